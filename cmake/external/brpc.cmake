@@ -55,6 +55,10 @@ if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU" AND ${CMAKE_CXX_COMPILER_VERSION}
   set(BRPC_PATCH_COMMAND_GCC13 git apply ${http2_h_patch})
 endif()
 
+if(WITH_BRPC_RDMA)
+  set(BRPC_RDMA_ARGS -DWITH_RDMA=ON)
+endif()
+
 # If minimal .a is need, you can set  WITH_DEBUG_SYMBOLS=OFF
 ExternalProject_Add(
   extern_brpc
@@ -77,6 +81,7 @@ ExternalProject_Add(
              -DWITH_GLOG=ON
              -DBUILD_BRPC_TOOLS=ON
              -DBUILD_SHARED_LIBS=ON
+             ${BRPC_RDMA_ARGS}
              ${EXTERNAL_OPTIONAL_ARGS}
   LIST_SEPARATOR |
   CMAKE_CACHE_ARGS
@@ -101,6 +106,9 @@ set_property(TARGET brpc PROPERTY IMPORTED_LOCATION ${BRPC_LIBRARIES})
 add_dependencies(brpc extern_brpc)
 
 add_definitions(-DBRPC_WITH_GLOG)
+if(WITH_BRPC_RDMA)
+  add_definitions(-DBRPC_WITH_RDMA=1)
+endif()
 
 list(APPEND external_project_dependencies brpc)
 
@@ -116,3 +124,13 @@ set(EXTERNAL_BRPC_DEPS
 if(NOT WITH_GFLAGS)
   set(EXTERNAL_BRPC_DEPS ${EXTERNAL_BRPC_DEPS} gflags)
 endif()
+
+if(WITH_BRPC_RDMA)
+  find_library(IBVERBS_LIBRARY NAMES ibverbs)
+  if(NOT IBVERBS_LIBRARY)
+    message(FATAL_ERROR "WITH_BRPC_RDMA needs libibverbs.")
+  endif()
+  add_library(ibverbs SHARED IMPORTED GLOBAL)
+  set_property(TARGET ibverbs PROPERTY IMPORTED_LOCATION ${IBVERBS_LIBRARY})
+  set(EXTERNAL_BRPC_DEPS ${EXTERNAL_BRPC_DEPS} ibverbs)
+endif()
@@ -0,0 +1,162 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/compilation_disk_cache.h"
+
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_compilation_cache_dir);
+
+namespace cinn {
+namespace backends {
+
+namespace {
+
+constexpr char kEntryMagic[8] = {'C', 'I', 'N', 'N', 'D', 'C', '0', '1'};
+
+// FNV-1a, stable across processes and builds unlike std::hash
+uint64_t HashString(const std::string& str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+void WriteUint64(std::ostream& os, uint64_t value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool ReadUint64(std::istream& is, uint64_t* value) {
+  return static_cast<bool>(
+      is.read(reinterpret_cast<char*>(value), sizeof(*value)));
+}
+
+bool ReadString(std::istream& is, uint64_t size, std::string* str) {
+  str->resize(size);
+  return size == 0 || static_cast<bool>(is.read(&(*str)[0], size));
+}
+
+}  // namespace
+
+CompilationDiskCache& CompilationDiskCache::Instance() {
+  static CompilationDiskCache instance(FLAGS_cinn_compilation_cache_dir);
+  return instance;
+}
+
+CompilationDiskCache::CompilationDiskCache(const std::string& dir)
+    : dir_(dir) {
+  if (dir_.empty()) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(dir_, ec);
+  if (ec) {
+    LOG(WARNING) << "Failed to create compilation cache dir " << dir_ << ": "
+                 << ec.message() << ", the disk cache is disabled.";
+    dir_.clear();
+  }
+}
+
+std::string CompilationDiskCache::EntryPath(const std::string& key) const {
+  char name[32];
+  snprintf(name,
+           sizeof(name),
+           "%016llx.bin",
+           static_cast<unsigned long long>(HashString(key)));  // NOLINT
+  return dir_ + "/" + name;
+}
+
+bool CompilationDiskCache::Get(const std::string& key,
+                               std::string* value) const {
+  if (!Enabled()) {
+    return false;
+  }
+  std::string path = EntryPath(key);
+  std::ifstream ifs(path, std::ios::in | std::ios::binary);
+  if (!ifs.is_open()) {
+    VLOG(4) << "Compilation disk cache miss: " << path;
+    return false;
+  }
+  char magic[sizeof(kEntryMagic)];
+  uint64_t key_size = 0;
+  uint64_t value_size = 0;
+  uint64_t checksum = 0;
+  std::string stored_key;
+  if (!ifs.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), kEntryMagic) ||
+      !ReadUint64(ifs, &key_size) || key_size != key.size() ||
+      !ReadString(ifs, key_size, &stored_key) || stored_key != key ||
+      !ReadUint64(ifs, &value_size) || !ReadString(ifs, value_size, value) ||
+      !ReadUint64(ifs, &checksum) || checksum != HashString(*value)) {
+    VLOG(4) << "Compilation disk cache entry mismatch: " << path;
+    value->clear();
+    return false;
+  }
+  VLOG(4) << "Compilation disk cache hit: " << path;
+  return true;
+}
+
+void CompilationDiskCache::Put(const std::string& key,
+                               const std::string& value) const {
+  if (!Enabled()) {
+    return;
+  }
+  static std::atomic<uint64_t> tmp_id{0};
+  std::string path = EntryPath(key);
+  std::stringstream tmp_path;
+  tmp_path << path << ".tmp." << getpid() << "."
+           << std::hash<std::thread::id>()(std::this_thread::get_id()) << "."
+           << tmp_id++;
+  {
+    std::ofstream ofs(tmp_path.str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    if (ofs.is_open()) {
+      ofs.write(kEntryMagic, sizeof(kEntryMagic));
+      WriteUint64(ofs, key.size());
+      ofs.write(key.data(), key.size());
+      WriteUint64(ofs, value.size());
+      ofs.write(value.data(), value.size());
+      WriteUint64(ofs, HashString(value));
+      ofs.close();
+    }
+    if (ofs.fail()) {
+      LOG(WARNING) << "Failed to write compilation cache entry " << path;
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Failed to commit compilation cache entry " << path;
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+  VLOG(4) << "Compilation disk cache insert: " << path;
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+namespace cinn {
+namespace backends {
+
+/**
+ * An on-disk cache of compiled device code, shared by all processes on the
+ * host that use the same directory (FLAGS_cinn_compilation_cache_dir for the
+ * global instance).
+ *
+ * Every entry is one file named by the hash of its key. The file also keeps
+ * the full key, so a hash collision reads as a miss. Entries are written to a
+ * temporary file and renamed into place, so readers in other processes only
+ * ever see complete entries and concurrent writers of one key do not clash.
+ */
+class CompilationDiskCache {
+ public:
+  static CompilationDiskCache& Instance();
+
+  explicit CompilationDiskCache(const std::string& dir);
+
+  bool Enabled() const { return !dir_.empty(); }
+
+  /**
+   * Look up \p key, the key must contain everything the value depends on,
+   * e.g. source code, device arch and compiler version.
+   * @return true and fill \p value on a hit.
+   */
+  bool Get(const std::string& key, std::string* value) const;
+
+  /**
+   * Store \p value for \p key, failures only disable this entry.
+   */
+  void Put(const std::string& key, const std::string& value) const;
+
+ private:
+  std::string EntryPath(const std::string& key) const;
+
+  std::string dir_;
+};
+
+}  // namespace backends
+}  // namespace cinn
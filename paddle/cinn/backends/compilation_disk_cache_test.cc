@@ -0,0 +1,105 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/backends/compilation_disk_cache.h"
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cinn {
+namespace backends {
+
+TEST(CompilationDiskCache, PutAndGet) {
+  std::string dir = "./compilation_disk_cache_test";
+  std::filesystem::remove_all(dir);
+  CompilationDiskCache cache(dir);
+  ASSERT_TRUE(cache.Enabled());
+
+  std::string value;
+  EXPECT_FALSE(cache.Get("sm_80 kernel_a", &value));
+  std::string binary("\x7f" "ELF\0\1\2", 7);
+  cache.Put("sm_80 kernel_a", binary);
+  EXPECT_TRUE(cache.Get("sm_80 kernel_a", &value));
+  EXPECT_EQ(value, binary);
+  // any other arch or source is a miss
+  EXPECT_FALSE(cache.Get("sm_90 kernel_a", &value));
+
+  // a second instance, as in another process, sees the entry
+  CompilationDiskCache other(dir);
+  EXPECT_TRUE(other.Get("sm_80 kernel_a", &value));
+  EXPECT_EQ(value, binary);
+
+  CompilationDiskCache disabled("");
+  EXPECT_FALSE(disabled.Enabled());
+  EXPECT_FALSE(disabled.Get("sm_80 kernel_a", &value));
+  std::filesystem::remove_all(dir);
+}
+
+TEST(CompilationDiskCache, ConcurrentWriters) {
+  std::string dir = "./compilation_disk_cache_concurrent";
+  std::filesystem::remove_all(dir);
+  const int process_num = 4;
+  const int key_num = 16;
+  auto value_of = [](int key) { return std::string(4096 + key, 'a' + key); };
+
+  std::vector<pid_t> children;
+  for (int p = 0; p < process_num; ++p) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      CompilationDiskCache cache(dir);
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&]() {
+          for (int key = 0; key < key_num; ++key) {
+            cache.Put("kernel_" + std::to_string(key), value_of(key));
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      _exit(0);
+    }
+    children.push_back(pid);
+  }
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+  }
+
+  CompilationDiskCache cache(dir);
+  for (int key = 0; key < key_num; ++key) {
+    std::string value;
+    EXPECT_TRUE(cache.Get("kernel_" + std::to_string(key), &value));
+    EXPECT_EQ(value, value_of(key));
+  }
+  // no temporary file is left behind
+  int entry_num = 0;
+  for (auto& entry : std::filesystem::directory_iterator(dir)) {
+    EXPECT_EQ(entry.path().extension(), ".bin");
+    ++entry_num;
+  }
+  EXPECT_EQ(entry_num, key_num);
+  std::filesystem::remove_all(dir);
+}
+
+}  // namespace backends
+}  // namespace cinn
@@ -16,8 +16,10 @@
 
 #include <sys/stat.h>
 #include <fstream>
+#include <sstream>
 #include "paddle/cinn/backends/codegen_cuda_host.h"
 #include "paddle/cinn/backends/codegen_device_util.h"
+#include "paddle/cinn/backends/compilation_disk_cache.h"
 #include "paddle/cinn/backends/llvm/runtime_symbol_registry.h"
 #include "paddle/cinn/common/context.h"
 #include "paddle/cinn/hlir/framework/graph_compiler_util.h"
@@ -43,6 +45,7 @@ PD_DECLARE_string(cinn_dump_group_source_code);
 PD_DECLARE_string(cinn_dump_group_ptx);
 PD_DECLARE_string(cinn_dump_group_instruction);
 PD_DECLARE_string(cinn_debug_custom_code_path);
+PD_DECLARE_bool(cinn_nvrtc_cubin_with_fmad);
 
 namespace {
 
@@ -325,11 +328,48 @@ void Compiler::RegisterDeviceModuleSymbol() {
       [&](common::HygonDCUArchHIP) { RegisterHipModuleSymbol(); });
 }
 
+#ifdef CINN_WITH_CUDA
+namespace {
+// everything besides the source that the nvrtc output depends on; the build
+// stamp covers the runtime headers that are included by path
+std::string CudaCompilationCacheKey(const std::string& source_code,
+                                    bool compile_to_cubin) {
+  int major = 0, minor = 0;
+  cudaDeviceGetAttribute(&major, cudaDevAttrComputeCapabilityMajor, 0);
+  cudaDeviceGetAttribute(&minor, cudaDevAttrComputeCapabilityMinor, 0);
+  int nvrtc_major = 0, nvrtc_minor = 0;
+  nvrtcVersion(&nvrtc_major, &nvrtc_minor);
+  std::stringstream ss;
+  ss << "cuda " << CUDA_VERSION << " nvrtc " << nvrtc_major << "."
+     << nvrtc_minor << " sm_" << major << minor << " cubin "
+     << compile_to_cubin << " fmad " << FLAGS_cinn_nvrtc_cubin_with_fmad
+     << " build " << __DATE__ << " " << __TIME__ << "\n"
+     << source_code;
+  return ss.str();
+}
+}  // namespace
+#endif
+
 void Compiler::RegisterCudaModuleSymbol() {
 #ifdef CINN_WITH_CUDA
   nvrtc::Compiler compiler;
   std::string source_code = CodeGenCudaDev::GetSourceHeader() + device_fn_code_;
-  auto ptx = compiler(source_code);
+  // nvcc writes the binary to a temporary file and returns its path, only
+  // the nvrtc output can be shared through the disk cache
+  auto& disk_cache = CompilationDiskCache::Instance();
+  bool use_disk_cache = disk_cache.Enabled() && !runtime::CanUseNvccCompiler();
+  std::string cache_key;
+  std::string ptx;
+  if (use_disk_cache) {
+    cache_key =
+        CudaCompilationCacheKey(source_code, compiler.compile_to_cubin());
+  }
+  if (!use_disk_cache || !disk_cache.Get(cache_key, &ptx)) {
+    ptx = compiler(source_code);
+    if (use_disk_cache && !ptx.empty()) {
+      disk_cache.Put(cache_key, ptx);
+    }
+  }
   PADDLE_ENFORCE_EQ(!ptx.empty(),
                     true,
                     ::common::errors::InvalidArgument(
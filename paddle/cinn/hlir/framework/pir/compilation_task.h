@@ -69,12 +69,12 @@ class CompilationTask {
 
   std::shared_ptr<pir::CompilationResult> operator()();
   void Lowering();
+  std::shared_ptr<pir::CompilationResult> CodegenAndJit();
   std::shared_ptr<pir::CompilationResult> CompileBroadcastModules(
       std::vector<GroupCompilationContext>* leaf_group_contexts,
       const std::unordered_map<int, ir::Var>& symbolic_shape_var_index);
 
  private:
-  std::shared_ptr<pir::CompilationResult> CodegenAndJit();
   std::shared_ptr<pir::CompilationResult> BuildPirCINNKernelInfo(
       const ir::Module& module,
       const ir::Module& CX86module,
@@ -14,6 +14,7 @@
 
 #include "paddle/cinn/hlir/framework/pir/op_lowering_impl.h"
 
+#include <sstream>
 #include <string>
 
 #include "paddle/cinn/adt/map_expr_ctx.h"
@@ -84,6 +85,25 @@ std::optional<std::vector<ir::Expr>> GetTensorValueFromShapeOrData(
   return result;
 }
 
+std::string GroupSignature(const std::vector<::pir::Operation*>& ops) {
+  std::stringstream ss;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    ss << (i > 0 ? ";" : "") << CompatibleInfo::OpName(*ops[i]) << "(";
+    for (size_t j = 0; j < ops[i]->num_results(); ++j) {
+      auto type_info = ops[i]
+                           ->result(j)
+                           .type()
+                           .dyn_cast<paddle::dialect::DenseTensorType>();
+      ss << (j > 0 ? "," : "");
+      if (type_info) {
+        ss << CompatibleInfo::ConvertIRType(type_info.dtype());
+      }
+    }
+    ss << ")";
+  }
+  return ss.str();
+}
+
 }  // namespace details
 
 OpLowererImpl::OpLowererImpl(const Target& target) : target_(target) {
@@ -122,6 +142,7 @@ BucketLoweredFuncsWrapper OpLowererImpl::BucketLower(
   if (group->IsBroadcastLeaf()) {
     fusion_group_info->can_apply_grid_reduce = false;
   }
+  fusion_group_info->group_signature = details::GroupSignature(ops);
 
   if (FLAGS_cinn_check_tensor_buffer_map) {
     optim::CheckTensorBufferMap(func_bodies, "BucketLower OpFusion");
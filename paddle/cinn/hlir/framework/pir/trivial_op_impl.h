@@ -166,6 +166,8 @@ struct FusionGroupInfo {
   std::vector<int64_t> reduce_axis;
   std::vector<std::string> reduce_var_name;
   bool can_apply_grid_reduce;
+  // ops and dtypes of the group, the key of its tuned schedule configs
+  std::string group_signature;
 
   std::string DebugPrint() {
     std::stringstream ss;
@@ -173,7 +175,8 @@ struct FusionGroupInfo {
        << "\nloop_strides: " << cinn::utils::Join(loop_strides, ", ")
        << "\nreduce_axis: " << cinn::utils::Join(reduce_axis, " ")
        << "\nreduce_var_name: " << cinn::utils::Join(reduce_var_name, " ")
-       << "\ncan_apply_grid_reduce: " << can_apply_grid_reduce;
+       << "\ncan_apply_grid_reduce: " << can_apply_grid_reduce
+       << "\ngroup_signature: " << group_signature;
     return ss.str();
   }
 };
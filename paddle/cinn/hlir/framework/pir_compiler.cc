@@ -13,6 +13,11 @@
 // limitations under the License.
 
 #include "paddle/cinn/hlir/framework/pir_compiler.h"
+
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
 #include "paddle/cinn/ir/group_schedule/config/schedule_config_manager.h"
 
 #include "paddle/cinn/hlir/dialect/operator/transforms/lowering_pass/utils.h"
@@ -20,11 +25,13 @@
 #include "paddle/cinn/hlir/framework/pir/utils.h"
 #include "paddle/cinn/runtime/arch_device.h"
 #include "paddle/cinn/utils/multi_threading.h"
+#include "paddle/cinn/utils/timer.h"
 #include "paddle/common/enforce.h"
 #include "paddle/common/flags.h"
 
 PD_DECLARE_bool(enable_cinn_compile_cache);
 PD_DECLARE_int64(cinn_compile_thread_num);
+PD_DECLARE_bool(cinn_compile_timing_report);
 
 namespace cinn::hlir::framework {
 class CompilationContextMapper {
@@ -66,8 +73,52 @@ static size_t GetThreadNum(size_t task_size) {
   return thread_size;
 }
 
+// Groups with more ops take longer to lower and compile, starting them first
+// keeps a few big groups from running alone at the end of the build.
+static std::vector<int> LargestGroupFirstOrder(
+    const std::vector<GroupCompilationContext>& contexts) {
+  std::vector<int> order(contexts.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+    return contexts[lhs].GetGroup()->ops().size() >
+           contexts[rhs].GetGroup()->ops().size();
+  });
+  return order;
+}
+
+static void PrintCompileTimingReport(
+    std::vector<GroupCompileTiming> timings,
+    size_t group_num,
+    size_t thread_size,
+    float wall_ms) {
+  const size_t max_rows = 20;
+  float sum_ms = 0;
+  for (const auto& timing : timings) {
+    sum_ms += timing.TotalMs();
+  }
+  std::sort(timings.begin(),
+            timings.end(),
+            [](const GroupCompileTiming& lhs, const GroupCompileTiming& rhs) {
+              return lhs.TotalMs() > rhs.TotalMs();
+            });
+  std::stringstream ss;
+  ss << "CINN compiled " << timings.size() << " unique groups out of "
+     << group_num << " with " << thread_size << " threads in " << wall_ms
+     << " ms, sum of group time " << sum_ms << " ms.\n";
+  ss << "slowest groups (lowering / codegen / jit ms, op num):\n";
+  for (size_t i = 0; i < std::min(max_rows, timings.size()); ++i) {
+    const auto& timing = timings[i];
+    ss << "  " << timing.func_name << ": " << timing.TotalMs() << " ("
+       << timing.lowering_ms << " / " << timing.codegen_ms << " / "
+       << timing.jit_ms << "), " << timing.op_num << " ops\n";
+  }
+  LOG(INFO) << ss.str();
+}
+
 std::vector<pir::CINNKernelInfo> PirCompiler::Build(
     const std::vector<pir::OpLoweringGroupPtr>& groups) {
+  utils::Timer build_timer;
+  build_timer.Start();
   CompilationContextMapper ctx_mapper(target_, groups);
   auto& group_compilation_contexts = ctx_mapper.UniqueCompilationContexts();
   auto& compilation_results = ctx_mapper.MutableCompilationResult();
@@ -77,6 +128,7 @@ std::vector<pir::CINNKernelInfo> PirCompiler::Build(
   VLOG(5) << "Found " << task_size << " new groups parsed from "
           << groups.size() << " and compiles with " << thread_size;
   cinn::ir::InitScheduleConfig();
+  std::vector<GroupCompileTiming> timings(task_size);
   if (task_size > 0) {
     // See
     // https://developer.nvidia.com/blog/cuda-pro-tip-always-set-current-device-avoid-multithreading-bugs/
@@ -84,22 +136,33 @@ std::vector<pir::CINNKernelInfo> PirCompiler::Build(
     const auto device_id = runtime::GetArchDevice(target_);
     auto worker_fn = [&](int index) {
       runtime::SetArchDevice(target_, device_id);
-      compilation_results[index] = Compile(&group_compilation_contexts[index]);
+      compilation_results[index] =
+          Compile(&group_compilation_contexts[index], &timings[index]);
     };
-    utils::parallel_run(worker_fn,
-                        utils::SequenceDispatcher(0, task_size),
-                        /*thread_num=*/thread_size);
+    utils::parallel_run(
+        worker_fn,
+        utils::OrderedDispatcher(
+            LargestGroupFirstOrder(group_compilation_contexts)),
+        /*thread_num=*/thread_size);
   }
   VLOG(5) << "Finished compiling " << task_size << " Cinn Kernel info.";
+  if (FLAGS_cinn_compile_timing_report && task_size > 0) {
+    PrintCompileTimingReport(
+        timings, groups.size(), thread_size, build_timer.Stop());
+  }
   ctx_mapper.SetFinalize(true);
   ctx_mapper.UpdateGlobalCache();
   return ctx_mapper.RecoverKernelInfos();
 }
 
 std::shared_ptr<pir::CompilationResult> PirCompiler::Compile(
-    GroupCompilationContext* ctx) {
+    GroupCompilationContext* ctx, GroupCompileTiming* timing) {
   std::shared_ptr<pir::CompilationResult> compile_result;
   CompilationTask task(ctx);
+  timing->func_name = ctx->GetGroup()->FuncName();
+  timing->op_num = ctx->GetGroup()->ops().size();
+  utils::Timer timer;
+  timer.Start();
 
   const auto& optional_broadcast_optimize_groups =
       pir::GetBroadcastGroupListForOptimize(ctx->GetGroup());
@@ -128,14 +191,22 @@ std::shared_ptr<pir::CompilationResult> PirCompiler::Compile(
     std::unordered_map<int, ir::Var> symbolic_shape_var_index;
     UnifyBroadcastGroupFuncArgs(
         &switch_group_ctxs, ctx->GetGroup(), &symbolic_shape_var_index);
+    timing->lowering_ms = timer.Stop();
+    timer.Start();
     compile_result = task.CompileBroadcastModules(&switch_group_ctxs,
                                                   symbolic_shape_var_index);
   } else {
-    compile_result = task();
+    task.Lowering();
+    timing->lowering_ms = timer.Stop();
+    timer.Start();
+    compile_result = task.CodegenAndJit();
   }
+  timing->codegen_ms = timer.Stop();
 
   // Triggering llvm compilation in thread
+  timer.Start();
   compile_result->GetKernelInfo();
+  timing->jit_ms = timer.Stop();
   return compile_result;
 }
 
@@ -15,11 +15,23 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include "paddle/cinn/common/macros.h"
 #include "paddle/cinn/hlir/framework/pir/compilation_task.h"
 
 namespace cinn::hlir::framework {
 
+// wall time of the stages of compiling one group, in ms
+struct GroupCompileTiming {
+  std::string func_name;
+  size_t op_num{0};
+  float lowering_ms{0};
+  float codegen_ms{0};
+  float jit_ms{0};
+
+  float TotalMs() const { return lowering_ms + codegen_ms + jit_ms; }
+};
+
 class PirCompiler final {
  public:
   PirCompiler(const Target& target) : target_(target) {}
@@ -30,7 +42,8 @@ class PirCompiler final {
  private:
   CINN_DISALLOW_COPY_AND_ASSIGN(PirCompiler);
 
-  std::shared_ptr<pir::CompilationResult> Compile(GroupCompilationContext* ctx);
+  std::shared_ptr<pir::CompilationResult> Compile(GroupCompilationContext* ctx,
+                                                  GroupCompileTiming* timing);
 
   Target target_;
 };
@@ -14,6 +14,10 @@
 
 #include "paddle/cinn/ir/group_schedule/config/group_tile_config.h"
 #include "paddle/cinn/hlir/framework/pir/op_lowering_impl.h"
+#include "paddle/cinn/utils/string.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_string(cinn_dynamic_shape_buckets);
 
 namespace cinn {
 namespace ir {
@@ -26,6 +30,9 @@ namespace {
 
 const int kMaxNumel = INT32_MAX;
 
+// Smaller priorities are dispatched first, the generic buckets use 100.
+const int kDeclaredBucketPriority = 10;
+
 int64_t CeilPow2(int64_t n) {
   int64_t pow = 1;
   while (pow < n) {
@@ -439,6 +446,107 @@ CombineBaseInfoAndConfig(
   return combined;
 }
 
+DeclaredShapeBuckets ParseDeclaredShapeBuckets(const std::string& spec) {
+  DeclaredShapeBuckets declared_buckets;
+  for (const std::string& item : utils::Split(spec, ";")) {
+    if (utils::Trim(item).empty()) {
+      continue;
+    }
+    std::vector<std::string> key_and_bounds = utils::Split(item, ":");
+    PADDLE_ENFORCE_EQ(key_and_bounds.size(),
+                      2UL,
+                      ::common::errors::InvalidArgument(
+                          "Shape buckets should be declared as "
+                          "\"S:128,512;R:1024\", but got \"%s\".",
+                          spec));
+    std::string iter_type = utils::Trim(key_and_bounds[0]);
+    PADDLE_ENFORCE_EQ(iter_type == "S" || iter_type == "R",
+                      true,
+                      ::common::errors::InvalidArgument(
+                          "Shape buckets can only be declared for the S or R "
+                          "extent, but got \"%s\".",
+                          iter_type));
+    std::vector<int64_t>& bounds = declared_buckets[iter_type];
+    for (const std::string& bound : utils::Split(key_and_bounds[1], ",")) {
+      std::string digits = utils::Trim(bound);
+      bool is_number = !digits.empty() && digits.size() <= 10 &&
+                       std::all_of(digits.begin(), digits.end(), ::isdigit);
+      int64_t value = is_number ? std::stoll(digits) : 0;
+      PADDLE_ENFORCE_EQ(
+          value > (bounds.empty() ? 0 : bounds.back()) && value <= kMaxNumel,
+          true,
+          ::common::errors::InvalidArgument(
+              "Upper bounds of the %s shape buckets should be positive and "
+              "increasing, but got \"%s\".",
+              iter_type,
+              spec));
+      bounds.push_back(value);
+    }
+  }
+  return declared_buckets;
+}
+
+TileConfigMap BuildDeclaredShapeBucketConfig(
+    const std::shared_ptr<ScheduleConfig::BaseInfo>& base_info,
+    const common::Target& target,
+    const DeclaredShapeBuckets& declared_buckets) {
+  // a static extent spans the whole range, like in the generic buckets
+  auto RangesOf = [&](bool is_dynamic,
+                      int64_t numel,
+                      const std::string& iter_type) {
+    std::vector<std::pair<int, int>> ranges;
+    if (!is_dynamic) {
+      ranges.emplace_back(1, numel > 1 ? kMaxNumel : 1);
+      return ranges;
+    }
+    auto it = declared_buckets.find(iter_type);
+    if (it == declared_buckets.end()) {
+      return ranges;
+    }
+    int lower_bound = 1;
+    for (int64_t upper_bound : it->second) {
+      ranges.emplace_back(lower_bound, static_cast<int>(upper_bound));
+      lower_bound = static_cast<int>(upper_bound) + 1;
+    }
+    return ranges;
+  };
+  // extents above the last declared bound stay in the generic buckets
+  const auto sp_ranges = RangesOf(
+      base_info->has_dynamic_spatial, base_info->spatial_numel, "S");
+  const auto rd_ranges =
+      RangesOf(base_info->has_dynamic_reduce, base_info->reduce_numel, "R");
+
+  TileConfigMap config_map;
+  for (const auto& sp_range : sp_ranges) {
+    for (const auto& rd_range : rd_ranges) {
+      // configure the bucket as a static shape of its largest extent
+      auto specialized = std::make_shared<ScheduleConfig::BaseInfo>(*base_info);
+      if (base_info->has_dynamic_spatial) {
+        specialized->spatial_numel = sp_range.second;
+        specialized->has_dynamic_spatial = false;
+      }
+      if (base_info->has_dynamic_reduce) {
+        specialized->reduce_numel = rd_range.second;
+        specialized->has_dynamic_reduce = false;
+      }
+      // grid reduce needs a temp space sized by the static shape
+      specialized->can_apply_grid_reduce = false;
+      TileConfig tile_config =
+          BuildPureStaticShapeConfig(specialized, target).begin()->second;
+
+      BucketInfo bucket_info{sp_range.first,
+                             sp_range.second,
+                             rd_range.first,
+                             rd_range.second,
+                             base_info->has_dynamic_spatial,
+                             base_info->has_dynamic_reduce};
+      bucket_info.bucket_priority = kDeclaredBucketPriority;
+      config_map[bucket_info] = tile_config;
+    }
+  }
+  return config_map;
+}
+
 std::unordered_map<BucketInfo, ScheduleConfig, BucketInfoHash>
 BuildScheduleConfig(const std::shared_ptr<FusionGroupInfo>& group_info,
                     const common::Target& target) {
@@ -448,19 +556,27 @@ BuildScheduleConfig(const std::shared_ptr<FusionGroupInfo>& group_info,
     VLOG(6) << "Building static sptial and static reduce config.";
     return CombineBaseInfoAndConfig(
         BuildPureStaticShapeConfig(base_info, target), base_info);
-  } else if (base_info->has_dynamic_reduce && !base_info->has_dynamic_spatial) {
+  }
+  TileConfigMap config_map;
+  if (base_info->has_dynamic_reduce && !base_info->has_dynamic_spatial) {
     VLOG(6) << "Building static sptial and dynamic reduce config.";
-    return CombineBaseInfoAndConfig(BuildStaticSpatialConfig(base_info, target),
-                                    base_info);
+    config_map = BuildStaticSpatialConfig(base_info, target);
   } else if (!base_info->has_dynamic_reduce && base_info->has_dynamic_spatial) {
     VLOG(6) << "Building dynamic sptial and static reduce config.";
-    return CombineBaseInfoAndConfig(BuildStaticReduceConfig(base_info, target),
-                                    base_info);
+    config_map = BuildStaticReduceConfig(base_info, target);
   } else {  // (base_info->has_dynamic_reduce && base_info->has_dynamic_spatial)
     VLOG(6) << "Building dynamic spatial and dynamic reduce config.";
-    return CombineBaseInfoAndConfig(BuildDynamicShapeConfig(base_info, target),
-                                    base_info);
+    config_map = BuildDynamicShapeConfig(base_info, target);
+  }
+  if (!FLAGS_cinn_dynamic_shape_buckets.empty()) {
+    TileConfigMap declared_map = BuildDeclaredShapeBucketConfig(
+        base_info,
+        target,
+        ParseDeclaredShapeBuckets(FLAGS_cinn_dynamic_shape_buckets));
+    VLOG(6) << "Add " << declared_map.size() << " declared shape buckets.";
+    config_map.insert(declared_map.begin(), declared_map.end());
   }
+  return CombineBaseInfoAndConfig(config_map, base_info);
 }
 
 }  // namespace ir
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <map>
 #include <memory>
 #include "paddle/cinn/adt/adt.h"
 #include "paddle/cinn/common/target.h"
@@ -124,6 +125,20 @@ CombineBaseInfoAndConfig(
                              BucketInfoHash>& config_map,
     const std::shared_ptr<ScheduleConfig::BaseInfo>& base_info);
 
+// Upper bounds of the user declared buckets of the total spatial ("S") and
+// reduce ("R") extent, parsed from e.g. "S:128,512,2048;R:1024,4096".
+using DeclaredShapeBuckets = std::map<std::string, std::vector<int64_t>>;
+
+DeclaredShapeBuckets ParseDeclaredShapeBuckets(const std::string& spec);
+
+// Specialized configs of a dynamic shape group, one for each declared bucket
+// of its dynamic extents. The buckets are checked before the generic ones.
+std::unordered_map<BucketInfo, ScheduleConfig::TileConfig, BucketInfoHash>
+BuildDeclaredShapeBucketConfig(
+    const std::shared_ptr<ScheduleConfig::BaseInfo>& base_info,
+    const common::Target& target,
+    const DeclaredShapeBuckets& declared_buckets);
+
 std::unordered_map<BucketInfo, ScheduleConfig, BucketInfoHash>
 BuildScheduleConfig(const std::shared_ptr<FusionGroupInfo>& group_info,
                     const common::Target& target);
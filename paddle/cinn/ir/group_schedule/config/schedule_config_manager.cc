@@ -15,7 +15,10 @@
 #include "paddle/cinn/ir/group_schedule/config/schedule_config_manager.h"
 #include "paddle/cinn/ir/group_schedule/config/file_database.h"
 
+#include <algorithm>
+
 PD_DECLARE_string(tile_config_policy);
+PD_DECLARE_string(cinn_tuning_database_file);
 
 namespace cinn {
 namespace ir {
@@ -42,16 +45,62 @@ ScheduleConfigMap ScheduleConfigManager::ExtractConfigs(
     return CombineBaseInfoAndConfig(tile_config_map, base_info);
   };
 
+  ScheduleConfigMap configs;
   if (policy_ == "default" || tile_config_data_.count(policy_) == 0) {
-    return BuildScheduleConfig(group_info, target);
+    configs = BuildScheduleConfig(group_info, target);
   } else if (policy_ == "hybrid") {
     ScheduleConfigMap default_map = BuildScheduleConfig(group_info, target);
-    ScheduleConfigMap stored_map = ReadConfigs(policy_);
-    stored_map.insert(default_map.begin(), default_map.end());
-    return stored_map;
+    configs = ReadConfigs(policy_);
+    configs.insert(default_map.begin(), default_map.end());
   } else {
     VLOG(3) << "Enter policy branch: " << policy_;
-    return ReadConfigs(policy_);
+    configs = ReadConfigs(policy_);
+  }
+  ApplyTuning(target, group_info, &configs);
+  return configs;
+}
+
+void ScheduleConfigManager::ApplyTuning(
+    const common::Target& target,
+    const std::shared_ptr<FusionGroupInfo>& group_info,
+    ScheduleConfigMap* configs) const {
+  if (group_info->group_signature.empty() || configs->empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  std::vector<TuningRecord> records;
+  if (tuning_database_) {
+    records = tuning_database_->GetRecords(target, group_info->group_signature);
+  }
+  if (tuning_override_ &&
+      tuning_override_->group_signature == group_info->group_signature) {
+    records.push_back(*tuning_override_);
+  }
+  for (auto& [bucket_info, config] : *configs) {
+    BucketInfo tuning_bucket = TuningBucketOf(*config.base_info, bucket_info);
+    // the last matching record wins, so the override beats the database
+    for (const auto& record : records) {
+      if (IsSameBucketSpace(record.bucket_info, tuning_bucket)) {
+        VLOG(4) << "Use tuned config of group " << group_info->group_signature
+                << " on " << tuning_bucket.ToString();
+        config.tile_config = record.tile_config;
+      }
+    }
+    auto IsCollected = [&]() {
+      return std::any_of(
+          tuning_tasks_.begin(), tuning_tasks_.end(), [&](const auto& task) {
+            return task.group_signature == group_info->group_signature &&
+                   IsSameBucketSpace(task.bucket_info, tuning_bucket);
+          });
+    };
+    if (collect_tuning_tasks_ && !config.base_info->has_dynamic_spatial &&
+        !config.base_info->has_dynamic_reduce && !IsCollected()) {
+      tuning_tasks_.push_back(TuningTask{target,
+                                         group_info->group_signature,
+                                         tuning_bucket,
+                                         config.base_info,
+                                         config.tile_config});
+    }
   }
 }
 
@@ -59,6 +108,42 @@ void ScheduleConfigManager::SetPolicy(const std::string& policy) {
   policy_ = policy;
 }
 
+void ScheduleConfigManager::SetTuningDatabase(
+    const std::shared_ptr<TuningRecordDatabase>& database) {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  tuning_database_ = database;
+}
+
+std::shared_ptr<TuningRecordDatabase>
+ScheduleConfigManager::GetTuningDatabase() const {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  return tuning_database_;
+}
+
+void ScheduleConfigManager::SetTuningOverride(const TuningRecord& record) {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  tuning_override_ = record;
+}
+
+void ScheduleConfigManager::ClearTuningOverride() {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  tuning_override_.reset();
+}
+
+void ScheduleConfigManager::StartCollectTuningTasks() {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  collect_tuning_tasks_ = true;
+  tuning_tasks_.clear();
+}
+
+std::vector<TuningTask> ScheduleConfigManager::StopCollectTuningTasks() {
+  std::lock_guard<std::mutex> lock(tuning_mutex_);
+  collect_tuning_tasks_ = false;
+  std::vector<TuningTask> tasks;
+  tasks.swap(tuning_tasks_);
+  return tasks;
+}
+
 void InitScheduleConfig() {
   auto& schedule_config_manager = cinn::ir::ScheduleConfigManager::Instance();
   std::string policy;
@@ -69,6 +154,14 @@ void InitScheduleConfig() {
         std::make_shared<cinn::ir::FileTileConfigDatabase>();
     schedule_config_manager.AddConfigDatabase(policy, tile_config_database);
   }
+  const std::string& tuning_file = FLAGS_cinn_tuning_database_file;
+  auto tuning_database = schedule_config_manager.GetTuningDatabase();
+  if (tuning_file.empty()) {
+    schedule_config_manager.SetTuningDatabase(nullptr);
+  } else if (!tuning_database || tuning_database->path() != tuning_file) {
+    schedule_config_manager.SetTuningDatabase(
+        std::make_shared<TuningRecordDatabase>(tuning_file));
+  }
 }
 
 }  // namespace ir
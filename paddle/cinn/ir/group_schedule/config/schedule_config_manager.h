@@ -14,11 +14,28 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "paddle/cinn/ir/group_schedule/config/database.h"
+#include "paddle/cinn/ir/group_schedule/config/tuning_database.h"
 
 namespace cinn {
 namespace ir {
 
+// A group and shape bucket seen by the compiler while collecting tuning tasks.
+struct TuningTask {
+  common::Target target;
+  std::string group_signature;
+  BucketInfo bucket_info;
+  std::shared_ptr<ScheduleConfig::BaseInfo> base_info;
+  // the config the compiler uses for it now
+  ScheduleConfig::TileConfig tile_config;
+};
+
 class ScheduleConfigManager {
  public:
   static ScheduleConfigManager& Instance();
@@ -32,16 +49,37 @@ class ScheduleConfigManager {
 
   void SetPolicy(const std::string& policy);
 
+  // Tuned records of the database replace the configs of every policy.
+  void SetTuningDatabase(const std::shared_ptr<TuningRecordDatabase>& database);
+  std::shared_ptr<TuningRecordDatabase> GetTuningDatabase() const;
+
+  // Used by the tuner: force the config of one group and bucket, and collect
+  // the static shape groups the compiler extracts configs for.
+  void SetTuningOverride(const TuningRecord& record);
+  void ClearTuningOverride();
+  void StartCollectTuningTasks();
+  std::vector<TuningTask> StopCollectTuningTasks();
+
  private:
   ScheduleConfigManager() = default;
   ~ScheduleConfigManager() = default;
   ScheduleConfigManager(const ScheduleConfigManager&) = delete;
   void operator=(const ScheduleConfigManager&) = delete;
 
+  void ApplyTuning(const common::Target& target,
+                   const std::shared_ptr<FusionGroupInfo>& group_info,
+                   ScheduleConfigMap* configs) const;
+
  private:
   std::unordered_map<std::string, std::shared_ptr<TileConfigDatabase>>
       tile_config_data_;
   std::string policy_ = "default";
+
+  mutable std::mutex tuning_mutex_;
+  std::shared_ptr<TuningRecordDatabase> tuning_database_;
+  std::optional<TuningRecord> tuning_override_;
+  bool collect_tuning_tasks_{false};
+  mutable std::vector<TuningTask> tuning_tasks_;
 };
 
 void InitScheduleConfig();
@@ -0,0 +1,215 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/ir/group_schedule/config/tuning_database.h"
+
+#include <google/protobuf/util/json_util.h>
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+#include "paddle/cinn/ir/group_schedule/config/tile_config_desc.pb.h"
+#include "paddle/common/enforce.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+std::string TargetKey(const common::Target& target) {
+  return target.arch_str() + "_" + target.device_name_str();
+}
+
+std::string RecordKey(const std::string& target_key,
+                      const std::string& group_signature) {
+  return target_key + "/" + group_signature;
+}
+
+ReduceMethod ReduceMethodFromIndex(int index) {
+  switch (index) {
+    case 1:
+      return WarpReduceMethod();
+    case 2:
+      return BlockReduceMethod();
+    case 3:
+      return DiscreteReduceMethod();
+    default:
+      return NoneReduceMethod();
+  }
+}
+
+int ClampToInt(int64_t numel) {
+  return static_cast<int>(std::min<int64_t>(numel, INT_MAX));
+}
+
+}  // namespace
+
+BucketInfo TuningBucketOf(const ScheduleConfig::BaseInfo& base_info,
+                          const BucketInfo& config_bucket) {
+  if (base_info.has_dynamic_spatial || base_info.has_dynamic_reduce) {
+    return config_bucket;
+  }
+  int spatial_numel = ClampToInt(base_info.spatial_numel);
+  int reduce_numel = ClampToInt(base_info.reduce_numel);
+  return BucketInfo(spatial_numel,
+                    spatial_numel,
+                    reduce_numel,
+                    reduce_numel,
+                    /* sp_is_dynamic = */ false,
+                    /* rb_is_dynamic = */ false);
+}
+
+bool IsSameBucketSpace(const BucketInfo& lhs, const BucketInfo& rhs) {
+  if (lhs.space.size() != rhs.space.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < lhs.space.size(); ++i) {
+    if (lhs.space[i].is_dynamic != rhs.space[i].is_dynamic ||
+        lhs.space[i].iter_type != rhs.space[i].iter_type ||
+        lhs.space[i].lower_bound != rhs.space[i].lower_bound ||
+        lhs.space[i].upper_bound != rhs.space[i].upper_bound) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TuningRecordDatabase::TuningRecordDatabase(const std::string& path)
+    : path_(path) {
+  Load();
+}
+
+void TuningRecordDatabase::Load() {
+  std::ifstream is(path_);
+  if (!is.good()) {
+    VLOG(3) << "Tuning database doesn't exist yet: " << path_;
+    return;
+  }
+  int line_num = 0;
+  for (std::string line; std::getline(is, line);) {
+    if (line.empty()) {
+      continue;
+    }
+    group_schedule::config::proto::TuningRecord proto;
+    auto status = google::protobuf::util::JsonStringToMessage(line, &proto);
+    if (!status.ok()) {
+      // a line cut by a crashed writer only loses that record
+      LOG(WARNING) << "Skip broken line of tuning database " << path_ << ": "
+                   << line;
+      continue;
+    }
+    TuningRecord record;
+    record.group_signature = proto.group_signature();
+    std::vector<BucketInfo::Dimension> dims;
+    for (const auto& dim : proto.bucket_info().dimension()) {
+      dims.emplace_back(dim.lower_bound(),
+                        dim.upper_bound(),
+                        dim.iter_type(),
+                        dim.is_dynamic());
+    }
+    record.bucket_info = BucketInfo(dims);
+    record.tile_config.warp_num = proto.tile_config().warp_num();
+    record.tile_config.tree_reduce_num = proto.tile_config().tree_reduce_num();
+    record.tile_config.spatial_inner_num =
+        proto.tile_config().spatial_inner_num();
+    record.tile_config.grid_reduce_num =
+        std::max<int64_t>(proto.grid_reduce_num(), 1);
+    record.tile_config.reduce_method =
+        ReduceMethodFromIndex(proto.reduce_method());
+    record.score = proto.score();
+    Insert(RecordKey(proto.target(), record.group_signature), record);
+    ++line_num;
+  }
+  VLOG(3) << "Loaded " << line_num << " tuning records from " << path_;
+}
+
+void TuningRecordDatabase::Insert(const std::string& key,
+                                  const TuningRecord& record) {
+  auto& records = records_[key];
+  for (auto& stored : records) {
+    if (IsSameBucketSpace(stored.bucket_info, record.bucket_info)) {
+      stored = record;
+      return;
+    }
+  }
+  records.push_back(record);
+}
+
+std::vector<TuningRecord> TuningRecordDatabase::GetRecords(
+    const common::Target& target, const std::string& group_signature) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = records_.find(RecordKey(TargetKey(target), group_signature));
+  if (it == records_.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+bool TuningRecordDatabase::HasRecord(const common::Target& target,
+                                     const std::string& group_signature,
+                                     const BucketInfo& bucket_info) const {
+  for (const auto& record : GetRecords(target, group_signature)) {
+    if (IsSameBucketSpace(record.bucket_info, bucket_info)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void TuningRecordDatabase::Commit(const common::Target& target,
+                                  const TuningRecord& record) {
+  group_schedule::config::proto::TuningRecord proto;
+  proto.set_target(TargetKey(target));
+  proto.set_group_signature(record.group_signature);
+  for (const auto& dim : record.bucket_info.space) {
+    auto* proto_dim = proto.mutable_bucket_info()->add_dimension();
+    proto_dim->set_lower_bound(dim.lower_bound);
+    proto_dim->set_upper_bound(dim.upper_bound);
+    proto_dim->set_iter_type(dim.iter_type);
+    proto_dim->set_is_dynamic(dim.is_dynamic);
+  }
+  proto.mutable_tile_config()->set_warp_num(record.tile_config.warp_num);
+  proto.mutable_tile_config()->set_tree_reduce_num(
+      record.tile_config.tree_reduce_num);
+  proto.mutable_tile_config()->set_spatial_inner_num(
+      record.tile_config.spatial_inner_num);
+  proto.set_grid_reduce_num(record.tile_config.grid_reduce_num);
+  proto.set_reduce_method(
+      static_cast<int>(record.tile_config.reduce_method.index()));
+  proto.set_score(record.score);
+
+  std::string json_string;
+  auto status =
+      google::protobuf::util::MessageToJsonString(proto, &json_string);
+  PADDLE_ENFORCE_EQ(status.ok(),
+                    true,
+                    ::common::errors::InvalidArgument(
+                        "Failed to serialize tuning record of group %s",
+                        record.group_signature));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Insert(RecordKey(proto.target(), record.group_signature), record);
+  std::ofstream os(path_, std::ofstream::app);
+  PADDLE_ENFORCE_EQ(os.good(),
+                    true,
+                    ::common::errors::InvalidArgument(
+                        "Cannot open the tuning database to write: %s", path_));
+  // one write per line, so appends of concurrent processes don't interleave
+  os << json_string + "\n";
+  os.flush();
+  VLOG(3) << "Add tuning record: " << json_string;
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/ir/group_schedule/config/group_tile_config.h"
+
+namespace cinn {
+namespace ir {
+
+/**
+ * The measured best tile config of one fusion group on one shape bucket.
+ * For a static shape group the bucket holds the exact spatial and reduce
+ * numel, see TuningBucketOf.
+ */
+struct TuningRecord {
+  std::string group_signature;
+  BucketInfo bucket_info;
+  ScheduleConfig::TileConfig tile_config;
+  // measured kernel time of the tuning run, only for reference
+  double score{0.0};
+};
+
+/**
+ * The bucket a tuning record of the group is keyed by: the exact extents for
+ * a static shape group, or the bucket of the config itself otherwise.
+ */
+BucketInfo TuningBucketOf(const ScheduleConfig::BaseInfo& base_info,
+                          const BucketInfo& config_bucket);
+
+bool IsSameBucketSpace(const BucketInfo& lhs, const BucketInfo& rhs);
+
+/**
+ * A persistent database of tuning records, stored as one json line per record
+ * in an append-only file so that later runs and other processes reuse the
+ * results. A later line overrides an earlier one with the same target, group
+ * signature and bucket.
+ */
+class TuningRecordDatabase {
+ public:
+  explicit TuningRecordDatabase(const std::string& path);
+
+  const std::string& path() const { return path_; }
+
+  std::vector<TuningRecord> GetRecords(
+      const common::Target& target, const std::string& group_signature) const;
+
+  bool HasRecord(const common::Target& target,
+                 const std::string& group_signature,
+                 const BucketInfo& bucket_info) const;
+
+  void Commit(const common::Target& target, const TuningRecord& record);
+
+ private:
+  void Load();
+  void Insert(const std::string& key, const TuningRecord& record);
+
+  std::string path_;
+  mutable std::mutex mutex_;
+  // target + group signature -> records of all its buckets
+  std::unordered_map<std::string, std::vector<TuningRecord>> records_;
+};
+
+}  // namespace ir
+}  // namespace cinn
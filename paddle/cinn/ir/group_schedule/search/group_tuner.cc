@@ -0,0 +1,236 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/ir/group_schedule/search/group_tuner.h"
+
+#include "paddle/cinn/utils/string.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_bool(cinn_measure_kernel_time);
+PD_DECLARE_string(cinn_tuning_database_file);
+PHI_DECLARE_bool(enable_cinn_compile_cache);
+
+namespace cinn {
+namespace ir {
+namespace search {
+
+namespace {
+
+constexpr int kThreadsPerWarp = 32;
+constexpr int kMaxWarpNum = 32;
+constexpr int kMaxTreeReduceNum = 1024;
+constexpr int kMaxSpatialInnerNum = 8;
+
+bool IsPow2(int64_t n) { return n > 0 && (n & (n - 1)) == 0; }
+
+int64_t CeilPow2(int64_t n) {
+  int64_t pow = 1;
+  while (pow < n) {
+    pow *= 2;
+  }
+  return pow;
+}
+
+bool IsReduceLast(const ScheduleConfig::BaseInfo& base_info) {
+  return !base_info.iter_space_type.empty() &&
+         base_info.iter_space_type.back().first == "R";
+}
+
+// Measuring needs kernel timing and a recompile for every candidate
+class TuningFlagsGuard {
+ public:
+  explicit TuningFlagsGuard(const std::string& database_file)
+      : measure_kernel_time_(FLAGS_cinn_measure_kernel_time),
+        enable_compile_cache_(FLAGS_enable_cinn_compile_cache),
+        database_file_(FLAGS_cinn_tuning_database_file) {
+    FLAGS_cinn_measure_kernel_time = true;
+    FLAGS_enable_cinn_compile_cache = false;
+    FLAGS_cinn_tuning_database_file = database_file;
+  }
+  ~TuningFlagsGuard() {
+    FLAGS_cinn_measure_kernel_time = measure_kernel_time_;
+    FLAGS_enable_cinn_compile_cache = enable_compile_cache_;
+    FLAGS_cinn_tuning_database_file = database_file_;
+  }
+
+ private:
+  bool measure_kernel_time_;
+  bool enable_compile_cache_;
+  std::string database_file_;
+};
+
+}  // namespace
+
+std::vector<CandidateType> TuningCandidates(const TuningTask& task,
+                                            int max_trials) {
+  const ScheduleConfig::BaseInfo& base_info = *task.base_info;
+  const bool reduce_last = IsReduceLast(base_info);
+  const int64_t spatial_numel = base_info.spatial_numel;
+  const int64_t reduce_numel = base_info.reduce_numel;
+
+  // candidate = {warp_num, tree_reduce_num, spatial_inner_num}
+  std::vector<std::pair<int, int>> candidate_range{
+      {1, kMaxWarpNum}, {1, kMaxTreeReduceNum}, {1, kMaxSpatialInnerNum}};
+  std::vector<ConstraintFunc> constraints;
+  constraints.emplace_back([](const CandidateType& candidate) {
+    return IsPow2(candidate[1]) && IsPow2(candidate[2]);
+  });
+  constraints.emplace_back([](const CandidateType& candidate) {
+    return candidate[0] <= 4 || candidate[0] % 4 == 0;
+  });
+  // reduce threads are a divisor of the block
+  constraints.emplace_back([](const CandidateType& candidate) {
+    int64_t threads = candidate[0] * kThreadsPerWarp;
+    return candidate[1] <= threads && threads % candidate[1] == 0;
+  });
+  constraints.emplace_back([&](const CandidateType& candidate) {
+    if (reduce_numel <= 1) {
+      return candidate[1] == 1;
+    }
+    if (reduce_last) {
+      // keep the low 32 threads on the contiguous reduce axis
+      return candidate[1] >= kThreadsPerWarp &&
+             candidate[1] <= std::max<int64_t>(CeilPow2(reduce_numel),
+                                               kThreadsPerWarp);
+    }
+    return candidate[1] <= std::min<int64_t>(CeilPow2(reduce_numel), 16);
+  });
+  // don't launch more spatial work per block than there is
+  constraints.emplace_back([&](const CandidateType& candidate) {
+    int64_t spatial_threads =
+        candidate[0] * kThreadsPerWarp / candidate[1] * candidate[2];
+    return spatial_threads <=
+           std::max<int64_t>(CeilPow2(spatial_numel), kThreadsPerWarp);
+  });
+  // inner loops go to either the reduce or the spatial axis
+  constraints.emplace_back([&](const CandidateType& candidate) {
+    return candidate[2] == 1 || reduce_numel <= candidate[1];
+  });
+
+  std::vector<CandidateType> candidates =
+      CandidateGenerator(candidate_range, constraints).Candidates();
+  if (max_trials <= 0 ||
+      candidates.size() <= static_cast<size_t>(max_trials)) {
+    return candidates;
+  }
+  std::vector<CandidateType> sampled;
+  sampled.reserve(max_trials);
+  for (int i = 0; i < max_trials; ++i) {
+    sampled.push_back(candidates[i * candidates.size() / max_trials]);
+  }
+  return sampled;
+}
+
+ScheduleConfig::TileConfig CandidateToTileConfig(
+    const TuningTask& task, const CandidateType& candidate) {
+  ScheduleConfig::TileConfig config = task.tile_config;
+  config.warp_num = candidate[0];
+  config.tree_reduce_num = candidate[1];
+  config.spatial_inner_num = candidate[2];
+  if (task.base_info->reduce_numel <= 1 || candidate[1] == 1) {
+    config.reduce_method = NoneReduceMethod();
+  } else if (!IsReduceLast(*task.base_info)) {
+    config.reduce_method = DiscreteReduceMethod();
+  } else if (candidate[1] == kThreadsPerWarp) {
+    config.reduce_method = WarpReduceMethod();
+  } else {
+    config.reduce_method = BlockReduceMethod();
+  }
+  return config;
+}
+
+GroupScheduleTuner::GroupScheduleTuner(
+    ::pir::Program* program,
+    const std::unordered_map<std::string, std::vector<int64_t>>&
+        input_name_and_shape,
+    const std::shared_ptr<TuningRecordDatabase>& database,
+    const GroupTuningOptions& options)
+    : program_(program),
+      input_name_and_shape_(input_name_and_shape),
+      database_(database),
+      options_(options) {
+  PADDLE_ENFORCE_NOT_NULL(
+      database_,
+      ::common::errors::InvalidArgument(
+          "GroupScheduleTuner needs a database to commit records to."));
+}
+
+ScoreType GroupScheduleTuner::Measure() {
+  Measurer measurer(program_);
+  measurer.Compile();
+  measurer.Run(input_name_and_shape_, options_.repeats);
+  return measurer.Result().avg_kernel_execute_time.count();
+}
+
+int GroupScheduleTuner::Tune() {
+  TuningFlagsGuard flags_guard(database_->path());
+  auto& schedule_config_manager = ScheduleConfigManager::Instance();
+  schedule_config_manager.SetTuningDatabase(database_);
+
+  // Step 1: Compile and run once to find the groups and their buckets.
+  schedule_config_manager.StartCollectTuningTasks();
+  Measure();
+  std::vector<TuningTask> tasks =
+      schedule_config_manager.StopCollectTuningTasks();
+
+  // Step 2: Measure the candidates of every group not tuned yet.
+  int committed = 0;
+  for (const TuningTask& task : tasks) {
+    if (database_->HasRecord(
+            task.target, task.group_signature, task.bucket_info) &&
+        !options_.retune) {
+      VLOG(3) << "Skip tuned group " << task.group_signature;
+      continue;
+    }
+    // the config in use is a candidate too, tuning never makes it slower
+    TuningRecord best{
+        task.group_signature, task.bucket_info, task.tile_config, Measure()};
+    std::vector<CandidateType> candidates =
+        TuningCandidates(task, options_.max_trials_per_group);
+    for (const CandidateType& candidate : candidates) {
+      TuningRecord trial{task.group_signature,
+                         task.bucket_info,
+                         CandidateToTileConfig(task, candidate),
+                         0.0};
+      schedule_config_manager.SetTuningOverride(trial);
+      try {
+        trial.score = Measure();
+      } catch (const std::exception& e) {
+        VLOG(3) << "Candidate " << utils::Join<int64_t>(candidate, ", ")
+                << " failed: " << e.what();
+        continue;
+      }
+      VLOG(4) << "Candidate " << utils::Join<int64_t>(candidate, ", ")
+              << " score = " << trial.score;
+      if (trial.score < best.score) {
+        best = trial;
+      }
+    }
+    schedule_config_manager.ClearTuningOverride();
+    database_->Commit(task.target, best);
+    ++committed;
+    LOG(INFO) << "Tuned group " << task.group_signature << " on "
+              << task.bucket_info.ToString() << " over " << candidates.size()
+              << " candidates, best: warp_num = " << best.tile_config.warp_num
+              << ", tree_reduce_num = " << best.tile_config.tree_reduce_num
+              << ", spatial_inner_num = "
+              << best.tile_config.spatial_inner_num
+              << ", score = " << best.score;
+  }
+  return committed;
+}
+
+}  // namespace search
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,82 @@
+// Copyright (c) 2024 CINN Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/cinn/ir/group_schedule/config/schedule_config_manager.h"
+#include "paddle/cinn/ir/group_schedule/config/tuning_database.h"
+#include "paddle/cinn/ir/group_schedule/search/config_searcher.h"
+#include "paddle/pir/include/core/program.h"
+
+namespace cinn {
+namespace ir {
+namespace search {
+
+struct GroupTuningOptions {
+  // candidates measured per group, spread evenly over the valid ones
+  int max_trials_per_group = 64;
+  int repeats = 20;
+  // measure groups again even if the database has a record for them
+  bool retune = false;
+};
+
+/**
+ * The valid (warp_num, tree_reduce_num, spatial_inner_num) candidates of a
+ * static shape group, at most max_trials of them.
+ */
+std::vector<CandidateType> TuningCandidates(const TuningTask& task,
+                                            int max_trials);
+
+ScheduleConfig::TileConfig CandidateToTileConfig(
+    const TuningTask& task, const CandidateType& candidate);
+
+/**
+ * Tunes the tile configs of all static shape fusion groups of a program on
+ * the device and commits the best config of each group and shape bucket to a
+ * tuning database. The compiler reuses the records for the same group
+ * signature and bucket whenever FLAGS_cinn_tuning_database_file points to the
+ * database.
+ *
+ * Like Measurer, the program takes float inputs of the given names and
+ * shapes and fetches "out". Each candidate recompiles the program with the
+ * candidate forced on one group, and is scored by the total kernel time.
+ */
+class GroupScheduleTuner {
+ public:
+  GroupScheduleTuner(::pir::Program* program,
+                     const std::unordered_map<std::string, std::vector<int64_t>>&
+                         input_name_and_shape,
+                     const std::shared_ptr<TuningRecordDatabase>& database,
+                     const GroupTuningOptions& options = GroupTuningOptions());
+
+  // Returns the number of records committed to the database.
+  int Tune();
+
+ private:
+  ScoreType Measure();
+
+  ::pir::Program* program_;
+  std::unordered_map<std::string, std::vector<int64_t>> input_name_and_shape_;
+  std::shared_ptr<TuningRecordDatabase> database_;
+  GroupTuningOptions options_;
+};
+
+}  // namespace search
+}  // namespace ir
+}  // namespace cinn
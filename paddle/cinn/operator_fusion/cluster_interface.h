@@ -72,11 +72,15 @@ inline std::vector<fusion::PatternNodePtr> ClusterOps(
   const auto& iters_fusion_policy =
       std::make_shared<fusion::ItersFusionPolicy>(iters_manager);
 
+  const auto& fusion_cost_policy =
+      std::make_shared<fusion::FusionCostPolicy>(outputs);
+
   fusion::PolicyManager policy_manager;
 
   policy_manager.SetPolicy(relative_judge_policy);
   policy_manager.SetPolicy(general_topo_policy);
   policy_manager.SetPolicy(iters_fusion_policy);
+  policy_manager.SetPolicy(fusion_cost_policy);
 
   VLOG(4) << "Start Create PatternGraph";
   fusion::PatternGraph graph(content_without_yield, outputs, policy_manager);
@@ -157,7 +157,10 @@ struct CanFuseItersPermutationMatcher {
            (graph.iters_fusion_policy()->CanFuseSource2Target(downstream,
                                                               upstream) ||
             graph.iters_fusion_policy()->CanFuseSource2Target(upstream,
-                                                              downstream));
+                                                              downstream)) &&
+           graph.policy_manager()
+               .template GetPolicy<FusionCostPolicy>()
+               ->CanFuse(upstream, downstream);
   }
 };
 
@@ -191,7 +194,10 @@ struct RecomputeNodeMatcher {
     };
 
     return StmtPatternGraphMatcher<ItersPermutationPattern>()(graph, node) &&
-           node->downstream().size() >= 1 && can_recompute_fn(node);
+           node->downstream().size() >= 1 && can_recompute_fn(node) &&
+           graph.policy_manager()
+               .template GetPolicy<FusionCostPolicy>()
+               ->CanRecompute(node);
   }
 };
 
@@ -361,6 +367,16 @@ struct HorizontalFusionConstrain {
   }
 };
 
+struct HorizontalFusionCostConstrain {
+  bool operator()(const PatternGraph& graph,
+                  const PatternNodePtr& lhs,
+                  const PatternNodePtr& rhs) {
+    return graph.policy_manager()
+        .GetPolicy<FusionCostPolicy>()
+        ->CanHorizontalFuse(lhs, rhs);
+  }
+};
+
 /*
  * We must limit the output + input + shape_info number and make sure
  * the number is smaller than 512.
@@ -190,9 +190,10 @@ void PatternGraph::HorizontalFusion() {
   GraphTransformer<NodePairPattern,
                    And<HorizontalFusionConstrain,
                        InputOutputMaximumConstrain,
-                       HorizontalCheckMiddleOutputVar>,  // Avoid two many
-                                                         // inputs and
-                                                         // outputs.
+                       HorizontalCheckMiddleOutputVar,  // Avoid two many
+                                                        // inputs and
+                                                        // outputs.
+                       HorizontalFusionCostConstrain>,
                    HorizontalFusionOperation>(this);
 }
 
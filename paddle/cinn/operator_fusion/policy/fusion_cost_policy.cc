@@ -0,0 +1,210 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/operator_fusion/policy/fusion_cost_policy.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_bool(cinn_fusion_cost_model);
+COMMON_DECLARE_bool(cinn_fusion_decision_dump);
+
+namespace cinn::fusion {
+
+int64_t EstimateValueBytes(pir::Value value) {
+  if (!value || !value.type() || !value.type().isa<pir::DenseTensorType>()) {
+    return 0;
+  }
+  int64_t numel = 1;
+  for (const auto& dim : GetDimExprsFromValue(value)) {
+    numel *= dim.isa<std::int64_t>() ? dim.dyn_cast<std::int64_t>()
+                                     : FusionCostPolicy::kDynamicDimSize;
+  }
+  const auto& dtype = hlir::framework::pir::CompatibleInfo::ConvertIRType(
+      value.type().dyn_cast<pir::DenseTensorType>().dtype());
+  return numel * std::max(dtype.bytes(), 1);
+}
+
+namespace {
+
+bool NeedCost() {
+  return FLAGS_cinn_fusion_cost_model || FLAGS_cinn_fusion_decision_dump;
+}
+
+int64_t CountReduce(const std::vector<pir::Operation*>& ops) {
+  return std::count_if(ops.begin(), ops.end(), [](pir::Operation* op) {
+    return GetOpPatternKind(op) == hlir::framework::kReduction;
+  });
+}
+
+// the values used by ops but not produced by them
+std::vector<pir::Value> ExternalInputs(
+    const std::vector<pir::Operation*>& ops) {
+  return VectorDiff(GetInputsValue(ops), GetOutputsValue(ops));
+}
+
+}  // namespace
+
+bool FusionCostPolicy::CanFuse(const PatternNodePtr& upstream,
+                               const PatternNodePtr& downstream) {
+  if (!NeedCost()) return true;
+  const auto& upstream_ops = upstream->ops();
+  const auto& downstream_ops = downstream->ops();
+  const std::unordered_set<pir::Operation*> upstream_set(upstream_ops.begin(),
+                                                         upstream_ops.end());
+  const std::unordered_set<pir::Operation*> downstream_set(
+      downstream_ops.begin(), downstream_ops.end());
+
+  FusionCost cost;
+  for (const auto& value : GetOutputsValue(upstream_ops)) {
+    bool used_by_downstream = false;
+    bool used_outside = false;
+    for (auto it = value.use_begin(); it != value.use_end(); ++it) {
+      if (downstream_set.count(it->owner())) {
+        used_by_downstream = true;
+      } else if (!upstream_set.count(it->owner())) {
+        used_outside = true;
+      }
+    }
+    if (!used_by_downstream) continue;
+    // The read of downstream is always saved, the write only when nothing
+    // outside the merged group needs the value.
+    const int64_t bytes = EstimateValueBytes(value);
+    cost.saved_bytes += bytes;
+    if (!used_outside && !outputs_.count(value)) {
+      cost.saved_bytes += bytes;
+    }
+  }
+  const int64_t upstream_reduce = CountReduce(upstream_ops);
+  const int64_t downstream_reduce = CountReduce(downstream_ops);
+  cost.num_reduce = upstream_reduce + downstream_reduce;
+
+  if (upstream_reduce > 0 && downstream_reduce > 0 &&
+      cost.num_reduce > kMaxReduceNum) {
+    return Decide("Vertical",
+                  upstream->id() + " -> " + downstream->id(),
+                  cost,
+                  false,
+                  "too many reductions in one group");
+  }
+  return Decide("Vertical",
+                upstream->id() + " -> " + downstream->id(),
+                cost,
+                true,
+                "intermediates stay on chip");
+}
+
+bool FusionCostPolicy::CanHorizontalFuse(const PatternNodePtr& lhs,
+                                         const PatternNodePtr& rhs) {
+  if (!NeedCost()) return true;
+  const auto& lhs_ops = lhs->ops();
+  const auto& rhs_ops = rhs->ops();
+
+  FusionCost cost;
+  const auto& rhs_inputs = ExternalInputs(rhs_ops);
+  const std::unordered_set<pir::Value> rhs_input_set(rhs_inputs.begin(),
+                                                     rhs_inputs.end());
+  for (const auto& value : ExternalInputs(lhs_ops)) {
+    if (rhs_input_set.count(value)) {
+      cost.saved_bytes += EstimateValueBytes(value);
+    }
+  }
+  const int64_t lhs_reduce = CountReduce(lhs_ops);
+  const int64_t rhs_reduce = CountReduce(rhs_ops);
+  cost.num_reduce = lhs_reduce + rhs_reduce;
+
+  const std::string candidate = lhs->id() + " | " + rhs->id();
+  if (lhs_reduce > 0 && rhs_reduce > 0) {
+    if (cost.num_reduce > kMaxReduceNum) {
+      return Decide("Horizontal",
+                    candidate,
+                    cost,
+                    false,
+                    "too many reductions in one group");
+    }
+    if (cost.saved_bytes == 0) {
+      return Decide("Horizontal",
+                    candidate,
+                    cost,
+                    false,
+                    "sibling reductions share no input");
+    }
+    return Decide("Horizontal",
+                  candidate,
+                  cost,
+                  true,
+                  "sibling reductions read shared inputs once");
+  }
+  return Decide("Horizontal", candidate, cost, true, "saves a kernel launch");
+}
+
+bool FusionCostPolicy::CanRecompute(const PatternNodePtr& node) {
+  if (!NeedCost()) return true;
+  const auto& ops = node->ops();
+  const int64_t num_downstream = node->downstream().size();
+
+  FusionCost cost;
+  int64_t output_bytes = 0;
+  bool is_output = false;
+  for (const auto& value :
+       VectorDiff(GetOutputsValue(ops), GetInputsValue(ops))) {
+    output_bytes += EstimateValueBytes(value);
+    is_output = is_output || outputs_.count(value);
+  }
+  // Without recomputation the node writes its outputs once and every
+  // downstream reads them back; with it every downstream reads the inputs of
+  // the node and does its work again.
+  cost.saved_bytes = output_bytes * num_downstream;
+  if (!is_output) {
+    cost.saved_bytes += output_bytes;
+  }
+  for (const auto& value : ExternalInputs(ops)) {
+    cost.extra_bytes += EstimateValueBytes(value) * num_downstream;
+  }
+  cost.redundant_compute = (num_downstream - 1) *
+                           static_cast<int64_t>(ops.size()) * output_bytes;
+
+  const int64_t recompute_cost =
+      cost.extra_bytes + cost.redundant_compute / kComputePerByte;
+  if (recompute_cost > cost.saved_bytes) {
+    return Decide("Recompute",
+                  node->id(),
+                  cost,
+                  false,
+                  "recomputation costs more than the traffic it saves");
+  }
+  return Decide("Recompute",
+                node->id(),
+                cost,
+                true,
+                "recomputation is cheaper than a round trip");
+}
+
+bool FusionCostPolicy::Decide(const std::string& kind,
+                              const std::string& candidate,
+                              const FusionCost& cost,
+                              bool profitable,
+                              const std::string& reason) {
+  const bool accepted = profitable || !FLAGS_cinn_fusion_cost_model;
+  if (FLAGS_cinn_fusion_decision_dump) {
+    LOG(INFO) << "[FusionCost] " << kind << " " << candidate << ": "
+              << (accepted ? "accept" : "reject") << ", " << reason
+              << (accepted && !profitable ? " (cost model disabled)" : "")
+              << ", saved_bytes=" << cost.saved_bytes
+              << ", extra_bytes=" << cost.extra_bytes
+              << ", redundant_compute=" << cost.redundant_compute
+              << ", num_reduce=" << cost.num_reduce;
+  }
+  return accepted;
+}
+
+}  // namespace cinn::fusion
@@ -0,0 +1,72 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "paddle/cinn/operator_fusion/pattern_node.h"
+#include "paddle/cinn/operator_fusion/policy/policy_base.h"
+
+namespace cinn::fusion {
+
+// The estimated cost of merging two pattern nodes. Bytes are global memory
+// traffic, dynamic dims are counted as kDynamicDimSize.
+struct FusionCost {
+  // traffic removed by the merge, e.g. intermediates that are no longer
+  // written and read back, or shared inputs that are read only once
+  int64_t saved_bytes = 0;
+  // traffic added by the merge, e.g. inputs read again by recomputation
+  int64_t extra_bytes = 0;
+  // elementwise work done more than once because of recomputation
+  int64_t redundant_compute = 0;
+  // reductions in the merged group, a proxy of register pressure
+  int64_t num_reduce = 0;
+};
+
+// Estimates the memory traffic and redundant compute of candidate merges and
+// rejects the unprofitable ones when FLAGS_cinn_fusion_cost_model is set.
+// FLAGS_cinn_fusion_decision_dump logs every decision with its reason.
+class FusionCostPolicy final : public PolicyBase {
+ public:
+  explicit FusionCostPolicy(const std::vector<pir::Value>& outputs)
+      : outputs_(outputs.begin(), outputs.end()) {}
+  static constexpr PolicyKind Kind = PolicyKind::FusionCost;
+  std::string Name() { return "FusionCostPolicy"; }
+
+  // upstream and downstream are fused into one loop
+  bool CanFuse(const PatternNodePtr& upstream,
+               const PatternNodePtr& downstream);
+  // lhs and rhs are independent and fused side by side
+  bool CanHorizontalFuse(const PatternNodePtr& lhs, const PatternNodePtr& rhs);
+  // node is recomputed in each of its downstreams
+  bool CanRecompute(const PatternNodePtr& node);
+
+  static constexpr int64_t kDynamicDimSize = 1024;
+  // more reductions than this in one group tend to spill registers
+  static constexpr int64_t kMaxReduceNum = 8;
+  // compute is cheaper than traffic, weighted by a rough arithmetic
+  // intensity of the devices
+  static constexpr int64_t kComputePerByte = 8;
+
+ private:
+  bool Decide(const std::string& kind,
+              const std::string& candidate,
+              const FusionCost& cost,
+              bool profitable,
+              const std::string& reason);
+
+  std::unordered_set<pir::Value> outputs_;
+};
+
+int64_t EstimateValueBytes(pir::Value value);
+
+}  // namespace cinn::fusion
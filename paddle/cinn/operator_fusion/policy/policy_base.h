@@ -18,7 +18,12 @@
 
 namespace cinn::fusion {
 
-enum PolicyKind { GeneralTopo = 1, RelativeJudge = 2, ItersFusion = 3 };
+enum PolicyKind {
+  GeneralTopo = 1,
+  RelativeJudge = 2,
+  ItersFusion = 3,
+  FusionCost = 4
+};
 
 struct PolicyKindHash {
   std::size_t operator()(const PolicyKind& t) const {
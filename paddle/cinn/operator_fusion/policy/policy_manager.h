@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/cinn/operator_fusion/pattern_node.h"
+#include "paddle/cinn/operator_fusion/policy/fusion_cost_policy.h"
 #include "paddle/cinn/operator_fusion/policy/general_topo_policy.h"
 #include "paddle/cinn/operator_fusion/policy/iters_fusion_policy.h"
 #include "paddle/cinn/operator_fusion/policy/policy_base.h"
@@ -29,6 +29,7 @@
 #include "paddle/cinn/optim/lower_function_call_bind_vars.h"
 #include "paddle/cinn/optim/lower_intrin.h"
 #include "paddle/cinn/optim/map_extern_call.h"
+#include "paddle/cinn/optim/parallelize_host_loops.h"
 #include "paddle/cinn/optim/rearrange_load_instruction.h"
 #include "paddle/cinn/optim/remove_schedule_block.h"
 #include "paddle/cinn/optim/replace_const_param_to_integer.h"
@@ -112,6 +113,16 @@ ir::LoweredFunc Optimize(ir::LoweredFunc fn,
   Simplify(&copied->body);
   VLOG(10) << "After Optimize Simplify" << copied;
 
+  target.arch.Match(
+      [&](common::X86Arch) {
+        ParallelizeHostLoops(&copied->body);
+        VLOG(10) << "After ParallelizeHostLoops:" << copied;
+      },
+      [&](std::variant<common::UnknownArch,
+                       common::ARMArch,
+                       common::NVGPUArch,
+                       common::HygonDCUArchHIP>) {});
+
   RemoveScheduleBlock(&copied->body);
   VLOG(10) << "After RemoveScheduleBlock:" << copied;
 
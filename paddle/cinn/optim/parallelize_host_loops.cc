@@ -0,0 +1,143 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/optim/parallelize_host_loops.h"
+
+#include "paddle/cinn/common/cas.h"
+#include "paddle/cinn/ir/ir_analyzer/ir_analyzer.h"
+#include "paddle/cinn/ir/ir_mutator.h"
+#include "paddle/cinn/ir/utils/ir_copy.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+#include "paddle/common/flags.h"
+
+PD_DECLARE_int64(cinn_cpu_parallel_min_work);
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+bool UseVar(const ir::Expr& expr,
+            const ir::Var& var,
+            const std::set<std::string>& iter_vars) {
+  auto var_use = ir::ir_utils::CollectIRNodes(
+      expr,
+      [&](const ir::Expr* x) {
+        return x->is_var() && (x->as_var_ref() == var ||
+                               iter_vars.count(x->as_var()->name) > 0);
+      },
+      /* uniq_target = */ true);
+  return var_use.size() > 0;
+}
+
+// Check whether var only binds spatial iterators of the block and the block
+// stores to a different element in each iteration of var.
+bool IsSpatialLoopVarOf(const ir::Expr& block, const ir::Var& var) {
+  auto* block_realize = block.As<ir::ScheduleBlockRealize>();
+  auto* schedule_block = block_realize->schedule_block.As<ir::ScheduleBlock>();
+  std::set<std::string> ref_iter_vars;
+  for (int i = 0; i < block_realize->iter_values.size(); ++i) {
+    if (!UseVar(block_realize->iter_values[i], var, {})) continue;
+    if (schedule_block->iter_vars[i]->is_reduce_axis) return false;
+    ref_iter_vars.insert(schedule_block->iter_vars[i]->name);
+  }
+  auto* store = ir::analyzer::GetStoreOfSBlock(block).As<ir::Store>();
+  if (store == nullptr) return false;
+  for (const ir::Expr& index : store->indices) {
+    if (UseVar(index, var, ref_iter_vars)) return true;
+  }
+  return false;
+}
+
+bool CanParallelize(const ir::Expr& loop) {
+  auto* node = loop.As<ir::For>();
+  if (!node->is_serial() || !node->min.is_constant() ||
+      node->min.get_constant() != 0) {
+    return false;
+  }
+  auto inner_loops = ir::ir_utils::CollectIRNodesWithoutTensor(
+      node->body, [](const ir::Expr* x) {
+        return x->As<ir::For>() && (x->As<ir::For>()->is_parallel() ||
+                                    x->As<ir::For>()->is_binded());
+      });
+  if (!inner_loops.empty()) return false;
+
+  auto blocks = ir::ir_utils::CollectIRNodesWithoutTensor(
+      node->body,
+      [](const ir::Expr* x) { return x->As<ir::ScheduleBlockRealize>(); });
+  if (blocks.empty()) return false;
+  for (const ir::Expr& block : blocks) {
+    if (!IsSpatialLoopVarOf(block, node->loop_var)) return false;
+  }
+  return true;
+}
+
+// The number of iterations of the perfectly nested loops starting at loop.
+ir::Expr LoopNestWork(const ir::Expr& loop) {
+  ir::Expr work = ir::Expr(int64_t(1));
+  const ir::For* node = loop.As<ir::For>();
+  while (node) {
+    work = ir::Mul::Make(work,
+                         ir::Cast::Make(cinn::common::Int(64), node->extent));
+    const ir::Expr* body = &node->body;
+    if (body->As<ir::Block>() && body->As<ir::Block>()->stmts.size() == 1) {
+      body = &body->As<ir::Block>()->stmts[0];
+    }
+    node = body->As<ir::For>();
+  }
+  return cinn::common::AutoSimplify(work);
+}
+
+struct HostLoopParallelizer : public ir::IRMutator<> {
+  using ir::IRMutator<>::Visit;
+  void operator()(ir::Expr* expr) { ir::IRMutator<>::Visit(expr, expr); }
+
+  void Visit(const ir::For* op, ir::Expr* expr) override {
+    // only the outermost loops in the root schedule block, the runtime does
+    // not support nested parallel loops
+    if (!in_root_ || !CanParallelize(*expr)) return;
+
+    ir::Expr work = LoopNestWork(*expr);
+    const int64_t min_work = FLAGS_cinn_cpu_parallel_min_work;
+    if (work.is_constant()) {
+      if (static_cast<int64_t>(work.get_constant()) >= min_work) {
+        expr->As<ir::For>()->set_parallel();
+      }
+      return;
+    }
+    ir::Expr parallel_loop = ir::ir_utils::IRCopy(*expr);
+    parallel_loop.As<ir::For>()->set_parallel();
+    ir::Expr cond = ir::GE::Make(work, ir::Expr(min_work));
+    *expr = ir::IfThenElse::Make(cond, parallel_loop, *expr);
+  }
+
+  void Visit(const ir::ScheduleBlockRealize* op, ir::Expr* expr) override {
+    auto* schedule_block = op->schedule_block.As<ir::ScheduleBlock>();
+    if (schedule_block->name.substr(0, 4) == "root") {
+      in_root_ = true;
+      ir::IRMutator<>::Visit(op, expr);
+      in_root_ = false;
+    }
+  }
+
+ private:
+  bool in_root_{false};
+};
+
+}  // namespace
+
+void ParallelizeHostLoops(ir::Expr* expr) { HostLoopParallelizer()(expr); }
+
+}  // namespace optim
+}  // namespace cinn
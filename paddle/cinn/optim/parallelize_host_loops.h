@@ -0,0 +1,67 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "paddle/cinn/ir/ir.h"
+
+namespace cinn {
+namespace optim {
+
+/**
+ * Parallelize the outermost serial loops of host functions, so that the
+ * iterations are distributed over the threads of the CPU runtime.
+ *
+ * A loop is parallelized if:
+ * (1) It starts from 0 and contains no parallel or bound loops.
+ * (2) Its loop variable is a spatial iterator of every child schedule block,
+ *     i.e. it is never used as a reduce axis and it always appears in the
+ *     store indices, so that different iterations never write to the same
+ *     element.
+ * (3) The loop nest is large enough to pay for launching the threads, which
+ *     is FLAGS_cinn_cpu_parallel_min_work elements. When the extents are not
+ *     constant, the decision is made at runtime.
+ *
+ * The inner loops are left serial, the innermost contiguous loop is
+ * vectorized by the LLVM loop vectorizer.
+ *
+ * Example 1:
+ *   serial for (i, 0, 1024):
+ *     serial for (j, 0, 256):
+ *       ScheduleBlock(A):
+ *         i0, i1 = axis.bind(i, j)
+ *         A[i0, i1] = B[i0, i1] + C[i0, i1]
+ * =>
+ *   parallel for (i, 0, 1024):
+ *     serial for (j, 0, 256):
+ *       ...
+ *
+ *
+ * Example 2:
+ *   serial for (i, 0, S0):
+ *     serial for (j, 0, 256):
+ *       ScheduleBlock(A):
+ *         i0, i1 = axis.bind(i, j)
+ *         A[i0] = A[i0] + B[i0, i1]    # i1 is a reduce axis
+ * =>
+ *   if (S0 * 256 >= min_work):
+ *     parallel for (i, 0, S0):
+ *       ...
+ *   else:
+ *     serial for (i, 0, S0):
+ *       ...
+ */
+void ParallelizeHostLoops(ir::Expr* expr);
+
+}  // namespace optim
+}  // namespace cinn
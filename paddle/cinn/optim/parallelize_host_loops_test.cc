@@ -0,0 +1,108 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/cinn/optim/parallelize_host_loops.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "paddle/cinn/cinn.h"
+#include "paddle/cinn/ir/ir.h"
+#include "paddle/cinn/ir/ir_printer.h"
+#include "paddle/cinn/ir/utils/ir_nodes_collector.h"
+
+namespace cinn {
+namespace optim {
+
+namespace {
+
+std::vector<const ir::For*> GetParallelLoops(const ir::Expr& body) {
+  std::vector<const ir::For*> loops;
+  ir::ir_utils::CollectIRNodesWithoutTensor(body, [&](const ir::Expr* x) {
+    if (x->As<ir::For>() && x->As<ir::For>()->is_parallel()) {
+      loops.push_back(x->As<ir::For>());
+    }
+    return false;
+  });
+  return loops;
+}
+
+}  // namespace
+
+TEST(ParallelizeHostLoops, Elementwise) {
+  Context::Global().ResetNameId();
+  Placeholder<float> A("A", {Expr(1024), Expr(256)});
+  ir::Tensor B = Compute(
+      {Expr(1024), Expr(256)},
+      [&](Var i, Var j) { return A(i, j) + Expr(1.f); },
+      "B");
+  ast_gen_ius::TensorGroup tensor_group({A, B});
+  auto func = lang::LowerToAst("elementwise", {A, B}, &tensor_group);
+
+  ir::Expr body = func->body;
+  ParallelizeHostLoops(&body);
+  VLOG(6) << "After ParallelizeHostLoops: " << body;
+
+  auto loops = GetParallelLoops(body);
+  ASSERT_EQ(loops.size(), 1UL);
+  EXPECT_EQ(loops[0]->extent.as_int32(), 1024);
+}
+
+TEST(ParallelizeHostLoops, ReduceSpatialAxis) {
+  Context::Global().ResetNameId();
+  Placeholder<float> A("A", {Expr(1024), Expr(128)});
+  Var reduce_j(128, "reduce_j");
+  ir::Tensor B = Compute(
+      {Expr(1024)},
+      [&](Var i) { return lang::ReduceSum(A(i, reduce_j), {reduce_j}); },
+      "B");
+  ast_gen_ius::TensorGroup tensor_group({A, B});
+  auto func = lang::LowerToAst("reduce_sum", {A, B}, &tensor_group);
+
+  ir::Expr body = func->body;
+  ParallelizeHostLoops(&body);
+  VLOG(6) << "After ParallelizeHostLoops: " << body;
+
+  // the spatial loop is split across threads, each reduces its own rows
+  auto loops = GetParallelLoops(body);
+  ASSERT_EQ(loops.size(), 1UL);
+  EXPECT_EQ(loops[0]->extent.as_int32(), 1024);
+}
+
+TEST(ParallelizeHostLoops, SkipReduceAxisAndSmallLoops) {
+  Context::Global().ResetNameId();
+  Placeholder<float> A("A", {Expr(65536)});
+  Var reduce_i(65536, "reduce_i");
+  ir::Tensor B = Compute(
+      {Expr(1)},
+      [&](Var i) { return lang::ReduceSum(A(reduce_i), {reduce_i}); },
+      "B");
+  Placeholder<float> C("C", {Expr(16), Expr(16)});
+  ir::Tensor D = Compute(
+      {Expr(16), Expr(16)},
+      [&](Var i, Var j) { return C(i, j) * Expr(2.f); },
+      "D");
+  ast_gen_ius::TensorGroup tensor_group({A, B, C, D});
+  auto func = lang::LowerToAst("reduce_all", {A, B, C, D}, &tensor_group);
+
+  ir::Expr body = func->body;
+  ParallelizeHostLoops(&body);
+  VLOG(6) << "After ParallelizeHostLoops: " << body;
+
+  EXPECT_TRUE(GetParallelLoops(body).empty());
+}
+
+}  // namespace optim
+}  // namespace cinn
@@ -19,6 +19,11 @@
 
 #ifdef CINN_USE_OPENMP
 #include <omp.h>
+#else
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #endif  // CINN_USE_OPENMP
 
 #include "paddle/cinn/backends/extern_func_jit_register.h"
@@ -44,6 +49,99 @@ int max_concurrency() {
   return std::max(max_concurrency, 1);
 }
 
+#ifndef CINN_USE_OPENMP
+namespace {
+
+// The threads shared by the parallel loops of all host kernels when OpenMP is
+// not available. The calling thread runs tasks too, and the threads take the
+// tasks one by one until all of them are done.
+class ParallelThreadPool {
+ public:
+  static ParallelThreadPool& Global() {
+    // Leaked on purpose, the threads never exit.
+    static ParallelThreadPool* pool =
+        new ParallelThreadPool(max_concurrency() - 1);
+    return *pool;
+  }
+
+  int Launch(FCINNParallelLambda flambda, void* datas, int num_task) {
+    std::lock_guard<std::mutex> launch_guard(launch_mutex_);
+    auto job = std::make_shared<Job>();
+    job->flambda = flambda;
+    job->datas = datas;
+    job->num_task = num_task;
+    job->unfinished = num_task;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      job_ = job;
+    }
+    cv_.notify_all();
+    RunTasks(job.get());
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return job->unfinished == 0; });
+    job_ = nullptr;
+    return job->failed ? -1 : 0;
+  }
+
+ private:
+  struct Job {
+    FCINNParallelLambda flambda;
+    void* datas;
+    int num_task;
+    std::atomic<int> next_task{0};
+    // guarded by mutex_
+    int unfinished;
+    bool failed{false};
+  };
+
+  explicit ParallelThreadPool(int num_threads) {
+    for (int i = 0; i < num_threads; ++i) {
+      std::thread([this] { WorkerLoop(); }).detach();
+    }
+  }
+
+  void WorkerLoop() {
+    std::shared_ptr<Job> last_job;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return job_ != nullptr && job_ != last_job; });
+        last_job = job_;
+      }
+      RunTasks(last_job.get());
+    }
+  }
+
+  void RunTasks(Job* job) {
+    int finished = 0;
+    bool failed = false;
+    for (int task_id = job->next_task++; task_id < job->num_task;
+         task_id = job->next_task++) {
+      failed = (*job->flambda)(task_id, job->num_task, job->datas) != 0 ||
+               failed;
+      ++finished;
+    }
+    if (finished == 0) return;
+    std::lock_guard<std::mutex> guard(mutex_);
+    job->failed = job->failed || failed;
+    job->unfinished -= finished;
+    if (job->unfinished == 0) {
+      done_cv_.notify_all();
+    }
+  }
+
+  // one launch at a time, nested launches are not supported
+  std::mutex launch_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::condition_variable done_cv_;
+  std::shared_ptr<Job> job_;
+};
+
+}  // namespace
+#endif  // CINN_USE_OPENMP
+
 int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
                                  void* datas,
                                  int num_task) {
@@ -56,11 +154,10 @@ int cinn_backend_parallel_launch(FCINNParallelLambda flambda,
     int thread_num = omp_get_thread_num();
     (*flambda)(thread_num, num_task, datas);
   }
+  return 0;
 #else
-  PADDLE_THROW(::common::errors::Fatal(
-      "CINN host parallel launch need OpenMP! Please check."));
+  return ParallelThreadPool::Global().Launch(flambda, datas, num_task);
 #endif  // CINN_USE_OPENMP
-  return 0;
 }
 
 CINN_REGISTER_HELPER(cinn_backend_parallel) {
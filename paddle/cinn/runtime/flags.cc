@@ -63,6 +63,11 @@ PD_DEFINE_string(
     StringFromEnv("FLAGS_tile_config_policy", "default"),
     "Which config does the compiler use, optimal, custom or default");
 
+PD_DEFINE_string(cinn_tuning_database_file,
+                 StringFromEnv("FLAGS_cinn_tuning_database_file", ""),
+                 "File of tuned schedule configs keyed by group signature and "
+                 "shape bucket, used by the compiler when it is not empty");
+
 PD_DEFINE_int32(cinn_parallel_compile_thread,
                 Int32FromEnv("FLAGS_cinn_parallel_compile_thread",
                              (std::thread::hardware_concurrency() >> 1)),
@@ -72,10 +77,21 @@ PD_DEFINE_bool(cinn_measure_kernel_time,
                BoolFromEnv("FLAGS_cinn_measure_kernel_time", false),
                "Whether to enable schedule config search mode.");
 
+PD_DEFINE_int64(cinn_cpu_parallel_min_work,
+                Int64FromEnv("FLAGS_cinn_cpu_parallel_min_work", 16384),
+                "The least number of iterations of a loop nest in a host "
+                "kernel to run its outermost loop on multiple threads.");
+
 PD_DEFINE_bool(cinn_enable_grid_reduce,
                BoolFromEnv("FLAGS_cinn_enable_grid_reduce", true),
                "Whether to enable the grid reduce method.");
 
+PD_DEFINE_string(cinn_dynamic_shape_buckets,
+                 StringFromEnv("FLAGS_cinn_dynamic_shape_buckets", ""),
+                 "Upper bounds of the shape buckets that dynamic shape groups "
+                 "compile specialized kernels for, e.g. \"S:128,512;R:1024\" "
+                 "for the total spatial and reduce extent of a group.");
+
 PD_DEFINE_bool(cinn_use_op_fusion,
                BoolFromEnv("FLAGS_cinn_use_op_fusion", true),
                "Whether to use op fusion pass.");
@@ -227,6 +243,12 @@ PD_DEFINE_string(
     StringFromEnv("FLAGS_cinn_dump_group_instruction", ""),
     "Specify the path for dump instruction by group, which is used for debug.");
 
+PD_DEFINE_string(cinn_compilation_cache_dir,
+                 StringFromEnv("FLAGS_cinn_compilation_cache_dir", ""),
+                 "Specify the directory of the on-disk cache of compiled "
+                 "device code, which is shared by the processes on a host. "
+                 "Empty disables it.");
+
 // Todo(CZ): support kernel name check for multiple kernel code gen.
 PD_DEFINE_string(cinn_debug_custom_code_path,
                  StringFromEnv("FLAGS_cinn_debug_custom_code_path", ""),
@@ -45,6 +45,17 @@ int SequenceDispatcher::Next() const {
   return idx;
 }
 
+OrderedDispatcher::OrderedDispatcher(std::vector<int> order)
+    : order_(std::move(order)), pos_(0) {}
+
+int OrderedDispatcher::Next() const {
+  int pos = pos_.fetch_add(1);
+  if (pos >= static_cast<int>(order_.size())) {
+    return -1;
+  }
+  return order_[pos];
+}
+
 void parallel_run(const WorkerFuncType& fn,
                   JobDispatcher&& dispatcher,
                   int num_threads) {
@@ -15,6 +15,7 @@
 #pragma once
 #include <atomic>
 #include <functional>
+#include <vector>
 
 namespace cinn {
 namespace utils {
@@ -51,6 +52,20 @@ class SequenceDispatcher : public JobDispatcher {
   mutable std::atomic<int> index_;
 };
 
+// This dispatcher pops the indexes of `order` one by one, e.g. to start the
+// most expensive jobs first
+class OrderedDispatcher : public JobDispatcher {
+ public:
+  explicit OrderedDispatcher(std::vector<int> order);
+
+  int Next() const override;
+
+ private:
+  std::vector<int> order_;
+  // position of the next index in order_
+  mutable std::atomic<int> pos_;
+};
+
 /**
  * \brief A general function to run a batch of jobs in parallel
  * \param fn A instance of WorkerFuncType, which defines how to complete a
@@ -34,6 +34,17 @@ TEST(JobDispatcher, SequenceDispatcher) {
   ASSERT_EQ(-1, dispatcher->Next());
 }
 
+TEST(JobDispatcher, OrderedDispatcher) {
+  std::unique_ptr<JobDispatcher> dispatcher =
+      std::make_unique<OrderedDispatcher>(std::vector<int>{2, 0, 1});
+  ASSERT_EQ(2, dispatcher->Next());
+  ASSERT_EQ(0, dispatcher->Next());
+  ASSERT_EQ(1, dispatcher->Next());
+  // check reach the end
+  ASSERT_EQ(-1, dispatcher->Next());
+  ASSERT_EQ(-1, dispatcher->Next());
+}
+
 TEST(parallel_run, Basic) {
   std::vector<int> results(100, -1);
   auto worker_fn = [&results](int index) {
@@ -60,5 +71,19 @@ TEST(parallel_run, Basic) {
   }
 }
 
+TEST(parallel_run, OrderedDispatcher) {
+  std::vector<int> order(100);
+  for (int i = 0; i < 100; ++i) {
+    order[i] = 99 - i;
+  }
+  std::vector<int> results(100, 0);
+  auto worker_fn = [&results](int index) { results[index] += 1; };
+  parallel_run(worker_fn, OrderedDispatcher(order), 4);
+  // check every index is processed exactly once
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(results[i], 1);
+  }
+}
+
 }  // namespace utils
 }  // namespace cinn
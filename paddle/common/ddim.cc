@@ -271,15 +271,13 @@ DDim ComputeCompatibleDim(const DDim& dim1, const DDim& dim2) {
                     "Does not support rank inconsistency: rank1=%d, rank2=%d",
                     dim1.size(),
                     dim2.size());
-  std::vector<int64_t> result;
+  DDim result(dim1);
   for (int i = 0; i < dim1.size(); ++i) {
     if (dim1[i] != dim2[i]) {
-      result.push_back(-1);
-    } else {
-      result.push_back(dim1[i]);
+      result[i] = -1;
     }
   }
-  return make_ddim(result);
+  return result;
 }
 
 bool AreDimsWithDynamicShapeCompatible(const DDim& dim1, const DDim& dim2) {
@@ -22,6 +22,7 @@
 #include "paddle/common/dim.h"
 #include "paddle/common/enforce.h"
 #include "paddle/common/exception.h"
+#include "paddle/utils/small_vector.h"
 #include "paddle/utils/test_macros.h"
 
 namespace common {
@@ -181,14 +182,37 @@ TEST_API DDim make_ddim(const std::vector<int>& dims);
  */
 TEST_API DDim make_ddim(std::initializer_list<int64_t> dims);
 
+/**
+ * \brief Shape kept inline, for the temporaries of InferMeta and kernels
+ *
+ * A DDim never has more than kMaxRank dims, so building a shape in a
+ * SmallShape never touches the heap.
+ */
+template <typename T = int64_t>
+using SmallShape = paddle::small_vector<T, DDim::kMaxRank>;
+
+template <typename T, unsigned N>
+DDim make_ddim(const paddle::small_vector<T, N>& dims) {
+  return DDim(dims.data(), static_cast<int>(dims.size()));
+}
+
 template <typename T = int64_t>
 std::vector<T> vectorize(const DDim& ddim) {
   if (ddim.size() == -1) {
     return std::vector<T>({0});
   }
-  std::vector<T> result(DDim::kMaxRank);
+  std::vector<T> result(ddim.size());
+  dynamic_dim_assign(ddim.Get(), result.data(), ddim.size());
+  return result;
+}
+
+template <typename T = int64_t>
+SmallShape<T> small_vectorize(const DDim& ddim) {
+  if (ddim.size() == -1) {
+    return SmallShape<T>{0};
+  }
+  SmallShape<T> result(ddim.size());
   dynamic_dim_assign(ddim.Get(), result.data(), ddim.size());
-  result.resize(ddim.size());
   return result;
 }
 
@@ -102,6 +102,26 @@ PHI_DEFINE_EXPORTED_int32(
     0,
     "Setting the check and print level when FLAGS_check_nan_inf is set.");
 
+/**
+ * Operator related FLAG
+ * Name: FLAGS_check_nan_inf_sampling_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_check_nan_inf_sampling_interval=10, with FLAGS_check_nan_inf
+ * set, the PIR executor checks the outputs of every 10th step.
+ * Note: Used to debug. When greater than 0, the PIR executor checks NAN/INF in
+ * a low overhead mode: the results of all operators of a sampled step are
+ * reduced on the device into one flag, which is read once per step without
+ * synchronizing the device. After a NAN/INF is found, all operators of the
+ * following steps are checked one by one to locate it. 0 checks each operator
+ * of each step.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    check_nan_inf_sampling_interval,
+    0,
+    "Step interval of the low overhead NAN/INF checking of the PIR executor, "
+    "0 to check each operator when FLAGS_check_nan_inf is set.");
+
 /**
  * Operator related FLAG
  * Name: FLAGS_check_nan_inf
@@ -213,6 +233,20 @@ PHI_DEFINE_EXPORTED_bool(
     true,
     "Whether enable api kernel fallback to CPU one when not found");
 
+/**
+ * Kernel related FLAG
+ * Name: FLAGS_fused_dropout_bitpack_mask
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If true, fused_bias_dropout_residual_layer_norm saves its dropout
+ *       mask for backward with 1 bit per element instead of 1 byte, the
+ *       mask output then has shape [ceil(numel(x) / 8)].
+ */
+PHI_DEFINE_EXPORTED_bool(fused_dropout_bitpack_mask,
+                         false,
+                         "Whether fused dropout saves a bit-packed mask");
+
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 /**
  * CUDNN related FLAG
@@ -239,7 +273,10 @@ PHI_DEFINE_EXPORTED_bool(
  * Note: whether to use deterministic algorithm in embedding op.
  *       If it is 1, it will use the optimized deterministic CUDA kernel in
  *       embedding op. If it is 2, it will use the legacy deterministic
- *       CUDA kernel in embedding op.
+ *       CUDA kernel in embedding op. If it is 3, it will always sort the ids
+ *       and reduce the gradient of every row once. If it is 0, the sorted
+ *       reduction is used when there are at least as many ids as rows of
+ *       the table, otherwise the gradients are accumulated with atomics.
  */
 PHI_DEFINE_EXPORTED_int64(
     embedding_deterministic,
@@ -248,6 +285,22 @@ PHI_DEFINE_EXPORTED_int64(
     "operator. The deterministic algorithm may be slower. If "
     "it is larger than 0, the algorithm is deterministic.");
 
+/**
+ * Kernel related FLAG
+ * Name: FLAGS_sparse_csr_balanced_matmul_threshold
+ * Since Version: 3.0.0
+ * Value Range: double, default=1.0
+ * Example:
+ * Note: The GPU sparse CSR matmul and masked_matmul use the nnz-balanced
+ *       kernels instead of cuSPARSE when the coefficient of variation of the
+ *       row lengths of the sparse input exceeds this. 0 always uses them and
+ *       a negative value never does, except for float16.
+ */
+PHI_DEFINE_EXPORTED_double(sparse_csr_balanced_matmul_threshold,
+                           1.0,
+                           "the row length coefficient of variation above "
+                           "which sparse CSR matmul uses balanced kernels");
+
 /**
  * CUDNN related FLAG
  * Name: FLAGS_cudnn_exhaustive_search
@@ -374,6 +427,62 @@ PHI_DEFINE_EXPORTED_bool(
 PHI_DEFINE_EXPORTED_int32(communicator_send_queue_size,
                           20,
                           "queue size to recv gradient before send");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_adaptive_send
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: The async communicator adjusts the number of gradients merged into
+ *       one send of a table and the number of tables sent at the same time
+ *       from the queue depth and the rpc latency it observes, within
+ *       communicator_max_merge_var_num and communicator_thread_pool_size.
+ */
+PHI_DEFINE_EXPORTED_bool(communicator_adaptive_send,
+                         false,
+                         "adjust the merge window and send concurrency of the "
+                         "async communicator from queue depth and rpc latency");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_communicator_send_latency_target_ms
+ * Since Version: 3.0.0
+ * Value Range: int32, default=50
+ * Example:
+ * Note: The rpc latency that FLAGS_communicator_adaptive_send aims for,
+ *       fewer tables are sent at the same time when the smoothed latency
+ *       of a send goes beyond it.
+ */
+PHI_DEFINE_EXPORTED_int32(communicator_send_latency_target_ms,
+                          50,
+                          "rpc latency target of the adaptive send in ms");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_geo_sparse_delta_compress_type
+ * Since Version: 3.0.0
+ * Value Range: string, default=none
+ * Example:
+ * Note: Encoding of the sparse deltas the geo communicator pushes, none,
+ *       fp16 or int8 (a scale per row). The quantization error stays in
+ *       the trainer's copy of the parameter and goes out with the next
+ *       delta of the row.
+ */
+PHI_DEFINE_EXPORTED_string(geo_sparse_delta_compress_type,
+                           "none",
+                           "encoding of geo sparse deltas, none, fp16 or int8");
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_geo_sparse_delta_skip_threshold
+ * Since Version: 3.0.0
+ * Value Range: double, default=0
+ * Example:
+ * Note: The geo communicator does not push a sparse row whose delta has
+ *       no value above this in abs, the delta stays with the trainer
+ *       until the row is pushed again. 0 pushes every updated row.
+ */
+PHI_DEFINE_EXPORTED_double(geo_sparse_delta_skip_threshold,
+                           0.0,
+                           "geo sparse rows with a smaller max abs delta are "
+                           "not pushed");
 #endif
 
 /**
@@ -389,6 +498,21 @@ PHI_DEFINE_EXPORTED_int32(dist_threadpool_size,
                           0,
                           "number of threads used for distributed executed.");
 
+/**
+ * ProcessGroupGloo related FLAG
+ * Name: FLAGS_gloo_allreduce_halving_doubling_bytes
+ * Since Version: 3.0
+ * Value Range: int64, default=262144
+ * Example: FLAGS_gloo_allreduce_halving_doubling_bytes=0 always uses ring
+ * Note: Sum allreduces of gloo up to this many bytes use the halving-doubling
+ * algorithm, which takes log2(nranks) steps instead of the 2*(nranks-1) of
+ * ring and suits latency bound messages. Larger ones use ring.
+ */
+PHI_DEFINE_EXPORTED_int64(gloo_allreduce_halving_doubling_bytes,
+                          262144,
+                          "Sum allreduces of gloo up to this many bytes use "
+                          "halving-doubling instead of ring.");
+
 /**
  * Garbage collector related FLAG
  * Name: FLAGS_eager_delete_tensor_gb
@@ -432,6 +556,23 @@ PHI_DEFINE_EXPORTED_bool(
     "Fast eager deletion mode. If enabled, memory would release "
     "immediately without waiting GPU kernel ends.");
 
+/**
+ * Garbage collector related FLAG
+ * Name: FLAGS_new_executor_gc_batch_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_new_executor_gc_batch_size=64, the garbage collector of the
+ * new executor releases garbage in batches of 64 allocations.
+ * Note: Batching amortizes the device events and allocator locks taken by
+ *       each release over the whole batch, at the cost of holding the batch
+ *       a little longer. Values no larger than 1 release garbage one by one.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    new_executor_gc_batch_size,
+    1,
+    "Number of garbage allocations released together by the garbage "
+    "collector of the new executor.");
+
 /**
  * Memory related FLAG
  * Name: FLAGS_memory_fraction_of_eager_deletion
@@ -462,10 +603,12 @@ PHI_DEFINE_EXPORTED_double(
  * Allocator related FLAG
  * Name: FLAGS_allocator_strategy
  * Since Version: 1.2
- * Value Range: string, {naive_best_fit, auto_growth, thread_local},
- * default=auto_growth
+ * Value Range: string, {naive_best_fit, auto_growth, thread_local,
+ * size_class}, default=auto_growth
  * Example:
- * Note: For selecting allocator policy of PaddlePaddle.
+ * Note: For selecting allocator policy of PaddlePaddle. size_class is the
+ * auto_growth allocator with size-class segregated free lists for small
+ * requests.
  */
 static constexpr char kDefaultAllocatorStrategy[] = "auto_growth";  // NOLINT
 PHI_DEFINE_EXPORTED_string(
@@ -786,6 +929,21 @@ PHI_DEFINE_EXPORTED_string(tracer_onednn_ops_off,
                            "",
                            "List of OneDNN operation types to be turned off");
 
+/**
+ * Inference related FLAG
+ * Name: onednn_shared_primitive_cache_capacity
+ * Since Version: 3.0.0
+ * Value Range: int64, default=4096
+ * Example: FLAGS_onednn_shared_primitive_cache_capacity=1024
+ * Note: The number of OneDNN primitives and primitive descriptors shared by
+ * the clones of the predictors. Sharing one above it drops the oldest ones.
+ * 0 means unlimited.
+ */
+PHI_DEFINE_EXPORTED_int64(onednn_shared_primitive_cache_capacity,
+                          4096,
+                          "Number of OneDNN primitives shared by predictor "
+                          "clones, 0 means unlimited.");
+
 /**
  * Debug related FLAG
  * Name: check_kernel_launch
@@ -875,6 +1033,66 @@ PHI_DEFINE_EXPORTED_bool(graph_load_in_parallel,
                          "It controls whether load graph node and edge with "
                          "multi threads parallelly.");
 
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_compress_edge_shard
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether the edges of a graph table shard are packed into csr
+ * with delta varint neighbor ids after they are loaded, only the random
+ * sampler is supported on them.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_compress_edge_shard,
+                         false,
+                         "It controls whether the loaded edges of a graph "
+                         "table shard are compressed into csr.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_load_chunk_size_mb
+ * Since Version: 3.0.0
+ * Value Range: int32, default=256
+ * Example:
+ * Note: When graph_load_in_parallel is off, an edge file is mapped into memory
+ * and parsed in chunks of this many MB by several threads, then the edges are
+ * added shard by shard in parallel. 0 reads the file line by line in one
+ * thread.
+ */
+PHI_DEFINE_EXPORTED_int32(graph_load_chunk_size_mb,
+                          256,
+                          "The size in MB of the chunks an edge file is "
+                          "parsed in parallel in, 0 to parse it in one "
+                          "thread.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_alias_sampler
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Control whether the weighted edges loaded into a graph table get an
+ * alias sampler, so that their neighbors are sampled by the weights.
+ */
+PHI_DEFINE_EXPORTED_bool(graph_alias_sampler,
+                         false,
+                         "It controls whether weighted edges are sampled by "
+                         "an alias sampler built at load time.");
+
+/**
+ * Distributed related FLAG
+ * Name: FLAGS_graph_alias_sampler_min_degree
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: The nodes with fewer edges do not keep an alias table, 8 bytes an
+ * edge, and scan their weights on each sample instead.
+ */
+PHI_DEFINE_EXPORTED_int32(graph_alias_sampler_min_degree,
+                          0,
+                          "The degree below which the alias sampler scans "
+                          "the weights instead of keeping a table.");
+
 /**
  * Distributed related FLAG
  * Name: FLAGS_enable_neighbor_list_use_uva
@@ -942,6 +1160,66 @@ PHI_DEFINE_EXPORTED_bool(
     false,
     "It controls whether exit trainer when an worker has no ins.");
 
+/**
+ * Distributed related FLAG
+ * Name: downpour_max_push_inflight_batches
+ * Since Version: 3.0.0
+ * Value Range: int32, default=-1
+ * Example:
+ * Note: The number of batches whose sparse and dense pushes a DownpourWorker
+ *       thread keeps in flight while it pulls and computes the next ones,
+ *       which bounds the staleness of the pulled values. -1 never waits the
+ *       pushes, 0 waits the pushes of each batch before the next one.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    downpour_max_push_inflight_batches,
+    -1,
+    "The number of batches whose pushes a DownpourWorker keeps in flight.");
+
+/**
+ * Distributed related FLAG
+ * Name: downpour_concurrent_pull_sparse
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Let a DownpourWorker thread pull all its sparse tables of a batch
+ *       at the same time, instead of one table after another.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    downpour_concurrent_pull_sparse,
+    false,
+    "It controls whether DownpourWorker pulls its sparse tables at once.");
+
+/**
+ * Distributed related FLAG
+ * Name: heter_pipeline_balance_interval
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: The number of mini-batches over which a HeterSectionWorker measures
+ *       the time its section computes and the time it waits for the other
+ *       section, then logs them. 0 disables the monitoring.
+ */
+PHI_DEFINE_EXPORTED_int32(
+    heter_pipeline_balance_interval,
+    0,
+    "The number of mini-batches of a HeterSectionWorker balance window.");
+
+/**
+ * Distributed related FLAG
+ * Name: heter_pipeline_adaptive_microbatch
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Let the cpu section of a heter pipeline tune, after each balance
+ *       window, the number of micro-batches it keeps in flight between 1 and
+ *       num_microbatches, following the measured instances per second.
+ */
+PHI_DEFINE_EXPORTED_bool(
+    heter_pipeline_adaptive_microbatch,
+    false,
+    "It controls whether the cpu section tunes its in-flight micro-batches.");
+
 /**
  * Distributed related FLAG
  * Name: enable_adjust_op_order
@@ -1059,6 +1337,18 @@ PHI_DEFINE_EXPORTED_int64(
     cinn_compile_thread_num,
     -1,
     "It controls how many thread numbers applying compilation cache.");
+/*
+ * CINN related FLAG
+ * Name: FLAGS_cinn_compile_timing_report
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cinn_compile_timing_report=true would log the compile time
+ * of every group and the slowest groups after each build
+ */
+PHI_DEFINE_EXPORTED_bool(
+    cinn_compile_timing_report,
+    false,
+    "It controls whether to log the per group compile timing report.");
 /*
  * CINN related FLAG
  * Name: FLAGS_enable_interpretercore_launch_cinn
@@ -1140,6 +1430,48 @@ PHI_DEFINE_EXPORTED_bool(new_executor_use_cuda_graph,
                          false,
                          "Use CUDA Graph in new executor");
 
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_job_overlap
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_job_overlap=true would allow the standalone
+ * executor to run the jobs of a plan concurrently when they do not depend on
+ * each other, e.g. the forward of micro-batch i+1 and the backward of
+ * micro-batch i in gradient accumulation. Only works with PIR.
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_job_overlap,
+                         false,
+                         "Run independent jobs of a plan concurrently.");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_instruction_stats
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_new_executor_instruction_stats=true would make the PIR
+ * executor count, per op type, the host time spent on dispatching, infer meta
+ * and kernel launch, and the sampled device time of the kernels. The counters
+ * are read by paddle.base.core.get_instruction_statistics().
+ */
+PHI_DEFINE_EXPORTED_bool(new_executor_instruction_stats,
+                         false,
+                         "Collect the runtime statistics of instructions.");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_instruction_stats_device_sampling
+ * Since Version: 3.0.0
+ * Value Range: int32, default=100
+ * Example: FLAGS_new_executor_instruction_stats_device_sampling=100 would
+ * measure the device time of an instruction on every 100th run of it when
+ * FLAGS_new_executor_instruction_stats is set. 0 disables device timing.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_instruction_stats_device_sampling,
+                          100,
+                          "Run interval of sampling the device time of "
+                          "instructions.");
+
 /*
  * CUDA Graph / Allocator related FLAG
  * Name: FLAGS_use_cuda_malloc_async_allocator
@@ -1202,6 +1534,37 @@ PHI_DEFINE_EXPORTED_uint64(executor_log_deps_every_microseconds,
                            0,
                            "Enable new executor log deps every n microseconds");
 
+/*
+ * Executor related FLAG
+ * Name: FLAGS_naive_executor_inter_op_threads
+ * Since Version: 3.0
+ * Value Range: int32, default=1
+ * Example: FLAGS_naive_executor_inter_op_threads=4 lets the NaiveExecutor of
+ * CPU inference run up to 4 independent ops at the same time. The cpu math
+ * library threads of the predictor are split evenly between them.
+ */
+PHI_DEFINE_EXPORTED_int32(naive_executor_inter_op_threads,
+                          1,
+                          "Number of threads the NaiveExecutor of CPU "
+                          "inference runs independent ops on, 1 runs ops in "
+                          "order on the calling thread");
+
+/*
+ * Executor related FLAG
+ * Name: FLAGS_new_executor_steal_group_size
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_new_executor_steal_group_size=8 would group every 8 adjacent
+ * host worker threads of the new executor into one steal partition. An idle
+ * worker steals from its own group first and then from the nearest groups,
+ * which keeps short kernels on the cores sharing a cache or NUMA node. 0
+ * disables the locality-aware stealing.
+ */
+PHI_DEFINE_EXPORTED_int32(new_executor_steal_group_size,
+                          0,
+                          "Number of adjacent host worker threads sharing one "
+                          "steal partition in new executor, 0 to disable.");
+
 PD_DEFINE_int32(record_pool_max_size,
                 2000000,
                 "SlotRecordDataset slot record pool max size");
@@ -1211,12 +1574,51 @@ PD_DEFINE_int32(slotpool_thread_num,
 PD_DEFINE_bool(enable_slotpool_wait_release,  // NOLINT
                false,
                "enable slotrecord object wait release, default false");
+PD_DEFINE_int64(slotpool_preload_max_records,
+                0,
+                "the most slot records in use while a SlotRecordDataset "
+                "preloads the next pass, the preload waits for the records "
+                "of the released passes above it, 0 for no limit");
 PD_DEFINE_bool(enable_slotrecord_reset_shrink,  // NOLINT
                false,
                "enable slotrecord object reset shrink memory, default false");
 PD_DEFINE_bool(enable_ins_parser_file,  // NOLINT
                false,
                "enable parser ins file, default false");
+PD_DEFINE_int32(slotrecord_parse_thread_num,
+                0,
+                "SlotRecordDataset parse threads behind each loading thread, "
+                "0 parses on the loading thread, default 0");
+PD_DEFINE_string(hdfs_native_lib,
+                 "",
+                 "path of libhdfs3.so, when set hdfs:/afs: files are read by "
+                 "the native client instead of the hdfs command, default "
+                 "empty");
+PD_DEFINE_string(hdfs_native_user,
+                 "",
+                 "user name of the native hdfs client, default empty");
+PD_DEFINE_int64(hdfs_native_read_chunk_size,
+                8 << 20,
+                "bytes of one range read of the native hdfs client, "
+                "default 8MB");
+PD_DEFINE_int32(hdfs_native_read_thread_num,
+                4,
+                "range reads in flight per file of the native hdfs client, "
+                "default 4");
+PD_DEFINE_string(slotrecord_columnar_cache_dir,
+                 "",
+                 "SlotRecordDataset caches every parsed file as a binary "
+                 "columnar file in this dir and mmaps it on later loads, "
+                 "empty disables the cache, default empty");
+PD_DEFINE_bool(enable_slotrecord_gpu_pass_pack,  // NOLINT
+               false,
+               "SlotRecordDataset uploads the slot values of a reader's pass "
+               "to the gpu once and gathers every batch from them on the "
+               "gpu, default false");
+PD_DEFINE_bool(slotrecord_gpu_pass_shuffle,  // NOLINT
+               false,
+               "shuffle the instances of a reader's pass on the gpu, works "
+               "with enable_slotrecord_gpu_pass_pack, default false");
 PHI_DEFINE_EXPORTED_bool(
     gpugraph_enable_hbm_table_collision_stat,
     false,
@@ -1248,6 +1650,32 @@ PHI_DEFINE_EXPORTED_int32(
     gpugraph_dedup_pull_push_mode,
     0,
     "enable dedup keys while pull push sparse, default 0");
+PHI_DEFINE_EXPORTED_bool(
+    gpups_incremental_pass_build,
+    false,
+    "keep the hbm table of a pass resident and only build the new keys of "
+    "the next pass, only the rows changed in a pass are dumped back at "
+    "end_pass. The cpu table must not be changed between passes, call "
+    "release_resident_table before shrink or load, default false");
+PHI_DEFINE_EXPORTED_double(
+    gpups_hbm_cache_ratio,
+    1.0,
+    "the ratio of the rows of a pass kept in hbm, the most shown keys go "
+    "first, the others stay in host memory the gpu reads in place. Set it "
+    "below 1 for the passes that do not fit in hbm, not used with "
+    "gpups_incremental_pass_build, default 1.0");
+PHI_DEFINE_EXPORTED_bool(
+    gpups_share_dim_pools,
+    true,
+    "keep the hbm rows of all the mf dims of a device in one pool, so a "
+    "device holds one peak allocation instead of one per dim, not used with "
+    "gpups_incremental_pass_build or gpups_hbm_cache_ratio below 1, "
+    "default true");
+PHI_DEFINE_EXPORTED_bool(
+    gpugraph_sage_feature_prefetch,
+    false,
+    "pull the slot features of the next sage batch in the background while "
+    "the current batch trains, default false");
 PHI_DEFINE_EXPORTED_bool(gpugraph_load_node_list_into_hbm,
                          true,
                          "enable load_node_list_into_hbm, default true");
@@ -1269,6 +1697,12 @@ PHI_DEFINE_EXPORTED_bool(enable_all2all_use_fp16,
 PHI_DEFINE_EXPORTED_bool(enable_sparse_inner_gather,
                          false,
                          "enable sparse inner gather, default false");
+PHI_DEFINE_EXPORTED_bool(
+    enable_pull_inner_all2all,
+    false,
+    "pull the keys of the other cards of a node by nccl all2all over the "
+    "inner comms instead of p2p copies along the transfer paths, every card "
+    "has to pull the same batches, default false");
 PHI_DEFINE_EXPORTED_bool(gpugraph_debug_gpu_memory,
                          false,
                          "enable debug gpu memory, default false");
@@ -1319,6 +1753,117 @@ PHI_DEFINE_EXPORTED_bool(eager_communication_connection,
                          false,
                          "enable eager to create nccl comm");
 
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_backward_num_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_eager_backward_num_threads=4 runs the ready grad nodes of a
+ * backward on 4 threads.
+ * Note: 0 runs the grad nodes one by one on the calling thread. The grads are
+ * accumulated in the same order as the sequential backward. The pool is
+ * created at the first parallel backward, later changes of the size take no
+ * effect. The backward with create_graph, amp, general grad or force
+ * sequential nodes stays sequential.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_backward_num_threads,
+                          0,
+                          "The number of threads that run the grad nodes of "
+                          "a backward, 0 means sequential.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_offload_saved_tensor_min_bytes
+ * Since Version: 3.0.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_eager_offload_saved_tensor_min_bytes=1048576 copies the
+ * activations of 1MB or more saved for the backward to pinned host memory.
+ * Note: 0 keeps the saved tensors on the device. Only the contiguous dense
+ * tensors on the gpu produced by an op are offloaded, the leaf tensors such
+ * as parameters stay on the device anyway.
+ */
+PHI_DEFINE_EXPORTED_int64(eager_offload_saved_tensor_min_bytes,
+                          0,
+                          "The saved tensors at least this large are "
+                          "offloaded to the host, 0 means no offload.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_offload_prefetch_num
+ * Since Version: 3.0.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_eager_offload_prefetch_num=2 copies back the two tensors
+ * offloaded before a tensor when the backward reloads it.
+ * Note: Only works with FLAGS_eager_offload_saved_tensor_min_bytes.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_offload_prefetch_num,
+                          2,
+                          "The number of offloaded tensors prefetched when "
+                          "the backward reloads one.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_recompute_memory_budget_mb
+ * Since Version: 3.0.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_eager_recompute_memory_budget_mb=4096 drops the outputs of
+ * the cheapest ops to recompute until the activations saved for a backward
+ * take at most 4GB, and recomputes them in the backward.
+ * Note: 0 disables the recompute. Only the ops whose grad keeps the input,
+ * such as the activations, are recomputed.
+ */
+PHI_DEFINE_EXPORTED_int64(eager_recompute_memory_budget_mb,
+                          0,
+                          "The memory budget in MB of the saved tensors, "
+                          "0 means no recompute.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_recompute_profile_steps
+ * Since Version: 3.0.0
+ * Value Range: int32, default=2
+ * Example: FLAGS_eager_recompute_profile_steps=2 measures the saved bytes and
+ * the recompute time of the ops in the first 2 steps before planning.
+ * Note: Only works with FLAGS_eager_recompute_memory_budget_mb.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_recompute_profile_steps,
+                          2,
+                          "The number of steps profiled before planning "
+                          "the recompute.");
+
+/**
+ * Backward related FLAG
+ * Name: FLAGS_eager_grad_object_pool_capacity
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1024
+ * Example: FLAGS_eager_grad_object_pool_capacity=1024 keeps at most 1024
+ * freed blocks of each size class in each thread for the GradNodes and
+ * AutogradMetas of the next step.
+ * Note: 0 means the grad graph objects are not pooled.
+ */
+PHI_DEFINE_EXPORTED_int32(eager_grad_object_pool_capacity,
+                          1024,
+                          "The number of freed blocks of each size class "
+                          "cached for the grad graph objects.");
+
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: nccl_hierarchical_allreduce
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_nccl_hierarchical_allreduce=true
+ * Note: The default allreduce mode of the NCCL process groups. If true, an
+ * allreduce is a reduce-scatter within the node, an allreduce of the shards
+ * across the nodes and an all-gather within the node, which helps when the
+ * links across the nodes are much slower than those within a node. A group
+ * can change it with set_hierarchical_allreduce.
+ */
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+PHI_DEFINE_EXPORTED_bool(nccl_hierarchical_allreduce,
+                         false,
+                         "Allreduce within the nodes first, then across them");
+#endif
+
 /**
  * Autotune related FLAG
  * Name: FLAGS_use_autotune
@@ -1328,6 +1873,20 @@ PHI_DEFINE_EXPORTED_bool(eager_communication_connection,
  */
 PHI_DEFINE_EXPORTED_bool(use_autotune, false, "Whether enable autotune.");
 
+/**
+ * Autotune related FLAG
+ * Name: FLAGS_autotune_cache_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_autotune_cache_file=/path/to/autotune_cache
+ * Note: If not empty, the kernel autotune caches are loaded from the file when
+ * the tuning starts, and merged into the file when the tuning range ends. The
+ * ranks of a job can share the file so that each shape is tuned only once.
+ */
+PHI_DEFINE_EXPORTED_string(autotune_cache_file,
+                           "",
+                           "The file to load and save the autotune caches.");
+
 /**
  * CINN training related FLAG
  * Name: FLAGS_disable_dyshape_in_train
@@ -1402,6 +1961,34 @@ PHI_DEFINE_EXPORTED_bool(
     true,
     "Whether enable use append iters transform in cinn fusion.");
 
+/**
+ * CINN fusion cost model FLAG
+ * Name: FLAGS_cinn_fusion_cost_model
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cinn_fusion_cost_model=true would reject the candidate
+ * merges of cinn fusion whose estimated memory traffic saving does not pay
+ * for the recomputation and register pressure they bring
+ */
+PHI_DEFINE_EXPORTED_bool(
+    cinn_fusion_cost_model,
+    false,
+    "Whether to check candidate merges in cinn fusion by a cost model.");
+
+/**
+ * CINN fusion decision dump FLAG
+ * Name: FLAGS_cinn_fusion_decision_dump
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_cinn_fusion_decision_dump=true would log every candidate
+ * merge checked by the fusion cost model, with its estimated cost and the
+ * reason it is accepted or rejected
+ */
+PHI_DEFINE_EXPORTED_bool(cinn_fusion_decision_dump,
+                         false,
+                         "Whether to log the decisions of the cinn fusion "
+                         "cost model with their reasons.");
+
 /**
  * Conv Search cache max number related FLAG
  * Name: FLAGS_search_cache_max_number
@@ -1439,6 +2026,35 @@ PHI_DEFINE_EXPORTED_bool(enable_auto_layout_pass,
                          false,
                          "Whether enable auto_layout_pass.");
 
+/**
+ * Performance related FLAG
+ * Name: layout_autotune_measure
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the dygraph layout autotune times the first conv2d in both
+ * NCHW and NHWC on the device and tunes to the faster layout, instead of
+ * choosing the layout by the data type.
+ */
+PHI_DEFINE_EXPORTED_bool(layout_autotune_measure,
+                         false,
+                         "Whether layout autotune measures the conv2d "
+                         "kernels to choose the layout.");
+
+/**
+ * Performance related FLAG
+ * Name: layout_autotune_cache_file
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_layout_autotune_cache_file=./layout_cache.txt
+ * Note: The file keeps the layouts measured by FLAGS_layout_autotune_measure
+ * for each conv2d signature, so that the next runs skip the measurement.
+ */
+PHI_DEFINE_EXPORTED_string(layout_autotune_cache_file,
+                           "",
+                           "The file of the layouts measured by layout "
+                           "autotune.");
+
 /**
  * JitLayer related FLAG
  * Name: FLAGS_jit_engine_type
@@ -1502,6 +2118,36 @@ PHI_DEFINE_EXPORTED_bool(trt_ibuilder_cache,
                          false,
                          "Add a persistent ibuilder.");
 
+/**
+ * Inference related FLAG
+ * Name: trt_engine_cache_capacity_mb
+ * Since Version: 3.0.0
+ * Value Range: int64, default=0
+ * Example: FLAGS_trt_engine_cache_capacity_mb=10240
+ * Note: The size limit of the serialized TensorRT engines in an optimization
+ * cache directory. Storing an engine removes the least recently used ones
+ * above it. 0 means unlimited.
+ */
+PHI_DEFINE_EXPORTED_int64(trt_engine_cache_capacity_mb,
+                          0,
+                          "Size limit of the serialized TensorRT engines of "
+                          "a cache directory in MB, 0 means unlimited.");
+
+/**
+ * Inference related FLAG
+ * Name: trt_instruction_use_cuda_graph
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_trt_instruction_use_cuda_graph=true
+ * Note: If True, a TensorRT engine instruction of the PIR executor captures
+ * its enqueue into a CUDA graph once two consecutive runs have the same input
+ * shapes and buffer addresses, and replays the graph while they stay the same.
+ */
+PHI_DEFINE_EXPORTED_bool(trt_instruction_use_cuda_graph,
+                         false,
+                         "Replay TensorRT engine instructions with stable "
+                         "shapes and buffers through a CUDA graph.");
+
 /**
  * mmap_allocator related FLAG
  * Name: use_shm_cache
@@ -1528,6 +2174,37 @@ PHI_DEFINE_EXPORTED_bool(dataloader_use_file_descriptor,
                          false,
                          "Use file descriptor in mmap_allocator.");
 
+/**
+ * mmap_allocator related FLAG
+ * Name: dataloader_shm_ring_size
+ * Since Version: 3.0.0
+ * Value Range: int32, default=0
+ * Example:
+ * Note: The number of shm segments each DataLoader worker reuses for its
+ * batches, all the tensors of a batch are packed into one segment. 0 means
+ * every tensor is sent in a new shm file.
+ */
+PHI_DEFINE_EXPORTED_int32(dataloader_shm_ring_size,
+                          0,
+                          "Number of reused shm segments of a DataLoader "
+                          "worker, 0 to disable.");
+
+/**
+ * cuda_ipc_allocator related FLAG
+ * Name: cuda_ipc_pool_segment_size_mb
+ * Since Version: 3.0.0
+ * Value Range: uint64, default=0
+ * Example: FLAGS_cuda_ipc_pool_segment_size_mb=256
+ * Note: Size of the segments GPU tensors are copied into when sent to other
+ * processes. Each segment is exported once and opened once by every
+ * receiver, blocks are reused once their receivers released them. 0 means
+ * every tensor exports its own allocation.
+ */
+PHI_DEFINE_EXPORTED_uint64(cuda_ipc_pool_segment_size_mb,
+                           0,
+                           "Size of the pooled CUDA IPC segments in MB, 0 to "
+                           "disable the pool.");
+
 /**
  * Tensor operants related FLAG
  * Name: tensor_operants_mode
@@ -1616,6 +2293,57 @@ PHI_DEFINE_EXPORTED_bool(enable_pir_in_executor_trace_run,
                          false,
                          "Enable PIR in executor");
 
+/**
+ * Using PIR in executor FLAG
+ * Name: pir_interpreter_static_trace_replay
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, after the first (warm-up) run the pir interpreter records
+ * the resolved instruction order and the garbage collection release points
+ * into a flat plan, and replays it on later runs without dependency counting
+ * and reference counting. Only valid for programs whose execution order and
+ * variable lifetimes do not change between runs, e.g. fixed-shape programs.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_static_trace_replay,
+                         false,
+                         "Replay the recorded execution plan in pir "
+                         "interpreter for fixed-shape programs");
+
+/**
+ * Using PIR in executor FLAG
+ * Name: pir_interpreter_static_memory_plan
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: Only works with FLAGS_pir_interpreter_static_trace_replay. If True,
+ * the first replay run records the bytes of the intermediate tensors, then
+ * their lifetimes in the replay order are packed into one preallocated
+ * buffer, and later runs bind the tensors to their offsets in the buffer
+ * instead of allocating and releasing them. A tensor larger than planned
+ * falls back to the allocator. Multi-stream programs are not planned.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_static_memory_plan,
+                         false,
+                         "Run the intermediate tensors of pir interpreter "
+                         "from one planned buffer for fixed-shape programs");
+
+/**
+ * Using PIR in executor FLAG
+ * Name: pir_interpreter_cache_infer_meta
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, a phi kernel instruction of the pir interpreter skips
+ * InferMeta when the dims, dtype, layout and lod of its inputs and outputs
+ * are the same as right after its last InferMeta. Ops whose InferMeta reads
+ * the values of tensor attributes are never skipped. Always on for inference.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_interpreter_cache_infer_meta,
+                         false,
+                         "Skip InferMeta of pir interpreter instructions "
+                         "whose input metas do not change between runs");
+
 /**
  * Apply inplace pass to PIR FLAG
  * Name: pir_apply_inplace_pass
@@ -1690,6 +2418,24 @@ PHI_DEFINE_EXPORTED_string(
     "",
     "It controls the forward blacklist ops not to be decomposed.");
 
+// PIR and prim related FLAG
+// Example: FLAGS_prim_decomp_cache=true would reuse the primitive subgraph
+// decomposed for an op when another op has the same name, attributes and
+// input types, instead of running its decomposition rule again.
+PHI_DEFINE_EXPORTED_bool(
+    prim_decomp_cache,
+    false,
+    "Whether to cache the decomposed subgraphs per op signature.");
+
+// PIR and prim related FLAG
+// Example: FLAGS_prim_fused_kernel_reduce_numel=8192 would keep layer_norm,
+// softmax and log_softmax undecomposed when CINN is off, or when one of their
+// reductions covers at least 8192 elements. 0 decomposes them as usual.
+PHI_DEFINE_EXPORTED_int64(
+    prim_fused_kernel_reduce_numel,
+    0,
+    "The reduce size from which ops with a fused kernel are not decomposed.");
+
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL) || \
     defined(PADDLE_WITH_XPU_BKCL) || defined(PADDLE_WITH_CUSTOM_DEVICE)
 /**
@@ -1707,6 +2453,22 @@ PHI_DEFINE_EXPORTED_bool(dynamic_static_unified_comm,
                          "parallel and static mode.");
 #endif  // FLAGS_dynamic_static_unified_comm
 
+/**
+ * Communication library related FLAG
+ * Name: FLAGS_tcp_store_relay_fanout
+ * Since Version: 3.0
+ * Value Range: int32, default=0
+ * Example: FLAGS_tcp_store_relay_fanout=32
+ * Note: The fanout of the tree of relays of the global TCPStore, 0 to connect
+ * all the ranks to the master. With a fanout F, the rank r connects to the
+ * relay served by the rank (r - 1) / F on the port of its endpoint in
+ * PADDLE_TRAINER_ENDPOINTS, so the master serves F connections only.
+ */
+PHI_DEFINE_EXPORTED_int32(tcp_store_relay_fanout,
+                          0,
+                          "The fanout of the tree of relays of the global "
+                          "TCPStore, 0 to disable the relays.");
+
 /**
  * ProcessGroupNCCL related FLAG
  * Name: enable_async_trace
@@ -1722,11 +2484,42 @@ PHI_DEFINE_EXPORTED_bool(enable_async_trace,
 
 PHI_DEFINE_EXPORTED_int32(async_trace_count, 5, "collective async trace count");
 
+/**
+ * ProcessGroupNCCL related FLAG
+ * Name: FLAGS_comm_stats_sample_interval
+ * Since Version: 3.0
+ * Value Range: int32, default=100
+ * Example: FLAGS_comm_stats_sample_interval=1 times every collective
+ * Note: Time one in N collectives of ProcessGroupNCCL with CUDA events to
+ * build the latency histograms of each group and type of collective, 0 to
+ * disable.
+ */
+PHI_DEFINE_EXPORTED_int32(comm_stats_sample_interval,
+                          100,
+                          "Time one in N collectives for the latency "
+                          "histograms, 0 to disable.");
+
 PHI_DEFINE_EXPORTED_bool(
     use_auto_growth_pinned_allocator,
     false,
     "Whether to use the auto_growth CUDA pinned allocator.");
 
+/**
+ * Allocator related FLAG
+ * Name: FLAGS_pinned_memory_numa_local
+ * Since Version: 3.0
+ * Value Range: bool, default=false
+ * Example: FLAGS_pinned_memory_numa_local=true
+ * Note: Map the pinned host memory on the NUMA node of the current GPU and
+ * pin it with cudaHostRegister instead of calling cudaHostAlloc, so that the
+ * copies between host and device stay on the socket of the GPU. Linux and
+ * CUDA only, read when the pinned allocator is created.
+ */
+PHI_DEFINE_EXPORTED_bool(pinned_memory_numa_local,
+                         false,
+                         "Place pinned host memory on the NUMA node of the "
+                         "current GPU.");
+
 PHI_DEFINE_EXPORTED_bool(
     sync_after_alloc,
     false,
@@ -1749,6 +2542,63 @@ PHI_DEFINE_EXPORTED_bool(pir_apply_shape_optimization_pass,
                          "Whether to apply shape_optimization pass "
                          "to infer symbolic shape");
 
+/**
+ * Run the nested pass pipelines of PIR in parallel FLAG
+ * Name: pir_pass_num_threads
+ * Since Version: 3.0.0
+ * Value Range: int32, default=1
+ * Example:
+ * Note: The number of threads a pass manager uses to run its pipeline over
+ * the nested operations isolated from above, 1 runs them sequentially.
+ */
+PHI_DEFINE_EXPORTED_int32(pir_pass_num_threads,
+                          1,
+                          "Number of threads to run the nested pass "
+                          "pipelines of PIR.");
+
+/**
+ * Incremental pattern rewrite of PIR FLAG
+ * Name: pir_incremental_pattern_rewrite
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Example:
+ * Note: If True, the greedy pattern rewrite driver only rescans the ops
+ * touched by the last iteration and their users instead of the whole region.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_incremental_pattern_rewrite,
+                         false,
+                         "Whether the pattern rewrite driver only revisits "
+                         "the ops touched by the last iteration.");
+
+/**
+ * Operation memory pool of PIR FLAG
+ * Name: pir_operation_memory_pool
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Example:
+ * Note: If True, the memory of small operations is carved from large chunks
+ * and recycled by size instead of allocated one by one. Disable it to check
+ * the operations with memory tools.
+ */
+PHI_DEFINE_EXPORTED_bool(pir_operation_memory_pool,
+                         true,
+                         "Whether to pool the memory of PIR operations.");
+
+/**
+ * Constant folding cache of PIR FLAG
+ * Name: pir_constant_folding_cache_dir
+ * Since Version: 3.0.0
+ * Value Range: string, default=empty
+ * Example: FLAGS_pir_constant_folding_cache_dir=/tmp/folding_cache
+ * Note: If not empty, constant_folding_pass saves the results of every folded
+ * operation in this directory, keyed by the operation and the contents of its
+ * inputs, and loads them instead of running the operation again next time.
+ */
+PHI_DEFINE_EXPORTED_string(pir_constant_folding_cache_dir,
+                           "",
+                           "The directory to cache the results of PIR "
+                           "constant folding.");
+
 PHI_DEFINE_EXPORTED_int64(
     pir_broadcast_tree_limit,
     32,
@@ -1988,6 +2838,48 @@ PHI_DEFINE_EXPORTED_bool(enable_auto_parallel_align_mode,
                          false,
                          "Enable align mode for auto parallel");
 
+/**
+ * Auto parallel related FLAG
+ * Name: reshard_planner
+ * Since Version: 3.0.0
+ * Value Range: bool, default=false
+ * Note: Reshard on a N-d mesh along the path of 1-d reshards with the least
+ * estimated communication time instead of the fixed partial -> replicated ->
+ * shard order.
+ */
+PHI_DEFINE_EXPORTED_bool(reshard_planner,
+                         false,
+                         "Plan the N-d mesh reshards by communication cost");
+
+/**
+ * Auto parallel related FLAG
+ * Name: enable_spmd_rule_cache
+ * Since Version: 3.0.0
+ * Value Range: bool, default=true
+ * Note: In dygraph auto parallel, reuse the InferSpmd result of an api called
+ * again with the same input shapes, dist attrs and attributes, and the reshard
+ * function chosen for the same pair of dist attrs.
+ */
+PHI_DEFINE_EXPORTED_bool(enable_spmd_rule_cache,
+                         true,
+                         "Cache InferSpmd results and reshard functions in "
+                         "dygraph auto parallel");
+
+/**
+ * Auto parallel related FLAG
+ * Name: reshard_mesh_axis_bandwidths
+ * Since Version: 3.0.0
+ * Value Range: string, default=""
+ * Example: FLAGS_reshard_mesh_axis_bandwidths="25,200" means the ranks along
+ * mesh axis 0 are connected with 25GB/s and the ones along axis 1 with
+ * 200GB/s, e.g. across nodes and inside a node.
+ * Note: Used by the reshard planner, the axes not given use the last
+ * bandwidth, all axes are equal by default.
+ */
+PHI_DEFINE_EXPORTED_string(reshard_mesh_axis_bandwidths,
+                           "",
+                           "Bandwidth in GB/s of each process mesh axis");
+
 /**
  * fused_multi_transformer_op related FLAG
  * Name: fused_multi_transformer_op_use_mbfmha
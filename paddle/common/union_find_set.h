@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <unordered_map>
 #include <vector>
 
@@ -23,31 +24,55 @@ template <typename T>
 class UnionFindSet {
  public:
   const T& Find(const T& x) const {
-    if (parent_.find(x) == parent_.end()) {
+    auto iter = parent_.find(x);
+    if (iter == parent_.end()) {
       return x;
     }
-    if (parent_.at(x) != x) return Find(parent_.at(x));
-    return parent_.at(x);
+    while (iter->second != iter->first) {
+      iter = parent_.find(iter->second);
+    }
+    return iter->first;
   }
 
   const T& Find(const T& x) {
-    if (parent_.find(x) == parent_.end()) {
+    auto iter = parent_.find(x);
+    if (iter == parent_.end()) {
       return x;
     }
-    if (parent_[x] != x) {
-      parent_[x] = Find(parent_[x]);
+    auto root = iter;
+    while (root->second != root->first) {
+      root = parent_.find(root->second);
+    }
+    // path compression
+    while (iter != root) {
+      auto next = parent_.find(iter->second);
+      iter->second = root->first;
+      iter = next;
     }
-    return parent_.at(x);
+    return root->first;
   }
 
   void Union(const T& p, const T& q) {
-    if (parent_.find(p) == parent_.end()) {
-      parent_[p] = p;
+    parent_.try_emplace(p, p);
+    parent_.try_emplace(q, q);
+    const T& p_root = Find(p);
+    const T& q_root = Find(q);
+    if (p_root == q_root) {
+      return;
     }
-    if (parent_.find(q) == parent_.end()) {
-      parent_[q] = q;
+    // Union by rank keeps the trees shallow, the root of p is kept on a tie.
+    auto p_rank = rank_.find(p_root);
+    auto q_rank = rank_.find(q_root);
+    size_t p_rank_value = p_rank == rank_.end() ? 0 : p_rank->second;
+    size_t q_rank_value = q_rank == rank_.end() ? 0 : q_rank->second;
+    if (p_rank_value < q_rank_value) {
+      parent_[p_root] = q_root;
+    } else {
+      if (p_rank_value == q_rank_value) {
+        rank_[p_root] = p_rank_value + 1;
+      }
+      parent_[q_root] = p_root;
     }
-    parent_[Find(q)] = Find(p);
   }
 
   const std::unordered_map<T, T>& GetMap() const { return parent_; }
@@ -69,6 +94,8 @@ class UnionFindSet {
 
  private:
   std::unordered_map<T, T> parent_;
+  // the rank of the roots higher than 0
+  std::unordered_map<T, size_t> rank_;
 };
 
 }  // namespace common
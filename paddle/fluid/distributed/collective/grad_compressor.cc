@@ -0,0 +1,267 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/grad_compressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+using Tensor = paddle::Tensor;
+using IntArray = paddle::experimental::IntArrayBase<paddle::Tensor>;
+
+// the largest finite value of float8_e4m3fn
+static constexpr float kFP8E4M3Max = 448.0f;
+// the seed of the initial Q, it must be the same on all the ranks
+static constexpr int kPowerSGDSeed = 2024;
+
+static phi::DenseTensor *GetDenseTensor(const Tensor &tensor) {
+  return std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl()).get();
+}
+
+Tensor GradCompressor::AllReduce(const Tensor &contents,
+                                 size_t group_index,
+                                 ProcessGroup *process_group,
+                                 std::shared_ptr<ProcessGroup::Task> *task) {
+  Tensor input = contents;
+  if (error_feedback_) {
+    auto iter = residuals_.find(group_index);
+    if (iter != residuals_.end()) {
+      input = paddle::experimental::add(contents, iter->second);
+    }
+  }
+
+  Tensor local;
+  Tensor out = Reduce(input, group_index, process_group, &local, task);
+  if (error_feedback_) {
+    residuals_[group_index] = paddle::experimental::subtract(input, local);
+  }
+  return out;
+}
+
+std::shared_ptr<ProcessGroup::Task> GradCompressor::AllReduceSum(
+    ProcessGroup *process_group, Tensor *tensor) {
+  distributed::AllreduceOptions opts;
+  opts.reduce_op = ReduceOp::SUM;
+  auto *dense = GetDenseTensor(*tensor);
+  auto task = process_group->AllReduce(dense, *dense, opts, false);
+  // the decompression runs on the calculation stream
+  task->Wait();
+  return task;
+}
+
+Tensor GradCompressor::AllGather(ProcessGroup *process_group,
+                                 const Tensor &tensor,
+                                 std::shared_ptr<ProcessGroup::Task> *task) {
+  Tensor out = paddle::experimental::empty(
+      IntArray({process_group->GetSize() * tensor.numel()}),
+      tensor.dtype(),
+      tensor.place());
+  *task = process_group->AllGather(GetDenseTensor(out),
+                                   *GetDenseTensor(tensor),
+                                   /*offset*/ 0,
+                                   /*numel*/ -1,
+                                   false);
+  (*task)->Wait();
+  return out;
+}
+
+CastGradCompressor::CastGradCompressor(phi::DataType dtype,
+                                       bool error_feedback)
+    : GradCompressor(error_feedback), dtype_(dtype) {
+  PADDLE_ENFORCE_EQ(
+      dtype_ == phi::DataType::BFLOAT16 ||
+          dtype_ == phi::DataType::FLOAT8_E4M3FN,
+      true,
+      common::errors::InvalidArgument(
+          "Gradients can only be cast to bfloat16 or float8_e4m3fn, "
+          "but got %s.",
+          dtype_));
+}
+
+std::string CastGradCompressor::name() const {
+  return dtype_ == phi::DataType::BFLOAT16 ? "bf16" : "fp8";
+}
+
+Tensor CastGradCompressor::Reduce(const Tensor &input,
+                                  size_t group_index UNUSED,
+                                  ProcessGroup *process_group,
+                                  Tensor *local,
+                                  std::shared_ptr<ProcessGroup::Task> *task) {
+  const auto origin_dtype = input.dtype();
+  if (dtype_ == phi::DataType::BFLOAT16) {
+    Tensor low = paddle::experimental::cast(input, dtype_);
+    *local = paddle::experimental::cast(low, origin_dtype);
+    bytes_sent_ += low.numel() * phi::SizeOf(dtype_);
+    *task = AllReduceSum(process_group, &low);
+    return paddle::experimental::cast(low, origin_dtype);
+  }
+
+  // scale the max absolute value of the rank to the max of e4m3
+  Tensor amax = paddle::experimental::reshape(
+      paddle::experimental::max(paddle::experimental::abs(input)), {1});
+  amax = paddle::experimental::clip(
+      amax, std::numeric_limits<float>::min(), kFP8E4M3Max * 1e30f);
+  Tensor inv_scale = paddle::experimental::scale(amax, 1.0 / kFP8E4M3Max);
+  Tensor low = paddle::experimental::cast(
+      paddle::experimental::divide(input, inv_scale), dtype_);
+  *local = paddle::experimental::multiply(
+      paddle::experimental::cast(low, origin_dtype), inv_scale);
+
+  // FP8 can't be summed by the collectives, gather the bits and the scales
+  // of all ranks and sum them here
+  const int64_t numel = low.numel();
+  const int64_t nranks = process_group->GetSize();
+  bytes_sent_ += numel * phi::SizeOf(dtype_) + phi::SizeOf(origin_dtype);
+  Tensor gathered_bits = AllGather(
+      process_group,
+      paddle::experimental::view_dtype(low, phi::DataType::UINT8),
+      task);
+  Tensor gathered_scales = AllGather(process_group, inv_scale, task);
+  Tensor gathered = paddle::experimental::cast(
+      paddle::experimental::view_dtype(gathered_bits, dtype_), origin_dtype);
+  Tensor dequantized = paddle::experimental::multiply(
+      paddle::experimental::reshape(gathered, {nranks, numel}),
+      paddle::experimental::reshape(gathered_scales, {nranks, 1}));
+  return paddle::experimental::sum(dequantized, {0});
+}
+
+TopKGradCompressor::TopKGradCompressor(double ratio, bool error_feedback)
+    : GradCompressor(error_feedback), ratio_(ratio) {
+  PADDLE_ENFORCE_EQ(
+      ratio_ > 0.0 && ratio_ <= 1.0,
+      true,
+      common::errors::InvalidArgument(
+          "The ratio of top-k compression should be in (0, 1], but got %f.",
+          ratio_));
+}
+
+Tensor TopKGradCompressor::Reduce(const Tensor &input,
+                                  size_t group_index UNUSED,
+                                  ProcessGroup *process_group,
+                                  Tensor *local,
+                                  std::shared_ptr<ProcessGroup::Task> *task) {
+  const int64_t numel = input.numel();
+  const int64_t k = std::max<int64_t>(
+      1, static_cast<int64_t>(static_cast<double>(numel) * ratio_));
+
+  auto topk = paddle::experimental::topk(
+      paddle::experimental::abs(input), k, -1, true, false);
+  Tensor indices = std::get<1>(topk);
+  Tensor values = paddle::experimental::gather(input, indices);
+  Tensor zeros =
+      paddle::experimental::full_like(input, 0, input.dtype(), input.place());
+  *local = paddle::experimental::scatter(zeros, indices, values, true);
+
+  bytes_sent_ += k * (phi::SizeOf(input.dtype()) + sizeof(int64_t));
+  Tensor all_indices = AllGather(process_group, indices, task);
+  Tensor all_values = AllGather(process_group, values, task);
+  // the positions chosen by several ranks are accumulated
+  return paddle::experimental::scatter(zeros, all_indices, all_values, false);
+}
+
+PowerSGDGradCompressor::PowerSGDGradCompressor(int rank, bool error_feedback)
+    : GradCompressor(error_feedback), rank_(rank) {
+  PADDLE_ENFORCE_GT(rank_,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The rank of PowerSGD should be greater than 0, "
+                        "but got %d.",
+                        rank_));
+}
+
+Tensor PowerSGDGradCompressor::Reduce(
+    const Tensor &input,
+    size_t group_index,
+    ProcessGroup *process_group,
+    Tensor *local,
+    std::shared_ptr<ProcessGroup::Task> *task) {
+  const auto origin_dtype = input.dtype();
+  // qr has no low precision kernels
+  const auto dtype = origin_dtype == phi::DataType::FLOAT64
+                         ? phi::DataType::FLOAT64
+                         : phi::DataType::FLOAT32;
+  const int64_t numel = input.numel();
+  const int64_t side =
+      static_cast<int64_t>(std::ceil(std::sqrt(static_cast<double>(numel))));
+  const int64_t rank = std::min<int64_t>(rank_, side);
+
+  Tensor flat = paddle::experimental::cast(input, dtype);
+  if (side * side > numel) {
+    Tensor padding = paddle::experimental::full(
+        IntArray({side * side - numel}), 0, dtype, input.place());
+    flat = paddle::experimental::concat({flat, padding}, 0);
+  }
+  Tensor matrix = paddle::experimental::reshape(flat, {side, side});
+
+  auto iter = qs_.find(group_index);
+  if (iter == qs_.end() || iter->second.dims()[0] != side) {
+    iter = qs_.insert_or_assign(group_index,
+                                paddle::experimental::gaussian(
+                                    IntArray({side, rank}),
+                                    0.0f,
+                                    1.0f,
+                                    kPowerSGDSeed,
+                                    dtype,
+                                    input.place()))
+               .first;
+  }
+
+  bytes_sent_ += 2 * side * rank * phi::SizeOf(dtype);
+  Tensor p = paddle::experimental::matmul(matrix, iter->second, false, false);
+  AllReduceSum(process_group, &p);
+  p = std::get<0>(paddle::experimental::qr(p, "reduced"));
+  Tensor q = paddle::experimental::matmul(matrix, p, true, false);
+  *task = AllReduceSum(process_group, &q);
+  iter->second = q;
+
+  Tensor approx = paddle::experimental::reshape(
+      paddle::experimental::matmul(p, q, false, true), {side * side});
+  if (side * side > numel) {
+    approx = paddle::experimental::slice(approx, {0}, {0}, {numel}, {1}, {});
+  }
+  *local = paddle::experimental::cast(approx, origin_dtype);
+  return *local;
+}
+
+std::shared_ptr<GradCompressor> CreateGradCompressor(const std::string &codec,
+                                                     double topk_ratio,
+                                                     int powersgd_rank,
+                                                     bool error_feedback) {
+  if (codec == "bf16") {
+    return std::make_shared<CastGradCompressor>(phi::DataType::BFLOAT16,
+                                                error_feedback);
+  } else if (codec == "fp8") {
+    return std::make_shared<CastGradCompressor>(phi::DataType::FLOAT8_E4M3FN,
+                                                error_feedback);
+  } else if (codec == "topk") {
+    return std::make_shared<TopKGradCompressor>(topk_ratio, error_feedback);
+  } else if (codec == "powersgd") {
+    return std::make_shared<PowerSGDGradCompressor>(powersgd_rank,
+                                                    error_feedback);
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown gradient compression codec %s, it should be one of bf16, fp8, "
+      "topk and powersgd.",
+      codec));
+}
+
+}  //  namespace distributed
+}  //  namespace paddle
@@ -0,0 +1,152 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/common/data_type.h"
+
+namespace paddle {
+namespace distributed {
+
+// Compresses the fused gradients of a dense EagerGroup before they are
+// reduced across the ranks. The part of the gradient a codec drops is kept
+// on device as an error feedback residual and added back to the gradient of
+// the same group in the next step.
+class GradCompressor {
+ public:
+  explicit GradCompressor(bool error_feedback)
+      : error_feedback_(error_feedback) {}
+
+  virtual ~GradCompressor() {}
+
+  // Returns the sum over the ranks of `contents`, the fused gradients of
+  // group `group_index` already divided by nranks. The result is ready on the
+  // calculation stream, `task` is set to the last communication launched.
+  paddle::Tensor AllReduce(const paddle::Tensor &contents,
+                           size_t group_index,
+                           ProcessGroup *process_group,
+                           std::shared_ptr<ProcessGroup::Task> *task);
+
+  // Drops the residuals and the codec state, the group indices they are kept
+  // by are no longer valid once the groups are rebuilt.
+  virtual void Reset() { residuals_.clear(); }
+
+  virtual std::string name() const = 0;
+
+  // Bytes this rank has put into the collectives since it was created.
+  int64_t bytes_sent() const { return bytes_sent_; }
+
+ protected:
+  // Reduces the compressed `input` and sets `local` to what this rank
+  // contributed after compression, the residual is `input - local`.
+  virtual paddle::Tensor Reduce(const paddle::Tensor &input,
+                                size_t group_index,
+                                ProcessGroup *process_group,
+                                paddle::Tensor *local,
+                                std::shared_ptr<ProcessGroup::Task> *task) = 0;
+
+  std::shared_ptr<ProcessGroup::Task> AllReduceSum(ProcessGroup *process_group,
+                                                   paddle::Tensor *tensor);
+  paddle::Tensor AllGather(ProcessGroup *process_group,
+                           const paddle::Tensor &tensor,
+                           std::shared_ptr<ProcessGroup::Task> *task);
+
+  bool error_feedback_;
+  int64_t bytes_sent_{0};
+  std::unordered_map<size_t, paddle::Tensor> residuals_;
+};
+
+// Casts the gradients to BF16 or FP8 (e4m3). BF16 keeps the range of FP32 and
+// is summed by the allreduce directly. FP8 gradients are scaled by the max
+// absolute value of each rank into the range of e4m3, gathered with their
+// scales and summed in the original dtype, since FP8 can't be accumulated.
+class CastGradCompressor : public GradCompressor {
+ public:
+  CastGradCompressor(phi::DataType dtype, bool error_feedback);
+
+  std::string name() const override;
+
+ protected:
+  paddle::Tensor Reduce(const paddle::Tensor &input,
+                        size_t group_index,
+                        ProcessGroup *process_group,
+                        paddle::Tensor *local,
+                        std::shared_ptr<ProcessGroup::Task> *task) override;
+
+ private:
+  phi::DataType dtype_;
+};
+
+// Sends the `ratio` share of the gradients with the largest magnitude with
+// their indices, the gathered values of all ranks are added into a dense
+// tensor.
+class TopKGradCompressor : public GradCompressor {
+ public:
+  TopKGradCompressor(double ratio, bool error_feedback);
+
+  std::string name() const override { return "topk"; }
+
+ protected:
+  paddle::Tensor Reduce(const paddle::Tensor &input,
+                        size_t group_index,
+                        ProcessGroup *process_group,
+                        paddle::Tensor *local,
+                        std::shared_ptr<ProcessGroup::Task> *task) override;
+
+ private:
+  double ratio_;
+};
+
+// PowerSGD: the group is padded into a square matrix M and approximated by
+// P * Q^T of rank `rank` with a single power iteration, P = orth(M Q) and
+// Q = M^T P, each factor being allreduced. Q is reused as the start of the
+// iteration of the next step.
+class PowerSGDGradCompressor : public GradCompressor {
+ public:
+  PowerSGDGradCompressor(int rank, bool error_feedback);
+
+  std::string name() const override { return "powersgd"; }
+
+  void Reset() override {
+    GradCompressor::Reset();
+    qs_.clear();
+  }
+
+ protected:
+  paddle::Tensor Reduce(const paddle::Tensor &input,
+                        size_t group_index,
+                        ProcessGroup *process_group,
+                        paddle::Tensor *local,
+                        std::shared_ptr<ProcessGroup::Task> *task) override;
+
+ private:
+  int rank_;
+  std::unordered_map<size_t, paddle::Tensor> qs_;
+};
+
+// Creates the compressor of `codec`, one of "bf16", "fp8", "topk" and
+// "powersgd".
+std::shared_ptr<GradCompressor> CreateGradCompressor(const std::string &codec,
+                                                     double topk_ratio,
+                                                     int powersgd_rank,
+                                                     bool error_feedback);
+
+}  //  namespace distributed
+}  //  namespace paddle
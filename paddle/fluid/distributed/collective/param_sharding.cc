@@ -0,0 +1,291 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/distributed/collective/param_sharding.h"
+
+#include "paddle/fluid/eager/accumulation/accumulation_node.h"
+#include "paddle/fluid/eager/api/utils/global_utils.h"
+#include "paddle/fluid/eager/autograd_meta.h"
+#include "paddle/fluid/eager/grad_node_info.h"
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace paddle {
+namespace distributed {
+
+using IntArray = paddle::experimental::IntArrayBase<paddle::Tensor>;
+
+static phi::DenseTensor *GetDenseTensor(const Tensor &tensor) {
+  return std::dynamic_pointer_cast<phi::DenseTensor>(tensor.impl()).get();
+}
+
+// flattens `tensor` and pads it with zeros to `padded_numel` elements
+static Tensor FlattenAndPad(const Tensor &tensor,
+                            int64_t numel,
+                            int64_t padded_numel) {
+  Tensor flat = paddle::experimental::reshape(tensor, {numel});
+  if (padded_numel > numel) {
+    Tensor padding = paddle::experimental::full(IntArray({padded_numel - numel}),
+                                                0,
+                                                tensor.dtype(),
+                                                tensor.place());
+    flat = paddle::experimental::concat({flat, padding}, 0);
+  }
+  return flat;
+}
+
+EagerParamSharding::EagerParamSharding(
+    const std::vector<std::vector<Tensor>> &units,
+    std::shared_ptr<ProcessGroup> process_group,
+    int prefetch_depth,
+    bool reshard_after_forward)
+    : params_(),
+      units_(units.size()),
+      accumulation_node_index_(),
+      pending_grads_(),
+      process_group_(process_group),
+      prefetch_depth_(prefetch_depth),
+      reshard_after_forward_(reshard_after_forward) {
+  VLOG(3) << "Start construct the EagerParamSharding ...";
+  PADDLE_ENFORCE_GE(prefetch_depth_,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The prefetch depth should be non-negative, "
+                        "but got %d.",
+                        prefetch_depth_));
+
+  nranks_ = process_group_->GetSize();
+  rank_ = process_group_->GetRank();
+
+  for (size_t unit_index = 0; unit_index < units.size(); ++unit_index) {
+    for (const auto &tensor : units[unit_index]) {
+      PADDLE_ENFORCE_EQ(
+          tensor.is_dense_tensor() && tensor.initialized(),
+          true,
+          common::errors::PreconditionNotMet(
+              "Tensor %s to shard must be an initialized DenseTensor.",
+              tensor.name()));
+      const size_t param_index = params_.size();
+
+      ShardedParam param;
+      param.param = tensor;
+      param.numel = tensor.numel();
+      param.shard_numel = (param.numel + nranks_ - 1) / nranks_;
+      param.unit_index = unit_index;
+
+      Tensor flat =
+          FlattenAndPad(tensor, param.numel, param.shard_numel * nranks_);
+      param.shard = paddle::experimental::assign(
+          paddle::experimental::slice(flat,
+                                      {0},
+                                      {rank_ * param.shard_numel},
+                                      {(rank_ + 1) * param.shard_numel},
+                                      {1},
+                                      {}));
+      param.shard.set_name(tensor.name() + "@shard");
+      auto *shard_meta = egr::EagerUtils::autograd_meta(&param.shard);
+      shard_meta->SetStopGradient(false);
+      shard_meta->SetPersistable(true);
+
+      auto *autograd_meta = tensor.get_autograd_meta();
+      const auto &grad_node = static_cast<egr::AutogradMeta *>(autograd_meta)
+                                  ->GetMutableGradNode();
+      PADDLE_ENFORCE(
+          grad_node.get() != nullptr,
+          common::errors::Fatal("Detected NULL grad_node,"
+                                "Leaf tensor should have had grad_node "
+                                "with type: GradNodeAccumulation"));
+      const auto &accumulation_grad_node =
+          std::dynamic_pointer_cast<egr::GradNodeAccumulation>(grad_node);
+      accumulation_grad_node->RegisterReduceHook(
+          std::make_shared<egr::CppVoidHook>(
+              [=]() { this->ReduceScatterGrad(param_index); }));
+      accumulation_node_index_[grad_node.get()] = param_index;
+
+      units_[unit_index].param_indices.push_back(param_index);
+      params_.push_back(std::move(param));
+    }
+    units_[unit_index].pending = units_[unit_index].param_indices.size();
+  }
+
+  // only the shards are kept from now on
+  for (auto &param : params_) {
+    GetDenseTensor(param.param)->clear();
+  }
+
+  egr::Controller::Instance().AddBackwardRunObserver(this);
+}
+
+EagerParamSharding::~EagerParamSharding() {
+  egr::Controller::Instance().RemoveBackwardRunObserver(this);
+}
+
+std::vector<Tensor> EagerParamSharding::Shards() const {
+  std::vector<Tensor> shards;
+  shards.reserve(params_.size());
+  for (const auto &param : params_) {
+    shards.push_back(param.shard);
+  }
+  return shards;
+}
+
+void EagerParamSharding::Gather(size_t unit_index) {
+  auto &unit = units_[unit_index];
+  if (unit.state != State::kSharded) return;
+
+  VLOG(3) << "Gather unit [" << unit_index << "]";
+  for (const auto param_index : unit.param_indices) {
+    auto &param = params_[param_index];
+    Tensor buffer =
+        paddle::experimental::empty(IntArray({param.shard_numel * nranks_}),
+                                    param.shard.dtype(),
+                                    param.shard.place());
+    param.buffer = *GetDenseTensor(buffer);
+    param.task = process_group_->AllGather(&param.buffer,
+                                           *GetDenseTensor(param.shard),
+                                           /*offset*/ 0,
+                                           /*numel*/ -1,
+                                           false);
+  }
+  unit.state = State::kGathering;
+}
+
+void EagerParamSharding::WaitGathered(size_t unit_index) {
+  Gather(unit_index);
+  auto &unit = units_[unit_index];
+  if (unit.state == State::kGathered) return;
+
+  for (const auto param_index : unit.param_indices) {
+    auto &param = params_[param_index];
+    // the calc stream waits for the all-gather, the host doesn't
+    param.task->Wait();
+    param.task.reset();
+    GetDenseTensor(param.param)->ResetHolder(param.buffer.Holder());
+  }
+  unit.state = State::kGathered;
+}
+
+void EagerParamSharding::Free(size_t unit_index) {
+  auto &unit = units_[unit_index];
+  if (unit.state == State::kSharded) return;
+
+  VLOG(3) << "Free unit [" << unit_index << "]";
+  for (const auto param_index : unit.param_indices) {
+    auto &param = params_[param_index];
+    if (param.task) {
+      param.task->Wait();
+      param.task.reset();
+    }
+    GetDenseTensor(param.param)->clear();
+    param.buffer = phi::DenseTensor();
+  }
+  unit.state = State::kSharded;
+}
+
+void EagerParamSharding::PreForward(size_t unit_index) {
+  PADDLE_ENFORCE_LT(unit_index,
+                    units_.size(),
+                    common::errors::OutOfRange(
+                        "The unit index should be less than %d, but got %d.",
+                        units_.size(),
+                        unit_index));
+  WaitGathered(unit_index);
+  for (size_t i = unit_index + 1;
+       i < units_.size() && i <= unit_index + prefetch_depth_;
+       ++i) {
+    Gather(i);
+  }
+}
+
+void EagerParamSharding::PostForward(size_t unit_index) {
+  // the backward starts with the last unit
+  if (reshard_after_forward_ && unit_index + 1 < units_.size()) {
+    Free(unit_index);
+  }
+}
+
+void EagerParamSharding::PreRunGradNode(egr::GradNodeBase *node) {
+  for (const auto &slot : node->OutputMeta()) {
+    for (const auto &meta : slot) {
+      const auto &edge = meta.GetEdge();
+      if (!edge.IsInitialized()) continue;
+      auto iter = accumulation_node_index_.find(edge.GetGradNode());
+      if (iter == accumulation_node_index_.end()) continue;
+
+      // the node computes the grad of a sharded param, it reads the param
+      const size_t unit_index = params_[iter->second].unit_index;
+      if (units_[unit_index].state == State::kGathered) continue;
+      WaitGathered(unit_index);
+      for (size_t i = 1; i <= static_cast<size_t>(prefetch_depth_) &&
+                         i <= unit_index;
+           ++i) {
+        Gather(unit_index - i);
+      }
+    }
+  }
+}
+
+void EagerParamSharding::ReduceScatterGrad(size_t param_index) {
+  auto &param = params_[param_index];
+  auto *grad = egr::EagerUtils::mutable_grad(param.param);
+  if (grad != nullptr && grad->initialized()) {
+    PendingGrad pending;
+    pending.param_index = param_index;
+    pending.input =
+        FlattenAndPad(*grad, param.numel, param.shard_numel * nranks_);
+    pending.output = paddle::experimental::empty(
+        IntArray({param.shard_numel}), grad->dtype(), grad->place());
+    distributed::ReduceScatterOptions opts;
+    opts.reduce_op = ReduceOp::SUM;
+    pending.task = process_group_->ReduceScatter(
+        GetDenseTensor(pending.output),
+        *GetDenseTensor(pending.input),
+        opts,
+        false);
+    pending_grads_.push_back(std::move(pending));
+    // the full grad is kept by the pending reduce-scatter only
+    grad->reset();
+  }
+
+  auto &unit = units_[param.unit_index];
+  if (unit.pending > 0 && --unit.pending == 0) {
+    Free(param.unit_index);
+  }
+}
+
+void EagerParamSharding::PostBackward() {
+  for (auto &pending : pending_grads_) {
+    pending.task->Wait();
+    auto &param = params_[pending.param_index];
+    Tensor shard_grad =
+        paddle::experimental::scale(pending.output, 1.0 / nranks_, 0.0, true);
+    auto *grad = egr::EagerUtils::mutable_grad(param.shard);
+    if (grad->defined() && grad->initialized()) {
+      *grad = paddle::experimental::add(*grad, shard_grad);
+    } else {
+      *grad = shard_grad;
+    }
+  }
+  pending_grads_.clear();
+
+  // the units of unused params are still gathered
+  for (size_t unit_index = 0; unit_index < units_.size(); ++unit_index) {
+    Free(unit_index);
+    units_[unit_index].pending = units_[unit_index].param_indices.size();
+  }
+}
+
+}  //  namespace distributed
+}  //  namespace paddle
@@ -0,0 +1,109 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/fluid/eager/hooks.h"
+#include "paddle/phi/api/include/tensor.h"
+
+namespace paddle {
+namespace distributed {
+
+// Shards the parameters of a model over the ranks of a process group like
+// ZeRO stage 3. Each rank keeps 1/nranks of every parameter, the full
+// parameters of a unit (usually a layer) are all-gathered before they are
+// used and freed right after:
+//   - in the forward, PreForward of unit i waits for its parameters and
+//     prefetches the units i+1 .. i+prefetch_depth, PostForward frees them,
+//   - in the backward, the GradNode with an edge to the accumulation node of
+//     a parameter of unit i waits for the unit and prefetches the units
+//     i-1 .. i-prefetch_depth. The unit is freed once the gradients of all
+//     its parameters are accumulated, and each gradient is reduce-scattered
+//     into the grad of its shard.
+// The parameters keep their DenseTensor while they are sharded, only its
+// holder is released, so the TensorWrappers of the backward see the gathered
+// values again. Like the EagerReducer, it must outlive the backward of the
+// parameters it registered reduce hooks on.
+class EagerParamSharding : public egr::BackwardRunObserver {
+ public:
+  EagerParamSharding(const std::vector<std::vector<Tensor>> &units,
+                     std::shared_ptr<ProcessGroup> process_group,
+                     int prefetch_depth,
+                     bool reshard_after_forward);
+
+  ~EagerParamSharding() override;
+
+  void PreForward(size_t unit_index);
+  void PostForward(size_t unit_index);
+
+  // The shards of this rank in the order of registration, the optimizer
+  // updates them and reads their grads.
+  std::vector<Tensor> Shards() const;
+
+  void PreRunGradNode(egr::GradNodeBase *node) override;
+  void PostBackward() override;
+
+ private:
+  enum class State { kSharded, kGathering, kGathered };
+
+  struct ShardedParam {
+    Tensor param;
+    Tensor shard;
+    int64_t numel;
+    int64_t shard_numel;
+    size_t unit_index;
+    // the all-gather output while the unit is not sharded
+    phi::DenseTensor buffer;
+    std::shared_ptr<ProcessGroup::Task> task;
+  };
+
+  struct Unit {
+    std::vector<size_t> param_indices;
+    State state = State::kSharded;
+    // params whose grad hasn't been accumulated in this backward
+    size_t pending = 0;
+  };
+
+  struct PendingGrad {
+    size_t param_index;
+    // kept alive until the reduce-scatter finished
+    Tensor input;
+    Tensor output;
+    std::shared_ptr<ProcessGroup::Task> task;
+  };
+
+  void Gather(size_t unit_index);
+  void WaitGathered(size_t unit_index);
+  void Free(size_t unit_index);
+  void ReduceScatterGrad(size_t param_index);
+
+  std::vector<ShardedParam> params_;
+  std::vector<Unit> units_;
+  std::unordered_map<egr::GradNodeBase *, size_t> accumulation_node_index_;
+  std::vector<PendingGrad> pending_grads_;
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  int prefetch_depth_;
+  bool reshard_after_forward_;
+  int64_t nranks_;
+  int64_t rank_;
+};
+
+}  //  namespace distributed
+}  //  namespace paddle
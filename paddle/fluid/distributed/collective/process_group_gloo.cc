@@ -345,8 +345,18 @@ class AllreduceGlooTask : public ProcessGroupGloo::GlooTask {
 
   void _do_allreduce(std::vector<phi::DenseTensor>& ins,     // NOLINT
                      std::vector<phi::DenseTensor>& outs) {  // NOLINT
+    if (ins.size() == 1) {
+      _comm_context->AllReduce(
+          &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+      return;
+    }
+    std::vector<phi::DenseTensor*> out_ptrs;
+    out_ptrs.reserve(outs.size());
+    for (auto& out : outs) {
+      out_ptrs.push_back(&out);
+    }
     _comm_context->AllReduce(
-        &(outs[0]), ins[0], static_cast<int>(_reduce_op), _tag);
+        out_ptrs, ins, static_cast<int>(_reduce_op), _tag);
   }
 };
 
@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/collective/process_group_nccl.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/collective/common.h"
 #include "paddle/phi/api/lib/utils/allocator.h"
@@ -21,6 +27,7 @@
 #include "paddle/phi/core/distributed/check/nccl_dynamic_check.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
+#include "paddle/phi/core/distributed/comm_stats.h"
 #include "paddle/phi/core/distributed/comm_task_manager.h"
 #include "paddle/phi/core/distributed/nccl_comm_task.h"
 #include "paddle/phi/core/distributed/nccl_tools.h"
@@ -37,6 +44,7 @@ COMMON_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(enable_async_trace);
 COMMON_DECLARE_bool(eager_communication_connection);
+COMMON_DECLARE_bool(nccl_hierarchical_allreduce);
 
 // set this flag to `true` and recompile to enable dynamic checks
 constexpr bool FLAGS_enable_nccl_dynamic_check = false;
@@ -147,7 +155,8 @@ ProcessGroupNCCL::ProcessGroupNCCL(
       place_to_group_key_(),
       pg_timeout_(timeout),
       nccl_comm_init_option_(nccl_comm_init_option),
-      allocation_stream_pairs_() {
+      allocation_stream_pairs_(),
+      hierarchical_allreduce_(FLAGS_nccl_hierarchical_allreduce) {
   LOG(INFO) << "ProcessGroupNCCL pg_timeout_ " << pg_timeout_;
   LOG(INFO) << "ProcessGroupNCCL nccl_comm_init_option_ "
             << nccl_comm_init_option_;
@@ -273,6 +282,31 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::AllReduce(
   CheckTensorContiguous(in_tensor);
   CheckTensorContiguous(*out_tensor);
 
+  // the sub-communicators can't join a group of calls in progress
+  if (hierarchical_allreduce_ && s_group_call_counter == 0 &&
+      !is_coalescing_ && InitHierarchicalComms(in_tensor.place())) {
+    return Collective(
+        [&](phi::distributed::NCCLCommContext* comm_context,
+            gpuStream_t stream) {
+          VLOG(3) << "[hierarchical ncclAllReduce] "
+                  << "sendbuff: " << in_tensor.data()
+                  << ", recvbuff: " << out_tensor->data()
+                  << ", count: " << in_tensor.numel()
+                  << ", local size: " << intra_node_comm_->GetSize()
+                  << ", nodes: " << inter_node_comm_->GetSize() << ", "
+                  << GetGroupMessage();
+          HierarchicalAllReduce(out_tensor,
+                                in_tensor,
+                                ToNCCLRedType(opts.reduce_op),
+                                comm_context,
+                                stream);
+        },
+        in_tensor,
+        CommType::ALLREDUCE,
+        sync_op,
+        use_calc_stream);
+  }
+
   return Collective(
       [&](phi::distributed::NCCLCommContext* comm_context, gpuStream_t stream) {
         VLOG(3) << "[ncclAllReduce] "
@@ -896,6 +930,143 @@ void ProcessGroupNCCL::EagerConnectRingExchange() {
   }
 }
 
+bool ProcessGroupNCCL::InitHierarchicalComms(const Place& place) {
+  if (hierarchical_comms_inited_) {
+    return intra_node_comm_ != nullptr;
+  }
+  hierarchical_comms_inited_ = true;
+
+  // find the ranks of every node from their host names
+  char host_name[256] = {0};
+  gethostname(host_name, sizeof(host_name) - 1);
+  const std::string host_prefix =
+      "nccl_ids/" + std::to_string(gid_) + "/host/";
+  store_->set(host_prefix + std::to_string(rank_),
+              std::vector<uint8_t>(host_name, host_name + strlen(host_name)));
+  std::vector<std::string> hosts;
+  std::vector<std::vector<int>> node_ranks;
+  int node_index = -1;
+  int local_rank = -1;
+  for (int rank = 0; rank < size_; ++rank) {
+    auto value = store_->get(host_prefix + std::to_string(rank));
+    std::string host(value.begin(), value.end());
+    auto it = std::find(hosts.begin(), hosts.end(), host);
+    if (it == hosts.end()) {
+      hosts.push_back(host);
+      node_ranks.emplace_back();
+      it = hosts.end() - 1;
+    }
+    auto& ranks = node_ranks[it - hosts.begin()];
+    if (rank == rank_) {
+      node_index = static_cast<int>(it - hosts.begin());
+      local_rank = static_cast<int>(ranks.size());
+    }
+    ranks.push_back(rank);
+  }
+
+  const int num_nodes = static_cast<int>(node_ranks.size());
+  const int local_size = static_cast<int>(node_ranks.front().size());
+  for (const auto& ranks : node_ranks) {
+    if (static_cast<int>(ranks.size()) != local_size) {
+      LOG(WARNING) << "The nodes of the group " << gid_
+                   << " have different numbers of ranks, the allreduce is "
+                      "not hierarchical.";
+      return false;
+    }
+  }
+  if (num_nodes == 1 || local_size == 1) {
+    VLOG(3) << "The group " << gid_ << " has " << num_nodes << " nodes of "
+            << local_size << " ranks, the allreduce is not hierarchical.";
+    return false;
+  }
+
+  platform::CUDADeviceGuard cuda_guard(place);
+  const std::string prefix = "nccl_ids/" + std::to_string(gid_);
+  const std::string intra_key =
+      prefix + "/intra_node/" + std::to_string(node_index);
+  const std::string inter_key =
+      prefix + "/inter_node/" + std::to_string(local_rank);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_,
+      intra_key,
+      local_rank,
+      local_size,
+      /*hash_key=*/"",
+      /*opt=*/nullptr,
+      nccl_comm_init_option_);
+  phi::distributed::CommContextManager::CreateNCCLCommContext(
+      store_,
+      inter_key,
+      node_index,
+      num_nodes,
+      /*hash_key=*/"",
+      /*opt=*/nullptr,
+      nccl_comm_init_option_);
+  intra_node_comm_ = GetCommContext(&intra_key);
+  inter_node_comm_ = GetCommContext(&inter_key);
+  LOG(INFO) << "Hierarchical allreduce of the group " << gid_ << " over "
+            << num_nodes << " nodes of " << local_size << " ranks.";
+  return true;
+}
+
+void ProcessGroupNCCL::HierarchicalAllReduce(
+    phi::DenseTensor* out_tensor,
+    const phi::DenseTensor& in_tensor,
+    ncclRedOp_t reduce_type,
+    phi::distributed::NCCLCommContext* comm_context,
+    gpuStream_t stream) {
+  phi::distributed::CommStaticCheck::SameShape(*out_tensor,
+                                               in_tensor,
+                                               /*dst_rank*/ rank_,
+                                               /*cur_rank*/ rank_,
+                                               size_);
+  const int64_t numel = in_tensor.numel();
+  const int local_size = intra_node_comm_->GetSize();
+  const int local_rank = intra_node_comm_->GetRank();
+  const int64_t shard_numel = numel / local_size;
+  const auto dtype = phi::ToNCCLDataType(in_tensor.dtype());
+  const size_t elem_size = phi::SizeOf(in_tensor.dtype());
+  const auto* send = static_cast<const uint8_t*>(in_tensor.data());
+  auto* recv = static_cast<uint8_t*>(out_tensor->data());
+
+  // the shard of the rank is reduced in place in the output, as NCCL allows
+  // for a reduce-scatter into and an all-gather from the slot of the rank
+  if (shard_numel > 0) {
+    auto* shard = recv + local_rank * shard_numel * elem_size;
+    NCCL_CHECK(phi::dynload::ncclReduceScatter(send,
+                                               shard,
+                                               shard_numel,
+                                               dtype,
+                                               reduce_type,
+                                               intra_node_comm_->GetNcclComm(),
+                                               stream));
+    NCCL_CHECK(phi::dynload::ncclAllReduce(shard,
+                                           shard,
+                                           shard_numel,
+                                           dtype,
+                                           reduce_type,
+                                           inter_node_comm_->GetNcclComm(),
+                                           stream));
+    NCCL_CHECK(phi::dynload::ncclAllGather(shard,
+                                           recv,
+                                           shard_numel,
+                                           dtype,
+                                           intra_node_comm_->GetNcclComm(),
+                                           stream));
+  }
+  // the elements left over by the shards take the flat allreduce
+  const int64_t offset = shard_numel * local_size;
+  if (offset < numel) {
+    NCCL_CHECK(phi::dynload::ncclAllReduce(send + offset * elem_size,
+                                           recv + offset * elem_size,
+                                           numel - offset,
+                                           dtype,
+                                           reduce_type,
+                                           comm_context->GetNcclComm(),
+                                           stream));
+  }
+}
+
 std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
     std::function<void(phi::distributed::NCCLCommContext*, gpuStream_t)> fn,
     const phi::DenseTensor& tensor,
@@ -931,6 +1102,15 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
 
   auto nccl_comm_ctx = this->GetCommContext(&store_key);
 
+  // the collectives of a group are launched at its end, they aren't timed
+  auto& comm_stats = phi::distributed::CommStatsManager::GetInstance();
+  const bool sampled = !is_coalescing_ && s_group_call_counter == 0 &&
+                       comm_stats.ShouldSample();
+  phi::distributed::CommStatsManager::Sample sample;
+  if (sampled) {
+    sample = comm_stats.StartSample(place.GetDeviceId(), nccl_stream);
+  }
+
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream);
   } else {
@@ -958,6 +1138,14 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Collective(
     comm_task_manager.CommTaskEnqueue(std::move(comm_task));
   }
 
+  if (sampled) {
+    comm_stats.EndSample(sample,
+                         place_to_group_key_.at(key),
+                         comm_type,
+                         tensor.numel() * phi::SizeOf(tensor.dtype()),
+                         nccl_stream);
+  }
+
   if (!use_calc_stream) {
     if (!is_coalescing_) {
       if (FLAGS_use_stream_safe_cuda_allocator ||
@@ -1068,6 +1256,13 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
 
   auto nccl_comm_ctx = this->GetCommContext(&store_key);
 
+  auto& comm_stats = phi::distributed::CommStatsManager::GetInstance();
+  const bool sampled = !is_batch_p2p && comm_stats.ShouldSample();
+  phi::distributed::CommStatsManager::Sample sample;
+  if (sampled) {
+    sample = comm_stats.StartSample(place.GetDeviceId(), nccl_stream);
+  }
+
   if (!FLAGS_enable_async_trace) {
     fn(nccl_comm_ctx, nccl_stream, p2p_target_rank);
   } else {
@@ -1080,6 +1275,14 @@ std::shared_ptr<ProcessGroup::Task> ProcessGroupNCCL::Point2Point(
     comm_task_manager.CommTaskEnqueue(std::move(comm_task));
   }
 
+  if (sampled) {
+    comm_stats.EndSample(sample,
+                         place_to_group_key_.at(key),
+                         comm_type,
+                         tensor.numel() * phi::SizeOf(tensor.dtype()),
+                         nccl_stream);
+  }
+
   if (!use_calc_stream) {
     if (!is_coalescing_) {
       if (FLAGS_use_stream_safe_cuda_allocator ||
@@ -184,6 +184,15 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   phi::distributed::NCCLCommContext* GetOrCreateCommContext(
       const Place& place, CommType comm_type = CommType::UNKNOWN);
 
+  // Runs the allreduces of the group as a reduce-scatter within the node, an
+  // allreduce of the shards across the nodes and an all-gather within the
+  // node. Groups without the same number of ranks on every node, or on a
+  // single node, keep the flat allreduce.
+  void SetHierarchicalAllReduce(bool enable) {
+    hierarchical_allreduce_ = enable;
+  }
+  bool HierarchicalAllReduceEnabled() const { return hierarchical_allreduce_; }
+
  private:
   std::shared_ptr<ProcessGroupNCCL::NCCLTask> CreateTask(const Place& place,
                                                          int rank,
@@ -246,6 +255,16 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
 
   void EagerConnectRingExchange();
 
+  // Creates the communicators within and across the nodes on first use,
+  // returns false if the group can't use them.
+  bool InitHierarchicalComms(const Place& place);
+
+  void HierarchicalAllReduce(phi::DenseTensor* out_tensor,
+                             const phi::DenseTensor& in_tensor,
+                             ncclRedOp_t reduce_type,
+                             phi::distributed::NCCLCommContext* comm_context,
+                             gpuStream_t stream);
+
  private:
   std::shared_ptr<phi::distributed::Store> store_;
 
@@ -270,6 +289,13 @@ class ProcessGroupNCCL final : public ProcessGroupWithStream {
   std::vector<std::pair<std::weak_ptr<phi::Allocation>, gpuStream_t>>
       allocation_stream_pairs_;
 
+  // For hierarchical allreduce, the communicators are cached by
+  // CommContextManager
+  bool hierarchical_allreduce_{false};
+  bool hierarchical_comms_inited_{false};
+  phi::distributed::NCCLCommContext* intra_node_comm_{nullptr};
+  phi::distributed::NCCLCommContext* inter_node_comm_{nullptr};
+
   // For colaescing tensors processing (eg. batch_isend_irecv)
   bool is_coalescing_{false};
   std::vector<std::shared_ptr<phi::DenseTensor>> colaescing_tensors_;
@@ -18,6 +18,8 @@
 #include "paddle/phi/api/lib/data_transform.h"
 #include "paddle/phi/backends/device_guard.h"
 #include "paddle/phi/backends/device_manager.h"
+#include "paddle/phi/core/platform/profiler.h"
+#include "paddle/phi/core/tensor_utils.h"
 
 PD_DECLARE_bool(use_stream_safe_cuda_allocator);
 COMMON_DECLARE_string(allocator_strategy);
@@ -26,10 +28,16 @@ namespace paddle {
 namespace distributed {
 
 static bool IsStreamSafeAllocator() {
-  return (FLAGS_allocator_strategy == "auto_growth" &&
+  return ((FLAGS_allocator_strategy == "auto_growth" ||
+           FLAGS_allocator_strategy == "size_class") &&
           FLAGS_use_stream_safe_cuda_allocator);
 }
 
+static bool IsCompressibleType(phi::DataType dtype) {
+  return dtype == phi::DataType::FLOAT32 || dtype == phi::DataType::FLOAT64 ||
+         dtype == phi::DataType::FLOAT16 || dtype == phi::DataType::BFLOAT16;
+}
+
 static Backend TransToBackend(phi::Place place) {
   static const std::map<phi::AllocationType, Backend> type_backend = {
       {phi::AllocationType::GPU, Backend::GPU},
@@ -377,7 +385,27 @@ void SplitTensorsWithType<phi::XPUContext>(
 }
 #endif
 
+phi::DenseTensor EagerGroup::GradBufferSlice(size_t index) const {
+  const auto *buffer =
+      static_cast<const phi::DenseTensor *>(grad_buffer_.impl().get());
+  return buffer->Slice(offsets_[index], offsets_[index] + length_[index]);
+}
+
 void EagerGroup::ConcatTensors(const phi::Place &place) {
+  if (grad_buffer_.initialized()) {
+    const auto &holder =
+        static_cast<phi::DenseTensor *>(grad_buffer_.impl().get())->Holder();
+    bool in_buffer = std::all_of(
+        dense_tensors_.begin(),
+        dense_tensors_.end(),
+        [&holder](const phi::DenseTensor &t) { return t.Holder() == holder; });
+    if (in_buffer) {
+      // the grads are already in place
+      dense_contents_ = grad_buffer_;
+      return;
+    }
+  }
+
   dense_contents_ =
       paddle::experimental::empty(IntArray({all_length_}), dtype_, place);
 
@@ -427,6 +455,11 @@ void EagerGroup::ConcatTensors(const phi::Place &place) {
 }
 
 void EagerGroup::SplitTensors(const phi::DeviceContext &context) {
+  if (dense_contents_.initialized() &&
+      dense_contents_.impl() == grad_buffer_.impl()) {
+    // the grads are reduced in place
+    return;
+  }
   auto place = context.GetPlace();
   if (phi::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
@@ -536,6 +569,24 @@ EagerReducer::EagerReducer(
   }
 }
 
+void EagerReducer::SetGradCompressor(
+    std::shared_ptr<GradCompressor> grad_compressor) {
+  grad_compressor_ = std::move(grad_compressor);
+  VLOG(3) << "Gradient compression: "
+          << (grad_compressor_ ? grad_compressor_->name() : "none");
+}
+
+void EagerReducer::SetGradAsBucketView(bool grad_as_bucket_view) {
+  grad_as_bucket_view_ = grad_as_bucket_view;
+  if (!grad_as_bucket_view_) {
+    // the grads keep the buffers they are views of
+    for (auto &group : groups_) {
+      group.grad_buffer_.reset();
+    }
+  }
+  VLOG(3) << "Grad as bucket view: " << grad_as_bucket_view_;
+}
+
 std::shared_ptr<egr::GradNodeBase> EagerReducer::GetGradNodeFromTensor(
     Tensor *tensor) {
   auto *autograd_meta = tensor->get_autograd_meta();
@@ -619,6 +670,7 @@ void EagerReducer::InitializeDenseGroups(
         0,
         common::errors::PreconditionNotMet(
             "The number of tensor %s's elements is 0.", tensor_name));
+    p_group->offsets_.push_back(all_length);
     all_length += size;
 
     p_group->length_.push_back(size);
@@ -696,6 +748,9 @@ void EagerReducer::PrepareForBackward(const std::vector<Tensor> &outputs) {
   grad_need_hooks_ = true;
 
   next_group_ = 0;
+  num_vars_ready_ = 0;
+  overlapped_bytes_ = 0;
+  reduced_bytes_ = 0;
   std::for_each(groups_.begin(), groups_.end(), [](EagerGroup &group) {
     group.pending_ = group.tensor_indices_.size();
     group.sparse_contents_ = Tensor();
@@ -835,6 +890,13 @@ void EagerReducer::MarkVarReady(const size_t var_index,
     vars_marked_ready_[var_index] = true;
   }
   groups_need_finalize_ = true;
+  ++num_vars_ready_;
+
+  // rebuild group when find_unused_vars_each_step_ is false
+  if (NeedRebuildGroup()) {
+    rebuild_vars_.push_back(tensors_[var_index]);
+    rebuild_var_indices_.push_back(static_cast<int64_t>(var_index));
+  }
 
   const auto &var_locator = variable_locators_[var_index];
   const auto group_index = var_locator.group_index;
@@ -842,7 +904,11 @@ void EagerReducer::MarkVarReady(const size_t var_index,
 
   auto &group = groups_[group_index];
 
-  if (!group.is_sparse_) {
+  if (!group.is_sparse_ && grad_as_bucket_view_ &&
+      MarkDenseVarReadyInBuffer(var_index)) {
+    VLOG(3) << "Tensor[" << tensors_[var_index].name()
+            << "] is ready in the group buffer";
+  } else if (!group.is_sparse_) {
     auto &group_tensor = group.dense_tensors_[inside_group_index];
     const auto length = group.length_[inside_group_index];
     if (is_used_var) {
@@ -952,6 +1018,53 @@ void EagerReducer::MarkVarReady(const size_t var_index,
   }
 }
 
+bool EagerReducer::MarkDenseVarReadyInBuffer(size_t var_index) {
+  const auto &var_locator = variable_locators_[var_index];
+  const auto inside_group_index = var_locator.inside_group_index;
+  auto &group = groups_[var_locator.group_index];
+  auto *dev_ctx = phi::DeviceContextPool::Instance().Get(inner_place_);
+
+  std::shared_ptr<phi::DenseTensor> grad_dense_tensor;
+  Tensor *grad_tensor = nullptr;
+  if (HasGrad(var_index)) {
+    grad_tensor = egr::EagerUtils::mutable_grad(tensors_[var_index]);
+    grad_dense_tensor =
+        std::dynamic_pointer_cast<phi::DenseTensor>(grad_tensor->impl());
+    if (!grad_dense_tensor || grad_dense_tensor->dtype() != group.dtype_) {
+      return false;
+    }
+  }
+
+  if (!group.grad_buffer_.initialized()) {
+    group.grad_buffer_ = paddle::experimental::empty(
+        IntArray({group.all_length_}), group.dtype_, inner_place_);
+  }
+  auto &group_tensor = group.dense_tensors_[inside_group_index];
+  group_tensor = group.GradBufferSlice(inside_group_index);
+
+  if (!grad_dense_tensor) {
+    VLOG(3) << "Tensor[" << tensors_[var_index].name()
+            << "] doesn't have grad";
+    phi::funcs::set_constant(*dev_ctx, &group_tensor, 0.0f);
+    return true;
+  }
+  if (grad_dense_tensor->Holder() == group_tensor.Holder() &&
+      grad_dense_tensor->meta().offset == group_tensor.meta().offset) {
+    return true;
+  }
+
+  // the first step or the grad was replaced, e.g. by clear_grad
+  phi::Copy(*dev_ctx, *grad_dense_tensor, inner_place_, false, &group_tensor);
+  group_tensor.Resize({group.length_[inside_group_index]});
+  auto grad_view = std::make_shared<phi::DenseTensor>(group_tensor);
+  grad_view->Resize(grad_dense_tensor->dims());
+  grad_tensor->set_impl(grad_view);
+  std::static_pointer_cast<egr::GradNodeAccumulation>(
+      GetGradNodeFromTensor(&tensors_[var_index]))
+      ->SetKeepGradBuffer(true);
+  return true;
+}
+
 void EagerReducer::MarkGroupReady(size_t group_index) {
   VLOG(3) << "Group[" << group_index << "] is ready";
 
@@ -970,9 +1083,16 @@ void EagerReducer::MarkGroupReady(size_t group_index) {
     return;
   }
 
+  // the groups scheduled after the last var are exposed communication
+  const bool overlapped = num_vars_ready_ < tensors_.size();
   for (; next_group_ < groups_.size() && groups_[next_group_].pending_ == 0;
        ++next_group_) {
     UNUSED auto &group = groups_[next_group_];
+    if (!group.is_sparse_) {
+      const int64_t bytes = group.all_length_ * phi::SizeOf(group.dtype_);
+      reduced_bytes_ += bytes;
+      if (overlapped) overlapped_bytes_ += bytes;
+    }
     if (group.is_sparse_) {
       AllReduceSparse(&group, static_cast<int>(next_group_));
     } else {
@@ -1065,6 +1185,19 @@ void EagerReducer::ProcessUnusedDenseVars() {
 void EagerReducer::FinalizeBackward() {
   groups_need_finalize_ = false;
   grad_need_hooks_ = false;
+  overlap_ratio_ = reduced_bytes_ > 0 ? static_cast<double>(overlapped_bytes_) /
+                                            static_cast<double>(reduced_bytes_)
+                                      : 1.0;
+  VLOG(3) << "Overlapped " << overlapped_bytes_ << " of " << reduced_bytes_
+          << " gradient bytes with the backward.";
+  // spans the exposed communication of the step
+  phi::RecordEvent record_event(
+      "EagerReducer::FinalizeBackward",
+      "overlap_ratio=" + std::to_string(overlap_ratio_) +
+          ",overlapped_bytes=" + std::to_string(overlapped_bytes_) +
+          ",reduced_bytes=" + std::to_string(reduced_bytes_),
+      phi::TracerEventType::Communication,
+      1);
   for (auto &group : groups_) {
     if (!group.is_sparse_) {
       group.task->Synchronize();
@@ -1076,6 +1209,15 @@ void EagerReducer::FinalizeBackward() {
     }
   }
 
+  if (NeedRebuildGroup()) {
+    VLOG(3) << "Start rebuilding the groups";
+    auto rebuild_group_indices = RebuildGroups();
+    group_indices_ = std::move(rebuild_group_indices);
+    InitializeGroups(group_indices_);
+    // the residuals are kept by the old group indices
+    if (grad_compressor_) grad_compressor_->Reset();
+  }
+
   if (find_unused_vars_each_step_) {
     ProcessUnusedDenseVars();
     local_used_vars_.clear();
@@ -1086,6 +1228,49 @@ void EagerReducer::FinalizeBackward() {
   VLOG(3) << "In the batch, Reducer is finished.";
 }
 
+std::vector<std::vector<size_t>> EagerReducer::RebuildGroups() {
+  VLOG(3) << "The order of parameter arrival: "
+          << string::join_strings(rebuild_var_indices_, ',');
+
+  PADDLE_ENFORCE_EQ(
+      rebuild_vars_.size(),
+      tensors_.size(),
+      common::errors::PreconditionNotMet(
+          "Rebuild vars's number should be equal to original vars'number, "
+          "expect it to be %d, but got %d.",
+          tensors_.size(),
+          rebuild_vars_.size()));
+
+  // the ranks may see different orders, all of them follow rank 0 so that
+  // the groups match
+  const auto *dev_ctx = phi::DeviceContextPool::Instance().Get(inner_place_);
+  phi::DenseTensor order_tensor;
+  framework::TensorFromVector<int64_t>(
+      rebuild_var_indices_, *dev_ctx, &order_tensor);
+  distributed::BroadcastOptions opts;
+  opts.source_rank = 0;
+  std::vector<phi::DenseTensor> in_out = {order_tensor};
+  process_group_->Broadcast(in_out, in_out, opts)->Synchronize();
+  framework::TensorToVector<int64_t>(
+      in_out.front(), *dev_ctx, &rebuild_var_indices_);
+  dev_ctx->Wait();
+  for (size_t i = 0; i < rebuild_var_indices_.size(); ++i) {
+    rebuild_vars_[i] = tensors_[rebuild_var_indices_[i]];
+  }
+
+  std::reverse(rebuild_vars_.begin(), rebuild_vars_.end());
+  std::reverse(rebuild_var_indices_.begin(), rebuild_var_indices_.end());
+  auto rebuild_group_indices = Eager_AssignGroupBySize(rebuild_vars_,
+                                                       is_sparse_gradient_,
+                                                       group_size_limits_,
+                                                       rebuild_var_indices_);
+  has_rebuilt_group_ = true;
+  rebuild_vars_.clear();
+  rebuild_var_indices_.clear();
+  std::reverse(rebuild_group_indices.begin(), rebuild_group_indices.end());
+  return rebuild_group_indices;
+}
+
 void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
                                           const int curr_group_index) {
   // The overall timeline: concat > div_nranks > allreduce > split
@@ -1101,6 +1286,22 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
   paddle::experimental::scale_(
       group->dense_contents_, 1.0 / nranks_, 0.0, false);  // NOLINT
 
+  if (grad_compressor_ && IsCompressibleType(group->dtype_)) {
+    const int64_t bytes_sent = grad_compressor_->bytes_sent();
+    group->dense_contents_ =
+        grad_compressor_->AllReduce(group->dense_contents_,
+                                    curr_group_index,
+                                    process_group_.get(),
+                                    &group->task);
+    comm_bytes_ += grad_compressor_->bytes_sent() - bytes_sent;
+    if (IsStreamSafeAllocator()) {
+      // the decompressed contents are written by the calculation stream
+      auto *default_ctx = phi::DeviceContextPool::Instance().Get(inner_place_);
+      group->SplitTensors(*default_ctx);
+    }
+    return;
+  }
+
   // all_reduce
   std::vector<Tensor> reduce_tensors = {group->dense_contents_};
   std::vector<phi::DenseTensor> in_out;
@@ -1109,6 +1310,7 @@ void EagerReducer::FusedAllReduceSchedule(EagerGroup *group,
     in_out.push_back(*std::dynamic_pointer_cast<phi::DenseTensor>(t.impl()));
   }
   group->task = process_group_->AllReduce(in_out, in_out, opts);
+  comm_bytes_ += group->all_length_ * phi::SizeOf(group->dtype_);
 
   auto *context = process_group_->GetDeviceContext(inner_place_);
 
@@ -17,6 +17,7 @@
 #include <map>
 #include <vector>
 
+#include "paddle/fluid/distributed/collective/grad_compressor.h"
 #include "paddle/fluid/distributed/collective/process_group.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/utils/hook_utils.h"
@@ -53,6 +54,7 @@ class EagerGroup {
   // for concat kernel
   std::vector<phi::DenseTensor> dense_tensors_;
   std::vector<int64_t> length_;
+  std::vector<int64_t> offsets_;
   int64_t all_length_{0};
   std::vector<IntArray> origin_shapes_;
 
@@ -69,6 +71,13 @@ class EagerGroup {
   // help to sync
   std::shared_ptr<ProcessGroup::Task> task;
 
+  // the fused buffer whose slices are the grads of the group, see
+  // EagerReducer::SetGradAsBucketView
+  Tensor grad_buffer_;
+
+  // the slice of grad_buffer_ for the index-th tensor of the group
+  phi::DenseTensor GradBufferSlice(size_t index) const;
+
   // context is used to select the stream for concat
   void ConcatTensors(const phi::Place &);
 
@@ -112,8 +121,35 @@ class EagerReducer {
   void TraverseBackwardGraph(const std::vector<Tensor> &outputs);
   void ProcessUnusedDenseVars();
   bool HasGrad(size_t var_index);
+  std::vector<std::vector<size_t>> RebuildGroups();
+
+  // The share of the gradient bytes of the last step whose allreduce started
+  // before the last gradient was ready, i.e. overlapped with the backward.
+  double overlap_ratio() const { return overlap_ratio_; }
+
+  // Compresses the dense groups of floating point gradients before they are
+  // reduced, nullptr restores the full precision allreduce.
+  void SetGradCompressor(std::shared_ptr<GradCompressor> grad_compressor);
+
+  // Bytes of dense gradients this rank has put into the collectives.
+  int64_t comm_bytes() const { return comm_bytes_; }
+
+  // Makes the dense grads views of the fused buffers of their groups, so
+  // that the grads are accumulated right into the buffers that are reduced
+  // and the groups need no concat and split.
+  void SetGradAsBucketView(bool grad_as_bucket_view);
 
  private:
+  // rebuild the groups in the gradient ready order of the first step, the
+  // order can't change between steps when there may be unused vars
+  inline bool NeedRebuildGroup() {
+    return !has_rebuilt_group_ && !find_unused_vars_each_step_;
+  }
+
+  // Points the slot of the var in its group at the fused buffer and moves
+  // the grad of the var there, returns false if the grad can't be moved.
+  bool MarkDenseVarReadyInBuffer(size_t var_index);
+
   std::vector<Tensor> tensors_;
   std::vector<std::vector<size_t>> group_indices_;
   std::vector<bool> is_sparse_gradient_;
@@ -139,6 +175,22 @@ class EagerReducer {
   bool find_unused_vars_once_{true};
   bool groups_need_finalize_{false};
   Tensor global_used_vars_;
+
+  // Following variables are to rebuild the groups
+  bool has_rebuilt_group_{false};
+  std::vector<Tensor> rebuild_vars_;
+  std::vector<int64_t> rebuild_var_indices_;
+
+  // Following variables are to measure the overlap of each step
+  size_t num_vars_ready_{0};
+  int64_t overlapped_bytes_{0};
+  int64_t reduced_bytes_{0};
+  double overlap_ratio_{0.0};
+
+  std::shared_ptr<GradCompressor> grad_compressor_;
+  int64_t comm_bytes_{0};
+
+  bool grad_as_bucket_view_{false};
 };
 
 }  //  namespace distributed
@@ -0,0 +1,210 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <cstring>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Count-min sketch estimating how often a key was seen recently. All the
+// counters are halved every `decay_interval` additions so that the estimate
+// follows the recent traffic. Counters are updated without locks, the
+// estimate is approximate anyway.
+class CountMinSketch {
+ public:
+  CountMinSketch(size_t width, size_t depth, uint64_t decay_interval)
+      : _width(width > 0 ? width : 1),
+        _depth(depth > 0 ? depth : 1),
+        _decay_interval(decay_interval > 0 ? decay_interval : 1),
+        _counters(_width * _depth) {
+    for (auto &counter : _counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t add(uint64_t key) {
+    uint32_t estimate = UINT32_MAX;
+    for (size_t row = 0; row < _depth; ++row) {
+      auto &counter = _counters[index(row, key)];
+      uint32_t value = counter.fetch_add(1, std::memory_order_relaxed) + 1;
+      estimate = value < estimate ? value : estimate;
+    }
+    if (_additions.fetch_add(1, std::memory_order_relaxed) % _decay_interval ==
+        _decay_interval - 1) {
+      for (auto &counter : _counters) {
+        counter.store(counter.load(std::memory_order_relaxed) / 2,
+                      std::memory_order_relaxed);
+      }
+    }
+    return estimate;
+  }
+
+  uint32_t estimate(uint64_t key) const {
+    uint32_t estimate = UINT32_MAX;
+    for (size_t row = 0; row < _depth; ++row) {
+      uint32_t value =
+          _counters[index(row, key)].load(std::memory_order_relaxed);
+      estimate = value < estimate ? value : estimate;
+    }
+    return estimate;
+  }
+
+ private:
+  size_t index(size_t row, uint64_t key) const {
+    // splitmix64 with a different seed for each row
+    uint64_t x = key + 0x9e3779b97f4a7c15ULL * (row + 1);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x = x ^ (x >> 31);
+    return row * _width + x % _width;
+  }
+
+  size_t _width;
+  size_t _depth;
+  uint64_t _decay_interval;
+  std::vector<std::atomic<uint32_t>> _counters;
+  std::atomic<uint64_t> _additions{0};
+};
+
+// Client side cache of the pulled values of hot sparse keys. A key is cached
+// once the sketch estimates it was pulled at least `admit_threshold` times
+// recently, and a cached value is served for at most `staleness_ms`.
+// Every local push bumps the version of the cache and drops the pushed keys,
+// values pulled before a push are not admitted after it.
+class HotKeyCache {
+ public:
+  HotKeyCache(size_t value_bytes,
+              size_t capacity,
+              uint32_t staleness_ms,
+              uint32_t admit_threshold)
+      : _value_bytes(value_bytes),
+        _shard_capacity(capacity / kShardNum > 0 ? capacity / kShardNum : 1),
+        _staleness_ms(staleness_ms),
+        _admit_threshold(admit_threshold),
+        _sketch(capacity, 4, capacity * 16) {}
+  ~HotKeyCache() {}
+
+  // Count a pull of key and copy the cached value to value on hit.
+  bool lookup(uint64_t key, void *value) {
+    _sketch.add(key);
+    auto &shard = _shards[shard_of(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto itr = shard.entries.find(key);
+    if (itr == shard.entries.end()) {
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    if (itr->second.expire_ms <= now_ms()) {
+      shard.entries.erase(itr);
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    memcpy(value, itr->second.value.data(), _value_bytes);
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  uint64_t version() const { return _version.load(std::memory_order_acquire); }
+
+  // Cache the value of key pulled at `pull_version` if key is hot.
+  void insert(uint64_t key, const void *value, uint64_t pull_version) {
+    if (_sketch.estimate(key) < _admit_threshold) {
+      return;
+    }
+    auto &shard = _shards[shard_of(key)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (pull_version != version()) {
+      return;
+    }
+    int64_t now = now_ms();
+    if (shard.entries.size() >= _shard_capacity &&
+        shard.entries.find(key) == shard.entries.end()) {
+      for (auto itr = shard.entries.begin(); itr != shard.entries.end();) {
+        if (itr->second.expire_ms <= now) {
+          itr = shard.entries.erase(itr);
+        } else {
+          ++itr;
+        }
+      }
+      if (shard.entries.size() >= _shard_capacity) {
+        return;
+      }
+    }
+    auto &entry = shard.entries[key];
+    entry.value.resize(_value_bytes);
+    memcpy(entry.value.data(), value, _value_bytes);
+    entry.expire_ms = now + _staleness_ms;
+  }
+
+  void invalidate(const uint64_t *keys, size_t num) {
+    _version.fetch_add(1, std::memory_order_acq_rel);
+    for (size_t i = 0; i < num; ++i) {
+      auto &shard = _shards[shard_of(keys[i])];
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.entries.erase(keys[i]);
+    }
+  }
+
+  size_t size() {
+    size_t total = 0;
+    for (auto &shard : _shards) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      total += shard.entries.size();
+    }
+    return total;
+  }
+  uint64_t hits() const { return _hits.load(std::memory_order_relaxed); }
+  uint64_t misses() const { return _misses.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr size_t kShardNum = 64;
+
+  struct Entry {
+    std::vector<char> value;
+    int64_t expire_ms;
+  };
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, Entry> entries;
+  };
+
+  static size_t shard_of(uint64_t key) {
+    return (key * 0x9e3779b97f4a7c15ULL) >> 58;
+  }
+  static int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  size_t _value_bytes;
+  size_t _shard_capacity;
+  uint32_t _staleness_ms;
+  uint32_t _admit_threshold;
+  CountMinSketch _sketch;
+  Shard _shards[kShardNum];
+  std::atomic<uint64_t> _version{0};
+  std::atomic<uint64_t> _hits{0};
+  std::atomic<uint64_t> _misses{0};
+};
+
+}  // namespace distributed
+}  // namespace paddle
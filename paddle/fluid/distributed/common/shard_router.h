@@ -0,0 +1,94 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace distributed {
+
+// Jump consistent hash of Lamping and Veach. Growing bucket_num by one moves
+// 1/bucket_num of the keys, all of them into the new bucket, and shrinking it
+// by one only moves the keys of the last bucket.
+inline uint32_t JumpConsistentHash(uint64_t key, uint32_t bucket_num) {
+  int64_t bucket = -1;
+  int64_t next = 0;
+  while (next < static_cast<int64_t>(bucket_num)) {
+    bucket = next;
+    key = key * 2862933555777941757ULL + 1;
+    next = static_cast<int64_t>(
+        static_cast<double>(bucket + 1) *
+        (static_cast<double>(1LL << 31) /
+         static_cast<double>((key >> 33) + 1)));
+  }
+  return static_cast<uint32_t>(bucket);
+}
+
+// Owner pserver of every global shard of a sparse table whose shards are
+// placed by consistent hashing. Routing reads a snapshot of the owners, moves
+// copy it, so lookups on the pull and push paths never wait on a rebalance.
+// Each shard keeps the version of its last move and older moves are ignored.
+class SparseShardRouter {
+ public:
+  SparseShardRouter(uint32_t shard_num, uint32_t server_num)
+      : _owners(std::make_shared<const std::vector<uint32_t>>(
+            ConsistentOwners(shard_num, server_num))),
+        _versions(shard_num, 0) {}
+
+  static std::vector<uint32_t> ConsistentOwners(uint32_t shard_num,
+                                                uint32_t server_num) {
+    std::vector<uint32_t> owners(shard_num);
+    for (uint32_t shard_id = 0; shard_id < shard_num; ++shard_id) {
+      owners[shard_id] =
+          JumpConsistentHash(shard_id, server_num > 0 ? server_num : 1);
+    }
+    return owners;
+  }
+
+  std::shared_ptr<const std::vector<uint32_t>> owners() const {
+    return std::atomic_load(&_owners);
+  }
+
+  uint32_t owner(uint32_t shard_id) const { return (*owners())[shard_id]; }
+
+  uint64_t version(uint32_t shard_id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _versions[shard_id];
+  }
+
+  // returns false when the shard already moved with a newer version
+  bool set_owner(uint32_t shard_id, uint32_t server, uint64_t version) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (shard_id >= _versions.size() || version <= _versions[shard_id]) {
+      return false;
+    }
+    auto owners = std::make_shared<std::vector<uint32_t>>(*_owners);
+    (*owners)[shard_id] = server;
+    _versions[shard_id] = version;
+    std::atomic_store(&_owners,
+                      std::shared_ptr<const std::vector<uint32_t>>(owners));
+    return true;
+  }
+
+ private:
+  mutable std::mutex _mutex;
+  std::shared_ptr<const std::vector<uint32_t>> _owners;
+  std::vector<uint64_t> _versions;
+};
+
+}  // namespace distributed
+}  // namespace paddle
@@ -14,7 +14,12 @@
 
 #include "paddle/fluid/distributed/fleet_executor/runtime_graph.h"
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
+#include "paddle/phi/core/enforce.h"
 
 namespace paddle::distributed {
 
@@ -28,4 +33,254 @@ std::string RuntimeGraph::DebugString() const {
   return os.str();
 }
 
+namespace {
+
+using JobType = PipelineJob::Type;
+
+// Megatron's order of the jobs of the chunks: num_stages micro batches on
+// the first chunk, then the same ones on the next chunk, and so on, with
+// the backward going through the chunks in reverse.
+std::vector<PipelineJob> Interleaved1F1BJobs(int64_t stage,
+                                             int64_t num_stages,
+                                             int64_t num_micro_batches,
+                                             int64_t num_chunks) {
+  const int64_t total = num_micro_batches * num_chunks;
+  const int64_t group_size = num_stages * num_chunks;
+  auto job = [&](JobType type, int64_t k) {
+    int64_t chunk = (k % group_size) / num_stages;
+    if (type == JobType::kBackward) {
+      chunk = num_chunks - 1 - chunk;
+    }
+    return PipelineJob{
+        type, k / group_size * num_stages + k % num_stages, chunk};
+  };
+
+  int64_t num_warmup = num_chunks == 1 ? num_stages - stage - 1
+                                       : (num_stages - stage - 1) * 2 +
+                                             (num_chunks - 1) * num_stages;
+  num_warmup = std::min(num_warmup, total);
+
+  std::vector<PipelineJob> jobs;
+  for (int64_t k = 0; k < num_warmup; ++k) {
+    jobs.push_back(job(JobType::kForward, k));
+  }
+  for (int64_t k = 0; k < total - num_warmup; ++k) {
+    jobs.push_back(job(JobType::kForward, num_warmup + k));
+    jobs.push_back(job(JobType::kBackward, k));
+  }
+  for (int64_t k = total - num_warmup; k < total; ++k) {
+    jobs.push_back(job(JobType::kBackward, k));
+  }
+  return jobs;
+}
+
+// ZB-H1, the same order as the zero bubble pass of the static pipeline: the
+// weight gradients of the first micro batches of a stage are delayed to its
+// cooldown, where the later stages would otherwise wait.
+std::vector<PipelineJob> ZeroBubbleJobs(int64_t stage,
+                                        int64_t num_stages,
+                                        int64_t num_micro_batches) {
+  const int64_t num_warmup = num_stages - stage;
+  std::vector<PipelineJob> jobs;
+  int64_t forward_id = 0;
+  int64_t backward_id = 0;
+  for (int64_t i = 0; i < num_warmup; ++i) {
+    jobs.push_back({JobType::kForward, forward_id++});
+  }
+  for (int64_t i = 0; i < stage; ++i) {
+    jobs.push_back({JobType::kBackwardInput, backward_id++});
+    jobs.push_back({JobType::kForward, forward_id++});
+  }
+  for (int64_t i = 0; i < num_micro_batches - num_stages; ++i) {
+    jobs.push_back({JobType::kBackward, backward_id++});
+    jobs.push_back({JobType::kForward, forward_id++});
+  }
+  for (int64_t i = 0; i < num_warmup - 1; ++i) {
+    jobs.push_back({JobType::kBackward, backward_id++});
+  }
+  if (stage > 0) {
+    jobs.push_back({JobType::kBackwardInput, backward_id});
+    jobs.push_back({JobType::kBackwardWeight, backward_id});
+  } else {
+    jobs.push_back({JobType::kBackward, backward_id});
+  }
+  for (int64_t i = 0; i < stage; ++i) {
+    jobs.push_back({JobType::kBackwardWeight, i});
+  }
+  return jobs;
+}
+
+}  // namespace
+
+PipelineSchedule GeneratePipelineSchedule(PipelineScheduleType type,
+                                          int64_t num_stages,
+                                          int64_t num_micro_batches,
+                                          int64_t num_chunks) {
+  PADDLE_ENFORCE_GT(num_stages,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of stages should be positive, but got %d.",
+                        num_stages));
+  PADDLE_ENFORCE_GT(
+      num_micro_batches,
+      0,
+      common::errors::InvalidArgument(
+          "The number of micro batches should be positive, but got %d.",
+          num_micro_batches));
+  PADDLE_ENFORCE_EQ(
+      num_chunks == 1 || type == PipelineScheduleType::kInterleaved1F1B,
+      true,
+      common::errors::InvalidArgument(
+          "Only the interleaved 1F1B schedule has more than one chunk, but "
+          "got %d chunks.",
+          num_chunks));
+  PADDLE_ENFORCE_GT(
+      num_chunks,
+      0,
+      common::errors::InvalidArgument(
+          "The number of chunks should be positive, but got %d.", num_chunks));
+
+  PipelineSchedule schedule;
+  for (int64_t stage = 0; stage < num_stages; ++stage) {
+    switch (type) {
+      case PipelineScheduleType::k1F1B:
+        schedule.push_back(
+            Interleaved1F1BJobs(stage, num_stages, num_micro_batches, 1));
+        break;
+      case PipelineScheduleType::kInterleaved1F1B:
+        PADDLE_ENFORCE_EQ(
+            num_chunks == 1 || num_micro_batches % num_stages == 0,
+            true,
+            common::errors::InvalidArgument(
+                "The number of micro batches (%d) should be a multiple of "
+                "the number of stages (%d) for the interleaved 1F1B "
+                "schedule.",
+                num_micro_batches,
+                num_stages));
+        schedule.push_back(Interleaved1F1BJobs(
+            stage, num_stages, num_micro_batches, num_chunks));
+        break;
+      case PipelineScheduleType::kZeroBubble:
+        PADDLE_ENFORCE_LE(
+            num_stages,
+            num_micro_batches,
+            common::errors::InvalidArgument(
+                "The number of micro batches (%d) should be at least the "
+                "number of stages (%d) for the zero bubble schedule.",
+                num_micro_batches,
+                num_stages));
+        schedule.push_back(
+            ZeroBubbleJobs(stage, num_stages, num_micro_batches));
+        break;
+    }
+  }
+  return schedule;
+}
+
+PipelineSimulation SimulatePipelineSchedule(const PipelineSchedule& schedule,
+                                            const PipelineCost& cost) {
+  const int64_t num_stages = static_cast<int64_t>(schedule.size());
+  int64_t num_chunks = 1;
+  size_t remaining = 0;
+  for (const auto& jobs : schedule) {
+    for (const auto& job : jobs) {
+      num_chunks = std::max(num_chunks, job.chunk + 1);
+    }
+    remaining += jobs.size();
+  }
+  const int64_t num_virtual_stages = num_stages * num_chunks;
+
+  // (0 the forward, 1 the input gradients, 2 the weight gradients, virtual
+  // stage, micro batch) -> the time it's done
+  std::map<std::tuple<int, int64_t, int64_t>, double> done_times;
+  auto wait_for = [&](int kind, int64_t vs, int64_t micro_batch, double* t) {
+    auto iter = done_times.find(std::make_tuple(kind, vs, micro_batch));
+    if (iter == done_times.end()) {
+      return false;
+    }
+    *t = std::max(*t, iter->second);
+    return true;
+  };
+
+  std::vector<size_t> next_job(num_stages, 0);
+  std::vector<double> free_time(num_stages, 0.0);
+  double busy_time = 0.0;
+  bool progress = true;
+  while (remaining > 0 && progress) {
+    progress = false;
+    for (int64_t stage = 0; stage < num_stages; ++stage) {
+      while (next_job[stage] < schedule[stage].size()) {
+        const auto& job = schedule[stage][next_job[stage]];
+        const int64_t vs = job.chunk * num_stages + stage;
+        double start = free_time[stage];
+        double p2p_done = 0.0;
+        bool ready = true;
+        double duration = 0.0;
+        switch (job.type) {
+          case JobType::kForward:
+            if (vs > 0) {
+              ready = wait_for(0, vs - 1, job.micro_batch, &p2p_done);
+              start = std::max(start, p2p_done + cost.p2p);
+            }
+            duration = cost.forward;
+            break;
+          case JobType::kBackward:
+          case JobType::kBackwardInput:
+            ready = wait_for(0, vs, job.micro_batch, &start);
+            if (ready && vs + 1 < num_virtual_stages) {
+              ready = wait_for(1, vs + 1, job.micro_batch, &p2p_done);
+              start = std::max(start, p2p_done + cost.p2p);
+            }
+            duration = cost.backward_input;
+            if (job.type == JobType::kBackward) {
+              duration += cost.backward_weight;
+            }
+            break;
+          case JobType::kBackwardWeight:
+            ready = wait_for(1, vs, job.micro_batch, &start);
+            duration = cost.backward_weight;
+            break;
+        }
+        if (!ready) {
+          break;
+        }
+
+        const double end = start + duration / num_chunks;
+        if (job.type == JobType::kForward) {
+          done_times[std::make_tuple(0, vs, job.micro_batch)] = end;
+        }
+        if (job.type == JobType::kBackward ||
+            job.type == JobType::kBackwardInput) {
+          done_times[std::make_tuple(1, vs, job.micro_batch)] = end;
+        }
+        if (job.type == JobType::kBackward ||
+            job.type == JobType::kBackwardWeight) {
+          done_times[std::make_tuple(2, vs, job.micro_batch)] = end;
+        }
+        busy_time += duration / num_chunks;
+        free_time[stage] = end;
+        ++next_job[stage];
+        --remaining;
+        progress = true;
+      }
+    }
+  }
+  PADDLE_ENFORCE_EQ(remaining,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The pipeline schedule deadlocks with %d jobs that "
+                        "can't run.",
+                        remaining));
+
+  PipelineSimulation simulation;
+  for (double t : free_time) {
+    simulation.makespan = std::max(simulation.makespan, t);
+  }
+  if (simulation.makespan > 0.0) {
+    simulation.bubble_ratio =
+        1.0 - busy_time / (num_stages * simulation.makespan);
+  }
+  return simulation;
+}
+
 }  // namespace paddle::distributed
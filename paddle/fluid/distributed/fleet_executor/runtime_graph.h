@@ -52,5 +52,50 @@ class RuntimeGraph final {
   std::unordered_map<int64_t, int64_t> interceptor_id_to_rank_;
 };
 
+// A job of a pipeline stage on a micro batch and a virtual stage (chunk) of
+// the stage. Zero bubble splits the backward into the gradients of the
+// inputs (kBackwardInput), which the previous stage waits for, and the ones
+// of the weights (kBackwardWeight), which fill the bubbles.
+struct PipelineJob {
+  enum class Type { kForward, kBackward, kBackwardInput, kBackwardWeight };
+
+  Type type;
+  int64_t micro_batch;
+  int64_t chunk = 0;
+};
+
+enum class PipelineScheduleType { k1F1B, kInterleaved1F1B, kZeroBubble };
+
+// the jobs of each stage in the order they run
+using PipelineSchedule = std::vector<std::vector<PipelineJob>>;
+
+// Interleaved 1F1B places the chunk c of the stage s at the virtual stage
+// c * num_stages + s, it needs num_micro_batches to be a multiple of
+// num_stages. 1F1B and zero bubble (ZB-H1) have a single chunk.
+PipelineSchedule GeneratePipelineSchedule(PipelineScheduleType type,
+                                          int64_t num_stages,
+                                          int64_t num_micro_batches,
+                                          int64_t num_chunks = 1);
+
+// The time of the jobs of a whole stage, a chunk takes 1 / num_chunks of it.
+struct PipelineCost {
+  double forward = 1.0;
+  double backward_input = 1.0;
+  double backward_weight = 1.0;
+  // of the send of the activations or the gradients to the next stage
+  double p2p = 0.0;
+};
+
+struct PipelineSimulation {
+  double makespan = 0.0;
+  // the idle time of all the stages over num_stages * makespan
+  double bubble_ratio = 0.0;
+};
+
+// Runs the jobs of each stage in order as soon as the jobs they depend on
+// are done, throws if the schedule deadlocks.
+PipelineSimulation SimulatePipelineSchedule(const PipelineSchedule& schedule,
+                                            const PipelineCost& cost);
+
 }  // namespace distributed
 }  // namespace paddle
@@ -14,6 +14,9 @@
 
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "paddle/fluid/framework/data_feed.h"
 
 namespace paddle::distributed {
@@ -71,6 +74,118 @@ std::vector<std::vector<uint64_t>> LayerWiseSampler::sample(
   }
   return outputs;
 }
+
+void LayerWiseSampler::sample_batch(const uint64_t* user_inputs,
+                                    const uint64_t* target_ids,
+                                    size_t input_num,
+                                    size_t user_feature_num,
+                                    bool with_hierarchy,
+                                    bool share_negatives,
+                                    int num_threads,
+                                    uint64_t* outputs) {
+  PADDLE_ENFORCE_GT(
+      num_threads,
+      0,
+      common::errors::InvalidArgument(
+          "num_threads should be greater than 0, but received %d.",
+          num_threads));
+  if (input_num == 0) {
+    return;
+  }
+  size_t num_layers = layer_counts_.size();
+  size_t feature_num = user_feature_num;
+  size_t cols = user_feature_num + 2;
+
+  // look the tree up for the whole batch before sampling
+  std::vector<uint64_t> travel_ids(input_num * num_layers);
+  tree_->GetTravelIds(
+      target_ids, input_num, start_sample_layer_, travel_ids.data());
+  std::vector<uint64_t> ancestor_ids;
+  if (with_hierarchy) {
+    auto max_layer = tree_->Height();
+    size_t batch_features = input_num * feature_num;
+    ancestor_ids.resize(num_layers * batch_features);
+    for (size_t j = 1; j < num_layers; j++) {
+      tree_->GetAncestorIds(user_inputs,
+                            batch_features,
+                            max_layer - static_cast<int>(j) - 1,
+                            ancestor_ids.data() + j * batch_features);
+    }
+  }
+
+  num_threads = static_cast<int>(
+      std::min(static_cast<size_t>(num_threads), input_num));
+  while (thread_samplers_.size() < static_cast<size_t>(num_threads)) {
+    // a fixed seed still gives each thread its own sequence
+    unsigned int seed =
+        seed_ == 0 ? 0 : seed_ + static_cast<int>(thread_samplers_.size()) + 1;
+    std::vector<std::shared_ptr<phi::math::Sampler>> samplers;
+    for (auto& ids : layer_ids_) {
+      samplers.push_back(
+          std::make_shared<phi::math::UniformSampler>(ids.size() - 1, seed));
+    }
+    thread_samplers_.push_back(std::move(samplers));
+  }
+
+  auto sample_inputs = [&](int thread_id, size_t begin, size_t end) {
+    auto& samplers = thread_samplers_[thread_id];
+    auto draw = [&](size_t j) {
+      return layer_ids_[j][samplers[j]->Sample()].id();
+    };
+    std::vector<std::vector<uint64_t>> shared(num_layers);
+    if (share_negatives) {
+      for (size_t j = 0; j < num_layers; j++) {
+        for (int k = 0; k < layer_counts_[j]; k++) {
+          shared[j].push_back(draw(j));
+        }
+      }
+    }
+    for (size_t i = begin; i < end; i++) {
+      uint64_t* out = outputs + i * layer_counts_sum_ * cols;
+      for (size_t j = 0; j < num_layers; j++) {
+        const uint64_t* user =
+            j > 0 && with_hierarchy
+                ? ancestor_ids.data() + (j * input_num + i) * feature_num
+                : user_inputs + i * feature_num;
+        uint64_t positive = travel_ids[i * num_layers + j];
+        for (int r = 0; r <= layer_counts_[j]; r++) {
+          std::copy_n(user, feature_num, out + r * cols);
+        }
+        out[feature_num] = positive;
+        out[feature_num + 1] = 1;
+        for (int k = 0; k < layer_counts_[j]; k++) {
+          uint64_t negative = share_negatives ? shared[j][k] : positive;
+          while (negative == positive) {
+            negative = draw(j);
+          }
+          uint64_t* row = out + (k + 1) * cols;
+          row[feature_num] = negative;
+          row[feature_num + 1] = 0;
+        }
+        out += (layer_counts_[j] + 1) * cols;
+      }
+    }
+  };
+
+  if (num_threads == 1) {
+    sample_inputs(0, 0, input_num);
+    return;
+  }
+  std::vector<std::thread> threads;
+  size_t chunk = (input_num + num_threads - 1) / num_threads;
+  for (int t = 0; t < num_threads; t++) {
+    size_t begin = t * chunk;
+    size_t end = std::min(begin + chunk, input_num);
+    if (begin >= end) {
+      break;
+    }
+    threads.emplace_back(sample_inputs, t, begin, end);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 void LayerWiseSampler::sample_from_dataset(
     const uint16_t sample_slot,
     std::vector<paddle::framework::Record>* src_datas,
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #pragma once
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
@@ -46,6 +48,26 @@ class IndexSampler {
       const std::vector<uint64_t>& input_targets,
       bool with_hierarchy = false) = 0;
 
+  // Rows sample and sample_batch produce for each input.
+  virtual int64_t rows_per_input() const { return 0; }
+
+  // sample over a batch on num_threads threads. user_inputs holds input_num
+  // rows of user_feature_num ids and outputs gets the rows of sample, input
+  // after input, each of user_feature_num + 2 ids. With share_negatives, the
+  // inputs a thread samples draw the negatives of each layer once and only
+  // redraw the ones equal to their positive.
+  virtual void sample_batch(const uint64_t* user_inputs UNUSED,
+                            const uint64_t* target_ids UNUSED,
+                            size_t input_num UNUSED,
+                            size_t user_feature_num UNUSED,
+                            bool with_hierarchy UNUSED,
+                            bool share_negatives UNUSED,
+                            int num_threads UNUSED,
+                            uint64_t* outputs UNUSED) {
+    PADDLE_THROW(common::errors::Unimplemented(
+        "sample_batch is not supported by this IndexSampler."));
+  }
+
   virtual void sample_from_dataset(
       const uint16_t sample_slot,
       std::vector<paddle::framework::Record>* src_datas,
@@ -100,6 +122,7 @@ class LayerWiseSampler : public IndexSampler {
 
     auto max_layer = tree_->Height();
     sampler_vec_.clear();
+    thread_samplers_.clear();
     layer_ids_.clear();
 
     auto layer_index = max_layer - 1;
@@ -119,6 +142,18 @@ class LayerWiseSampler : public IndexSampler {
       const std::vector<uint64_t>& target_ids,
       bool with_hierarchy) override;
 
+  int64_t rows_per_input() const override { return layer_counts_sum_; }
+
+  // Not thread safe, the threads of a call keep their own samplers.
+  void sample_batch(const uint64_t* user_inputs,
+                    const uint64_t* target_ids,
+                    size_t input_num,
+                    size_t user_feature_num,
+                    bool with_hierarchy,
+                    bool share_negatives,
+                    int num_threads,
+                    uint64_t* outputs) override;
+
   void sample_from_dataset(
       const uint16_t sample_slot,
       std::vector<paddle::framework::Record>* src_datas,
@@ -131,6 +166,9 @@ class LayerWiseSampler : public IndexSampler {
   int seed_{0};
   int start_sample_layer_{1};
   std::vector<std::shared_ptr<phi::math::Sampler>> sampler_vec_;
+  // samplers of each layer for the threads of sample_batch
+  std::vector<std::vector<std::shared_ptr<phi::math::Sampler>>>
+      thread_samplers_;
   std::vector<std::vector<IndexNode>> layer_ids_;
 };
 
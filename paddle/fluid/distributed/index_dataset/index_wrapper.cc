@@ -11,6 +11,7 @@ limitations under the License. */
 
 #include "paddle/fluid/distributed/index_dataset/index_wrapper.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <thread>
@@ -187,6 +188,48 @@ std::vector<uint64_t> TreeIndex::GetTravelCodes(uint64_t id, int start_level) {
   return res;
 }
 
+void TreeIndex::GetTravelIds(const uint64_t* ids,
+                             size_t num,
+                             int start_level,
+                             uint64_t* travel_ids) {
+  int branch = meta_.branch();
+  int height = meta_.height();
+  for (size_t i = 0; i < num; ++i) {
+    auto it = id_codes_map_.find(ids[i]);
+    PADDLE_ENFORCE_NE(it,
+                      id_codes_map_.end(),
+                      common::errors::InvalidArgument(
+                          "id = %d doesn't exist in Tree.", ids[i]));
+    auto code = it->second;
+    for (int level = height - 1; level >= start_level; --level) {
+      *travel_ids++ = CodeToId(code);
+      code = (code - 1) / branch;
+    }
+  }
+}
+
+void TreeIndex::GetAncestorIds(const uint64_t* ids,
+                               size_t num,
+                               int level,
+                               uint64_t* ancestor_ids) {
+  // as in GetAncestorCodes, ids are taken as leaves, so all of them climb
+  // the same number of levels
+  int branch = meta_.branch();
+  int climb = level >= 0 ? std::max(meta_.height() - 1 - level, 0) : 0;
+  for (size_t i = 0; i < num; ++i) {
+    auto it = id_codes_map_.find(ids[i]);
+    if (it == id_codes_map_.end()) {
+      ancestor_ids[i] = CodeToId(max_code_);
+      continue;
+    }
+    auto code = it->second;
+    for (int k = 0; k < climb; ++k) {
+      code = (code - 1) / branch;
+    }
+    ancestor_ids[i] = CodeToId(code);
+  }
+}
+
 std::vector<IndexNode> TreeIndex::GetAllLeafs() {
   std::vector<IndexNode> res;
   res.reserve(id_codes_map_.size());
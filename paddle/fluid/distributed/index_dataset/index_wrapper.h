@@ -57,6 +57,18 @@ class TreeIndex : public Index {
   std::vector<uint64_t> GetTravelCodes(uint64_t id, int start_level);
   std::vector<IndexNode> GetAllLeafs();
 
+  // Batch forms of GetNodes(GetTravelCodes) and GetNodes(GetAncestorCodes)
+  // which write node ids instead of nodes. travel_ids holds num rows of
+  // Height() - start_level ids, ancestor_ids holds num ids.
+  void GetTravelIds(const uint64_t* ids,
+                    size_t num,
+                    int start_level,
+                    uint64_t* travel_ids);
+  void GetAncestorIds(const uint64_t* ids,
+                      size_t num,
+                      int level,
+                      uint64_t* ancestor_ids);
+
   std::unordered_map<uint64_t, IndexNode> data_;
   std::unordered_map<uint64_t, uint64_t> id_codes_map_;
   uint64_t total_nodes_num_;
@@ -64,6 +76,12 @@ class TreeIndex : public Index {
   uint64_t max_id_;
   uint64_t max_code_;
   IndexNode fake_node_;
+
+ private:
+  uint64_t CodeToId(uint64_t code) const {
+    auto it = data_.find(code);
+    return it == data_.end() ? fake_node_.id() : it->second.id();
+  }
 };
 
 using TreePtr = std::shared_ptr<TreeIndex>;
@@ -88,6 +88,39 @@ inline size_t get_sparse_shard(uint32_t shard_num,
   return (key % shard_num) / local_shard_num;
 }
 
+// server of key, given by the shard owners for a table routed by consistent
+// hashing and by the contiguous shard ranges of get_sparse_shard otherwise
+inline size_t route_sparse_key(const std::vector<uint32_t> *shard_owners,
+                               uint32_t shard_num,
+                               uint32_t server_num,
+                               uint64_t key) {
+  if (shard_owners != nullptr) {
+    return (*shard_owners)[key % shard_num];
+  }
+  return get_sparse_shard(shard_num, server_num, key);
+}
+
+// Buffer of the |keys|values| payload of a sparse push. brpc only compresses
+// the message body, so uncompressed pushes carry the payload in the
+// attachment, which saves the protobuf copies on both ends.
+inline char *ReserveSparsePushData(PsRequestMessage *request, size_t size) {
+  if (FLAGS_pserver_communicate_compress_type == brpc::COMPRESS_TYPE_NONE) {
+    return AllocZeroCopyBuffer(size);
+  }
+  auto *push_data = request->mutable_data();
+  push_data->resize(size);
+  return const_cast<char *>(push_data->data());
+}
+
+// hands a filled payload from ReserveSparsePushData to the request
+inline void CommitSparsePushData(brpc::Controller *cntl,
+                                 char *data,
+                                 size_t size) {
+  if (FLAGS_pserver_communicate_compress_type == brpc::COMPRESS_TYPE_NONE) {
+    AppendZeroCopyBuffer(&cntl->request_attachment(), data, size);
+  }
+}
+
 void DownpourPsClientService::service(
     ::google::protobuf::RpcController *controller,
     const PsRequestMessage *request,
@@ -115,6 +148,7 @@ int32_t BrpcPsClient::StartClientService() {
   brpc::ServerOptions options;
   int start_port = 8500;
   options.num_threads = 24;
+  SetBrpcRdmaOptions(&options, UseRdmaConfig());
 
   if (_server.Start(butil::my_ip_cstr(),
                     brpc::PortRange(start_port, max_port),
@@ -165,6 +199,7 @@ int32_t BrpcPsClient::CreateClient2ClientConnection(
   options.connection_type = "pooled";
   options.connect_timeout_ms = pserver_connect_timeout_ms;
   options.max_retry = max_retry;
+  SetBrpcRdmaOptions(&options, UseRdmaConfig());
 
   std::vector<PSHost> client_list = _env->GetPsClients();
   VLOG(1) << "BrpcPsClient::create_c2c_connection client_list size: "
@@ -296,6 +331,9 @@ int32_t BrpcPsClient::Initialize() {
   options.connection_type = "pooled";
   options.connect_timeout_ms = FLAGS_pserver_connect_timeout_ms;
   options.max_retry = 3;
+  if (SetBrpcRdmaOptions(&options, UseRdmaConfig())) {
+    VLOG(0) << "BrpcPsClient connects to servers over rdma";
+  }
 
   std::ostringstream os;
   std::string server_ip_port;
@@ -326,6 +364,26 @@ int32_t BrpcPsClient::Initialize() {
     }
     os << server_ip_port << ",";
   }
+  // routing of the tables placing their shards by consistent hashing
+  const auto &downpour_param = _config.server_param().downpour_server_param();
+  for (int i = 0; i < downpour_param.downpour_table_param_size(); ++i) {
+    const auto &table_param = downpour_param.downpour_table_param(i);
+    if (!table_param.consistent_hash_shard()) {
+      continue;
+    }
+    uint32_t active_server_num = table_param.active_server_num();
+    if (active_server_num == 0 || active_server_num > server_list.size()) {
+      active_server_num = server_list.size();
+    }
+    _shard_routers[table_param.table_id()] =
+        std::make_shared<SparseShardRouter>(table_param.shard_num(),
+                                            active_server_num);
+  }
+  RegisterClient2ClientMsgHandler(
+      PS_UPDATE_SHARD_ROUTING,
+      [this](int msg_type, int from_client, const std::string &msg) {
+        return HandleShardRouting(msg);
+      });
   // 启动client探听接口, 并相互建立连接
   StartClientService();
 
@@ -342,6 +400,18 @@ int32_t BrpcPsClient::Initialize() {
       _push_sparse_task_queue_map[table_id] =
           ::paddle::framework::MakeChannel<SparseAsyncTask *>();
       _push_sparse_merge_count_map[table_id] = 0;
+      const auto &cache_param =
+          worker_param.downpour_table_param(i).hot_key_cache();
+      if (cache_param.enable()) {
+        _hot_key_caches[table_id] = std::make_unique<HotKeyCache>(
+            GetTableAccessor(table_id)->GetAccessorInfo().select_size,
+            cache_param.capacity(),
+            cache_param.staleness_ms(),
+            cache_param.admit_threshold());
+        VLOG(0) << "enable hot key cache for table " << table_id
+                << ", capacity: " << cache_param.capacity()
+                << ", staleness_ms: " << cache_param.staleness_ms();
+      }
     }
   }
 
@@ -794,6 +864,7 @@ std::future<int32_t> BrpcPsClient::PushSparseParam(size_t table_id,
                                                    const float **update_values,
                                                    size_t num,
                                                    void *done) {
+  InvalidateHotKeys(table_id, keys, num);
   auto *accessor = GetTableAccessor(table_id);
   // 发送RPC请求
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
@@ -1007,6 +1078,7 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     const float **update_values,
     size_t num,
     void *done) {
+  InvalidateHotKeys(table_id, keys, num);
   auto *accessor = GetTableAccessor(table_id);
   // 发送RPC请求
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
@@ -1029,9 +1101,11 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
       break;
     }
   }
+  auto shard_owners = GetShardOwners(table_id);
 
   for (size_t i = 0; i < num; ++i) {
-    size_t pserver_idx = get_sparse_shard(shard_num, request_call_num, keys[i]);
+    size_t pserver_idx = route_sparse_key(
+        shard_owners.get(), shard_num, request_call_num, keys[i]);
     ids[pserver_idx].push_back(keys[i]);
     value_ptrs[pserver_idx].push_back(update_values[i]);
   }
@@ -1049,9 +1123,9 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
     push_request->set_table_id(table_id);
     push_request->set_client_id(_client_id);
     push_request->add_params((char *)&kv_size, sizeof(uint32_t));  // NOLINT
-    auto *push_data = push_request->mutable_data();
-    push_data->resize(kv_size * (sizeof(uint64_t) + value_size));
-    char *push_data_ptr = const_cast<char *>(push_data->data());
+    size_t push_data_size = kv_size * (sizeof(uint64_t) + value_size);
+    char *push_data = ReserveSparsePushData(push_request, push_data_size);
+    char *push_data_ptr = push_data;
     memcpy(push_data_ptr, kvs.data(), kv_size * sizeof(uint64_t));
     push_data_ptr += kv_size * sizeof(uint64_t);
 
@@ -1059,6 +1133,7 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradient(
       memcpy(push_data_ptr, value_ptr[i], value_size);
       push_data_ptr += value_size;
     }
+    CommitSparsePushData(closure->cntl(shard_idx), push_data, push_data_size);
     PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
     closure->cntl(shard_idx)->set_request_compress_type(
         (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
@@ -1156,18 +1231,32 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
       break;
     }
   }
-
-  for (size_t i = 0; i < num; ++i) {
-    size_t shard_id = get_sparse_shard(shard_num, request_call_num, keys[i]);
-    shard_sorted_kvs->at(shard_id).push_back({keys[i], select_values[i]});
-  }
+  auto shard_owners = GetShardOwners(table_id);
 
   auto *accessor = GetTableAccessor(table_id);
 
   size_t value_size = accessor->GetAccessorInfo().select_size;
 
+  // hot keys are served from the local cache and not sent to the servers
+  HotKeyCache *hot_key_cache = GetHotKeyCache(table_id);
+  uint64_t cache_version = 0;
+  if (hot_key_cache != nullptr) {
+    cache_version = hot_key_cache->version();
+  }
+  for (size_t i = 0; i < num; ++i) {
+    if (hot_key_cache != nullptr &&
+        hot_key_cache->lookup(keys[i], select_values[i])) {
+      continue;
+    }
+    size_t shard_id = route_sparse_key(
+        shard_owners.get(), shard_num, request_call_num, keys[i]);
+    shard_sorted_kvs->at(shard_id).push_back({keys[i], select_values[i]});
+  }
+
   DownpourBrpcClosure *closure = new DownpourBrpcClosure(
-      request_call_num, [shard_sorted_kvs, value_size](void *done) {
+      request_call_num,
+      [shard_sorted_kvs, value_size, hot_key_cache, cache_version](
+          void *done) {
         int ret = 0;
         auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
         for (size_t i = 0; i < shard_sorted_kvs->size(); ++i) {
@@ -1197,6 +1286,10 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
                 ret = -1;
                 break;
               }
+              if (hot_key_cache != nullptr) {
+                hot_key_cache->insert(
+                    last_key, last_value_data, cache_version);
+              }
             }
           }
         }
@@ -1259,6 +1352,69 @@ std::future<int32_t> BrpcPsClient::PullSparse(float **select_values,
   return fut;
 }
 
+std::future<int32_t> BrpcPsClient::PrefetchSparse(size_t table_id,
+                                                  const uint64_t *keys,
+                                                  size_t num) {
+  size_t request_call_num = _server_channels.size();
+  const auto &server_param = _config.server_param().downpour_server_param();
+  uint64_t shard_num = FLAGS_pserver_sparse_table_shard_num;
+  for (int i = 0; i < server_param.downpour_table_param_size(); ++i) {
+    const auto &table_param = server_param.downpour_table_param(i);
+    if (table_param.table_id() == table_id) {
+      shard_num = table_param.shard_num();
+      break;
+    }
+  }
+  auto shard_owners = GetShardOwners(table_id);
+
+  auto shard_keys = std::make_shared<std::vector<std::vector<uint64_t>>>();
+  shard_keys->resize(request_call_num);
+  for (size_t i = 0; i < num; ++i) {
+    size_t shard_id = route_sparse_key(
+        shard_owners.get(), shard_num, request_call_num, keys[i]);
+    shard_keys->at(shard_id).push_back(keys[i]);
+  }
+
+  DownpourBrpcClosure *closure = new DownpourBrpcClosure(
+      request_call_num, [request_call_num](void *done) {
+        int ret = 0;
+        auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        for (size_t i = 0; i < request_call_num; ++i) {
+          if (closure->check_response(i, PS_PREFETCH_SPARSE_TABLE) != 0) {
+            ret = -1;
+            break;
+          }
+        }
+        closure->set_promise_value(ret);
+      });
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+
+  for (size_t i = 0; i < request_call_num; ++i) {
+    auto &keys_i = shard_keys->at(i);
+    std::sort(keys_i.begin(), keys_i.end());
+    keys_i.erase(std::unique(keys_i.begin(), keys_i.end()), keys_i.end());
+    if (keys_i.empty()) {
+      closure->Run();
+      continue;
+    }
+    uint32_t key_num = keys_i.size();
+    closure->request(i)->set_cmd_id(PS_PREFETCH_SPARSE_TABLE);
+    closure->request(i)->set_table_id(table_id);
+    closure->request(i)->set_client_id(_client_id);
+    closure->request(i)->add_params((char *)&key_num,  // NOLINT
+                                    sizeof(uint32_t));
+    closure->cntl(i)->request_attachment().append(
+        reinterpret_cast<void *>(keys_i.data()), key_num * sizeof(uint64_t));
+    PsService_Stub rpc_stub(GetCmdChannel(i));
+    closure->cntl(i)->set_log_id(butil::gettimeofday_ms());
+    rpc_stub.service(
+        closure->cntl(i), closure->request(i), closure->response(i), closure);
+  }
+  return fut;
+}
+
 // for GEO
 std::future<int32_t> BrpcPsClient::PullSparseParam(float **select_values,
                                                    size_t table_id,
@@ -1400,6 +1556,192 @@ std::future<int32_t> BrpcPsClient::SendClient2ClientMsg(
   return fut;
 }
 
+int32_t BrpcPsClient::SendShardCmd(size_t server_id,
+                                   int cmd_id,
+                                   size_t table_id,
+                                   const std::vector<std::string> &params,
+                                   const std::string &attachment,
+                                   std::string *response_data,
+                                   std::string *response_attachment) {
+  DownpourBrpcClosure *closure = new DownpourBrpcClosure(
+      1, [cmd_id, response_data, response_attachment](void *done) {
+        auto *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+        int32_t ret = closure->check_response(0, cmd_id);
+        if (ret == 0 && response_data != nullptr) {
+          *response_data = closure->response(0)->data();
+        }
+        if (ret == 0 && response_attachment != nullptr) {
+          *response_attachment =
+              closure->cntl(0)->response_attachment().to_string();
+        }
+        closure->set_promise_value(ret);
+      });
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+  closure->request(0)->set_cmd_id(cmd_id);
+  closure->request(0)->set_table_id(table_id);
+  closure->request(0)->set_client_id(_client_id);
+  for (const auto &param : params) {
+    closure->request(0)->add_params(param);
+  }
+  closure->cntl(0)->request_attachment().append(attachment);
+  closure->cntl(0)->set_timeout_ms(FLAGS_pserver_timeout_ms);
+  PsService_Stub rpc_stub(GetCmdChannel(server_id));
+  rpc_stub.service(
+      closure->cntl(0), closure->request(0), closure->response(0), closure);
+  fut.wait();
+  return fut.get();
+}
+
+// A shard is copied bucket by bucket while training goes on, then all the
+// clients switch to the new owner and the old owner drops it. Updates the
+// old owner gets between the copy of a bucket and the switch are lost, which
+// async training tolerates like any other stale push.
+int32_t BrpcPsClient::MoveSparseShard(size_t table_id,
+                                      uint32_t shard_id,
+                                      uint32_t to_server) {
+  auto itr = _shard_routers.find(table_id);
+  if (itr == _shard_routers.end() || to_server >= _server_channels.size() ||
+      shard_id >= itr->second->owners()->size()) {
+    LOG(ERROR) << "can not move shard " << shard_id << " of table "
+               << table_id << " to server " << to_server
+               << ", is the table consistent_hash_shard?";
+    return -1;
+  }
+  auto &router = itr->second;
+  uint32_t from_server = router->owner(shard_id);
+  if (from_server == to_server) {
+    return 0;
+  }
+  std::string shard_param = std::to_string(shard_id);
+  std::string more = "1";
+  for (uint32_t part = 0; more == "1"; ++part) {
+    std::string rows;
+    if (SendShardCmd(from_server,
+                     PS_EXPORT_SPARSE_SHARD,
+                     table_id,
+                     {shard_param, std::to_string(part)},
+                     "",
+                     &more,
+                     &rows) != 0 ||
+        SendShardCmd(to_server,
+                     PS_IMPORT_SPARSE_SHARD,
+                     table_id,
+                     {shard_param},
+                     rows,
+                     nullptr,
+                     nullptr) != 0) {
+      LOG(ERROR) << "copy part " << part << " of shard " << shard_id
+                 << " of table " << table_id << " from server " << from_server
+                 << " to server " << to_server << " failed";
+      return -1;
+    }
+  }
+
+  uint64_t version = router->version(shard_id) + 1;
+  std::ostringstream msg;
+  msg << table_id << " " << shard_id << " " << to_server << " " << version;
+  HandleShardRouting(msg.str());
+  std::vector<std::future<int32_t>> routing_status;
+  for (size_t i = 0; i < _client_channels.size(); ++i) {
+    if (i != _client_id) {
+      routing_status.push_back(
+          SendClient2ClientMsg(PS_UPDATE_SHARD_ROUTING, i, msg.str()));
+    }
+  }
+  int32_t ret = 0;
+  for (auto &status : routing_status) {
+    status.wait();
+    if (status.get() != 0) {
+      // such a client keeps pushing to the old owner, which drops the rows
+      // at the next shrink
+      LOG(ERROR) << "update routing of shard " << shard_id << " of table "
+                 << table_id << " failed on some client";
+      ret = -1;
+    }
+  }
+  if (SendShardCmd(from_server,
+                   PS_DROP_SPARSE_SHARD,
+                   table_id,
+                   {shard_param},
+                   "",
+                   nullptr,
+                   nullptr) != 0) {
+    LOG(ERROR) << "drop shard " << shard_id << " of table " << table_id
+               << " on server " << from_server << " failed";
+    ret = -1;
+  }
+  VLOG(0) << "moved shard " << shard_id << " of table " << table_id
+          << " from server " << from_server << " to server " << to_server;
+  return ret;
+}
+
+int32_t BrpcPsClient::HandleShardRouting(const std::string &msg) {
+  std::istringstream is(msg);
+  size_t table_id = 0;
+  uint32_t shard_id = 0;
+  uint32_t owner = 0;
+  uint64_t version = 0;
+  if (!(is >> table_id >> shard_id >> owner >> version)) {
+    LOG(ERROR) << "shard routing message is not in format: " << msg;
+    return -1;
+  }
+  auto itr = _shard_routers.find(table_id);
+  if (itr == _shard_routers.end()) {
+    LOG(ERROR) << "table " << table_id << " is not consistent_hash_shard";
+    return -1;
+  }
+  if (itr->second->set_owner(shard_id, owner, version)) {
+    VLOG(1) << "shard " << shard_id << " of table " << table_id
+            << " routes to server " << owner << ", version " << version;
+  }
+  return 0;
+}
+
+std::future<int32_t> BrpcPsClient::MigrateSparseShard(size_t table_id,
+                                                      uint32_t shard_id,
+                                                      uint32_t to_server) {
+  std::promise<int32_t> promise;
+  std::future<int32_t> fut = promise.get_future();
+  promise.set_value(MoveSparseShard(table_id, shard_id, to_server));
+  return fut;
+}
+
+std::future<int32_t> BrpcPsClient::RebalanceSparseTable(size_t table_id,
+                                                        uint32_t server_num) {
+  std::promise<int32_t> promise;
+  std::future<int32_t> fut = promise.get_future();
+  auto itr = _shard_routers.find(table_id);
+  if (itr == _shard_routers.end() || server_num == 0 ||
+      server_num > _server_channels.size()) {
+    LOG(ERROR) << "can not rebalance table " << table_id << " on "
+               << server_num << " servers, is the table consistent_hash_shard?";
+    promise.set_value(-1);
+    return fut;
+  }
+  auto owners = itr->second->owners();
+  auto target =
+      SparseShardRouter::ConsistentOwners(owners->size(), server_num);
+  int32_t ret = 0;
+  size_t moved = 0;
+  for (uint32_t shard_id = 0; shard_id < owners->size(); ++shard_id) {
+    if ((*owners)[shard_id] == target[shard_id]) {
+      continue;
+    }
+    if (MoveSparseShard(table_id, shard_id, target[shard_id]) != 0) {
+      ret = -1;
+    } else {
+      ++moved;
+    }
+  }
+  VLOG(0) << "rebalance table " << table_id << " on " << server_num
+          << " servers, moved " << moved << " of " << owners->size()
+          << " shards";
+  promise.set_value(ret);
+  return fut;
+}
+
 std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
     size_t table_id,
     const uint64_t *keys,
@@ -1407,6 +1749,7 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
     uint32_t num,
     void *done,
     int pserver_idx) {
+  InvalidateHotKeys(table_id, keys, num);
   auto *accessor = GetTableAccessor(table_id);
   size_t value_size = accessor->GetAccessorInfo().update_size;
   DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
@@ -1420,15 +1763,50 @@ std::future<int32_t> BrpcPsClient::PushSparseRawGradientPartial(
   push_request->set_table_id(table_id);
   push_request->set_client_id(_client_id);
   push_request->add_params((char *)&num, sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
-  push_data->resize(num * (sizeof(uint64_t) + value_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
+  size_t push_data_size = num * (sizeof(uint64_t) + value_size);
+  char *push_data = ReserveSparsePushData(push_request, push_data_size);
+  char *push_data_ptr = push_data;
   memcpy(push_data_ptr, keys, num * sizeof(uint64_t));
   push_data_ptr += num * sizeof(uint64_t);
   for (uint32_t i = 0; i < num; ++i) {
     memcpy(push_data_ptr, update_values[i], value_size);
     push_data_ptr += value_size;
   }
+  CommitSparsePushData(closure->cntl(0), push_data, push_data_size);
+  PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
+  closure->cntl(0)->set_request_compress_type(
+      (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
+  rpc_stub.service(
+      closure->cntl(0), closure->request(0), closure->response(0), closure);
+  return fut;
+}
+
+std::future<int32_t> BrpcPsClient::PushSparseEncodedGradientPartial(
+    size_t table_id,
+    const uint64_t *keys,
+    const char *update_values,
+    size_t update_size,
+    uint32_t codec,
+    uint32_t num,
+    void *done,
+    int pserver_idx) {
+  InvalidateHotKeys(table_id, keys, num);
+  DownpourBrpcClosure *closure = reinterpret_cast<DownpourBrpcClosure *>(done);
+  auto promise = std::make_shared<std::promise<int32_t>>();
+  closure->add_promise(promise);
+  std::future<int> fut = promise->get_future();
+
+  auto *push_request = closure->request(0);
+  push_request->set_cmd_id(PS_PUSH_SPARSE_TABLE);
+  push_request->set_table_id(table_id);
+  push_request->set_client_id(_client_id);
+  push_request->add_params((char *)&num, sizeof(uint32_t));    // NOLINT
+  push_request->add_params((char *)&codec, sizeof(uint32_t));  // NOLINT
+  size_t push_data_size = num * sizeof(uint64_t) + update_size;
+  char *push_data = ReserveSparsePushData(push_request, push_data_size);
+  memcpy(push_data, keys, num * sizeof(uint64_t));
+  memcpy(push_data + num * sizeof(uint64_t), update_values, update_size);
+  CommitSparsePushData(closure->cntl(0), push_data, push_data_size);
   PsService_Stub rpc_stub(GetSparseChannel(pserver_idx));
   closure->cntl(0)->set_request_compress_type(
       (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
@@ -1527,6 +1905,7 @@ std::future<int32_t> BrpcPsClient::PushSparse(size_t table_id,
                                               const uint64_t *keys,
                                               const float **update_values,
                                               size_t num) {
+  InvalidateHotKeys(table_id, keys, num);
   auto push_timer = std::make_shared<CostTimer>("pserver_client_push_sparse");
   CostTimer parse_timer("pserver_client_push_sparse_parse");
   int push_sparse_async_num = _push_sparse_task_queue_map[table_id]->Size();
@@ -1556,8 +1935,10 @@ std::future<int32_t> BrpcPsClient::PushSparse(size_t table_id,
       break;
     }
   }
+  auto shard_owners = GetShardOwners(table_id);
   for (size_t i = 0; i < num; ++i) {
-    size_t shard_id = get_sparse_shard(shard_num, request_call_num, keys[i]);
+    size_t shard_id = route_sparse_key(
+        shard_owners.get(), shard_num, request_call_num, keys[i]);
     shard_sorted_kv_list[shard_id].push_back({keys[i], update_values[i]});
   }
   auto sparse_task_data = _sparse_task_pool.get();
@@ -1854,10 +2235,10 @@ int BrpcPsClient::PushSparseAsyncShardPush(
   push_request->set_client_id(_client_id);
   push_request->add_params(reinterpret_cast<char *>(&merged_kv_count),
                            sizeof(uint32_t));  // NOLINT
-  auto *push_data = push_request->mutable_data();
   int update_size = accessor->GetAccessorInfo().update_size;
-  push_data->resize(merged_kv_count * (sizeof(uint64_t) + update_size));
-  char *push_data_ptr = const_cast<char *>(push_data->data());
+  size_t push_data_size = merged_kv_count * (sizeof(uint64_t) + update_size);
+  char *push_data = ReserveSparsePushData(push_request, push_data_size);
+  char *push_data_ptr = push_data;
   memcpy(push_data_ptr,
          merged_key_list.data(),
          merged_kv_count * sizeof(uint64_t));
@@ -1870,6 +2251,7 @@ int BrpcPsClient::PushSparseAsyncShardPush(
            update_size);
     push_data_ptr += update_size;
   }
+  CommitSparsePushData(closure->cntl(shard_idx), push_data, push_data_size);
   PsService_Stub rpc_stub(GetSparseChannel(shard_idx));
   closure->cntl(shard_idx)->set_request_compress_type(
       (brpc::CompressType)FLAGS_pserver_communicate_compress_type);
@@ -24,6 +24,8 @@
 #include "brpc/controller.h"
 #include "brpc/server.h"
 #include "paddle/common/macros.h"
+#include "paddle/fluid/distributed/common/hot_key_cache.h"
+#include "paddle/fluid/distributed/common/shard_router.h"
 #include "paddle/fluid/distributed/ps/service/brpc_utils.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
@@ -267,6 +269,9 @@ class BrpcPsClient : public PSClient {
                                           const uint64_t *keys,
                                           size_t num,
                                           bool is_training);
+  std::future<int32_t> PrefetchSparse(size_t table_id,
+                                      const uint64_t *keys,
+                                      size_t num) override;
   virtual std::future<int32_t> PullSparseParam(float **select_values,
                                                size_t table_id,
                                                const uint64_t *keys,
@@ -290,6 +295,12 @@ class BrpcPsClient : public PSClient {
                                             int to_client_id,
                                             const std::string &msg) override;
 
+  std::future<int32_t> MigrateSparseShard(size_t table_id,
+                                          uint32_t shard_id,
+                                          uint32_t to_server) override;
+  std::future<int32_t> RebalanceSparseTable(size_t table_id,
+                                            uint32_t server_num) override;
+
   // for local save sparse
   virtual int32_t RecvAndSaveTable(const uint64_t table_id,
                                    const std::string &path);
@@ -366,6 +377,39 @@ class BrpcPsClient : public PSClient {
   std::unordered_map<uint32_t, paddle::framework::Channel<SparseAsyncTask *>>
       _push_sparse_task_queue_map;
   std::unordered_map<uint32_t, uint32_t> _push_sparse_merge_count_map;
+  // client side cache of hot keys, only for tables enabling hot_key_cache
+  std::unordered_map<uint32_t, std::unique_ptr<HotKeyCache>> _hot_key_caches;
+  HotKeyCache *GetHotKeyCache(size_t table_id) {
+    auto itr = _hot_key_caches.find(table_id);
+    return itr == _hot_key_caches.end() ? nullptr : itr->second.get();
+  }
+  void InvalidateHotKeys(size_t table_id, const uint64_t *keys, size_t num) {
+    auto *cache = GetHotKeyCache(table_id);
+    if (cache != nullptr) {
+      cache->invalidate(keys, num);
+    }
+  }
+  // owners of the global shards, only for tables with consistent_hash_shard
+  std::unordered_map<uint32_t, std::shared_ptr<SparseShardRouter>>
+      _shard_routers;
+  // snapshot of the shard owners of table_id, null when it is range sharded
+  std::shared_ptr<const std::vector<uint32_t>> GetShardOwners(
+      size_t table_id) {
+    auto itr = _shard_routers.find(table_id);
+    return itr == _shard_routers.end() ? nullptr : itr->second->owners();
+  }
+  int32_t MoveSparseShard(size_t table_id,
+                          uint32_t shard_id,
+                          uint32_t to_server);
+  int32_t HandleShardRouting(const std::string &msg);
+  // sends cmd_id to one server and waits for the response
+  int32_t SendShardCmd(size_t server_id,
+                       int cmd_id,
+                       size_t table_id,
+                       const std::vector<std::string> &params,
+                       const std::string &attachment,
+                       std::string *response_data,
+                       std::string *response_attachment);
 
   std::thread _print_thread;
 
@@ -410,6 +454,16 @@ class BrpcPsClient : public PSClient {
                                                     void *done,
                                                     int pserver_idx) override;
 
+  std::future<int32_t> PushSparseEncodedGradientPartial(
+      size_t table_id,
+      const uint64_t *keys,
+      const char *update_values,
+      size_t update_size,
+      uint32_t codec,
+      uint32_t num,
+      void *done,
+      int pserver_idx) override;
+
   std::future<int32_t> PushSparseParam(size_t table_id,
                                        const uint64_t *keys,
                                        const float **update_values,
@@ -424,6 +478,14 @@ class BrpcPsClient : public PSClient {
  private:
   int32_t StartClientService();
 
+  // whether the ps service config asks for the rdma transport
+  bool UseRdmaConfig() const {
+    return _config.server_param()
+        .downpour_server_param()
+        .service_param()
+        .use_rdma();
+  }
+
   void PushDenseRawGradient(std::shared_ptr<DenseAsyncTask> &task,  // NOLINT
                             float *total_send_data,
                             size_t total_send_data_size,
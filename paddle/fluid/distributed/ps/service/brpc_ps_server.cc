@@ -16,7 +16,6 @@
 
 #include <thread>  // NOLINT
 
-#include "butil/object_pool.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/ps/table/depends/sparse_utils.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
@@ -79,6 +78,10 @@ uint64_t BrpcPsServer::Start(const std::string &ip, uint32_t port) {
   int num_threads = std::thread::hardware_concurrency();
   auto trainers = _environment->GetTrainers();
   options.num_threads = trainers > num_threads ? trainers : num_threads;
+  const auto &service_config = _config.downpour_server_param().service_param();
+  if (SetBrpcRdmaOptions(&options, service_config.use_rdma())) {
+    VLOG(0) << "BrpcPsServer serves over rdma";
+  }
 
   if (_server.Start(ip_port.c_str(), &options) != 0) {
     VLOG(0) << "BrpcPsServer start failed, ip_port= " << ip_port
@@ -109,6 +112,8 @@ int32_t BrpcPsServer::StartS2S() {
   options.connection_type = FLAGS_pserver_connection_type_s2s;
   options.connect_timeout_ms = FLAGS_pserver_connect_timeout_ms_s2s;
   options.max_retry = 3;
+  SetBrpcRdmaOptions(
+      &options, _config.downpour_server_param().service_param().use_rdma());
 
   std::vector<PSHost> pserver_list = _environment->GetPsServers();
   _pserver_channels.resize(pserver_list.size());
@@ -196,6 +201,13 @@ int32_t BrpcPsService::Initialize() {
   _service_handler_map[PS_PUSH_DENSE_TABLE] = &BrpcPsService::PushDense;
   _service_handler_map[PS_PULL_SPARSE_TABLE] = &BrpcPsService::PullSparse;
   _service_handler_map[PS_PUSH_SPARSE_TABLE] = &BrpcPsService::PushSparse;
+  _service_handler_map[PS_PREFETCH_SPARSE_TABLE] =
+      &BrpcPsService::PrefetchSparse;
+  _service_handler_map[PS_EXPORT_SPARSE_SHARD] =
+      &BrpcPsService::ExportSparseShard;
+  _service_handler_map[PS_IMPORT_SPARSE_SHARD] =
+      &BrpcPsService::ImportSparseShard;
+  _service_handler_map[PS_DROP_SPARSE_SHARD] = &BrpcPsService::DropSparseShard;
   _service_handler_map[PS_SAVE_ONE_TABLE] = &BrpcPsService::SaveOneTable;
   _service_handler_map[PS_SAVE_ALL_TABLE] = &BrpcPsService::SaveAllTable;
   _service_handler_map[PS_SHRINK_TABLE] = &BrpcPsService::ShrinkTable;
@@ -316,20 +328,20 @@ int32_t BrpcPsService::PullDense(Table *table,
   CostTimer timer("pserver_server_pull_dense");
   uint32_t num = *(const uint32_t *)request.params(0).c_str();
 
-  auto res_data = butil::get_object<std::vector<float>>();
-  res_data->resize(num *
-                   table->GetValueAccessor()->GetAccessorInfo().select_size /
-                   sizeof(float));
+  // pulled straight into a buffer owned by the response attachment
+  size_t res_size =
+      num * table->GetValueAccessor()->GetAccessorInfo().select_size;
+  char *res_data = AllocZeroCopyBuffer(res_size);
 
   TableContext table_context;
   table_context.value_type = Dense;
-  table_context.pull_context.values = res_data->data();
+  table_context.pull_context.values = reinterpret_cast<float *>(res_data);
   table_context.num = num;
-  table->Pull(table_context);
+  if (table->Pull(table_context) != 0) {
+    set_response_code(response, -1, "PullDense error");
+  }
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
-  butil::return_object(res_data);
+  AppendZeroCopyBuffer(&cntl->response_attachment(), res_data, res_size);
 
   return 0;
 }
@@ -430,8 +442,8 @@ int32_t BrpcPsService::PushSparseParam(Table *table,
   phi::RecordEvent record_event(
       "PsService->PushSparseParam", phi::TracerEventType::Communication, 1);
   CHECK_TABLE_EXIST(table, request, response)
-  auto &push_data = request.data();
-  if (push_data.empty()) {
+  auto &req_io_buffer = cntl->request_attachment();
+  if (request.data().empty() && req_io_buffer.empty()) {
     // set_response_code(response, 0, "push sparse data is empty");
     return 0;
   }
@@ -537,18 +549,112 @@ int32_t BrpcPsService::PullSparse(Table *table,
 
   value.DeserializeFromBytes(const_cast<void *>(data));
 
-  auto res_data = butil::get_object<std::vector<float>>();
-  res_data->resize(num * dim);
+  size_t res_size = num * dim * sizeof(float);
+  char *res_data = AllocZeroCopyBuffer(res_size);
   TableContext table_context;
   table_context.value_type = Sparse;
   table_context.pull_context.pull_value = value;
-  table_context.pull_context.values = res_data->data();
-  table->Pull(table_context);
+  table_context.pull_context.values = reinterpret_cast<float *>(res_data);
+  if (table->Pull(table_context) != 0) {
+    set_response_code(response, -1, "PullSparse error");
+  }
   // table->PullSparse(res_data->data(), value);
 
-  cntl->response_attachment().append(reinterpret_cast<char *>(res_data->data()),
-                                     res_data->size() * sizeof(float));
-  butil::return_object(res_data);
+  AppendZeroCopyBuffer(&cntl->response_attachment(), res_data, res_size);
+  return 0;
+}
+
+int32_t BrpcPsService::PrefetchSparse(Table *table,
+                                      const PsRequestMessage &request,
+                                      PsResponseMessage &response,
+                                      brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 1) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at "
+                      "least 1 for num of sparse_key");
+    return 0;
+  }
+  const uint32_t num =
+      *(reinterpret_cast<const uint32_t *>(request.params(0).c_str()));
+  auto &req_io_buffer = cntl->request_attachment();
+  if (req_io_buffer.size() != num * sizeof(uint64_t)) {
+    set_response_code(response, -1, "req attachment is not in format");
+    return 0;
+  }
+  std::vector<uint64_t> keys(num);
+  req_io_buffer.copy_to(reinterpret_cast<void *>(keys.data()),
+                        num * sizeof(uint64_t));
+  // the table only schedules the loads, the rpc returns right away
+  if (table->Prefetch(keys.data(), num) != 0) {
+    set_response_code(response, -1, "PrefetchSparse error");
+  }
+  return 0;
+}
+
+int32_t BrpcPsService::ExportSparseShard(Table *table,
+                                         const PsRequestMessage &request,
+                                         PsResponseMessage &response,
+                                         brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 2) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at "
+                      "least 2 for shard_id and part");
+    return 0;
+  }
+  uint32_t shard_id = std::stoul(request.params(0));
+  uint32_t part = std::stoul(request.params(1));
+  std::string data;
+  int32_t ret = table->ExportShard(shard_id, part, &data);
+  if (ret < 0) {
+    set_response_code(response, -1, "ExportSparseShard error");
+    return 0;
+  }
+  // data tells whether more parts follow
+  response.set_data(std::to_string(ret));
+  cntl->response_attachment().append(data);
+  return 0;
+}
+
+int32_t BrpcPsService::ImportSparseShard(Table *table,
+                                         const PsRequestMessage &request,
+                                         PsResponseMessage &response,
+                                         brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 1) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at "
+                      "least 1 for shard_id");
+    return 0;
+  }
+  uint32_t shard_id = std::stoul(request.params(0));
+  std::string data = cntl->request_attachment().to_string();
+  if (table->ImportShard(shard_id, data.data(), data.size()) != 0) {
+    set_response_code(response, -1, "ImportSparseShard error");
+  }
+  return 0;
+}
+
+int32_t BrpcPsService::DropSparseShard(Table *table,
+                                       const PsRequestMessage &request,
+                                       PsResponseMessage &response,
+                                       brpc::Controller *cntl) {
+  CHECK_TABLE_EXIST(table, request, response)
+  if (request.params_size() < 1) {
+    set_response_code(response,
+                      -1,
+                      "PsRequestMessage.params is required at "
+                      "least 1 for shard_id");
+    return 0;
+  }
+  uint32_t shard_id = std::stoul(request.params(0));
+  if (table->DropShard(shard_id) != 0) {
+    set_response_code(response, -1, "DropSparseShard error");
+  }
   return 0;
 }
 
@@ -559,8 +665,8 @@ int32_t BrpcPsService::PushSparse(Table *table,
   phi::RecordEvent record_event(
       "PsService->PushSparse", phi::TracerEventType::Communication, 1);
   CHECK_TABLE_EXIST(table, request, response)
-  auto &push_data = request.data();
-  if (push_data.empty()) {
+  auto &req_io_buffer = cntl->request_attachment();
+  if (request.data().empty() && req_io_buffer.empty()) {
     // set_response_code(response, 0, "push sparse data is empty");
     return 0;
   }
@@ -578,13 +684,28 @@ int32_t BrpcPsService::PushSparse(Table *table,
   Push Content:
   |---keysData---|---valuesData---|
   |---8*{num}B---|----------------|
+  uncompressed pushes carry it in the attachment and are parsed in place,
+  compressed ones in request.data(). A second param is the GeoDeltaCodec
+  the values are encoded by, for geo tables.
   */
+  const char *push_data = request.data().data();
+  if (request.data().empty()) {
+    thread_local std::string push_buffer;
+    push_data = FetchIOBufInPlace(
+        req_io_buffer, req_io_buffer.size(), &push_buffer);
+  }
   TableContext table_context;
   table_context.value_type = Sparse;
-  table_context.push_context.keys = (const uint64_t *)push_data.data();
+  table_context.push_context.keys = (const uint64_t *)push_data;
   table_context.push_context.values =
-      (const float *)(push_data.data() + sizeof(uint64_t) * num);
+      (const float *)(push_data + sizeof(uint64_t) * num);
   table_context.num = num;
+  if (request.params_size() > 1) {
+    table_context.push_context.value_codec =
+        *(reinterpret_cast<const uint32_t *>(request.params(1).c_str()));
+    table_context.push_context.encoded_values =
+        push_data + sizeof(uint64_t) * num;
+  }
   // const uint64_t *keys = (const uint64_t *)push_data.data();
   // const float *values = (const float *)(push_data.data() + sizeof(uint64_t) *
   // num);
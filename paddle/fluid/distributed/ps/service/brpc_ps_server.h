@@ -117,6 +117,23 @@ class BrpcPsService : public PsBaseService {
                   const PsRequestMessage &request,
                   PsResponseMessage &response,  // NOLINT
                   brpc::Controller *cntl);
+  int32_t PrefetchSparse(Table *table,
+                         const PsRequestMessage &request,
+                         PsResponseMessage &response,  // NOLINT
+                         brpc::Controller *cntl);
+  int32_t ExportSparseShard(Table *table,
+                            const PsRequestMessage &request,
+                            PsResponseMessage &response,  // NOLINT
+                            brpc::Controller *cntl);
+  int32_t ImportSparseShard(Table *table,
+                            const PsRequestMessage &request,
+                            PsResponseMessage &response,  // NOLINT
+                            brpc::Controller *cntl);
+  int32_t DropSparseShard(Table *table,
+                          const PsRequestMessage &request,
+                          PsResponseMessage &response,  // NOLINT
+                          brpc::Controller *cntl);
+
   int32_t PushSparse(Table *table,
                      const PsRequestMessage &request,
                      PsResponseMessage &response,  // NOLINT
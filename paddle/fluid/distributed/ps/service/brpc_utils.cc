@@ -17,8 +17,16 @@ limitations under the License. */
 #include <arpa/inet.h>
 #include <netdb.h>
 
+#include <atomic>
+#include <mutex>
+
+#include "butil/iobuf.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/platform/enforce.h"
+#ifdef PADDLE_WITH_BRPC_RDMA
+#include "brpc/rdma/rdma_helper.h"
+#endif
 
 namespace paddle::framework {
 class Variable;
@@ -30,6 +38,139 @@ class DenseTensor;
 
 namespace paddle::distributed {
 
+PD_DEFINE_bool(pserver_use_rdma,
+               false,
+               "run ps and heter brpc services over rdma");
+
+namespace {
+
+std::atomic<bool> g_rdma_enabled{false};
+
+#ifdef PADDLE_WITH_BRPC_RDMA
+// Recycles zero-copy buffers registered with the RDMA NIC, registering memory
+// costs far more than sending it. Buffers come in power of two classes of
+// 4KB to 64MB, larger ones are registered per use. A header in front of each
+// buffer keeps its class and lkey.
+class RdmaBufferPool {
+ public:
+  static RdmaBufferPool& Instance() {
+    static RdmaBufferPool pool;
+    return pool;
+  }
+
+  char* Alloc(size_t size) {
+    size_t size_class = SizeClass(size);
+    if (size_class < kNumClasses) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto& free_list = free_lists_[size_class];
+      if (!free_list.empty()) {
+        char* data = free_list.back();
+        free_list.pop_back();
+        return data;
+      }
+    }
+    size_t capacity = size_class < kNumClasses ? kMinSize << size_class : size;
+    void* base = nullptr;
+    if (posix_memalign(&base, kHeaderSize, kHeaderSize + capacity) != 0) {
+      return nullptr;
+    }
+    uint32_t lkey =
+        brpc::rdma::RegisterMemoryForRdma(base, kHeaderSize + capacity);
+    if (lkey == 0) {
+      free(base);  // NOLINT
+      return nullptr;
+    }
+    auto* header = reinterpret_cast<Header*>(base);
+    header->size_class = static_cast<uint32_t>(size_class);
+    header->lkey = lkey;
+    return reinterpret_cast<char*>(base) + kHeaderSize;
+  }
+
+  static uint32_t LKey(const char* data) {
+    return reinterpret_cast<const Header*>(data - kHeaderSize)->lkey;
+  }
+
+  static void Free(void* data) {
+    char* base = reinterpret_cast<char*>(data) - kHeaderSize;
+    size_t size_class = reinterpret_cast<Header*>(base)->size_class;
+    if (size_class >= kNumClasses) {
+      brpc::rdma::DeregisterMemoryForRdma(base);
+      free(base);  // NOLINT
+      return;
+    }
+    auto& pool = Instance();
+    std::lock_guard<std::mutex> lock(pool.mutex_);
+    pool.free_lists_[size_class].push_back(reinterpret_cast<char*>(data));
+  }
+
+ private:
+  struct Header {
+    uint32_t size_class;
+    uint32_t lkey;
+  };
+  static constexpr size_t kHeaderSize = 64;
+  static constexpr size_t kMinSize = 4096;
+  static constexpr size_t kNumClasses = 15;
+
+  static size_t SizeClass(size_t size) {
+    size_t size_class = 0;
+    while (size_class < kNumClasses && (kMinSize << size_class) < size) {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+  std::mutex mutex_;
+  std::vector<char*> free_lists_[kNumClasses];
+};
+#endif
+
+}  // namespace
+
+bool UseBrpcRdma(bool config_use_rdma) {
+  if (!config_use_rdma && !FLAGS_pserver_use_rdma) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  static std::once_flag init_flag;
+  std::call_once(init_flag, [] {
+    brpc::rdma::GlobalRdmaInitializeOrDie();
+    VLOG(0) << "brpc rdma initialized for ps and heter services";
+  });
+  g_rdma_enabled = true;
+  return true;
+#else
+  static std::once_flag warn_flag;
+  std::call_once(warn_flag, [] {
+    LOG(WARNING) << "rdma is asked for but paddle is not built with "
+                    "WITH_BRPC_RDMA, ps and heter services fall back to tcp";
+  });
+  return false;
+#endif
+}
+
+bool SetBrpcRdmaOptions(brpc::ChannelOptions* options, bool config_use_rdma) {
+  if (!UseBrpcRdma(config_use_rdma)) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  options->use_rdma = true;
+  // brpc's rdma endpoint serves one connection per channel
+  options->connection_type = "single";
+#endif
+  return true;
+}
+
+bool SetBrpcRdmaOptions(brpc::ServerOptions* options, bool config_use_rdma) {
+  if (!UseBrpcRdma(config_use_rdma)) {
+    return false;
+  }
+#ifdef PADDLE_WITH_BRPC_RDMA
+  options->use_rdma = true;
+#endif
+  return true;
+}
+
 framework::proto::VarType::Type VarMessageToVarType(
     VariableMessage::Type type) {
   switch (type) {
@@ -338,4 +479,50 @@ std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port) {
   return int_ip_port;
 }
 
+char* AllocZeroCopyBuffer(size_t size) {
+#ifdef PADDLE_WITH_BRPC_RDMA
+  if (g_rdma_enabled) {
+    char* data = RdmaBufferPool::Instance().Alloc(size);
+    PADDLE_ENFORCE_NOT_NULL(
+        data,
+        common::errors::ResourceExhausted(
+            "Failed to allocate a %d bytes rdma registered buffer.", size));
+    return data;
+  }
+#endif
+  return reinterpret_cast<char*>(malloc(size > 0 ? size : 1));  // NOLINT
+}
+
+void AppendZeroCopyBuffer(butil::IOBuf* iobuf, char* data, size_t size) {
+#ifdef PADDLE_WITH_BRPC_RDMA
+  if (g_rdma_enabled) {
+    if (size == 0 ||
+        iobuf->append_user_data_with_meta(data,
+                                          size,
+                                          RdmaBufferPool::Free,
+                                          RdmaBufferPool::LKey(data)) != 0) {
+      iobuf->append(data, size);
+      RdmaBufferPool::Free(data);
+    }
+    return;
+  }
+#endif
+  if (size == 0 || iobuf->append_user_data(data, size, free) != 0) {
+    // empty or oversized blocks are not accepted as user data, copy instead
+    iobuf->append(data, size);
+    free(data);  // NOLINT
+  }
+}
+
+const char* FetchIOBufInPlace(const butil::IOBuf& iobuf,
+                              size_t size,
+                              std::string* buffer) {
+  if (iobuf.backing_block_num() > 0 && iobuf.backing_block(0).size() >= size) {
+    return iobuf.backing_block(0).data();
+  }
+  buffer->resize(size);
+  iobuf.copy_to(const_cast<char*>(buffer->data()), size);
+  return buffer->data();
+}
+
 }  // namespace paddle::distributed
@@ -21,6 +21,7 @@ limitations under the License. */
 #include <vector>
 
 #include "brpc/channel.h"
+#include "brpc/server.h"
 #include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/fluid/framework/lod_tensor.h"
@@ -94,5 +95,29 @@ void DeserializeSelectedRows(framework::Variable* var,
 
 std::string GetIntTypeEndpoint(const std::string& ip, const uint32_t& port);
 
+// RDMA transport of the ps and heter services. It is on when paddle is built
+// WITH_BRPC_RDMA and either the ps service config or FLAGS_pserver_use_rdma
+// asks for it. The Set* helpers switch the given options to brpc's RDMA
+// endpoint and return whether they did.
+bool UseBrpcRdma(bool config_use_rdma = false);
+bool SetBrpcRdmaOptions(brpc::ChannelOptions* options,
+                        bool config_use_rdma = false);
+bool SetBrpcRdmaOptions(brpc::ServerOptions* options,
+                        bool config_use_rdma = false);
+
+// Zero-copy helpers for ps messages. A buffer from AllocZeroCopyBuffer is
+// filled by the caller and then owned by the IOBuf it is appended to, brpc
+// frees it after the message is written to the socket. Once RDMA is on the
+// buffers come from memory registered with the NIC, so the values are sent
+// without being copied into brpc's own blocks.
+char* AllocZeroCopyBuffer(size_t size);
+void AppendZeroCopyBuffer(butil::IOBuf* iobuf, char* data, size_t size);
+
+// Returns the first size bytes of iobuf. Points into the IOBuf itself when
+// they are in its first block, otherwise they are gathered into *buffer.
+const char* FetchIOBufInPlace(const butil::IOBuf& iobuf,
+                              size_t size,
+                              std::string* buffer);
+
 }  // namespace distributed
 }  // namespace paddle
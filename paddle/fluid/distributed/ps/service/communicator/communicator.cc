@@ -23,6 +23,11 @@ limitations under the License. */
 #include "paddle/phi/core/platform/profiler.h"
 #include "paddle/utils/string/string_helper.h"
 
+COMMON_DECLARE_bool(communicator_adaptive_send);
+COMMON_DECLARE_int32(communicator_send_latency_target_ms);
+COMMON_DECLARE_string(geo_sparse_delta_compress_type);
+COMMON_DECLARE_double(geo_sparse_delta_skip_threshold);
+
 #define LEARNING_RATE_DECAY_COUNTER "@LR_DECAY_COUNTER@"
 #define STEP_COUNTER "@PS_STEP_COUNTER@"
 
@@ -497,14 +502,99 @@ void AsyncCommunicator::RecvNoBarrier() {
   return;
 }
 
+int AsyncCommunicator::MergeWindow(const std::string &name) {
+  if (!FLAGS_communicator_adaptive_send) {
+    return max_merge_var_num_;
+  }
+  std::lock_guard<std::mutex> lock(send_stat_mutex_);
+  return send_stats_[name].merge_window;
+}
+
+void AsyncCommunicator::AcquireSendSlot() {
+  std::unique_lock<std::mutex> lock(send_slot_mutex_);
+  send_slot_cond_.wait(lock,
+                       [this] { return sending_num_ < send_concurrency_; });
+  ++sending_num_;
+}
+
+void AsyncCommunicator::ReleaseSendSlot() {
+  {
+    std::lock_guard<std::mutex> lock(send_slot_mutex_);
+    --sending_num_;
+  }
+  send_slot_cond_.notify_all();
+}
+
+void AsyncCommunicator::UpdateSendStat(const std::string &name,
+                                       size_t queue_size,
+                                       int merged_var_num,
+                                       double rpc_ms) {
+  std::lock_guard<std::mutex> lock(send_stat_mutex_);
+  auto &stat = send_stats_[name];
+  stat.send_num += 1;
+  stat.merged_var_num += merged_var_num;
+  stat.rpc_ms += rpc_ms;
+  stat.max_rpc_ms = std::max(stat.max_rpc_ms, rpc_ms);
+  stat.rpc_ms_ewma = stat.send_num == 1
+                         ? rpc_ms
+                         : 0.8 * stat.rpc_ms_ewma + 0.2 * rpc_ms;
+  stat.queue_size = queue_size;
+  stat.max_queue_size = std::max(stat.max_queue_size, queue_size);
+  if (!FLAGS_communicator_adaptive_send) {
+    return;
+  }
+  // a queue still holding a full window is behind, merge more per rpc and
+  // send more tables at once, a drained queue keeps the window at what
+  // arrives so that the merge loop does not wait on an idle queue. An rpc
+  // slower than the target backs the concurrency off.
+  bool backlog = queue_size >= static_cast<size_t>(stat.merge_window);
+  if (backlog) {
+    stat.merge_window = std::min(stat.merge_window * 2, max_merge_var_num_);
+  } else if (queue_size == 0 && merged_var_num * 2 <= stat.merge_window) {
+    stat.merge_window = std::max(stat.merge_window / 2, 1);
+  }
+  {
+    std::lock_guard<std::mutex> slot_lock(send_slot_mutex_);
+    if (stat.rpc_ms_ewma > FLAGS_communicator_send_latency_target_ms) {
+      send_concurrency_ = std::max(send_concurrency_ - 1, 1);
+    } else if (backlog) {
+      send_concurrency_ = std::min(send_concurrency_ + 1, thread_pool_size_);
+    }
+  }
+  send_slot_cond_.notify_all();
+}
+
+std::unordered_map<std::string, CommunicatorSendStat>
+AsyncCommunicator::GetSendStats() {
+  std::unordered_map<std::string, CommunicatorSendStat> stats;
+  {
+    std::lock_guard<std::mutex> lock(send_stat_mutex_);
+    stats = send_stats_;
+  }
+  int send_concurrency = 0;
+  {
+    std::lock_guard<std::mutex> lock(send_slot_mutex_);
+    send_concurrency = send_concurrency_;
+  }
+  for (auto &iter : stats) {
+    auto &ctx = send_varname_to_ctx_.at(iter.first);
+    auto &queue = send_varname_to_queue_.at(ctx.origin_varnames[0]);
+    iter.second.queue_size = queue->Size();
+    iter.second.queue_full_waits = queue->FullWaits();
+    iter.second.send_concurrency = send_concurrency;
+  }
+  return stats;
+}
+
 void AsyncCommunicator::SendByCommunicator() {
   std::vector<std::future<void>> tasks;
   tasks.reserve(send_varname_to_ctx_.size());
 
   for (auto &iter : send_varname_to_ctx_) {
+    auto &name = iter.first;
     auto &ctx = iter.second;
 
-    auto send_recv_task = [this, &ctx] {
+    auto send_recv_task = [this, &name, &ctx] {
       auto &varnames = ctx.origin_varnames;
       auto &table_id = ctx.table_id;
       size_t var_nums = varnames.size();
@@ -513,7 +603,8 @@ void AsyncCommunicator::SendByCommunicator() {
       vars.resize(var_nums);
       int merged_var_num = 0;
       int wait_times = 0;
-      while (merged_var_num < max_merge_var_num_) {
+      int merge_window = MergeWindow(name);
+      while (merged_var_num < merge_window) {
         if (check_queue->Size() == 0) {
           VLOG(4) << "wait_times -> " << wait_times;
           if (wait_times >= send_wait_times_) {
@@ -543,17 +634,29 @@ void AsyncCommunicator::SendByCommunicator() {
         }
       }
 
-      if (ctx.is_tensor_table) {
-        SendGlobalStep(ctx, merged_var_num, send_scope_.get());
-      } else if (ctx.is_sparse) {
+      if (!ctx.is_tensor_table && ctx.is_sparse) {
         PADDLE_ENFORCE_EQ(
             varnames.size(),
             1,
             common::errors::InvalidArgument(
                 "sparse variables can only be merged by one variables"));
+      }
+      AcquireSendSlot();
+      double start_us = GetCurrentUS();
+      if (ctx.is_tensor_table) {
+        SendGlobalStep(ctx, merged_var_num, send_scope_.get());
+      } else if (ctx.is_sparse) {
         RpcSendSparse(varnames[0], table_id, *send_scope_);
       } else {
         RpcSendDense(ctx, *send_scope_);
+      }
+      ReleaseSendSlot();
+      UpdateSendStat(name,
+                     check_queue->Size(),
+                     merged_var_num,
+                     (GetCurrentUS() - start_us) / 1000);
+
+      if (!ctx.is_tensor_table && !ctx.is_sparse) {
         if (!independent_recv_ &&
             recv_varname_to_ctx_.find(table_id) != recv_varname_to_ctx_.end()) {
           auto recv_varnames = recv_varname_to_ctx_.at(table_id);
@@ -858,6 +961,10 @@ void AsyncCommunicator::InitImpl(const RpcCtxMap &send_varname_to_ctx,
     }
   }
   send_threadpool_ = std::make_unique<::ThreadPool>(thread_pool_size_);
+  send_concurrency_ = thread_pool_size_;
+  for (auto &iter : send_varname_to_ctx_) {
+    send_stats_[iter.first].merge_window = max_merge_var_num_;
+  }
 }
 
 AsyncCommunicator::~AsyncCommunicator() {
@@ -1410,22 +1517,57 @@ void GeoCommunicator::SendSparse(const std::string &varname,
   auto blas = phi::funcs::GetBlas<phi::CPUContext, float>(cpu_ctx);
   float coefficient = 1.0 / static_cast<float>(trainers_);
 
+  // old takes what the pserver decodes, so the quantization error and the
+  // skipped deltas stay in latest - old for the next send
+  uint32_t codec =
+      GeoDeltaCodecFromString(FLAGS_geo_sparse_delta_compress_type);
+  float skip_threshold =
+      static_cast<float>(FLAGS_geo_sparse_delta_skip_threshold);
+  size_t row_bytes = GeoDeltaRowBytes(codec, dims1);
+  std::vector<char> encoded;
+  if (codec != kGeoDeltaFP32) {
+    encoded.resize(sparse_ids.size() * row_bytes);
+  }
+  std::vector<float> decoded(dims1);
+
+  std::vector<int64_t> send_ids;
+  send_ids.reserve(sparse_ids.size());
   std::vector<float *> push_g_vec;
   for (auto j = 0; j < static_cast<int>(sparse_ids.size()); ++j) {
+    float *delta = t_value + j * dims1;
+    float *old_data = t_old->data<float>() + sparse_ids[j] * dims1;
     blas.VSUB(dims1,
               t_latest.data<float>() + sparse_ids[j] * dims1,
-              t_old->data<float>() + sparse_ids[j] * dims1,
-              t_value + j * dims1);
-    blas.SCAL(dims1, coefficient, t_value + j * dims1);
-    blas.VADD(dims1,
-              t_old->data<float>() + sparse_ids[j] * dims1,
-              t_value + j * dims1,
-              t_old->data<float>() + sparse_ids[j] * dims1);
-    push_g_vec.push_back(t_value + j * dims1);
+              old_data,
+              delta);
+    blas.SCAL(dims1, coefficient, delta);
+    if (skip_threshold > 0 &&
+        std::all_of(delta, delta + dims1, [skip_threshold](float v) {
+          return std::fabs(v) <= skip_threshold;
+        })) {
+      continue;
+    }
+    if (codec != kGeoDeltaFP32) {
+      GeoDeltaEncodeRow(codec,
+                        delta,
+                        dims1,
+                        encoded.data() + send_ids.size() * row_bytes,
+                        decoded.data());
+      blas.VADD(dims1, old_data, decoded.data(), old_data);
+    } else {
+      blas.VADD(dims1, old_data, delta, old_data);
+      push_g_vec.push_back(delta);
+    }
+    send_ids.push_back(sparse_ids[j]);
 
     VLOG(5) << "DEBUG GeoCommunicator::SendSparse send sparse key "
-            << sparse_ids[j] << " value[0] " << push_g_vec[j][0]
-            << " value[-1] " << push_g_vec[j][dims1 - 1];
+            << sparse_ids[j] << " value[0] " << delta[0] << " value[-1] "
+            << delta[dims1 - 1];
+  }
+  if (send_ids.empty()) {
+    VLOG(1) << "Skip Send Sparse " << varname << ", no delta above "
+            << skip_threshold;
+    return;
   }
 
   ++_async_call_num;
@@ -1438,17 +1580,31 @@ void GeoCommunicator::SendSparse(const std::string &varname,
     closure->set_promise_value(ret);
     --_async_call_num;
   });
-  auto status = _worker_ptr->PushSparseRawGradientPartial(
-      table_id,
-      (const uint64_t *)sparse_ids.data(),
-      (const float **)push_g_vec.data(),
-      sparse_ids.size(),
-      closure,
-      ep_idx);
+  std::future<int32_t> status;
+  if (codec != kGeoDeltaFP32) {
+    status = _worker_ptr->PushSparseEncodedGradientPartial(
+        table_id,
+        (const uint64_t *)send_ids.data(),
+        encoded.data(),
+        send_ids.size() * row_bytes,
+        codec,
+        send_ids.size(),
+        closure,
+        ep_idx);
+  } else {
+    status = _worker_ptr->PushSparseRawGradientPartial(
+        table_id,
+        (const uint64_t *)send_ids.data(),
+        (const float **)push_g_vec.data(),
+        send_ids.size(),
+        closure,
+        ep_idx);
+  }
   status.wait();
 
   VLOG(1) << "Finish Send Sparse " << varname
-          << ", ids.size = " << sparse_ids.size() << ", table_id: " << table_id;
+          << ", ids.size = " << send_ids.size() << " of " << sparse_ids.size()
+          << ", table_id: " << table_id;
   return;
 }
 
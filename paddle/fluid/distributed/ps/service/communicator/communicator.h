@@ -33,7 +33,9 @@ limitations under the License. */
 #include "paddle/fluid/distributed/ps/service/communicator/communicator_common.h"
 #include "paddle/fluid/distributed/ps/service/coordinator_client.h"
 #include "paddle/fluid/distributed/ps/service/ps_client.h"
+#include "paddle/fluid/distributed/ps/table/depends/geo_recorder.h"
 #include "paddle/fluid/framework/channel.h"
+#include "paddle/fluid/framework/mpmc_ring.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/variable.h"
 #include "paddle/fluid/framework/variable_helper.h"
@@ -60,95 +62,32 @@ namespace distributed {
 using Scope = framework::Scope;
 using Variable = framework::Variable;
 
+// Bounded queue of the communicator, backed by a lock free MPMCRing so that
+// the trainer threads pushing gradients do not contend on a lock.
 template <typename T>
 class BlockingQueue {
  public:
-  explicit BlockingQueue(size_t capacity) : capacity_(capacity) {
-    PADDLE_ENFORCE_GT(capacity_,
-                      0,
-                      common::errors::InvalidArgument(
-                          "The capacity must be greater than 0."));
-  }
-
-  bool Push(const T &elem) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForWrite(lock);
+  explicit BlockingQueue(size_t capacity) : ring_(capacity) {}
 
-    queue_.push_back(elem);
+  bool Push(const T &elem) { return ring_.Push(elem); }
 
-    Notify();
-    return true;
-  }
-  bool WaitForWrite(std::unique_lock<std::mutex> &lock) {  // NOLINT
-    while (FullUnlocked()) {
-      if (empty_waiters_ != 0) {
-        empty_cond_.notify_one();
-      }
-      full_waiters_++;
-      full_cond_.wait(lock);
-      full_waiters_--;
-    }
-    return true;
-  }
-  bool WaitForRead(std::unique_lock<std::mutex> &lock) {  // NOLINT
-    while (EmptyUnlocked()) {
-      if (full_waiters_ != 0) {
-        full_cond_.notify_one();
-      }
-      empty_waiters_++;
-      empty_cond_.wait(lock);
-      empty_waiters_--;
-    }
-    return true;
-  }
-  bool EmptyUnlocked() { return queue_.empty(); }
-
-  bool FullUnlocked() { return queue_.size() >= capacity_; }
-  void Notify() {
-    if (empty_waiters_ != 0 && (!EmptyUnlocked())) {
-      empty_cond_.notify_one();
-    }
-    if (full_waiters_ != 0 && (!FullUnlocked())) {
-      full_cond_.notify_one();
-    }
-  }
+  bool Push(T &&elem) { return ring_.Push(std::move(elem)); }
 
-  bool Push(T &&elem) {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForWrite(lock);
-    queue_.emplace_back(std::move(elem));
-
-    Notify();
-    return true;
-  }
   T Pop() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    WaitForRead(lock);
-    T rc(std::move(queue_.front()));
-    queue_.pop_front();
-    Notify();
+    T rc;
+    ring_.Pop(&rc);
     return rc;
   }
 
-  size_t Cap() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return capacity_;
-  }
+  size_t Cap() const { return ring_.Capacity(); }
 
-  size_t Size() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return queue_.size();
-  }
+  size_t Size() const { return ring_.Size(); }
+
+  // times a push waited for the queue to have room
+  size_t FullWaits() const { return ring_.FullWaits(); }
 
  private:
-  int empty_waiters_ = 0;
-  int full_waiters_ = 0;
-  std::condition_variable empty_cond_;
-  std::condition_variable full_cond_;
-  const size_t capacity_;
-  std::deque<T> queue_;
-
-  mutable std::mutex mutex_;
+  framework::MPMCRing<T> ring_;
 };
 
 template <typename T,
@@ -226,6 +165,21 @@ inline void MergeVars(const std::string &var_name,
   }
 }
 
+// send metrics of a table, with the merge window and the send concurrency
+// that FLAGS_communicator_adaptive_send adjusts from them
+struct CommunicatorSendStat {
+  uint64_t send_num = 0;
+  uint64_t merged_var_num = 0;
+  double rpc_ms = 0;
+  double max_rpc_ms = 0;
+  double rpc_ms_ewma = 0;
+  size_t queue_size = 0;
+  size_t max_queue_size = 0;
+  size_t queue_full_waits = 0;
+  int merge_window = 0;
+  int send_concurrency = 0;
+};
+
 using RpcCtxMap = std::unordered_map<std::string, CommContext>;
 using RecvCtxMap = std::unordered_map<uint64_t, std::vector<std::string>>;
 using SparseValue = std::unordered_map<int64_t, std::vector<float>>;
@@ -316,6 +270,11 @@ class Communicator {
 
   virtual void Barrier() {}
 
+  // send metrics by send context name
+  virtual std::unordered_map<std::string, CommunicatorSendStat> GetSendStats() {
+    return {};
+  }
+
   virtual void BarrierWithTable(uint32_t barrier_type) {
     auto rets = _worker_ptr->Barrier(barrier_table_id_, barrier_type);
     rets.wait();
@@ -477,6 +436,8 @@ class AsyncCommunicator : public Communicator {
 
   void PushDensePostProcessing();
 
+  std::unordered_map<std::string, CommunicatorSendStat> GetSendStats() override;
+
   void PullSparseToTensorSync(
       const uint64_t table_id,
       int fea_dim,
@@ -516,6 +477,23 @@ class AsyncCommunicator : public Communicator {
 
   std::unique_ptr<Scope> send_scope_;  // an independent scope
   std::atomic_uint grad_num_{0};  // the num of gradient sent since last recv
+
+  // the merge window of a send, max_merge_var_num_ unless adaptive
+  int MergeWindow(const std::string &name);
+  void AcquireSendSlot();
+  void ReleaseSendSlot();
+  void UpdateSendStat(const std::string &name,
+                      size_t queue_size,
+                      int merged_var_num,
+                      double rpc_ms);
+
+  std::mutex send_stat_mutex_;
+  std::unordered_map<std::string, CommunicatorSendStat> send_stats_;
+  // the tables sending at the same time are bounded by send_concurrency_
+  std::mutex send_slot_mutex_;
+  std::condition_variable send_slot_cond_;
+  int send_concurrency_ = 1;
+  int sending_num_ = 0;
 };
 
 class HalfAsyncCommunicator : public AsyncCommunicator {
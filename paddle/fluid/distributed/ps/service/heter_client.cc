@@ -77,6 +77,7 @@ void HeterClient::CreateClient2XpuConnection() {
   options.protocol = "baidu_std";
   options.connection_type = "single";
   options.timeout_ms = FLAGS_pserver_timeout_ms;
+  SetBrpcRdmaOptions(&options);
 
   xpu_channels_.resize(xpu_list_.size());
   for (size_t i = 0; i < xpu_list_.size(); ++i) {
@@ -106,6 +106,7 @@ class HeterClient {
 #endif
       client_channels = &peer_switch_channels_;
     } else if (peer_role == PEER_ROLE_IS_WORKER) {
+      SetBrpcRdmaOptions(&options);
       client_channels = &peer_worker_channels_;
     } else {
       LOG(ERROR) << "init switch client failed, peer_role not valid";
@@ -137,6 +137,18 @@ class PSClient {
                                           size_t num,
                                           bool is_training) = 0;
 
+  // 提前告知server即将pull的keys，server端可将其从ssd异步加载到内存
+  // future结束只代表server已接收，不代表数据已加载完成
+  virtual std::future<int32_t> PrefetchSparse(size_t table_id UNUSED,
+                                              const uint64_t *keys UNUSED,
+                                              size_t num UNUSED) {
+    VLOG(0) << "Did not implement";
+    std::promise<int32_t> promise;
+    std::future<int> fut = promise.get_future();
+    promise.set_value(-1);
+    return fut;
+  }
+
   virtual std::future<int32_t> PullSparseParam(float **select_values UNUSED,
                                                size_t table_id UNUSED,
                                                const uint64_t *keys UNUSED,
@@ -230,6 +242,27 @@ class PSClient {
     return fut;
   }
 
+  // 将sparse表的一个全局分片在线迁移到另一个server, 仅支持开启
+  // consistent_hash_shard的表, 迁移期间训练不中断
+  virtual std::future<int32_t> MigrateSparseShard(size_t table_id UNUSED,
+                                                  uint32_t shard_id UNUSED,
+                                                  uint32_t to_server UNUSED) {
+    VLOG(0) << "Did not implement";
+    std::promise<int32_t> promise;
+    std::future<int> fut = promise.get_future();
+    promise.set_value(-1);
+    return fut;
+  }
+  // 按一致性hash将sparse表的分片重新分布到前server_num个server上
+  virtual std::future<int32_t> RebalanceSparseTable(
+      size_t table_id UNUSED, uint32_t server_num UNUSED) {
+    VLOG(0) << "Did not implement";
+    std::promise<int32_t> promise;
+    std::future<int> fut = promise.get_future();
+    promise.set_value(-1);
+    return fut;
+  }
+
   // client2client消息处理，std::function<int32_t (int, int, const std::string&)
   // -> ret (msg_type, from_client_id, msg)
   typedef std::function<int32_t(int, int, const std::string &)> MsgHandlerFunc;
@@ -280,6 +313,24 @@ class PSClient {
       void *done,
       int pserver_idx) = 0;
 
+  // like PushSparseRawGradientPartial, the num rows are encoded back to
+  // back in update_values by codec (GeoDeltaCodec)
+  virtual std::future<int32_t> PushSparseEncodedGradientPartial(
+      size_t table_id UNUSED,
+      const uint64_t *keys UNUSED,
+      const char *update_values UNUSED,
+      size_t update_size UNUSED,
+      uint32_t codec UNUSED,
+      uint32_t num UNUSED,
+      void *done UNUSED,
+      int pserver_idx UNUSED) {
+    VLOG(0) << "Did not implement";
+    std::promise<int32_t> promise;
+    std::future<int> fut = promise.get_future();
+    promise.set_value(-1);
+    return fut;
+  }
+
   virtual std::future<int32_t> PushSparseParam(size_t table_id,
                                                const uint64_t *keys,
                                                const float **update_values,
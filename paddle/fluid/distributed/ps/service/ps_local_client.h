@@ -77,6 +77,10 @@ class PsLocalClient : public PSClient {
     return fut;
   }
 
+  virtual ::std::future<int32_t> PrefetchSparse(size_t table_id,
+                                                const uint64_t* keys,
+                                                size_t num);
+
   virtual ::std::future<int32_t> PullSparsePtr(
       const int shard_id,
       char** select_values,
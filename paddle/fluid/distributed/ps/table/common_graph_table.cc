@@ -14,6 +14,12 @@
 
 #include "paddle/fluid/distributed/ps/table/common_graph_table.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <ctime>
 
 #include <algorithm>
@@ -42,6 +48,9 @@ COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_uint64(gpugraph_slot_feasign_max_num);
 COMMON_DECLARE_bool(graph_metapath_split_opt);
 COMMON_DECLARE_double(graph_neighbor_size_percent);
+COMMON_DECLARE_bool(graph_compress_edge_shard);
+COMMON_DECLARE_bool(graph_alias_sampler);
+COMMON_DECLARE_int32(graph_load_chunk_size_mb);
 
 PHI_DEFINE_EXPORTED_bool(graph_edges_split_only_by_src_id,
                          false,
@@ -741,6 +750,34 @@ void GraphTable::feature_shrink_to_fit() {
   for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
 }
 
+size_t GraphTable::compress_edge_shards(int idx) {
+  std::vector<std::future<size_t>> tasks;
+  for (auto &shard : edge_shards[idx]) {
+    tasks.push_back(
+        load_node_edge_task_pool->enqueue([&shard, this]() -> size_t {
+          shard->compress_edges(is_weighted_);
+          return shard->compressed_edges->byte_size();
+        }));
+  }
+  size_t edge_bytes = 0;
+  for (size_t i = 0; i < tasks.size(); i++) edge_bytes += tasks[i].get();
+  return edge_bytes;
+}
+
+void GraphTable::decompress_edge_shards(int idx) {
+  std::vector<std::future<int>> tasks;
+  for (auto &shard : edge_shards[idx]) {
+    if (!shard->is_compressed()) {
+      continue;
+    }
+    tasks.push_back(load_node_edge_task_pool->enqueue([&shard]() -> int {
+      shard->decompress_edges();
+      return 0;
+    }));
+  }
+  for (size_t i = 0; i < tasks.size(); i++) tasks[i].get();
+}
+
 void GraphTable::merge_feature_shard() {
   VLOG(0) << "begin merge_feature_shard";
   std::vector<std::future<int>> tasks;
@@ -1777,6 +1814,58 @@ void GraphShard::clear() {
   }
   bucket.clear();
   node_location.clear();
+  compressed_edges.reset();
+}
+
+void GraphShard::compress_edges(bool is_weighted) {
+  if (compressed_edges == nullptr) {
+    compressed_edges = std::make_unique<CompressedGraphEdges>(is_weighted);
+  }
+  std::vector<int64_t> ids;
+  std::vector<CompressedGraphEdges::WeightType> weights;
+  for (auto &item : bucket) {
+    auto *node = dynamic_cast<GraphNode *>(item);
+    if (node == nullptr) {
+      continue;
+    }
+    size_t neighbor_size = node->get_neighbor_size();
+    ids.resize(neighbor_size);
+    weights.resize(is_weighted ? neighbor_size : 0);
+    for (size_t i = 0; i < neighbor_size; ++i) {
+      ids[i] = node->get_neighbor_id(i);
+      if (is_weighted) {
+        weights[i] = node->get_neighbor_weight(i);
+      }
+    }
+    uint32_t row = compressed_edges->add_row(&ids, &weights);
+    item = new CompressedGraphNode(
+        node->get_id(), compressed_edges.get(), row);
+    delete node;
+  }
+  compressed_edges->shrink_to_fit();
+}
+
+void GraphShard::decompress_edges() {
+  if (compressed_edges == nullptr) {
+    return;
+  }
+  bool is_weighted = compressed_edges->is_weighted();
+  for (auto &item : bucket) {
+    auto *row = dynamic_cast<CompressedGraphNode *>(item);
+    if (row == nullptr) {
+      continue;
+    }
+    auto *node = new GraphNode(row->get_id());
+    node->build_edges(is_weighted);
+    size_t neighbor_size = row->get_neighbor_size();
+    for (size_t i = 0; i < neighbor_size; ++i) {
+      node->add_edge(row->get_neighbor_id(i),
+                     static_cast<float>(row->get_neighbor_weight(i)));
+    }
+    item = node;
+    delete row;
+  }
+  compressed_edges.reset();
 }
 
 GraphShard::~GraphShard() { clear(); }
@@ -1794,6 +1883,7 @@ void GraphShard::delete_node(uint64_t id) {
   bucket.pop_back();
 }
 GraphNode *GraphShard::add_graph_node(uint64_t id) {
+  decompress_edges();
   if (node_location.find(id) == node_location.end()) {
     node_location[id] = bucket.size();
     bucket.push_back(new GraphNode(id));
@@ -2583,6 +2673,206 @@ std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file(
   return {local_count, local_valid_count};
 }
 
+namespace {
+
+struct ParsedEdge {
+  uint64_t src;
+  uint64_t dst;
+  float weight;
+};
+
+// Parses the decimal at *pos, before end, and moves *pos past it.
+bool ParseEdgeId(const char **pos, const char *end, uint64_t *id) {
+  const char *p = *pos;
+  while (p < end && (*p == ' ' || *p == '\t')) {
+    ++p;
+  }
+  if (p == end || *p < '0' || *p > '9') {
+    return false;
+  }
+  uint64_t value = 0;
+  for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+    value = value * 10 + (*p - '0');
+  }
+  *id = value;
+  *pos = p;
+  return true;
+}
+
+}  // namespace
+
+// Same edges as parse_edge_file, but the file is mapped into memory and its
+// chunks of FLAGS_graph_load_chunk_size_mb, cut at line ends, are parsed in
+// place by the threads of load_node_edge_task_pool into per shard buffers.
+// Then each shard adds the edges of its buffers in one task, so no shard is
+// written by two threads. A wave of chunks is parsed and added at a time to
+// bound the memory of the buffers.
+std::pair<uint64_t, uint64_t> GraphTable::parse_edge_file_in_chunks(
+    const std::string &path, int idx, bool reverse, bool use_weight) {
+  int fd = open(path.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    VLOG(0) << "can not open edge file " << path;
+    return {0, 0};
+  }
+  size_t file_size = static_cast<size_t>(st.st_size);
+  if (file_size == 0) {
+    close(fd);
+    return {0, 0};
+  }
+  void *addr = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    VLOG(0) << "mmap of edge file " << path << " failed, read it by lines";
+    return parse_edge_file(path, idx, reverse, use_weight);
+  }
+  madvise(addr, file_size, MADV_SEQUENTIAL);
+  is_weighted_ = use_weight;
+  const char *data = static_cast<const char *>(addr);
+  const char *data_end = data + file_size;
+
+  size_t chunk_size =
+      static_cast<size_t>(FLAGS_graph_load_chunk_size_mb) << 20;
+  size_t chunk_num = (file_size + chunk_size - 1) / chunk_size;
+  std::vector<const char *> bounds(chunk_num + 1, data_end);
+  bounds[0] = data;
+  for (size_t k = 1; k < chunk_num; ++k) {
+    // a chunk starts after the first line end at or past its offset
+    const char *from = std::max(data + k * chunk_size - 1, bounds[k - 1]);
+    const char *eol = static_cast<const char *>(
+        memchr(from, '\n', static_cast<size_t>(data_end - from)));
+    bounds[k] = eol == nullptr ? data_end : eol + 1;
+  }
+
+  bool hard_split = FLAGS_graph_edges_split_mode == "hard" ||
+                    FLAGS_graph_edges_split_mode == "HARD";
+  size_t local_shard_num = shard_end - shard_start;
+  auto parse_chunk = [&](const char *begin,
+                         const char *end,
+                         std::vector<std::vector<ParsedEdge>> *edges,
+                         uint64_t *line_count) -> uint64_t {
+    edges->resize(local_shard_num);
+    uint64_t valid_count = 0;
+    char weight_buf[64];
+    for (const char *line = begin; line < end;) {
+      const char *eol = static_cast<const char *>(
+          memchr(line, '\n', static_cast<size_t>(end - line)));
+      if (eol == nullptr) {
+        eol = end;
+      }
+      const char *first_tab = static_cast<const char *>(
+          memchr(line, '\t', static_cast<size_t>(eol - line)));
+      const char *next = eol + 1;
+      if (first_tab == nullptr) {
+        line = next;
+        continue;
+      }
+      ++*line_count;
+      uint64_t src_id = 0;
+      uint64_t dst_id = 0;
+      const char *pos = line;
+      const char *dst_pos = first_tab + 1;
+      if (!ParseEdgeId(&pos, first_tab, &src_id) ||
+          !ParseEdgeId(&dst_pos, eol, &dst_id)) {
+        line = next;
+        continue;
+      }
+      if (reverse) {
+        std::swap(src_id, dst_id);
+      }
+      size_t src_shard_id = src_id % shard_num;
+      if (src_shard_id >= shard_end || src_shard_id < shard_start) {
+        VLOG(4) << "will not load " << src_id << " from " << path
+                << ", please check id distribution";
+        line = next;
+        continue;
+      }
+      if (hard_split &&
+          (!is_key_for_self_rank(src_id) ||
+           (!FLAGS_graph_edges_split_only_by_src_id &&
+            !is_key_for_self_rank(dst_id)))) {
+        line = next;
+        continue;
+      }
+      float weight = 1;
+      const char *last_tab = first_tab;
+      for (const char *p = eol; p > first_tab + 1; --p) {
+        if (p[-1] == '\t') {
+          last_tab = p - 1;
+          break;
+        }
+      }
+      if (last_tab != first_tab) {
+        size_t len = std::min(static_cast<size_t>(eol - last_tab - 1),
+                              sizeof(weight_buf) - 1);
+        memcpy(weight_buf, last_tab + 1, len);
+        weight_buf[len] = '\0';
+        weight = strtof(weight_buf, nullptr);
+      }
+      (*edges)[src_shard_id - shard_start].push_back(
+          {src_id, dst_id, weight});
+      ++valid_count;
+      line = next;
+    }
+    return valid_count;
+  };
+
+  uint64_t local_count = 0;
+  uint64_t local_valid_count = 0;
+  size_t wave_size = static_cast<size_t>(std::max(load_thread_num_, 1));
+  for (size_t wave_begin = 0; wave_begin < chunk_num;
+       wave_begin += wave_size) {
+    size_t wave_end = std::min(wave_begin + wave_size, chunk_num);
+    size_t wave_chunks = wave_end - wave_begin;
+    std::vector<std::vector<std::vector<ParsedEdge>>> edges(wave_chunks);
+    std::vector<uint64_t> line_counts(wave_chunks, 0);
+    std::vector<std::future<uint64_t>> parse_tasks;
+    for (size_t i = 0; i < wave_chunks; ++i) {
+      parse_tasks.push_back(
+          load_node_edge_task_pool->enqueue([&, i]() -> uint64_t {
+            return parse_chunk(bounds[wave_begin + i],
+                               bounds[wave_begin + i + 1],
+                               &edges[i],
+                               &line_counts[i]);
+          }));
+    }
+    for (size_t i = 0; i < wave_chunks; ++i) {
+      local_valid_count += parse_tasks[i].get();
+      local_count += line_counts[i];
+    }
+    std::vector<std::future<int>> add_tasks;
+    for (size_t index = 0; index < local_shard_num; ++index) {
+      add_tasks.push_back(
+          load_node_edge_task_pool->enqueue([&, index, idx]() -> int {
+            auto &shard = edge_shards[idx][index];
+            // in chunk order, the neighbors keep the order of the file
+            for (auto &chunk_edges : edges) {
+              for (auto &edge : chunk_edges[index]) {
+                auto node = shard->add_graph_node(edge.src);
+                if (node != NULL) {
+                  node->build_edges(is_weighted_);
+                  node->add_edge(edge.dst, edge.weight);
+                }
+              }
+              std::vector<ParsedEdge>().swap(chunk_edges[index]);
+            }
+            return 0;
+          }));
+    }
+    for (auto &task : add_tasks) {
+      task.get();
+    }
+  }
+  munmap(addr, file_size);
+  VLOG(2) << local_valid_count << "/" << local_count
+          << " edges are loaded from filepath->" << path << " in "
+          << chunk_num << " chunks";
+  return {local_count, local_valid_count};
+}
+
 std::pair<uint64_t, uint64_t> GraphTable::load_edges(
     const std::string &path,
     bool reverse_edge,
@@ -2608,6 +2898,10 @@ std::pair<uint64_t, uint64_t> GraphTable::load_edges(
   uint64_t count = 0;
   uint64_t valid_count = 0;
 
+  // the edges are added to graph nodes, the shards are compressed again after
+  // the load
+  decompress_edge_shards(idx);
+
   VLOG(0) << "Begin GraphTable::load_edges() edge_type[" << edge_type << "]";
   if (FLAGS_graph_load_in_parallel) {
     std::vector<std::future<std::pair<uint64_t, uint64_t>>> tasks;
@@ -2624,7 +2918,10 @@ std::pair<uint64_t, uint64_t> GraphTable::load_edges(
     }
   } else {
     for (auto path : paths) {
-      auto res = parse_edge_file(path, idx, reverse_edge, use_weight);
+      auto res = FLAGS_graph_load_chunk_size_mb > 0
+                     ? parse_edge_file_in_chunks(
+                           path, idx, reverse_edge, use_weight)
+                     : parse_edge_file(path, idx, reverse_edge, use_weight);
       count += res.first;
       valid_count += res.second;
     }
@@ -2646,6 +2943,12 @@ std::pair<uint64_t, uint64_t> GraphTable::load_edges(
   }
 #endif
 
+  if (FLAGS_graph_compress_edge_shard) {
+    size_t edge_bytes = compress_edge_shards(idx);
+    VLOG(0) << "edge_type[" << edge_type << "] edges are compressed into "
+            << edge_bytes << " bytes";
+  }
+
   if (!build_sampler_on_cpu) {
     // To reduce memory overhead, CPU samplers won't be created in gpugraph.
     // In order not to affect the sampler function of other scenario,
@@ -2653,7 +2956,15 @@ std::pair<uint64_t, uint64_t> GraphTable::load_edges(
     VLOG(0) << "run in gpugraph mode!";
   } else {
     std::string sample_type = "random";
-    VLOG(0) << "build sampler ... ";
+    if (is_weighted_ && FLAGS_graph_alias_sampler) {
+      if (FLAGS_graph_compress_edge_shard) {
+        VLOG(0) << "compressed edges are sampled at random, the alias "
+                   "sampler is not built";
+      } else {
+        sample_type = "alias";
+      }
+    }
+    VLOG(0) << "build " << sample_type << " sampler ... ";
     for (auto &shard : edge_shards[idx]) {
       auto bucket = shard->get_bucket();
       for (auto item : bucket) {
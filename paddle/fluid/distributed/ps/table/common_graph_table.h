@@ -82,7 +82,16 @@ class GraphShard {
   size_t get_all_neighbor_id(std::vector<std::vector<uint64_t>> *total_res,
                              int slice_num) {
     std::vector<uint64_t> keys;
+    std::vector<int64_t> row_ids;
     for (size_t i = 0; i < bucket.size(); i++) {
+      auto *row = dynamic_cast<CompressedGraphNode *>(bucket[i]);
+      if (row != nullptr) {
+        // decodes the row in one pass instead of a block per neighbor
+        row_ids.clear();
+        row->get_neighbor_ids(&row_ids);
+        keys.insert(keys.end(), row_ids.begin(), row_ids.end());
+        continue;
+      }
       size_t neighbor_size = bucket[i]->get_neighbor_size();
       size_t n = keys.size();
       keys.resize(n + neighbor_size);
@@ -130,6 +139,12 @@ class GraphShard {
   void delete_node(uint64_t id);
   void clear();
   void add_neighbor(uint64_t id, uint64_t dst_id, float weight);
+  // packs the neighbor lists of the graph nodes into the csr edges and
+  // replaces the nodes with views on their rows
+  void compress_edges(bool is_weighted);
+  // turns the views back into graph nodes, before edges are added
+  void decompress_edges();
+  bool is_compressed() { return compressed_edges != nullptr; }
   std::unordered_map<uint64_t, int> &get_node_location() {
     return node_location;
   }
@@ -142,6 +157,8 @@ class GraphShard {
   }
 
   void merge_shard(GraphShard *&shard) {  // NOLINT
+    // the views can not outlive the edges of their shard
+    shard->decompress_edges();
     bucket.reserve(bucket.size() + shard->bucket.size());
     for (size_t i = 0; i < shard->bucket.size(); i++) {
       auto node_id = shard->bucket[i]->get_id();
@@ -159,6 +176,7 @@ class GraphShard {
  public:
   std::unordered_map<uint64_t, int> node_location;
   std::vector<Node *> bucket;
+  std::unique_ptr<CompressedGraphEdges> compressed_edges;
 };
 
 enum LRUResponse { ok = 0, blocked = 1, err = 2 };
@@ -195,251 +213,198 @@ class SampleResult {
   ~SampleResult() {}
 };
 
-template <typename K, typename V>
-class LRUNode {
- public:
-  LRUNode(K _key, V _data, size_t _ttl) : key(_key), data(_data), ttl(_ttl) {
-    next = pre = NULL;
+// Counters of a ScaledLRU, summed over its shards.
+struct LRUStats {
+  size_t hit = 0;
+  size_t miss = 0;
+  size_t evict = 0;
+  size_t expire = 0;
+  // the calls that found their shard taken and returned blocked
+  size_t blocked = 0;
+  double hit_rate() const {
+    return hit + miss == 0 ? 0.0 : static_cast<double>(hit) / (hit + miss);
   }
-  K key;
-  V data;
-  size_t ttl;
-  // time to live
-  LRUNode<K, V> *pre, *next;
 };
-template <typename K, typename V>
-class ScaledLRU;
 
+// A shard of the cache with a fixed number of slots, full shards evict by
+// clock (second chance) when they insert, so there is no list to maintain on
+// a hit and no shrink pass. A shard is only locked by try_lock, a caller that
+// finds it taken gets blocked and goes on without the cache.
 template <typename K, typename V>
 class RandomSampleLRU {
  public:
-  explicit RandomSampleLRU(ScaledLRU<K, V> *_father) {
-    father = _father;
-    remove_count = 0;
-    node_size = 0;
-    node_head = node_end = NULL;
-    global_ttl = father->ttl;
-    total_diff = 0;
-  }
-
-  ~RandomSampleLRU() {
-    LRUNode<K, V> *p;
-    while (node_head != NULL) {
-      p = node_head->next;
-      delete node_head;
-      node_head = p;
-    }
-  }
+  RandomSampleLRU(size_t capacity, size_t ttl)
+      : capacity(std::max<size_t>(capacity, 1)), global_ttl(ttl), hand(0) {}
+
   LRUResponse query(K *keys,
                     size_t length,
                     std::vector<std::pair<K, V>> &res) {  // NOLINT
-    if (pthread_rwlock_tryrdlock(&father->rwlock) != 0)
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      stats.blocked++;
       return LRUResponse::blocked;
-    // pthread_rwlock_rdlock(&father->rwlock);
-    int init_size = node_size - remove_count;
-    process_redundant(length * 3);
-
+    }
     for (size_t i = 0; i < length; i++) {
       auto iter = key_map.find(keys[i]);
-      if (iter != key_map.end()) {
-        res.emplace_back(keys[i], iter->second->data);
-        iter->second->ttl--;
-        if (iter->second->ttl == 0) {
-          remove(iter->second);
-          if (remove_count != 0) remove_count--;
-        } else {
-          move_to_tail(iter->second);
-        }
+      if (iter == key_map.end()) {
+        stats.miss++;
+        continue;
+      }
+      stats.hit++;
+      Slot &slot = slots[iter->second];
+      res.emplace_back(keys[i], slot.data);
+      slot.referenced = true;
+      // a result is served ttl times, then sampled again
+      if (--slot.ttl == 0) {
+        stats.expire++;
+        release(iter->second);
+        key_map.erase(iter);
       }
     }
-    total_diff += node_size - remove_count - init_size;
-    if (total_diff >= 500 || total_diff < -500) {
-      father->handle_size_diff(total_diff);
-      total_diff = 0;
-    }
-    pthread_rwlock_unlock(&father->rwlock);
     return LRUResponse::ok;
   }
+
   LRUResponse insert(K *keys, V *data, size_t length) {
-    if (pthread_rwlock_tryrdlock(&father->rwlock) != 0)
+    std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      stats.blocked++;
       return LRUResponse::blocked;
-    // pthread_rwlock_rdlock(&father->rwlock);
-    int init_size = node_size - remove_count;
-    process_redundant(length * 3);
+    }
     for (size_t i = 0; i < length; i++) {
       auto iter = key_map.find(keys[i]);
       if (iter != key_map.end()) {
-        move_to_tail(iter->second);
-        iter->second->ttl = global_ttl;
-        iter->second->data = data[i];
-      } else {
-        LRUNode<K, V> *temp = new LRUNode<K, V>(keys[i], data[i], global_ttl);
-        add_new(temp);
+        Slot &slot = slots[iter->second];
+        slot.data = data[i];
+        slot.ttl = global_ttl;
+        slot.referenced = true;
+        continue;
       }
+      key_map.emplace(keys[i], place(keys[i], data[i]));
     }
-    total_diff += node_size - remove_count - init_size;
-    if (total_diff >= 500 || total_diff < -500) {
-      father->handle_size_diff(total_diff);
-      total_diff = 0;
-    }
-
-    pthread_rwlock_unlock(&father->rwlock);
     return LRUResponse::ok;
   }
-  void remove(LRUNode<K, V> *node) {
-    fetch(node);
-    node_size--;
-    key_map.erase(node->key);
-    delete node;
-  }
 
-  void process_redundant(int process_size) {
-    int length = std::min(remove_count, process_size);
-    while (length--) {
-      remove(node_head);
-      remove_count--;
-    }
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return key_map.size();
   }
 
-  void move_to_tail(LRUNode<K, V> *node) {
-    fetch(node);
-    place_at_tail(node);
+  LRUStats get_stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats;
   }
 
-  void add_new(LRUNode<K, V> *node) {
-    node->ttl = global_ttl;
-    place_at_tail(node);
-    node_size++;
-    key_map[node->key] = node;
-  }
-  void place_at_tail(LRUNode<K, V> *node) {
-    if (node_end == NULL) {
-      node_head = node_end = node;
-      node->next = node->pre = NULL;
-    } else {
-      node_end->next = node;
-      node->pre = node_end;
-      node->next = NULL;
-      node_end = node;
-    }
-  }
+ private:
+  struct Slot {
+    Slot(const K &key, const V &data, size_t ttl)
+        : key(key), data(data), ttl(ttl) {}
+    K key;
+    V data;
+    size_t ttl;
+    bool referenced = false;
+    bool used = true;
+  };
 
-  void fetch(LRUNode<K, V> *node) {
-    if (node->pre) {
-      node->pre->next = node->next;
+  // takes a free slot, a new one, or the first unreferenced one under the
+  // hand
+  size_t place(const K &key, const V &data) {
+    size_t pos;
+    if (!free_slots.empty()) {
+      pos = free_slots.back();
+      free_slots.pop_back();
+    } else if (slots.size() < capacity) {
+      slots.emplace_back(key, data, global_ttl);
+      return slots.size() - 1;
     } else {
-      node_head = node->next;
-    }
-    if (node->next) {
-      node->next->pre = node->pre;
-    } else {
-      node_end = node->pre;
+      while (true) {
+        pos = hand;
+        hand = (hand + 1) % slots.size();
+        Slot &slot = slots[pos];
+        if (slot.used && slot.referenced) {
+          slot.referenced = false;
+          continue;
+        }
+        if (slot.used) {
+          stats.evict++;
+          key_map.erase(slot.key);
+        }
+        break;
+      }
     }
-  }
-
- private:
-  std::unordered_map<K, LRUNode<K, V> *> key_map;
-  ScaledLRU<K, V> *father;
-  size_t global_ttl, size_limit;
-  int node_size, total_diff;
-  LRUNode<K, V> *node_head, *node_end;
-  friend class ScaledLRU<K, V>;
-  int remove_count;
+    Slot &slot = slots[pos];
+    slot.key = key;
+    slot.data = data;
+    slot.ttl = global_ttl;
+    slot.referenced = false;
+    slot.used = true;
+    return pos;
+  }
+
+  // the buffer of the slot is freed when the slot is taken again
+  void release(size_t pos) {
+    slots[pos].used = false;
+    slots[pos].referenced = false;
+    free_slots.push_back(pos);
+  }
+
+  size_t capacity;
+  size_t global_ttl;
+  size_t hand;
+  std::unordered_map<K, size_t> key_map;
+  std::vector<Slot> slots;
+  std::vector<size_t> free_slots;
+  LRUStats stats;
+  std::mutex mutex_;
 };
 
 template <typename K, typename V>
 class ScaledLRU {
  public:
-  ScaledLRU(size_t _shard_num, size_t size_limit, size_t _ttl)
-      : size_limit(size_limit), ttl(_ttl) {
+  ScaledLRU(size_t _shard_num, size_t size_limit, size_t _ttl) : ttl(_ttl) {
     shard_num = _shard_num;
-    pthread_rwlock_init(&rwlock, NULL);
-    stop = false;
-    thread_pool.reset(new ::ThreadPool(1));
-    global_count = 0;
-    lru_pool = std::vector<RandomSampleLRU<K, V>>(shard_num,
-                                                  RandomSampleLRU<K, V>(this));
-    shrink_job = std::thread([this]() -> void {
-      while (true) {
-        {
-          std::unique_lock<std::mutex> lock(mutex_);
-          cv_.wait_for(lock, std::chrono::milliseconds(20000));
-          if (stop) {
-            return;
-          }
-        }
-        auto status =
-            thread_pool->enqueue([this]() -> int { return Shrink(); });
-        status.wait();
-      }
-    });
-    shrink_job.detach();
-  }
-  ~ScaledLRU() {
-    std::unique_lock<std::mutex> lock(mutex_);
-    stop = true;
-    cv_.notify_one();
+    size_t shard_capacity = (size_limit + shard_num - 1) / shard_num;
+    for (size_t i = 0; i < shard_num; i++) {
+      lru_pool.emplace_back(
+          std::make_unique<RandomSampleLRU<K, V>>(shard_capacity, ttl));
+    }
   }
   LRUResponse query(size_t index,
                     K *keys,
                     size_t length,
                     std::vector<std::pair<K, V>> &res) {  // NOLINT
-    return lru_pool[index].query(keys, length, res);
+    return lru_pool[index]->query(keys, length, res);
   }
   LRUResponse insert(size_t index, K *keys, V *data, size_t length) {
-    return lru_pool[index].insert(keys, data, length);
+    return lru_pool[index]->insert(keys, data, length);
   }
-  int Shrink() {
-    size_t node_size = 0;
-    for (size_t i = 0; i < lru_pool.size(); i++) {
-      node_size += lru_pool[i].node_size - lru_pool[i].remove_count;
-    }
 
-    if (node_size <= static_cast<size_t>(1.1 * size_limit) + 1) return 0;
-    if (pthread_rwlock_wrlock(&rwlock) == 0) {
-      global_count = 0;
-      for (size_t i = 0; i < lru_pool.size(); i++) {
-        global_count += lru_pool[i].node_size - lru_pool[i].remove_count;
-      }
-      if (static_cast<size_t>(global_count) > size_limit) {
-        size_t remove = global_count - size_limit;
-        for (size_t i = 0; i < lru_pool.size(); i++) {
-          lru_pool[i].total_diff = 0;
-          lru_pool[i].remove_count +=
-              1.0 * (lru_pool[i].node_size - lru_pool[i].remove_count) /
-              global_count * remove;
-        }
-      }
-      pthread_rwlock_unlock(&rwlock);
-      return 0;
-    }
-    return 0;
-  }
+  size_t get_ttl() { return ttl; }
 
-  void handle_size_diff(int diff) {
-    if (diff != 0) {
-      __sync_fetch_and_add(&global_count, diff);
-      if (global_count > static_cast<int>(1.25 * size_limit)) {
-        thread_pool->enqueue([this]() -> int { return Shrink(); });
-      }
+  size_t size() {
+    size_t total = 0;
+    for (auto &lru : lru_pool) {
+      total += lru->size();
     }
+    return total;
+  }
+
+  LRUStats get_stats() {
+    LRUStats total;
+    for (auto &lru : lru_pool) {
+      LRUStats stats = lru->get_stats();
+      total.hit += stats.hit;
+      total.miss += stats.miss;
+      total.evict += stats.evict;
+      total.expire += stats.expire;
+      total.blocked += stats.blocked;
+    }
+    return total;
   }
 
-  size_t get_ttl() { return ttl; }
-
  private:
-  pthread_rwlock_t rwlock;
   size_t shard_num;
-  int global_count;
-  size_t size_limit, total, hit;
   size_t ttl;
-  bool stop;
-  std::thread shrink_job;
-  std::vector<RandomSampleLRU<K, V>> lru_pool;
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
-  std::shared_ptr<::ThreadPool> thread_pool;
-  friend class RandomSampleLRU<K, V>;
+  std::vector<std::unique_ptr<RandomSampleLRU<K, V>>> lru_pool;
 };
 enum GraphTableType { EDGE_TABLE, FEATURE_TABLE, NODE_TABLE };
 class GraphTable : public Table {
@@ -623,6 +588,8 @@ class GraphTable : public Table {
                                                 int idx,
                                                 bool reverse,
                                                 bool use_weight);
+  std::pair<uint64_t, uint64_t> parse_edge_file_in_chunks(
+      const std::string &path, int idx, bool reverse, bool use_weight);
   std::pair<uint64_t, uint64_t> parse_node_file(const std::string &path,
                                                 const std::string &node_type,
                                                 int idx,
@@ -700,6 +667,9 @@ class GraphTable : public Table {
   void clear_feature_shard();
   void clear_node_shard();
   void feature_shrink_to_fit();
+  // packs the edges of edge type idx into csr, returns their bytes
+  size_t compress_edge_shards(int idx);
+  void decompress_edge_shards(int idx);
   void merge_feature_shard();
   void release_graph();
   void release_graph_edge();
@@ -715,6 +685,9 @@ class GraphTable : public Table {
     }
     return 0;
   }
+  LRUStats get_neighbor_sample_cache_stats() {
+    return use_cache ? scaled_lru->get_stats() : LRUStats();
+  }
   virtual void load_node_weight(int type_id, int idx, std::string path);
 #ifdef PADDLE_WITH_HETERPS
   virtual void make_partitions(int idx, int64_t gb_size, int device_len);
@@ -246,9 +246,22 @@ int32_t CtrCommonAccessor::Merge(float** update_values,
 int32_t CtrCommonAccessor::Update(float** update_values,
                                   const float** push_values,
                                   size_t num) {
+  const float nonclk_coeff = _config.ctr_accessor_param().nonclk_coeff();
+  const float click_coeff = _config.ctr_accessor_param().click_coeff();
   for (size_t value_item = 0; value_item < num; ++value_item) {
     float* update_value = update_values[value_item];
     const float* push_value = push_values[value_item];
+    // the rows of a batch are scattered over the shard, fetch the next one
+    // while this one is updated
+    if (value_item + 1 < num) {
+      float* next_update_value = update_values[value_item + 1];
+      const float* next_push_value = push_values[value_item + 1];
+      __builtin_prefetch(next_update_value, 1);
+      __builtin_prefetch(
+          next_update_value + common_feature_value.EmbedxWIndex(), 1);
+      __builtin_prefetch(next_push_value);
+      __builtin_prefetch(next_push_value + CtrCommonPushValue::EmbedxGIndex());
+    }
     float push_show = push_value[CtrCommonPushValue::ShowIndex()];
     float push_click = push_value[CtrCommonPushValue::ClickIndex()];
     float slot = push_value[CtrCommonPushValue::SlotIndex()];
@@ -256,14 +269,13 @@ int32_t CtrCommonAccessor::Update(float** update_values,
     update_value[common_feature_value.ClickIndex()] += push_click;
     update_value[common_feature_value.SlotIndex()] = slot;
     update_value[common_feature_value.DeltaScoreIndex()] +=
-        (push_show - push_click) * _config.ctr_accessor_param().nonclk_coeff() +
-        push_click * _config.ctr_accessor_param().click_coeff();
+        (push_show - push_click) * nonclk_coeff + push_click * click_coeff;
     update_value[common_feature_value.UnseenDaysIndex()] = 0;
     // TODO(zhaocaibei123): add configure show_scale
     if (!_show_scale) {
       push_show = 1;
     }
-    VLOG(3) << "accessor show scale:" << _show_scale
+    VLOG(5) << "accessor show scale:" << _show_scale
             << ", push_show:" << push_show;
     _embed_sgd_rule->UpdateValue(
         update_value + common_feature_value.EmbedWIndex(),
@@ -178,12 +178,16 @@ class CtrCommonAccessor : public ValueAccessor {
   int32_t ParseFromString(const std::string& str, float* v) override;
   virtual bool CreateValue(int type, const float* value);
 
-  // 这个接口目前只用来取show
+  // 这个接口目前只用来取show和ssd淘汰用的show_click_score
   float GetField(float* value, const std::string& name) override {
     // CHECK(name == "show");
     if (name == "show") {
       return common_feature_value.Show(value);
     }
+    if (name == "show_click_score") {
+      return ShowClickScore(common_feature_value.Show(value),
+                            common_feature_value.Click(value));
+    }
     return 0.0;
   }
 
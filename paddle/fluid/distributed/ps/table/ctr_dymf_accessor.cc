@@ -14,13 +14,94 @@
 
 #include "paddle/fluid/distributed/ps/table/ctr_dymf_accessor.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/common/float16.h"
 #include "paddle/utils/string/string_helper.h"
 
 namespace paddle::distributed {
 
+namespace {
+
+int EmbedxStorageFromString(const std::string& name) {
+  if (name.empty() || name == "fp32") {
+    return kEmbedxStorageFP32;
+  } else if (name == "fp16") {
+    return kEmbedxStorageFP16;
+  } else if (name == "int8") {
+    return kEmbedxStorageINT8;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown embedx_storage %s of CtrDymfAccessor, expected fp32, fp16 or "
+      "int8.",
+      name));
+}
+
+// A value buffer of the fp32 layout, for the values of a compact storage
+// on their way in and out of the table.
+float* Fp32ValueBuffer(size_t dim) {
+  thread_local std::vector<float> buffer;
+  if (buffer.size() < dim) {
+    buffer.resize(dim);
+  }
+  return buffer.data();
+}
+
+}  // namespace
+
+void CtrDymfAccessor::CtrDymfFeatureValue::EncodeEmbedxW(const float* w,
+                                                         int mf_dim,
+                                                         float* out) {
+  if (embedx_storage == kEmbedxStorageFP16) {
+    auto* half = reinterpret_cast<phi::dtype::float16*>(out);
+    for (int i = 0; i < mf_dim; ++i) {
+      half[i] = static_cast<phi::dtype::float16>(w[i]);
+    }
+    if (mf_dim % 2 != 0) {
+      half[mf_dim] = static_cast<phi::dtype::float16>(0.0f);
+    }
+  } else if (embedx_storage == kEmbedxStorageINT8) {
+    float max_abs = 0;
+    for (int i = 0; i < mf_dim; ++i) {
+      max_abs = std::max(max_abs, std::fabs(w[i]));
+    }
+    float scale = max_abs / 127.0f;
+    out[0] = scale;
+    auto* q = reinterpret_cast<int8_t*>(out + 1);
+    for (int i = 0; i < mf_dim; ++i) {
+      q[i] = scale > 0 ? static_cast<int8_t>(std::lround(w[i] / scale)) : 0;
+    }
+    for (int i = mf_dim; i < (EmbedxWDim(mf_dim) - 1) * 4; ++i) {
+      q[i] = 0;
+    }
+  } else {
+    memcpy(out, w, mf_dim * sizeof(float));
+  }
+}
+
+void CtrDymfAccessor::CtrDymfFeatureValue::DecodeEmbedxW(const float* in,
+                                                         int mf_dim,
+                                                         float* w) {
+  if (embedx_storage == kEmbedxStorageFP16) {
+    auto* half = reinterpret_cast<const phi::dtype::float16*>(in);
+    for (int i = 0; i < mf_dim; ++i) {
+      w[i] = static_cast<float>(half[i]);
+    }
+  } else if (embedx_storage == kEmbedxStorageINT8) {
+    float scale = in[0];
+    auto* q = reinterpret_cast<const int8_t*>(in + 1);
+    for (int i = 0; i < mf_dim; ++i) {
+      w[i] = q[i] * scale;
+    }
+  } else {
+    memcpy(w, in, mf_dim * sizeof(float));
+  }
+}
+
 int CtrDymfAccessor::Initialize() {
   auto name = _config.embed_sgd_param().name();
   _embed_sgd_rule = CREATE_PSCORE_CLASS(SparseValueSGDRule, name);
@@ -31,6 +112,8 @@ int CtrDymfAccessor::Initialize() {
   _embedx_sgd_rule->LoadConfig(_config.embedx_sgd_param(),
                                _config.embedx_dim());
   common_feature_value.optimizer_name = name;
+  common_feature_value.embedx_storage =
+      EmbedxStorageFromString(_config.ctr_accessor_param().embedx_storage());
 
   common_feature_value.embed_sgd_dim = _embed_sgd_rule->Dim();
   common_feature_value.embedx_dim = _config.embedx_dim();
@@ -58,7 +141,9 @@ int CtrDymfAccessor::Initialize() {
   VLOG(0) << " INTO CtrDymfAccessor::Initialize(); embed_sgd_dim:"
           << common_feature_value.embed_sgd_dim
           << " embedx_dim:" << common_feature_value.embedx_dim
-          << "  embedx_sgd_dim:" << common_feature_value.embedx_sgd_dim;
+          << "  embedx_sgd_dim:" << common_feature_value.embedx_sgd_dim
+          << " embedx_storage:"
+          << _config.ctr_accessor_param().embedx_storage();
   InitAccessorInfo();
   SetTimeDecayRates();
   return 0;
@@ -74,8 +159,9 @@ void CtrDymfAccessor::InitAccessorInfo() {
   _accessor_info.select_size = _accessor_info.select_dim * sizeof(float);
   _accessor_info.update_dim = 5 + embedx_dim;
   _accessor_info.update_size = _accessor_info.update_dim * sizeof(float);
-  _accessor_info.mf_size =
-      (embedx_dim + common_feature_value.embedx_sgd_dim) * sizeof(float);
+  _accessor_info.mf_size = (common_feature_value.EmbedxWDim(embedx_dim) +
+                            common_feature_value.embedx_sgd_dim) *
+                           sizeof(float);
 }
 
 void CtrDymfAccessor::SetTimeDecayRates() {
@@ -250,6 +336,15 @@ int32_t CtrDymfAccessor::Create(float** values, size_t num) {
         zero_init);  // adam embed init not zero, adagrad embed init zero;
                      // pglbox set false for adam, gpups set true for adagrad
                      // users can set this in python config, default is true
+    if (common_feature_value.IsEmbedxCompact()) {
+      int embedx_dim = common_feature_value.embedx_dim;
+      float* embedx_w = Fp32ValueBuffer(embedx_dim);
+      _embedx_sgd_rule->InitValue(
+          embedx_w, value + common_feature_value.EmbedxG2SumIndex(), false);
+      common_feature_value.EncodeEmbedxW(
+          embedx_w, embedx_dim, value + common_feature_value.EmbedxWIndex());
+      continue;
+    }
     _embedx_sgd_rule->InitValue(value + common_feature_value.EmbedxWIndex(),
                                 value + common_feature_value.EmbedxG2SumIndex(),
                                 false);
@@ -283,6 +378,13 @@ int32_t CtrDymfAccessor::Select(float** select_values,
         value[common_feature_value.ClickIndex()];
     select_value[CtrDymfPullValue::EmbedWIndex()] =
         value[common_feature_value.EmbedWIndex()];
+    if (common_feature_value.IsEmbedxCompact()) {
+      common_feature_value.DecodeEmbedxW(
+          value + common_feature_value.EmbedxWIndex(),
+          embedx_dim,
+          select_value + CtrDymfPullValue::EmbedxWIndex());
+      continue;
+    }
     memcpy(select_value + CtrDymfPullValue::EmbedxWIndex(),
            value + common_feature_value.EmbedxWIndex(),
            embedx_dim * sizeof(float));
@@ -373,7 +475,21 @@ std::string CtrDymfAccessor::ParseToString(const float* v, int param) {
   auto mf_dim =
       static_cast<int>(common_feature_value.MfDim(const_cast<float*>(v)));
   if (score >= _config.embedx_threshold() &&
-      param > common_feature_value.EmbedxG2SumIndex()) {
+      param > common_feature_value.EmbedxG2SumIndex() &&
+      common_feature_value.IsEmbedxCompact()) {
+    // the saved embedx_w is fp32 whatever the storage
+    int sgd_end = common_feature_value.EmbedxG2SumIndex() +
+                  common_feature_value.EmbedxSgdDim(mf_dim);
+    for (auto i = common_feature_value.EmbedxG2SumIndex(); i < sgd_end; ++i) {
+      os << " " << v[i];
+    }
+    float* embedx_w = Fp32ValueBuffer(mf_dim);
+    common_feature_value.DecodeEmbedxW(v + sgd_end, mf_dim, embedx_w);
+    for (int i = 0; i < mf_dim; ++i) {
+      os << " " << embedx_w[i];
+    }
+  } else if (score >= _config.embedx_threshold() &&
+             param > common_feature_value.EmbedxG2SumIndex()) {
     for (auto i = common_feature_value.EmbedxG2SumIndex();
          i < common_feature_value.Dim(mf_dim);
          ++i) {
@@ -384,6 +500,9 @@ std::string CtrDymfAccessor::ParseToString(const float* v, int param) {
 }
 
 int CtrDymfAccessor::ParseFromString(const std::string& str, float* value) {
+  if (common_feature_value.IsEmbedxCompact()) {
+    return ParseCompactFromString(str, value);
+  }
   auto ret = paddle::string::str_to_float(str.data(), value);
 #ifdef PADDLE_WITH_PSLIB
   float unseen_day = value[common_feature_value.UnseenDaysIndex()];
@@ -398,6 +517,42 @@ int CtrDymfAccessor::ParseFromString(const std::string& str, float* value) {
   return ret;
 }
 
+// Parses the fp32 text of a value, and encodes its embedx_w to the storage.
+int CtrDymfAccessor::ParseCompactFromString(const std::string& str,
+                                            float* value) {
+  float* parsed = Fp32ValueBuffer(str.size() / 2 + 1);
+  int ret = paddle::string::str_to_float(str.data(), parsed);
+  PADDLE_ENFORCE_GE(
+      ret,
+      7,
+      common::errors::InvalidArgument(
+          "Invalid return value. Expect more than 7. But recieved %d.", ret));
+  int embedx_begin = common_feature_value.EmbedxG2SumIndex();
+  if (ret <= embedx_begin) {
+    memcpy(value, parsed, ret * sizeof(float));
+    return ret;
+  }
+  int mf_dim = static_cast<int>(parsed[common_feature_value.MfDimIndex()]);
+  int sgd_dim = common_feature_value.EmbedxSgdDim(mf_dim);
+  PADDLE_ENFORCE_EQ(ret,
+                    embedx_begin + sgd_dim + mf_dim,
+                    common::errors::InvalidArgument(
+                        "Invalid value of mf_dim %d, expect %d fields, but "
+                        "recieved %d.",
+                        mf_dim,
+                        embedx_begin + sgd_dim + mf_dim,
+                        ret));
+  memcpy(value, parsed, (embedx_begin + sgd_dim) * sizeof(float));
+  common_feature_value.EncodeEmbedxW(
+      parsed + embedx_begin + sgd_dim, mf_dim, value + embedx_begin + sgd_dim);
+#ifdef PADDLE_WITH_PSLIB
+  float unseen_day = value[common_feature_value.UnseenDaysIndex()];
+  common_feature_value.UnseenDays(value) = (uint16_t)(unseen_day);
+  common_feature_value.PassId(value) = 0;
+#endif
+  return embedx_begin + sgd_dim + common_feature_value.EmbedxWDim(mf_dim);
+}
+
 void CtrDymfAccessor::SetDayId(int day_id) { _day_id = day_id; }
 
 void CtrDymfAccessor::UpdateTimeDecay(float* value, bool is_update_seen_day) {
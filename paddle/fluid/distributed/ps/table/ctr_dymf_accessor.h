@@ -27,6 +27,16 @@
 namespace paddle {
 namespace distributed {
 
+// How embedx_w is stored in the values of CtrDymfAccessor, set by
+// ctr_accessor_param.embedx_storage. fp16 keeps mf_dim halves, int8 a float
+// scale and mf_dim int8 scaled to the max abs value of the row, both padded
+// to whole floats. The values pulled and saved are fp32 in all cases.
+enum CtrDymfEmbedxStorage : int {
+  kEmbedxStorageFP32 = 0,
+  kEmbedxStorageFP16 = 1,
+  kEmbedxStorageINT8 = 2,
+};
+
 // DownpourUnitAccessor
 class CtrDymfAccessor : public ValueAccessor {
  public:
@@ -60,7 +70,9 @@ class CtrDymfAccessor : public ValueAccessor {
       std::vector<float> embedx_w;
     */
 
-    int Dim() { return 7 + embed_sgd_dim + embedx_sgd_dim + embedx_dim; }
+    int Dim() {
+      return 7 + embed_sgd_dim + embedx_sgd_dim + EmbedxWDim(embedx_dim);
+    }
     int DimSize(size_t dim, int embedx_dim) { return sizeof(float); }
     int Size() { return Dim() * sizeof(float); }
     int UnseenDaysIndex() { return 0; }
@@ -74,15 +86,38 @@ class CtrDymfAccessor : public ValueAccessor {
     int EmbedxG2SumIndex() { return MfDimIndex() + 1; }
     int EmbedxWIndex() { return EmbedxG2SumIndex() + embedx_sgd_dim; }
 
-    // 根据mf_dim计算的总长度
-    int Dim(int mf_dim) {
+    // 根据mf_dim计算的embedx sgd长度
+    int EmbedxSgdDim(int mf_dim) {
       int tmp_embedx_sgd_dim = 1;
       if (optimizer_name == "SparseAdamSGDRule") {  // adam
         tmp_embedx_sgd_dim = mf_dim * 2 + 2;
       } else if (optimizer_name == "SparseSharedAdamSGDRule") {  // shared_adam
         tmp_embedx_sgd_dim = 4;
       }
-      return 7 + embed_sgd_dim + tmp_embedx_sgd_dim + mf_dim;
+      return tmp_embedx_sgd_dim;
+    }
+
+    // 根据mf_dim计算的embedx_w存储长度
+    int EmbedxWDim(int mf_dim) {
+      switch (embedx_storage) {
+        case kEmbedxStorageFP16:
+          return (mf_dim + 1) / 2;
+        case kEmbedxStorageINT8:
+          return 1 + (mf_dim + 3) / 4;
+        default:
+          return mf_dim;
+      }
+    }
+
+    bool IsEmbedxCompact() { return embedx_storage != kEmbedxStorageFP32; }
+
+    // 在fp32的embedx_w与存储格式之间转换
+    void EncodeEmbedxW(const float* w, int mf_dim, float* out);
+    void DecodeEmbedxW(const float* in, int mf_dim, float* w);
+
+    // 根据mf_dim计算的总长度
+    int Dim(int mf_dim) {
+      return 7 + embed_sgd_dim + EmbedxSgdDim(mf_dim) + EmbedxWDim(mf_dim);
     }
 
     // 根据mf_dim计算的总byte数
@@ -116,6 +151,7 @@ class CtrDymfAccessor : public ValueAccessor {
     int embed_sgd_dim;
     int embedx_dim;
     int embedx_sgd_dim;
+    int embedx_storage = kEmbedxStorageFP32;
     std::string optimizer_name;
   };
 
@@ -271,6 +307,7 @@ class CtrDymfAccessor : public ValueAccessor {
 
  private:
   void SetTimeDecayRates();
+  int ParseCompactFromString(const std::string& str, float* value);
   // float ShowClickScore(float show, float click);
 
   // SparseValueSGDRule* _embed_sgd_rule;
@@ -20,6 +20,7 @@
 
 #include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/common/chunk_allocator.h"
+#include "paddle/phi/core/utils/rw_lock.h"
 
 namespace paddle {
 namespace distributed {
@@ -192,9 +193,17 @@ struct alignas(64) SparseTableShard {
       return hash >> (sizeof(size_t) * 8 - CTR_SPARSE_SHARD_BUCKET_NUM_BITS);
     }
   }
+  // The shard itself is not thread safe. When a shard is accessed by several
+  // threads, callers hold the lock of the bucket a key falls in: a read lock
+  // to find and read values, a write lock to insert or update them.
+  phi::RWLock* bucket_lock(const KEY& key) {
+    return &_bucket_locks[compute_bucket(_hasher(key))];
+  }
+  phi::RWLock* bucket_lock_at(size_t bucket) { return &_bucket_locks[bucket]; }
 
  private:
   map_type _buckets[CTR_SPARSE_SHARD_BUCKET_NUM];
+  phi::RWLock _bucket_locks[CTR_SPARSE_SHARD_BUCKET_NUM];
   ChunkAllocator<VALUE> _alloc;
   std::hash<KEY> _hasher;
 };
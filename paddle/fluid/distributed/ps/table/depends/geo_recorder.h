@@ -16,11 +16,18 @@
 
 #include <ThreadPool.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <future>  // NOLINT
 #include <memory>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
+#include "paddle/common/enforce.h"
+#include "paddle/phi/common/float16.h"
+
 namespace paddle {
 namespace distributed {
 
@@ -87,5 +94,89 @@ class GeoRecorder {
   std::vector<std::unique_ptr<ConcurrentSet>> trainer_rows_;
 };
 
+// Encodings of the sparse deltas a geo trainer pushes. A row is encoded
+// on its own: fp16 keeps dim halves, int8 a float scale and dim int8
+// values of the row scaled to its max abs value.
+enum GeoDeltaCodec : uint32_t {
+  kGeoDeltaFP32 = 0,
+  kGeoDeltaFP16 = 1,
+  kGeoDeltaINT8 = 2,
+};
+
+inline uint32_t GeoDeltaCodecFromString(const std::string& name) {
+  if (name.empty() || name == "none" || name == "fp32") {
+    return kGeoDeltaFP32;
+  } else if (name == "fp16") {
+    return kGeoDeltaFP16;
+  } else if (name == "int8") {
+    return kGeoDeltaINT8;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unknown geo delta compress type %s, expected none, fp16 or int8.",
+      name));
+}
+
+inline size_t GeoDeltaRowBytes(uint32_t codec, int dim) {
+  switch (codec) {
+    case kGeoDeltaFP16:
+      return dim * sizeof(phi::dtype::float16);
+    case kGeoDeltaINT8:
+      return sizeof(float) + dim * sizeof(int8_t);
+    default:
+      return dim * sizeof(float);
+  }
+}
+
+// Encodes a row to out and writes the values the receiver decodes to
+// decoded, the sender keeps row - decoded as the error of the next delta.
+inline void GeoDeltaEncodeRow(
+    uint32_t codec, const float* row, int dim, char* out, float* decoded) {
+  if (codec == kGeoDeltaFP16) {
+    auto* half = reinterpret_cast<phi::dtype::float16*>(out);
+    for (int i = 0; i < dim; ++i) {
+      half[i] = static_cast<phi::dtype::float16>(row[i]);
+      decoded[i] = static_cast<float>(half[i]);
+    }
+  } else if (codec == kGeoDeltaINT8) {
+    float max_abs = 0;
+    for (int i = 0; i < dim; ++i) {
+      max_abs = std::max(max_abs, std::fabs(row[i]));
+    }
+    float scale = max_abs / 127.0f;
+    memcpy(out, &scale, sizeof(float));
+    auto* q = reinterpret_cast<int8_t*>(out + sizeof(float));
+    for (int i = 0; i < dim; ++i) {
+      q[i] = scale > 0
+                 ? static_cast<int8_t>(std::lround(row[i] / scale))
+                 : 0;
+      decoded[i] = q[i] * scale;
+    }
+  } else {
+    memcpy(out, row, dim * sizeof(float));
+    memcpy(decoded, row, dim * sizeof(float));
+  }
+}
+
+inline void GeoDeltaDecodeRow(uint32_t codec,
+                              const char* in,
+                              int dim,
+                              float* row) {
+  if (codec == kGeoDeltaFP16) {
+    auto* half = reinterpret_cast<const phi::dtype::float16*>(in);
+    for (int i = 0; i < dim; ++i) {
+      row[i] = static_cast<float>(half[i]);
+    }
+  } else if (codec == kGeoDeltaINT8) {
+    float scale = 0;
+    memcpy(&scale, in, sizeof(float));
+    auto* q = reinterpret_cast<const int8_t*>(in + sizeof(float));
+    for (int i = 0; i < dim; ++i) {
+      row[i] = q[i] * scale;
+    }
+  } else {
+    memcpy(row, in, dim * sizeof(float));
+  }
+}
+
 }  // namespace distributed
 }  // namespace paddle
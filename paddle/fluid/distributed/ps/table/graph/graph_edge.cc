@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_edge.h"
+#include <algorithm>
 #include <cstring>
+#include <numeric>
 namespace paddle::distributed {
 
 void GraphEdgeBlob::add_edge(int64_t id, float weight = 1) {
@@ -24,6 +26,107 @@ void WeightedGraphEdgeBlob::add_edge(int64_t id, float weight = 1) {
   id_arr.push_back(id);
 #ifdef PADDLE_WITH_CUDA
   weight_arr.push_back((half)weight);
+#else
+  weight_arr.push_back(weight);
 #endif
 }
+
+uint32_t CompressedGraphEdges::add_row(std::vector<int64_t>* ids,
+                                       std::vector<WeightType>* weights) {
+  size_t n = ids->size();
+  if (is_weighted_) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return (*ids)[a] < (*ids)[b];
+    });
+    for (size_t i = 0; i < n; ++i) {
+      weights_.push_back((*weights)[order[i]]);
+    }
+    std::vector<int64_t> sorted(n);
+    for (size_t i = 0; i < n; ++i) {
+      sorted[i] = (*ids)[order[i]];
+    }
+    ids->swap(sorted);
+  } else {
+    std::sort(ids->begin(), ids->end());
+  }
+  uint64_t edge = edge_offsets_.back();
+  for (size_t i = 0; i < n; ++i, ++edge) {
+    int64_t id = (*ids)[i];
+    uint64_t delta =
+        static_cast<uint64_t>(id) - static_cast<uint64_t>(last_id_);
+    if (edge % kBlockSize == 0) {
+      block_offsets_.push_back(data_.size());
+      delta = static_cast<uint64_t>(id);
+    }
+    // zigzag, the rows do not continue the order of the previous ones
+    int64_t d = static_cast<int64_t>(delta);
+    encode((static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63));
+    last_id_ = id;
+  }
+  edge_offsets_.push_back(edge);
+  return edge_offsets_.size() - 2;
+}
+
+void CompressedGraphEdges::encode(uint64_t value) {
+  while (value >= 0x80) {
+    data_.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  data_.push_back(static_cast<uint8_t>(value));
+}
+
+size_t CompressedGraphEdges::decode(size_t pos, uint64_t* value) const {
+  uint64_t v = 0;
+  int shift = 0;
+  while (data_[pos] & 0x80) {
+    v |= static_cast<uint64_t>(data_[pos++] & 0x7f) << shift;
+    shift += 7;
+  }
+  v |= static_cast<uint64_t>(data_[pos++]) << shift;
+  *value = (v >> 1) ^ (~(v & 1) + 1);
+  return pos;
+}
+
+size_t CompressedGraphEdges::seek(uint64_t edge, int64_t* id) const {
+  uint64_t block_start = edge - edge % kBlockSize;
+  uint64_t value = 0;
+  size_t pos = decode(block_offsets_[block_start / kBlockSize], &value);
+  uint64_t cur = value;
+  for (uint64_t e = block_start + 1; e <= edge; ++e) {
+    pos = decode(pos, &value);
+    cur += value;
+  }
+  *id = static_cast<int64_t>(cur);
+  return pos;
+}
+
+int64_t CompressedGraphEdges::get_id(uint32_t row, int idx) const {
+  int64_t id = 0;
+  seek(edge_offsets_[row] + idx, &id);
+  return id;
+}
+
+void CompressedGraphEdges::get_ids(uint32_t row,
+                                   std::vector<int64_t>* res) const {
+  uint64_t start = edge_offsets_[row];
+  uint64_t end = edge_offsets_[row + 1];
+  if (start == end) {
+    return;
+  }
+  int64_t id = 0;
+  size_t pos = seek(start, &id);
+  res->push_back(id);
+  for (uint64_t e = start + 1; e < end; ++e) {
+    uint64_t value = 0;
+    pos = decode(pos, &value);
+    if (e % kBlockSize == 0) {
+      id = static_cast<int64_t>(value);
+    } else {
+      id = static_cast<int64_t>(static_cast<uint64_t>(id) + value);
+    }
+    res->push_back(id);
+  }
+}
 }  // namespace paddle::distributed
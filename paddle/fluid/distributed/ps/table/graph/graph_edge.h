@@ -59,5 +59,60 @@ class WeightedGraphEdgeBlob : public GraphEdgeBlob {
   std::vector<float> weight_arr;
 #endif
 };
+
+// The neighbor lists of a whole shard in csr. The ids of a row are sorted and
+// stored as zigzag varint deltas, every kBlockSize edges restart from a full
+// id, so an edge is decoded from at most one block.
+class CompressedGraphEdges {
+ public:
+#ifdef PADDLE_WITH_CUDA
+  using WeightType = half;
+#else
+  using WeightType = float;
+#endif
+  static constexpr size_t kBlockSize = 16;
+
+  explicit CompressedGraphEdges(bool is_weighted)
+      : is_weighted_(is_weighted) {
+    edge_offsets_.push_back(0);
+  }
+  // sorts the ids of a row, with their weights, and appends it
+  uint32_t add_row(std::vector<int64_t>* ids,
+                   std::vector<WeightType>* weights);
+  size_t row_size(uint32_t row) const {
+    return edge_offsets_[row + 1] - edge_offsets_[row];
+  }
+  int64_t get_id(uint32_t row, int idx) const;
+  WeightType get_weight(uint32_t row, int idx) const {
+    return is_weighted_ ? weights_[edge_offsets_[row] + idx] : WeightType(1.0);
+  }
+  void get_ids(uint32_t row, std::vector<int64_t>* res) const;
+  bool is_weighted() const { return is_weighted_; }
+  size_t byte_size() const {
+    return edge_offsets_.size() * sizeof(uint64_t) +
+           block_offsets_.size() * sizeof(uint64_t) + data_.size() +
+           weights_.size() * sizeof(WeightType);
+  }
+  void shrink_to_fit() {
+    edge_offsets_.shrink_to_fit();
+    block_offsets_.shrink_to_fit();
+    data_.shrink_to_fit();
+    weights_.shrink_to_fit();
+  }
+
+ private:
+  // returns the position after the edge and leaves its id in id
+  size_t seek(uint64_t edge, int64_t* id) const;
+  size_t decode(size_t pos, uint64_t* value) const;
+  void encode(uint64_t value);
+
+  bool is_weighted_;
+  int64_t last_id_ = 0;
+  std::vector<uint64_t> edge_offsets_;
+  std::vector<uint64_t> block_offsets_;
+  std::vector<uint8_t> data_;
+  std::vector<WeightType> weights_;
+};
+
 }  // namespace distributed
 }  // namespace paddle
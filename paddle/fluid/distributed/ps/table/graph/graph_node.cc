@@ -15,6 +15,11 @@
 #include "paddle/fluid/distributed/ps/table/graph/graph_node.h"
 
 #include <cstring>
+
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(graph_alias_sampler_min_degree);
+
 namespace paddle::distributed {
 
 GraphNode::~GraphNode() {
@@ -72,6 +77,8 @@ void GraphNode::build_sampler(std::string sample_type) {
     sampler = new RandomSampler();
   } else if (sample_type == "weighted") {
     sampler = new WeightedSampler();
+  } else if (sample_type == "alias") {
+    sampler = new AliasSampler(FLAGS_graph_alias_sampler_min_degree);
   }
   if (sampler != nullptr) {
     sampler->build(edges);
@@ -80,6 +87,14 @@ void GraphNode::build_sampler(std::string sample_type) {
                              sample_type);
   }
 }
+void CompressedGraphNode::build_sampler(std::string sample_type) {
+  // the compressed rows are sampled uniformly, without a sampler object
+  if (sample_type != "random") {
+    throw std::runtime_error(
+        "Only the random sampler is supported on compressed edges, got: " +
+        sample_type);
+  }
+}
 void FeatureNode::to_buffer(char* buffer, bool need_feature) {
   memcpy(buffer, &id, id_size);
   buffer += id_size;
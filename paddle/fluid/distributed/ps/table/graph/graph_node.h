@@ -117,6 +117,44 @@ class GraphNode : public Node {
   GraphEdgeBlob *edges;
 };
 
+// A row of the compressed edges of a shard, it takes the place of a
+// GraphNode once the shard is compressed.
+class CompressedGraphNode : public Node {
+ public:
+  CompressedGraphNode(uint64_t id,
+                      const CompressedGraphEdges *edges,
+                      uint32_t row)
+      : Node(id), edges(edges), row(row) {
+    is_weighted = edges->is_weighted();
+  }
+  virtual ~CompressedGraphNode() {}
+  virtual void build_sampler(std::string sample_type);
+  virtual std::vector<int> sample_k(
+      int k, const std::shared_ptr<std::mt19937_64> rng) {
+    return random_sample_k(edges->row_size(row), k, rng);
+  }
+  virtual uint64_t get_neighbor_id(int idx) {
+    return edges->get_id(row, idx);
+  }
+#ifdef PADDLE_WITH_CUDA
+  virtual half get_neighbor_weight(int idx) {
+    return edges->get_weight(row, idx);
+  }
+#else
+  virtual float get_neighbor_weight(int idx) {
+    return edges->get_weight(row, idx);
+  }
+#endif
+  virtual size_t get_neighbor_size() { return edges->row_size(row); }
+  void get_neighbor_ids(std::vector<int64_t> *res) const {
+    edges->get_ids(row, res);
+  }
+
+ protected:
+  const CompressedGraphEdges *edges;
+  uint32_t row;
+};
+
 class FeatureNode : public Node {
  public:
   FeatureNode() : Node() {}
@@ -14,9 +14,14 @@
 
 #include "paddle/fluid/distributed/ps/table/graph/graph_weighted_sampler.h"
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "paddle/phi/core/generator.h"
 namespace paddle::distributed {
@@ -25,7 +30,12 @@ void RandomSampler::build(GraphEdgeBlob *edges) { this->edges = edges; }
 
 std::vector<int> RandomSampler::sample_k(
     int k, const std::shared_ptr<std::mt19937_64> rng) {
-  int n = edges->size();
+  return random_sample_k(edges->size(), k, rng);
+}
+
+std::vector<int> random_sample_k(int n,
+                                 int k,
+                                 const std::shared_ptr<std::mt19937_64> rng) {
   if (k >= n) {
     k = n;
     std::vector<int> sample_result;
@@ -165,4 +175,114 @@ int WeightedSampler::sample(
   subtract_count_map[this]++;
   return return_idx;
 }
+
+void AliasSampler::build(GraphEdgeBlob *edges) {
+  this->edges = edges;
+  prob.clear();
+  alias.clear();
+  int n = edges->size();
+  if (n < min_degree || n == 0) {
+    return;
+  }
+  // vose
+  std::vector<double> scaled(n);
+  double total = 0;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = static_cast<float>(edges->get_weight(i));
+    total += scaled[i];
+  }
+  if (total <= 0) {
+    return;
+  }
+  prob.resize(n);
+  alias.resize(n);
+  std::vector<int> small, large;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = scaled[i] * n / total;
+    if (scaled[i] < 1.0) {
+      small.push_back(i);
+    } else {
+      large.push_back(i);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    int s = small.back();
+    int l = large.back();
+    small.pop_back();
+    prob[s] = scaled[s];
+    alias[s] = l;
+    scaled[l] = scaled[l] + scaled[s] - 1.0;
+    if (scaled[l] < 1.0) {
+      large.pop_back();
+      small.push_back(l);
+    }
+  }
+  for (int i : large) {
+    prob[i] = 1.0;
+    alias[i] = i;
+  }
+  for (int i : small) {
+    prob[i] = 1.0;
+    alias[i] = i;
+  }
+}
+
+std::vector<int> AliasSampler::sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  int n = edges->size();
+  if (k >= n) {
+    std::vector<int> sample_result;
+    sample_result.reserve(n);
+    for (int i = 0; i < n; i++) {
+      sample_result.push_back(i);
+    }
+    return sample_result;
+  }
+  if (prob.empty()) {
+    return scan_sample_k(k, rng);
+  }
+  std::vector<int> sample_result;
+  sample_result.reserve(k);
+  std::unordered_set<int> sampled;
+  std::uniform_int_distribution<int> pick(0, n - 1);
+  std::uniform_real_distribution<float> coin(0, 1.0);
+  // the duplicates get frequent when k comes close to the edges carrying the
+  // weight, the scan takes over then
+  int max_draws = 4 * k + 32;
+  while (static_cast<int>(sample_result.size()) < k && max_draws-- > 0) {
+    int i = pick(*rng);
+    int res = coin(*rng) < prob[i] ? i : alias[i];
+    if (sampled.insert(res).second) {
+      sample_result.push_back(res);
+    }
+  }
+  if (static_cast<int>(sample_result.size()) < k) {
+    return scan_sample_k(k, rng);
+  }
+  return sample_result;
+}
+
+std::vector<int> AliasSampler::scan_sample_k(
+    int k, const std::shared_ptr<std::mt19937_64> rng) {
+  // a-res, the k largest log(u) / w
+  int n = edges->size();
+  std::uniform_real_distribution<float> distrib(0, 1.0);
+  std::vector<std::pair<float, int>> keys(n);
+  for (int i = 0; i < n; i++) {
+    float w = static_cast<float>(edges->get_weight(i));
+    float u = distrib(*rng);
+    keys[i].first = w > 0 ? std::log(u) / w
+                          : -std::numeric_limits<float>::infinity();
+    keys[i].second = i;
+  }
+  std::partial_sort(keys.begin(),
+                    keys.begin() + k,
+                    keys.end(),
+                    std::greater<std::pair<float, int>>());
+  std::vector<int> sample_result(k);
+  for (int i = 0; i < k; i++) {
+    sample_result[i] = keys[i].second;
+  }
+  return sample_result;
+}
 }  // namespace paddle::distributed
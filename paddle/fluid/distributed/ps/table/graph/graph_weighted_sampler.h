@@ -23,6 +23,11 @@
 namespace paddle {
 namespace distributed {
 
+// k distinct indices out of n
+std::vector<int> random_sample_k(int n,
+                                 int k,
+                                 const std::shared_ptr<std::mt19937_64> rng);
+
 class Sampler {
  public:
   virtual ~Sampler() {}
@@ -62,5 +67,27 @@ class WeightedSampler : public Sampler {
       std::unordered_map<WeightedSampler *, int> &subtract_count_map,  // NOLINT
       float &subtract);                                                // NOLINT
 };
+
+// Samples by the weights with an alias table, each draw is O(1) and a drawn
+// edge is drawn again on a duplicate, which keeps the distribution of the
+// sampling without replacement. The rows with fewer than min_degree edges do
+// not keep a table, they are sampled by a scan over the weights instead.
+class AliasSampler : public Sampler {
+ public:
+  explicit AliasSampler(int min_degree = 0) : min_degree(min_degree) {}
+  virtual ~AliasSampler() {}
+  virtual void build(GraphEdgeBlob *edges);
+  virtual std::vector<int> sample_k(int k,
+                                    const std::shared_ptr<std::mt19937_64> rng);
+
+ private:
+  std::vector<int> scan_sample_k(int k,
+                                 const std::shared_ptr<std::mt19937_64> rng);
+
+  int min_degree;
+  GraphEdgeBlob *edges = nullptr;
+  std::vector<float> prob;
+  std::vector<int> alias;
+};
 }  // namespace distributed
 }  // namespace paddle
@@ -36,6 +36,13 @@ int32_t MemorySparseGeoTable::Push(TableContext& context) {
                     true,
                     common::errors::InvalidArgument(
                         "The value_type of context must be Sparse."));
+  if (!context.push_context.is_param &&
+      context.push_context.value_codec != kGeoDeltaFP32) {
+    return PushEncodedSparse(context.push_context.keys,
+                             context.push_context.encoded_values,
+                             context.push_context.value_codec,
+                             context.num);
+  }
   if (!context.push_context.is_param) {
     return PushSparse(
         context.push_context.keys, context.push_context.values, context.num);
@@ -131,6 +138,18 @@ int32_t MemorySparseGeoTable::PushSparse(const uint64_t* keys,
   return 0;
 }
 
+int32_t MemorySparseGeoTable::PushEncodedSparse(const uint64_t* keys,
+                                                const char* values,
+                                                uint32_t codec,
+                                                size_t num) {
+  size_t row_bytes = GeoDeltaRowBytes(codec, _dim);
+  std::vector<float> decoded(num * _dim);
+  for (size_t i = 0; i < num; ++i) {
+    GeoDeltaDecodeRow(codec, values + i * row_bytes, _dim, &decoded[i * _dim]);
+  }
+  return PushSparse(keys, decoded.data(), num);
+}
+
 int32_t MemorySparseGeoTable::Initialize() {
   if (!_geo_recorder) {
     auto trainers = _config.common().trainer_num();
@@ -73,6 +73,12 @@ class MemorySparseGeoTable : public Table {
 
   int32_t PushSparse(const uint64_t* keys, const float* values, size_t num);
 
+  // decodes the rows a geo trainer encoded by codec and pushes them
+  int32_t PushEncodedSparse(const uint64_t* keys,
+                            const char* values,
+                            uint32_t codec,
+                            size_t num);
+
   int32_t _PushSparse(const uint64_t* keys, const float* values, size_t num);
   // int32_t _pull_sparse(float* pull_values, const PullSparseValue&
   // pull_value);
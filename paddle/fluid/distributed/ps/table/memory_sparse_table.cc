@@ -13,11 +13,15 @@
 // limitations under the License.
 
 #include <omp.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
 #include <sstream>
 
 #include "glog/logging.h"
 #include "paddle/fluid/distributed/common/cost_timer.h"
 #include "paddle/fluid/distributed/common/local_random.h"
+#include "paddle/fluid/distributed/common/shard_router.h"
 #include "paddle/fluid/distributed/common/topk_calculator.h"
 #include "paddle/fluid/distributed/ps/table/memory_sparse_table.h"
 #include "paddle/fluid/framework/archive.h"
@@ -38,9 +42,261 @@ PD_DEFINE_bool(pserver_enable_create_feasign_randomly,
 PD_DEFINE_int32(pserver_table_save_max_retry,
                 3,
                 "pserver_table_save_max_retry");
+PD_DEFINE_bool(pserver_sparse_table_concurrent_shard,
+               false,
+               "let several task threads access one MemorySparseTable shard "
+               "under per-bucket read/write locks, so that the keys of hot "
+               "shards are pulled and pushed in parallel");
+PD_DEFINE_int32(pserver_shard_task_chunk_size,
+                1024,
+                "max keys of one shard handled by one task when "
+                "pserver_sparse_table_concurrent_shard is on");
+PD_DEFINE_bool(pserver_sparse_table_binary_save,
+               false,
+               "save the checkpoints of MemorySparseTable as binary shard "
+               "files, and record the pushed keys for binary delta "
+               "checkpoints. Load reads either format");
+PD_DEFINE_bool(pserver_sparse_table_incremental_shrink,
+               false,
+               "shrink MemorySparseTable in background, slice by slice on "
+               "the threads owning the shards, instead of stopping pull and "
+               "push to scan all shards at once");
+PD_DEFINE_int32(pserver_shrink_slice_rows,
+                10000,
+                "max rows checked by one slice of the incremental shrink");
+PD_DEFINE_int32(pserver_shrink_slice_interval_ms,
+                5,
+                "pause between two slices of the incremental shrink, which "
+                "bounds the share of the shard threads it takes");
 
 namespace paddle::distributed {
 
+namespace {
+// Holds a bucket lock of a shard when shards are shared by several task
+// threads, does nothing when lock is null.
+class ShardBucketGuard {
+ public:
+  ShardBucketGuard(phi::RWLock *lock, bool write) : lock_(lock) {
+    if (lock_ == nullptr) {
+      return;
+    }
+    if (write) {
+      lock_->WRLock();
+    } else {
+      lock_->RDLock();
+    }
+  }
+  ~ShardBucketGuard() {
+    if (lock_ != nullptr) {
+      lock_->UNLock();
+    }
+  }
+
+ private:
+  phi::RWLock *lock_;
+};
+
+// A binary shard file is a header, one record per row, and a footer:
+//   header: uint64 magic, uint32 version, uint32 max value dim
+//   record: uint32 value dim, uint64 key, float value[dim]
+//   footer: uint32 kBinaryShardEndTag, uint64 row count, uint64 checksum
+// The checksum is the FNV-1a hash of the 32-bit words of all records.
+constexpr uint64_t kBinaryShardMagic = 0x314E494250534450;  // "PDSPBIN1"
+constexpr uint32_t kBinaryShardVersion = 1;
+constexpr uint32_t kBinaryShardEndTag = 0xFFFFFFFF;
+constexpr size_t kBinaryShardBufferSize = 4 * 1024 * 1024;
+
+bool IsBinaryShardFile(const std::string &path) {
+  const std::string suffix = ".bin";
+  return path.size() >= suffix.size() &&
+         path.compare(path.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+// global shard held by a file named part-<server>-<shard>[.gz|.bin]
+int ShardIdOfFile(const std::string &path) {
+  size_t name_begin = path.find_last_of('/');
+  name_begin = name_begin == std::string::npos ? 0 : name_begin + 1;
+  size_t pos = path.find_last_of('-');
+  if (pos == std::string::npos || pos < name_begin) {
+    return -1;
+  }
+  return atoi(path.c_str() + pos + 1);
+}
+
+class BinaryShardChecksum {
+ public:
+  void Update(const char *data, size_t size) {
+    for (size_t i = 0; i + sizeof(uint32_t) <= size; i += sizeof(uint32_t)) {
+      uint32_t word;
+      memcpy(&word, data + i, sizeof(uint32_t));
+      hash_ = (hash_ ^ word) * 0x100000001b3;
+    }
+  }
+  uint64_t value() const { return hash_; }
+
+ private:
+  uint64_t hash_{0xcbf29ce484222325};
+};
+
+// Streams the rows of a shard into a write channel through a buffer.
+class BinaryShardWriter {
+ public:
+  explicit BinaryShardWriter(FsWriteChannel *channel) : channel_(channel) {
+    buffer_.reserve(kBinaryShardBufferSize);
+  }
+
+  void WriteHeader(uint32_t max_dim) {
+    Append(&kBinaryShardMagic, sizeof(kBinaryShardMagic));
+    Append(&kBinaryShardVersion, sizeof(kBinaryShardVersion));
+    Append(&max_dim, sizeof(max_dim));
+  }
+
+  void WriteRecord(uint64_t key, const float *value, uint32_t dim) {
+    size_t begin = buffer_.size();
+    Append(&dim, sizeof(dim));
+    Append(&key, sizeof(key));
+    Append(value, dim * sizeof(float));
+    checksum_.Update(buffer_.data() + begin, buffer_.size() - begin);
+    ++count_;
+    if (buffer_.size() >= kBinaryShardBufferSize) {
+      Flush();
+    }
+  }
+
+  // Writes the footer, returns false if any write failed.
+  bool Finish() {
+    uint64_t checksum = checksum_.value();
+    Append(&kBinaryShardEndTag, sizeof(kBinaryShardEndTag));
+    Append(&count_, sizeof(count_));
+    Append(&checksum, sizeof(checksum));
+    Flush();
+    return ok_;
+  }
+
+  bool ok() const { return ok_; }
+  uint64_t count() const { return count_; }
+
+ private:
+  void Append(const void *data, size_t size) {
+    const char *bytes = static_cast<const char *>(data);
+    buffer_.insert(buffer_.end(), bytes, bytes + size);
+  }
+
+  void Flush() {
+    if (ok_ && !buffer_.empty() &&
+        channel_->write(buffer_.data(), buffer_.size()) != 0) {
+      ok_ = false;
+    }
+    buffer_.clear();
+  }
+
+  FsWriteChannel *channel_;
+  std::vector<char> buffer_;
+  BinaryShardChecksum checksum_;
+  uint64_t count_{0};
+  bool ok_{true};
+};
+
+class BinaryShardReader {
+ public:
+  explicit BinaryShardReader(FsReadChannel *channel) : channel_(channel) {}
+
+  bool ReadHeader(uint32_t *max_dim) {
+    uint64_t magic = 0;
+    uint32_t version = 0;
+    return Read(&magic, sizeof(magic), false) && magic == kBinaryShardMagic &&
+           Read(&version, sizeof(version), false) &&
+           version == kBinaryShardVersion &&
+           Read(max_dim, sizeof(*max_dim), false);
+  }
+
+  // Reads the dim and the key of the next record. Returns 1 for a record,
+  // 0 at a footer matching the records read, and -1 on errors.
+  int Next(uint64_t *key, uint32_t *dim) {
+    if (!Read(dim, sizeof(*dim), false)) {
+      return -1;
+    }
+    if (*dim == kBinaryShardEndTag) {
+      uint64_t count = 0;
+      uint64_t checksum = 0;
+      if (!Read(&count, sizeof(count), false) ||
+          !Read(&checksum, sizeof(checksum), false)) {
+        return -1;
+      }
+      return count == count_ && checksum == checksum_.value() ? 0 : -1;
+    }
+    checksum_.Update(reinterpret_cast<const char *>(dim), sizeof(*dim));
+    ++count_;
+    return Read(key, sizeof(*key), true) ? 1 : -1;
+  }
+
+  bool ReadValue(float *value, uint32_t dim) {
+    return Read(value, dim * sizeof(float), true);
+  }
+
+ private:
+  bool Read(void *data, size_t size, bool checked) {
+    char *bytes = static_cast<char *>(data);
+    if (channel_->read(bytes, size) != static_cast<int>(size)) {
+      return false;
+    }
+    if (checked) {
+      checksum_.Update(bytes, size);
+    }
+    return true;
+  }
+
+  FsReadChannel *channel_;
+  BinaryShardChecksum checksum_;
+  uint64_t count_{0};
+};
+
+// Collects the rows of a push that are updated in place and updates them by
+// blocks, so that the accessor runs its update rules over many rows in one
+// call and fetches the next row while it updates the current one. The value
+// data of a row stays valid until the block is flushed, since it lives in
+// the heap buffer of its FixedFeatureValue.
+class PushUpdateBlock {
+ public:
+  static constexpr size_t kMaxRows = 64;
+
+  PushUpdateBlock(ValueAccessor *accessor, size_t capacity)
+      : accessor_(accessor), capacity_(capacity) {
+    values_.reserve(capacity_);
+    pushes_.reserve(capacity_);
+  }
+
+  void Add(float *value, const float *push) {
+    values_.push_back(value);
+    pushes_.push_back(push);
+    if (values_.size() >= capacity_) {
+      Flush();
+    }
+  }
+
+  void Flush() {
+    if (values_.empty()) {
+      return;
+    }
+    accessor_->Update(values_.data(), pushes_.data(), values_.size());
+    values_.clear();
+    pushes_.clear();
+  }
+
+ private:
+  ValueAccessor *accessor_;
+  size_t capacity_;
+  std::vector<float *> values_;
+  std::vector<const float *> pushes_;
+};
+}  // namespace
+
+MemorySparseTable::~MemorySparseTable() {
+  _shrink_stop = true;
+  WaitShrinkDone();
+}
+
 int32_t MemorySparseTable::Initialize() {
   auto &profiler = CostProfiler::instance();
   profiler.register_profiler("pserver_sparse_update_all");
@@ -56,15 +312,37 @@ int32_t MemorySparseTable::Initialize() {
 
 int32_t MemorySparseTable::InitializeValue() {
   _sparse_table_shard_num = static_cast<int>(_config.shard_num());
-  _avg_local_shard_num =
-      sparse_local_shard_num(_sparse_table_shard_num, _shard_num);
-  _real_local_shard_num = _avg_local_shard_num;
-  if (static_cast<int>(_real_local_shard_num * (_shard_idx + 1)) >
-      _sparse_table_shard_num) {
-    _real_local_shard_num =
-        _sparse_table_shard_num - _real_local_shard_num * _shard_idx;
-    _real_local_shard_num =
-        _real_local_shard_num < 0 ? 0 : _real_local_shard_num;
+  _consistent_hash_shard = _config.consistent_hash_shard();
+  if (_consistent_hash_shard) {
+    PADDLE_ENFORCE_EQ(
+        _config.enable_revert() || _config.use_gpu_graph(),
+        false,
+        common::errors::InvalidArgument(
+            "consistent_hash_shard of table %d does not support "
+            "enable_revert or use_gpu_graph.",
+            _config.table_id()));
+    // a slot for every global shard, so that shards can move in and out
+    _avg_local_shard_num = _sparse_table_shard_num;
+    _real_local_shard_num = _sparse_table_shard_num;
+    uint32_t active_server_num = _config.active_server_num();
+    if (active_server_num == 0 || active_server_num > _shard_num) {
+      active_server_num = _shard_num;
+    }
+    _owned_shards.reset(new std::atomic<bool>[_sparse_table_shard_num]);
+    for (int i = 0; i < _sparse_table_shard_num; ++i) {
+      _owned_shards[i] = JumpConsistentHash(i, active_server_num) == _shard_idx;
+    }
+  } else {
+    _avg_local_shard_num =
+        sparse_local_shard_num(_sparse_table_shard_num, _shard_num);
+    _real_local_shard_num = _avg_local_shard_num;
+    if (static_cast<int>(_real_local_shard_num * (_shard_idx + 1)) >
+        _sparse_table_shard_num) {
+      _real_local_shard_num =
+          _sparse_table_shard_num - _real_local_shard_num * _shard_idx;
+      _real_local_shard_num =
+          _real_local_shard_num < 0 ? 0 : _real_local_shard_num;
+    }
   }
 #ifdef PADDLE_WITH_HETERPS
   _task_pool_size = _sparse_table_shard_num;
@@ -77,6 +355,8 @@ int32_t MemorySparseTable::InitializeValue() {
           << " _use_gpu_graph:" << _use_gpu_graph;
 
   _local_shards.reset(new shard_type[_real_local_shard_num]);
+  _touched_keys.resize(_real_local_shard_num);
+  _touched_keys_mutex.reset(new std::mutex[_real_local_shard_num]);
 
   if (_config.enable_revert()) {
     // calculate merged shard number based on config param;
@@ -122,6 +402,7 @@ int32_t MemorySparseTable::InitializeValue() {
 
 int32_t MemorySparseTable::Load(const std::string &path,
                                 const std::string &param) {
+  WaitShrinkDone();
   std::string table_path = TableDir(path);
   auto file_list = _afs_client.list(table_path);
 
@@ -145,8 +426,20 @@ int32_t MemorySparseTable::Load(const std::string &path,
   if (load_param == 5) {
     return LoadPatch(file_list, load_param);
   }
+  if (_consistent_hash_shard) {
+    // the owners of the shards are not contiguous, order the files by the
+    // global shard they hold
+    std::stable_sort(file_list.begin(),
+                     file_list.end(),
+                     [](const std::string &a, const std::string &b) {
+                       return ShardIdOfFile(a) < ShardIdOfFile(b);
+                     });
+  }
+  if (IsBinaryShardFile(file_list[0])) {
+    return LoadBinary(file_list);
+  }
 
-  size_t file_start_idx = _shard_idx * _avg_local_shard_num;
+  size_t file_start_idx = LocalShardFileStart();
 
   if (file_start_idx >= file_list.size()) {
     return 0;
@@ -166,6 +459,9 @@ int32_t MemorySparseTable::Load(const std::string &path,
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
+    if (!OwnsLocalShard(i)) {
+      continue;
+    }
     uint64_t mem_count = 0;
     uint64_t mem_mf_count = 0;
 
@@ -342,6 +638,7 @@ void MemorySparseTable::CheckSavePrePatchDone() {
 
 int32_t MemorySparseTable::Save(const std::string &dirname,
                                 const std::string &param) {
+  WaitShrinkDone();
 #if defined(PADDLE_WITH_HETERPS) && defined(PADDLE_WITH_PSCORE)
   // gpu graph mode
   if (_use_gpu_graph) {
@@ -369,6 +666,11 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
     return 0;
   }
 
+  if (save_param == PSERVER_BINARY_DELTA_SAVE_PARAM ||
+      (FLAGS_pserver_sparse_table_binary_save && save_param == 0)) {
+    return SaveBinary(dirname, save_param);
+  }
+
   // cache model
   int64_t tk_size = LocalSize() * _config.sparse_table_cache_rate();
   TopkCalculator tk(_real_local_shard_num, tk_size);
@@ -378,7 +680,7 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
       "%s/part-%03d-*", table_path.c_str(), _shard_idx));
   std::atomic<uint32_t> feasign_size_all{0};
 
-  size_t file_start_idx = _avg_local_shard_num * _shard_idx;
+  size_t file_start_idx = LocalShardFileStart();
 
 #ifdef PADDLE_WITH_HETERPS
   int thread_num = _real_local_shard_num;
@@ -388,6 +690,9 @@ int32_t MemorySparseTable::Save(const std::string &dirname,
   omp_set_num_threads(thread_num);
 #pragma omp parallel for schedule(dynamic)
   for (int i = 0; i < _real_local_shard_num; ++i) {
+    if (!OwnsLocalShard(i)) {
+      continue;
+    }
     FsChannelConfig channel_config = {};
     if (_config.compress_in_save() && (save_param == 0 || save_param == 3)) {
       channel_config.path =
@@ -682,6 +987,194 @@ int32_t MemorySparseTable::Save_v2(const std::string &dirname,
 }
 #endif
 
+int32_t MemorySparseTable::SaveBinary(const std::string &dirname,
+                                      int save_param) {
+  bool is_delta = save_param == PSERVER_BINARY_DELTA_SAVE_PARAM;
+  if (is_delta && !FLAGS_pserver_sparse_table_binary_save) {
+    LOG(WARNING) << "MemorySparseTable binary delta save needs "
+                    "FLAGS_pserver_sparse_table_binary_save to record the "
+                    "pushed keys, path:"
+                 << dirname;
+    return -1;
+  }
+  bool save_all = !is_delta || _touched_all;
+  std::string table_path = TableDir(dirname);
+  _afs_client.remove(::paddle::string::format_string(
+      "%s/part-%03d-*", table_path.c_str(), _shard_idx));
+  std::atomic<uint64_t> feasign_size_all{0};
+  size_t file_start_idx = LocalShardFileStart();
+  uint32_t max_dim = _value_accessor->GetAccessorInfo().size / sizeof(float);
+
+#ifdef PADDLE_WITH_HETERPS
+  int thread_num = _real_local_shard_num;
+#else
+  int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
+#endif
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    if (!OwnsLocalShard(i)) {
+      continue;
+    }
+    // the rows are written raw, without the converter of the text format
+    FsChannelConfig channel_config = {};
+    channel_config.path =
+        ::paddle::string::format_string("%s/part-%03d-%05d.bin",
+                                        table_path.c_str(),
+                                        _shard_idx,
+                                        file_start_idx + i);
+    // a checkpoint starts a new delta chain as well
+    std::unordered_set<uint64_t> touched_keys;
+    {
+      std::lock_guard<std::mutex> lock(_touched_keys_mutex[i]);
+      touched_keys.swap(_touched_keys[i]);
+    }
+    auto &shard = _local_shards[i];
+    bool is_write_failed = false;
+    uint64_t feasign_size = 0;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      is_write_failed = false;
+      auto write_channel =
+          _afs_client.open_w(channel_config, 1024 * 1024 * 40, &err_no);
+      BinaryShardWriter writer(write_channel.get());
+      writer.WriteHeader(max_dim);
+      auto save_row = [&](uint64_t key, FixedFeatureValue &value) {
+        if (_value_accessor->Save(value.data(), 0)) {
+          writer.WriteRecord(
+              key, value.data(), static_cast<uint32_t>(value.size()));
+        }
+      };
+      if (save_all) {
+        for (auto it = shard.begin(); it != shard.end() && writer.ok(); ++it) {
+          save_row(it.key(), it.value());
+        }
+      } else {
+        for (uint64_t key : touched_keys) {
+          auto it = shard.find(key);
+          // shrunk since pushed
+          if (it != shard.end()) {
+            save_row(key, it.value());
+          }
+          if (!writer.ok()) {
+            break;
+          }
+        }
+      }
+      is_write_failed = !writer.Finish();
+      feasign_size = writer.count();
+      write_channel->close();
+      if (is_write_failed || err_no == -1) {
+        ++retry_num;
+        is_write_failed = true;
+        LOG(ERROR) << "MemorySparseTable binary save failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+        _afs_client.remove(channel_config.path);
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable binary save failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_write_failed);
+    feasign_size_all += feasign_size;
+    LOG(INFO) << "MemorySparseTable binary save success, path: "
+              << channel_config.path << " feasign_size: " << feasign_size;
+  }
+  _touched_all = false;
+  LOG(INFO) << "MemorySparseTable binary " << (is_delta ? "delta " : "")
+            << "save success, feasign_size: " << feasign_size_all;
+  return 0;
+}
+
+int32_t MemorySparseTable::LoadBinary(
+    const std::vector<std::string> &file_list) {
+  size_t file_start_idx = LocalShardFileStart();
+  if (file_start_idx >= file_list.size()) {
+    return 0;
+  }
+  uint32_t feature_value_size =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  uint32_t mf_value_size =
+      _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
+
+#ifdef PADDLE_WITH_HETERPS
+  int thread_num = _real_local_shard_num;
+#else
+  int thread_num = _real_local_shard_num < 15 ? _real_local_shard_num : 15;
+#endif
+  omp_set_num_threads(thread_num);
+#pragma omp parallel for schedule(dynamic)
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    if (!OwnsLocalShard(i)) {
+      continue;
+    }
+    uint64_t mem_count = 0;
+    uint64_t mem_mf_count = 0;
+    FsChannelConfig channel_config = {};
+    channel_config.path = file_list[file_start_idx + i];
+    VLOG(1) << "MemorySparseTable::LoadBinary begin load "
+            << channel_config.path << " into local shard " << i;
+
+    bool is_read_failed = false;
+    int retry_num = 0;
+    int err_no = 0;
+    do {
+      err_no = 0;
+      mem_count = 0;
+      mem_mf_count = 0;
+      auto read_channel = _afs_client.open_r(channel_config, 0, &err_no);
+      BinaryShardReader reader(read_channel.get());
+      auto &shard = _local_shards[i];
+      uint32_t max_dim = 0;
+      int status = reader.ReadHeader(&max_dim) && max_dim == feature_value_size
+                       ? 1
+                       : -1;
+      uint64_t key = 0;
+      uint32_t dim = 0;
+      while (status == 1 && (status = reader.Next(&key, &dim)) == 1) {
+        if (dim > feature_value_size) {
+          status = -1;
+          break;
+        }
+        auto &value = shard[key];
+        value.resize(dim);
+        if (!reader.ReadValue(value.data(), dim)) {
+          status = -1;
+          break;
+        }
+        ++mem_count;
+        if (dim > feature_value_size - mf_value_size) {
+          ++mem_mf_count;
+        }
+      }
+      read_channel->close();
+      is_read_failed = status != 0 || err_no == -1;
+      if (is_read_failed) {
+        ++retry_num;
+        LOG(ERROR) << "MemorySparseTable binary load failed, retry it! path:"
+                   << channel_config.path << " , retry_num=" << retry_num;
+      }
+      if (retry_num > FLAGS_pserver_table_save_max_retry) {
+        LOG(ERROR) << "MemorySparseTable binary load failed reach max limit!";
+        exit(-1);
+      }
+    } while (is_read_failed);
+    VLOG(0) << "Table>> binary load done. MEM[" << mem_count << "] MEM_MF["
+            << mem_mf_count << "]";
+  }
+  LOG(INFO) << "MemorySparseTable binary load success, path from "
+            << file_list[file_start_idx] << " to "
+            << file_list[file_start_idx + _real_local_shard_num - 1];
+  return 0;
+}
+
+void MemorySparseTable::MarkTouched(int shard_id, uint64_t key) {
+  std::lock_guard<std::mutex> lock(_touched_keys_mutex[shard_id]);
+  _touched_keys[shard_id].insert(key);
+}
+
 int32_t MemorySparseTable::SavePatch(const std::string &path, int save_param) {
   if (!_config.enable_revert()) {
     LOG(INFO) << "MemorySparseTable should be enabled revert.";
@@ -1010,10 +1503,35 @@ int32_t MemorySparseTable::Push(TableContext &context) {
   }
 }
 
+std::vector<MemorySparseTable::ShardTask> MemorySparseTable::SplitShardTasks(
+    const std::vector<std::vector<std::pair<uint64_t, int>>> &task_keys) {
+  std::vector<ShardTask> shard_tasks;
+  size_t pool_size = _shards_task_pool.size();
+  size_t chunk_size = std::max<int32_t>(FLAGS_pserver_shard_task_chunk_size, 1);
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    size_t num = task_keys[shard_id].size();
+    if (num == 0) {
+      continue;
+    }
+    if (!FLAGS_pserver_sparse_table_concurrent_shard || num <= chunk_size) {
+      shard_tasks.push_back({shard_id, 0, num, shard_id % pool_size});
+      continue;
+    }
+    // spread the chunks of a hot shard over the threads of its neighbors
+    for (size_t begin = 0, chunk = 0; begin < num;
+         begin += chunk_size, ++chunk) {
+      shard_tasks.push_back({shard_id,
+                             begin,
+                             std::min(begin + chunk_size, num),
+                             (shard_id + chunk) % pool_size});
+    }
+  }
+  return shard_tasks;
+}
+
 int32_t MemorySparseTable::PullSparse(float *pull_values,
                                       const PullSparseValue &pull_value) {
   CostTimer timer("pserver_sparse_select_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
 
   const size_t value_size =
       _value_accessor->GetAccessorInfo().size / sizeof(float);
@@ -1031,54 +1549,75 @@ int32_t MemorySparseTable::PullSparse(float *pull_values,
                    _avg_local_shard_num;
     task_keys[shard_id].push_back({pull_value.feasigns_[i], i});
   }
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-            [this,
-             shard_id,
-             &task_keys,
-             value_size,
-             pull_values,
-             mf_value_size,
-             select_value_size]() -> int {
-              auto &local_shard = _local_shards[shard_id];
-              float data_buffer[value_size];  // NOLINT
-              float *data_buffer_ptr = data_buffer;
-
-              auto &keys = task_keys[shard_id];
-              for (auto &item : keys) {
-                uint64_t key = item.first;
-                auto itr = local_shard.find(key);
-                size_t data_size = value_size - mf_value_size;
-                if (itr == local_shard.end()) {
-                  // ++missed_keys;
-                  if (FLAGS_pserver_create_value_when_push) {
-                    memset(data_buffer, 0, sizeof(float) * data_size);
-                  } else {
-                    auto &feature_value = local_shard[key];
-                    feature_value.resize(data_size);
-                    float *data_ptr = feature_value.data();
-                    _value_accessor->Create(&data_buffer_ptr, 1);
-                    memcpy(
-                        data_ptr, data_buffer_ptr, data_size * sizeof(float));
-                  }
+  std::vector<ShardTask> shard_tasks = SplitShardTasks(task_keys);
+  std::vector<std::future<int>> tasks(shard_tasks.size());
+  for (size_t task_id = 0; task_id < shard_tasks.size(); ++task_id) {
+    const ShardTask &shard_task = shard_tasks[task_id];
+    tasks[task_id] = _shards_task_pool[shard_task.pool_idx]->enqueue(
+        [this,
+         shard_task,
+         &task_keys,
+         value_size,
+         pull_values,
+         mf_value_size,
+         select_value_size]() -> int {
+          auto &local_shard = _local_shards[shard_task.shard_id];
+          bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+          float data_buffer[value_size];  // NOLINT
+          float *data_buffer_ptr = data_buffer;
+
+          auto &keys = task_keys[shard_task.shard_id];
+          for (size_t k = shard_task.begin; k < shard_task.end; ++k) {
+            auto &item = keys[k];
+            uint64_t key = item.first;
+            phi::RWLock *lock =
+                concurrent ? local_shard.bucket_lock(key) : nullptr;
+            size_t data_size = value_size - mf_value_size;
+            bool found = false;
+            {
+              ShardBucketGuard guard(lock, /*write=*/false);
+              auto itr = local_shard.find(key);
+              if (itr != local_shard.end()) {
+                found = true;
+                data_size = itr.value().size();
+                memcpy(data_buffer_ptr,
+                       itr.value().data(),
+                       data_size * sizeof(float));
+              }
+            }
+            if (!found) {
+              // ++missed_keys;
+              if (FLAGS_pserver_create_value_when_push) {
+                memset(data_buffer, 0, sizeof(float) * data_size);
+              } else {
+                ShardBucketGuard guard(lock, /*write=*/true);
+                auto res = local_shard.emplace(key);
+                auto &feature_value = res.first.value();
+                if (res.second) {
+                  feature_value.resize(data_size);
+                  float *data_ptr = feature_value.data();
+                  _value_accessor->Create(&data_buffer_ptr, 1);
+                  memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
                 } else {
-                  data_size = itr.value().size();
+                  // created by another thread after the lookup above
+                  data_size = feature_value.size();
                   memcpy(data_buffer_ptr,
-                         itr.value().data(),
+                         feature_value.data(),
                          data_size * sizeof(float));
                 }
-                for (size_t mf_idx = data_size; mf_idx < value_size; ++mf_idx) {
-                  data_buffer[mf_idx] = 0.0;
-                }
-                auto offset = item.second;
-                float *select_data = pull_values + select_value_size * offset;
-                _value_accessor->Select(
-                    &select_data, (const float **)&data_buffer_ptr, 1);
               }
+            }
+            for (size_t mf_idx = data_size; mf_idx < value_size; ++mf_idx) {
+              data_buffer[mf_idx] = 0.0;
+            }
+            auto offset = item.second;
+            float *select_data = pull_values + select_value_size * offset;
+            _value_accessor->Select(
+                &select_data, (const float **)&data_buffer_ptr, 1);
+          }
 
-              return 0;
-            });
+          return 0;
+        });
   }
 
   for (auto &task : tasks) {
@@ -1097,7 +1636,6 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
   size_t mf_value_size =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
 
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1105,40 +1643,53 @@ int32_t MemorySparseTable::PullSparsePtr(int shard_id,  // fake num
     task_keys[shard_id].push_back({keys[i], i});
   }
   // std::atomic<uint32_t> missed_keys{0};
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] =
-        _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
-            [this,
-             shard_id,
-             &task_keys,
-             pull_values,
-             value_size,
-             mf_value_size]() -> int {
-              auto &keys = task_keys[shard_id];
-              auto &local_shard = _local_shards[shard_id];
-              float data_buffer[value_size];  // NOLINT
-              float *data_buffer_ptr = data_buffer;
-              for (auto &item : keys) {
-                uint64_t key = item.first;
-                auto itr = local_shard.find(key);
-                size_t data_size = value_size - mf_value_size;
-                FixedFeatureValue *ret = NULL;
-                if (itr == local_shard.end()) {
-                  // ++missed_keys;
-                  auto &feature_value = local_shard[key];
-                  feature_value.resize(data_size);
-                  float *data_ptr = feature_value.data();
-                  _value_accessor->Create(&data_buffer_ptr, 1);
-                  memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
-                  ret = &feature_value;
-                } else {
-                  ret = itr.value_ptr();
-                }
-                int pull_data_idx = item.second;
-                pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
+  std::vector<ShardTask> shard_tasks = SplitShardTasks(task_keys);
+  std::vector<std::future<int>> tasks(shard_tasks.size());
+  for (size_t task_id = 0; task_id < shard_tasks.size(); ++task_id) {
+    const ShardTask &shard_task = shard_tasks[task_id];
+    tasks[task_id] = _shards_task_pool[shard_task.pool_idx]->enqueue(
+        [this,
+         shard_task,
+         &task_keys,
+         pull_values,
+         value_size,
+         mf_value_size]() -> int {
+          auto &keys = task_keys[shard_task.shard_id];
+          auto &local_shard = _local_shards[shard_task.shard_id];
+          bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+          float data_buffer[value_size];  // NOLINT
+          float *data_buffer_ptr = data_buffer;
+          for (size_t k = shard_task.begin; k < shard_task.end; ++k) {
+            auto &item = keys[k];
+            uint64_t key = item.first;
+            phi::RWLock *lock =
+                concurrent ? local_shard.bucket_lock(key) : nullptr;
+            size_t data_size = value_size - mf_value_size;
+            FixedFeatureValue *ret = NULL;
+            {
+              ShardBucketGuard guard(lock, /*write=*/false);
+              auto itr = local_shard.find(key);
+              if (itr != local_shard.end()) {
+                ret = itr.value_ptr();
               }
-              return 0;
-            });
+            }
+            if (ret == NULL) {
+              // ++missed_keys;
+              ShardBucketGuard guard(lock, /*write=*/true);
+              auto res = local_shard.emplace(key);
+              ret = res.first.value_ptr();
+              if (res.second) {
+                ret->resize(data_size);
+                float *data_ptr = ret->data();
+                _value_accessor->Create(&data_buffer_ptr, 1);
+                memcpy(data_ptr, data_buffer_ptr, data_size * sizeof(float));
+              }
+            }
+            int pull_data_idx = item.second;
+            pull_values[pull_data_idx] = reinterpret_cast<char *>(ret);
+          }
+          return 0;
+        });
   }
   for (auto &task : tasks) {
     task.wait();
@@ -1150,7 +1701,6 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float *values,
                                       size_t num) {
   CostTimer timer("pserver_sparse_update_all");
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1165,25 +1715,39 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
   size_t update_value_col =
       _value_accessor->GetAccessorInfo().update_size / sizeof(float);
 
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
+  std::vector<ShardTask> shard_tasks = SplitShardTasks(task_keys);
+  std::vector<std::future<int>> tasks(shard_tasks.size());
+  for (size_t task_id = 0; task_id < shard_tasks.size(); ++task_id) {
+    const ShardTask &shard_task = shard_tasks[task_id];
+    tasks[task_id] = _shards_task_pool[shard_task.pool_idx]->enqueue(
         [this,
-         shard_id,
+         shard_task,
          value_col,
          mf_value_col,
          update_value_col,
          values,
          &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
-          auto &local_shard_new = _local_shards_new[shard_id];
+          auto &keys = task_keys[shard_task.shard_id];
+          auto &local_shard = _local_shards[shard_task.shard_id];
+          auto &local_shard_new = _local_shards_new[shard_task.shard_id];
+          bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
+          // rows are updated one by one under the bucket locks, or when the
+          // updated row is copied for revert right after
+          PushUpdateBlock block(_value_accessor.get(),
+                                concurrent || _config.enable_revert()
+                                    ? 1
+                                    : PushUpdateBlock::kMaxRows);
+          for (size_t k = shard_task.begin; k < shard_task.end; ++k) {
+            auto &item = keys[k];
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
             const float *update_data =
                 values + push_data_idx * update_value_col;
+            ShardBucketGuard guard(
+                concurrent ? local_shard.bucket_lock(key) : nullptr,
+                /*write=*/true);
             auto itr = local_shard.find(key);
             if (itr == local_shard.end()) {
               if (FLAGS_pserver_enable_create_feasign_randomly &&
@@ -1205,9 +1769,10 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             size_t value_size = feature_value.size();
 
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
+              block.Add(value_data, update_data);
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+              block.Flush();
               memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
               _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
 
@@ -1218,7 +1783,13 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               }
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
+            if (FLAGS_pserver_sparse_table_binary_save) {
+              MarkTouched(shard_task.shard_id, key);
+            }
             if (_config.enable_revert()) {
+              ShardBucketGuard new_guard(
+                  concurrent ? local_shard_new.bucket_lock(key) : nullptr,
+                  /*write=*/true);
               FixedFeatureValue *feature_value_new = &(local_shard_new[key]);
               auto new_size = feature_value.size();
               feature_value_new->resize(new_size);
@@ -1227,6 +1798,7 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                      new_size * sizeof(float));
             }
           }
+          block.Flush();
           return 0;
         });
   }
@@ -1240,7 +1812,6 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
 int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
                                       const float **values,
                                       size_t num) {
-  std::vector<std::future<int>> tasks(_real_local_shard_num);
   std::vector<std::vector<std::pair<uint64_t, int>>> task_keys(
       _real_local_shard_num);
   for (size_t i = 0; i < num; ++i) {
@@ -1252,17 +1823,28 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
   size_t mf_value_col =
       _value_accessor->GetAccessorInfo().mf_size / sizeof(float);
 
-  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
-    tasks[shard_id] = _shards_task_pool[shard_id % _task_pool_size]->enqueue(
-        [this, shard_id, value_col, mf_value_col, values, &task_keys]() -> int {
-          auto &keys = task_keys[shard_id];
-          auto &local_shard = _local_shards[shard_id];
+  std::vector<ShardTask> shard_tasks = SplitShardTasks(task_keys);
+  std::vector<std::future<int>> tasks(shard_tasks.size());
+  for (size_t task_id = 0; task_id < shard_tasks.size(); ++task_id) {
+    const ShardTask &shard_task = shard_tasks[task_id];
+    tasks[task_id] = _shards_task_pool[shard_task.pool_idx]->enqueue(
+        [this, shard_task, value_col, mf_value_col, values, &task_keys]()
+            -> int {
+          auto &keys = task_keys[shard_task.shard_id];
+          auto &local_shard = _local_shards[shard_task.shard_id];
+          bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
           float data_buffer[value_col];  // NOLINT
           float *data_buffer_ptr = data_buffer;
-          for (auto &item : keys) {
+          PushUpdateBlock block(_value_accessor.get(),
+                                concurrent ? 1 : PushUpdateBlock::kMaxRows);
+          for (size_t k = shard_task.begin; k < shard_task.end; ++k) {
+            auto &item = keys[k];
             uint64_t key = item.first;
             uint64_t push_data_idx = item.second;
             const float *update_data = values[push_data_idx];
+            ShardBucketGuard guard(
+                concurrent ? local_shard.bucket_lock(key) : nullptr,
+                /*write=*/true);
             auto itr = local_shard.find(key);
             if (itr == local_shard.end()) {
               if (FLAGS_pserver_enable_create_feasign_randomly &&
@@ -1282,9 +1864,10 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
             float *value_data = feature_value.data();
             size_t value_size = feature_value.size();
             if (value_size == value_col) {  // 已拓展到最大size, 则就地update
-              _value_accessor->Update(&value_data, &update_data, 1);
+              block.Add(value_data, update_data);
             } else {
               // 拷入buffer区进行update，然后再回填，不需要的mf则回填时抛弃了
+              block.Flush();
               memcpy(data_buffer_ptr, value_data, value_size * sizeof(float));
               _value_accessor->Update(&data_buffer_ptr, &update_data, 1);
               if (_value_accessor->NeedExtendMF(data_buffer)) {
@@ -1294,7 +1877,11 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
               }
               memcpy(value_data, data_buffer_ptr, value_size * sizeof(float));
             }
+            if (FLAGS_pserver_sparse_table_binary_save) {
+              MarkTouched(shard_task.shard_id, key);
+            }
           }
+          block.Flush();
           return 0;
         });
   }
@@ -1308,6 +1895,25 @@ int32_t MemorySparseTable::PushSparse(const uint64_t *keys,
 int32_t MemorySparseTable::Flush() { return 0; }
 
 int32_t MemorySparseTable::Shrink(const std::string &param) {
+  if (FLAGS_pserver_sparse_table_incremental_shrink) {
+    std::lock_guard<std::mutex> lock(_shrink_mutex);
+    if (_shrink_running) {
+      LOG(WARNING) << "MemorySparseTable::Shrink skipped, the last shrink is "
+                      "still running";
+      return 0;
+    }
+    if (_shrink_thread.joinable()) {
+      _shrink_thread.join();
+    }
+    // the decayed rows all go into the next binary delta
+    _touched_all = FLAGS_pserver_sparse_table_binary_save;
+    _shrink_running = true;
+    _shrink_thread = std::thread([this]() {
+      ShrinkIncrementally();
+      _shrink_running = false;
+    });
+    return 0;
+  }
   VLOG(0) << "MemorySparseTable::Shrink";
   std::atomic<uint32_t> shrink_size_all{0};
   int thread_num = _real_local_shard_num;
@@ -1317,6 +1923,13 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     // Shrink
     int feasign_size = 0;
     auto &shard = _local_shards[shard_id];
+    if (!OwnsLocalShard(shard_id)) {
+      // rows pushed by clients routing with a stale owner
+      feasign_size = shard.size();
+      shard.clear();
+      shrink_size_all += feasign_size;
+      continue;
+    }
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accessor->Shrink(it.value().data())) {
         it = shard.erase(it);
@@ -1327,11 +1940,190 @@ int32_t MemorySparseTable::Shrink(const std::string &param) {
     }
     shrink_size_all += feasign_size;
   }
+  // the decayed rows all go into the next binary delta
+  _touched_all = FLAGS_pserver_sparse_table_binary_save;
   VLOG(0) << "MemorySparseTable::Shrink success, shrink size:"
           << shrink_size_all;
   return 0;
 }
 
+void MemorySparseTable::ShrinkIncrementally() {
+  VLOG(0) << "MemorySparseTable::Shrink incrementally";
+  const size_t slice_rows =
+      std::max<int32_t>(FLAGS_pserver_shrink_slice_rows, 1);
+  const auto interval = std::chrono::milliseconds(
+      std::max<int32_t>(FLAGS_pserver_shrink_slice_interval_ms, 0));
+  const bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+  size_t shrink_size_all = 0;
+  for (int shard_id = 0; shard_id < _real_local_shard_num && !_shrink_stop;
+       ++shard_id) {
+    auto &shard = _local_shards[shard_id];
+    auto &pool = _shards_task_pool[shard_id % _shards_task_pool.size()];
+    for (size_t bucket = 0; bucket < shard.bucket_count() && !_shrink_stop;
+         ++bucket) {
+      // the keys of the bucket when the shrink gets there, the rows created
+      // later are fresh and kept
+      std::vector<uint64_t> keys =
+          pool->enqueue([&shard, bucket, concurrent]() {
+                std::vector<uint64_t> keys;
+                ShardBucketGuard guard(
+                    concurrent ? shard.bucket_lock_at(bucket) : nullptr,
+                    /*write=*/false);
+                keys.reserve(shard.bucket_size(bucket));
+                for (auto it = shard.begin(bucket); it != shard.end(bucket);
+                     ++it) {
+                  keys.push_back(it.key());
+                }
+                return keys;
+              })
+              .get();
+      // the rows are looked up again, since the bucket may be rehashed by
+      // the pushes between two slices
+      auto shrink_slice = [this, &shard, &keys, bucket, concurrent](
+                              size_t begin, size_t end) -> size_t {
+        ShardBucketGuard guard(
+            concurrent ? shard.bucket_lock_at(bucket) : nullptr,
+            /*write=*/true);
+        size_t shrink_size = 0;
+        for (size_t i = begin; i < end; ++i) {
+          auto it = shard.find(keys[i]);
+          if (it != shard.end() && _value_accessor->Shrink(it.value().data())) {
+            shard.quick_erase(it);
+            ++shrink_size;
+          }
+        }
+        return shrink_size;
+      };
+      for (size_t begin = 0; begin < keys.size() && !_shrink_stop;
+           begin += slice_rows) {
+        size_t end = std::min(begin + slice_rows, keys.size());
+        shrink_size_all += pool->enqueue(shrink_slice, begin, end).get();
+        std::this_thread::sleep_for(interval);
+      }
+    }
+  }
+  VLOG(0) << "MemorySparseTable::Shrink incrementally "
+          << (_shrink_stop ? "stopped" : "success")
+          << ", shrink size:" << shrink_size_all;
+}
+
+void MemorySparseTable::WaitShrinkDone() {
+  std::lock_guard<std::mutex> lock(_shrink_mutex);
+  if (_shrink_thread.joinable()) {
+    _shrink_thread.join();
+  }
+}
+
+int32_t MemorySparseTable::ExportShard(uint32_t shard_id,
+                                       uint32_t part,
+                                       std::string *data) {
+  if (!_consistent_hash_shard ||
+      shard_id >= static_cast<uint32_t>(_real_local_shard_num) ||
+      part >= _local_shards[shard_id].bucket_count()) {
+    LOG(WARNING) << "MemorySparseTable can not export part " << part
+                 << " of shard " << shard_id
+                 << ", consistent_hash_shard: " << _consistent_hash_shard;
+    return -1;
+  }
+  auto &shard = _local_shards[shard_id];
+  auto &pool = _shards_task_pool[shard_id % _shards_task_pool.size()];
+  const bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+  // a part is a bucket, written as the records of the binary shard files
+  pool->enqueue([&shard, part, concurrent, data]() {
+        ShardBucketGuard guard(
+            concurrent ? shard.bucket_lock_at(part) : nullptr,
+            /*write=*/false);
+        data->clear();
+        for (auto it = shard.begin(part); it != shard.end(part); ++it) {
+          uint32_t dim = static_cast<uint32_t>(it.value().size());
+          uint64_t key = it.key();
+          data->append(reinterpret_cast<const char *>(&dim), sizeof(dim));
+          data->append(reinterpret_cast<const char *>(&key), sizeof(key));
+          data->append(reinterpret_cast<const char *>(it.value().data()),
+                       dim * sizeof(float));
+        }
+      })
+      .wait();
+  return part + 1 < shard.bucket_count() ? 1 : 0;
+}
+
+int32_t MemorySparseTable::ImportShard(uint32_t shard_id,
+                                       const char *data,
+                                       size_t size) {
+  if (!_consistent_hash_shard ||
+      shard_id >= static_cast<uint32_t>(_real_local_shard_num)) {
+    LOG(WARNING) << "MemorySparseTable can not import shard " << shard_id
+                 << ", consistent_hash_shard: " << _consistent_hash_shard;
+    return -1;
+  }
+  _owned_shards[shard_id] = true;
+  // the moved rows all go into the next binary delta
+  _touched_all = FLAGS_pserver_sparse_table_binary_save;
+  auto &shard = _local_shards[shard_id];
+  auto &pool = _shards_task_pool[shard_id % _shards_task_pool.size()];
+  const bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+  const size_t value_size =
+      _value_accessor->GetAccessorInfo().size / sizeof(float);
+  int32_t ret =
+      pool->enqueue([&shard, data, size, value_size, concurrent]() -> int32_t {
+            size_t offset = 0;
+            while (offset < size) {
+              uint32_t dim = 0;
+              uint64_t key = 0;
+              if (offset + sizeof(dim) + sizeof(key) > size) {
+                return -1;
+              }
+              memcpy(&dim, data + offset, sizeof(dim));
+              memcpy(&key, data + offset + sizeof(dim), sizeof(key));
+              offset += sizeof(dim) + sizeof(key);
+              if (dim > value_size || offset + dim * sizeof(float) > size) {
+                return -1;
+              }
+              ShardBucketGuard guard(
+                  concurrent ? shard.bucket_lock(key) : nullptr,
+                  /*write=*/true);
+              auto &value = shard[key];
+              value.resize(dim);
+              memcpy(value.data(), data + offset, dim * sizeof(float));
+              offset += dim * sizeof(float);
+            }
+            return 0;
+          })
+          .get();
+  if (ret != 0) {
+    LOG(ERROR) << "MemorySparseTable import shard " << shard_id
+               << " failed, the data is not in format";
+  }
+  return ret;
+}
+
+int32_t MemorySparseTable::DropShard(uint32_t shard_id) {
+  if (!_consistent_hash_shard ||
+      shard_id >= static_cast<uint32_t>(_real_local_shard_num)) {
+    LOG(WARNING) << "MemorySparseTable can not drop shard " << shard_id
+                 << ", consistent_hash_shard: " << _consistent_hash_shard;
+    return -1;
+  }
+  _owned_shards[shard_id] = false;
+  auto &shard = _local_shards[shard_id];
+  auto &pool = _shards_task_pool[shard_id % _shards_task_pool.size()];
+  const bool concurrent = FLAGS_pserver_sparse_table_concurrent_shard;
+  pool->enqueue([&shard, concurrent]() {
+        for (size_t bucket = 0; concurrent && bucket < shard.bucket_count();
+             ++bucket) {
+          shard.bucket_lock_at(bucket)->WRLock();
+        }
+        shard.clear();
+        for (size_t bucket = 0; concurrent && bucket < shard.bucket_count();
+             ++bucket) {
+          shard.bucket_lock_at(bucket)->UNLock();
+        }
+      })
+      .wait();
+  VLOG(0) << "MemorySparseTable dropped shard " << shard_id;
+  return 0;
+}
+
 void MemorySparseTable::Clear() { VLOG(0) << "clear coming soon"; }
 
 }  // namespace paddle::distributed
@@ -18,10 +18,13 @@
 #include <assert.h>
 #include <pthread.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -32,6 +35,9 @@
 #include "paddle/utils/string/string_helper.h"
 
 #define PSERVER_SAVE_SUFFIX ".shard"
+// save_param of a binary delta checkpoint, which holds the rows pushed since
+// the last binary checkpoint or delta.
+#define PSERVER_BINARY_DELTA_SAVE_PARAM 6
 
 namespace paddle {
 namespace distributed {
@@ -40,7 +46,7 @@ class MemorySparseTable : public Table {
  public:
   typedef SparseTableShard<uint64_t, FixedFeatureValue> shard_type;
   MemorySparseTable() {}
-  virtual ~MemorySparseTable() {}
+  virtual ~MemorySparseTable();
 
   // unused method end
   static int32_t sparse_local_shard_num(uint32_t shard_num,
@@ -105,12 +111,23 @@ class MemorySparseTable : public Table {
 
   int32_t Flush() override;
   int32_t Shrink(const std::string& param) override;
+  // Waits for the shrink running in background, see
+  // FLAGS_pserver_sparse_table_incremental_shrink.
+  void WaitShrinkDone();
   void Clear() override;
 
   void* GetShard(size_t shard_idx) override {
     return &_local_shards[shard_idx];
   }
 
+  int32_t ExportShard(uint32_t shard_id,
+                      uint32_t part,
+                      std::string* data) override;
+  int32_t ImportShard(uint32_t shard_id,
+                      const char* data,
+                      size_t size) override;
+  int32_t DropShard(uint32_t shard_id) override;
+
   virtual void Revert();
   virtual void CheckSavePrePatchDone();
 
@@ -118,6 +135,37 @@ class MemorySparseTable : public Table {
   virtual int32_t SavePatch(const std::string& path, int save_param);
   virtual int32_t LoadPatch(const std::vector<std::string>& file_list,
                             int save_param);
+  // Writes each local shard into one binary file, see
+  // FLAGS_pserver_sparse_table_binary_save.
+  virtual int32_t SaveBinary(const std::string& path, int save_param);
+  virtual int32_t LoadBinary(const std::vector<std::string>& file_list);
+  // Records a pushed key for the next binary delta checkpoint.
+  void MarkTouched(int shard_id, uint64_t key);
+  // With consistent_hash_shard every global shard has a local slot, of which
+  // only the owned ones are saved and loaded.
+  bool OwnsLocalShard(int shard_id) const {
+    return !_consistent_hash_shard || _owned_shards[shard_id];
+  }
+  // global index of the first local shard, which names the shard files
+  size_t LocalShardFileStart() const {
+    return _consistent_hash_shard ? 0 : _avg_local_shard_num * _shard_idx;
+  }
+  // Shrinks the shards slice by slice on the threads owning them, so that
+  // pull and push keep running between the slices.
+  void ShrinkIncrementally();
+
+  // A slice [begin, end) of the keys of one shard, run on a task pool thread.
+  struct ShardTask {
+    int shard_id;
+    size_t begin;
+    size_t end;
+    size_t pool_idx;
+  };
+  // One task per shard on the thread owning it. When
+  // FLAGS_pserver_sparse_table_concurrent_shard is on, shards with many keys
+  // are split into chunks spread over several threads.
+  std::vector<ShardTask> SplitShardTasks(
+      const std::vector<std::vector<std::pair<uint64_t, int>>>& task_keys);
 
   int _task_pool_size = 24;
   int _avg_local_shard_num;
@@ -137,6 +185,23 @@ class MemorySparseTable : public Table {
   std::unique_ptr<shard_type[]> _local_shards_patch_model;
   std::thread _save_patch_model_thread;
   bool _use_gpu_graph = false;
+
+  // for binary delta checkpoints, the keys pushed into each local shard since
+  // the last binary save, all rows are saved after a shrink decayed them
+  std::vector<std::unordered_set<uint64_t>> _touched_keys;
+  std::unique_ptr<std::mutex[]> _touched_keys_mutex;
+  bool _touched_all{false};
+
+  // for incremental shrink
+  std::thread _shrink_thread;
+  std::mutex _shrink_mutex;
+  std::atomic<bool> _shrink_running{false};
+  std::atomic<bool> _shrink_stop{false};
+
+  // for consistent hash shard placement, whether this server owns each
+  // global shard
+  bool _consistent_hash_shard{false};
+  std::unique_ptr<std::atomic<bool>[]> _owned_shards;
 };
 
 }  // namespace distributed
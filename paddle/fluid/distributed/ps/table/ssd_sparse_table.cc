@@ -25,6 +25,18 @@ PD_DECLARE_bool(pserver_create_value_when_push);
 PD_DECLARE_bool(pserver_enable_create_feasign_randomly);
 PD_DEFINE_bool(pserver_open_strict_check, false, "pserver_open_strict_check");
 PD_DEFINE_int32(pserver_load_batch_size, 5000, "load batch size for ssd");
+PD_DEFINE_int32(pserver_ssd_prefetch_thread_num,
+                4,
+                "number of threads reading prefetched keys from rocksdb");
+PD_DEFINE_int32(pserver_ssd_prefetch_max_inflight,
+                64,
+                "max pending prefetch batches, more prefetch requests are "
+                "dropped until the pending ones are installed");
+PD_DEFINE_int64(pserver_ssd_mem_keys_per_shard,
+                0,
+                "max rows kept in memory per shard on UpdateTable, rows with "
+                "the lowest show/click score are spilled to rocksdb, 0 means "
+                "no limit");
 PHI_DEFINE_EXPORTED_string(rocksdb_path,
                            "database",
                            "path of sparse table rocksdb file");
@@ -35,6 +47,14 @@ int32_t SSDSparseTable::Initialize() {
   MemorySparseTable::Initialize();
   _db = ::paddle::distributed::RocksDBHandler::GetInstance();
   _db->initialize(FLAGS_rocksdb_path, _real_local_shard_num);
+  _spill_epoch.reset(new std::atomic<uint64_t>[_real_local_shard_num]);
+  for (int i = 0; i < _real_local_shard_num; ++i) {
+    _spill_epoch[i] = 0;
+  }
+  _prefetch_pool.resize(FLAGS_pserver_ssd_prefetch_thread_num);
+  for (auto& prefetch_task : _prefetch_pool) {
+    prefetch_task.reset(new ::ThreadPool(1));
+  }
   VLOG(0) << "initialize SSDSparseTable succ";
   VLOG(0) << "SSD FLAGS_pserver_print_missed_key_num_every_push:"
           << FLAGS_pserver_print_missed_key_num_every_push;
@@ -529,6 +549,124 @@ int32_t SSDSparseTable::PushSparse(const uint64_t* keys,
   return 0;
 }
 
+int32_t SSDSparseTable::Prefetch(const uint64_t* keys, size_t num) {
+  if (_prefetch_pool.empty() || num == 0) {
+    return 0;
+  }
+  auto task_keys = std::make_shared<std::vector<std::vector<uint64_t>>>(
+      _real_local_shard_num);
+  for (size_t i = 0; i < num; ++i) {
+    int shard_id = (keys[i] % _sparse_table_shard_num) % _avg_local_shard_num;
+    (*task_keys)[shard_id].push_back(keys[i]);
+  }
+
+  for (int shard_id = 0; shard_id < _real_local_shard_num; ++shard_id) {
+    auto& shard_keys = (*task_keys)[shard_id];
+    if (shard_keys.empty()) {
+      continue;
+    }
+    if (_prefetch_inflight.load() >= FLAGS_pserver_ssd_prefetch_max_inflight) {
+      VLOG(3) << "SSDSparseTable prefetch backlog full, drop "
+              << shard_keys.size() << " keys of shard " << shard_id;
+      continue;
+    }
+    ++_prefetch_inflight;
+    std::sort(shard_keys.begin(), shard_keys.end());
+    shard_keys.erase(std::unique(shard_keys.begin(), shard_keys.end()),
+                     shard_keys.end());
+    uint64_t epoch = _spill_epoch[shard_id].load();
+    // read on the prefetch pool so the shard thread keeps serving pulls,
+    // then install on the shard thread which owns the memory shard
+    _prefetch_pool[shard_id % _prefetch_pool.size()]->enqueue(
+        [this, shard_id, epoch, task_keys]() -> int {
+          auto& shard_keys = (*task_keys)[shard_id];
+          auto item = std::make_shared<RocksDBItem>();
+          for (auto& key : shard_keys) {
+            item->batch_keys.emplace_back(reinterpret_cast<const char*>(&key),
+                                          sizeof(uint64_t));
+          }
+          item->batch_values.resize(item->batch_keys.size());
+          item->status.resize(item->batch_keys.size());
+          _db->multi_get(shard_id,
+                         item->batch_keys.size(),
+                         item->batch_keys.data(),
+                         item->batch_values.data(),
+                         item->status.data(),
+                         false);
+          _shards_task_pool[shard_id % _shards_task_pool.size()]->enqueue(
+              [this, shard_id, epoch, task_keys, item]() -> int {
+                auto& shard_keys = (*task_keys)[shard_id];
+                auto& local_shard = _local_shards[shard_id];
+                size_t installed = 0;
+                if (_spill_epoch[shard_id].load() == epoch) {
+                  for (size_t i = 0; i < shard_keys.size(); ++i) {
+                    if (!item->status[i].ok()) {
+                      continue;
+                    }
+                    uint64_t key = shard_keys[i];
+                    // pulled or created since the read, memory is newer
+                    if (local_shard.find(key) != local_shard.end()) {
+                      continue;
+                    }
+                    size_t data_size =
+                        item->batch_values[i].size() / sizeof(float);
+                    auto& feature_value = local_shard[key];
+                    feature_value.resize(data_size);
+                    memcpy(const_cast<float*>(feature_value.data()),
+                           item->batch_values[i].data(),
+                           data_size * sizeof(float));
+                    _db->del_data(shard_id,
+                                  reinterpret_cast<char*>(&key),
+                                  sizeof(uint64_t));
+                    ++installed;
+                  }
+                }
+                VLOG(3) << "SSDSparseTable prefetch shard " << shard_id
+                        << " keys " << shard_keys.size() << " installed "
+                        << installed;
+                --_prefetch_inflight;
+                return 0;
+              });
+          return 0;
+        });
+  }
+  return 0;
+}
+
+size_t SSDSparseTable::EvictByScore(int shard_id, size_t max_keys) {
+  auto& shard = _local_shards[shard_id];
+  if (max_keys == 0 || shard.size() <= max_keys) {
+    return 0;
+  }
+  size_t evict_num = shard.size() - max_keys;
+  std::vector<float> scores;
+  scores.reserve(shard.size());
+  for (auto it = shard.begin(); it != shard.end(); ++it) {
+    scores.push_back(
+        _value_accessor->GetField(it.value().data(), "show_click_score"));
+  }
+  std::nth_element(
+      scores.begin(), scores.begin() + (evict_num - 1), scores.end());
+  float threshold = scores[evict_num - 1];
+
+  size_t count = 0;
+  for (auto it = shard.begin(); it != shard.end() && count < evict_num;) {
+    if (_value_accessor->GetField(it.value().data(), "show_click_score") <=
+        threshold) {
+      _db->put(shard_id,
+               reinterpret_cast<const char*>(&it.key()),
+               sizeof(uint64_t),
+               reinterpret_cast<const char*>(it.value().data()),
+               it.value().size() * sizeof(float));
+      it = shard.erase(it);
+      ++count;
+    } else {
+      ++it;
+    }
+  }
+  return count;
+}
+
 int32_t SSDSparseTable::Shrink(const std::string& param) {
   int thread_num = _real_local_shard_num < 20 ? _real_local_shard_num : 20;
   omp_set_num_threads(thread_num);
@@ -538,6 +676,7 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
     uint64_t ssd_count = 0;
 
     LOG(INFO) << "SSDSparseTable begin shrink shard:" << i;
+    ++_spill_epoch[i];
     auto& shard = _local_shards[i];
     for (auto it = shard.begin(); it != shard.end();) {
       if (_value_accessor->Shrink(it.value().data())) {
@@ -571,7 +710,9 @@ int32_t SSDSparseTable::Shrink(const std::string& param) {
 
 int32_t SSDSparseTable::UpdateTable() {
   int count = 0;
+  int evict_count = 0;
   for (int i = 0; i < _real_local_shard_num; ++i) {
+    ++_spill_epoch[i];
     auto& shard = _local_shards[i];
     // from mem to ssd
     for (auto it = shard.begin(); it != shard.end();) {
@@ -587,9 +728,11 @@ int32_t SSDSparseTable::UpdateTable() {
         ++it;
       }
     }
+    evict_count += EvictByScore(i, FLAGS_pserver_ssd_mem_keys_per_shard);
     _db->flush(i);
   }
-  LOG(INFO) << "Table>> update count: " << count;
+  LOG(INFO) << "Table>> update count: " << count
+            << " evict count: " << evict_count;
   return 0;
 }
 
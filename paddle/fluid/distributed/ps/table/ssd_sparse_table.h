@@ -85,10 +85,15 @@ class SSDSparseTable : public MemorySparseTable {
   int32_t PushSparse(const uint64_t* keys, const float* values, size_t num);
   int32_t PushSparse(const uint64_t* keys, const float** values, size_t num);
 
+  // load cold rows of upcoming keys from rocksdb into the memory shards in
+  // background, returns as soon as the reads are scheduled
+  int32_t Prefetch(const uint64_t* keys, size_t num) override;
+
   int32_t Flush() override { return 0; }
   int32_t Shrink(const std::string& param) override;
   void Clear() override {
     for (int i = 0; i < _real_local_shard_num; ++i) {
+      ++_spill_epoch[i];
       _local_shards[i].clear();
     }
   }
@@ -135,7 +140,16 @@ class SSDSparseTable : public MemorySparseTable {
   void SetDayId(int day_id) override;
 
  private:
+  // spill the lowest show/click score rows of a shard to rocksdb until at
+  // most max_keys rows stay in memory, returns the number of spilled rows
+  size_t EvictByScore(int shard_id, size_t max_keys);
+
   RocksDBHandler* _db;
+  // bumped whenever rows of a shard leave memory or rocksdb, a prefetch
+  // started in an older epoch is dropped instead of installed
+  std::unique_ptr<std::atomic<uint64_t>[]> _spill_epoch;
+  std::vector<std::shared_ptr<::ThreadPool>> _prefetch_pool;
+  std::atomic<int32_t> _prefetch_inflight{0};
   int64_t _cache_tk_size;
   double _local_show_threshold{0.0};
   std::vector<paddle::framework::Channel<std::string>> _fs_channel;
@@ -54,6 +54,9 @@ struct TablePushContext {
   const float **ptr_values = nullptr;
   const int64_t *push_steps = nullptr;  // for global step
   bool is_param = false;  // true: push param, false: push gradient
+  // for geo, the rows of values encoded by a GeoDeltaCodec
+  const char *encoded_values = nullptr;
+  uint32_t value_codec = 0;
 };
 
 struct TableContext {
@@ -104,6 +107,28 @@ class Table {
 
   virtual int32_t Pour() { return 0; }
 
+  // hint keys that will be pulled soon, tables backed by slower storage may
+  // start loading them asynchronously
+  virtual int32_t Prefetch(const uint64_t *keys UNUSED, size_t num UNUSED) {
+    return 0;
+  }
+
+  // move a global shard between servers. ExportShard serializes one part of
+  // the shard and returns 1 while more parts follow, 0 after the last one.
+  // ImportShard makes this server an owner of the shard and stores exported
+  // rows, DropShard gives the shard up and frees its rows.
+  virtual int32_t ExportShard(uint32_t shard_id UNUSED,
+                              uint32_t part UNUSED,
+                              std::string *data UNUSED) {
+    return -1;
+  }
+  virtual int32_t ImportShard(uint32_t shard_id UNUSED,
+                              const char *data UNUSED,
+                              size_t size UNUSED) {
+    return -1;
+  }
+  virtual int32_t DropShard(uint32_t shard_id UNUSED) { return -1; }
+
   virtual void Clear() = 0;
   virtual int32_t Flush() = 0;
   virtual int32_t Shrink(const std::string &param) = 0;
@@ -16,11 +16,28 @@ limitations under the License. */
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include "paddle/common/flags.h"
 #include "paddle/fluid/distributed/ps/service/communicator/communicator.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 
 namespace paddle::distributed {
 
+PD_DEFINE_bool(pserver_pull_sparse_dedup,
+               false,
+               "pull each distinct sparse key once per request");
+
+PD_DEFINE_int32(pserver_pull_sparse_merge_window_us,
+                0,
+                "window in which concurrent sparse pulls of a table are "
+                "merged before deduplication, 0 means no merging");
+
 using framework::ProgramDesc;
 using framework::VarDesc;
 using framework::Variable;
@@ -34,6 +51,162 @@ std::shared_ptr<::paddle::distributed::PSCore> FleetWrapper::pserver_ptr_ =
 std::shared_ptr<::paddle::distributed::PSClient> FleetWrapper::worker_ptr_ =
     NULL;
 
+namespace {
+
+// Sort-merges the keys of one or more sparse pulls, fetches each distinct
+// key once and copies its value to every position asking for it.
+int32_t PullUniqueSparse(PSClient* client,
+                         uint64_t table_id,
+                         size_t value_dim,
+                         bool is_training,
+                         const std::vector<uint64_t>& keys,
+                         const std::vector<float*>& values) {
+  std::vector<std::pair<uint64_t, uint32_t>> order(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    order[i] = {keys[i], static_cast<uint32_t>(i)};
+  }
+  std::sort(order.begin(), order.end());
+
+  std::vector<uint64_t> unique_keys;
+  std::vector<uint32_t> slot(keys.size());
+  unique_keys.reserve(keys.size());
+  for (auto& item : order) {
+    if (unique_keys.empty() || unique_keys.back() != item.first) {
+      unique_keys.push_back(item.first);
+    }
+    slot[item.second] = static_cast<uint32_t>(unique_keys.size() - 1);
+  }
+
+  std::vector<float> unique_values(unique_keys.size() * value_dim);
+  std::vector<float*> unique_ptrs(unique_keys.size());
+  for (size_t i = 0; i < unique_keys.size(); ++i) {
+    unique_ptrs[i] = unique_values.data() + i * value_dim;
+  }
+  VLOG(3) << "pull sparse table " << table_id << " keys " << keys.size()
+          << " unique " << unique_keys.size();
+  auto status = client->PullSparse(unique_ptrs.data(),
+                                   table_id,
+                                   unique_keys.data(),
+                                   unique_keys.size(),
+                                   is_training);
+  status.wait();
+  int32_t ret = status.get();
+  if (ret != 0) {
+    return ret;
+  }
+  for (size_t i = 0; i < keys.size(); ++i) {
+    memcpy(values[i], unique_ptrs[slot[i]], sizeof(float) * value_dim);
+  }
+  return 0;
+}
+
+// Process wide stage merging sparse pulls which different threads issue on
+// the same table within FLAGS_pserver_pull_sparse_merge_window_us. The first
+// thread of a window becomes the leader, waits out the window, pulls the
+// union of the keys once and wakes up the others.
+class SparsePullMerger {
+ public:
+  static SparsePullMerger& Instance() {
+    static SparsePullMerger merger;
+    return merger;
+  }
+
+  int32_t Pull(PSClient* client,
+               uint64_t table_id,
+               size_t value_dim,
+               bool is_training,
+               float** values,
+               const uint64_t* keys,
+               size_t num) {
+    Request request{keys, values, num};
+    auto group_key = std::make_tuple(client, table_id, value_dim, is_training);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto& group = groups_[group_key];
+    group.pending.push_back(&request);
+    if (group.has_leader) {
+      cv_.wait(lock, [&request] { return request.done; });
+      return request.ret;
+    }
+    group.has_leader = true;
+    lock.unlock();
+    std::this_thread::sleep_for(std::chrono::microseconds(
+        FLAGS_pserver_pull_sparse_merge_window_us));
+    lock.lock();
+    std::vector<Request*> batch;
+    batch.swap(group.pending);
+    group.has_leader = false;
+    lock.unlock();
+
+    std::vector<uint64_t> merged_keys;
+    std::vector<float*> merged_values;
+    for (auto* req : batch) {
+      merged_keys.insert(merged_keys.end(), req->keys, req->keys + req->num);
+      merged_values.insert(
+          merged_values.end(), req->values, req->values + req->num);
+    }
+    int32_t ret = PullUniqueSparse(client,
+                                   table_id,
+                                   value_dim,
+                                   is_training,
+                                   merged_keys,
+                                   merged_values);
+
+    lock.lock();
+    for (auto* req : batch) {
+      req->ret = ret;
+      req->done = true;
+    }
+    lock.unlock();
+    cv_.notify_all();
+    return request.ret;
+  }
+
+ private:
+  struct Request {
+    const uint64_t* keys;
+    float** values;
+    size_t num;
+    int32_t ret = 0;
+    bool done = false;
+  };
+  struct Group {
+    std::vector<Request*> pending;
+    bool has_leader = false;
+  };
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::map<std::tuple<PSClient*, uint64_t, size_t, bool>, Group> groups_;
+};
+
+// Pulls with the dedup stage when FLAGS_pserver_pull_sparse_dedup is on,
+// otherwise sends the keys as they are.
+int32_t PullSparseMaybeDedup(PSClient* client,
+                             uint64_t table_id,
+                             size_t value_dim,
+                             bool is_training,
+                             float** values,
+                             const uint64_t* keys,
+                             size_t num) {
+  if (!FLAGS_pserver_pull_sparse_dedup || num == 0) {
+    auto status = client->PullSparse(values, table_id, keys, num, is_training);
+    status.wait();
+    return status.get();
+  }
+  if (FLAGS_pserver_pull_sparse_merge_window_us > 0) {
+    return SparsePullMerger::Instance().Pull(
+        client, table_id, value_dim, is_training, values, keys, num);
+  }
+  return PullUniqueSparse(client,
+                          table_id,
+                          value_dim,
+                          is_training,
+                          std::vector<uint64_t>(keys, keys + num),
+                          std::vector<float*>(values, values + num));
+}
+
+}  // namespace
+
 int FleetWrapper::RegisterHeterCallback(HeterCallBackFunc handler) {
   VLOG(0) << "RegisterHeterCallback support later";
   return 0;
@@ -263,8 +436,6 @@ void FleetWrapper::PullSparseVarsSync(
     std::vector<std::vector<float>>* fea_values,
     int fea_value_dim,
     const std::vector<std::string>& var_emb_names) {
-  std::vector<std::future<int32_t>> pull_sparse_status;
-  pull_sparse_status.resize(0);
   fea_keys->clear();
   fea_keys->resize(0);
   fea_keys->reserve(MAX_FEASIGN_NUM);
@@ -305,20 +476,17 @@ void FleetWrapper::PullSparseVarsSync(
     pull_result_ptr.push_back(t.data());
   }
   bool training = true;
-  auto status = pserver_ptr_->_worker_ptr->PullSparse(pull_result_ptr.data(),
-                                                      table_id,
-                                                      fea_keys->data(),
-                                                      fea_keys->size(),
-                                                      training);
-  pull_sparse_status.push_back(std::move(status));
-  for (auto& t : pull_sparse_status) {
-    t.wait();
-    auto status = t.get();
-    if (status != 0) {
-      LOG(ERROR) << "fleet pull sparse failed, status[" << status << "]";
-      sleep(sleep_seconds_before_fail_exit_);
-      exit(-1);
-    }
+  auto status = PullSparseMaybeDedup(pserver_ptr_->_worker_ptr.get(),
+                                     table_id,
+                                     fea_value_dim,
+                                     training,
+                                     pull_result_ptr.data(),
+                                     fea_keys->data(),
+                                     fea_keys->size());
+  if (status != 0) {
+    LOG(ERROR) << "fleet pull sparse failed, status[" << status << "]";
+    sleep(sleep_seconds_before_fail_exit_);
+    exit(-1);
   }
 }
 
@@ -384,13 +552,13 @@ void FleetWrapper::PullSparseToTensorSync(
     }
   }
 
-  auto status = worker_ptr_->PullSparse(pull_result_ptr.data(),
-                                        table_id,
-                                        fea_keys.data(),
-                                        fea_keys.size(),
-                                        is_training);
-  status.wait();
-  auto ret = status.get();
+  auto ret = PullSparseMaybeDedup(worker_ptr_.get(),
+                                  table_id,
+                                  fea_dim,
+                                  is_training,
+                                  pull_result_ptr.data(),
+                                  fea_keys.data(),
+                                  fea_keys.size());
   if (ret != 0) {
     LOG(ERROR) << "fleet pull sparse failed, status[" << ret << "]";
     sleep(sleep_seconds_before_fail_exit_);
@@ -844,6 +1012,28 @@ void FleetWrapper::ShrinkSparseTable(int table_id, int threshold) {
   }
 }
 
+void FleetWrapper::RebalanceSparseTable(int table_id, int server_num) {
+  auto ret = worker_ptr_->RebalanceSparseTable(table_id, server_num);
+  ret.wait();
+  int32_t err_code = ret.get();
+  if (err_code == -1) {
+    LOG(ERROR) << "rebalance sparse table " << table_id << " on "
+               << server_num << " servers failed";
+  }
+}
+
+void FleetWrapper::MigrateSparseShard(int table_id,
+                                      int shard_id,
+                                      int to_server) {
+  auto ret = worker_ptr_->MigrateSparseShard(table_id, shard_id, to_server);
+  ret.wait();
+  int32_t err_code = ret.get();
+  if (err_code == -1) {
+    LOG(ERROR) << "migrate shard " << shard_id << " of sparse table "
+               << table_id << " to server " << to_server << " failed";
+  }
+}
+
 void FleetWrapper::ClearModel() {
   auto ret = pserver_ptr_->_worker_ptr->Clear();
   ret.wait();
@@ -271,6 +271,10 @@ class FleetWrapper {
   void ClearOneTable(const uint64_t table_id);
   // shrink sparse table
   void ShrinkSparseTable(int table_id, int threshold);
+  // move the shards of a consistent_hash_shard table onto server_num servers
+  void RebalanceSparseTable(int table_id, int server_num);
+  // move one shard of a consistent_hash_shard table to to_server
+  void MigrateSparseShard(int table_id, int shard_id, int to_server);
   // shrink dense table
   void ShrinkDenseTable(int table_id,
                         Scope* scope,
@@ -0,0 +1,187 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "butil/iobuf.h"
+#include "gtest/gtest.h"
+#include "paddle/fluid/distributed/ps/service/brpc_utils.h"
+#include "paddle/fluid/distributed/ps/service/sendrecv.pb.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+const size_t kKeyNum = 16384;
+const size_t kValueDim = 12;
+const size_t kValueSize = kValueDim * sizeof(float);
+const int kRounds = 200;
+
+struct PushInput {
+  std::vector<uint64_t> keys;
+  std::vector<std::vector<float>> values;
+  std::vector<const float*> value_ptrs;
+};
+
+void MakePushInput(PushInput* input) {
+  input->keys.resize(kKeyNum);
+  input->values.resize(kKeyNum);
+  input->value_ptrs.resize(kKeyNum);
+  for (size_t i = 0; i < kKeyNum; ++i) {
+    input->keys[i] = i * 7919;
+    input->values[i].assign(kValueDim, static_cast<float>(i));
+    input->value_ptrs[i] = input->values[i].data();
+  }
+}
+
+void FillPushData(const PushInput& input, char* push_data_ptr) {
+  memcpy(push_data_ptr, input.keys.data(), kKeyNum * sizeof(uint64_t));
+  push_data_ptr += kKeyNum * sizeof(uint64_t);
+  for (size_t i = 0; i < kKeyNum; ++i) {
+    memcpy(push_data_ptr, input.value_ptrs[i], kValueSize);
+    push_data_ptr += kValueSize;
+  }
+}
+
+// payload in PsRequestMessage.data, serialized and parsed by protobuf
+float LegacyPushRound(const PushInput& input) {
+  PsRequestMessage request;
+  request.set_cmd_id(PS_PUSH_SPARSE_TABLE);
+  auto* push_data = request.mutable_data();
+  push_data->resize(kKeyNum * (sizeof(uint64_t) + kValueSize));
+  FillPushData(input, const_cast<char*>(push_data->data()));
+
+  butil::IOBuf wire;
+  {
+    // the stream gives back its unused block space on destruction
+    butil::IOBufAsZeroCopyOutputStream output(&wire);
+    request.SerializeToZeroCopyStream(&output);
+  }
+
+  PsRequestMessage received;
+  butil::IOBufAsZeroCopyInputStream wire_input(wire);
+  received.ParseFromZeroCopyStream(&wire_input);
+  const float* values = reinterpret_cast<const float*>(
+      received.data().data() + kKeyNum * sizeof(uint64_t));
+  return values[(kKeyNum - 1) * kValueDim];
+}
+
+// payload handed to the attachment without copy, parsed in place
+float ZeroCopyPushRound(const PushInput& input) {
+  PsRequestMessage request;
+  request.set_cmd_id(PS_PUSH_SPARSE_TABLE);
+  size_t push_data_size = kKeyNum * (sizeof(uint64_t) + kValueSize);
+  char* push_data = AllocZeroCopyBuffer(push_data_size);
+  FillPushData(input, push_data);
+  butil::IOBuf attachment;
+  AppendZeroCopyBuffer(&attachment, push_data, push_data_size);
+
+  butil::IOBuf wire;
+  {
+    // the stream gives back its unused block space on destruction
+    butil::IOBufAsZeroCopyOutputStream output(&wire);
+    request.SerializeToZeroCopyStream(&output);
+  }
+  wire.append(attachment);
+
+  PsRequestMessage received;
+  butil::IOBuf received_message;
+  wire.cutn(&received_message, wire.size() - attachment.size());
+  butil::IOBufAsZeroCopyInputStream wire_input(received_message);
+  received.ParseFromZeroCopyStream(&wire_input);
+  thread_local std::string push_buffer;
+  const char* data = FetchIOBufInPlace(wire, push_data_size, &push_buffer);
+  const float* values =
+      reinterpret_cast<const float*>(data + kKeyNum * sizeof(uint64_t));
+  return values[(kKeyNum - 1) * kValueDim];
+}
+
+template <typename Round>
+double BytesPerSecondPerCore(const PushInput& input,
+                             int thread_num,
+                             Round round) {
+  std::vector<std::thread> threads;
+  std::vector<double> seconds(thread_num, 0.0);
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      auto begin = std::chrono::steady_clock::now();
+      for (int r = 0; r < kRounds; ++r) {
+        EXPECT_FLOAT_EQ(round(input), static_cast<float>(kKeyNum - 1));
+      }
+      auto end = std::chrono::steady_clock::now();
+      seconds[t] = std::chrono::duration<double>(end - begin).count();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double bytes = static_cast<double>(kRounds) * kKeyNum *
+                 (sizeof(uint64_t) + kValueSize);
+  double total = 0.0;
+  for (auto s : seconds) {
+    total += bytes / s;
+  }
+  return total / thread_num;
+}
+
+}  // namespace
+
+TEST(BrpcZeroCopy, FetchIOBufInPlace) {
+  std::string payload(1024, 'a');
+  butil::IOBuf contiguous;
+  contiguous.append(payload);
+  std::string buffer;
+  const char* data = FetchIOBufInPlace(contiguous, payload.size(), &buffer);
+  EXPECT_EQ(data, contiguous.backing_block(0).data());
+  EXPECT_TRUE(buffer.empty());
+
+  // two user data blocks are never merged, the bytes have to be gathered
+  butil::IOBuf split;
+  for (size_t offset = 0; offset < payload.size(); offset += 512) {
+    char* block = AllocZeroCopyBuffer(512);
+    memcpy(block, payload.data() + offset, 512);
+    AppendZeroCopyBuffer(&split, block, 512);
+  }
+  EXPECT_EQ(split.backing_block_num(), 2UL);
+  data = FetchIOBufInPlace(split, payload.size(), &buffer);
+  EXPECT_EQ(data, buffer.data());
+  EXPECT_EQ(std::string(data, payload.size()), payload);
+}
+
+TEST(BrpcZeroCopy, PushSparseBenchmark) {
+  PushInput input;
+  MakePushInput(&input);
+  int thread_num = std::max(
+      1, std::min(4, static_cast<int>(std::thread::hardware_concurrency())));
+
+  double legacy = BytesPerSecondPerCore(input, thread_num, LegacyPushRound);
+  double zero_copy =
+      BytesPerSecondPerCore(input, thread_num, ZeroCopyPushRound);
+  std::cout << "push sparse " << kKeyNum << " keys x " << kValueSize
+            << "B, threads " << thread_num << std::endl
+            << "  protobuf data : " << legacy / (1 << 20) << " MB/s per core"
+            << std::endl
+            << "  zero copy     : " << zero_copy / (1 << 20)
+            << " MB/s per core" << std::endl;
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -16,6 +16,8 @@ limitations under the License. */
 
 #include <cmath>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/common/registerer.h"
@@ -170,4 +172,62 @@ TEST(downpour_feature_value_accessor_test, test_string_related) {
   ASSERT_NE(acc->ParseFromString(str, value), 0);
   // make sure init_zero=true
 }
+
+TEST(downpour_feature_value_accessor_test, test_compact_embedx) {
+  for (const std::string storage : {"fp16", "int8"}) {
+    TableAccessorParameter parameter = gen_param();
+    parameter.mutable_ctr_accessor_param()->set_embedx_storage(storage);
+    parameter.set_embedx_threshold(0);
+    parameter.mutable_embedx_sgd_param()->set_name("SparseAdaGradSGDRule");
+    auto* adagrad_param =
+        parameter.mutable_embedx_sgd_param()->mutable_adagrad();
+    adagrad_param->set_learning_rate(0.1);
+    adagrad_param->set_initial_range(0.3);
+    adagrad_param->set_initial_g2sum(0.0);
+    adagrad_param->add_weight_bounds(-10.0);
+    adagrad_param->add_weight_bounds(10.0);
+    CtrDymfAccessor* acc = new CtrDymfAccessor();
+    ASSERT_EQ(acc->Configure(parameter), 0);
+    ASSERT_EQ(acc->Initialize(), 0);
+
+    const int embedx_dim = 8;
+    auto& feature_value = acc->common_feature_value;
+    const int dim = acc->GetAccessorInfo().dim;
+    ASSERT_EQ(dim, feature_value.Dim(embedx_dim));
+    // 7 fields, embed g2sum, embedx g2sum and the fp32 embedx_w
+    ASSERT_LT(dim, 7 + 1 + 1 + embedx_dim);
+
+    std::vector<float> value(dim);
+    float* value_ptr = value.data();
+    ASSERT_EQ(acc->Create(&value_ptr, 1), 0);
+    std::vector<float> pull(acc->GetAccessorInfo().select_dim);
+    float* pull_ptr = pull.data();
+    const float* const_value_ptr = value_ptr;
+    ASSERT_EQ(acc->Select(&pull_ptr, &const_value_ptr, 1), 0);
+    for (int i = 0; i < embedx_dim; ++i) {
+      float w = CtrDymfAccessor::CtrDymfPullValue::EmbedxW(pull_ptr)[i];
+      ASSERT_LE(std::fabs(w), 0.31);
+    }
+
+    // the saved text is fp32, and loads back to the same storage
+    std::vector<float> embedx_w = {
+        -0.25, -0.125, 0, 0.0625, 0.125, 0.25, 0.5, -0.5};
+    feature_value.Show(value_ptr) = 10;
+    feature_value.Click(value_ptr) = 5;
+    feature_value.MfDim(value_ptr) = embedx_dim;
+    feature_value.EncodeEmbedxW(
+        embedx_w.data(), embedx_dim, value_ptr + feature_value.EmbedxWIndex());
+    auto str = acc->ParseToString(value_ptr, dim);
+    std::vector<float> loaded(dim);
+    ASSERT_EQ(acc->ParseFromString(str, loaded.data()), dim);
+    const_value_ptr = loaded.data();
+    ASSERT_EQ(acc->Select(&pull_ptr, &const_value_ptr, 1), 0);
+    for (int i = 0; i < embedx_dim; ++i) {
+      ASSERT_NEAR(CtrDymfAccessor::CtrDymfPullValue::EmbedxW(pull_ptr)[i],
+                  embedx_w[i],
+                  0.5 / 127);
+    }
+    delete acc;
+  }
+}
 }  // namespace paddle::distributed
@@ -0,0 +1,160 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gloo/rendezvous/hash_store.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/common/reduce_type.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/distributed/gloo_comm_context.h"
+#include "paddle/phi/core/distributed/gloo_utils.h"
+
+namespace paddle {
+namespace distributed {
+
+namespace {
+
+using phi::distributed::GlooCommContext;
+
+const int kRanks = 4;
+const int kTensorNum = 64;
+const int64_t kTensorNumel = 1024;
+const int kRounds = 20;
+
+template <typename T>
+std::vector<phi::DenseTensor> MakeTensors(int rank) {
+  std::vector<phi::DenseTensor> tensors(kTensorNum);
+  for (auto& tensor : tensors) {
+    tensor.Resize(common::make_ddim({kTensorNumel}));
+    T* data = tensor.mutable_data<T>(phi::CPUPlace());
+    for (int64_t i = 0; i < kTensorNumel; ++i) {
+      data[i] = static_cast<T>(rank + 1);
+    }
+  }
+  return tensors;
+}
+
+template <typename T>
+void CheckTensors(const std::vector<phi::DenseTensor>& tensors) {
+  // 1 + 2 + ... + kRanks is exact in bfloat16
+  const float expected = kRanks * (kRanks + 1) / 2.0f;
+  for (const auto& tensor : tensors) {
+    const T* data = tensor.data<T>();
+    for (int64_t i = 0; i < kTensorNumel; ++i) {
+      ASSERT_EQ(static_cast<float>(data[i]), expected);
+    }
+  }
+}
+
+// Runs one thread per rank and returns the seconds of the slowest rank.
+template <typename T, typename Round>
+double RunRanks(Round round) {
+  auto store = std::make_shared<gloo::rendezvous::HashStore>();
+  std::vector<std::thread> threads;
+  std::vector<double> seconds(kRanks, 0.0);
+  for (int rank = 0; rank < kRanks; ++rank) {
+    threads.emplace_back([&, rank]() {
+      GlooCommContext comm(
+          rank, kRanks, store, phi::distributed::CreateGlooDevice());
+      auto tensors = MakeTensors<T>(rank);
+      auto begin = std::chrono::steady_clock::now();
+      for (int r = 0; r < kRounds; ++r) {
+        round(&comm, &tensors);
+      }
+      auto end = std::chrono::steady_clock::now();
+      seconds[rank] = std::chrono::duration<double>(end - begin).count();
+      // the timed rounds keep summing their sums, check a fresh round
+      auto check = MakeTensors<T>(rank);
+      round(&comm, &check);
+      CheckTensors<T>(check);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double slowest = 0.0;
+  for (auto s : seconds) {
+    slowest = std::max(slowest, s);
+  }
+  return slowest;
+}
+
+void PerTensorRound(GlooCommContext* comm,
+                    std::vector<phi::DenseTensor>* tensors) {
+  for (auto& tensor : *tensors) {
+    comm->AllReduce(
+        &tensor, tensor, static_cast<int>(phi::ReduceType::kRedSum));
+  }
+}
+
+void CoalescedRound(GlooCommContext* comm,
+                    std::vector<phi::DenseTensor>* tensors) {
+  std::vector<phi::DenseTensor*> outs;
+  for (auto& tensor : *tensors) {
+    outs.push_back(&tensor);
+  }
+  comm->AllReduce(outs, *tensors, static_cast<int>(phi::ReduceType::kRedSum));
+}
+
+template <typename T>
+void Benchmark(const char* name) {
+  double per_tensor = RunRanks<T>(PerTensorRound);
+  double coalesced = RunRanks<T>(CoalescedRound);
+  std::cout << name << " allreduce " << kTensorNum << " x " << kTensorNumel
+            << ", ranks " << kRanks << std::endl
+            << "  per tensor : " << per_tensor * 1000 / kRounds << " ms"
+            << std::endl
+            << "  coalesced  : " << coalesced * 1000 / kRounds << " ms"
+            << std::endl;
+}
+
+}  // namespace
+
+TEST(GlooAllReduce, VecSum) {
+  const size_t n = 1000;  // not a multiple of the vector width
+  std::mt19937 gen(2024);
+  std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+  std::vector<float> a(n), b(n), c(n);
+  std::vector<phi::dtype::bfloat16> a16(n), b16(n), c16(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = dist(gen);
+    b[i] = dist(gen);
+    a16[i] = static_cast<phi::dtype::bfloat16>(a[i]);
+    b16[i] = static_cast<phi::dtype::bfloat16>(b[i]);
+  }
+  phi::distributed::VecSumFloat(c.data(), a.data(), b.data(), n);
+  phi::distributed::VecSumBFloat16(c16.data(), a16.data(), b16.data(), n);
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(c[i], a[i] + b[i]);
+    EXPECT_EQ(c16[i].x, (a16[i] + b16[i]).x);
+  }
+}
+
+TEST(GlooAllReduce, CoalescedBenchmark) {
+  Benchmark<float>("float32");
+  Benchmark<phi::dtype::bfloat16>("bfloat16");
+}
+
+}  // namespace distributed
+}  // namespace paddle
@@ -13,9 +13,11 @@ limitations under the License. */
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <condition_variable>  // NOLINT
 #include <fstream>
 #include <iomanip>
+#include <random>
 #include <string>
 #include <thread>  // NOLINT
 #include <unordered_set>
@@ -712,3 +714,125 @@ void testGraphToBuffer() {
 }
 
 TEST(RunBrpcPushSparse, Run) { RunBrpcPushSparse(); }
+
+TEST(ScaledLRU, Run) {
+  ::paddle::distributed::ScaledLRU<::paddle::distributed::SampleKey,
+                                   ::paddle::distributed::SampleResult>
+      lru(2, 4, 3);
+  std::vector<::paddle::distributed::SampleKey> keys;
+  std::vector<::paddle::distributed::SampleResult> results;
+  for (int i = 0; i < 4; i++) {
+    keys.emplace_back(0, i, 5, false);
+    char *str = new char[2];
+    str[0] = 'a' + i;
+    str[1] = '\0';
+    results.emplace_back(2, str);
+  }
+  std::vector<std::pair<::paddle::distributed::SampleKey,
+                        ::paddle::distributed::SampleResult>>
+      r;
+  // two slots a shard, the first two keys are evicted
+  lru.insert(0, keys.data(), results.data(), 4);
+  ASSERT_EQ(lru.size(), 2UL);
+  lru.query(0, keys.data(), 2, r);
+  ASSERT_EQ(r.size(), 0UL);
+  for (size_t i = 0; i < lru.get_ttl(); i++) {
+    r.clear();
+    lru.query(0, keys.data() + 2, 2, r);
+    ASSERT_EQ(r.size(), 2UL);
+    ASSERT_EQ(r[0].second.buffer.get()[0], 'c');
+    ASSERT_EQ(r[1].second.buffer.get()[0], 'd');
+  }
+  // served ttl times
+  r.clear();
+  lru.query(0, keys.data() + 2, 2, r);
+  ASSERT_EQ(r.size(), 0UL);
+  ASSERT_EQ(lru.size(), 0UL);
+
+  // a referenced key gets a second chance
+  lru.insert(1, keys.data(), results.data(), 2);
+  r.clear();
+  lru.query(1, keys.data(), 1, r);
+  lru.insert(1, keys.data() + 2, results.data() + 2, 1);
+  r.clear();
+  lru.query(1, keys.data(), 3, r);
+  ASSERT_EQ(r.size(), 2UL);
+  ASSERT_EQ(r[0].first.node_key, 0UL);
+  ASSERT_EQ(r[1].first.node_key, 2UL);
+
+  auto stats = lru.get_stats();
+  ASSERT_EQ(stats.evict, 3UL);
+  ASSERT_EQ(stats.expire, 2UL);
+  ASSERT_EQ(stats.blocked, 0UL);
+  ASSERT_EQ(stats.hit, 9UL);
+  ASSERT_EQ(stats.miss, 5UL);
+}
+
+TEST(CompressedGraphEdges, Run) {
+  ::paddle::distributed::CompressedGraphEdges edges(true);
+  std::vector<std::vector<int64_t>> rows = {
+      {9, 3, 1000000007, 5}, {}, {}, {42}};
+  // a row across several blocks
+  for (int64_t i = 40; i > 0; --i) {
+    rows[1].push_back(i * 1000 + (i % 3));
+  }
+  std::vector<::paddle::distributed::CompressedGraphEdges::WeightType> weights;
+  for (auto &row : rows) {
+    std::vector<int64_t> ids = row;
+    weights.clear();
+    for (auto id : ids) {
+      weights.emplace_back(static_cast<float>(id % 7));
+    }
+    edges.add_row(&ids, &weights);
+    std::sort(row.begin(), row.end());
+  }
+  for (size_t r = 0; r < rows.size(); ++r) {
+    ASSERT_EQ(edges.row_size(r), rows[r].size());
+    std::vector<int64_t> ids;
+    edges.get_ids(r, &ids);
+    ASSERT_EQ(ids, rows[r]);
+    for (size_t i = 0; i < rows[r].size(); ++i) {
+      ASSERT_EQ(edges.get_id(r, i), rows[r][i]);
+      ASSERT_EQ(static_cast<float>(edges.get_weight(r, i)),
+                static_cast<float>(rows[r][i] % 7));
+    }
+  }
+
+  ::paddle::distributed::CompressedGraphNode node(7, &edges, 1);
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  std::vector<int> res = node.sample_k(10, rng);
+  std::unordered_set<int> uniq(res.begin(), res.end());
+  ASSERT_EQ(uniq.size(), 10UL);
+  ASSERT_EQ(node.get_neighbor_size(), 40UL);
+}
+
+TEST(AliasSampler, Run) {
+  ::paddle::distributed::WeightedGraphEdgeBlob edges;
+  std::vector<float> weights = {0, 1, 1, 8, 0, 2};
+  for (size_t i = 0; i < weights.size(); ++i) {
+    edges.add_edge(i, weights[i]);
+  }
+  auto rng = std::make_shared<std::mt19937_64>(0);
+  // with a table and with the scan
+  for (int min_degree : {0, 100}) {
+    ::paddle::distributed::AliasSampler sampler(min_degree);
+    sampler.build(&edges);
+    ASSERT_EQ(sampler.sample_k(10, rng).size(), weights.size());
+    std::vector<int> counts(weights.size(), 0);
+    for (int t = 0; t < 1000; ++t) {
+      std::vector<int> res = sampler.sample_k(3, rng);
+      ASSERT_EQ(res.size(), 3UL);
+      std::unordered_set<int> uniq(res.begin(), res.end());
+      ASSERT_EQ(uniq.size(), 3UL);
+      for (int x : res) {
+        counts[x]++;
+      }
+      counts[sampler.sample_k(1, rng)[0]] += 1000;
+    }
+    ASSERT_EQ(counts[0], 0);
+    ASSERT_EQ(counts[4], 0);
+    // 8 / 12 of the single draws
+    ASSERT_GT(counts[3], 600 * 1000);
+    ASSERT_LT(counts[3], 740 * 1000 + 1000);
+  }
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/distributed/common/hot_key_cache.h"
+
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+
+namespace paddle::distributed {
+
+TEST(CountMinSketch, Estimate) {
+  CountMinSketch sketch(1024, 4, 1000000);
+  for (int i = 0; i < 10; ++i) {
+    sketch.add(42);
+  }
+  sketch.add(7);
+  ASSERT_GE(sketch.estimate(42), 10u);
+  ASSERT_GE(sketch.estimate(7), 1u);
+  ASSERT_LT(sketch.estimate(7), 10u);
+}
+
+TEST(HotKeyCache, AdmitAndInvalidate) {
+  float value[3] = {1.0, 2.0, 3.0};
+  float result[3] = {0.0, 0.0, 0.0};
+  HotKeyCache cache(sizeof(value), 1024, 100000, 2);
+
+  // cold key is not admitted
+  ASSERT_FALSE(cache.lookup(1, result));
+  cache.insert(1, value, cache.version());
+  ASSERT_EQ(cache.size(), 0u);
+
+  ASSERT_FALSE(cache.lookup(1, result));
+  cache.insert(1, value, cache.version());
+  ASSERT_EQ(cache.size(), 1u);
+  ASSERT_TRUE(cache.lookup(1, result));
+  ASSERT_EQ(result[2], 3.0);
+
+  // values pulled before a push are dropped
+  uint64_t pull_version = cache.version();
+  cache.invalidate(std::vector<uint64_t>{1}.data(), 1);
+  ASSERT_FALSE(cache.lookup(1, result));
+  cache.insert(1, value, pull_version);
+  ASSERT_EQ(cache.size(), 0u);
+}
+
+TEST(HotKeyCache, Staleness) {
+  float value = 1.0;
+  float result = 0.0;
+  HotKeyCache cache(sizeof(value), 1024, 10, 1);
+  ASSERT_FALSE(cache.lookup(1, &result));
+  cache.insert(1, &value, cache.version());
+  ASSERT_TRUE(cache.lookup(1, &result));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  ASSERT_FALSE(cache.lookup(1, &result));
+}
+
+}  // namespace paddle::distributed
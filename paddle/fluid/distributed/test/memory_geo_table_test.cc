@@ -144,4 +144,77 @@ TEST(MemorySparseGeoTable, SSUM) {
   }
 }
 
+// the deltas of a trainer pushed as fp16 and int8 rows
+TEST(MemorySparseGeoTable, EncodedPush) {
+  int emb_dim = 8;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseGeoTable");
+  FsClientParameter fs_config;
+  Table *table = new MemorySparseGeoTable();
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CommMergeAccessor");
+  accessor_config->set_fea_dim(emb_dim);
+  CommonAccessorParameter *common_config = table_config.mutable_common();
+  common_config->set_name("sum");
+  common_config->set_table_name("encoded_test_table");
+  common_config->set_trainer_num(1);
+  common_config->add_params("Param");
+  common_config->add_dims(emb_dim);
+  common_config->add_initializers("fill_constant&1.0");
+  ASSERT_EQ(table->Initialize(table_config, fs_config), 0);
+
+  std::vector<uint64_t> keys = {0, 1, 2};
+  std::vector<uint32_t> fres = {1, 1, 1};
+  std::vector<float> deltas;
+  for (size_t i = 0; i < keys.size() * emb_dim; ++i) {
+    deltas.push_back(0.01f * i - 0.1f);
+  }
+  std::vector<float> params(deltas.size(), 0.0f);
+
+  TableContext param_context;
+  param_context.value_type = Sparse;
+  param_context.push_context.keys = keys.data();
+  param_context.push_context.values = params.data();
+  param_context.push_context.is_param = true;
+  param_context.num = keys.size();
+  table->Push(param_context);
+
+  for (uint32_t codec : {kGeoDeltaFP16, kGeoDeltaINT8}) {
+    size_t row_bytes = GeoDeltaRowBytes(codec, emb_dim);
+    std::vector<char> encoded(keys.size() * row_bytes);
+    std::vector<float> decoded(emb_dim);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      GeoDeltaEncodeRow(codec,
+                        &deltas[i * emb_dim],
+                        emb_dim,
+                        &encoded[i * row_bytes],
+                        decoded.data());
+      for (int k = 0; k < emb_dim; ++k) {
+        ASSERT_NEAR(decoded[k], deltas[i * emb_dim + k], 1e-3);
+        params[i * emb_dim + k] += decoded[k];
+      }
+    }
+
+    TableContext push_context;
+    push_context.value_type = Sparse;
+    push_context.push_context.keys = keys.data();
+    push_context.push_context.encoded_values = encoded.data();
+    push_context.push_context.value_codec = codec;
+    push_context.num = keys.size();
+    table->Push(push_context);
+
+    std::vector<float> pull_values(params.size());
+    TableContext pull_context;
+    pull_context.value_type = Sparse;
+    pull_context.pull_context.pull_value =
+        PullSparseValue(keys, fres, emb_dim);
+    pull_context.pull_context.values = pull_values.data();
+    table->Pull(pull_context);
+    for (size_t i = 0; i < params.size(); ++i) {
+      ASSERT_NEAR(pull_values[i], params[i], 1e-6);
+    }
+  }
+}
+
 }  // namespace paddle::distributed
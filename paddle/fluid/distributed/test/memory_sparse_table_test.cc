@@ -24,6 +24,13 @@ limitations under the License. */
 #include "gtest/gtest.h"
 #include "paddle/fluid/distributed/ps/table/table.h"
 #include "paddle/fluid/distributed/the_one_ps.pb.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+PD_DECLARE_bool(pserver_sparse_table_concurrent_shard);
+PD_DECLARE_int32(pserver_shard_task_chunk_size);
+PD_DECLARE_bool(pserver_sparse_table_binary_save);
+PD_DECLARE_bool(pserver_sparse_table_incremental_shrink);
+PD_DECLARE_int32(pserver_shrink_slice_rows);
 
 namespace paddle::distributed {
 
@@ -151,4 +158,245 @@ TEST(MemorySparseTable, SGD) {
   }
 }
 
+TEST(MemorySparseTable, ConcurrentShard) {
+  FLAGS_pserver_sparse_table_concurrent_shard = true;
+  FLAGS_pserver_shard_task_chunk_size = 4;
+  int emb_dim = 8;
+  int trainers = 4;
+
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(2);
+  FsClientParameter fs_config;
+  Table *table = new MemorySparseTable();
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  accessor_config->mutable_ctr_accessor_param()->set_base_threshold(0.5);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_threshold(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  accessor_config->mutable_ctr_accessor_param()->set_show_click_decay_rate(
+      0.99);
+  accessor_config->mutable_embed_sgd_param()->set_name("SparseNaiveSGDRule");
+  auto *naive_param =
+      accessor_config->mutable_embed_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+  accessor_config->mutable_embedx_sgd_param()->set_name("SparseNaiveSGDRule");
+  naive_param = accessor_config->mutable_embedx_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+
+  auto ret = table->Initialize(table_config, fs_config);
+  ASSERT_EQ(ret, 0);
+
+  // every trainer pushes show = 1 for all keys at the same time
+  std::vector<uint64_t> keys;
+  for (uint64_t key = 0; key < 200; ++key) {
+    keys.push_back(key);
+  }
+  std::vector<float> push_values;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    push_values.push_back(0.0);  // slot
+    push_values.push_back(1.0);  // show
+    for (int k = 0; k < emb_dim + 2; k++) {
+      push_values.push_back(0.0);
+    }
+  }
+  std::shared_ptr<::ThreadPool> pool_ =
+      std::make_shared<::ThreadPool>(trainers);
+  std::vector<std::future<void>> task_status;
+  for (int i = 0; i < trainers; i++) {
+    task_status.push_back(pool_->enqueue([table, &keys, &push_values] {
+      TableContext table_context;
+      table_context.value_type = Sparse;
+      table_context.push_context.keys = keys.data();
+      table_context.push_context.values = push_values.data();
+      table_context.num = keys.size();
+      table->Push(table_context);
+    }));
+  }
+  for (auto &status : task_status) {
+    status.wait();
+  }
+  ASSERT_EQ(dynamic_cast<MemorySparseTable *>(table)->LocalSize(),
+            static_cast<int64_t>(keys.size()));
+
+  std::vector<uint32_t> fres(keys.size(), 1);
+  std::vector<float> pull_values(keys.size() * (emb_dim + 3));
+  auto value = PullSparseValue(keys, fres, emb_dim);
+  TableContext table_context;
+  table_context.value_type = Sparse;
+  table_context.pull_context.pull_value = value;
+  table_context.pull_context.values = pull_values.data();
+  table->Pull(table_context);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_FLOAT_EQ(pull_values[i * (emb_dim + 3)], trainers);
+  }
+  FLAGS_pserver_sparse_table_concurrent_shard = false;
+}
+
+Table *CreateBinarySaveTable() {
+  TableParameter table_config;
+  table_config.set_table_class("MemorySparseTable");
+  table_config.set_shard_num(4);
+  FsClientParameter fs_config;
+  Table *table = new MemorySparseTable();
+  table->SetShard(0, 1);
+
+  TableAccessorParameter *accessor_config = table_config.mutable_accessor();
+  accessor_config->set_accessor_class("CtrCommonAccessor");
+  accessor_config->set_fea_dim(11);
+  accessor_config->set_embedx_dim(8);
+  accessor_config->set_embedx_threshold(5);
+  accessor_config->mutable_ctr_accessor_param()->set_nonclk_coeff(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_click_coeff(1);
+  accessor_config->mutable_ctr_accessor_param()->set_base_threshold(0.5);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_threshold(0.2);
+  accessor_config->mutable_ctr_accessor_param()->set_delta_keep_days(16);
+  accessor_config->mutable_ctr_accessor_param()->set_show_click_decay_rate(
+      0.99);
+  accessor_config->mutable_embed_sgd_param()->set_name("SparseNaiveSGDRule");
+  auto *naive_param =
+      accessor_config->mutable_embed_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+  accessor_config->mutable_embedx_sgd_param()->set_name("SparseNaiveSGDRule");
+  naive_param = accessor_config->mutable_embedx_sgd_param()->mutable_naive();
+  naive_param->set_learning_rate(0.1);
+  naive_param->set_initial_range(0.3);
+  naive_param->add_weight_bounds(-10.0);
+  naive_param->add_weight_bounds(10.0);
+
+  EXPECT_EQ(table->Initialize(table_config, fs_config), 0);
+  return table;
+}
+
+TEST(MemorySparseTable, BinarySaveLoad) {
+  FLAGS_pserver_sparse_table_binary_save = true;
+  int emb_dim = 8;
+  std::string base_dir = "./memory_sparse_table_binary_base";
+  std::string delta_dir = "./memory_sparse_table_binary_delta";
+
+  auto push = [emb_dim](Table *table, const std::vector<uint64_t> &keys) {
+    std::vector<float> push_values;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      push_values.push_back(0.0);  // slot
+      push_values.push_back(1.0);  // show
+      for (int k = 0; k < emb_dim + 2; k++) {
+        push_values.push_back(0.1 * k);
+      }
+    }
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = push_values.data();
+    table_context.num = keys.size();
+    table->Push(table_context);
+  };
+  auto pull = [emb_dim](Table *table, const std::vector<uint64_t> &keys) {
+    std::vector<uint32_t> fres(keys.size(), 1);
+    std::vector<float> pull_values(keys.size() * (emb_dim + 3));
+    auto value = PullSparseValue(keys, fres, emb_dim);
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.pull_context.pull_value = value;
+    table_context.pull_context.values = pull_values.data();
+    table->Pull(table_context);
+    return pull_values;
+  };
+
+  std::vector<uint64_t> keys;
+  for (uint64_t key = 0; key < 100; ++key) {
+    keys.push_back(key);
+  }
+  std::vector<uint64_t> delta_keys(keys.begin(), keys.begin() + 10);
+
+  Table *table = CreateBinarySaveTable();
+  push(table, keys);
+  ASSERT_EQ(table->Save(base_dir, "0"), 0);
+  push(table, delta_keys);
+  ASSERT_EQ(table->Save(delta_dir, "6"), 0);
+
+  // the delta only holds the rows pushed after the base
+  Table *delta_table = CreateBinarySaveTable();
+  ASSERT_EQ(delta_table->Load(delta_dir, "0"), 0);
+  ASSERT_EQ(dynamic_cast<MemorySparseTable *>(delta_table)->LocalSize(),
+            static_cast<int64_t>(delta_keys.size()));
+
+  // base + delta restores the table
+  Table *loaded_table = CreateBinarySaveTable();
+  ASSERT_EQ(loaded_table->Load(base_dir, "0"), 0);
+  ASSERT_EQ(dynamic_cast<MemorySparseTable *>(loaded_table)->LocalSize(),
+            static_cast<int64_t>(keys.size()));
+  ASSERT_EQ(loaded_table->Load(delta_dir, "0"), 0);
+  std::vector<float> expected = pull(table, keys);
+  std::vector<float> loaded = pull(loaded_table, keys);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_FLOAT_EQ(loaded[i], expected[i]);
+  }
+
+  paddle::framework::fs_remove(base_dir);
+  paddle::framework::fs_remove(delta_dir);
+  FLAGS_pserver_sparse_table_binary_save = false;
+}
+
+TEST(MemorySparseTable, IncrementalShrink) {
+  FLAGS_pserver_sparse_table_incremental_shrink = true;
+  FLAGS_pserver_shrink_slice_rows = 3;
+  int emb_dim = 8;
+
+  auto push = [emb_dim](Table *table,
+                        const std::vector<uint64_t> &keys,
+                        float show) {
+    std::vector<float> push_values;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      push_values.push_back(0.0);   // slot
+      push_values.push_back(show);  // show
+      for (int k = 0; k < emb_dim + 2; k++) {
+        push_values.push_back(0.1 * k);
+      }
+    }
+    TableContext table_context;
+    table_context.value_type = Sparse;
+    table_context.push_context.keys = keys.data();
+    table_context.push_context.values = push_values.data();
+    table_context.num = keys.size();
+    table->Push(table_context);
+  };
+
+  std::vector<uint64_t> cold_keys;
+  std::vector<uint64_t> hot_keys;
+  for (uint64_t key = 0; key < 100; ++key) {
+    (key % 4 == 0 ? hot_keys : cold_keys).push_back(key);
+  }
+  Table *table = CreateBinarySaveTable();
+  push(table, cold_keys, 1.0);
+  push(table, hot_keys, 10.0);
+
+  // the score of the cold rows decays below delete_threshold
+  ASSERT_EQ(table->Shrink(""), 0);
+  // pushes keep running during the shrink
+  push(table, hot_keys, 10.0);
+  auto *memory_table = dynamic_cast<MemorySparseTable *>(table);
+  memory_table->WaitShrinkDone();
+  ASSERT_EQ(memory_table->LocalSize(), static_cast<int64_t>(hot_keys.size()));
+
+  delete table;
+  FLAGS_pserver_shrink_slice_rows = 10000;
+  FLAGS_pserver_sparse_table_incremental_shrink = false;
+}
+
 }  // namespace paddle::distributed
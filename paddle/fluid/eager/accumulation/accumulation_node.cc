@@ -25,15 +25,43 @@
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/platform/device_context.h"
 #include "paddle/phi/core/sparse_coo_tensor.h"
+#include "paddle/phi/core/tensor_utils.h"
 
 namespace egr {
 
+// Whether t can be written into the memory of tensor instead of replacing it.
+static bool CanCopyInto(const paddle::Tensor& tensor, const paddle::Tensor& t) {
+  if (!tensor.initialized() || !tensor.is_dense_tensor() ||
+      !t.is_dense_tensor() || tensor.place() != t.place() ||
+      tensor.dtype() != t.dtype() || tensor.numel() != t.numel()) {
+    return false;
+  }
+  return static_cast<phi::DenseTensor*>(tensor.impl().get())
+      ->meta()
+      .is_contiguous();
+}
+
 static void CopyOrAddTensor(paddle::Tensor* tensor,
                             const paddle::Tensor& t,
-                            bool is_fake_empty) {
+                            bool is_fake_empty,
+                            bool keep_grad_buffer) {
   if (is_fake_empty) {
-    VLOG(3) << "Move Tensor ptr: " << t.impl();
-    *tensor = t;
+    if (keep_grad_buffer && CanCopyInto(*tensor, t)) {
+      VLOG(3) << "Copy Tensor ptr: " << t.impl()
+              << " into Tensor ptr: " << tensor->impl();
+      auto* dev_ctx = phi::DeviceContextPool::Instance().Get(tensor->place());
+      auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor->impl().get());
+      phi::DDim dims = dense_tensor->dims();
+      phi::Copy(*dev_ctx,
+                *static_cast<phi::DenseTensor*>(t.impl().get()),
+                tensor->place(),
+                false,
+                dense_tensor);
+      dense_tensor->Resize(dims);
+    } else {
+      VLOG(3) << "Move Tensor ptr: " << t.impl();
+      *tensor = t;
+    }
   } else {
     if (!tensor->defined() || !tensor->initialized()) {
       // Simply copy tensor->impl
@@ -180,7 +208,8 @@ GradNodeAccumulation::operator()(
     auto grad = weak_grad_.lock();
     if (grad_out.defined() &&
         (grad_out.is_dist_tensor() || grad_out.initialized())) {
-      CopyOrAddTensor(grad.get(), grad_out, is_fake_empty_);
+      CopyOrAddTensor(
+          grad.get(), grad_out, is_fake_empty_, keep_grad_buffer_);
     }
     // else { do nothing since there is no valid value in grad out tensor }
     is_fake_empty_ = false;
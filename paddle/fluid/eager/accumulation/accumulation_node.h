@@ -67,9 +67,17 @@ class TEST_API GradNodeAccumulation : public GradNodeBase {
 
   void SetFakeEmpty(bool is_fake_empty) { is_fake_empty_ = is_fake_empty; }
 
+  // The grad lives in a buffer owned by someone else, e.g. the fused buffer
+  // of a reducer group, so a cleared grad is overwritten in place instead of
+  // being replaced by the incoming one.
+  void SetKeepGradBuffer(bool keep_grad_buffer) {
+    keep_grad_buffer_ = keep_grad_buffer;
+  }
+
  private:
   // TODO(Jiabin): remove this when we make our clear gradient really cleared;
   bool is_fake_empty_ = {false};
+  bool keep_grad_buffer_ = {false};
   std::weak_ptr<paddle::Tensor> weak_grad_;
   std::vector<std::shared_ptr<VoidHook>> reduce_hooks_;
   std::function<paddle::Tensor(const paddle::Tensor&)> retain_grad_hook_;
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 
@@ -126,6 +127,20 @@ class Controller {
 
   void ClearFinalBackwardHooks() { final_backward_hooks_.clear(); }
 
+  // The observers are not owned, they must be removed before destruction
+  void AddBackwardRunObserver(BackwardRunObserver* observer) {
+    backward_run_observers_.push_back(observer);
+  }
+  void RemoveBackwardRunObserver(BackwardRunObserver* observer) {
+    backward_run_observers_.erase(std::remove(backward_run_observers_.begin(),
+                                              backward_run_observers_.end(),
+                                              observer),
+                                  backward_run_observers_.end());
+  }
+  const std::vector<BackwardRunObserver*>& BackwardRunObservers() const {
+    return backward_run_observers_;
+  }
+
   void ClearForceSequentialNodes() {
     while (!force_sequential_nodes_.empty()) {
       force_sequential_nodes_.pop();
@@ -153,6 +168,7 @@ class Controller {
                      std::vector<std::vector<std::unordered_map<int, int>>>>
       custom_edges_slot_map_;
   std::vector<std::shared_ptr<VoidHook>> final_backward_hooks_;
+  std::vector<BackwardRunObserver*> backward_run_observers_;
   std::queue<GradNodeBase*> force_sequential_nodes_;
   bool is_in_backward_{false};
   DISABLE_COPY_AND_ASSIGN(Controller);
@@ -202,6 +202,20 @@ strided_op_list = {
     "view_dtype",
 }
 
+# The ops whose output the backward may drop and recompute from the input,
+# see egr::RecomputePlanner. Their grad nodes keep the input anyway.
+recompute_op_list = {
+    "celu",
+    "gelu",
+    "leaky_relu",
+    "logsigmoid",
+    "mish",
+    "silu",
+    "softplus",
+    "square",
+    "swish",
+}
+
 strided_op_need_flags_check_list = {
     "as_complex_",
     "as_real_",
@@ -408,6 +422,8 @@ TEST_API {} {}({}) {{
 {}
   // Check Inplace if needed
 {}{}
+  // Set recompute function of the output
+{}
   // Set grad_node after API call
 {}
 
@@ -419,6 +435,12 @@ TEST_API {} {}({}) {{
 }}
 """
 
+SET_RECOMPUTE_TEMPLATE = """  if (require_any_grad && egr::RecomputePlanner::Instance().IsEnabled()) {{
+    egr::RecomputePlanner::Instance().SetRecompute(
+        "{}", {}, [=]() {{ return paddle::experimental::{}({}); }});
+  }}
+"""
+
 AFTER_LOG_PRINT_TEMPLATE = """
   if (VLOG_IS_ON(4)) {{
     const char* INPUT_PRINT_TEMPLATE = \"{{ Input: [%s],  \\n Output: [%s] }} \";
@@ -574,6 +596,8 @@ FORWARD_CC_FILE_TEMPLATE = """
 #include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/backwards/nodes.h"
 #include "paddle/fluid/eager/eager_layout_auto_tune.h"
+#include "paddle/fluid/eager/grad_object_pool.h"
+#include "paddle/fluid/eager/recompute_planner.h"
 #include "paddle/phi/api/include/strings_api.h"
 #include "paddle/phi/api/include/sparse_api.h"
 #include "paddle/fluid/eager/api/utils/global_utils.h"
@@ -1201,8 +1225,10 @@ class DygraphFunctionGeneratorBase(FunctionGeneratorBase):
         # request MEMALIGN for allocation (Maybe).
         # See https://stackoverflow.com/questions/31228656/how-can-shared-ptr-disrupt-alignment
         # and https://github.com/MRtrix3/mrtrix3/issues/957
-        node_construction_str = f"{indent}auto grad_node = std::shared_ptr<{grad_node_name}>(new {grad_node_name}({num_backward_inputs}, {num_backward_outputs})); // NOLINT"
-        node_assignment_str = f"{indent}grad_node = std::shared_ptr<{grad_node_name}>(new {grad_node_name}({num_backward_inputs}, {num_backward_outputs})); // NOLINT"
+        # MakeGradObject allocates from the grad object pool, whose blocks are aligned to max_align_t
+        # and over-aligned nodes fail to compile.
+        node_construction_str = f"{indent}auto grad_node = egr::MakeGradObject<{grad_node_name}>({num_backward_inputs}, {num_backward_outputs});"
+        node_assignment_str = f"{indent}grad_node = egr::MakeGradObject<{grad_node_name}>({num_backward_inputs}, {num_backward_outputs});"
 
         # SetAttributes
         set_attributes_list = []
@@ -1966,6 +1992,22 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
                 inputs_call_args_str_tmp = ", ".join(self.inputs_call_list_tmp)
                 forward_call_str = f"{indent}{api_out_type} api_result = paddle::experimental::{namespace}{function_name}({inputs_call_args_str_tmp});"
 
+        # Recompute
+        set_recompute_str = ""
+        if (
+            forward_api_name in recompute_op_list
+            and not is_inplaced
+            and num_outputs == 1
+            and len(intermediate_outputs) == 0
+        ):
+            out_name = next(iter(forward_outputs_position_map.keys()))
+            set_recompute_str = SET_RECOMPUTE_TEMPLATE.format(
+                forward_api_name,
+                f"&{out_name}",
+                function_name,
+                inputs_call_args_str,
+            )
+
         dygraph_event_str = f'{indent}phi::RecordEvent dygraph_entrance_record_event("{forward_api_name} dygraph", phi::TracerEventType::Operator, 1);\n'
         log_memory_info_str = f'{indent}paddle::memory::LogDeviceMemoryStats(egr::Controller::Instance().GetExpectedPlace(), "{forward_api_name}");'
         forward_ad_function_name = GetDygraphForwardFunctionName(
@@ -2165,6 +2207,7 @@ class DygraphForwardFunctionGenerator(DygraphFunctionGeneratorBase):
                 outputs_autograd_meta_str,
                 check_inplace_str,
                 bump_inplace_version_str,
+                set_recompute_str,
                 node_creation_after_call_str,
                 forward_api_name,
                 log_str,
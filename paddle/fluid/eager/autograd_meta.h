@@ -18,6 +18,8 @@
 #include "paddle/fluid/eager/grad_node_info.h"
 namespace egr {
 
+struct RecomputeInfo;
+
 using AbstractAutogradMeta = paddle::AbstractAutogradMeta;
 /**
  *
@@ -131,6 +133,14 @@ class AutogradMeta : public AbstractAutogradMeta {
 
   void SetRetainGrads(bool value) { retain_grads_ = value; }
 
+  const std::shared_ptr<RecomputeInfo>& GetRecomputeInfo() const {
+    return recompute_info_;
+  }
+
+  void SetRecomputeInfo(const std::shared_ptr<RecomputeInfo>& info) {
+    recompute_info_ = info;
+  }
+
  private:
   // TODO(jiabin) :Should we use pointer instead of object?
   std::shared_ptr<paddle::Tensor> grad_ = std::make_shared<paddle::Tensor>();
@@ -162,6 +172,10 @@ class AutogradMeta : public AbstractAutogradMeta {
 
   bool retain_grads_{false};
 
+  // How to recompute the tensor when its saved copy is dropped, see
+  // RecomputePlanner
+  std::shared_ptr<RecomputeInfo> recompute_info_ = nullptr;
+
   // TODO(jiabin) :Support Quantum here and add cache mechanism as
   // VarCache defined in VarBase
 };
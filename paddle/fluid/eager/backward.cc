@@ -14,10 +14,22 @@
 
 #include "paddle/fluid/eager/backward.h"
 
+#include <functional>
+#include <future>
+
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/general_grad.h"
+#include "paddle/fluid/eager/grad_object_pool.h"
+#include "paddle/fluid/eager/recompute_planner.h"
 #include "paddle/phi/core/memory/stats.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+#include "paddle/phi/core/threadpool.h"
 #include "paddle/phi/kernels/autotune/switch_autotune.h"
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 std::unordered_map<GradNodeBase*, int> getInDegreeMap(
@@ -102,6 +114,233 @@ void DuplicateCheck(const std::vector<paddle::Tensor>& inputs, bool is_input) {
 
 GeneralGrad* GeneralGrad::general_grad_ = new GeneralGrad();
 
+// Adds the grad outputs of node to the GradTensorHolders of its next nodes,
+// and calls on_ready for each next node whose in_degree drops to zero.
+void PrepareNextNodes(
+    GradNodeBase* node,
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>*
+        grad_output_tensors,
+    bool create_graph,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    const std::function<void(GradNodeBase*)>& on_ready) {
+  const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
+      metas = node->OutputMeta();
+  PADDLE_ENFORCE(metas.size() == grad_output_tensors->size() || metas.empty(),
+                 common::errors::Fatal(
+                     "Number of edges should be either empty ( for leaf node "
+                     ") or the same as number of output grad tensors, but we "
+                     "got edges size is: %d, grad_output size is: %d",
+                     metas.size(),
+                     grad_output_tensors->size()));
+
+  for (size_t i = 0; i < metas.size(); i++) {
+    for (size_t j = 0; j < metas[i].size(); j++) {
+      const Edge& edge = metas[i][j].GetEdge();
+      if (!edge.IsInitialized()) {
+        continue;
+      }
+      auto edge_rank = edge.GetEdgeRankInfo();
+      // Since we make edge has as same rank as bwd outputs, we indexing them
+      // with the same rank(i, j)
+      auto next_node_shared = edge.GetMutableGradNode();
+      VLOG(3) << "Node: " << node->name() << " addr:" << node
+              << ", Found pending node: " << next_node_shared->name()
+              << " addr: " << next_node_shared.get();
+      // Next node could be nullptr if it is leaf tensor with no
+      // AccumulationNode attached
+      // Or it could also originated from dispensable inputs
+      if (!next_node_shared || !next_node_shared.get() ||
+          (*grad_output_tensors)[i].empty()) {
+        continue;
+      }
+
+      PADDLE_ENFORCE_LT(
+          j,
+          (*grad_output_tensors)[i].size(),
+          common::errors::Fatal(
+              "Rank of grad_output_tensors should be less than "
+              "grad_output_tensors[i].size(), which is: %d. This error may "
+              "indicate autoprune or autograd api error. ",
+              grad_output_tensors->size()));
+      paddle::Tensor& grad_output_tensor = (*grad_output_tensors)[i][j];
+
+      if ((!grad_output_tensor.defined() ||
+           !grad_output_tensor.initialized())) {
+        VLOG(7) << "We get grad_output_tensor with slot: " << i
+                << ", rank: " << j << " as uninitialized or undefined tensor";
+      }
+
+      VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
+              << ", rank: " << j
+              << " 's name is: " << grad_output_tensor.name();
+
+      auto* next_node = next_node_shared.get();
+      if (!node_input_buffers_dict->count(next_node)) {
+        const auto& input_meta = next_node->InputMeta();
+        auto grad_tensor_holder =
+            std::make_unique<GradTensorHolder>(input_meta);
+        VLOG(7) << "Construct GradTensorHolder for grad node: "
+                << next_node->name();
+        (*node_input_buffers_dict)[next_node] = std::move(grad_tensor_holder);
+      }
+
+      VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
+              << ", rank: " << edge_rank.second;
+
+      (*node_input_buffers_dict)[next_node]->add(edge_rank.first,
+                                                 edge_rank.second,
+                                                 grad_output_tensor,
+                                                 create_graph);
+
+      // Update queue
+      (*node_in_degree_map)[next_node]--;
+      VLOG(7) << next_node->name()
+              << " ref_cnt is: " << (*node_in_degree_map)[next_node];
+
+      PADDLE_ENFORCE(
+          (*node_in_degree_map)[next_node] >= 0,
+          common::errors::Fatal(
+              "Detected in-degree value smaller than zero. For Node: %s"
+              "Node's in-degree cannot be negative.",
+              next_node->name()));
+
+      if ((*node_in_degree_map)[next_node] == 0) {
+        on_ready(next_node);
+      }
+    }
+  }
+}
+
+
+// Set in the threads that run the grad nodes of a parallel backward, a
+// backward started from a hook there runs sequentially instead of waiting on
+// the busy pool.
+static thread_local bool in_parallel_backward = false;
+
+static phi::ThreadPool* BackwardThreadPool() {
+  static std::unique_ptr<phi::ThreadPool> pool(
+      new phi::ThreadPool(FLAGS_eager_backward_num_threads));
+  return pool.get();
+}
+
+// Runs the grad nodes on the backward thread pool once their inputs are
+// ready. The calling thread handles the finished nodes in the order they
+// were started, so the grads are accumulated into the GradTensorHolders in
+// the same order on every run.
+void RunGradNodesParallel(
+    std::deque<GradNodeBase*>* queue,
+    std::unordered_map<GradNodeBase*, std::unique_ptr<GradTensorHolder>>*
+        node_input_buffers_dict,
+    std::unordered_map<GradNodeBase*, int>* node_in_degree_map,
+    bool retain_graph,
+    const phi::Place& place) {
+  struct RunningNode {
+    GradNodeBase* node;
+    std::unique_ptr<GradTensorHolder> input_buffer;
+    paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
+        grad_output_tensors;
+    std::future<std::unique_ptr<common::enforce::EnforceNotMet>> done;
+  };
+  // the grad nodes run with the tracer state of the calling thread
+  auto tracer = egr::Controller::Instance().GetCurrentTracer();
+  bool has_grad = egr::Controller::Instance().HasGrad();
+  auto* pool = BackwardThreadPool();
+
+  // the startup nodes reached from other startup nodes run when ready
+  std::deque<GradNodeBase*> ready;
+  for (auto* node : *queue) {
+    if ((*node_in_degree_map)[node] == 0) {
+      ready.push_back(node);
+    }
+  }
+  queue->clear();
+
+  // deque keeps the running nodes in place while the pool uses them
+  std::deque<RunningNode> running;
+  auto start_node = [&](GradNodeBase* node) {
+    VLOG(3) << "Starting GradNode:" << node->name() << " addr:" << node;
+    auto node_input_buffer_iter = node_input_buffers_dict->find(node);
+    PADDLE_ENFORCE_NE(
+        node_input_buffer_iter,
+        node_input_buffers_dict->end(),
+        common::errors::Fatal(
+            "Unable to find next node in the GradTensorHolder \n"
+            "Trying to run Node without configuring its GradTensorHolder."));
+    EnforceGradNodeHasInput(node);
+    for (auto* observer : egr::Controller::Instance().BackwardRunObservers()) {
+      observer->PreRunGradNode(node);
+    }
+
+    running.emplace_back();
+    RunningNode* task = &running.back();
+    task->node = node;
+    task->input_buffer = std::move(node_input_buffer_iter->second);
+    node_input_buffers_dict->erase(node_input_buffer_iter);
+    task->done = pool->RunAndGetException([task, tracer, has_grad, place]() {
+      in_parallel_backward = true;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      if (phi::is_gpu_place(place)) {
+        phi::backends::gpu::SetDeviceId(place.device);
+      }
+#endif
+      egr::Controller::Instance().SetCurrentTracer(tracer);
+      paddle::imperative::SetCurrentTracer(tracer);
+      egr::Controller::Instance().SetHasGrad(has_grad);
+      phi::RecordEvent grad_node_record_event(
+          "Global_" + std::string(task->node->name()),
+          phi::TracerEventType::Operator,
+          1);
+      task->grad_output_tensors =
+          (*task->node)(task->input_buffer->Buffers(), false, false);
+    });
+  };
+
+  try {
+    while (!ready.empty() || !running.empty()) {
+      while (!ready.empty()) {
+        GradNodeBase* node = ready.front();
+        ready.pop_front();
+        start_node(node);
+      }
+
+      RunningNode& task = running.front();
+      auto ex = task.done.get();
+      if (ex != nullptr) {
+        throw *ex;
+      }
+      if (!retain_graph) {
+        task.node->ClearTensorWrappers();
+      }
+      PrepareNextNodes(task.node,
+                       &task.grad_output_tensors,
+                       false,
+                       node_input_buffers_dict,
+                       node_in_degree_map,
+                       [&ready](GradNodeBase* next_node) {
+                         if (dynamic_cast<egr::GradNodeAccumulation*>(
+                                 next_node)) {
+                           ready.push_front(next_node);
+                         } else {
+                           ready.push_back(next_node);
+                         }
+                       });
+      paddle::memory::LogDeviceMemoryStats(place,
+                                           std::string(task.node->name()));
+      running.pop_front();
+    }
+  } catch (...) {
+    // the pool still uses the nodes that have not finished
+    for (auto& task : running) {
+      if (task.done.valid()) {
+        task.done.wait();
+      }
+    }
+    throw;
+  }
+}
+
 std::vector<paddle::Tensor> RunBackward(
     const std::vector<paddle::Tensor>& tensors,  // output
     const std::vector<paddle::Tensor>& grad_tensors,
@@ -243,6 +482,27 @@ std::vector<paddle::Tensor> RunBackward(
 
   VLOG(5) << "Startup_ops's size is " << queue.size();
 
+  if (FLAGS_eager_backward_num_threads > 0 && !in_parallel_backward &&
+      !is_general_grad && !create_graph && force_sequential_nodes_set.empty() &&
+      egr::Controller::Instance().GetAMPLevel() ==
+          paddle::imperative::AmpLevel::O0 &&
+      (phi::is_cpu_place(place) || phi::is_gpu_place(place))) {
+    // Consumes the queue, the topological visit below has nothing left to run
+    RunGradNodesParallel(&queue,
+                         &node_input_buffers_dict,
+                         &node_in_degree_map,
+                         retain_graph,
+                         place);
+  }
+
+  auto add_next_node_func = [&queue](GradNodeBase* next_node) {
+    if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
+      queue.push_front(next_node);
+    } else {
+      queue.push_back(next_node);
+    }
+  };
+
   /* --- Topological Visit --- */
   // 1. Pop queue
   // 2. Run node
@@ -291,6 +551,10 @@ std::vector<paddle::Tensor> RunBackward(
         phi::TracerEventType::Operator,
         1);
 
+    for (auto* observer : egr::Controller::Instance().BackwardRunObservers()) {
+      observer->PreRunGradNode(node);
+    }
+
     // Run Pre Backward Node and get outputs
     paddle::small_vector<std::vector<paddle::Tensor>, kSlotSmallVectorSize>
         grad_output_tensors = (*node)(
@@ -312,119 +576,38 @@ std::vector<paddle::Tensor> RunBackward(
     node_input_buffers_dict.erase(node_input_buffer_iter);
 
     // Prepare GradTensorHolder for next node
-    const paddle::small_vector<std::vector<GradSlotMeta>, kSlotSmallVectorSize>&
-        metas = node->OutputMeta();
-    PADDLE_ENFORCE(metas.size() == grad_output_tensors.size() || metas.empty(),
-                   common::errors::Fatal(
-                       "Number of edges should be either empty ( for leaf node "
-                       ") or the same as number of output grad tensors, but we "
-                       "got edges size is: %d, grad_output size is: %d",
-                       metas.size(),
-                       grad_output_tensors.size()));
-
-    for (size_t i = 0; i < metas.size(); i++) {
-      for (size_t j = 0; j < metas[i].size(); j++) {
-        const Edge& edge = metas[i][j].GetEdge();
-        if (!edge.IsInitialized()) {
-          continue;
-        }
-        auto edge_rank = edge.GetEdgeRankInfo();
-        // Since we make edge has as same rank as bwd outputs, we indexing them
-        // with the same rank(i, j)
-        auto next_node_shared = edge.GetMutableGradNode();
-        VLOG(3) << "Node: " << node->name() << " addr:" << node
-                << ", Found pending node: " << next_node_shared->name()
-                << " addr: " << next_node_shared.get();
-        // Next node could be nullptr if it is leaf tensor with no
-        // AccumulationNode attached
-        // Or it could also originated from dispensable inputs
-        if (!next_node_shared || !next_node_shared.get() ||
-            grad_output_tensors[i].empty()) {
-          continue;
-        }
-
-        PADDLE_ENFORCE_LT(
-            j,
-            grad_output_tensors[i].size(),
-            common::errors::Fatal(
-                "Rank of grad_output_tensors should be less than "
-                "grad_output_tensors[i].size(), which is: %d. This error may "
-                "indicate autoprune or autograd api error. ",
-                grad_output_tensors.size()));
-        paddle::Tensor& grad_output_tensor = grad_output_tensors[i][j];
-
-        if ((!grad_output_tensor.defined() ||
-             !grad_output_tensor.initialized())) {
-          VLOG(7) << "We get grad_output_tensor with slot: " << i
-                  << ", rank: " << j << " as uninitialized or undefined tensor";
-        }
-
-        VLOG(7) << "Get Edge and grad_output_tensor with slot: " << i
-                << ", rank: " << j
-                << " 's name is: " << grad_output_tensor.name();
-
-        auto* next_node = next_node_shared.get();
-        if (!node_input_buffers_dict.count(next_node)) {
-          const auto& input_meta = next_node->InputMeta();
-          auto grad_tensor_holder =
-              std::make_unique<GradTensorHolder>(input_meta);
-          VLOG(7) << "Construct GradTensorHolder for grad node: "
-                  << next_node->name();
-          node_input_buffers_dict[next_node] = std::move(grad_tensor_holder);
-        }
-
-        VLOG(3) << "Sum or Move grad inputs for edge slot: " << edge_rank.first
-                << ", rank: " << edge_rank.second;
-
-        node_input_buffers_dict[next_node]->add(edge_rank.first,
-                                                edge_rank.second,
-                                                grad_output_tensor,
-                                                create_graph);
-
-        // Update queue
-        node_in_degree_map[next_node]--;
-        VLOG(7) << next_node->name()
-                << " ref_cnt is: " << node_in_degree_map[next_node];
-
-        PADDLE_ENFORCE(
-            node_in_degree_map[next_node] >= 0,
-            common::errors::Fatal(
-                "Detected in-degree value smaller than zero. For Node: %s"
-                "Node's in-degree cannot be negative.",
-                next_node->name()));
-
-        auto add_next_node_func = [&queue](GradNodeBase* next_node) {
-          if (dynamic_cast<egr::GradNodeAccumulation*>(next_node)) {
-            queue.push_front(next_node);
-          } else {
-            queue.push_back(next_node);
-          }
-        };
-        if (node_in_degree_map[next_node] == 0) {
-          if (force_sequential_nodes_set.count(next_node)) {
-            if (force_sequential_nodes_queue.front() == next_node) {
-              force_sequential_nodes_queue.pop_front();
-              add_next_node_func(next_node);
-              while (ready_force_sequential_nodes.count(
-                  force_sequential_nodes_queue.front())) {
-                ready_force_sequential_nodes.erase(
-                    force_sequential_nodes_queue.front());
-                add_next_node_func(force_sequential_nodes_queue.front());
-                force_sequential_nodes_queue.pop_front();
-              }
-            } else {
-              ready_force_sequential_nodes.insert(next_node);
-              continue;
-            }
-          } else {
-            add_next_node_func(next_node);
-          }
-        }
-      }
-    }
+    PrepareNextNodes(node,
+                     &grad_output_tensors,
+                     create_graph,
+                     &node_input_buffers_dict,
+                     &node_in_degree_map,
+                     [&](GradNodeBase* next_node) {
+                       if (!force_sequential_nodes_set.count(next_node)) {
+                         add_next_node_func(next_node);
+                         return;
+                       }
+                       if (force_sequential_nodes_queue.front() != next_node) {
+                         ready_force_sequential_nodes.insert(next_node);
+                         return;
+                       }
+                       force_sequential_nodes_queue.pop_front();
+                       add_next_node_func(next_node);
+                       while (ready_force_sequential_nodes.count(
+                           force_sequential_nodes_queue.front())) {
+                         ready_force_sequential_nodes.erase(
+                             force_sequential_nodes_queue.front());
+                         add_next_node_func(
+                             force_sequential_nodes_queue.front());
+                         force_sequential_nodes_queue.pop_front();
+                       }
+                     });
     paddle::memory::LogDeviceMemoryStats(place, std::string((*node).name()));
   }
 
+  for (auto* observer : egr::Controller::Instance().BackwardRunObservers()) {
+    observer->PostBackward();
+  }
+
   VLOG(7) << "Run Backward Final hook size: "
           << egr::Controller::Instance().FinalBackwardHooks().size();
   for (auto& hook : egr::Controller::Instance().FinalBackwardHooks()) {
@@ -443,6 +626,8 @@ void Backward(const std::vector<paddle::Tensor>& tensors,  // outputs
   phi::RecordEvent backward_record_event(
       "backward", phi::TracerEventType::UserDefined, 1);
   RunBackward(tensors, grad_tensors, retain_graph);
+  RecomputePlanner::Instance().EndStep();
+  GradObjectPool::EndStep();
   egr::Controller::Instance().ClearForceSequentialNodes();
   phi::autotune::AutoTuneStatus::Instance().Update();
 }
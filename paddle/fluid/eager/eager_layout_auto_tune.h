@@ -14,9 +14,14 @@
 
 #pragma once
 
+#include <chrono>
+#include <sstream>
+
 #include "paddle/fluid/eager/api/generated/eager_generated/forwards/dygraph_functions.h"
 #include "paddle/fluid/eager/eager_layout_transformer.h"
 #include "paddle/fluid/imperative/layout_autotune.h"
+#include "paddle/phi/api/include/api.h"
+#include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 namespace egr {
 inline bool NeedTransLayout(
@@ -100,6 +105,69 @@ inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
   }
   return std::make_shared<EagerLightlyLayoutSensitiveOpTransformer>(op_name);
 }
+// Times the conv2d of input and filter in NCHW and in NHWC on the gpu and
+// returns the faster layout, UNDEFINED if it can not be measured. The conv of
+// stride 1 keeping the spatial size stands for the conv of the model, whose
+// other attributes are not known here.
+inline phi::DataLayout MeasureConvLayout(const paddle::Tensor& input,
+                                         const paddle::Tensor& filter,
+                                         const std::string& data_format) {
+  if (!phi::is_gpu_place(input.place()) || input.shape().size() != 4 ||
+      filter.shape().size() != 4 ||
+      (data_format != "NCHW" && data_format != "NHWC")) {
+    return phi::DataLayout::UNDEFINED;
+  }
+  auto& layout_autotune = paddle::imperative::LayoutAutoTune::Instance();
+  std::stringstream key;
+  key << "conv2d/" << phi::DataTypeToString(input.dtype()) << "/"
+      << data_format;
+  for (auto dim : input.shape()) {
+    key << "/" << dim;
+  }
+  for (auto dim : filter.shape()) {
+    key << "/" << dim;
+  }
+  phi::DataLayout faster = phi::DataLayout::UNDEFINED;
+  if (layout_autotune.GetMeasuredLayout(key.str(), &faster)) {
+    VLOG(3) << "LayoutAutoTune uses the measured layout " << faster << " of "
+            << key.str();
+    return faster;
+  }
+
+  bool is_nhwc = data_format == "NHWC";
+  auto nchw_input =
+      is_nhwc ? paddle::experimental::transpose(input, {0, 3, 1, 2}) : input;
+  auto nhwc_input =
+      is_nhwc ? input : paddle::experimental::transpose(input, {0, 2, 3, 1});
+  int groups = static_cast<int>(nchw_input.shape()[1] / filter.shape()[1]);
+  std::vector<int> paddings = {static_cast<int>(filter.shape()[2] / 2),
+                               static_cast<int>(filter.shape()[3] / 2)};
+  auto* dev_ctx = phi::DeviceContextPool::Instance().Get(input.place());
+  auto time_conv = [&](const paddle::Tensor& x, const std::string& format) {
+    constexpr int kRepeat = 3;
+    // the first run also selects the kernel algorithm
+    paddle::experimental::conv2d(
+        x, filter, {1, 1}, paddings, "EXPLICIT", {1, 1}, groups, format);
+    dev_ctx->Wait();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < kRepeat; ++i) {
+      paddle::experimental::conv2d(
+          x, filter, {1, 1}, paddings, "EXPLICIT", {1, 1}, groups, format);
+    }
+    dev_ctx->Wait();
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  };
+  double nchw_us = time_conv(nchw_input, "NCHW");
+  double nhwc_us = time_conv(nhwc_input, "NHWC");
+  faster = nhwc_us < nchw_us ? phi::DataLayout::NHWC : phi::DataLayout::NCHW;
+  VLOG(3) << "LayoutAutoTune measures " << key.str() << ", NCHW: " << nchw_us
+          << " us, NHWC: " << nhwc_us << " us";
+  layout_autotune.SetMeasuredLayout(key.str(), faster);
+  return faster;
+}
+
 template <>
 inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
     const std::string& op_name,
@@ -121,6 +189,14 @@ inline std::shared_ptr<EagerLayoutTransformer> EagerLayoutAutotune(
       bool is_tune_fp16 = (data_type == phi::DataType::FLOAT16 ||
                            data_type == phi::DataType::BFLOAT16) &&
                           (*attr == "NCHW");
+      if (paddle::imperative::LayoutAutoTune::Instance().IsMeasureEnabled()) {
+        auto faster = MeasureConvLayout(
+            tensors_vector[0][0], tensors_vector[1][0], *attr);
+        if (faster != phi::DataLayout::UNDEFINED) {
+          is_tune_fp32 = *attr == "NHWC" && faster == phi::DataLayout::NCHW;
+          is_tune_fp16 = *attr == "NCHW" && faster == phi::DataLayout::NHWC;
+        }
+      }
       VLOG(4) << "LayoutAutoTune assert with dtype and layout, Current op : "
               << op_name;
       if (is_tune_fp32) {
@@ -247,6 +247,7 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
   explicit EagerLightlyLayoutSensitiveOpTransformer(
       const std::string& op_name) {
     VLOG(4) << "Lightly op : " << op_name;
+    op_name_ = op_name;
     auto desired_layout = DesiredLayout();
     final_layout_ = common::DataLayoutToString(desired_layout);
   }
@@ -257,6 +258,8 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
     std::string input_layout = common::DataLayoutToString(in.layout());
     auto default_layout = DefaultLayout();
     if (final_layout_ == input_layout && in.shape().size() == 4) {
+      paddle::imperative::LayoutAutoTune::Instance().RecordTransposeBack(
+          op_name_);
       auto out_tensor = EagerTraceTransposeOp(phi::DataLayout::UNDEFINED, in);
       phi::DenseTensorUtils::GetMutableMeta(
           static_cast<phi::DenseTensor*>(out_tensor.impl().get()))
@@ -275,6 +278,8 @@ class EagerLightlyLayoutSensitiveOpTransformer : public EagerLayoutTransformer {
     for (size_t i = 0; i < in.size(); i++) {
       auto in_tensor = in[i];
       if (in_tensor.layout() == desired_layout) {
+        paddle::imperative::LayoutAutoTune::Instance().RecordTransposeBack(
+            op_name_);
         auto out_tensor =
             EagerTraceTransposeOp(phi::DataLayout::UNDEFINED, in_tensor);
         phi::DenseTensorUtils::GetMutableMeta(
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/grad_object_pool.h"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(eager_grad_object_pool_capacity);
+
+namespace egr {
+
+namespace {
+
+// the blocks are rounded up to the multiples of kClassBytes, the larger
+// ones are not pooled
+constexpr size_t kClassBytes = 64;
+constexpr size_t kNumClasses = 64;
+
+enum class FreeListsState : int { kNone, kAlive, kDestroyed };
+
+// trivially destructible, so it can still be read while the thread exits
+thread_local FreeListsState free_lists_state = FreeListsState::kNone;
+
+struct FreeLists {
+  FreeLists() { free_lists_state = FreeListsState::kAlive; }
+
+  ~FreeLists() {
+    free_lists_state = FreeListsState::kDestroyed;
+    for (auto& list : lists) {
+      for (void* block : list) {
+        ::operator delete(block);
+      }
+    }
+  }
+
+  std::array<std::vector<void*>, kNumClasses> lists;
+};
+
+FreeLists& ThreadFreeLists() {
+  thread_local FreeLists free_lists;
+  return free_lists;
+}
+
+std::atomic<int64_t> step_allocated{0};
+std::atomic<int64_t> step_reused{0};
+std::atomic<int64_t> step_bytes{0};
+
+std::mutex stats_mutex;
+GradObjectPool::Stats last_step_stats;
+
+}  // namespace
+
+void* GradObjectPool::Allocate(size_t size) {
+  step_allocated.fetch_add(1, std::memory_order_relaxed);
+  step_bytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+  size_t size_class = (size + kClassBytes - 1) / kClassBytes;
+  if (size_class > kNumClasses) {
+    return ::operator new(size);
+  }
+  // a block of the whole class, it may be pooled when freed
+  if (FLAGS_eager_grad_object_pool_capacity <= 0 ||
+      free_lists_state == FreeListsState::kDestroyed) {
+    return ::operator new(size_class * kClassBytes);
+  }
+  auto& list = ThreadFreeLists().lists[size_class - 1];
+  if (list.empty()) {
+    return ::operator new(size_class * kClassBytes);
+  }
+  step_reused.fetch_add(1, std::memory_order_relaxed);
+  void* block = list.back();
+  list.pop_back();
+  return block;
+}
+
+void GradObjectPool::Deallocate(void* ptr, size_t size) noexcept {
+  size_t size_class = (size + kClassBytes - 1) / kClassBytes;
+  if (size_class > kNumClasses ||
+      free_lists_state == FreeListsState::kDestroyed) {
+    ::operator delete(ptr);
+    return;
+  }
+  auto& list = ThreadFreeLists().lists[size_class - 1];
+  if (list.size() >=
+      static_cast<size_t>(FLAGS_eager_grad_object_pool_capacity)) {
+    ::operator delete(ptr);
+    return;
+  }
+  list.push_back(ptr);
+}
+
+void GradObjectPool::EndStep() {
+  Stats stats;
+  stats.allocated = step_allocated.exchange(0, std::memory_order_relaxed);
+  stats.reused = step_reused.exchange(0, std::memory_order_relaxed);
+  stats.bytes = step_bytes.exchange(0, std::memory_order_relaxed);
+  VLOG(6) << "Grad graph objects of the step: " << stats.allocated
+          << " allocated, " << stats.reused << " reused, " << stats.bytes
+          << " bytes";
+  std::lock_guard<std::mutex> guard(stats_mutex);
+  last_step_stats = stats;
+}
+
+GradObjectPool::Stats GradObjectPool::LastStepStats() {
+  std::lock_guard<std::mutex> guard(stats_mutex);
+  return last_step_stats;
+}
+
+}  // namespace egr
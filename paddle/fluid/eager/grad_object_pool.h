@@ -0,0 +1,95 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * GradObjectPool caches the memory of the grad graph objects, the GradNodes
+ * built by each forward op and the AutogradMeta of their outputs, so that
+ * the next step reuses the blocks freed after the backward instead of going
+ * to malloc again.
+ *
+ * The blocks are kept in free lists of a few size classes for each thread,
+ * see FLAGS_eager_grad_object_pool_capacity. A block freed by another thread,
+ * e.g. by the backward, goes to the free lists of that thread.
+ *
+ * MakeGradObject creates the object and the control block of its shared_ptr
+ * in one pooled block.
+ **/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace egr {
+
+class GradObjectPool {
+ public:
+  struct Stats {
+    // the blocks requested and the ones served from the free lists
+    int64_t allocated = 0;
+    int64_t reused = 0;
+    int64_t bytes = 0;
+  };
+
+  static void* Allocate(size_t size);
+
+  static void Deallocate(void* ptr, size_t size) noexcept;
+
+  // Called at the end of each backward.
+  static void EndStep();
+
+  // The stats of the last finished step.
+  static Stats LastStepStats();
+};
+
+template <typename T>
+class GradObjectAllocator {
+ public:
+  using value_type = T;
+
+  GradObjectAllocator() = default;
+
+  template <typename U>
+  GradObjectAllocator(const GradObjectAllocator<U>&) {}  // NOLINT
+
+  T* allocate(size_t n) {
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "Over-aligned grad graph objects can not be pooled.");
+    return static_cast<T*>(GradObjectPool::Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) noexcept {
+    GradObjectPool::Deallocate(ptr, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const GradObjectAllocator<U>&) const {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const GradObjectAllocator<U>&) const {
+    return false;
+  }
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeGradObject(Args&&... args) {
+  return std::allocate_shared<T>(GradObjectAllocator<T>(),
+                                 std::forward<Args>(args)...);
+}
+
+}  // namespace egr
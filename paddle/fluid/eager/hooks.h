@@ -35,6 +35,17 @@ class VoidHook {
   virtual void operator()() = 0;
 };
 
+class GradNodeBase;
+
+// Observes the runs of the backward engine, e.g. to materialize the sharded
+// parameters a GradNode reads right before it runs.
+class BackwardRunObserver {
+ public:
+  virtual ~BackwardRunObserver() = default;
+  virtual void PreRunGradNode(GradNodeBase* node) = 0;
+  virtual void PostBackward() = 0;
+};
+
 class CppTensorHook : public TensorHook {
  public:
   explicit CppTensorHook(
@@ -0,0 +1,167 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/recompute_planner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/fluid/eager/autograd_meta.h"
+#include "paddle/fluid/eager/utils.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+COMMON_DECLARE_int64(eager_recompute_memory_budget_mb);
+COMMON_DECLARE_int32(eager_recompute_profile_steps);
+
+namespace egr {
+
+RecomputePlanner& RecomputePlanner::Instance() {
+  static RecomputePlanner* planner = new RecomputePlanner();
+  return *planner;
+}
+
+bool RecomputePlanner::IsEnabled() const {
+  return FLAGS_eager_recompute_memory_budget_mb > 0;
+}
+
+void RecomputePlanner::SetRecompute(const char* op_name,
+                                    paddle::Tensor* out,
+                                    std::function<paddle::Tensor()> fn) {
+  if (!out->initialized()) {
+    return;
+  }
+  bool profiling = false;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (planned_ && dropped_ops_.count(op_name) == 0) {
+      return;
+    }
+    profiling = !planned_;
+  }
+
+  if (profiling) {
+    // run the op once more to know what recomputing it costs
+    auto* dev_ctx = phi::DeviceContextPool::Instance().Get(out->place());
+    dev_ctx->Wait();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    dev_ctx->Wait();
+    double time_us = std::chrono::duration<double, std::micro>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto& cost = costs_[op_name];
+    ++cost.calls;
+    cost.time_us += time_us;
+  }
+
+  auto info = std::make_shared<RecomputeInfo>();
+  info->op_name = op_name;
+  info->fn = std::move(fn);
+  EagerUtils::autograd_meta(out)->SetRecomputeInfo(info);
+}
+
+std::shared_ptr<RecomputeInfo> RecomputePlanner::OnSaveTensor(
+    const paddle::Tensor& tensor) {
+  if (!tensor.initialized() || !tensor.is_dense_tensor()) {
+    return nullptr;
+  }
+  auto* autograd_meta = EagerUtils::nullable_autograd_meta(tensor);
+  auto info = autograd_meta ? autograd_meta->GetRecomputeInfo() : nullptr;
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (planned_) {
+    return info;
+  }
+  auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor.impl().get());
+  int64_t bytes = dense_tensor->numel() *
+                  static_cast<int64_t>(phi::SizeOf(dense_tensor->dtype()));
+  step_saved_bytes_ += bytes;
+  if (info) {
+    auto& cost = costs_[info->op_name];
+    ++cost.saves;
+    cost.bytes += bytes;
+  }
+  return nullptr;
+}
+
+void RecomputePlanner::EndStep() {
+  if (!IsEnabled()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (planned_) {
+    return;
+  }
+  max_saved_bytes_ = std::max(max_saved_bytes_, step_saved_bytes_);
+  step_saved_bytes_ = 0;
+  if (++step_ >= FLAGS_eager_recompute_profile_steps) {
+    Plan();
+  }
+}
+
+void RecomputePlanner::Plan() {
+  planned_ = true;
+  int64_t budget = FLAGS_eager_recompute_memory_budget_mb << 20;
+  int64_t excess = max_saved_bytes_ - budget;
+  if (excess <= 0) {
+    VLOG(1) << "Saved tensors of " << max_saved_bytes_
+            << " bytes fit the budget, no recompute";
+    return;
+  }
+
+  struct Candidate {
+    std::string op_name;
+    int64_t bytes;
+    double time_us;
+  };
+  std::vector<Candidate> candidates;
+  int steps = std::max(step_, 1);
+  for (auto& item : costs_) {
+    const OpCost& cost = item.second;
+    if (cost.saves == 0 || cost.calls == 0) {
+      continue;
+    }
+    // the bytes freed and the time spent per step when the op is dropped
+    candidates.push_back(
+        {item.first,
+         cost.bytes / steps,
+         cost.time_us / cost.calls * cost.saves / steps});
+  }
+  std::sort(candidates.begin(),
+            candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.time_us * b.bytes < b.time_us * a.bytes;
+            });
+
+  for (auto& candidate : candidates) {
+    if (excess <= 0) {
+      break;
+    }
+    dropped_ops_.insert(candidate.op_name);
+    excess -= candidate.bytes;
+    VLOG(1) << "Recompute " << candidate.op_name << " in the backward, frees "
+            << candidate.bytes << " bytes for " << candidate.time_us
+            << " us per step";
+  }
+  if (excess > 0) {
+    LOG(WARNING) << "Saved tensors still exceed the recompute memory budget "
+                 << "by " << excess << " bytes";
+  }
+}
+
+}  // namespace egr
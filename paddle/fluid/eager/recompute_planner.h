@@ -0,0 +1,89 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * RecomputePlanner decides which activations saved by TensorWrapper are
+ * dropped in the forward and recomputed in the backward, so that the saved
+ * tensors of a step fit FLAGS_eager_recompute_memory_budget_mb.
+ *
+ * During the first FLAGS_eager_recompute_profile_steps steps it records the
+ * bytes saved for the outputs of each recomputable op and the time to run
+ * the op again. Then it drops the outputs of the ops that free the most
+ * memory per unit of recompute time, until the rest fits the budget.
+ *
+ * The generated forward functions register the recompute function of the
+ * recomputable ops, see recompute_op_list in eager_gen.py.
+ **/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "paddle/phi/api/include/tensor.h"
+
+namespace egr {
+
+// Recomputes the output of a forward op from the inputs.
+struct RecomputeInfo {
+  std::string op_name;
+  std::function<paddle::Tensor()> fn;
+};
+
+class RecomputePlanner {
+ public:
+  static RecomputePlanner& Instance();
+
+  bool IsEnabled() const;
+
+  // Registers fn to recompute the output out of op_name, it is only kept
+  // when out may be dropped.
+  void SetRecompute(const char* op_name,
+                    paddle::Tensor* out,
+                    std::function<paddle::Tensor()> fn);
+
+  // Called when the tensor is saved for the backward, returns how to
+  // recompute it when the plan drops it, otherwise nullptr.
+  std::shared_ptr<RecomputeInfo> OnSaveTensor(const paddle::Tensor& tensor);
+
+  // Called at the end of each backward.
+  void EndStep();
+
+ private:
+  RecomputePlanner() = default;
+
+  void Plan();
+
+  struct OpCost {
+    int64_t calls = 0;
+    double time_us = 0;
+    int64_t saves = 0;
+    int64_t bytes = 0;
+  };
+
+  std::mutex mutex_;
+  int step_ = 0;
+  bool planned_ = false;
+  // the bytes saved in the current step and the most of any profiled step
+  int64_t step_saved_bytes_ = 0;
+  int64_t max_saved_bytes_ = 0;
+  std::unordered_map<std::string, OpCost> costs_;
+  std::unordered_set<std::string> dropped_ops_;
+};
+
+}  // namespace egr
@@ -0,0 +1,190 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/eager/tensor_offload.h"
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/api/profiler/event.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/cuda_stream.h"
+#endif
+
+COMMON_DECLARE_int64(eager_offload_saved_tensor_min_bytes);
+COMMON_DECLARE_int32(eager_offload_prefetch_num);
+
+namespace egr {
+
+OffloadedTensor::OffloadedTensor() = default;
+
+OffloadedTensor::~OffloadedTensor() = default;
+
+TensorOffloader& TensorOffloader::Instance() {
+  static TensorOffloader* offloader = new TensorOffloader();
+  return *offloader;
+}
+
+bool TensorOffloader::NeedOffload(const paddle::Tensor& tensor) const {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (FLAGS_eager_offload_saved_tensor_min_bytes <= 0 ||
+      !tensor.initialized() || !tensor.is_dense_tensor() ||
+      !phi::is_gpu_place(tensor.place())) {
+    return false;
+  }
+  auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor.impl().get());
+  if (!dense_tensor->meta().is_contiguous()) {
+    return false;
+  }
+  return dense_tensor->numel() *
+             static_cast<int64_t>(phi::SizeOf(dense_tensor->dtype())) >=
+         FLAGS_eager_offload_saved_tensor_min_bytes;
+#else
+  return false;
+#endif
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+static gpuStream_t ComputeStream(const phi::Place& place) {
+  return static_cast<phi::GPUContext*>(
+             phi::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+
+// Makes stream wait for the kernels issued to the compute stream so far.
+static void WaitComputeStream(const phi::Place& place,
+                              phi::CUDAStream* stream) {
+  phi::CudaEvent ready;
+  ready.Record(ComputeStream(place));
+  stream->WaitEvent(ready.GetRawCudaEvent());
+}
+
+phi::CUDAStream* TensorOffloader::OffloadStream(const phi::Place& place) {
+  auto& stream = streams_[place.GetDeviceId()];
+  if (!stream) {
+    stream = std::make_unique<phi::CUDAStream>(
+        place, 0, phi::CUDAStream::StreamFlag::kStreamNonBlocking);
+  }
+  return stream.get();
+}
+
+void TensorOffloader::Prefetch(OffloadedTensor* offloaded) {
+  auto* stream = OffloadStream(offloaded->place);
+  gpuStream_t compute_stream = ComputeStream(offloaded->place);
+  // allocated for the compute stream, the copy waits for the kernels that
+  // used the memory before
+  offloaded->prefetched = paddle::memory::AllocShared(
+      offloaded->place,
+      offloaded->size,
+      phi::Stream(reinterpret_cast<phi::StreamId>(compute_stream)));
+  WaitComputeStream(offloaded->place, stream);
+  paddle::memory::Copy(phi::GPUPlace(offloaded->place.GetDeviceId()),
+                       offloaded->prefetched->ptr(),
+                       phi::GPUPinnedPlace(),
+                       offloaded->host->ptr(),
+                       offloaded->size,
+                       stream->raw_stream());
+  paddle::memory::RecordStream(offloaded->prefetched, stream->raw_stream());
+  offloaded->prefetch_event = std::make_unique<phi::CudaEvent>();
+  offloaded->prefetch_event->Record(stream->raw_stream());
+}
+
+void TensorOffloader::PrefetchBefore(uint64_t id) {
+  int num = FLAGS_eager_offload_prefetch_num;
+  auto iter = offloaded_.lower_bound(id);
+  while (num > 0 && iter != offloaded_.begin()) {
+    --iter;
+    auto offloaded = iter->second.lock();
+    if (!offloaded) {
+      iter = offloaded_.erase(iter);
+      continue;
+    }
+    if (!offloaded->prefetched) {
+      Prefetch(offloaded.get());
+    }
+    --num;
+  }
+}
+#endif
+
+std::shared_ptr<OffloadedTensor> TensorOffloader::Offload(
+    const paddle::Tensor& tensor) {
+  auto offloaded = std::make_shared<OffloadedTensor>();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  auto* dense_tensor = static_cast<phi::DenseTensor*>(tensor.impl().get());
+  offloaded->place = tensor.place();
+  offloaded->size = dense_tensor->numel() * phi::SizeOf(dense_tensor->dtype());
+  offloaded->host =
+      paddle::memory::AllocShared(phi::GPUPinnedPlace(), offloaded->size);
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto* stream = OffloadStream(offloaded->place);
+  WaitComputeStream(offloaded->place, stream);
+  paddle::memory::Copy(phi::GPUPinnedPlace(),
+                       offloaded->host->ptr(),
+                       phi::GPUPlace(offloaded->place.GetDeviceId()),
+                       dense_tensor->data(),
+                       offloaded->size,
+                       stream->raw_stream());
+  offloaded->offload_event = std::make_unique<phi::CudaEvent>();
+  offloaded->offload_event->Record(stream->raw_stream());
+  // the allocator keeps the device memory until the copy is done, without a
+  // stream safe allocator the copy has to finish here
+  if (!paddle::memory::RecordStream(dense_tensor->Holder(),
+                                    stream->raw_stream())) {
+    offloaded->offload_event->Synchronize();
+  }
+
+  offloaded->id = next_id_++;
+  offloaded_[offloaded->id] = offloaded;
+  // the tensors of the finished backwards
+  while (!offloaded_.empty() && offloaded_.begin()->second.expired()) {
+    offloaded_.erase(offloaded_.begin());
+  }
+  VLOG(6) << "Offload saved tensor " << offloaded->id << " of "
+          << offloaded->size << " bytes to the host";
+#endif
+  return offloaded;
+}
+
+std::shared_ptr<phi::Allocation> TensorOffloader::Reload(
+    OffloadedTensor* offloaded) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!offloaded->prefetched) {
+    Prefetch(offloaded);
+  }
+  std::shared_ptr<phi::Allocation> holder = std::move(offloaded->prefetched);
+  gpuStream_t compute_stream = ComputeStream(offloaded->place);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(
+      compute_stream, offloaded->prefetch_event->GetRawCudaEvent(), 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(
+      compute_stream, offloaded->prefetch_event->GetRawCudaEvent(), 0));
+#endif
+  VLOG(6) << "Reload saved tensor " << offloaded->id << " from the host";
+
+  PrefetchBefore(offloaded->id);
+  return holder;
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "Saved tensors can only be offloaded from the gpu."));
+#endif
+}
+
+}  // namespace egr
@@ -0,0 +1,99 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * TensorOffloader moves the data of the activations saved by TensorWrapper
+ * to pinned host memory, so that the device memory is released once the
+ * forward no longer uses them, see FLAGS_eager_offload_saved_tensor_min_bytes.
+ *
+ * The copies run on a side stream of each device. The backward consumes the
+ * saved tensors about in the reverse order of the forward, so reloading a
+ * tensor also starts to copy back the ones offloaded just before it, see
+ * FLAGS_eager_offload_prefetch_num.
+ **/
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "paddle/phi/api/include/tensor.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/allocator.h"
+
+namespace phi {
+class CudaEvent;
+class CUDAStream;
+}  // namespace phi
+
+namespace egr {
+
+// The host copy of an offloaded tensor.
+struct OffloadedTensor {
+  OffloadedTensor();
+  ~OffloadedTensor();
+
+  uint64_t id = 0;
+  phi::Place place;
+  size_t size = 0;
+  std::shared_ptr<phi::Allocation> host;
+  // the device copy started ahead by a prefetch
+  std::shared_ptr<phi::Allocation> prefetched;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // recorded on the side stream when the copy to the host or the prefetch
+  // is done
+  std::unique_ptr<phi::CudaEvent> offload_event;
+  std::unique_ptr<phi::CudaEvent> prefetch_event;
+#endif
+};
+
+class TensorOffloader {
+ public:
+  static TensorOffloader& Instance();
+
+  // Whether the saved tensor is a contiguous dense tensor on the gpu that is
+  // large enough to offload.
+  bool NeedOffload(const paddle::Tensor& tensor) const;
+
+  // Starts to copy the tensor to the host, the device memory is released
+  // when the other users of the tensor release it.
+  std::shared_ptr<OffloadedTensor> Offload(const paddle::Tensor& tensor);
+
+  // Returns the data of the tensor on the device, ready to use on the
+  // stream of the device context.
+  std::shared_ptr<phi::Allocation> Reload(OffloadedTensor* offloaded);
+
+ private:
+  TensorOffloader() = default;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  phi::CUDAStream* OffloadStream(const phi::Place& place);
+
+  void Prefetch(OffloadedTensor* offloaded);
+
+  void PrefetchBefore(uint64_t id);
+#endif
+
+  std::mutex mutex_;
+  uint64_t next_id_ = 0;
+  // the offloaded tensors by the order of offloading
+  std::map<uint64_t, std::weak_ptr<OffloadedTensor>> offloaded_;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::unordered_map<int, std::unique_ptr<phi::CUDAStream>> streams_;
+#endif
+};
+
+}  // namespace egr
@@ -27,6 +27,9 @@
 #pragma once
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/grad_node_info.h"
+#include "paddle/fluid/eager/grad_object_pool.h"
+#include "paddle/fluid/eager/recompute_planner.h"
+#include "paddle/fluid/eager/tensor_offload.h"
 #include "paddle/fluid/eager/utils.h"
 #include "paddle/phi/api/lib/utils/allocator.h"
 #ifndef PADDLE_NO_PYTHON
@@ -122,7 +125,35 @@ class TensorWrapper {
         packed_value_ = (*pack_hook)(tensor);
       } else {
 #endif
-        intermidiate_tensor_.set_impl(tensor.impl());
+        if (RecomputePlanner::Instance().IsEnabled()) {
+          recompute_ = RecomputePlanner::Instance().OnSaveTensor(tensor);
+        }
+        if (recompute_) {
+          // Only keep the meta and the inplace version, the data is
+          // recomputed in the backward
+          phi::DenseTensor* dense_tensor =
+              static_cast<phi::DenseTensor*>(tensor.impl().get());
+          auto dropped_tensor = std::make_shared<phi::DenseTensor>(
+              std::make_shared<phi::Allocation>(nullptr, 0, tensor.place()),
+              dense_tensor->meta());
+          dropped_tensor->ShareInplaceVersionCounterWith(*dense_tensor);
+          intermidiate_tensor_.set_impl(dropped_tensor);
+        } else if (TensorOffloader::Instance().NeedOffload(tensor) &&
+                   !EagerUtils::IsLeafTensor(tensor)) {
+          // Only keep the meta and the inplace version on the device
+          phi::DenseTensor* dense_tensor =
+              static_cast<phi::DenseTensor*>(tensor.impl().get());
+          phi::DenseTensorMeta meta = dense_tensor->meta();
+          meta.offset = 0;
+          auto offloaded_tensor = std::make_shared<phi::DenseTensor>(
+              std::make_shared<phi::Allocation>(nullptr, 0, tensor.place()),
+              meta);
+          offloaded_tensor->ShareInplaceVersionCounterWith(*dense_tensor);
+          intermidiate_tensor_.set_impl(offloaded_tensor);
+          offloaded_ = TensorOffloader::Instance().Offload(tensor);
+        } else {
+          intermidiate_tensor_.set_impl(tensor.impl());
+        }
 #ifndef PADDLE_NO_PYTHON
       }
 #endif
@@ -134,9 +165,9 @@ class TensorWrapper {
     }
 
     if (tensor_autograd_meta) {
-      auto autograd_meta =
-          std::make_shared<AutogradMeta>(*tensor_autograd_meta);
+      auto autograd_meta = MakeGradObject<AutogradMeta>(*tensor_autograd_meta);
       autograd_meta->ResetGradNode();
+      autograd_meta->SetRecomputeInfo(nullptr);
       intermidiate_tensor_.set_autograd_meta(autograd_meta);
       weak_grad_node_ = tensor_autograd_meta->GetMutableGradNode();
     }
@@ -191,6 +222,16 @@ class TensorWrapper {
 #endif
 
     paddle::Tensor recovered_tensor = intermidiate_tensor_;
+    if (offloaded_) {
+      auto reloaded_tensor = std::make_shared<phi::DenseTensor>(
+          *static_cast<phi::DenseTensor*>(intermidiate_tensor_.impl().get()));
+      reloaded_tensor->ResetHolder(
+          TensorOffloader::Instance().Reload(offloaded_.get()));
+      recovered_tensor.set_impl(reloaded_tensor);
+    } else if (recompute_) {
+      VLOG(6) << "Recompute saved tensor by " << recompute_->op_name;
+      recovered_tensor.set_impl(recompute_->fn().impl());
+    }
 
     std::shared_ptr<GradNodeBase> new_grad_node = weak_grad_node_.lock();
     if (new_grad_node) {
@@ -204,7 +245,7 @@ class TensorWrapper {
 
     if (intermediate_autograd_meta) {
       auto p_ab_autograd_meta =
-          std::make_shared<AutogradMeta>(*intermediate_autograd_meta);
+          MakeGradObject<AutogradMeta>(*intermediate_autograd_meta);
       if (new_grad_node) {
         p_ab_autograd_meta->SetGradNode(new_grad_node);
       }
@@ -216,7 +257,11 @@ class TensorWrapper {
 
   paddle::Tensor get_intermidiate_tensor() { return intermidiate_tensor_; }
 
-  void clear() { intermidiate_tensor_.reset(); }
+  void clear() {
+    intermidiate_tensor_.reset();
+    offloaded_.reset();
+    recompute_.reset();
+  }
 
  private:
   void check_inplace_version() {
@@ -270,6 +315,10 @@ class TensorWrapper {
   paddle::Tensor intermidiate_tensor_;
   std::weak_ptr<egr::GradNodeBase> weak_grad_node_;
   uint32_t inplace_version_snapshot_ = 0;
+  // the data on the host when the saved tensor is offloaded
+  std::shared_ptr<OffloadedTensor> offloaded_;
+  // how to recompute the saved tensor when the plan drops it
+  std::shared_ptr<RecomputeInfo> recompute_;
 #ifndef PADDLE_NO_PYTHON
   std::shared_ptr<egr::PyObjectHolderBase> packed_value_;
   std::shared_ptr<egr::UnPackHookBase> unpack_hook_;
@@ -161,6 +161,23 @@ static void CheckOutputVarStatus(const paddle::framework::Variable &src_var,
   }
 }
 
+static void ShareTensorIntoVar(const Tensor &tensor,
+                               paddle::framework::Variable *var) {
+  CheckInputVarStatus(tensor);
+  // share tensor
+  auto *tensor_base = tensor.impl().get();
+  if (phi::DenseTensor::classof(tensor_base)) {
+    *var->GetMutable<phi::DenseTensor>() =
+        *static_cast<phi::DenseTensor *>(tensor_base);
+  } else if (phi::SelectedRows::classof(tensor_base)) {
+    *var->GetMutable<phi::SelectedRows>() =
+        *static_cast<phi::SelectedRows *>(tensor_base);
+  } else if (paddle::framework::VariableRefArray::classof(tensor_base)) {
+    *var->GetMutable<paddle::framework::VariableRefArray>() =
+        *static_cast<paddle::framework::VariableRefArray *>(tensor_base);
+  }
+}
+
 static void ShareTensorsIntoScopeWithName(
     const std::vector<Tensor> &tensors,
     const std::vector<std::string> &tensor_names,
@@ -172,24 +189,18 @@ static void ShareTensorsIntoScopeWithName(
         name == paddle::framework::kEmptyVarName) {
       continue;
     }
-    auto *var = scope->Var(name);
-    CheckInputVarStatus(tensors[i]);
-    // share tensor
-    auto tensor_base = tensors[i].impl();
-    if (phi::DenseTensor::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::DenseTensor>();
-      auto t = std::dynamic_pointer_cast<phi::DenseTensor>(tensor_base);
-      *dst_tensor = *t;
-    } else if (phi::SelectedRows::classof(tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<phi::SelectedRows>();
-      auto t = std::dynamic_pointer_cast<phi::SelectedRows>(tensor_base);
-      *dst_tensor = *t;
-    } else if (paddle::framework::VariableRefArray::classof(
-                   tensor_base.get())) {
-      auto *dst_tensor = var->GetMutable<paddle::framework::VariableRefArray>();
-      auto t = std::dynamic_pointer_cast<paddle::framework::VariableRefArray>(
-          tensor_base);
-      *dst_tensor = *t;
+    ShareTensorIntoVar(tensors[i], scope->Var(name));
+  }
+}
+
+// Same as ShareTensorsIntoScopeByValue, with the variables bound by
+// BindVarsByValue. nullptr variables are skipped.
+static void ShareTensorsIntoVars(
+    const std::vector<Tensor> &tensors,
+    const std::vector<paddle::framework::Variable *> &vars) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (vars[i] != nullptr) {
+      ShareTensorIntoVar(tensors[i], vars[i]);
     }
   }
 }
@@ -216,6 +227,36 @@ static void ShareTensorsIntoScopeByValue(
   ShareTensorsIntoScopeWithName(tensors, names, scope);
 }
 
+static void ShareTensorFromVar(const paddle::framework::Variable &var,
+                               Tensor *tensor,
+                               const std::string &name) {
+  CheckOutputVarStatus(var, *tensor);
+  // share tensor
+  if (var.IsType<phi::DenseTensor>()) {
+    auto &src_tensor = var.Get<phi::DenseTensor>();
+    auto *dst_tensor = const_cast<phi::DenseTensor *>(
+        dynamic_cast<const phi::DenseTensor *>(tensor->impl().get()));
+    VLOG(2) << "actually do sharing " << name << " from scope";
+    *dst_tensor = src_tensor;
+  } else if (var.IsType<phi::SelectedRows>()) {
+    auto &src_tensor = var.Get<phi::SelectedRows>();
+    auto *dst_tensor = const_cast<phi::SelectedRows *>(
+        dynamic_cast<const phi::SelectedRows *>(tensor->impl().get()));
+    *dst_tensor = src_tensor;
+  } else if (var.IsType<paddle::framework::VariableRefArray>()) {
+    auto &src_tensor = var.Get<paddle::framework::VariableRefArray>();
+    auto *dst_tensor = const_cast<paddle::framework::VariableRefArray *>(
+        dynamic_cast<const paddle::framework::VariableRefArray *>(
+            tensor->impl().get()));
+    *dst_tensor = src_tensor;
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "The RunProgram(Grad)Op only support output "
+        "variable of type DenseTensor, SelectedRows or VariableRefArray",
+        name));
+  }
+}
+
 static void ShareTensorsFromScopeByValue(
     const std::vector<Tensor *> &tensors,
     const std::vector<::pir::Value> &values,
@@ -237,34 +278,40 @@ static void ShareTensorsFromScopeByValue(
                                  "RunProgram(Grad)Op'"
                                  "s internal scope.",
                                  name));
-    CheckOutputVarStatus(*var, *tensors[i]);
-    // share tensor
-    if (var->IsType<phi::DenseTensor>()) {
-      auto &src_tensor = var->Get<phi::DenseTensor>();
-      auto *dst_tensor = const_cast<phi::DenseTensor *>(
-          dynamic_cast<const phi::DenseTensor *>(tensors[i]->impl().get()));
-      VLOG(2) << "actually do sharing " << name << " from scope";
-      *dst_tensor = src_tensor;
-    } else if (var->IsType<phi::SelectedRows>()) {
-      auto &src_tensor = var->Get<phi::SelectedRows>();
-      auto *dst_tensor = const_cast<phi::SelectedRows *>(
-          dynamic_cast<const phi::SelectedRows *>(tensors[i]->impl().get()));
-      *dst_tensor = src_tensor;
-    } else if (var->IsType<paddle::framework::VariableRefArray>()) {
-      auto &src_tensor = var->Get<paddle::framework::VariableRefArray>();
-      auto *dst_tensor = const_cast<paddle::framework::VariableRefArray *>(
-          dynamic_cast<const paddle::framework::VariableRefArray *>(
-              tensors[i]->impl().get()));
-      *dst_tensor = src_tensor;
-    } else {
-      PADDLE_THROW(common::errors::InvalidArgument(
-          "The RunProgram(Grad)Op only support output "
-          "variable of type DenseTensor, SelectedRows or VariableRefArray",
-          name));
+    ShareTensorFromVar(*var, tensors[i], name);
+  }
+}
+
+// Same as ShareTensorsFromScopeByValue, with the variables bound by
+// BindVarsByValue. nullptr variables are skipped.
+static void ShareTensorsFromVars(
+    const std::vector<Tensor *> &tensors,
+    const std::vector<paddle::framework::Variable *> &vars) {
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (vars[i] != nullptr) {
+      ShareTensorFromVar(*vars[i], tensors[i], tensors[i]->name());
     }
   }
 }
 
+// The variables of values in scope, nullptr for the values without a
+// variable. The variables stay valid as long as scope keeps them, GcScope
+// only frees their memory.
+static std::vector<paddle::framework::Variable *> BindVarsByValue(
+    const std::vector<::pir::Value> &values, paddle::framework::Scope *scope) {
+  auto names = GetNameFromValue(values);
+  std::vector<paddle::framework::Variable *> vars(values.size(), nullptr);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i].impl() == nullptr ||
+        names[i] == paddle::framework::kFakeVarName ||
+        names[i] == paddle::framework::kEmptyVarName) {
+      continue;
+    }
+    vars[i] = scope->FindVar(names[i]);
+  }
+  return vars;
+}
+
 static void ShareTensorsFromScopeWithPartialBlock(
     const std::vector<Tensor *> &tensors,
     const paddle::framework::BlockDesc &forward_global_block,
@@ -409,30 +456,27 @@ inline void PirRunProgramAPI(
 
   VLOG(4) << "global_inner_scope:" << global_inner_scope;
 
-  auto input_values =
+  const auto &input_values =
       PADDLE_GET_CONST(std::vector<::pir::Value>, attrs.at("fx"));
-  auto output_values =
+  const auto &output_values =
       PADDLE_GET_CONST(std::vector<::pir::Value>, attrs.at("fo"));
-  auto middle_values =
-      PADDLE_GET_CONST(std::vector<::pir::Value>, attrs.at("fm"));
-  auto param_values =
+  const auto &param_values =
       PADDLE_GET_CONST(std::vector<::pir::Value>, attrs.at("fp"));
 
-  std::shared_ptr<::pir::Program> forward_program = PADDLE_GET_CONST(
+  const auto &forward_program = PADDLE_GET_CONST(
       std::shared_ptr<::pir::Program>, attrs.at("forward_program"));
-  std::shared_ptr<::pir::Program> backward_program = PADDLE_GET_CONST(
-      std::shared_ptr<::pir::Program>, attrs.at("backward_program"));
 
   VLOG(10) << is_test << program_id;
 
   auto &cache = paddle::framework::InterpreterCoreInfoCache::Instance();
   std::shared_ptr<paddle::framework::InterpreterCore> interpreter_core =
       nullptr;
-  if (!cache.Has(program_id,
-                 global_inner_scope,
-                 place_hash_key,
-                 /*is_grad=*/false,
-                 /*in_pir_mode=*/true)) {
+  // computed once, Find and the creation below use the same key
+  const int64_t cache_key =
+      paddle::framework::InterpreterCoreInfoCache::CacheKey(
+          program_id, global_inner_scope, place_hash_key, /*in_pir_mode=*/true);
+  auto *cached_value = cache.Find(cache_key, /*is_grad=*/false);
+  if (cached_value == nullptr) {
     phi::RecordEvent record_event(
         "create_new_interpretercore", phi::TracerEventType::UserDefined, 1);
     VLOG(2) << "No interpretercore cache, so create a new interpretercore "
@@ -461,8 +505,11 @@ inline void PirRunProgramAPI(
         global_inner_scope,
         place_hash_key,
         in_sot_mode);
+    cached_value = cache.Find(cache_key, /*is_grad=*/false);
     // Step 4. get all eager gc vars (skip_names = backward_inputs -
     // no_need_buffers + outputs)
+    const auto &backward_program = PADDLE_GET_CONST(
+        std::shared_ptr<::pir::Program>, attrs.at("backward_program"));
     std::vector<std::string> skip_names;
     // update interpretercore skip_gc_var
     for (auto &kwarg : backward_program->block()->kwargs()) {
@@ -491,16 +538,17 @@ inline void PirRunProgramAPI(
         "get_interpretercore_cache", phi::TracerEventType::UserDefined, 1);
     VLOG(2) << "Get interpretercore cache by program:" << program_id;
     // Step 1. get cache interpretercore
-    auto &cached_value = cache.GetMutable(program_id,
-                                          global_inner_scope,
-                                          place_hash_key,
-                                          /*is_grad=*/false,
-                                          /*in_pir_mode=*/true);
-    interpreter_core = cached_value.core_;
+    interpreter_core = cached_value->core_;
     // Step 2. update scope for cache interpretercore
-    details::ShareTensorsIntoScopeByValue(x, input_values, global_inner_scope);
-    details::ShareTensorsIntoScopeByValue(
-        params, param_values, global_inner_scope);
+    if (cached_value->vars_bound_) {
+      details::ShareTensorsIntoVars(x, cached_value->input_vars_);
+      details::ShareTensorsIntoVars(params, cached_value->param_vars_);
+    } else {
+      details::ShareTensorsIntoScopeByValue(
+          x, input_values, global_inner_scope);
+      details::ShareTensorsIntoScopeByValue(
+          params, param_values, global_inner_scope);
+    }
     // TODO(xiongkun): new ir how to build scope.
     // if (interpreter_core->GetVariableScope()->GetMutableScope() !=
     // global_inner_scope) {
@@ -522,8 +570,21 @@ inline void PirRunProgramAPI(
     phi::RecordEvent record_event(
         "fetch_and_gc", phi::TracerEventType::UserDefined, 1);
     // Get Output, and Middle Outputs
-    details::ShareTensorsFromScopeByValue(
-        out, output_values, global_inner_scope);
+    if (cached_value->vars_bound_) {
+      details::ShareTensorsFromVars(out, cached_value->output_vars_);
+    } else {
+      details::ShareTensorsFromScopeByValue(
+          out, output_values, global_inner_scope);
+      // all the variables exist after the first run, bind them for the
+      // later runs of the same core in the same scope
+      cached_value->input_vars_ =
+          details::BindVarsByValue(input_values, global_inner_scope);
+      cached_value->param_vars_ =
+          details::BindVarsByValue(param_values, global_inner_scope);
+      cached_value->output_vars_ =
+          details::BindVarsByValue(output_values, global_inner_scope);
+      cached_value->vars_bound_ = true;
+    }
 
     VLOG(3) << paddle::framework::GenScopeTreeDebugInfo(out_scope_vec->front());
 
@@ -16,6 +16,7 @@
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/eager/api/utils/hook_utils.h"
+#include "paddle/fluid/eager/grad_object_pool.h"
 #include "paddle/fluid/eager/grad_node_info.h"
 #include "paddle/fluid/eager/tensor_wrapper.h"
 
@@ -83,7 +84,7 @@ void SetGradOutputDistAttrIter::visit(
 AutogradMeta* EagerUtils::autograd_meta(paddle::Tensor* target) {
   auto* p_autograd_meta = target->get_autograd_meta();
   if (!p_autograd_meta) {
-    auto p_autograd_meta_ptr = std::make_shared<AutogradMeta>();
+    auto p_autograd_meta_ptr = MakeGradObject<AutogradMeta>();
     p_autograd_meta = p_autograd_meta_ptr.get();
     target->set_autograd_meta(p_autograd_meta_ptr);
   }
@@ -25,13 +25,21 @@ limitations under the License. */
 #include <sys/mman.h>
 #include <sys/stat.h>
 #endif
+#include <limits>
+
 #include "io/fs.h"
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/framework/data_feed_columnar.h"
+#include "paddle/fluid/framework/data_feed_text_parser.h"
 #include "paddle/phi/core/platform/monitor.h"
 #include "paddle/phi/core/platform/timer.h"
 
 USE_INT_STAT(STAT_total_feasign_num_in_mem);
 COMMON_DECLARE_bool(enable_ins_parser_file);
+COMMON_DECLARE_int32(slotrecord_parse_thread_num);
+COMMON_DECLARE_string(slotrecord_columnar_cache_dir);
+COMMON_DECLARE_bool(enable_slotrecord_gpu_pass_pack);
+COMMON_DECLARE_bool(slotrecord_gpu_pass_shuffle);
 namespace paddle::framework {
 
 DLManager& global_dlmanager_pool() {
@@ -1319,11 +1327,12 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
     VLOG(3) << line;
     // parse line
     const char* str = line.c_str();
+    const char* line_end = str + line.size();
     char* endptr = const_cast<char*>(str);
     int pos = 0;
     for (size_t i = 0; i < use_slots_index_.size(); ++i) {
       int idx = use_slots_index_[i];
-      int num = strtol(&str[pos], &endptr, 10);
+      int num = static_cast<int>(FastStrtoull(&str[pos], line_end, &endptr));
       PADDLE_ENFORCE_NE(
           num,
           0,
@@ -1344,7 +1353,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
       if (idx != -1) {
         if (all_slots_type_[i][0] == 'f') {  // float
           for (int j = 0; j < num; ++j) {
-            float feasign = strtof(endptr, &endptr);
+            float feasign = FastStrtof(endptr, line_end, &endptr);
             if (fabs(feasign) < 1e-6) {
               continue;
             }
@@ -1354,7 +1363,7 @@ bool MultiSlotInMemoryDataFeed::ParseOneInstance(Record* instance) {
           }
         } else if (all_slots_type_[i][0] == 'u') {  // uint64
           for (int j = 0; j < num; ++j) {
-            uint64_t feasign = (uint64_t)strtoull(endptr, &endptr, 10);
+            uint64_t feasign = FastStrtoull(endptr, line_end, &endptr);
             if (feasign == 0) {
               continue;
             }
@@ -2072,6 +2081,9 @@ SlotRecordInMemoryDataFeed::~SlotRecordInMemoryDataFeed() {  // NOLINT
   for (auto* pack : pack_vec_) {
     pack->set_use_flag(false);
   }
+  if (pass_pack_ != nullptr) {
+    pass_pack_->set_use_flag(false);
+  }
 #endif
 }
 
@@ -2213,6 +2225,8 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemory() {
   VLOG(3) << "SlotRecord LoadIntoMemory() begin, thread_id=" << thread_id_;
   if (!so_parser_name_.empty()) {
     LoadIntoMemoryByLib();
+  } else if (!FLAGS_slotrecord_columnar_cache_dir.empty()) {
+    LoadIntoMemoryByColumnarCache();
   } else {
     LoadIntoMemoryByCommand();
   }
@@ -2416,6 +2430,10 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByLine() {
 
 void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 #ifdef _LINUX
+  if (FLAGS_slotrecord_parse_thread_num > 0) {
+    LoadIntoMemoryByPipeline(FLAGS_slotrecord_parse_thread_num);
+    return;
+  }
   std::string filename;
   BufferedLineFileReader line_reader;
   line_reader.set_sample_rate(sample_rate_);
@@ -2482,6 +2500,264 @@ void SlotRecordInMemoryDataFeed::LoadIntoMemoryByCommand() {
 #endif
 }
 
+std::string SlotRecordInMemoryDataFeed::ColumnarCachePath(
+    const std::string& filename) {
+  // everything that changes the parsed records is part of the key
+  std::string key = filename + "\n" + pipe_command_ + "\n" +
+                    std::to_string(parse_ins_id_) +
+                    std::to_string(parse_logkey_);
+  for (auto& info : all_slots_info_) {
+    key += "\n" + info.slot + ":" + info.type + ":" +
+           std::to_string(info.used_idx);
+  }
+  char name[32];
+  snprintf(name,
+           sizeof(name),
+           "%016llx.slotcol",
+           static_cast<unsigned long long>(  // NOLINT
+               std::hash<std::string>()(key)));
+  return FLAGS_slotrecord_columnar_cache_dir + "/" + name;
+}
+
+// every file is parsed from text once and cached as a columnar file, later
+// loads of the same file with the same slot config mmap it instead
+void SlotRecordInMemoryDataFeed::LoadIntoMemoryByColumnarCache() {
+#ifdef _LINUX
+  std::string filename;
+  BufferedLineFileReader line_reader;
+  line_reader.set_sample_rate(sample_rate_);
+  // sampled lines differ between loads, so they are never cached
+  bool use_cache = (sample_rate_ == 1.0f);
+
+  while (this->PickOneFile(&filename)) {
+    VLOG(3) << "PickOneFile, filename=" << filename
+            << ", thread_id=" << thread_id_;
+    platform::Timer timeline;
+    timeline.Start();
+    std::string cache_path = ColumnarCachePath(filename);
+
+    SlotRecordColumnarReader reader;
+    if (use_cache &&
+        reader.Open(cache_path, uint64_use_slot_size_, float_use_slot_size_)) {
+      int num = 0;
+      size_t records = 0;
+      std::vector<SlotRecord> record_vec;
+      while ((num = reader.NextBlock()) > 0) {
+        SlotRecordPool().get(&record_vec, num);
+        reader.FillBlock(&record_vec[0]);
+        input_channel_->Write(std::move(record_vec));
+        record_vec.clear();
+        records += num;
+      }
+      if (num == 0) {
+        timeline.Pause();
+        VLOG(3) << "LoadIntoMemoryByColumnarCache() mmap file=" << filename
+                << ", cache=" << cache_path << ", records=" << records
+                << ", cost time=" << timeline.ElapsedSec()
+                << " seconds, thread_id=" << thread_id_;
+        continue;
+      }
+      PADDLE_ENFORCE_EQ(
+          records,
+          static_cast<size_t>(0),
+          common::errors::InvalidArgument(
+              "Columnar cache file %s is corrupted after %d records, "
+              "remove it and load again.",
+              cache_path,
+              records));
+      LOG(WARNING) << "columnar cache file " << cache_path
+                   << " is corrupted, parse " << filename << " from text";
+    }
+
+    SlotRecordColumnarWriter writer(uint64_use_slot_size_,
+                                    float_use_slot_size_);
+    bool write_cache = use_cache && writer.Open(cache_path);
+    int lines = 0;
+    std::vector<SlotRecord> record_vec;
+    SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+    int offset = 0;
+
+    do {
+      int err_no = 0;
+      this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+      PADDLE_ENFORCE_EQ(this->fp_ != nullptr,
+                        true,
+                        common::errors::InvalidArgument(
+                            "This fp should not be null, please check!"));
+      __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
+
+      lines = line_reader.read_file(
+          this->fp_.get(),
+          [this, &record_vec, &offset, &filename, &writer, &write_cache](
+              const std::string& line) {
+            if (ParseOneInstance(line, &record_vec[offset])) {
+              ++offset;
+            } else {
+              LOG(WARNING) << "read file:[" << filename
+                           << "] item error, line:[" << line << "]";
+              // the cache would silently drop the line on every later load
+              write_cache = false;
+              return false;
+            }
+            if (offset >= OBJPOOL_BLOCK_SIZE) {
+              if (write_cache) {
+                write_cache = writer.Append(&record_vec[0], offset);
+              }
+              input_channel_->Write(std::move(record_vec));
+              record_vec.clear();
+              SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+              offset = 0;
+            }
+            return true;
+          },
+          lines);
+    } while (line_reader.is_error());
+    if (offset > 0) {
+      if (write_cache) {
+        write_cache = writer.Append(&record_vec[0], offset);
+      }
+      input_channel_->WriteMove(offset, &record_vec[0]);
+      if (offset < OBJPOOL_BLOCK_SIZE) {
+        SlotRecordPool().put(&record_vec[offset],
+                             (OBJPOOL_BLOCK_SIZE - offset));
+      }
+    } else {
+      SlotRecordPool().put(&record_vec);
+    }
+    record_vec.clear();
+    record_vec.shrink_to_fit();
+    if (write_cache) {
+      writer.Commit();
+    } else {
+      writer.Abort();
+    }
+    timeline.Pause();
+    VLOG(3) << "LoadIntoMemoryByColumnarCache() parse file=" << filename
+            << ", lines=" << lines << ", cache=" << cache_path
+            << ", cost time=" << timeline.ElapsedSec()
+            << " seconds, thread_id=" << thread_id_;
+  }
+  VLOG(3) << "LoadIntoMemoryByColumnarCache() end, thread_id=" << thread_id_;
+#endif
+}
+
+// read -> parse -> pack: this thread only reads lines and hands them over
+// in batches, the parse threads turn them into SlotRecords and pack those
+// into OBJPOOL_BLOCK_SIZE blocks of input_channel_
+void SlotRecordInMemoryDataFeed::LoadIntoMemoryByPipeline(
+    int parse_thread_num) {
+#ifdef _LINUX
+  const size_t line_batch_size = 1024;
+  auto line_channel = MakeChannel<std::vector<std::string>>();
+  line_channel->SetCapacity(2 * parse_thread_num);
+
+  std::atomic<size_t> error_lines{0};
+  std::mutex exception_mutex;
+  std::exception_ptr parse_exception = nullptr;
+  std::vector<std::thread> parse_threads;
+  for (int i = 0; i < parse_thread_num; ++i) {
+    parse_threads.emplace_back([this,
+                                &line_channel,
+                                &error_lines,
+                                &exception_mutex,
+                                &parse_exception]() {
+      std::vector<std::string> lines;
+      std::vector<SlotRecord> record_vec;
+      SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+      int offset = 0;
+      try {
+        while (line_channel->Get(lines)) {
+          for (auto& line : lines) {
+            if (ParseOneInstance(line, &record_vec[offset])) {
+              ++offset;
+            } else {
+              ++error_lines;
+              LOG(WARNING) << "parse item error, line:[" << line << "]";
+            }
+            if (offset >= OBJPOOL_BLOCK_SIZE) {
+              input_channel_->Write(std::move(record_vec));
+              record_vec.clear();
+              SlotRecordPool().get(&record_vec, OBJPOOL_BLOCK_SIZE);
+              offset = 0;
+            }
+          }
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(exception_mutex);
+        if (parse_exception == nullptr) {
+          parse_exception = std::current_exception();
+        }
+        // keep draining so the reader never blocks on a full channel
+        while (line_channel->Get(lines)) {
+        }
+      }
+      if (offset > 0) {
+        input_channel_->WriteMove(offset, &record_vec[0]);
+        if (offset < OBJPOOL_BLOCK_SIZE) {
+          SlotRecordPool().put(&record_vec[offset],
+                               (OBJPOOL_BLOCK_SIZE - offset));
+        }
+      } else {
+        SlotRecordPool().put(&record_vec);
+      }
+    });
+  }
+
+  std::string filename;
+  BufferedLineFileReader line_reader;
+  line_reader.set_sample_rate(sample_rate_);
+  while (this->PickOneFile(&filename)) {
+    VLOG(3) << "PickOneFile, filename=" << filename
+            << ", thread_id=" << thread_id_;
+    platform::Timer timeline;
+    timeline.Start();
+    std::vector<std::string> line_batch;
+    line_batch.reserve(line_batch_size);
+
+    int err_no = 0;
+    this->fp_ = fs_open_read(filename, &err_no, this->pipe_command_, true);
+    PADDLE_ENFORCE_EQ(this->fp_ != nullptr,
+                      true,
+                      common::errors::InvalidArgument(
+                          "This fp should not be null, please check!"));
+    __fsetlocking(&*(this->fp_), FSETLOCKING_BYCALLER);
+    int lines = line_reader.read_file(
+        this->fp_.get(),
+        [&line_channel, &line_batch, line_batch_size](
+            const std::string& line) {
+          line_batch.push_back(line);
+          if (line_batch.size() >= line_batch_size) {
+            line_channel->Put(std::move(line_batch));
+            line_batch.clear();
+            line_batch.reserve(line_batch_size);
+          }
+          return true;
+        },
+        0);
+    if (!line_batch.empty()) {
+      line_channel->Put(std::move(line_batch));
+    }
+    timeline.Pause();
+    VLOG(3) << "LoadIntoMemoryByPipeline() read all lines, file=" << filename
+            << ", lines=" << lines
+            << ", sample lines=" << line_reader.get_sample_line()
+            << ", cost time=" << timeline.ElapsedSec()
+            << " seconds, thread_id=" << thread_id_;
+  }
+  line_channel->Close();
+  for (auto& parse_thread : parse_threads) {
+    parse_thread.join();
+  }
+  if (parse_exception != nullptr) {
+    std::rethrow_exception(parse_exception);
+  }
+  VLOG(3) << "LoadIntoMemoryByPipeline() end, thread_id=" << thread_id_
+          << ", parse threads=" << parse_thread_num
+          << ", error lines=" << error_lines.load()
+          << ", total size: " << line_reader.file_size();
+#endif
+}
+
 static void parser_log_key(const std::string& log_key,
                            uint64_t* search_id,
                            uint32_t* cmatch,
@@ -2500,6 +2776,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   SlotRecord& rec = (*ins);
   // parse line
   const char* str = line.c_str();
+  const char* line_end = str + line.size();
   char* endptr = const_cast<char*>(str);
   int pos = 0;
 
@@ -2509,7 +2786,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   slot_uint64_feasigns.resize(uint64_use_slot_size_);
 
   if (parse_ins_id_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(FastStrtoull(&str[pos], line_end, &endptr));
     PADDLE_ENFORCE_EQ(num == 1,
                       true,
                       common::errors::InvalidArgument(
@@ -2523,7 +2800,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
     pos += static_cast<int>(len + 1);
   }
   if (parse_logkey_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(FastStrtoull(&str[pos], line_end, &endptr));
     PADDLE_ENFORCE_EQ(num == 1,
                       true,
                       common::errors::InvalidArgument(
@@ -2551,7 +2828,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
   int uint64_total_slot_num = 0;
 
   for (auto& info : all_slots_info_) {
-    int num = static_cast<int>(strtol(&str[pos], &endptr, 10));
+    int num = static_cast<int>(FastStrtoull(&str[pos], line_end, &endptr));
     PADDLE_ENFORCE(num,
                    "The number of ids can not be zero, you need padding "
                    "it in data generator; or if there is something wrong with "
@@ -2563,7 +2840,7 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         auto& slot_fea = slot_float_feasigns[info.slot_value_idx];
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
-          float feasign = strtof(endptr, &endptr);
+          float feasign = FastStrtof(endptr, line_end, &endptr);
           if (fabs(feasign) < 1e-6 && !used_slots_info_[info.used_idx].dense) {
             continue;
           }
@@ -2574,19 +2851,16 @@ bool SlotRecordInMemoryDataFeed::ParseOneInstance(const std::string& line,
         auto& slot_fea = slot_uint64_feasigns[info.slot_value_idx];
         slot_fea.clear();
         for (int j = 0; j < num; ++j) {
-          uint64_t feasign =
-              static_cast<uint64_t>(strtoull(endptr, &endptr, 10));
+          uint64_t feasign = FastStrtoull(endptr, line_end, &endptr);
           slot_fea.push_back(feasign);
           ++uint64_total_slot_num;
         }
       }
       pos = static_cast<int>(endptr - str);
     } else {
+      // skip the num token and its num values
       for (int j = 0; j <= num; ++j) {
-        // pos = line.find_first_of(' ', pos + 1);
-        while (line[pos + 1] != ' ') {
-          pos++;
-        }
+        pos = static_cast<int>(FindNextSpace(str + pos + 1, line_end) - str);
       }
     }
   }
@@ -2808,6 +3082,9 @@ bool SlotRecordInMemoryDataFeed::Start() {
     pack_vec_.push_back(pack);
     free_pack_queue_.Push(pack);
   }
+  if (FLAGS_enable_slotrecord_gpu_pass_pack) {
+    PackPassToGPU();
+  }
 
   pack_offset_index_.store(0);
   pack_is_end_.store(false);
@@ -2831,7 +3108,13 @@ bool SlotRecordInMemoryDataFeed::Start() {
         auto batch_size = batch.second;
 
         paddle::platform::SetDeviceId(place_.GetDeviceId());
-        pack->pack_instance(&records_[offset], batch_size);
+        if (pass_pack_ != nullptr) {
+          int start = pass_batch_starts_[offset_index];
+          pack->gather_instance(
+              pass_pack_, &pass_records_[start], start, batch_size);
+        } else {
+          pack->pack_instance(&records_[offset], batch_size);
+        }
         this->BuildSlotBatchGPU(batch_size, pack);
         using_pack_queue_.Push(pack);
       }
@@ -3039,11 +3322,11 @@ void SlotRecordInMemoryDataFeed::BuildSlotBatchGPU(const int ins_num,
                 use_slot_size_,
                 dest_gpu_p,
                 (const size_t*)pack->gpu_slot_offsets(),
-                (const uint64_t*)value.d_uint64_keys.data(),
+                pack->uint64_keys(),
                 (const int*)value.d_uint64_offset.data(),
                 (const int*)value.d_uint64_lens.data(),
                 uint64_use_slot_size_,
-                (const float*)value.d_float_keys.data(),
+                pack->float_keys(),
                 (const int*)value.d_float_offset.data(),
                 (const int*)value.d_float_lens.data(),
                 float_use_slot_size_,
@@ -3128,6 +3411,48 @@ void SlotRecordInMemoryDataFeed::PackToScope(MiniBatchGpuPack* pack,
   }
 }
 
+void SlotRecordInMemoryDataFeed::PackPassToGPU() {
+  platform::Timer timeline;
+  timeline.Start();
+  pass_records_.clear();
+  pass_batch_starts_.resize(batch_offsets_.size());
+  size_t uint64_total_num = 0;
+  size_t float_total_num = 0;
+  for (size_t i = 0; i < batch_offsets_.size(); ++i) {
+    auto& batch = batch_offsets_[i];
+    pass_batch_starts_[i] = static_cast<int>(pass_records_.size());
+    for (int k = 0; k < batch.second; ++k) {
+      auto& r = records_[batch.first + k];
+      uint64_total_num += r->slot_uint64_feasigns_.slot_values.size();
+      float_total_num += r->slot_float_feasigns_.slot_values.size();
+      pass_records_.push_back(r);
+    }
+  }
+  PADDLE_ENFORCE_LT(
+      std::max(uint64_total_num, float_total_num),
+      static_cast<size_t>(std::numeric_limits<int>::max()),
+      common::errors::OutOfRange(
+          "The pass of reader %d has %llu uint64 and %llu float values, too "
+          "many to pack on the gpu at once, use more readers or disable "
+          "FLAGS_enable_slotrecord_gpu_pass_pack.",
+          thread_id_,
+          static_cast<unsigned long long>(uint64_total_num),  // NOLINT
+          static_cast<unsigned long long>(float_total_num)));  // NOLINT
+  if (pass_pack_ == nullptr) {
+    pass_pack_ = BatchGpuPackMgr().get(this->GetPlace(), used_slots_info_);
+  }
+  paddle::platform::SetDeviceId(place_.GetDeviceId());
+  pass_pack_->pack_instance(pass_records_.data(),
+                            static_cast<int>(pass_records_.size()));
+  if (FLAGS_slotrecord_gpu_pass_shuffle) {
+    pass_pack_->shuffle_instance(&pass_records_, std::random_device()());
+  }
+  timeline.Pause();
+  VLOG(1) << "reader " << thread_id_ << " packed " << pass_records_.size()
+          << " records of " << batch_offsets_.size()
+          << " batches to gpu, cost " << timeline.ElapsedSec() << " seconds";
+}
+
 MiniBatchGpuPack* SlotRecordInMemoryDataFeed::get_pack(
     MiniBatchGpuPack* last_pack) {
   if (last_pack != nullptr) {
@@ -3348,6 +3673,8 @@ void MiniBatchGpuPack::pack_float_data(const SlotRecord* ins_vec, int num) {
 void MiniBatchGpuPack::pack_instance(const SlotRecord* ins_vec, int num) {
   ins_num_ = num;
   batch_ins_ = ins_vec;
+  pass_pack_ = nullptr;
+  shuffled_ = false;
   PADDLE_ENFORCE_EQ(
       used_uint64_num_ > 0 || used_float_num_ > 0,
       true,
@@ -3361,6 +3688,8 @@ void MiniBatchGpuPack::pack_instance(const SlotRecord* ins_vec, int num) {
   } else {  // only float
     pack_float_data(ins_vec, num);
   }
+  uint64_total_len_ = used_uint64_num_ > 0 ? buf_.h_uint64_lens.back() : 0;
+  float_total_len_ = used_float_num_ > 0 ? buf_.h_float_lens.back() : 0;
   // to gpu
   transfer_to_gpu();
 }
@@ -44,6 +44,7 @@ COMMON_DECLARE_double(gpugraph_hbm_table_load_factor);
 COMMON_DECLARE_bool(enable_graph_multi_node_sampling);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
 COMMON_DECLARE_string(graph_edges_split_mode);
+COMMON_DECLARE_bool(gpugraph_sage_feature_prefetch);
 
 namespace paddle {
 namespace framework {
@@ -473,6 +474,133 @@ void SlotRecordInMemoryDataFeed::CopyForTensor(
   cudaStreamSynchronize(stream);
 }
 
+// gather the offsets of the instances of a batch from the pass, lens gets the
+// start of every instance in the values of the pass
+__global__ void GatherPassInsKernel(const int ins_num,
+                                    const int start,
+                                    const int *perm,
+                                    const int *pass_lens,
+                                    const int *pass_offsets,
+                                    const int cols,
+                                    int *lens,
+                                    int *offsets,
+                                    int *total_len) {
+  CUDA_KERNEL_LOOP(i, ins_num * cols) {
+    int ins_idx = i / cols;
+    int col = i % cols;
+    int pass_idx = perm != nullptr ? perm[start + ins_idx] : start + ins_idx;
+    offsets[i] = pass_offsets[pass_idx * cols + col];
+    if (col == 0) {
+      lens[ins_idx] = pass_lens[pass_idx];
+      atomicAdd(total_len, pass_lens[pass_idx + 1] - pass_lens[pass_idx]);
+    }
+  }
+}
+
+void MiniBatchGpuPack::gather_instance(MiniBatchGpuPack *pass_pack,
+                                       const SlotRecord *ins_vec,
+                                       int start,
+                                       int num) {
+  ins_num_ = num;
+  batch_ins_ = ins_vec;
+  pass_pack_ = pass_pack;
+  shuffled_ = false;
+  uint64_total_len_ = 0;
+  float_total_len_ = 0;
+  if (num == 0) {
+    return;
+  }
+  const int *perm =
+      pass_pack->shuffled_ ? pass_pack->ins_perm_.data() : nullptr;
+  d_total_lens_.resize(2);
+  CUDA_CHECK(
+      cudaMemsetAsync(d_total_lens_.data(), 0, 2 * sizeof(int), stream_));
+  if (used_uint64_num_ > 0) {
+    int cols = used_uint64_num_ + 1;
+    value_.d_uint64_lens.resize(num);
+    value_.d_uint64_offset.resize(num * cols);
+    GatherPassInsKernel<<<GET_BLOCKS(num * cols),
+                          CUDA_NUM_THREADS,
+                          0,
+                          stream_>>>(num,
+                                     start,
+                                     perm,
+                                     pass_pack->value_.d_uint64_lens.data(),
+                                     pass_pack->value_.d_uint64_offset.data(),
+                                     cols,
+                                     value_.d_uint64_lens.data(),
+                                     value_.d_uint64_offset.data(),
+                                     d_total_lens_.data());
+  }
+  if (used_float_num_ > 0) {
+    int cols = used_float_num_ + 1;
+    value_.d_float_lens.resize(num);
+    value_.d_float_offset.resize(num * cols);
+    GatherPassInsKernel<<<GET_BLOCKS(num * cols),
+                          CUDA_NUM_THREADS,
+                          0,
+                          stream_>>>(num,
+                                     start,
+                                     perm,
+                                     pass_pack->value_.d_float_lens.data(),
+                                     pass_pack->value_.d_float_offset.data(),
+                                     cols,
+                                     value_.d_float_lens.data(),
+                                     value_.d_float_offset.data(),
+                                     d_total_lens_.data() + 1);
+  }
+  int h_total_lens[2] = {0, 0};
+  CUDA_CHECK(cudaMemcpyAsync(h_total_lens,
+                             d_total_lens_.data(),
+                             2 * sizeof(int),
+                             cudaMemcpyDeviceToHost,
+                             stream_));
+  CUDA_CHECK(cudaStreamSynchronize(stream_));
+  uint64_total_len_ = h_total_lens[0];
+  float_total_len_ = h_total_lens[1];
+}
+
+void MiniBatchGpuPack::shuffle_instance(std::vector<SlotRecord> *records,
+                                        uint64_t seed) {
+  int num = ins_num_;
+  PADDLE_ENFORCE_EQ(
+      records->size(),
+      static_cast<size_t>(num),
+      common::errors::InvalidArgument(
+          "The records size %d should be equal to the packed ins num %d.",
+          records->size(),
+          num));
+  if (num == 0) {
+    return;
+  }
+  ins_perm_.resize(num);
+  paddle::memory::ThrustAllocator<cudaStream_t> allocator(place_, stream_);
+  thrust::random::default_random_engine engine(seed);
+  const auto &exec_policy = thrust::cuda::par(allocator).on(stream_);
+  thrust::counting_iterator<int> cnt_iter(0);
+  phi::funcs::shuffle_copy_fixed(
+      thrust::detail::derived_cast(thrust::detail::strip_const(exec_policy)),
+      cnt_iter,
+      cnt_iter + num,
+      thrust::device_pointer_cast(ins_perm_.data()),
+      engine);
+  shuffled_ = true;
+
+  // the line ids are read from the records, put them in the same order
+  std::vector<int> h_perm(num);
+  CUDA_CHECK(cudaMemcpyAsync(h_perm.data(),
+                             ins_perm_.data(),
+                             num * sizeof(int),
+                             cudaMemcpyDeviceToHost,
+                             stream_));
+  CUDA_CHECK(cudaStreamSynchronize(stream_));
+  std::vector<SlotRecord> shuffled(num);
+  for (int i = 0; i < num; ++i) {
+    shuffled[i] = (*records)[h_perm[i]];
+  }
+  records->swap(shuffled);
+}
+
 __global__ void GraphFillCVMKernel(int64_t *tensor, int len) {
   CUDA_KERNEL_LOOP(idx, len) { tensor[idx] = 1; }
 }
@@ -1331,6 +1459,10 @@ int GraphDataGenerator::GenerateBatch() {
   }
 
   cudaStreamSynchronize(train_stream_);
+  if (conf_.sage_mode && conf_.accumulate_num == 1 &&
+      sage_batch_count_ < sage_batch_num_) {
+    PrefetchSageFeature(sage_batch_count_);
+  }
   if (!conf_.gpu_graph_training) return 1;
   if (!conf_.sage_mode) {
     ins_buf_pair_len_[0] -= total_instance / 2;
@@ -1338,6 +1470,78 @@ int GraphDataGenerator::GenerateBatch() {
   return 1;
 }
 
+void GraphDataGenerator::PrefetchSageFeature(int index) {
+  if (!FLAGS_gpugraph_sage_feature_prefetch || uint_slot_num_ == 0) {
+    return;
+  }
+  WaitFeaturePrefetch();
+  auto &prefetch = feature_prefetch_;
+  prefetch.batch = -1;
+  int key_num = uniq_instance_vec_[index];
+  uint64_t *d_nodes =
+      reinterpret_cast<uint64_t *>(final_sage_nodes_vec_[index]->ptr());
+  // the graph table looks the features up on its own streams, so the pull of
+  // the next batch overlaps the training of the current one
+  feature_prefetch_done_ =
+      std::async(std::launch::async, [this, index, key_num, d_nodes]() {
+        platform::CUDADeviceGuard guard(conf_.gpuid);
+        auto &prefetch = feature_prefetch_;
+        size_t temp_bytes = (key_num + 1) * sizeof(uint32_t);
+        if (prefetch.size_list == NULL ||
+            prefetch.size_list->size() < temp_bytes) {
+          prefetch.size_list = memory::AllocShared(this->place_, temp_bytes);
+        }
+        if (prefetch.size_prefixsum == NULL ||
+            prefetch.size_prefixsum->size() < temp_bytes) {
+          prefetch.size_prefixsum =
+              memory::AllocShared(this->place_, temp_bytes);
+        }
+        auto gpu_graph_ptr = GraphGpuWrapper::GetInstance();
+        prefetch.fea_num =
+            gpu_graph_ptr->get_feature_info_of_nodes(conf_.gpuid,
+                                                     d_nodes,
+                                                     key_num,
+                                                     prefetch.size_list,
+                                                     prefetch.size_prefixsum,
+                                                     prefetch.feature_list,
+                                                     prefetch.slot_list,
+                                                     conf_.sage_mode);
+        prefetch.key_num = key_num;
+        prefetch.batch = index;
+      });
+}
+
+void GraphDataGenerator::WaitFeaturePrefetch() {
+  if (feature_prefetch_done_.valid()) {
+    feature_prefetch_done_.get();
+  }
+}
+
+bool GraphDataGenerator::TakePrefetchedFeature(
+    size_t key_num,
+    int *fea_num,
+    std::shared_ptr<phi::Allocation> *feature_list,
+    std::shared_ptr<phi::Allocation> *slot_list) {
+  if (!conf_.sage_mode || conf_.accumulate_num != 1) {
+    return false;
+  }
+  WaitFeaturePrefetch();
+  auto &prefetch = feature_prefetch_;
+  if (prefetch.batch != sage_batch_count_ ||
+      prefetch.key_num != static_cast<int>(key_num)) {
+    return false;
+  }
+  prefetch.batch = -1;
+  // the buffers in use go back to the prefetch, the next one starts after
+  // train_stream_ is done with them
+  std::swap(d_feature_size_list_buf_, prefetch.size_list);
+  std::swap(d_feature_size_prefixsum_buf_, prefetch.size_prefixsum);
+  *fea_num = prefetch.fea_num;
+  *feature_list = std::move(prefetch.feature_list);
+  *slot_list = std::move(prefetch.slot_list);
+  return true;
+}
+
 __global__ void GraphFillSampleKeysKernel(int *prefix_sum,
                                           int *sampleidx2row,
                                           int *tmp_sampleidx2row,
@@ -1704,15 +1908,19 @@ int GraphDataGenerator::FillSlotFeature(uint64_t *d_walk,
     d_feature_size_prefixsum_buf_ =
         memory::AllocShared(this->place_, temp_bytes);
   }
-  int fea_num =
-      gpu_graph_ptr->get_feature_info_of_nodes(conf_.gpuid,
-                                               d_walk,
-                                               key_num,
-                                               d_feature_size_list_buf_,
-                                               d_feature_size_prefixsum_buf_,
-                                               d_feature_list,
-                                               d_slot_list,
-                                               conf_.sage_mode);
+  int fea_num = 0;
+  if (!TakePrefetchedFeature(
+          key_num, &fea_num, &d_feature_list, &d_slot_list)) {
+    fea_num =
+        gpu_graph_ptr->get_feature_info_of_nodes(conf_.gpuid,
+                                                 d_walk,
+                                                 key_num,
+                                                 d_feature_size_list_buf_,
+                                                 d_feature_size_prefixsum_buf_,
+                                                 d_feature_list,
+                                                 d_slot_list,
+                                                 conf_.sage_mode);
+  }
   // num of slot feature
   int slot_num = conf_.slot_num - float_slot_num_;
   int conf_slot_num = slot_num;
@@ -2553,8 +2761,8 @@ std::vector<std::shared_ptr<phi::Allocation>> SampleNeighbors(
                                            cumsum_actual_sample_size_ptr + 1,
                                            len * conf.edge_to_id_len,
                                            stream));
-  cudaStreamSynchronize(stream);
 
+  // the split nums are read on the host after the scan on the same stream
   edges_split_num_ptr->resize(conf.edge_to_id_len);
   for (int i = 0; i < conf.edge_to_id_len; i++) {
     cudaMemcpyAsync(edges_split_num_ptr->data() + i,
@@ -2689,7 +2897,7 @@ std::shared_ptr<phi::Allocation> FillReindexHashTable(int64_t *input,
                                                                keys,
                                                                values,
                                                                key_index);
-  cudaStreamSynchronize(stream);
+  // ReindexSrcOutput runs after it on the same stream
   return unique_items;
 }
 
@@ -2749,8 +2957,6 @@ std::shared_ptr<phi::Allocation> GetReindexResult(int64_t *reindex_src_data,
                   cudaMemcpyDeviceToDevice,
                   stream);
 
-  cudaStreamSynchronize(stream);
-
   auto final_nodes = FillReindexHashTable(all_nodes_data,
                                           node_len + neighbor_len,
                                           reindex_table_size,
@@ -2770,6 +2976,7 @@ std::shared_ptr<phi::Allocation> GetReindexResult(int64_t *reindex_src_data,
           d_reindex_table_key_ptr,
           d_reindex_table_value_ptr);
 
+  // the sampler of the next hop reads the nodes on its own streams
   cudaStreamSynchronize(stream);
   return final_nodes;
 }
@@ -3850,6 +4057,7 @@ void GraphDataGenerator::DoWalkandSage() {
   int device_id = place_.GetDeviceId();
   debug_gpu_memory_info(device_id, "DoWalkandSage start");
   platform::CUDADeviceGuard guard(conf_.gpuid);
+  WaitFeaturePrefetch();
   sage_batch_num_ = 0;
   if (conf_.gpu_graph_training) {
     int local_train_flag = DoWalkForTrain();
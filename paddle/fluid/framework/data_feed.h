@@ -19,6 +19,7 @@ limitations under the License. */
 #define _LINUX
 #endif
 
+#include <condition_variable>  // NOLINT
 #include <fstream>
 #include <future>  // NOLINT
 #include <memory>
@@ -53,6 +54,7 @@ limitations under the License. */
 COMMON_DECLARE_int32(record_pool_max_size);
 COMMON_DECLARE_int32(slotpool_thread_num);
 COMMON_DECLARE_bool(enable_slotpool_wait_release);
+COMMON_DECLARE_int64(slotpool_preload_max_records);
 COMMON_DECLARE_bool(enable_slotrecord_reset_shrink);
 
 namespace paddle {
@@ -290,6 +292,9 @@ class SlotObjPool {
     return get(&(*output)[0], n);
   }
   void get(SlotRecord* output, int n) {
+    if (preload_thread()) {
+      wait_preload_budget();
+    }
     int size = 0;
     mutex_.lock();
     int left = static_cast<int>(alloc_.capacity());
@@ -331,6 +336,11 @@ class SlotObjPool {
       // over max capacity
       size_t n = input.size();
       count_ -= n;
+      {
+        // the records of a finished pass make room for a preload
+        std::lock_guard<std::mutex> lock(budget_mutex_);
+        budget_cond_.notify_all();
+      }
       if (disable_pool_ || n + capacity() > max_capacity_) {
         for (auto& t : input) {
           free_slotrecord(t);
@@ -370,8 +380,39 @@ class SlotObjPool {
     mutex_.unlock();
     return total;
   }
+  // Marks the calling thread as loading a pass ahead of the training one, its
+  // gets wait while more than FLAGS_slotpool_preload_max_records records are
+  // handed out and not put back.
+  static void set_preload_thread(bool preload) { preload_thread() = preload; }
+  // Lets the waiting preload threads go on regardless of the budget, e.g.
+  // when the pass they load is needed now.
+  void set_preload_throttle(bool throttle) {
+    std::lock_guard<std::mutex> lock(budget_mutex_);
+    preload_throttle_ = throttle;
+    budget_cond_.notify_all();
+  }
 
  private:
+  static bool& preload_thread() {
+    thread_local bool preload = false;
+    return preload;
+  }
+  void wait_preload_budget() {
+    int64_t max_records = FLAGS_slotpool_preload_max_records;
+    if (max_records <= 0) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(budget_mutex_);
+    if (!preload_throttle_ || count_.load() < max_records) {
+      return;
+    }
+    VLOG(3) << "preload waits for the slot pool, records in use="
+            << count_.load() << ", budget=" << max_records;
+    budget_cond_.wait(lock, [this, max_records] {
+      return !preload_throttle_ || count_.load() < max_records;
+    });
+  }
+
   size_t max_capacity_;
   Channel<SlotRecord> ins_chan_;
   std::vector<std::thread> threads_;
@@ -379,6 +420,9 @@ class SlotObjPool {
   SlotObjAllocator<SlotRecordObject> alloc_;
   bool disable_pool_;
   std::atomic<long> count_;  // NOLINT
+  std::mutex budget_mutex_;
+  std::condition_variable budget_cond_;
+  bool preload_throttle_ = false;
 };
 
 inline SlotObjPool& SlotRecordPool() {
@@ -554,6 +598,14 @@ class MiniBatchGpuPack {
   void set_use_flag(bool is_use) { is_using_ = is_use; }
   void reset(const phi::Place& place);
   void pack_instance(const SlotRecord* ins_vec, int num);
+  // gathers instances [start, start + num) of a pass packed by pass_pack,
+  // ins_vec holds the records of the batch for the line ids
+  void gather_instance(MiniBatchGpuPack* pass_pack,
+                       const SlotRecord* ins_vec,
+                       int start,
+                       int num);
+  // permutes the packed instances on the gpu, and records in the same order
+  void shuffle_instance(std::vector<SlotRecord>* records, uint64_t seed);
   int ins_num() { return ins_num_; }
   int pv_num() { return pv_num_; }
   BatchGPUValue& value() { return value_; }
@@ -561,20 +613,27 @@ class MiniBatchGpuPack {
   UsedSlotGpuType* get_gpu_slots(void) {
     return reinterpret_cast<UsedSlotGpuType*>(gpu_slots_.data());
   }
+  // the keys are those of the pass pack after gather_instance
+  const uint64_t* uint64_keys(void) {
+    return pass_pack_ != nullptr ? pass_pack_->value_.d_uint64_keys.data()
+                                 : value_.d_uint64_keys.data();
+  }
+  const float* float_keys(void) {
+    return pass_pack_ != nullptr ? pass_pack_->value_.d_float_keys.data()
+                                 : value_.d_float_keys.data();
+  }
   SlotRecord* get_records(void) { return &ins_vec_[0]; }
 
   // tensor gpu memory reused
   void resize_tensor(void) {
     if (used_float_num_ > 0) {
-      int float_total_len = buf_.h_float_lens.back();
-      if (float_total_len > 0) {
-        float_tensor_.mutable_data<float>({float_total_len, 1}, this->place_);
+      if (float_total_len_ > 0) {
+        float_tensor_.mutable_data<float>({float_total_len_, 1}, this->place_);
       }
     }
     if (used_uint64_num_ > 0) {
-      int uint64_total_len = buf_.h_uint64_lens.back();
-      if (uint64_total_len > 0) {
-        uint64_tensor_.mutable_data<int64_t>({uint64_total_len, 1},
+      if (uint64_total_len_ > 0) {
+        uint64_tensor_.mutable_data<int64_t>({uint64_total_len_, 1},
                                              this->place_);
       }
     }
@@ -643,6 +702,15 @@ class MiniBatchGpuPack {
   BatchCPUValue buf_;
   int ins_num_ = 0;
   int pv_num_ = 0;
+  int uint64_total_len_ = 0;
+  int float_total_len_ = 0;
+
+  // the pass pack a batch is gathered from, in gather_instance the
+  // lens of value_ hold the start of every instance in the keys of the pass
+  MiniBatchGpuPack* pass_pack_ = nullptr;
+  CudaBuffer<int> ins_perm_;
+  bool shuffled_ = false;
+  CudaBuffer<int> d_total_lens_;
 
   bool enable_pv_ = false;
   int used_float_num_ = 0;
@@ -1011,6 +1079,13 @@ class GraphDataGenerator {
                       int tensor_pair_idx,
                       int accum = 0);
   int FillFloatFeature(uint64_t* d_walk, size_t key_num, int tensor_pair_idx);
+  // pulls the slot features of the sage batch at index in the background
+  void PrefetchSageFeature(int index);
+  void WaitFeaturePrefetch();
+  bool TakePrefetchedFeature(size_t key_num,
+                             int* fea_num,
+                             std::shared_ptr<phi::Allocation>* feature_list,
+                             std::shared_ptr<phi::Allocation>* slot_list);
   int GetPathNum() { return total_row_[0]; }
   void ResetPathNum() { total_row_[0] = 0; }
   int GetGraphBatchsize() { return conf_.batch_size; }
@@ -1113,6 +1188,19 @@ class GraphDataGenerator {
   std::vector<std::vector<std::shared_ptr<phi::Allocation>>> graph_edges_vec_;
   std::vector<std::vector<std::vector<int>>> edges_split_num_vec_;
 
+  // slot features of the next sage batch
+  struct FeaturePrefetch {
+    int batch = -1;
+    int key_num = 0;
+    int fea_num = 0;
+    std::shared_ptr<phi::Allocation> size_list;
+    std::shared_ptr<phi::Allocation> size_prefixsum;
+    std::shared_ptr<phi::Allocation> feature_list;
+    std::shared_ptr<phi::Allocation> slot_list;
+  };
+  FeaturePrefetch feature_prefetch_;
+  std::future<void> feature_prefetch_done_;
+
   int sage_batch_count_;
   int sage_batch_num_;
   bool global_train_flag_ = 0;
@@ -1985,6 +2073,13 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   void PutToFeedVec(const std::vector<SlotRecord>& ins_vec UNUSED) override {}
 
   virtual void LoadIntoMemoryByCommand(void);
+  // LoadIntoMemoryByCommand with parse_thread_num threads parsing lines
+  // read by the calling thread
+  void LoadIntoMemoryByPipeline(int parse_thread_num);
+  // LoadIntoMemoryByCommand through the columnar file cache in
+  // FLAGS_slotrecord_columnar_cache_dir
+  void LoadIntoMemoryByColumnarCache();
+  std::string ColumnarCachePath(const std::string& filename);
   virtual void LoadIntoMemoryByLib(void);
   virtual void LoadIntoMemoryByLine(void);
   virtual void LoadIntoMemoryByFile(void);
@@ -2008,6 +2103,8 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
 
   virtual void PackToScope(MiniBatchGpuPack* pack,
                            const Scope* scope = nullptr);
+  // packs the records of all the batches of this reader into pass_pack_
+  void PackPassToGPU();
 
   void FillSlotValueOffset(const int ins_num,
                            const int used_slot_num,
@@ -2073,6 +2170,12 @@ class SlotRecordInMemoryDataFeed : public InMemoryDataFeed<SlotRecord> {
   std::atomic<bool> stop_token_{false};
   std::atomic<int> thread_count_{0};
   std::mutex pack_mutex_;
+  // FLAGS_enable_slotrecord_gpu_pass_pack, the batches are gathered on the
+  // gpu from pass_pack_, pass_records_ holds the records of the batches
+  // back to back from pass_batch_starts_
+  MiniBatchGpuPack* pass_pack_{nullptr};
+  std::vector<SlotRecord> pass_records_;
+  std::vector<int> pass_batch_starts_;
 
   // async infershape
   std::map<const Scope*, std::vector<phi::DenseTensor*>> scope_feed_vec_;
@@ -0,0 +1,314 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_feed_columnar.h"
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#ifdef _LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace paddle::framework {
+
+namespace {
+
+const uint32_t kColumnarMagic = 0x52534450;  // "PDSR"
+const uint32_t kColumnarVersion = 1;
+
+struct FileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t uint64_slot_num;
+  uint32_t float_slot_num;
+};
+
+struct BlockHeader {
+  uint32_t record_num;
+  uint32_t reserved;
+  uint64_t block_bytes;
+};
+
+inline size_t Align8(size_t size) {
+  return (size + 7) & ~static_cast<size_t>(7);
+}
+
+inline void AppendBytes(std::string* buffer, const void* data, size_t size) {
+  buffer->append(reinterpret_cast<const char*>(data), size);
+  buffer->resize(Align8(buffer->size()), '\0');
+}
+
+template <typename T>
+void AppendSlotColumn(std::string* buffer,
+                      const SlotRecord* records,
+                      size_t num,
+                      int slot,
+                      SlotValues<T> SlotRecordObject::*values) {
+  std::vector<uint32_t> offsets(num + 1, 0);
+  std::vector<T> column;
+  for (size_t i = 0; i < num; ++i) {
+    const auto& slot_values = records[i]->*values;
+    const auto& slot_offsets = slot_values.slot_offsets;
+    if (static_cast<int>(slot_offsets.size()) > slot + 1) {
+      const T* data = slot_values.slot_values.data();
+      column.insert(
+          column.end(), data + slot_offsets[slot], data + slot_offsets[slot + 1]);
+    }
+    offsets[i + 1] = static_cast<uint32_t>(column.size());
+  }
+  AppendBytes(buffer, offsets.data(), offsets.size() * sizeof(uint32_t));
+  AppendBytes(buffer, column.data(), column.size() * sizeof(T));
+}
+
+// returns the section at *pos and moves *pos past it, nullptr when it does
+// not fit in the block
+inline const char* TakeSection(const char* block,
+                               size_t block_bytes,
+                               size_t* pos,
+                               size_t size) {
+  if (*pos + size > block_bytes) {
+    return nullptr;
+  }
+  const char* section = block + *pos;
+  *pos += Align8(size);
+  return section;
+}
+
+}  // namespace
+
+bool SlotRecordColumnarWriter::Open(const std::string& path) {
+  Abort();
+  path_ = path;
+  fp_ = fopen((path_ + ".tmp").c_str(), "wb");
+  if (fp_ == nullptr) {
+    LOG(WARNING) << "open columnar file " << path_ << ".tmp failed";
+    return false;
+  }
+  FileHeader header{kColumnarMagic,
+                    kColumnarVersion,
+                    static_cast<uint32_t>(uint64_slot_num_),
+                    static_cast<uint32_t>(float_slot_num_)};
+  if (fwrite(&header, sizeof(header), 1, fp_) != 1) {
+    Abort();
+    return false;
+  }
+  return true;
+}
+
+bool SlotRecordColumnarWriter::Append(const SlotRecord* records, size_t num) {
+  if (fp_ == nullptr || num == 0) {
+    return fp_ != nullptr;
+  }
+  buffer_.clear();
+  buffer_.resize(sizeof(BlockHeader), '\0');
+
+  std::vector<uint64_t> search_ids(num);
+  std::vector<uint32_t> ranks(num);
+  std::vector<uint32_t> cmatches(num);
+  std::vector<uint32_t> ins_id_offsets(num + 1, 0);
+  std::string ins_ids;
+  for (size_t i = 0; i < num; ++i) {
+    search_ids[i] = records[i]->search_id;
+    ranks[i] = records[i]->rank;
+    cmatches[i] = records[i]->cmatch;
+    ins_ids.append(records[i]->ins_id_);
+    ins_id_offsets[i + 1] = static_cast<uint32_t>(ins_ids.size());
+  }
+  AppendBytes(&buffer_, search_ids.data(), num * sizeof(uint64_t));
+  AppendBytes(&buffer_, ranks.data(), num * sizeof(uint32_t));
+  AppendBytes(&buffer_, cmatches.data(), num * sizeof(uint32_t));
+  AppendBytes(&buffer_, ins_id_offsets.data(), (num + 1) * sizeof(uint32_t));
+  AppendBytes(&buffer_, ins_ids.data(), ins_ids.size());
+  for (int slot = 0; slot < uint64_slot_num_; ++slot) {
+    AppendSlotColumn<uint64_t>(&buffer_,
+                               records,
+                               num,
+                               slot,
+                               &SlotRecordObject::slot_uint64_feasigns_);
+  }
+  for (int slot = 0; slot < float_slot_num_; ++slot) {
+    AppendSlotColumn<float>(&buffer_,
+                            records,
+                            num,
+                            slot,
+                            &SlotRecordObject::slot_float_feasigns_);
+  }
+
+  BlockHeader header{static_cast<uint32_t>(num), 0, buffer_.size()};
+  memcpy(const_cast<char*>(buffer_.data()), &header, sizeof(header));
+  if (fwrite(buffer_.data(), 1, buffer_.size(), fp_) != buffer_.size()) {
+    LOG(WARNING) << "write columnar file " << path_ << ".tmp failed";
+    Abort();
+    return false;
+  }
+  return true;
+}
+
+bool SlotRecordColumnarWriter::Commit() {
+  if (fp_ == nullptr) {
+    return false;
+  }
+  bool ok = (fclose(fp_) == 0);
+  fp_ = nullptr;
+  std::string tmp_path = path_ + ".tmp";
+  if (!ok || rename(tmp_path.c_str(), path_.c_str()) != 0) {
+    LOG(WARNING) << "commit columnar file " << path_ << " failed";
+    remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void SlotRecordColumnarWriter::Abort() {
+  if (fp_ != nullptr) {
+    fclose(fp_);
+    fp_ = nullptr;
+    remove((path_ + ".tmp").c_str());
+  }
+}
+
+bool SlotRecordColumnarReader::Open(const std::string& path,
+                                    int uint64_slot_num,
+                                    int float_slot_num) {
+#ifdef _LINUX
+  Close();
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+    close(fd);
+    return false;
+  }
+  void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(WARNING) << "mmap columnar file " << path << " failed";
+    return false;
+  }
+  madvise(data, st.st_size, MADV_SEQUENTIAL);
+  data_ = reinterpret_cast<const char*>(data);
+  size_ = st.st_size;
+
+  const FileHeader* header = reinterpret_cast<const FileHeader*>(data_);
+  if (header->magic != kColumnarMagic || header->version != kColumnarVersion ||
+      header->uint64_slot_num != static_cast<uint32_t>(uint64_slot_num) ||
+      header->float_slot_num != static_cast<uint32_t>(float_slot_num)) {
+    LOG(WARNING) << "columnar file " << path
+                 << " does not match the slot config, ignore it";
+    Close();
+    return false;
+  }
+  uint64_slot_num_ = uint64_slot_num;
+  float_slot_num_ = float_slot_num;
+  pos_ = sizeof(FileHeader);
+  return true;
+#else
+  return false;
+#endif
+}
+
+int SlotRecordColumnarReader::NextBlock() {
+  if (data_ == nullptr || pos_ == size_) {
+    return 0;
+  }
+  if (pos_ + sizeof(BlockHeader) > size_) {
+    return -1;
+  }
+  const BlockHeader* header =
+      reinterpret_cast<const BlockHeader*>(data_ + pos_);
+  if (header->block_bytes < sizeof(BlockHeader) ||
+      pos_ + header->block_bytes > size_) {
+    return -1;
+  }
+  block_ = data_ + pos_;
+  block_record_num_ = header->record_num;
+  pos_ += header->block_bytes;
+  return static_cast<int>(block_record_num_);
+}
+
+void SlotRecordColumnarReader::FillBlock(SlotRecord* records) {
+  const BlockHeader* header = reinterpret_cast<const BlockHeader*>(block_);
+  size_t block_bytes = header->block_bytes;
+  size_t num = block_record_num_;
+  size_t pos = sizeof(BlockHeader);
+  auto take = [this, block_bytes, &pos](size_t size) {
+    const char* section = TakeSection(block_, block_bytes, &pos, size);
+    PADDLE_ENFORCE_NOT_NULL(
+        section,
+        common::errors::InvalidArgument(
+            "Columnar block section exceeds the block, file is corrupted."));
+    return section;
+  };
+
+  auto search_ids =
+      reinterpret_cast<const uint64_t*>(take(num * sizeof(uint64_t)));
+  auto ranks = reinterpret_cast<const uint32_t*>(take(num * sizeof(uint32_t)));
+  auto cmatches =
+      reinterpret_cast<const uint32_t*>(take(num * sizeof(uint32_t)));
+  auto ins_id_offsets =
+      reinterpret_cast<const uint32_t*>(take((num + 1) * sizeof(uint32_t)));
+  const char* ins_ids = take(ins_id_offsets[num]);
+  for (size_t i = 0; i < num; ++i) {
+    SlotRecord rec = records[i];
+    rec->reset();
+    rec->search_id = search_ids[i];
+    rec->rank = ranks[i];
+    rec->cmatch = cmatches[i];
+    rec->ins_id_.assign(ins_ids + ins_id_offsets[i],
+                        ins_id_offsets[i + 1] - ins_id_offsets[i]);
+  }
+
+  auto fill_slots = [&](int slot_num, auto values, auto* type_tag) {
+    using T = std::remove_pointer_t<decltype(type_tag)>;
+    for (int slot = 0; slot < slot_num; ++slot) {
+      auto offsets =
+          reinterpret_cast<const uint32_t*>(take((num + 1) * sizeof(uint32_t)));
+      auto column =
+          reinterpret_cast<const T*>(take(offsets[num] * sizeof(T)));
+      for (size_t i = 0; i < num; ++i) {
+        (records[i]->*values)
+            .add_values(column + offsets[i], offsets[i + 1] - offsets[i]);
+      }
+    }
+  };
+  fill_slots(uint64_slot_num_,
+             &SlotRecordObject::slot_uint64_feasigns_,
+             static_cast<uint64_t*>(nullptr));
+  fill_slots(float_slot_num_,
+             &SlotRecordObject::slot_float_feasigns_,
+             static_cast<float*>(nullptr));
+}
+
+void SlotRecordColumnarReader::Close() {
+#ifdef _LINUX
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  pos_ = 0;
+  block_ = nullptr;
+  block_record_num_ = 0;
+}
+
+}  // namespace paddle::framework
@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "paddle/fluid/framework/data_feed.h"
+
+namespace paddle {
+namespace framework {
+
+// Binary columnar file of SlotRecords, written once after a text file is
+// parsed and mmapped on later loads instead of parsing again.
+//
+// file  : FileHeader, then blocks until the end of file
+// block : BlockHeader,
+//         search_id uint64[n], rank uint32[n], cmatch uint32[n],
+//         ins_id offsets uint32[n + 1] and bytes,
+//         per uint64 slot: offsets uint32[n + 1] and values uint64[],
+//         per float slot : offsets uint32[n + 1] and values float[]
+// Every section starts 8 byte aligned, offsets index into the slot's own
+// value column, so a slot of all records of a block is contiguous.
+class SlotRecordColumnarWriter {
+ public:
+  SlotRecordColumnarWriter(int uint64_slot_num, int float_slot_num)
+      : uint64_slot_num_(uint64_slot_num), float_slot_num_(float_slot_num) {}
+  ~SlotRecordColumnarWriter() { Abort(); }
+
+  // data goes to path + ".tmp" until Commit renames it to path, so readers
+  // never see a partial file
+  bool Open(const std::string& path);
+  // writes the records as one block
+  bool Append(const SlotRecord* records, size_t num);
+  bool Commit();
+  void Abort();
+
+ private:
+  int uint64_slot_num_;
+  int float_slot_num_;
+  std::string path_;
+  FILE* fp_ = nullptr;
+  std::string buffer_;
+};
+
+class SlotRecordColumnarReader {
+ public:
+  SlotRecordColumnarReader() = default;
+  ~SlotRecordColumnarReader() { Close(); }
+
+  // fails when the file is missing or was written for other slot counts
+  bool Open(const std::string& path, int uint64_slot_num, int float_slot_num);
+  // record num of the next block, 0 at the end of file and -1 when the
+  // file is corrupted
+  int NextBlock();
+  // fills the block returned by the last NextBlock into records
+  void FillBlock(SlotRecord* records);
+  void Close();
+
+ private:
+  int uint64_slot_num_ = 0;
+  int float_slot_num_ = 0;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t pos_ = 0;
+  const char* block_ = nullptr;
+  uint32_t block_record_num_ = 0;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,151 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace paddle {
+namespace framework {
+
+// Number parsing for the slot text format "num v1 v2 ... num v1 ...". The
+// functions have the strtoull/strtof contract, end is the end of the line
+// and is never read past. Plain decimal tokens are converted 8 digits at a
+// time with SWAR arithmetic, anything else (signs for integers, exponents,
+// hex, inf/nan, more than 19 digits) falls back to the libc function.
+namespace text_parser {
+
+inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline bool IsEightDigits(uint64_t v) {
+  return (((v & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
+
+// v holds 8 ascii digits, the first one in the lowest byte
+inline uint32_t ParseEightDigits(uint64_t v) {
+  v -= 0x3030303030303030ULL;
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+       (((v >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >>
+      32;
+  return static_cast<uint32_t>(v);
+}
+
+// accumulates the digits at *p into *value, returns the number of digits
+inline int ParseDigits(const char** p, const char* end, uint64_t* value) {
+  const char* begin = *p;
+  const char* cur = *p;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (end - cur >= 8) {
+    uint64_t chunk = 0;
+    memcpy(&chunk, cur, sizeof(chunk));
+    if (!IsEightDigits(chunk)) {
+      break;
+    }
+    *value = *value * 100000000ULL + ParseEightDigits(chunk);
+    cur += 8;
+  }
+#endif
+  while (cur < end && IsDigit(*cur)) {
+    *value = *value * 10 + static_cast<uint64_t>(*cur - '0');
+    ++cur;
+  }
+  *p = cur;
+  return static_cast<int>(cur - begin);
+}
+
+}  // namespace text_parser
+
+inline uint64_t FastStrtoull(const char* str, const char* end, char** endptr) {
+  const char* p = str;
+  while (p < end && *p == ' ') {
+    ++p;
+  }
+  if (p == end || !text_parser::IsDigit(*p)) {
+    return strtoull(str, endptr, 10);
+  }
+  uint64_t value = 0;
+  if (text_parser::ParseDigits(&p, end, &value) > 19) {
+    return strtoull(str, endptr, 10);
+  }
+  *endptr = const_cast<char*>(p);
+  return value;
+}
+
+// The decimal fast path computes mantissa / 10^k in double, which is
+// correctly rounded for up to 18 digits, and then rounds to float. It may
+// differ from strtof in the last bit only when the double result lands on a
+// float halfway point.
+inline float FastStrtof(const char* str, const char* end, char** endptr) {
+  static const double kPow10[] = {1e0,
+                                  1e1,
+                                  1e2,
+                                  1e3,
+                                  1e4,
+                                  1e5,
+                                  1e6,
+                                  1e7,
+                                  1e8,
+                                  1e9,
+                                  1e10,
+                                  1e11,
+                                  1e12,
+                                  1e13,
+                                  1e14,
+                                  1e15,
+                                  1e16,
+                                  1e17,
+                                  1e18};
+  const char* p = str;
+  while (p < end && *p == ' ') {
+    ++p;
+  }
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  uint64_t mantissa = 0;
+  int digits = text_parser::ParseDigits(&p, end, &mantissa);
+  int frac_digits = 0;
+  if (p < end && *p == '.') {
+    ++p;
+    frac_digits = text_parser::ParseDigits(&p, end, &mantissa);
+    digits += frac_digits;
+  }
+  if (digits == 0 || digits > 18 ||
+      (p < end && (*p == 'e' || *p == 'E' || *p == 'x' || *p == 'X'))) {
+    return strtof(str, endptr);
+  }
+  double value = static_cast<double>(mantissa) / kPow10[frac_digits];
+  *endptr = const_cast<char*>(p);
+  return static_cast<float>(negative ? -value : value);
+}
+
+// the next ' ' at or after p, end when there is none; memchr is vectorized
+// by libc, which is what makes skipping unused slots cheap
+inline const char* FindNextSpace(const char* p, const char* end) {
+  if (p >= end) {
+    return end;
+  }
+  const void* space = memchr(p, ' ', end - p);
+  return space == nullptr ? end : static_cast<const char*>(space);
+}
+
+}  // namespace framework
+}  // namespace paddle
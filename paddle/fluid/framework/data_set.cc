@@ -14,6 +14,8 @@
 
 #include "paddle/fluid/framework/data_set.h"
 
+#include <type_traits>
+
 #include "google/protobuf/text_format.h"
 #if (defined PADDLE_WITH_DISTRIBUTE) && (defined PADDLE_WITH_PSCORE)
 #include "paddle/fluid/distributed/index_dataset/index_sampler.h"
@@ -597,9 +599,24 @@ void DatasetImpl<T>::LoadIntoMemory() {
           << ", cost time=" << timeline.ElapsedSec() << " seconds";
 }
 
+template <typename T>
+static void PreLoadReader(DataFeed* reader) {
+  // the records of the pass training count against the budget of the preload
+  if constexpr (std::is_same<T, SlotRecord>::value) {
+    SlotObjPool::set_preload_thread(true);
+  }
+  reader->LoadIntoMemory();
+  if constexpr (std::is_same<T, SlotRecord>::value) {
+    SlotObjPool::set_preload_thread(false);
+  }
+}
+
 template <typename T>
 void DatasetImpl<T>::PreLoadIntoMemory() {
   VLOG(3) << "DatasetImpl<T>::PreLoadIntoMemory() begin";
+  if constexpr (std::is_same<T, SlotRecord>::value) {
+    SlotRecordPool().set_preload_throttle(true);
+  }
   if (preload_thread_num_ != 0) {
     PADDLE_ENFORCE_EQ(static_cast<size_t>(preload_thread_num_),
                       preload_readers_.size(),
@@ -610,9 +627,8 @@ void DatasetImpl<T>::PreLoadIntoMemory() {
                           preload_readers_.size()));
     preload_threads_.clear();
     for (int64_t i = 0; i < preload_thread_num_; ++i) {
-      preload_threads_.emplace_back(
-          &paddle::framework::DataFeed::LoadIntoMemory,
-          preload_readers_[i].get());
+      preload_threads_.emplace_back(&PreLoadReader<T>,
+                                    preload_readers_[i].get());
     }
   } else {
     PADDLE_ENFORCE_EQ(
@@ -624,8 +640,7 @@ void DatasetImpl<T>::PreLoadIntoMemory() {
             readers_.size()));
     preload_threads_.clear();
     for (int64_t i = 0; i < thread_num_; ++i) {
-      preload_threads_.emplace_back(
-          &paddle::framework::DataFeed::LoadIntoMemory, readers_[i].get());
+      preload_threads_.emplace_back(&PreLoadReader<T>, readers_[i].get());
     }
   }
   VLOG(3) << "DatasetImpl<T>::PreLoadIntoMemory() end";
@@ -634,6 +649,10 @@ void DatasetImpl<T>::PreLoadIntoMemory() {
 template <typename T>
 void DatasetImpl<T>::WaitPreLoadDone() {
   VLOG(3) << "DatasetImpl<T>::WaitPreLoadDone() begin";
+  if constexpr (std::is_same<T, SlotRecord>::value) {
+    // the pass is needed now, finish it even above the budget
+    SlotRecordPool().set_preload_throttle(false);
+  }
   for (std::thread& t : preload_threads_) {
     t.join();
   }
@@ -2056,7 +2075,12 @@ void SlotRecordDataset::ReleaseMemory() {
   timeline.Start();
 
   if (input_channel_) {
-    input_channel_->Clear();
+    // records not taken out of the channel go back to the pool too, for the
+    // next pass to reuse
+    input_channel_->Close();
+    std::vector<SlotRecord> records;
+    input_channel_->ReadAll(records);
+    SlotRecordPool().put(&records);
     input_channel_ = nullptr;
   }
   if (enable_heterps_) {
@@ -15,6 +15,7 @@ limitations under the License. */
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <fstream>
 #include <map>
 #include <memory>
@@ -362,6 +363,13 @@ class DownpourWorker : public HogwildWorker {
   void CopySparseTable();
   void CopyDenseTable();
   void CopyDenseVars();
+  // Pulls all the sparse tables of a batch at once, see
+  // FLAGS_downpour_concurrent_pull_sparse. Returns false if nothing is
+  // pulled, then the tables are pulled one by one.
+  bool PullSparseTablesConcurrently();
+  // Keeps the pushes of at most max_batches batches in flight, a negative
+  // max_batches never waits them.
+  void BoundPushInflight(int max_batches);
 
   DownpourWorkerParameter param_;
   // copy table
@@ -392,6 +400,8 @@ class DownpourWorker : public HogwildWorker {
   std::map<uint64_t, std::vector<std::string>> dense_grad_names_;
   float scale_datanorm_;
   std::vector<::std::future<int32_t>> push_dense_status_;
+  // the pushes of the last batches still in flight
+  std::deque<std::vector<::std::future<int32_t>>> push_inflight_;
   // skipped ops
   std::vector<std::string> skip_ops_;
   // just save the value in param_ for easy access
@@ -842,6 +852,8 @@ class HeterSectionWorker : public DeviceWorker {
   void MiniBatchBarrier();
   void Run();
   void BatchPostProcess();
+  // logs the section balance of the window and tunes active_microbatches_
+  void BalanceSections();
   void SetDebug(bool debug) { debug_ = debug; }
   Scope* GetThreadScope() override { return minibatch_scope_; }
 
@@ -880,6 +892,18 @@ class HeterSectionWorker : public DeviceWorker {
   platform::Timer timeline_;
   double total_time_ = 0.0;
   double read_time_ = 0.0;
+  // micro-batches the cpu section runs per mini-batch, <= num_microbatches_
+  int active_microbatches_ = 0;
+  // balance window: seconds spent computing the section and waiting for the
+  // other one, on the cpu section the wait is the heter section latency and
+  // on a heter section it is the device idle time
+  platform::Timer section_timer_;
+  double window_compute_time_ = 0.0;
+  double window_wait_time_ = 0.0;
+  uint64_t window_ins_num_ = 0;
+  int window_batches_ = 0;
+  double last_window_throughput_ = 0.0;
+  int microbatch_step_ = -1;
 };
 #endif
 
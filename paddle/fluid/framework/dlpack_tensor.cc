@@ -17,6 +17,10 @@
 #include "paddle/fluid/framework/data_type.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/utils/visit_place.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
 
 namespace paddle {
 namespace framework {
@@ -181,6 +185,75 @@ DLManagedTensor *toDLPack(const phi::DenseTensor &src) {
   return &(pdDLMTensor->tensor);
 }
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+static gpuStream_t ToGpuStream(int64_t stream) {
+  PADDLE_ENFORCE_NE(
+      stream,
+      0,
+      common::errors::InvalidArgument(
+          "Stream 0 is ambiguous, use 1 for the legacy default stream or 2 "
+          "for the per-thread default stream."));
+#ifdef PADDLE_WITH_HIP
+  if (stream == 1) return nullptr;
+  if (stream == 2) return hipStreamPerThread;
+#else
+  if (stream == 1) return cudaStreamLegacy;
+  if (stream == 2) return cudaStreamPerThread;
+#endif
+  return reinterpret_cast<gpuStream_t>(stream);
+}
+
+static gpuStream_t PlaceStream(const phi::Place &place) {
+  return static_cast<phi::GPUContext *>(
+             phi::DeviceContextPool::Instance().Get(place))
+      ->stream();
+}
+
+// Records an event on signaler and makes waiter wait for it.
+static void StreamWaitStream(const phi::Place &place,
+                             gpuStream_t waiter,
+                             gpuStream_t signaler) {
+  if (waiter == signaler) {
+    return;
+  }
+  phi::backends::gpu::GPUDeviceGuard guard(place.GetDeviceId());
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipEventCreateWithFlags(&event, hipEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event, signaler));
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(waiter, event, 0));
+  // the event is released once the wait is done
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventDestroy(event));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, signaler));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(waiter, event, 0));
+  // the event is released once the wait is done
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(event));
+#endif
+}
+#endif
+
+void DLPackStreamWaitPlace(int64_t stream, const phi::Place &place) {
+  if (!phi::is_gpu_place(place)) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  StreamWaitStream(place, ToGpuStream(stream), PlaceStream(place));
+#endif
+}
+
+void DLPackPlaceWaitStream(const phi::Place &place, int64_t stream) {
+  if (!phi::is_gpu_place(place)) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  StreamWaitStream(place, PlaceStream(place), ToGpuStream(stream));
+#endif
+}
+
 DLPackTensor::DLPackTensor(const phi::DenseTensor &tensor, LaneType lanes)
     : t_{}, shape_{} {
   // init data, data buffer
@@ -47,5 +47,17 @@ class DLPackTensor {
 
 DLManagedTensor* toDLPack(const phi::DenseTensor& src);
 
+// The streams below are the raw stream handles of the DLPack and the CUDA
+// array interface protocols, 1 and 2 stand for the legacy and the per-thread
+// default stream. Neither blocks the host.
+
+// Makes stream wait for the work issued to the stream of place so far, so
+// that a consumer on stream sees the data of a tensor exported from place.
+TEST_API void DLPackStreamWaitPlace(int64_t stream, const phi::Place& place);
+
+// Makes the stream of place wait for the work issued to stream so far, so
+// that Paddle sees the data of a tensor imported from a producer on stream.
+TEST_API void DLPackPlaceWaitStream(const phi::Place& place, int64_t stream);
+
 }  // namespace framework
 }  // namespace paddle
@@ -12,11 +12,17 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <future>
+
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/framework/fleet/metrics.h"
 #include "paddle/fluid/operators/isfinite_op.h"
 #include "paddle/phi/core/platform/cpu_helper.h"
 
+COMMON_DECLARE_int32(downpour_max_push_inflight_batches);
+COMMON_DECLARE_bool(downpour_concurrent_pull_sparse);
+
 namespace phi {
 class DenseTensor;
 }  // namespace phi
@@ -696,19 +702,7 @@ void DownpourWorker::TrainFilesWithProfiler() {
     }
 
     if (need_to_push_sparse_) {
-      int32_t tmp_push_sparse_wait_times = -1;
-      static uint32_t push_sparse_wait_times =
-          static_cast<uint32_t>(tmp_push_sparse_wait_times);
-      if (push_sparse_status_.size() >= push_sparse_wait_times) {
-        for (auto& t : push_sparse_status_) {
-          t.wait();
-        }
-        push_sparse_status_.resize(0);
-      }
-
-      if (tmp_push_sparse_wait_times == -1) {
-        push_sparse_status_.resize(0);
-      }
+      BoundPushInflight(FLAGS_downpour_max_push_inflight_batches);
 
       VLOG(3) << "going to increase thread version";
       VLOG(3) << "push dense table id size: "
@@ -822,6 +816,62 @@ inline void AddAucMonitor(const Scope* scope, const phi::Place& place) {
 }
 #endif
 
+bool DownpourWorker::PullSparseTablesConcurrently() {
+  int table_num = param_.program_config(0).pull_sparse_table_id_size();
+  if (!FLAGS_downpour_concurrent_pull_sparse || table_num < 2) {
+    return false;
+  }
+  // the buffers of each table are looked up here, the pulls only write
+  // their own ones
+  std::vector<std::future<void>> pulls;
+  for (int i = 0; i < table_num; ++i) {
+    uint64_t tid = static_cast<uint64_t>(
+        param_.program_config(0).pull_sparse_table_id(i));
+    int fea_dim = 0;
+    for (auto const& j : param_.sparse_table()) {
+      if (j.table_id() == tid) {
+        fea_dim = j.fea_dim();
+        break;
+      }
+    }
+    pulls.push_back(std::async(std::launch::async,
+                               [this,
+                                tid,
+                                fea_dim,
+                                key_names = &sparse_key_names_[tid],
+                                keys = &features_[tid],
+                                values = &feature_values_[tid],
+                                value_names = &sparse_value_names_[tid]]() {
+                                 fleet_ptr_->PullSparseVarsSync(*thread_scope_,
+                                                                tid,
+                                                                *key_names,
+                                                                keys,
+                                                                values,
+                                                                fea_dim,
+                                                                *value_names);
+                               }));
+  }
+  for (auto& pull : pulls) {
+    pull.get();
+  }
+  return true;
+}
+
+void DownpourWorker::BoundPushInflight(int max_batches) {
+  if (max_batches < 0) {
+    push_sparse_status_.resize(0);
+    return;
+  }
+  push_inflight_.push_back(std::move(push_sparse_status_));
+  push_sparse_status_.clear();
+  while (push_inflight_.size() > static_cast<size_t>(max_batches)) {
+    for (auto& t : push_inflight_.front()) {
+      t.wait();
+    }
+    push_inflight_.pop_front();
+  }
+}
+
 void DownpourWorker::TrainFiles() {
   VLOG(3) << "Begin to train files";
   platform::SetNumThreads(1);
@@ -837,6 +887,7 @@ void DownpourWorker::TrainFiles() {
       }
     }
     // pull sparse here
+    bool pulled = PullSparseTablesConcurrently();
     for (int i = 0; i < param_.program_config(0).pull_sparse_table_id_size();
          ++i) {
       uint64_t tid = static_cast<uint64_t>(
@@ -848,13 +899,15 @@ void DownpourWorker::TrainFiles() {
           break;
         }
       }
-      fleet_ptr_->PullSparseVarsSync(*thread_scope_,
-                                     tid,
-                                     sparse_key_names_[tid],
-                                     &features_[tid],
-                                     &feature_values_[tid],
-                                     table.fea_dim(),
-                                     sparse_value_names_[tid]);
+      if (!pulled) {
+        fleet_ptr_->PullSparseVarsSync(*thread_scope_,
+                                       tid,
+                                       sparse_key_names_[tid],
+                                       &features_[tid],
+                                       &feature_values_[tid],
+                                       table.fea_dim(),
+                                       sparse_value_names_[tid]);
+      }
       CollectLabelInfo(i);
       FillSparseValue(i);
       auto nid_iter = std::find(sparse_value_names_[tid].begin(),
@@ -1061,19 +1114,7 @@ void DownpourWorker::TrainFiles() {
 
     if (need_to_push_sparse_) {
       VLOG(3) << "push sparse gradient done.";
-      int32_t tmp_push_sparse_wait_times = -1;
-      static uint32_t push_sparse_wait_times =
-          static_cast<uint32_t>(tmp_push_sparse_wait_times);
-      if (push_sparse_status_.size() >= push_sparse_wait_times) {
-        for (auto& t : push_sparse_status_) {
-          t.wait();
-        }
-        push_sparse_status_.resize(0);
-      }
-
-      if (tmp_push_sparse_wait_times == -1) {
-        push_sparse_status_.resize(0);
-      }
+      BoundPushInflight(FLAGS_downpour_max_push_inflight_batches);
     }
 
     if (need_to_push_dense_) {
@@ -1095,6 +1136,9 @@ void DownpourWorker::TrainFiles() {
     thread_scope_->DropKids();
     ++batch_cnt;
   }
+  if (FLAGS_downpour_max_push_inflight_batches >= 0) {
+    BoundPushInflight(0);
+  }
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
   }
@@ -12,10 +12,13 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/device_worker.h"
 #include "paddle/fluid/operators/isfinite_op.h"
 #include "paddle/phi/core/platform/cpu_helper.h"
 
+COMMON_DECLARE_int32(downpour_max_push_inflight_batches);
+
 namespace paddle::framework {
 
 class OpDesc;
@@ -514,19 +517,7 @@ void DownpourWorkerOpt::TrainFiles() {
 
     if (need_to_push_sparse_) {
       VLOG(3) << "push sparse gradient done.";
-      int32_t tmp_push_sparse_wait_times = -1;
-      static uint32_t push_sparse_wait_times =
-          static_cast<uint32_t>(tmp_push_sparse_wait_times);
-      if (push_sparse_status_.size() >= push_sparse_wait_times) {
-        for (auto& t : push_sparse_status_) {
-          t.wait();
-        }
-        push_sparse_status_.resize(0);
-      }
-
-      if (tmp_push_sparse_wait_times == -1) {
-        push_sparse_status_.resize(0);
-      }
+      BoundPushInflight(FLAGS_downpour_max_push_inflight_batches);
     }
 
     if (need_to_push_dense_) {
@@ -548,6 +539,9 @@ void DownpourWorkerOpt::TrainFiles() {
     thread_scope_->DropKids();
     ++batch_cnt;
   }
+  if (FLAGS_downpour_max_push_inflight_batches >= 0) {
+    BoundPushInflight(0);
+  }
   if (need_dump_field_ || need_dump_param_) {
     writer_.Flush();
   }
@@ -64,6 +64,12 @@ class InterpreterCoreInfo {
     std::shared_ptr<InterpreterCore> core_{nullptr};
     std::set<std::string> skip_eager_delete_vars_;
     std::unique_ptr<::pir::Program> ir_prog_{nullptr};
+    // Variables of the inputs, parameters and outputs in the scope of core_,
+    // bound once so that the later runs share tensors without name lookups.
+    bool vars_bound_{false};
+    std::vector<Variable*> input_vars_;
+    std::vector<Variable*> param_vars_;
+    std::vector<Variable*> output_vars_;
   };
 
   bool IsAvailable(bool is_grad) {
@@ -84,18 +90,35 @@ class InterpreterCoreInfoCache {
  public:
   static InterpreterCoreInfoCache& Instance();
 
+  static int64_t CacheKey(int64_t program_id,
+                          const framework::Scope* scope,
+                          const int64_t& place_hash_key,
+                          bool in_pir_mode) {
+    if (in_pir_mode) {
+      int64_t scope_i = reinterpret_cast<int64_t>(scope);
+      program_id = hash_with_seed(program_id, scope_i);
+      program_id = hash_with_seed(program_id, place_hash_key);
+    }
+    return program_id;
+  }
+
   bool Has(int64_t program_id,
            const framework::Scope* scope,
            const int64_t& place_hash_key,
            bool is_grad,
            bool in_pir_mode) {
-    if (in_pir_mode) {
-      int64_t scope_i = reinterpret_cast<int64_t>(scope);
-      program_id = hash_with_seed(program_id, scope_i);
-      program_id = hash_with_seed(program_id, place_hash_key);
+    return Find(CacheKey(program_id, scope, place_hash_key, in_pir_mode),
+                is_grad) != nullptr;
+  }
+
+  // The cached value of a key computed by CacheKey, nullptr if there is no
+  // core for it. Only one lookup, for the hot path of run_program.
+  InterpreterCoreInfo::CacheValue* Find(int64_t key, bool is_grad) {
+    auto iter = info_map_.find(key);
+    if (iter == info_map_.end() || !iter->second.IsAvailable(is_grad)) {
+      return nullptr;
     }
-    return info_map_.find(program_id) != info_map_.end() &&
-           info_map_[program_id].IsAvailable(is_grad);
+    return &iter->second.GetMutable(is_grad);
   }
 
   InterpreterCoreInfo::CacheValue& GetMutable(int64_t program_id,
@@ -103,12 +126,8 @@ class InterpreterCoreInfoCache {
                                               const int64_t& place_hash_key,
                                               bool is_grad,
                                               bool in_pir_mode) {
-    if (in_pir_mode) {
-      int64_t scope_i = reinterpret_cast<int64_t>(scope);
-      program_id = hash_with_seed(program_id, scope_i);
-      program_id = hash_with_seed(program_id, place_hash_key);
-    }
-    return info_map_[program_id].GetMutable(is_grad);
+    return info_map_[CacheKey(program_id, scope, place_hash_key, in_pir_mode)]
+        .GetMutable(is_grad);
   }
 
   void UpdateSkipEagerDeleteVars(int64_t program_id,
@@ -81,6 +81,38 @@ __global__ void PullCopy(
   }  // end kernel loop
 }
 
+// PullCopy for outputs that are slices of one slot-contiguous buffer: row i of
+// the packed keys is row i of the outputs, so no slot lookup is needed.
+template <size_t EMBEDX_DIM, size_t EXPAND_EMBED_DIM>
+__global__ void PullCopyContiguous(
+    float* dest,
+    const boxps::FeatureValueGpu<EMBEDX_DIM, EXPAND_EMBED_DIM>* src,
+    const uint64_t* keys,
+    int hidden,
+    int total_len) {
+  CUDA_KERNEL_LOOP(i, total_len) {
+    float* row = dest + static_cast<int64_t>(i) * hidden;
+    if (keys[i] == 0) {
+      for (int j = 0; j < hidden; j++) {
+        row[j] = 0;
+      }
+      continue;
+    }
+    row[0] = (src + i)->show;
+    row[1] = (src + i)->clk;
+    row[2] = (src + i)->embed_w;
+    if ((src + i)->embedding_size == 0) {
+      for (int j = 0; j < hidden - 3; j++) {
+        row[3 + j] = 0;
+      }
+    } else {
+      for (int j = 0; j < hidden - 3; j++) {
+        row[3 + j] = (src + i)->embedx[1 + j];
+      }
+    }
+  }
+}
+
 __global__ void CopyKeysKernel(uint64_t** src_keys,
                                uint64_t* dest_total_keys,
                                const int64_t* len,
@@ -150,10 +182,49 @@ void BoxWrapper::CopyForPull(const phi::Place& place,
                              const int slot_num,
                              const int hidden_size,
                              const int expand_embed_dim,
-                             const int64_t total_length) {
+                             const int64_t total_length,
+                             const uint64_t* total_keys,
+                             float* total_dest) {
   auto stream = dynamic_cast<phi::GPUContext*>(
                     phi::DeviceContextPool::Instance().Get(place))
                     ->stream();
+  if (total_dest != nullptr) {
+    // slot-contiguous outputs: a single pass over the packed keys, without
+    // uploading the per-slot output pointers
+    PADDLE_ENFORCE_EQ(expand_embed_dim,
+                      0,
+                      common::errors::InvalidArgument(
+                          "Slot-contiguous pull does not support expand "
+                          "embedding, but expand_embed_dim is %d.",
+                          expand_embed_dim));
+#define EMBEDX_CONTIGUOUS_CASE(i)                                              \
+  case i: {                                                                    \
+    constexpr size_t EmbedxDim = i;                                            \
+    PullCopyContiguous<EmbedxDim, 0>                                           \
+        <<<(total_length + 512 - 1) / 512, 512, 0, stream>>>(                  \
+            total_dest,                                                        \
+            reinterpret_cast<boxps::FeatureValueGpu<EmbedxDim, 0>*>(           \
+                total_values_gpu),                                             \
+            total_keys,                                                        \
+            hidden_size,                                                       \
+            total_length);                                                     \
+  } break
+
+    switch (hidden_size - 3) {
+      EMBEDX_CONTIGUOUS_CASE(8);
+      EMBEDX_CONTIGUOUS_CASE(16);
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Unsupport this embedding size [%d]", hidden_size - 3));
+    }
+#ifdef PADDLE_WITH_HIP
+    hipStreamSynchronize(stream);
+#else
+    cudaStreamSynchronize(stream);
+#endif
+#undef EMBEDX_CONTIGUOUS_CASE
+    return;
+  }
   auto buf_value = memory::Alloc(place, values.size() * sizeof(float*));
   float** gpu_values = reinterpret_cast<float**>(buf_value->ptr());
 #ifdef PADDLE_WITH_HIP
@@ -401,6 +401,8 @@ class BoxWrapper {
                       const int expand_embed_dim,
                       const int batch_size);
 
+  // total_dest, when not null, is the start of the rows of all the slots laid
+  // out back to back, which are then written by key index from total_keys
   void CopyForPull(const phi::Place& place,
                    uint64_t** gpu_keys,
                    const std::vector<float*>& values,
@@ -409,7 +411,9 @@ class BoxWrapper {
                    const int slot_num,
                    const int hidden_size,
                    const int expand_embed_dim,
-                   const int64_t total_length);
+                   const int64_t total_length,
+                   const uint64_t* total_keys = nullptr,
+                   float* total_dest = nullptr);
 
   void CopyForPush(const phi::Place& place,
                    const std::vector<const float*>& grad_values,
@@ -101,6 +101,25 @@ void BoxWrapper::PullSparseCase(const phi::Place& place,
 
     VLOG(3) << "Begin Copy result to tensor, total_length[" << total_length
             << "]";
+    // the outputs of pull_box_sparse are slices of one slot-contiguous arena,
+    // which is then filled in a single pass over the packed keys
+    float* total_dest = nullptr;
+    if (expand_embed_dim == 0) {
+      int64_t offset = 0;
+      for (size_t i = 0; i < values.size(); ++i) {
+        if (slot_lengths[i] == 0) {
+          continue;
+        }
+        if (total_dest == nullptr) {
+          total_dest = values[i];
+        }
+        if (values[i] != total_dest + offset * hidden_size) {
+          total_dest = nullptr;
+          break;
+        }
+        offset += slot_lengths[i];
+      }
+    }
     this->CopyForPull(place,
                       gpu_keys,
                       values,
@@ -109,7 +128,9 @@ void BoxWrapper::PullSparseCase(const phi::Place& place,
                       static_cast<int>(slot_lengths.size()),
                       hidden_size,
                       expand_embed_dim,
-                      total_length);
+                      total_length,
+                      total_keys,
+                      total_dest);
 #else
     PADDLE_THROW(common::errors::PreconditionNotMet(
         "Please compile WITH_GPU option, because NCCL doesn't support "
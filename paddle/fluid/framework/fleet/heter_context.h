@@ -92,6 +92,10 @@ class HeterContext {
   std::vector<std::vector<FeatureValue>> device_values_;
   std::vector<std::vector<FeatureKey>> device_keys_;
   std::vector<std::vector<std::vector<FeatureKey>>> device_dim_keys_;
+  // rows of the hbm pools to build from the cpu table when the pass reuses
+  // the rows resident from the pass before, the other rows are kept
+  std::vector<std::vector<std::vector<uint32_t>>> device_dim_build_rows_;
+  bool incremental_build_ = false;
   std::vector<std::mutex*> mutex_;
   std::vector<std::vector<std::mutex*>> dim_mutex_;
   int multi_mf_dim_ = 0;
@@ -194,7 +198,9 @@ class HeterContext {
           device_dim_ptr_[i][j].clear();
         }
       }
+      device_dim_build_rows_.clear();
     }
+    incremental_build_ = false;
 
     for (auto& item : keys2rank_map_vec_) {
       item.clear();
@@ -323,6 +323,20 @@ class CommonFeatureValueAccessor {
       gpu_val[common_feature_value.MfSizeIndex()] =
           common_feature_value.MFSize(mf_dim) / sizeof(float);
 
+      if (cpu_accessor->common_feature_value.IsEmbedxCompact()) {
+        // embedx_w is stored in fp16 or int8 on cpu
+        int sgd_dim = cpu_accessor->common_feature_value.EmbedxSgdDim(mf_dim);
+        const float* cpu_embedx =
+            cpu_val + cpu_accessor->common_feature_value.EmbedxG2SumIndex();
+        for (int x = 0; x < sgd_dim; x++) {
+          gpu_val[common_feature_value.EmbedxG2SumIndex() + x] = cpu_embedx[x];
+        }
+        cpu_accessor->common_feature_value.DecodeEmbedxW(
+            cpu_embedx + sgd_dim,
+            mf_dim,
+            gpu_val + common_feature_value.EmbedxG2SumIndex() + sgd_dim);
+        return;
+      }
       for (size_t x = 0;
            x < (common_feature_value.MFSize(mf_dim) / sizeof(float));
            x++) {
@@ -438,7 +452,20 @@ class CommonFeatureValueAccessor {
           gpu_val[common_feature_value.EmbedG2SumIndex() + i];
     }
 
-    if (gpu_val[common_feature_value.MfSizeIndex()] > 0) {
+    if (gpu_val[common_feature_value.MfSizeIndex()] > 0 &&
+        cpu_accessor->common_feature_value.IsEmbedxCompact()) {
+      // embedx_w is stored in fp16 or int8 on cpu
+      int sgd_dim = cpu_accessor->common_feature_value.EmbedxSgdDim(mf_dim);
+      float* cpu_embedx =
+          cpu_val + cpu_accessor->common_feature_value.EmbedxG2SumIndex();
+      for (int x = 0; x < sgd_dim; x++) {
+        cpu_embedx[x] = gpu_val[common_feature_value.EmbedxG2SumIndex() + x];
+      }
+      cpu_accessor->common_feature_value.EncodeEmbedxW(
+          gpu_val + common_feature_value.EmbedxG2SumIndex() + sgd_dim,
+          mf_dim,
+          cpu_embedx + sgd_dim);
+    } else if (gpu_val[common_feature_value.MfSizeIndex()] > 0) {
       for (size_t x = 0;
            x < (common_feature_value.MFSize(mf_dim) / sizeof(float));
            x++) {
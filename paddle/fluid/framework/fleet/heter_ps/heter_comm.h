@@ -537,6 +537,13 @@ class HeterComm {
                            KeyType* d_keys,
                            float* d_vals,
                            const size_t& len);
+#if defined(PADDLE_WITH_CUDA)
+  // inner all2all pull
+  void pull_sparse_inner_all2all(const int& gpu_id,
+                                 KeyType* d_keys,
+                                 float* d_vals,
+                                 const size_t& len);
+#endif
 
   template <typename Sgd>
   void push_normal_sparse(int num,
@@ -35,6 +35,7 @@ COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_bool(enable_tracker_all2all);
 COMMON_DECLARE_bool(enable_all2all_use_fp16);
 COMMON_DECLARE_bool(enable_sparse_inner_gather);
+COMMON_DECLARE_bool(enable_pull_inner_all2all);
 COMMON_DECLARE_bool(graph_embedding_split_infer_mode);
 
 namespace paddle {
@@ -1808,12 +1809,254 @@ void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_normal_sparse(
   }
 }
 
+#if defined(PADDLE_WITH_CUDA)
+// Pulls the keys of a card from the tables of the cards of the node by nccl
+// all2all over the inner comms, each card looks its own table up, instead of
+// the p2p copies along the transfer paths. All the cards of the node call it
+// for the same batch. The keys are deduplicated before they are sent, and the
+// own shard is looked up while the keys of the other cards are on the way.
+template <typename KeyType,
+          typename ValType,
+          typename GradType,
+          typename GPUAccessor>
+void HeterComm<KeyType, ValType, GradType, GPUAccessor>::
+    pull_sparse_inner_all2all(const int &gpu_id,
+                              KeyType *d_keys,
+                              float *d_vals,
+                              const size_t &len) {
+  int total_device = resource_->total_device();
+  int dev_id = resource_->dev_id(gpu_id);
+  DevPlace place = DevPlace(dev_id);
+  AnyDeviceGuard guard(dev_id);
+  auto stream = resource_->local_stream(gpu_id, 0);
+  auto nccl_stream = resource_->comm_stream(gpu_id, 0);
+  auto &comm = nccl_inner_comms_[gpu_id];
+
+  auto accessor_wrapper_ptr =
+      GlobalAccessorFactory::GetInstance().GetAccessorWrapper();
+  size_t val_type_size = accessor_wrapper_ptr->GetPullValueSize(max_mf_dim_);
+  size_t alloc_len = std::max(len, static_cast<size_t>(1));
+
+  int h_left[total_device];   // NOLINT
+  int h_right[total_device];  // NOLINT
+  auto d_left = MemoryAlloc(place, total_device * sizeof(int));
+  auto d_right = MemoryAlloc(place, total_device * sizeof(int));
+  int *d_left_ptr = reinterpret_cast<int *>(d_left->ptr());
+  int *d_right_ptr = reinterpret_cast<int *>(d_right->ptr());
+  cudaMemsetAsync(d_left_ptr, -1, total_device * sizeof(int), stream);
+  cudaMemsetAsync(d_right_ptr, -1, total_device * sizeof(int), stream);
+
+  auto d_sorted_keys = MemoryAlloc(place, alloc_len * sizeof(KeyType));
+  auto d_sorted_keys_ptr = reinterpret_cast<KeyType *>(d_sorted_keys->ptr());
+  auto d_merged_keys = MemoryAlloc(place, alloc_len * sizeof(KeyType));
+  auto d_merged_keys_ptr = reinterpret_cast<KeyType *>(d_merged_keys->ptr());
+  auto d_restore_idx = MemoryAlloc(place, alloc_len * sizeof(uint32_t));
+  auto d_restore_idx_ptr = reinterpret_cast<uint32_t *>(d_restore_idx->ptr());
+  auto d_shard_keys = MemoryAlloc(place, alloc_len * sizeof(KeyType));
+  auto d_shard_keys_ptr = reinterpret_cast<KeyType *>(d_shard_keys->ptr());
+  auto d_shard_vals = MemoryAlloc(place, alloc_len * val_type_size);
+  auto d_shard_vals_ptr = reinterpret_cast<char *>(d_shard_vals->ptr());
+  auto d_idx = MemoryAlloc(place, alloc_len * sizeof(int));
+  auto d_idx_ptr = reinterpret_cast<int *>(d_idx->ptr());
+
+  // a card without keys still takes part in the exchange
+  size_t uniq_len = 0;
+  if (len > 0) {
+    uniq_len = merge_keys(gpu_id,
+                          d_keys,
+                          len,
+                          d_sorted_keys_ptr,
+                          d_merged_keys_ptr,
+                          d_restore_idx_ptr,
+                          stream);
+    split_idx_to_shard(d_merged_keys_ptr,
+                       d_idx_ptr,
+                       uniq_len,
+                       d_left_ptr,
+                       d_right_ptr,
+                       gpu_id,
+                       stream);
+    heter_comm_kernel_->fill_shard_key(d_shard_keys_ptr,
+                                       d_merged_keys_ptr,
+                                       d_idx_ptr,
+                                       uniq_len,
+                                       stream,
+                                       dev_id);
+  }
+  memory_copy(phi::CPUPlace(),
+              h_left,
+              place,
+              d_left_ptr,
+              total_device * sizeof(int),
+              stream);
+  memory_copy(phi::CPUPlace(),
+              h_right,
+              place,
+              d_right_ptr,
+              total_device * sizeof(int),
+              stream);
+  sync_stream(stream);
+
+  // the sizes of the shards, then the keys, then the values back
+  std::vector<size_t> h_sizes(4 * total_device, 0);
+  size_t *h_send_sizes = h_sizes.data();
+  size_t *h_send_offsets = h_send_sizes + total_device;
+  size_t *h_recv_sizes = h_send_offsets + total_device;
+  size_t *h_recv_offsets = h_recv_sizes + total_device;
+  for (int i = 0; i < total_device; ++i) {
+    if (h_left[i] != -1 && h_right[i] != -1) {
+      h_send_sizes[i] = h_right[i] - h_left[i] + 1;
+      h_send_offsets[i] = h_left[i];
+    }
+  }
+  auto d_sizes = MemoryAlloc(place, 2 * total_device * sizeof(size_t));
+  size_t *d_send_sizes = reinterpret_cast<size_t *>(d_sizes->ptr());
+  size_t *d_recv_sizes = d_send_sizes + total_device;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(d_send_sizes,
+                                             h_send_sizes,
+                                             total_device * sizeof(size_t),
+                                             cudaMemcpyHostToDevice,
+                                             nccl_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemsetAsync(
+      d_recv_sizes, 0, total_device * sizeof(size_t), nccl_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupStart());
+  for (int i = 0; i < total_device; ++i) {
+    if (i == gpu_id) {
+      continue;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclSend(
+        d_send_sizes + i, 1, ncclUint64, i, comm, nccl_stream));
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclRecv(
+        d_recv_sizes + i, 1, ncclUint64, i, comm, nccl_stream));
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupEnd());
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(h_recv_sizes,
+                                             d_recv_sizes,
+                                             total_device * sizeof(size_t),
+                                             cudaMemcpyDeviceToHost,
+                                             nccl_stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(nccl_stream));
+  size_t total_recv = 0;
+  for (int i = 0; i < total_device; ++i) {
+    h_recv_offsets[i] = total_recv;
+    total_recv += h_recv_sizes[i];
+  }
+  auto d_recv_keys = MemoryAlloc(
+      place, std::max(total_recv, static_cast<size_t>(1)) * sizeof(KeyType));
+  auto d_recv_keys_ptr = reinterpret_cast<KeyType *>(d_recv_keys->ptr());
+  auto d_recv_vals = MemoryAlloc(
+      place, std::max(total_recv, static_cast<size_t>(1)) * val_type_size);
+  auto d_recv_vals_ptr = reinterpret_cast<char *>(d_recv_vals->ptr());
+
+  ptr_tables_[gpu_id]->rwlock_->RDLock();
+  // the own shard overlaps the exchange of the keys
+  if (h_send_sizes[gpu_id] > 0) {
+    ptr_tables_[gpu_id]->get(
+        d_shard_keys_ptr + h_send_offsets[gpu_id],
+        d_shard_vals_ptr + h_send_offsets[gpu_id] * val_type_size,
+        h_send_sizes[gpu_id],
+        stream,
+        gpu_accessor_);
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupStart());
+  for (int i = 0; i < total_device; ++i) {
+    if (i == gpu_id) {
+      continue;
+    }
+    if (h_send_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::dynload::ncclSend(d_shard_keys_ptr + h_send_offsets[i],
+                                 h_send_sizes[i] * sizeof(KeyType),
+                                 ncclInt8,
+                                 i,
+                                 comm,
+                                 nccl_stream));
+    }
+    if (h_recv_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::dynload::ncclRecv(d_recv_keys_ptr + h_recv_offsets[i],
+                                 h_recv_sizes[i] * sizeof(KeyType),
+                                 ncclInt8,
+                                 i,
+                                 comm,
+                                 nccl_stream));
+    }
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupEnd());
+  // the lookup for the other cards is ordered after the exchange on the
+  // nccl stream
+  if (total_recv > 0) {
+    ptr_tables_[gpu_id]->get(d_recv_keys_ptr,
+                             d_recv_vals_ptr,
+                             total_recv,
+                             nccl_stream,
+                             gpu_accessor_);
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupStart());
+  for (int i = 0; i < total_device; ++i) {
+    if (i == gpu_id) {
+      continue;
+    }
+    if (h_recv_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclSend(
+          d_recv_vals_ptr + h_recv_offsets[i] * val_type_size,
+          h_recv_sizes[i] * val_type_size,
+          ncclInt8,
+          i,
+          comm,
+          nccl_stream));
+    }
+    if (h_send_sizes[i] > 0) {
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclRecv(
+          d_shard_vals_ptr + h_send_offsets[i] * val_type_size,
+          h_send_sizes[i] * val_type_size,
+          ncclInt8,
+          i,
+          comm,
+          nccl_stream));
+    }
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::ncclGroupEnd());
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(nccl_stream));
+  sync_stream(stream);
+  ptr_tables_[gpu_id]->rwlock_->UNLock();
+
+  if (len == 0) {
+    return;
+  }
+  auto d_merged_vals = MemoryAlloc(place, uniq_len * val_type_size);
+  auto d_merged_vals_ptr = reinterpret_cast<float *>(d_merged_vals->ptr());
+  heter_comm_kernel_->dy_mf_fill_dvals(
+      reinterpret_cast<float *>(d_shard_vals_ptr),
+      d_merged_vals_ptr,
+      d_idx_ptr,
+      uniq_len,
+      val_type_size,
+      stream);
+  heter_comm_kernel_->unpack_merged_vals(len,
+                                         d_keys,
+                                         d_merged_vals_ptr,
+                                         d_restore_idx_ptr,
+                                         d_vals,
+                                         val_type_size,
+                                         stream);
+  sync_stream(stream);
+}
+#endif
+
 template <typename KeyType,
           typename ValType,
           typename GradType,
           typename GPUAccessor>
 void HeterComm<KeyType, ValType, GradType, GPUAccessor>::pull_sparse(
     int num, KeyType *d_keys, float *d_vals, size_t len) {
+#if defined(PADDLE_WITH_CUDA)
+  // every card takes part in the all2all, also without keys
+  if (!multi_node_ && FLAGS_enable_pull_inner_all2all) {
+    pull_sparse_inner_all2all(num, d_keys, d_vals, len);
+    return;
+  }
+#endif
   if (len == 0) {
     return;
   }
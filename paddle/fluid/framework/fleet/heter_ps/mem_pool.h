@@ -104,7 +104,7 @@ class HBMMemoryPoolFix : public managed {
 
   ~HBMMemoryPoolFix() {
     VLOG(3) << "delete hbm memory pool";
-    cudaFree(mem_);
+    release();
   }
 
   size_t block_size() { return block_size_; }
@@ -112,16 +112,95 @@ class HBMMemoryPoolFix : public managed {
   void clear(void) { cudaMemset(mem_, 0, block_size_ * capacity_); }
 
   void reset(size_t capacity, size_t block_size) {
-    if (max_byte_capacity_ < capacity * block_size) {
-      if (mem_ != NULL) {
-        cudaFree(mem_);
-      }
+    if (max_byte_capacity_ < capacity * block_size || managed_ || borrowed_) {
+      release();
       max_byte_capacity_ = (block_size * capacity / 8 + 1) * 8;
       CUDA_CHECK(cudaMalloc(&mem_, max_byte_capacity_));
+      managed_ = false;
+    }
+    size_ = capacity;
+    block_size_ = block_size;
+    capacity_ = max_byte_capacity_ / block_size;
+  }
+
+  // Keeps the first hbm_rows rows in hbm and the others in host memory that
+  // the device reads and writes in place, without migrating the pages, so a
+  // pool may outgrow the hbm. The caller puts the hot rows first.
+  void reset(size_t capacity, size_t block_size, size_t hbm_rows) {
+    if (hbm_rows >= capacity) {
+      reset(capacity, block_size);
+      return;
     }
+    release();
+    max_byte_capacity_ = (block_size * capacity / 8 + 1) * 8;
+    CUDA_CHECK(cudaMallocManaged(&mem_, max_byte_capacity_));
+    managed_ = true;
     size_ = capacity;
     block_size_ = block_size;
     capacity_ = max_byte_capacity_ / block_size;
+
+    int dev_id = 0;
+    CUDA_CHECK(cudaGetDevice(&dev_id));
+    size_t hbm_bytes = hbm_rows * block_size;
+    if (hbm_bytes > 0) {
+      CUDA_CHECK(cudaMemAdvise(
+          mem_, hbm_bytes, cudaMemAdviseSetPreferredLocation, dev_id));
+      CUDA_CHECK(cudaMemPrefetchAsync(mem_, hbm_bytes, dev_id, 0));
+    }
+    CUDA_CHECK(cudaMemAdvise(mem_ + hbm_bytes,
+                             max_byte_capacity_ - hbm_bytes,
+                             cudaMemAdviseSetPreferredLocation,
+                             cudaCpuDeviceId));
+    CUDA_CHECK(cudaMemAdvise(mem_ + hbm_bytes,
+                             max_byte_capacity_ - hbm_bytes,
+                             cudaMemAdviseSetAccessedBy,
+                             dev_id));
+  }
+
+  // like reset, but keeps the rows already in the pool, a pool that has to
+  // grow gets 1/8 more room so that the next passes seldom copy it again
+  void resize(size_t capacity, size_t block_size) {
+    if (block_size != block_size_ || mem_ == NULL) {
+      reset(capacity, block_size);
+      return;
+    }
+    if (max_byte_capacity_ < capacity * block_size || managed_) {
+      size_t byte_capacity =
+          (block_size * (capacity + capacity / 8) / 8 + 1) * 8;
+      char* mem = NULL;
+      CUDA_CHECK(cudaMalloc(&mem, byte_capacity));
+      CUDA_CHECK(cudaMemcpy(
+          mem, mem_, size_ * block_size_, cudaMemcpyDeviceToDevice));
+      release();
+      mem_ = mem;
+      max_byte_capacity_ = byte_capacity;
+    }
+    size_ = capacity;
+    capacity_ = max_byte_capacity_ / block_size;
+  }
+
+  // Uses capacity rows of block_size bytes at mem, which the caller owns, e.g.
+  // the region of one mf dim in a pool shared by all the dims of a device.
+  // The next reset or a resize that has to grow allocates a pool of its own.
+  void reset_view(char* mem, size_t capacity, size_t block_size) {
+    release();
+    mem_ = mem;
+    borrowed_ = true;
+    size_ = capacity;
+    block_size_ = block_size;
+    max_byte_capacity_ = capacity * block_size;
+    capacity_ = capacity;
+  }
+
+  // Frees the memory of the pool unless it is a view.
+  void release() {
+    if (mem_ != NULL && !borrowed_) {
+      cudaFree(mem_);
+    }
+    mem_ = NULL;
+    max_byte_capacity_ = 0;
+    managed_ = false;
+    borrowed_ = false;
   }
 
   char* mem() { return mem_; }
@@ -138,6 +217,10 @@ class HBMMemoryPoolFix : public managed {
   size_t size_;
   size_t block_size_;
   size_t max_byte_capacity_;
+  // the pool is split between hbm and host memory
+  bool managed_ = false;
+  // mem_ is a view set by reset_view
+  bool borrowed_ = false;
 };
 
 }  // namespace framework
@@ -31,6 +31,7 @@ limitations under the License. */
 
 #include <algorithm>
 #include <deque>
+#include <numeric>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/data_set.h"
@@ -48,6 +49,9 @@ COMMON_DECLARE_int32(gpugraph_dedup_pull_push_mode);
 COMMON_DECLARE_int32(gpugraph_storage_mode);
 COMMON_DECLARE_bool(query_dest_rank_by_multi_node);
 COMMON_DECLARE_string(graph_edges_split_mode);
+COMMON_DECLARE_bool(gpups_incremental_pass_build);
+COMMON_DECLARE_double(gpups_hbm_cache_ratio);
+COMMON_DECLARE_bool(gpups_share_dim_pools);
 
 namespace paddle::framework {
 
@@ -1666,6 +1670,179 @@ void PSGPUWrapper::divide_to_device(std::shared_ptr<HeterContext> gpu_task) {
           << " seconds.";
 }
 
+// Lays the keys of the pass out on the rows of the hbm pools of the pass
+// before: a key that stays keeps its row, the new keys take the rows of the
+// keys that left and then the rows past the end. Only the rows of the new keys
+// are built from the cpu table, the kept rows are in sync with it since the
+// rows changed in a pass are dumped at its end.
+void PSGPUWrapper::ReuseResidentKeys(std::shared_ptr<HeterContext> gpu_task) {
+  platform::Timer timeline;
+  timeline.Start();
+  int device_num = heter_devices_.size();
+  auto& build_rows = gpu_task->device_dim_build_rows_;
+  build_rows.resize(device_num);
+  for (auto& dim_rows : build_rows) {
+    dim_rows.resize(multi_mf_dim_);
+  }
+  std::vector<size_t> reused_counts(device_num * multi_mf_dim_, 0);
+
+  auto reuse_func = [this, &gpu_task, &build_rows, &reused_counts](int i,
+                                                                    int j) {
+    uint64_t unuse_key = std::numeric_limits<uint64_t>::max();
+    auto& keys = gpu_task->device_dim_keys_[i][j];
+    auto& ptrs = gpu_task->device_dim_ptr_[i][j];
+    auto& rows = build_rows[i][j];
+    rows.clear();
+    if (resident_task_ == nullptr) {
+      rows.resize(keys.size());
+      std::iota(rows.begin(), rows.end(), 0);
+      return;
+    }
+    auto& old_keys = resident_task_->device_dim_keys_[i][j];
+    auto& old_ptrs = resident_task_->device_dim_ptr_[i][j];
+    std::unordered_map<uint64_t, uint32_t> old_rows;
+    old_rows.reserve(old_keys.size());
+    for (size_t row = 0; row < old_keys.size(); ++row) {
+      if (old_keys[row] != unuse_key) {
+        old_rows.emplace(old_keys[row], row);
+      }
+    }
+
+    std::remove_reference_t<decltype(keys)> row_keys(old_keys.size(),
+                                                     unuse_key);
+    std::remove_reference_t<decltype(ptrs)> row_ptrs(old_keys.size(),
+                                                     nullptr);
+    std::vector<size_t> new_pos;
+    for (size_t k = 0; k < keys.size(); ++k) {
+      auto it = old_rows.find(keys[k]);
+      // a value recreated in the cpu table is built again
+      if (it != old_rows.end() && old_ptrs[it->second] == ptrs[k]) {
+        row_keys[it->second] = keys[k];
+        row_ptrs[it->second] = ptrs[k];
+      } else {
+        new_pos.push_back(k);
+      }
+    }
+    reused_counts[i * multi_mf_dim_ + j] = keys.size() - new_pos.size();
+
+    size_t row = 0;
+    for (auto k : new_pos) {
+      while (row < row_keys.size() && row_keys[row] != unuse_key) {
+        ++row;
+      }
+      if (row == row_keys.size()) {
+        row_keys.push_back(keys[k]);
+        row_ptrs.push_back(ptrs[k]);
+      } else {
+        row_keys[row] = keys[k];
+        row_ptrs[row] = ptrs[k];
+      }
+      rows.push_back(row);
+      ++row;
+    }
+    while (!row_keys.empty() && row_keys.back() == unuse_key) {
+      row_keys.pop_back();
+      row_ptrs.pop_back();
+    }
+    keys.swap(row_keys);
+    ptrs.swap(row_ptrs);
+  };
+
+  std::vector<std::future<void>> task_futures;
+  for (int i = 0; i < device_num; i++) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      task_futures.emplace_back(cpu_work_pool_[i]->enqueue(reuse_func, i, j));
+    }
+  }
+  for (auto& f : task_futures) {
+    f.wait();
+  }
+  gpu_task->incremental_build_ = true;
+  timeline.Pause();
+
+  size_t total_reused = 0;
+  size_t total_built = 0;
+  for (int i = 0; i < device_num; i++) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      total_reused += reused_counts[i * multi_mf_dim_ + j];
+      total_built += build_rows[i][j].size();
+    }
+  }
+  VLOG(0) << "passid=" << gpu_task->pass_id_
+          << ", ReuseResidentKeys reused keys: " << total_reused
+          << ", new keys: " << total_built << ", cost "
+          << timeline.ElapsedSec() << " seconds.";
+}
+
+// Puts the most shown keys first in each pool, they are the rows kept in hbm
+// when FLAGS_gpups_hbm_cache_ratio leaves the others in host memory. The shows
+// are the ones dumped at the end of the pass before, so the keys that get hot
+// are promoted to hbm pass by pass.
+void PSGPUWrapper::PromoteHotKeys(std::shared_ptr<HeterContext> gpu_task) {
+#ifdef PADDLE_WITH_PSCORE
+  platform::Timer timeline;
+  timeline.Start();
+  int device_num = heter_devices_.size();
+  auto promote_func = [this, &gpu_task](int i, int j) {
+    auto& keys = gpu_task->device_dim_keys_[i][j];
+    auto& ptrs = gpu_task->device_dim_ptr_[i][j];
+    size_t hbm_rows =
+        static_cast<size_t>(keys.size() * FLAGS_gpups_hbm_cache_ratio);
+    if (hbm_rows >= keys.size()) {
+      return;
+    }
+    std::vector<std::pair<float, uint32_t>> shows(keys.size());
+    for (size_t k = 0; k < keys.size(); ++k) {
+      shows[k] = std::make_pair(
+          cpu_table_accessor_->GetField(ptrs[k]->data(), "show"), k);
+    }
+    std::nth_element(shows.begin(),
+                     shows.begin() + hbm_rows,
+                     shows.end(),
+                     [](const std::pair<float, uint32_t>& l,
+                        const std::pair<float, uint32_t>& r) {
+                       return l.first > r.first;
+                     });
+    std::remove_reference_t<decltype(keys)> hot_keys(keys.size());
+    std::remove_reference_t<decltype(ptrs)> hot_ptrs(ptrs.size());
+    for (size_t k = 0; k < shows.size(); ++k) {
+      hot_keys[k] = keys[shows[k].second];
+      hot_ptrs[k] = ptrs[shows[k].second];
+    }
+    keys.swap(hot_keys);
+    ptrs.swap(hot_ptrs);
+  };
+
+  std::vector<std::future<void>> task_futures;
+  for (int i = 0; i < device_num; i++) {
+    for (int j = 0; j < multi_mf_dim_; j++) {
+      task_futures.emplace_back(
+          cpu_work_pool_[i]->enqueue(promote_func, i, j));
+    }
+  }
+  for (auto& f : task_futures) {
+    f.wait();
+  }
+  timeline.Pause();
+  VLOG(1) << "passid=" << gpu_task->pass_id_
+          << ", PromoteHotKeys hbm cache ratio: "
+          << FLAGS_gpups_hbm_cache_ratio << ", cost "
+          << timeline.ElapsedSec() << " seconds.";
+#endif
+}
+
+void PSGPUWrapper::ReleaseResidentTable() {
+  if (current_task_ != nullptr) {
+    PADDLE_THROW(common::errors::PreconditionNotMet(
+        "[ReleaseResidentTable] the resident table can not be released "
+        "before the pass ends."));
+  }
+  if (resident_task_ != nullptr) {
+    gpu_task_pool_.Push(resident_task_);
+    resident_task_ = nullptr;
+  }
+}
+
 void PSGPUWrapper::PrepareGPUTask(std::shared_ptr<HeterContext> gpu_task) {
   platform::Timer timeline;
   int device_num = heter_devices_.size();
@@ -1829,6 +2006,11 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
           size_t feature_value_size =
               accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
           size_t len = device_dim_ptrs.size();
+          const uint32_t* build_rows = nullptr;
+          if (gpu_task->incremental_build_) {
+            build_rows = gpu_task->device_dim_build_rows_[i][j].data();
+            len = gpu_task->device_dim_build_rows_[i][j].size();
+          }
           size_t start = tid * once_gpu_copy;
           while (start < len) {
             size_t real_len =
@@ -1839,17 +2021,18 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
                 [](char* p) { delete[] p; });
             char* test_build_values = build_values.get();
             for (size_t k = start; k < end; k++) {
+              size_t row = build_rows ? build_rows[k] : k;
 #ifdef PADDLE_WITH_PSCORE
               void* val = reinterpret_cast<float*>(
                   test_build_values + (k - start) * feature_value_size);
               accessor_wrapper_ptr->BuildFill(
-                  val, device_dim_ptrs[k], cpu_table_accessor_, mf_dim);
+                  val, device_dim_ptrs[row], cpu_table_accessor_, mf_dim);
 #endif
 #ifdef PADDLE_WITH_PSLIB
               float* val = reinterpret_cast<float*>(
                   test_build_values + (k - start) * feature_value_size);
               accessor_wrapper_ptr->BuildFill(val,
-                                              device_dim_ptrs[k],
+                                              device_dim_ptrs[row],
                                               cpu_table_accessor_,
                                               mf_dim,
                                               accessor_class_);
@@ -1862,6 +2045,7 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
             task.multi_mf_dim = j;
             task.start = 0;
             task.end = static_cast<int>(real_len);
+            task.rows = build_rows ? build_rows + start : nullptr;
             cpu_reday_channels_[i]->Put(task);
             // step
             start = start + (once_gpu_copy * cpu_device_thread_num_);
@@ -1887,14 +2071,48 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
                                 infer_mode_);
     // insert hbm table
     stagetime.Start();
+    bool share_dim_pools = FLAGS_gpups_share_dim_pools &&
+                           !gpu_task->incremental_build_ &&
+                           FLAGS_gpups_hbm_cache_ratio >= 1.0 &&
+                           multi_mf_dim_ > 1;
+    if (share_dim_pools) {
+      // the rows of every dim take a 256 bytes aligned region of one pool
+      std::vector<size_t> offsets(multi_mf_dim_ + 1, 0);
+      for (int j = 0; j < multi_mf_dim_; j++) {
+        size_t bytes = gpu_task->device_dim_keys_[i][j].size() *
+                       accessor_wrapper_ptr->GetFeatureValueSize(
+                           this->index_dim_vec_[j]);
+        offsets[j + 1] = offsets[j] + (bytes + 255) / 256 * 256;
+      }
+      auto arena = this->hbm_dim_arenas_[i];
+      arena->reset(offsets[multi_mf_dim_], 1);
+      for (int j = 0; j < multi_mf_dim_; j++) {
+        this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset_view(
+            arena->mem() + offsets[j],
+            gpu_task->device_dim_keys_[i][j].size(),
+            accessor_wrapper_ptr->GetFeatureValueSize(this->index_dim_vec_[j]));
+      }
+    }
     for (int j = 0; j < multi_mf_dim_; j++) {
       auto& device_dim_keys = gpu_task->device_dim_keys_[i][j];
       size_t len = device_dim_keys.size();
       int mf_dim = this->index_dim_vec_[j];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(len,
-                                                           feature_value_size);
+      if (gpu_task->incremental_build_) {
+        // the rows kept from the pass before stay in place
+        this->hbm_pools_[i * this->multi_mf_dim_ + j]->resize(
+            len, feature_value_size);
+      } else if (FLAGS_gpups_hbm_cache_ratio < 1.0) {
+        // the hot keys go first, the rows past hbm_rows stay in host memory
+        size_t hbm_rows =
+            static_cast<size_t>(len * FLAGS_gpups_hbm_cache_ratio);
+        this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(
+            len, feature_value_size, hbm_rows);
+      } else if (!share_dim_pools) {
+        this->hbm_pools_[i * this->multi_mf_dim_ + j]->reset(
+            len, feature_value_size);
+      }
       this->HeterPs_->build_ps(
           i,
           device_dim_keys.data(),
@@ -1910,6 +2128,10 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
         HeterPs_->show_one_table(i);
       }
     }
+    if (!share_dim_pools) {
+      // the pools that were views have copied their rows out by now
+      this->hbm_dim_arenas_[i]->release();
+    }
 
     stagetime.Pause();
     auto build_span = stagetime.ElapsedSec();
@@ -1955,14 +2177,62 @@ void PSGPUWrapper::BuildGPUTask(std::shared_ptr<HeterContext> gpu_task) {
       int mf_dim = this->index_dim_vec_[task.multi_mf_dim];
       size_t feature_value_size =
           accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
-      auto hbm_start = hbm + task.offset * feature_value_size;
-      CUDA_CHECK(cudaMemcpyAsync(
-          hbm_start,
-          task.build_values.get() + task.start * feature_value_size,
-          (task.end - task.start) * feature_value_size,
-          cudaMemcpyHostToDevice,
-          stream));
-      total_len += (task.end - task.start);
+      size_t task_len = task.end - task.start;
+      if (task.rows != nullptr) {
+        auto place = phi::GPUPlace(resource_->dev_id(i));
+        auto d_values = memory::Alloc(place, task_len * feature_value_size);
+        auto d_rows = memory::Alloc(place, task_len * sizeof(uint32_t));
+        CUDA_CHECK(cudaMemcpyAsync(
+            d_values->ptr(),
+            task.build_values.get() + task.start * feature_value_size,
+            task_len * feature_value_size,
+            cudaMemcpyHostToDevice,
+            stream));
+        CUDA_CHECK(cudaMemcpyAsync(d_rows->ptr(),
+                                   task.rows + task.start,
+                                   task_len * sizeof(uint32_t),
+                                   cudaMemcpyHostToDevice,
+                                   stream));
+        ScatterHbmRows(hbm,
+                       reinterpret_cast<char*>(d_values->ptr()),
+                       reinterpret_cast<uint32_t*>(d_rows->ptr()),
+                       task_len,
+                       feature_value_size,
+                       stream);
+        // the staging buffers are freed at the end of the scope
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+      } else {
+        auto hbm_start = hbm + task.offset * feature_value_size;
+        CUDA_CHECK(cudaMemcpyAsync(
+            hbm_start,
+            task.build_values.get() + task.start * feature_value_size,
+            task_len * feature_value_size,
+            cudaMemcpyHostToDevice,
+            stream));
+      }
+      total_len += task_len;
+    }
+    if (gpu_task->incremental_build_) {
+      // the rows in sync with the cpu table, end_pass dumps the others
+      for (int j = 0; j < multi_mf_dim_; j++) {
+        int pool_id = i * this->multi_mf_dim_ + j;
+        size_t len = gpu_task->device_dim_keys_[i][j].size();
+        int mf_dim = this->index_dim_vec_[j];
+        size_t feature_value_size =
+            accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
+        auto& sums = this->hbm_row_sums_[pool_id];
+        if (sums == nullptr || sums->size() < len * sizeof(uint64_t)) {
+          sums.reset();
+          sums = memory::AllocShared(
+              phi::GPUPlace(resource_->dev_id(i)),
+              std::max(len, static_cast<size_t>(1)) * sizeof(uint64_t));
+        }
+        HbmRowSums(this->hbm_pools_[pool_id]->mem(),
+                   len,
+                   feature_value_size,
+                   reinterpret_cast<uint64_t*>(sums->ptr()),
+                   stream);
+      }
     }
     PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
     stagetime.Pause();
@@ -2125,6 +2395,11 @@ void PSGPUWrapper::build_task() {
   MergePull(gpu_task);
   if (multi_mf_dim_) {
     divide_to_device(gpu_task);
+    if (FLAGS_gpups_incremental_pass_build) {
+      ReuseResidentKeys(gpu_task);
+    } else if (FLAGS_gpups_hbm_cache_ratio < 1.0) {
+      PromoteHotKeys(gpu_task);
+    }
   } else {
     PrepareGPUTask(gpu_task);
   }
@@ -2189,7 +2464,15 @@ void PSGPUWrapper::EndPass() {
           << ", EndPass HbmToSparseTable cost time: " << stagetime.ElapsedSec()
           << "s";
 
-  gpu_task_pool_.Push(current_task_);
+  if (current_task_->incremental_build_) {
+    // the rows stay in hbm for the next pass
+    if (resident_task_ != nullptr) {
+      gpu_task_pool_.Push(resident_task_);
+    }
+    resident_task_ = current_task_;
+  } else {
+    gpu_task_pool_.Push(current_task_);
+  }
   current_task_ = nullptr;
   // fleet_ptr->pslib_ptr_->_worker_ptr->release_table_mutex(this->table_id_);
 }
@@ -2260,9 +2543,91 @@ void PSGPUWrapper::HbmToSparseTable() {
 
   int once_cpu_num = 16 * 1024;
   int once_gpu_copy = 8 * once_cpu_num;
+  // the rows changed in the pass, only they are dumped when the rows stay in
+  // hbm for the next pass
+  bool dump_dirty_rows = current_task_->incremental_build_;
+  std::vector<std::vector<uint32_t>> dirty_rows(heter_devices_.size() *
+                                                multi_mf_dim_);
+
+  auto dump_dirty_rows_func = [this, &accessor_wrapper_ptr, &dirty_rows](
+                                  int i, int j, size_t once_gpu_copy) {
+    size_t once_cpu_num = once_gpu_copy / 8;
+    auto stream = this->resource_->local_stream(i, 0);
+    auto place = phi::GPUPlace(this->resource_->dev_id(i));
+    int pool_id = i * this->multi_mf_dim_ + j;
+    auto& hbm_pool = this->hbm_pools_[pool_id];
+    int mf_dim = this->index_dim_vec_[j];
+    size_t feature_value_size =
+        accessor_wrapper_ptr->GetFeatureValueSize(mf_dim);
+    size_t len = this->current_task_->device_dim_keys_[i][j].size();
+    if (len == 0) {
+      return static_cast<size_t>(0);
+    }
+
+    auto d_dirty = memory::Alloc(place, (len + 1) * sizeof(uint32_t));
+    uint32_t* d_dirty_num = reinterpret_cast<uint32_t*>(d_dirty->ptr());
+    uint32_t* d_dirty_rows = d_dirty_num + 1;
+    size_t dirty_len = CollectDirtyHbmRows(
+        hbm_pool->mem(),
+        len,
+        feature_value_size,
+        reinterpret_cast<uint64_t*>(this->hbm_row_sums_[pool_id]->ptr()),
+        d_dirty_rows,
+        d_dirty_num,
+        stream);
+    auto& h_dirty_rows = dirty_rows[pool_id];
+    h_dirty_rows.resize(dirty_len);
+    if (dirty_len == 0) {
+      return dirty_len;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(h_dirty_rows.data(),
+                                               d_dirty_rows,
+                                               dirty_len * sizeof(uint32_t),
+                                               cudaMemcpyDeviceToHost,
+                                               stream));
+    auto d_values = memory::Alloc(
+        place, std::min(dirty_len, once_gpu_copy) * feature_value_size);
+    size_t start = 0;
+    while (start < dirty_len) {
+      size_t real_len = std::min(once_gpu_copy, dirty_len - start);
+      std::shared_ptr<char> build_values(
+          new char[feature_value_size * real_len],
+          [](char* p) { delete[] p; });
+      GatherHbmRows(hbm_pool->mem(),
+                    d_dirty_rows + start,
+                    real_len,
+                    feature_value_size,
+                    reinterpret_cast<char*>(d_values->ptr()),
+                    stream);
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaMemcpyAsync(build_values.get(),
+                          d_values->ptr(),
+                          feature_value_size * real_len,
+                          cudaMemcpyDeviceToHost,
+                          stream));
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+      for (size_t k = 0; k < real_len; k = k + once_cpu_num) {
+        struct task_info task;
+        task.build_values = build_values;
+        task.offset = start;
+        task.device_id = i;
+        task.multi_mf_dim = j;
+        task.start = k;
+        task.end =
+            (k + once_cpu_num) < real_len ? (k + once_cpu_num) : (real_len);
+        task.rows = h_dirty_rows.data() + start;
+        cpu_reday_channels_[i]->Put(task);
+      }
+      start += real_len;
+    }
+    return dirty_len;
+  };
 
-  auto dump_pool_to_cpu_func = [this, &accessor_wrapper_ptr, once_cpu_num](
-                                   int i, size_t once_gpu_copy) {
+  auto dump_pool_to_cpu_func = [this,
+                                &accessor_wrapper_ptr,
+                                &dump_dirty_rows_func,
+                                dump_dirty_rows,
+                                once_cpu_num](int i, size_t once_gpu_copy) {
     platform::Timer tm;
     tm.Start();
     PADDLE_ENFORCE_GPU_SUCCESS(cudaSetDevice(this->resource_->dev_id(i)));
@@ -2271,6 +2636,10 @@ void PSGPUWrapper::HbmToSparseTable() {
     size_t total_len = 0;
     // multi mf dim
     for (int j = 0; j < this->multi_mf_dim_; ++j) {
+      if (dump_dirty_rows) {
+        total_len += dump_dirty_rows_func(i, j, once_gpu_copy);
+        continue;
+      }
       auto& hbm_pool = this->hbm_pools_[i * this->multi_mf_dim_ + j];
       // ============ multi-thread process feasign============
       int mf_dim = this->index_dim_vec_[j];
@@ -2324,7 +2693,8 @@ void PSGPUWrapper::HbmToSparseTable() {
               ->device_dim_keys_[task.device_id][task.multi_mf_dim];
       uint64_t unuse_key = std::numeric_limits<uint64_t>::max();
       for (int i = task.start; i < task.end; ++i) {
-        if (device_keys[i + task.offset] == unuse_key) {
+        size_t row = task.rows ? task.rows[i] : i + task.offset;
+        if (device_keys[row] == unuse_key) {
           continue;
         }
 #ifdef PADDLE_WITH_PSLIB
@@ -140,6 +140,135 @@ void PSGPUWrapper::CopyKeys(const phi::Place& place,
   cudaStreamSynchronize(stream);
 }
 
+// the feature values are made of floats, the rows are copied word by word
+__global__ void ScatterRowsKernel(char* pool,
+                                  const char* values,
+                                  const uint32_t* rows,
+                                  size_t len,
+                                  size_t row_words) {
+  CUDA_KERNEL_LOOP_TYPE(i, len * row_words, size_t) {
+    size_t k = i / row_words;
+    size_t w = i - k * row_words;
+    reinterpret_cast<uint32_t*>(pool)[rows[k] * row_words + w] =
+        reinterpret_cast<const uint32_t*>(values)[i];
+  }
+}
+
+__global__ void GatherRowsKernel(const char* pool,
+                                 const uint32_t* rows,
+                                 size_t len,
+                                 size_t row_words,
+                                 char* values) {
+  CUDA_KERNEL_LOOP_TYPE(i, len * row_words, size_t) {
+    size_t k = i / row_words;
+    size_t w = i - k * row_words;
+    reinterpret_cast<uint32_t*>(values)[i] =
+        reinterpret_cast<const uint32_t*>(pool)[rows[k] * row_words + w];
+  }
+}
+
+__device__ __forceinline__ uint64_t RowSum(const uint32_t* row,
+                                           size_t row_words) {
+  // fnv-1a
+  uint64_t sum = 14695981039346656037ULL;
+  for (size_t w = 0; w < row_words; ++w) {
+    sum = (sum ^ row[w]) * 1099511628211ULL;
+  }
+  return sum;
+}
+
+__global__ void RowSumsKernel(const char* pool,
+                              size_t len,
+                              size_t row_words,
+                              uint64_t* sums) {
+  CUDA_KERNEL_LOOP_TYPE(i, len, size_t) {
+    sums[i] =
+        RowSum(reinterpret_cast<const uint32_t*>(pool) + i * row_words,
+               row_words);
+  }
+}
+
+__global__ void CollectDirtyRowsKernel(const char* pool,
+                                       size_t len,
+                                       size_t row_words,
+                                       uint64_t* sums,
+                                       uint32_t* dirty_rows,
+                                       uint32_t* dirty_num) {
+  CUDA_KERNEL_LOOP_TYPE(i, len, size_t) {
+    uint64_t sum =
+        RowSum(reinterpret_cast<const uint32_t*>(pool) + i * row_words,
+               row_words);
+    if (sum != sums[i]) {
+      sums[i] = sum;
+      dirty_rows[atomicAdd(dirty_num, 1U)] = static_cast<uint32_t>(i);
+    }
+  }
+}
+
+void PSGPUWrapper::ScatterHbmRows(char* pool,
+                                  const char* values,
+                                  const uint32_t* rows,
+                                  size_t len,
+                                  size_t row_size,
+                                  cudaStream_t stream) {
+  size_t total_len = len * (row_size / sizeof(uint32_t));
+  if (total_len == 0) {
+    return;
+  }
+  ScatterRowsKernel<<<CUDA_BLOCK(total_len), stream>>>(
+      pool, values, rows, len, row_size / sizeof(uint32_t));
+}
+
+void PSGPUWrapper::GatherHbmRows(const char* pool,
+                                 const uint32_t* rows,
+                                 size_t len,
+                                 size_t row_size,
+                                 char* values,
+                                 cudaStream_t stream) {
+  size_t total_len = len * (row_size / sizeof(uint32_t));
+  if (total_len == 0) {
+    return;
+  }
+  GatherRowsKernel<<<CUDA_BLOCK(total_len), stream>>>(
+      pool, rows, len, row_size / sizeof(uint32_t), values);
+}
+
+void PSGPUWrapper::HbmRowSums(const char* pool,
+                              size_t len,
+                              size_t row_size,
+                              uint64_t* sums,
+                              cudaStream_t stream) {
+  if (len == 0) {
+    return;
+  }
+  RowSumsKernel<<<CUDA_BLOCK(len), stream>>>(
+      pool, len, row_size / sizeof(uint32_t), sums);
+}
+
+size_t PSGPUWrapper::CollectDirtyHbmRows(const char* pool,
+                                         size_t len,
+                                         size_t row_size,
+                                         uint64_t* sums,
+                                         uint32_t* dirty_rows,
+                                         uint32_t* dirty_num,
+                                         cudaStream_t stream) {
+  if (len == 0) {
+    return 0;
+  }
+  uint32_t h_dirty_num = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMemsetAsync(dirty_num, 0, sizeof(uint32_t), stream));
+  CollectDirtyRowsKernel<<<CUDA_BLOCK(len), stream>>>(
+      pool, len, row_size / sizeof(uint32_t), sums, dirty_rows, dirty_num);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(&h_dirty_num,
+                                             dirty_num,
+                                             sizeof(uint32_t),
+                                             cudaMemcpyDeviceToHost,
+                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(stream));
+  return h_dirty_num;
+}
+
 void PSGPUWrapper::SetSparseSGD(float nonclk_coeff,
                                 float clk_coeff,
                                 float min_bound,
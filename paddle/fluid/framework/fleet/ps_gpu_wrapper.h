@@ -216,6 +216,8 @@ struct task_info {
   int multi_mf_dim;
   int start;
   int end;
+  // pool rows of the values when they are not contiguous from offset
+  const uint32_t* rows = nullptr;
 };
 
 class PSGPUWrapper {
@@ -330,6 +332,35 @@ class PSGPUWrapper {
   void build_pull_thread();
   void build_task();
   void DumpToMem();
+  void ReuseResidentKeys(std::shared_ptr<HeterContext> gpu_task);
+  void PromoteHotKeys(std::shared_ptr<HeterContext> gpu_task);
+  void ReleaseResidentTable();
+#ifdef PADDLE_WITH_CUDA
+  void ScatterHbmRows(char* pool,
+                      const char* values,
+                      const uint32_t* rows,
+                      size_t len,
+                      size_t row_size,
+                      cudaStream_t stream);
+  void GatherHbmRows(const char* pool,
+                     const uint32_t* rows,
+                     size_t len,
+                     size_t row_size,
+                     char* values,
+                     cudaStream_t stream);
+  void HbmRowSums(const char* pool,
+                  size_t len,
+                  size_t row_size,
+                  uint64_t* sums,
+                  cudaStream_t stream);
+  size_t CollectDirtyHbmRows(const char* pool,
+                             size_t len,
+                             size_t row_size,
+                             uint64_t* sums,
+                             uint32_t* dirty_rows,
+                             uint32_t* dirty_num,
+                             cudaStream_t stream);
+#endif
   void MergePull(std::shared_ptr<HeterContext> gpu_task);
   void MergeKeys(std::shared_ptr<HeterContext> gpu_task);
   void FilterPull(std::shared_ptr<HeterContext> gpu_task,
@@ -368,6 +399,9 @@ class PSGPUWrapper {
     for (size_t i = 0; i < hbm_pools_.size(); i++) {
       delete hbm_pools_[i];
     }
+    for (size_t i = 0; i < hbm_dim_arenas_.size(); i++) {
+      delete hbm_dim_arenas_[i];
+    }
     buildcpu_ready_channel_->Close();
     buildpull_ready_channel_->Close();
     running_ = false;
@@ -987,6 +1021,11 @@ class PSGPUWrapper {
     for (size_t i = 0; i < hbm_pools_.size(); i++) {
       hbm_pools_[i] = new HBMMemoryPoolFix();
     }
+    hbm_dim_arenas_.resize(resource_->total_device());
+    for (size_t i = 0; i < hbm_dim_arenas_.size(); i++) {
+      hbm_dim_arenas_[i] = new HBMMemoryPoolFix();
+    }
+    hbm_row_sums_.resize(hbm_pools_.size());
 
     mem_pools_.resize(resource_->total_device() * num_of_dim);
     max_mf_dim_ = index_dim_vec_.back();
@@ -1165,6 +1204,9 @@ class PSGPUWrapper {
   std::vector<MemoryPool*> mem_pools_;
   std::vector<HBMMemoryPoolFix*> hbm_pools_;  // in multi mfdim, one table need
                                               // hbm pools of total dims number
+  // per device, the memory the hbm_pools_ of all its dims are views into
+  // with gpups_share_dim_pools
+  std::vector<HBMMemoryPoolFix*> hbm_dim_arenas_;
 #endif
 
   std::shared_ptr<
@@ -1178,6 +1220,14 @@ class PSGPUWrapper {
   std::vector<std::shared_ptr<paddle::framework::ChannelObject<task_info>>>
       cpu_reday_channels_;
   std::shared_ptr<HeterContext> current_task_ = nullptr;
+  // the task whose rows stay in hbm_pools_ between passes with
+  // FLAGS_gpups_incremental_pass_build
+  std::shared_ptr<HeterContext> resident_task_ = nullptr;
+#ifdef PADDLE_WITH_CUDA
+  // checksums of the rows of hbm_pools_ when they were last in sync with the
+  // cpu table, the rows that differ at end_pass are dumped
+  std::vector<std::shared_ptr<memory::Allocation>> hbm_row_sums_;
+#endif
   std::thread buildpull_threads_;
   bool running_ = false;
   std::vector<std::shared_ptr<::ThreadPool>> pull_thread_pool_;
@@ -20,6 +20,9 @@ limitations under the License. */
 #include "paddle/phi/core/platform/cpu_helper.h"
 #include "paddle/phi/core/platform/device_context.h"
 
+COMMON_DECLARE_int32(heter_pipeline_balance_interval);
+COMMON_DECLARE_bool(heter_pipeline_adaptive_microbatch);
+
 namespace paddle::framework {
 
 void SetMicroId(paddle::framework::Scope* scope,
@@ -200,7 +203,10 @@ void HeterSectionWorker::MiniBatchBarrier() {
   VLOG(4) << "entering MiniBatchBarrier";
   VLOG(4) << "micro_ids_.size(): " << micro_ids_.size();
   while (micro_ids.size() < micro_ids_.size()) {
+    section_timer_.Start();
     auto task = (*thread_queue_).Pop();
+    section_timer_.Pause();
+    window_wait_time_ += section_timer_.ElapsedSec();
     VLOG(4) << "got one task from task que in cpu worker";
     auto message_name = task.first;
     auto micro_id = task.second;
@@ -216,7 +222,10 @@ void HeterSectionWorker::MiniBatchBarrier() {
     micro_ids.insert(micro_id);
     // backward data has been deserialized to micro scope
     // now run backward computation
+    section_timer_.Start();
     RunBackward(micro_id);
+    section_timer_.Pause();
+    window_compute_time_ += section_timer_.ElapsedSec();
     batch_num_++;
     BatchPostProcess();
     VLOG(0) << "one task in cpu worker overed!";
@@ -242,6 +251,7 @@ void HeterSectionWorker::RunForward(int micro_id) {
     epoch_finish_ = true;
     return;
   }
+  window_ins_num_ += cur_micro_batch;
   if (debug_) {
     timeline_.Pause();
     read_time_ += timeline_.ElapsedSec();
@@ -261,6 +271,7 @@ void HeterSectionWorker::RunForward(int micro_id) {
       epoch_finish_ = true;
       return;
     }
+    window_ins_num_ += cur_micro_batch;
     if (debug_) {
       timeline_.Pause();
       read_time_ += timeline_.ElapsedSec();
@@ -376,12 +387,16 @@ void HeterSectionWorker::Run() {
       op_time = 0.0;
     }
   }
+  if (active_microbatches_ <= 0 || active_microbatches_ > num_microbatches_) {
+    active_microbatches_ = num_microbatches_;
+  }
   bool is_first_stage = (pipeline_stage_ == 0);
   bool is_last_stage = (pipeline_stage_ + 1 == num_pipeline_stages_);
   if (is_first_stage) {  // for cpu trainer
     while (!epoch_finish_) {
       // forward
-      for (int i = 0; i < num_microbatches_; i++) {
+      section_timer_.Start();
+      for (int i = 0; i < active_microbatches_; i++) {
         VLOG(4) << "Run " << i << " microbatch";
         RunForward(i);
         if (epoch_finish_ == true) {
@@ -389,9 +404,12 @@ void HeterSectionWorker::Run() {
         }
         micro_ids_.push_back(i);
       }
+      section_timer_.Pause();
+      window_compute_time_ += section_timer_.ElapsedSec();
       // backward
       if (!micro_ids_.empty()) {
         MiniBatchBarrier();
+        BalanceSections();
       }
       VLOG(0) << "one batch run over! micro_ids_size: " << micro_ids_.size();
     }
@@ -404,7 +422,10 @@ void HeterSectionWorker::Run() {
         epoch_finish_ = true;
         break;
       }
+      section_timer_.Start();
       auto task = (*thread_queue_).Pop();
+      section_timer_.Pause();
+      window_wait_time_ += section_timer_.ElapsedSec();
       VLOG(4) << "got one task from task que in heter worker";
       auto message_name = task.first;
       auto micro_id = task.second;
@@ -413,25 +434,81 @@ void HeterSectionWorker::Run() {
                           1,
                           common::errors::InvalidArgument(
                               "last stage only receive forward data"));
+        section_timer_.Start();
         RunForward(micro_id);
         RunBackward(micro_id);
+        section_timer_.Pause();
+        window_compute_time_ += section_timer_.ElapsedSec();
         batch_num_++;
         BatchPostProcess();
+        BalanceSections();
         VLOG(0) << "one batch run over! micro_id: " << micro_id
                 << " batch_num: " << batch_num_;
       } else {
+        section_timer_.Start();
         if (message_name.find("forward") != std::string::npos) {
           RunForward(micro_id);
         } else if (message_name.find("backward") != std::string::npos) {
           RunBackward(micro_id);
           batch_num_++;
           BatchPostProcess();
+          BalanceSections();
         }
+        section_timer_.Pause();
+        window_compute_time_ += section_timer_.ElapsedSec();
       }
     }
   }
 }
 
+// Over each window of heter_pipeline_balance_interval batches, logs how long
+// this section computed and how long it waited for the other one. With
+// heter_pipeline_adaptive_microbatch the cpu section then moves the number of
+// micro-batches it keeps in flight one step at a time, keeping the direction
+// while the instances per second grow and turning back when they drop.
+void HeterSectionWorker::BalanceSections() {
+  if (FLAGS_heter_pipeline_balance_interval <= 0 ||
+      ++window_batches_ < FLAGS_heter_pipeline_balance_interval) {
+    return;
+  }
+  double window_time = window_compute_time_ + window_wait_time_;
+  if (window_time <= 0.0) {
+    window_time = DBL_EPSILON;
+  }
+  std::stringstream ss;
+  ss << "heter section balance, stage " << pipeline_stage_ << " thread "
+     << thread_id_ << ": " << window_batches_ / window_time
+     << " batches/s, computing " << window_compute_time_ / window_time * 100
+     << "%, waiting for the "
+     << (pipeline_stage_ == 0 ? "heter section " : "previous section ")
+     << window_wait_time_ / window_time * 100 << "%";
+  if (pipeline_stage_ == 0 && FLAGS_heter_pipeline_adaptive_microbatch &&
+      num_microbatches_ > 1) {
+    double throughput = window_ins_num_ / window_time;
+    int microbatches = active_microbatches_;
+    if (last_window_throughput_ <= 0.0 ||
+        throughput > last_window_throughput_ * 1.02) {
+      microbatches += microbatch_step_;
+    } else if (throughput < last_window_throughput_ * 0.98) {
+      microbatch_step_ = -microbatch_step_;
+      microbatches += microbatch_step_;
+    }
+    if (microbatches < 1 || microbatches > num_microbatches_) {
+      microbatch_step_ = -microbatch_step_;
+      microbatches = active_microbatches_;
+    }
+    ss << ", " << throughput << " ins/s, micro-batches in flight "
+       << active_microbatches_ << " -> " << microbatches;
+    active_microbatches_ = microbatches;
+    last_window_throughput_ = throughput;
+  }
+  VLOG(0) << ss.str();
+  window_compute_time_ = 0.0;
+  window_wait_time_ = 0.0;
+  window_ins_num_ = 0;
+  window_batches_ = 0;
+}
+
 void HeterSectionWorker::BatchPostProcess() {
   PrintFetchVars();
   // dump param & field
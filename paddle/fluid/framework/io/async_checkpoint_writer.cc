@@ -0,0 +1,154 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/fluid/framework/io/async_checkpoint_writer.h"
+
+#include <chrono>
+#include <map>
+
+#include "glog/logging.h"
+#include "paddle/fluid/framework/io/save_load_tensor.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/core/tensor_utils.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle::framework {
+
+AsyncCheckpointWriter::AsyncCheckpointWriter(int num_threads) {
+  PADDLE_ENFORCE_GT(num_threads,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of threads should be positive, "
+                        "but got %d.",
+                        num_threads));
+  pool_ = std::make_unique<phi::ThreadPool>(num_threads);
+}
+
+AsyncCheckpointWriter::~AsyncCheckpointWriter() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& future : futures_) {
+    auto ex = future.get();
+    if (ex) {
+      LOG(ERROR) << "Failed to write the checkpoint: " << ex->what();
+    }
+  }
+}
+
+void AsyncCheckpointWriter::Save(
+    const std::vector<std::string>& names,
+    const std::vector<const phi::DenseTensor*>& tensors,
+    const std::string& file_path) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    common::errors::InvalidArgument(
+                        "The number of names (%d) should be equal to the "
+                        "number of tensors (%d).",
+                        names.size(),
+                        tensors.size()));
+
+  auto snapshot = std::make_shared<std::vector<phi::DenseTensor>>();
+  snapshot->reserve(tensors.size());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::map<int, const phi::GPUContext*> gpu_ctxs;
+#endif
+  auto& pool = phi::DeviceContextPool::Instance();
+  for (const auto* tensor : tensors) {
+    phi::DenseTensor host;
+    const auto& place = tensor->place();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (phi::is_gpu_place(place)) {
+      auto* dev_ctx = static_cast<const phi::GPUContext*>(pool.Get(place));
+      phi::Copy(*dev_ctx, *tensor, phi::GPUPinnedPlace(), false, &host);
+      gpu_ctxs[place.GetDeviceId()] = dev_ctx;
+      snapshot->push_back(std::move(host));
+      continue;
+    }
+#endif
+    phi::Copy(*pool.Get(place), *tensor, phi::CPUPlace(), true, &host);
+    snapshot->push_back(std::move(host));
+  }
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the writer waits for the copies to the pinned memory, not the host
+  std::vector<std::shared_ptr<paddle::platform::CudaEventObject>> events;
+  for (const auto& [device_id, dev_ctx] : gpu_ctxs) {
+    auto event =
+        paddle::platform::CudaEventResourcePool::Instance().New(device_id);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event.get(), dev_ctx->stream()));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventRecord(event.get(), dev_ctx->stream()));
+#endif
+    events.push_back(event);
+  }
+#endif
+
+  VLOG(3) << "Snapshot " << tensors.size() << " tensors to write " << file_path;
+  auto future = pool_->RunAndGetException([=]() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    for (const auto& event : events) {
+#ifdef PADDLE_WITH_HIP
+      PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event.get()));
+#else
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event.get()));
+#endif
+    }
+#endif
+    std::vector<const phi::DenseTensor*> ptrs;
+    ptrs.reserve(snapshot->size());
+    for (const auto& tensor : *snapshot) {
+      ptrs.push_back(&tensor);
+    }
+    SaveTensors(names, ptrs, file_path);
+    VLOG(3) << "Finish writing " << file_path;
+  });
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  futures_.push_back(std::move(future));
+}
+
+void AsyncCheckpointWriter::Wait() {
+  std::vector<std::future<std::unique_ptr<common::enforce::EnforceNotMet>>>
+      futures;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    futures.swap(futures_);
+  }
+  std::unique_ptr<common::enforce::EnforceNotMet> first_ex;
+  for (auto& future : futures) {
+    auto ex = future.get();
+    if (ex && !first_ex) {
+      first_ex = std::move(ex);
+    }
+  }
+  if (first_ex) {
+    throw *first_ex;
+  }
+}
+
+size_t AsyncCheckpointWriter::Pending() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  size_t pending = 0;
+  for (auto& future : futures_) {
+    if (future.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      ++pending;
+    }
+  }
+  return pending;
+}
+
+}  // namespace paddle::framework
@@ -0,0 +1,58 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+    http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/threadpool.h"
+
+namespace paddle {
+namespace framework {
+
+// Writes the files of a checkpoint in background threads while the training
+// goes on. Save snapshots the tensors into host memory first: the device
+// tensors are copied into pinned memory on the stream of their device
+// context, so the kernels launched after Save can't change the snapshot and
+// the host doesn't wait for the copies. Each file is written by one thread
+// with SaveTensors, the files of a Save and of different Saves are written
+// in parallel.
+class AsyncCheckpointWriter {
+ public:
+  explicit AsyncCheckpointWriter(int num_threads);
+
+  // Waits for the files being written
+  ~AsyncCheckpointWriter();
+
+  void Save(const std::vector<std::string>& names,
+            const std::vector<const phi::DenseTensor*>& tensors,
+            const std::string& file_path);
+
+  // Waits for all the files, throws the error of the first one failed.
+  void Wait();
+
+  // The number of files not written yet
+  size_t Pending();
+
+ private:
+  std::unique_ptr<phi::ThreadPool> pool_;
+  std::mutex mutex_;
+  std::vector<std::future<std::unique_ptr<common::enforce::EnforceNotMet>>>
+      futures_;
+};
+
+}  // namespace framework
+}  // namespace paddle
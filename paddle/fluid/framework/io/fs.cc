@@ -16,11 +16,21 @@ limitations under the License. */
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <deque>
+#include <future>  // NOLINT
+#include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/common/macros.h"
 #include "paddle/fluid/platform/enforce.h"
 
+COMMON_DECLARE_int64(hdfs_native_read_chunk_size);
+COMMON_DECLARE_int32(hdfs_native_read_thread_num);
+
 namespace paddle::framework {
 
 static void fs_add_read_converter_internal(std::string& path,  // NOLINT
@@ -275,10 +285,209 @@ void set_download_command(const std::string& x) {
   customized_download_cmd_internal() = x;
 }
 
+static std::mutex& fs_backend_mutex_internal() {
+  static std::mutex x;
+  return x;
+}
+
+static std::map<std::string, std::shared_ptr<FsBackend>>&
+fs_backends_internal() {
+  static std::map<std::string, std::shared_ptr<FsBackend>> x;
+  return x;
+}
+
+void fs_register_backend(const std::string& prefix,
+                         std::shared_ptr<FsBackend> backend) {
+  std::lock_guard<std::mutex> lock(fs_backend_mutex_internal());
+  if (backend == nullptr) {
+    fs_backends_internal().erase(prefix);
+  } else {
+    fs_backends_internal()[prefix] = backend;
+  }
+}
+
+std::shared_ptr<FsBackend> fs_get_backend(const std::string& path) {
+  static std::once_flag native_once;
+  std::call_once(native_once, []() {
+    auto native = hdfs_native_backend();
+    if (native != nullptr) {
+      std::lock_guard<std::mutex> lock(fs_backend_mutex_internal());
+      fs_backends_internal().emplace("hdfs:", native);
+      fs_backends_internal().emplace("afs:", native);
+    }
+  });
+  std::lock_guard<std::mutex> lock(fs_backend_mutex_internal());
+  for (auto& it : fs_backends_internal()) {
+    if (fs_begin_with_internal(path, it.first)) {
+      return it.second;
+    }
+  }
+  return nullptr;
+}
+
+#if defined _WIN32 || defined __APPLE__
+std::shared_ptr<FILE> fs_open_random_reader(
+    std::shared_ptr<FsRandomReader> reader UNUSED,
+    size_t chunk_size UNUSED,
+    int thread_num UNUSED) {
+  return nullptr;
+}
+#else
+namespace {
+
+// keeps thread_num chunks in flight from the consumer's position, so a
+// single file is fetched with parallel range reads while it is parsed
+class ReadaheadStream {
+ public:
+  ReadaheadStream(std::shared_ptr<FsRandomReader> reader,
+                  size_t chunk_size,
+                  int thread_num)
+      : reader_(reader),
+        file_size_(reader->size()),
+        chunk_size_(chunk_size),
+        thread_num_(std::max(thread_num, 1)) {}
+
+  ssize_t read(char* buf, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+      if (pos_ == chunk_.size()) {
+        if (!next_chunk()) {
+          break;
+        }
+        continue;
+      }
+      size_t n = std::min(size - total, chunk_.size() - pos_);
+      memcpy(buf + total, chunk_.data() + pos_, n);
+      pos_ += n;
+      total += n;
+    }
+    if (total == 0 && error_) {
+      return -1;
+    }
+    return static_cast<ssize_t>(total);
+  }
+
+ private:
+  struct Chunk {
+    std::string data;
+    bool ok = true;
+  };
+
+  static Chunk fetch(std::shared_ptr<FsRandomReader> reader,
+                     int64_t offset,
+                     size_t size) {
+    const int max_retry = 3;
+    Chunk chunk;
+    chunk.data.resize(size);
+    size_t done = 0;
+    int retry = 0;
+    while (done < size) {
+      int64_t ret = reader->pread(offset + done, &chunk.data[done], size - done);
+      if (ret > 0) {
+        done += ret;
+      } else if (ret == 0) {
+        break;
+      } else if (++retry > max_retry) {
+        LOG(ERROR) << "range read failed at offset " << offset + done;
+        chunk.ok = false;
+        break;
+      }
+    }
+    chunk.data.resize(done);
+    return chunk;
+  }
+
+  void schedule() {
+    while (static_cast<int>(inflight_.size()) < thread_num_ &&
+           next_offset_ < file_size_) {
+      size_t size = static_cast<size_t>(
+          std::min<int64_t>(chunk_size_, file_size_ - next_offset_));
+      inflight_.push_back(
+          std::async(std::launch::async, fetch, reader_, next_offset_, size));
+      next_offset_ += size;
+    }
+  }
+
+  bool next_chunk() {
+    if (error_) {
+      return false;
+    }
+    schedule();
+    if (inflight_.empty()) {
+      return false;
+    }
+    Chunk chunk = inflight_.front().get();
+    inflight_.pop_front();
+    if (!chunk.ok || chunk.data.empty()) {
+      error_ = true;
+      return false;
+    }
+    chunk_.swap(chunk.data);
+    pos_ = 0;
+    schedule();
+    return true;
+  }
+
+  std::shared_ptr<FsRandomReader> reader_;
+  int64_t file_size_;
+  size_t chunk_size_;
+  int thread_num_;
+  int64_t next_offset_ = 0;
+  std::deque<std::future<Chunk>> inflight_;
+  std::string chunk_;
+  size_t pos_ = 0;
+  bool error_ = false;
+};
+
+}  // namespace
+
+std::shared_ptr<FILE> fs_open_random_reader(
+    std::shared_ptr<FsRandomReader> reader, size_t chunk_size, int thread_num) {
+  cookie_io_functions_t funcs;
+  funcs.read = [](void* cookie, char* buf, size_t size) -> ssize_t {
+    return static_cast<ReadaheadStream*>(cookie)->read(buf, size);
+  };
+  funcs.write = nullptr;
+  funcs.seek = nullptr;
+  funcs.close = [](void* cookie) -> int {
+    delete static_cast<ReadaheadStream*>(cookie);
+    return 0;
+  };
+  auto* stream = new ReadaheadStream(reader, chunk_size, thread_num);
+  FILE* fp = fopencookie(stream, "r", funcs);
+  if (fp == nullptr) {
+    delete stream;
+    return nullptr;
+  }
+  return {fp, [](FILE* fp) { fclose(fp); }};
+}
+#endif
+
 std::shared_ptr<FILE> hdfs_open_read(std::string path,
                                      int* err_no,
                                      const std::string& converter,
                                      bool read_data) {
+  // the native client reads the bytes in place of '-cat', files that need
+  // '-text', a download command or a converter still go through the shell
+  if (download_cmd().empty() && converter.empty() &&
+      !fs_end_with_internal(path, ".gz")) {
+    auto backend = fs_get_backend(path);
+    auto reader = backend ? backend->open_random_read(path) : nullptr;
+    auto fp = reader ? fs_open_random_reader(
+                           reader,
+                           FLAGS_hdfs_native_read_chunk_size,
+                           FLAGS_hdfs_native_read_thread_num)
+                     : nullptr;
+    if (fp != nullptr) {
+      if (err_no != nullptr) {
+        *err_no = 0;
+      }
+      return fp;
+    }
+    if (backend != nullptr) {
+      LOG(WARNING) << "native open " << path << " failed, use hdfs command";
+    }
+  }
   if (!download_cmd().empty()) {  // use customized download command
     path = string::format_string(
         "%s \"%s\"", download_cmd().c_str(), path.c_str());
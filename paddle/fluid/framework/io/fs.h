@@ -93,6 +93,42 @@ extern void hdfs_mkdir(const std::string& path);
 
 extern void hdfs_mv(const std::string& src, const std::string& dest);
 
+// native clients, used by hdfs_open_read instead of the hdfs command when one
+// is registered for the path prefix
+
+// random access reader of one file, pread must be safe to call from several
+// threads at once
+class FsRandomReader {
+ public:
+  virtual ~FsRandomReader() {}
+  virtual int64_t size() = 0;
+  // reads up to size bytes at offset, returns the bytes read or -1 on error
+  virtual int64_t pread(int64_t offset, char* data, size_t size) = 0;
+};
+
+class FsBackend {
+ public:
+  virtual ~FsBackend() {}
+  // nullptr when the file can not be opened
+  virtual std::shared_ptr<FsRandomReader> open_random_read(
+      const std::string& path) = 0;
+};
+
+// backend for paths beginning with prefix such as "afs:", nullptr removes it
+extern void fs_register_backend(const std::string& prefix,
+                                std::shared_ptr<FsBackend> backend);
+
+extern std::shared_ptr<FsBackend> fs_get_backend(const std::string& path);
+
+// sequential FILE over reader, thread_num range reads of chunk_size bytes
+// run ahead of the consumer
+extern std::shared_ptr<FILE> fs_open_random_reader(
+    std::shared_ptr<FsRandomReader> reader, size_t chunk_size, int thread_num);
+
+// libhdfs3 loaded from FLAGS_hdfs_native_lib, nullptr when it is not set or
+// can not be loaded
+extern std::shared_ptr<FsBackend> hdfs_native_backend();
+
 // aut-detect fs
 extern std::shared_ptr<FILE> fs_open_read(const std::string& path,
                                           int* err_no,
@@ -0,0 +1,216 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <ctime>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <type_traits>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/fluid/framework/io/fs.h"
+
+#if !defined(_WIN32)
+#include <dlfcn.h>
+#endif
+
+COMMON_DECLARE_string(hdfs_native_lib);
+COMMON_DECLARE_string(hdfs_native_user);
+
+namespace paddle::framework {
+
+#if defined(_WIN32)
+std::shared_ptr<FsBackend> hdfs_native_backend() { return nullptr; }
+#else
+namespace {
+
+// the subset of the libhdfs3 C api used here, resolved with dlsym so that
+// the library is only needed at runtime on clusters that provide it
+struct hdfsBuilder;
+typedef struct hdfs_internal* hdfsFS;
+typedef struct hdfsFile_internal* hdfsFile;
+typedef int32_t tSize;
+typedef int64_t tOffset;
+struct hdfsFileInfo {
+  int mKind;
+  char* mName;
+  time_t mLastMod;
+  tOffset mSize;
+  int16_t mReplication;
+  tOffset mBlockSize;
+  char* mOwner;
+  char* mGroup;
+  int16_t mPermissions;
+  time_t mLastAccess;
+};
+
+struct LibHdfs3 {
+  hdfsBuilder* (*hdfsNewBuilder)();
+  void (*hdfsBuilderSetNameNode)(hdfsBuilder*, const char*);
+  void (*hdfsBuilderSetUserName)(hdfsBuilder*, const char*);
+  hdfsFS (*hdfsBuilderConnect)(hdfsBuilder*);
+  hdfsFile (*hdfsOpenFile)(hdfsFS, const char*, int, int, int16_t, tOffset);
+  int (*hdfsCloseFile)(hdfsFS, hdfsFile);
+  tSize (*hdfsPread)(hdfsFS, hdfsFile, tOffset, void*, tSize);
+  hdfsFileInfo* (*hdfsGetPathInfo)(hdfsFS, const char*);
+  void (*hdfsFreeFileInfo)(hdfsFileInfo*, int);
+
+  bool load(const std::string& path) {
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr) {
+      LOG(WARNING) << "dlopen " << path << " failed: " << dlerror();
+      return false;
+    }
+    bool ok = true;
+    auto bind = [handle, &ok](auto* func, const char* name) {
+      *func = reinterpret_cast<std::remove_pointer_t<decltype(func)>>(
+          dlsym(handle, name));
+      if (*func == nullptr) {
+        LOG(WARNING) << "symbol " << name << " not found in libhdfs3";
+        ok = false;
+      }
+    };
+    bind(&hdfsNewBuilder, "hdfsNewBuilder");
+    bind(&hdfsBuilderSetNameNode, "hdfsBuilderSetNameNode");
+    bind(&hdfsBuilderSetUserName, "hdfsBuilderSetUserName");
+    bind(&hdfsBuilderConnect, "hdfsBuilderConnect");
+    bind(&hdfsOpenFile, "hdfsOpenFile");
+    bind(&hdfsCloseFile, "hdfsCloseFile");
+    bind(&hdfsPread, "hdfsPread");
+    bind(&hdfsGetPathInfo, "hdfsGetPathInfo");
+    bind(&hdfsFreeFileInfo, "hdfsFreeFileInfo");
+    return ok;
+  }
+};
+
+class HdfsNativeReader : public FsRandomReader {
+ public:
+  HdfsNativeReader(const LibHdfs3* lib, hdfsFS fs, hdfsFile file, int64_t size)
+      : lib_(lib), fs_(fs), file_(file), size_(size) {}
+  ~HdfsNativeReader() override { lib_->hdfsCloseFile(fs_, file_); }
+
+  int64_t size() override { return size_; }
+
+  int64_t pread(int64_t offset, char* data, size_t size) override {
+    size_t max_size = std::numeric_limits<tSize>::max();
+    tSize length = static_cast<tSize>(std::min(size, max_size));
+    return lib_->hdfsPread(fs_, file_, offset, data, length);
+  }
+
+ private:
+  const LibHdfs3* lib_;
+  hdfsFS fs_;
+  hdfsFile file_;
+  int64_t size_;
+};
+
+class HdfsNativeBackend : public FsBackend {
+ public:
+  bool initialize(const std::string& lib_path) { return lib_.load(lib_path); }
+
+  std::shared_ptr<FsRandomReader> open_random_read(
+      const std::string& path) override {
+    std::string name_node;
+    std::string file_path;
+    split_path(path, &name_node, &file_path);
+    hdfsFS fs = connect(name_node);
+    if (fs == nullptr) {
+      return nullptr;
+    }
+    hdfsFileInfo* info = lib_.hdfsGetPathInfo(fs, file_path.c_str());
+    if (info == nullptr) {
+      return nullptr;
+    }
+    int64_t size = info->mSize;
+    lib_.hdfsFreeFileInfo(info, 1);
+    hdfsFile file =
+        lib_.hdfsOpenFile(fs, file_path.c_str(), O_RDONLY, 0, 0, 0);
+    if (file == nullptr) {
+      return nullptr;
+    }
+    return std::make_shared<HdfsNativeReader>(&lib_, fs, file, size);
+  }
+
+ private:
+  // "afs://host:port/a/b" -> "afs://host:port", "/a/b"; without a host the
+  // default name node of the client config is used
+  static void split_path(const std::string& path,
+                         std::string* name_node,
+                         std::string* file_path) {
+    size_t scheme_end = path.find(':');
+    size_t begin = scheme_end + 1;
+    if (path.compare(begin, 2, "//") == 0) {
+      size_t host_end = path.find('/', begin + 2);
+      if (host_end == std::string::npos) {
+        host_end = path.size();
+      }
+      *name_node = path.substr(0, host_end);
+      *file_path = host_end < path.size() ? path.substr(host_end) : "/";
+    } else {
+      *name_node = "default";
+      *file_path = path.substr(begin);
+    }
+  }
+
+  // connections are shared by all files of a name node and never closed
+  hdfsFS connect(const std::string& name_node) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = connections_.find(name_node);
+    if (it != connections_.end()) {
+      return it->second;
+    }
+    hdfsBuilder* builder = lib_.hdfsNewBuilder();
+    lib_.hdfsBuilderSetNameNode(builder, name_node.c_str());
+    if (!FLAGS_hdfs_native_user.empty()) {
+      lib_.hdfsBuilderSetUserName(builder, FLAGS_hdfs_native_user.c_str());
+    }
+    hdfsFS fs = lib_.hdfsBuilderConnect(builder);
+    if (fs == nullptr) {
+      LOG(WARNING) << "native connect to " << name_node << " failed";
+      return nullptr;
+    }
+    connections_[name_node] = fs;
+    return fs;
+  }
+
+  LibHdfs3 lib_;
+  std::mutex mutex_;
+  std::map<std::string, hdfsFS> connections_;
+};
+
+}  // namespace
+
+std::shared_ptr<FsBackend> hdfs_native_backend() {
+  static std::shared_ptr<FsBackend> backend = []() {
+    if (FLAGS_hdfs_native_lib.empty()) {
+      return std::shared_ptr<FsBackend>();
+    }
+    auto native = std::make_shared<HdfsNativeBackend>();
+    if (!native->initialize(FLAGS_hdfs_native_lib)) {
+      return std::shared_ptr<FsBackend>();
+    }
+    VLOG(0) << "hdfs files are read by " << FLAGS_hdfs_native_lib;
+    return std::static_pointer_cast<FsBackend>(native);
+  }();
+  return backend;
+}
+#endif
+
+}  // namespace paddle::framework
@@ -12,6 +12,8 @@ limitations under the License. */
 #include "paddle/fluid/framework/io/save_load_tensor.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <numeric>
 
@@ -21,6 +23,13 @@ limitations under the License. */
 
 namespace paddle::framework {
 
+// The header of the files of SaveTensors: the magic, the uint32_t version and
+// the uint64_t number of tensors, then each tensor as its uint64_t name size,
+// the name and the serialized DenseTensor.
+static constexpr char kTensorsFileMagic[8] = {
+    'P', 'D', 'T', 'E', 'N', 'S', 'O', 'R'};
+static constexpr uint32_t kTensorsFileVersion = 0;
+
 void SaveTensor(const phi::DenseTensor& x,
                 const std::string& file_path,
                 bool overwrite) {
@@ -53,4 +62,98 @@ void LoadTensor(const std::string& file_path, phi::DenseTensor* out) {
 
   phi::DeserializeFromStream(fin, out);
 }
+
+void SaveTensors(const std::vector<std::string>& names,
+                 const std::vector<const phi::DenseTensor*>& tensors,
+                 const std::string& file_path) {
+  PADDLE_ENFORCE_EQ(names.size(),
+                    tensors.size(),
+                    common::errors::InvalidArgument(
+                        "The number of names (%d) should be equal to the "
+                        "number of tensors (%d).",
+                        names.size(),
+                        tensors.size()));
+  VLOG(6) << tensors.size() << " tensors will be saved to " << file_path;
+  MkDirRecursively(DirName(file_path).c_str());
+
+  const std::string tmp_path = file_path + ".tmp";
+  {
+    std::ofstream fout(tmp_path, std::ios::binary);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                      true,
+                      common::errors::Unavailable(
+                          "Cannot open %s to save variables.", tmp_path));
+    fout.write(kTensorsFileMagic, sizeof(kTensorsFileMagic));
+    fout.write(reinterpret_cast<const char*>(&kTensorsFileVersion),
+               sizeof(kTensorsFileVersion));
+    const uint64_t num = tensors.size();
+    fout.write(reinterpret_cast<const char*>(&num), sizeof(num));
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const uint64_t name_size = names[i].size();
+      fout.write(reinterpret_cast<const char*>(&name_size), sizeof(name_size));
+      fout.write(names[i].data(), static_cast<std::streamsize>(name_size));
+      phi::SerializeToStream(fout, *tensors[i]);
+    }
+    fout.close();
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(fout),
+        true,
+        common::errors::Unavailable("Failed to write variables to %s.",
+                                    tmp_path));
+  }
+  PADDLE_ENFORCE_EQ(
+      std::rename(tmp_path.c_str(), file_path.c_str()),
+      0,
+      common::errors::Unavailable(
+          "Cannot rename %s to %s.", tmp_path, file_path));
+}
+
+void LoadTensors(const std::string& file_path,
+                 std::vector<std::string>* names,
+                 std::vector<phi::DenseTensor>* tensors) {
+  PADDLE_ENFORCE_EQ(
+      IsTensorsFile(file_path),
+      true,
+      common::errors::InvalidArgument(
+          "%s is not a file of tensors, please check whether the model file "
+          "is complete or damaged.",
+          file_path));
+  std::ifstream fin(file_path, std::ios::binary);
+  fin.seekg(sizeof(kTensorsFileMagic));
+  uint32_t version = 0;
+  fin.read(reinterpret_cast<char*>(&version), sizeof(version));
+  PADDLE_ENFORCE_EQ(version,
+                    kTensorsFileVersion,
+                    common::errors::InvalidArgument(
+                        "Only version %d of the file of tensors is supported, "
+                        "but %s is of version %d.",
+                        kTensorsFileVersion,
+                        file_path,
+                        version));
+  uint64_t num = 0;
+  fin.read(reinterpret_cast<char*>(&num), sizeof(num));
+  names->resize(num);
+  tensors->resize(num);
+  for (uint64_t i = 0; i < num; ++i) {
+    uint64_t name_size = 0;
+    fin.read(reinterpret_cast<char*>(&name_size), sizeof(name_size));
+    (*names)[i].resize(name_size);
+    fin.read(&(*names)[i][0], static_cast<std::streamsize>(name_size));
+    phi::DeserializeFromStream(fin, &(*tensors)[i]);
+  }
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+                    true,
+                    common::errors::Unavailable(
+                        "Failed to read variables from %s, please check "
+                        "whether the model file is complete or damaged.",
+                        file_path));
+}
+
+bool IsTensorsFile(const std::string& file_path) {
+  std::ifstream fin(file_path, std::ios::binary);
+  char magic[sizeof(kTensorsFileMagic)];
+  fin.read(magic, sizeof(magic));
+  return static_cast<bool>(fin) &&
+         std::memcmp(magic, kTensorsFileMagic, sizeof(magic)) == 0;
+}
 }  // namespace paddle::framework
@@ -12,6 +12,7 @@ limitations under the License. */
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "paddle/phi/core/dense_tensor.h"
 
@@ -23,5 +24,18 @@ void SaveTensor(const phi::DenseTensor& x,
 
 void LoadTensor(const std::string& file_path, phi::DenseTensor* out);
 
+// Saves the tensors with their names into one file, the file is written to
+// `file_path`.tmp first and renamed once complete.
+void SaveTensors(const std::vector<std::string>& names,
+                 const std::vector<const phi::DenseTensor*>& tensors,
+                 const std::string& file_path);
+
+void LoadTensors(const std::string& file_path,
+                 std::vector<std::string>* names,
+                 std::vector<phi::DenseTensor>* tensors);
+
+// Whether the file was written by SaveTensors
+bool IsTensorsFile(const std::string& file_path);
+
 }  // namespace framework
 }  // namespace paddle
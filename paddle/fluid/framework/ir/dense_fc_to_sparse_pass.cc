@@ -47,6 +47,52 @@ PDNode *patterns::DenseFC::operator()() {
 }  // namespace paddle::framework::ir::patterns
 namespace paddle::framework::ir {
 
+namespace {
+
+// Whether the [k, n] weight of fc has at most 2 nonzeros in every 4
+// consecutive elements along k, the sparsity the sparse tensor cores run.
+template <typename T>
+bool IsSparse24(const phi::DenseTensor &weight) {
+  const int64_t k = weight.dims()[0];
+  const int64_t n = weight.dims()[1];
+  const T *data = weight.data<T>();
+  for (int64_t col = 0; col < n; ++col) {
+    for (int64_t row = 0; row < k; row += 4) {
+      int nonzeros = 0;
+      for (int64_t i = row; i < row + 4; ++i) {
+        nonzeros += static_cast<float>(data[i * n + col]) != 0.0f;
+      }
+      if (nonzeros > 2) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool IsSparse24Weight(const Scope *scope, const std::string &name) {
+  auto *var = scope->FindVar(name);
+  if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+    return false;
+  }
+  const auto &weight = var->Get<phi::DenseTensor>();
+  if (!weight.initialized() || weight.dims().size() != 2 ||
+      weight.dims()[0] % 4 != 0 || weight.numel() == 0 ||
+      weight.place().GetType() != phi::AllocationType::CPU) {
+    return false;
+  }
+  switch (weight.dtype()) {
+    case phi::DataType::FLOAT32:
+      return IsSparse24<float>(weight);
+    case phi::DataType::FLOAT16:
+      return IsSparse24<phi::dtype::float16>(weight);
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 DenseFCToSparsePass::DenseFCToSparsePass() {
   AddOpCompat(OpCompat("fc"))
       .AddInput("Input")
@@ -75,6 +121,9 @@ void DenseFCToSparsePass::ApplyImpl(Graph *graph) const {
                                      "dense_fc_replace_pass");
   dense_fc_pattern();
   int found_dense_fc_count = 0;
+  Scope *scope = graph->Has(kParamScopeAttr)
+                     ? &graph->Get<Scope>(kParamScopeAttr)
+                     : nullptr;
   auto handler = [&](const GraphPatternDetector::subgraph_t &subgraph,
                      Graph *g) {
     VLOG(4) << "Replace dense fc with sparse_fc.";
@@ -92,8 +141,11 @@ void DenseFCToSparsePass::ApplyImpl(Graph *graph) const {
 
     auto *fc_op = fc->Op();
     auto w_name = fc_op->Input("W")[0];
-    // recognize sparse op by name
-    if (w_name.find("sparse_2_4") != w_name.npos) {
+    // recognize sparse op by name, or by the values of a model pruned to 2:4
+    // without renaming its weights
+    bool is_sparse = w_name.find("sparse_2_4") != w_name.npos ||
+                     (scope != nullptr && IsSparse24Weight(scope, w_name));
+    if (is_sparse) {
       // fake op
       OpDesc desc(fc_op->Block());
       desc.SetType("sparse_fc");
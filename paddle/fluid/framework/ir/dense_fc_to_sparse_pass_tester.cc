@@ -103,6 +103,72 @@ TEST(FCFusePass, basic) {
                         num_sparse_fc_nodes_after));
 }
 
+TEST(DenseFCToSparsePass, sparse_values) {
+  // inputs                     operator            output
+  // --------------------------------------------------------
+  // (a, weights_0)             mul              -> mul_out_0
+  // (mul_out_0, bias_0)        elementwise_add  -> add_out_0
+  // add_out_0                  relu             -> relu_out_0
+  // (relu_out_0, weights_1)    mul              -> mul_out_1
+  // (mul_out_1, bias_1)        elementwise_add  -> add_out_1
+  //
+  // weights_0 is pruned to 2:4 without the sparse_2_4 marker in its name.
+  Layers layers;
+  auto* a = layers.data("a", {2, 8});
+  auto* weights_0 = layers.data("weights_0", {8, 4}, true);
+  auto* mul_out_0 = layers.mul(a, weights_0);
+  auto* bias_0 = layers.data("bias_0", {4}, true);
+  auto* add_out_0 = layers.elementwise_add(mul_out_0, bias_0, nullptr, 1);
+  auto* relu_out_0 = layers.relu(add_out_0);
+  auto* weights_1 = layers.data("weights_1", {4, 8}, true);
+  auto* mul_out_1 = layers.mul(relu_out_0, weights_1);
+  auto* bias_1 = layers.data("bias_1", {8}, true);
+  auto* add_out_1 = layers.elementwise_add(mul_out_1, bias_1, nullptr, 1);
+  VLOG(4) << add_out_1;
+
+  auto* param_scope = new Scope();
+  auto* sparse_weights =
+      param_scope->Var("weights_0")->GetMutable<phi::DenseTensor>();
+  sparse_weights->Resize({8, 4});
+  float* sparse_data = sparse_weights->mutable_data<float>(phi::CPUPlace());
+  for (int i = 0; i < 8 * 4; ++i) {
+    // rows 0 and 1 of every 4 rows are nonzero
+    sparse_data[i] = (i / 4) % 4 < 2 ? 1.0f : 0.0f;
+  }
+  auto* dense_weights =
+      param_scope->Var("weights_1")->GetMutable<phi::DenseTensor>();
+  dense_weights->Resize({4, 8});
+  float* dense_data = dense_weights->mutable_data<float>(phi::CPUPlace());
+  for (int i = 0; i < 4 * 8; ++i) {
+    dense_data[i] = 1.0f;
+  }
+  AddVarToScope(param_scope, "bias_0", {4});
+  AddVarToScope(param_scope, "bias_1", {8});
+
+  std::unique_ptr<ir::Graph> graph(new ir::Graph(layers.main_program()));
+  auto fuse_pass = PassRegistry::Instance().Get("fc_fuse_pass");
+  auto sparse_pass = PassRegistry::Instance().Get("dense_fc_to_sparse_pass");
+  fuse_pass->Set("use_gpu", new bool(true));
+  sparse_pass->Set("use_gpu", new bool(true));
+  graph->Set("__param_scope__", param_scope);
+
+  graph.reset(fuse_pass->Apply(graph.release()));
+  graph.reset(sparse_pass->Apply(graph.release()));
+  int num_fc_nodes_after = GetNumOpNodes(graph, "fc");
+  int num_sparse_fc_nodes_after = GetNumOpNodes(graph, "sparse_fc");
+  VLOG(3) << DebugString(graph);
+
+  PADDLE_ENFORCE_EQ(num_fc_nodes_after,
+                    1,
+                    common::errors::InvalidArgument("num_fc_nodes_after=%d.",
+                                                    num_fc_nodes_after));
+  PADDLE_ENFORCE_EQ(
+      num_sparse_fc_nodes_after,
+      1,
+      common::errors::InvalidArgument("num_sparse_fc_nodes_after=%d.",
+                                      num_sparse_fc_nodes_after));
+}
+
 }  // namespace paddle::framework::ir
 
 USE_PASS(fc_fuse_pass);
@@ -226,6 +226,18 @@ int PrelnResidualBiasFusePass::ApplyPattern(ir::Graph *graph,
       LOG(WARNING) << "preln_residual_bias pass in op compat failed.";
       return;
     }
+    // the fused op normalizes the last dimension of the added inputs of the
+    // same shape
+    auto x_shape = subgraph.at(x)->Var()->GetShape();
+    auto y_shape = subgraph.at(y)->Var()->GetShape();
+    int begin_norm_axis =
+        PADDLE_GET_CONST(int, layer_norm->Op()->GetAttr("begin_norm_axis"));
+    if (x_shape != y_shape ||
+        begin_norm_axis != static_cast<int>(x_shape.size()) - 1) {
+      VLOG(3) << "preln_residual_bias pass only fuses the layer_norm of the "
+                 "last dimension of inputs of the same shape.";
+      return;
+    }
 
     std::unordered_set<const Node *> del_node_set;
     // Create an PrelnResidualBias op node
@@ -0,0 +1,358 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/platform/enforce.h"
+
+namespace paddle {
+namespace framework {
+
+// A 32 bit counter threads can sleep on until it changes, a futex on Linux.
+class WaitWord {
+ public:
+  uint32_t Load() const { return value_.load(std::memory_order_acquire); }
+
+  // Sleeps while the counter still equals expected, at most timeout_ms if it
+  // is not negative. May return spuriously.
+  void Wait(uint32_t expected, int64_t timeout_ms = -1) {
+#if defined(__linux__)
+    struct timespec timeout;
+    struct timespec* timeout_ptr = nullptr;
+    if (timeout_ms >= 0) {
+      timeout.tv_sec = timeout_ms / 1000;
+      timeout.tv_nsec = (timeout_ms % 1000) * 1000000;
+      timeout_ptr = &timeout;
+    }
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&value_),
+            FUTEX_WAIT_PRIVATE,
+            expected,
+            timeout_ptr,
+            nullptr,
+            0);
+#else
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto changed = [&] { return Load() != expected; };
+    if (timeout_ms < 0) {
+      cond_.wait(lock, changed);
+    } else {
+      cond_.wait_for(lock, std::chrono::milliseconds(timeout_ms), changed);
+    }
+#endif
+  }
+
+  // Changes the counter and wakes one or all of the sleeping threads.
+  void Notify(bool notify_all) {
+#if defined(__linux__)
+    value_.fetch_add(1, std::memory_order_release);
+    syscall(SYS_futex,
+            reinterpret_cast<uint32_t*>(&value_),
+            FUTEX_WAKE_PRIVATE,
+            notify_all ? INT_MAX : 1,
+            nullptr,
+            nullptr,
+            0);
+#else
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      value_.fetch_add(1, std::memory_order_release);
+    }
+    if (notify_all) {
+      cond_.notify_all();
+    } else {
+      cond_.notify_one();
+    }
+#endif
+  }
+
+ private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+                "WaitWord needs a lock free 32 bit atomic.");
+  std::atomic<uint32_t> value_{0};
+#if !defined(__linux__)
+  std::mutex mutex_;
+  std::condition_variable cond_;
+#endif
+};
+
+// Bounded multi-producer multi-consumer ring. Every slot carries a sequence
+// number telling whether it waits for the producer or for the consumer of a
+// position, so threads only contend on claiming positions with a CAS and
+// never take a lock. Push and Pop sleep on a WaitWord only while the ring is
+// full or empty, and producers and consumers skip the wake-up syscall when
+// nobody sleeps.
+template <typename T>
+class MPMCRing {
+ public:
+  explicit MPMCRing(size_t capacity) : capacity_(capacity) {
+    PADDLE_ENFORCE_GT(capacity_,
+                      0,
+                      common::errors::InvalidArgument(
+                          "The capacity of MPMCRing must be greater than 0."));
+    slots_.reset(new Slot[capacity_]);
+    for (size_t i = 0; i < capacity_; ++i) {
+      slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~MPMCRing() {
+    T val;
+    while (TryPop(&val)) {
+    }
+  }
+
+  DISABLE_COPY_AND_ASSIGN(MPMCRing);
+
+  size_t Capacity() const { return capacity_; }
+
+  // Approximate while other threads push or pop.
+  size_t Size() const {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t head = head_.load(std::memory_order_acquire);
+    return head > tail ? head - tail : 0;
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  // Pushes and pops fail once closed, pops only after the ring drained.
+  void Close() {
+    closed_.store(true, std::memory_order_seq_cst);
+    not_empty_.Notify(true);
+    not_full_.Notify(true);
+  }
+
+  void Open() { closed_.store(false, std::memory_order_seq_cst); }
+
+  bool Closed() const { return closed_.load(std::memory_order_acquire); }
+
+  // Times a push slept because the ring was full.
+  size_t FullWaits() const {
+    return full_waits_.load(std::memory_order_relaxed);
+  }
+
+  template <typename U>
+  bool TryPush(U&& val) {
+    if (!TryPushNoNotify(std::forward<U>(val))) {
+      return false;
+    }
+    NotifyNotEmpty(false);
+    return true;
+  }
+
+  bool TryPop(T* val) {
+    if (!TryPopNoNotify(val)) {
+      return false;
+    }
+    NotifyNotFull(false);
+    return true;
+  }
+
+  // Blocks while the ring is full, returns false if it is closed.
+  template <typename U>
+  bool Push(U&& val) {
+    while (!Closed()) {
+      if (TryPush(std::forward<U>(val))) {
+        return true;
+      }
+      uint32_t word = not_full_.Load();
+      full_sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (Size() >= capacity_ && !Closed()) {
+        full_waits_.fetch_add(1, std::memory_order_relaxed);
+        not_full_.Wait(word);
+      }
+      full_sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return false;
+  }
+
+  // Blocks while the ring is empty, returns false if it is closed and empty.
+  bool Pop(T* val) { return PopFor(val, -1); }
+
+  // Pop waiting at most timeout_ms, forever if it is negative.
+  bool PopFor(T* val, int64_t timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::max<int64_t>(timeout_ms, 0));
+    while (true) {
+      if (TryPop(val)) {
+        return true;
+      }
+      if (Closed()) {
+        // pushes that won the race with Close are still delivered
+        return TryPop(val);
+      }
+      int64_t wait_ms = -1;
+      if (timeout_ms >= 0) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now())
+                        .count();
+        if (left <= 0) {
+          return false;
+        }
+        wait_ms = left;
+      }
+      uint32_t word = not_empty_.Load();
+      empty_sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (Size() == 0 && !Closed()) {
+        not_empty_.Wait(word, wait_ms);
+      }
+      empty_sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  // Moves vals[0, n) in, blocking while the ring is full, and wakes the
+  // consumers once. Returns less than n if the ring is closed meanwhile.
+  size_t PushBatch(T* vals, size_t n) {
+    size_t pushed = 0;
+    while (pushed < n && !Closed()) {
+      size_t m = pushed;
+      while (m < n && TryPushNoNotify(std::move(vals[m]))) {
+        ++m;
+      }
+      if (m > pushed) {
+        NotifyNotEmpty(m - pushed > 1);
+        pushed = m;
+        continue;
+      }
+      if (!Push(std::move(vals[pushed]))) {
+        break;
+      }
+      ++pushed;
+    }
+    return pushed;
+  }
+
+  // Pops up to n values, blocking only until the first one arrives, and
+  // wakes the producers once. Returns 0 if the ring is closed and empty.
+  size_t PopBatch(T* vals, size_t n) {
+    if (n == 0 || !Pop(vals)) {
+      return 0;
+    }
+    size_t popped = 1;
+    while (popped < n && TryPopNoNotify(vals + popped)) {
+      ++popped;
+    }
+    if (popped > 1) {
+      NotifyNotFull(true);
+    }
+    return popped;
+  }
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<size_t> seq;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T* value() { return reinterpret_cast<T*>(&storage); }
+  };
+
+  template <typename U>
+  bool TryPushNoNotify(U&& val) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos % capacity_];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(seq) -
+                  static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          new (slot.value()) T(std::forward<U>(val));
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // the consumer of the previous round has not taken it yet
+        return false;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool TryPopNoNotify(T* val) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      Slot& slot = slots_[pos % capacity_];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(seq) -
+                  static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(
+                pos, pos + 1, std::memory_order_relaxed)) {
+          *val = std::move(*slot.value());
+          slot.value()->~T();
+          slot.seq.store(pos + capacity_, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // the producer of this position has not filled it yet
+        return false;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Pairs with the fence between announcing a sleeper and checking the ring
+  // again, so either the sleeper sees the change or we see the sleeper.
+  void NotifyNotEmpty(bool notify_all) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (empty_sleepers_.load(std::memory_order_relaxed) != 0) {
+      not_empty_.Notify(notify_all);
+    }
+  }
+
+  void NotifyNotFull(bool notify_all) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (full_sleepers_.load(std::memory_order_relaxed) != 0) {
+      not_full_.Notify(notify_all);
+    }
+  }
+
+  const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<bool> closed_{false};
+  std::atomic<int> empty_sleepers_{0};
+  std::atomic<int> full_sleepers_{0};
+  std::atomic<size_t> full_waits_{0};
+  WaitWord not_empty_;
+  WaitWord not_full_;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -14,7 +14,9 @@
 
 #include "paddle/fluid/framework/naive_executor.h"
 
+#include <algorithm>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -22,6 +24,7 @@
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/framework/variable_helper.h"
+#include "paddle/phi/core/platform/cpu_helper.h"
 #include "paddle/phi/core/platform/denormal.h"
 #ifdef PADDLE_WITH_DNNL
 #include "paddle/fluid/platform/onednn_helper.h"
@@ -98,62 +101,223 @@ void NaiveExecutor::Run() {
 #ifdef PADDLE_WITH_NVTX
   platform::CudaNvtxRangePush("model", platform::NvtxRangeColor::Yellow);
 #endif
-  for (auto &op : ops_) {
-    VLOG(4) << std::this_thread::get_id() << " run "
-            << op->DebugStringEx(scope_) << " on scope " << scope_;
-    op->SetIsCalledByExecutor(false);
-
-    for (auto &func : input_hookfuncs_) {
-      func(op.get(), scope_);
+  if (op_queue_ != nullptr && input_hookfuncs_.empty() &&
+      output_hookfuncs_.empty() && reuse_cache_.empty()) {
+    RunParallel();
+  } else {
+    for (auto &op : ops_) {
+      RunOp(op.get());
     }
+  }
+#ifdef PADDLE_WITH_NVTX
+  platform::CudaNvtxRangePop();
+#endif
+}
 
-    if (op->Type() == "while" || op->Type() == "conditional_block") {
-      op->SetOutputHooks(output_hookfuncs_);
-      op->SetInputHooks(input_hookfuncs_);
-    }
+void NaiveExecutor::RunOp(OperatorBase *op) {
+  VLOG(4) << std::this_thread::get_id() << " run " << op->DebugStringEx(scope_)
+          << " on scope " << scope_;
+  op->SetIsCalledByExecutor(false);
+
+  for (auto &func : input_hookfuncs_) {
+    func(op, scope_);
+  }
+
+  if (op->Type() == "while" || op->Type() == "conditional_block") {
+    op->SetOutputHooks(output_hookfuncs_);
+    op->SetInputHooks(input_hookfuncs_);
+  }
 
 #ifdef PADDLE_WITH_NVTX
-    platform::CudaNvtxRangePush(op->Type() + "|" + op->OutputVars(true).front(),
-                                platform::NvtxRangeColor::Green);
+  platform::CudaNvtxRangePush(op->Type() + "|" + op->OutputVars(true).front(),
+                              platform::NvtxRangeColor::Green);
 #endif
-    op->Run(*scope_, place_);
+  op->Run(*scope_, place_);
 #ifdef PADDLE_WITH_NVTX
-    platform::CudaNvtxRangePop();
+  platform::CudaNvtxRangePop();
 #endif
 
-    // Update the shared_holder so that only records the max one.
-    if (reuse_cache_.count(op.get())) {
-      for (auto &it : reuse_cache_[op.get()]) {
-        if (it.first->memory_size() >
-            cluster_buffer_[it.second]->memory_size()) {
-          cluster_buffer_[it.second] = it.first;
-          int updated_cluster_id = it.second;
-
-          // cluster_buffer_[it.second] has been updated to be a new
-          // phi::DenseTensor*, we need change all phi::DenseTensor's
-          // shared_holder in this cluster. The following two loops code looks
-          // ugly, it does work. The following two loops seem time-consuming,
-          // but once the memory reaches its peak, the cluster will not update,
-          // so it's ok.
-          for (auto &op_map : reuse_cache_) {
-            // op_map.second is std::unordered_map<phi::DenseTensor*, int>.
-            for (auto &it2 : op_map.second) {
-              if (it2.second == updated_cluster_id) {
-                it2.first->ShareBufferWith(*cluster_buffer_[it2.second], true);
-              }
+  // Update the shared_holder so that only records the max one.
+  if (reuse_cache_.count(op)) {
+    for (auto &it : reuse_cache_[op]) {
+      if (it.first->memory_size() >
+          cluster_buffer_[it.second]->memory_size()) {
+        cluster_buffer_[it.second] = it.first;
+        int updated_cluster_id = it.second;
+
+        // cluster_buffer_[it.second] has been updated to be a new
+        // phi::DenseTensor*, we need change all phi::DenseTensor's
+        // shared_holder in this cluster. The following two loops code looks
+        // ugly, it does work. The following two loops seem time-consuming,
+        // but once the memory reaches its peak, the cluster will not update,
+        // so it's ok.
+        for (auto &op_map : reuse_cache_) {
+          // op_map.second is std::unordered_map<phi::DenseTensor*, int>.
+          for (auto &it2 : op_map.second) {
+            if (it2.second == updated_cluster_id) {
+              it2.first->ShareBufferWith(*cluster_buffer_[it2.second], true);
             }
           }
         }
       }
     }
+  }
+
+  for (auto &func : output_hookfuncs_) {
+    func(op, scope_);
+  }
+}
+
+void NaiveExecutor::EnableInterOpParallel(int num_threads, int total_threads) {
+  PADDLE_ENFORCE_GT(
+      num_threads,
+      0,
+      common::errors::InvalidArgument(
+          "The inter op threads of NaiveExecutor must be greater than 0, but "
+          "received %d.",
+          num_threads));
+  PADDLE_ENFORCE_EQ(phi::is_cpu_place(place_),
+                    true,
+                    common::errors::Unimplemented(
+                        "NaiveExecutor only runs ops in parallel on CPU."));
+  if (num_threads == 1) {
+    op_queue_.reset();
+    return;
+  }
+  intra_op_threads_ = std::max(total_threads / num_threads, 1);
+  BuildOpDependency();
+  WorkQueueOptions options("NaiveExecutorInterOp",
+                           num_threads,
+                           /*allow_spinning=*/true,
+                           /*track_task=*/false);
+  op_queue_ = CreateMultiThreadedWorkQueue(options);
+  VLOG(3) << "NaiveExecutor runs " << ops_.size() << " ops on " << num_threads
+          << " threads with " << intra_op_threads_ << " intra op threads, "
+          << root_ops_.size() << " of them ready at start";
+}
 
-    for (auto &func : output_hookfuncs_) {
-      func(op.get(), scope_);
+void NaiveExecutor::BuildOpDependency() {
+  size_t num_ops = ops_.size();
+  std::vector<std::set<size_t>> upstreams(num_ops);
+  std::unordered_map<std::string, size_t> last_writer;
+  std::unordered_map<std::string, std::vector<size_t>> readers;
+  // ops with sub blocks may touch variables they do not list, they wait for
+  // all the ops before them and all the ops after them wait for them
+  size_t last_barrier = num_ops;
+  std::vector<size_t> since_barrier;
+  for (size_t i = 0; i < num_ops; ++i) {
+    auto *op = ops_[i].get();
+    if (op->HasAttr("sub_block") || op->HasAttr("sub_blocks")) {
+      upstreams[i].insert(since_barrier.begin(), since_barrier.end());
+      if (last_barrier != num_ops) {
+        upstreams[i].insert(last_barrier);
+      }
+      last_barrier = i;
+      since_barrier.clear();
+      last_writer.clear();
+      readers.clear();
+      continue;
     }
+    if (last_barrier != num_ops) {
+      upstreams[i].insert(last_barrier);
+    }
+    since_barrier.push_back(i);
+    for (auto &input : op->Inputs()) {
+      for (auto &name : input.second) {
+        auto it = last_writer.find(name);
+        if (it != last_writer.end()) {
+          upstreams[i].insert(it->second);
+        }
+        readers[name].push_back(i);
+      }
+    }
+    for (auto &output : op->Outputs()) {
+      for (auto &name : output.second) {
+        if (name == kEmptyVarName) {
+          continue;
+        }
+        auto it = last_writer.find(name);
+        if (it != last_writer.end()) {
+          upstreams[i].insert(it->second);
+        }
+        for (size_t reader : readers[name]) {
+          upstreams[i].insert(reader);
+        }
+        readers[name].clear();
+        last_writer[name] = i;
+      }
+    }
+    upstreams[i].erase(i);
+  }
+
+  op_downstreams_.assign(num_ops, {});
+  op_deps_.assign(num_ops, 0);
+  root_ops_.clear();
+  for (size_t i = 0; i < num_ops; ++i) {
+    op_deps_[i] = upstreams[i].size();
+    for (size_t upstream : upstreams[i]) {
+      op_downstreams_[upstream].push_back(i);
+    }
+    if (op_deps_[i] == 0) {
+      root_ops_.push_back(i);
+    }
+  }
+  op_deps_left_ = std::make_unique<std::atomic<size_t>[]>(num_ops);
+}
+
+void NaiveExecutor::RunParallel() {
+  if (ops_.empty()) {
+    return;
+  }
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    op_deps_left_[i].store(op_deps_[i], std::memory_order_relaxed);
+  }
+  exception_holder_.Clear();
+  tasks_left_.store(root_ops_.size());
+  for (size_t op_idx : root_ops_) {
+    op_queue_->AddTask([this, op_idx]() { RunOpAsync(op_idx); });
+  }
+  {
+    std::unique_lock<std::mutex> lock(tasks_mutex_);
+    tasks_done_.wait(lock, [this]() { return tasks_left_.load() == 0; });
+  }
+  if (exception_holder_.IsCaught()) {
+    exception_holder_.ReThrow();
+  }
+}
+
+void NaiveExecutor::RunOpAsync(size_t op_idx) {
+  // the predictor sets the whole budget before Run, narrow it on this thread
+  platform::SetNumThreads(intra_op_threads_);
+  constexpr size_t kNone = static_cast<size_t>(-1);
+  size_t next = op_idx;
+  while (next != kNone && !exception_holder_.IsCaught()) {
+    try {
+      RunOp(ops_[next].get());
+    } catch (...) {
+      exception_holder_.Catch(std::current_exception());
+      break;
+    }
+    size_t following = kNone;
+    for (size_t downstream : op_downstreams_[next]) {
+      if (op_deps_left_[downstream].fetch_sub(
+              1, std::memory_order_acq_rel) != 1) {
+        continue;
+      }
+      if (following == kNone) {
+        following = downstream;
+      } else {
+        // count the new task before this one finishes
+        tasks_left_.fetch_add(1);
+        op_queue_->AddTask([this, downstream]() { RunOpAsync(downstream); });
+      }
+    }
+    next = following;
+  }
+  if (tasks_left_.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> guard(tasks_mutex_);
+    tasks_done_.notify_all();
   }
-#ifdef PADDLE_WITH_NVTX
-  platform::CudaNvtxRangePop();
-#endif
 }
 
 void NaiveExecutor::CreateVariables(const ProgramDesc &desc,
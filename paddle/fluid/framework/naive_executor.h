@@ -14,12 +14,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "paddle/fluid/framework/details/exception_holder.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/program_desc.h"
 #include "paddle/fluid/framework/scope.h"
@@ -28,6 +32,7 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
+#include "paddle/fluid/framework/new_executor/workqueue/workqueue.h"
 
 #include "paddle/pir/include/core/program.h"
 
@@ -35,8 +40,8 @@ namespace paddle {
 namespace framework {
 
 /*
- * Simple, intuitive and effective. Only single thread is supported, and
- * currently designed for inference.
+ * Simple, intuitive and effective, currently designed for inference. Ops run
+ * in order on the calling thread, unless EnableInterOpParallel is called.
  */
 class ProgramDesc;
 class Scope;
@@ -78,6 +83,12 @@ class NaiveExecutor {
                        bool persistable,
                        Scope* scope);
 
+  // Run independent operators of the prepared block on num_threads threads,
+  // following the variables they read and write. Each thread runs its ops
+  // with total_threads / num_threads cpu math library threads. Runs with
+  // hooks or a reuse plan still run in order.
+  void EnableInterOpParallel(int num_threads, int total_threads);
+
   // Run all the operators.
   void Run();
 
@@ -103,6 +114,16 @@ class NaiveExecutor {
  private:
   void CreateOps(const ProgramDesc& desc, int block_id);
 
+  void RunOp(OperatorBase* op);
+
+  void BuildOpDependency();
+
+  void RunParallel();
+
+  // Runs op_idx, then the downstream ops it makes ready, keeping one of them
+  // on this thread and handing the others to op_queue_.
+  void RunOpAsync(size_t op_idx);
+
  private:
   const phi::Place place_;
   // Catch the required resource to avoid recreate.
@@ -121,6 +142,19 @@ class NaiveExecutor {
   std::vector<phi::DenseTensor*> cluster_buffer_;
 
   std::unique_ptr<framework::InterpreterCore> interpreter_core_;
+
+  // For EnableInterOpParallel.
+  int intra_op_threads_{1};
+  std::unique_ptr<WorkQueue> op_queue_;
+  std::vector<std::vector<size_t>> op_downstreams_;
+  std::vector<size_t> op_deps_;
+  std::vector<size_t> root_ops_;
+  std::unique_ptr<std::atomic<size_t>[]> op_deps_left_;
+  // tasks scheduled to op_queue_ and not finished yet
+  std::atomic<size_t> tasks_left_{0};
+  std::mutex tasks_mutex_;
+  std::condition_variable tasks_done_;
+  details::ExceptionHolder exception_holder_;
 };
 
 }  // namespace framework
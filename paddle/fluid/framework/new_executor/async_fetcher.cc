@@ -0,0 +1,131 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/async_fetcher.h"
+
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/platform/device_context.h"
+#include "paddle/phi/core/platform/profiler/event_tracing.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/platform/device/gpu/gpu_info.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+bool FetchHandle::IsReady() const {
+  if (ready_) {
+    return true;
+  }
+#if defined(PADDLE_WITH_CUDA)
+  gpuError_t err = cudaEventQuery(event_.get());
+  if (err == cudaErrorNotReady) {
+    return false;
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(err);
+#elif defined(PADDLE_WITH_HIP)
+  gpuError_t err = hipEventQuery(event_.get());
+  if (err == hipErrorNotReady) {
+    return false;
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(err);
+#endif
+  return true;
+}
+
+const FetchList& FetchHandle::Wait() {
+  if (!ready_) {
+    phi::RecordEvent record_event(
+        "FetchHandle::Wait", phi::TracerEventType::UserDefined, 1);
+#if defined(PADDLE_WITH_CUDA)
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventSynchronize(event_.get()));
+#elif defined(PADDLE_WITH_HIP)
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventSynchronize(event_.get()));
+#endif
+    ready_ = true;
+  }
+  return results_;
+}
+
+AsyncFetcher::AsyncFetcher(const phi::Place& place) : place_(place) {}
+
+std::shared_ptr<FetchHandle> AsyncFetcher::Fetch(
+    const std::vector<phi::DenseTensor>& tensors) {
+  phi::RecordEvent record_event(
+      "AsyncFetcher::Fetch", phi::TracerEventType::UserDefined, 1);
+  auto handle = std::make_shared<FetchHandle>();
+  handle->results_.resize(tensors.size());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place_)) {
+    platform::SetDeviceId(place_.device);
+    // NOTE: the copies are issued on the compute stream rather than a side
+    // stream, so they are ordered after the kernels producing the tensors and
+    // before the kernels of the next step that may write the same buffers,
+    // without any cross stream synchronization.
+    gpuStream_t stream = static_cast<phi::GPUContext*>(
+                             phi::DeviceContextPool::Instance().Get(place_))
+                             ->stream();
+    phi::GPUPinnedPlace pinned_place;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      const auto& src = tensors[i];
+      auto& dst = PADDLE_GET(phi::DenseTensor, handle->results_[i]);
+      if (!src.initialized()) {
+        continue;
+      }
+      if (!phi::is_gpu_place(src.place())) {
+        TensorCopySync(src, phi::CPUPlace(), &dst);
+        continue;
+      }
+      PADDLE_ENFORCE_EQ(
+          src.meta().is_contiguous(),
+          true,
+          common::errors::InvalidArgument(
+              "AsyncFetcher only supports contiguous tensors, but the %d-th "
+              "fetched tensor is not contiguous.",
+              i));
+      size_t size = src.numel() * phi::SizeOf(src.dtype());
+      auto holder = memory::AllocShared(pinned_place, size);
+      phi::memory_utils::Copy(
+          pinned_place, holder->ptr(), src.place(), src.data(), size, stream);
+      dst = phi::DenseTensor(
+          holder, phi::DenseTensorMeta(src.dtype(), src.dims(), src.layout()));
+      dst.set_lod(src.lod());
+    }
+    handle->event_ =
+        platform::CudaEventResourcePool::Instance().New(place_.device);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(handle->event_.get(), stream));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(handle->event_.get(), stream));
+#endif
+    return handle;
+  }
+#endif
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    if (tensors[i].initialized()) {
+      TensorCopySync(tensors[i],
+                     phi::CPUPlace(),
+                     &PADDLE_GET(phi::DenseTensor, handle->results_[i]));
+    }
+  }
+  handle->ready_ = true;
+  return handle;
+}
+
+}  // namespace framework
+}  // namespace paddle
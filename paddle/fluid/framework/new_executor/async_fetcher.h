@@ -0,0 +1,70 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/framework/feed_fetch_type.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/core/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+// FetchHandle holds the host copies of the tensors of an asynchronous fetch,
+// the copies are only readable after Wait returns.
+class FetchHandle {
+ public:
+  // Returns whether the copies have completed, never blocks.
+  bool IsReady() const;
+
+  // Blocks until the copies have completed.
+  const FetchList& Wait();
+
+ private:
+  friend class AsyncFetcher;
+
+  FetchList results_;
+  bool ready_{false};
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::shared_ptr<platform::CudaEventObject> event_;
+#endif
+};
+
+// AsyncFetcher copies device tensors, e.g. the loss and the metrics of a
+// training step, to pinned host memory without synchronizing the device. The
+// copies are queued behind the kernels that produce the tensors, and the
+// returned handle is resolved later, so fetching every step does not
+// serialize the host and the device.
+class AsyncFetcher {
+ public:
+  explicit AsyncFetcher(const phi::Place& place);
+
+  std::shared_ptr<FetchHandle> Fetch(
+      const std::vector<phi::DenseTensor>& tensors);
+
+  const phi::Place& GetPlace() const { return place_; }
+
+ private:
+  phi::Place place_;
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
 
+#include <atomic>
 #include <fstream>
 #include <functional>
 #include <map>
@@ -37,6 +38,11 @@ PHI_DEFINE_EXPORTED_string(static_executor_perfstat_filepath,
 
 namespace paddle::framework {
 
+namespace {
+std::atomic<uint64_t> g_workqueue_local_tasks{0};
+std::atomic<uint64_t> g_workqueue_stolen_tasks{0};
+}  // namespace
+
 class StatisticsEngine {
  public:
   StatisticsEngine() : executor_type_(ExecutorType::EXECUTOR) {}
@@ -554,6 +560,18 @@ void StatisticsEngine::Log(const std::string& filepath) {
                                    evt_stat.count,
                                    evt_stat.normalization_time);
   }
+  const std::pair<const char*, uint64_t> task_counters[] = {
+      {"ThreadpoolLocalTask", g_workqueue_local_tasks.exchange(0)},
+      {"ThreadpoolStolenTask", g_workqueue_stolen_tasks.exchange(0)}};
+  for (const auto& counter : task_counters) {
+    ofs << platform::string_format(std::string(R"JSON(
+  {
+    "statistical item" : "%s",
+    "total number of times" : %llu
+  },)JSON"),
+                                   counter.first,
+                                   counter.second);
+  }
   ofs.seekp(-1, std::ios_base::end);
   ofs << "]";
   if (ofs) {
@@ -562,6 +580,15 @@ void StatisticsEngine::Log(const std::string& filepath) {
   ofs.close();
 }
 
+void RecordWorkQueueTaskStatistics(uint64_t local_tasks,
+                                   uint64_t stolen_tasks) {
+  if (FLAGS_static_executor_perfstat_filepath.empty()) {
+    return;
+  }
+  g_workqueue_local_tasks.fetch_add(local_tasks, std::memory_order_relaxed);
+  g_workqueue_stolen_tasks.fetch_add(stolen_tasks, std::memory_order_relaxed);
+}
+
 void StaticGraphExecutorPerfStatistics(
     std::shared_ptr<const platform::NodeTrees> profiling_data) {
   if (FLAGS_static_executor_perfstat_filepath.empty()) {
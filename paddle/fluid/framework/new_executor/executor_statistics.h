@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "paddle/fluid/platform/profiler/event_node.h"
@@ -24,5 +25,11 @@ namespace framework {
 void StaticGraphExecutorPerfStatistics(
     std::shared_ptr<const platform::NodeTrees> profiling_data);
 
+// Accumulates the number of instructions run by the worker that scheduled
+// them and the number stolen by another worker during one executor run.
+// The totals are logged (and then cleared) by
+// StaticGraphExecutorPerfStatistics.
+void RecordWorkQueueTaskStatistics(uint64_t local_tasks, uint64_t stolen_tasks);
+
 }  // namespace framework
 }  // namespace paddle
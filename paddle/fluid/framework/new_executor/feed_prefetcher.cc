@@ -0,0 +1,172 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/feed_prefetcher.h"
+
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/platform/device_context.h"
+#include "paddle/phi/core/platform/profiler/event_tracing.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/platform/device/gpu/gpu_info.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+FeedPrefetcher::FeedPrefetcher(const phi::Place& place, size_t capacity)
+    : place_(place), capacity_(capacity), thread_pool_(1) {
+  PADDLE_ENFORCE_GT(
+      capacity,
+      0UL,
+      common::errors::InvalidArgument(
+          "The capacity of FeedPrefetcher should be greater than 0."));
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place_)) {
+    compute_stream_ = static_cast<phi::GPUContext*>(
+                          phi::DeviceContextPool::Instance().Get(place_))
+                          ->stream();
+    copy_stream_ =
+        platform::CudaStreamResourcePool::Instance().New(place_.device);
+  }
+#endif
+}
+
+FeedPrefetcher::~FeedPrefetcher() {
+  while (!pending_.empty()) {
+    auto& front = pending_.front();
+    if (front.valid()) {
+      front.wait();
+    }
+    pending_.pop();
+  }
+}
+
+void FeedPrefetcher::Push(const std::vector<std::string>& names,
+                          const std::vector<phi::DenseTensor>& tensors) {
+  PADDLE_ENFORCE_EQ(
+      names.size(),
+      tensors.size(),
+      common::errors::InvalidArgument(
+          "The number of feed names (%d) and feed tensors (%d) of "
+          "FeedPrefetcher are not matched.",
+          names.size(),
+          tensors.size()));
+  PADDLE_ENFORCE_LT(
+      pending_.size(),
+      capacity_,
+      common::errors::ResourceExhausted(
+          "FeedPrefetcher already holds %d pending batches, pop a batch "
+          "before pushing a new one.",
+          capacity_));
+  // The host tensors are captured by value, so the caller may release its
+  // own references right after pushing.
+  pending_.emplace(thread_pool_.enqueue(
+      [this, names, tensors] { return Stage(names, tensors); }));
+}
+
+FeedPrefetcher::FeedBatch FeedPrefetcher::Pop() {
+  PADDLE_ENFORCE_EQ(
+      pending_.empty(),
+      false,
+      common::errors::PreconditionNotMet(
+          "FeedPrefetcher has no pending batch, push a batch first."));
+  auto future = std::move(pending_.front());
+  pending_.pop();
+  FeedBatch batch = future.get();
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (copy_stream_) {
+    // The buffers are allocated on the copy stream, record the compute stream
+    // so that they are not reused before the step that consumes them ends.
+    for (auto& [name, tensor] : batch) {
+      if (tensor.Holder()) {
+        memory::RecordStream(tensor.Holder(), compute_stream_);
+      }
+    }
+  }
+#endif
+  return batch;
+}
+
+FeedPrefetcher::FeedBatch FeedPrefetcher::Stage(
+    const std::vector<std::string>& names,
+    const std::vector<phi::DenseTensor>& tensors) {
+  phi::RecordEvent record_event(
+      "FeedPrefetcher::Stage", phi::TracerEventType::UserDefined, 1);
+  FeedBatch batch;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (copy_stream_) {
+    // NOTE: set the device before calling any CUDA API in this thread,
+    // otherwise the context of device 0 is created.
+    platform::SetDeviceId(place_.device);
+    gpuStream_t stream = copy_stream_.get();
+    phi::Stream alloc_stream(reinterpret_cast<phi::StreamId>(stream));
+    phi::GPUPinnedPlace pinned_place;
+    // The pinned staging buffers must outlive the async copies.
+    std::vector<std::shared_ptr<phi::Allocation>> staging;
+    for (size_t i = 0; i < names.size(); ++i) {
+      const auto& src = tensors[i];
+      auto& dst = batch[names[i]];
+      if (!src.initialized() || src.place() == place_) {
+        dst = src;
+        continue;
+      }
+      PADDLE_ENFORCE_EQ(
+          src.meta().is_contiguous(),
+          true,
+          common::errors::InvalidArgument(
+              "FeedPrefetcher only supports contiguous feed tensors, but "
+              "feed %s is not contiguous.",
+              names[i]));
+      size_t size = src.numel() * phi::SizeOf(src.dtype());
+      auto holder = memory::AllocShared(place_, size, alloc_stream);
+      const void* src_ptr = src.data();
+      phi::Place src_place = src.place();
+      if (src_place.GetType() == phi::AllocationType::CPU) {
+        staging.emplace_back(memory::AllocShared(pinned_place, size));
+        phi::memory_utils::Copy(
+            pinned_place, staging.back()->ptr(), src_place, src_ptr, size);
+        src_ptr = staging.back()->ptr();
+        src_place = pinned_place;
+      }
+      phi::memory_utils::Copy(
+          place_, holder->ptr(), src_place, src_ptr, size, stream);
+      dst = phi::DenseTensor(
+          holder, phi::DenseTensorMeta(src.dtype(), src.dims(), src.layout()));
+      dst.set_lod(src.lod());
+    }
+    // Synchronizing here only blocks the prefetching thread, the batch is
+    // complete on the device once it is popped.
+    phi::backends::gpu::GpuStreamSync(stream);
+    return batch;
+  }
+#endif
+  for (size_t i = 0; i < names.size(); ++i) {
+    const auto& src = tensors[i];
+    auto& dst = batch[names[i]];
+    if (!src.initialized() || src.place() == place_) {
+      dst = src;
+      continue;
+    }
+    TensorCopySync(src, place_, &dst);
+  }
+  return batch;
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -0,0 +1,84 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <future>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ThreadPool.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/core/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+// FeedPrefetcher stages the host feed batches of the following steps to the
+// device while the current step is running. The host to device copies of a
+// batch are issued on a dedicated copy stream by a background thread, the
+// device buffers are allocated on the copy stream so that staging never waits
+// for the kernels queued on the compute stream. Popping a batch returns device
+// tensors that can be fed to the executor directly, so the feed of a step only
+// swaps buffers instead of copying.
+//
+// Usage:
+//   FeedPrefetcher prefetcher(place, 2);
+//   prefetcher.Push(names, batch_0);
+//   prefetcher.Push(names, batch_1);
+//   feed = prefetcher.Pop();  // run step 0 with feed, then push batch_2
+class FeedPrefetcher {
+ public:
+  using FeedBatch = std::unordered_map<std::string, phi::DenseTensor>;
+
+  FeedPrefetcher(const phi::Place& place, size_t capacity);
+
+  ~FeedPrefetcher();
+
+  // Starts staging a batch, at most `capacity` batches can be pending.
+  void Push(const std::vector<std::string>& names,
+            const std::vector<phi::DenseTensor>& tensors);
+
+  // Returns the earliest pushed batch, waits until its copies are issued.
+  FeedBatch Pop();
+
+  size_t Size() const { return pending_.size(); }
+
+  size_t Capacity() const { return capacity_; }
+
+  const phi::Place& GetPlace() const { return place_; }
+
+ private:
+  FeedBatch Stage(const std::vector<std::string>& names,
+                  const std::vector<phi::DenseTensor>& tensors);
+
+  phi::Place place_;
+  size_t capacity_;
+  ::ThreadPool thread_pool_;
+  std::queue<std::future<FeedBatch>> pending_;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::shared_ptr<platform::CudaStreamObject> copy_stream_;
+  gpuStream_t compute_stream_{nullptr};
+#endif
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -53,6 +53,12 @@ InterpreterCoreEventGarbageCollector::InterpreterCoreEventGarbageCollector(
 
 InterpreterCoreEventGarbageCollector::
     ~InterpreterCoreEventGarbageCollector() {  // NOLINT
+  {
+    std::lock_guard<memory::SpinLock> guard(spinlock_);
+    if (!garbages_->empty()) {
+      FreeGarbages();
+    }
+  }
   queue_.reset(nullptr);
 }
 
@@ -151,16 +157,19 @@ void InterpreterCoreEventGarbageCollector::Add(Garbage garbage,
     return;
   }
 
-  if (max_memory_size_ <= 1) {
+  if (max_memory_size_ <= 1 && max_garbage_num_ <= 1) {
     Free(garbage, event, ctx);
   } else {
     {  // lock guard
       std::lock_guard<memory::SpinLock> guard(spinlock_);
       cur_memory_size_ += static_cast<int64_t>(garbage->size());
       garbages_->push_back(std::move(garbage));
+      // One event per stream is recorded for the whole batch, the latest
+      // instruction on a stream covers all the earlier ones.
       events_[ctx] = event;
 
-      if (cur_memory_size_ >= max_memory_size_) {
+      if (cur_memory_size_ >= max_memory_size_ &&
+          garbages_->size() >= max_garbage_num_) {
         FreeGarbages();
       }
     }
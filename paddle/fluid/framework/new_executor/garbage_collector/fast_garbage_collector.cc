@@ -83,14 +83,18 @@ void InterpreterCoreFastGarbageCollector::Add(Garbage garbage) {
     return;
   }
 
-  if (max_memory_size_ > 1) {
+  if (max_memory_size_ > 1 || max_garbage_num_ > 1) {
+    // The stream safe allocator orders the frees after the kernels on the
+    // streams recorded for each allocation, so a batch is released at once
+    // without waiting for the device.
     std::unique_ptr<GarbageQueue> pending_delete_garbages;
     {  // lock guard
       std::lock_guard<memory::SpinLock> guard(spinlock_);
       cur_memory_size_ += static_cast<int64_t>(garbage->size());
       garbages_->push_back(std::move(garbage));
 
-      if (cur_memory_size_ >= max_memory_size_) {
+      if (cur_memory_size_ >= max_memory_size_ &&
+          garbages_->size() >= max_garbage_num_) {
         cur_memory_size_ = 0;
         pending_delete_garbages = std::move(garbages_);
         garbages_ = std::make_unique<GarbageQueue>();
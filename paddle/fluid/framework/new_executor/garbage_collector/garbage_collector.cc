@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "paddle/fluid/framework/new_executor/garbage_collector/garbage_collector.h"
+
+#include <algorithm>
+
 #include "paddle/fluid/framework/garbage_collector.h"
 #include "paddle/fluid/framework/new_executor/garbage_collector/event_garbage_collector.h"
 #include "paddle/fluid/framework/new_executor/garbage_collector/fast_garbage_collector.h"
@@ -24,6 +27,8 @@ InterpreterCoreGarbageCollector::InterpreterCoreGarbageCollector()
     : garbages_(std::make_unique<GarbageQueue>()) {
   max_memory_size_ = static_cast<int64_t>(GetEagerDeletionThreshold());
   cur_memory_size_ = 0;
+  max_garbage_num_ = static_cast<size_t>(
+      std::max<int32_t>(FLAGS_new_executor_gc_batch_size, 1));
 }
 
 std::unique_ptr<InterpreterCoreGarbageCollector>
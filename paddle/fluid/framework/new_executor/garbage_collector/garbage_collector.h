@@ -24,6 +24,7 @@
 
 COMMON_DECLARE_bool(fast_eager_deletion_mode);
 COMMON_DECLARE_bool(new_executor_use_cuda_graph);
+COMMON_DECLARE_int32(new_executor_gc_batch_size);
 
 namespace paddle {
 namespace framework {
@@ -46,6 +47,9 @@ class InterpreterCoreGarbageCollector {
   std::unique_ptr<GarbageQueue> garbages_;
   int64_t max_memory_size_;
   int64_t cur_memory_size_;
+  // Garbage is released once both max_memory_size_ and max_garbage_num_
+  // are reached, see FLAGS_new_executor_gc_batch_size.
+  size_t max_garbage_num_;
   memory::SpinLock spinlock_;
 };
 
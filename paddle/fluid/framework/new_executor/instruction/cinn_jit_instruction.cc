@@ -43,14 +43,32 @@ class CinnJitInstruction::FnPtrImpl {
   explicit FnPtrImpl(const CINNKernelInfo& cinn_kernel_info)
       : cinn_kernel_info_(cinn_kernel_info) {}
 
-  void InitFuncArgs(const std::vector<phi::DenseTensor*>& kernel_tensor_args) {
-    // 1. Create placeholders for tensor args
-    for (size_t i = 0; i < kernel_tensor_args.size(); ++i) {
+  ~FnPtrImpl() { FreeFuncArgs(); }
+
+  // Builds the argument list once, the buffers of the tensor args followed by
+  // the symbol args. Run only patches the data pointers and symbol values.
+  void InitFuncArgs(size_t num_tensor_args) {
+    for (size_t i = 0; i < num_tensor_args; ++i) {
       auto* buffer = new cinn_buffer_t();
       func_args_.emplace_back(buffer);
     }
+    num_tensor_args_ = num_tensor_args;
+    for (size_t i = 0; i < cinn_kernel_info_.symbol_args_map.size(); ++i) {
+      func_args_.emplace_back(static_cast<int64_t>(0));
+    }
+
+    if (VLOG_IS_ON(4)) {
+      VLOG(4) << "Run func_args_ size: " << func_args_.size();
+      for (const auto& args : func_args_) {
+        VLOG(4) << " args type_code: " << args.type_code();
+      }
+    }
+  }
 
-    // 2. Convert symbol args about dynamic shape to cinn_pod_value_t
+  // Convert symbol args about dynamic shape to cinn_pod_value_t, before
+  // InferShape since it reads them too.
+  void UpdateSymbolArgs(
+      const std::vector<phi::DenseTensor*>& kernel_tensor_args) {
     const auto& GetSymbolArg = common::Overloaded{
         [&](const CINNKernelInfo::ArgDimIdx& binding_info) -> int64_t {
           return static_cast<int64_t>(
@@ -84,15 +102,10 @@ class CinnJitInstruction::FnPtrImpl {
                                       "for dynamic shape arg now"));
         }};
 
+    size_t idx = num_tensor_args_;
     for (const auto& [_, binding_info] : cinn_kernel_info_.symbol_args_map) {
-      func_args_.emplace_back(std::visit(GetSymbolArg, binding_info));
-    }
-
-    if (VLOG_IS_ON(4)) {
-      VLOG(4) << "Run func_args_ size: " << func_args_.size();
-      for (const auto& args : func_args_) {
-        VLOG(4) << " args type_code: " << args.type_code();
-      }
+      func_args_[idx++] =
+          cinn_pod_value_t(std::visit(GetSymbolArg, binding_info));
     }
   }
 
@@ -163,26 +176,29 @@ class CinnJitInstruction::FnPtrImpl {
                   int32_t input_tensor_size,
                   int32_t output_tensor_size) {
     VLOG(6) << "Start InferShape: " << cinn_kernel_info_.fn_name;
-    // Define an array of Pointers to hold the output tensor shape
-    std::vector<int64_t*> output_tensor_shapes(output_tensor_size);
-    for (int i = 0; i < output_tensor_size; ++i) {
-      output_tensor_shapes[i] = reinterpret_cast<int64_t*>(
-          malloc(kernel_tensor_args[input_tensor_size + i]->dims().size() *
-                 sizeof(int64_t*)));
+    // Define an array of Pointers to hold the output tensor shape, the
+    // buffers are kept across runs since the ranks never change
+    if (output_shape_buffers_.empty()) {
+      output_shape_buffers_.resize(output_tensor_size);
+      output_tensor_shapes_.resize(output_tensor_size);
+      for (int i = 0; i < output_tensor_size; ++i) {
+        output_shape_buffers_[i].resize(
+            kernel_tensor_args[input_tensor_size + i]->dims().size());
+        output_tensor_shapes_[i] = output_shape_buffers_[i].data();
+      }
     }
 
     // Launch infer_shape_fn_ptr to infer shape of output tensor
     ((infer_shape_func_ptr_g)cinn_kernel_info_.infer_shape_fn_ptr)(
         static_cast<void*>(func_args_.data()),
         func_args_.size(),
-        output_tensor_shapes.data());
+        output_tensor_shapes_.data());
 
     // Resize shape of output tensor
     for (int i = 0; i < output_tensor_size; ++i) {
-      DDim dim(output_tensor_shapes[i],
+      DDim dim(output_tensor_shapes_[i],
                kernel_tensor_args[input_tensor_size + i]->dims().size());
       kernel_tensor_args[input_tensor_size + i]->Resize(dim);
-      free(output_tensor_shapes[i]);
     }
     VLOG(6) << "End InferShape: " << cinn_kernel_info_.fn_name;
   }
@@ -200,6 +216,10 @@ class CinnJitInstruction::FnPtrImpl {
   CINNKernelInfo cinn_kernel_info_;
 
   std::vector<cinn_pod_value_t> func_args_;
+  size_t num_tensor_args_{0};
+
+  std::vector<std::vector<int64_t>> output_shape_buffers_;
+  std::vector<int64_t*> output_tensor_shapes_;
 };
 
 CinnJitInstruction::CinnJitInstruction(
@@ -273,6 +293,10 @@ CinnJitInstruction::CinnJitInstruction(
     tensor_args_.push_back(&tensor);
   }
   output_tensor_size += temp_space_tensors_.size();
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  fn_ptr_impl_->InitFuncArgs(tensor_args_.size());
+#endif
 }
 
 void CinnJitInstruction::Run() {
@@ -287,7 +311,7 @@ void CinnJitInstruction::Run() {
   }
 
   // 1. prepare kernel arguments
-  fn_ptr_impl_->InitFuncArgs(tensor_args_);
+  fn_ptr_impl_->UpdateSymbolArgs(tensor_args_);
 
   if (FLAGS_cinn_bucket_compile && need_update_shape) {
     fn_ptr_impl_->InferShape(
@@ -301,7 +325,6 @@ void CinnJitInstruction::Run() {
   fn_ptr_impl_->Run(tensor_args_, running_stream, is_gpu);
 
   // 3. release resource
-  fn_ptr_impl_->FreeFuncArgs();
   for (auto& tensor : temp_space_tensors_) {
     tensor.clear();
   }
@@ -170,18 +170,27 @@ void WhileInstruction::ShareInputsToOutputs() {
 }
 
 void WhileInstruction::ShareOutputsToBlockArgs() {
-  for (size_t i = 0; i < body_block_->args_size(); ++i) {
-    auto block_arg = body_block_->arg(i);
-    auto var_name = body_inter_->GetNameByValue(block_arg);
-    auto* inner_var = body_inter_->local_scope()->GetVar(var_name);
+  if (block_arg_vars_.empty()) {
+    for (size_t i = 0; i < body_block_->args_size(); ++i) {
+      auto var_name = body_inter_->GetNameByValue(body_block_->arg(i));
+      block_arg_vars_.push_back(body_inter_->local_scope()->GetVar(var_name));
+    }
+  }
+  for (size_t i = 0; i < block_arg_vars_.size(); ++i) {
+    auto* inner_var = block_arg_vars_[i];
 
     if (outputs_[i]->IsType<phi::DenseTensor>()) {
       inner_var->GetMutable<phi::DenseTensor>()->ShareDataWith(
           outputs_[i]->Get<phi::DenseTensor>());
     } else if (outputs_[i]->IsType<phi::TensorArray>()) {
-      const auto& outer_array = outputs_[i]->Get<phi::TensorArray>();
+      // The yield at the end of the body overwrites the output, so the
+      // loop-carried array is moved into the body rather than copied. A
+      // growing array, e.g. a kv cache, is then not copied twice per
+      // iteration.
+      auto* outer_array = outputs_[i]->GetMutable<phi::TensorArray>();
       auto* inner_array = inner_var->GetMutable<phi::TensorArray>();
-      *inner_array = outer_array;
+      *inner_array = std::move(*outer_array);
+      outer_array->clear();
       VLOG(10) << inner_var
                << " should be created: " << inner_var->IsInitialized();
     } else {
@@ -192,9 +201,11 @@ void WhileInstruction::ShareOutputsToBlockArgs() {
 }
 
 void WhileInstruction::ShareConditionData() {
-  auto inner_cond_var = body_inter_->local_scope()->GetVar(inner_cond_);
+  if (inner_cond_var_ == nullptr) {
+    inner_cond_var_ = body_inter_->local_scope()->GetVar(inner_cond_);
+  }
   cond_var_->GetMutable<phi::DenseTensor>()->ShareDataWith(
-      inner_cond_var->Get<phi::DenseTensor>());
+      inner_cond_var_->Get<phi::DenseTensor>());
 }
 
 void WhileInstruction::SetOutputHooks(
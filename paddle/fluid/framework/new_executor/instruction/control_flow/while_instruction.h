@@ -77,6 +77,10 @@ class WhileInstruction : public InstructionBase {
 
   Variable* cond_var_;
   std::string inner_cond_;
+  // Resolved on the first iteration rather than looked up by name in every
+  // iteration.
+  Variable* inner_cond_var_{nullptr};
+  std::vector<Variable*> block_arg_vars_;
 
   std::vector<Variable*> inputs_;
   std::vector<Variable*> outputs_;
@@ -29,6 +29,7 @@ class Value;
 namespace paddle {
 namespace framework {
 class ValueExecutionInfo;
+struct InstructionCounters;
 
 using SchedulingPriority = int64_t;
 
@@ -180,6 +181,13 @@ class InstructionBase {
     skip_record_stream_for_gc_ = skip;
   }
 
+  // Set by the interpreter when FLAGS_new_executor_instruction_stats is on,
+  // see instruction_statistics.h.
+  InstructionCounters* RuntimeCounters() const { return runtime_counters_; }
+  void SetRuntimeCounters(InstructionCounters* counters) {
+    runtime_counters_ = counters;
+  }
+
  protected:
   size_t id_;
 
@@ -230,6 +238,8 @@ class InstructionBase {
   std::unordered_set<::pir::Value> no_need_buffer_values_;
 
   bool skip_record_stream_for_gc_{false};
+
+  InstructionCounters* runtime_counters_{nullptr};  // not owned
 };
 
 }  // namespace framework
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/instruction_statistics.h"
 
 namespace pir {
 class Operation;
@@ -66,6 +67,8 @@ class LegacyKernelInstruction : public InstructionBase {
   ::pir::Operation* op_{nullptr};  // not owned
 
   const ValueExecutionInfo* value_exec_info_;  // not owned
+
+  DeviceTimeSampler device_time_sampler_;
 };
 
 }  // namespace framework
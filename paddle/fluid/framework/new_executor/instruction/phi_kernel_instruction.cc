@@ -122,6 +122,15 @@ PhiKernelInstruction::PhiKernelInstruction(
   VLOG(6) << "finish process yaml_info_parser";
 
   if (infer_meta_interface_) {
+    // The values of tensor attributes, e.g. the shape of reshape, are read by
+    // InferMeta, so the metas of the inputs can not decide the outputs.
+    infer_meta_cacheable_ = true;
+    for (auto& attr_name : yaml_info_parser.AttrParams(false)) {
+      if (yaml_info_parser.InputName2Id().count(attr_name)) {
+        infer_meta_cacheable_ = false;
+        break;
+      }
+    }
     BuildPhiContext<
         phi::InferMetaContext,
         phi::MetaTensor,
@@ -183,6 +192,63 @@ PhiKernelInstruction::PhiKernelInstruction(
 
 PhiKernelInstruction::~PhiKernelInstruction() { delete phi_kernel_; }
 
+void PhiKernelInstruction::EnableInferMetaCache() {
+  if (!infer_meta_cacheable_ || cache_infer_meta_) {
+    return;
+  }
+  Scope* inner_scope = value_exec_info_->GetScope();
+  auto find_var = [&](pir::Value value) -> const Variable* {
+    if (!value || !value.type() || !value_exec_info_->HasValue(value)) {
+      return nullptr;
+    }
+    return inner_scope->FindVar(value_exec_info_->GetVarName(value));
+  };
+  infer_meta_vars_.clear();
+  for (size_t i = 0; i < op_->num_operands(); ++i) {
+    infer_meta_vars_.push_back(find_var(op_->operand_source(i)));
+  }
+  for (size_t i = 0; i < op_->num_results(); ++i) {
+    infer_meta_vars_.push_back(find_var(op_->result(i)));
+  }
+  cache_infer_meta_ = true;
+}
+
+bool PhiKernelInstruction::BuildInferMetaSignature(
+    std::vector<int64_t>* signature) const {
+  signature->clear();
+  for (const Variable* var : infer_meta_vars_) {
+    if (var == nullptr) {
+      signature->push_back(-1);
+      continue;
+    }
+    if (!var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    const auto& meta = var->Get<phi::DenseTensor>().meta();
+    signature->push_back(static_cast<int64_t>(meta.dtype));
+    signature->push_back(static_cast<int64_t>(meta.layout));
+    signature->push_back(meta.is_contiguous() ? 1 : 0);
+    signature->push_back(meta.dims.size());
+    for (int i = 0; i < meta.dims.size(); ++i) {
+      signature->push_back(meta.dims[i]);
+    }
+    signature->push_back(static_cast<int64_t>(meta.legacy_lod.size()));
+    for (const auto& level : meta.legacy_lod) {
+      signature->push_back(static_cast<int64_t>(level.size()));
+      signature->insert(signature->end(), level.begin(), level.end());
+    }
+  }
+  return true;
+}
+
+bool PhiKernelInstruction::CanSkipInferMeta() {
+  // The outputs are compared as well, since other instructions may share and
+  // reshape them, e.g. inplace ops.
+  return cache_infer_meta_ && !infer_meta_signature_.empty() &&
+         BuildInferMetaSignature(&signature_buffer_) &&
+         signature_buffer_ == infer_meta_signature_;
+}
+
 void PhiKernelInstruction::Run() {
   if (FLAGS_print_kernel_run_info) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -210,13 +276,19 @@ void PhiKernelInstruction::Run() {
     }
 #endif
   }
+  KernelRunTimer run_timer(this, &device_time_sampler_);
   VLOG(6) << "Begin run op " << phi_op_name_ << " infer meta.";
-  if (infer_meta_interface_) {
+  if (infer_meta_interface_ && !CanSkipInferMeta()) {
     phi::RecordEvent record_event("PhiKernelInstruction::infermeta",
                                   phi::TracerEventType::UserDefined,
                                   1);
     infer_meta_interface_->infer_meta_(&(infer_meta_context_));
+    if (cache_infer_meta_ &&
+        !BuildInferMetaSignature(&infer_meta_signature_)) {
+      infer_meta_signature_.clear();
+    }
   }
+  run_timer.InferMetaDone();
   VLOG(6) << "End run op " << phi_op_name_ << " infer meta.";
   for (auto& pair : this->InplaceInfo()) {
     ShareVarBuffer(pair.first, pair.second);
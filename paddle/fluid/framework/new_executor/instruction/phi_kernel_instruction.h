@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/fluid/framework/new_executor/instruction_statistics.h"
 
 namespace pir {
 class Operation;
@@ -48,6 +51,10 @@ class PhiKernelInstruction : public InstructionBase {
 
   ::pir::Operation* Operation() const override { return op_; }
 
+  // Skip InferMeta when the metas of the inputs and outputs are the same as
+  // those of the last run, see FLAGS_pir_interpreter_cache_infer_meta.
+  void EnableInferMetaCache();
+
   void Run() override;
 
   const std::string& Name() const override { return phi_op_name_; }
@@ -69,6 +76,18 @@ class PhiKernelInstruction : public InstructionBase {
   ::pir::Operation* op_{nullptr};  // not owned
 
   const ValueExecutionInfo* value_exec_info_;  // not owned
+
+  DeviceTimeSampler device_time_sampler_;
+
+  // for the InferMeta cache
+  bool CanSkipInferMeta();
+  bool BuildInferMetaSignature(std::vector<int64_t>* signature) const;
+
+  bool infer_meta_cacheable_{false};
+  bool cache_infer_meta_{false};
+  std::vector<const Variable*> infer_meta_vars_;  // not owned
+  std::vector<int64_t> infer_meta_signature_;
+  std::vector<int64_t> signature_buffer_;
 };
 
 }  // namespace framework
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "paddle/fluid/framework/new_executor/instruction/tensorrt_engine_instruction.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/new_executor/instruction/instruction_util.h"
 #include "paddle/fluid/inference/analysis/helper.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
@@ -22,6 +23,8 @@
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 
+COMMON_DECLARE_bool(trt_instruction_use_cuda_graph);
+
 namespace paddle {
 namespace framework {
 
@@ -341,6 +344,14 @@ void TensorRTEngineInstruction::PrepareDynamicShape() {
     }
   }
 
+  // Shape tensors carry values that have to be checked on every run, other
+  // inputs only their dims, which an earlier run may have checked already.
+  has_shape_tensor_input_ = !runtime_shape_tensor.empty();
+  if (!has_shape_tensor_input_ &&
+      runtime_input_shape == checked_input_shapes_) {
+    return;
+  }
+
   if (!allow_build_at_runtime_) {
     std::map<std::string, std::vector<int>> min_input_shape =
         trt_engine_->min_input_shape();
@@ -387,6 +398,7 @@ void TensorRTEngineInstruction::PrepareDynamicShape() {
       if (trt_engine_->engine()) {
         trt_engine_->ResetContext();
         trt_engine_->ClearTensorMap();
+        ResetBindingCache();
       }
       auto *anc = scope.parent();
       while (anc && anc->parent()) {
@@ -405,6 +417,43 @@ void TensorRTEngineInstruction::PrepareDynamicShape() {
       // rebuild trt_engine
     }
   }
+  if (has_shape_tensor_input_) {
+    checked_input_shapes_.clear();
+  } else {
+    checked_input_shapes_ = std::move(runtime_input_shape);
+  }
+}
+
+int TensorRTEngineInstruction::GetBindIndex(const std::string &name) {
+  // Index in profile 0, the same for every context of the engine
+  auto it = io_tensor_index_.find(name);
+  if (it == io_tensor_index_.end()) {
+    int index = -1;
+#if IS_TRT_VERSION_GE(8600)
+    for (int i = 0; i < trt_engine_->engine()->getNbIOTensors(); ++i) {
+      if (name == std::string(trt_engine_->engine()->getIOTensorName(i))) {
+        index = i;
+        break;
+      }
+    }
+#else
+    index = trt_engine_->engine()->getBindingIndex(name.c_str());
+#endif
+    PADDLE_ENFORCE_GE(index,
+                      0,
+                      common::errors::InvalidArgument(
+                          "Cannot find tensor name %s in TRT engine", name));
+    it = io_tensor_index_.emplace(name, index).first;
+  }
+  return it->second + trt_engine_->GetBindingsOffset();
+}
+
+void TensorRTEngineInstruction::ResetBindingCache() {
+  bound_context_ = nullptr;
+  bound_input_shapes_.clear();
+  checked_input_shapes_.clear();
+  cuda_graph_.reset();
+  graph_buffers_.clear();
 }
 
 void TensorRTEngineInstruction::BindInputTensor(
@@ -416,11 +465,7 @@ void TensorRTEngineInstruction::BindInputTensor(
     int *runtime_batch) {
   auto dev_place = dev_ctx_->GetPlace();
   const int num_bindings = trt_engine_->GetNbBindings();
-  int binding_offset = 0;
-  nvinfer1::IExecutionContext *trt_context = nullptr;
-  // Initialize context and get offset by profile index
-  trt_context = trt_engine_->context();
-  binding_offset = trt_engine_->GetBindingsOffset();
+  nvinfer1::IExecutionContext *trt_context = trt_engine_->context();
 
   PADDLE_ENFORCE_GT(
       input_tensor.numel(),
@@ -454,25 +499,7 @@ void TensorRTEngineInstruction::BindInputTensor(
   }
 
   // Get index of profile 0 first, then plus binding offset
-#if IS_TRT_VERSION_GE(8600)
-  int bind_index = -1;
-  for (int i = 0; i < trt_engine_->engine()->getNbIOTensors(); ++i) {
-    if (std::string(input_name.c_str()) ==
-        std::string(trt_engine_->engine()->getIOTensorName(i))) {
-      bind_index = i + binding_offset;
-      break;
-    }
-  }
-  PADDLE_ENFORCE_GE(
-      bind_index,
-      0,
-      common::errors::InvalidArgument("Cannot find input name %s in TRT engine",
-                                      input_name.c_str()));
-#else
-  const int bind_index =
-      trt_engine_->engine()->getBindingIndex(input_name.c_str()) +
-      binding_offset;
-#endif
+  const int bind_index = GetBindIndex(input_name);
   PADDLE_ENFORCE_LT(bind_index,
                     num_bindings,
                     common::errors::InvalidArgument(
@@ -483,6 +510,14 @@ void TensorRTEngineInstruction::BindInputTensor(
                         bind_index,
                         num_bindings));
 
+  // The context keeps the input shapes of the last run, only set changed ones
+  auto &bound_shape = bound_input_shapes_[input_name];
+  const bool shape_changed = bound_shape != input_shape;
+  if (shape_changed) {
+    bound_shape = input_shape;
+    input_shape_changed_ = true;
+  }
+
 #if IS_TRT_VERSION_GE(6000)
 #if IS_TRT_VERSION_GE(8500)
   if (trt_engine_->engine()->isShapeInferenceIO(input_name.c_str()) &&
@@ -513,15 +548,17 @@ void TensorRTEngineInstruction::BindInputTensor(
                               nullptr);
     }
     trt_context->setTensorAddress(input_name.c_str(), shape_v.data());
-  } else {
+  } else if (shape_changed) {
     trt_context->setInputShape(
         input_name.c_str(),
         paddle::platform::Vec2TRT_Dims(input_shape, input_name, true));
   }
 #else
-  trt_context->setBindingDimensions(
-      bind_index,
-      paddle::platform::Vec2TRT_Dims(input_shape, input_name, true));
+  if (shape_changed) {
+    trt_context->setBindingDimensions(
+        bind_index,
+        paddle::platform::Vec2TRT_Dims(input_shape, input_name, true));
+  }
   // If this x is a shape tensor, we need call setInputShapeBinding
   if (trt_engine_->engine()->isShapeBinding(bind_index) &&
       trt_engine_->engine()->bindingIsInput(bind_index)) {
@@ -622,31 +659,9 @@ void TensorRTEngineInstruction::BindOutputTensor(
     int output_index,
     std::vector<void *> &buffers,
     int *runtime_batch) {
-  int binding_offset = 0;
   const int num_bindings = trt_engine_->GetNbBindings();
-  nvinfer1::IExecutionContext *trt_context = nullptr;
-  // Initialize context and get offset by profile index
-  trt_context = trt_engine_->context();
-  binding_offset = trt_engine_->GetBindingsOffset();
-#if IS_TRT_VERSION_GE(8600)
-  int bind_index = -1;
-  for (int i = 0; i < trt_engine_->engine()->getNbIOTensors(); ++i) {
-    if (std::string(output_name.c_str()) ==
-        std::string(trt_engine_->engine()->getIOTensorName(i))) {
-      bind_index = i + binding_offset;
-      break;
-    }
-  }
-  PADDLE_ENFORCE_GE(
-      bind_index,
-      0,
-      common::errors::InvalidArgument("Cannot find input name %s in TRT engine",
-                                      output_name.c_str()));
-#else
-  const int bind_index =
-      trt_engine_->engine()->getBindingIndex(output_name.c_str()) +
-      binding_offset;
-#endif
+  nvinfer1::IExecutionContext *trt_context = trt_engine_->context();
+  const int bind_index = GetBindIndex(output_name);
   std::vector<int> ddim;
 
 #if IS_TRT_VERSION_GE(8500)
@@ -705,7 +720,12 @@ void TensorRTEngineInstruction::RunTrt() {
 
   // Get the total over all profiles
   const int num_bindings = trt_engine_->GetNbBindings();
-  std::vector<void *> buffers(num_bindings, nullptr);
+  buffers_.assign(num_bindings, nullptr);
+  input_shape_changed_ = false;
+  if (trt_engine_->context() != bound_context_) {
+    ResetBindingCache();
+    bound_context_ = trt_engine_->context();
+  }
 
   pir::Value source_value = op_->operand_source(0);
   auto in_var_name = value_exec_info_->GetVarName(source_value);
@@ -727,7 +747,7 @@ void TensorRTEngineInstruction::RunTrt() {
       BindInputTensor(index_name_pair.second,
                       input_tensor,
                       scope,
-                      buffers,
+                      buffers_,
                       shape_inputs[i],
                       &runtime_batch);
     } else {
@@ -756,7 +776,7 @@ void TensorRTEngineInstruction::RunTrt() {
           &(out_variable_array->at(i)->Get<phi::DenseTensor>()));
       // Bind input tensor to TRT.
       BindOutputTensor(
-          index_name_pair.second, output_tensor, i, buffers, &runtime_batch);
+          index_name_pair.second, output_tensor, i, buffers_, &runtime_batch);
     } else {
       PADDLE_THROW(
           common::errors::Unimplemented("Only support Vector<DenseTensor> now "
@@ -767,7 +787,7 @@ void TensorRTEngineInstruction::RunTrt() {
 
   VLOG(4) << "Start Runing trt engine...";
   // Execute the engine.
-  trt_engine_->Execute(runtime_batch, &buffers, stream);
+  ExecuteTrt(runtime_batch, stream);
   VLOG(4) << "End Runing trt engine and deal with output";
   for (const auto &index_name_pair : output_names_) {
     size_t i = index_name_pair.first;
@@ -811,6 +831,44 @@ void TensorRTEngineInstruction::RunTrt() {
   }
 }
 
+void TensorRTEngineInstruction::ExecuteTrt(int runtime_batch,
+                                           cudaStream_t stream) {
+  // The host pointers of shape tensors change every run, and a graph
+  // captures the addresses and shapes bound at capture time.
+  if (!FLAGS_trt_instruction_use_cuda_graph || has_shape_tensor_input_ ||
+      cuda_graph_failed_) {
+    trt_engine_->Execute(runtime_batch, &buffers_, stream);
+    return;
+  }
+  if (input_shape_changed_ || buffers_ != graph_buffers_) {
+    cuda_graph_.reset();
+    graph_buffers_ = buffers_;
+    trt_engine_->Execute(runtime_batch, &buffers_, stream);
+    return;
+  }
+  if (!cuda_graph_) {
+    // The previous run had the same bindings and served as warm up.
+    auto *trt_context = trt_engine_->context();
+    cuda_graph_ = std::make_unique<paddle::platform::TrtCudaGraph>();
+    cuda_graph_->BeginCapture(stream);
+    if (trt_engine_->Enqueue(trt_context, &buffers_, runtime_batch, stream)) {
+      cuda_graph_->EndCapture(stream);
+    } else {
+      cuda_graph_->EndCaptureOnError(stream);
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaGetLastError());
+      cuda_graph_.reset();
+      cuda_graph_failed_ = true;
+      LOG(WARNING) << "The TensorRT engine of " << op_name_
+                   << " can not be captured into a CUDA graph, it will be "
+                      "launched without CUDA graph.";
+      trt_engine_->Execute(runtime_batch, &buffers_, stream);
+      return;
+    }
+  }
+  VLOG(4) << "Launch the CUDA graph of trt engine";
+  cuda_graph_->Launch(stream);
+}
+
 void TensorRTEngineInstruction::Run() {
   PrepareDynamicShape();
   RunTrt();
@@ -56,6 +56,9 @@ class TensorRTEngineInstruction : public InstructionBase {
                         int output_index,
                         std::vector<void*>& buffers,  // NOLINT
                         int* runtime_batch);
+  int GetBindIndex(const std::string& name);
+  void ResetBindingCache();
+  void ExecuteTrt(int runtime_batch, cudaStream_t stream);
   std::unique_ptr<paddle::platform::TensorRTEngine> trt_engine_;  // not owned
   int64_t workspace_size_;
   bool allow_build_at_runtime_;
@@ -68,6 +71,21 @@ class TensorRTEngineInstruction : public InstructionBase {
   std::vector<int> outputs_rank_;
   std::vector<phi::DataType> outputs_dtype_;
   std::string op_name_ = "pd_op.tensorrt_engine";
+
+  // Binding state kept between runs, see ResetBindingCache.
+  std::unordered_map<std::string, int> io_tensor_index_;
+  nvinfer1::IExecutionContext* bound_context_{nullptr};
+  std::unordered_map<std::string, std::vector<int64_t>> bound_input_shapes_;
+  std::map<std::string, std::vector<int32_t>> checked_input_shapes_;
+  std::vector<void*> buffers_;
+  bool input_shape_changed_{false};
+  bool has_shape_tensor_input_{false};
+
+  // CUDA graph of the last enqueue, valid for graph_buffers_ only.
+  std::unique_ptr<paddle::platform::TrtCudaGraph> cuda_graph_;
+  std::vector<void*> graph_buffers_;
+  bool cuda_graph_failed_{false};
+
   ::pir::Operation* op_{nullptr};  // not owned
 
   const ValueExecutionInfo* value_exec_info_;  // not owned
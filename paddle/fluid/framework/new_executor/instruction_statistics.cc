@@ -0,0 +1,170 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/instruction_statistics.h"
+
+#include "paddle/common/flags.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#endif
+
+COMMON_DECLARE_bool(new_executor_instruction_stats);
+COMMON_DECLARE_int32(new_executor_instruction_stats_device_sampling);
+
+namespace paddle {
+namespace framework {
+
+InstructionStatistics& InstructionStatistics::Instance() {
+  static InstructionStatistics instance;
+  return instance;
+}
+
+InstructionCounters* InstructionStatistics::GetCounters(
+    const std::string& op_type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto& counters = counters_[op_type];
+  if (!counters) {
+    counters = std::make_unique<InstructionCounters>();
+  }
+  return counters.get();
+}
+
+std::map<std::string, InstructionRuntimeStats>
+InstructionStatistics::Snapshot() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  std::map<std::string, InstructionRuntimeStats> snapshot;
+  for (auto& [op_type, counters] : counters_) {
+    InstructionRuntimeStats stats;
+    stats.count = counters->count.load(std::memory_order_relaxed);
+    if (stats.count == 0) {
+      continue;
+    }
+    stats.dispatch_time =
+        counters->dispatch_time.load(std::memory_order_relaxed);
+    stats.infer_meta_time =
+        counters->infer_meta_time.load(std::memory_order_relaxed);
+    stats.launch_time = counters->launch_time.load(std::memory_order_relaxed);
+    stats.device_samples =
+        counters->device_samples.load(std::memory_order_relaxed);
+    stats.device_time = counters->device_time.load(std::memory_order_relaxed);
+    snapshot.emplace(op_type, stats);
+  }
+  return snapshot;
+}
+
+void InstructionStatistics::Reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& [op_type, counters] : counters_) {
+    counters->count.store(0, std::memory_order_relaxed);
+    counters->dispatch_time.store(0, std::memory_order_relaxed);
+    counters->infer_meta_time.store(0, std::memory_order_relaxed);
+    counters->launch_time.store(0, std::memory_order_relaxed);
+    counters->device_samples.store(0, std::memory_order_relaxed);
+    counters->device_time.store(0, std::memory_order_relaxed);
+  }
+}
+
+bool DeviceTimeSampler::Start(const phi::DeviceContext& ctx,
+                              InstructionCounters* counters) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (!phi::is_gpu_place(ctx.GetPlace())) {
+    return false;
+  }
+  if (pending_counters_ && timer_->IsStopped()) {
+    auto elapsed_ns = static_cast<uint64_t>(timer_->ElapsedTime() * 1e6);
+    pending_counters_->device_samples.fetch_add(1, std::memory_order_relaxed);
+    pending_counters_->device_time.fetch_add(elapsed_ns,
+                                             std::memory_order_relaxed);
+    pending_counters_ = nullptr;
+  }
+  const int64_t interval = FLAGS_new_executor_instruction_stats_device_sampling;
+  if (interval <= 0 || pending_counters_ ||
+      (num_runs_++ % static_cast<uint64_t>(interval)) != 0) {
+    return false;
+  }
+  if (!timer_) {
+    timer_ = std::make_unique<phi::GpuTimer>();
+  }
+  timer_->Start(static_cast<const phi::GPUContext&>(ctx).stream());
+  pending_counters_ = counters;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void DeviceTimeSampler::Stop(const phi::DeviceContext& ctx) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  timer_->Stop(static_cast<const phi::GPUContext&>(ctx).stream());
+#endif
+}
+
+KernelRunTimer::KernelRunTimer(InstructionBase* instr,
+                               DeviceTimeSampler* sampler)
+    : instr_(instr), counters_(instr->RuntimeCounters()), sampler_(sampler) {
+  if (counters_ == nullptr) {
+    return;
+  }
+  start_ = InstructionStatsNow();
+  infer_meta_end_ = start_;
+}
+
+KernelRunTimer::~KernelRunTimer() {
+  if (counters_ == nullptr) {
+    return;
+  }
+  if (sampled_) {
+    sampler_->Stop(instr_->DeviceContext());
+  }
+  counters_->infer_meta_time.fetch_add(infer_meta_end_ - start_,
+                                       std::memory_order_relaxed);
+  counters_->launch_time.fetch_add(InstructionStatsNow() - infer_meta_end_,
+                                   std::memory_order_relaxed);
+}
+
+void KernelRunTimer::InferMetaDone() {
+  if (counters_ == nullptr) {
+    return;
+  }
+  infer_meta_end_ = InstructionStatsNow();
+  sampled_ = sampler_->Start(instr_->DeviceContext(), counters_);
+}
+
+InstructionDispatchTimer::InstructionDispatchTimer(InstructionBase* instr) {
+  if (!FLAGS_new_executor_instruction_stats) {
+    if (instr->RuntimeCounters()) {
+      instr->SetRuntimeCounters(nullptr);
+    }
+    return;
+  }
+  if (instr->RuntimeCounters() == nullptr) {
+    instr->SetRuntimeCounters(
+        InstructionStatistics::Instance().GetCounters(instr->Name()));
+  }
+  counters_ = instr->RuntimeCounters();
+  start_ = InstructionStatsNow();
+}
+
+InstructionDispatchTimer::~InstructionDispatchTimer() {
+  if (counters_ == nullptr) {
+    return;
+  }
+  counters_->count.fetch_add(1, std::memory_order_relaxed);
+  counters_->dispatch_time.fetch_add(InstructionStatsNow() - start_,
+                                     std::memory_order_relaxed);
+}
+
+}  // namespace framework
+}  // namespace paddle
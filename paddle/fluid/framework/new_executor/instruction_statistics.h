@@ -0,0 +1,145 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
+#include "paddle/phi/core/device_context.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#endif
+
+namespace paddle {
+namespace framework {
+
+// The runtime statistics of the instructions of an op type, all the times are
+// in nanoseconds.
+struct InstructionRuntimeStats {
+  uint64_t count{0};
+  // host time the interpreter spends on the instructions, including waiting
+  // events, infer meta, kernel launch and gc
+  uint64_t dispatch_time{0};
+  uint64_t infer_meta_time{0};
+  // host time of calling the kernels
+  uint64_t launch_time{0};
+  // device time of the kernels, summed over the sampled runs only
+  uint64_t device_samples{0};
+  uint64_t device_time{0};
+};
+
+// The counters are updated by the threads of the interpreters concurrently.
+struct InstructionCounters {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> dispatch_time{0};
+  std::atomic<uint64_t> infer_meta_time{0};
+  std::atomic<uint64_t> launch_time{0};
+  std::atomic<uint64_t> device_samples{0};
+  std::atomic<uint64_t> device_time{0};
+};
+
+// InstructionStatistics aggregates low overhead runtime counters of the
+// instructions of PirInterpreter by op type, see
+// FLAGS_new_executor_instruction_stats. Comparing the host dispatch time with
+// the device time tells whether a program is bound by kernel launch or by
+// device compute, without a full profiler trace.
+class InstructionStatistics {
+ public:
+  static InstructionStatistics& Instance();
+
+  InstructionStatistics(const InstructionStatistics&) = delete;
+  InstructionStatistics& operator=(const InstructionStatistics&) = delete;
+
+  // The returned counters live as long as the process, Reset only clears
+  // them, so instructions can cache the pointer.
+  InstructionCounters* GetCounters(const std::string& op_type);
+
+  std::map<std::string, InstructionRuntimeStats> Snapshot() const;
+
+  void Reset();
+
+ private:
+  InstructionStatistics() = default;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, std::unique_ptr<InstructionCounters>>
+      counters_;
+};
+
+inline uint64_t InstructionStatsNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Measures the device time of the kernels of an instruction on every
+// FLAGS_new_executor_instruction_stats_device_sampling runs. A sample is
+// read when the next sample starts and only if its kernels have completed,
+// so the device is never synchronized.
+class DeviceTimeSampler {
+ public:
+  // Returns whether the current run is sampled.
+  bool Start(const phi::DeviceContext& ctx, InstructionCounters* counters);
+
+  void Stop(const phi::DeviceContext& ctx);
+
+ private:
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  std::unique_ptr<phi::GpuTimer> timer_;
+#endif
+  InstructionCounters* pending_counters_{nullptr};
+  uint64_t num_runs_{0};
+};
+
+// Splits the host time of running a kernel instruction into infer meta and
+// kernel launch, does nothing if the counters of the instruction are not set.
+class KernelRunTimer {
+ public:
+  KernelRunTimer(InstructionBase* instr, DeviceTimeSampler* sampler);
+
+  ~KernelRunTimer();
+
+  void InferMetaDone();
+
+ private:
+  InstructionBase* instr_;
+  InstructionCounters* counters_;
+  DeviceTimeSampler* sampler_;
+  bool sampled_{false};
+  uint64_t start_{0};
+  uint64_t infer_meta_end_{0};
+};
+
+// Measures the whole host time the interpreter spends on an instruction.
+class InstructionDispatchTimer {
+ public:
+  explicit InstructionDispatchTimer(InstructionBase* instr);
+
+  ~InstructionDispatchTimer();
+
+ private:
+  InstructionCounters* counters_{nullptr};
+  uint64_t start_{0};
+};
+
+}  // namespace framework
+}  // namespace paddle
@@ -58,8 +58,7 @@ bool DataTransferHelper::apply(const phi::KernelKey& kernel_type_for_var,
     is_transferred = true;
   }
 
-  // 2. dtype transform
-  if (need_dtype_transform(kernel_type_for_var, expected_kernel_key)) {
+  auto transfer_dtype = [&]() {
     auto op = TransferDtype(
         *src_var_name,
         new_var_name,
@@ -74,13 +73,11 @@ bool DataTransferHelper::apply(const phi::KernelKey& kernel_type_for_var,
     // update src_var_name
     src_var_name = new_var_name;
     is_transferred = true;
-  }
+  };
 
-  // 3. device transform
-  phi::Backend expected_backend = expected_kernel_key.backend();
-  if (need_device_transform(kernel_type_for_var, tensor, expected_backend)) {
+  auto transfer_device = [&]() {
     auto src_place = tensor->place();
-    auto dst_place = phi::TransToPhiPlace(expected_backend);
+    auto dst_place = phi::TransToPhiPlace(expected_kernel_key.backend());
 
     auto op = TransferDevice(
         *src_var_name, new_var_name, src_place, dst_place, var_scope_, scope_);
@@ -88,7 +85,37 @@ bool DataTransferHelper::apply(const phi::KernelKey& kernel_type_for_var,
       RunAndConstructOpFuncNode(
           op, *src_var_name, *new_var_name, op_func_nodes, static_build);
     }
+    // update src_var_name
+    src_var_name = new_var_name;
     is_transferred = true;
+  };
+
+  // 2. dtype transform and 3. device transform
+  const bool need_dtype =
+      need_dtype_transform(kernel_type_for_var, expected_kernel_key);
+  const bool need_device = need_device_transform(
+      kernel_type_for_var, tensor, expected_kernel_key.backend());
+  // NOTE: When a host tensor is cast to a wider (or the same size) dtype for
+  // a device kernel, copy it first and cast it on the device. It moves fewer
+  // bytes through memcpy_h2d and the cast runs on the device instead of the
+  // host.
+  const bool device_first =
+      need_dtype && need_device && phi::is_cpu_place(tensor->place()) &&
+      phi::SizeOf(expected_kernel_key.dtype()) >=
+          phi::SizeOf(kernel_type_for_var.dtype());
+  if (device_first) {
+    VLOG(4) << "Transfer " << var_name << " to "
+            << phi::TransToPhiPlace(expected_kernel_key.backend())
+            << " before casting it to " << expected_kernel_key.dtype();
+    transfer_device();
+    transfer_dtype();
+  } else {
+    if (need_dtype) {
+      transfer_dtype();
+    }
+    if (need_device) {
+      transfer_device();
+    }
   }
   return is_transferred;
 }
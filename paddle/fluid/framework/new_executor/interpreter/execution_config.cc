@@ -14,6 +14,7 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 
+#include <algorithm>
 #include <set>
 #include <thread>
 
@@ -37,6 +38,22 @@ PHI_DEFINE_EXPORTED_string(force_sync_ops,
                            "",
                            "Pattern to force sync ops in executor.");
 
+// FLAGS_new_executor_num_compute_streams is the number of compute streams,
+// including the default one, that the pir interpreter places independent GPU
+// kernels on. The kernels are assigned by a list scheduling on the estimated
+// cost of kernels, 1 keeps all kernels on the default stream.
+PHI_DEFINE_EXPORTED_int32(new_executor_num_compute_streams,
+                          1,
+                          "Number of compute streams in executor.");
+
+// FLAGS_new_executor_kernel_cost_table is the path of a profiled kernel cost
+// table used by the multi-stream scheduling. Each line is "kernel_name
+// cost_in_us", the kernels not in the table are estimated by the size of their
+// outputs.
+PHI_DEFINE_EXPORTED_string(new_executor_kernel_cost_table,
+                           "",
+                           "Path of the kernel cost table for multi-stream.");
+
 PD_DECLARE_bool(new_executor_serial_run);
 
 namespace paddle::framework::interpreter {
@@ -133,6 +150,19 @@ void ExecutionConfig::AnalyzeThreadPoolConfig(const phi::Place& place,
   }
 }
 
+void ExecutionConfig::AnalyzeStreamConfig(const phi::Place& place) {
+  if (num_compute_streams == 0) {
+    num_compute_streams = static_cast<size_t>(
+        std::max(FLAGS_new_executor_num_compute_streams, 1));
+  }
+  if (!phi::is_gpu_place(place) || FLAGS_new_executor_serial_run) {
+    num_compute_streams = 1;
+  }
+  if (kernel_cost_table.empty()) {
+    kernel_cost_table = FLAGS_new_executor_kernel_cost_table;
+  }
+}
+
 void ExecutionConfig::Log(int log_level) {
   std::stringstream log_str;
   log_str << "ExecutionConfig:\n"
@@ -142,7 +172,9 @@ void ExecutionConfig::Log(int log_level) {
           << "used_for_jit = " << used_for_jit << "\n"
           << "used_for_sot = " << used_for_sot << "\n"
           << "device_num_threads = " << device_num_threads << "\n"
-          << "host_num_threads = " << host_num_threads << "\n";
+          << "host_num_threads = " << host_num_threads << "\n"
+          << "num_compute_streams = " << num_compute_streams << "\n"
+          << "kernel_cost_table = " << kernel_cost_table << "\n";
 
   log_str << "force_root_scope_vars = [";
   for (const std::string& var : force_root_scope_vars) {
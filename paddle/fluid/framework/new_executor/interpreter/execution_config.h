@@ -35,6 +35,13 @@ struct ExecutionConfig {
   size_t device_num_threads{0};
   size_t host_num_threads{0};
 
+  // The number of compute streams, including the default one, to place the
+  // independent GPU kernels on. 0 means FLAGS_new_executor_num_compute_streams.
+  size_t num_compute_streams{0};
+  // The profiled time cost of kernels, see
+  // FLAGS_new_executor_kernel_cost_table.
+  std::string kernel_cost_table;
+
   std::set<std::pair<int, std::string>>
       force_sync_ops;  // set{pair<op_id, name>}, -1 matches any op_id, ""
                        // matches any name
@@ -44,6 +51,7 @@ struct ExecutionConfig {
   std::set<std::string> skip_gc_vars;
 
   void AnalyzeThreadPoolConfig(const phi::Place& place, size_t op_num);
+  void AnalyzeStreamConfig(const phi::Place& place);
   void Log(int log_level);
 };
 
@@ -56,6 +56,7 @@ COMMON_DECLARE_bool(use_mkldnn);
 COMMON_DECLARE_bool(check_nan_inf);
 COMMON_DECLARE_string(static_runtime_data_save_path);
 COMMON_DECLARE_bool(save_static_runtime_data);
+COMMON_DECLARE_int32(new_executor_steal_group_size);
 
 namespace paddle::framework::interpreter {
 
@@ -104,6 +105,10 @@ const std::vector<WorkQueueOptions> ConstructWorkQueueOptions(
                              /*track_task*/ false,
                              /*detached*/ true,
                              /*events_waiter*/ waiter);
+  if (FLAGS_new_executor_steal_group_size > 0) {
+    group_options.back().steal_group_size =
+        static_cast<size_t>(FLAGS_new_executor_steal_group_size);
+  }
   // for launch device Kernel
   group_options.emplace_back(/*name*/ "DeviceKernelLaunch",
                              /*num_threads*/ device_num_threads,
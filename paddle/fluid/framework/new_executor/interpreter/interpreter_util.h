@@ -61,6 +61,8 @@ class AsyncWorkQueue {
     return queue_group_->QueueNumThreads(idx);
   }
 
+  WorkQueueStats Stats() const { return queue_group_->QueueGroupStats(); }
+
  private:
   size_t host_num_thread_;
   std::unique_ptr<WorkQueueGroup> queue_group_;
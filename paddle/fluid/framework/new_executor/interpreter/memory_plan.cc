@@ -0,0 +1,89 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/new_executor/interpreter/memory_plan.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+#include "paddle/common/enforce.h"
+
+namespace paddle::framework::interpreter {
+
+size_t PlanTensorOffsets(const std::vector<TensorLifetime>& tensors,
+                         size_t alignment,
+                         std::vector<size_t>* offsets) {
+  PADDLE_ENFORCE_GT(alignment,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The alignment of the memory plan should be larger "
+                        "than 0, but got %d.",
+                        alignment));
+  auto aligned_size = [alignment](size_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+  };
+
+  std::vector<size_t> order(tensors.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+    return tensors[lhs].size > tensors[rhs].size;
+  });
+
+  offsets->assign(tensors.size(), 0);
+  std::vector<size_t> placed;
+  std::vector<std::pair<size_t, size_t>> occupied;
+  size_t buffer_size = 0;
+  for (size_t idx : order) {
+    const TensorLifetime& tensor = tensors[idx];
+    size_t size = aligned_size(tensor.size);
+
+    occupied.clear();
+    for (size_t other : placed) {
+      if (tensors[other].begin <= tensor.end &&
+          tensor.begin <= tensors[other].end) {
+        size_t offset = (*offsets)[other];
+        occupied.emplace_back(offset,
+                              offset + aligned_size(tensors[other].size));
+      }
+    }
+    std::sort(occupied.begin(), occupied.end());
+
+    // best fit among the gaps, or right after the last occupied range
+    size_t best_offset = 0;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (auto& range : occupied) {
+      if (range.first > prev_end) {
+        size_t gap = range.first - prev_end;
+        if (gap >= size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = prev_end;
+        }
+      }
+      prev_end = std::max(prev_end, range.second);
+    }
+    if (best_gap == std::numeric_limits<size_t>::max()) {
+      best_offset = prev_end;
+    }
+
+    (*offsets)[idx] = best_offset;
+    buffer_size = std::max(buffer_size, best_offset + size);
+    placed.push_back(idx);
+  }
+  return buffer_size;
+}
+
+}  // namespace paddle::framework::interpreter
@@ -0,0 +1,61 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/core/allocator.h"
+
+namespace paddle {
+namespace framework {
+namespace interpreter {
+
+// The lifetime of a tensor is [begin, end] in the execution order, both ends
+// inclusive, so that the inputs and outputs of one instruction never share
+// memory.
+struct TensorLifetime {
+  size_t begin;
+  size_t end;
+  size_t size;
+};
+
+// Assigns every tensor an offset in one buffer, so that tensors whose
+// lifetimes overlap do not overlap in the buffer. Tensors are placed from the
+// largest to the smallest, each into the smallest gap it fits among the
+// tensors it overlaps with. Offsets are aligned to `alignment`. Returns the
+// size of the buffer.
+size_t PlanTensorOffsets(const std::vector<TensorLifetime>& tensors,
+                         size_t alignment,
+                         std::vector<size_t>* offsets);
+
+// A view of [offset, offset + size) of the planned buffer, which keeps the
+// buffer alive.
+class PlannedAllocation : public phi::Allocation {
+ public:
+  PlannedAllocation(const std::shared_ptr<phi::Allocation>& buffer,
+                    size_t offset,
+                    size_t size)
+      : phi::Allocation(static_cast<char*>(buffer->ptr()) + offset,
+                        size,
+                        buffer->place()),
+        buffer_(buffer) {}
+
+ private:
+  std::shared_ptr<phi::Allocation> buffer_;
+};
+
+}  // namespace interpreter
+}  // namespace framework
+}  // namespace paddle
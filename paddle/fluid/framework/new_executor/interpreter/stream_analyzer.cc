@@ -14,12 +14,21 @@
 
 #include "paddle/fluid/framework/new_executor/interpreter/stream_analyzer.h"
 
+#include <fstream>
 #include <future>
+#include <limits>
+#include <mutex>
 #include <unordered_set>
 
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_op.h"
+#include "paddle/fluid/pir/dialect/kernel/ir/kernel_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/dialect/operator/utils/utils.h"
 #include "paddle/phi/core/platform/device_context.h"
+#include "paddle/pir/include/core/block.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
 #if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/comm_context_manager.h"
@@ -678,6 +687,193 @@ void StreamAnalyzer::ShareEventInfoFrom(const StreamAnalyzer& src) {
 /// ======================== ///
 ///        For new ir        ///
 /// ======================== ///
+namespace {
+
+// The prefix of the streams assigned by AssignComputeStreams.
+constexpr char kAutoComputeStream[] = "auto_compute_stream_";
+// The estimated cost of the kernels not in the cost table, a kernel launch
+// plus writing its outputs once.
+constexpr double kKernelLaunchCostUs = 5.0;
+constexpr double kBytesPerUs = 5e5;
+constexpr int64_t kDynamicDimSize = 1024;
+// Recording an event on one stream and waiting for it on another one.
+constexpr double kCrossStreamCostUs = 10.0;
+
+const std::unordered_map<std::string, double>& GetKernelCostTable(
+    const std::string& path) {
+  static std::mutex mutex;
+  static std::unordered_map<std::string,
+                            std::unordered_map<std::string, double>>
+      tables;
+  std::lock_guard<std::mutex> guard(mutex);
+  auto iter = tables.find(path);
+  if (iter != tables.end()) {
+    return iter->second;
+  }
+  auto& table = tables[path];
+  if (!path.empty()) {
+    std::ifstream fin(path);
+    PADDLE_ENFORCE_EQ(
+        fin.is_open(),
+        true,
+        common::errors::NotFound("Cannot open the kernel cost table %s.",
+                                 path));
+    std::string kernel_name;
+    double cost = 0.0;
+    while (fin >> kernel_name >> cost) {
+      table[kernel_name] = cost;
+    }
+    VLOG(4) << "Load " << table.size() << " kernel costs from " << path;
+  }
+  return table;
+}
+
+// Only the GPU kernels without a manual 'execution_stream' are placed, the
+// communication and memcpy kernels have their own streams already.
+bool IsComputeStreamCandidate(::pir::Operation* op) {
+  if (op->num_regions() > 0 || op->HasAttribute("execution_stream")) {
+    return false;
+  }
+  phi::KernelKey kernel_key;
+  if (op->isa<paddle::dialect::PhiKernelOp>()) {
+    kernel_key = op->dyn_cast<paddle::dialect::PhiKernelOp>().kernel_key();
+  } else if (op->isa<paddle::dialect::LegacyKernelOp>()) {
+    kernel_key = op->dyn_cast<paddle::dialect::LegacyKernelOp>().kernel_key();
+  } else {
+    return false;
+  }
+  if (kernel_key.backend() != phi::Backend::GPU &&
+      kernel_key.backend() != phi::Backend::GPUDNN) {
+    return false;
+  }
+  if (IsCommunicationOp(op)) {
+    return false;
+  }
+  const std::string& op_name =
+      op->attribute<::pir::StrAttribute>("op_name").AsString();
+  return op_name != paddle::dialect::MemcpyD2hOp::name() &&
+         op_name != paddle::dialect::MemcpyH2dOp::name();
+}
+
+double EstimateKernelCost(
+    ::pir::Operation* op,
+    const std::unordered_map<std::string, double>& cost_table) {
+  const std::string& kernel_name =
+      op->attribute<::pir::StrAttribute>("kernel_name").AsString();
+  auto iter = cost_table.find(kernel_name);
+  if (iter != cost_table.end()) {
+    return iter->second;
+  }
+  int64_t bytes = 0;
+  for (uint32_t i = 0; i < op->num_results(); ++i) {
+    auto type = op->result(i).type();
+    if (!type || !type.isa<paddle::dialect::AllocatedDenseTensorType>()) {
+      continue;
+    }
+    auto tensor_type =
+        type.dyn_cast<paddle::dialect::AllocatedDenseTensorType>();
+    int64_t numel = 1;
+    for (int j = 0; j < tensor_type.dims().size(); ++j) {
+      numel *= tensor_type.dims()[j] >= 0 ? tensor_type.dims()[j]
+                                          : kDynamicDimSize;
+    }
+    bytes += numel * static_cast<int64_t>(phi::SizeOf(
+                         paddle::dialect::TransToPhiDataType(
+                             tensor_type.dtype())));
+  }
+  return kKernelLaunchCostUs + static_cast<double>(bytes) / kBytesPerUs;
+}
+
+}  // namespace
+
+void PirStreamAnalyzer::AssignComputeStreams(
+    ::pir::Block* block, const ExecutionConfig& config) const {
+  const size_t num_streams = config.num_compute_streams;
+  if (!phi::is_gpu_place(place_) || num_streams <= 1) {
+    return;
+  }
+  for (auto& op : *block) {
+    if (op.HasAttribute("execution_stream") &&
+        op.attribute<::pir::StrAttribute>("execution_stream")
+                .AsString()
+                .rfind(kAutoComputeStream, 0) == 0) {
+      VLOG(6) << "Compute streams have been assigned for the block";
+      return;
+    }
+  }
+  const auto& cost_table = GetKernelCostTable(config.kernel_cost_table);
+
+  // A list scheduling that simulates the streams: every kernel goes to the
+  // stream on which it starts the earliest, where waiting for a kernel on
+  // another stream costs an extra event. So a chain of kernels stays on one
+  // stream, and independent branches spread over the streams when they are
+  // heavier than the events.
+  std::vector<double> stream_ready(num_streams, 0.0);
+  std::unordered_map<::pir::Operation*, double> finish_time;
+  std::unordered_map<::pir::Operation*, int> stream_of;
+  size_t num_assigned = 0;
+  ::pir::IrContext* ctx = ::pir::IrContext::Instance();
+  for (auto& op : *block) {
+    std::vector<::pir::Operation*> preds;
+    for (const auto& operand : op.operands_source()) {
+      auto* def_op = operand ? operand.defining_op() : nullptr;
+      if (def_op && finish_time.count(def_op)) {
+        preds.push_back(def_op);
+      }
+    }
+
+    if (!IsComputeStreamCandidate(&op)) {
+      // The other ops are transparent, they pass the latest input through.
+      double finish = 0.0;
+      int stream = -1;
+      for (auto* pred : preds) {
+        if (finish_time.at(pred) >= finish) {
+          finish = finish_time.at(pred);
+          stream = stream_of.at(pred);
+        }
+      }
+      finish_time[&op] = finish;
+      stream_of[&op] = stream;
+      continue;
+    }
+
+    int best_stream = 0;
+    double best_start = std::numeric_limits<double>::max();
+    for (size_t s = 0; s < num_streams; ++s) {
+      double start = stream_ready[s];
+      for (auto* pred : preds) {
+        const int pred_stream = stream_of.at(pred);
+        const bool cross_stream =
+            pred_stream >= 0 && pred_stream != static_cast<int>(s);
+        start = std::max(
+            start,
+            finish_time.at(pred) + (cross_stream ? kCrossStreamCostUs : 0.0));
+      }
+      if (start < best_start) {
+        best_start = start;
+        best_stream = static_cast<int>(s);
+      }
+    }
+    const double finish = best_start + EstimateKernelCost(&op, cost_table);
+    stream_ready[best_stream] = finish;
+    finish_time[&op] = finish;
+    stream_of[&op] = best_stream;
+
+    if (best_stream > 0) {
+      op.set_attribute(
+          "execution_stream",
+          ::pir::StrAttribute::get(
+              ctx, kAutoComputeStream + std::to_string(best_stream)));
+      ++num_assigned;
+    }
+  }
+  VLOG(4) << "Assign " << num_assigned
+          << " kernels to the non-default compute streams, the estimated "
+             "makespan is "
+          << *std::max_element(stream_ready.begin(), stream_ready.end())
+          << " us";
+}
+
 void PirStreamAnalyzer::ConstructEvents(
     const std::vector<std::unique_ptr<paddle::framework::InstructionBase>>&
         instructions) {
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "paddle/fluid/framework/new_executor/interpreter/dependency_builder.h"
+#include "paddle/fluid/framework/new_executor/interpreter/execution_config.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/phi/core/platform/device_context.h"
 #include "paddle/phi/core/platform/device_event.h"
@@ -135,6 +136,12 @@ class PirStreamAnalyzer {
 
   ~PirStreamAnalyzer() {}
 
+  // Place the independent GPU kernels of the block on up to
+  // config.num_compute_streams streams by setting their 'execution_stream'
+  // attribute. It must be called before the instructions are built.
+  void AssignComputeStreams(::pir::Block* block,
+                            const ExecutionConfig& config) const;
+
   void ConstructEvents(
       const std::vector<std::unique_ptr<paddle::framework::InstructionBase>>&
           instructions);
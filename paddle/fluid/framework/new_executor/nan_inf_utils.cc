@@ -21,16 +21,50 @@
 #include "paddle/phi/core/compat/convert_utils.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
+#include "paddle/phi/core/memory/malloc.h"
 #include "paddle/phi/core/selected_rows.h"
+#include "paddle/phi/kernels/check_numerics_kernel.h"
 
 namespace paddle {
 namespace framework {
 
 static std::once_flag pir_white_list_init_flag;
 
-void CheckTensorHasNanOrInf(InstructionBase* instruction,
-                            const paddle::framework::Scope* scope,
-                            ValueExecutionInfo* value_exe_info) {
+namespace {
+
+template <typename Context>
+struct NanInfFlagVisitor {
+  NanInfFlagVisitor(const phi::DeviceContext& c,
+                    const phi::DenseTensor& t,
+                    int* f)
+      : ctx(c), tensor(t), flag(f) {}
+
+  template <typename T>
+  void apply(
+      typename std::enable_if<std::is_integral<T>::value>::type* = 0) const {}
+
+  template <typename T>
+  void apply(typename std::enable_if<
+                 std::is_floating_point<T>::value ||
+                 std::is_same<T, ::phi::dtype::complex<float>>::value ||
+                 std::is_same<T, ::phi::dtype::complex<double>>::value>::type* =
+                 0) const {
+    phi::AccumulateNanInfFlag<T, Context>(
+        static_cast<const Context&>(ctx), tensor, flag);
+  }
+
+  const phi::DeviceContext& ctx;
+  const phi::DenseTensor& tensor;
+  int* flag;
+};
+
+// Calls fn(api_name, tensor_name, dense_tensor) for each output of
+// instruction which is not in the white lists of NAN/INF checking.
+template <typename Fn>
+void VisitTensorsToCheck(InstructionBase* instruction,
+                         const paddle::framework::Scope* scope,
+                         ValueExecutionInfo* value_exe_info,
+                         Fn&& fn) {
   std::call_once(pir_white_list_init_flag, details::InitWhiteListFormEnv);
 
   std::string dialect_name = instruction->Operation()
@@ -40,7 +74,6 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
                                  .AsString();
   auto api_name =
       dialect_name.substr(dialect_name.find(".") + 1, dialect_name.size());
-  auto op_name = phi::TransToFluidOpName(api_name);
 
   if (details::op_type_nan_inf_white_list().count(api_name) != 0) {
     return;
@@ -76,23 +109,119 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
                  << tensor_name << " is no need.";
         break;
       }
+      fn(api_name, tensor_name, *dense_tensor);
+    }
+  }
+}
+
+}  // namespace
 
-      auto& place = dense_tensor->place();
-      if (phi::is_gpu_place(place)) {
+void CheckTensorHasNanOrInf(InstructionBase* instruction,
+                            const paddle::framework::Scope* scope,
+                            ValueExecutionInfo* value_exe_info) {
+  VisitTensorsToCheck(
+      instruction,
+      scope,
+      value_exe_info,
+      [](const std::string& api_name,
+         const std::string& tensor_name,
+         const phi::DenseTensor& dense_tensor) {
+        auto& place = dense_tensor.place();
+        if (phi::is_gpu_place(place)) {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
-        paddle::framework::details::tensor_check<phi::GPUContext>(
-            api_name, tensor_name, *dense_tensor, place);
+          paddle::framework::details::tensor_check<phi::GPUContext>(
+              api_name, tensor_name, dense_tensor, place);
 #else
-        PADDLE_THROW(common::errors::PreconditionNotMet(
-            "Tensor[%s] use gpu place. PaddlePaddle must compile with GPU.",
-            tensor_name));
+          PADDLE_THROW(common::errors::PreconditionNotMet(
+              "Tensor[%s] use gpu place. PaddlePaddle must compile with GPU.",
+              tensor_name));
 #endif
-        continue;
-      }
-      paddle::framework::details::tensor_check<phi::CPUContext>(
-          api_name, tensor_name, *dense_tensor, place);
+          return;
+        }
+        paddle::framework::details::tensor_check<phi::CPUContext>(
+            api_name, tensor_name, dense_tensor, place);
+      });
+}
+
+NanInfStepChecker::NanInfStepChecker(const phi::Place& place,
+                                     int64_t sampling_interval)
+    : sampling_interval_(sampling_interval) {
+  PADDLE_ENFORCE_GT(sampling_interval_,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The sampling interval of NAN/INF checking should be "
+                        "greater than 0, but got %d.",
+                        sampling_interval_));
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (phi::is_gpu_place(place)) {
+    // pinned host memory is mapped into the address space of the device
+    flag_holder_ = memory::Alloc(phi::GPUPinnedPlace(), sizeof(int));
+  }
+#endif
+  if (!flag_holder_) {
+    flag_holder_ = memory::Alloc(phi::CPUPlace(), sizeof(int));
+  }
+  flag_ = reinterpret_cast<int*>(flag_holder_->ptr());
+  *flag_ = 0;
+}
+
+void NanInfStepChecker::BeginStep() {
+  volatile int* flag = flag_;
+  if (*flag != 0) {
+    *flag = 0;
+    if (!full_check_) {
+      LOG(WARNING) << "NAN/INF is found in the outputs of step " << step_
+                   << " or the step before it, check the outputs of each "
+                      "operator from now on to locate it.";
+      full_check_ = true;
     }
   }
+  is_sampled_step_ = (step_ % sampling_interval_) == 0;
+  ++step_;
+}
+
+void NanInfStepChecker::Check(InstructionBase* instruction,
+                              const paddle::framework::Scope* scope,
+                              ValueExecutionInfo* value_exe_info) {
+  if (full_check_) {
+    CheckTensorHasNanOrInf(instruction, scope, value_exe_info);
+    return;
+  }
+  if (!is_sampled_step_) {
+    return;
+  }
+  VisitTensorsToCheck(
+      instruction,
+      scope,
+      value_exe_info,
+      [&](const std::string& api_name,
+          const std::string& tensor_name,
+          const phi::DenseTensor& dense_tensor) {
+        auto& place = dense_tensor.place();
+        auto data_type = framework::TransToProtoVarType(dense_tensor.dtype());
+        if (phi::is_gpu_place(place)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+          // launch on the stream of the instruction, which wrote the tensor
+          const phi::DeviceContext* ctx = &instruction->DeviceContext();
+          if (ctx->GetPlace() != place) {
+            ctx = phi::DeviceContextPool::Instance().Get(place);
+          }
+          NanInfFlagVisitor<phi::GPUContext> visitor(
+              *ctx, dense_tensor, flag_);
+          framework::VisitDataType(data_type, visitor);
+#else
+          PADDLE_THROW(common::errors::PreconditionNotMet(
+              "Tensor[%s] use gpu place. PaddlePaddle must compile with GPU.",
+              tensor_name));
+#endif
+          return;
+        }
+        NanInfFlagVisitor<phi::CPUContext> visitor(
+            *phi::DeviceContextPool::Instance().Get(phi::CPUPlace()),
+            dense_tensor,
+            flag_);
+        framework::VisitDataType(data_type, visitor);
+      });
 }
 
 }  // namespace framework
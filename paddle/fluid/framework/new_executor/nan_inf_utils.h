@@ -14,9 +14,12 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "paddle/fluid/framework/new_executor/instruction/instruction_base.h"
 #include "paddle/fluid/framework/new_executor/new_executor_defs.h"
 #include "paddle/fluid/framework/new_executor/pir_adaptor/pir_adaptor_util.h"
+#include "paddle/phi/core/allocator.h"
 
 namespace paddle {
 namespace framework {
@@ -25,5 +28,33 @@ void CheckTensorHasNanOrInf(InstructionBase* instruction,
                             const paddle::framework::Scope* scope,
                             ValueExecutionInfo* value_exe_info);
 
+// Low overhead NAN/INF checking, see FLAGS_check_nan_inf_sampling_interval.
+// Instead of checking the outputs of each instruction one by one with a
+// host synchronization, the outputs of all instructions of a sampled step are
+// reduced on the device into one word of pinned host memory. The word is
+// read once at the beginning of the next step without synchronizing the
+// device, so a NAN/INF may be reported one step late. Once a NAN/INF is
+// found, the following steps fall back to CheckTensorHasNanOrInf to locate
+// the operator.
+class NanInfStepChecker {
+ public:
+  NanInfStepChecker(const phi::Place& place, int64_t sampling_interval);
+
+  void BeginStep();
+
+  void Check(InstructionBase* instruction,
+             const paddle::framework::Scope* scope,
+             ValueExecutionInfo* value_exe_info);
+
+ private:
+  int64_t sampling_interval_;
+  int64_t step_{0};
+  bool is_sampled_step_{false};
+  bool full_check_{false};
+
+  phi::Allocator::AllocationPtr flag_holder_;
+  int* flag_{nullptr};
+};
+
 }  // namespace framework
 }  // namespace paddle
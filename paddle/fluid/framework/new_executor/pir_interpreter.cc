@@ -14,16 +14,20 @@
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 
+#include <algorithm>
 #include <chrono>
 #include <unordered_set>
 
 #include "paddle/common/flags.h"
 
 #include "paddle/fluid/framework/details/nan_inf_utils.h"
+#include "paddle/fluid/framework/new_executor/executor_statistics.h"
 #include "paddle/fluid/framework/new_executor/interpreter/interpreter_util.h"
+#include "paddle/fluid/framework/new_executor/interpreter/memory_plan.h"
 #include "paddle/fluid/framework/new_executor/interpreter/static_build.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/platform/profiler/supplement_tracing.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/kernel_context.h"
 #include "paddle/phi/core/os_info.h"
@@ -82,13 +86,19 @@
 COMMON_DECLARE_bool(dynamic_static_unified_comm);
 #endif
 #include "paddle/fluid/framework/new_executor/collect_shape_manager.h"
+#include "paddle/fluid/framework/new_executor/instruction_statistics.h"
 #include "paddle/fluid/framework/new_executor/nan_inf_utils.h"
 
 COMMON_DECLARE_bool(enable_pir_in_executor);
 COMMON_DECLARE_bool(enable_pir_in_executor_trace_run);
+COMMON_DECLARE_bool(pir_interpreter_static_trace_replay);
+COMMON_DECLARE_bool(pir_interpreter_static_memory_plan);
+COMMON_DECLARE_bool(pir_interpreter_cache_infer_meta);
 COMMON_DECLARE_bool(enable_collect_shape);
 COMMON_DECLARE_int32(low_precision_op_list);
+COMMON_DECLARE_int32(check_nan_inf_sampling_interval);
 COMMON_DECLARE_bool(pir_interpreter_record_stream_for_gc_cache);
+COMMON_DECLARE_int32(new_executor_steal_group_size);
 
 #define CREATE_INSTR(instr_name)                                   \
   vec_instruction_base_.emplace_back(std::make_unique<instr_name>( \
@@ -188,6 +198,7 @@ PirInterpreter::PirInterpreter(const phi::Place& place,
   var_scope_.SetLocalScope(local_scope_);
 
   execution_config_.AnalyzeThreadPoolConfig(place, 1);
+  execution_config_.AnalyzeStreamConfig(place);
   execution_config_.Log(/*log_level=*/8);
 
   ir_instruction_scheduling_priority_less = [this](size_t lhs, size_t rhs) {
@@ -279,6 +290,7 @@ PirInterpreter::PirInterpreter(
   var_scope_.SetLocalScope(local_scope_);
 
   execution_config_.AnalyzeThreadPoolConfig(place, 1);
+  execution_config_.AnalyzeStreamConfig(place);
   execution_config_.Log(/*log_level=*/8);
 
   ir_instruction_scheduling_priority_less = [this](size_t lhs, size_t rhs) {
@@ -805,6 +817,10 @@ void PirInterpreter::AnalyzeForceSyncOps() {
 void PirInterpreter::BuildInstruction() {
   VLOG(6) << "Build Instructions for pir ... ";
   vec_instruction_base_.clear();
+  // The sub blocks of control flow ops run on the streams of their parents.
+  if (!execution_config_.used_for_control_flow_op) {
+    ir_stream_analyzer_.AssignComputeStreams(ir_block_, execution_config_);
+  }
   size_t op_idx = 0;
   for (auto& op : *ir_block_) {
     VLOG(6) << "Build Instruction for op: " << op_idx;
@@ -930,6 +946,11 @@ void PirInterpreter::BuildInstruction() {
         CREATE_INSTR(LegacyKernelInstruction);
       } else {
         CREATE_INSTR(PhiKernelInstruction);
+        if (FLAGS_pir_interpreter_cache_infer_meta ||
+            execution_config_.used_for_inference) {
+          static_cast<PhiKernelInstruction*>(vec_instruction_base_.back().get())
+              ->EnableInferMetaCache();
+        }
       }
 #ifdef PADDLE_WITH_DNNL
     } else if (op.dialect()->name() == "onednn_kernel") {
@@ -1305,6 +1326,20 @@ void PirInterpreter::CheckGC(InstructionBase* instr) {
   RecordStreamForGC(instr);
 #endif
 
+  if (in_replay_run_) {
+    for (auto var_id : replay_gc_var_ids_[instr->Id()]) {
+      if (UNLIKELY(collect_memory_plan_)) {
+        CollectMemoryPlanCandidate(var_id);
+      }
+      gc_->Add(refs_[var_id]->Var(), instr);
+    }
+    for (auto var : instr->EagerGCVars()) {
+      gc_->Add(var, instr);
+    }
+    instr->ClearEagerGCVars();
+    return;
+  }
+
   for (auto var_id : instr->GCCheckVars()) {
     VLOG(4) << "GC:" << value_exe_info_->GetNameById(static_cast<int>(var_id))
             << ", id:" << var_id << ", ref:" << refs_[var_id]->DynamicRef();
@@ -1503,8 +1538,10 @@ paddle::framework::FetchList PirInterpreter::Run(
 #endif
 
   FeedInput();
+  BeginNanInfCheckStep();
 
   if (!is_build_ || switch_stream) {
+    replay_plan_built_ = false;
     LOG_FIRST_N(INFO, 1) << "New Executor is Running ...";
     VLOG(4) << DebugValueInfo();
 
@@ -1536,7 +1573,9 @@ paddle::framework::FetchList PirInterpreter::Run(
     is_build_ = true;
     is_shared_results_build_ = true;
   } else {
-    if (UseTraceRun(execution_config_, onednn_op_num_, sync_op_num_)) {
+    if (FLAGS_pir_interpreter_static_trace_replay) {
+      ReplayRunImpl();
+    } else if (UseTraceRun(execution_config_, onednn_op_num_, sync_op_num_)) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
@@ -1582,7 +1621,10 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
   platform::RegisterModelLayout(ir_block_, place_);
 #endif
 
+  BeginNanInfCheckStep();
+
   if (!is_build_ || switch_stream) {
+    replay_plan_built_ = false;
     LOG_FIRST_N(INFO, 1) << "New Executor is Running ...";
     VLOG(4) << DebugValueInfo();
 
@@ -1615,7 +1657,9 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
     is_build_ = true;
     is_shared_results_build_ = true;
   } else {
-    if (UseTraceRun(execution_config_, onednn_op_num_, sync_op_num_)) {
+    if (FLAGS_pir_interpreter_static_trace_replay) {
+      ReplayRunImpl();
+    } else if (UseTraceRun(execution_config_, onednn_op_num_, sync_op_num_)) {
       TraceRunImpl();
     } else {
       MultiThreadRunImpl();
@@ -1642,6 +1686,17 @@ FetchList PirInterpreter::Run(const std::vector<std::string>& feed_names,
   return fetch_res;
 }
 
+void PirInterpreter::BeginNanInfCheckStep() {
+  if (!FLAGS_check_nan_inf || FLAGS_check_nan_inf_sampling_interval <= 0) {
+    return;
+  }
+  if (!nan_inf_checker_) {
+    nan_inf_checker_ = std::make_unique<NanInfStepChecker>(
+        place_, FLAGS_check_nan_inf_sampling_interval);
+  }
+  nan_inf_checker_->BeginStep();
+}
+
 void PirInterpreter::TraceRunImpl() {
   // lazy initialization of gc, do not create gc is the program only run once
   if (!gc_) {
@@ -1660,6 +1715,194 @@ void PirInterpreter::TraceRunImpl() {
 #endif
 }
 
+void PirInterpreter::BuildReplayPlan() {
+  VLOG(4) << "Build static trace replay plan";
+  replay_memcpy_d2h_instrs_.clear();
+  for (size_t i = 0; i < dependency_count_->size(); ++i) {
+    if ((*dependency_count_)[i] == 0 &&
+        vec_instruction_base_[i]->Name() == "pd_op.memcpy_d2h") {
+      replay_memcpy_d2h_instrs_.push_back(i);
+    }
+  }
+
+  // Simulate VarRefInfo::CheckAndDecrease along the trace order once, so that
+  // replay releases exactly the variables the reference counting would.
+  // Dynamic refs equal the static refs here since every run resets them.
+  std::vector<size_t> remaining_refs(refs_.size());
+  for (size_t var_id = 0; var_id < refs_.size(); ++var_id) {
+    remaining_refs[var_id] = refs_[var_id]->DynamicRef();
+  }
+  replay_gc_var_ids_.assign(vec_instruction_base_.size(), {});
+  for (size_t instr_id : trace_execute_order_) {
+    InstructionBase* instr = vec_instruction_base_[instr_id].get();
+    for (auto var_id : instr->GCCheckVars()) {
+      bool is_ready =
+          remaining_refs[var_id] == 1 || --remaining_refs[var_id] == 0;
+      if (is_ready && !parameter_var_names_.count(value_exe_info_->GetNameById(
+                          static_cast<int>(var_id)))) {
+        replay_gc_var_ids_[instr_id].push_back(var_id);
+      }
+    }
+  }
+  replay_plan_built_ = true;
+
+  memory_plan_bindings_.clear();
+  memory_plan_buffer_.reset();
+  memory_plan_candidate_bytes_.clear();
+  // Reusing memory by offsets is only ordered on a single stream.
+  collect_memory_plan_ = FLAGS_pir_interpreter_static_memory_plan &&
+                         !vec_instruction_base_.empty();
+  for (size_t i = 1; collect_memory_plan_ && i < vec_instruction_base_.size();
+       ++i) {
+    if (&vec_instruction_base_[i]->DeviceContext() !=
+        &vec_instruction_base_[0]->DeviceContext()) {
+      VLOG(4) << "Skip static memory plan for multi-stream program";
+      collect_memory_plan_ = false;
+      break;
+    }
+  }
+}
+
+void PirInterpreter::CollectMemoryPlanCandidate(size_t var_id) {
+  Variable* var = refs_[var_id]->Var();
+  if (!var->IsType<phi::DenseTensor>()) {
+    return;
+  }
+  const auto& holder = var->Get<phi::DenseTensor>().Holder();
+  // The memory shared with other variables, e.g. by inplace or view kernels,
+  // lives longer than this variable, so it is left to the allocator.
+  if (holder == nullptr || holder.use_count() != 1 || holder->size() == 0 ||
+      holder->place() != place_) {
+    return;
+  }
+  memory_plan_candidate_bytes_[var_id] = holder->size();
+}
+
+void PirInterpreter::BuildMemoryPlan() {
+  std::vector<size_t> position(vec_instruction_base_.size());
+  for (size_t i = 0; i < trace_execute_order_.size(); ++i) {
+    position[trace_execute_order_[i]] = i;
+  }
+  // A variable lives from the first instruction writing it to the
+  // instruction releasing it.
+  std::unordered_map<size_t, size_t> begin;
+  for (size_t i = 0; i < trace_execute_order_.size(); ++i) {
+    auto& instr = vec_instruction_base_[trace_execute_order_[i]];
+    for (auto& item : instr->Outputs()) {
+      for (int var_id : item.second) {
+        begin.emplace(var_id, i);
+      }
+    }
+  }
+
+  std::vector<size_t> var_ids;
+  std::vector<interpreter::TensorLifetime> lifetimes;
+  size_t total_bytes = 0;
+  for (size_t instr_id = 0; instr_id < replay_gc_var_ids_.size(); ++instr_id) {
+    for (auto var_id : replay_gc_var_ids_[instr_id]) {
+      auto bytes_iter = memory_plan_candidate_bytes_.find(var_id);
+      auto begin_iter = begin.find(var_id);
+      if (bytes_iter == memory_plan_candidate_bytes_.end() ||
+          begin_iter == begin.end() ||
+          begin_iter->second > position[instr_id]) {
+        continue;
+      }
+      var_ids.push_back(var_id);
+      lifetimes.push_back(
+          {begin_iter->second, position[instr_id], bytes_iter->second});
+      total_bytes += bytes_iter->second;
+    }
+  }
+  memory_plan_candidate_bytes_.clear();
+  if (var_ids.empty()) {
+    return;
+  }
+
+  constexpr size_t kAlignment = 256;
+  std::vector<size_t> offsets;
+  size_t buffer_bytes =
+      interpreter::PlanTensorOffsets(lifetimes, kAlignment, &offsets);
+  memory_plan_buffer_ = phi::memory_utils::AllocShared(place_, buffer_bytes);
+  std::unordered_set<size_t> planned;
+  for (size_t i = 0; i < var_ids.size(); ++i) {
+    memory_plan_bindings_.emplace_back(
+        refs_[var_ids[i]]->Var(),
+        std::make_shared<interpreter::PlannedAllocation>(
+            memory_plan_buffer_, offsets[i], lifetimes[i].size));
+    planned.insert(var_ids[i]);
+  }
+  // The planned variables keep their memory between runs.
+  for (auto& gc_var_ids : replay_gc_var_ids_) {
+    gc_var_ids.erase(
+        std::remove_if(gc_var_ids.begin(),
+                       gc_var_ids.end(),
+                       [&](size_t id) { return planned.count(id) != 0; }),
+        gc_var_ids.end());
+  }
+  VLOG(1) << "Static memory plan of " << planned.size() << " variables: "
+          << buffer_bytes << " bytes in one buffer, " << total_bytes
+          << " bytes without reuse";
+}
+
+void PirInterpreter::BindMemoryPlan() {
+  for (auto& item : memory_plan_bindings_) {
+    auto* tensor = item.first->GetMutable<phi::DenseTensor>();
+    // A larger shape than planned, or an inplace kernel, replaces the holder
+    // during the run.
+    if (tensor->Holder() != item.second) {
+      tensor->MoveMemoryHolder();
+      tensor->ResetHolder(item.second);
+    }
+  }
+}
+
+void PirInterpreter::ReplayRunImpl() {
+  if (!gc_) {
+    gc_ = CreateInterpreterCoreGarbageCollector(place_, vec_instruction_base_);
+  }
+  if (!replay_plan_built_) {
+    BuildReplayPlan();
+  }
+  VLOG(4) << "Replay Instruction List";
+
+  exception_holder_.Clear();
+  for (size_t instr_id : replay_memcpy_d2h_instrs_) {
+    RecordMemcpyD2H(vec_instruction_base_[instr_id].get());
+  }
+
+  BindMemoryPlan();
+
+  // NOTE: deps_ and refs_ are not touched during replay, so there is nothing
+  // to reset afterwards, even if an exception is caught.
+  in_replay_run_ = true;
+  for (size_t instr_id : trace_execute_order_) {
+    RunInstructionBase(vec_instruction_base_[instr_id].get());
+    if (UNLIKELY(exception_holder_.IsCaught())) {
+      VLOG(4) << "Exception caught";
+      break;
+    }
+  }
+  in_replay_run_ = false;
+
+  if (collect_memory_plan_) {
+    collect_memory_plan_ = false;
+    if (!exception_holder_.IsCaught()) {
+      BuildMemoryPlan();
+    }
+  }
+
+  if (UNLIKELY(exception_holder_.IsCaught())) {
+    VLOG(1) << "Exception caught " << exception_holder_.Type();
+    exception_holder_.ReThrow();
+  }
+  VLOG(4) << "Done ReplayRunImpl";
+#ifdef PADDLE_WITH_CUSTOM_DEVICE
+  if (phi::is_custom_place(place_)) {
+    phi::DeviceContextPool::Instance().Get(place_)->Wait();
+  }
+#endif
+}
+
 void PirInterpreter::MultiThreadRunImpl() {
   // lazy initialization of gc, do not create gc is the program only run once
   if (!gc_) {
@@ -1670,8 +1913,21 @@ void PirInterpreter::MultiThreadRunImpl() {
   VLOG(4) << "Multi Thread Run Instruction List";
 
   async_work_queue_ = GetWorkQueue();
+  WorkQueueStats stats_before_run = async_work_queue_->Stats();
   MultiThreadRunInstructionList(vec_instruction_base_);
   VLOG(4) << "Done MultiThreadRunInstructionList";
+  if (async_work_queue_) {
+    WorkQueueStats stats_after_run = async_work_queue_->Stats();
+    last_run_workqueue_stats_.local_tasks =
+        stats_after_run.local_tasks - stats_before_run.local_tasks;
+    last_run_workqueue_stats_.stolen_tasks =
+        stats_after_run.stolen_tasks - stats_before_run.stolen_tasks;
+    VLOG(4) << "WorkQueue tasks run locally: "
+            << last_run_workqueue_stats_.local_tasks
+            << ", stolen: " << last_run_workqueue_stats_.stolen_tasks;
+    RecordWorkQueueTaskStatistics(last_run_workqueue_stats_.local_tasks,
+                                  last_run_workqueue_stats_.stolen_tasks);
+  }
 #ifdef PADDLE_WITH_CUSTOM_DEVICE
   if (phi::is_custom_place(place_)) {
     phi::DeviceContextPool::Instance().Get(place_)->Wait();
@@ -1876,17 +2132,32 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
     return deps_[next_id]->CheckAndDecrease();
   };
 
-  for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
+  for (size_t next_instr_id : instr->NextInstrsInSameThread()) {
     if (IsReady(next_instr_id)) {
-      async_work_queue_->AddTask(
-          vec_instruction_base_[next_instr_id]->KernelType(),
-          [this, next_instr_id]() { RunInstructionBaseAsync(next_instr_id); });
+      reserved_next_ops->push(next_instr_id);
     }
   }
 
-  for (size_t next_instr_id : instr->NextInstrsInSameThread()) {
+  // With locality-aware scheduling, the current thread keeps one ready
+  // successor that would be dispatched to its own queue anyway if it has
+  // nothing else to run, instead of exposing it to stealing.
+  bool keep_successor = FLAGS_new_executor_steal_group_size > 0 &&
+                        reserved_next_ops->empty();
+  auto SameQueue = [instr](const InstructionBase* next) {
+    return (instr->KernelType() == OpFuncType::kGpuAsync) ==
+           (next->KernelType() == OpFuncType::kGpuAsync);
+  };
+  for (size_t next_instr_id : instr->NextInstrsInDifferenceThread()) {
     if (IsReady(next_instr_id)) {
-      reserved_next_ops->push(next_instr_id);
+      auto* next_instr = vec_instruction_base_[next_instr_id].get();
+      if (keep_successor && SameQueue(next_instr)) {
+        reserved_next_ops->push(next_instr_id);
+        keep_successor = false;
+        continue;
+      }
+      async_work_queue_->AddTask(
+          next_instr->KernelType(),
+          [this, next_instr_id]() { RunInstructionBaseAsync(next_instr_id); });
     }
   }
 }
@@ -1894,6 +2165,7 @@ void PirInterpreter::RunNextInstructions(InstructionBase* instr,
 void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
   phi::RecordEvent instruction_event(
       instr_node->Name(), phi::TracerEventType::Operator, 1);
+  InstructionDispatchTimer dispatch_timer(instr_node);
 
   auto cur_place = instr_node->DeviceContext().GetPlace();
   SetDeviceId(cur_place);
@@ -1952,7 +2224,12 @@ void PirInterpreter::RunInstructionBase(InstructionBase* instr_node) {
 #endif
       }
       if (FLAGS_check_nan_inf) {
-        CheckTensorHasNanOrInf(instr_node, scope_, value_exe_info_.get());
+        if (nan_inf_checker_ &&
+            FLAGS_check_nan_inf_sampling_interval > 0) {
+          nan_inf_checker_->Check(instr_node, scope_, value_exe_info_.get());
+        } else {
+          CheckTensorHasNanOrInf(instr_node, scope_, value_exe_info_.get());
+        }
       }
       VLOG(2) << "\ndone: " << __func__ << " OP id:" << instr_node->Id()
               << " name:" << instr_node->Name() << " type:"
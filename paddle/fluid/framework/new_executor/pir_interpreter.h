@@ -29,6 +29,7 @@ class Block;
 namespace paddle {
 namespace framework {
 class ValueExecutionInfo;
+class NanInfStepChecker;
 class PirInterpreter : public InterpreterBaseImpl {
   using ExecutionConfig = interpreter::ExecutionConfig;
   using InstructionSchedulingPriorityLess = std::function<bool(size_t, size_t)>;
@@ -140,6 +141,9 @@ class PirInterpreter : public InterpreterBaseImpl {
   // gc
   void ClearLoDTensorArrayInLocalScope();
 
+  // nan/inf check
+  void BeginNanInfCheckStep();
+
   // cuda graph
   void CheckCUDAGraphBeforeRun(const std::vector<std::string>& feed_names);
   void PrepareForCUDAGraphCapture();
@@ -209,6 +213,9 @@ class PirInterpreter : public InterpreterBaseImpl {
   std::vector<PirHookFunc> pir_output_hookfuncs_;
   std::vector<PirHookFunc> pir_input_hookfuncs_;
 
+  // see FLAGS_check_nan_inf_sampling_interval
+  std::unique_ptr<NanInfStepChecker> nan_inf_checker_;
+
   /// ======================== ///
   ///        For new ir        ///
   /// ======================== ///
@@ -233,6 +240,19 @@ class PirInterpreter : public InterpreterBaseImpl {
 
   void MultiThreadRunImpl();
 
+  // static trace replay, see FLAGS_pir_interpreter_static_trace_replay
+  void BuildReplayPlan();
+
+  void ReplayRunImpl();
+
+  // static memory plan on top of static trace replay, see
+  // FLAGS_pir_interpreter_static_memory_plan
+  void CollectMemoryPlanCandidate(size_t var_id);
+
+  void BuildMemoryPlan();
+
+  void BindMemoryPlan();
+
   void MultiThreadRunInstructionList(
       const std::vector<std::unique_ptr<InstructionBase>>& vec_instr);
 
@@ -285,6 +305,26 @@ class PirInterpreter : public InterpreterBaseImpl {
 #endif
   size_t last_calculate_instr_id_;
   bool enable_job_schedule_profiler_;
+
+  // Flat execution plan for static trace replay. replay_gc_var_ids_[i] holds
+  // the variables released right after the i-th instruction.
+  bool replay_plan_built_{false};
+  bool in_replay_run_{false};
+  std::vector<size_t> replay_memcpy_d2h_instrs_;
+  std::vector<std::vector<size_t>> replay_gc_var_ids_;
+
+  // Static memory plan. The first replay run records the bytes of the
+  // variables it releases, then these variables are given fixed offsets in
+  // memory_plan_buffer_ and are no longer released by replay.
+  bool collect_memory_plan_{false};
+  std::unordered_map<size_t, size_t> memory_plan_candidate_bytes_;
+  std::shared_ptr<phi::Allocation> memory_plan_buffer_;
+  std::vector<std::pair<Variable*, std::shared_ptr<phi::Allocation>>>
+      memory_plan_bindings_;
+
+  // Locally run vs. stolen instructions of the last multi-thread run, see
+  // FLAGS_new_executor_steal_group_size.
+  WorkQueueStats last_run_workqueue_stats_;
 };
 
 }  // namespace framework
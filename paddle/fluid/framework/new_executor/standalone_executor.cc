@@ -12,6 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include "paddle/fluid/framework/new_executor/standalone_executor.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
 #include "paddle/common/flags.h"
 #include "paddle/fluid/framework/feed_hook.h"
 #include "paddle/fluid/framework/new_executor/feed_fetch_utils.h"
@@ -24,6 +31,7 @@
 
 #include "paddle/fluid/ir_adaptor/translator/translate.h"
 #include "paddle/fluid/pir/transforms/general/inplace_pass.h"
+#include "paddle/pir/include/core/builtin_op.h"
 #include "paddle/pir/include/core/program.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_manager.h"
@@ -31,6 +39,7 @@
 COMMON_DECLARE_bool(enable_pir_in_executor);
 COMMON_DECLARE_bool(enable_pir_api);
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
+COMMON_DECLARE_bool(new_executor_job_overlap);
 
 namespace paddle::framework {
 StandaloneExecutor::StandaloneExecutor(const phi::Place& place,
@@ -166,6 +175,11 @@ StandaloneExecutor::StandaloneExecutor(const phi::Place& place,
       }
     }
   }
+
+  if (FLAGS_enable_pir_in_executor && FLAGS_new_executor_job_overlap &&
+      jobs.size() > 1) {
+    BuildJobDependencies();
+  }
 }
 
 paddle::framework::FetchList StandaloneExecutor::Run(
@@ -197,7 +211,7 @@ paddle::framework::FetchList StandaloneExecutor::Run(
   }
 
   fetch_list_.resize(plan_.MicroBatchNum());
-  for (size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
+  auto run_job = [&](size_t job_idx) {
     const auto& job = jobs[job_idx];
     const std::string& job_type = job->Type();
     phi::RecordEvent record_event(
@@ -241,6 +255,14 @@ paddle::framework::FetchList StandaloneExecutor::Run(
                                         enable_job_schedule_profiler);
       }
     }
+  };
+
+  if (job_upstreams_.empty()) {
+    for (size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
+      run_job(job_idx);
+    }
+  } else {
+    RunJobsWithOverlap(run_job);
   }
 
   // record each job's run time
@@ -282,6 +304,184 @@ paddle::framework::FetchList StandaloneExecutor::Run(
   }
 }
 
+namespace {
+
+struct JobEffects {
+  std::unordered_set<std::string> reads;
+  std::unordered_set<std::string> writes;
+  bool has_communication{false};
+};
+
+// The op names of inplace ops end with '_', e.g. pd_op.adamw_.
+bool IsInplaceUser(const ::pir::Operation* op) {
+  std::string op_name = op->name();
+  if (op->HasAttribute("op_name")) {
+    op_name = op->attribute<::pir::StrAttribute>("op_name").AsString();
+  }
+  return !op_name.empty() && op_name.back() == '_';
+}
+
+void CollectJobEffects(const ::pir::Block& block, JobEffects* effects) {
+  for (const auto& op : block) {
+    if (interpreter::IsCommunicationOp(&op)) {
+      effects->has_communication = true;
+    }
+    if (op.isa<::pir::ParameterOp>()) {
+      const std::string& name =
+          op.attribute<::pir::StrAttribute>("parameter_name").AsString();
+      effects->reads.insert(name);
+      for (auto it = op.result(0).use_begin(); it != op.result(0).use_end();
+           ++it) {
+        if (IsInplaceUser(it.owner())) {
+          effects->writes.insert(name);
+        }
+      }
+    } else if (op.isa<::pir::SetParameterOp>()) {
+      effects->writes.insert(
+          op.attribute<::pir::StrAttribute>("parameter_name").AsString());
+    } else if (op.isa<::pir::ShadowOutputOp>()) {
+      effects->writes.insert(
+          op.attribute<::pir::StrAttribute>("output_name").AsString());
+    }
+    for (size_t i = 0; i < op.num_regions(); ++i) {
+      for (const auto& inner_block : op.region(i)) {
+        CollectJobEffects(inner_block, effects);
+      }
+    }
+  }
+}
+
+bool Intersects(const std::unordered_set<std::string>& lhs,
+                const std::unordered_set<std::string>& rhs) {
+  for (const auto& name : lhs) {
+    if (rhs.count(name)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+void StandaloneExecutor::BuildJobDependencies() {
+  // A job depends on an earlier job if:
+  // 1. they run the same micro-batch, which shares the micro-batch scope;
+  // 2. both of them communicate, so that the collective calls keep the same
+  //    order on all ranks;
+  // 3. one of them writes a variable of the outer scope, e.g. a parameter or
+  //    an accumulated gradient, that the other one reads or writes.
+  const auto& jobs = plan_.JobList();
+  std::vector<JobEffects> effects(jobs.size());
+  for (size_t job_idx = 0; job_idx < jobs.size(); ++job_idx) {
+    auto program = plan_.IrProgram("job_" + std::to_string(job_idx));
+    CollectJobEffects(*program->block(), &effects[job_idx]);
+    // only the variables of the outer scope are shared by micro-batches
+    for (auto* names : {&effects[job_idx].reads, &effects[job_idx].writes}) {
+      for (auto it = names->begin(); it != names->end();) {
+        it = scope_->FindLocalVar(*it) ? std::next(it) : names->erase(it);
+      }
+    }
+  }
+
+  job_upstreams_.assign(jobs.size(), {});
+  for (size_t i = 1; i < jobs.size(); ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (jobs[j]->MicroBatchId() == jobs[i]->MicroBatchId() ||
+          (effects[j].has_communication && effects[i].has_communication) ||
+          Intersects(effects[j].writes, effects[i].reads) ||
+          Intersects(effects[j].writes, effects[i].writes) ||
+          Intersects(effects[j].reads, effects[i].writes)) {
+        job_upstreams_[i].push_back(j);
+      }
+    }
+  }
+
+  if (VLOG_IS_ON(4)) {
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      std::stringstream ss;
+      for (size_t upstream : job_upstreams_[i]) {
+        ss << upstream << " ";
+      }
+      VLOG(4) << "Job (" << i << "), type = " << jobs[i]->Type()
+              << ", micro_batch_id = " << jobs[i]->MicroBatchId()
+              << ", upstream jobs = [ " << ss.str() << "]";
+    }
+  }
+}
+
+void StandaloneExecutor::RunJobsWithOverlap(
+    const std::function<void(size_t)>& run_job) {
+  const size_t job_num = job_upstreams_.size();
+  std::vector<size_t> num_pending_upstreams(job_num);
+  std::vector<std::vector<size_t>> downstreams(job_num);
+  for (size_t i = 0; i < job_num; ++i) {
+    num_pending_upstreams[i] = job_upstreams_[i].size();
+    for (size_t upstream : job_upstreams_[i]) {
+      downstreams[upstream].push_back(i);
+    }
+  }
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<size_t> finished_jobs;
+  std::exception_ptr exception = nullptr;
+  std::vector<std::thread> threads;
+  threads.reserve(job_num);
+
+  auto launch = [&](size_t job_idx) {
+    threads.emplace_back([&, job_idx]() {
+      std::exception_ptr job_exception = nullptr;
+      try {
+        run_job(job_idx);
+      } catch (...) {
+        job_exception = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (job_exception && !exception) {
+          exception = job_exception;
+        }
+        finished_jobs.push_back(job_idx);
+      }
+      cv.notify_one();
+    });
+  };
+
+  for (size_t i = 0; i < job_num; ++i) {
+    if (num_pending_upstreams[i] == 0) {
+      launch(i);
+    }
+  }
+  size_t num_finished = 0;
+  while (num_finished < threads.size()) {
+    size_t job_idx = 0;
+    bool failed = false;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return !finished_jobs.empty(); });
+      job_idx = finished_jobs.front();
+      finished_jobs.pop_front();
+      failed = exception != nullptr;
+    }
+    ++num_finished;
+    // stop launching the remaining jobs once a job fails
+    if (failed) {
+      continue;
+    }
+    for (size_t downstream : downstreams[job_idx]) {
+      if (--num_pending_upstreams[downstream] == 0) {
+        launch(downstream);
+      }
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+}
+
 std::shared_ptr<framework::ProgramDesc> StandaloneExecutor::RunProfile(
     const std::vector<std::string>& feed_names) {
   phi::RecordEvent record_event(
@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include <functional>
 #include <map>
 #include <string>
 #include <unordered_map>
@@ -47,6 +48,11 @@ class StandaloneExecutor {
       const std::vector<std::string>& feed_names);
 
  private:
+  // Build the dependencies between jobs for FLAGS_new_executor_job_overlap.
+  void BuildJobDependencies();
+
+  void RunJobsWithOverlap(const std::function<void(size_t)>& run_job);
+
   bool is_interpretercore_build_result_shared_{false};
   const phi::Place place_;
   interpreter::Plan plan_;
@@ -60,6 +66,10 @@ class StandaloneExecutor {
 
   std::vector<std::unordered_map<std::string, std::shared_ptr<EventInter>>>
       vec_force_events_to_wait_;
+
+  // job_upstreams_[i] are the jobs that must finish before job i starts,
+  // empty if the jobs run one by one.
+  std::vector<std::vector<size_t>> job_upstreams_;
 };
 
 }  // namespace framework
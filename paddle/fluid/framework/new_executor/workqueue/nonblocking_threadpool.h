@@ -9,6 +9,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstdlib>
 #include <vector>
@@ -33,6 +34,7 @@ class ThreadPoolTempl {
                   int num_threads,
                   bool allow_spinning,
                   bool always_spinning,
+                  int steal_group_size = 0,
                   Environment env = Environment())
       : env_(env),
         allow_spinning_(allow_spinning),
@@ -60,6 +62,24 @@ class ThreadPoolTempl {
     }
     for (int i = 0; i < num_threads_; i++) {
       SetStealPartition(i, EncodePartition(0, num_threads_));
+    }
+    // Group adjacent threads into steal partitions of steal_group_size. A
+    // thread first steals inside its own group (threads sharing L2 or the
+    // same NUMA node when the workers are pinned contiguously), then from the
+    // nearest groups, and only then from anywhere in the pool.
+    if (steal_group_size > 0 && steal_group_size < num_threads_) {
+      steal_group_size_ = steal_group_size;
+      std::vector<std::pair<unsigned, unsigned>> partitions;
+      partitions.reserve(num_threads_);
+      for (int i = 0; i < num_threads_; i++) {
+        unsigned start = i / steal_group_size * steal_group_size;
+        unsigned limit = std::min(start + steal_group_size,
+                                  static_cast<unsigned>(num_threads_));
+        partitions.emplace_back(start, limit);
+      }
+      SetStealPartitions(partitions);
+    }
+    for (int i = 0; i < num_threads_; i++) {
       thread_data_[i].thread.reset(
           env_.CreateThread([this, i]() { WorkerLoop(i); }));
     }
@@ -156,6 +176,18 @@ class ThreadPoolTempl {
 
   size_t NumThreads() const { return num_threads_; }
 
+  // Number of tasks popped from the worker's own queue and number of tasks
+  // stolen from other workers' queues, accumulated since construction.
+  void GetTaskStats(uint64_t* local_tasks, uint64_t* stolen_tasks) const {
+    uint64_t local = 0, stolen = 0;
+    for (const auto& data : thread_data_) {
+      local += data.local_tasks.load(std::memory_order_relaxed);
+      stolen += data.stolen_tasks.load(std::memory_order_relaxed);
+    }
+    *local_tasks = local;
+    *stolen_tasks = stolen;
+  }
+
   int CurrentThreadId() const {
     const PerThread* pt = const_cast<ThreadPoolTempl*>(this)->GetPerThread();
     if (pt->pool == this) {
@@ -226,10 +258,18 @@ class ThreadPoolTempl {
   };
 
   struct ThreadData {
-    constexpr ThreadData() : thread(), steal_partition(0), queue() {}
+    constexpr ThreadData()
+        : thread(),
+          steal_partition(0),
+          queue(),
+          local_tasks(0),
+          stolen_tasks(0) {}
     std::unique_ptr<Thread> thread;
     std::atomic<unsigned> steal_partition;
     Queue queue;
+    // Only written by the owner thread, read by GetTaskStats.
+    std::atomic<uint64_t> local_tasks;
+    std::atomic<uint64_t> stolen_tasks;
   };
 
   Environment env_;
@@ -242,9 +282,15 @@ class ThreadPoolTempl {
   std::atomic<bool> cancelled_;
   EventCount ec_;
   const int num_threads_;
+  int steal_group_size_{0};
   std::vector<ThreadData> thread_data_;
   std::string name_;
 
+  inline void CountTask(std::atomic<uint64_t>* counter) {
+    counter->store(counter->load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+
   // Main worker thread loop.
   void WorkerLoop(int thread_id) {
     std::string thr_name = name_ + "_thread_" + std::to_string(thread_id);
@@ -282,14 +328,21 @@ class ThreadPoolTempl {
           }
         }
         if (t.f) {
+          CountTask(&thread_data_[thread_id].local_tasks);
           env_.ExecuteTask(t);
         }
       }
     } else {
+      ThreadData& data = thread_data_[thread_id];
       while (!cancelled_) {
         Task t = q.PopFront();
-        if (!t.f) {
+        if (t.f) {
+          CountTask(&data.local_tasks);
+        } else {
           t = LocalSteal();
+          if (!t.f) {
+            t = NeighborSteal();
+          }
           if (!t.f) {
             t = GlobalSteal();
             if (!t.f) {
@@ -309,6 +362,9 @@ class ThreadPoolTempl {
               }
             }
           }
+          if (t.f) {
+            CountTask(&data.stolen_tasks);
+          }
         }
         if (t.f) {
           env_.ExecuteTask(t);
@@ -359,6 +415,30 @@ class ThreadPoolTempl {
     return Steal(start, limit);
   }
 
+  // Steals work from the other steal groups, nearest group first, so that
+  // work stays close to the cache/NUMA domain it was produced in. Returns an
+  // empty task immediately if the pool is not partitioned.
+  Task NeighborSteal() {
+    if (steal_group_size_ == 0) return Task();
+    PerThread* pt = GetPerThread();
+    const int num_groups =
+        (num_threads_ + steal_group_size_ - 1) / steal_group_size_;
+    const int my_group = pt->thread_id / steal_group_size_;
+    for (int dist = 1; dist < num_groups; ++dist) {
+      for (int group : {my_group + dist, my_group - dist}) {
+        if (group < 0 || group >= num_groups) continue;
+        unsigned start = group * steal_group_size_;
+        unsigned limit = std::min(start + steal_group_size_,
+                                  static_cast<unsigned>(num_threads_));
+        Task t = Steal(start, limit);
+        if (t.f) {
+          return t;
+        }
+      }
+    }
+    return Task();
+  }
+
   // Steals work from any other thread in the pool.
   Task GlobalSteal() { return Steal(0, num_threads_); }
 
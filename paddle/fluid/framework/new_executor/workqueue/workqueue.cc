@@ -46,10 +46,12 @@ class WorkQueueImpl : public WorkQueue {
       destruct_notifier_ =
           options.events_waiter->RegisterEvent(kQueueDestructEvent);
     }
-    queue_ = new NonblockingThreadPool(options_.name,
-                                       static_cast<int>(options_.num_threads),
-                                       options_.allow_spinning,
-                                       options_.always_spinning);
+    queue_ = new NonblockingThreadPool(
+        options_.name,
+        static_cast<int>(options_.num_threads),
+        options_.allow_spinning,
+        options_.always_spinning,
+        static_cast<int>(options_.steal_group_size));
   }
 
   ~WorkQueueImpl() override {
@@ -80,6 +82,12 @@ class WorkQueueImpl : public WorkQueue {
 
   size_t NumThreads() const override { return queue_->NumThreads(); }
 
+  WorkQueueStats Stats() const override {
+    WorkQueueStats stats;
+    queue_->GetTaskStats(&stats.local_tasks, &stats.stolen_tasks);
+    return stats;
+  }
+
  private:
   NonblockingThreadPool* queue_{nullptr};
   TaskTracker* tracker_{nullptr};
@@ -100,6 +108,10 @@ class WorkQueueGroupImpl : public WorkQueueGroup {
 
   size_t QueueGroupNumThreads() const override;
 
+  WorkQueueStats QueueStats(size_t queue_idx) const override;
+
+  WorkQueueStats QueueGroupStats() const override;
+
   void Cancel() override;
 
  private:
@@ -141,7 +153,8 @@ WorkQueueGroupImpl::WorkQueueGroupImpl(
         NonblockingThreadPool(options.name,
                               static_cast<int>(options.num_threads),
                               options.allow_spinning,
-                              options.always_spinning);
+                              options.always_spinning,
+                              static_cast<int>(options.steal_group_size));
   }
 }
 
@@ -192,6 +205,24 @@ size_t WorkQueueGroupImpl::QueueGroupNumThreads() const {
   return total_num;
 }
 
+WorkQueueStats WorkQueueGroupImpl::QueueStats(size_t queue_idx) const {
+  assert(queue_idx < queues_.size());
+  WorkQueueStats stats;
+  if (queues_.at(queue_idx)) {
+    queues_.at(queue_idx)->GetTaskStats(&stats.local_tasks,
+                                        &stats.stolen_tasks);
+  }
+  return stats;
+}
+
+WorkQueueStats WorkQueueGroupImpl::QueueGroupStats() const {
+  WorkQueueStats total;
+  for (size_t idx = 0; idx < queues_.size(); ++idx) {
+    total += QueueStats(idx);
+  }
+  return total;
+}
+
 void WorkQueueGroupImpl::Cancel() {
   for (auto queue : queues_) {
     if (queue) {
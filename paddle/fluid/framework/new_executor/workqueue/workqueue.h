@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <memory>
@@ -102,6 +103,25 @@ struct WorkQueueOptions {
   // false and set events_waiter.
   bool detached{true};
   EventsWaiter* events_waiter{nullptr};  // not owned
+  // If steal_group_size > 0, adjacent worker threads are grouped into steal
+  // partitions of this size. Idle workers steal inside their own group first,
+  // then from the nearest groups. Set it to the number of cores sharing a
+  // cache or NUMA domain to keep short tasks on warm caches.
+  size_t steal_group_size{0};
+};
+
+// Task counters of a WorkQueue, accumulated since the queue was created.
+struct WorkQueueStats {
+  // Tasks executed by the worker that owns the queue they were pushed to.
+  uint64_t local_tasks{0};
+  // Tasks executed after being stolen from another worker's queue.
+  uint64_t stolen_tasks{0};
+
+  WorkQueueStats& operator+=(const WorkQueueStats& other) {
+    local_tasks += other.local_tasks;
+    stolen_tasks += other.stolen_tasks;
+    return *this;
+  }
 };
 
 class WorkQueue {
@@ -136,6 +156,8 @@ class WorkQueue {
 
   virtual size_t NumThreads() const = 0;
 
+  virtual WorkQueueStats Stats() const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -178,6 +200,10 @@ class WorkQueueGroup {
 
   virtual size_t QueueGroupNumThreads() const = 0;
 
+  virtual WorkQueueStats QueueStats(size_t queue_idx) const = 0;
+
+  virtual WorkQueueStats QueueGroupStats() const = 0;
+
   virtual void Cancel() = 0;
 
  protected:
@@ -27,8 +27,32 @@ COMMON_DECLARE_bool(eager_delete_scope);
 #define SCOPE_VARS_WRITER_LOCK phi::AutoWRLock auto_lock(&vars_lock_);
 
 namespace paddle::framework {
+
+VariableArena::VariableArena(size_t block_size) : block_size_(block_size) {
+  PADDLE_ENFORCE_GT(block_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The block size of VariableArena must be positive."));
+}
+
+Variable* VariableArena::New() {
+  size_t block_idx = size_ / block_size_;
+  if (block_idx == blocks_.size()) {
+    blocks_.emplace_back(new Slot[block_size_]);
+  }
+  Slot* slot = &blocks_[block_idx][size_ % block_size_];
+  ++size_;
+  return new (slot) Variable();
+}
+
+void VariableArena::Reset() { size_ = 0; }
+
 Scope::Scope() : vars_(), kids_() {}
-Scope::~Scope() { DropKids(); }  // NOLINT
+Scope::~Scope() {  // NOLINT
+  DropKids();
+  // Destroy the arena variables before the arena itself.
+  vars_.clear();
+}
 
 Scope& Scope::NewScope() const {
   Scope* child = new Scope(this);
@@ -166,14 +190,70 @@ void Scope::DeleteScope(Scope* scope) const {
 void Scope::EraseVars(const std::vector<std::string>& var_names) {
   {
     std::set<std::string> var_set(var_names.begin(), var_names.end());
+    std::unordered_set<Variable*> erased;
     SCOPE_VARS_WRITER_LOCK
     for (auto it = vars_.begin(); it != vars_.end();) {
       if (var_set.find(it->first) != var_set.end()) {
+        erased.insert(it->second.get());
         it = vars_.erase(it);
       } else {
         ++it;
       }
     }
+    EraseVarIndices(erased);
+  }
+}
+
+void Scope::EnableArena(size_t block_size) {
+  SCOPE_VARS_WRITER_LOCK
+  PADDLE_ENFORCE_EQ(
+      arena_,
+      nullptr,
+      common::errors::AlreadyExists("The arena of scope %p is already enabled.",
+                                    this));
+  arena_ = std::make_unique<VariableArena>(block_size);
+}
+
+void Scope::ResetArena() {
+  SCOPE_VARS_WRITER_LOCK
+  vars_.clear();
+  indexed_vars_.clear();
+  if (arena_) {
+    arena_->Reset();
+  }
+}
+
+size_t Scope::VarIndex(const std::string& name) {
+  SCOPE_VARS_WRITER_LOCK
+  Variable* var = VarInternal(name);
+  for (size_t i = 0; i < indexed_vars_.size(); ++i) {
+    if (indexed_vars_[i] == var) {
+      return i;
+    }
+  }
+  indexed_vars_.push_back(var);
+  return indexed_vars_.size() - 1;
+}
+
+Variable* Scope::VarAt(size_t index) const {
+  SCOPE_VARS_READER_LOCK
+  PADDLE_ENFORCE_LT(
+      index,
+      indexed_vars_.size(),
+      common::errors::OutOfRange("The variable index %d is out of range [0, %d)"
+                                 " in scope %p.",
+                                 index,
+                                 indexed_vars_.size(),
+                                 this));
+  return indexed_vars_[index];
+}
+
+void Scope::EraseVarIndices(const std::unordered_set<Variable*>& erased) const {
+  if (erased.empty()) return;
+  for (auto& var : indexed_vars_) {
+    if (erased.count(var)) {
+      var = nullptr;
+    }
   }
 }
 
@@ -197,8 +277,15 @@ std::string Scope::Rename(const std::string& origin_name) const {
 Variable* Scope::VarInternal(const std::string& name) {
   auto* v = FindVarLocally(name);
   if (v != nullptr) return v;
-  v = new Variable();
-  vars_.emplace(name, std::unique_ptr<Variable>(v));
+  if (arena_) {
+    v = arena_->New();
+    vars_.emplace(name,
+                  std::unique_ptr<Variable, VariableDeleter>(
+                      v, VariableDeleter{/*in_arena=*/true}));
+  } else {
+    v = new Variable();
+    vars_.emplace(name, std::unique_ptr<Variable, VariableDeleter>(v));
+  }
   VLOG(3) << "Create variable " << name;
   return v;
 }
@@ -234,7 +321,7 @@ void Scope::RenameInternal(const std::string& origin_name,
       vars_.end(),
       common::errors::AlreadyExists(
           "The variable with name %s already exists in the scope.", new_name));
-  vars_[new_name].reset(origin_it->second.release());
+  vars_[new_name] = std::move(origin_it->second);
   vars_.erase(origin_it);
 }
 
@@ -256,13 +343,16 @@ Variable* Scope::FindVarLocally(const std::string& name) const {
 
 void Scope::EraseVarsExcept(const std::unordered_set<Variable*>& vars) {
   SCOPE_VARS_WRITER_LOCK
+  std::unordered_set<Variable*> erased;
   for (auto iter = vars_.begin(); iter != vars_.end();) {
     if (vars.count(iter->second.get()) != 0) {
       ++iter;
     } else {
+      erased.insert(iter->second.get());
       vars_.erase(iter++);
     }
   }
+  EraseVarIndices(erased);
 }
 
 std::string GenScopeTreeDebugInfo(Scope* root) {
@@ -21,6 +21,7 @@ extern "C" {
 #include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -39,6 +40,50 @@ class Variable;
 
 namespace paddle {
 namespace framework {
+
+/**
+ * @brief Bump allocator of Variable objects.
+ *
+ * Variables are constructed in place inside fixed-size blocks. Destruction of
+ * a single variable only runs its destructor; the memory of all variables is
+ * reclaimed at once by Reset, which keeps the blocks for reuse.
+ */
+class TEST_API VariableArena {
+ public:
+  explicit VariableArena(size_t block_size);
+  ~VariableArena() = default;
+
+  Variable* New();
+
+  // All variables created by New must have been destroyed before Reset.
+  void Reset();
+
+  // Number of variables handed out since the last Reset.
+  size_t Size() const { return size_; }
+
+ private:
+  using Slot = std::aligned_storage_t<sizeof(Variable), alignof(Variable)>;
+
+  const size_t block_size_;
+  std::vector<std::unique_ptr<Slot[]>> blocks_;
+  size_t size_{0};
+
+  DISABLE_COPY_AND_ASSIGN(VariableArena);
+};
+
+// Deleter of the variables owned by a Scope. Variables created from the
+// scope's arena are only destructed, their memory belongs to the arena.
+struct VariableDeleter {
+  bool in_arena{false};
+  void operator()(Variable* var) const {
+    if (in_arena) {
+      var->~Variable();
+    } else {
+      delete var;
+    }
+  }
+};
+
 /**
  * @brief Scope that manage all variables.
  *
@@ -129,6 +174,27 @@ class TEST_API Scope {
 
   void SetCanReused(bool can_reused) { can_reused_ = can_reused; }
 
+  /// Allocate the variables created in this scope from now on from a local
+  /// bump arena of `block_size` variables per block. Intended for short-lived
+  /// scopes whose variables are dropped together, see ResetArena.
+  void EnableArena(size_t block_size = kDefaultArenaBlockSize);
+
+  bool IsArenaEnabled() const { return arena_ != nullptr; }
+
+  /// Drop all local variables and the variable indices in one step, and
+  /// rewind the arena so the next variables reuse its memory.
+  void ResetArena();
+
+  /// Create (if needed) a local variable and return a stable index to it.
+  /// VarAt(index) then reaches the variable without hashing its name.
+  size_t VarIndex(const std::string& name);
+
+  /// Return the variable registered by VarIndex, or nullptr if the variable
+  /// was erased since.
+  Variable* VarAt(size_t index) const;
+
+  static constexpr size_t kDefaultArenaBlockSize = 256;
+
  protected:
   struct KeyHasher {
     std::size_t operator()(const std::string& key) const {
@@ -136,7 +202,9 @@ class TEST_API Scope {
     }
   };
 
-  mutable std::unordered_map<std::string, std::unique_ptr<Variable>, KeyHasher>
+  mutable std::unordered_map<std::string,
+                             std::unique_ptr<Variable, VariableDeleter>,
+                             KeyHasher>
       vars_;
 
  private:
@@ -162,6 +230,9 @@ class TEST_API Scope {
   // Called by FindVarInternal and Var.
   Variable* FindVarLocally(const std::string& name) const;
 
+  // Called after local variables are erased, clear their indices.
+  void EraseVarIndices(const std::unordered_set<Variable*>& erased) const;
+
   // Scope in `kids_` are owned by this class.
   mutable std::list<Scope*> kids_;
   const Scope* parent_{nullptr};
@@ -169,6 +240,10 @@ class TEST_API Scope {
   // only for dygraph_to_static
   bool can_reused_{false};
 
+  std::unique_ptr<VariableArena> arena_;
+  // Variables registered by VarIndex, erased ones are set to nullptr.
+  mutable std::vector<Variable*> indexed_vars_;
+
   DISABLE_COPY_AND_ASSIGN(Scope);
 
  private:
@@ -14,12 +14,19 @@
 
 #include "paddle/fluid/imperative/layout_autotune.h"
 
+#include <fstream>
+
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/framework/op_info.h"
 #include "paddle/fluid/imperative/layout_transformer.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_bool(layout_autotune_measure);
+COMMON_DECLARE_string(layout_autotune_cache_file);
+
 namespace paddle::imperative {
 
 LayoutAutoTune::LayoutAutoTune() {
@@ -87,6 +94,70 @@ LayoutAutoTune::LayoutAutoTune() {
           << lightly_layout_sensitive_ops_.size();
 }
 
+bool LayoutAutoTune::IsMeasureEnabled() const {
+  return FLAGS_layout_autotune_measure;
+}
+
+void LayoutAutoTune::LoadMeasuredLayouts() {
+  measured_layouts_loaded_ = true;
+  if (FLAGS_layout_autotune_cache_file.empty()) {
+    return;
+  }
+  std::ifstream fin(FLAGS_layout_autotune_cache_file);
+  std::string key, layout;
+  while (fin >> key >> layout) {
+    measured_layouts_[key] = common::StringToDataLayout(layout);
+  }
+  VLOG(3) << "Load " << measured_layouts_.size()
+          << " measured layouts from " << FLAGS_layout_autotune_cache_file;
+}
+
+bool LayoutAutoTune::GetMeasuredLayout(const std::string& key,
+                                       DataLayout* layout) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!measured_layouts_loaded_) {
+    LoadMeasuredLayouts();
+  }
+  auto iter = measured_layouts_.find(key);
+  if (iter == measured_layouts_.end()) {
+    return false;
+  }
+  *layout = iter->second;
+  return true;
+}
+
+void LayoutAutoTune::SetMeasuredLayout(const std::string& key,
+                                       DataLayout layout) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  measured_layouts_[key] = layout;
+  if (FLAGS_layout_autotune_cache_file.empty()) {
+    return;
+  }
+  std::ofstream fout(FLAGS_layout_autotune_cache_file, std::ios::app);
+  if (!fout) {
+    LOG(WARNING) << "Failed to write the layout autotune cache file "
+                 << FLAGS_layout_autotune_cache_file;
+    return;
+  }
+  fout << key << " " << common::DataLayoutToString(layout) << "\n";
+}
+
+void LayoutAutoTune::RecordTransposeBack(const std::string& op_type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  ++transpose_back_count_[op_type];
+}
+
+std::unordered_map<std::string, int64_t>
+LayoutAutoTune::TransposeBackReport() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return transpose_back_count_;
+}
+
+void LayoutAutoTune::ClearTransposeBackReport() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  transpose_back_count_.clear();
+}
+
 template <typename VarType>
 paddle::imperative::NameVarMap<VarType> DealHeavilyLayoutSensitive(
     const std::string& op_type,
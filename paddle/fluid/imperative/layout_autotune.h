@@ -16,6 +16,9 @@
 #include <glog/logging.h>
 
 #include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "paddle/common/layout.h"
@@ -55,9 +58,29 @@ class LayoutAutoTune {
 
   void SetDefaultLayout(const DataLayout& layout) { default_layout_ = layout; }
 
+  // Whether to choose the layout by timing the conv kernels, see
+  // FLAGS_layout_autotune_measure.
+  bool IsMeasureEnabled() const;
+
+  // The layout measured for the signature of a conv, loaded from
+  // FLAGS_layout_autotune_cache_file of the former runs.
+  bool GetMeasuredLayout(const std::string& key, DataLayout* layout);
+
+  void SetMeasuredLayout(const std::string& key, DataLayout layout);
+
+  // Records a transpose back to the default layout inserted before op_type,
+  // because op_type has no kernel working on the desired layout.
+  void RecordTransposeBack(const std::string& op_type);
+
+  std::unordered_map<std::string, int64_t> TransposeBackReport();
+
+  void ClearTransposeBackReport();
+
  private:
   LayoutAutoTune();
 
+  void LoadMeasuredLayouts();
+
   std::unordered_set<std::string> layout_agnostic_ops_{};
 
   std::unordered_set<std::string> heavily_layout_sensitive_ops_{"batch_norm"};
@@ -70,6 +93,11 @@ class LayoutAutoTune {
 
   // Default Layout in this model
   DataLayout default_layout_{DataLayout::UNDEFINED};
+
+  std::mutex mutex_;
+  bool measured_layouts_loaded_{false};
+  std::unordered_map<std::string, DataLayout> measured_layouts_;
+  std::unordered_map<std::string, int64_t> transpose_back_count_;
 };
 
 // LayoutAutotuneGuard is used for RAII.
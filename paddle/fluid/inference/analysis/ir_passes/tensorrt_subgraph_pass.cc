@@ -15,11 +15,17 @@
 
 #include "paddle/fluid/inference/analysis/ir_passes/tensorrt_subgraph_pass.h"
 #include <fcntl.h>
+#include <algorithm>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <sstream>
 #include <string>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/block_desc.h"
 #include "paddle/fluid/framework/ir/graph_helper.h"
 #include "paddle/fluid/framework/ir/graph_pattern_detector.h"
@@ -32,12 +38,17 @@
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/tensorrt/convert/op_converter.h"
 #include "paddle/fluid/inference/tensorrt/engine.h"
+#include "paddle/fluid/inference/tensorrt/helper.h"
 #include "paddle/fluid/inference/tensorrt/op_teller.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
+#include "paddle/fluid/inference/utils/engine_cache.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
 
+COMMON_DECLARE_int64(trt_engine_cache_capacity_mb);
+
 namespace paddle::inference::analysis {
 namespace {
 
@@ -118,6 +129,111 @@ bool AllNodesLowerToTrtPostProcess(framework::ir::Graph *graph) {
   }
   return all_nodes_offload_to_trt;
 }
+
+// Reports the ops left to Paddle between tensorrt_engine ops. Every such op
+// splits the engines, and every tensor crossing the boundary is an extra
+// copy out of and into TensorRT, so the report tells the ops worth a
+// converter, a plugin or a trt_disabled_ops change first.
+void ReportEngineBoundaries(
+    framework::ir::Graph *graph,
+    const std::unordered_map<const framework::ir::Node *, std::string>
+        &rejected_reasons) {
+  auto is_engine = [](const framework::ir::Node *node) {
+    return node->IsOp() && node->Op() &&
+           node->Op()->Type() == "tensorrt_engine";
+  };
+  int num_engines = 0;
+  // op type -> (number of ops, number of crossing tensors, reason)
+  std::map<std::string, std::tuple<int, int, std::string>> boundaries;
+  for (auto *node : graph->Nodes()) {
+    if (!node->IsOp() || !node->Op()) continue;
+    if (is_engine(node)) {
+      ++num_engines;
+      continue;
+    }
+    int num_from_engines = 0;
+    for (auto *var : node->inputs) {
+      for (auto *producer : var->inputs) {
+        if (is_engine(producer)) ++num_from_engines;
+      }
+    }
+    int num_to_engines = 0;
+    for (auto *var : node->outputs) {
+      for (auto *consumer : var->outputs) {
+        if (is_engine(consumer)) ++num_to_engines;
+      }
+    }
+    if (num_from_engines == 0 || num_to_engines == 0) continue;
+
+    auto it = rejected_reasons.find(node);
+    const std::string reason =
+        it != rejected_reasons.end()
+            ? it->second
+            : "its subgraph is smaller than min_subgraph_size";
+    VLOG(1) << "TensorRT engines are split by " << node->Op()->Type()
+            << ": " << reason << ", " << num_from_engines
+            << " tensors from engines and " << num_to_engines
+            << " tensors to engines.";
+    auto &boundary = boundaries[node->Op()->Type()];
+    std::get<0>(boundary) += 1;
+    std::get<1>(boundary) += num_from_engines + num_to_engines;
+    std::get<2>(boundary) = reason;
+  }
+  if (num_engines <= 1 || boundaries.empty()) return;
+
+  std::stringstream os;
+  os << "The graph is partitioned into " << num_engines
+     << " TensorRT engines. The ops left to Paddle between the engines:";
+  for (const auto &it : boundaries) {
+    os << "\n  " << it.first << " x" << std::get<0>(it.second) << ", "
+       << std::get<1>(it.second)
+       << " tensors crossing the engines, because " << std::get<2>(it.second)
+       << ".";
+  }
+  LOG(INFO) << os.str();
+}
+
+void HashShapes(const std::map<std::string, std::vector<int>> &shapes,
+                std::ostream *os) {
+  for (const auto &it : shapes) {
+    *os << it.first << ":";
+    for (int dim : it.second) {
+      *os << dim << ",";
+    }
+    *os << ";";
+  }
+  *os << "#";
+}
+
+// The serialized engines of a cache directory may be shared by processes
+// running other weights, versions of TensorRT or GPUs, so the key of an
+// engine holds all of them besides the names the engine key is made of.
+std::string EngineSignature(const framework::BlockDesc &block_desc,
+                            std::vector<std::string> parameters,
+                            const framework::Scope &scope,
+                            int device_id,
+                            const std::string &options) {
+  uint64_t hash = StableHash(block_desc.Proto()->SerializeAsString());
+  std::sort(parameters.begin(), parameters.end());
+  for (const auto &name : parameters) {
+    hash = StableHash(name, hash);
+    auto *var = scope.FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      continue;
+    }
+    const auto &tensor = var->Get<phi::DenseTensor>();
+    hash = StableHash(
+        tensor.dims().to_str() + phi::DataTypeToString(tensor.dtype()), hash);
+    if (tensor.initialized() && phi::is_cpu_place(tensor.place())) {
+      hash = StableHashBytes(tensor.data(), tensor.memory_size(), hash);
+    }
+  }
+  std::stringstream os;
+  os << tensorrt::GetInferLibVersion() << "#"
+     << phi::backends::gpu::GetGPUComputeCapability(device_id) << "#"
+     << options;
+  return std::to_string(StableHash(os.str(), hash));
+}
 }  // namespace
 
 using framework::ir::Node;
@@ -151,6 +267,10 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   auto with_dynamic_shape = Get<bool>("with_dynamic_shape");
   auto use_explicit_quantization = Get<bool>("use_explicit_quantization");
   auto forbid_dynamic_op = Get<bool>("forbid_dynamic_op");
+  // Why an op is not lowered to TensorRT, for the report of the boundaries
+  // between the engines.
+  std::unordered_map<const framework::ir::Node *, std::string>
+      rejected_reasons;
   auto teller = [&](const framework::ir::Node *node) {
     if (!node->IsOp() || !node->Op()) return false;
     if (find(trt_disabled_ops.begin(),
@@ -159,6 +279,7 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
       VLOG(3) << node->Op()->Type().c_str()
 
               << " is diabled by config in TensorRT";
+      rejected_reasons[node] = "the op type is in trt_disabled_ops";
       return false;
     }
     for (const auto &out_var : node->Op()->OutputNames()) {
@@ -167,6 +288,8 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
             trt_disabled_ops.end()) {
           VLOG(3) << node->Op()->Type().c_str()
                   << " is diabled by config in TensorRT";
+          rejected_reasons[node] =
+              "the output " + var_name + " is in trt_disabled_ops";
           return false;
         }
       }
@@ -176,8 +299,14 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
                                                    with_dynamic_shape,
                                                    forbid_dynamic_op,
                                                    use_explicit_quantization);
-    if (!is_ok)
+    if (!is_ok) {
       VLOG(3) << node->Op()->Type().c_str() << " op is not in TensorRT";
+      rejected_reasons[node] =
+          with_dynamic_shape
+              ? "neither a converter nor the generic plugin supports it"
+              : "no converter supports it, and the generic plugin requires "
+                "dynamic shape";
+    }
     return is_ok;
   };
 
@@ -217,6 +346,7 @@ void analysis::TensorRtSubgraphPass::ApplyImpl(
   framework::ir::GraphSafeRemoveNodes(graph, nodes2remove);
   graph->Set(framework::ir::kRepetitiveParamAttr,
              new std::vector<std::string>(repetitive_params));
+  ReportEngineBoundaries(graph, rejected_reasons);
 
   bool all_nodes_offload_to_trt = AllNodesLowerToTrtPostProcess(graph);
   if (all_nodes_offload_to_trt) {
@@ -535,6 +665,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   auto shape_range_info_path = Get<std::string>("trt_shape_range_info_path");
   auto trt_tuned_dynamic_shape = Get<bool>("trt_tuned_dynamic_shape");
   int max_batch_size = Get<int>("max_batch_size");
+  std::vector<std::map<std::string, std::vector<int>>> profile_min_input_shapes;
+  std::vector<std::map<std::string, std::vector<int>>> profile_max_input_shapes;
+  std::vector<std::map<std::string, std::vector<int>>>
+      profile_optim_input_shapes;
   if (trt_tuned_dynamic_shape) {
     if (!shape_range_info_path.empty()) {
       VLOG(1) << "trt dynamic_shape deserialize from " << shape_range_info_path;
@@ -545,6 +679,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
                                            &min_shape_tensor,
                                            &max_shape_tensor,
                                            &optim_shape_tensor);
+      inference::DeserializeShapeRangeProfiles(shape_range_info_path,
+                                               &profile_min_input_shapes,
+                                               &profile_max_input_shapes,
+                                               &profile_optim_input_shapes);
     } else {
       shape_range_info_path = Get<std::string>("model_opt_cache_dir") + "/" +
                               "shape_range_info.pbtxt";
@@ -558,6 +696,10 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
                                              &min_shape_tensor,
                                              &max_shape_tensor,
                                              &optim_shape_tensor);
+        inference::DeserializeShapeRangeProfiles(shape_range_info_path,
+                                                 &profile_min_input_shapes,
+                                                 &profile_max_input_shapes,
+                                                 &profile_optim_input_shapes);
       } else {
         int fd = open(shape_range_info_path.c_str(), O_WRONLY | O_CREAT, 0644);
         close(fd);
@@ -725,9 +867,8 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     op_desc->SetAttr("model_opt_cache_dir",
                      Get<std::string>("model_opt_cache_dir"));
 
-  // TODO(NHZlX)
-  // There are models with the same structure but the different parameters,
-  // when running in the 'use_serialize' mode, there is a bug.
+  // Models with the same structure but different parameters have the same
+  // names, so a serialized engine is also keyed by its signature.
   // serialization is affected by max_batch_size, but calibration is not.
   // So we use separate engine keys in serialization and calibration.
   auto engine_key =
@@ -738,6 +879,29 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
                         std::to_string(static_cast<int>(precision_mode)),
                         use_cuda_graph,
                         false);
+  if (use_static_engine) {
+    std::stringstream options;
+    options << with_dynamic_shape << use_dla << dla_core << optimization_level
+            << use_explicit_quantization << enable_low_precision_io
+            << disable_trt_plugin_fp16 << use_varseqlen << with_interleaved
+            << "#";
+    HashShapes(min_input_shape, &options);
+    HashShapes(max_input_shape, &options);
+    HashShapes(optim_input_shape, &options);
+    HashShapes(min_shape_tensor, &options);
+    HashShapes(max_shape_tensor, &options);
+    HashShapes(optim_shape_tensor, &options);
+    for (size_t i = 0; i < profile_min_input_shapes.size(); ++i) {
+      HashShapes(profile_min_input_shapes[i], &options);
+      HashShapes(profile_max_input_shapes[i], &options);
+      HashShapes(profile_optim_input_shapes[i], &options);
+    }
+    engine_key = std::to_string(StableHash(
+        engine_key + "#" +
+        EngineSignature(
+            block_desc, parameters, *scope, gpu_device_id, options.str())));
+    VLOG(2) << "TRT serialized engine key: " << engine_key;
+  }
   auto calibration_engine_key =
       GenerateEngineKey(input_names_with_id,
                         output_names_with_id,
@@ -847,6 +1011,9 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   params.min_shape_tensor = min_shape_tensor;
   params.max_shape_tensor = max_shape_tensor;
   params.optim_shape_tensor = optim_shape_tensor;
+  params.profile_min_input_shapes = profile_min_input_shapes;
+  params.profile_max_input_shapes = profile_max_input_shapes;
+  params.profile_optim_input_shapes = profile_optim_input_shapes;
   params.disable_trt_plugin_fp16 = disable_trt_plugin_fp16;
   params.precision = precision_mode;
   params.use_varseqlen = use_varseqlen;
@@ -869,25 +1036,40 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
   // support force ops to run in FP32 precision
   trt_engine->SetRunFloat(trt_ops_run_float);
 
-  if (use_static_engine) {
-    trt_engine_serialized_data = GetTrtEngineSerializedData(
-        Get<std::string>("model_opt_cache_dir"), engine_key);
+  EngineFileCache engine_cache(
+      Get<std::string>("model_opt_cache_dir"),
+      "trt_serialized_",
+      FLAGS_trt_engine_cache_capacity_mb * 1024 * 1024);
+  // Held while this process builds the engine, so that the other processes
+  // sharing the cache directory load it instead of building it again.
+  std::unique_ptr<EngineFileCache::BuildLock> build_lock;
+  auto load_serialized_engine = [&]() {
     // we can load the engine info serialized before from the disk.
-    if (!trt_engine_serialized_data.empty()) {
-      try {
-        trt_engine->Deserialize(trt_engine_serialized_data);
-        LOG(INFO) << "Load TRT Optimized Info from "
-                  << GetTrtEngineSerializedPath(
-                         Get<std::string>("model_opt_cache_dir"), engine_key);
-        return engine_key + std::to_string(predictor_id);
-      } catch (const std::exception &exp) {
-        LOG(WARNING)
-            << "Fail to load TRT Optimized Info from "
-            << GetTrtEngineSerializedPath(
-                   Get<std::string>("model_opt_cache_dir"), engine_key)
-            << ". Engine deserialization failed: Serialized Engine Version "
-               "does not match Current Version, TRT engine will be rebuilt";
-      }
+    if (!engine_cache.Load(engine_key, &trt_engine_serialized_data)) {
+      return false;
+    }
+    try {
+      trt_engine->Deserialize(trt_engine_serialized_data);
+      LOG(INFO) << "Load TRT Optimized Info from "
+                << engine_cache.Path(engine_key);
+      return true;
+    } catch (const std::exception &exp) {
+      LOG(WARNING)
+          << "Fail to load TRT Optimized Info from "
+          << engine_cache.Path(engine_key)
+          << ". Engine deserialization failed: Serialized Engine Version "
+             "does not match Current Version, TRT engine will be rebuilt";
+      return false;
+    }
+  };
+  if (use_static_engine) {
+    if (load_serialized_engine()) {
+      return engine_key + std::to_string(predictor_id);
+    }
+    build_lock = engine_cache.LockForBuild(engine_key);
+    // another process may have built it while we waited
+    if (load_serialized_engine()) {
+      return engine_key + std::to_string(predictor_id);
     }
   }
 
@@ -920,13 +1102,9 @@ std::string TensorRtSubgraphPass::CreateTensorRTOp(
     trt_engine_serialized_data =
         std::string((const char *)serialized_engine_data->data(),
                     serialized_engine_data->size());
-    SaveTrtEngineSerializedDataToFile(
-        GetTrtEngineSerializedPath(Get<std::string>("model_opt_cache_dir"),
-                                   engine_key),
-        trt_engine_serialized_data);
+    engine_cache.Store(engine_key, trt_engine_serialized_data);
     LOG(INFO) << "Save TRT Optimized Info to "
-              << GetTrtEngineSerializedPath(
-                     Get<std::string>("model_opt_cache_dir"), engine_key);
+              << engine_cache.Path(engine_key);
   }
 
   return engine_key + std::to_string(predictor_id);
@@ -178,6 +178,27 @@ void AnalysisConfig::Exp_EnableUseCutlass() {
   Update();
 }
 
+void AnalysisConfig::Exp_SetWeightOnlyQuant(const std::string &algo,
+                                            int group_size) {
+  PADDLE_ENFORCE_EQ(algo == "weight_only_int8" || algo == "weight_only_int4",
+                    true,
+                    common::errors::InvalidArgument(
+                        "The weight only quantization algo must be "
+                        "weight_only_int8 or weight_only_int4, but got %s.",
+                        algo));
+  PADDLE_ENFORCE_EQ(
+      group_size == -1 || group_size == 64 || group_size == 128,
+      true,
+      common::errors::InvalidArgument(
+          "The group_size of weight only quantization must be -1 "
+          "(per-channel), 64 or 128, but got %d.",
+          group_size));
+  weight_only_algo_ = algo;
+  weight_only_group_size_ = group_size;
+
+  Update();
+}
+
 void AnalysisConfig::SetExecStream(void *stream) {
   PADDLE_ENFORCE_NOT_NULL(
       stream,
@@ -472,6 +493,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(model_dir_);
   CP_MEMBER(model_from_memory_);  // the memory model reuses prog_file_ and
                                   // params_file_ fields.
+  CP_MEMBER(mmap_params_);
   CP_MEMBER(save_optimized_model_);
   CP_MEMBER(opt_cache_dir_);
   CP_MEMBER(prog_file_);
@@ -481,6 +503,8 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   // GPU related.
   CP_MEMBER(use_gpu_);
   CP_MEMBER(use_cutlass_);
+  CP_MEMBER(weight_only_algo_);
+  CP_MEMBER(weight_only_group_size_);
   CP_MEMBER(use_external_stream_);
   CP_MEMBER(exec_stream_);
   CP_MEMBER(use_cudnn_);
@@ -495,6 +519,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(enable_low_precision_io_);
 
   CP_MEMBER(enable_memory_optim_);
+  CP_MEMBER(share_activation_memory_);
   // TensorRT related.
   CP_MEMBER(use_tensorrt_);
   CP_MEMBER(tensorrt_workspace_size_);
@@ -520,6 +545,9 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(trt_tuned_dynamic_shape_);
   CP_MEMBER(trt_allow_build_at_runtime_);
   CP_MEMBER(collect_shape_range_info_);
+  CP_MEMBER(trt_shape_profile_num_);
+  CP_MEMBER(warmup_enabled_);
+  CP_MEMBER(warmup_shape_range_info_path_);
   CP_MEMBER(shape_range_info_path_);
   CP_MEMBER(trt_use_inspector_);
   CP_MEMBER(trt_inspector_serialize_);
@@ -533,6 +561,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(use_mkldnn_);
   CP_MEMBER(mkldnn_enabled_op_types_);
   CP_MEMBER(mkldnn_cache_capacity_);
+  CP_MEMBER(mkldnn_primitive_sharing_);
   // Bfloat16 related.
   CP_MEMBER(use_mkldnn_bfloat16_);
   CP_MEMBER(bfloat16_enabled_op_types_);
@@ -551,6 +580,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
 
   // profile related.
   CP_MEMBER(with_profile_);
+  CP_MEMBER(with_run_telemetry_);
 
   // cinn compiler related.
   CP_MEMBER(use_cinn_);
@@ -566,6 +596,7 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(use_optimized_model_);
 
   CP_MEMBER(cpu_math_library_num_threads_);
+  CP_MEMBER(numa_sharding_);
 
   CP_MEMBER(serialized_info_cache_);
 
@@ -596,6 +627,9 @@ AnalysisConfig::AnalysisConfig(const AnalysisConfig &other) {
   CP_MEMBER(skip_load_params_);
 
   CP_MEMBER(use_new_executor_);
+  CP_MEMBER(use_scope_arena_);
+  CP_MEMBER(use_cuda_graph_);
+  CP_MEMBER(cuda_graph_max_num_graphs_);
   CP_MEMBER(use_pir_);
   CP_MEMBER(custom_passes_);
   CP_MEMBER(custom_pass_only_);
@@ -679,6 +713,15 @@ void AnalysisConfig::SetMkldnnCacheCapacity(int capacity) {
 #endif
 }
 
+void AnalysisConfig::EnableMkldnnPrimitiveSharing(bool x) {
+#ifdef PADDLE_WITH_DNNL
+  mkldnn_primitive_sharing_ = x;
+#else
+  LOG(ERROR) << "Please compile with MKLDNN first to share MKLDNN primitives";
+  mkldnn_primitive_sharing_ = false;
+#endif
+}
+
 void AnalysisConfig::EnableMkldnnBfloat16() {
 #ifdef PADDLE_WITH_DNNL
   if (phi::backends::cpu::MayIUse(phi::backends::cpu::cpu_isa_t::avx512_core)) {
@@ -1072,6 +1115,8 @@ std::string AnalysisConfig::SerializeInfoCache() {
 
   ss << use_gpu_;
   ss << enable_gpu_mixed_;
+  ss << weight_only_algo_;
+  ss << weight_only_group_size_;
   ss << use_external_stream_;
   ss << exec_stream_;
   ss << use_fc_padding_;
@@ -1101,6 +1146,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   ss << trt_dla_core_;
 
   ss << enable_memory_optim_;
+  ss << share_activation_memory_;
   ss << trt_engine_memory_sharing_;
 
   ss << use_mkldnn_;
@@ -1115,6 +1161,7 @@ std::string AnalysisConfig::SerializeInfoCache() {
   for (auto &item : quantize_excluded_op_ids_) ss << item;
   ss << ";";
   ss << model_from_memory_;
+  ss << mmap_params_;
 
   ss << with_profile_;
 
@@ -1180,6 +1227,8 @@ void AnalysisConfig::SetCpuMathLibraryNumThreads(
   Update();
 }
 
+void AnalysisConfig::EnableNumaSharding(bool x) { numa_sharding_ = x; }
+
 float AnalysisConfig::fraction_of_gpu_memory_for_pool() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // Get the GPU memory details and calculate the fraction of memory for the
@@ -1211,6 +1260,22 @@ bool AnalysisConfig::enable_memory_optim() const {
   return enable_memory_optim_;
 }
 
+void AnalysisConfig::EnableCUDAGraph(int max_num_graphs) {
+  PADDLE_ENFORCE_GT(max_num_graphs,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The number of CUDA Graphs must be positive, but got "
+                        "%d.",
+                        max_num_graphs));
+  use_cuda_graph_ = true;
+  cuda_graph_max_num_graphs_ = max_num_graphs;
+}
+
+void AnalysisConfig::EnableActivationMemorySharing(bool x) {
+  share_activation_memory_ = x;
+  Update();
+}
+
 bool AnalysisConfig::trt_engine_memory_sharing() const {
   return trt_engine_memory_sharing_;
 }
@@ -1224,6 +1289,8 @@ void AnalysisConfig::SetModelBuffer(const char *prog_buffer,
   model_from_memory_ = true;
 }
 
+void AnalysisConfig::EnableMmapParams(bool x) { mmap_params_ = x; }
+
 NativeConfig AnalysisConfig::ToNativeConfig() const {
   NativeConfig config;
   config.model_dir = model_dir_;
@@ -1248,6 +1315,8 @@ void AnalysisConfig::EnableProfile() {
   Update();
 }
 
+void AnalysisConfig::EnableRunTelemetry(bool x) { with_run_telemetry_ = x; }
+
 void AnalysisConfig::DisableGlogInfo() {
   with_glog_info_ = false;
   Update();
@@ -1270,20 +1339,27 @@ std::string AnalysisConfig::Summary() {
   if (model_from_memory_) {
     os.InsertRow({"model_from_memory", params_file_});
   }
+  os.InsertRow({"mmap_params", mmap_params_ ? "true" : "false"});
   os.InsetDivider();
 
   // cpu info
   os.InsertRow(
       {"cpu_math_thread", std::to_string(cpu_math_library_num_threads_)});
+  os.InsertRow({"numa_sharding", numa_sharding_ ? "true" : "false"});
   os.InsertRow({"enable_mkldnn", use_mkldnn_ ? "true" : "false"});
   os.InsertRow(
       {"mkldnn_cache_capacity", std::to_string(mkldnn_cache_capacity_)});
+  os.InsertRow({"mkldnn_primitive_sharing",
+                mkldnn_primitive_sharing_ ? "true" : "false"});
   os.InsetDivider();
 
   // gpu info
   os.InsertRow({"use_gpu", use_gpu_ ? "true" : "false"});
   if (use_gpu_) {
     os.InsertRow({"use_cutlass", use_cutlass_ ? "true" : "false"});
+    os.InsertRow({"weight_only_algo", weight_only_algo_});
+    os.InsertRow(
+        {"weight_only_group_size", std::to_string(weight_only_group_size_)});
     os.InsertRow({"gpu_device_id", std::to_string(gpu_device_id_)});
     os.InsertRow({"enable_gpu_mixed", std::to_string(enable_gpu_mixed_)});
     os.InsertRow({"mixed_precision_mode",
@@ -1292,6 +1368,10 @@ std::string AnalysisConfig::Summary() {
                   std::to_string(memory_pool_init_size_mb_) + "MB"});
     os.InsertRow(
         {"use_external_stream", use_external_stream_ ? "true" : "false"});
+    os.InsertRow({"cuda_graph",
+                  use_cuda_graph_
+                      ? std::to_string(cuda_graph_max_num_graphs_) + " graphs"
+                      : "false"});
     os.InsertRow(
         {"thread_local_stream", thread_local_stream_ ? "true" : "false"});
 
@@ -1421,10 +1501,19 @@ std::string AnalysisConfig::Summary() {
   os.InsertRow(
       {"use_optimized_model", use_optimized_model_ ? "true" : "false"});
   os.InsertRow({"memory_optim", enable_memory_optim_ ? "true" : "false"});
+  os.InsertRow({"share_activation_memory",
+                share_activation_memory_ ? "true" : "false"});
   os.InsertRow({"enable_profile", with_profile_ ? "true" : "false"});
+  os.InsertRow({"run_telemetry", with_run_telemetry_ ? "true" : "false"});
   os.InsertRow({"enable_log", with_glog_info_ ? "true" : "false"});
   os.InsertRow({"collect_shape_range_info",
                 collect_shape_range_info_ ? shape_range_info_path_ : "false"});
+  if (collect_shape_range_info_) {
+    os.InsertRow(
+        {"trt_shape_profile_num", std::to_string(trt_shape_profile_num_)});
+  }
+  os.InsertRow({"warmup",
+                warmup_enabled_ ? warmup_shape_range_info_path() : "false"});
 
   return os.PrintTable();
 }
@@ -1452,6 +1541,26 @@ bool AnalysisConfig::shape_range_info_collected() const {
   return collect_shape_range_info_;
 }
 
+void AnalysisConfig::SetTRTShapeProfileNum(int num_profiles) {
+  PADDLE_ENFORCE_GE(num_profiles,
+                    1,
+                    common::errors::InvalidArgument(
+                        "The number of shape profiles should be at least 1, "
+                        "but got %d.",
+                        num_profiles));
+  trt_shape_profile_num_ = num_profiles;
+}
+
+void AnalysisConfig::EnableWarmup(const std::string &shape_range_info_path) {
+  warmup_enabled_ = true;
+  warmup_shape_range_info_path_ = shape_range_info_path;
+}
+
+const std::string &AnalysisConfig::warmup_shape_range_info_path() const {
+  return warmup_shape_range_info_path_.empty() ? shape_range_info_path_
+                                               : warmup_shape_range_info_path_;
+}
+
 void AnalysisConfig::EnableTunedTensorRtDynamicShape(
     const std::string &shape_range_info_path, bool allow_build_at_runtime) {
   shape_range_info_path_ = shape_range_info_path;
@@ -17,15 +17,23 @@
 #include <glog/logging.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <exception>
+#include <functional>
 #include <fstream>
 #include <memory>
+#include <numeric>
 #include <set>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
 #include "paddle/common/enforce.h"
+#include "paddle/common/hash_funcs.h"
 #include "paddle/fluid/framework/feed_fetch_method.h"
 #include "paddle/fluid/framework/feed_fetch_type.h"
 #include "paddle/fluid/framework/feed_hook.h"
@@ -36,6 +44,7 @@
 #include "paddle/fluid/framework/op_proto_maker.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/framework/transfer_scope_cache.h"
 #include "paddle/fluid/framework/var_type_traits.h"
 #include "paddle/fluid/framework/version.h"
@@ -51,6 +60,7 @@
 #include "paddle/fluid/inference/api/resource_manager.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/fluid/inference/utils/model_utils.h"
+#include "paddle/fluid/inference/utils/shape_profiles.h"
 #include "paddle/fluid/inference/utils/singleton.h"
 #include "paddle/fluid/prim/utils/utils.h"
 #include "paddle/fluid/primitive/base/decomp_trans.h"
@@ -62,6 +72,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/memcpy.h"
 #include "paddle/phi/core/platform/cpu_helper.h"
+#include "paddle/phi/core/platform/cuda_graph_with_memory_pool.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_types.h"
 #include "paddle/phi/core/platform/device_context.h"
@@ -75,6 +86,10 @@
 #include "paddle/phi/backends/dynload/mklml.h"
 #endif
 
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+#endif
+
 #ifdef PADDLE_WITH_ONNXRUNTIME
 #include "paddle/fluid/inference/api/onnxruntime_predictor.h"
 #endif
@@ -132,6 +147,8 @@
 
 COMMON_DECLARE_bool(pir_apply_inplace_pass);
 COMMON_DECLARE_bool(enable_auto_layout_pass);
+COMMON_DECLARE_bool(new_executor_use_cuda_graph);
+COMMON_DECLARE_int32(naive_executor_inter_op_threads);
 namespace paddle {
 namespace {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
@@ -208,6 +225,11 @@ bool IsPersistable(const framework::VarDesc *var) {
   return false;
 }
 
+// a params buffer set by SetModelBuffer can not be mapped
+bool UseMmapParams(const AnalysisConfig &config) {
+  return config.mmap_params_enabled() && !config.model_from_memory();
+}
+
 phi::DataType ConvertPrecision(AnalysisConfig::Precision precision) {
   switch (precision) {
     case AnalysisConfig::Precision::kFloat32:
@@ -361,6 +383,17 @@ bool PaddleTensorToDenseTensor(const PaddleTensor &pt,
   t->set_lod(lod);
   return true;
 }
+
+template <typename T>
+void FillWarmupInput(ZeroCopyTensor *tensor,
+                     int64_t numel,
+                     const std::vector<int32_t> *values) {
+  std::unique_ptr<T[]> data(new T[numel]);
+  for (int64_t i = 0; i < numel; ++i) {
+    data[i] = static_cast<T>(values ? (*values)[i] : 0);
+  }
+  tensor->CopyFromCpu(data.get());
+}
 }  // namespace
 
 AnalysisPredictor::AnalysisPredictor(const AnalysisConfig &config)
@@ -444,6 +477,11 @@ bool AnalysisPredictor::Init(
     config_.use_new_executor_ = true;
   }
 
+  // a clone runs the program of the predictor it is cloned from
+  if (!status_is_cloned_ &&
+      (config_.use_optimized_model_ || config_.save_optimized_model_)) {
+    optimized_model_key_ = GetOptimizedModelKey();
+  }
   // Use Optimized model to inference
   if (config_.use_optimized_model_) {
     std::string optimized_model_path = GetOptimizedModelPath();
@@ -455,7 +493,22 @@ bool AnalysisPredictor::Init(
     }
     std::string optimized_params =
         optimized_model_path + "/" + "_optimized.pdiparams";
-    if (FileExists(optimized_model) && FileExists(optimized_params)) {
+    // a model saved without a key is used as it is
+    std::string optimized_key = optimized_model_path + "/" + "_optimized.key";
+    bool key_matched = true;
+    if (!optimized_model_key_.empty() && FileExists(optimized_key)) {
+      std::ifstream fin(optimized_key);
+      std::string saved_key;
+      fin >> saved_key;
+      key_matched = saved_key == optimized_model_key_;
+    }
+    if (!key_matched) {
+      LOG(WARNING) << "The optimized model in " << optimized_model_path
+                   << " was saved for another model, config or device, "
+                      "fallback to original model and save it again.";
+      config_.EnableSaveOptimModel(true);
+      config_.UseOptimizedModel(false);
+    } else if (FileExists(optimized_model) && FileExists(optimized_params)) {
       config_.SetModel(optimized_model, optimized_params);
       if (config_.new_ir_enabled()) {
         load_pir_model_ = true;
@@ -477,6 +530,23 @@ bool AnalysisPredictor::Init(
     return false;
   }
   InitPlace();
+  if (config_.numa_sharding_enabled() && !status_is_cloned_) {
+    int num_nodes = paddle::platform::GetNumaNodeCount();
+    if (!phi::is_cpu_place(place_)) {
+      LOG(WARNING) << "NUMA sharding needs a CPU predictor, it is disabled.";
+    } else if (num_nodes > 1) {
+      numa_node_ = 0;
+      numa_replicas_ = std::make_shared<NumaReplicas>();
+      numa_replicas_->scopes.resize(num_nodes);
+      numa_replicas_->scopes[0] = scope_;
+    }
+  }
+  if (config_.cuda_graph_enabled() &&
+      !(config_.use_gpu() && config_.new_executor_enabled())) {
+    LOG(WARNING) << "CUDA Graph needs a GPU predictor with the new executor, "
+                    "the kernels are launched one by one.";
+    config_.use_cuda_graph_ = false;
+  }
 
   if (!CreateExecutor()) {
     return false;
@@ -504,7 +574,7 @@ bool AnalysisPredictor::Init(
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   // TODO(inference): Now only gpu with external stream support private
   // device_context.
-  if (config_.use_gpu_ && config_.use_external_stream_) {
+  if (config_.use_gpu_ && (config_.use_external_stream_ || own_stream_)) {
     private_context_ = true;
   }
   if (private_context_) {
@@ -537,12 +607,117 @@ bool AnalysisPredictor::Init(
   }
 #endif
 
+  if (config_.activation_memory_sharing()) {
+    CollectPersistentVarNames();
+  }
   TryShrinkMemory();
+  if (config_.warmup_enabled() && !config_.shape_range_info_collected()) {
+    Warmup();
+  }
+  // after the warm-up, which is not a request
+  if (config_.run_telemetry_enabled()) {
+    run_telemetry_ = std::make_unique<details::RunTelemetry>(
+        config_.model_dir().empty() ? config_.prog_file()
+                                    : config_.model_dir());
+  }
 
   inference::DisplayMemoryInfo(place_, "Init predictor");
   return true;
 }
 
+void AnalysisPredictor::Warmup() {
+  const std::string &path = config_.warmup_shape_range_info_path();
+  if (path.empty() || !FileExists(path)) {
+    LOG(WARNING) << "The shape info file [" << path
+                 << "] of the warm-up is not found, skip the warm-up.";
+    return;
+  }
+  using ShapeMap = std::map<std::string, std::vector<int32_t>>;
+  ShapeMap min_shape, max_shape, opt_shape;
+  ShapeMap min_value, max_value, opt_value;
+  inference::DeserializeShapeRangeInfo(path,
+                                       &min_shape,
+                                       &max_shape,
+                                       &opt_shape,
+                                       &min_value,
+                                       &max_value,
+                                       &opt_value);
+  auto input_types = GetInputTypes();
+  auto start = std::chrono::steady_clock::now();
+  // The max shapes run first, so that the allocator grows to the peak at once
+  // instead of chunk by chunk.
+  const std::vector<std::pair<const ShapeMap *, const ShapeMap *>> profiles{
+      {&max_shape, &max_value},
+      {&opt_shape, &opt_value},
+      {&min_shape, &min_value}};
+  for (const auto &[shapes, values] : profiles) {
+    for (const auto &name : GetInputNames()) {
+      auto shape = shapes->find(name);
+      if (shape == shapes->end()) {
+        LOG(WARNING) << "The shape info file [" << path
+                     << "] has no shape of the input [" << name
+                     << "], skip the warm-up.";
+        return;
+      }
+      auto tensor = GetInputTensor(name);
+      tensor->Reshape(
+          std::vector<int>(shape->second.begin(), shape->second.end()));
+      int64_t numel = std::accumulate(shape->second.begin(),
+                                      shape->second.end(),
+                                      int64_t{1},
+                                      std::multiplies<int64_t>());
+      // shape tensors get the collected values, the others are zeros
+      auto value = values->find(name);
+      const std::vector<int32_t> *data =
+          value != values->end() &&
+                  static_cast<int64_t>(value->second.size()) == numel
+              ? &value->second
+              : nullptr;
+      switch (input_types[name]) {
+        case paddle_infer::DataType::FLOAT32:
+          FillWarmupInput<float>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::FLOAT64:
+          FillWarmupInput<double>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::FLOAT16:
+          FillWarmupInput<phi::dtype::float16>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::BFLOAT16:
+          FillWarmupInput<phi::dtype::bfloat16>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::INT64:
+          FillWarmupInput<int64_t>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::INT32:
+          FillWarmupInput<int32_t>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::INT8:
+          FillWarmupInput<int8_t>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::UINT8:
+          FillWarmupInput<uint8_t>(tensor.get(), numel, data);
+          break;
+        case paddle_infer::DataType::BOOL:
+          FillWarmupInput<bool>(tensor.get(), numel, data);
+          break;
+        default:
+          LOG(WARNING) << "The data type of the input [" << name
+                       << "] is not supported by the warm-up, skip it.";
+          return;
+      }
+    }
+    if (!ZeroCopyRun()) {
+      LOG(WARNING) << "The warm-up run of the predictor failed.";
+      return;
+    }
+  }
+  auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  LOG(INFO) << "The warm-up of the predictor completed with "
+            << profiles.size() << " runs in " << elapsed.count() << " ms.";
+}
+
 void AnalysisPredictor::InitPlace() {
   if (config_.use_gpu()) {
     PADDLE_ENFORCE_EQ(config_.use_xpu(),
@@ -610,6 +785,70 @@ std::string AnalysisPredictor::GetOptimizedModelPath() {
   return model_opt_cache_dir;
 }
 
+std::string AnalysisPredictor::GetOptimizedModelKey() {
+  size_t seed = 0;
+  auto hash_file = [&](const std::string &path) {
+    if (config_.model_from_memory()) {
+      ::HashCombine(&seed, path);
+      return;
+    }
+    std::ifstream fin(path, std::ios::binary);
+    std::vector<char> buffer(4 << 20);
+    while (fin) {
+      fin.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+      ::HashCombine(
+          &seed,
+          std::string_view(buffer.data(), static_cast<size_t>(fin.gcount())));
+    }
+  };
+  hash_file(config_.prog_file());
+  hash_file(config_.params_file());
+
+  // the options deciding the optimized model, without the pointers which
+  // differ from process to process
+  AnalysisConfig config(config_);
+  config.use_optimized_model_ = false;
+  config.save_optimized_model_ = false;
+  config.exec_stream_ = nullptr;
+  config.xpu_config_.l3_ptr = nullptr;
+  config.xpu_config_.stream = nullptr;
+  ::HashCombine(&seed, config.SerializeInfoCache());
+  for (const auto &pass : config_.pass_builder()->AllPasses()) {
+    ::HashCombine(&seed, pass);
+  }
+  for (const auto &pass : config_.custom_passes_) {
+    ::HashCombine(&seed, pass);
+  }
+  for (const auto &pass : config_.deleted_passes_) {
+    ::HashCombine(&seed, pass);
+  }
+  ::HashCombine(&seed, config_.custom_pass_only_, get_version());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  if (config_.use_gpu()) {
+    ::HashCombine(
+        &seed, platform::GetGPUComputeCapability(config_.gpu_device_id()));
+  }
+#endif
+
+  std::stringstream ss;
+  ss << std::hex << seed;
+  return ss.str();
+}
+
+void AnalysisPredictor::SaveOptimizedModelKey() {
+  if (optimized_model_key_.empty()) {
+    return;
+  }
+  std::string optimized_key = GetOptimizedModelPath() + "/" + "_optimized.key";
+  std::ofstream fout(optimized_key);
+  PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                    true,
+                    common::errors::Unavailable(
+                        "Cannot open %s to save the optimized model key.",
+                        optimized_key));
+  fout << optimized_model_key_;
+}
+
 void AnalysisPredictor::ClearExtraParams() {
   auto var_names = scope_->LocalVarNames();
   std::vector<std::string> trt_repetitive_params;
@@ -723,6 +962,27 @@ void AnalysisPredictor::InitDeviceContexts() {
 #endif
 }
 
+void AnalysisPredictor::WaitForRunTelemetry() {
+  if (run_telemetry_ == nullptr) {
+    return;
+  }
+  details::ScopedStageTimer timer(run_telemetry_.get(),
+                                  details::RunTelemetry::kSyncWait);
+  if (private_context_) {
+    auto *dev_ctxs = reinterpret_cast<const std::map<
+        phi::Place,
+        std::shared_future<std::unique_ptr<phi::DeviceContext>>> *>(
+        GetDeviceContexts());
+    dev_ctxs->at(place_).get()->Wait();
+  } else {
+    phi::DeviceContextPool::Instance().Get(place_)->Wait();
+  }
+}
+
+std::string AnalysisPredictor::GetRunTelemetry() const {
+  return run_telemetry_ ? run_telemetry_->ToPrometheusText() : "";
+}
+
 void *AnalysisPredictor::GetExecStream() const {
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   if (place_.GetType() == phi::AllocationType::GPU) {
@@ -790,6 +1050,9 @@ bool AnalysisPredictor::PrepareScope(
     status_is_cloned_ = false;
   }
   sub_scope_ = &scope_->NewScope();
+  if (config_.scope_arena_enabled()) {
+    sub_scope_->EnableArena();
+  }
   return true;
 }
 
@@ -986,6 +1249,12 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
           pass->name() == "conv2d_add_fuse_pass") {
         pass->Set("use_cutlass", new bool(config_.use_cutlass_));
       }
+      if (pass->name() == "fused_weight_only_linear_pass") {
+        pass->Set("weight_only_algo",
+                  new std::string(config_.weight_only_algo_));
+        pass->Set("weight_only_group_size",
+                  new int(config_.weight_only_group_size_));
+      }
     }
 
     if (!config_.glog_info_disabled()) {
@@ -1005,6 +1274,7 @@ void AnalysisPredictor::OptimizeInferencePirProgram() {
       pir::WriteModule(*pir_program_, optimized_model, 1, true, false, true);
       LOG(INFO) << "Optimized model saved to " << optimized_model;
       SaveOrLoadPirParameters(true);
+      SaveOptimizedModelKey();
     }
   }
 
@@ -1186,7 +1456,9 @@ bool AnalysisPredictor::SaveOrLoadPirParameters(bool for_save) {
         dev_ctx = pool.Get(phi::CPUPlace());
         pir::Type type_ = pir::GetDataTypeFromValue(value);
         phi::DataType type_data = paddle::dialect::TransToPhiDataType(type_);
-        dev_ctx->Alloc(tensor_temp, type_data);
+        // the mapped params file provides the memory of the parameters
+        dev_ctx->Alloc(
+            tensor_temp, type_data, 0, false, UseMmapParams(config_));
       } else {
         PADDLE_THROW(common::errors::Unavailable(
             "Only support parameter data of type DenseTensor."));
@@ -1214,8 +1486,12 @@ bool AnalysisPredictor::SaveOrLoadPirParameters(bool for_save) {
         const_tensor_out, param_names, optimized_params, true, false, true);
     LOG(INFO) << "Optimized params saved to " << optimized_params;
   } else {
-    pir::LoadCombineFunction(
-        config_.params_file(), filter_param_names, &tensor_out, false, place_);
+    pir::LoadCombineFunction(config_.params_file(),
+                             filter_param_names,
+                             &tensor_out,
+                             false,
+                             place_,
+                             UseMmapParams(config_));
   }
   return true;
 }
@@ -1274,6 +1550,9 @@ bool AnalysisPredictor::PrepareProgram(
 #endif
     } else {
       OptimizeInferenceProgram();
+      if (config_.save_optimized_model_ && config_.enable_ir_optim_) {
+        SaveOptimizedModelKey();
+      }
     }
   } else {
     // If the program is passed from external, no need to optimize it, this
@@ -1386,6 +1665,14 @@ bool AnalysisPredictor::PrepareExecutor() {
             root_predictor_id_, "memory_optimize_pass");
     executor_->MakeReusePlan(reuse_table);
   }
+
+  // oneDNN keeps its cache per thread, so its ops stay on the calling thread
+  if (FLAGS_naive_executor_inter_op_threads > 1 &&
+      !config_.new_executor_enabled() && !config_.new_ir_enabled() &&
+      phi::is_cpu_place(place_) && !config_.mkldnn_enabled()) {
+    executor_->EnableInterOpParallel(FLAGS_naive_executor_inter_op_threads,
+                                     config_.cpu_math_library_num_threads());
+  }
   return true;
 }
 
@@ -1432,10 +1719,20 @@ void AnalysisPredictor::MkldnnPreSet(
   }
   phi::OneDNNContext::tls().set_cur_input_shape_cache_capacity(
       config_.mkldnn_cache_capacity_);
+  // the thread may have run another predictor before
+  phi::OneDNNContext::tls().set_primitive_cache_scope(
+      config_.mkldnn_primitive_sharing_ ? MkldnnPrimitiveCacheScope() : "");
 
 #endif
 }
 
+#ifdef PADDLE_WITH_DNNL
+std::string AnalysisPredictor::MkldnnPrimitiveCacheScope() const {
+  // a clone runs the program of its root predictor
+  return "predictor" + std::to_string(root_predictor_id_);
+}
+#endif
+
 void AnalysisPredictor::MkldnnPostReset() {
 #ifdef PADDLE_WITH_DNNL
   // In cache clearing mode.
@@ -1465,6 +1762,10 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
                             std::vector<PaddleTensor> *output_data,
                             int batch_size) {
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  if (numa_node_ >= 0) {
+    paddle::platform::BindToNumaNode(numa_node_,
+                                     config_.cpu_math_library_num_threads());
+  }
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1494,12 +1795,21 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
     HookCollectShapeRangeInfo();
   }
 
-  if (config_.new_executor_enabled()) {  // NOLINT
-    executor_->RunInterpreterCore();
-  } else {
-    // Run the inference program
-    // if share variables, we need not create variables
-    executor_->Run();
+  {
+    details::ScopedStageTimer run_timer(run_telemetry_.get(),
+                                        details::RunTelemetry::kRun);
+    {
+      details::ScopedStageTimer dispatch_timer(
+          run_telemetry_.get(), details::RunTelemetry::kDispatch);
+      if (config_.new_executor_enabled()) {  // NOLINT
+        executor_->RunInterpreterCore();
+      } else {
+        // Run the inference program
+        // if share variables, we need not create variables
+        executor_->Run();
+      }
+    }
+    WaitForRunTelemetry();
   }
 
   // get fetch variable
@@ -1517,6 +1827,9 @@ bool AnalysisPredictor::Run(const std::vector<PaddleTensor> &inputs,
     tensor_array_batch_cleaner_.CollectNoTensorVars(sub_scope_);
   }
   tensor_array_batch_cleaner_.ResetNoTensorVars();
+  if (config_.activation_memory_sharing()) {
+    ReleaseActivations();
+  }
 
   // recover the cpu_math_library_num_threads to 1, in order to avoid thread
   // conflict when integrating it into deployment service.
@@ -1542,6 +1855,10 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
     pool.SyncDeviceContext(place_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  if (numa_node_ >= 0) {
+    paddle::platform::BindToNumaNode(numa_node_,
+                                     config_.cpu_math_library_num_threads());
+  }
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) MkldnnPreSet(inputs);
 #endif
@@ -1597,12 +1914,21 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
   }
 #endif
 
-  if (config_.new_executor_enabled()) {  // NOLINT
-    executor_->RunInterpreterCore();
-  } else {
-    // Run the inference program
-    // if share variables, we need not create variables
-    executor_->Run();
+  {
+    details::ScopedStageTimer run_timer(run_telemetry_.get(),
+                                        details::RunTelemetry::kRun);
+    {
+      details::ScopedStageTimer dispatch_timer(
+          run_telemetry_.get(), details::RunTelemetry::kDispatch);
+      if (config_.new_executor_enabled()) {  // NOLINT
+        executor_->RunInterpreterCore();
+      } else {
+        // Run the inference program
+        // if share variables, we need not create variables
+        executor_->Run();
+      }
+    }
+    WaitForRunTelemetry();
   }
 
   inference::DisplayMemoryInfo(place_, "after run");
@@ -1620,6 +1946,9 @@ bool AnalysisPredictor::Run(const std::vector<paddle::Tensor> &inputs,
   // Fix TensorArray reuse not cleaned bug.
   tensor_array_batch_cleaner_.CollectTensorArrays(sub_scope_);
   tensor_array_batch_cleaner_.ResetTensorArray();
+  if (config_.activation_memory_sharing()) {
+    ReleaseActivations();
+  }
 
   // recover the cpu_math_library_num_threads to 1, in order to avoid thread
   // conflict when integrating it into deployment service.
@@ -2402,6 +2731,7 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetInputTensor(
   std::unique_ptr<ZeroCopyTensor> res(new ZeroCopyTensor(
       static_cast<void *>(scope), this->GetDeviceContexts()));
   res->input_or_output_ = true;
+  res->telemetry_ = run_telemetry_.get();
   res->SetName(name);
   if (phi::is_cpu_place(place_)) {  // NOLINT
     res->SetPlace(PaddlePlace::kCPU);
@@ -2420,6 +2750,13 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetInputTensor(
   } else {
     auto gpu_place = place_;
     res->SetPlace(PaddlePlace::kGPU, gpu_place.GetDeviceId());
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    if (input_stager_ == nullptr) {
+      input_stager_ = std::make_unique<details::AsyncInputStager>(
+          phi::GPUPlace(gpu_place.GetDeviceId()));
+    }
+    res->input_stager_ = input_stager_.get();
+#endif
   }
   return res;
 }
@@ -2436,6 +2773,7 @@ std::unique_ptr<ZeroCopyTensor> AnalysisPredictor::GetOutputTensor(
   std::unique_ptr<ZeroCopyTensor> res(new ZeroCopyTensor(
       static_cast<void *>(scope), this->GetDeviceContexts()));
   res->input_or_output_ = false;
+  res->telemetry_ = run_telemetry_.get();
   res->SetName(name);
   if (phi::is_cpu_place(place_)) {  // NOLINT
     res->SetPlace(PaddlePlace::kCPU);
@@ -2466,6 +2804,10 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
     pool.SyncDeviceContext(place_);
   }
   paddle::platform::SetNumThreads(config_.cpu_math_library_num_threads());
+  if (numa_node_ >= 0) {
+    paddle::platform::BindToNumaNode(numa_node_,
+                                     config_.cpu_math_library_num_threads());
+  }
 #ifdef PADDLE_WITH_DNNL
   if (config_.use_mkldnn_) {
     std::vector<std::vector<int>> shape_vector;
@@ -2521,10 +2863,21 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   }
 #endif
 
-  if (config_.new_executor_enabled()) {  // NOLINT
-    executor_->RunInterpreterCore({}, false, switch_stream);
-  } else {
-    executor_->Run();
+  {
+    details::ScopedStageTimer run_timer(run_telemetry_.get(),
+                                        details::RunTelemetry::kRun);
+    {
+      details::ScopedStageTimer dispatch_timer(
+          run_telemetry_.get(), details::RunTelemetry::kDispatch);
+      if (config_.cuda_graph_enabled()) {
+        RunWithCUDAGraph(switch_stream);
+      } else if (config_.new_executor_enabled()) {  // NOLINT
+        executor_->RunInterpreterCore({}, false, switch_stream);
+      } else {
+        executor_->Run();
+      }
+    }
+    WaitForRunTelemetry();
   }
   inference::DisplayMemoryInfo(place_, "after run");
 
@@ -2550,6 +2903,9 @@ bool AnalysisPredictor::ZeroCopyRun(bool switch_stream) {
   // Fix TensorArray reuse not cleaned bug.
   tensor_array_batch_cleaner_.CollectTensorArrays(sub_scope_);
   tensor_array_batch_cleaner_.ResetTensorArray();
+  if (config_.activation_memory_sharing()) {
+    ReleaseActivations();
+  }
 
   // recover the cpu_math_library_num_threads to 1, in order to avoid thread
   // conflict when integrating it into deployment service.
@@ -2611,6 +2967,8 @@ bool AnalysisPredictor::ExpRunWithExternalStream(const gpuStream_t stream) {
 #endif
 
 void AnalysisPredictor::HookCollectShapeRangeInfo() {
+  // called once per run
+  ++num_shape_collect_runs_;
   if (config_.new_executor_enabled()) {
     LOG_FIRST_N(WARNING, 1)
         << "When collecting shapes, it is recommended to run multiple loops to "
@@ -2642,6 +3000,7 @@ void AnalysisPredictor::HookCollectShapeRangeInfo() {
       shape[i] = static_cast<int32_t>(dim[i]);
     if (!shape.empty()) {
       shape_info_[input_name].emplace_back(shape);
+      shape_info_runs_[input_name].push_back(num_shape_collect_runs_);
     } else if (tensor->numel() > 0) {
       // This must be a zero dimension tensor.
       PADDLE_ENFORCE_EQ(tensor->numel(),
@@ -2651,6 +3010,7 @@ void AnalysisPredictor::HookCollectShapeRangeInfo() {
                             tensor->numel()));
       std::vector<int32_t> zero_shape(1, 1);
       shape_info_[input_name].emplace_back(zero_shape);
+      shape_info_runs_[input_name].push_back(num_shape_collect_runs_);
     }
 
     // We need collect value range for shape tensor for Paddle-TRT's use.
@@ -2792,6 +3152,72 @@ void AnalysisPredictor::StatisticShapeRangeInfo() {
                                      min_values,
                                      max_values,
                                      opt_values);
+  if (config_.trt_shape_profile_num() <= 1) {
+    return;
+  }
+
+  // Cluster the runs by their size, the sum of the largest shape of every
+  // tensor, and give every cluster a profile of its own.
+  std::map<int, std::map<std::string, int64_t>> run_tensor_sizes;
+  for (auto const &it : shape_info_) {
+    const auto &runs = shape_info_runs_[it.first];
+    for (size_t i = 0; i < it.second.size(); ++i) {
+      int64_t numel = std::accumulate(it.second[i].begin(),
+                                      it.second[i].end(),
+                                      static_cast<int64_t>(1),
+                                      std::multiplies<int64_t>());
+      auto &size = run_tensor_sizes[runs[i]][it.first];
+      size = std::max(size, numel);
+    }
+  }
+  std::vector<int> run_ids;
+  std::vector<int64_t> run_sizes;
+  for (auto const &run : run_tensor_sizes) {
+    int64_t size = 0;
+    for (auto const &tensor : run.second) size += tensor.second;
+    run_ids.push_back(run.first);
+    run_sizes.push_back(size);
+  }
+  auto clusters =
+      inference::ClusterShapeSizes(run_sizes, config_.trt_shape_profile_num());
+  std::map<int, int> run_clusters;
+  int num_clusters = 0;
+  for (size_t i = 0; i < clusters.size(); ++i) {
+    run_clusters[run_ids[i]] = clusters[i];
+    num_clusters = std::max(num_clusters, clusters[i] + 1);
+  }
+  if (num_clusters <= 1) {
+    return;
+  }
+
+  // tensors not seen in the runs of a cluster keep the range of all runs
+  std::vector<std::map<std::string, std::vector<int32_t>>> profile_min_shapes(
+      num_clusters, min_shapes);
+  std::vector<std::map<std::string, std::vector<int32_t>>> profile_max_shapes(
+      num_clusters, max_shapes);
+  std::vector<std::map<std::string, std::vector<int32_t>>> profile_opt_shapes(
+      num_clusters, opt_shapes);
+  for (int c = 0; c < num_clusters; ++c) {
+    decltype(shape_info_) cluster_shape_info;
+    for (auto const &it : shape_info_) {
+      const auto &runs = shape_info_runs_[it.first];
+      for (size_t i = 0; i < it.second.size(); ++i) {
+        if (run_clusters[runs[i]] == c) {
+          cluster_shape_info[it.first].push_back(it.second[i]);
+        }
+      }
+    }
+    extract_min_max_opt(profile_min_shapes[c],
+                        profile_max_shapes[c],
+                        profile_opt_shapes[c],
+                        cluster_shape_info);
+  }
+  LOG(INFO) << "Collect " << num_clusters
+            << " TensorRT shape profiles from " << run_ids.size() << " runs.";
+  inference::SerializeShapeRangeProfiles(config_.shape_range_info_path(),
+                                         profile_min_shapes,
+                                         profile_max_shapes,
+                                         profile_opt_shapes);
 }
 
 bool AnalysisPredictor::LoadProgramDesc() {
@@ -2929,6 +3355,119 @@ void AnalysisPredictor::ClearIntermediateTensor() {
   }
 }
 
+void AnalysisPredictor::CollectPersistentVarNames() {
+  // the tensors holding memory before the first run are the parameters
+  persistent_var_names_.clear();
+  auto *scope = executor_->GetScope();
+  for (const auto &name : scope->LocalVarNames()) {
+    auto *variable = scope->FindLocalVar(name);
+    if (variable != nullptr && variable->IsType<phi::DenseTensor>() &&
+        variable->Get<phi::DenseTensor>().IsInitialized()) {
+      persistent_var_names_.insert(name);
+    }
+  }
+}
+
+void AnalysisPredictor::ReleaseActivations() {
+  std::unordered_set<std::string> kept_names(persistent_var_names_);
+  for (const auto &item : feed_names_) {
+    kept_names.insert(item.first);
+  }
+  for (const auto &item : idx2fetches_) {
+    kept_names.insert(item.second);
+  }
+  kept_names.insert(framework::kFeedOpType);
+  kept_names.insert(framework::kFetchOpType);
+
+  auto *scope = executor_->GetScope();
+  for (const auto &name : scope->LocalVarNames()) {
+    if (kept_names.count(name)) {
+      continue;
+    }
+    auto *variable = scope->FindLocalVar(name);
+    if (variable != nullptr && variable->IsType<phi::DenseTensor>()) {
+      VLOG(4) << "Release activation: " << name;
+      variable->GetMutable<phi::DenseTensor>()->clear();
+    }
+  }
+}
+
+void AnalysisPredictor::RunWithCUDAGraph(bool switch_stream) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  auto *scope = executor_->GetScope();
+  std::vector<phi::DenseTensor *> inputs;
+  std::stringstream ss;
+  for (const auto &name : GetInputNames()) {
+    auto *tensor = scope->FindVar(name)->GetMutable<phi::DenseTensor>();
+    inputs.push_back(tensor);
+    ss << name << ":" << tensor->dtype() << "[" << tensor->dims() << "];";
+  }
+  std::string key = ss.str();
+
+  auto it = cuda_graphs_.find(key);
+  if (it == cuda_graphs_.end()) {
+    // allocates the memory and runs what a capture can not, e.g. the lazy
+    // initialization of handles and workspaces
+    executor_->RunInterpreterCore({}, false, switch_stream);
+    if (cuda_graphs_.size() >=
+        static_cast<size_t>(config_.cuda_graph_max_num_graphs())) {
+      return;
+    }
+
+    CapturedCUDAGraph captured;
+    for (auto *tensor : inputs) {
+      captured.inputs.push_back(*tensor);
+    }
+    bool use_cuda_graph = FLAGS_new_executor_use_cuda_graph;
+    FLAGS_new_executor_use_cuda_graph = true;
+    platform::BeginCUDAGraphCapture(phi::GPUPlace(place_.GetDeviceId()),
+                                    phi::gpuStreamCaptureModeThreadLocal);
+    try {
+      executor_->RunInterpreterCore({}, false, switch_stream);
+    } catch (...) {
+      platform::EndCUDAGraphCapture();
+      FLAGS_new_executor_use_cuda_graph = use_cuda_graph;
+      throw;
+    }
+    captured.graph = platform::EndCUDAGraphCapture();
+    FLAGS_new_executor_use_cuda_graph = use_cuda_graph;
+    for (const auto &name : GetOutputNames()) {
+      captured.outputs.push_back(
+          *scope->FindVar(name)->GetMutable<phi::DenseTensor>());
+    }
+    VLOG(3) << "Captured CUDA Graph " << cuda_graphs_.size() << " for inputs "
+            << key;
+    it = cuda_graphs_.emplace(key, std::move(captured)).first;
+  }
+
+  auto &captured = it->second;
+  auto stream = static_cast<phi::GPUContext *>(
+                    phi::DeviceContextPool::Instance().Get(place_))
+                    ->stream();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    auto &buffer = captured.inputs[i];
+    if (inputs[i]->initialized() && inputs[i]->data() != buffer.data()) {
+      paddle::memory::Copy(buffer.place(),
+                           buffer.data(),
+                           inputs[i]->place(),
+                           inputs[i]->data(),
+                           inputs[i]->numel() * phi::SizeOf(inputs[i]->dtype()),
+                           stream);
+    }
+  }
+  captured.graph->Replay();
+  auto output_names = GetOutputNames();
+  for (size_t i = 0; i < output_names.size(); ++i) {
+    scope->FindVar(output_names[i])
+        ->GetMutable<phi::DenseTensor>()
+        ->ShareDataWith(captured.outputs[i]);
+  }
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "CUDA Graph needs Paddle compiled with CUDA."));
+#endif
+}
+
 #ifdef PADDLE_WITH_TENSORRT
 using inference::Singleton;
 bool AnalysisPredictor::SaveTrtCalibToDisk() {
@@ -3003,6 +3542,16 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
                               "./profile.log");
   }
 
+#ifdef PADDLE_WITH_DNNL
+  if (config_.mkldnn_primitive_sharing_ && !status_is_cloned_) {
+    auto stats = phi::OneDNNPrimitiveCache::Instance().GetStats();
+    VLOG(1) << "Shared OneDNN primitives: " << stats.num_entries
+            << " entries of " << stats.memory_bytes << " bytes, "
+            << stats.hits << " hits, " << stats.misses << " misses.";
+    phi::OneDNNPrimitiveCache::Instance().Erase(MkldnnPrimitiveCacheScope());
+  }
+#endif
+
   if (sub_scope_) {
     if (framework::global_transfer_scope_key().find(sub_scope_) !=
         framework::global_transfer_scope_key().end()) {
@@ -3014,6 +3563,10 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
     }
     scope_->DeleteScope(sub_scope_);
   }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // after the scope, whose tensors may hold memory of the graph pools
+  cuda_graphs_.clear();
+#endif
 
   if (config_.shape_range_info_collected()) {
     StatisticShapeRangeInfo();
@@ -3039,11 +3592,6 @@ AnalysisPredictor::~AnalysisPredictor() {  // NOLINT
 
 std::unique_ptr<PaddlePredictor> AnalysisPredictor::Clone(void *stream) {
   VLOG(3) << "AnalysisPredictor::Clone";
-  std::lock_guard<std::mutex> lk(clone_mutex_);
-  auto *x = new AnalysisPredictor(config_);
-  x->status_is_cloned_ = true;
-  x->root_predictor_id_ = this->root_predictor_id_;
-  x->config_.apply_optim_ = false;
   if (config_.use_external_stream_ && stream == nullptr) {
     PADDLE_THROW(common::errors::InvalidArgument(
         "config has been configured to use external stream, but the Clone "
@@ -3053,14 +3601,96 @@ std::unique_ptr<PaddlePredictor> AnalysisPredictor::Clone(void *stream) {
         "config has not been configured to use external stream, but the Clone "
         "function has received a stream parameter."));
   }
+  return CloneImpl(stream, false);
+}
+
+std::unique_ptr<PaddlePredictor> AnalysisPredictor::CloneOnNewStream() {
+  VLOG(3) << "AnalysisPredictor::CloneOnNewStream";
+  return CloneImpl(nullptr, config_.use_gpu());
+}
+
+std::unique_ptr<PaddlePredictor> AnalysisPredictor::CloneImpl(
+    void *stream, bool own_stream) {
+  std::lock_guard<std::mutex> lk(clone_mutex_);
+  auto *x = new AnalysisPredictor(config_);
+  x->status_is_cloned_ = true;
+  x->own_stream_ = own_stream;
+  x->root_predictor_id_ = this->root_predictor_id_;
+  x->config_.apply_optim_ = false;
   x->predictor_stream_ = stream;
-  x->Init(scope_, inference_program_);
+  std::shared_ptr<framework::Scope> scope = scope_;
+  if (numa_replicas_) {
+    int num_clones = 0;
+    {
+      std::lock_guard<std::mutex> lock(numa_replicas_->mutex);
+      num_clones = ++numa_replicas_->num_clones;
+    }
+    x->numa_node_ =
+        num_clones % static_cast<int>(numa_replicas_->scopes.size());
+    x->numa_replicas_ = numa_replicas_;
+    scope = GetNumaReplicaScope(x->numa_node_);
+  }
+  x->Init(scope, inference_program_);
 #ifdef PADDLE_WITH_TENSORRT
   x->executor_->ResetTrtOps(++AnalysisPredictor::clone_num_);
 #endif
   return std::unique_ptr<PaddlePredictor>(x);
 }
 
+std::shared_ptr<framework::Scope> AnalysisPredictor::GetNumaReplicaScope(
+    int node) {
+  std::lock_guard<std::mutex> lock(numa_replicas_->mutex);
+  auto &replica = numa_replicas_->scopes[node];
+  if (replica) {
+    return replica;
+  }
+  const auto &root = numa_replicas_->scopes[0];
+  std::vector<std::string> names = root->LocalVarNames();
+  for (const auto &name : names) {
+    auto *var = root->FindLocalVar(name);
+    if (var->IsInitialized() && !var->IsType<phi::DenseTensor>() &&
+        !var->IsType<framework::FeedList>() &&
+        !var->IsType<framework::FetchList>()) {
+      LOG(WARNING) << "Variable " << name << " can not be replicated on NUMA "
+                   << "node " << node << ", the clones share the weights.";
+      replica = root;
+      return replica;
+    }
+  }
+
+  // copy on a thread of the node, so that first touch places the copies in
+  // the memory of the node
+  auto scope = std::make_shared<framework::Scope>();
+  std::exception_ptr error;
+  std::thread copier([&] {
+    try {
+      paddle::platform::BindToNumaNode(node, 1);
+      for (const auto &name : names) {
+        auto *var = root->FindLocalVar(name);
+        if (!var->IsType<phi::DenseTensor>()) {
+          continue;
+        }
+        const auto &src = var->Get<phi::DenseTensor>();
+        auto *dst = scope->Var(name)->GetMutable<phi::DenseTensor>();
+        if (src.initialized()) {
+          framework::TensorCopySync(src, phi::CPUPlace(), dst);
+        }
+        dst->ResetLoD(src.lod());
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+  });
+  copier.join();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  VLOG(3) << "Replicate " << names.size() << " variables on NUMA node "
+          << node;
+  replica = scope;
+  return replica;
+}
+
 std::string AnalysisPredictor::GetSerializedProgram() const {
   return inference_program_->Proto()->SerializeAsString();
 }
@@ -3468,6 +4098,10 @@ void Predictor::RegisterInputHook(const InputTensorHookFunc &hookfunc) {
 
 void *Predictor::GetExecStream() const { return predictor_->GetExecStream(); }
 
+std::string Predictor::GetRunTelemetry() const {
+  return predictor_->GetRunTelemetry();
+}
+
 int GetNumBytesOfDataType(DataType dtype) {
   switch (dtype) {
     case DataType::FLOAT32:
@@ -3569,6 +4203,103 @@ Predictor *PredictorPool::Retrieve(size_t idx) {
   }
   return preds_[idx - 1].get();
 }
+
+ConcurrentPredictor::ConcurrentPredictor(const Config &config,
+                                         size_t max_streams)
+    : max_streams_(max_streams) {
+  PADDLE_ENFORCE_GE(
+      max_streams,
+      1UL,
+      common::errors::InvalidArgument(
+          "The max streams of the concurrent predictor should be greater "
+          "than 0, but it's (%d)",
+          max_streams));
+  // the executors keep no intermediate tensors between requests
+  Config copy_config(config);
+  copy_config.EnableActivationMemorySharing();
+  main_pred_ =
+      paddle::CreatePaddlePredictor<Config,
+                                    paddle::PaddleEngineKind::kAnalysis>(
+          copy_config);
+}
+
+ConcurrentPredictor::~ConcurrentPredictor() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] { return idle_preds_.size() == preds_.size(); });
+}
+
+bool ConcurrentPredictor::Run(const std::vector<paddle::Tensor> &inputs,
+                              std::vector<paddle::Tensor> *outputs) {
+  paddle::PaddlePredictor *pred = nullptr;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] {
+      return !idle_preds_.empty() || preds_.size() < max_streams_;
+    });
+    if (!idle_preds_.empty()) {
+      pred = idle_preds_.back();
+      idle_preds_.pop_back();
+    } else {
+      // clone out of the lock, the slot is taken by a null executor
+      preds_.emplace_back(nullptr);
+    }
+  }
+  if (pred == nullptr) {
+    auto *main_pred =
+        dynamic_cast<paddle::AnalysisPredictor *>(main_pred_.get());
+    std::unique_ptr<paddle::PaddlePredictor> clone;
+    try {
+      clone = main_pred->CloneOnNewStream();
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      preds_.erase(std::find(preds_.begin(), preds_.end(), nullptr));
+      cv_.notify_all();
+      throw;
+    }
+    pred = clone.get();
+    std::lock_guard<std::mutex> lock(mutex_);
+    *std::find(preds_.begin(), preds_.end(), nullptr) = std::move(clone);
+  }
+
+  auto release = [&] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_preds_.push_back(pred);
+    cv_.notify_all();
+  };
+  bool ret = false;
+  try {
+    ret = pred->Run(inputs, outputs);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    // the outputs are ready and the executor can take the next request
+    auto stream = static_cast<gpuStream_t>(pred->GetExecStream());
+    if (ret && stream != nullptr) {
+#ifdef PADDLE_WITH_HIP
+      hipStreamSynchronize(stream);
+#else
+      cudaStreamSynchronize(stream);
+#endif
+    }
+#endif
+  } catch (...) {
+    release();
+    throw;
+  }
+  release();
+  return ret;
+}
+
+std::vector<std::string> ConcurrentPredictor::GetInputNames() {
+  return main_pred_->GetInputNames();
+}
+
+std::vector<std::string> ConcurrentPredictor::GetOutputNames() {
+  return main_pred_->GetOutputNames();
+}
+
+size_t ConcurrentPredictor::GetNumExecutors() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return preds_.size();
+}
 }  // namespace services
 
 namespace experimental {
@@ -18,13 +18,16 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "paddle/fluid/framework/naive_executor.h"
 #include "paddle/fluid/framework/op_compatible_info.h"
 #include "paddle/fluid/inference/analysis/analyzer.h"
 #include "paddle/fluid/inference/api/api_impl.h"
+#include "paddle/fluid/inference/api/details/async_input_stager.h"
 #include "paddle/fluid/inference/api/details/reset_tensor_array.h"
+#include "paddle/fluid/inference/api/details/run_telemetry.h"
 #include "paddle/fluid/inference/api/helper.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/resource_manager.h"
@@ -43,6 +46,12 @@
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/program.h"
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+namespace phi::backends::gpu {
+class CUDAGraph;
+}  // namespace phi::backends::gpu
+#endif
+
 namespace paddle_infer {
 using float16 = phi::dtype::float16;
 using bfloat16 = phi::dtype::bfloat16;
@@ -229,6 +238,14 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   void *GetExecStream() const override;
 
+  ///
+  /// \brief Get the latency histograms of the stages of the runs.
+  ///
+  /// \return The histograms in the Prometheus text format, empty when
+  /// Config::EnableRunTelemetry is off.
+  ///
+  std::string GetRunTelemetry() const override;
+
   ///
   /// \brief Create feed fetch variables
   ///
@@ -273,6 +290,13 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   uint64_t TryShrinkMemory() override;
 
+  ///
+  /// \brief Return the memory of the intermediate tensors, other than the
+  /// inputs and outputs, to the memory pool. Called after every run when
+  /// activation memory sharing is on.
+  ///
+  void ReleaseActivations();
+
   ///
   /// \brief Get the argument used by predictor
   ///
@@ -286,6 +310,13 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   std::unique_ptr<PaddlePredictor> Clone(void *stream = nullptr) override;
   ///
+  /// \brief Clone to get a new predictor that runs on a new stream of its
+  /// own on GPU, whatever the stream of this predictor is. thread safe.
+  ///
+  /// \return get a new predictor
+  ///
+  std::unique_ptr<PaddlePredictor> CloneOnNewStream();
+  ///
   /// \brief Get the scope used by predictor
   ///
   /// \return scope
@@ -362,6 +393,17 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   bool CreateExecutor();
   ///
+  /// \brief Record the tensors of the executor scope that already hold
+  /// memory, which ReleaseActivations keeps.
+  ///
+  void CollectPersistentVarNames();
+  ///
+  /// \brief Run the program through the CUDA Graph captured for the shapes
+  /// of the inputs, capture it after a launch of the kernels if there is
+  /// none yet.
+  ///
+  void RunWithCUDAGraph(bool switch_stream);
+  ///
   /// \brief According to the model's program, the executor creates ops
   ///
   /// \return Whether the function executed successfully
@@ -471,6 +513,14 @@ class AnalysisPredictor : public PaddlePredictor {
   ///
   void MkldnnPostReset();
 
+#ifdef PADDLE_WITH_DNNL
+  ///
+  /// \brief The scope of the OneDNN primitives shared by the predictor and
+  /// its clones.
+  ///
+  std::string MkldnnPrimitiveCacheScope() const;
+#endif
+
 #ifdef PADDLE_WITH_TENSORRT
   ///
   /// \brief save calibration table
@@ -504,10 +554,30 @@ class AnalysisPredictor : public PaddlePredictor {
   void StatisticShapeRangeInfo();
   void HookCollectShapeRangeInfo();
   void InitPlace();
+
+  ///
+  /// \brief Wait for the device to finish the ops of the run, timed as the
+  /// sync_wait of the run telemetry.
+  ///
+  void WaitForRunTelemetry();
+
+  ///
+  /// \brief Clone with the given stream, or a new stream when own_stream.
+  ///
+  std::unique_ptr<PaddlePredictor> CloneImpl(void *stream, bool own_stream);
+
+  ///
+  /// \brief Run the predictor once for each of the max, opt and min shapes
+  /// of the shape info file of the warm-up.
+  ///
+  void Warmup();
   void InitDeviceContexts();
   void InitResourceManager(void *stream);
   std::string GetOptimizedModelPath();
+  std::string GetOptimizedModelKey();
+  void SaveOptimizedModelKey();
   void ClearExtraParams();
+  std::shared_ptr<framework::Scope> GetNumaReplicaScope(int node);
 
  private:
   AnalysisConfig config_;
@@ -520,6 +590,8 @@ class AnalysisPredictor : public PaddlePredictor {
   std::shared_ptr<framework::ProgramDesc> inference_program_;
   std::shared_ptr<pir::Program> pir_program_;
   bool load_pir_model_{false};
+  // identifies the model, config and device an optimized model is saved for
+  std::string optimized_model_key_;
   std::vector<framework::OpDesc *> feeds_;
   std::vector<pir::Operation *> pir_feeds_;
   std::map<std::string, size_t> feed_names_;
@@ -530,8 +602,25 @@ class AnalysisPredictor : public PaddlePredictor {
   std::vector<pir::Operation *> pir_fetches_;
   std::map<size_t, std::string> idx2fetches_;
   std::map<std::string, std::vector<int64_t>> fetch_name2shapes_;
+  // tensors initialized before the first run, kept by ReleaseActivations
+  std::unordered_set<std::string> persistent_var_names_;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // a CUDA Graph and the feed and fetch tensors it reads and writes
+  struct CapturedCUDAGraph {
+    std::unique_ptr<phi::backends::gpu::CUDAGraph> graph;
+    std::vector<phi::DenseTensor> inputs;
+    std::vector<phi::DenseTensor> outputs;
+  };
+  // keyed by the names, data types and shapes of the inputs
+  std::map<std::string, CapturedCUDAGraph> cuda_graphs_;
+  // copies the inputs of Tensor::CopyFromCpuAsync
+  std::unique_ptr<details::AsyncInputStager> input_stager_;
+#endif
 
   phi::DataType model_precision_{phi::DataType::FLOAT32};
+  // the latency of the stages of the runs, if Config::EnableRunTelemetry
+  std::unique_ptr<details::RunTelemetry> run_telemetry_;
 
   // Memory buffer for feed inputs. The temporary DenseTensor will cause serious
   // concurrency problems, wrong results and memory leak, so cache them.
@@ -541,6 +630,17 @@ class AnalysisPredictor : public PaddlePredictor {
   std::mutex clone_mutex_;
   static int clone_num_;
 
+  // the NUMA node the predictor runs on, -1 without NUMA sharding
+  int numa_node_{-1};
+  // the scopes of the weights per NUMA node, shared by the predictor and all
+  // its clones, the one of node 0 is the scope of the predictor
+  struct NumaReplicas {
+    std::mutex mutex;
+    int num_clones{0};
+    std::vector<std::shared_ptr<framework::Scope>> scopes;
+  };
+  std::shared_ptr<NumaReplicas> numa_replicas_;
+
   int predictor_id_;
   int root_predictor_id_{-1};
 
@@ -551,8 +651,13 @@ class AnalysisPredictor : public PaddlePredictor {
   std::vector<InputTensorHookFunc> input_hookfuncs_;
   // Some status here that help to determine the status inside the predictor.
   bool status_is_cloned_{false};
+  // The clone creates a stream of its own instead of the stream of config.
+  bool own_stream_{false};
 
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_info_;
+  // the run every shape of shape_info_ was collected in
+  std::map<std::string, std::vector<int>> shape_info_runs_;
+  int num_shape_collect_runs_{0};
   std::map<std::string, std::vector<std::vector<int32_t>>> shape_tensor_value_;
 
   bool private_context_{false};
@@ -0,0 +1,148 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/async_input_stager.h"
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/fluid/platform/enforce.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+
+namespace paddle {
+namespace details {
+
+namespace {
+
+#ifdef PADDLE_WITH_HIP
+void SetCopied(gpuStream_t, gpuError_t, void *user_data)
+#else
+void CUDART_CB SetCopied(void *user_data)
+#endif
+{
+  std::unique_ptr<std::promise<void>> copied(
+      static_cast<std::promise<void> *>(user_data));
+  copied->set_value();
+}
+
+}  // namespace
+
+AsyncInputStager::AsyncInputStager(const phi::GPUPlace &place)
+    : place_(place) {}
+
+AsyncInputStager::~AsyncInputStager() {
+  if (copy_stream_ == nullptr) {
+    return;
+  }
+  phi::backends::gpu::GPUDeviceGuard guard(place_.device);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamSynchronize(copy_stream_));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamSynchronize(copy_stream_));
+#endif
+  for (auto &input : inputs_) {
+    for (auto &event : input.second.released) {
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventDestroy(event));
+    }
+  }
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventDestroy(copied_));
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamDestroy(copy_stream_));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamDestroy(copy_stream_));
+#endif
+}
+
+std::shared_future<void> AsyncInputStager::CopyFromCpu(
+    const std::string &name,
+    phi::DenseTensor *tensor,
+    phi::DataType dtype,
+    const void *data,
+    size_t size,
+    const phi::GPUContext &dev_ctx) {
+  phi::backends::gpu::GPUDeviceGuard guard(place_.device);
+  if (copy_stream_ == nullptr) {
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipStreamCreateWithFlags(&copy_stream_, hipStreamNonBlocking));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaStreamCreateWithFlags(&copy_stream_, cudaStreamNonBlocking));
+#endif
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::gpuEventCreateWithFlags(&copied_, phi::gpuEventDisableTiming));
+  }
+  auto exec_stream = dev_ctx.stream();
+
+  auto it = inputs_.find(name);
+  if (it == inputs_.end()) {
+    it = inputs_.emplace(name, StagingBuffers()).first;
+    for (auto &event : it->second.released) {
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::gpuEventCreateWithFlags(&event, phi::gpuEventDisableTiming));
+    }
+  }
+  auto &input = it->second;
+  int next = 1 - input.active;
+  auto &buffer = input.buffers[next];
+  if (buffer == nullptr || buffer->size() < size) {
+    // The allocator orders reuse on the execution stream only, so memory it
+    // hands out again may still be read by the current run.
+    buffer = memory::AllocShared(
+        place_,
+        size,
+        phi::Stream(reinterpret_cast<phi::StreamId>(exec_stream)));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        phi::gpuEventRecord(input.released[next], exec_stream));
+  }
+
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamWaitEvent(copy_stream_, input.released[next], 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(copy_stream_, input.released[next], 0));
+#endif
+  memory::Copy(
+      place_, buffer->ptr(), phi::CPUPlace(), data, size, copy_stream_);
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventRecord(copied_, copy_stream_));
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(exec_stream, copied_, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(exec_stream, copied_, 0));
+#endif
+
+  // everything the execution stream has queued so far reads the active one
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::gpuEventRecord(input.released[input.active], exec_stream));
+  input.active = next;
+  tensor->ResetHolderWithType(buffer, dtype);
+
+  auto *copied = new std::promise<void>();
+  std::shared_future<void> future = copied->get_future().share();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      hipStreamAddCallback(copy_stream_, SetCopied, copied, 0));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaLaunchHostFunc(copy_stream_, SetCopied, copied));
+#endif
+  return future;
+}
+
+}  // namespace details
+}  // namespace paddle
+#endif
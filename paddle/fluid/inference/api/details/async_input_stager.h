@@ -0,0 +1,78 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/gpu/gpu_types.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/allocator.h"
+
+namespace phi {
+class DenseTensor;
+class GPUContext;
+}  // namespace phi
+
+namespace paddle {
+namespace details {
+
+// Copies the host inputs of a predictor to the device on a copy stream of
+// its own, so that the inputs of the next run are copied while the current
+// run computes.
+//
+// Every input alternates between two device buffers. A copy writes the
+// buffer the run before the current one read, once the execution stream is
+// done with it, and the execution stream waits for the copy before the next
+// run reads it. The host never blocks.
+class AsyncInputStager {
+ public:
+  explicit AsyncInputStager(const phi::GPUPlace& place);
+  ~AsyncInputStager();
+
+  // Points the tensor at a device buffer that holds the size bytes of data
+  // once the returned future is ready. The data must stay valid until then,
+  // and should be pinned, a copy from pageable memory blocks the host.
+  std::shared_future<void> CopyFromCpu(const std::string& name,
+                                       phi::DenseTensor* tensor,
+                                       phi::DataType dtype,
+                                       const void* data,
+                                       size_t size,
+                                       const phi::GPUContext& dev_ctx);
+
+ private:
+  struct StagingBuffers {
+    std::shared_ptr<phi::Allocation> buffers[2];
+    // recorded on the execution stream when a buffer stops being the input
+    gpuEvent_t released[2]{nullptr, nullptr};
+    int active{1};
+  };
+
+  phi::GPUPlace place_;
+  gpuStream_t copy_stream_{nullptr};
+  gpuEvent_t copied_{nullptr};
+  std::unordered_map<std::string, StagingBuffers> inputs_;
+
+  DISABLE_COPY_AND_ASSIGN(AsyncInputStager);
+};
+
+}  // namespace details
+}  // namespace paddle
+#endif
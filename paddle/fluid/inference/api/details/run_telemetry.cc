@@ -0,0 +1,85 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/details/run_telemetry.h"
+
+#include <algorithm>
+#include <sstream>
+
+namespace paddle {
+namespace details {
+
+namespace {
+
+constexpr const char* kStageNames[RunTelemetry::kNumStages] = {
+    "input_copy", "dispatch", "sync_wait", "output_copy", "run"};
+
+constexpr const char* kMetricName = "paddle_inference_stage_latency_us";
+
+}  // namespace
+
+void RunTelemetry::Record(Stage stage,
+                          std::chrono::steady_clock::duration elapsed) {
+  int64_t us =
+      std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+  size_t bucket =
+      std::lower_bound(kBucketBounds.begin(), kBucketBounds.end(), us) -
+      kBucketBounds.begin();
+  auto& histogram = histograms_[stage];
+  histogram.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  histogram.sum_us.fetch_add(us, std::memory_order_relaxed);
+  histogram.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string RunTelemetry::ToPrometheusText() const {
+  std::ostringstream os;
+  os << "# HELP " << kMetricName
+     << " Latency of the stages of the runs of a predictor.\n";
+  os << "# TYPE " << kMetricName << " histogram\n";
+  for (int stage = 0; stage < kNumStages; ++stage) {
+    const auto& histogram = histograms_[stage];
+    std::string labels =
+        "model=\"" + model_ + "\",stage=\"" + kStageNames[stage] + "\"";
+    // the buckets of Prometheus are cumulative
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i <= kBucketBounds.size(); ++i) {
+      cumulative += histogram.buckets[i].load(std::memory_order_relaxed);
+      os << kMetricName << "_bucket{" << labels << ",le=\"";
+      if (i < kBucketBounds.size()) {
+        os << kBucketBounds[i];
+      } else {
+        os << "+Inf";
+      }
+      os << "\"} " << cumulative << "\n";
+    }
+    os << kMetricName << "_sum{" << labels << "} "
+       << histogram.sum_us.load(std::memory_order_relaxed) << "\n";
+    os << kMetricName << "_count{" << labels << "} "
+       << histogram.count.load(std::memory_order_relaxed) << "\n";
+  }
+  return os.str();
+}
+
+void RunTelemetry::Reset() {
+  for (auto& histogram : histograms_) {
+    for (auto& bucket : histogram.buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    histogram.count.store(0, std::memory_order_relaxed);
+    histogram.sum_us.store(0, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace details
+}  // namespace paddle
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace details {
+
+// Latency histograms of the stages of the runs of a predictor, in
+// microseconds:
+//   input_copy:  Tensor::CopyFromCpu of the inputs
+//   dispatch:    the executor launching the ops of the program
+//   sync_wait:   the host waiting for the device to finish the launched ops
+//   output_copy: Tensor::CopyToCpu of the outputs
+//   run:         the whole Run, from dispatch to the end of sync_wait
+// Recording is lock free, so the histograms may be read while the predictor
+// runs.
+class RunTelemetry {
+ public:
+  enum Stage { kInputCopy = 0, kDispatch, kSyncWait, kOutputCopy, kRun };
+  static constexpr int kNumStages = kRun + 1;
+  // upper bounds of the buckets, the last bucket is +Inf
+  static constexpr std::array<int64_t, 12> kBucketBounds{
+      10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 100000};
+
+  explicit RunTelemetry(const std::string& model) : model_(model) {}
+
+  void Record(Stage stage, std::chrono::steady_clock::duration elapsed);
+
+  // The histograms in the Prometheus text exposition format, as
+  // paddle_inference_stage_latency_us{model="...",stage="..."}.
+  std::string ToPrometheusText() const;
+
+  void Reset();
+
+ private:
+  struct Histogram {
+    std::array<std::atomic<uint64_t>, kBucketBounds.size() + 1> buckets{};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum_us{0};
+  };
+
+  std::string model_;
+  std::array<Histogram, kNumStages> histograms_;
+
+  DISABLE_COPY_AND_ASSIGN(RunTelemetry);
+};
+
+// Records the time from its construction to its destruction, if telemetry
+// is not null.
+class ScopedStageTimer {
+ public:
+  ScopedStageTimer(RunTelemetry* telemetry, RunTelemetry::Stage stage)
+      : telemetry_(telemetry), stage_(stage) {
+    if (telemetry_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~ScopedStageTimer() {
+    if (telemetry_ != nullptr) {
+      telemetry_->Record(stage_, std::chrono::steady_clock::now() - start_);
+    }
+  }
+
+ private:
+  RunTelemetry* telemetry_;
+  RunTelemetry::Stage stage_;
+  std::chrono::steady_clock::time_point start_;
+
+  DISABLE_COPY_AND_ASSIGN(ScopedStageTimer);
+};
+
+}  // namespace details
+}  // namespace paddle
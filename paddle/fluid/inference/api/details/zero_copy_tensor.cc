@@ -16,6 +16,8 @@
 #include "paddle/fluid/framework/data_layout_transform.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/inference/api/details/async_input_stager.h"
+#include "paddle/fluid/inference/api/details/run_telemetry.h"
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/api/paddle_tensor.h"
 #include "paddle/fluid/platform/enforce.h"
@@ -193,6 +195,9 @@ PlaceType Tensor::place() const { return place_; }
 
 template <typename T>
 void Tensor::CopyFromCpu(const T *data) {
+  paddle::details::ScopedStageTimer timer(
+      static_cast<paddle::details::RunTelemetry *>(telemetry_),
+      paddle::details::RunTelemetry::kInputCopy);
   EAGER_GET_TENSOR(phi::DenseTensor);
   PADDLE_ENFORCE_GE(tensor->numel(),
                     0,
@@ -366,6 +371,45 @@ void Tensor::ShareExternalData(const T *data,
   }
 }
 
+template <typename T>
+std::shared_future<void> Tensor::CopyFromCpuAsync(const T *data) {
+  EAGER_GET_TENSOR(phi::DenseTensor);
+  PADDLE_ENFORCE_GE(tensor->numel(),
+                    0,
+                    common::errors::PreconditionNotMet(
+                        "You should call Tensor::Reshape(const "
+                        "std::vector<int> &shape)"
+                        "function before copying data from cpu."));
+  PADDLE_ENFORCE_EQ(
+      place_ == PlaceType::kGPU && input_stager_ != nullptr,
+      true,
+      common::errors::Unimplemented(
+          "CopyFromCpuAsync only supports the GPU input tensors of a "
+          "predictor now, use CopyFromCpu for tensor %s.",
+          name_));
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  phi::GPUPlace gpu_place(device_);
+  auto *dev_ctxs = reinterpret_cast<const std::map<
+      phi::Place,
+      std::shared_future<std::unique_ptr<phi::DeviceContext>>> *>(
+      device_contexts_);
+  auto *dev_ctx =
+      static_cast<phi::GPUContext *>(dev_ctxs->at(gpu_place).get().get());
+  auto *stager =
+      static_cast<paddle::details::AsyncInputStager *>(input_stager_);
+  return stager->CopyFromCpu(name_,
+                             tensor,
+                             DataTypeInfo<T>().TYPE,
+                             data,
+                             tensor->numel() * sizeof(T),
+                             *dev_ctx);
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "Can not copy tensor to CUDA place because paddle is not compiled "
+      "with CUDA."));
+#endif
+}
+
 void Tensor::CopyStringsFromCpu(const paddle_infer::Strings *data) {
   EAGER_GET_TENSOR(phi::Strings);
   PADDLE_ENFORCE_GE(tensor->size(),
@@ -382,6 +426,9 @@ void Tensor::CopyToCpuImpl(T *data,
                            void *exec_stream,
                            CallbackFunc cb,
                            void *cb_params) const {
+  paddle::details::ScopedStageTimer timer(
+      static_cast<paddle::details::RunTelemetry *>(telemetry_),
+      paddle::details::RunTelemetry::kOutputCopy);
   EAGER_GET_TENSOR(phi::DenseTensor);
   auto ele_num = tensor->numel();
   auto *t_data = tensor->data<T>();
@@ -561,6 +608,25 @@ template PD_INFER_DECL void Tensor::ShareExternalData<bool>(
     PlaceType place,
     DataLayout layout);
 
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<double>(const double *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<float>(const float *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<int64_t>(const int64_t *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<int32_t>(const int32_t *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<uint8_t>(const uint8_t *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<int8_t>(const int8_t *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<float16>(const float16 *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<bfloat16>(const bfloat16 *data);
+template PD_INFER_DECL std::shared_future<void>
+Tensor::CopyFromCpuAsync<bool>(const bool *data);
+
 template PD_INFER_DECL void Tensor::CopyToCpu<double>(double *data) const;
 template PD_INFER_DECL void Tensor::CopyToCpu<float>(float *data) const;
 template PD_INFER_DECL void Tensor::CopyToCpu<int64_t>(int64_t *data) const;
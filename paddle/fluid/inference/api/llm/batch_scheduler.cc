@@ -0,0 +1,371 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/llm/batch_scheduler.h"
+
+#include <algorithm>
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+namespace {
+
+// returns the erased request, or nullptr if the queue doesn't have it
+std::shared_ptr<Request> EraseRequest(
+    std::deque<std::shared_ptr<Request>>* queue, int64_t request_id) {
+  auto it = std::find_if(
+      queue->begin(), queue->end(), [&](const std::shared_ptr<Request>& r) {
+        return r->id == request_id;
+      });
+  if (it == queue->end()) {
+    return nullptr;
+  }
+  std::shared_ptr<Request> request = *it;
+  queue->erase(it);
+  return request;
+}
+
+}  // namespace
+
+ContinuousBatchScheduler::ContinuousBatchScheduler(
+    const SchedulerConfig& config,
+    KVCacheBlockManager* block_manager,
+    int64_t pad_token_id)
+    : config_(config),
+      block_manager_(block_manager),
+      pad_token_id_(pad_token_id) {
+  PADDLE_ENFORCE_NOT_NULL(
+      block_manager_,
+      common::errors::InvalidArgument(
+          "ContinuousBatchScheduler needs a KV cache block manager."));
+  PADDLE_ENFORCE_GT(config_.max_batch_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "max_batch_size must be positive, but got %d.",
+                        config_.max_batch_size));
+  // every running request decodes in every step
+  PADDLE_ENFORCE_GE(
+      config_.max_num_batched_tokens,
+      config_.max_batch_size,
+      common::errors::InvalidArgument(
+          "max_num_batched_tokens (%d) must be at least max_batch_size (%d).",
+          config_.max_num_batched_tokens,
+          config_.max_batch_size));
+  PADDLE_ENFORCE_GT(config_.max_blocks_per_seq,
+                    0,
+                    common::errors::InvalidArgument(
+                        "max_blocks_per_seq must be positive, but got %d.",
+                        config_.max_blocks_per_seq));
+}
+
+int64_t ContinuousBatchScheduler::MaxTokensPerSeq() const {
+  return std::min<int64_t>(
+      config_.max_seq_len,
+      static_cast<int64_t>(config_.max_blocks_per_seq) *
+          block_manager_->block_size());
+}
+
+void ContinuousBatchScheduler::AddRequest(
+    const std::shared_ptr<Request>& request) {
+  PADDLE_ENFORCE_NOT_NULL(
+      request, common::errors::InvalidArgument("The request is null."));
+  PADDLE_ENFORCE_EQ(
+      request->prompt_ids.empty(),
+      false,
+      common::errors::InvalidArgument("Request %d has an empty prompt.",
+                                      request->id));
+  PADDLE_ENFORCE_GT(request->max_new_tokens,
+                    0,
+                    common::errors::InvalidArgument(
+                        "Request %d must generate at least one token.",
+                        request->id));
+  PADDLE_ENFORCE_EQ(block_manager_->HasRequest(request->id),
+                    false,
+                    common::errors::AlreadyExists(
+                        "Request %d is already scheduled.", request->id));
+  const int64_t max_tokens = MaxTokensPerSeq();
+  PADDLE_ENFORCE_LE(
+      request->NumTokens(),
+      max_tokens,
+      common::errors::InvalidArgument(
+          "The prompt of request %d has %d tokens, more than the %d tokens a "
+          "request may hold.",
+          request->id,
+          request->NumTokens(),
+          max_tokens));
+  // a request has to be able to finish even if it runs alone
+  const int64_t final_tokens =
+      std::min(request->NumTokens() + request->max_new_tokens, max_tokens);
+  PADDLE_ENFORCE_LE(
+      block_manager_->NumBlocksFor(final_tokens),
+      block_manager_->num_gpu_blocks(),
+      common::errors::ResourceExhausted(
+          "Request %d needs %d KV cache blocks, but the cache has only %d.",
+          request->id,
+          block_manager_->NumBlocksFor(final_tokens),
+          block_manager_->num_gpu_blocks()));
+  request->state = RequestState::kWaiting;
+  request->num_computed_tokens = 0;
+  waiting_.push_back(request);
+}
+
+void ContinuousBatchScheduler::AbortRequest(int64_t request_id) {
+  std::shared_ptr<Request> request = EraseRequest(&waiting_, request_id);
+  if (!request) {
+    request = EraseRequest(&running_, request_id);
+  }
+  if (!request) {
+    request = EraseRequest(&swapped_, request_id);
+  }
+  if (request) {
+    block_manager_->Free(request_id);
+    request->state = RequestState::kFinished;
+    VLOG(3) << "Abort request " << request_id;
+  }
+}
+
+void ContinuousBatchScheduler::ForkRequest(
+    int64_t parent_id, const std::shared_ptr<Request>& child) {
+  auto it = std::find_if(
+      running_.begin(), running_.end(), [&](const std::shared_ptr<Request>& r) {
+        return r->id == parent_id;
+      });
+  PADDLE_ENFORCE_EQ(
+      it != running_.end(),
+      true,
+      common::errors::PreconditionNotMet(
+          "Only a running request can be forked, but request %d isn't.",
+          parent_id));
+  PADDLE_ENFORCE_LT(
+      running_.size(),
+      static_cast<size_t>(config_.max_batch_size),
+      common::errors::ResourceExhausted(
+          "Can't fork request %d, the batch is full.", parent_id));
+  const Request& parent = **it;
+  block_manager_->Fork(parent_id, child->id);
+  child->prompt_ids = parent.prompt_ids;
+  child->output_ids = parent.output_ids;
+  child->num_computed_tokens = parent.num_computed_tokens;
+  child->state = RequestState::kRunning;
+  running_.push_back(child);
+}
+
+void ContinuousBatchScheduler::Preempt(const std::shared_ptr<Request>& victim,
+                                       StepPlan* plan) {
+  EraseRequest(&running_, victim->id);
+  if (config_.enable_swap && block_manager_->CanSwapOut(victim->id)) {
+    auto mapping = block_manager_->SwapOut(victim->id);
+    plan->swap_out.insert(
+        plan->swap_out.end(), mapping.begin(), mapping.end());
+    victim->state = RequestState::kSwapped;
+    // the earlier admitted one is swapped out later and resumes first
+    swapped_.push_front(victim);
+    VLOG(3) << "Swap out request " << victim->id << " with "
+            << mapping.size() << " blocks";
+  } else {
+    block_manager_->Free(victim->id);
+    victim->num_computed_tokens = 0;
+    victim->state = RequestState::kWaiting;
+    waiting_.push_front(victim);
+    plan->recompute.push_back(victim->id);
+    VLOG(3) << "Preempt request " << victim->id << " for recomputation";
+  }
+}
+
+void ContinuousBatchScheduler::AppendRow(
+    const std::shared_ptr<Request>& request, StepPlan* plan) {
+  const bool is_prefill = request->num_computed_tokens == 0;
+  const int num_tokens = static_cast<int>(request->NumTokens());
+  plan->seqs.push_back(request);
+  if (is_prefill) {
+    plan->seq_lens_encoder.push_back(num_tokens);
+    plan->seq_lens_decoder.push_back(0);
+    plan->seq_lens_this_time.push_back(num_tokens);
+  } else {
+    plan->seq_lens_encoder.push_back(0);
+    plan->seq_lens_decoder.push_back(
+        static_cast<int>(request->num_computed_tokens));
+    plan->seq_lens_this_time.push_back(1);
+  }
+  plan->max_input_len =
+      std::max(plan->max_input_len, plan->seq_lens_this_time.back());
+  plan->num_batched_tokens += plan->seq_lens_this_time.back();
+
+  const std::vector<int>& table = block_manager_->BlockTable(request->id);
+  PADDLE_ENFORCE_LE(table.size(),
+                    static_cast<size_t>(config_.max_blocks_per_seq),
+                    common::errors::OutOfRange(
+                        "Request %d holds %d blocks, more than "
+                        "max_blocks_per_seq %d.",
+                        request->id,
+                        table.size(),
+                        config_.max_blocks_per_seq));
+  plan->block_tables.insert(
+      plan->block_tables.end(), table.begin(), table.end());
+  plan->block_tables.insert(plan->block_tables.end(),
+                            config_.max_blocks_per_seq - table.size(),
+                            -1);
+}
+
+StepPlan ContinuousBatchScheduler::Schedule() {
+  StepPlan plan;
+  std::vector<std::shared_ptr<Request>> decodes;
+  std::vector<std::shared_ptr<Request>> prefills;
+  int num_tokens = 0;
+
+  // Step 1: Every running request decodes one token. Make room for it by
+  // preempting the latest admitted requests.
+  for (size_t i = 0; i < running_.size();) {
+    std::shared_ptr<Request> request = running_[i];
+    bool preempted_self = false;
+    while (!block_manager_->Allocate(
+        request->id, request->NumTokens(), &plan.copy_blocks)) {
+      std::shared_ptr<Request> victim = running_.back();
+      Preempt(victim, &plan);
+      if (victim == request) {
+        preempted_self = true;
+        break;
+      }
+    }
+    if (preempted_self) {
+      break;
+    }
+    decodes.push_back(request);
+    ++num_tokens;
+    ++i;
+  }
+  const bool preempted = !plan.swap_out.empty() || !plan.recompute.empty();
+
+  // Step 2: Swapped requests go back before any new prompt.
+  while (!preempted && !swapped_.empty() &&
+         static_cast<int>(decodes.size()) < config_.max_batch_size &&
+         num_tokens < config_.max_num_batched_tokens) {
+    std::shared_ptr<Request> request = swapped_.front();
+    if (block_manager_->NumBlocksFor(request->NumTokens()) >
+        block_manager_->NumFreeGpuBlocks()) {
+      break;
+    }
+    auto mapping = block_manager_->SwapIn(request->id);
+    plan.swap_in.insert(plan.swap_in.end(), mapping.begin(), mapping.end());
+    block_manager_->Allocate(
+        request->id, request->NumTokens(), &plan.copy_blocks);
+    swapped_.pop_front();
+    request->state = RequestState::kRunning;
+    running_.push_back(request);
+    decodes.push_back(request);
+    ++num_tokens;
+    VLOG(3) << "Swap in request " << request->id << " with "
+            << mapping.size() << " blocks";
+  }
+
+  // Step 3: Fill the step with waiting prompts.
+  while (!preempted && swapped_.empty() && !waiting_.empty() &&
+         static_cast<int>(decodes.size() + prefills.size()) <
+             config_.max_batch_size) {
+    std::shared_ptr<Request> request = waiting_.front();
+    const int prompt_len = static_cast<int>(request->NumTokens());
+    const bool step_is_empty = decodes.empty() && prefills.empty();
+    // a prompt longer than the budget runs alone
+    if (!step_is_empty &&
+        num_tokens + prompt_len > config_.max_num_batched_tokens) {
+      break;
+    }
+    const std::vector<int64_t> token_ids = request->TokenIds();
+    const int watermark = running_.empty() ? 0 : config_.watermark_blocks;
+    if (block_manager_->NumFreeGpuBlocks() -
+            block_manager_->NumBlocksToAllocate(token_ids) <
+        watermark) {
+      break;
+    }
+    if (!block_manager_->Allocate(request->id, token_ids)) {
+      break;
+    }
+    waiting_.pop_front();
+    request->state = RequestState::kRunning;
+    running_.push_back(request);
+    prefills.push_back(request);
+    num_tokens += prompt_len;
+    if (num_tokens >= config_.max_num_batched_tokens) {
+      break;
+    }
+  }
+
+  for (const auto& request : decodes) {
+    AppendRow(request, &plan);
+  }
+  for (const auto& request : prefills) {
+    AppendRow(request, &plan);
+  }
+  plan.input_ids.assign(
+      static_cast<size_t>(plan.rows()) * plan.max_input_len, pad_token_id_);
+  for (int row = 0; row < plan.rows(); ++row) {
+    const Request& request = *plan.seqs[row];
+    int64_t* dst = plan.input_ids.data() +
+                   static_cast<size_t>(row) * plan.max_input_len;
+    if (plan.seq_lens_encoder[row] > 0) {
+      std::copy(request.prompt_ids.begin(), request.prompt_ids.end(), dst);
+      std::copy(request.output_ids.begin(),
+                request.output_ids.end(),
+                dst + request.prompt_ids.size());
+    } else {
+      dst[0] = request.LastToken();
+    }
+  }
+  VLOG(3) << "Schedule " << decodes.size() << " decodes and "
+          << prefills.size() << " prefills with " << plan.num_batched_tokens
+          << " tokens, " << waiting_.size() << " waiting, " << swapped_.size()
+          << " swapped, " << block_manager_->NumFreeGpuBlocks()
+          << " free blocks";
+  return plan;
+}
+
+std::vector<std::shared_ptr<Request>> ContinuousBatchScheduler::Update(
+    const StepPlan& plan, const std::vector<int64_t>& next_tokens) {
+  PADDLE_ENFORCE_EQ(next_tokens.size(),
+                    plan.seqs.size(),
+                    common::errors::InvalidArgument(
+                        "The step has %d rows but got %d next tokens.",
+                        plan.seqs.size(),
+                        next_tokens.size()));
+  std::vector<std::shared_ptr<Request>> finished;
+  for (size_t row = 0; row < plan.seqs.size(); ++row) {
+    const std::shared_ptr<Request>& request = plan.seqs[row];
+    // aborted after the step was scheduled
+    if (request->state != RequestState::kRunning) {
+      continue;
+    }
+    request->num_computed_tokens = request->NumTokens();
+    request->output_ids.push_back(next_tokens[row]);
+    bool is_eos = request->eos_token_id >= 0 &&
+                  next_tokens[row] == request->eos_token_id;
+    if (is_eos ||
+        static_cast<int>(request->output_ids.size()) >=
+            request->max_new_tokens ||
+        request->NumTokens() >= MaxTokensPerSeq()) {
+      block_manager_->Free(request->id);
+      EraseRequest(&running_, request->id);
+      request->state = RequestState::kFinished;
+      finished.push_back(request);
+    }
+  }
+  return finished;
+}
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
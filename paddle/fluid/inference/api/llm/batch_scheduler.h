@@ -0,0 +1,163 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/inference/api/llm/block_manager.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+struct SchedulerConfig {
+  // rows of one step
+  int max_batch_size{64};
+  // prompt and decode tokens of one step, a longer prompt runs alone
+  int max_num_batched_tokens{4096};
+  // prompt plus generated tokens of one request
+  int max_seq_len{4096};
+  // the width of block_tables
+  int max_blocks_per_seq{128};
+  // device blocks kept free when admitting new prompts, so that the running
+  // requests can grow for a while without being preempted
+  int watermark_blocks{0};
+  // preempt by swapping the KV blocks to the host pool, otherwise free them
+  // and compute the tokens again when the request is rescheduled
+  bool enable_swap{true};
+};
+
+enum class RequestState { kWaiting, kRunning, kSwapped, kFinished };
+
+struct Request {
+  int64_t id{-1};
+  std::vector<int64_t> prompt_ids;
+  std::vector<int64_t> output_ids;
+  int max_new_tokens{128};
+  // a negative id never stops the generation
+  int64_t eos_token_id{-1};
+  RequestState state{RequestState::kWaiting};
+  // tokens whose keys and values are in the cache
+  int64_t num_computed_tokens{0};
+
+  int64_t NumTokens() const {
+    return static_cast<int64_t>(prompt_ids.size() + output_ids.size());
+  }
+  int64_t LastToken() const {
+    return output_ids.empty() ? prompt_ids.back() : output_ids.back();
+  }
+  std::vector<int64_t> TokenIds() const {
+    std::vector<int64_t> token_ids(prompt_ids);
+    token_ids.insert(token_ids.end(), output_ids.begin(), output_ids.end());
+    return token_ids;
+  }
+};
+
+/// \brief The inputs of one block_multihead_attention step. Every row is
+/// either a prefill, which computes all tokens of the request
+/// (seq_lens_encoder = seq_lens_this_time = n, seq_lens_decoder = 0), or a
+/// decode, which feeds the last token (seq_lens_encoder = 0,
+/// seq_lens_decoder = computed tokens, seq_lens_this_time = 1).
+struct StepPlan {
+  std::vector<std::shared_ptr<Request>> seqs;
+  // copy before running the step, swap outs first
+  KVCacheBlockManager::BlockMapping swap_out;
+  KVCacheBlockManager::BlockMapping swap_in;
+  // device blocks to copy before a request writes to its own copy of a
+  // shared block
+  KVCacheBlockManager::BlockMapping copy_blocks;
+  // requests that lost their blocks and wait to be computed again
+  std::vector<int64_t> recompute;
+
+  std::vector<int> seq_lens_encoder;
+  std::vector<int> seq_lens_decoder;
+  std::vector<int> seq_lens_this_time;
+  // [rows, max_blocks_per_seq], padded with -1
+  std::vector<int> block_tables;
+  // [rows, max_input_len], padded with the pad token
+  std::vector<int64_t> input_ids;
+  int max_input_len{0};
+  int num_batched_tokens{0};
+
+  int rows() const { return static_cast<int>(seqs.size()); }
+  bool empty() const { return seqs.empty(); }
+};
+
+/// \brief Continuous batching over a paged KV cache. Every step runs the
+/// decodes of all running requests, and fills the rest of the step with
+/// prompts of waiting requests as long as the token budget and the free
+/// blocks allow. A finished request returns its blocks at once, so a new
+/// request takes its row in the next step instead of waiting for the whole
+/// batch.
+///
+/// With prefix caching on in the block manager, a prompt takes the cached
+/// blocks of its longest indexed prefix. The prompt is still computed as a
+/// whole, block_multihead_attention attends only within the tokens of the
+/// step, so the shared blocks save memory and are written the same values.
+///
+/// When a running request can't grow, the latest admitted running request is
+/// preempted: swapped out to the host pool, or dropped and computed again
+/// later when swapping is off or the host pool is full. Swapped requests are
+/// swapped in before new prompts are admitted.
+class ContinuousBatchScheduler {
+ public:
+  ContinuousBatchScheduler(const SchedulerConfig& config,
+                           KVCacheBlockManager* block_manager,
+                           int64_t pad_token_id = 0);
+
+  /// Queues a request, throws if it can never fit in the cache.
+  void AddRequest(const std::shared_ptr<Request>& request);
+  /// Drops a request in any state and returns its blocks.
+  void AbortRequest(int64_t request_id);
+  /// Starts the child as a running copy of the parent, sharing its blocks,
+  /// e.g. to sample several outputs of one prompt.
+  void ForkRequest(int64_t parent_id, const std::shared_ptr<Request>& child);
+
+  StepPlan Schedule();
+  /// Appends the sampled token of every row of the plan, returns the requests
+  /// that finished.
+  std::vector<std::shared_ptr<Request>> Update(
+      const StepPlan& plan, const std::vector<int64_t>& next_tokens);
+
+  bool HasUnfinished() const {
+    return !waiting_.empty() || !running_.empty() || !swapped_.empty();
+  }
+  size_t NumWaiting() const { return waiting_.size(); }
+  size_t NumRunning() const { return running_.size(); }
+  size_t NumSwapped() const { return swapped_.size(); }
+
+ private:
+  // frees the blocks of the victim and moves it out of running_
+  void Preempt(const std::shared_ptr<Request>& victim, StepPlan* plan);
+  void AppendRow(const std::shared_ptr<Request>& request, StepPlan* plan);
+  int64_t MaxTokensPerSeq() const;
+
+  SchedulerConfig config_;
+  KVCacheBlockManager* block_manager_;
+  int64_t pad_token_id_;
+  std::deque<std::shared_ptr<Request>> waiting_;
+  // in the order of admission, the back is preempted first
+  std::deque<std::shared_ptr<Request>> running_;
+  std::deque<std::shared_ptr<Request>> swapped_;
+
+  DISABLE_COPY_AND_ASSIGN(ContinuousBatchScheduler);
+};
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
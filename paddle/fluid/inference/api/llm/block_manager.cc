@@ -0,0 +1,382 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/llm/block_manager.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "paddle/common/enforce.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+KVCacheBlockManager::KVCacheBlockManager(int num_gpu_blocks,
+                                         int num_cpu_blocks,
+                                         int block_size,
+                                         bool enable_prefix_caching)
+    : num_gpu_blocks_(num_gpu_blocks),
+      num_cpu_blocks_(num_cpu_blocks),
+      block_size_(block_size),
+      enable_prefix_caching_(enable_prefix_caching) {
+  PADDLE_ENFORCE_GT(num_gpu_blocks,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The KV cache needs at least one device block."));
+  PADDLE_ENFORCE_GE(
+      num_cpu_blocks,
+      0,
+      common::errors::InvalidArgument(
+          "The number of host blocks can't be negative, but got %d.",
+          num_cpu_blocks));
+  PADDLE_ENFORCE_GT(block_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The block size must be positive, but got %d.",
+                        block_size));
+  // pop from the back hands out block 0 first
+  for (int i = num_gpu_blocks - 1; i >= 0; --i) {
+    free_gpu_.push_back(i);
+  }
+  for (int i = num_cpu_blocks - 1; i >= 0; --i) {
+    free_cpu_.push_back(i);
+  }
+  ref_counts_.assign(num_gpu_blocks, 0);
+}
+
+int KVCacheBlockManager::NumBlocksFor(int64_t num_tokens) const {
+  return static_cast<int>((num_tokens + block_size_ - 1) / block_size_);
+}
+
+bool KVCacheBlockManager::HasRequest(int64_t request_id) const {
+  return gpu_tables_.count(request_id) || cpu_tables_.count(request_id);
+}
+
+bool KVCacheBlockManager::IsSwapped(int64_t request_id) const {
+  return cpu_tables_.count(request_id) > 0;
+}
+
+size_t KVCacheBlockManager::HashBlock(size_t parent_hash,
+                                      const std::vector<int64_t>& token_ids,
+                                      size_t begin,
+                                      size_t end) {
+  size_t seed = parent_hash;
+  for (size_t i = begin; i < end; ++i) {
+    seed ^= std::hash<int64_t>()(token_ids[i]) + 0x9e3779b9 + (seed << 6) +
+            (seed >> 2);
+  }
+  return seed;
+}
+
+std::vector<int> KVCacheBlockManager::MatchPrefix(
+    const std::vector<int64_t>& token_ids) const {
+  std::vector<int> blocks;
+  if (!enable_prefix_caching_) {
+    return blocks;
+  }
+  size_t hash = 0;
+  int parent = -1;
+  for (size_t end = block_size_; end <= token_ids.size(); end += block_size_) {
+    const size_t begin = end - block_size_;
+    hash = HashBlock(hash, token_ids, begin, end);
+    auto it = prefix_index_.find(hash);
+    if (it == prefix_index_.end()) {
+      break;
+    }
+    // a hash collision only misses the cache
+    const CachedBlock& cached = cached_blocks_.at(it->second);
+    if (cached.parent != parent ||
+        !std::equal(cached.token_ids.begin(),
+                    cached.token_ids.end(),
+                    token_ids.begin() + begin)) {
+      break;
+    }
+    blocks.push_back(it->second);
+    parent = it->second;
+  }
+  return blocks;
+}
+
+int KVCacheBlockManager::PopFreeGpuBlock() {
+  int block_id = -1;
+  if (!free_gpu_.empty()) {
+    block_id = free_gpu_.back();
+    free_gpu_.pop_back();
+  } else {
+    PADDLE_ENFORCE_EQ(
+        evictable_.empty(),
+        false,
+        common::errors::ResourceExhausted("The KV cache has no free block."));
+    block_id = evictable_.front();
+    evictable_.pop_front();
+    auto cached = cached_blocks_.find(block_id);
+    prefix_index_.erase(cached->second.hash);
+    cached_blocks_.erase(cached);
+  }
+  ref_counts_[block_id] = 1;
+  return block_id;
+}
+
+void KVCacheBlockManager::RetainGpuBlock(int block_id) {
+  if (ref_counts_[block_id]++ == 0) {
+    // an indexed block taken back from the evictable list
+    evictable_.erase(cached_blocks_.at(block_id).evictable_it);
+  }
+}
+
+void KVCacheBlockManager::ReleaseGpuBlock(int block_id) {
+  if (--ref_counts_[block_id] > 0) {
+    return;
+  }
+  auto cached = cached_blocks_.find(block_id);
+  if (cached != cached_blocks_.end()) {
+    cached->second.evictable_it = evictable_.insert(evictable_.end(), block_id);
+  } else {
+    free_gpu_.push_back(block_id);
+  }
+}
+
+void KVCacheBlockManager::IndexBlocks(const std::vector<int64_t>& token_ids,
+                                      const std::vector<int>& table) {
+  if (!enable_prefix_caching_) {
+    return;
+  }
+  size_t hash = 0;
+  int parent = -1;
+  for (size_t i = 0; (i + 1) * block_size_ <= token_ids.size(); ++i) {
+    const size_t begin = i * block_size_;
+    hash = HashBlock(hash, token_ids, begin, begin + block_size_);
+    const int block_id = table[i];
+    if (!cached_blocks_.count(block_id)) {
+      if (prefix_index_.count(hash)) {
+        // another block has the hash, the rest of the chain can't be found
+        return;
+      }
+      CachedBlock& cached = cached_blocks_[block_id];
+      cached.hash = hash;
+      cached.parent = parent;
+      cached.token_ids.assign(token_ids.begin() + begin,
+                              token_ids.begin() + begin + block_size_);
+      prefix_index_[hash] = block_id;
+    }
+    parent = block_id;
+  }
+}
+
+int KVCacheBlockManager::NumBlocksToGrow(int64_t request_id,
+                                         int64_t num_tokens) const {
+  auto it = gpu_tables_.find(request_id);
+  int num_held =
+      it == gpu_tables_.end() ? 0 : static_cast<int>(it->second.size());
+  int num_new = std::max(NumBlocksFor(num_tokens) - num_held, 0);
+  // the block of the token written next is shared and has to be copied
+  const int64_t write_block = (num_tokens - 1) / block_size_;
+  if (num_tokens > 0 && write_block < num_held &&
+      ref_counts_[it->second[write_block]] > 1) {
+    ++num_new;
+  }
+  return num_new;
+}
+
+bool KVCacheBlockManager::CanAllocate(int64_t request_id,
+                                      int64_t num_tokens) const {
+  return !IsSwapped(request_id) &&
+         NumBlocksToGrow(request_id, num_tokens) <= NumFreeGpuBlocks();
+}
+
+bool KVCacheBlockManager::Allocate(int64_t request_id,
+                                   int64_t num_tokens,
+                                   BlockMapping* copies) {
+  PADDLE_ENFORCE_EQ(IsSwapped(request_id),
+                    false,
+                    common::errors::PreconditionNotMet(
+                        "Request %d is swapped out, swap it in before "
+                        "allocating blocks for it.",
+                        request_id));
+  if (!CanAllocate(request_id, num_tokens)) {
+    return false;
+  }
+  auto& table = gpu_tables_[request_id];
+  const int64_t write_block = (num_tokens - 1) / block_size_;
+  if (num_tokens > 0 && write_block < static_cast<int64_t>(table.size()) &&
+      ref_counts_[table[write_block]] > 1) {
+    PADDLE_ENFORCE_NOT_NULL(
+        copies,
+        common::errors::InvalidArgument(
+            "Request %d writes to a shared block, the copy has to be "
+            "returned to the caller.",
+            request_id));
+    const int shared = table[write_block];
+    table[write_block] = PopFreeGpuBlock();
+    ReleaseGpuBlock(shared);
+    copies->emplace_back(shared, table[write_block]);
+  }
+  while (static_cast<int>(table.size()) < NumBlocksFor(num_tokens)) {
+    table.push_back(PopFreeGpuBlock());
+  }
+  return true;
+}
+
+int64_t KVCacheBlockManager::NumCachedTokens(
+    const std::vector<int64_t>& token_ids) const {
+  return static_cast<int64_t>(MatchPrefix(token_ids).size()) * block_size_;
+}
+
+int KVCacheBlockManager::NumBlocksToAllocate(
+    const std::vector<int64_t>& token_ids) const {
+  std::vector<int> matched = MatchPrefix(token_ids);
+  int num_taken =
+      NumBlocksFor(token_ids.size()) - static_cast<int>(matched.size());
+  // matched blocks nobody holds leave the free ones too
+  for (int block_id : matched) {
+    num_taken += ref_counts_[block_id] == 0;
+  }
+  return num_taken;
+}
+
+bool KVCacheBlockManager::CanAllocate(
+    int64_t request_id, const std::vector<int64_t>& token_ids) const {
+  if (HasRequest(request_id)) {
+    return CanAllocate(request_id, static_cast<int64_t>(token_ids.size()));
+  }
+  return NumBlocksToAllocate(token_ids) <= NumFreeGpuBlocks();
+}
+
+bool KVCacheBlockManager::Allocate(int64_t request_id,
+                                   const std::vector<int64_t>& token_ids) {
+  if (HasRequest(request_id)) {
+    return Allocate(request_id, static_cast<int64_t>(token_ids.size()));
+  }
+  if (!CanAllocate(request_id, token_ids)) {
+    return false;
+  }
+  std::vector<int> table = MatchPrefix(token_ids);
+  for (int block_id : table) {
+    RetainGpuBlock(block_id);
+  }
+  num_prefix_hit_tokens_ += static_cast<int64_t>(table.size()) * block_size_;
+  while (static_cast<int>(table.size()) < NumBlocksFor(token_ids.size())) {
+    table.push_back(PopFreeGpuBlock());
+  }
+  IndexBlocks(token_ids, table);
+  gpu_tables_[request_id] = std::move(table);
+  return true;
+}
+
+void KVCacheBlockManager::Fork(int64_t parent_id, int64_t child_id) {
+  PADDLE_ENFORCE_EQ(HasRequest(child_id),
+                    false,
+                    common::errors::AlreadyExists(
+                        "Request %d already holds blocks.", child_id));
+  std::vector<int> table = BlockTable(parent_id);
+  for (int block_id : table) {
+    RetainGpuBlock(block_id);
+  }
+  gpu_tables_[child_id] = std::move(table);
+}
+
+void KVCacheBlockManager::Free(int64_t request_id) {
+  auto gpu_it = gpu_tables_.find(request_id);
+  if (gpu_it != gpu_tables_.end()) {
+    // the leading blocks of a prompt are the most likely to be shared, keep
+    // them in the cache longer
+    for (auto it = gpu_it->second.rbegin(); it != gpu_it->second.rend();
+         ++it) {
+      ReleaseGpuBlock(*it);
+    }
+    gpu_tables_.erase(gpu_it);
+  }
+  auto cpu_it = cpu_tables_.find(request_id);
+  if (cpu_it != cpu_tables_.end()) {
+    free_cpu_.insert(
+        free_cpu_.end(), cpu_it->second.rbegin(), cpu_it->second.rend());
+    cpu_tables_.erase(cpu_it);
+  }
+}
+
+const std::vector<int>& KVCacheBlockManager::BlockTable(
+    int64_t request_id) const {
+  auto it = gpu_tables_.find(request_id);
+  PADDLE_ENFORCE_EQ(it != gpu_tables_.end(),
+                    true,
+                    common::errors::NotFound(
+                        "Request %d holds no device blocks.", request_id));
+  return it->second;
+}
+
+bool KVCacheBlockManager::CanSwapOut(int64_t request_id) const {
+  auto it = gpu_tables_.find(request_id);
+  return it != gpu_tables_.end() &&
+         static_cast<int>(it->second.size()) <= NumFreeCpuBlocks();
+}
+
+KVCacheBlockManager::BlockMapping KVCacheBlockManager::SwapOut(
+    int64_t request_id) {
+  PADDLE_ENFORCE_EQ(CanSwapOut(request_id),
+                    true,
+                    common::errors::ResourceExhausted(
+                        "Can't swap out request %d, it holds no device blocks "
+                        "or the host pool has only %d free blocks.",
+                        request_id,
+                        NumFreeCpuBlocks()));
+  auto gpu_it = gpu_tables_.find(request_id);
+  auto& cpu_table = cpu_tables_[request_id];
+  BlockMapping mapping;
+  for (int gpu_block : gpu_it->second) {
+    int cpu_block = free_cpu_.back();
+    free_cpu_.pop_back();
+    cpu_table.push_back(cpu_block);
+    mapping.emplace_back(gpu_block, cpu_block);
+  }
+  // shared blocks stay on the device for the other requests
+  for (auto it = gpu_it->second.rbegin(); it != gpu_it->second.rend(); ++it) {
+    ReleaseGpuBlock(*it);
+  }
+  gpu_tables_.erase(gpu_it);
+  return mapping;
+}
+
+bool KVCacheBlockManager::CanSwapIn(int64_t request_id) const {
+  auto it = cpu_tables_.find(request_id);
+  return it != cpu_tables_.end() &&
+         static_cast<int>(it->second.size()) <= NumFreeGpuBlocks();
+}
+
+KVCacheBlockManager::BlockMapping KVCacheBlockManager::SwapIn(
+    int64_t request_id) {
+  PADDLE_ENFORCE_EQ(CanSwapIn(request_id),
+                    true,
+                    common::errors::ResourceExhausted(
+                        "Can't swap in request %d, it isn't swapped out or "
+                        "the device has only %d free blocks.",
+                        request_id,
+                        NumFreeGpuBlocks()));
+  auto cpu_it = cpu_tables_.find(request_id);
+  auto& gpu_table = gpu_tables_[request_id];
+  BlockMapping mapping;
+  for (int cpu_block : cpu_it->second) {
+    int gpu_block = PopFreeGpuBlock();
+    gpu_table.push_back(gpu_block);
+    mapping.emplace_back(cpu_block, gpu_block);
+  }
+  free_cpu_.insert(
+      free_cpu_.end(), cpu_it->second.rbegin(), cpu_it->second.rend());
+  cpu_tables_.erase(cpu_it);
+  return mapping;
+}
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,155 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+/// \brief Owns the block ids of a paged KV cache, in the layout of
+/// block_multihead_attention: key_cache / value_cache are
+/// [num_blocks, kv_num_heads, block_size, head_dim] and a sequence addresses
+/// its tokens through a row of block ids in block_tables.
+///
+/// Every request holds its blocks either on the device or, after a swap out,
+/// on the host pool. Allocation is all or nothing, a request never ends up
+/// with a partial block table.
+///
+/// Device blocks are reference counted, so requests may share them: a forked
+/// request shares all blocks of its parent, and with prefix caching the full
+/// blocks of a prompt are indexed by their tokens and the blocks before them,
+/// so that another prompt with the same prefix, e.g. the same system prompt,
+/// takes the same blocks. A shared block is copied before a request writes a
+/// new token to it. An indexed block nobody holds stays in the index until
+/// its memory is needed, the least recently freed goes first.
+class KVCacheBlockManager {
+ public:
+  using BlockMapping = std::vector<std::pair<int, int> /*src, dst*/>;
+
+  KVCacheBlockManager(int num_gpu_blocks,
+                      int num_cpu_blocks,
+                      int block_size,
+                      bool enable_prefix_caching = false);
+
+  int block_size() const { return block_size_; }
+  int num_gpu_blocks() const { return num_gpu_blocks_; }
+  int num_cpu_blocks() const { return num_cpu_blocks_; }
+  bool enable_prefix_caching() const { return enable_prefix_caching_; }
+  // cached blocks nobody holds count as free
+  int NumFreeGpuBlocks() const {
+    return static_cast<int>(free_gpu_.size() + evictable_.size());
+  }
+  int NumFreeCpuBlocks() const { return static_cast<int>(free_cpu_.size()); }
+
+  int NumBlocksFor(int64_t num_tokens) const;
+
+  bool HasRequest(int64_t request_id) const;
+  bool IsSwapped(int64_t request_id) const;
+
+  /// Number of new device blocks needed to hold num_tokens for the request,
+  /// including the copy of a shared block written next.
+  int NumBlocksToGrow(int64_t request_id, int64_t num_tokens) const;
+  bool CanAllocate(int64_t request_id, int64_t num_tokens) const;
+  /// Grows the device block table of the request to hold num_tokens, the
+  /// last of which is written next. If that token falls in a shared block,
+  /// the block is replaced by a private copy and the (shared, copy) pair is
+  /// appended to copies. Returns false and changes nothing when there are
+  /// not enough free blocks.
+  bool Allocate(int64_t request_id,
+                int64_t num_tokens,
+                BlockMapping* copies = nullptr);
+
+  /// Number of leading tokens whose blocks are in the prefix index.
+  int64_t NumCachedTokens(const std::vector<int64_t>& token_ids) const;
+  /// Number of free device blocks a new request for the tokens takes.
+  int NumBlocksToAllocate(const std::vector<int64_t>& token_ids) const;
+  bool CanAllocate(int64_t request_id,
+                   const std::vector<int64_t>& token_ids) const;
+  /// Allocates the blocks of a new request for its tokens, and shares the
+  /// blocks of the longest indexed prefix when prefix caching is on.
+  bool Allocate(int64_t request_id, const std::vector<int64_t>& token_ids);
+
+  /// The child shares all device blocks of the parent.
+  void Fork(int64_t parent_id, int64_t child_id);
+  /// Returns all blocks of the request, on the device or on the host.
+  void Free(int64_t request_id);
+
+  /// Device block ids of the request, in token order.
+  const std::vector<int>& BlockTable(int64_t request_id) const;
+  int RefCount(int block_id) const { return ref_counts_[block_id]; }
+  /// Prompt tokens whose blocks were found in the prefix index.
+  int64_t num_prefix_hit_tokens() const { return num_prefix_hit_tokens_; }
+
+  bool CanSwapOut(int64_t request_id) const;
+  /// Moves the request to host blocks, returns the (gpu, cpu) block pairs
+  /// the caller has to copy before the gpu blocks are reused.
+  BlockMapping SwapOut(int64_t request_id);
+  bool CanSwapIn(int64_t request_id) const;
+  /// Moves the request back to device blocks, returns the (cpu, gpu) block
+  /// pairs the caller has to copy before the request runs again.
+  BlockMapping SwapIn(int64_t request_id);
+
+ private:
+  struct CachedBlock {
+    size_t hash{0};
+    int parent{-1};
+    std::vector<int64_t> token_ids;
+    std::list<int>::iterator evictable_it;
+  };
+
+  static size_t HashBlock(size_t parent_hash,
+                          const std::vector<int64_t>& token_ids,
+                          size_t begin,
+                          size_t end);
+  // device blocks of the longest indexed prefix of the tokens
+  std::vector<int> MatchPrefix(const std::vector<int64_t>& token_ids) const;
+  int PopFreeGpuBlock();
+  void RetainGpuBlock(int block_id);
+  void ReleaseGpuBlock(int block_id);
+  void IndexBlocks(const std::vector<int64_t>& token_ids,
+                   const std::vector<int>& table);
+
+  int num_gpu_blocks_;
+  int num_cpu_blocks_;
+  int block_size_;
+  bool enable_prefix_caching_;
+  int64_t num_prefix_hit_tokens_{0};
+  // free lists are stacks, recently freed blocks are reused first
+  std::vector<int> free_gpu_;
+  std::vector<int> free_cpu_;
+  std::vector<int> ref_counts_;
+  std::unordered_map<int64_t, std::vector<int>> gpu_tables_;
+  std::unordered_map<int64_t, std::vector<int>> cpu_tables_;
+
+  // hash of the tokens up to the end of a block -> block
+  std::unordered_map<size_t, int> prefix_index_;
+  std::unordered_map<int, CachedBlock> cached_blocks_;
+  // indexed blocks nobody holds, in the order they were released
+  std::list<int> evictable_;
+
+  DISABLE_COPY_AND_ASSIGN(KVCacheBlockManager);
+};
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,301 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/llm/llm_engine.h"
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+namespace {
+
+const std::vector<int>& CheckedCacheShape(const LLMEngineConfig& config) {
+  PADDLE_ENFORCE_EQ(config.cache_shape.size(),
+                    4UL,
+                    common::errors::InvalidArgument(
+                        "The KV cache shape must be [num_blocks, "
+                        "kv_num_heads, block_size, head_dim], but got rank %d.",
+                        config.cache_shape.size()));
+  return config.cache_shape;
+}
+
+int NumCpuBlocks(const LLMEngineConfig& config) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  return config.scheduler.enable_swap ? config.num_cpu_blocks : 0;
+#else
+  if (config.scheduler.enable_swap && config.num_cpu_blocks > 0) {
+    LOG(WARNING) << "Swapping KV blocks needs a GPU build, preempted requests "
+                    "are computed again instead.";
+  }
+  return 0;
+#endif
+}
+
+void* MutableCacheData(paddle_infer::Tensor* tensor,
+                       paddle_infer::DataType dtype) {
+  auto place = paddle_infer::PlaceType::kGPU;
+  switch (dtype) {
+    case paddle_infer::DataType::FLOAT32:
+      return tensor->mutable_data<float>(place);
+    case paddle_infer::DataType::FLOAT16:
+      return tensor->mutable_data<phi::dtype::float16>(place);
+    case paddle_infer::DataType::BFLOAT16:
+      return tensor->mutable_data<phi::dtype::bfloat16>(place);
+    case paddle_infer::DataType::INT8:
+      return tensor->mutable_data<int8_t>(place);
+    case paddle_infer::DataType::UINT8:
+      return tensor->mutable_data<uint8_t>(place);
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported KV cache data type %d.", static_cast<int>(dtype)));
+  }
+}
+
+void FeedInt32(paddle_infer::Predictor* predictor,
+               const std::string& name,
+               const std::vector<int>& shape,
+               const std::vector<int>& data) {
+  auto tensor = predictor->GetInputHandle(name);
+  tensor->Reshape(shape);
+  tensor->CopyFromCpu(data.data());
+}
+
+}  // namespace
+
+ContinuousBatchingEngine::ContinuousBatchingEngine(
+    const std::shared_ptr<paddle_infer::Predictor>& predictor,
+    const LLMEngineConfig& config)
+    : predictor_(predictor),
+      config_(config),
+      block_manager_(CheckedCacheShape(config)[0],
+                     NumCpuBlocks(config),
+                     CheckedCacheShape(config)[2],
+                     config.enable_prefix_caching),
+      scheduler_(config.scheduler, &block_manager_, config.pad_token_id) {
+  PADDLE_ENFORCE_NOT_NULL(
+      predictor_,
+      common::errors::InvalidArgument(
+          "ContinuousBatchingEngine needs a predictor to run."));
+  PADDLE_ENFORCE_EQ(config_.cache_names.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "The names of the KV cache inputs are not set."));
+  InitKVCache();
+}
+
+ContinuousBatchingEngine::~ContinuousBatchingEngine() {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // the pending copies may still read or write the host pool
+  if (!cpu_caches_.empty()) {
+    phi::backends::gpu::GpuStreamSync(
+        static_cast<gpuStream_t>(predictor_->GetExecStream()));
+  }
+#endif
+}
+
+void ContinuousBatchingEngine::InitKVCache() {
+  int64_t numel = 1;
+  for (int dim : config_.cache_shape) {
+    numel *= dim;
+  }
+  block_bytes_ = static_cast<size_t>(numel / config_.cache_shape[0]) *
+                 paddle_infer::GetNumBytesOfDataType(config_.cache_dtype);
+  const size_t pool_bytes = block_bytes_ * block_manager_.num_cpu_blocks();
+  for (const std::string& name : config_.cache_names) {
+    auto tensor = predictor_->GetInputHandle(name);
+    tensor->Reshape(config_.cache_shape);
+    gpu_caches_.push_back(MutableCacheData(tensor.get(), config_.cache_dtype));
+    if (block_manager_.num_cpu_blocks() > 0) {
+      cpu_caches_.push_back(
+          paddle::memory::Alloc(phi::GPUPinnedPlace(), pool_bytes));
+    }
+  }
+  VLOG(3) << "KV cache of " << config_.cache_names.size() << " tensors, "
+          << block_manager_.num_gpu_blocks() << " device blocks and "
+          << block_manager_.num_cpu_blocks() << " host blocks of "
+          << block_bytes_ << " bytes";
+}
+
+void ContinuousBatchingEngine::SwapBlocks(
+    const KVCacheBlockManager::BlockMapping& mapping, bool to_host) {
+  if (mapping.empty()) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // on the execution stream, the copies finish before the step reads or
+  // overwrites the blocks
+  void* stream = predictor_->GetExecStream();
+  phi::GPUPlace gpu_place(config_.device_id);
+  for (size_t i = 0; i < gpu_caches_.size(); ++i) {
+    auto* gpu_base = static_cast<uint8_t*>(gpu_caches_[i]);
+    auto* cpu_base = static_cast<uint8_t*>(cpu_caches_[i]->ptr());
+    for (const auto& [src, dst] : mapping) {
+      if (to_host) {
+        paddle::memory::Copy(phi::GPUPinnedPlace(),
+                             cpu_base + dst * block_bytes_,
+                             gpu_place,
+                             gpu_base + src * block_bytes_,
+                             block_bytes_,
+                             stream);
+      } else {
+        paddle::memory::Copy(gpu_place,
+                             gpu_base + dst * block_bytes_,
+                             phi::GPUPinnedPlace(),
+                             cpu_base + src * block_bytes_,
+                             block_bytes_,
+                             stream);
+      }
+    }
+  }
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "Swapping KV blocks needs Paddle compiled with CUDA."));
+#endif
+}
+
+void ContinuousBatchingEngine::CopyBlocks(
+    const KVCacheBlockManager::BlockMapping& mapping) {
+  if (mapping.empty()) {
+    return;
+  }
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  void* stream = predictor_->GetExecStream();
+  phi::GPUPlace gpu_place(config_.device_id);
+  for (void* cache : gpu_caches_) {
+    auto* base = static_cast<uint8_t*>(cache);
+    for (const auto& [src, dst] : mapping) {
+      paddle::memory::Copy(gpu_place,
+                           base + dst * block_bytes_,
+                           gpu_place,
+                           base + src * block_bytes_,
+                           block_bytes_,
+                           stream);
+    }
+  }
+#else
+  PADDLE_THROW(common::errors::Unavailable(
+      "Copying KV blocks needs Paddle compiled with CUDA."));
+#endif
+}
+
+void ContinuousBatchingEngine::FeedInputs(const StepPlan& plan) {
+  const int rows = plan.rows();
+  auto input_ids = predictor_->GetInputHandle(config_.input_ids_name);
+  input_ids->Reshape({rows, plan.max_input_len});
+  input_ids->CopyFromCpu(plan.input_ids.data());
+  FeedInt32(predictor_.get(),
+            config_.seq_lens_encoder_name,
+            {rows, 1},
+            plan.seq_lens_encoder);
+  FeedInt32(predictor_.get(),
+            config_.seq_lens_decoder_name,
+            {rows, 1},
+            plan.seq_lens_decoder);
+  FeedInt32(predictor_.get(),
+            config_.seq_lens_this_time_name,
+            {rows, 1},
+            plan.seq_lens_this_time);
+  FeedInt32(predictor_.get(),
+            config_.block_tables_name,
+            {rows, config_.scheduler.max_blocks_per_seq},
+            plan.block_tables);
+}
+
+std::vector<int64_t> ContinuousBatchingEngine::FetchNextTokens(int rows) {
+  std::string name = config_.next_tokens_name.empty()
+                         ? predictor_->GetOutputNames()[0]
+                         : config_.next_tokens_name;
+  auto output = predictor_->GetOutputHandle(name);
+  int numel = 1;
+  for (int dim : output->shape()) {
+    numel *= dim;
+  }
+  PADDLE_ENFORCE_EQ(numel,
+                    rows,
+                    common::errors::InvalidArgument(
+                        "The model returns %d next tokens for %d rows.",
+                        numel,
+                        rows));
+  std::vector<int64_t> next_tokens(rows);
+  if (output->type() == paddle_infer::DataType::INT64) {
+    output->CopyToCpu(next_tokens.data());
+  } else if (output->type() == paddle_infer::DataType::INT32) {
+    std::vector<int> tokens(rows);
+    output->CopyToCpu(tokens.data());
+    next_tokens.assign(tokens.begin(), tokens.end());
+  } else {
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "The next tokens must be int32 or int64."));
+  }
+  return next_tokens;
+}
+
+void ContinuousBatchingEngine::AddRequest(
+    const std::shared_ptr<Request>& request) {
+  scheduler_.AddRequest(request);
+}
+
+void ContinuousBatchingEngine::AbortRequest(int64_t request_id) {
+  scheduler_.AbortRequest(request_id);
+}
+
+void ContinuousBatchingEngine::ForkRequest(
+    int64_t parent_id, const std::shared_ptr<Request>& child) {
+  scheduler_.ForkRequest(parent_id, child);
+}
+
+std::vector<std::shared_ptr<Request>> ContinuousBatchingEngine::Step() {
+  StepPlan plan = scheduler_.Schedule();
+  // swap outs free the blocks the swap ins may take
+  SwapBlocks(plan.swap_out, /* to_host = */ true);
+  SwapBlocks(plan.swap_in, /* to_host = */ false);
+  CopyBlocks(plan.copy_blocks);
+  if (plan.empty()) {
+    return {};
+  }
+  FeedInputs(plan);
+  PADDLE_ENFORCE_EQ(
+      predictor_->Run(),
+      true,
+      common::errors::External("Failed to run the step of %d rows.",
+                               plan.rows()));
+  return scheduler_.Update(plan, FetchNextTokens(plan.rows()));
+}
+
+std::vector<std::shared_ptr<Request>> ContinuousBatchingEngine::Generate(
+    const std::vector<std::shared_ptr<Request>>& requests) {
+  for (const auto& request : requests) {
+    AddRequest(request);
+  }
+  std::vector<std::shared_ptr<Request>> finished;
+  while (HasUnfinished()) {
+    auto step_finished = Step();
+    finished.insert(finished.end(), step_finished.begin(), step_finished.end());
+  }
+  return finished;
+}
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/inference/api/llm/batch_scheduler.h"
+#include "paddle/fluid/inference/api/llm/block_manager.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/phi/core/allocator.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+struct LLMEngineConfig {
+  SchedulerConfig scheduler;
+
+  // [num_blocks, kv_num_heads, block_size, head_dim], it also sets the number
+  // of device blocks and the block size
+  std::vector<int> cache_shape;
+  // pinned host blocks for swapped out requests, 0 preempts by recomputation
+  int num_cpu_blocks{0};
+  // share the cached blocks of common prompt prefixes between requests
+  bool enable_prefix_caching{false};
+  int device_id{0};
+  paddle_infer::DataType cache_dtype{paddle_infer::DataType::FLOAT16};
+  // the key and value caches of all layers, fed to block_multihead_attention
+  std::vector<std::string> cache_names;
+
+  // int64 [rows, max_input_len]
+  std::string input_ids_name{"input_ids"};
+  // int32 [rows, 1]
+  std::string seq_lens_encoder_name{"seq_lens_encoder"};
+  std::string seq_lens_decoder_name{"seq_lens_decoder"};
+  std::string seq_lens_this_time_name{"seq_lens_this_time"};
+  // int32 [rows, max_blocks_per_seq]
+  std::string block_tables_name{"block_tables"};
+  // int32 or int64 [rows] or [rows, 1], the first output if empty
+  std::string next_tokens_name;
+  int64_t pad_token_id{0};
+};
+
+/// \brief Serves generation requests with continuous batching on a predictor
+/// of a decoder model built on block_multihead_attention. The engine owns the
+/// paged KV cache tensors of the model, and every Step() schedules one batch,
+/// moves the KV blocks of swapped requests between the device and the pinned
+/// host pool on the execution stream of the predictor, runs the predictor and
+/// appends the sampled tokens.
+///
+/// The model computes the padding offsets, the rotary embeddings and the
+/// sampling from the inputs above, as the block attention models of
+/// PaddleNLP do.
+class ContinuousBatchingEngine {
+ public:
+  ContinuousBatchingEngine(
+      const std::shared_ptr<paddle_infer::Predictor>& predictor,
+      const LLMEngineConfig& config);
+  ~ContinuousBatchingEngine();
+
+  void AddRequest(const std::shared_ptr<Request>& request);
+  void AbortRequest(int64_t request_id);
+  void ForkRequest(int64_t parent_id, const std::shared_ptr<Request>& child);
+  bool HasUnfinished() const { return scheduler_.HasUnfinished(); }
+
+  /// Runs one step, returns the requests finished in it.
+  std::vector<std::shared_ptr<Request>> Step();
+  /// Runs the requests to the end, returns them in the order they finish.
+  std::vector<std::shared_ptr<Request>> Generate(
+      const std::vector<std::shared_ptr<Request>>& requests);
+
+  const KVCacheBlockManager& block_manager() const { return block_manager_; }
+
+ private:
+  void InitKVCache();
+  void SwapBlocks(const KVCacheBlockManager::BlockMapping& mapping,
+                  bool to_host);
+  void CopyBlocks(const KVCacheBlockManager::BlockMapping& mapping);
+  void FeedInputs(const StepPlan& plan);
+  std::vector<int64_t> FetchNextTokens(int rows);
+
+  std::shared_ptr<paddle_infer::Predictor> predictor_;
+  LLMEngineConfig config_;
+  KVCacheBlockManager block_manager_;
+  ContinuousBatchScheduler scheduler_;
+
+  size_t block_bytes_{0};
+  std::vector<void*> gpu_caches_;
+  std::vector<phi::Allocator::AllocationPtr> cpu_caches_;
+
+  DISABLE_COPY_AND_ASSIGN(ContinuousBatchingEngine);
+};
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
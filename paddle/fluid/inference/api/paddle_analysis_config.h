@@ -420,6 +420,15 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void Exp_EnableUseCutlass();
   ///
+  /// \brief Set how fused_weight_only_linear_pass quantizes the fp16/bf16
+  /// matmul weights of the model on Nvidia GPU.
+  ///
+  /// \param algo "weight_only_int8" or "weight_only_int4".
+  /// \param group_size -1 for per-channel scales, 64 or 128 for a scale per
+  /// group of that many input channels.
+  ///
+  void Exp_SetWeightOnlyQuant(const std::string& algo, int group_size = -1);
+  ///
   ///
   /// \brief A boolean state telling whether the XPU is turned on.
   ///
@@ -660,6 +669,19 @@ struct PD_INFER_DECL AnalysisConfig {
     return !min_input_shape_.empty();
   }
   ///
+  /// \brief The max input shapes set by SetTRTDynamicShapeInfo.
+  ///
+  const std::map<std::string, std::vector<int>>& trt_max_input_shape() const {
+    return max_input_shape_;
+  }
+  ///
+  /// \brief The opt input shapes set by SetTRTDynamicShapeInfo.
+  ///
+  const std::map<std::string, std::vector<int>>& trt_optim_input_shape()
+      const {
+    return optim_input_shape_;
+  }
+  ///
   /// \brief Enable tuned tensorrt dynamic shape.
   ///
   /// \param shape_range_info_path the path to shape_info file got in
@@ -723,6 +745,53 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool shape_range_info_collected() const;
 
+  ///
+  /// \brief Collect the shapes into several TensorRT optimization profiles.
+  /// The runs are clustered by the size of their inputs, so that traffic with
+  /// short and long inputs gets a profile tuned for each, and the engine runs
+  /// every input on the closest profile that holds it. The shape range of all
+  /// the runs is kept as the first profile.
+  ///
+  /// \param num_profiles the max number of tuned profiles, 1 means the shape
+  /// range of all the runs only.
+  ///
+  void SetTRTShapeProfileNum(int num_profiles);
+
+  ///
+  /// \brief The max number of tuned TensorRT optimization profiles.
+  ///
+  /// \return int The max number of tuned profiles.
+  ///
+  int trt_shape_profile_num() const { return trt_shape_profile_num_; }
+
+  ///
+  /// \brief Warm up the predictor when it is created. The inputs are filled
+  /// with the max, opt and min shapes collected by CollectShapeRangeInfo and
+  /// the predictor runs once for each, so that the allocator growth, kernel
+  /// autotune, oneDNN primitives and TensorRT contexts are set up before the
+  /// first request. The allocator keeps the memory of the run with the max
+  /// shapes. The predictor is returned after the warm-up has completed.
+  ///
+  /// \param shape_range_info_path the shape info file, empty means the file
+  /// given to EnableTunedTensorRtDynamicShape.
+  ///
+  void EnableWarmup(const std::string& shape_range_info_path = "");
+
+  ///
+  /// \brief A boolean state telling whether the predictor is warmed up when
+  /// it is created.
+  ///
+  /// \return bool Whether the warm-up is enabled.
+  ///
+  bool warmup_enabled() const { return warmup_enabled_; }
+
+  ///
+  /// \brief The shape info file of the warm-up.
+  ///
+  /// \return the shape info path.
+  ///
+  const std::string& warmup_shape_range_info_path() const;
+
   ///
   /// \brief Prevent ops running in Paddle-TRT
   /// NOTE: just experimental, not an official stable API, easy to be broken.
@@ -826,6 +895,49 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool new_executor_enabled() const { return use_new_executor_; }
 
+  ///
+  /// \brief Allocate the variables of the predictor's working scope from a
+  /// bump arena. The variables of a predictor (and of each of its clones)
+  /// then live in a few contiguous blocks that are released in one step when
+  /// the predictor is destroyed.
+  ///
+  /// \param x Whether to use the scope arena.
+  ///
+  void EnableScopeArena(bool x = true) { use_scope_arena_ = x; }
+
+  ///
+  /// \brief A boolean state telling whether the scope arena is used.
+  ///
+  /// \return bool Whether the scope arena is used.
+  ///
+  bool scope_arena_enabled() const { return use_scope_arena_; }
+
+  ///
+  /// \brief Launch ZeroCopyRun on GPU through CUDA Graphs, needs the new
+  /// executor. The first run of every set of input shapes and data types
+  /// launches the kernels and then captures them into a graph with a memory
+  /// pool of its own, this and later runs replay the graph. The graphs read
+  /// the inputs from the buffers they were captured with, an input that
+  /// moved is copied there first. The model must not synchronize with the
+  /// host, e.g. by reading a shape from a GPU tensor.
+  ///
+  /// \param max_num_graphs The number of input shapes to capture graphs for,
+  /// the kernels of other shapes are launched one by one.
+  ///
+  void EnableCUDAGraph(int max_num_graphs = 8);
+  ///
+  /// \brief A boolean state telling whether CUDA Graphs are used.
+  ///
+  /// \return bool Whether CUDA Graphs are used.
+  ///
+  bool cuda_graph_enabled() const { return use_cuda_graph_; }
+  ///
+  /// \brief The number of input shapes CUDA Graphs are captured for.
+  ///
+  /// \return int The number of input shapes.
+  ///
+  int cuda_graph_max_num_graphs() const { return cuda_graph_max_num_graphs_; }
+
   /// \brief A boolean state telling whether to use new IR.
   ///
   /// \return bool whether to use new IR.
@@ -836,6 +948,9 @@ struct PD_INFER_DECL AnalysisConfig {
 
   ///
   /// \brief Control whether to use optimized model to inference.
+  /// The optimized model is saved with a key of the model files, the config
+  /// and the device. When any of them changes, the model is optimized and
+  /// saved again instead of loading the outdated one.
   ///
   /// \param x whether to use optimized model.
   ///
@@ -872,6 +987,24 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   void SetMkldnnCacheCapacity(int capacity);
   ///
+  /// \brief Share the OneDNN primitives of the predictor and its clones
+  /// through a process-wide cache, so that a clone reuses the primitives
+  /// created by the others for the same input shapes instead of creating its
+  /// own. FLAGS_onednn_shared_primitive_cache_capacity bounds the cache.
+  ///
+  /// \param x Whether to share the OneDNN primitives.
+  ///
+  void EnableMkldnnPrimitiveSharing(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the OneDNN primitives are shared
+  /// by the clones.
+  ///
+  /// \return bool Whether the OneDNN primitives are shared.
+  ///
+  bool mkldnn_primitive_sharing_enabled() const {
+    return mkldnn_primitive_sharing_;
+  }
+  ///
   /// \brief A boolean state telling whether to use the OneDNN.
   ///
   /// \return bool Whether to use the OneDNN.
@@ -895,6 +1028,24 @@ struct PD_INFER_DECL AnalysisConfig {
     return cpu_math_library_num_threads_;
   }
 
+  ///
+  /// \brief Shard the CPU predictor and its clones across the NUMA nodes.
+  /// Every clone is assigned a node round robin, keeps its cpu math library
+  /// threads on the cpus of the node, and runs on a replica of the weights
+  /// placed in the memory of the node, shared by the clones of the node. The
+  /// predictor itself runs on node 0 with the weights it loaded.
+  ///
+  /// \param x Whether to shard the predictors across the NUMA nodes.
+  ///
+  void EnableNumaSharding(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the predictors are sharded
+  /// across the NUMA nodes.
+  ///
+  /// \return bool Whether the predictors are sharded across the NUMA nodes.
+  ///
+  bool numa_sharding_enabled() const { return numa_sharding_; }
+
   ///
   /// \brief Transform the AnalysisConfig to NativeConfig.
   ///
@@ -985,6 +1136,22 @@ struct PD_INFER_DECL AnalysisConfig {
   /// \return bool Whether model and params are loaded directly from memory.
   ///
   bool model_from_memory() const { return model_from_memory_; }
+  ///
+  /// \brief Map the combined params file into memory instead of reading it,
+  /// for the PIR model. The parameters keep pointing into the mapping until
+  /// they are moved to the device, so their pages are read from the file when
+  /// they are first used. Not supported on Windows.
+  ///
+  /// \param x Whether to map the params file.
+  ///
+  void EnableMmapParams(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the params file is mapped into
+  /// memory.
+  ///
+  /// \return bool Whether the params file is mapped into memory.
+  ///
+  bool mmap_params_enabled() const { return mmap_params_; }
 
   ///
   /// \brief Turn on memory optimize
@@ -1000,6 +1167,24 @@ struct PD_INFER_DECL AnalysisConfig {
   /// \return bool Whether the memory optimization is activated.
   ///
   bool enable_memory_optim() const;
+  ///
+  /// \brief Return the memory of the intermediate tensors to the memory pool
+  /// of the device after every run, instead of keeping it for the next run of
+  /// this predictor. Predictors of different models on the same device and
+  /// stream that run one after another then take their activations from the
+  /// same memory, so an idle model holds only its parameters. The inputs and
+  /// outputs stay valid until the next run.
+  ///
+  /// \param x Whether to share the activation memory between predictors.
+  ///
+  void EnableActivationMemorySharing(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the activation memory is
+  /// returned to the memory pool after every run.
+  ///
+  /// \return bool Whether the activation memory is shared.
+  ///
+  bool activation_memory_sharing() const { return share_activation_memory_; }
 
   ///
   /// \brief Turn on profiling report.
@@ -1013,6 +1198,22 @@ struct PD_INFER_DECL AnalysisConfig {
   ///
   bool profile_enabled() const { return with_profile_; }
 
+  ///
+  /// \brief Record the latency of the stages of every run, the input copies,
+  /// the dispatch of the ops, the wait for the device, and the output copies,
+  /// in histograms read by Predictor::GetRunTelemetry. The host waits for the
+  /// device at the end of every run to time it.
+  ///
+  /// \param x Whether to record the run telemetry.
+  ///
+  void EnableRunTelemetry(bool x = true);
+  ///
+  /// \brief A boolean state telling whether the run telemetry is recorded.
+  ///
+  /// \return bool Whether the run telemetry is recorded.
+  ///
+  bool run_telemetry_enabled() const { return with_run_telemetry_; }
+
   ///
   /// \brief Mute all logs in Paddle inference.
   ///
@@ -1143,6 +1344,8 @@ struct PD_INFER_DECL AnalysisConfig {
   // GPU related.
   bool use_gpu_{false};
   bool use_cutlass_{false};
+  std::string weight_only_algo_{"weight_only_int8"};
+  int weight_only_group_size_{-1};
   int gpu_device_id_{0};
   uint64_t memory_pool_init_size_mb_{100};  // initial size is 100MB.
   bool enable_gpu_mixed_{false};
@@ -1217,9 +1420,15 @@ struct PD_INFER_DECL AnalysisConfig {
   // min_shape, max_shape and opt_shape and save in shape_range_info_path_;
   bool collect_shape_range_info_{false};
   std::string shape_range_info_path_;
+  // Clusters of the collected runs, each of which gets its own profile.
+  int trt_shape_profile_num_{1};
+  // Run the collected shapes once when the predictor is created.
+  bool warmup_enabled_{false};
+  std::string warmup_shape_range_info_path_;
 
   // memory reuse related.
   bool enable_memory_optim_{false};
+  bool share_activation_memory_{false};
   bool trt_engine_memory_sharing_{true};
   int trt_engine_memory_sharing_identifier_{0};
 
@@ -1233,6 +1442,7 @@ struct PD_INFER_DECL AnalysisConfig {
   std::unordered_set<std::string> mkldnn_enabled_op_types_;
 
   bool model_from_memory_{false};
+  bool mmap_params_{false};
 
   bool enable_ir_optim_{true};
   bool ir_debug_{false};
@@ -1241,11 +1451,18 @@ struct PD_INFER_DECL AnalysisConfig {
 
   bool use_new_executor_{false};
 
+  bool use_scope_arena_{false};
+
+  bool use_cuda_graph_{false};
+  int cuda_graph_max_num_graphs_{8};
+
   bool specify_input_name_{false};
 
   int cpu_math_library_num_threads_{1};
+  bool numa_sharding_{false};
 
   bool with_profile_{false};
+  bool with_run_telemetry_{false};
 
   bool with_glog_info_{true};
 
@@ -1263,6 +1480,7 @@ struct PD_INFER_DECL AnalysisConfig {
 
   // onednn related.
   int mkldnn_cache_capacity_{10};
+  bool mkldnn_primitive_sharing_{false};
   bool use_mkldnn_bfloat16_{false};
   std::unordered_set<std::string> bfloat16_enabled_op_types_;
   bool use_mkldnn_int8_{false};
@@ -349,6 +349,10 @@ class PD_INFER_DECL PaddlePredictor {
 
   virtual void* GetExecStream() const { return nullptr; }
 
+  /// \brief The run telemetry in the Prometheus text format, empty when it
+  /// is not recorded.
+  virtual std::string GetRunTelemetry() const { return ""; }
+
  protected:
   virtual const void* GetDeviceContexts() const { return nullptr; }
 };
@@ -40,6 +40,19 @@ void TensorUtils::CudaFreePinnedMemory(void* ptr) {
 #endif
 }
 
+void TensorUtils::CudaRegisterPinnedMemory(void* mem, size_t size) {
+#if defined(PADDLE_WITH_CUDA)
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaHostRegister(mem, size, cudaHostRegisterPortable));
+#endif
+}
+
+void TensorUtils::CudaUnregisterPinnedMemory(void* mem) {
+#if defined(PADDLE_WITH_CUDA)
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaHostUnregister(mem));
+#endif
+}
+
 void TensorUtils::CopyTensorImpl(Tensor* p_dst,
                                  const Tensor& src,
                                  void* exec_stream,
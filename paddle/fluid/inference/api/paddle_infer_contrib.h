@@ -23,6 +23,9 @@ class TensorUtils {
  public:
   static void* CudaMallocPinnedMemory(size_t size);
   static void CudaFreePinnedMemory(void* mem);
+  // pins host memory allocated by the caller, e.g. for CopyFromCpuAsync
+  static void CudaRegisterPinnedMemory(void* mem, size_t size);
+  static void CudaUnregisterPinnedMemory(void* mem);
 
   static void CopyTensor(Tensor* p_dst, const Tensor& src);
   static void CopyTensorAsync(Tensor* p_dst,
@@ -22,8 +22,10 @@ limitations under the License. */
 #pragma once
 
 #include <cassert>
+#include <condition_variable>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -210,6 +212,15 @@ class PD_INFER_DECL Predictor {
   ///
   void* GetExecStream() const;
 
+  ///
+  /// \brief Get the latency histograms of the stages of the runs, recorded
+  /// when Config::EnableRunTelemetry is on.
+  ///
+  /// \return The histograms in the Prometheus text exposition format, or an
+  /// empty string when the telemetry is not recorded.
+  ///
+  std::string GetRunTelemetry() const;
+
  private:
   std::unique_ptr<paddle::PaddlePredictor> predictor_;
   friend class paddle_infer::experimental::InternalUtils;
@@ -272,6 +283,64 @@ class PD_INFER_DECL PredictorPool {
   std::shared_ptr<Predictor> main_pred_;
   std::vector<std::unique_ptr<Predictor>> preds_;
 };
+
+///
+/// \class ConcurrentPredictor
+///
+/// \brief ConcurrentPredictor runs the requests of many threads on one model
+/// at the same time. Every running request takes an executor, which shares
+/// the weights of the model and runs on a stream of its own on GPU. The
+/// executors are created when the requests overlap, up to \param max_streams,
+/// and return the memory of the intermediate tensors to the stream-ordered
+/// memory pool after every run, so the memory grows with the requests that
+/// are running, not with the number of executors.
+///
+/// Usage:
+///
+/// \code{.cpp}
+/// services::ConcurrentPredictor predictor(config, 4);
+/// // on every thread
+/// std::vector<paddle::Tensor> outputs;
+/// predictor.Run(inputs, &outputs);
+/// \endcode
+///
+class PD_INFER_DECL ConcurrentPredictor {
+ public:
+  ConcurrentPredictor() = delete;
+  ConcurrentPredictor(const ConcurrentPredictor&) = delete;
+  ConcurrentPredictor& operator=(const ConcurrentPredictor&) = delete;
+
+  explicit ConcurrentPredictor(const Config& config, size_t max_streams = 4);
+  ~ConcurrentPredictor();
+
+  ///
+  /// \brief Run one request. thread safe. It blocks while \param max_streams
+  /// requests are running.
+  ///
+  /// \param[in] inputs A list of input tensors in the order of the input names
+  /// \param[out] outputs A list of output tensors, ready when it returns
+  /// \return Whether the run is successful
+  ///
+  bool Run(const std::vector<paddle::Tensor>& inputs,
+           std::vector<paddle::Tensor>* outputs);
+
+  /// \brief Get the input names
+  std::vector<std::string> GetInputNames();
+
+  /// \brief Get the output names
+  std::vector<std::string> GetOutputNames();
+
+  /// \brief Get the number of executors created so far.
+  size_t GetNumExecutors();
+
+ private:
+  std::unique_ptr<paddle::PaddlePredictor> main_pred_;
+  std::vector<std::unique_ptr<paddle::PaddlePredictor>> preds_;
+  std::vector<paddle::PaddlePredictor*> idle_preds_;
+  size_t max_streams_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+};
 }  // namespace services
 
 }  // namespace paddle_infer
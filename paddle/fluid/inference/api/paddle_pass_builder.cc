@@ -221,6 +221,7 @@ const std::vector<std::string> kCINNCompilerPasses{
 const std::vector<std::string> CpuBasicPasses{
     "simplify_with_basic_ops_pass",  //
     "layer_norm_fuse_pass",
+    "preln_residual_bias_fuse_pass",  //
     "attention_lstm_fuse_pass",       //
     "seqconv_eltadd_relu_fuse_pass",  //
     // "seqpool_concat_fuse_pass",    //
@@ -585,6 +586,7 @@ const std::vector<std::string> kPirGpuPasses{
     "add_shadow_output_after_dead_parameter_pass",
     "delete_quant_dequant_linear_op_pass",
     "delete_weight_dequant_linear_op_pass",
+    "matmul_fp8_fuse_pass",
     "map_op_to_another_pass",
     "identity_op_clean_pass",
     // Operator fusion pass
@@ -597,15 +599,18 @@ const std::vector<std::string> kPirGpuPasses{
     "fused_flash_attn_pass",
     "multihead_matmul_fuse_pass",
     "fused_weight_only_linear_pass",
+    "matmul_sparse_24_fuse_pass",
     "matmul_add_act_fuse_pass",
     "fc_elementwise_layernorm_fuse_pass",
     "add_norm_fuse_pass",
+    "fused_qk_norm_rope_fuse_pass",
     "group_norm_silu_fuse_pass",
     "matmul_scale_fuse_pass",
     "matmul_transpose_fuse_pass",
     "transpose_flatten_concat_fuse_pass",
     "remove_redundant_transpose_pass",
     "horizontal_fuse_pass",
+    "horizontal_batch_fuse_pass",
 };
 
 const std::vector<std::string> kPirXpuPasses{
@@ -677,6 +682,9 @@ const std::vector<std::string> kPirMkldnnBf16Passes{
 const std::vector<std::string> kPirCpuPasses{
     "add_shadow_output_after_dead_parameter_pass",
     "delete_quant_dequant_linear_op_pass",
-    "delete_weight_dequant_linear_op_pass"};
+    "delete_weight_dequant_linear_op_pass",
+    "matmul_int8_fuse_pass",
+    "embedding_seqpool_cvm_fuse_pass",
+    "weight_prepack_pass"};
 
 }  // namespace paddle
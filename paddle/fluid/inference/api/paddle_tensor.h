@@ -15,6 +15,7 @@
 #pragma once
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -117,6 +118,17 @@ class PD_INFER_DECL Tensor {
   template <typename T>
   void CopyFromCpu(const T* data);
 
+  /// \brief Copy the host memory to tensor data asynchronously.
+  /// The copy runs on a copy stream of the predictor, so the inputs of the
+  /// next Run can be copied while the current one computes, and the next Run
+  /// waits for it on the device. Only GPU input tensors support it now.
+  /// \param data The pointer of the data, from which the tensor will copy. It
+  /// should be pinned, see contrib::TensorUtils::CudaRegisterPinnedMemory,
+  /// and must stay valid until the copy has completed.
+  /// \return A future that becomes ready when the copy has completed.
+  template <typename T>
+  std::shared_future<void> CopyFromCpuAsync(const T* data);
+
   /// \brief Share the data with tensor data.
   /// It's usually used to set the tensor data.
   /// \param data The pointer of the data, from which the tensor will share.
@@ -202,6 +214,10 @@ class PD_INFER_DECL Tensor {
   bool input_or_output_;
   void* scope_{nullptr};
   const void* device_contexts_{nullptr};
+  // stages CopyFromCpuAsync, owned by the predictor
+  void* input_stager_{nullptr};
+  // records the copies, owned by the predictor
+  void* telemetry_{nullptr};
   PlaceType place_;
   int device_;
   std::string device_type_;
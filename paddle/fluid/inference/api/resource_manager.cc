@@ -257,7 +257,8 @@ dnnHandle_t GPUContextResource::GetDnnHandle() const { return dnn_handle_; }
 
 std::function<phi::dnnHandle_t()> GPUContextResource::GetDnnHandleCreator() {
   return [&]() -> phi::dnnHandle_t {
-    InitDnnHandle();
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (dnn_handle_ == nullptr) InitDnnHandle();
     return dnn_handle_;
   };
 }
@@ -266,7 +267,8 @@ blasHandle_t GPUContextResource::GetBlasHandle() const { return blas_handle_; }
 
 std::function<phi::blasHandle_t()> GPUContextResource::GetBlasHandleCreator() {
   return [&]() -> phi::blasHandle_t {
-    phi::InitBlasHandle(&blas_handle_, stream_);
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (blas_handle_ == nullptr) phi::InitBlasHandle(&blas_handle_, stream_);
     return blas_handle_;
   };
 }
@@ -280,9 +282,12 @@ GPUContextResource::GetBlasTensorCoreHandleCreator() {
   return [&]() -> phi::blasHandle_t {
 #ifdef PADDLE_WITH_CUDA
 #if CUDA_VERSION >= 9000
-    phi::InitBlasHandle(&blas_tensor_core_handle_, stream_);
-    PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
-        blas_tensor_core_handle_, CUBLAS_TENSOR_OP_MATH));
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (blas_tensor_core_handle_ == nullptr) {
+      phi::InitBlasHandle(&blas_tensor_core_handle_, stream_);
+      PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+          blas_tensor_core_handle_, CUBLAS_TENSOR_OP_MATH));
+    }
 #endif
 #endif
     return blas_tensor_core_handle_;
@@ -298,9 +303,12 @@ GPUContextResource::GetBlasTF32TensorCoreHandleCreator() {
   return [&]() -> phi::blasHandle_t {
 #ifdef PADDLE_WITH_CUDA
 #if CUDA_VERSION >= 11000
-    phi::InitBlasHandle(&blas_tf32_tensor_core_handle_, stream_);
-    PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
-        blas_tf32_tensor_core_handle_, CUBLAS_TF32_TENSOR_OP_MATH));
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (blas_tf32_tensor_core_handle_ == nullptr) {
+      phi::InitBlasHandle(&blas_tf32_tensor_core_handle_, stream_);
+      PADDLE_RETRY_CUDA_SUCCESS(phi::dynload::cublasSetMathMode(
+          blas_tf32_tensor_core_handle_, CUBLAS_TF32_TENSOR_OP_MATH));
+    }
 #endif
 #endif
     return blas_tf32_tensor_core_handle_;
@@ -314,7 +322,8 @@ blasLtHandle_t GPUContextResource::GetBlasLtHandle() const {
 std::function<phi::blasLtHandle_t()>
 GPUContextResource::GetBlasLtHandleCreator() {
   return [&]() {
-    InitBlasLtHandle();
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (blaslt_handle_ == nullptr) InitBlasLtHandle();
     return blaslt_handle_;
   };
 }
@@ -326,7 +335,8 @@ phi::solverHandle_t GPUContextResource::GetSolverDnHandle() const {
 std::function<phi::solverHandle_t()>
 GPUContextResource::GetSolverDnHandleCreator() {
   return [&]() {
-    InitSolverHandle();
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (solver_handle_ == nullptr) InitSolverHandle();
     return solver_handle_;
   };
 }
@@ -338,7 +348,8 @@ phi::sparseHandle_t GPUContextResource::GetSparseHandle() const {
 std::function<phi::sparseHandle_t()>
 GPUContextResource::GetSparseHandleCreator() {
   return [&]() {
-    InitSparseHandle();
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (sparse_handle_ == nullptr) InitSparseHandle();
     return sparse_handle_;
   };
 }
@@ -349,8 +360,11 @@ Eigen::GpuDevice* GPUContextResource::GetGpuEigenDevice() const {
 
 std::function<Eigen::GpuDevice*()>
 GPUContextResource::GetGpuEigenDeviceCreator() {
+  // NOTE: the eigen device is created with the resource, re-creating it here
+  // would leave the contexts which share this resource with a dangling one.
   return [&]() {
-    InitGpuEigenDevice();
+    std::lock_guard<std::mutex> lock_guard(handle_mutex_);
+    if (gpu_eigen_device_ == nullptr) InitGpuEigenDevice();
     return gpu_eigen_device_.get();
   };
 }
@@ -417,6 +431,7 @@ void* ResourceManager::InitGPUResource(const phi::Place& place, void* stream) {
 }
 
 void ResourceManager::DestroyGPUResource(void* stream) {
+  std::lock_guard<std::mutex> lock_guard(gpu_mutex_);
   PADDLE_ENFORCE_EQ(gpu_resources_.count(stream),
                     true,
                     common::errors::InvalidArgument(
@@ -122,6 +122,10 @@ class GPUContextResource {
   phi::solverHandle_t solver_handle_{nullptr};
   phi::sparseHandle_t sparse_handle_{nullptr};
   // DnnWorkspaceHandle
+
+  // The predictors and clones bound to the same stream share this resource,
+  // the handles are created by the first of them and reused by the others.
+  std::mutex handle_mutex_;
 };
 #endif
 
@@ -0,0 +1,377 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/serving/batch_policy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "paddle/common/enforce.h"
+
+namespace paddle {
+namespace inference {
+namespace serving {
+
+namespace {
+
+size_t SizeOfDType(PaddleDType dtype) {
+  switch (dtype) {
+    case PaddleDType::FLOAT64:
+    case PaddleDType::INT64:
+      return 8;
+    case PaddleDType::FLOAT32:
+    case PaddleDType::INT32:
+      return 4;
+    case PaddleDType::FLOAT16:
+    case PaddleDType::BFLOAT16:
+      return 2;
+    case PaddleDType::UINT8:
+    case PaddleDType::INT8:
+    case PaddleDType::BOOL:
+      return 1;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported data type %d.", static_cast<int>(dtype)));
+  }
+}
+
+int64_t NumElements(const std::vector<int>& shape) {
+  int64_t numel = 1;
+  for (int dim : shape) {
+    numel *= dim;
+  }
+  return numel;
+}
+
+size_t RowBytes(const std::vector<int>& shape, PaddleDType dtype) {
+  size_t bytes = SizeOfDType(dtype);
+  for (size_t i = 1; i < shape.size(); ++i) {
+    bytes *= shape[i];
+  }
+  return bytes;
+}
+
+PaddleTensor MakeTensor(const std::string& name,
+                        PaddleDType dtype,
+                        const std::vector<int>& shape) {
+  PaddleTensor tensor;
+  tensor.name = name;
+  tensor.dtype = dtype;
+  tensor.shape = shape;
+  tensor.data.Resize(NumElements(shape) * SizeOfDType(dtype));
+  return tensor;
+}
+
+// copies src into dst, whose dimensions are at least those of src, the rest
+// of dst is left as it is
+void CopyPadded(const char* src,
+                const std::vector<int>& src_shape,
+                char* dst,
+                const std::vector<int>& dst_shape,
+                size_t dim,
+                size_t bytes_per_element) {
+  if (dim + 1 == src_shape.size()) {
+    std::memcpy(dst, src, src_shape[dim] * bytes_per_element);
+    return;
+  }
+  size_t src_stride = bytes_per_element;
+  size_t dst_stride = bytes_per_element;
+  for (size_t i = dim + 1; i < src_shape.size(); ++i) {
+    src_stride *= src_shape[i];
+    dst_stride *= dst_shape[i];
+  }
+  for (int i = 0; i < src_shape[dim]; ++i) {
+    CopyPadded(src + i * src_stride,
+               src_shape,
+               dst + i * dst_stride,
+               dst_shape,
+               dim + 1,
+               bytes_per_element);
+  }
+}
+
+PaddleTensor PackRagged(const std::vector<const PaddleTensor*>& tensors) {
+  const PaddleTensor& first = *tensors.front();
+  std::vector<int> shape(first.shape);
+  shape[0] = 0;
+  for (const auto* tensor : tensors) {
+    PADDLE_ENFORCE_EQ(
+        tensor->lod.size(),
+        first.lod.size(),
+        common::errors::InvalidArgument(
+            "The LoD levels of input %s differ between requests, %d vs %d.",
+            first.name,
+            tensor->lod.size(),
+            first.lod.size()));
+    PADDLE_ENFORCE_EQ(
+        std::equal(tensor->shape.begin() + 1,
+                   tensor->shape.end(),
+                   first.shape.begin() + 1,
+                   first.shape.end()),
+        true,
+        common::errors::InvalidArgument(
+            "The LoD input %s is packed ragged, so the dimensions after the "
+            "first must be the same for all requests.",
+            first.name));
+    shape[0] += tensor->shape[0];
+  }
+
+  PaddleTensor packed = MakeTensor(first.name, first.dtype, shape);
+  packed.lod.assign(first.lod.size(), std::vector<size_t>{0});
+  char* dst = static_cast<char*>(packed.data.data());
+  for (const auto* tensor : tensors) {
+    size_t bytes = NumElements(tensor->shape) * SizeOfDType(tensor->dtype);
+    std::memcpy(dst, tensor->data.data(), bytes);
+    dst += bytes;
+    // every level offsets the entries of the next one, which are appended in
+    // the same request order
+    for (size_t level = 0; level < tensor->lod.size(); ++level) {
+      auto& merged = packed.lod[level];
+      size_t base = merged.back();
+      const auto& offsets = tensor->lod[level];
+      for (size_t i = 1; i < offsets.size(); ++i) {
+        merged.push_back(base + offsets[i] - offsets.front());
+      }
+    }
+  }
+  return packed;
+}
+
+PaddleTensor PackPadded(const std::vector<const PaddleTensor*>& tensors,
+                        int64_t padded_rows) {
+  const PaddleTensor& first = *tensors.front();
+  std::vector<int> shape(first.shape);
+  int64_t rows = 0;
+  for (const auto* tensor : tensors) {
+    PADDLE_ENFORCE_EQ(
+        !tensor->shape.empty() && tensor->shape.size() == first.shape.size(),
+        true,
+        common::errors::InvalidArgument(
+            "Input %s must have a batch dimension and the same rank in all "
+            "requests.",
+            first.name));
+    for (size_t i = 1; i < shape.size(); ++i) {
+      shape[i] = std::max(shape[i], tensor->shape[i]);
+    }
+    rows += tensor->shape[0];
+  }
+  shape[0] = static_cast<int>(std::max(rows, padded_rows));
+
+  PaddleTensor packed = MakeTensor(first.name, first.dtype, shape);
+  std::memset(packed.data.data(), 0, packed.data.length());
+  size_t bytes_per_element = SizeOfDType(first.dtype);
+  size_t row_bytes = RowBytes(shape, first.dtype);
+  char* dst = static_cast<char*>(packed.data.data());
+  for (const auto* tensor : tensors) {
+    if (tensor->shape[0] > 0) {
+      CopyPadded(static_cast<const char*>(tensor->data.data()),
+                 tensor->shape,
+                 dst,
+                 shape,
+                 0,
+                 bytes_per_element);
+    }
+    dst += tensor->shape[0] * row_bytes;
+  }
+  return packed;
+}
+
+PaddleTensor SliceRows(const PaddleTensor& tensor,
+                       int64_t begin,
+                       int64_t end) {
+  std::vector<int> shape(tensor.shape);
+  shape[0] = static_cast<int>(end - begin);
+  PaddleTensor slice = MakeTensor(tensor.name, tensor.dtype, shape);
+  if (slice.data.length() > 0) {
+    std::memcpy(slice.data.data(),
+                static_cast<const char*>(tensor.data.data()) +
+                    begin * RowBytes(tensor.shape, tensor.dtype),
+                slice.data.length());
+  }
+  return slice;
+}
+
+}  // namespace
+
+BatchPolicy::BatchPolicy(int max_batch_size,
+                         std::vector<int> preferred_batch_sizes,
+                         bool pad_to_preferred_batch_size)
+    : max_batch_size_(max_batch_size),
+      preferred_batch_sizes_(std::move(preferred_batch_sizes)),
+      pad_to_preferred_batch_size_(pad_to_preferred_batch_size) {
+  PADDLE_ENFORCE_GT(max_batch_size_,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The max batch size must be positive, but got %d.",
+                        max_batch_size_));
+  std::sort(preferred_batch_sizes_.begin(), preferred_batch_sizes_.end());
+  preferred_batch_sizes_.erase(
+      std::unique(preferred_batch_sizes_.begin(), preferred_batch_sizes_.end()),
+      preferred_batch_sizes_.end());
+  preferred_batch_sizes_.erase(
+      std::remove_if(preferred_batch_sizes_.begin(),
+                     preferred_batch_sizes_.end(),
+                     [this](int size) {
+                       return size <= 0 || size > max_batch_size_;
+                     }),
+      preferred_batch_sizes_.end());
+}
+
+size_t BatchPolicy::NumRequestsToRun(const std::vector<int64_t>& queued_rows,
+                                     bool timed_out) const {
+  int64_t rows = 0;
+  size_t num_requests = 0;
+  size_t num_preferred = 0;
+  for (int64_t request_rows : queued_rows) {
+    if (rows + request_rows > max_batch_size_) {
+      break;
+    }
+    rows += request_rows;
+    ++num_requests;
+    if (std::binary_search(preferred_batch_sizes_.begin(),
+                           preferred_batch_sizes_.end(),
+                           rows)) {
+      num_preferred = num_requests;
+    }
+  }
+  bool full = rows == max_batch_size_ || num_requests < queued_rows.size();
+  return full || timed_out ? num_requests : num_preferred;
+}
+
+int64_t BatchPolicy::PaddedRows(int64_t rows) const {
+  if (!pad_to_preferred_batch_size_) {
+    return rows;
+  }
+  auto it = std::lower_bound(
+      preferred_batch_sizes_.begin(), preferred_batch_sizes_.end(), rows);
+  return it == preferred_batch_sizes_.end() ? rows : *it;
+}
+
+int64_t NumBatchRows(const std::vector<PaddleTensor>& inputs) {
+  PADDLE_ENFORCE_EQ(inputs.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "A request must have at least one input."));
+  for (const auto& input : inputs) {
+    if (!input.lod.empty()) {
+      return static_cast<int64_t>(input.lod.front().size()) - 1;
+    }
+  }
+  PADDLE_ENFORCE_EQ(inputs.front().shape.empty(),
+                    false,
+                    common::errors::InvalidArgument(
+                        "Input %s of a batched request must have a batch "
+                        "dimension.",
+                        inputs.front().name));
+  return inputs.front().shape.front();
+}
+
+std::vector<PaddleTensor> PackBatch(
+    const std::vector<const std::vector<PaddleTensor>*>& requests,
+    int64_t padded_rows) {
+  PADDLE_ENFORCE_EQ(
+      requests.empty(),
+      false,
+      common::errors::InvalidArgument("A batch must have a request."));
+  const auto& first = *requests.front();
+  bool ragged =
+      std::any_of(first.begin(), first.end(), [](const PaddleTensor& t) {
+        return !t.lod.empty();
+      });
+
+  std::vector<PaddleTensor> batch;
+  batch.reserve(first.size());
+  for (size_t i = 0; i < first.size(); ++i) {
+    std::vector<const PaddleTensor*> tensors;
+    tensors.reserve(requests.size());
+    for (const auto* request : requests) {
+      PADDLE_ENFORCE_EQ(
+          request->size() == first.size() &&
+              (*request)[i].name == first[i].name &&
+              (*request)[i].dtype == first[i].dtype,
+          true,
+          common::errors::InvalidArgument(
+              "Requests of a batch must have the same inputs in the same "
+              "order, input %d is %s in the first request.",
+              i,
+              first[i].name));
+      tensors.push_back(&(*request)[i]);
+    }
+    if (first[i].lod.empty()) {
+      batch.push_back(PackPadded(tensors, ragged ? 0 : padded_rows));
+    } else {
+      batch.push_back(PackRagged(tensors));
+    }
+  }
+  return batch;
+}
+
+std::vector<std::vector<PaddleTensor>> SplitBatch(
+    const std::vector<PaddleTensor>& outputs,
+    const std::vector<int64_t>& rows_per_request) {
+  int64_t total_rows = 0;
+  for (int64_t rows : rows_per_request) {
+    total_rows += rows;
+  }
+  std::vector<std::vector<PaddleTensor>> results(rows_per_request.size());
+  for (const auto& output : outputs) {
+    bool by_sequence =
+        !output.lod.empty() &&
+        static_cast<int64_t>(output.lod.front().size()) == total_rows + 1;
+    if (!by_sequence) {
+      PADDLE_ENFORCE_EQ(
+          !output.shape.empty() && output.shape.front() >= total_rows,
+          true,
+          common::errors::InvalidArgument(
+              "Output %s can not be split back to the requests, it needs a "
+              "row or a sequence per batch row, %d rows in total.",
+              output.name,
+              total_rows));
+    }
+    int64_t begin = 0;
+    for (size_t i = 0; i < rows_per_request.size(); ++i) {
+      int64_t end = begin + rows_per_request[i];
+      if (!by_sequence) {
+        results[i].push_back(SliceRows(output, begin, end));
+        begin = end;
+        continue;
+      }
+      // walk the sequences of the request down to its rows
+      std::vector<std::vector<size_t>> lod;
+      size_t row_begin = begin;
+      size_t row_end = end;
+      for (const auto& offsets : output.lod) {
+        std::vector<size_t> level(offsets.begin() + row_begin,
+                                  offsets.begin() + row_end + 1);
+        for (auto& offset : level) {
+          offset -= offsets[row_begin];
+        }
+        lod.push_back(std::move(level));
+        size_t next_begin = offsets[row_begin];
+        row_end = offsets[row_end];
+        row_begin = next_begin;
+      }
+      PaddleTensor slice = SliceRows(output, row_begin, row_end);
+      slice.lod = std::move(lod);
+      results[i].push_back(std::move(slice));
+      begin = end;
+    }
+  }
+  return results;
+}
+
+}  // namespace serving
+}  // namespace inference
+}  // namespace paddle
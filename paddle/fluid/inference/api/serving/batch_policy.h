@@ -0,0 +1,82 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "paddle/fluid/inference/api/paddle_api.h"
+
+namespace paddle {
+namespace inference {
+namespace serving {
+
+/// \brief Decides when the queued requests run and how large their batch
+/// is. A batch is at most max_batch_size rows. It runs at once when it is
+/// full or its rows are one of the preferred batch sizes, the largest such
+/// prefix of the queue first, and otherwise when its oldest request has
+/// waited for the max latency. A batch that runs on timeout may be padded up
+/// to the next preferred size, so that it lands on a shape the engine was
+/// built for.
+class BatchPolicy {
+ public:
+  BatchPolicy(int max_batch_size,
+              std::vector<int> preferred_batch_sizes,
+              bool pad_to_preferred_batch_size);
+
+  int max_batch_size() const { return max_batch_size_; }
+  const std::vector<int>& preferred_batch_sizes() const {
+    return preferred_batch_sizes_;
+  }
+
+  /// Number of requests at the front of the queue that form the next batch,
+  /// given the rows of every queued request, 0 to wait for more.
+  size_t NumRequestsToRun(const std::vector<int64_t>& queued_rows,
+                          bool timed_out) const;
+  /// Rows of the batch fed to the predictor, with the padding rows.
+  int64_t PaddedRows(int64_t rows) const;
+
+ private:
+  int max_batch_size_;
+  // ascending, none above max_batch_size_
+  std::vector<int> preferred_batch_sizes_;
+  bool pad_to_preferred_batch_size_;
+};
+
+/// Rows a request adds to a batch: the top level sequences of its first input
+/// with LoD, otherwise the first dimension of its first input.
+int64_t NumBatchRows(const std::vector<PaddleTensor>& inputs);
+
+/// Concatenates the inputs of the requests along the first dimension, input
+/// by input in the order of the first request. The other dimensions are
+/// padded with zeros to the largest of the batch. Inputs with LoD are packed
+/// ragged instead: their rows are concatenated as they are and the offsets of
+/// the LoD are rebased, so every sequence of every request keeps its length.
+/// Batches without LoD inputs are padded with zero rows up to padded_rows.
+std::vector<PaddleTensor> PackBatch(
+    const std::vector<const std::vector<PaddleTensor>*>& requests,
+    int64_t padded_rows);
+
+/// Splits the outputs of a batch back to the requests with the given rows.
+/// An output with LoD whose top level has a sequence per batch row is split
+/// by sequences, any other output by its first dimension, which then has to
+/// be the rows of the batch, padding rows included.
+std::vector<std::vector<PaddleTensor>> SplitBatch(
+    const std::vector<PaddleTensor>& outputs,
+    const std::vector<int64_t>& rows_per_request);
+
+}  // namespace serving
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,250 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/api/serving/dynamic_batcher.h"
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+#include "paddle/phi/common/bfloat16.h"
+#include "paddle/phi/common/float16.h"
+
+namespace paddle {
+namespace inference {
+namespace serving {
+
+namespace {
+
+template <typename Visitor>
+void VisitDataType(PaddleDType dtype, Visitor&& visitor) {
+  switch (dtype) {
+    case PaddleDType::FLOAT32:
+      return visitor(static_cast<float*>(nullptr));
+    case PaddleDType::FLOAT64:
+      return visitor(static_cast<double*>(nullptr));
+    case PaddleDType::FLOAT16:
+      return visitor(static_cast<phi::dtype::float16*>(nullptr));
+    case PaddleDType::BFLOAT16:
+      return visitor(static_cast<phi::dtype::bfloat16*>(nullptr));
+    case PaddleDType::INT64:
+      return visitor(static_cast<int64_t*>(nullptr));
+    case PaddleDType::INT32:
+      return visitor(static_cast<int32_t*>(nullptr));
+    case PaddleDType::INT8:
+      return visitor(static_cast<int8_t*>(nullptr));
+    case PaddleDType::UINT8:
+      return visitor(static_cast<uint8_t*>(nullptr));
+    case PaddleDType::BOOL:
+      return visitor(static_cast<bool*>(nullptr));
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported data type %d.", static_cast<int>(dtype)));
+  }
+}
+
+BatchPolicy MakePolicy(const paddle_infer::Config& config,
+                       const DynamicBatcherConfig& batcher_config,
+                       paddle_infer::Predictor* predictor) {
+  int max_batch_size = batcher_config.max_batch_size;
+  std::vector<int> preferred_batch_sizes(batcher_config.preferred_batch_sizes);
+  if (config.tensorrt_engine_enabled() &&
+      config.tensorrt_dynamic_shape_enabled()) {
+    for (const auto& name : predictor->GetInputNames()) {
+      auto max_shape = config.trt_max_input_shape().find(name);
+      if (max_shape != config.trt_max_input_shape().end() &&
+          !max_shape->second.empty() && max_shape->second.front() > 0) {
+        max_batch_size = std::min(max_batch_size, max_shape->second.front());
+      }
+      auto opt_shape = config.trt_optim_input_shape().find(name);
+      if (opt_shape != config.trt_optim_input_shape().end() &&
+          !opt_shape->second.empty() && opt_shape->second.front() > 0) {
+        preferred_batch_sizes.push_back(opt_shape->second.front());
+      }
+    }
+    VLOG(3) << "The TensorRT dynamic shapes limit the batches to "
+            << max_batch_size << " rows.";
+  }
+  return BatchPolicy(max_batch_size,
+                     std::move(preferred_batch_sizes),
+                     batcher_config.pad_to_preferred_batch_size);
+}
+
+void Feed(paddle_infer::Predictor* predictor,
+          const std::vector<PaddleTensor>& inputs) {
+  for (const auto& input : inputs) {
+    auto tensor = predictor->GetInputHandle(input.name);
+    tensor->Reshape(input.shape);
+    VisitDataType(input.dtype, [&](auto* type) {
+      using T = std::remove_pointer_t<decltype(type)>;
+      tensor->CopyFromCpu(static_cast<const T*>(input.data.data()));
+    });
+    if (!input.lod.empty()) {
+      tensor->SetLoD(input.lod);
+    }
+  }
+}
+
+std::vector<PaddleTensor> Fetch(paddle_infer::Predictor* predictor) {
+  std::vector<PaddleTensor> outputs;
+  for (const auto& name : predictor->GetOutputNames()) {
+    auto tensor = predictor->GetOutputHandle(name);
+    PaddleTensor output;
+    output.name = name;
+    output.shape = tensor->shape();
+    output.dtype = tensor->type();
+    output.lod = tensor->lod();
+    int64_t numel = 1;
+    for (int dim : output.shape) {
+      numel *= dim;
+    }
+    VisitDataType(output.dtype, [&](auto* type) {
+      using T = std::remove_pointer_t<decltype(type)>;
+      if (numel > 0) {
+        output.data.Resize(numel * sizeof(T));
+        tensor->CopyToCpu(static_cast<T*>(output.data.data()));
+      }
+    });
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+}  // namespace
+
+DynamicBatcher::DynamicBatcher(const paddle_infer::Config& config,
+                               const DynamicBatcherConfig& batcher_config)
+    : pool_(config, batcher_config.num_predictors),
+      policy_(MakePolicy(config, batcher_config, pool_.Retrieve(0))),
+      max_latency_(batcher_config.max_latency_us) {
+  for (size_t i = 0; i < batcher_config.num_predictors; ++i) {
+    workers_.emplace_back(&DynamicBatcher::Work, this, pool_.Retrieve(i));
+  }
+}
+
+DynamicBatcher::~DynamicBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  queued_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<std::vector<PaddleTensor>> DynamicBatcher::Submit(
+    std::vector<PaddleTensor> inputs) {
+  auto request = std::make_unique<PendingRequest>();
+  request->rows = NumBatchRows(inputs);
+  PADDLE_ENFORCE_EQ(
+      request->rows > 0 && request->rows <= policy_.max_batch_size(),
+      true,
+      common::errors::InvalidArgument(
+          "A request must have between 1 and %d rows, but got %d.",
+          policy_.max_batch_size(),
+          request->rows));
+  request->inputs = std::move(inputs);
+  request->arrival = std::chrono::steady_clock::now();
+  auto outputs = request->outputs.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PADDLE_ENFORCE_EQ(stopped_,
+                      false,
+                      common::errors::PreconditionNotMet(
+                          "The dynamic batcher is stopped."));
+    queue_.push_back(std::move(request));
+  }
+  queued_.notify_one();
+  return outputs;
+}
+
+void DynamicBatcher::Work(paddle_infer::Predictor* predictor) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    if (queue_.empty()) {
+      if (stopped_) {
+        return;
+      }
+      queued_.wait(lock);
+      continue;
+    }
+    auto deadline = queue_.front()->arrival + max_latency_;
+    bool timed_out =
+        stopped_ || std::chrono::steady_clock::now() >= deadline;
+    std::vector<int64_t> queued_rows;
+    queued_rows.reserve(queue_.size());
+    for (const auto& request : queue_) {
+      queued_rows.push_back(request->rows);
+    }
+    size_t num_requests = policy_.NumRequestsToRun(queued_rows, timed_out);
+    if (num_requests == 0) {
+      queued_.wait_until(lock, deadline);
+      continue;
+    }
+
+    std::vector<std::unique_ptr<PendingRequest>> batch;
+    for (size_t i = 0; i < num_requests; ++i) {
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    // another predictor may batch the rest meanwhile
+    bool more = !queue_.empty();
+    lock.unlock();
+    if (more) {
+      queued_.notify_one();
+    }
+    RunBatch(predictor, &batch);
+    lock.lock();
+  }
+}
+
+void DynamicBatcher::RunBatch(
+    paddle_infer::Predictor* predictor,
+    std::vector<std::unique_ptr<PendingRequest>>* batch) {
+  std::vector<std::vector<PaddleTensor>> results;
+  try {
+    std::vector<const std::vector<PaddleTensor>*> inputs;
+    std::vector<int64_t> rows_per_request;
+    int64_t rows = 0;
+    for (const auto& request : *batch) {
+      inputs.push_back(&request->inputs);
+      rows_per_request.push_back(request->rows);
+      rows += request->rows;
+    }
+    Feed(predictor, PackBatch(inputs, policy_.PaddedRows(rows)));
+    PADDLE_ENFORCE_EQ(
+        predictor->Run(),
+        true,
+        common::errors::Fatal("The predictor failed to run a batch of %d "
+                              "requests.",
+                              batch->size()));
+    results = SplitBatch(Fetch(predictor), rows_per_request);
+  } catch (...) {
+    for (auto& request : *batch) {
+      request->outputs.set_exception(std::current_exception());
+    }
+    return;
+  }
+  for (size_t i = 0; i < batch->size(); ++i) {
+    (*batch)[i]->outputs.set_value(std::move(results[i]));
+  }
+}
+
+}  // namespace serving
+}  // namespace inference
+}  // namespace paddle
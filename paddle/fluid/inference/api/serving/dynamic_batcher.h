@@ -0,0 +1,97 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/fluid/inference/api/paddle_inference_api.h"
+#include "paddle/fluid/inference/api/serving/batch_policy.h"
+
+namespace paddle {
+namespace inference {
+namespace serving {
+
+struct DynamicBatcherConfig {
+  // rows of one batch, the max TensorRT dynamic shapes may lower it
+  int max_batch_size{32};
+  // how long the oldest queued request waits for others to join its batch
+  int64_t max_latency_us{1000};
+  // predictors of the pool, every one runs a batch at a time
+  size_t num_predictors{1};
+  // batch sizes the engine runs best at, the opt TensorRT dynamic shapes are
+  // added
+  std::vector<int> preferred_batch_sizes;
+  // pad a batch with zero rows up to the next preferred size
+  bool pad_to_preferred_batch_size{false};
+};
+
+/// \brief Batches the requests submitted from many threads and runs them on
+/// the predictors of a PredictorPool. Requests are packed along the first
+/// dimension as PackBatch describes, and the outputs are split back per
+/// request.
+///
+/// With TensorRT dynamic shapes the batches stay within the batch dimension
+/// of the max input shapes, and the batch dimension of the opt shapes is a
+/// preferred batch size, so that full batches run on the shapes the engine
+/// was tuned for.
+class DynamicBatcher {
+ public:
+  DynamicBatcher(const paddle_infer::Config& config,
+                 const DynamicBatcherConfig& batcher_config);
+  ~DynamicBatcher();
+
+  /// Queues the inputs of a request, the future holds its outputs or the
+  /// error of its batch.
+  std::future<std::vector<PaddleTensor>> Submit(
+      std::vector<PaddleTensor> inputs);
+
+  const BatchPolicy& policy() const { return policy_; }
+
+ private:
+  struct PendingRequest {
+    std::vector<PaddleTensor> inputs;
+    int64_t rows{0};
+    std::chrono::steady_clock::time_point arrival;
+    std::promise<std::vector<PaddleTensor>> outputs;
+  };
+
+  void Work(paddle_infer::Predictor* predictor);
+  void RunBatch(paddle_infer::Predictor* predictor,
+                std::vector<std::unique_ptr<PendingRequest>>* batch);
+
+  paddle_infer::services::PredictorPool pool_;
+  BatchPolicy policy_;
+  std::chrono::microseconds max_latency_;
+
+  std::mutex mutex_;
+  std::condition_variable queued_;
+  std::deque<std::unique_ptr<PendingRequest>> queue_;
+  bool stopped_{false};
+  std::vector<std::thread> workers_;
+
+  DISABLE_COPY_AND_ASSIGN(DynamicBatcher);
+};
+
+}  // namespace serving
+}  // namespace inference
+}  // namespace paddle
@@ -143,6 +143,53 @@ PD_Bool PD_PredictorRun(__pd_keep PD_Predictor* pd_predictor) {
   return predictor->Run();  // NOLINT
 }
 
+void PD_PredictorRunAsync(__pd_keep PD_Predictor* pd_predictor,
+                          PD_RunCallback callback,
+                          void* user_data) {
+  CHECK_AND_CONVERT_PD_PREDICTOR;
+  std::lock_guard<std::mutex> lock(pd_predictor->async_mutex);
+  pd_predictor->async_runs.emplace_back([&predictor, callback, user_data]() {
+    PD_Bool success = false;
+    try {
+      success = predictor->Run();
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "PD_PredictorRunAsync failed: " << e.what();
+    }
+    if (callback != nullptr) callback(user_data, success);
+  });
+  ++pd_predictor->async_pending;
+  if (!pd_predictor->async_worker.joinable()) {
+    pd_predictor->async_worker = std::thread([pd_predictor]() {
+      std::unique_lock<std::mutex> lock(pd_predictor->async_mutex);
+      while (true) {
+        pd_predictor->async_cv.wait(lock, [pd_predictor]() {
+          return pd_predictor->async_stop ||
+                 !pd_predictor->async_runs.empty();
+        });
+        if (pd_predictor->async_runs.empty()) return;
+        auto run = std::move(pd_predictor->async_runs.front());
+        pd_predictor->async_runs.pop_front();
+        lock.unlock();
+        run();
+        lock.lock();
+        --pd_predictor->async_pending;
+        pd_predictor->async_cv.notify_all();
+      }
+    });
+  }
+  pd_predictor->async_cv.notify_all();
+}
+
+void PD_PredictorWaitAsync(__pd_keep PD_Predictor* pd_predictor) {
+  PADDLE_ENFORCE_NOT_NULL(
+      pd_predictor,
+      common::errors::InvalidArgument(
+          "The pointer of paddle predictor shouldn't be nullptr"));
+  std::unique_lock<std::mutex> lock(pd_predictor->async_mutex);
+  pd_predictor->async_cv.wait(
+      lock, [pd_predictor]() { return pd_predictor->async_pending == 0; });
+}
+
 void PD_PredictorClearIntermediateTensor(__pd_keep PD_Predictor* pd_predictor) {
   CHECK_AND_CONVERT_PD_PREDICTOR;
   predictor->ClearIntermediateTensor();
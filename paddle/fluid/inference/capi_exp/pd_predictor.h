@@ -32,6 +32,12 @@ typedef struct PD_Tensor PD_Tensor;
 typedef struct PD_OneDimArrayCstr PD_OneDimArrayCstr;
 typedef struct PD_IOInfos PD_IOInfos;
 
+///
+/// \brief The callback of PD_PredictorRunAsync, called on the worker thread
+/// of the predictor when the run has finished.
+///
+typedef void (*PD_RunCallback)(void* user_data, PD_Bool success);
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -131,6 +137,32 @@ PADDLE_CAPI_EXPORT extern __pd_give PD_Tensor* PD_PredictorGetOutputHandle(
 PADDLE_CAPI_EXPORT extern PD_Bool PD_PredictorRun(
     __pd_keep PD_Predictor* pd_predictor);
 
+///
+/// \brief Submit a run of the prediction engine and return immediately.
+/// The runs submitted to a predictor are executed in order on its worker
+/// thread, so the inputs shared by PD_TensorShareExternalData* should not be
+/// changed until the callback of the run is called. Submit to the clones of a
+/// predictor to run several requests concurrently.
+///
+/// \param[in] pd_predictor predictor
+/// \param[in] callback The function called when the run has finished, can be
+/// NULL.
+/// \param[in] user_data The data passed to the callback.
+///
+PADDLE_CAPI_EXPORT extern void PD_PredictorRunAsync(
+    __pd_keep PD_Predictor* pd_predictor,
+    PD_RunCallback callback,
+    void* user_data);
+
+///
+/// \brief Wait until all the runs submitted by PD_PredictorRunAsync have
+/// finished.
+///
+/// \param[in] pd_predictor predictor
+///
+PADDLE_CAPI_EXPORT extern void PD_PredictorWaitAsync(
+    __pd_keep PD_Predictor* pd_predictor);
+
 /// \brief Clear the intermediate tensors of the predictor
 ///
 /// \param[in] pd_predictor predictor
@@ -206,6 +206,86 @@ PADDLE_CAPI_EXPORT extern void PD_TensorCopyFromCpuUint8(
 PADDLE_CAPI_EXPORT extern void PD_TensorCopyFromCpuInt8(
     __pd_keep PD_Tensor* pd_tensor, const int8_t* data);
 ///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory can be registered once and refilled before every run, it must
+/// stay valid and unchanged while a run using the tensor is in flight.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the external memory.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataFloat(
+    __pd_keep PD_Tensor* pd_tensor,
+    float* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory can be registered once and refilled before every run, it must
+/// stay valid and unchanged while a run using the tensor is in flight.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the external memory.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt64(
+    __pd_keep PD_Tensor* pd_tensor,
+    int64_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory can be registered once and refilled before every run, it must
+/// stay valid and unchanged while a run using the tensor is in flight.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the external memory.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt32(
+    __pd_keep PD_Tensor* pd_tensor,
+    int32_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory can be registered once and refilled before every run, it must
+/// stay valid and unchanged while a run using the tensor is in flight.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the external memory.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataUint8(
+    __pd_keep PD_Tensor* pd_tensor,
+    uint8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory can be registered once and refilled before every run, it must
+/// stay valid and unchanged while a run using the tensor is in flight.
+/// \param[in] pd_tensor tensor.
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape_size The size of shape.
+/// \param[in] shape The shape of the data.
+/// \param[in] place The place of the external memory.
+///
+PADDLE_CAPI_EXPORT extern void PD_TensorShareExternalDataInt8(
+    __pd_keep PD_Tensor* pd_tensor,
+    int8_t* data,
+    size_t shape_size,
+    int32_t* shape,
+    PD_PlaceType place);
+///
 /// \brief Copy the tensor data to the host memory.
 /// It's usually used to get the output tensor data.
 /// \param[in] pd_tensor tensor.
@@ -14,8 +14,13 @@
 
 #pragma once
 
+#include <condition_variable>
 #include <cstdint>
 #include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "paddle/fluid/inference/api/paddle_inference_api.h"
 #include "paddle/fluid/inference/capi_exp/pd_common.h"
@@ -26,4 +31,22 @@ typedef struct PD_Tensor {
 
 typedef struct PD_Predictor {
   std::shared_ptr<paddle_infer::Predictor> predictor;
+
+  // The runs submitted by PD_PredictorRunAsync, executed in order by
+  // async_worker, which is started by the first submission.
+  std::mutex async_mutex;
+  std::condition_variable async_cv;
+  std::deque<std::function<void()>> async_runs;
+  size_t async_pending{0};
+  bool async_stop{false};
+  std::thread async_worker;
+
+  ~PD_Predictor() {
+    {
+      std::lock_guard<std::mutex> lock(async_mutex);
+      async_stop = true;
+    }
+    async_cv.notify_all();
+    if (async_worker.joinable()) async_worker.join();
+  }
 } PD_Predictor;
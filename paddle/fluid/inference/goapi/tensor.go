@@ -183,6 +183,35 @@ func (t *Tensor) CopyFromCpu(value interface{}) {
 	}
 }
 
+///
+/// \brief Share the external memory with the tensor, no copy is made.
+/// The memory must not be allocated by Go, e.g. allocated by C.malloc or
+/// cudaMalloc, and must stay valid and unchanged while a run using the tensor
+/// is in flight. It's usually registered once and refilled before every run.
+///
+/// \param[in] data The pointer of the external memory.
+/// \param[in] shape The shape of the data.
+/// \param[in] dtype The data type of the data.
+/// \param[in] place The place of the external memory.
+///
+func (t *Tensor) ShareExternalData(data unsafe.Pointer, shape []int32, dtype DataType, place PlaceType) {
+	cShape := (*C.int32_t)(unsafe.Pointer(&shape[0]))
+	cSize := C.size_t(len(shape))
+	cPlace := C.PD_PlaceType(place)
+	switch dtype {
+	case Float32:
+		C.PD_TensorShareExternalDataFloat(t.c, (*C.float)(data), cSize, cShape, cPlace)
+	case Int32:
+		C.PD_TensorShareExternalDataInt32(t.c, (*C.int32_t)(data), cSize, cShape, cPlace)
+	case Int64:
+		C.PD_TensorShareExternalDataInt64(t.c, (*C.int64_t)(data), cSize, cShape, cPlace)
+	case Uint8:
+		C.PD_TensorShareExternalDataUint8(t.c, (*C.uint8_t)(data), cSize, cShape, cPlace)
+	case Int8:
+		C.PD_TensorShareExternalDataInt8(t.c, (*C.int8_t)(data), cSize, cShape, cPlace)
+	}
+}
+
 ///
 /// \brief Copy the tensor data to the host memory.
 /// It's usually used to get the output tensor data.
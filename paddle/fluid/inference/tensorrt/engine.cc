@@ -22,6 +22,7 @@ limitations under the License. */
 
 #include "paddle/fluid/inference/tensorrt/helper.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
+#include "paddle/fluid/inference/utils/shape_profiles.h"
 #include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 
 namespace paddle::inference::tensorrt {
@@ -74,8 +75,8 @@ void TensorRTEngine::InitNetwork() {
   }
 #endif
   infer_builder_config_.reset(infer_builder_->createBuilderConfig());
-  optim_profiles_.resize(max_profile_num_);
-  for (int i = 0; i < max_profile_num_; i++)
+  optim_profiles_.resize(max_profile_num_ * num_shape_profiles());
+  for (size_t i = 0; i < optim_profiles_.size(); i++)
     optim_profiles_[i] = infer_builder_->createOptimizationProfile();
 }
 
@@ -101,15 +102,18 @@ nvinfer1::IExecutionContext *TensorRTEngine::context() {
         common::errors::InvalidArgument(
             "TensorRT engine can not build execution context."));
     if (with_dynamic_shape()) {
+      // every context owns num_shape_profiles() profiles, it starts on the
+      // first of them
+      int profile_index = cur_profile_num_ * num_shape_profiles();
       // need new profile if it's not the first
-      if (cur_profile_num_ > 0) {
+      if (profile_index > 0) {
 #if IS_TRT_VERSION_GE(8600)
-        infer_context->setOptimizationProfileAsync(cur_profile_num_, nullptr);
+        infer_context->setOptimizationProfileAsync(profile_index, nullptr);
 #else
-        infer_context->setOptimizationProfile(cur_profile_num_);
+        infer_context->setOptimizationProfile(profile_index);
 #endif
       }
-      profile_index_[predictor_id_per_thread] = cur_profile_num_;
+      profile_index_[predictor_id_per_thread] = profile_index;
       ++cur_profile_num_;
     }
     infer_context_[predictor_id_per_thread].reset(infer_context);
@@ -117,6 +121,32 @@ nvinfer1::IExecutionContext *TensorRTEngine::context() {
   return infer_context_[predictor_id_per_thread].get();
 }
 
+void TensorRTEngine::SelectShapeProfile(const ShapeMapType &input_shapes,
+                                        cudaStream_t stream) {
+  if (num_shape_profiles() <= 1) return;
+  // a tuned profile holding the shapes is tighter than the shapes of all
+  // inputs, which hold everything else the engine can run
+  int shape_profile =
+      1 + inference::ChooseShapeProfile(input_shapes,
+                                        params_.profile_min_input_shapes,
+                                        params_.profile_max_input_shapes,
+                                        params_.profile_optim_input_shapes);
+  auto *infer_context = context();
+  int profile_index = GetProfileIndex();
+  int target_index =
+      profile_index - profile_index % num_shape_profiles() + shape_profile;
+  if (target_index == profile_index) return;
+  VLOG(3) << "Switch the TensorRT optimization profile from " << profile_index
+          << " to " << target_index;
+#if IS_TRT_VERSION_GE(8600)
+  infer_context->setOptimizationProfileAsync(target_index, stream);
+#else
+  infer_context->setOptimizationProfile(target_index);
+#endif
+  std::unique_lock<std::mutex> lock(mutex_);
+  profile_index_[predictor_id_per_thread] = target_index;
+}
+
 void TensorRTEngine::Execute(int batch_size,
                              std::vector<void *> *buffers,
                              cudaStream_t stream) {
@@ -326,39 +356,56 @@ void TensorRTEngine::FreezeNetwork() {
 
   if (with_dynamic_shape()) {
     LOG(INFO) << "Run Paddle-TRT Dynamic Shape mode.";
-    for (int i = 0; i < max_profile_num_; i++) {
+    for (size_t i = 0; i < optim_profiles_.size(); i++) {
+      int shape_profile = static_cast<int>(i) % num_shape_profiles();
+      // the tuned profiles fall back to the shapes of all inputs they lack
+      auto profile_shape = [&](ShapeMapType &shapes,
+                               std::vector<ShapeMapType> &tuned_shapes,
+                               const std::string &name) -> std::vector<int> & {
+        if (shape_profile > 0 && tuned_shapes[shape_profile - 1].count(name)) {
+          return tuned_shapes[shape_profile - 1][name];
+        }
+        return shapes[name];
+      };
       for (auto &input : min_input_shape()) {
+        auto &min_shape = profile_shape(
+            min_input_shape(), params_.profile_min_input_shapes, input.first);
+        auto &max_shape = profile_shape(
+            max_input_shape(), params_.profile_max_input_shapes, input.first);
+        auto &opt_shape = profile_shape(optim_input_shape(),
+                                        params_.profile_optim_input_shapes,
+                                        input.first);
 #if IS_TRT_VERSION_LT(7100)
         // trt6/trt7011 will check all_of input > 0
-        if (!(std::all_of(input.second.begin(),
-                          input.second.end(),
+        if (!(std::all_of(min_shape.begin(),
+                          min_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(max_input_shape()[input.first].begin(),
-                          max_input_shape()[input.first].end(),
+              std::all_of(max_shape.begin(),
+                          max_shape.end(),
                           [](int x) { return x > 0; }) &&
-              std::all_of(optim_input_shape()[input.first].begin(),
-                          optim_input_shape()[input.first].end(),
+              std::all_of(opt_shape.begin(),
+                          opt_shape.end(),
                           [](int x) { return x > 0; }))) {
           continue;
         }
 #endif
         VLOG(4) << "TRT dynamic_shape set " << input.first
-                << " min: " << Vec2Str(input.second)
-                << ", max: " << Vec2Str(max_input_shape()[input.first])
-                << ", opt: " << Vec2Str(optim_input_shape()[input.first]);
+                << " min: " << Vec2Str(min_shape)
+                << ", max: " << Vec2Str(max_shape)
+                << ", opt: " << Vec2Str(opt_shape);
 
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMIN,
-            Vec2TRT_Dims(input.second, input.first, true));
+            Vec2TRT_Dims(min_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kMAX,
-            Vec2TRT_Dims(max_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(max_shape, input.first, true));
         optim_profiles_[i]->setDimensions(
             input.first.c_str(),
             nvinfer1::OptProfileSelector::kOPT,
-            Vec2TRT_Dims(optim_input_shape()[input.first], input.first, true));
+            Vec2TRT_Dims(opt_shape, input.first, true));
       }
 
       for (int input_id = 0; input_id < network()->getNbInputs(); input_id++) {
@@ -454,7 +501,7 @@ void TensorRTEngine::FreezeNetwork() {
   binding_num_ = infer_engine_->getNbBindings();
 #endif
   // reset status for dynamic shape clone
-  if (max_profile_num_ > 1) {
+  if (max_profile_num_ > 1 || num_shape_profiles() > 1) {
     infer_context_.clear();
     cur_profile_num_ = 0;
   }
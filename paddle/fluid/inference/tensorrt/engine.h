@@ -152,6 +152,12 @@ class TensorRTEngine {
     ShapeMapType min_shape_tensor;
     ShapeMapType max_shape_tensor;
     ShapeMapType optim_shape_tensor;
+    // Optimization profiles tuned for clusters of the collected shapes, all
+    // within the shapes above. An input runs on the closest one that holds
+    // it, otherwise on the shapes above.
+    std::vector<ShapeMapType> profile_min_input_shapes;
+    std::vector<ShapeMapType> profile_max_input_shapes;
+    std::vector<ShapeMapType> profile_optim_input_shapes;
 
     bool use_inspector{false};
     std::string engine_info_path{""};
@@ -235,8 +241,26 @@ class TensorRTEngine {
   nvinfer1::IExecutionContext* context();
 
   int GetBindingsOffset() {
-    return (binding_num_ / max_profile_num_) * GetProfileIndex();
+#if IS_TRT_VERSION_GE(8600)
+    // the IO tensors are not repeated per profile
+    return 0;
+#else
+    return (binding_num_ / (max_profile_num_ * num_shape_profiles())) *
+           GetProfileIndex();
+#endif
+  }
+
+  // The profiles of a context, the shapes of the ConstructionParams and the
+  // tuned ones.
+  int num_shape_profiles() {
+    return with_dynamic_shape()
+               ? 1 + static_cast<int>(params_.profile_min_input_shapes.size())
+               : 1;
   }
+  // Switches the context of this predictor to the profile closest to the
+  // input shapes, before their shapes are set.
+  void SelectShapeProfile(const ShapeMapType& input_shapes,
+                          cudaStream_t stream);
 
   int GetNbBindings() { return binding_num_; }
 
@@ -552,7 +576,7 @@ class TensorRTEngine {
   int device_id() { return params_.device_id; }
 
   int GetProfileIndex() {
-    if (max_profile_num_ > 1) {
+    if (max_profile_num_ > 1 || num_shape_profiles() > 1) {
       std::unique_lock<std::mutex> lock(mutex_);
       return profile_index_[predictor_id_per_thread];
     } else {
@@ -0,0 +1,212 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/utils/engine_cache.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <sys/file.h>
+#include <unistd.h>
+#include <utime.h>
+#else
+#include <io.h>
+#include <process.h>
+#endif
+
+#include "glog/logging.h"
+
+namespace paddle::inference {
+
+namespace {
+
+constexpr char kTmpSuffix[] = ".tmp.";
+constexpr char kLockSuffix[] = ".lock";
+
+bool EndsWith(const std::string& str, const std::string& suffix) {
+  return str.size() >= suffix.size() &&
+         str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int ProcessId() {
+#if !defined(_WIN32)
+  return static_cast<int>(getpid());
+#else
+  return _getpid();
+#endif
+}
+
+}  // namespace
+
+uint64_t StableHashBytes(const void* data, size_t size, uint64_t seed) {
+  constexpr uint64_t kPrime = 1099511628211ULL;
+  uint64_t hash = 14695981039346656037ULL ^ seed;
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= kPrime;
+  }
+  return hash;
+}
+
+EngineFileCache::BuildLock::BuildLock(const std::string& path) {
+#if !defined(_WIN32)
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    LOG(WARNING) << "Fail to open the engine build lock " << path
+                 << ", the engine is built without it.";
+    return;
+  }
+  while (flock(fd_, LOCK_EX) != 0) {
+    if (errno != EINTR) {
+      close(fd_);
+      fd_ = -1;
+      return;
+    }
+  }
+#endif
+}
+
+EngineFileCache::BuildLock::~BuildLock() {
+#if !defined(_WIN32)
+  if (fd_ >= 0) {
+    flock(fd_, LOCK_UN);
+    close(fd_);
+  }
+#endif
+}
+
+EngineFileCache::EngineFileCache(const std::string& dir,
+                                 const std::string& prefix,
+                                 int64_t capacity_bytes)
+    : dir_(dir), prefix_(prefix), capacity_bytes_(capacity_bytes) {}
+
+std::string EngineFileCache::Path(const std::string& key) const {
+  return dir_ + "/" + prefix_ + key;
+}
+
+bool EngineFileCache::Load(const std::string& key, std::string* data) const {
+  const std::string path = Path(key);
+  std::ifstream infile(path, std::ios::binary);
+  if (!infile.is_open()) {
+    return false;
+  }
+  std::stringstream buffer;
+  buffer << infile.rdbuf();
+  *data = buffer.str();
+  if (data->empty()) {
+    return false;
+  }
+#if !defined(_WIN32)
+  // the modification time orders the engines for the eviction
+  utime(path.c_str(), nullptr);
+#endif
+  VLOG(3) << "Engine cache hit: " << path;
+  return true;
+}
+
+void EngineFileCache::Store(const std::string& key,
+                            const std::string& data) const {
+  const std::string path = Path(key);
+  std::stringstream tmp_path;
+  tmp_path << path << kTmpSuffix << ProcessId() << "."
+           << std::hash<std::thread::id>()(std::this_thread::get_id());
+  {
+    std::ofstream outfile(tmp_path.str(), std::ios::binary);
+    outfile << data;
+    outfile.close();
+    if (!outfile) {
+      LOG(WARNING) << "Fail to write the engine to " << tmp_path.str();
+      std::remove(tmp_path.str().c_str());
+      return;
+    }
+  }
+#if defined(_WIN32)
+  // rename does not replace an existing file on Windows
+  std::remove(path.c_str());
+#endif
+  if (std::rename(tmp_path.str().c_str(), path.c_str()) != 0) {
+    LOG(WARNING) << "Fail to publish the engine to " << path;
+    std::remove(tmp_path.str().c_str());
+    return;
+  }
+  if (capacity_bytes_ > 0) {
+    Evict(path);
+  }
+}
+
+std::unique_ptr<EngineFileCache::BuildLock> EngineFileCache::LockForBuild(
+    const std::string& key) const {
+  return std::make_unique<BuildLock>(Path(key) + kLockSuffix);
+}
+
+void EngineFileCache::Evict(const std::string& kept) const {
+#if !defined(_WIN32)
+  struct Entry {
+    std::string path;
+    int64_t size;
+    time_t mtime;
+  };
+  DIR* dir = opendir(dir_.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+  std::vector<Entry> entries;
+  int64_t total = 0;
+  while (auto* entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (name.compare(0, prefix_.size(), prefix_) != 0 ||
+        name.find(kTmpSuffix) != std::string::npos ||
+        EndsWith(name, kLockSuffix)) {
+      continue;
+    }
+    std::string path = dir_ + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    total += st.st_size;
+    if (path != kept) {
+      entries.push_back({path, st.st_size, st.st_mtime});
+    }
+  }
+  closedir(dir);
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.mtime < b.mtime;
+  });
+  for (const auto& entry : entries) {
+    if (total <= capacity_bytes_) {
+      break;
+    }
+    if (std::remove(entry.path.c_str()) == 0) {
+      VLOG(3) << "Evict the engine " << entry.path;
+      total -= entry.size;
+    }
+  }
+#endif
+}
+
+}  // namespace paddle::inference
@@ -0,0 +1,79 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "paddle/common/macros.h"
+
+namespace paddle {
+namespace inference {
+
+/// \brief A directory of serialized engines shared by every process on a
+/// host, e.g. the replicas of a service mounting the same optimization cache
+/// directory.
+///
+/// Lookups only read the file of the key. A store writes a temporary file and
+/// renames it, so a reader sees either no engine or a complete one. A process
+/// that misses takes the build lock of the key, so that the others wait for
+/// its engine instead of building the same one. Above the capacity, a store
+/// removes the least recently used engines.
+class EngineFileCache {
+ public:
+  class BuildLock {
+   public:
+    explicit BuildLock(const std::string& path);
+    ~BuildLock();
+
+   private:
+    int fd_{-1};
+
+    DISABLE_COPY_AND_ASSIGN(BuildLock);
+  };
+
+  /// \param capacity_bytes total size of the engines of the directory, 0
+  /// means unlimited.
+  EngineFileCache(const std::string& dir,
+                  const std::string& prefix,
+                  int64_t capacity_bytes);
+
+  std::string Path(const std::string& key) const;
+
+  /// Reads the engine of the key, returns false if there is none.
+  bool Load(const std::string& key, std::string* data) const;
+  /// Publishes the engine of the key, a failure is only logged since the
+  /// engine can still be used by this process.
+  void Store(const std::string& key, const std::string& data) const;
+  /// Blocks until no other process builds the engine of the key.
+  std::unique_ptr<BuildLock> LockForBuild(const std::string& key) const;
+
+ private:
+  void Evict(const std::string& kept) const;
+
+  std::string dir_;
+  std::string prefix_;
+  int64_t capacity_bytes_;
+};
+
+/// FNV-1a, stable across processes and builds unlike std::hash.
+uint64_t StableHashBytes(const void* data, size_t size, uint64_t seed = 0);
+inline uint64_t StableHash(const std::string& data, uint64_t seed = 0) {
+  return StableHashBytes(data.data(), data.size(), seed);
+}
+
+}  // namespace inference
+}  // namespace paddle
@@ -344,5 +344,54 @@ void UpdateShapeRangeInfo(
   inference::SerializeShapeRangeInfo(path, shape_range_infos);
 }
 
+void SerializeShapeRangeProfiles(
+    const std::string &path,
+    const std::vector<std::map<std::string, std::vector<int32_t>>> &min_shapes,
+    const std::vector<std::map<std::string, std::vector<int32_t>>> &max_shapes,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>
+        &opt_shapes) {
+  paddle::inference::proto::ShapeRangeInfos shape_range_infos;
+  DeserializeShapeRangeInfo(path, &shape_range_infos);
+  shape_range_infos.clear_profiles();
+  for (size_t p = 0; p < min_shapes.size(); ++p) {
+    auto *profile = shape_range_infos.add_profiles();
+    for (const auto &it : min_shapes[p]) {
+      auto *info = profile->add_shape_range_info();
+      info->set_name(it.first);
+      for (auto shape : it.second) info->add_min_shape(shape);
+      for (auto shape : max_shapes[p].at(it.first)) info->add_max_shape(shape);
+      for (auto shape : opt_shapes[p].at(it.first)) info->add_opt_shape(shape);
+    }
+  }
+  inference::SerializeShapeRangeInfo(path, shape_range_infos);
+}
+
+void DeserializeShapeRangeProfiles(
+    const std::string &path,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *min_shapes,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *max_shapes,
+    std::vector<std::map<std::string, std::vector<int32_t>>> *opt_shapes) {
+  paddle::inference::proto::ShapeRangeInfos shape_range_infos;
+  DeserializeShapeRangeInfo(path, &shape_range_infos);
+  min_shapes->clear();
+  max_shapes->clear();
+  opt_shapes->clear();
+  for (const auto &profile : shape_range_infos.profiles()) {
+    std::map<std::string, std::vector<int32_t>> min_shape, max_shape,
+        opt_shape;
+    for (const auto &info : profile.shape_range_info()) {
+      min_shape[info.name()].assign(info.min_shape().begin(),
+                                    info.min_shape().end());
+      max_shape[info.name()].assign(info.max_shape().begin(),
+                                    info.max_shape().end());
+      opt_shape[info.name()].assign(info.opt_shape().begin(),
+                                    info.opt_shape().end());
+    }
+    min_shapes->push_back(std::move(min_shape));
+    max_shapes->push_back(std::move(max_shape));
+    opt_shapes->push_back(std::move(opt_shape));
+  }
+}
+
 }  // namespace inference
 }  // namespace paddle
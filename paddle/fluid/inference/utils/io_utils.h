@@ -70,5 +70,17 @@ TEST_API void UpdateShapeRangeInfo(
     const std::map<std::string, std::vector<int32_t>>& opt_value,
     const std::vector<std::string>& names,
     const std::vector<std::string>& tensor_names);
+// Adds the optimization profiles tuned for clusters of the collected shapes
+// to the shape range info of path, replacing the ones it had.
+TEST_API void SerializeShapeRangeProfiles(
+    const std::string& path,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& min_shapes,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& max_shapes,
+    const std::vector<std::map<std::string, std::vector<int32_t>>>& opt_shapes);
+TEST_API void DeserializeShapeRangeProfiles(
+    const std::string& path,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* min_shapes,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* max_shapes,
+    std::vector<std::map<std::string, std::vector<int32_t>>>* opt_shapes);
 }  // namespace inference
 }  // namespace paddle
@@ -0,0 +1,145 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/inference/utils/shape_profiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace paddle::inference {
+
+std::vector<int> ClusterShapeSizes(const std::vector<int64_t>& sizes,
+                                   int num_clusters) {
+  std::vector<int> clusters(sizes.size(), 0);
+  if (sizes.empty() || num_clusters <= 1) {
+    return clusters;
+  }
+  std::vector<double> points(sizes.size());
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    points[i] = std::log(static_cast<double>(std::max<int64_t>(sizes[i], 1)));
+  }
+
+  // start from the quantiles of the distinct sizes
+  std::vector<double> distinct(points);
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                 distinct.end());
+  size_t k = std::min(static_cast<size_t>(num_clusters), distinct.size());
+  std::vector<double> centroids(k);
+  for (size_t c = 0; c < k; ++c) {
+    centroids[c] = distinct[(2 * c + 1) * distinct.size() / (2 * k)];
+  }
+
+  constexpr int kMaxIterations = 32;
+  for (int iter = 0; iter < kMaxIterations; ++iter) {
+    bool changed = false;
+    for (size_t i = 0; i < points.size(); ++i) {
+      int nearest = 0;
+      for (size_t c = 1; c < centroids.size(); ++c) {
+        if (std::abs(points[i] - centroids[c]) <
+            std::abs(points[i] - centroids[nearest])) {
+          nearest = static_cast<int>(c);
+        }
+      }
+      changed |= (iter == 0 || clusters[i] != nearest);
+      clusters[i] = nearest;
+    }
+    if (!changed) {
+      break;
+    }
+    std::vector<double> sums(centroids.size(), 0.);
+    std::vector<size_t> counts(centroids.size(), 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+      sums[clusters[i]] += points[i];
+      ++counts[clusters[i]];
+    }
+    for (size_t c = 0; c < centroids.size(); ++c) {
+      if (counts[c] > 0) {
+        centroids[c] = sums[c] / static_cast<double>(counts[c]);
+      }
+    }
+  }
+
+  // renumber the non-empty clusters by increasing centroid
+  std::vector<size_t> order;
+  std::vector<size_t> counts(centroids.size(), 0);
+  for (int cluster : clusters) {
+    ++counts[cluster];
+  }
+  for (size_t c = 0; c < centroids.size(); ++c) {
+    if (counts[c] > 0) order.push_back(c);
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return centroids[a] < centroids[b];
+  });
+  std::vector<int> rank(centroids.size(), 0);
+  for (size_t r = 0; r < order.size(); ++r) {
+    rank[order[r]] = static_cast<int>(r);
+  }
+  for (auto& cluster : clusters) {
+    cluster = rank[cluster];
+  }
+  return clusters;
+}
+
+int ChooseShapeProfile(const ShapeProfile& shapes,
+                       const std::vector<ShapeProfile>& min_shapes,
+                       const std::vector<ShapeProfile>& max_shapes,
+                       const std::vector<ShapeProfile>& opt_shapes) {
+  constexpr double kEpsilon = 1e-9;
+  int chosen = -1;
+  double chosen_distance = std::numeric_limits<double>::max();
+  double chosen_width = std::numeric_limits<double>::max();
+  for (size_t p = 0; p < min_shapes.size(); ++p) {
+    bool holds = true;
+    // both relative to the dimensions, so that no dimension dominates
+    double distance = 0.;
+    double width = 0.;
+    for (const auto& it : min_shapes[p]) {
+      auto shape = shapes.find(it.first);
+      if (shape == shapes.end()) continue;
+      const auto& min_shape = it.second;
+      const auto& max_shape = max_shapes[p].at(it.first);
+      const auto& opt_shape = opt_shapes[p].at(it.first);
+      if (shape->second.size() != min_shape.size()) {
+        holds = false;
+        break;
+      }
+      for (size_t d = 0; d < min_shape.size(); ++d) {
+        int32_t dim = shape->second[d];
+        if (dim < min_shape[d] || dim > max_shape[d]) {
+          holds = false;
+          break;
+        }
+        distance += std::abs(dim - opt_shape[d]) /
+                    static_cast<double>(std::max(opt_shape[d], 1));
+        width += (max_shape[d] - min_shape[d]) /
+                 static_cast<double>(std::max(max_shape[d], 1));
+      }
+      if (!holds) break;
+    }
+    if (!holds) continue;
+    // the tighter profile on a tie, it is tuned for fewer shapes
+    if (distance < chosen_distance - kEpsilon ||
+        (distance < chosen_distance + kEpsilon && width < chosen_width)) {
+      chosen = static_cast<int>(p);
+      chosen_distance = distance;
+      chosen_width = width;
+    }
+  }
+  return chosen;
+}
+
+}  // namespace paddle::inference
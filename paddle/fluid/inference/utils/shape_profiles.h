@@ -0,0 +1,43 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace inference {
+
+using ShapeProfile = std::map<std::string, std::vector<int32_t>>;
+
+// Groups the runs of the given sizes into at most num_clusters clusters with
+// a 1-D k-means on the log of the sizes, so that traffic with short and long
+// inputs gets a cluster per mode. Returns the cluster of every run, the
+// clusters are numbered by increasing size and none of them is empty.
+std::vector<int> ClusterShapeSizes(const std::vector<int64_t>& sizes,
+                                   int num_clusters);
+
+// Returns the profile whose opt shapes are the closest to the given shapes
+// among those whose min and max shapes hold them, or -1 if none does. Only
+// the names of a profile are checked.
+int ChooseShapeProfile(const ShapeProfile& shapes,
+                       const std::vector<ShapeProfile>& min_shapes,
+                       const std::vector<ShapeProfile>& max_shapes,
+                       const std::vector<ShapeProfile>& opt_shapes);
+
+}  // namespace inference
+}  // namespace paddle
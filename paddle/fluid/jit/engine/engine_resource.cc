@@ -0,0 +1,82 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/jit/engine/engine_resource.h"
+
+#include "paddle/fluid/framework/new_executor/interpretercore.h"
+#include "paddle/fluid/framework/new_executor/pir_interpreter.h"
+#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
+
+namespace paddle::jit {
+
+EngineResource::EngineResource(
+    const std::shared_ptr<VariableMap> &params_dict)
+    : state_(std::make_shared<SharedState>()) {
+  state_->params_dict = params_dict;
+}
+
+std::shared_ptr<EngineResource> EngineResource::Fork() const {
+  return std::shared_ptr<EngineResource>(new EngineResource(state_));
+}
+
+framework::Scope *EngineResource::NewScope(
+    const std::vector<std::string> &param_names) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::vector<std::string> missing_names;
+  for (const auto &name : param_names) {
+    if (state_->param_names.insert(name).second) {
+      missing_names.push_back(name);
+    }
+  }
+  utils::ShareParamsIntoScope(
+      missing_names, state_->params_dict, &state_->param_scope);
+  return &state_->param_scope.NewScope();
+}
+
+void EngineResource::DeleteScope(framework::Scope *scope) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->param_scope.DeleteScope(scope);
+}
+
+std::shared_ptr<pir::Program> EngineResource::KernelProgram(
+    const std::shared_ptr<pir::Program> &prog, const phi::Place &place) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  auto &kernel_program = state_->kernel_programs[prog.get()];
+  if (kernel_program == nullptr) {
+    kernel_program = paddle::dialect::PdOpLowerToKernelPass(prog.get(), place);
+  }
+  return kernel_program;
+}
+
+void EngineResource::ShareWorkQueue(
+    const std::shared_ptr<framework::InterpreterCore> &interpreter) {
+  auto owner = work_queue_owner_.lock();
+  if (owner == nullptr) {
+    work_queue_owner_ = interpreter;
+  } else {
+    interpreter->ShareWorkQueueFrom(owner);
+  }
+}
+
+void EngineResource::ShareWorkQueue(
+    const std::shared_ptr<framework::PirInterpreter> &interpreter) {
+  auto owner = pir_work_queue_owner_.lock();
+  if (owner == nullptr) {
+    pir_work_queue_owner_ = interpreter;
+  } else {
+    interpreter->ShareWorkQueueFrom(owner.get());
+  }
+}
+
+}  // namespace paddle::jit
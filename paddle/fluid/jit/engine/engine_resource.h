@@ -0,0 +1,90 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/jit/function_utils.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/pir/include/core/program.h"
+
+namespace paddle {
+
+namespace framework {
+class InterpreterCore;
+class PirInterpreter;
+}  // namespace framework
+
+namespace jit {
+
+// What the engines of the functions of one Layer share, so that a model
+// exported with many methods does not set everything up once per method:
+// - one scope holding the parameters, every engine runs in a child scope of
+//   it;
+// - the kernel programs lowered from the pir programs, lowered once;
+// - the work queue of the first interpreter, reused by the later ones instead
+//   of starting their own threads.
+class EngineResource {
+ public:
+  explicit EngineResource(const std::shared_ptr<VariableMap> &params_dict);
+
+  // Shares the parameter scope and the kernel programs but not the work
+  // queue, for engine clones that serve other threads at the same time.
+  std::shared_ptr<EngineResource> Fork() const;
+
+  // a child of the parameter scope, which gets param_names if it lacks them
+  framework::Scope *NewScope(const std::vector<std::string> &param_names);
+
+  void DeleteScope(framework::Scope *scope);
+
+  // kernel program of prog on place, lowered on the first call
+  std::shared_ptr<pir::Program> KernelProgram(
+      const std::shared_ptr<pir::Program> &prog, const phi::Place &place);
+
+  // lets interpreter use the work queue of the first interpreter shared here
+  void ShareWorkQueue(
+      const std::shared_ptr<framework::InterpreterCore> &interpreter);
+  void ShareWorkQueue(
+      const std::shared_ptr<framework::PirInterpreter> &interpreter);
+
+ private:
+  struct SharedState {
+    std::shared_ptr<VariableMap> params_dict;
+    std::mutex mutex;
+    framework::Scope param_scope;
+    std::unordered_set<std::string> param_names;
+    // Layers live on one place, so the source program identifies the lowered
+    // one
+    std::unordered_map<const pir::Program *, std::shared_ptr<pir::Program>>
+        kernel_programs;
+  };
+
+  explicit EngineResource(const std::shared_ptr<SharedState> &state)
+      : state_(state) {}
+
+  std::shared_ptr<SharedState> state_;
+  // the sharers hold the queue itself, so the owner may go first
+  std::weak_ptr<framework::InterpreterCore> work_queue_owner_;
+  std::weak_ptr<framework::PirInterpreter> pir_work_queue_owner_;
+};
+
+}  // namespace jit
+}  // namespace paddle
@@ -29,19 +29,31 @@ namespace paddle::jit {
 InterpreterEngine::InterpreterEngine(
     const std::shared_ptr<FunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
-    const phi::Place &place)
-    : info_(info), params_dict_(params_dict), place_(place) {
+    const phi::Place &place,
+    const std::shared_ptr<EngineResource> &resource)
+    : info_(info),
+      params_dict_(params_dict),
+      resource_(resource),
+      place_(place) {
   info_->RemoveDescFeedFetch();
   PADDLE_ENFORCE_GT(
       static_cast<int64_t>(info_->ProgramDesc().Block(0).OpSize()),
       0,
       common::errors::PreconditionNotMet(
           "There is no operator in ProgramDesc."));
-  utils::ShareParamsIntoScope(info_->ParamNames(), params_dict_, &scope_);
-  VLOG(6) << framework::GenScopeTreeDebugInfo(&scope_);
+  if (resource_ == nullptr) {
+    resource_ = std::make_shared<EngineResource>(params_dict_);
+  }
+  scope_ = resource_->NewScope(info_->ParamNames());
+  VLOG(6) << framework::GenScopeTreeDebugInfo(scope_);
   CreateInterpreterCore();
 }
 
+InterpreterEngine::~InterpreterEngine() noexcept {
+  inner_interpreter_.reset();
+  resource_->DeleteScope(scope_);
+}
+
 void InterpreterEngine::CreateInterpreterCore() {
   auto &program_desc = info_->ProgramDesc();
 
@@ -70,7 +82,8 @@ void InterpreterEngine::CreateInterpreterCore() {
   execution_config.skip_gc_vars.insert(out_names.begin(), out_names.end());
 
   inner_interpreter_ = std::make_shared<InterpreterCore>(
-      place_, converted_prog_.Block(0), &scope_, execution_config);
+      place_, converted_prog_.Block(0), scope_, execution_config);
+  resource_->ShareWorkQueue(inner_interpreter_);
 }
 
 std::vector<Tensor> InterpreterEngine::operator()(
@@ -81,15 +94,15 @@ std::vector<Tensor> InterpreterEngine::operator()(
 
 std::vector<DenseTensor> InterpreterEngine::operator()(
     const std::vector<DenseTensor> &inputs) {
-  utils::ShareIntoScope(info_->InputArgNames(), inputs, &scope_);
+  utils::ShareIntoScope(info_->InputArgNames(), inputs, scope_);
 
   // the latter can be moved to python side.
   auto &feed_names = info_->InputArgNames();
   paddle::framework::FetchList outs = inner_interpreter_->Run(feed_names);
 
   std::vector<DenseTensor> outputs;
-  utils::FetchOuts(info_->OutputArgNames(), scope_, &outputs);
-  scope_.DropKids();
+  utils::FetchOuts(info_->OutputArgNames(), *scope_, &outputs);
+  scope_->DropKids();
 
   return outputs;
 }
@@ -99,7 +112,8 @@ const std::shared_ptr<FunctionInfo> &InterpreterEngine::Info() const {
 }
 
 std::unique_ptr<BaseEngine> InterpreterEngine::Clone(void *stream) {
-  auto *x = new InterpreterEngine(info_, params_dict_, place_);
+  auto *x =
+      new InterpreterEngine(info_, params_dict_, place_, resource_->Fork());
   return std::unique_ptr<BaseEngine>(x);
 }
 
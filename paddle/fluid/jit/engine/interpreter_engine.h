@@ -20,6 +20,7 @@
 #include "paddle/fluid/framework/scope.h"
 
 #include "paddle/fluid/jit/engine/base_engine.h"
+#include "paddle/fluid/jit/engine/engine_resource.h"
 #include "paddle/fluid/jit/function_schema.h"
 #include "paddle/fluid/jit/function_utils.h"
 
@@ -35,11 +36,14 @@ using InterpreterCore = framework::InterpreterCore;
 
 class InterpreterEngine : public BaseEngine {
  public:
+  // resource is shared with the engines of the other functions of the layer,
+  // a private one is made when it is null
   InterpreterEngine(const std::shared_ptr<FunctionInfo> &info,
                     const std::shared_ptr<VariableMap> &params_dict,
-                    const phi::Place &place);
+                    const phi::Place &place,
+                    const std::shared_ptr<EngineResource> &resource = nullptr);
 
-  ~InterpreterEngine() noexcept {}
+  ~InterpreterEngine() noexcept;
 
   void CreateInterpreterCore();
 
@@ -55,7 +59,9 @@ class InterpreterEngine : public BaseEngine {
  private:
   std::shared_ptr<FunctionInfo> info_;
   std::shared_ptr<VariableMap> params_dict_;
-  framework::Scope scope_;
+  std::shared_ptr<EngineResource> resource_;
+  // child of the parameter scope of resource_
+  framework::Scope *scope_;
   phi::Place place_;
   std::shared_ptr<framework::InterpreterCore> inner_interpreter_;
   framework::ProgramDesc converted_prog_;
@@ -16,7 +16,6 @@
 #include "paddle/fluid/jit/engine/interpreter_engine.h"
 
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
-#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
 #include "paddle/phi/core/enforce.h"
 #include "paddle/pir/include/core/program.h"
 #include "paddle/pir/include/core/value.h"
@@ -28,16 +27,31 @@ PirInterpreterEngine::PirInterpreterEngine(
     const std::shared_ptr<PirFunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
     const phi::Place &place,
-    const std::shared_ptr<pir::Program> &prog)
-    : info_(info), params_dict_(params_dict), place_(place), prog_(prog) {
+    const std::shared_ptr<pir::Program> &prog,
+    const std::shared_ptr<EngineResource> &resource)
+    : info_(info),
+      params_dict_(params_dict),
+      resource_(resource),
+      place_(place),
+      prog_(prog) {
   PADDLE_ENFORCE_GT(static_cast<int64_t>(info_->Program()->block()->size()),
                     0,
                     common::errors::PreconditionNotMet(
                         "There is no operator in ProgramDesc."));
-  utils::ShareParamsIntoScope(info_->ParamNames(), params_dict_, &scope_);
+  if (resource_ == nullptr) {
+    resource_ = std::make_shared<EngineResource>(params_dict_);
+  }
+  scope_ = resource_->NewScope(info_->ParamNames());
+  // lowered once per layer rather than on every call
+  kernel_prog_ = resource_->KernelProgram(prog_, place_);
   CreateInterpreterCore();
 }
 
+PirInterpreterEngine::~PirInterpreterEngine() noexcept {
+  inner_interpreter_.reset();
+  resource_->DeleteScope(scope_);
+}
+
 void PirInterpreterEngine::CreateInterpreterCore() {
   framework::interpreter::ExecutionConfig execution_config;
   execution_config.create_local_scope = false;
@@ -49,7 +63,8 @@ void PirInterpreterEngine::CreateInterpreterCore() {
   execution_config.skip_gc_vars.insert(in_names.begin(), in_names.end());
   execution_config.skip_gc_vars.insert(out_names.begin(), out_names.end());
   inner_interpreter_ = std::make_shared<PirInterpreter>(
-      place_, out_names, prog_->block(), &scope_, execution_config);
+      place_, out_names, kernel_prog_->block(), scope_, execution_config);
+  resource_->ShareWorkQueue(inner_interpreter_);
 }
 
 std::vector<Tensor> PirInterpreterEngine::operator()(
@@ -60,16 +75,15 @@ std::vector<Tensor> PirInterpreterEngine::operator()(
 
 std::vector<DenseTensor> PirInterpreterEngine::operator()(
     const std::vector<DenseTensor> &inputs) {
-  prog_ = paddle::dialect::PdOpLowerToKernelPass(prog_.get(), place_);
-  utils::ShareIntoScope(info_->InputArgNames(), inputs, &scope_);
+  utils::ShareIntoScope(info_->InputArgNames(), inputs, scope_);
 
   // the latter can be moved to python side.
   auto &feed_names = info_->InputArgNames();
   paddle::framework::FetchList outs = inner_interpreter_->Run(feed_names);
 
   std::vector<DenseTensor> outputs;
-  utils::FetchOuts(info_->OutputArgNames(), scope_, &outputs);
-  scope_.DropKids();
+  utils::FetchOuts(info_->OutputArgNames(), *scope_, &outputs);
+  scope_->DropKids();
 
   return outputs;
 }
@@ -79,7 +93,8 @@ const std::shared_ptr<PirFunctionInfo> &PirInterpreterEngine::Info() const {
 }
 
 std::unique_ptr<BaseEngine> PirInterpreterEngine::Clone(void *stream) {
-  auto *x = new PirInterpreterEngine(info_, params_dict_, place_, prog_);
+  auto *x = new PirInterpreterEngine(
+      info_, params_dict_, place_, prog_, resource_->Fork());
   return std::unique_ptr<BaseEngine>(x);
 }
 
@@ -21,6 +21,7 @@
 
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/jit/engine/base_engine.h"
+#include "paddle/fluid/jit/engine/engine_resource.h"
 #include "paddle/fluid/jit/function_schema.h"
 #include "paddle/fluid/jit/function_utils.h"
 
@@ -37,12 +38,16 @@ using PirInterpreter = framework::PirInterpreter;
 
 class PirInterpreterEngine : public BaseEngine {
  public:
-  PirInterpreterEngine(const std::shared_ptr<PirFunctionInfo> &info,
-                       const std::shared_ptr<VariableMap> &params_dict,
-                       const phi::Place &place,
-                       const std::shared_ptr<pir::Program> &prog);
+  // resource is shared with the engines of the other functions of the layer,
+  // a private one is made when it is null
+  PirInterpreterEngine(
+      const std::shared_ptr<PirFunctionInfo> &info,
+      const std::shared_ptr<VariableMap> &params_dict,
+      const phi::Place &place,
+      const std::shared_ptr<pir::Program> &prog,
+      const std::shared_ptr<EngineResource> &resource = nullptr);
 
-  ~PirInterpreterEngine() noexcept {}
+  ~PirInterpreterEngine() noexcept;
 
   void CreateInterpreterCore();
 
@@ -58,10 +63,14 @@ class PirInterpreterEngine : public BaseEngine {
  private:
   std::shared_ptr<PirFunctionInfo> info_;
   std::shared_ptr<VariableMap> params_dict_;
-  framework::Scope scope_;
+  std::shared_ptr<EngineResource> resource_;
+  // child of the parameter scope of resource_
+  framework::Scope *scope_;
   phi::Place place_;
   std::shared_ptr<framework::PirInterpreter> inner_interpreter_;
+  // the source program, whose lowered kernel program is run
   std::shared_ptr<pir::Program> prog_;
+  std::shared_ptr<pir::Program> kernel_prog_;
 };
 
 }  // namespace jit
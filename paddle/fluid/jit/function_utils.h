@@ -56,20 +56,22 @@ void ShareParamsIntoScope(const std::vector<std::string> &param_names,
 
 void RemoveFeedFetch(framework::ProgramDesc *program_desc);
 
-template <typename T>
+template <typename T, typename... Args>
 std::shared_ptr<T> MakeEngine(const std::shared_ptr<FunctionInfo> &info,
                               const std::shared_ptr<VariableMap> &params_dict,
-                              const phi::Place &place) {
-  return std::make_shared<T>(info, params_dict, place);
+                              const phi::Place &place,
+                              const Args &...args) {
+  return std::make_shared<T>(info, params_dict, place, args...);
 }
 
-template <typename T>
+template <typename T, typename... Args>
 std::shared_ptr<T> MakePirEngine(
     const std::shared_ptr<PirFunctionInfo> &info,
     const std::shared_ptr<VariableMap> &params_dict,
     const phi::Place &place,
-    const std::shared_ptr<pir::Program> &prog) {
-  return std::make_shared<T>(info, params_dict, place, prog);
+    const std::shared_ptr<pir::Program> &prog,
+    const Args &...args) {
+  return std::make_shared<T>(info, params_dict, place, prog, args...);
 }
 
 }  // namespace utils
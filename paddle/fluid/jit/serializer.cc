@@ -93,6 +93,9 @@ Layer Deserializer::operator()(const std::string& path,
   }
 
   Layer layer = Layer(params_dict, attrs_dict, info_map, place);
+  // the functions share the parameter scope, the kernel programs and the
+  // work queue of their interpreters
+  auto engine_resource = std::make_shared<EngineResource>(params_dict);
 
   for (auto& map_item : info_map) {
     const std::string& func_name = map_item.first;
@@ -103,13 +106,17 @@ Layer Deserializer::operator()(const std::string& path,
       auto pir_info = std::dynamic_pointer_cast<PirFunctionInfo>(base_info);
       layer.SetEngine(func_name,
                       utils::MakePirEngine<PirInterpreterEngine>(
-                          pir_info, params_dict, place, pir_info->Program()));
+                          pir_info,
+                          params_dict,
+                          place,
+                          pir_info->Program(),
+                          engine_resource));
     } else {
       auto info = std::dynamic_pointer_cast<FunctionInfo>(base_info);
       if (FLAGS_jit_engine_type == "New") {
-        layer.SetEngine(
-            func_name,
-            utils::MakeEngine<InterpreterEngine>(info, params_dict, place));
+        layer.SetEngine(func_name,
+                        utils::MakeEngine<InterpreterEngine>(
+                            info, params_dict, place, engine_resource));
       } else if (FLAGS_jit_engine_type == "Predictor") {
         layer.SetEngine(
             info->FunctionName(),
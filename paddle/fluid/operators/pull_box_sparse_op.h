@@ -36,23 +36,41 @@ static void PullBoxSparseFunctor(const framework::ExecutionContext &ctx) {
   // BoxPS only supports float now
   std::vector<float *> all_values(slot_size);
   std::vector<int64_t> slot_lengths(slot_size);
+  int64_t total_length = 0;
   for (size_t i = 0; i < slot_size; i++) {
     const auto *slot = inputs[i];
     const uint64_t *single_slot_keys =
         reinterpret_cast<const uint64_t *>(slot->data<int64_t>());
     all_keys[i] = single_slot_keys;
     slot_lengths[i] = slot->numel();
-    auto *output = outputs[i]->mutable_data<T>(ctx.GetPlace());
-    all_values[i] = output;
+    total_length += slot_lengths[i];
   }
-#ifdef PADDLE_WITH_BOX_PS
+  // All the outputs are row slices of one slot-contiguous arena: one
+  // allocation instead of one per slot, and the pull can fill the rows of
+  // every slot in a single pass over the packed keys.
   auto hidden_size = ctx.Attr<int>("size");
+  phi::DenseTensor out_arena;
+  if (total_length > 0) {
+    out_arena.Resize({total_length, hidden_size});
+    out_arena.mutable_data<T>(ctx.GetPlace());
+  }
+  int64_t offset = 0;
+  for (size_t i = 0; i < slot_size; i++) {
+    if (slot_lengths[i] > 0) {
+      auto out_dims = outputs[i]->dims();
+      outputs[i]->ShareDataWith(
+          out_arena.Slice(offset, offset + slot_lengths[i]));
+      outputs[i]->Resize(out_dims);
+      offset += slot_lengths[i];
+    }
+    all_values[i] = outputs[i]->mutable_data<T>(ctx.GetPlace());
+  }
+#ifdef PADDLE_WITH_BOX_PS
   auto box_ptr = paddle::framework::BoxWrapper::GetInstance();
   box_ptr->PullSparse(
       ctx.GetPlace(), all_keys, all_values, slot_lengths, hidden_size, 0);
 #endif
 #ifdef PADDLE_WITH_HETERPS
-  auto hidden_size = ctx.Attr<int>("size");
   auto gpu_ps_ptr = paddle::framework::PSGPUWrapper::GetInstance();
   gpu_ps_ptr->PullSparse(
       ctx.GetPlace(), 0, all_keys, all_values, slot_lengths, hidden_size);
@@ -16,6 +16,7 @@
 
 #ifdef PADDLE_WITH_CUDA
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -24,6 +25,7 @@
 #include <vector>
 
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/data_device_transform.h"
 #include "paddle/fluid/framework/executor.h"
 #include "paddle/fluid/framework/op_registry.h"
@@ -34,6 +36,7 @@
 #include "paddle/fluid/inference/tensorrt/engine.h"
 #include "paddle/fluid/inference/tensorrt/helper.h"
 #include "paddle/fluid/inference/tensorrt/trt_int8_calibrator.h"
+#include "paddle/fluid/inference/utils/engine_cache.h"
 #include "paddle/fluid/inference/utils/io_utils.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/memory_utils.h"
@@ -44,6 +47,8 @@
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
 #include "paddle/utils/string/string_helper.h"
 
+COMMON_DECLARE_int64(trt_engine_cache_capacity_mb);
+
 namespace paddle {
 namespace inference {
 namespace tensorrt {
@@ -419,13 +424,13 @@ class TensorRTEngineOp : public framework::OperatorBase {
             std::string trt_engine_serialized_data =
                 std::string((const char *)serialized_engine_data->data(),
                             serialized_engine_data->size());
-            inference::analysis::SaveTrtEngineSerializedDataToFile(
-                inference::analysis::GetTrtEngineSerializedPath(
-                    model_opt_cache_dir_, engine_key_),
-                trt_engine_serialized_data);
+            inference::EngineFileCache engine_cache(
+                model_opt_cache_dir_,
+                "trt_serialized_",
+                FLAGS_trt_engine_cache_capacity_mb * 1024 * 1024);
+            engine_cache.Store(engine_key_, trt_engine_serialized_data);
             LOG(INFO) << "Save TRT Optimized Info to "
-                      << inference::analysis::GetTrtEngineSerializedPath(
-                             model_opt_cache_dir_, engine_key_);
+                      << engine_cache.Path(engine_key_);
           }
         }
       }
@@ -558,6 +563,16 @@ class TensorRTEngineOp : public framework::OperatorBase {
     if (engine->with_dynamic_shape()) {
       // Initialize context and get offset by profile index
       trt_context = engine->context();
+      if (engine->num_shape_profiles() > 1) {
+        std::map<std::string, std::vector<int>> input_shapes;
+        for (auto x : runtime_input_names_) {
+          const auto &t =
+              inference::analysis::GetFromScope<phi::DenseTensor>(scope, x);
+          x = x.substr(0, x.find("_cast_auto_mixed.tmp_"));
+          input_shapes[x] = common::vectorize<int>(t.dims());
+        }
+        engine->SelectShapeProfile(input_shapes, stream);
+      }
       binding_offset = engine->GetBindingsOffset();
     }
     // Bind input tensor to TRT.
@@ -997,6 +1012,11 @@ class TensorRTEngineOp : public framework::OperatorBase {
                                              &params.min_shape_tensor,
                                              &params.max_shape_tensor,
                                              &params.optim_shape_tensor);
+        inference::DeserializeShapeRangeProfiles(
+            shape_range_info_path_,
+            &params.profile_min_input_shapes,
+            &params.profile_max_input_shapes,
+            &params.profile_optim_input_shapes);
       } else {
         if (HasAttr("dynamic_shape_names") &&
             HasAttr("min_input_shape_vector") &&
@@ -0,0 +1,130 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/dialect/distributed/transforms/fuse_collective_matmul_pass.h"
+
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+#include "paddle/fluid/pir/utils/general_functions.h"
+
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+bool IsLinear(const paddle::drr::MatchContext &match_ctx) {
+  return match_ctx.Attr<bool>("trans_x") == false &&
+         pir::GetShapeFromValue(match_ctx.Tensor("x")).size() >= 2 &&
+         pir::GetShapeFromValue(match_ctx.Tensor("weight")).size() == 2;
+}
+
+// all_gather+matmul -> all_gather_matmul, the gathered input is still an
+// output for the matmul_grad.
+class FuseAllGatherMatmulPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override { return "FuseAllGatherMatmulPattern"; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+
+    const auto &all_gather = pat.Op(paddle::dialect::AllGatherOp::name(),
+                                    {{"ring_id", pat.Attr("ring_id")},
+                                     {"nranks", pat.Attr("nranks")}});
+    const auto &matmul = pat.Op(paddle::dialect::MatmulOp::name(),
+                                {{"transpose_x", pat.Attr("trans_x")},
+                                 {"transpose_y", pat.Attr("trans_y")}});
+
+    pat.Tensor("x") = all_gather(pat.Tensor("x_local"));
+    pat.Tensor("out") = matmul(pat.Tensor("x"), pat.Tensor("weight"));
+
+    pat.AddConstraint([&](const paddle::drr::MatchContext &match_ctx) {
+      return IsLinear(match_ctx);
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    const auto &all_gather_matmul =
+        res.Op(paddle::dialect::AllGatherMatmulOp::name(),
+               {{"transpose_y", pat.Attr("trans_y")},
+                {"ring_id", pat.Attr("ring_id")},
+                {"nranks", pat.Attr("nranks")}});
+    all_gather_matmul({&res.Tensor("x_local"), &res.Tensor("weight")},
+                      {&res.Tensor("out"), &res.Tensor("x")});
+  }
+};
+
+// matmul+reduce_scatter -> matmul_reduce_scatter
+class FuseMatmulReduceScatterPattern : public paddle::drr::DrrPatternBase {
+ public:
+  std::string name() const override {
+    return "FuseMatmulReduceScatterPattern";
+  }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+
+    const auto &matmul = pat.Op(paddle::dialect::MatmulOp::name(),
+                                {{"transpose_x", pat.Attr("trans_x")},
+                                 {"transpose_y", pat.Attr("trans_y")}});
+    const auto &reduce_scatter =
+        pat.Op(paddle::dialect::ReduceScatterOp::name(),
+               {{"ring_id", pat.Attr("ring_id")},
+                {"nranks", pat.Attr("nranks")}});
+
+    pat.Tensor("partial") = matmul(pat.Tensor("x"), pat.Tensor("weight"));
+    pat.Tensor("out") = reduce_scatter(pat.Tensor("partial"));
+
+    pat.AddConstraint([&](const paddle::drr::MatchContext &match_ctx) {
+      return IsLinear(match_ctx) &&
+             match_ctx.Tensor("partial").use_count() == 1;
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    const auto &matmul_reduce_scatter =
+        res.Op(paddle::dialect::MatmulReduceScatterOp::name(),
+               {{"transpose_y", pat.Attr("trans_y")},
+                {"ring_id", pat.Attr("ring_id")},
+                {"nranks", pat.Attr("nranks")}});
+    res.Tensor("out") =
+        matmul_reduce_scatter(res.Tensor("x"), res.Tensor("weight"));
+  }
+};
+
+// Replaces the all_gather before and the reduce_scatter after the matmul of
+// the tensor parallel linears (the reshards of the sequence parallel inserted
+// around matmul) by the kernels overlapping the collective with the GEMM.
+class FuseCollectiveMatmulPass : public pir::PatternRewritePass {
+ public:
+  FuseCollectiveMatmulPass()
+      : pir::PatternRewritePass("fuse_collective_matmul_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(paddle::drr::Create<FuseAllGatherMatmulPattern>(context));
+    ps.Add(paddle::drr::Create<FuseMatmulReduceScatterPattern>(context));
+
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateFuseCollectiveMatmulPass() {
+  return std::make_unique<FuseCollectiveMatmulPass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(fuse_collective_matmul_pass, FuseCollectiveMatmulPass);
@@ -104,7 +104,9 @@ NEED_GEN_STATIC_ONLY_APIS = [
     'distributed_fused_lamb_init_',
     'fetch',
     'fused_embedding_eltwise_layernorm',
+    'fused_embedding_seqpool_cvm',
     'fused_fc_elementwise_layernorm',
+    'fused_int8_matmul',
     'fused_multi_transformer_xpu',
     'fused_scale_bias_relu_conv_bn',
     'fused_scale_bias_add_relu',
@@ -2221,6 +2221,56 @@ bool FusedMultiTransformerOpInferSymbolicShape(
   return true;
 }
 
+bool FusedTokenPruneOpInferSymbolicShape(
+    pir::Operation *op, pir::InferSymbolicShapeContext *infer_context) {
+  const auto &attn_shape =
+      infer_context->GetShapeOrDataForValue(op->operand_source(0)).shape();
+  const auto &x_shape =
+      infer_context->GetShapeOrDataForValue(op->operand_source(1)).shape();
+  const auto &mask_shape =
+      infer_context->GetShapeOrDataForValue(op->operand_source(2)).shape();
+  const auto &new_mask_shape =
+      infer_context->GetShapeOrDataForValue(op->operand_source(3)).shape();
+
+  PADDLE_ENFORCE_EQ(
+      attn_shape.size(),
+      4,
+      common::errors::InvalidArgument("The input attn must be 4-dimension"));
+  PADDLE_ENFORCE_EQ(
+      x_shape.size(),
+      3,
+      common::errors::InvalidArgument("The input x must be 3-dimension"));
+  PADDLE_ENFORCE_EQ(
+      mask_shape.size(),
+      4,
+      common::errors::InvalidArgument("The input mask must be 4-dimension"));
+  PADDLE_ENFORCE_EQ(new_mask_shape.size(),
+                    4,
+                    common::errors::InvalidArgument(
+                        "The input new_mask must be 4-dimension"));
+
+  // batch size and max seq len
+  infer_context->AddEqualCstr(attn_shape[0], mask_shape[0]);
+  infer_context->AddEqualCstr(attn_shape[0], x_shape[0]);
+  infer_context->AddEqualCstr(attn_shape[1], mask_shape[1]);
+  infer_context->AddEqualCstr(attn_shape[2], attn_shape[3]);
+  infer_context->AddEqualCstr(attn_shape[2], mask_shape[2]);
+  infer_context->AddEqualCstr(attn_shape[2], mask_shape[3]);
+  infer_context->AddEqualCstr(attn_shape[2], x_shape[1]);
+
+  // The pruned seq len is the one of new_mask, so the ops after the pruning
+  // are planned for the shorter sequences in terms of the same symbol.
+  const symbol::DimExpr &slim_seq_len = new_mask_shape[2];
+  infer_context->SetShapeOrDataForValue(
+      op->result(0),
+      symbol::TensorShapeOrDataDimExprs(
+          {x_shape[0], slim_seq_len, x_shape[2]}));
+  infer_context->SetShapeOrDataForValue(
+      op->result(1),
+      symbol::TensorShapeOrDataDimExprs({x_shape[0], slim_seq_len}));
+  return true;
+}
+
 bool GenerateProposalsOpInferSymbolicShape(
     pir::Operation *op, pir::InferSymbolicShapeContext *infer_context) {
   symbol::DimExpr out_unknown = infer_context->GetNextSymName();
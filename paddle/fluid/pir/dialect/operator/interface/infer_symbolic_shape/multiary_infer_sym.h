@@ -65,6 +65,7 @@ OP_DECLARE_INFER_SYMBOLIC_SHAPE(FusedBnAddActivation)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(FusedBnAddActivation_)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(FusedGemmEpilogue)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(FusedMultiTransformer)
+OP_DECLARE_INFER_SYMBOLIC_SHAPE(FusedTokenPrune)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(GenerateProposals)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(GraphKhopSampler)
 OP_DECLARE_INFER_SYMBOLIC_SHAPE(GraphSampleNeighbors)
@@ -50,6 +50,11 @@ class DrrRewritePattern : public pir::RewritePattern {
       pir::PatternRewriter& rewriter) const override;  // // NOLINT
 
  private:
+  // Rejects the ops whose operands can not match the anchor of the source
+  // pattern graph before the whole graph is matched, most of the ops of the
+  // anchor type fail on the producers of their operands.
+  bool MatchAnchorOperands(pir::Operation* op) const;
+
   bool PatternGraphMatch(pir::Operation* op,
                          MatchContextImpl* source_pattern_match_ctx) const;
 
@@ -101,6 +106,15 @@ class DrrRewritePattern : public pir::RewritePattern {
   const std::vector<PostProcess> post_processes_;
   const std::shared_ptr<ResultPatternGraph> result_pattern_graph_;
 
+  struct AnchorOperand {
+    bool is_none;
+    // Empty if the operand is an input of the source pattern graph.
+    std::string producer_name;
+    size_t num_consumers;
+  };
+  size_t anchor_num_results_;
+  std::vector<AnchorOperand> anchor_operands_;
+
   // Not used, just for hold it's life cycle.
   const std::shared_ptr<const DrrPatternBase> drr_pattern_owner_;
 };
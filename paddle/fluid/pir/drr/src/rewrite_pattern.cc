@@ -49,6 +49,14 @@ DrrRewritePattern::DrrRewritePattern(
                     common::errors::InvalidArgument(
                         "Source pattern graph is empty. Suggested fix: please "
                         "check the drr source pattern definition code."));
+  const OpCall* anchor = *source_pattern_graph_->OutputNodes().begin();
+  anchor_num_results_ = anchor->outputs().size();
+  for (const auto* input : anchor->inputs()) {
+    anchor_operands_.push_back(
+        {input->is_none(),
+         input->producer() ? input->producer()->name() : std::string(),
+         input->consumers().size()});
+  }
   if (VLOG_IS_ON(4)) {
     std::cout << "\nThe source pattern graph in [" << pattern_name << "]:\n"
               << *source_pattern_graph_ << std::endl;
@@ -60,6 +68,9 @@ DrrRewritePattern::DrrRewritePattern(
 bool DrrRewritePattern::MatchAndRewrite(
     pir::Operation* op,
     pir::PatternRewriter& rewriter) const {  // NOLINT
+  if (!MatchAnchorOperands(op)) {
+    return false;
+  }
   std::shared_ptr<MatchContextImpl> src_match_ctx =
       std::make_shared<MatchContextImpl>();
   if (PatternGraphMatch(op, src_match_ctx.get())) {
@@ -75,6 +86,30 @@ bool DrrRewritePattern::MatchAndRewrite(
   return false;
 }
 
+bool DrrRewritePattern::MatchAnchorOperands(pir::Operation* op) const {
+  if (op->num_operands() != anchor_operands_.size() ||
+      op->num_results() != anchor_num_results_) {
+    return false;
+  }
+  for (size_t i = 0; i < anchor_operands_.size(); ++i) {
+    const auto& anchor_operand = anchor_operands_[i];
+    pir::Value value = op->operand_source(i);
+    if (anchor_operand.is_none) {
+      if (value) return false;
+      continue;
+    }
+    if (anchor_operand.producer_name.empty()) {
+      continue;
+    }
+    if (!value || value.use_count() != anchor_operand.num_consumers ||
+        !value.defining_op() ||
+        value.defining_op()->name() != anchor_operand.producer_name) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool DrrRewritePattern::PatternGraphMatch(
     pir::Operation* op, MatchContextImpl* source_pattern_match_ctx) const {
   VLOG(6) << "PatternGraphMatch Start: op(" << op->name() << ")";
@@ -0,0 +1,50 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "paddle/fluid/pir/serialize_deserialize/include/third_party.h"
+
+namespace pir {
+/**
+ * The binary program format keeps the program json of ProgramWriter in a
+ * tagged binary encoding instead of text, which is smaller and faster to
+ * parse since numbers are varints and every string is decoded only once.
+ *
+ * The file starts with the magic, the pir version and the trainable flag,
+ * followed by sections of {kind, size, data}:
+ *   - the string table, every string value of the program appears once in
+ *     the table and is replaced by its index in the other sections;
+ *   - one section for each region of the program;
+ *   - the other keys of the program json.
+ * A reader skips the sections of unknown kind.
+ */
+
+// Whether the file starts with the magic of the binary program format.
+bool IsBinaryProgramFile(const std::string& file_path);
+
+void WriteBinaryProgram(const Json& program_json,
+                        uint64_t pir_version,
+                        bool trainable,
+                        std::ostream* os);
+
+// Returns the program json written by WriteBinaryProgram.
+Json ReadBinaryProgram(std::istream* is,
+                       uint64_t* pir_version,
+                       bool* trainable);
+
+}  // namespace pir
@@ -32,6 +32,9 @@ namespace pir {
  * @param[in] trainable    (Optional parameter, default to true) If true,
  * operation has opresult_attrs for training like stop_gradient,persistable;
  * Otherwise, it may only has opinfo attrs.
+ * @param[in] binary       (Optional parameter, default to false) If true, the
+ * program is written in the binary program format, which is smaller and
+ * faster to load than json, readable is ignored then.
  *
  * @return void。
  *
@@ -43,7 +46,8 @@ void IR_API WriteModule(const pir::Program& program,
                         uint64_t pir_version,
                         bool overwrite,
                         bool readable = false,
-                        bool trainable = true);
+                        bool trainable = true,
+                        bool binary = false);
 
 /**
  * @brief Gets a PIR program from the specified file path.
@@ -59,7 +63,8 @@ void IR_API WriteModule(const pir::Program& program,
  * funtune.
  *
  * @note If 'pir_version' is larger than the version of file, will trigger
- * version compatibility modification rule.
+ * version compatibility modification rule. Both the json and the binary
+ * program format are accepted.
  */
 bool IR_API ReadModule(const std::string& file_path,
                        pir::Program* program,
@@ -141,6 +146,10 @@ void IR_API LoadFunction(const std::string& file_path,
  * @param[out] out              The tensor to be loaded.
  * @param[in] load_as_fp16      If the flag is true, the tensor will be loaded
  * as fp16 type.
+ * @param[in] use_mmap          If the flag is true, the file is mapped into
+ * memory instead of read. The tensors loaded on the CPU point into the
+ * mapping and are read from the file when first used, the tensors loaded on
+ * a GPU are streamed through pinned buffers.
  *
  * @return void。
  *
@@ -149,5 +158,6 @@ void IR_API LoadCombineFunction(const std::string& file_path,
                                 const std::vector<std::string>& names,
                                 std::vector<phi::DenseTensor*>* out,
                                 bool load_as_fp16,
-                                phi::Place place = phi::Place());
+                                phi::Place place = phi::Place(),
+                                bool use_mmap = false);
 }  // namespace pir
@@ -0,0 +1,382 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_program.h"
+
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+#include "glog/logging.h"
+#include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/schema.h"
+
+namespace pir {
+
+namespace {
+
+constexpr char kMagic[8] = {'P', 'I', 'R', 'B', 'I', 'N', '\0', '\1'};
+
+enum SectionKind : uint8_t {
+  kStringTable = 0,
+  kRegion = 1,
+  kProgramRest = 2,
+};
+
+// the tags of the values in the sections
+enum ValueTag : uint8_t {
+  kNull = 0,
+  kFalse = 1,
+  kTrue = 2,
+  kInteger = 3,
+  kUnsigned = 4,
+  kFloat = 5,
+  kString = 6,
+  kArray = 7,
+  kObject = 8,
+};
+
+class StringTable {
+ public:
+  uint64_t Intern(const std::string& str) {
+    auto iter = index_.find(str);
+    if (iter != index_.end()) {
+      return iter->second;
+    }
+    uint64_t idx = strings_.size();
+    index_.emplace(str, idx);
+    strings_.push_back(str);
+    return idx;
+  }
+
+  const std::vector<std::string>& strings() const { return strings_; }
+
+ private:
+  std::unordered_map<std::string, uint64_t> index_;
+  std::vector<std::string> strings_;
+};
+
+class SectionWriter {
+ public:
+  explicit SectionWriter(StringTable* table) : table_(table) {}
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      data_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    data_.push_back(static_cast<char>(value));
+  }
+
+  void WriteRaw(const std::string& str) {
+    WriteVarint(str.size());
+    data_.append(str);
+  }
+
+  void WriteValue(const Json& json) {
+    switch (json.type()) {
+      case Json::value_t::null:
+        data_.push_back(kNull);
+        break;
+      case Json::value_t::boolean:
+        data_.push_back(json.get<bool>() ? kTrue : kFalse);
+        break;
+      case Json::value_t::number_integer: {
+        // zigzag, so that small negative numbers stay short
+        auto value = json.get<int64_t>();
+        data_.push_back(kInteger);
+        WriteVarint((static_cast<uint64_t>(value) << 1) ^
+                    static_cast<uint64_t>(value >> 63));
+        break;
+      }
+      case Json::value_t::number_unsigned:
+        data_.push_back(kUnsigned);
+        WriteVarint(json.get<uint64_t>());
+        break;
+      case Json::value_t::number_float: {
+        auto value = json.get<double>();
+        data_.push_back(kFloat);
+        data_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        break;
+      }
+      case Json::value_t::string:
+        data_.push_back(kString);
+        WriteVarint(table_->Intern(json.get_ref<const std::string&>()));
+        break;
+      case Json::value_t::array:
+        data_.push_back(kArray);
+        WriteVarint(json.size());
+        for (auto& item : json) {
+          WriteValue(item);
+        }
+        break;
+      case Json::value_t::object:
+        data_.push_back(kObject);
+        WriteVarint(json.size());
+        for (auto& item : json.items()) {
+          WriteVarint(table_->Intern(item.key()));
+          WriteValue(item.value());
+        }
+        break;
+      default:
+        PADDLE_THROW(common::errors::Unimplemented(
+            "Json value of type %s can not be written to the binary program.",
+            json.type_name()));
+    }
+  }
+
+  const std::string& data() const { return data_; }
+
+ private:
+  StringTable* table_;
+  std::string data_;
+};
+
+class SectionReader {
+ public:
+  SectionReader(const char* data,
+                size_t size,
+                const std::vector<std::string>* strings)
+      : cur_(data), end_(data + size), strings_(strings) {}
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte = ReadByte();
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    PADDLE_THROW(common::errors::InvalidArgument(
+        "Invalid varint in the binary program."));
+  }
+
+  std::string ReadRaw() {
+    uint64_t size = ReadVarint();
+    Require(size);
+    std::string str(cur_, size);
+    cur_ += size;
+    return str;
+  }
+
+  const std::string& ReadStringRef() {
+    uint64_t idx = ReadVarint();
+    PADDLE_ENFORCE_LT(idx,
+                      strings_->size(),
+                      common::errors::InvalidArgument(
+                          "Invalid string index %d in the binary program, "
+                          "the string table has %d strings.",
+                          idx,
+                          strings_->size()));
+    return (*strings_)[idx];
+  }
+
+  Json ReadValue() {
+    switch (ReadByte()) {
+      case kNull:
+        return Json();
+      case kFalse:
+        return Json(false);
+      case kTrue:
+        return Json(true);
+      case kInteger: {
+        uint64_t value = ReadVarint();
+        return Json(static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1)));
+      }
+      case kUnsigned:
+        return Json(ReadVarint());
+      case kFloat: {
+        double value;
+        Require(sizeof(value));
+        std::memcpy(&value, cur_, sizeof(value));
+        cur_ += sizeof(value);
+        return Json(value);
+      }
+      case kString:
+        return Json(ReadStringRef());
+      case kArray: {
+        uint64_t size = ReadVarint();
+        Json json = Json::array();
+        auto& array = json.get_ref<Json::array_t&>();
+        array.reserve(size);
+        for (uint64_t i = 0; i < size; ++i) {
+          array.emplace_back(ReadValue());
+        }
+        return json;
+      }
+      case kObject: {
+        uint64_t size = ReadVarint();
+        Json json = Json::object();
+        auto& object = json.get_ref<Json::object_t&>();
+        for (uint64_t i = 0; i < size; ++i) {
+          const std::string& key = ReadStringRef();
+          object.emplace_hint(object.end(), key, ReadValue());
+        }
+        return json;
+      }
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Invalid value tag in the binary program."));
+    }
+  }
+
+  bool AtEnd() const { return cur_ == end_; }
+
+ private:
+  void Require(size_t size) {
+    PADDLE_ENFORCE_LE(
+        size,
+        static_cast<size_t>(end_ - cur_),
+        common::errors::InvalidArgument("The binary program is truncated."));
+  }
+
+  uint8_t ReadByte() {
+    Require(1);
+    return static_cast<uint8_t>(*cur_++);
+  }
+
+  const char* cur_;
+  const char* end_;
+  const std::vector<std::string>* strings_;
+};
+
+template <typename T>
+void WritePod(const T& value, std::ostream* os) {
+  os->write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T ReadPod(std::istream* is) {
+  T value;
+  is->read(reinterpret_cast<char*>(&value), sizeof(T));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(*is),
+      true,
+      common::errors::InvalidArgument("The binary program is truncated."));
+  return value;
+}
+
+void WriteSection(SectionKind kind, const std::string& data, std::ostream* os) {
+  WritePod(static_cast<uint8_t>(kind), os);
+  WritePod(static_cast<uint64_t>(data.size()), os);
+  os->write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+}  // namespace
+
+bool IsBinaryProgramFile(const std::string& file_path) {
+  std::ifstream fin(file_path, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  fin.read(magic, sizeof(magic));
+  return fin && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+void WriteBinaryProgram(const Json& program_json,
+                        uint64_t pir_version,
+                        bool trainable,
+                        std::ostream* os) {
+  StringTable table;
+  std::vector<std::string> regions;
+  SectionWriter rest(&table);
+  rest.WriteVarint(program_json.size() - program_json.count(REGIONS));
+  for (auto& item : program_json.items()) {
+    if (item.key() == REGIONS) {
+      for (auto& region : item.value()) {
+        SectionWriter writer(&table);
+        writer.WriteValue(region);
+        regions.push_back(writer.data());
+      }
+    } else {
+      rest.WriteVarint(table.Intern(item.key()));
+      rest.WriteValue(item.value());
+    }
+  }
+  SectionWriter strings(&table);
+  strings.WriteVarint(table.strings().size());
+  for (auto& str : table.strings()) {
+    strings.WriteRaw(str);
+  }
+
+  os->write(kMagic, sizeof(kMagic));
+  WritePod(pir_version, os);
+  WritePod(static_cast<uint8_t>(trainable), os);
+  // the string table goes first, the other sections refer to it
+  WritePod(static_cast<uint64_t>(regions.size() + 2), os);
+  WriteSection(kStringTable, strings.data(), os);
+  for (auto& region : regions) {
+    WriteSection(kRegion, region, os);
+  }
+  WriteSection(kProgramRest, rest.data(), os);
+  VLOG(6) << "Write binary program with " << regions.size() << " regions and "
+          << table.strings().size() << " strings.";
+}
+
+Json ReadBinaryProgram(std::istream* is,
+                       uint64_t* pir_version,
+                       bool* trainable) {
+  char magic[sizeof(kMagic)];
+  is->read(magic, sizeof(magic));
+  PADDLE_ENFORCE_EQ(
+      static_cast<bool>(*is) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0,
+      true,
+      common::errors::InvalidArgument("Invalid binary model file."));
+  *pir_version = ReadPod<uint64_t>(is);
+  *trainable = ReadPod<uint8_t>(is) != 0;
+  uint64_t num_sections = ReadPod<uint64_t>(is);
+
+  std::vector<std::string> strings;
+  Json program_json = Json::object();
+  program_json[REGIONS] = Json::array();
+  std::string data;
+  for (uint64_t i = 0; i < num_sections; ++i) {
+    auto kind = ReadPod<uint8_t>(is);
+    auto size = ReadPod<uint64_t>(is);
+    if (kind > kProgramRest) {
+      VLOG(6) << "Skip the section of unknown kind " << kind;
+      is->seekg(static_cast<std::streamoff>(size), std::ios::cur);
+      continue;
+    }
+    data.resize(size);
+    is->read(&data[0], static_cast<std::streamsize>(size));
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(*is),
+        true,
+        common::errors::InvalidArgument("The binary program is truncated."));
+    SectionReader reader(data.data(), data.size(), &strings);
+    if (kind == kStringTable) {
+      uint64_t num_strings = reader.ReadVarint();
+      strings.reserve(num_strings);
+      for (uint64_t j = 0; j < num_strings; ++j) {
+        strings.emplace_back(reader.ReadRaw());
+      }
+    } else if (kind == kRegion) {
+      program_json[REGIONS].push_back(reader.ReadValue());
+    } else {
+      uint64_t num_items = reader.ReadVarint();
+      for (uint64_t j = 0; j < num_items; ++j) {
+        const std::string& key = reader.ReadStringRef();
+        program_json[key] = reader.ReadValue();
+      }
+    }
+    PADDLE_ENFORCE_EQ(reader.AtEnd(),
+                      true,
+                      common::errors::InvalidArgument(
+                          "The section of the binary program is corrupted."));
+  }
+  return program_json;
+}
+
+}  // namespace pir
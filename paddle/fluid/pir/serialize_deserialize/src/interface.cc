@@ -15,6 +15,7 @@
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include <stdio.h>
 #include "paddle/common/enforce.h"
+#include "paddle/fluid/pir/serialize_deserialize/include/binary_program.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_deserialize.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/ir_serialize.h"
 #include "paddle/phi/common/port.h"
@@ -31,7 +32,8 @@ void WriteModule(const pir::Program& program,
                  uint64_t pir_version,
                  bool overwrite,
                  bool readable,
-                 bool trainable) {
+                 bool trainable,
+                 bool binary) {
   PADDLE_ENFORCE_EQ(
       FileExists(file_path) && !overwrite,
       false,
@@ -40,13 +42,26 @@ void WriteModule(const pir::Program& program,
           file_path,
           overwrite));
 
+  ProgramWriter writer(pir_version, trainable);
+  if (binary) {
+    Json program_json = writer.GetProgramJson(&program);
+    MkDirRecursively(DirName(file_path).c_str());
+    std::ofstream fout(file_path, std::ios::binary);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(fout),
+                      true,
+                      common::errors::Unavailable(
+                          "Cannot open %s to save variables.", file_path));
+    WriteBinaryProgram(program_json, pir_version, trainable, &fout);
+    fout.close();
+    return;
+  }
+
   // write base code
   Json total;
 
   total[BASE_CODE] = {
       {MAGIC, PIR}, {PIRVERSION, pir_version}, {TRAINABLE, trainable}};
 
-  ProgramWriter writer(pir_version, trainable);
   // write program
   total[PROGRAM] = writer.GetProgramJson(&program);
   std::string total_str;
@@ -69,44 +84,53 @@ void WriteModule(const pir::Program& program,
 bool ReadModule(const std::string& file_path,
                 pir::Program* program,
                 int64_t pir_version) {
-  std::ifstream f(file_path);
-  Json data = Json::parse(f);
   if (pir_version < 0) {
     pir_version = DEVELOP_VERSION;
     VLOG(6) << "pir_version is null, get pir_version: " << pir_version;
   }
 
-  PatchBuilder builder(pir_version);
-
-  if (data.contains(BASE_CODE) && data[BASE_CODE].contains(MAGIC) &&
-      data[BASE_CODE][MAGIC] == PIR) {
-    uint64_t file_version =
-        data.at(BASE_CODE).at(PIRVERSION).template get<uint64_t>();
-    if (file_version != (uint64_t)pir_version) {
-      builder.SetFileVersion(file_version);
-      // Set max_version to the max version number of release pir plus 1.
-      auto max_version = RELEASE_VERSION + 1;
-      // If pir_version_ is not 0, we will build patch from file_version_ to
-      // pir_version_; If pir_version_ is 0, we will first build patch from
-      // file_version_ to max_version, and then add 0.yaml to the end.
-      auto version = pir_version == 0 ? max_version : pir_version;
-      VLOG(6) << "file_version: " << file_version
-              << ", pir_version: " << pir_version
-              << ", final_version: " << version;
-      builder.BuildPatch(version, max_version);
-    }
+  Json data;
+  Json* program_json = nullptr;
+  uint64_t file_version = 0;
+  bool trainable = false;
+  if (IsBinaryProgramFile(file_path)) {
+    std::ifstream f(file_path, std::ios::binary);
+    data = ReadBinaryProgram(&f, &file_version, &trainable);
+    program_json = &data;
   } else {
-    PADDLE_THROW(common::errors::InvalidArgument("Invalid model file."));
+    std::ifstream f(file_path);
+    data = Json::parse(f);
+    if (data.contains(BASE_CODE) && data[BASE_CODE].contains(MAGIC) &&
+        data[BASE_CODE][MAGIC] == PIR) {
+      file_version = data.at(BASE_CODE).at(PIRVERSION).template get<uint64_t>();
+      if (data[BASE_CODE].contains(TRAINABLE)) {
+        trainable = data[BASE_CODE][TRAINABLE].get<bool>();
+      }
+    } else {
+      PADDLE_THROW(common::errors::InvalidArgument("Invalid model file."));
+    }
+    program_json = &(data[PROGRAM]);
+  }
+
+  PatchBuilder builder(pir_version);
+  if (file_version != (uint64_t)pir_version) {
+    builder.SetFileVersion(file_version);
+    // Set max_version to the max version number of release pir plus 1.
+    auto max_version = RELEASE_VERSION + 1;
+    // If pir_version_ is not 0, we will build patch from file_version_ to
+    // pir_version_; If pir_version_ is 0, we will first build patch from
+    // file_version_ to max_version, and then add 0.yaml to the end.
+    auto version = pir_version == 0 ? max_version : pir_version;
+    VLOG(6) << "file_version: " << file_version
+            << ", pir_version: " << pir_version
+            << ", final_version: " << version;
+    builder.BuildPatch(version, max_version);
   }
 
   ProgramReader reader(pir_version);
-  reader.RecoverProgram(&(data[PROGRAM]), program, &builder);
+  reader.RecoverProgram(program_json, program, &builder);
 
-  if (data[BASE_CODE].contains(TRAINABLE)) {
-    return data[BASE_CODE][TRAINABLE].get<bool>();
-  } else {
-    return false;
-  }
+  return trainable;
 }
 
 }  // namespace pir
@@ -9,15 +9,33 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <memory>
 #include <numeric>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "glog/logging.h"
+#include "paddle/common/macros.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/pir/serialize_deserialize/include/interface.h"
 #include "paddle/phi/common/port.h"
+#include "paddle/phi/core/memory/malloc.h"
+#include "paddle/phi/core/memory/memcpy.h"
+#include "paddle/phi/core/tensor_utils.h"
 #include "paddle/phi/kernels/funcs/data_type_transform.h"
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_types.h"
+#endif
 
 namespace pir {
 
@@ -183,19 +201,272 @@ void LoadFunction(const std::string& file_path,
   }
 }
 
+#if !defined(_WIN32)
+namespace {
+
+// A private mapping of a parameter file. The pages are read from the file
+// when they are first touched, writes (e.g. of passes folding weights) go to
+// copies of the pages and never reach the file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& file_path) {
+    int fd = open(file_path.c_str(), O_RDONLY);
+    PADDLE_ENFORCE_GE(fd,
+                      0,
+                      common::errors::Unavailable(
+                          "Load operator fail to open file %s, please check "
+                          "whether the model file is complete or damaged.",
+                          file_path));
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      PADDLE_THROW(common::errors::Unavailable(
+          "Cannot get the size of the parameter file %s.", file_path));
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+      data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    PADDLE_ENFORCE_NE(data_,
+                      MAP_FAILED,
+                      common::errors::Unavailable(
+                          "Cannot map the parameter file %s into memory.",
+                          file_path));
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr && data_ != MAP_FAILED) {
+      munmap(data_, size_);
+    }
+  }
+
+  char* data() const { return static_cast<char*>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  void* data_{nullptr};
+  size_t size_{0};
+
+  DISABLE_COPY_AND_ASSIGN(MappedFile);
+};
+
+// Parameter memory inside a mapped file, the mapping lives as long as any
+// tensor still points into it.
+class MappedAllocation : public phi::Allocation {
+ public:
+  MappedAllocation(const std::shared_ptr<MappedFile>& file,
+                   char* ptr,
+                   size_t size)
+      : phi::Allocation(ptr, size, phi::CPUPlace()), file_(file) {}
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+};
+
+class MappedReader {
+ public:
+  MappedReader(const MappedFile& file, const std::string& file_path)
+      : file_(file), file_path_(file_path) {}
+
+  char* Take(size_t size) {
+    PADDLE_ENFORCE_LE(
+        size,
+        file_.size() - offset_,
+        common::errors::Unavailable(
+            "The parameter file %s ends before all tensors are loaded, please "
+            "check whether the model file is complete or damaged.",
+            file_path_));
+    char* ptr = file_.data() + offset_;
+    offset_ += size;
+    return ptr;
+  }
+
+  template <typename T>
+  T Read() {
+    T value;
+    std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  bool eof() const { return offset_ == file_.size(); }
+
+ private:
+  const MappedFile& file_;
+  const std::string& file_path_;
+  size_t offset_{0};
+};
+
+class PinnedStagingCopier;
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// Copies host memory to the device through two pinned buffers: while one
+// chunk is transferred, the next one is copied (and paged in from the file)
+// into the other buffer.
+class PinnedStagingCopier {
+ public:
+  explicit PinnedStagingCopier(const phi::GPUContext& dev_ctx)
+      : dev_ctx_(dev_ctx), gpu_place_(dev_ctx.GetPlace().GetDeviceId()) {
+    for (int i = 0; i < 2; ++i) {
+      buffers_[i] = paddle::memory::Alloc(phi::GPUPinnedPlace(), kChunkBytes);
+      PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventCreateWithFlags(
+          &events_[i], phi::gpuEventDisableTiming));
+    }
+  }
+
+  ~PinnedStagingCopier() {
+    for (int i = 0; i < 2; ++i) {
+      if (pending_[i]) {
+        PADDLE_WARN_GPU_SUCCESS(phi::gpuEventSynchronize(events_[i]));
+      }
+      PADDLE_WARN_GPU_SUCCESS(phi::gpuEventDestroy(events_[i]));
+    }
+  }
+
+  void Copy(void* dst, const char* src, size_t size) {
+    auto* dst_bytes = static_cast<char*>(dst);
+    for (size_t offset = 0; offset < size; offset += kChunkBytes) {
+      size_t bytes = std::min(kChunkBytes, size - offset);
+      if (pending_[next_]) {
+        PADDLE_ENFORCE_GPU_SUCCESS(phi::gpuEventSynchronize(events_[next_]));
+      }
+      void* buffer = buffers_[next_]->ptr();
+      std::memcpy(buffer, src + offset, bytes);
+      paddle::memory::Copy(gpu_place_,
+                           dst_bytes + offset,
+                           phi::GPUPinnedPlace(),
+                           buffer,
+                           bytes,
+                           dev_ctx_.stream());
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          phi::gpuEventRecord(events_[next_], dev_ctx_.stream()));
+      pending_[next_] = true;
+      next_ ^= 1;
+    }
+  }
+
+ private:
+  static constexpr size_t kChunkBytes = 16UL << 20;
+
+  const phi::GPUContext& dev_ctx_;
+  phi::GPUPlace gpu_place_;
+  phi::Allocator::AllocationPtr buffers_[2];
+  phi::gpuEvent_t events_[2];
+  bool pending_[2]{false, false};
+  int next_{0};
+
+  DISABLE_COPY_AND_ASSIGN(PinnedStagingCopier);
+};
+#endif
+
+// Reads a tensor in the layout of phi::SerializeToStream from the mapping.
+void DeserializeFromMappedFile(MappedReader* reader,
+                               const std::shared_ptr<MappedFile>& file,
+                               phi::DenseTensor* tensor,
+                               const phi::DeviceContext& dev_ctx,
+                               PinnedStagingCopier* copier) {
+  uint32_t version = reader->Read<uint32_t>();
+  PADDLE_ENFORCE_EQ(
+      version,
+      0U,
+      common::errors::InvalidArgument(
+          "Deserialize to tensor failed, maybe the loaded file is "
+          "not a paddle model(expected file format: 0, but %u found).",
+          version));
+  uint64_t lod_level = reader->Read<uint64_t>();
+  auto& lod = *tensor->mutable_lod();
+  lod.resize(lod_level);
+  for (uint64_t i = 0; i < lod_level; ++i) {
+    uint64_t size = reader->Read<uint64_t>();
+    lod[i].resize(size / sizeof(size_t));
+    std::memcpy(lod[i].data(), reader->Take(size), size);
+  }
+
+  uint32_t tensor_version = reader->Read<uint32_t>();
+  PADDLE_ENFORCE_EQ(
+      tensor_version,
+      0U,
+      common::errors::InvalidArgument(
+          "tensor version %u is not supported, Only version 0 is supported",
+          tensor_version));
+  int32_t desc_size = reader->Read<int32_t>();
+  PADDLE_ENFORCE_GE(desc_size,
+                    0,
+                    common::errors::InvalidArgument(
+                        "phi::DenseTensor desc size should >= 0"));
+  paddle::framework::proto::VarType::TensorDesc desc;
+  PADDLE_ENFORCE_EQ(
+      desc.ParseFromArray(reader->Take(desc_size), desc_size),
+      true,
+      common::errors::InvalidArgument("Cannot parse tensor desc"));
+
+  std::vector<int64_t> dims(desc.dims().begin(), desc.dims().end());
+  tensor->Resize(common::make_ddim(dims));
+  auto dtype = phi::TransToPhiDataType(desc.data_type());
+  size_t size = tensor->numel() * phi::SizeOf(dtype);
+  char* data = reader->Take(size);
+
+  auto place = dev_ctx.GetPlace();
+  if (phi::is_cpu_place(place)) {
+    if (reinterpret_cast<uintptr_t>(data) % phi::SizeOf(dtype) == 0) {
+      tensor->ResetHolderWithType(
+          std::make_shared<MappedAllocation>(file, data, size), dtype);
+    } else {
+      std::memcpy(dev_ctx.Alloc(tensor, dtype), data, size);
+    }
+  } else if (phi::is_gpu_place(place)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    copier->Copy(dev_ctx.Alloc(tensor, dtype), data, size);
+#else
+    PADDLE_THROW(common::errors::Unimplemented(
+        "CUDAPlace is not supported when not compiled with CUDA"));
+#endif
+  } else {
+    phi::DenseTensor cpu_tensor;
+    cpu_tensor.Resize(common::make_ddim(dims));
+    std::memcpy(cpu_tensor.mutable_data(phi::CPUPlace(), dtype), data, size);
+    phi::Copy(dev_ctx, cpu_tensor, place, true, tensor);
+  }
+}
+
+void LoadCombineFromMappedFile(const std::string& file_path,
+                               const std::vector<std::string>& names,
+                               std::vector<phi::DenseTensor*>* out,
+                               const phi::DeviceContext& dev_ctx) {
+  auto file = std::make_shared<MappedFile>(file_path);
+  MappedReader reader(*file, file_path);
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  // waits for the last transfers when it goes out of scope
+  std::unique_ptr<PinnedStagingCopier> copier;
+  if (phi::is_gpu_place(dev_ctx.GetPlace())) {
+    copier = std::make_unique<PinnedStagingCopier>(
+        static_cast<const phi::GPUContext&>(dev_ctx));
+  }
+  for (size_t i = 0; i < names.size(); i++) {
+    DeserializeFromMappedFile(
+        &reader, file, out->at(i), dev_ctx, copier.get());
+  }
+#else
+  for (size_t i = 0; i < names.size(); i++) {
+    DeserializeFromMappedFile(&reader, file, out->at(i), dev_ctx, nullptr);
+  }
+#endif
+  PADDLE_ENFORCE_EQ(reader.eof(),
+                    true,
+                    common::errors::Unavailable(
+                        "Not allowed to load partial data via "
+                        "load_combine_op, please use load_op instead."));
+}
+
+}  // namespace
+#endif
+
 void LoadCombineFunction(const std::string& file_path,
                          const std::vector<std::string>& names,
                          std::vector<phi::DenseTensor*>* out,
                          bool load_as_fp16,
-                         phi::Place place) {
-  std::ifstream fin(file_path, std::ios::binary);
-  PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
-                    true,
-                    common::errors::Unavailable(
-                        "Load operator fail to open file %s, please check "
-                        "whether the model file is complete or damaged.",
-                        file_path));
-
+                         phi::Place place,
+                         bool use_mmap) {
   PADDLE_ENFORCE_GT(out->size(),
                     0UL,
                     common::errors::InvalidArgument(
@@ -203,10 +474,38 @@ void LoadCombineFunction(const std::string& file_path,
                         "it to be greater than 0.",
                         out->size()));
   const phi::DeviceContext* dev_ctx = GetDeviceContext(*(out->at(0)), place);
+#if defined(_WIN32)
+  if (use_mmap) {
+    LOG(WARNING) << "Mapping the parameter file is not supported on Windows, "
+                 << file_path << " is read instead.";
+    use_mmap = false;
+  }
+#endif
+  if (use_mmap) {
+#if !defined(_WIN32)
+    LoadCombineFromMappedFile(file_path, names, out, *dev_ctx);
+#endif
+  } else {
+    std::ifstream fin(file_path, std::ios::binary);
+    PADDLE_ENFORCE_EQ(static_cast<bool>(fin),
+                      true,
+                      common::errors::Unavailable(
+                          "Load operator fail to open file %s, please check "
+                          "whether the model file is complete or damaged.",
+                          file_path));
+    for (size_t i = 0; i < names.size(); i++) {
+      phi::DeserializeFromStream(fin, out->at(i), *dev_ctx);
+    }
+    fin.peek();
+    PADDLE_ENFORCE_EQ(fin.eof(),
+                      true,
+                      common::errors::Unavailable(
+                          "Not allowed to load partial data via "
+                          "load_combine_op, please use load_op instead."));
+  }
+
   for (size_t i = 0; i < names.size(); i++) {
     auto tensor = out->at(i);
-    phi::DeserializeFromStream(fin, tensor, *dev_ctx);
-
     auto in_dtype = tensor->dtype();
     auto out_dtype = load_as_fp16 ? phi::DataType::FLOAT16 : in_dtype;
     if (in_dtype != out_dtype) {
@@ -214,12 +513,6 @@ void LoadCombineFunction(const std::string& file_path,
       *tensor = CastTensorType(dev_ctx, cast_in, out_dtype);
     }
   }
-  fin.peek();
-  PADDLE_ENFORCE_EQ(fin.eof(),
-                    true,
-                    common::errors::Unavailable(
-                        "Not allowed to load partial data via "
-                        "load_combine_op, please use load_op instead."));
 }
 
 }  // namespace pir
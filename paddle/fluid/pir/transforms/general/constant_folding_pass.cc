@@ -14,13 +14,20 @@
 
 #include "paddle/fluid/pir/transforms/general/constant_folding_pass.h"
 
+#include <xxhash.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "paddle/fluid/framework/new_executor/interpretercore.h"
 #include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
 #include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -31,9 +38,11 @@
 #include "paddle/fluid/pir/utils/general_functions.h"
 
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/framework/dense_tensor_serialize.h"
 
 #include "paddle/pir/include/core/builder.h"
 #include "paddle/pir/include/core/builtin_attribute.h"
@@ -51,6 +60,8 @@
 #include "paddle/pir/include/pattern_rewrite/pattern_match.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_rewrite_driver.h"
 
+COMMON_DECLARE_string(pir_constant_folding_cache_dir);
+
 namespace {
 
 class ConstantFoldingPattern : public pir::RewritePattern {
@@ -68,7 +79,8 @@ class ConstantFoldingPattern : public pir::RewritePattern {
         suffix_(suffix),
         place_(place),
         scope_(scope),
-        exe_config_(exe_config) {
+        exe_config_(exe_config),
+        cache_dir_(FLAGS_pir_constant_folding_cache_dir) {
     exe_config_->create_local_scope = false;
   }
 
@@ -282,9 +294,26 @@ class ConstantFoldingPattern : public pir::RewritePattern {
   std::vector<std::string> RunOp(
       pir::Operation* op,
       pir::PatternRewriter& rewriter) const {  // NOLINT
+    std::string cache_file;
+    if (!cache_dir_.empty()) {
+      std::string fingerprint = FoldingFingerprint(op);
+      if (!fingerprint.empty()) {
+        cache_file = cache_dir_ + "/" + fingerprint + ".pdfold";
+      }
+    }
+
     pir::Program new_program(rewriter.ir_context());
     auto output_var_names =
         BuildProgramFromOperation(op, &new_program, rewriter);
+    if (output_var_names.empty()) {
+      cache_file.clear();
+    }
+    if (!cache_file.empty() &&
+        LoadFoldedOutputs(cache_file, output_var_names)) {
+      VLOG(4) << "constant_folding_pass loads the results of [" << op->name()
+              << "] op from " << cache_file;
+      return output_var_names;
+    }
 
     // execute program
     for (const auto& output_var_name : output_var_names) {
@@ -302,9 +331,127 @@ class ConstantFoldingPattern : public pir::RewritePattern {
         place_, {}, kernel_program->block(), scope_, *exe_config_);
 
     core.Run({});
+    if (!cache_file.empty()) {
+      SaveFoldedOutputs(cache_file, output_var_names);
+    }
     return output_var_names;
   }
 
+  std::vector<pir::Value> FoldingInputs(pir::Operation* op) const {
+    std::vector<pir::Value> inputs;
+    for (uint32_t i = 0; i < op->num_operands(); i++) {
+      if (!op->operand_source(i)) {
+        continue;
+      }
+      auto* prev_op = pir::GetDefiningOpForInput(op, i);
+      if (prev_op->isa<pir::CombineOp>()) {
+        for (uint32_t j = 0; j < prev_op->num_operands(); j++) {
+          inputs.push_back(prev_op->operand_source(j));
+        }
+      } else {
+        inputs.push_back(op->operand_source(i));
+      }
+    }
+    return inputs;
+  }
+
+  // The key of the folding cache, made of the op, its attributes, its output
+  // types and the contents of its inputs. Returns empty if the inputs can
+  // not be hashed.
+  std::string FoldingFingerprint(pir::Operation* op) const {
+    std::ostringstream os;
+    os << op->name() << ";" << phi::AllocationTypeStr(place_.GetType()) << ";";
+    std::vector<std::string> attr_names;
+    for (auto& [name, _] : op->attributes()) {
+      // the call stack and the op id do not change the results
+      if (name != "op_callstack" && name != "origin_id") {
+        attr_names.push_back(name);
+      }
+    }
+    std::sort(attr_names.begin(), attr_names.end());
+    for (auto& name : attr_names) {
+      os << name << "=" << op->attribute(name) << ";";
+    }
+    for (uint32_t i = 0; i < op->num_results(); i++) {
+      os << op->result(i).type() << ";";
+    }
+    for (auto& input : FoldingInputs(op)) {
+      auto* var = scope_->FindVar(pir::GetParameterNameFromValue(input));
+      if (!var || !var->IsType<phi::DenseTensor>()) {
+        return "";
+      }
+      const auto& tensor = var->Get<phi::DenseTensor>();
+      if (!tensor.IsInitialized()) {
+        return "";
+      }
+      const phi::DenseTensor* cpu_tensor = &tensor;
+      phi::DenseTensor temp_tensor;
+      if (tensor.place().GetType() != phi::AllocationType::CPU) {
+        paddle::framework::TensorCopySync(
+            tensor, phi::CPUPlace{}, &temp_tensor);
+        cpu_tensor = &temp_tensor;
+      }
+      os << tensor.dtype() << tensor.dims() << ":"
+         << XXH64(cpu_tensor->data(),
+                  cpu_tensor->numel() * phi::SizeOf(cpu_tensor->dtype()),
+                  0)
+         << ";";
+    }
+    std::string desc = os.str();
+    std::ostringstream key;
+    key << std::hex << XXH64(desc.data(), desc.size(), 0);
+    return key.str();
+  }
+
+  bool LoadFoldedOutputs(const std::string& cache_file,
+                         const std::vector<std::string>& var_names) const {
+    std::ifstream fin(cache_file, std::ios::binary);
+    if (!fin) {
+      return false;
+    }
+    try {
+      uint32_t num_outputs = 0;
+      fin.read(reinterpret_cast<char*>(&num_outputs), sizeof(num_outputs));
+      if (!fin || num_outputs != var_names.size()) {
+        return false;
+      }
+      for (auto& var_name : var_names) {
+        auto* tensor = scope_->Var(var_name)->GetMutable<phi::DenseTensor>();
+        phi::DeserializeFromStream(fin, tensor);
+      }
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "Failed to load the constant folding cache "
+                   << cache_file << ": " << e.what();
+      return false;
+    }
+    return true;
+  }
+
+  void SaveFoldedOutputs(const std::string& cache_file,
+                         const std::vector<std::string>& var_names) const {
+    // written to a temporary file first, so that a concurrent reader never
+    // sees a partial file
+    std::string temp_file = cache_file + "." + var_names.front() + ".tmp";
+    {
+      std::ofstream fout(temp_file, std::ios::binary);
+      if (!fout) {
+        LOG(WARNING) << "Failed to open " << temp_file
+                     << " for the constant folding cache.";
+        return;
+      }
+      auto num_outputs = static_cast<uint32_t>(var_names.size());
+      fout.write(reinterpret_cast<const char*>(&num_outputs),
+                 sizeof(num_outputs));
+      for (auto& var_name : var_names) {
+        phi::SerializeToStream(
+            fout, scope_->FindVar(var_name)->Get<phi::DenseTensor>());
+      }
+    }
+    if (std::rename(temp_file.c_str(), cache_file.c_str()) != 0) {
+      std::remove(temp_file.c_str());
+    }
+  }
+
   template <typename Op>
   Op BuildParameterOrConstantTensorOP(
       uint32_t index,
@@ -421,6 +568,7 @@ class ConstantFoldingPattern : public pir::RewritePattern {
   phi::Place place_;
   paddle::framework::Scope* scope_;
   paddle::framework::interpreter::ExecutionConfig* exe_config_;
+  std::string cache_dir_;
   mutable std::vector<std::string> deleted_vars_;
 };
 
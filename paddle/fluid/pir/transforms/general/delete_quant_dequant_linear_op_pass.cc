@@ -121,6 +121,12 @@ class DeleteQuantDequantLinearOpPattern : public paddle::drr::DrrPatternBase {
 
       quant_analysis.scale_map[match_ctx.Tensor("x")] =
           std::vector<float>({input_scale});
+      quant_analysis.qmax_map[match_ctx.Tensor("x")] =
+          match_ctx.Tensor("quantize_linear_out")
+              .defining_op()
+              ->attribute("qmax")
+              .dyn_cast<pir::Int32Attribute>()
+              .data();
     });
 
     paddle::drr::ResultPattern res = pat.ResultPattern();
@@ -158,6 +158,8 @@ class DeleteWeightDequantLinearOpPattern : public paddle::drr::DrrPatternBase {
               common::errors::InvalidArgument(
                   "QuantAnalysis should be Preserved"));
           quant_analysis.scale_map[match_ctx.Tensor("weight")] = weight_scales;
+          quant_analysis.qmax_map[match_ctx.Tensor("weight")] =
+              op->attribute("qmax").dyn_cast<pir::Int32Attribute>().data();
 
           auto& int8_analysis = this->pass_state_.get()
                                     ->am.GetAnalysis<pir::pass::Int8Analysis>();
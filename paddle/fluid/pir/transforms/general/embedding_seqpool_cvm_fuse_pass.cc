@@ -0,0 +1,192 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/embedding_seqpool_cvm_fuse_pass.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_match.h"
+
+namespace {
+
+// embedding -> sequence_pool -> cvm of one slot
+struct SlotChain {
+  paddle::dialect::EmbeddingOp embedding;
+  paddle::dialect::SequencePoolOp seqpool;
+  paddle::dialect::CvmOp cvm;
+};
+
+// Fuses the embedding -> sequence_pool -> cvm chains of all the slots that
+// look up the same table and share the cvm input into one
+// fused_embedding_seqpool_cvm, which pools every sequence straight from the
+// table. The fused op is inserted before the first cvm of the slots, the
+// slots whose ids are defined after it are left for the next match.
+class EmbeddingSeqpoolCvmFusePattern
+    : public pir::OpRewritePattern<paddle::dialect::CvmOp> {
+ public:
+  using pir::OpRewritePattern<paddle::dialect::CvmOp>::OpRewritePattern;
+
+  bool MatchAndRewrite(
+      paddle::dialect::CvmOp op,
+      pir::PatternRewriter& rewriter) const override {  // NOLINT
+    SlotChain anchor;
+    if (!MatchChain(op, &anchor)) {
+      return false;
+    }
+    const pir::Value table = anchor.embedding.weight();
+    const pir::Value cvm = op.cvm();
+    const std::string pooltype = PoolType(anchor.seqpool);
+    const bool use_cvm = UseCvm(op);
+    const int64_t padding_idx = PaddingIdx(anchor.embedding);
+
+    // the positions of the ops in the block, to keep the slots whose ids
+    // are defined before the fused op
+    pir::Block* block = op->GetParent();
+    std::unordered_map<pir::Operation*, size_t> positions;
+    size_t position = 0;
+    for (auto& block_op : *block) {
+      positions[&block_op] = position++;
+    }
+    const size_t anchor_position = positions.at(op.operation());
+    // block arguments and values of the enclosing blocks are defined before
+    auto defined_before_anchor = [&](pir::Value value) {
+      pir::Operation* def = value.defining_op();
+      if (def == nullptr || def->GetParent() != block) {
+        return true;
+      }
+      return positions.at(def) < anchor_position;
+    };
+
+    std::vector<SlotChain> chains{anchor};
+    for (auto it = table.use_begin(); it != table.use_end(); ++it) {
+      auto embedding = it.owner()->dyn_cast<paddle::dialect::EmbeddingOp>();
+      if (!embedding ||
+          embedding.operation() == anchor.embedding.operation() ||
+          embedding->GetParent() != block || !embedding.out().HasOneUse()) {
+        continue;
+      }
+      auto cvm_op = NextCvm(embedding);
+      SlotChain chain;
+      if (!cvm_op || !MatchChain(cvm_op, &chain) ||
+          chain.embedding.operation() != embedding.operation() ||
+          cvm_op.cvm() != cvm ||
+          PoolType(chain.seqpool) != pooltype || UseCvm(cvm_op) != use_cvm ||
+          PaddingIdx(embedding) != padding_idx ||
+          positions.at(cvm_op.operation()) < anchor_position ||
+          !defined_before_anchor(embedding.x())) {
+        continue;
+      }
+      chains.push_back(chain);
+    }
+
+    std::vector<pir::Value> ids;
+    ids.reserve(chains.size());
+    for (const auto& chain : chains) {
+      ids.push_back(chain.embedding.x());
+    }
+    rewriter.SetInsertionPoint(op.operation());
+    auto combine_op = rewriter.Build<pir::CombineOp>(ids);
+    auto fused_op = rewriter.Build<paddle::dialect::FusedEmbeddingSeqpoolCvmOp>(
+        combine_op.out(), table, cvm, pooltype, use_cvm, padding_idx);
+    auto split_op = rewriter.Build<pir::SplitOp>(fused_op.result(0));
+    const auto outs = split_op.outputs();
+    for (size_t i = 0; i < chains.size(); ++i) {
+      rewriter.ReplaceAllUsesWith(chains[i].cvm.out(), outs[i]);
+    }
+    for (const auto& chain : chains) {
+      rewriter.EraseOp(chain.cvm.operation());
+      rewriter.EraseOp(chain.seqpool.operation());
+      rewriter.EraseOp(chain.embedding.operation());
+    }
+    return true;
+  }
+
+ private:
+  static std::string PoolType(paddle::dialect::SequencePoolOp op) {
+    return op->attribute<pir::StrAttribute>("pooltype").AsString();
+  }
+
+  static bool UseCvm(paddle::dialect::CvmOp op) {
+    return op->attribute<pir::BoolAttribute>("use_cvm").data();
+  }
+
+  static int64_t PaddingIdx(paddle::dialect::EmbeddingOp op) {
+    return op->attribute<pir::Int64Attribute>("padding_idx").data();
+  }
+
+  static paddle::dialect::CvmOp NextCvm(paddle::dialect::EmbeddingOp op) {
+    pir::Operation* user = op.out().first_use().owner();
+    auto seqpool = user->dyn_cast<paddle::dialect::SequencePoolOp>();
+    if (!seqpool || !seqpool.out().HasOneUse()) {
+      return paddle::dialect::CvmOp(nullptr);
+    }
+    user = seqpool.out().first_use().owner();
+    return user->dyn_cast<paddle::dialect::CvmOp>();
+  }
+
+  static bool MatchChain(paddle::dialect::CvmOp op, SlotChain* chain) {
+    auto seqpool = op.x().defining_op<paddle::dialect::SequencePoolOp>();
+    if (!seqpool || !seqpool.out().HasOneUse() ||
+        !seqpool.max_index().use_empty()) {
+      return false;
+    }
+    // an empty sequence pools to the pad value, the fused op pools it to 0
+    const std::string pooltype = PoolType(seqpool);
+    if ((pooltype != "SUM" && pooltype != "AVERAGE" && pooltype != "SQRT") ||
+        seqpool->attribute<pir::FloatAttribute>("pad_value").data() != 0.0f) {
+      return false;
+    }
+    auto embedding = seqpool.x().defining_op<paddle::dialect::EmbeddingOp>();
+    if (!embedding || !embedding.out().HasOneUse() ||
+        !embedding.weight().type().isa<paddle::dialect::DenseTensorType>()) {
+      return false;
+    }
+    chain->embedding = embedding;
+    chain->seqpool = seqpool;
+    chain->cvm = op;
+    return true;
+  }
+};
+
+class EmbeddingSeqpoolCvmFusePass : public pir::PatternRewritePass {
+ public:
+  EmbeddingSeqpoolCvmFusePass()
+      : pir::PatternRewritePass("embedding_seqpool_cvm_fuse_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext* context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add<EmbeddingSeqpoolCvmFusePattern>(context);
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateEmbeddingSeqpoolCvmFusePass() {
+  return std::make_unique<EmbeddingSeqpoolCvmFusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(embedding_seqpool_cvm_fuse_pass, EmbeddingSeqpoolCvmFusePass);
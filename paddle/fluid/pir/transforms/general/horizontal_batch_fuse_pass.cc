@@ -0,0 +1,412 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/horizontal_batch_fuse_pass.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+
+#include "paddle/pir/include/core/block.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+/**
+ * Batch the independent ops of the same kind and the same shape into one op.
+ *
+ * Graphs like multi-tower recommender models have many small parallel
+ * branches, and every branch launches its own tiny kernels:
+ *
+ *     x0   w0      x1   w1            xn   wn
+ *      \   /        \   /              \   /
+ *     matmul       matmul     ...     matmul
+ *       |            |                  |
+ *       y0           y1                 yn
+ *
+ * Stacking the operands along a new leading axis turns the branches into a
+ * single batched kernel:
+ *
+ *     stack(x0..xn)   stack(w0..wn)
+ *              \         /
+ *               matmul
+ *                 |
+ *              unstack
+ *             /   |    \
+ *            y0   y1 .. yn
+ *
+ * which is correct for elementwise ops whose operands have the same rank and
+ * for matmul whose operands have the same rank of at least 2. The stacks of
+ * parameters are folded by constant_folding_pass.
+ */
+
+namespace {
+
+// A group is batched only if it launches fewer kernels afterwards, i.e. one
+// stack per operand, the batched op and the unstack.
+constexpr size_t kExtraOpNum = 2;
+// Larger kernels are not bound by the launch overhead, and stacking their
+// operands costs more than it saves.
+constexpr int64_t kMaxBatchNumel = 65536;
+
+const std::unordered_set<std::string>& UnaryOps() {
+  static const std::unordered_set<std::string> ops = {
+      paddle::dialect::ReluOp::name(),
+      paddle::dialect::SigmoidOp::name(),
+      paddle::dialect::TanhOp::name(),
+      paddle::dialect::ExpOp::name(),
+      paddle::dialect::SiluOp::name(),
+      paddle::dialect::GeluOp::name(),
+      paddle::dialect::CastOp::name(),
+  };
+  return ops;
+}
+
+const std::unordered_set<std::string>& BinaryOps() {
+  static const std::unordered_set<std::string> ops = {
+      paddle::dialect::AddOp::name(),
+      paddle::dialect::SubtractOp::name(),
+      paddle::dialect::MultiplyOp::name(),
+      paddle::dialect::DivideOp::name(),
+      paddle::dialect::MaximumOp::name(),
+      paddle::dialect::MinimumOp::name(),
+      paddle::dialect::MatmulOp::name(),
+  };
+  return ops;
+}
+
+bool IsStaticDenseTensor(const pir::Value& value) {
+  if (!value || !value.type().isa<paddle::dialect::DenseTensorType>()) {
+    return false;
+  }
+  const auto& dims =
+      value.type().dyn_cast<paddle::dialect::DenseTensorType>().dims();
+  for (int i = 0; i < dims.size(); ++i) {
+    if (dims[i] < 0) return false;
+  }
+  return true;
+}
+
+int64_t Rank(const pir::Value& value) {
+  return value.type()
+      .dyn_cast<paddle::dialect::DenseTensorType>()
+      .dims()
+      .size();
+}
+
+bool CanBatch(pir::Operation* op) {
+  const std::string& name = op->name();
+  const bool is_unary = UnaryOps().count(name) > 0;
+  const bool is_binary = BinaryOps().count(name) > 0;
+  if (!is_unary && !is_binary) return false;
+  if (op->num_regions() > 0 || op->num_results() != 1) return false;
+  if (op->num_operands() != (is_unary ? 1 : 2)) return false;
+  for (const auto& operand : op->operands_source()) {
+    if (!IsStaticDenseTensor(operand)) return false;
+  }
+  if (!IsStaticDenseTensor(op->result(0))) return false;
+  if (common::product(op->result(0)
+                          .type()
+                          .dyn_cast<paddle::dialect::DenseTensorType>()
+                          .dims()) > kMaxBatchNumel) {
+    return false;
+  }
+  if (is_binary) {
+    // stacking does not keep the broadcast of operands of different ranks
+    if (Rank(op->operand_source(0)) != Rank(op->operand_source(1))) {
+      return false;
+    }
+    if (name == paddle::dialect::MatmulOp::name() &&
+        Rank(op->operand_source(0)) < 2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t HashOp(pir::Operation* op) {
+  size_t seed = std::hash<std::string>()(op->name());
+  for (const auto& operand : op->operands_source()) {
+    seed ^= std::hash<pir::Type>()(operand.type()) + 0x9e3779b9 +
+            (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+bool IsSameKind(pir::Operation* lhs, pir::Operation* rhs) {
+  if (lhs->info() != rhs->info() ||
+      lhs->num_operands() != rhs->num_operands()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < lhs->num_operands(); ++i) {
+    if (lhs->operand_source(i).type() != rhs->operand_source(i).type()) {
+      return false;
+    }
+  }
+  return lhs->attributes() == rhs->attributes();
+}
+
+using PositionMap = std::unordered_map<pir::Operation*, int64_t>;
+
+PositionMap GetPositions(pir::Block* block) {
+  PositionMap positions;
+  int64_t pos = 0;
+  for (auto& op : *block) {
+    positions[&op] = pos++;
+  }
+  return positions;
+}
+
+// The op of the block that defines the value, nullptr for the values defined
+// outside of the block.
+pir::Operation* DefiningOpInBlock(const pir::Value& value, pir::Block* block) {
+  pir::Operation* op = value.defining_op();
+  return op && op->GetParent() == block ? op : nullptr;
+}
+
+struct OpGroup {
+  std::vector<pir::Operation*> ops;
+  // The position of the last op that defines an operand of the group, and of
+  // the first op that uses a result of the group. The batched op is inserted
+  // between them.
+  int64_t last_def_pos;
+  int64_t first_use_pos;
+};
+
+int64_t LastDefPos(pir::Operation* op,
+                   pir::Block* block,
+                   const PositionMap& positions) {
+  int64_t last_def = -1;
+  for (const auto& operand : op->operands_source()) {
+    if (auto* def_op = DefiningOpInBlock(operand, block)) {
+      last_def = std::max(last_def, positions.at(def_op));
+    }
+  }
+  return last_def;
+}
+
+int64_t FirstUsePos(pir::Operation* op,
+                    pir::Block* block,
+                    const PositionMap& positions) {
+  int64_t first_use = std::numeric_limits<int64_t>::max();
+  for (auto it = op->result(0).use_begin(); it != op->result(0).use_end();
+       ++it) {
+    pir::Operation* user = it.owner();
+    // the user may live in a sub block of an op of this block
+    while (user && user->GetParent() != block) {
+      user = user->GetParentOp();
+    }
+    if (!user) return -1;
+    first_use = std::min(first_use, positions.at(user));
+  }
+  return first_use;
+}
+
+// Whether op can join the group. The ops of a group must not depend on each
+// other, which holds if no op uses the result of another one directly, and
+// every operand is defined before every result is used. The latter also
+// leaves room to insert the batched op.
+bool CanJoin(const OpGroup& group,
+             pir::Operation* op,
+             int64_t last_def_pos,
+             int64_t first_use_pos) {
+  if (std::max(group.last_def_pos, last_def_pos) >=
+      std::min(group.first_use_pos, first_use_pos)) {
+    return false;
+  }
+  for (const auto& operand : op->operands_source()) {
+    if (std::find(group.ops.begin(),
+                  group.ops.end(),
+                  operand.defining_op()) != group.ops.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class HorizontalBatchFuser {
+ public:
+  explicit HorizontalBatchFuser(pir::IrContext* ctx) : ctx_(ctx) {}
+
+  int64_t Run(pir::Block* block) {
+    int64_t num_batched = 0;
+    for (auto& op : *block) {
+      for (size_t i = 0; i < op.num_regions(); ++i) {
+        for (auto& inner_block : op.region(i)) {
+          num_batched += Run(&inner_block);
+        }
+      }
+    }
+
+    const PositionMap positions = GetPositions(block);
+    std::unordered_map<size_t, std::vector<OpGroup>> open_groups;
+    std::vector<OpGroup> groups;
+    for (auto& op : *block) {
+      if (!CanBatch(&op)) continue;
+      const int64_t last_def = LastDefPos(&op, block, positions);
+      const int64_t first_use = FirstUsePos(&op, block, positions);
+      auto& candidates = open_groups[HashOp(&op)];
+      auto it = std::find_if(
+          candidates.begin(), candidates.end(), [&](const OpGroup& group) {
+            return IsSameKind(group.ops.front(), &op);
+          });
+      if (it == candidates.end()) {
+        candidates.push_back(OpGroup{{&op}, last_def, first_use});
+      } else if (CanJoin(*it, &op, last_def, first_use)) {
+        it->ops.push_back(&op);
+        it->last_def_pos = std::max(it->last_def_pos, last_def);
+        it->first_use_pos = std::min(it->first_use_pos, first_use);
+      } else {
+        groups.push_back(std::move(*it));
+        *it = OpGroup{{&op}, last_def, first_use};
+      }
+    }
+    for (auto& [_, candidates] : open_groups) {
+      for (auto& group : candidates) {
+        groups.push_back(std::move(group));
+      }
+    }
+    std::sort(groups.begin(),
+              groups.end(),
+              [&](const OpGroup& lhs, const OpGroup& rhs) {
+                return positions.at(lhs.ops.front()) <
+                       positions.at(rhs.ops.front());
+              });
+
+    for (const auto& group : groups) {
+      const size_t num_operands = group.ops.front()->num_operands();
+      if (group.ops.size() <= num_operands + kExtraOpNum) continue;
+      if (Batch(group.ops, block)) {
+        num_batched += static_cast<int64_t>(group.ops.size());
+      }
+    }
+    return num_batched;
+  }
+
+ private:
+  bool Batch(const std::vector<pir::Operation*>& ops, pir::Block* block) {
+    // The earlier batches moved the operands and users of the group, check
+    // the group again on the current block.
+    const PositionMap positions = GetPositions(block);
+    int64_t last_def = -1;
+    int64_t first_use = std::numeric_limits<int64_t>::max();
+    for (auto* op : ops) {
+      last_def = std::max(last_def, LastDefPos(op, block, positions));
+      first_use = std::min(first_use, FirstUsePos(op, block, positions));
+    }
+    if (last_def >= first_use) return false;
+
+    pir::Builder builder(ctx_, block);
+    if (last_def < 0) {
+      builder.set_insertion_point(block, block->begin());
+    } else {
+      for (auto& op : *block) {
+        if (positions.at(&op) == last_def) {
+          builder.SetInsertionPointAfter(&op);
+          break;
+        }
+      }
+    }
+
+    pir::Operation* example_op = ops.front();
+    const int64_t batch_size = static_cast<int64_t>(ops.size());
+    std::vector<pir::Value> stacked_operands;
+    for (uint32_t i = 0; i < example_op->num_operands(); ++i) {
+      std::vector<pir::Value> operands;
+      for (auto* op : ops) {
+        operands.push_back(op->operand_source(i));
+      }
+      auto combined = builder.Build<pir::CombineOp>(operands).out();
+      stacked_operands.push_back(
+          builder.Build<paddle::dialect::StackOp>(combined, 0).result(0));
+    }
+
+    auto result_type = example_op->result(0)
+                           .type()
+                           .dyn_cast<paddle::dialect::DenseTensorType>();
+    std::vector<int64_t> batched_dims{batch_size};
+    for (int i = 0; i < result_type.dims().size(); ++i) {
+      batched_dims.push_back(result_type.dims()[i]);
+    }
+    auto batched_type =
+        paddle::dialect::DenseTensorType::get(ctx_,
+                                              result_type.dtype(),
+                                              common::make_ddim(batched_dims),
+                                              result_type.data_layout(),
+                                              result_type.lod(),
+                                              result_type.offset());
+    pir::Operation* batched_op = builder.Build(stacked_operands,
+                                               example_op->attributes(),
+                                               {batched_type},
+                                               example_op->info());
+
+    auto unstacked = builder.Build<paddle::dialect::UnstackOp>(
+        batched_op->result(0), 0, static_cast<int>(batch_size));
+    auto outs = builder.Build<pir::SplitOp>(unstacked.result(0)).outputs();
+    for (size_t i = 0; i < ops.size(); ++i) {
+      ops[i]->result(0).ReplaceAllUsesWith(outs[i]);
+    }
+    for (auto* op : ops) {
+      op->Erase();
+    }
+    VLOG(4) << "horizontal_batch_fuse_pass batched " << batch_size << " ["
+            << batched_op->name() << "] ops";
+    return true;
+  }
+
+  pir::IrContext* ctx_;
+};
+
+class HorizontalBatchFusePass : public pir::Pass {
+ public:
+  HorizontalBatchFusePass() : pir::Pass("horizontal_batch_fuse_pass", 2) {}
+
+  void Run(pir::Operation* op) override {
+    HorizontalBatchFuser fuser(pir::IrContext::Instance());
+    int64_t num_batched = 0;
+    for (size_t i = 0; i < op->num_regions(); ++i) {
+      for (auto& block : op->region(i)) {
+        num_batched += fuser.Run(&block);
+      }
+    }
+    AddStatistics(num_batched);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    return op->isa<pir::ModuleOp>() && op->num_regions() > 0;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateHorizontalBatchFusePass() {
+  return std::make_unique<HorizontalBatchFusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(horizontal_batch_fuse_pass, HorizontalBatchFusePass);
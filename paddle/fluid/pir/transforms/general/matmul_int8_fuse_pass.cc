@@ -0,0 +1,211 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/matmul_int8_fuse_pass.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/utils/analysis_info.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+constexpr float kQuantMaxBound = 127.0f;
+
+// Replaces the matmul ops of a quantized model whose weight is a parameter
+// with fused_int8_matmul, using the scales delete_quant_dequant_linear_op_pass
+// and delete_weight_dequant_linear_op_pass left in QuantAnalysis. The weights
+// are converted to int8 in the scope, the activations are quantized by the
+// kernel.
+class MatmulInt8FusePass : public pir::Pass {
+ public:
+  MatmulInt8FusePass() : pir::Pass("matmul_int8_fuse_pass", 1) {}
+
+  bool Initialize(pir::IrContext* context) override {
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kPlaceAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulInt8FusePass, place attribute is required!"
+            "Use Set method to set the place attribute."));
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kParamScopeAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulInt8FusePass, scope attribute is required!"
+            "Use Set method to set the scope attribute."));
+
+    place_ = Get<phi::Place>(pir::Pass::kPlaceAttr);
+    scope_ = &Get<paddle::framework::Scope>(pir::Pass::kParamScopeAttr);
+    return true;
+  }
+
+  void Run(pir::Operation* op) override {
+    auto module_op = op->dyn_cast<pir::ModuleOp>();
+    PADDLE_ENFORCE_NOT_NULL(
+        module_op,
+        common::errors::PreconditionNotMet(
+            "matmul_int8_fuse_pass should run on module op."));
+    PADDLE_ENFORCE_EQ(
+        pass_state().has_value(),
+        true,
+        common::errors::InvalidArgument("pass state has no value"));
+    auto& quant_analysis =
+        pass_state()->am.GetAnalysis<pir::pass::QuantAnalysis>();
+    pass_state()->preserved_analyses.Preserve<pir::pass::QuantAnalysis>();
+    const auto& scale_map = quant_analysis.scale_map;
+
+    std::vector<pir::Operation*> matmul_ops;
+    for (auto& inner_op : module_op.block()) {
+      if (inner_op.isa<paddle::dialect::MatmulOp>()) {
+        matmul_ops.push_back(&inner_op);
+      }
+    }
+
+    pir::IrContext* ctx = pir::IrContext::Instance();
+    pir::Builder builder(ctx, &module_op.block());
+    int64_t fused_count = 0;
+    for (auto* matmul_op : matmul_ops) {
+      if (matmul_op->attribute<pir::BoolAttribute>("transpose_x").data() ||
+          matmul_op->attribute<pir::BoolAttribute>("transpose_y").data()) {
+        continue;
+      }
+      pir::Value x = matmul_op->operand_source(0);
+      pir::Value weight = matmul_op->operand_source(1);
+      auto x_scale = scale_map.find(x);
+      auto weight_scale = scale_map.find(weight);
+      if (x_scale == scale_map.end() || x_scale->second.size() != 1 ||
+          x_scale->second[0] <= 0.0f || weight_scale == scale_map.end()) {
+        continue;
+      }
+      // the scales of fp8 quantized models are left to matmul_fp8_fuse_pass
+      auto x_qmax = quant_analysis.qmax_map.find(x);
+      if (x_qmax != quant_analysis.qmax_map.end() &&
+          x_qmax->second != static_cast<int>(kQuantMaxBound)) {
+        continue;
+      }
+      auto x_type = x.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      if (!x_type || !x_type.dtype().isa<pir::Float32Type>()) {
+        continue;
+      }
+      // the weight is converted in place, so it may not be shared
+      auto parameter_op = weight.defining_op<pir::ParameterOp>();
+      if (!parameter_op || weight.use_count() != 1) {
+        continue;
+      }
+      auto weight_type =
+          weight.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      if (!weight_type || weight_type.dims().size() != 2) {
+        continue;
+      }
+      const int64_t n = weight_type.dims()[1];
+      const std::vector<float>& scales = weight_scale->second;
+      if (scales.size() != 1 && static_cast<int64_t>(scales.size()) != n) {
+        continue;
+      }
+      if (!ConvertWeightToInt8(parameter_op.param_name(), weight_type, ctx)) {
+        continue;
+      }
+      weight.set_type(paddle::dialect::DenseTensorType::get(
+          ctx,
+          pir::Int8Type::get(ctx),
+          weight_type.dims(),
+          weight_type.data_layout(),
+          weight_type.lod(),
+          weight_type.offset()));
+
+      builder.SetInsertionPointAfter(matmul_op);
+      auto fused_op = builder.Build<paddle::dialect::FusedInt8MatmulOp>(
+          x, weight, scales, x_scale->second[0], kQuantMaxBound);
+      matmul_op->result(0).ReplaceAllUsesWith(fused_op.result(0));
+      matmul_op->Erase();
+      ++fused_count;
+    }
+    AddStatistics(fused_count);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    PADDLE_ENFORCE_NOT_NULL(
+        scope_, common::errors::InvalidArgument("scope can not be nullptr"));
+    return phi::is_cpu_place(place_) && op->isa<::pir::ModuleOp>() &&
+           op->num_regions() > 0;
+  }
+
+ private:
+  // The weights of a quantized model hold the integer values in float32
+  // after the dequantize op is deleted, or are already int8.
+  bool ConvertWeightToInt8(const std::string& name,
+                           paddle::dialect::DenseTensorType weight_type,
+                           pir::IrContext* ctx) {
+    if (weight_type.dtype().isa<pir::Int8Type>()) {
+      return true;
+    }
+    if (!weight_type.dtype().isa<pir::Float32Type>()) {
+      return false;
+    }
+    auto* var = scope_->FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    auto* tensor = var->GetMutable<phi::DenseTensor>();
+    if (tensor->dtype() != phi::DataType::FLOAT32 ||
+        !phi::is_cpu_place(tensor->place())) {
+      return false;
+    }
+    phi::DenseTensor int8_tensor;
+    int8_tensor.Resize(tensor->dims());
+    const float* src = tensor->data<float>();
+    int8_t* dst = int8_tensor.mutable_data<int8_t>(phi::CPUPlace());
+    for (int64_t i = 0; i < tensor->numel(); ++i) {
+      const float value = std::nearbyint(src[i]);
+      dst[i] = static_cast<int8_t>(
+          std::min(std::max(value, -kQuantMaxBound), kQuantMaxBound));
+    }
+    tensor->ShareDataWith(int8_tensor);
+    return true;
+  }
+
+  phi::Place place_{phi::CPUPlace{}};
+  paddle::framework::Scope* scope_{nullptr};
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<pir::Pass> CreateMatmulInt8FusePass() {
+  return std::make_unique<MatmulInt8FusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(matmul_int8_fuse_pass, MatmulInt8FusePass);
@@ -0,0 +1,132 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/general/weight_prepack_pass.h"
+
+#include <string>
+#include <unordered_set>
+
+#include "paddle/common/errors.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight.h"
+
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+// Packs the parameters used as the weight of fc and matmul for the packed
+// GEMM of MKL while the program is optimized, so the CPU kernels find them
+// packed in PackedWeightCache instead of packing them on every run. The
+// program itself is not changed.
+class WeightPrepackPass : public pir::Pass {
+ public:
+  WeightPrepackPass() : pir::Pass("weight_prepack_pass", 1) {}
+
+  bool Initialize(pir::IrContext* context) override {
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kPlaceAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using WeightPrepackPass, place attribute is required!"
+            "Use Set method to set the place attribute."));
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kParamScopeAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using WeightPrepackPass, scope attribute is required!"
+            "Use Set method to set the scope attribute."));
+
+    place_ = Get<phi::Place>(pir::Pass::kPlaceAttr);
+    scope_ = &Get<paddle::framework::Scope>(pir::Pass::kParamScopeAttr);
+    return true;
+  }
+
+  void Run(pir::Operation* op) override {
+    auto module_op = op->dyn_cast<pir::ModuleOp>();
+    PADDLE_ENFORCE_NOT_NULL(
+        module_op,
+        common::errors::PreconditionNotMet(
+            "weight_prepack_pass should run on module op."));
+    std::unordered_set<std::string> packed;
+    for (auto& inner_op : module_op.block()) {
+      pir::Value weight;
+      if (inner_op.isa<paddle::dialect::FcOp>()) {
+        if (inner_op.attribute<pir::BoolAttribute>("padding_weights").data()) {
+          continue;
+        }
+        weight = inner_op.operand_source(1);
+      } else if (inner_op.isa<paddle::dialect::MatmulOp>()) {
+        if (inner_op.attribute<pir::BoolAttribute>("transpose_y").data()) {
+          continue;
+        }
+        weight = inner_op.operand_source(1);
+      } else {
+        continue;
+      }
+      auto parameter_op = weight.defining_op<pir::ParameterOp>();
+      if (!parameter_op) {
+        continue;
+      }
+      const std::string name = parameter_op.param_name();
+      if (packed.count(name)) {
+        continue;
+      }
+      auto* var = scope_->FindVar(name);
+      if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+        continue;
+      }
+      if (phi::funcs::PackedWeightCache::Instance().Pack(
+              var->Get<phi::DenseTensor>())) {
+        packed.insert(name);
+      }
+    }
+    AddStatistics(static_cast<int64_t>(packed.size()));
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+#ifdef PADDLE_WITH_MKLML
+    PADDLE_ENFORCE_NOT_NULL(
+        scope_, common::errors::InvalidArgument("scope can not be nullptr"));
+    return phi::is_cpu_place(place_) && op->isa<::pir::ModuleOp>() &&
+           op->num_regions() > 0;
+#else
+    return false;
+#endif
+  }
+
+ private:
+  phi::Place place_{phi::CPUPlace{}};
+  paddle::framework::Scope* scope_{nullptr};
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<pir::Pass> CreateWeightPrepackPass() {
+  return std::make_unique<WeightPrepackPass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(weight_prepack_pass, WeightPrepackPass);
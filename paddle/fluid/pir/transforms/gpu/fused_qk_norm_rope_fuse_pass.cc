@@ -0,0 +1,166 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/gpu/fused_qk_norm_rope_fuse_pass.h"
+
+#include <string>
+
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/drr/include/drr_pattern_base.h"
+
+#include "paddle/fluid/pir/utils/general_functions.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/value.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+namespace {
+
+// q       w_q    k       w_k
+//  \      /       \      /
+//  rms_norm       rms_norm
+//       \           /
+//  fused_rotary_position_embedding(sin, cos, position_ids)
+//
+// ->
+//
+// fused_qk_norm_rope(q, k, w_q, w_k, sin, cos, position_ids)
+class FusedQkNormRopePattern : public paddle::drr::DrrPatternBase {
+ private:
+  const bool with_position_ids_;
+
+ public:
+  explicit FusedQkNormRopePattern(bool with_position_ids)
+      : with_position_ids_(with_position_ids) {}
+
+  std::string name() const override { return "FusedQkNormRopePattern"; }
+
+  uint32_t benefit() const override { return with_position_ids_ ? 2 : 1; }
+
+  void operator()(paddle::drr::DrrPatternContext *ctx) const override {
+    paddle::drr::SourcePattern pat = ctx->SourcePattern();
+    const auto &q_rms_norm =
+        pat.Op(paddle::dialect::RmsNormOp::name(),
+               {{"epsilon", pat.Attr("q_epsilon")},
+                {"begin_norm_axis", pat.Attr("q_begin_norm_axis")},
+                {"quant_scale", pat.Attr("q_quant_scale")}});
+    const auto &k_rms_norm =
+        pat.Op(paddle::dialect::RmsNormOp::name(),
+               {{"epsilon", pat.Attr("k_epsilon")},
+                {"begin_norm_axis", pat.Attr("k_begin_norm_axis")},
+                {"quant_scale", pat.Attr("k_quant_scale")}});
+    const auto &rope =
+        pat.Op(paddle::dialect::FusedRotaryPositionEmbeddingOp::name(),
+               {{"use_neox_rotary_style", pat.Attr("use_neox_rotary_style")},
+                {"time_major", pat.Attr("time_major")}});
+
+    q_rms_norm({&pat.Tensor("q"),
+                &pat.InputNoneTensor(),
+                &pat.InputNoneTensor(),
+                &pat.Tensor("q_norm_weight"),
+                &pat.InputNoneTensor()},
+               {&pat.Tensor("q_norm_out"),
+                &pat.Tensor("q_residual_out"),
+                &pat.Tensor("q_inv_var")});
+    k_rms_norm({&pat.Tensor("k"),
+                &pat.InputNoneTensor(),
+                &pat.InputNoneTensor(),
+                &pat.Tensor("k_norm_weight"),
+                &pat.InputNoneTensor()},
+               {&pat.Tensor("k_norm_out"),
+                &pat.Tensor("k_residual_out"),
+                &pat.Tensor("k_inv_var")});
+    rope({&pat.Tensor("q_norm_out"),
+          &pat.Tensor("k_norm_out"),
+          &pat.InputNoneTensor(),
+          &pat.Tensor("sin"),
+          &pat.Tensor("cos"),
+          with_position_ids_ ? &pat.Tensor("position_ids")
+                             : &pat.InputNoneTensor()},
+         {&pat.Tensor("out_q"), &pat.Tensor("out_k"), &pat.OutputNoneTensor()});
+
+    pat.AddConstraint([](const paddle::drr::MatchContext &match_ctx) {
+      if (match_ctx.Attr<bool>("time_major")) {
+        return false;
+      }
+      if (match_ctx.Attr<float>("q_epsilon") !=
+          match_ctx.Attr<float>("k_epsilon")) {
+        return false;
+      }
+      // The quantized output of rms_norm is not rotated.
+      if (match_ctx.Attr<float>("q_quant_scale") > 0.0f ||
+          match_ctx.Attr<float>("k_quant_scale") > 0.0f) {
+        return false;
+      }
+      auto q_shape = pir::GetShapeFromValue(match_ctx.Tensor("q"));
+      auto k_shape = pir::GetShapeFromValue(match_ctx.Tensor("k"));
+      if (q_shape.size() != 4 || k_shape.size() != 4) {
+        return false;
+      }
+      // Every head is normalized over head_dim.
+      if (match_ctx.Attr<int>("q_begin_norm_axis") != 3 ||
+          match_ctx.Attr<int>("k_begin_norm_axis") != 3) {
+        return false;
+      }
+      auto q_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("q"));
+      for (const auto &name :
+           {"k", "q_norm_weight", "k_norm_weight", "sin", "cos"}) {
+        if (pir::GetDataTypeFromValue(match_ctx.Tensor(name)) != q_dtype) {
+          return false;
+        }
+      }
+      return true;
+    });
+
+    paddle::drr::ResultPattern res = pat.ResultPattern();
+    const auto &fused_qk_norm_rope =
+        res.Op(paddle::dialect::FusedQkNormRopeOp::name(),
+               {{"epsilon", pat.Attr("q_epsilon")},
+                {"use_neox_rotary_style", pat.Attr("use_neox_rotary_style")}});
+    fused_qk_norm_rope({&res.Tensor("q"),
+                        &res.Tensor("k"),
+                        &res.Tensor("q_norm_weight"),
+                        &res.Tensor("k_norm_weight"),
+                        &res.Tensor("sin"),
+                        &res.Tensor("cos"),
+                        with_position_ids_ ? &res.Tensor("position_ids")
+                                           : &res.InputNoneTensor()},
+                       {&res.Tensor("out_q"), &res.Tensor("out_k")});
+  }
+};
+
+class FusedQkNormRopeFusePass : public pir::PatternRewritePass {
+ public:
+  FusedQkNormRopeFusePass()
+      : pir::PatternRewritePass("fused_qk_norm_rope_fuse_pass", 2) {}
+
+  pir::RewritePatternSet InitializePatterns(pir::IrContext *context) override {
+    pir::RewritePatternSet ps(context);
+    ps.Add(paddle::drr::Create<FusedQkNormRopePattern>(context, true));
+    ps.Add(paddle::drr::Create<FusedQkNormRopePattern>(context, false));
+    return ps;
+  }
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<Pass> CreateFusedQkNormRopeFusePass() {
+  return std::make_unique<FusedQkNormRopeFusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(fused_qk_norm_rope_fuse_pass, FusedQkNormRopeFusePass);
@@ -41,14 +41,17 @@ class FusedWeightOnlyLinearWithBiasPattern
  private:
   bool reverse_add_;
   std::string algo_;
+  int group_size_;
   int sm_version_;
 
  public:
   FusedWeightOnlyLinearWithBiasPattern(bool reverse_add,
                                        std::string algo,
+                                       int group_size,
                                        int sm_version)
       : reverse_add_(reverse_add),
         algo_(std::move(algo)),
+        group_size_(group_size),
         sm_version_(sm_version) {}
 
   std::string name() const override {
@@ -76,7 +79,7 @@ class FusedWeightOnlyLinearWithBiasPattern
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    src.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -99,6 +102,8 @@ class FusedWeightOnlyLinearWithBiasPattern
       }
 
       if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
+      // every group of input channels shares a scale
+      if (group_size_ > 0 && w_dims.at(0) % group_size_ != 0) return false;
       if (x_dims.at(x_dims.size() - 1) != w_dims.at(0)) return false;
 
       return true;
@@ -119,7 +124,7 @@ class FusedWeightOnlyLinearWithBiasPattern
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
       weight_quantize({&res.Tensor("w_cpu")},
                       {&res.Tensor("quanted_weight_tensor_cpu"),
                        &res.Tensor("weight_scale_tensor_cpu")});
@@ -139,7 +144,7 @@ class FusedWeightOnlyLinearWithBiasPattern
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
 
       weight_quantize({&res.Tensor("w")},
                       {&res.Tensor("quanted_weight_tensor"),
@@ -151,7 +156,7 @@ class FusedWeightOnlyLinearWithBiasPattern
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
                         &res.Tensor("bias"),
@@ -163,11 +168,16 @@ class FusedWeightOnlyLinearWithBiasPattern
 class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
  private:
   std::string algo_;
+  int group_size_;
   int sm_version_;
 
  public:
-  FusedWeightOnlyLinearNoBiasPattern(std::string algo, int sm_version)
-      : algo_(std::move(algo)), sm_version_(sm_version) {}
+  FusedWeightOnlyLinearNoBiasPattern(std::string algo,
+                                     int group_size,
+                                     int sm_version)
+      : algo_(std::move(algo)),
+        group_size_(group_size),
+        sm_version_(sm_version) {}
 
  public:
   std::string name() const override {
@@ -190,7 +200,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
     //
     // Constraints.
     //
-    src.AddConstraint([](const paddle::drr::MatchContext &match_ctx) -> bool {
+    src.AddConstraint([this](const paddle::drr::MatchContext &match_ctx) {
       if (!pir::ValueIsPersistable(match_ctx.Tensor("w"))) {
         return false;
       }
@@ -205,6 +215,8 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
       }
 
       if (w_dims.at(0) % 64 != 0 || w_dims.at(1) % 16 != 0) return false;
+      // every group of input channels shares a scale
+      if (group_size_ > 0 && w_dims.at(0) % group_size_ != 0) return false;
 
       auto w_dtype = pir::GetDataTypeFromValue(match_ctx.Tensor("w"));
       if (!w_dtype.isa<pir::Float16Type>() && !w_dtype.isa<pir::BFloat16Type>())
@@ -230,7 +242,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
       weight_quantize({&res.Tensor("w_cpu")},
                       {&res.Tensor("quanted_weight_tensor_cpu"),
                        &res.Tensor("weight_scale_tensor_cpu")});
@@ -250,7 +262,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
           res.Op(paddle::dialect::WeightQuantizeOp::name(),
                  {{"algo", res.StrAttr(algo_)},
                   {"arch", res.Int32Attr(sm_version_)},
-                  {"group_size", res.Int32Attr(-1)}});
+                  {"group_size", res.Int32Attr(group_size_)}});
 
       weight_quantize({&res.Tensor("w")},
                       {&res.Tensor("quanted_weight_tensor"),
@@ -261,7 +273,7 @@ class FusedWeightOnlyLinearNoBiasPattern : public paddle::drr::DrrPatternBase {
                {{"weight_dtype",
                  res.StrAttr(algo_ == "weight_only_int8" ? "int8" : "int4")},
                 {"arch", res.Int32Attr(sm_version_)},
-                {"group_size", res.Int32Attr(-1)}});
+                {"group_size", res.Int32Attr(group_size_)}});
     weight_only_linear({&res.Tensor("x"),
                         &res.Tensor("quanted_weight_tensor"),
                         &res.InputNoneTensor(),
@@ -288,13 +300,25 @@ class FusedWeightOnlyLinearPass : public pir::PatternRewritePass {
                           "weight_only_int8 or weight_only_int4, but get %s.",
                           algo));
 
+    int group_size = -1;
+    if (Has("weight_only_group_size")) {
+      group_size = Get<int>("weight_only_group_size");
+    }
+    PADDLE_ENFORCE_EQ(
+        group_size == -1 || group_size == 64 || group_size == 128,
+        true,
+        common::errors::InvalidArgument(
+            "fused_weight_only_linear_pass only support group_size -1 "
+            "(per-channel), 64 or 128, but get %d.",
+            group_size));
+
     pir::RewritePatternSet ps(context);
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, true, algo, sm_version_));
+        context, true, algo, group_size, sm_version_));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearWithBiasPattern>(
-        context, false, algo, sm_version_));
+        context, false, algo, group_size, sm_version_));
     ps.Add(paddle::drr::Create<FusedWeightOnlyLinearNoBiasPattern>(
-        context, algo, sm_version_));
+        context, algo, group_size, sm_version_));
     return ps;
   }
 
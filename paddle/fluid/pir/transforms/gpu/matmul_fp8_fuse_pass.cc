@@ -0,0 +1,296 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/gpu/matmul_fp8_fuse_pass.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/utils/analysis_info.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
+namespace {
+
+// The qmax of the quantize ops of a model quantized to fp8 e4m3.
+constexpr int kFp8MaxBound = 448;
+
+// fp8 gemms of cuBLASLt need sm_89+ and CUDA 12.1+.
+bool SupportFp8Gemm() {
+#ifdef PADDLE_WITH_CUDA
+  int device_id = phi::backends::gpu::GetCurrentDeviceId();
+  return phi::backends::gpu::GetGPUComputeCapability(device_id) >= 89 &&
+         phi::backends::gpu::GetGPURuntimeVersion(device_id) >= 12010;
+#else
+  return false;
+#endif
+}
+
+// Replaces the matmul ops of a model quantized to fp8 e4m3 whose weight is a
+// parameter with fp8_fp8_half_gemm_fused, using the per-tensor scales
+// delete_quant_dequant_linear_op_pass and delete_weight_dequant_linear_op_pass
+// left in QuantAnalysis. The weights are converted to fp8 in the scope, the
+// activations are scaled and cast to fp8, and the product is dequantized by
+// the alpha of the cuBLASLt gemm. A following bias add is fused into the
+// epilogue of the gemm when it has the output dtype.
+class MatmulFp8FusePass : public pir::Pass {
+ public:
+  MatmulFp8FusePass() : pir::Pass("matmul_fp8_fuse_pass", 2) {}
+
+  bool Initialize(pir::IrContext* context) override {
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kPlaceAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulFp8FusePass, place attribute is required!"
+            "Use Set method to set the place attribute."));
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kParamScopeAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulFp8FusePass, scope attribute is required!"
+            "Use Set method to set the scope attribute."));
+
+    place_ = Get<phi::Place>(pir::Pass::kPlaceAttr);
+    scope_ = &Get<paddle::framework::Scope>(pir::Pass::kParamScopeAttr);
+    return true;
+  }
+
+  void Run(pir::Operation* op) override {
+    auto module_op = op->dyn_cast<pir::ModuleOp>();
+    PADDLE_ENFORCE_NOT_NULL(
+        module_op,
+        common::errors::PreconditionNotMet(
+            "matmul_fp8_fuse_pass should run on module op."));
+    PADDLE_ENFORCE_EQ(
+        pass_state().has_value(),
+        true,
+        common::errors::InvalidArgument("pass state has no value"));
+    auto& quant_analysis =
+        pass_state()->am.GetAnalysis<pir::pass::QuantAnalysis>();
+    pass_state()->preserved_analyses.Preserve<pir::pass::QuantAnalysis>();
+    const auto& scale_map = quant_analysis.scale_map;
+    const auto& qmax_map = quant_analysis.qmax_map;
+    auto Fp8Scale = [&](pir::Value value) -> float {
+      auto scale = scale_map.find(value);
+      auto qmax = qmax_map.find(value);
+      if (scale == scale_map.end() || scale->second.size() != 1 ||
+          qmax == qmax_map.end() || qmax->second != kFp8MaxBound) {
+        return 0.0f;
+      }
+      return scale->second[0];
+    };
+
+    std::vector<pir::Operation*> matmul_ops;
+    for (auto& inner_op : module_op.block()) {
+      if (inner_op.isa<paddle::dialect::MatmulOp>()) {
+        matmul_ops.push_back(&inner_op);
+      }
+    }
+
+    pir::IrContext* ctx = pir::IrContext::Instance();
+    pir::Builder builder(ctx, &module_op.block());
+    int64_t fused_count = 0;
+    for (auto* matmul_op : matmul_ops) {
+      if (matmul_op->attribute<pir::BoolAttribute>("transpose_x").data() ||
+          matmul_op->attribute<pir::BoolAttribute>("transpose_y").data()) {
+        continue;
+      }
+      pir::Value x = matmul_op->operand_source(0);
+      pir::Value weight = matmul_op->operand_source(1);
+      const float x_scale = Fp8Scale(x);
+      const float weight_scale = Fp8Scale(weight);
+      if (x_scale <= 0.0f || weight_scale <= 0.0f) {
+        continue;
+      }
+      auto x_type = x.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      if (!x_type || x_type.dims().size() < 2) {
+        continue;
+      }
+      std::string output_dtype;
+      if (x_type.dtype().isa<pir::Float16Type>()) {
+        output_dtype = "float16";
+      } else if (x_type.dtype().isa<pir::BFloat16Type>() ||
+                 x_type.dtype().isa<pir::Float32Type>()) {
+        output_dtype = "bfloat16";
+      } else {
+        continue;
+      }
+      // x is flattened to 2D for the gemm, the output is reshaped back, so at
+      // most one of the leading dims may be dynamic.
+      std::vector<int64_t> out_shape = common::vectorize(x_type.dims());
+      const int64_t k = out_shape.back();
+      if (k <= 0 || k % 16 != 0 ||
+          std::count(out_shape.begin(), out_shape.end() - 1, -1) > 1) {
+        continue;
+      }
+      // the weight is converted in place, so it may not be shared
+      auto parameter_op = weight.defining_op<pir::ParameterOp>();
+      if (!parameter_op || weight.use_count() != 1) {
+        continue;
+      }
+      auto weight_type =
+          weight.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      if (!weight_type || weight_type.dims().size() != 2 ||
+          weight_type.dims()[0] != k) {
+        continue;
+      }
+      if (!ConvertWeightToFp8(parameter_op.param_name(), weight_type)) {
+        continue;
+      }
+      weight.set_type(paddle::dialect::DenseTensorType::get(
+          ctx,
+          pir::Float8E4M3FNType::get(ctx),
+          weight_type.dims(),
+          weight_type.data_layout(),
+          weight_type.lod(),
+          weight_type.offset()));
+      out_shape.back() = weight_type.dims()[1];
+
+      pir::Operation* last_op = matmul_op;
+      pir::Value bias;
+      if (matmul_op->result(0).use_count() == 1 &&
+          !x_type.dtype().isa<pir::Float32Type>()) {
+        auto* add_op = matmul_op->result(0).first_use().owner();
+        if (add_op->isa<paddle::dialect::AddOp>() &&
+            add_op->operand_source(0) == matmul_op->result(0)) {
+          auto bias_type = add_op->operand_source(1)
+                               .type()
+                               .dyn_cast<paddle::dialect::DenseTensorType>();
+          if (bias_type && bias_type.dims().size() == 1 &&
+              bias_type.dims()[0] == out_shape.back() &&
+              bias_type.dtype() == x_type.dtype()) {
+            bias = add_op->operand_source(1);
+            last_op = add_op;
+          }
+        }
+      }
+
+      builder.SetInsertionPointAfter(last_op);
+      pir::Value gemm_x = x;
+      if (out_shape.size() > 2) {
+        gemm_x = builder
+                     .Build<paddle::dialect::ReshapeOp>(
+                         x, std::vector<int64_t>{-1, k})
+                     .result(0);
+      }
+      auto quant_x = builder.Build<paddle::dialect::ScaleOp>(
+          gemm_x, kFp8MaxBound / x_scale, 0.0f, true);
+      auto fp8_x = builder.Build<paddle::dialect::CastOp>(
+          quant_x.result(0), phi::DataType::FLOAT8_E4M3FN);
+      auto gemm_op = builder.Build<paddle::dialect::Fp8Fp8HalfGemmFusedOp>(
+          fp8_x.result(0),
+          weight,
+          bias,
+          false,
+          false,
+          x_scale / kFp8MaxBound * weight_scale / kFp8MaxBound,
+          output_dtype,
+          "identity");
+      pir::Value out = gemm_op.result(0);
+      if (out_shape.size() > 2) {
+        out = builder.Build<paddle::dialect::ReshapeOp>(out, out_shape)
+                  .result(0);
+      }
+      if (x_type.dtype().isa<pir::Float32Type>()) {
+        out = builder
+                  .Build<paddle::dialect::CastOp>(out, phi::DataType::FLOAT32)
+                  .result(0);
+      }
+      last_op->result(0).ReplaceAllUsesWith(out);
+      if (last_op != matmul_op) {
+        last_op->Erase();
+      }
+      matmul_op->Erase();
+      ++fused_count;
+    }
+    AddStatistics(fused_count);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    PADDLE_ENFORCE_NOT_NULL(
+        scope_, common::errors::InvalidArgument("scope can not be nullptr"));
+    return phi::is_gpu_place(place_) && SupportFp8Gemm() &&
+           op->isa<::pir::ModuleOp>() && op->num_regions() > 0;
+  }
+
+ private:
+  // The weights of a quantized model hold the fp8 values in float32 after
+  // the dequantize op is deleted, or are already fp8.
+  bool ConvertWeightToFp8(const std::string& name,
+                          paddle::dialect::DenseTensorType weight_type) {
+    if (weight_type.dtype().isa<pir::Float8E4M3FNType>()) {
+      return true;
+    }
+    if (!weight_type.dtype().isa<pir::Float32Type>()) {
+      return false;
+    }
+    auto* var = scope_->FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      return false;
+    }
+    auto* tensor = var->GetMutable<phi::DenseTensor>();
+    if (tensor->dtype() != phi::DataType::FLOAT32) {
+      return false;
+    }
+    phi::DenseTensor cpu_tensor;
+    paddle::framework::TensorCopySync(*tensor, phi::CPUPlace(), &cpu_tensor);
+    phi::DenseTensor fp8_tensor;
+    fp8_tensor.Resize(tensor->dims());
+    const float* src = cpu_tensor.data<float>();
+    auto* dst =
+        fp8_tensor.mutable_data<phi::dtype::float8_e4m3fn>(phi::CPUPlace());
+    for (int64_t i = 0; i < tensor->numel(); ++i) {
+      dst[i] = phi::dtype::float8_e4m3fn(src[i]);
+    }
+    auto place = tensor->place();
+    paddle::framework::TensorCopySync(fp8_tensor, place, tensor);
+    return true;
+  }
+
+  phi::Place place_{phi::CPUPlace{}};
+  paddle::framework::Scope* scope_{nullptr};
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<pir::Pass> CreateMatmulFp8FusePass() {
+  return std::make_unique<MatmulFp8FusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(matmul_fp8_fuse_pass, MatmulFp8FusePass);
@@ -0,0 +1,264 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/pir/transforms/gpu/matmul_sparse_24_fuse_pass.h"
+
+#include <string>
+#include <vector>
+
+#include "paddle/common/errors.h"
+#include "paddle/fluid/framework/scope.h"
+#include "paddle/fluid/framework/tensor_util.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_attribute.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/builtin_type.h"
+#include "paddle/pir/include/pass/pass.h"
+#include "paddle/pir/include/pass/pass_registry.h"
+
+#ifdef PADDLE_WITH_CUSPARSELT
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/platform/device_context.h"
+#include "paddle/phi/kernels/fusion/gpu/sparse_24_gemm_utils.h"
+#endif
+
+namespace {
+
+// The sparse tensor cores of sm_80+ run 16-bit gemms whose weight has at most
+// 2 nonzeros in every 4 consecutive elements along k.
+bool SupportSparse24Gemm() {
+#ifdef PADDLE_WITH_CUSPARSELT
+  int device_id = phi::backends::gpu::GetCurrentDeviceId();
+  return phi::backends::gpu::GetGPUComputeCapability(device_id) >= 80;
+#else
+  return false;
+#endif
+}
+
+// Whether the [k, n] weight has at most 2 nonzeros in every 4 consecutive
+// elements of each column.
+template <typename T>
+bool IsSparse24(const phi::DenseTensor& weight) {
+  const int64_t k = weight.dims()[0];
+  const int64_t n = weight.dims()[1];
+  const T* data = weight.data<T>();
+  for (int64_t col = 0; col < n; ++col) {
+    for (int64_t row = 0; row < k; row += 4) {
+      int nonzeros = 0;
+      for (int64_t i = row; i < row + 4; ++i) {
+        nonzeros += static_cast<float>(data[i * n + col]) != 0.0f;
+      }
+      if (nonzeros > 2) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void Transpose(const phi::DenseTensor& weight, phi::DenseTensor* out) {
+  const int64_t k = weight.dims()[0];
+  const int64_t n = weight.dims()[1];
+  out->Resize({n, k});
+  const T* src = weight.data<T>();
+  T* dst = out->mutable_data<T>(phi::CPUPlace());
+  for (int64_t row = 0; row < k; ++row) {
+    for (int64_t col = 0; col < n; ++col) {
+      dst[col * k + row] = src[row * n + col];
+    }
+  }
+}
+
+// Replaces the 16-bit matmul ops whose weight is a 2:4 sparse parameter with
+// sparse_24_gemm, which runs on the sparse tensor cores by cuSPARSELt. The
+// weights are detected from their values, so any model pruned to 2:4, e.g.
+// by paddle.incubate.asp, is accelerated without marking it. Every weight is
+// compressed in the scope once, and the dense weight is erased.
+class MatmulSparse24FusePass : public pir::Pass {
+ public:
+  MatmulSparse24FusePass() : pir::Pass("matmul_sparse_24_fuse_pass", 2) {}
+
+  bool Initialize(pir::IrContext* context) override {
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kPlaceAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulSparse24FusePass, place attribute is required!"
+            "Use Set method to set the place attribute."));
+    PADDLE_ENFORCE_EQ(
+        Has(pir::Pass::kParamScopeAttr),
+        true,
+        common::errors::InvalidArgument(
+            "Pass initialize failed."
+            "When using MatmulSparse24FusePass, scope attribute is required!"
+            "Use Set method to set the scope attribute."));
+
+    place_ = Get<phi::Place>(pir::Pass::kPlaceAttr);
+    scope_ = &Get<paddle::framework::Scope>(pir::Pass::kParamScopeAttr);
+    return true;
+  }
+
+  void Run(pir::Operation* op) override {
+    auto module_op = op->dyn_cast<pir::ModuleOp>();
+    PADDLE_ENFORCE_NOT_NULL(
+        module_op,
+        common::errors::PreconditionNotMet(
+            "matmul_sparse_24_fuse_pass should run on module op."));
+
+    std::vector<pir::Operation*> matmul_ops;
+    for (auto& inner_op : module_op.block()) {
+      if (inner_op.isa<paddle::dialect::MatmulOp>()) {
+        matmul_ops.push_back(&inner_op);
+      }
+    }
+
+    pir::IrContext* ctx = pir::IrContext::Instance();
+    pir::Builder builder(ctx, &module_op.block());
+    int64_t fused_count = 0;
+    for (auto* matmul_op : matmul_ops) {
+      if (matmul_op->attribute<pir::BoolAttribute>("transpose_x").data() ||
+          matmul_op->attribute<pir::BoolAttribute>("transpose_y").data()) {
+        continue;
+      }
+      pir::Value x = matmul_op->operand_source(0);
+      pir::Value weight = matmul_op->operand_source(1);
+      auto x_type = x.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      auto weight_type =
+          weight.type().dyn_cast<paddle::dialect::DenseTensorType>();
+      if (!x_type || !weight_type || x_type.dims().size() < 2 ||
+          weight_type.dims().size() != 2 ||
+          x_type.dtype() != weight_type.dtype() ||
+          !(x_type.dtype().isa<pir::Float16Type>() ||
+            x_type.dtype().isa<pir::BFloat16Type>())) {
+        continue;
+      }
+      const int64_t k = weight_type.dims()[0];
+      const int64_t n = weight_type.dims()[1];
+      // the shapes cuSPARSELt accepts for 16-bit sparse matrices
+      if (k <= 0 || n <= 0 || k % 16 != 0 || n % 16 != 0) {
+        continue;
+      }
+      // the dense weight is erased, so it may not be shared
+      auto parameter_op = weight.defining_op<pir::ParameterOp>();
+      if (!parameter_op || weight.use_count() != 1) {
+        continue;
+      }
+      std::string compressed_name =
+          parameter_op.param_name() + "@sparse_24";
+      int64_t compressed_size =
+          CompressWeight(parameter_op.param_name(), compressed_name);
+      if (compressed_size <= 0) {
+        continue;
+      }
+
+      builder.SetInsertionPointAfter(parameter_op);
+      auto compressed_op = builder.Build<pir::ParameterOp>(
+          compressed_name,
+          paddle::dialect::DenseTensorType::get(
+              ctx,
+              pir::UInt8Type::get(ctx),
+              common::make_ddim({compressed_size}),
+              weight_type.data_layout(),
+              weight_type.lod(),
+              weight_type.offset()));
+      compressed_op->set_attribute(
+          pir::kAttrIsPersistable,
+          builder.array_attr({builder.bool_attr(true)}));
+      builder.SetInsertionPointAfter(matmul_op);
+      auto gemm_op = builder.Build<paddle::dialect::Sparse24GemmOp>(
+          x,
+          compressed_op.result(0),
+          static_cast<int>(n),
+          static_cast<int>(k));
+      matmul_op->result(0).ReplaceAllUsesWith(gemm_op.result(0));
+      matmul_op->Erase();
+      scope_->EraseVars({parameter_op.param_name()});
+      parameter_op->Erase();
+      ++fused_count;
+    }
+    AddStatistics(fused_count);
+  }
+
+  bool CanApplyOn(pir::Operation* op) const override {
+    PADDLE_ENFORCE_NOT_NULL(
+        scope_, common::errors::InvalidArgument("scope can not be nullptr"));
+    return phi::is_gpu_place(place_) && SupportSparse24Gemm() &&
+           op->isa<::pir::ModuleOp>() && op->num_regions() > 0;
+  }
+
+ private:
+  // Compresses the weight into a new variable if it is 2:4 sparse, returns
+  // the size of the compressed weight, or 0.
+  int64_t CompressWeight(const std::string& name,
+                         const std::string& compressed_name) {
+#ifdef PADDLE_WITH_CUSPARSELT
+    auto* var = scope_->FindVar(name);
+    if (var == nullptr || !var->IsType<phi::DenseTensor>()) {
+      return 0;
+    }
+    const auto& tensor = var->Get<phi::DenseTensor>();
+    phi::DenseTensor cpu_tensor;
+    paddle::framework::TensorCopySync(tensor, phi::CPUPlace(), &cpu_tensor);
+    phi::DenseTensor transposed;
+    if (tensor.dtype() == phi::DataType::FLOAT16) {
+      if (!IsSparse24<phi::dtype::float16>(cpu_tensor)) {
+        return 0;
+      }
+      Transpose<phi::dtype::float16>(cpu_tensor, &transposed);
+    } else if (tensor.dtype() == phi::DataType::BFLOAT16) {
+      if (!IsSparse24<phi::dtype::bfloat16>(cpu_tensor)) {
+        return 0;
+      }
+      Transpose<phi::dtype::bfloat16>(cpu_tensor, &transposed);
+    } else {
+      return 0;
+    }
+    VLOG(4) << "Compress the 2:4 sparse weight " << name;
+    phi::DenseTensor device_tensor;
+    paddle::framework::TensorCopySync(transposed, place_, &device_tensor);
+    auto* dev_ctx = static_cast<phi::GPUContext*>(
+        phi::DeviceContextPool::Instance().Get(place_));
+    auto* compressed =
+        scope_->Var(compressed_name)->GetMutable<phi::DenseTensor>();
+    phi::fusion::CompressSparse24Weight(*dev_ctx, device_tensor, compressed);
+    dev_ctx->Wait();
+    return compressed->numel();
+#else
+    return 0;
+#endif
+  }
+
+  phi::Place place_{phi::CPUPlace{}};
+  paddle::framework::Scope* scope_{nullptr};
+};
+
+}  // namespace
+
+namespace pir {
+
+std::unique_ptr<pir::Pass> CreateMatmulSparse24FusePass() {
+  return std::make_unique<MatmulSparse24FusePass>();
+}
+
+}  // namespace pir
+
+REGISTER_IR_PASS(matmul_sparse_24_fuse_pass, MatmulSparse24FusePass);
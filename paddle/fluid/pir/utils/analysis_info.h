@@ -25,6 +25,9 @@ namespace pass {
 // PIR Passes
 struct QuantAnalysis {
   std::unordered_map<pir::Value, std::vector<float>> scale_map;
+  // The qmax of the quantize op of every value in scale_map, e.g. 127 for
+  // int8 and 448 for fp8 e4m3.
+  std::unordered_map<pir::Value, int> qmax_map;
 };
 
 // Int8Analysis is used to pass information between PIR Passes on whether to
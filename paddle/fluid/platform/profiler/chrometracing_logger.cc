@@ -14,7 +14,9 @@ limitations under the License. */
 
 #include "paddle/fluid/platform/profiler/chrometracing_logger.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
 #include <ctime>
 #include <limits>
 #include <regex>
@@ -111,6 +113,182 @@ void ChromeTracingLogger::LogNodeTrees(const NodeTrees& node_trees) {
       }
     }
   }
+  LogMemoryLifetime(node_trees);
+}
+
+namespace {
+
+struct MemRecord {
+  const MemTraceEventNode* node;
+  // Name of the operator (or the innermost host event when there is no
+  // enclosing operator) during which the memory event happened.
+  std::string owner;
+};
+
+void CollectMemRecords(const HostTraceEventNode* host_node,
+                       const std::string& owner,
+                       bool owner_is_op,
+                       std::vector<MemRecord>* records) {
+  for (auto memnode : host_node->GetMemTraceEventNodes()) {
+    records->push_back({memnode, owner});
+  }
+  for (auto child : host_node->GetChildren()) {
+    if (child->Type() == TracerEventType::Operator || !owner_is_op) {
+      CollectMemRecords(child,
+                        child->Name(),
+                        child->Type() == TracerEventType::Operator,
+                        records);
+    } else {
+      CollectMemRecords(child, owner, owner_is_op, records);
+    }
+  }
+}
+
+}  // namespace
+
+void ChromeTracingLogger::LogMemoryLifetime(const NodeTrees& node_trees) {
+  if (!output_file_stream_) {
+    return;
+  }
+  std::vector<MemRecord> records;
+  for (const auto& thread_root : node_trees.GetNodeTrees()) {
+    CollectMemRecords(thread_root.second, "unattributed", false, &records);
+  }
+  if (records.empty()) {
+    return;
+  }
+  std::stable_sort(records.begin(),
+                   records.end(),
+                   [](const MemRecord& lhs, const MemRecord& rhs) {
+                     return lhs.node->TimeStampNs() < rhs.node->TimeStampNs();
+                   });
+
+  struct LiveAllocation {
+    uint64_t timestamp_ns;
+    uint64_t size;
+    std::string owner;
+    uint64_t process_id;
+  };
+  struct PlaceState {
+    std::map<uint64_t, LiveAllocation> live;
+    std::map<std::string, uint64_t> held_bytes;
+    uint64_t total_bytes = 0;
+    uint64_t peak_bytes = 0;
+    uint64_t peak_timestamp_ns = 0;
+    uint64_t process_id = 0;
+    std::map<std::string, uint64_t> held_bytes_at_peak;
+  };
+  std::map<std::string, PlaceState> place_states;
+
+  auto log_lifetime = [this](const std::string& place,
+                             const LiveAllocation& allocation,
+                             uint64_t addr,
+                             uint64_t end_ns,
+                             bool freed) {
+    output_file_stream_ << string_format(
+        std::string(
+            R"JSON(
+  {
+    "name": "[memory] %s", "pid": %lld, "tid": "%s memory",
+    "ts": %lld, "dur": %.3f,
+    "ph": "X", "cat": "MemoryLifetime",
+    "args": {
+      "addr": "%llu",
+      "bytes": %llu,
+      "lifetime": "%.3f us",
+      "freed": %s
+    }
+  },
+  )JSON"),
+        allocation.owner.c_str(),
+        allocation.process_id,
+        place.c_str(),
+        nsToUs(allocation.timestamp_ns),
+        nsToUsFloat(end_ns, allocation.timestamp_ns),
+        addr,
+        allocation.size,
+        nsToUsFloat(end_ns, allocation.timestamp_ns),
+        freed ? "true" : "false");
+  };
+
+  for (const auto& record : records) {
+    const MemTraceEventNode* node = record.node;
+    std::string place = node->Place();
+    PlaceState& state = place_states[place];
+    if (node->Type() == TracerMemEventType::Allocate) {
+      uint64_t size = std::abs(node->IncreaseBytes());
+      state.live[node->Addr()] = {
+          node->TimeStampNs(), size, record.owner, node->ProcessId()};
+      state.held_bytes[record.owner] += size;
+      state.total_bytes += size;
+      if (state.total_bytes > state.peak_bytes) {
+        state.peak_bytes = state.total_bytes;
+        state.peak_timestamp_ns = node->TimeStampNs();
+        state.process_id = node->ProcessId();
+        state.held_bytes_at_peak = state.held_bytes;
+      }
+    } else if (node->Type() == TracerMemEventType::Free) {
+      auto iter = state.live.find(node->Addr());
+      if (iter == state.live.end()) {
+        // allocated before the profiler started
+        continue;
+      }
+      const LiveAllocation& allocation = iter->second;
+      log_lifetime(place, allocation, node->Addr(), node->TimeStampNs(), true);
+      state.held_bytes[allocation.owner] -= allocation.size;
+      state.total_bytes -= allocation.size;
+      state.live.erase(iter);
+    }
+  }
+
+  uint64_t end_ns = records.back().node->TimeStampNs();
+  for (const auto& place_state : place_states) {
+    const std::string& place = place_state.first;
+    const PlaceState& state = place_state.second;
+    for (const auto& live : state.live) {
+      log_lifetime(place, live.second, live.first, end_ns, false);
+    }
+    if (state.peak_bytes == 0) {
+      continue;
+    }
+    std::vector<std::pair<std::string, uint64_t>> held_bytes;
+    for (const auto& item : state.held_bytes_at_peak) {
+      if (item.second > 0) {
+        held_bytes.emplace_back(item);
+      }
+    }
+    std::sort(held_bytes.begin(),
+              held_bytes.end(),
+              [](const std::pair<std::string, uint64_t>& lhs,
+                 const std::pair<std::string, uint64_t>& rhs) {
+                return lhs.second > rhs.second;
+              });
+    std::string args;
+    for (const auto& item : held_bytes) {
+      args += string_format(std::string(R"JSON(,
+      "%s": %llu)JSON"),
+                            item.first.c_str(),
+                            item.second);
+    }
+    output_file_stream_ << string_format(
+        std::string(
+            R"JSON(
+  {
+    "name": "[memory peak] %s", "pid": %lld, "tid": "%s memory",
+    "ts": %lld,
+    "ph": "i", "s": "p", "cat": "MemoryPeak",
+    "args": {
+      "peak_allocated": %llu%s
+    }
+  },
+  )JSON"),
+        place.c_str(),
+        state.process_id,
+        place.c_str(),
+        nsToUs(state.peak_timestamp_ns),
+        state.peak_bytes,
+        args.c_str());
+  }
 }
 
 void ChromeTracingLogger::LogMemTraceEventNode(
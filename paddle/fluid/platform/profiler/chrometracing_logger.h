@@ -55,6 +55,10 @@ class ChromeTracingLogger : public BaseLogger {
   void StartLog();
   void EndLog();
   void RefineDisplayName(std::unordered_map<std::string, std::string>);
+  // Pair the Allocate/Free events of the same address into lifetime events,
+  // and log the bytes held by each operator when the allocated memory of each
+  // place reaches its peak.
+  void LogMemoryLifetime(const NodeTrees&);
   std::string filename_;
   std::ofstream output_file_stream_;
   static const char* category_name_[];
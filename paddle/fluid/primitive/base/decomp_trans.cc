@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include "paddle/fluid/primitive/base/decomp_trans.h"
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT
 #include <regex>
 #include "paddle/fluid/eager/api/utils/global_utils.h"
 #include "paddle/fluid/imperative/amp_auto_cast.h"
@@ -24,11 +27,17 @@
 #include "paddle/fluid/prim/utils/utils.h"
 #include "paddle/fluid/primitive/base/primitive_ops.h"
 #include "paddle/pir/include/core/builtin_dialect.h"
+#include "paddle/pir/include/core/ir_mapping.h"
 #include "paddle/pir/include/core/program.h"
 
 COMMON_DECLARE_bool(prim_check_ops);
 COMMON_DECLARE_bool(prim_enable_dynamic);
 COMMON_DECLARE_string(prim_forward_blacklist);
+COMMON_DECLARE_bool(prim_decomp_cache);
+COMMON_DECLARE_int64(prim_fused_kernel_reduce_numel);
+#ifdef PADDLE_WITH_CINN
+COMMON_DECLARE_bool(use_cinn);
+#endif
 
 using paddle::dialect::DenseTensorType;
 using paddle::dialect::SelectedRowsType;
@@ -81,11 +90,208 @@ void RemoveOp(pir::Block* block, pir::Operation* op) {
     }
   }
   if (remove_op) {
-    auto op_iter = std::find(block->begin(), block->end(), *op);
-    block->erase(op_iter);
+    block->erase(*op);
   }
 }
 
+int64_t ReduceNumelOverAxis(pir::Operation* op, int64_t begin, int64_t end) {
+  auto x_type = op->operand_source(0).type().dyn_cast<DenseTensorType>();
+  if (!x_type) return -1;
+  const auto& dims = x_type.dims();
+  int64_t numel = 1;
+  for (int64_t i = begin; i < end; ++i) {
+    if (dims[i] < 0) return -1;
+    numel *= dims[i];
+  }
+  return numel;
+}
+
+int64_t NormReduceNumel(pir::Operation* op) {
+  auto x_type = op->operand_source(0).type().dyn_cast<DenseTensorType>();
+  if (!x_type) return -1;
+  int64_t rank = x_type.dims().size();
+  int64_t begin = op->attribute<pir::Int32Attribute>("begin_norm_axis").data();
+  return ReduceNumelOverAxis(op, begin < 0 ? begin + rank : begin, rank);
+}
+
+int64_t SoftmaxReduceNumel(pir::Operation* op) {
+  auto x_type = op->operand_source(0).type().dyn_cast<DenseTensorType>();
+  if (!x_type) return -1;
+  int64_t rank = x_type.dims().size();
+  if (rank == 0) return 1;
+  int64_t axis = op->attribute<pir::Int32Attribute>("axis").data();
+  axis = axis < 0 ? axis + rank : axis;
+  return ReduceNumelOverAxis(op, axis, axis + 1);
+}
+
+// Ops with a hand fused phi kernel, mapped to the number of elements one of
+// their reductions covers, or -1 if it is not static.
+const std::unordered_map<std::string, int64_t (*)(pir::Operation*)>
+    fused_kernel_reduce_numel = {
+        {"pd_op.layer_norm", NormReduceNumel},
+        {"pd_op.softmax", SoftmaxReduceNumel},
+        {"pd_op.log_softmax", SoftmaxReduceNumel},
+};
+
+// The primitive subgraph one decomposition rule emitted, kept in a detached
+// block whose arguments stand for the operands of the decomposed op.
+struct DecompCacheEntry {
+  std::unique_ptr<pir::Block> block;
+  std::vector<std::vector<pir::Value>> outputs;
+};
+
+// Decomposed subgraphs keyed by op signature: the op name and attributes, the
+// type and stop_gradient of each operand, the attributes of constant operands
+// that rules may read, and whether grads are recorded.
+class DecompSubgraphCache {
+ public:
+  static DecompSubgraphCache& Instance() {
+    // leaked on purpose, the cached ops must not outlive the IrContext
+    static auto* cache = new DecompSubgraphCache();
+    return *cache;
+  }
+
+  std::shared_ptr<const DecompCacheEntry> Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = entries_.find(key);
+    return iter == entries_.end() ? nullptr : iter->second;
+  }
+
+  void Put(const std::string& key,
+           std::shared_ptr<const DecompCacheEntry> entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() < kMaxEntries) {
+      entries_.emplace(key, std::move(entry));
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxEntries = 4096;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const DecompCacheEntry>>
+      entries_;
+};
+
+bool IsBuilderAttr(const std::string& name) {
+  return name == "op_role" || name == "chunk_id";
+}
+
+void AppendAttrsToKey(const pir::AttributeMap& attrs, std::string* key) {
+  std::map<std::string, pir::Attribute> sorted_attrs(attrs.begin(),
+                                                     attrs.end());
+  for (auto& [name, attr] : sorted_attrs) {
+    if (IsBuilderAttr(name)) continue;
+    key->append(name);
+    key->append(std::to_string(reinterpret_cast<uintptr_t>(attr.storage())));
+    key->push_back(';');
+  }
+}
+
+// Returns an empty key for ops whose decomposition can not be replayed.
+std::string DecompSignature(pir::Operation* op) {
+  if (op->num_regions() > 0) return "";
+  std::string key = op->name();
+  key.push_back(egr::Controller::Instance().HasGrad() ? '+' : '-');
+  AppendAttrsToKey(op->attributes(), &key);
+  std::unordered_set<pir::Value> operands;
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    pir::Value value = op->operand_source(i);
+    key.push_back('|');
+    if (!value) continue;
+    // a rule sees aliased operands as one value, the key can not tell
+    if (!operands.insert(value).second) return "";
+    key.append(
+        std::to_string(reinterpret_cast<uintptr_t>(value.type().storage())));
+    key.push_back(',');
+    key.append(std::to_string(reinterpret_cast<uintptr_t>(
+        value.attribute(pir::kStopGradientAttrName).storage())));
+    auto* def_op = value.defining_op();
+    if (def_op && def_op->num_operands() == 0 &&
+        (def_op->name() == "pd_op.full" ||
+         def_op->name() == "pd_op.full_int_array" ||
+         def_op->name() == "pd_op.assign_value" ||
+         def_op->name() == "pd_op.assign_value_")) {
+      key.append(def_op->name());
+      AppendAttrsToKey(def_op->attributes(), &key);
+    }
+  }
+  return key;
+}
+
+// Copies the ops in [first, op) that decomposing op emitted into a cache
+// entry, or returns nullptr if they use values defined elsewhere.
+std::shared_ptr<const DecompCacheEntry> CaptureDecomp(
+    pir::Operation* op,
+    pir::Block::Iterator first,
+    const std::vector<std::vector<pir::Value>>& decomp_res) {
+  auto entry = std::make_shared<DecompCacheEntry>();
+  entry->block = std::make_unique<pir::Block>();
+  pir::IrMapping mapping;
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    pir::Value value = op->operand_source(i);
+    if (value) {
+      mapping.Add(value, entry->block->AddArg(value.type()));
+    }
+  }
+  for (auto iter = first; iter != pir::Block::Iterator(*op); ++iter) {
+    if (iter->num_regions() > 0) return nullptr;
+    for (uint32_t i = 0; i < iter->num_operands(); ++i) {
+      pir::Value value = iter->operand_source(i);
+      if (value && !mapping.Has(value)) return nullptr;
+    }
+    entry->block->push_back(iter->Clone(mapping));
+  }
+  for (auto& outs : decomp_res) {
+    std::vector<pir::Value> cached_outs;
+    for (auto& value : outs) {
+      if (value && !mapping.Has(value)) return nullptr;
+      cached_outs.push_back(mapping.Lookup(value));
+    }
+    entry->outputs.push_back(std::move(cached_outs));
+  }
+  return entry;
+}
+
+std::vector<std::vector<pir::Value>> ReplayDecomp(
+    pir::Operation* op,
+    const DecompCacheEntry& entry,
+    const std::shared_ptr<pir::Builder>& builder,
+    int op_role,
+    int chunk_id) {
+  pir::IrMapping mapping;
+  uint32_t arg_index = 0;
+  for (uint32_t i = 0; i < op->num_operands(); ++i) {
+    pir::Value value = op->operand_source(i);
+    if (value) {
+      mapping.Add(entry.block->arg(arg_index++), value);
+    }
+  }
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  for (auto& cached_op : *entry.block) {
+    pir::Operation* new_op = cached_op.Clone(mapping);
+    new_op->erase_attribute("op_role");
+    new_op->erase_attribute("chunk_id");
+    if (op_role != -1) {
+      new_op->set_attribute("op_role", pir::Int32Attribute::get(ctx, op_role));
+    }
+    if (chunk_id != -1) {
+      new_op->set_attribute("chunk_id",
+                            pir::Int32Attribute::get(ctx, chunk_id));
+    }
+    builder->Insert(new_op);
+  }
+  std::vector<std::vector<pir::Value>> decomp_res;
+  for (auto& outs : entry.outputs) {
+    std::vector<pir::Value> new_outs;
+    for (auto& value : outs) {
+      new_outs.push_back(mapping.Lookup(value));
+    }
+    decomp_res.push_back(std::move(new_outs));
+  }
+  return decomp_res;
+}
+
 }  // namespace
 
 static bool has_dynamic_shape(const phi::DDim& dims) {
@@ -365,14 +571,31 @@ bool DecompProgram::enable_decomp_by_filter(const std::string& op_name) {
       flag = false;
     }
   }
-  auto from_flag_blacklist = StringSplit(FLAGS_prim_forward_blacklist);
-  if (!from_flag_blacklist.empty())
+  if (!flag_blacklist_merged_) {
+    auto from_flag_blacklist = StringSplit(FLAGS_prim_forward_blacklist);
     blacklist_.insert(from_flag_blacklist.begin(), from_flag_blacklist.end());
+    flag_blacklist_merged_ = true;
+  }
   if (!blacklist_.empty() && blacklist_.find(op_name) != blacklist_.end())
     flag = false;
   return flag;
 }
 
+bool DecompProgram::prefer_fused_kernel(pir::Operation* op) {
+  if (FLAGS_prim_fused_kernel_reduce_numel <= 0) return false;
+  auto iter = fused_kernel_reduce_numel.find(op->name());
+  if (iter == fused_kernel_reduce_numel.end()) return false;
+  bool use_cinn = false;
+#ifdef PADDLE_WITH_CINN
+  use_cinn = FLAGS_use_cinn;
+#endif
+  // without CINN nothing fuses the primitives back together
+  if (!use_cinn) return true;
+  // CINN fuses small reductions well, but splits large ones over several
+  // kernels where the hand fused kernel needs one pass.
+  return iter->second(op) >= FLAGS_prim_fused_kernel_reduce_numel;
+}
+
 std::vector<std::vector<pir::Value>> call_decomp_rule(pir::Operation* op) {
   paddle::dialect::DecompInterface decomp_interface =
       op->dyn_cast<paddle::dialect::DecompInterface>();
@@ -430,9 +653,9 @@ void DecompProgram::decomp_program() {
   for (size_t i = 0; i < src_vars_.size(); i++) {  // NOLINT
     orig_vars_dict[src_vars_[i]] = static_cast<int>(i);
   }
-  std::ostringstream orig_prog_stream;
-  program_->Print(orig_prog_stream);
   if (VLOG_IS_ON(4)) {
+    std::ostringstream orig_prog_stream;
+    program_->Print(orig_prog_stream);
     std::cout << "[Prim] Origin program before decomp :\n"
               << orig_prog_stream.str() << std::endl;
   }
@@ -451,9 +674,9 @@ void DecompProgram::decomp_program() {
         paddle::imperative::AmpLevel::O0);
     decomp_block(block, orig_vars_dict, tar_vars);
   }
-  std::ostringstream decomp_prog_stream;
-  program_->Print(decomp_prog_stream);
   if (VLOG_IS_ON(4)) {
+    std::ostringstream decomp_prog_stream;
+    program_->Print(decomp_prog_stream);
     std::cout << "[Prim] New program after decomp :\n"
               << decomp_prog_stream.str() << std::endl;
   }
@@ -480,8 +703,9 @@ void DecompProgram::decomp_block(
       auto& sub_body = op->dyn_cast<dialect::WhileOp>().body();
       decomp_block(&sub_body, orig_vars_dict, tar_vars);
     }
-    bool enable_prim =
-        has_decomp_rule(*op) && enable_decomp_by_filter(op->name());
+    bool enable_prim = has_decomp_rule(*op) &&
+                       enable_decomp_by_filter(op->name()) &&
+                       !prefer_fused_kernel(op);
     if (enable_prim && check_decomp_dynamic_shape(op) &&
         (!FLAGS_prim_enable_dynamic ||
          dynamic_shape_blacklist.find(op->name()) !=
@@ -490,7 +714,6 @@ void DecompProgram::decomp_block(
     }
     if (enable_prim) {
       VLOG(4) << "[Prim] decomp op name " << op->name();
-      check_decomp_dynamic_shape(op);
       std::shared_ptr<pir::Builder> builder =
           paddle::dialect::ApiBuilder::Instance().GetBuilder();
       builder->set_insertion_point(op);
@@ -503,7 +726,29 @@ void DecompProgram::decomp_block(
                          : -1;
       pir::BuilderAttrGuard guard(builder, op_role, chunk_id);
 
-      std::vector<std::vector<pir::Value>> decomp_res = call_decomp_rule(op);
+      std::string signature =
+          FLAGS_prim_decomp_cache ? DecompSignature(op) : std::string();
+      auto cached = signature.empty()
+                        ? nullptr
+                        : DecompSubgraphCache::Instance().Get(signature);
+      std::vector<std::vector<pir::Value>> decomp_res;
+      if (cached) {
+        VLOG(6) << "[Prim] replay cached decomp of " << op->name();
+        decomp_res = ReplayDecomp(op, *cached, builder, op_role, chunk_id);
+      } else {
+        pir::Block::Iterator op_iter = *op;
+        bool at_begin = op_iter == block->begin();
+        pir::Block::Iterator prev_iter = op_iter;
+        if (!at_begin) --prev_iter;
+        decomp_res = call_decomp_rule(op);
+        if (!signature.empty() && decomp_res.size() > 0) {
+          auto entry = CaptureDecomp(
+              op, at_begin ? block->begin() : ++prev_iter, decomp_res);
+          if (entry) {
+            DecompSubgraphCache::Instance().Put(signature, std::move(entry));
+          }
+        }
+      }
       if (decomp_res.size() == 0) {
         // if we don't decomp this op, then leave it intact.
         continue;
@@ -61,11 +61,15 @@ class DecompProgram {
                           std::unordered_map<pir::Value, int> orig_vars_dict,
                           std::vector<pir::Value>* tar_vars);
   bool enable_decomp_by_filter(const std::string& op_name);
+  // Whether op keeps its fused phi kernel under
+  // FLAGS_prim_fused_kernel_reduce_numel instead of being decomposed.
+  bool prefer_fused_kernel(pir::Operation* op);
   void set_src_vars(const std::vector<pir::Value>& src_vars) {
     src_vars_ = src_vars;
   }
   void set_blacklist(const std::set<std::string>& blacklist) {
     blacklist_ = blacklist;
+    flag_blacklist_merged_ = false;
   }
   void set_whitelist(const std::set<std::string>& whitelist) {
     whitelist_ = whitelist;
@@ -81,6 +85,8 @@ class DecompProgram {
   std::set<std::string> blacklist_;
   std::set<std::string> whitelist_;
   std::set<std::string> decomposed_prog_ops_set_;
+  // FLAGS_prim_forward_blacklist is merged into blacklist_ once per program
+  bool flag_blacklist_merged_{false};
   // Used to slice ops for global block.
   int start_index_{0};
   int end_index_{-1};
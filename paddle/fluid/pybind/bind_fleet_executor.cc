@@ -23,6 +23,7 @@
 #include "paddle/fluid/distributed/fleet_executor/dist_model.h"
 #include "paddle/fluid/distributed/fleet_executor/dist_model_tensor_wrapper.h"
 #include "paddle/fluid/distributed/fleet_executor/fleet_executor.h"
+#include "paddle/fluid/distributed/fleet_executor/runtime_graph.h"
 #include "paddle/fluid/distributed/fleet_executor/task_node.h"
 #include "paddle/fluid/framework/operator.h"
 #include "paddle/fluid/framework/program_desc.h"
@@ -69,6 +70,11 @@ using paddle::distributed::DistModelDataBuf;
 using paddle::distributed::DistModelDataType;
 using paddle::distributed::DistModelTensor;
 using paddle::distributed::FleetExecutor;
+using paddle::distributed::GeneratePipelineSchedule;
+using paddle::distributed::PipelineCost;
+using paddle::distributed::PipelineJob;
+using paddle::distributed::PipelineScheduleType;
+using paddle::distributed::SimulatePipelineSchedule;
 using paddle::distributed::TaskNode;
 using paddle::framework::OpDesc;
 using paddle::framework::ProgramDesc;
@@ -150,6 +156,33 @@ py::dtype DistModelTypeToNumpyDType(DistModelDataType dtype) {
   return dt;
 }
 
+PipelineScheduleType PipelineScheduleTypeFromString(const std::string& type) {
+  if (type == "1F1B") {
+    return PipelineScheduleType::k1F1B;
+  } else if (type == "VPP") {
+    return PipelineScheduleType::kInterleaved1F1B;
+  } else if (type == "ZBH1") {
+    return PipelineScheduleType::kZeroBubble;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Unsupported pipeline schedule %s, it should be 1F1B, VPP or ZBH1.",
+      type));
+}
+
+std::string PipelineJobTypeToString(PipelineJob::Type type) {
+  switch (type) {
+    case PipelineJob::Type::kForward:
+      return "forward";
+    case PipelineJob::Type::kBackward:
+      return "backward";
+    case PipelineJob::Type::kBackwardInput:
+      return "backward_b";
+    case PipelineJob::Type::kBackwardWeight:
+      return "backward_w";
+  }
+  return "";
+}
+
 py::array DistModelTensorGetData(DistModelTensor& tensor) {  // NOLINT
   py::dtype dt = DistModelTypeToNumpyDType(tensor.dtype);
   return py::array(dt, {tensor.shape}, tensor.data.data());
@@ -187,6 +220,63 @@ void BindFleetExecutor(py::module* m) {
       .def("init", [](TaskNode& self) { self.Init(); })
       .def("set_program", &TaskNode::SetProgram);
 
+  m->def(
+      "generate_pipeline_schedule",
+      [](const std::string& type,
+         int64_t num_stages,
+         int64_t num_micro_batches,
+         int64_t num_chunks) {
+        auto schedule =
+            GeneratePipelineSchedule(PipelineScheduleTypeFromString(type),
+                                     num_stages,
+                                     num_micro_batches,
+                                     num_chunks);
+        std::vector<std::vector<std::tuple<std::string, int64_t, int64_t>>>
+            jobs(schedule.size());
+        for (size_t stage = 0; stage < schedule.size(); ++stage) {
+          for (const auto& job : schedule[stage]) {
+            jobs[stage].emplace_back(
+                PipelineJobTypeToString(job.type), job.micro_batch, job.chunk);
+          }
+        }
+        return jobs;
+      },
+      py::arg("type"),
+      py::arg("num_stages"),
+      py::arg("num_micro_batches"),
+      py::arg("num_chunks") = 1);
+  m->def(
+      "simulate_pipeline_schedule",
+      [](const std::string& type,
+         int64_t num_stages,
+         int64_t num_micro_batches,
+         int64_t num_chunks,
+         double forward,
+         double backward_input,
+         double backward_weight,
+         double p2p) {
+        PipelineCost cost;
+        cost.forward = forward;
+        cost.backward_input = backward_input;
+        cost.backward_weight = backward_weight;
+        cost.p2p = p2p;
+        auto simulation = SimulatePipelineSchedule(
+            GeneratePipelineSchedule(PipelineScheduleTypeFromString(type),
+                                     num_stages,
+                                     num_micro_batches,
+                                     num_chunks),
+            cost);
+        return std::make_pair(simulation.makespan, simulation.bubble_ratio);
+      },
+      py::arg("type"),
+      py::arg("num_stages"),
+      py::arg("num_micro_batches"),
+      py::arg("num_chunks") = 1,
+      py::arg("forward") = 1.0,
+      py::arg("backward_input") = 1.0,
+      py::arg("backward_weight") = 1.0,
+      py::arg("p2p") = 0.0);
+
   py::class_<DistModelConfig>(*m, "DistModelConfig")
       .def(py::init<>())
       .def_readwrite("model_dir", &DistModelConfig::model_dir)
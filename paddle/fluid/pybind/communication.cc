@@ -29,6 +29,9 @@ limitations under the License. */
 #include <string>
 
 #include "paddle/phi/core/distributed/comm_context_manager.h"
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include "paddle/phi/core/distributed/comm_stats.h"
+#endif
 #include "paddle/phi/core/distributed/store/store_utils.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
@@ -84,6 +87,29 @@ void BindCommContextManager(py::module *m) {
               py::call_guard<py::gil_scoped_release>())
 #endif
           .def("set_store", &phi::distributed::CommContextManager::SetStore);
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+  m->def("get_comm_stats", []() {
+    auto stats = phi::distributed::CommStatsManager::GetInstance().GetStats();
+    py::list result;
+    for (const auto &op_stats : stats) {
+      py::dict item;
+      item["group_key"] = op_stats.group_key;
+      item["op"] = phi::distributed::CommTypeToString(op_stats.comm_type);
+      item["count"] = op_stats.count;
+      item["bytes"] = op_stats.bytes;
+      item["total_us"] = op_stats.total_us;
+      item["min_us"] = op_stats.min_us;
+      item["max_us"] = op_stats.max_us;
+      item["buckets"] = op_stats.buckets;
+      result.append(item);
+    }
+    return result;
+  });
+  m->def("reset_comm_stats", []() {
+    phi::distributed::CommStatsManager::GetInstance().Reset();
+  });
+#endif
 }
 
 using TCPStore = phi::distributed::TCPStore;
@@ -119,22 +145,60 @@ void BindTCPStore(py::module *m) {
                         py::call_guard<py::gil_scoped_release>())
                    .def("wait",
                         &phi::distributed::Store::wait,
-                        py::call_guard<py::gil_scoped_release>());
+                        py::call_guard<py::gil_scoped_release>())
+                   .def("multi_wait",
+                        &phi::distributed::Store::multi_wait,
+                        py::arg("keys"),
+                        py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "multi_get",
+                       [](phi::distributed::Store &self,
+                          const std::vector<std::string> &keys) {
+                         auto values = self.multi_get(keys);
+                         py::gil_scoped_acquire acquire;
+                         py::list result;
+                         for (const auto &value : values) {
+                           result.append(py::bytes(
+                               std::string(value.begin(), value.end())));
+                         }
+                         return result;
+                       },
+                       py::arg("keys"),
+                       py::call_guard<py::gil_scoped_release>())
+                   .def(
+                       "wait_prefix",
+                       [](phi::distributed::Store &self,
+                          const std::string &prefix,
+                          size_t count) {
+                         auto entries = self.wait_prefix(prefix, count);
+                         py::gil_scoped_acquire acquire;
+                         py::dict result;
+                         for (const auto &entry : entries) {
+                           result[py::str(entry.first)] = py::bytes(std::string(
+                               entry.second.begin(), entry.second.end()));
+                         }
+                         return result;
+                       },
+                       py::arg("prefix"),
+                       py::arg("count"),
+                       py::call_guard<py::gil_scoped_release>());
 
   py::class_<TCPStore, std::shared_ptr<TCPStore>>(*m, "TCPStore", Store)
       .def(py::init([](std::string hostname,
                        uint16_t port,
                        bool is_master,
                        size_t world_size,
-                       int timeout) {
+                       int timeout,
+                       uint16_t relay_port) {
              return std::make_shared<TCPStore>(
-                 hostname, port, is_master, world_size, timeout);
+                 hostname, port, is_master, world_size, timeout, relay_port);
            }),
            py::arg("hostname"),
            py::arg("port"),
            py::arg("is_master"),
            py::arg("world_size"),
            py::arg("timeout") = 900,
+           py::arg("relay_port") = 0,
            py::call_guard<py::gil_scoped_release>());
 
   m->def("create_or_get_global_tcp_store",
@@ -22,6 +22,7 @@ limitations under the License. */
 #endif
 
 #include "paddle/fluid/distributed/collective/process_group.h"
+#include "paddle/fluid/distributed/collective/param_sharding.h"
 #include "paddle/fluid/distributed/collective/reducer.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/tensor.h"
@@ -1257,7 +1258,12 @@ void BindDistributed(py::module *m) {
                   py::arg("nccl_comm_init_option") = 0,
                   py::call_guard<py::gil_scoped_release>())
       .def_static("group_start", distributed::ProcessGroupNCCL::GroupStart)
-      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd);
+      .def_static("group_end", distributed::ProcessGroupNCCL::GroupEnd)
+      .def("set_hierarchical_allreduce",
+           &distributed::ProcessGroupNCCL::SetHierarchicalAllReduce,
+           py::arg("enable") = true)
+      .def("hierarchical_allreduce",
+           &distributed::ProcessGroupNCCL::HierarchicalAllReduceEnabled);
 
   py::class_<distributed::AsyncLoad::Task,
              std::shared_ptr<distributed::AsyncLoad::Task>>(*m, "AsyncLoadTask")
@@ -1423,7 +1429,60 @@ void BindDistributed(py::module *m) {
             self.PrepareForBackward(params);
           },
           py::arg("tensors"),
-          py::call_guard<py::gil_scoped_release>());
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "set_grad_compression",
+          [](distributed::EagerReducer &self,
+             const std::string &codec,
+             double topk_ratio,
+             int powersgd_rank,
+             bool error_feedback) {
+            self.SetGradCompressor(
+                codec == "none"
+                    ? nullptr
+                    : distributed::CreateGradCompressor(
+                          codec, topk_ratio, powersgd_rank, error_feedback));
+          },
+          py::arg("codec"),
+          py::arg("topk_ratio") = 0.01,
+          py::arg("powersgd_rank") = 4,
+          py::arg("error_feedback") = true,
+          py::call_guard<py::gil_scoped_release>())
+      .def_property_readonly("comm_bytes",
+                             &distributed::EagerReducer::comm_bytes)
+      .def("set_grad_as_bucket_view",
+           &distributed::EagerReducer::SetGradAsBucketView,
+           py::arg("grad_as_bucket_view"),
+           py::call_guard<py::gil_scoped_release>());
+
+  py::class_<distributed::EagerParamSharding,
+             std::shared_ptr<distributed::EagerParamSharding>>(
+      *m, "EagerParamSharding", R"DOC()DOC")
+      .def(py::init([](py::handle py_units,
+                       std::shared_ptr<distributed::ProcessGroup> process_group,
+                       int prefetch_depth,
+                       bool reshard_after_forward) {
+             std::vector<std::vector<Tensor>> units;
+             for (auto py_unit : py_units) {
+               units.emplace_back(
+                   CastPyArg2VectorOfTensor(py_unit.ptr(), 0));
+             }
+             return std::make_shared<distributed::EagerParamSharding>(
+                 units, process_group, prefetch_depth, reshard_after_forward);
+           }),
+           py::arg("units"),
+           py::arg("process_group"),
+           py::arg("prefetch_depth") = 1,
+           py::arg("reshard_after_forward") = true)
+      .def("pre_forward",
+           &distributed::EagerParamSharding::PreForward,
+           py::arg("unit_index"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("post_forward",
+           &distributed::EagerParamSharding::PostForward,
+           py::arg("unit_index"),
+           py::call_guard<py::gil_scoped_release>())
+      .def("shards", &distributed::EagerParamSharding::Shards);
 
   py::class_<distributed::ProcessGroupIdMap,
              std::shared_ptr<distributed::ProcessGroupIdMap>>(
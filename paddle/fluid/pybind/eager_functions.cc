@@ -21,6 +21,7 @@ typedef SSIZE_T ssize_t;
 #undef copysign
 #endif
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,6 +31,7 @@ typedef SSIZE_T ssize_t;
 #include "paddle/fluid/eager/autograd_meta.h"
 #include "paddle/fluid/eager/backward.h"
 #include "paddle/fluid/eager/custom_operator/custom_operator_node.h"
+#include "paddle/fluid/eager/grad_object_pool.h"
 #include "paddle/fluid/eager/utils.h"
 #include "paddle/fluid/framework/convert_utils.h"
 #include "paddle/fluid/framework/custom_operator.h"
@@ -60,6 +62,9 @@ typedef SSIZE_T ssize_t;
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 #include "paddle/fluid/pybind/cuda_streams_py.h"
+#include "paddle/phi/api/profiler/event.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/platform/cuda_device_guard.h"
 #endif
 
 #include "paddle/common/flags.h"
@@ -1323,6 +1328,160 @@ static PyObject* eager_api_to_uva_tensor(PyObject* self,
 }
 #endif
 
+static phi::DataType NumpyArrayDataType(const py::array& array) {
+  if (py::isinstance<py::array_t<float>>(array)) {
+    return phi::DataType::FLOAT32;
+  } else if (py::isinstance<py::array_t<int>>(array)) {
+    return phi::DataType::INT32;
+  } else if (py::isinstance<py::array_t<int64_t>>(array)) {
+    return phi::DataType::INT64;
+  } else if (py::isinstance<py::array_t<double>>(array)) {
+    return phi::DataType::FLOAT64;
+  } else if (py::isinstance<py::array_t<int8_t>>(array)) {
+    return phi::DataType::INT8;
+  } else if (py::isinstance<py::array_t<int16_t>>(array)) {
+    return phi::DataType::INT16;
+  } else if (py::isinstance<py::array_t<uint8_t>>(array)) {
+    return phi::DataType::UINT8;
+  } else if (py::isinstance<py::array_t<phi::dtype::float16>>(array)) {
+    return phi::DataType::FLOAT16;
+  } else if (py::isinstance<py::array_t<phi::dtype::complex<float>>>(array)) {
+    return phi::DataType::COMPLEX64;
+  } else if (py::isinstance<py::array_t<phi::dtype::complex<double>>>(array)) {
+    return phi::DataType::COMPLEX128;
+  } else if (py::isinstance<py::array_t<uint16_t>>(array)) {
+    // since there is still no support for bfloat16 in NumPy,
+    // uint16 is used for casting bfloat16
+    return phi::DataType::BFLOAT16;
+  } else if (py::isinstance<py::array_t<bool>>(array)) {
+    return phi::DataType::BOOL;
+  }
+  PADDLE_THROW(common::errors::InvalidArgument(
+      "Incompatible array data type. tensors_from_numpy supports array with "
+      "bool, float16, float32, float64, int8, int16, int32, int64, uint8, "
+      "uint16, complex64 or complex128."));
+}
+
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+// The pinned buffer the arrays are gathered in before they are copied to a
+// device, it is reused once the previous copy is done.
+struct PinnedStaging {
+  std::mutex mutex;
+  std::shared_ptr<phi::Allocation> buffer;
+  std::unique_ptr<phi::CudaEvent> copied;
+};
+
+static PinnedStaging& GetPinnedStaging() {
+  static PinnedStaging* staging = new PinnedStaging();
+  return *staging;
+}
+#endif
+
+static PyObject* eager_api_tensors_from_numpy(PyObject* self,
+                                              PyObject* args,
+                                              PyObject* kwargs) {
+  EAGER_TRY
+  // each tensor starts at an aligned offset of the shared allocation
+  constexpr size_t kAlignment = 256;
+  PyObject* py_arrays = PyTuple_GET_ITEM(args, 0);
+  auto place = CastPyArg2Place(PyTuple_GET_ITEM(args, 1), 1);
+
+  std::vector<py::array> arrays;
+  std::vector<phi::DenseTensorMeta> metas;
+  std::vector<size_t> offsets;
+  size_t total_bytes = 0;
+  for (auto item : py::handle(py_arrays)) {
+    auto array = py::array::ensure(item, py::array::c_style);
+    PADDLE_ENFORCE_EQ(
+        static_cast<bool>(array),
+        true,
+        common::errors::InvalidArgument(
+            "tensors_from_numpy expects a list of numpy arrays."));
+    std::vector<int64_t> dims(array.shape(), array.shape() + array.ndim());
+    metas.emplace_back(NumpyArrayDataType(array), common::make_ddim(dims));
+    offsets.push_back(total_bytes);
+    total_bytes += (array.nbytes() + kAlignment - 1) / kAlignment * kAlignment;
+    arrays.push_back(std::move(array));
+  }
+
+  std::shared_ptr<phi::Allocation> holder;
+  {
+    eager_gil_scoped_release guard;
+    if (phi::is_cpu_place(place)) {
+      holder = paddle::memory::AllocShared(place, total_bytes);
+      auto* dst = static_cast<uint8_t*>(holder->ptr());
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        std::memcpy(dst + offsets[i], arrays[i].data(), arrays[i].nbytes());
+      }
+    } else if (phi::is_gpu_place(place)) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+      platform::CUDADeviceGuard device_guard(place.GetDeviceId());
+      auto* dev_ctx = static_cast<phi::GPUContext*>(
+          phi::DeviceContextPool::Instance().Get(place));
+      holder = paddle::memory::AllocShared(place, total_bytes);
+
+      auto& staging = GetPinnedStaging();
+      std::lock_guard<std::mutex> staging_guard(staging.mutex);
+      if (staging.copied) {
+        staging.copied->Synchronize();
+      } else {
+        staging.copied = std::make_unique<phi::CudaEvent>();
+      }
+      if (!staging.buffer || staging.buffer->size() < total_bytes) {
+        staging.buffer.reset();
+        staging.buffer =
+            paddle::memory::AllocShared(phi::GPUPinnedPlace(), total_bytes);
+      }
+      auto* src = static_cast<uint8_t*>(staging.buffer->ptr());
+      for (size_t i = 0; i < arrays.size(); ++i) {
+        std::memcpy(src + offsets[i], arrays[i].data(), arrays[i].nbytes());
+      }
+      paddle::memory::Copy(phi::GPUPlace(place.GetDeviceId()),
+                           holder->ptr(),
+                           phi::GPUPinnedPlace(),
+                           src,
+                           total_bytes,
+                           dev_ctx->stream());
+      staging.copied->Record(dev_ctx->stream());
+#endif
+    } else {
+      PADDLE_THROW(common::errors::Unimplemented(
+          "tensors_from_numpy only supports CPUPlace and CUDAPlace, but got "
+          "%s.",
+          place));
+    }
+  }
+
+  std::vector<paddle::Tensor> tensors;
+  tensors.reserve(arrays.size());
+  for (size_t i = 0; i < arrays.size(); ++i) {
+    metas[i].offset = offsets[i];
+    tensors.emplace_back(std::make_shared<phi::DenseTensor>(holder, metas[i]),
+                         egr::Controller::Instance().GenerateUniqueName());
+  }
+  return ToPyObject(tensors);
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
+static PyObject* eager_api_grad_object_pool_stats(PyObject* self,
+                                                  PyObject* args,
+                                                  PyObject* kwargs) {
+  EAGER_TRY
+  // the grad graph objects allocated in the last backward step
+  auto stats = egr::GradObjectPool::LastStepStats();
+  PyObject* dict = PyDict_New();
+  auto set_item = [dict](const char* key, int64_t value) {
+    PyObject* item = ToPyObject(value);
+    PyDict_SetItemString(dict, key, item);
+    Py_DECREF(item);
+  };
+  set_item("allocated", stats.allocated);
+  set_item("reused", stats.reused);
+  set_item("bytes", stats.bytes);
+  return dict;
+  EAGER_CATCH_AND_THROW_RETURN_NULL
+}
+
 static PyObject* eager_api__add_backward_final_hook(PyObject* self,
                                                     PyObject* args,
                                                     PyObject* kwargs) {
@@ -1452,6 +1611,14 @@ PyMethodDef variable_functions[] = {  // NOLINT
      (PyCFunction)(void (*)())eager__is_run_in_backward,
      METH_VARARGS | METH_KEYWORDS,
      nullptr},
+    {"tensors_from_numpy",
+     (PyCFunction)(void (*)())eager_api_tensors_from_numpy,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
+    {"_grad_object_pool_stats",
+     (PyCFunction)(void (*)())eager_api_grad_object_pool_stats,
+     METH_VARARGS | METH_KEYWORDS,
+     nullptr},
 /**sparse functions**/
 #if defined(PADDLE_WITH_CUDA)
     {"async_read",
@@ -34,6 +34,7 @@ limitations under the License. */
 #include "paddle/fluid/distributed/ps/wrapper/fleet.h"
 #include "paddle/fluid/framework/fleet/heter_ps/graph_gpu_wrapper.h"
 #include "paddle/fluid/pybind/fleet_py.h"
+#include "pybind11/numpy.h"
 
 namespace py = pybind11;
 using paddle::distributed::CommContext;
@@ -68,6 +69,8 @@ void BindDistFleetWrapper(py::module* m) {
       .def("stop_worker", &FleetWrapper::FinalizeWorker)
       .def("barrier", &FleetWrapper::BarrierWithTable)
       .def("shrink_sparse_table", &FleetWrapper::ShrinkSparseTable)
+      .def("rebalance_sparse_table", &FleetWrapper::RebalanceSparseTable)
+      .def("migrate_sparse_shard", &FleetWrapper::MigrateSparseShard)
       .def("set_clients", &FleetWrapper::SetClients)
       .def("get_client_info", &FleetWrapper::GetClientsInfo)
       .def("create_client2client_connection",
@@ -186,7 +189,25 @@ void BindDistCommunicator(py::module* m) {
       .def("set_clients", &Communicator::SetClients)
       .def("start_coordinator", &Communicator::StartCoordinator)
       .def("query_fl_clients_info", &Communicator::QueryFLClientsInfo)
-      .def("save_fl_strategy", &Communicator::SaveFLStrategy);
+      .def("save_fl_strategy", &Communicator::SaveFLStrategy)
+      .def("get_send_stats", [](Communicator& self) {
+        std::map<std::string, std::map<std::string, double>> stats;
+        for (auto& iter : self.GetSendStats()) {
+          auto& stat = iter.second;
+          stats[iter.first] = {
+              {"send_num", static_cast<double>(stat.send_num)},
+              {"merged_var_num", static_cast<double>(stat.merged_var_num)},
+              {"rpc_ms", stat.rpc_ms},
+              {"max_rpc_ms", stat.max_rpc_ms},
+              {"rpc_ms_ewma", stat.rpc_ms_ewma},
+              {"queue_size", static_cast<double>(stat.queue_size)},
+              {"max_queue_size", static_cast<double>(stat.max_queue_size)},
+              {"queue_full_waits", static_cast<double>(stat.queue_full_waits)},
+              {"merge_window", static_cast<double>(stat.merge_window)},
+              {"send_concurrency", static_cast<double>(stat.send_concurrency)}};
+        }
+        return stats;
+      });
 }
 
 void BindHeterClient(py::module* m) {
@@ -451,6 +472,58 @@ void BindIndexSampler(py::module* m) {
       }))
       .def("init_layerwise_conf", &IndexSampler::init_layerwise_conf)
       .def("init_beamsearch_conf", &IndexSampler::init_beamsearch_conf)
-      .def("sample", &IndexSampler::sample);
+      .def("sample", &IndexSampler::sample)
+      .def(
+          "sample_batch",
+          [](IndexSampler& self,
+             const py::array_t<uint64_t,
+                               py::array::c_style | py::array::forcecast>&
+                 user_inputs,
+             const py::array_t<uint64_t,
+                               py::array::c_style | py::array::forcecast>&
+                 target_ids,
+             bool with_hierarchy,
+             bool share_negatives,
+             int num_threads) {
+            PADDLE_ENFORCE_EQ(
+                user_inputs.ndim(),
+                2,
+                common::errors::InvalidArgument(
+                    "user_inputs should be 2-D, but received %d-D.",
+                    user_inputs.ndim()));
+            auto input_num = static_cast<size_t>(user_inputs.shape(0));
+            auto feature_num = static_cast<size_t>(user_inputs.shape(1));
+            PADDLE_ENFORCE_EQ(
+                static_cast<size_t>(target_ids.size()),
+                input_num,
+                common::errors::InvalidArgument(
+                    "target_ids should have %d ids, one for each row of "
+                    "user_inputs, but received %d.",
+                    input_num,
+                    target_ids.size()));
+            py::array_t<uint64_t> outputs(
+                {static_cast<size_t>(self.rows_per_input()) * input_num,
+                 feature_num + 2});
+            auto* user_data = user_inputs.data();
+            auto* target_data = target_ids.data();
+            auto* out_data = outputs.mutable_data();
+            {
+              py::gil_scoped_release release;
+              self.sample_batch(user_data,
+                                target_data,
+                                input_num,
+                                feature_num,
+                                with_hierarchy,
+                                share_negatives,
+                                num_threads,
+                                out_data);
+            }
+            return outputs;
+          },
+          py::arg("user_inputs"),
+          py::arg("target_ids"),
+          py::arg("with_hierarchy") = false,
+          py::arg("share_negatives") = false,
+          py::arg("num_threads") = 1);
 }
 }  // namespace paddle::pybind
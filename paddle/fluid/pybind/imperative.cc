@@ -611,6 +611,77 @@ void BindImperative(py::module *m_ptr) {
     memory::allocation::MemoryMapAllocationPool::Instance().SetMaxPoolSize(
         size);
   });
+
+  // DataLoader workers pack the tensors of a batch into a segment of the
+  // shm ring, returns None when the ring is disabled or full.
+  m.def("_pack_tensors_to_shm_ring", [](py::list &tensor_list) -> py::object {
+    auto &ring = memory::allocation::MemoryMapRing::Instance();
+    if (!ring.IsEnabled()) {
+      return py::none();
+    }
+    std::vector<phi::DenseTensor> tensors;
+    std::vector<size_t> offsets;
+    size_t data_size = 0;
+    for (auto &&item : tensor_list) {
+      auto t = item.cast<phi::DenseTensor>();
+      if (!t.IsInitialized() || !t.meta().is_contiguous() ||
+          !phi::is_cpu_place(t.place())) {
+        return py::none();
+      }
+      data_size = (data_size + memory::allocation::mmap_alignment - 1) /
+                  memory::allocation::mmap_alignment *
+                  memory::allocation::mmap_alignment;
+      offsets.push_back(data_size);
+      data_size += t.numel() * phi::SizeOf(t.dtype());
+      tensors.emplace_back(std::move(t));
+    }
+    auto segment = ring.Acquire(std::max<size_t>(data_size, 1));
+    if (segment == nullptr) {
+      return py::none();
+    }
+
+    py::list metas;
+    for (size_t i = 0; i < tensors.size(); ++i) {
+      auto &t = tensors[i];
+      memory::Copy(phi::CPUPlace(),
+                   static_cast<char *>(segment->data()) + offsets[i],
+                   phi::CPUPlace(),
+                   t.data(),
+                   t.numel() * phi::SizeOf(t.dtype()));
+      metas.append(py::make_tuple(offsets[i],
+                                  static_cast<int>(t.dtype()),
+                                  common::vectorize(t.dims()),
+                                  t.lod()));
+    }
+    return py::make_tuple(
+        segment->ipc_name(), segment->size(), data_size, metas);
+  });
+
+  // The main process builds the tensors of a batch packed by
+  // _pack_tensors_to_shm_ring in place.
+  m.def("_unpack_tensors_from_shm_ring",
+        [](py::tuple &meta, bool pin_memory) -> py::list {
+          auto holder = memory::allocation::MemoryMapRing::Instance().Open(
+              meta[0].cast<std::string>(),
+              meta[1].cast<size_t>(),
+              meta[2].cast<size_t>(),
+              pin_memory);
+          py::list tensors;
+          for (auto &&item : meta[3].cast<py::list>()) {
+            auto tensor_meta = item.cast<py::tuple>();
+            phi::DenseTensorMeta dense_meta(
+                static_cast<phi::DataType>(tensor_meta[1].cast<int>()),
+                common::make_ddim(tensor_meta[2].cast<std::vector<int64_t>>()));
+            dense_meta.offset = tensor_meta[0].cast<size_t>();
+            phi::DenseTensor t(holder, dense_meta);
+            t.set_lod(tensor_meta[3].cast<phi::LegacyLoD>());
+            tensors.append(t);
+          }
+          return tensors;
+        });
+
+  m.def("_clear_shm_ring",
+        []() { memory::allocation::MemoryMapRing::Instance().Clear(); });
 #endif
 
   m.def("start_imperative_gperf_profiler",
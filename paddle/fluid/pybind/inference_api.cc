@@ -50,6 +50,10 @@
 #include "paddle/fluid/inference/api/onnxruntime_predictor.h"
 #endif
 
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+#endif
+
 namespace py = pybind11;  // NOLINT
 
 namespace pybind11::detail {
@@ -546,6 +550,17 @@ void BindInferenceApi(py::module *m) {
   m->def("get_trt_compile_version", &paddle_infer::GetTrtCompileVersion);
   m->def("get_trt_runtime_version", &paddle_infer::GetTrtRuntimeVersion);
   m->def("get_num_bytes_of_data_type", &paddle_infer::GetNumBytesOfDataType);
+#ifdef PADDLE_WITH_DNNL
+  m->def("get_mkldnn_primitive_cache_stats", []() {
+    auto stats = phi::OneDNNPrimitiveCache::Instance().GetStats();
+    std::map<std::string, int64_t> result;
+    result["hits"] = static_cast<int64_t>(stats.hits);
+    result["misses"] = static_cast<int64_t>(stats.misses);
+    result["num_entries"] = static_cast<int64_t>(stats.num_entries);
+    result["memory_bytes"] = stats.memory_bytes;
+    return result;
+  });
+#endif
   m->def("convert_to_mixed_precision_bind",
          &paddle_infer::ConvertToMixedPrecision,
          py::arg("model_file"),
@@ -792,6 +807,10 @@ void BindAnalysisConfig(py::module *m) {
            py::arg("device_id") = 0,
            py::arg("precision_mode") = AnalysisConfig::Precision::kFloat32)
       .def("exp_enable_use_cutlass", &AnalysisConfig::Exp_EnableUseCutlass)
+      .def("exp_set_weight_only_quant",
+           &AnalysisConfig::Exp_SetWeightOnlyQuant,
+           py::arg("algo"),
+           py::arg("group_size") = -1)
       .def("exp_disable_mixed_precision_ops",
            &AnalysisConfig::Exp_DisableMixedPrecisionOps)
       .def("exp_enable_mixed_precision_ops",
@@ -868,12 +887,31 @@ void BindAnalysisConfig(py::module *m) {
       .def("enable_memory_optim",
            &AnalysisConfig::EnableMemoryOptim,
            py::arg("x") = true)
+      .def("enable_activation_memory_sharing",
+           &AnalysisConfig::EnableActivationMemorySharing,
+           py::arg("x") = true)
+      .def("activation_memory_sharing",
+           &AnalysisConfig::activation_memory_sharing)
       .def("enable_new_executor",
            &AnalysisConfig::EnableNewExecutor,
            py::arg("x") = true)
+      .def("enable_scope_arena",
+           &AnalysisConfig::EnableScopeArena,
+           py::arg("x") = true)
+      .def("scope_arena_enabled", &AnalysisConfig::scope_arena_enabled)
+      .def("enable_cuda_graph",
+           &AnalysisConfig::EnableCUDAGraph,
+           py::arg("max_num_graphs") = 8)
+      .def("cuda_graph_enabled", &AnalysisConfig::cuda_graph_enabled)
+      .def("cuda_graph_max_num_graphs",
+           &AnalysisConfig::cuda_graph_max_num_graphs)
       .def("enable_new_ir", &AnalysisConfig::EnableNewIR, py::arg("x") = true)
       .def("new_ir_enabled", &AnalysisConfig::new_ir_enabled)
       .def("enable_profile", &AnalysisConfig::EnableProfile)
+      .def("enable_run_telemetry",
+           &AnalysisConfig::EnableRunTelemetry,
+           py::arg("x") = true)
+      .def("run_telemetry_enabled", &AnalysisConfig::run_telemetry_enabled)
       .def("disable_glog_info", &AnalysisConfig::DisableGlogInfo)
       .def("glog_info_disabled", &AnalysisConfig::glog_info_disabled)
       .def("enable_save_optim_model",
@@ -927,6 +965,12 @@ void BindAnalysisConfig(py::module *m) {
       .def("shape_range_info_path", &AnalysisConfig::shape_range_info_path)
       .def("shape_range_info_collected",
            &AnalysisConfig::shape_range_info_collected)
+      .def("set_trt_shape_profile_num", &AnalysisConfig::SetTRTShapeProfileNum)
+      .def("trt_shape_profile_num", &AnalysisConfig::trt_shape_profile_num)
+      .def("enable_warmup",
+           &AnalysisConfig::EnableWarmup,
+           py::arg("shape_range_info_path") = "")
+      .def("warmup_enabled", &AnalysisConfig::warmup_enabled)
       .def("enable_tuned_tensorrt_dynamic_shape",
            &AnalysisConfig::EnableTunedTensorRtDynamicShape,
            py::arg("shape_range_info_path") = "",
@@ -973,12 +1017,21 @@ void BindAnalysisConfig(py::module *m) {
            &AnalysisConfig::SetCpuMathLibraryNumThreads)
       .def("cpu_math_library_num_threads",
            &AnalysisConfig::cpu_math_library_num_threads)
+      .def("enable_numa_sharding",
+           &AnalysisConfig::EnableNumaSharding,
+           py::arg("x") = true)
+      .def("numa_sharding_enabled", &AnalysisConfig::numa_sharding_enabled)
       .def("to_native_config", &AnalysisConfig::ToNativeConfig)
       .def("enable_mkldnn_bfloat16", &AnalysisConfig::EnableMkldnnBfloat16)
 #ifdef PADDLE_WITH_DNNL
       .def("set_mkldnn_cache_capacity",
            &AnalysisConfig::SetMkldnnCacheCapacity,
            py::arg("capacity") = 0)
+      .def("enable_mkldnn_primitive_sharing",
+           &AnalysisConfig::EnableMkldnnPrimitiveSharing,
+           py::arg("x") = true)
+      .def("mkldnn_primitive_sharing_enabled",
+           &AnalysisConfig::mkldnn_primitive_sharing_enabled)
       .def("set_bfloat16_op", &AnalysisConfig::SetBfloat16Op)
       .def("enable_mkldnn_int8",
            &AnalysisConfig::EnableMkldnnInt8,
@@ -1005,6 +1058,10 @@ void BindAnalysisConfig(py::module *m) {
       .def("set_mkldnn_op", &AnalysisConfig::SetMKLDNNOp)
       .def("set_model_buffer", &AnalysisConfig::SetModelBuffer)
       .def("model_from_memory", &AnalysisConfig::model_from_memory)
+      .def("enable_mmap_params",
+           &AnalysisConfig::EnableMmapParams,
+           py::arg("x") = true)
+      .def("mmap_params_enabled", &AnalysisConfig::mmap_params_enabled)
       .def("delete_pass", &AnalysisConfig::DeletePass)
       .def(
           "pass_builder",
@@ -1139,6 +1196,7 @@ void BindPaddleInferPredictor(py::module *m) {
            })
 #endif
       .def("try_shrink_memory", &paddle_infer::Predictor::TryShrinkMemory)
+      .def("get_run_telemetry", &paddle_infer::Predictor::GetRunTelemetry)
       .def("clear_intermediate_tensor",
            &paddle_infer::Predictor::ClearIntermediateTensor)
       .def("register_output_hook", &paddle_infer::Predictor::RegisterOutputHook)
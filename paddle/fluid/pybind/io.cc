@@ -14,6 +14,7 @@ limitations under the License. */
 
 #include "paddle/fluid/pybind/io.h"
 
+#include "paddle/fluid/framework/io/async_checkpoint_writer.h"
 #include "paddle/fluid/framework/io/save_load_tensor.h"
 #include "paddle/fluid/framework/lod_tensor.h"
 #include "paddle/fluid/framework/selected_rows_utils.h"
@@ -141,6 +142,50 @@ void BindIO(pybind11::module *m) {
     return tensor_load;
   });
 
+  m->def("load_tensors", [](const std::string &path) {
+    std::vector<std::string> names;
+    std::vector<phi::DenseTensor> tensors;
+    paddle::framework::LoadTensors(path, &names, &tensors);
+    std::unordered_map<std::string, phi::DenseTensor> name_to_tensor;
+    for (size_t i = 0; i < names.size(); ++i) {
+      name_to_tensor[names[i]] = std::move(tensors[i]);
+    }
+    return name_to_tensor;
+  });
+
+  m->def("is_tensors_file", &paddle::framework::IsTensorsFile);
+
+  py::class_<paddle::framework::AsyncCheckpointWriter>(*m,
+                                                       "AsyncCheckpointWriter")
+      .def(py::init<int>(), py::arg("num_threads"))
+      .def(
+          "save",
+          [](paddle::framework::AsyncCheckpointWriter &self,
+             const std::vector<std::string> &names,
+             const std::vector<paddle::Tensor> &tensors,
+             const std::string &file_path) {
+            std::vector<const phi::DenseTensor *> dense_tensors;
+            dense_tensors.reserve(tensors.size());
+            for (const auto &tensor : tensors) {
+              PADDLE_ENFORCE_EQ(
+                  tensor.is_dense_tensor() && tensor.initialized(),
+                  true,
+                  common::errors::InvalidArgument(
+                      "Tensor %s to save must be an initialized DenseTensor.",
+                      tensor.name()));
+              dense_tensors.push_back(
+                  static_cast<const phi::DenseTensor *>(tensor.impl().get()));
+            }
+            self.Save(names, dense_tensors, file_path);
+          },
+          py::arg("names"),
+          py::arg("tensors"),
+          py::arg("file_path"))
+      .def("wait",
+           &paddle::framework::AsyncCheckpointWriter::Wait,
+           py::call_guard<py::gil_scoped_release>())
+      .def("pending", &paddle::framework::AsyncCheckpointWriter::Pending);
+
   m->def("save_func", &pir::SaveFunction);
 
   m->def("save_combine_func", &pir::SaveCombineFunction);
@@ -167,7 +212,8 @@ void BindIO(pybind11::module *m) {
          py::arg("pir_version"),
          py::arg("overwrite") = true,
          py::arg("readable") = false,
-         py::arg("trainable") = true);
+         py::arg("trainable") = true,
+         py::arg("binary") = false);
   m->def("deserialize_pir_program",
          &pir::ReadModule,
          py::arg("file_path"),
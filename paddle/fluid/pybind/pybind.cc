@@ -54,8 +54,11 @@ limitations under the License. */
 #include "paddle/fluid/framework/ir/cost_model.h"
 #include "paddle/fluid/framework/ir/generate_pass.h"
 #include "paddle/fluid/framework/ir/pass_builder.h"
+#include "paddle/fluid/framework/new_executor/async_fetcher.h"
 #include "paddle/fluid/framework/new_executor/collect_shape_manager.h"
 #include "paddle/fluid/framework/new_executor/executor_statistics.h"
+#include "paddle/fluid/framework/new_executor/feed_prefetcher.h"
+#include "paddle/fluid/framework/new_executor/instruction_statistics.h"
 #include "paddle/fluid/framework/new_executor/interpreter/job.h"
 #include "paddle/fluid/framework/new_executor/interpreter/plan.h"
 #include "paddle/fluid/framework/new_executor/standalone_executor.h"
@@ -121,6 +124,7 @@ limitations under the License. */
 #include "paddle/fluid/pybind/pybind_variant_caster.h"
 #include "paddle/fluid/pybind/python_callable_registry.h"
 #include "paddle/fluid/pybind/xpu_streams_py.h"
+#include "paddle/phi/api/profiler/host_event_ring.h"
 #include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/backends/device_manager.h"
 #include "paddle/phi/backends/dynload/dynamic_loader.h"
@@ -1259,6 +1263,99 @@ PYBIND11_MODULE(libpaddle, m) {
     return ptensor;
   });
 
+  m.def("_from_cuda_array_interface", [](py::object obj) {
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+    py::dict interface = obj.attr("__cuda_array_interface__");
+    auto typestr = interface["typestr"].cast<std::string>();
+    PADDLE_ENFORCE_EQ(typestr.size() >= 3 && typestr[0] != '>',
+                      true,
+                      common::errors::InvalidArgument(
+                          "Unsupported typestr %s of __cuda_array_interface__",
+                          typestr));
+    ::DLDataType dtype;
+    dtype.lanes = 1;
+    int itemsize = std::stoi(typestr.substr(2));
+    dtype.bits = static_cast<uint8_t>(itemsize * 8);
+    switch (typestr[1]) {
+      case 'f':
+        dtype.code = kDLFloat;
+        break;
+      case 'i':
+        dtype.code = kDLInt;
+        break;
+      case 'u':
+        dtype.code = kDLUInt;
+        break;
+      case 'b':
+        dtype.code = kDLBool;
+        break;
+      case 'c':
+        dtype.code = kDLComplex;
+        break;
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Unsupported typestr %s of __cuda_array_interface__", typestr));
+    }
+
+    // keeps the exporter alive until the tensor is released
+    struct CudaArrayInterfaceCtx {
+      std::vector<int64_t> shape;
+      std::vector<int64_t> strides;
+      py::object owner;
+      DLManagedTensor tensor;
+    };
+    auto *ctx = new CudaArrayInterfaceCtx;
+    ctx->owner = obj;
+    ctx->shape = interface["shape"].cast<std::vector<int64_t>>();
+    if (interface.contains("strides") && !interface["strides"].is_none()) {
+      // in bytes for the interface but in elements for dlpack
+      for (auto stride : interface["strides"].cast<std::vector<int64_t>>()) {
+        ctx->strides.push_back(stride / itemsize);
+      }
+    }
+    auto data = interface["data"].cast<py::tuple>()[0].cast<uintptr_t>();
+    int device_id = phi::backends::gpu::GetCurrentDeviceId();
+    if (data != 0) {
+#ifdef PADDLE_WITH_HIP
+      hipPointerAttribute_t attr;
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          hipPointerGetAttributes(&attr, reinterpret_cast<void *>(data)));
+#else
+      cudaPointerAttributes attr;
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaPointerGetAttributes(&attr, reinterpret_cast<void *>(data)));
+#endif
+      device_id = attr.device;
+    }
+
+    DLTensor &dl_tensor = ctx->tensor.dl_tensor;
+    dl_tensor.data = reinterpret_cast<void *>(data);
+    dl_tensor.device = {kDLCUDA, device_id};
+    dl_tensor.ndim = static_cast<int32_t>(ctx->shape.size());
+    dl_tensor.dtype = dtype;
+    dl_tensor.shape = ctx->shape.data();
+    dl_tensor.strides = ctx->strides.empty() ? nullptr : ctx->strides.data();
+    dl_tensor.byte_offset = 0;
+    ctx->tensor.manager_ctx = ctx;
+    ctx->tensor.deleter = [](DLManagedTensor *self) {
+      py::gil_scoped_acquire gil;
+      delete static_cast<CudaArrayInterfaceCtx *>(self->manager_ctx);
+    };
+
+    // version 3 names the stream the data is produced on, None means the
+    // data is ready
+    phi::GPUPlace place(device_id);
+    if (interface.contains("stream") && !interface["stream"].is_none()) {
+      framework::DLPackPlaceWaitStream(place,
+                                       interface["stream"].cast<int64_t>());
+    }
+    return paddle::framework::TensorFromDLPack(&ctx->tensor);
+#else
+    PADDLE_THROW(common::errors::Unavailable(
+        "__cuda_array_interface__ is not supported in CPU only version."));
+#endif
+  });
+
   m.def("_create_loaded_parameter",
         [](const py::handle &vec_var_list,
            const Scope &scope,
@@ -2298,6 +2395,45 @@ All parameter, weight, gradient are variables in Paddle.
              return py::cast(std::move(program_desc));
            });
 
+  py::class_<framework::FetchHandle, std::shared_ptr<framework::FetchHandle>>(
+      m, "FetchHandle")
+      .def("is_ready", &framework::FetchHandle::IsReady)
+      .def("wait", [](framework::FetchHandle &self) {
+        framework::FetchList ret;
+        {
+          pybind11::gil_scoped_release release;
+          ret = self.Wait();
+        }
+        return py::cast(std::move(ret));
+      });
+
+  py::class_<framework::AsyncFetcher>(m, "AsyncFetcher")
+      .def(py::init<const phi::Place &>(), py::arg("place"))
+      .def("fetch", &framework::AsyncFetcher::Fetch);
+
+  py::class_<framework::FeedPrefetcher>(m, "FeedPrefetcher")
+      .def(py::init<const phi::Place &, size_t>(),
+           py::arg("place"),
+           py::arg("capacity") = 2)
+      .def("push",
+           [](framework::FeedPrefetcher &self,
+              const std::vector<std::string> &names,
+              const std::vector<phi::DenseTensor> &tensors) {
+             pybind11::gil_scoped_release release;
+             self.Push(names, tensors);
+           })
+      .def("pop",
+           [](framework::FeedPrefetcher &self) {
+             framework::FeedPrefetcher::FeedBatch batch;
+             {
+               pybind11::gil_scoped_release release;
+               batch = self.Pop();
+             }
+             return batch;
+           })
+      .def("size", &framework::FeedPrefetcher::Size)
+      .def("capacity", &framework::FeedPrefetcher::Capacity);
+
   py::class_<framework::interpreter::Job,
              std::shared_ptr<framework::interpreter::Job>>(m, "Job")
       .def(py::init<const std::string &>(), py::arg("type"))
@@ -2332,6 +2468,24 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("get_no_need_buffer_values",
         framework::interpreter::GetNoNeedBufferValues);
 
+  m.def("get_instruction_statistics", []() {
+    py::dict res;
+    for (auto &[op_type, stats] :
+         framework::InstructionStatistics::Instance().Snapshot()) {
+      py::dict item;
+      item["count"] = stats.count;
+      item["dispatch_time_ns"] = stats.dispatch_time;
+      item["infer_meta_time_ns"] = stats.infer_meta_time;
+      item["launch_time_ns"] = stats.launch_time;
+      item["device_samples"] = stats.device_samples;
+      item["device_time_ns"] = stats.device_time;
+      res[py::str(op_type)] = item;
+    }
+    return res;
+  });
+  m.def("reset_instruction_statistics",
+        []() { framework::InstructionStatistics::Instance().Reset(); });
+
   m.def("init_gflags", framework::InitGflags);
   m.def("init_glog", framework::InitGLOG);
   m.def("init_memory_method", framework::InitMemoryMethod);
@@ -2944,6 +3098,22 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("disable_memory_recorder", &paddle::platform::DisableMemoryRecorder);
   m.def("enable_op_info_recorder", &phi::EnableOpInfoRecorder);
   m.def("disable_op_info_recorder", &phi::DisableOpInfoRecorder);
+  m.def("enable_host_event_ring",
+        [](size_t events_per_thread, uint32_t trace_level) {
+          phi::HostEventRing::GetInstance().Enable(events_per_thread,
+                                                   trace_level);
+        });
+  m.def("disable_host_event_ring",
+        []() { phi::HostEventRing::GetInstance().Disable(); });
+  m.def("dump_host_event_ring",
+        [](const std::string &path, uint64_t window_ms) {
+          phi::HostEventRing::GetInstance().Dump(path, window_ms * 1000000);
+        });
+  m.def("dump_host_event_ring_on_signal",
+        [](int signum, const std::string &path_prefix, uint64_t window_ms) {
+          phi::HostEventRing::GetInstance().EnableDumpOnSignal(
+              signum, path_prefix, window_ms * 1000000);
+        });
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
   m.def("set_cublas_switch", phi::SetAllowTF32Cublas);
@@ -3158,6 +3328,14 @@ All parameter, weight, gradient are variables in Paddle.
   m.def("update_autotune_status",
         [] { return phi::autotune::AutoTuneStatus::Instance().Update(); });
 
+  m.def("save_autotune_cache", [](const std::string &path) {
+    return phi::autotune::AutoTuneCache::Instance().SaveToFile(path);
+  });
+
+  m.def("load_autotune_cache", [](const std::string &path) {
+    return phi::autotune::AutoTuneCache::Instance().LoadFromFile(path);
+  });
+
   m.def("autotune_status", [] {
     py::dict res;
     phi::autotune::AutoTuneCache::Instance().UpdateStatus();
@@ -3176,6 +3354,16 @@ All parameter, weight, gradient are variables in Paddle.
 
   m.def("use_layout_autotune",
         [] { return egr::Controller::Instance().UseLayoutAutoTune(); });
+
+  // The ops before which layout autotune transposed back to the default
+  // layout, with the number of transposes.
+  m.def("layout_autotune_transpose_report", [] {
+    return imperative::LayoutAutoTune::Instance().TransposeBackReport();
+  });
+
+  m.def("clear_layout_autotune_transpose_report", [] {
+    imperative::LayoutAutoTune::Instance().ClearTransposeBackReport();
+  });
   // Add the api for nan op debug
   m.def("set_nan_inf_stack_limit",
         &paddle::framework::details::SetNanInfStackLimit);
@@ -430,7 +430,11 @@ void BindTensor(pybind11::module &m) {  // NOLINT
            )DOC")
       .def(
           "_to_dlpack",
-          [](phi::DenseTensor &self) {
+          [](phi::DenseTensor &self, int64_t stream) {
+            // -1 means the consumer synchronizes by itself
+            if (stream != -1) {
+              framework::DLPackStreamWaitPlace(stream, self.place());
+            }
             DLManagedTensor *dlMTensor = framework::toDLPack(self);
             auto capsule = pybind11::capsule(
                 static_cast<void *>(dlMTensor), "dltensor", [](PyObject *data) {
@@ -443,7 +447,8 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                   dlMTensor->deleter(dlMTensor);
                 });
             return capsule;
-          })
+          },
+          py::arg("stream") = -1)
       .def("_set_float_element", TensorSetElement<float>)
       .def("_get_float_element", TensorGetElement<float>)
       .def("_set_double_element", TensorSetElement<double>)
@@ -812,6 +817,97 @@ void BindTensor(pybind11::module &m) {  // NOLINT
                     >>> metainfo = tensor.value().get_tensor()._share_cuda()
                     >>> tensor_from_shared = paddle.to_tensor(paddle.base.core.DenseTensor._new_shared_cuda(metainfo))
         )DOC")
+      .def("_share_cuda_pooled",
+           [](phi::DenseTensor self) {
+             if (!self.IsInitialized() || self.numel() == 0)
+               throw std::runtime_error(
+                   "Tensor not initialized or numel is 0.  could not pass "
+                   "to shared memory. ");
+             PADDLE_ENFORCE_EQ(
+                 phi::is_gpu_place(self.place()), true,
+                 common::errors::InvalidArgument(
+                     "Tensor is not on GPU. share_cuda_pooled only support "
+                     "GPU Tensor, share_filename is for CPU tensor."));
+
+             const auto &device_id = self.place().GetDeviceId();
+             auto stream = paddle::platform::get_current_stream(device_id);
+             size_t data_size =
+                 self.numel() *
+                 framework::SizeOfType(
+                     framework::TransToProtoVarType(self.type()));
+             // copied into the pool on the stream, no synchronization
+             auto meta = memory::allocation::ShareToCudaIpcPool(
+                 self.data(), data_size, device_id, stream->raw_stream());
+
+             return py::make_tuple(py::bytes(meta.mem_handle),
+                                   py::bytes(meta.event_handle),
+                                   meta.refcount_name,
+                                   (py::size_t)meta.offset,
+                                   meta.slot,
+                                   data_size,
+                                   static_cast<int>(self.type()),
+                                   common::vectorize(self.dims()),
+                                   self.lod(),
+                                   device_id);
+           },
+           R"DOC(
+           Serialize GPU Tensor by copying it into a pooled CUDA IPC block.
+           The block can only be received once, by _new_shared_cuda_pooled.
+
+           Returns:
+               tuple: contains segment handle, event handle, reference count
+                      file name, offset, slot, data size, data type, tensor
+                      dims, lod information, device index.
+
+           Examples:
+                .. code-block:: python
+
+                    >>> import paddle
+
+                    >>> tensor = paddle.ones([3,3])
+                    >>> metainfo = tensor.value().get_tensor()._share_cuda_pooled()
+      )DOC")
+      .def("_new_shared_cuda_pooled",
+           [](py::tuple t) {
+             if (t.size() != 10)
+               throw std::runtime_error(
+                   "Invalid Tensor meta info for pooled shared cuda tensor!");
+
+             memory::allocation::CudaIpcBlockMeta meta;
+             meta.mem_handle = t[0].cast<std::string>();
+             meta.event_handle = t[1].cast<std::string>();
+             meta.refcount_name = t[2].cast<std::string>();
+             meta.offset = t[3].cast<size_t>();
+             meta.slot = t[4].cast<int>();
+             auto device_id = t[9].cast<int>();
+             auto stream = paddle::platform::get_current_stream(device_id);
+             auto holder = memory::allocation::OpenCudaIpcBlock(
+                 meta, t[5].cast<size_t>(), device_id, stream->raw_stream());
+
+             phi::DenseTensor tensor;
+             tensor.ResetHolderWithType(
+                 holder, static_cast<phi::DataType>(t[6].cast<int>()));
+             tensor.Resize(common::make_ddim(t[7].cast<std::vector<int>>()));
+             tensor.set_lod(t[8].cast<phi::LegacyLoD>());
+
+             return tensor;
+           },
+           R"DOC(
+           Deserialize GPU lod tensor shared by _share_cuda_pooled. Work on
+           the current stream waits for the copy of the sender.
+
+           Params:
+               tuple: the meta info returned by _share_cuda_pooled.
+
+           Examples:
+                .. code-block:: python
+
+                    >>> import paddle
+
+                    >>> tensor = paddle.ones([3,3])
+                    >>> metainfo = tensor.value().get_tensor()._share_cuda_pooled()
+                    >>> tensor_from_shared = paddle.to_tensor(paddle.base.core.DenseTensor._new_shared_cuda_pooled(metainfo))
+        )DOC")
 #endif
       .def("_share_filename",
            [](phi::DenseTensor &self, bool use_file_descriptor) {
@@ -81,6 +81,8 @@ class TEST_API RecordEvent {
 
   bool is_enabled_{false};
   bool is_pushed_{false};
+  // also kept by the always-on HostEventRing
+  bool in_ring_{false};
   // Event name
   std::string* name_{nullptr};
   const char* shallow_copy_name_{nullptr};
@@ -0,0 +1,254 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/api/profiler/host_event_ring.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+
+#include "glog/logging.h"
+#include "paddle/phi/api/profiler/host_tracer.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/os_info.h"
+#include "paddle/phi/core/platform/profiler/utils.h"
+
+namespace phi {
+
+ThreadEventRing::ThreadEventRing(size_t capacity)
+    : thread_id_(GetCurrentThreadSysId()),
+      thread_name_(GetCurrentThreadName()),
+      slots_(capacity),
+      // room for the name and attr of a quarter of the events at full length
+      str_pool_(std::max<size_t>(capacity / 4, 1) * 2 * (kMaxStrLen + 1)) {}
+
+void ThreadEventRing::Record(const char *name,
+                             uint64_t start_ns,
+                             uint64_t end_ns,
+                             EventRole role,
+                             TracerEventType type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto &slot = slots_[num_recorded_ % slots_.size()];
+  slot.event = CommonEvent(name, start_ns, end_ns, role, type);
+  slot.str_pos = -1;
+  ++num_recorded_;
+}
+
+void ThreadEventRing::Record(const std::string &name,
+                             const std::string *attr,
+                             uint64_t start_ns,
+                             uint64_t end_ns,
+                             EventRole role,
+                             TracerEventType type) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto &slot = slots_[num_recorded_ % slots_.size()];
+  uint64_t name_pos = 0;
+  uint64_t attr_pos = 0;
+  slot.event =
+      CommonEvent(CopyStr(name, &name_pos), start_ns, end_ns, role, type);
+  if (attr != nullptr) {
+    slot.event.attr = CopyStr(*attr, &attr_pos);
+  }
+  slot.str_pos = static_cast<int64_t>(name_pos);
+  ++num_recorded_;
+}
+
+const char *ThreadEventRing::CopyStr(const std::string &str, uint64_t *pos) {
+  size_t len = std::min(str.size(), kMaxStrLen);
+  size_t offset = str_offset_ % str_pool_.size();
+  if (offset + len + 1 > str_pool_.size()) {
+    // never split a string across the end of the pool
+    str_offset_ += str_pool_.size() - offset;
+    offset = 0;
+  }
+  *pos = str_offset_;
+  char *buf = str_pool_.data() + offset;
+  memcpy(buf, str.data(), len);
+  buf[len] = '\0';
+  str_offset_ += len + 1;
+  return buf;
+}
+
+ThreadEventSection<CommonEvent> ThreadEventRing::Snapshot(
+    uint64_t since_ns, std::deque<std::string> *strs) const {
+  ThreadEventSection<CommonEvent> thr_sec;
+  thr_sec.thread_name = thread_name_;
+  thr_sec.thread_id = thread_id_;
+  std::lock_guard<std::mutex> guard(mutex_);
+  uint64_t num_events = std::min<uint64_t>(num_recorded_, slots_.size());
+  thr_sec.events.reserve(num_events);
+  for (uint64_t i = num_recorded_ - num_events; i < num_recorded_; ++i) {
+    const auto &slot = slots_[i % slots_.size()];
+    if (slot.event.end_ns < since_ns) {
+      continue;
+    }
+    thr_sec.events.push_back(slot.event);
+    if (slot.str_pos < 0) {
+      continue;
+    }
+    if (str_offset_ - static_cast<uint64_t>(slot.str_pos) > str_pool_.size()) {
+      // the copied name was overwritten
+      thr_sec.events.pop_back();
+      continue;
+    }
+    auto &event = thr_sec.events.back();
+    event.name = strs->emplace_back(event.name).c_str();
+    if (event.attr != nullptr) {
+      event.attr = strs->emplace_back(event.attr).c_str();
+    }
+  }
+  return thr_sec;
+}
+
+std::atomic<bool> HostEventRing::enabled_{false};
+
+HostEventRing &HostEventRing::GetInstance() {
+  // leaked, RecordEvent may still run in other threads at exit
+  static auto *instance = new HostEventRing;
+  return *instance;
+}
+
+void HostEventRing::Enable(size_t events_per_thread, uint32_t trace_level) {
+  PADDLE_ENFORCE_GT(events_per_thread,
+                    0,
+                    common::errors::InvalidArgument(
+                        "events_per_thread of HostEventRing must be greater "
+                        "than 0, but received %d.",
+                        events_per_thread));
+  events_per_thread_.store(events_per_thread);
+  HostTraceLevel::GetInstance().SetRingLevel(trace_level);
+  enabled_.store(true);
+}
+
+void HostEventRing::Disable() {
+  enabled_.store(false);
+  HostTraceLevel::GetInstance().SetRingLevel(HostTraceLevel::kDisabled);
+}
+
+ThreadEventRing *HostEventRing::GetThreadRing() {
+  thread_local ThreadEventRing *thread_ring = nullptr;
+  if (UNLIKELY(thread_ring == nullptr)) {
+    auto ring = std::make_shared<ThreadEventRing>(events_per_thread_.load());
+    std::lock_guard<std::mutex> guard(mutex_);
+    rings_.push_back(ring);
+    thread_ring = ring.get();
+  }
+  return thread_ring;
+}
+
+HostEventSection<CommonEvent> HostEventRing::Snapshot(
+    uint64_t window_ns, std::deque<std::string> *strs) {
+  uint64_t now_ns = PosixInNsec();
+  uint64_t since_ns = now_ns > window_ns ? now_ns - window_ns : 0;
+  HostEventSection<CommonEvent> host_sec;
+  host_sec.process_id = GetProcessId();
+  std::lock_guard<std::mutex> guard(mutex_);
+  host_sec.thr_sections.reserve(rings_.size());
+  for (auto &ring : rings_) {
+    auto thr_sec = ring->Snapshot(since_ns, strs);
+    if (!thr_sec.events.empty()) {
+      host_sec.thr_sections.emplace_back(std::move(thr_sec));
+    }
+  }
+  return host_sec;
+}
+
+static void WriteJsonString(std::ostream &os, const char *str) {
+  os << '"';
+  for (; *str != '\0'; ++str) {
+    char c = *str;
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      os << ' ';
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+void HostEventRing::Dump(const std::string &path, uint64_t window_ns) {
+  std::deque<std::string> strs;
+  auto host_sec = Snapshot(window_ns, &strs);
+  std::ofstream ofs(path);
+  PADDLE_ENFORCE_EQ(
+      ofs.is_open(),
+      true,
+      common::errors::Unavailable("Failed to open %s for writing.", path));
+  ofs << std::fixed << std::setprecision(3);
+  ofs << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+  bool first = true;
+  for (auto &thr_sec : host_sec.thr_sections) {
+    for (auto &event : thr_sec.events) {
+      ofs << (first ? "\n" : ",\n") << "{\"name\": ";
+      first = false;
+      WriteJsonString(ofs, event.name);
+      ofs << ", \"cat\": \""
+          << paddle::platform::StringTracerEventType(event.type)
+          << "\", \"ph\": \"X\", \"pid\": " << host_sec.process_id
+          << ", \"tid\": " << thr_sec.thread_id
+          << ", \"ts\": " << event.start_ns / 1000.0
+          << ", \"dur\": " << (event.end_ns - event.start_ns) / 1000.0;
+      if (event.attr != nullptr) {
+        ofs << ", \"args\": {\"attr\": ";
+        WriteJsonString(ofs, event.attr);
+        ofs << "}";
+      }
+      ofs << "}";
+    }
+  }
+  ofs << "\n]}\n";
+  VLOG(1) << "HostEventRing dumped the last " << window_ns / 1000000
+          << " ms to " << path;
+}
+
+static std::atomic<bool> g_dump_requested{false};
+
+void HostEventRing::EnableDumpOnSignal(int signum,
+                                       const std::string &path_prefix,
+                                       uint64_t window_ns) {
+#ifndef _WIN32
+  static std::once_flag once;
+  std::call_once(once, [&]() {
+    // only set a flag in the handler, the dump is not async-signal-safe
+    std::signal(signum, [](int) { g_dump_requested.store(true); });
+    std::thread([this, path_prefix, window_ns]() {
+      while (true) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (!g_dump_requested.exchange(false)) {
+          continue;
+        }
+        std::string path = path_prefix + "." +
+                           std::to_string(GetProcessId()) + "." +
+                           std::to_string(PosixInNsec()) + ".json";
+        try {
+          Dump(path, window_ns);
+        } catch (const std::exception &e) {
+          LOG(WARNING) << "HostEventRing failed to dump: " << e.what();
+        }
+      }
+    }).detach();
+  });
+#else
+  PADDLE_THROW(common::errors::Unimplemented(
+      "HostEventRing::EnableDumpOnSignal is not supported on Windows."));
+#endif
+}
+
+}  // namespace phi
@@ -0,0 +1,129 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/api/profiler/common_event.h"
+#include "paddle/phi/api/profiler/host_event_recorder.h"
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// The latest CommonEvents of a thread. Event slots and the bytes of copied
+// names are both reused circularly, so the memory is bounded by the capacity
+// given at construction. An event whose name bytes were reused by newer events
+// is dropped by Snapshot.
+class ThreadEventRing {
+ public:
+  explicit ThreadEventRing(size_t capacity);
+  DISABLE_COPY_AND_ASSIGN(ThreadEventRing);
+
+  void Record(const char *name,
+              uint64_t start_ns,
+              uint64_t end_ns,
+              EventRole role,
+              TracerEventType type);
+
+  void Record(const std::string &name,
+              const std::string *attr,
+              uint64_t start_ns,
+              uint64_t end_ns,
+              EventRole role,
+              TracerEventType type);
+
+  // The events ended at or after since_ns, oldest first. Copied names point
+  // into strs, which must outlive the events.
+  ThreadEventSection<CommonEvent> Snapshot(
+      uint64_t since_ns, std::deque<std::string> *strs) const;
+
+  // Names longer than this are truncated when copied into the ring.
+  static constexpr size_t kMaxStrLen = 255;
+
+ private:
+  struct Slot {
+    CommonEvent event{nullptr, 0, 0, EventRole::kOrdinary,
+                      TracerEventType::NumTypes};
+    // position in str_pool_ of the copied name and attr, -1 if not copied
+    int64_t str_pos = -1;
+  };
+
+  const char *CopyStr(const std::string &str, uint64_t *pos);
+
+  uint64_t thread_id_;
+  std::string thread_name_;
+  std::vector<Slot> slots_;
+  uint64_t num_recorded_ = 0;
+  std::vector<char> str_pool_;
+  // bytes of str_pool_ handed out since construction, wrapping included
+  uint64_t str_offset_ = 0;
+  // only contended while a snapshot is taken
+  mutable std::mutex mutex_;
+};
+
+// Always-on, low overhead host tracing for production. While enabled, every
+// RecordEvent that passes the trace level is also kept in the ring of its
+// thread, and the last seconds of all threads can be dumped on demand, either
+// through Dump or by sending the signal given to EnableDumpOnSignal.
+class TEST_API HostEventRing {
+ public:
+  static HostEventRing &GetInstance();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  // events_per_thread applies to the threads recording for the first time
+  // after this call.
+  void Enable(size_t events_per_thread, uint32_t trace_level);
+
+  void Disable();
+
+  template <typename... Args>
+  void Record(Args &&...args) {
+    GetThreadRing()->Record(std::forward<Args>(args)...);
+  }
+
+  // The events of all threads ended in the last window_ns.
+  HostEventSection<CommonEvent> Snapshot(uint64_t window_ns,
+                                         std::deque<std::string> *strs);
+
+  // Writes Snapshot(window_ns) to path in chrome tracing format.
+  void Dump(const std::string &path, uint64_t window_ns);
+
+  // Dumps the last window_ns to "<path_prefix>.<pid>.<time>.json" each time
+  // the process receives signum. The dump runs on a background thread.
+  void EnableDumpOnSignal(int signum,
+                          const std::string &path_prefix,
+                          uint64_t window_ns);
+
+ private:
+  HostEventRing() = default;
+  DISABLE_COPY_AND_ASSIGN(HostEventRing);
+
+  ThreadEventRing *GetThreadRing();
+
+  static std::atomic<bool> enabled_;
+
+  std::atomic<size_t> events_per_thread_{0};
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ThreadEventRing>> rings_;
+};
+
+}  // namespace phi
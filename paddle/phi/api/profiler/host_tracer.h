@@ -26,14 +26,19 @@ class HostTraceLevel {
   }
 
   bool NeedTrace(uint32_t level) {
-    return trace_level_ >= static_cast<int64_t>(level);
+    return trace_level_ >= static_cast<int64_t>(level) ||
+           ring_level_ >= static_cast<int64_t>(level);
   }
 
   void SetLevel(int64_t trace_level) { trace_level_ = trace_level; }
 
+  // Level of the always-on HostEventRing, independent of profiler sessions
+  void SetRingLevel(int64_t trace_level) { ring_level_ = trace_level; }
+
  private:
   // Verbose trace level, works like VLOG(level)
   int trace_level_ = kDisabled;
+  int ring_level_ = kDisabled;
 };
 
 struct HostTracerOptions {
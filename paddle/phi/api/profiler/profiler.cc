@@ -24,6 +24,7 @@ limitations under the License. */
 
 #include "paddle/phi/api/profiler/common_event.h"
 #include "paddle/phi/api/profiler/device_tracer.h"
+#include "paddle/phi/api/profiler/host_event_ring.h"
 #include "paddle/phi/api/profiler/host_event_recorder.h"
 #include "paddle/phi/api/profiler/host_tracer.h"
 #include "paddle/phi/api/profiler/profiler_helper.h"
@@ -111,7 +112,8 @@ RecordEvent::RecordEvent(const char *name,
   if (UNLIKELY(HostTraceLevel::GetInstance().NeedTrace(level) == false)) {
     return;
   }
-  if (FLAGS_enable_host_event_recorder_hook == false) {
+  in_ring_ = HostEventRing::IsEnabled();
+  if (FLAGS_enable_host_event_recorder_hook == false && !in_ring_) {
     if (ProfilerHelper::g_state !=
         ProfilerState::kDisabled) {  // avoid temp string
       if (type == TracerEventType::Operator ||
@@ -146,7 +148,8 @@ RecordEvent::RecordEvent(const std::string &name,
     return;
   }
 
-  if (FLAGS_enable_host_event_recorder_hook == false) {
+  in_ring_ = HostEventRing::IsEnabled();
+  if (FLAGS_enable_host_event_recorder_hook == false && !in_ring_) {
     if (type == TracerEventType::Operator ||
         type == TracerEventType::OperatorInner ||
         type == TracerEventType::UserDefined) {
@@ -180,7 +183,8 @@ RecordEvent::RecordEvent(const std::string &name,
     return;
   }
 
-  if (FLAGS_enable_host_event_recorder_hook == false) {
+  in_ring_ = HostEventRing::IsEnabled();
+  if (FLAGS_enable_host_event_recorder_hook == false && !in_ring_) {
     if (type == TracerEventType::Operator ||
         type == TracerEventType::OperatorInner ||
         type == TracerEventType::UserDefined) {
@@ -224,22 +228,34 @@ void RecordEvent::End() {
   }
 #endif
 #endif
-  if (LIKELY(FLAGS_enable_host_event_recorder_hook && is_enabled_)) {
+  if (LIKELY((FLAGS_enable_host_event_recorder_hook || in_ring_) &&
+             is_enabled_)) {
     uint64_t end_ns = PosixInNsec();
-    if (LIKELY(shallow_copy_name_ != nullptr)) {
-      HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
-          shallow_copy_name_, start_ns_, end_ns, role_, type_);
-    } else if (name_ != nullptr) {
-      if (attr_ == nullptr) {
-        HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
-            *name_, start_ns_, end_ns, role_, type_);
-      } else {
+    if (UNLIKELY(in_ring_)) {
+      if (LIKELY(shallow_copy_name_ != nullptr)) {
+        HostEventRing::GetInstance().Record(
+            shallow_copy_name_, start_ns_, end_ns, role_, type_);
+      } else if (name_ != nullptr) {
+        HostEventRing::GetInstance().Record(
+            *name_, attr_, start_ns_, end_ns, role_, type_);
+      }
+    }
+    if (FLAGS_enable_host_event_recorder_hook) {
+      if (LIKELY(shallow_copy_name_ != nullptr)) {
         HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
-            *name_, start_ns_, end_ns, role_, type_, *attr_);
-        delete attr_;
+            shallow_copy_name_, start_ns_, end_ns, role_, type_);
+      } else if (name_ != nullptr) {
+        if (attr_ == nullptr) {
+          HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
+              *name_, start_ns_, end_ns, role_, type_);
+        } else {
+          HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
+              *name_, start_ns_, end_ns, role_, type_, *attr_);
+        }
       }
-      delete name_;
     }
+    delete attr_;
+    delete name_;
     // use this flag to avoid double End();
     is_enabled_ = false;
     return;
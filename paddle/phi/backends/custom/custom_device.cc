@@ -266,6 +266,118 @@ class CustomDevice : public DeviceInterface {
     }
   }
 
+  void SubmitCommands(size_t dev_id,
+                      const stream::Stream* stream,
+                      const std::vector<stream::Command>& commands) override {
+    if (!pimpl_->stream_submit_commands) {
+      // one plugin call per command
+      DeviceInterface::SubmitCommands(dev_id, stream, commands);
+      return;
+    }
+    const auto device = &devices_pool[dev_id];
+    std::vector<C_Command> c_commands(commands.size());
+    for (size_t i = 0; i < commands.size(); ++i) {
+      auto& command = commands[i];
+      auto& c_command = c_commands[i];
+      memset(&c_command, 0, sizeof(C_Command));
+      switch (command.type) {
+        case stream::Command::Type::kMemoryCopyH2D:
+          c_command.type = C_COMMAND_MEMCPY_H2D;
+          break;
+        case stream::Command::Type::kMemoryCopyD2H:
+          c_command.type = C_COMMAND_MEMCPY_D2H;
+          break;
+        case stream::Command::Type::kMemoryCopyD2D:
+          c_command.type = C_COMMAND_MEMCPY_D2D;
+          break;
+        case stream::Command::Type::kMemorySet:
+          c_command.type = C_COMMAND_MEMSET;
+          c_command.value = command.value;
+          break;
+        case stream::Command::Type::kRecordEvent:
+          c_command.type = C_COMMAND_RECORD_EVENT;
+          break;
+        case stream::Command::Type::kWaitEvent:
+          c_command.type = C_COMMAND_WAIT_EVENT;
+          break;
+        case stream::Command::Type::kHostCallback:
+          c_command.type = C_COMMAND_HOST_CALLBACK;
+          c_command.callback = [](C_Device device,
+                                  C_Stream stream,
+                                  void* user_data,
+                                  C_Status* status) {
+            std::unique_ptr<std::function<void()>> func(
+                reinterpret_cast<std::function<void()>*>(user_data));
+            (*func)();
+          };
+          c_command.user_data = command.callback;
+          break;
+        default:
+          PADDLE_THROW(common::errors::InvalidArgument(
+              "Unknown command type %d.", static_cast<int>(command.type)));
+      }
+      c_command.dst = command.dst;
+      c_command.src = command.src;
+      c_command.size = command.size;
+      if (command.event) {
+        c_command.event = reinterpret_cast<C_Event>(command.event->raw_event());
+      }
+    }
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->stream_submit_commands(
+        device,
+        reinterpret_cast<C_Stream>(stream->raw_stream()),
+        c_commands.data(),
+        c_commands.size()));
+  }
+
+  void StreamBeginCapture(size_t dev_id,
+                          const stream::Stream* stream) override {
+    if (!pimpl_->stream_begin_capture) {
+      PADDLE_THROW(common::errors::Unavailable(
+          "StreamBeginCapture is not supported on %s.", Type()));
+    }
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->stream_begin_capture(
+        device, reinterpret_cast<C_Stream>(stream->raw_stream())));
+  }
+
+  stream::graph_t StreamEndCapture(size_t dev_id,
+                                   const stream::Stream* stream) override {
+    if (!pimpl_->stream_end_capture) {
+      PADDLE_THROW(common::errors::Unavailable(
+          "StreamEndCapture is not supported on %s.", Type()));
+    }
+    const auto device = &devices_pool[dev_id];
+    C_Graph graph = nullptr;
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(pimpl_->stream_end_capture(
+        device, reinterpret_cast<C_Stream>(stream->raw_stream()), &graph));
+    return graph;
+  }
+
+  void GraphLaunch(size_t dev_id,
+                   stream::graph_t graph,
+                   const stream::Stream* stream) override {
+    if (!pimpl_->graph_launch) {
+      PADDLE_THROW(common::errors::Unavailable(
+          "GraphLaunch is not supported on %s.", Type()));
+    }
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->graph_launch(device,
+                             reinterpret_cast<C_Stream>(stream->raw_stream()),
+                             reinterpret_cast<C_Graph>(graph)));
+  }
+
+  void GraphDestroy(size_t dev_id, stream::graph_t graph) override {
+    if (!pimpl_->graph_destroy) {
+      PADDLE_THROW(common::errors::Unavailable(
+          "GraphDestroy is not supported on %s.", Type()));
+    }
+    const auto device = &devices_pool[dev_id];
+    PADDLE_ENFORCE_CUSTOM_DEVICE_SUCCESS(
+        pimpl_->graph_destroy(device, reinterpret_cast<C_Graph>(graph)));
+  }
+
   void MemoryCopyH2D(size_t dev_id,
                      void* dst,
                      const void* src,
@@ -991,6 +1103,11 @@ bool ValidCustomCustomRuntimeParams(const CustomRuntimeParams* params) {
   CHECK_INTERFACE(synchronize_stream, false);
   CHECK_INTERFACE(synchronize_event, true);
   CHECK_INTERFACE(stream_wait_event, false);
+  CHECK_INTERFACE(stream_submit_commands, false);
+  CHECK_INTERFACE(stream_begin_capture, false);
+  CHECK_INTERFACE(stream_end_capture, false);
+  CHECK_INTERFACE(graph_launch, false);
+  CHECK_INTERFACE(graph_destroy, false);
 
   CHECK_INTERFACE(device_memory_allocate, true);
   CHECK_INTERFACE(device_memory_deallocate, true);
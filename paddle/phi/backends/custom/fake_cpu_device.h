@@ -60,6 +60,35 @@ C_Status AsyncMemCpy(const C_Device device,
   return C_SUCCESS;
 }
 
+C_Status SubmitCommands(const C_Device device,
+                        C_Stream stream,
+                        const C_Command *commands,
+                        size_t num_commands) {
+  for (size_t i = 0; i < num_commands; ++i) {
+    const C_Command &command = commands[i];
+    C_Status status = C_SUCCESS;
+    switch (command.type) {
+      case C_COMMAND_MEMCPY_H2D:
+      case C_COMMAND_MEMCPY_D2H:
+      case C_COMMAND_MEMCPY_D2D:
+        memcpy(command.dst, command.src, command.size);
+        break;
+      case C_COMMAND_MEMSET:
+        memset(command.dst, command.value, command.size);
+        break;
+      case C_COMMAND_HOST_CALLBACK:
+        command.callback(device, stream, command.user_data, &status);
+        break;
+      default:
+        break;
+    }
+    if (status != C_SUCCESS) {
+      return status;
+    }
+  }
+  return C_SUCCESS;
+}
+
 C_Status Allocate(const C_Device device, void **ptr, size_t size) {
   if (global_free_memory >= size) {
     *ptr = malloc(size);
@@ -255,6 +284,7 @@ void InitFakeCPUDevice(CustomRuntimeParams *params) {
   params->interface->synchronize_stream = SyncStream;
   params->interface->synchronize_event = SyncEvent;
   params->interface->stream_wait_event = StreamWaitEvent;
+  params->interface->stream_submit_commands = SubmitCommands;
 
   params->interface->memory_copy_h2d = MemCpy;
   params->interface->memory_copy_d2d = MemCpy;
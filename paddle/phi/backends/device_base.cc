@@ -97,6 +97,65 @@ void DeviceInterface::StreamWaitEvent(size_t dev_id,
   INTERFACE_UNIMPLEMENT;
 }
 
+void DeviceInterface::SubmitCommands(
+    size_t dev_id,
+    const stream::Stream* stream,
+    const std::vector<stream::Command>& commands) {
+  for (auto& command : commands) {
+    switch (command.type) {
+      case stream::Command::Type::kMemoryCopyH2D:
+        MemoryCopyH2D(dev_id, command.dst, command.src, command.size, stream);
+        break;
+      case stream::Command::Type::kMemoryCopyD2H:
+        MemoryCopyD2H(dev_id, command.dst, command.src, command.size, stream);
+        break;
+      case stream::Command::Type::kMemoryCopyD2D:
+        MemoryCopyD2D(dev_id, command.dst, command.src, command.size, stream);
+        break;
+      case stream::Command::Type::kMemorySet:
+        // MemorySet is not stream ordered
+        SynchronizeStream(dev_id, stream);
+        MemorySet(dev_id, command.dst, command.value, command.size);
+        break;
+      case stream::Command::Type::kRecordEvent:
+        RecordEvent(dev_id, command.event, stream);
+        break;
+      case stream::Command::Type::kWaitEvent:
+        StreamWaitEvent(dev_id, stream, command.event);
+        break;
+      case stream::Command::Type::kHostCallback:
+        AddCallback(
+            dev_id, const_cast<stream::Stream*>(stream), command.callback);
+        break;
+      default:
+        PADDLE_THROW(common::errors::InvalidArgument(
+            "Unknown command type %d.", static_cast<int>(command.type)));
+    }
+  }
+}
+
+// graph manage
+void DeviceInterface::StreamBeginCapture(size_t dev_id,
+                                         const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+stream::graph_t DeviceInterface::StreamEndCapture(
+    size_t dev_id, const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+  return nullptr;
+}
+
+void DeviceInterface::GraphLaunch(size_t dev_id,
+                                  stream::graph_t graph,
+                                  const stream::Stream* stream) {
+  INTERFACE_UNIMPLEMENT;
+}
+
+void DeviceInterface::GraphDestroy(size_t dev_id, stream::graph_t graph) {
+  INTERFACE_UNIMPLEMENT;
+}
+
 // event manage
 void DeviceInterface::CreateEvent(size_t dev_id,
                                   event::Event* event,
@@ -114,6 +114,27 @@ class DeviceInterface {  // Driver / Runtime
                                const stream::Stream* stream,
                                const event::Event* event);
 
+  // ! Enqueue a list of commands to a stream, in order.
+  virtual void SubmitCommands(size_t dev_id,
+                              const stream::Stream* stream,
+                              const std::vector<stream::Command>& commands);
+
+  // Graph
+  // ! Start capturing the work enqueued to a stream into a graph.
+  virtual void StreamBeginCapture(size_t dev_id, const stream::Stream* stream);
+
+  // ! Stop capturing a stream and return the captured graph.
+  virtual stream::graph_t StreamEndCapture(size_t dev_id,
+                                           const stream::Stream* stream);
+
+  // ! Replay a captured graph on a stream.
+  virtual void GraphLaunch(size_t dev_id,
+                           stream::graph_t graph,
+                           const stream::Stream* stream);
+
+  // ! Destroy a captured graph.
+  virtual void GraphDestroy(size_t dev_id, stream::graph_t graph);
+
   // Memory
   virtual void MemoryCopyH2D(size_t dev_id,
                              void* dst,
@@ -77,6 +77,30 @@ typedef void (*C_Callback)(C_Device device,
                            void* user_data,
                            C_Status* status);
 
+typedef struct C_Graph_st* C_Graph;
+
+typedef enum {
+  C_COMMAND_MEMCPY_H2D = 0,
+  C_COMMAND_MEMCPY_D2H,
+  C_COMMAND_MEMCPY_D2D,
+  C_COMMAND_MEMSET,
+  C_COMMAND_RECORD_EVENT,
+  C_COMMAND_WAIT_EVENT,
+  C_COMMAND_HOST_CALLBACK
+} C_CommandType;
+
+// One entry of a command list, the fields a type does not use are left zero.
+typedef struct {
+  C_CommandType type;
+  void* dst;            // MEMCPY_*, MEMSET
+  const void* src;      // MEMCPY_*
+  size_t size;          // MEMCPY_*, MEMSET
+  unsigned char value;  // MEMSET
+  C_Event event;        // RECORD_EVENT, WAIT_EVENT
+  C_Callback callback;  // HOST_CALLBACK
+  void* user_data;      // HOST_CALLBACK
+} C_Command;
+
 typedef struct {
   size_t sz;
   void* data;
@@ -247,7 +271,60 @@ struct C_DeviceInterface {
                                 C_Stream stream,
                                 C_Event event);
 
-  void* reserved_dev_api[8];
+  /**
+   * @brief Enqueue a list of commands to a stream in one call, they run in
+   * order as if each one was submitted by its own api
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[C_Command*] commands
+   * @param[size_t]     num_commands
+   */
+  C_Status (*stream_submit_commands)(const C_Device device,
+                                     C_Stream stream,
+                                     const C_Command* commands,
+                                     size_t num_commands);
+
+  /**
+   * @brief Start recording the work enqueued to a stream into a graph
+   * instead of running it
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   */
+  C_Status (*stream_begin_capture)(const C_Device device, C_Stream stream);
+
+  /**
+   * @brief Stop recording a stream
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[C_Graph*]   graph      Plugin create a graph and fill it
+   */
+  C_Status (*stream_end_capture)(const C_Device device,
+                                 C_Stream stream,
+                                 C_Graph* graph);
+
+  /**
+   * @brief Replay a captured graph on a stream
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Stream]   stream
+   * @param[C_Graph]    graph
+   */
+  C_Status (*graph_launch)(const C_Device device,
+                           C_Stream stream,
+                           C_Graph graph);
+
+  /**
+   * @brief Destroy a graph
+   *
+   * @param[C_Device]   device     Core fill it with a physical id
+   * @param[C_Graph]    graph
+   */
+  C_Status (*graph_destroy)(const C_Device device, C_Graph graph);
+
+  void* reserved_dev_api[3];
 
   ///////////////////////
   // memory manage api //
@@ -103,6 +103,32 @@ void Device::StreamWaitEvent(const stream::Stream* stream,
   impl_->StreamWaitEvent(dev_id_, stream, event);
 }
 
+void Device::SubmitCommands(const stream::Stream* stream,
+                            const std::vector<stream::Command>& commands) {
+  CheckInitialized();
+  impl_->SubmitCommands(dev_id_, stream, commands);
+}
+
+void Device::StreamBeginCapture(const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->StreamBeginCapture(dev_id_, stream);
+}
+
+stream::graph_t Device::StreamEndCapture(const stream::Stream* stream) {
+  CheckInitialized();
+  return impl_->StreamEndCapture(dev_id_, stream);
+}
+
+void Device::GraphLaunch(stream::graph_t graph, const stream::Stream* stream) {
+  CheckInitialized();
+  impl_->GraphLaunch(dev_id_, graph, stream);
+}
+
+void Device::GraphDestroy(stream::graph_t graph) {
+  CheckInitialized();
+  impl_->GraphDestroy(dev_id_, graph);
+}
+
 void Device::MemoryCopyH2D(void* dst,
                            const void* src,
                            size_t size,
@@ -76,6 +76,23 @@ class Device final {
   // ! Make a compute stream wait on an event
   void StreamWaitEvent(const stream::Stream* stream, const event::Event* event);
 
+  // ! Enqueue a list of commands to a stream with a single call.
+  void SubmitCommands(const stream::Stream* stream,
+                      const std::vector<stream::Command>& commands);
+
+  // Graph
+  // ! Start capturing the work enqueued to a stream into a graph.
+  void StreamBeginCapture(const stream::Stream* stream);
+
+  // ! Stop capturing a stream and return the captured graph.
+  stream::graph_t StreamEndCapture(const stream::Stream* stream);
+
+  // ! Replay a captured graph on a stream.
+  void GraphLaunch(stream::graph_t graph, const stream::Stream* stream);
+
+  // ! Destroy a captured graph.
+  void GraphDestroy(stream::graph_t graph);
+
   // Memory
   void MemoryCopyH2D(void* dst,
                      const void* src,
@@ -77,6 +77,7 @@ extern void *mklml_dso_handle;
   __macro(cblas_dgemm_compute);     \
   __macro(cblas_sgemm_free);        \
   __macro(cblas_dgemm_free);        \
+  __macro(cblas_gemm_s8u8s32);      \
   __macro(cblas_sgemm_batch);       \
   __macro(cblas_dgemm_batch);       \
   __macro(cblas_cgemm_batch);       \
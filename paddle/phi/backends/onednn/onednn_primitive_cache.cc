@@ -0,0 +1,127 @@
+//   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifdef PADDLE_WITH_DNNL
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/onednn/onednn_context.h"
+
+COMMON_DECLARE_int64(onednn_shared_primitive_cache_capacity);
+
+namespace phi {
+
+namespace {
+
+constexpr char kScopeSeparator = '|';
+
+}  // namespace
+
+OneDNNPrimitiveCache& OneDNNPrimitiveCache::Instance() {
+  static OneDNNPrimitiveCache cache;
+  return cache;
+}
+
+std::string OneDNNPrimitiveCache::Key(const std::string& base_key,
+                                      const std::string& suffix) {
+  const auto& tls = OneDNNContext::tls();
+  if (tls.get_primitive_cache_scope().empty()) {
+    return "";
+  }
+  // the suffix of the executor makes the keys of the clones differ
+  std::string key = base_key;
+  const auto& exec_suffix = tls.get_key_suffix();
+  if (!exec_suffix.empty()) {
+    auto pos = key.rfind(exec_suffix);
+    if (pos != std::string::npos) {
+      key.erase(pos, exec_suffix.size());
+    }
+  }
+  return tls.get_primitive_cache_scope() + kScopeSeparator +
+         tls.cur_input_shape_str + kScopeSeparator + key + suffix;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Get(const std::string& key) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+  ++hits_;
+  return it->second.primitive;
+}
+
+std::shared_ptr<void> OneDNNPrimitiveCache::Insert(
+    const std::string& key,
+    std::shared_ptr<void> primitive,
+    int64_t memory_bytes) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto inserted = entries_.emplace(key, Entry{primitive, memory_bytes});
+  if (!inserted.second) {
+    return inserted.first->second.primitive;
+  }
+  order_.push_back(key);
+  memory_bytes_ += memory_bytes;
+
+  const int64_t capacity = FLAGS_onednn_shared_primitive_cache_capacity;
+  while (capacity > 0 && static_cast<int64_t>(entries_.size()) > capacity) {
+    auto oldest = entries_.find(order_.front());
+    order_.pop_front();
+    if (oldest != entries_.end()) {
+      memory_bytes_ -= oldest->second.memory_bytes;
+      entries_.erase(oldest);
+    }
+  }
+  VLOG(3) << "Share the oneDNN primitive " << key << ", "
+          << entries_.size() << " primitives of " << memory_bytes_
+          << " bytes are shared.";
+  return primitive;
+}
+
+void OneDNNPrimitiveCache::Erase(const std::string& scope) {
+  const std::string prefix = scope + kScopeSeparator;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->first.compare(0, prefix.size(), prefix) == 0) {
+      memory_bytes_ -= it->second.memory_bytes;
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  order_.erase(std::remove_if(order_.begin(),
+                              order_.end(),
+                              [&](const std::string& key) {
+                                return key.compare(
+                                           0, prefix.size(), prefix) == 0;
+                              }),
+               order_.end());
+}
+
+OneDNNPrimitiveCache::Stats OneDNNPrimitiveCache::GetStats() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.num_entries = entries_.size();
+  stats.memory_bytes = memory_bytes_;
+  return stats;
+}
+
+}  // namespace phi
+#endif
@@ -0,0 +1,100 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+#ifdef PADDLE_WITH_DNNL
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "dnnl.hpp"  // NOLINT
+#include "paddle/utils/test_macros.h"
+
+namespace phi {
+
+// A process-wide cache of the oneDNN primitives created by the executors
+// running the same program, e.g. the clones of a predictor. The blob map of
+// OneDNNContext keys the primitives by thread and executor, so every clone
+// would otherwise create its own primitives for the same shapes.
+//
+// Executing a primitive does not modify it, so a cached primitive is run by
+// many threads at once. Only the memory objects bound to the data of an
+// executor stay in its blob map.
+//
+// A thread shares the primitives of the cache scope set in its
+// OneDNNContextThreadLocals, none if it is empty; the key of a primitive is
+// made of the scope, the current input shape and the key of the primitive
+// without the executor suffix.
+class OneDNNPrimitiveCache {
+ public:
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    size_t num_entries = 0;
+    // memory held by the primitives, as reported by oneDNN
+    int64_t memory_bytes = 0;
+  };
+
+  TEST_API static OneDNNPrimitiveCache& Instance();
+
+  // The key of the primitive of a handler in the cache scope of the thread,
+  // empty if the thread does not share primitives.
+  static std::string Key(const std::string& base_key,
+                         const std::string& suffix);
+
+  // Returns nullptr on a miss.
+  std::shared_ptr<void> Get(const std::string& key);
+
+  // Returns the primitive cached for the key, which is the given one unless
+  // another thread created it first. Above the capacity set by
+  // FLAGS_onednn_shared_primitive_cache_capacity the oldest primitives are
+  // dropped, executors running them keep them in their blob maps.
+  std::shared_ptr<void> Insert(const std::string& key,
+                               std::shared_ptr<void> primitive,
+                               int64_t memory_bytes);
+
+  // Drops the primitives of a cache scope.
+  void Erase(const std::string& scope);
+
+  Stats GetStats() const;
+
+ private:
+  OneDNNPrimitiveCache() = default;
+
+  struct Entry {
+    std::shared_ptr<void> primitive;
+    int64_t memory_bytes;
+  };
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  // the keys in insertion order, the oldest first
+  std::deque<std::string> order_;
+  int64_t memory_bytes_{0};
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+// The memory held by the primitive of a descriptor, as reported by oneDNN.
+inline int64_t PrimitiveMemoryBytes(const dnnl::primitive_desc_base& pd) {
+  return dnnl_primitive_desc_query_s64(
+      pd.get(), dnnl_query_memory_consumption_s64, 0);
+}
+
+}  // namespace phi
+#endif
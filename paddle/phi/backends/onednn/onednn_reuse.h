@@ -24,6 +24,7 @@ limitations under the License. */
 
 #include "paddle/phi/backends/onednn/onednn_context.h"
 #include "paddle/phi/backends/onednn/onednn_helper.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/common/place.h"
@@ -161,7 +162,10 @@ class OneDNNHandlerT {
     auto forward_p =
         std::static_pointer_cast<TForward>(dev_ctx_.GetBlob(key_p));
     if (forward_p == nullptr) {
-      forward_p = std::make_shared<TForward>(*fwd_pd_);
+      forward_p = AcquireShared<TForward>(
+          "@fwd_p",
+          [&] { return std::make_shared<TForward>(*fwd_pd_); },
+          PrimitiveMemoryBytes(*fwd_pd_));
       dev_ctx_.SetBlob(key_p, forward_p);
     }
     return forward_p;
@@ -307,11 +311,39 @@ class OneDNNHandlerT {
     fwd_pd_ = std::static_pointer_cast<typename TForward::primitive_desc>(
         dev_ctx_.GetBlob(key_pd));
     if (fwd_pd_ == nullptr) {
-      CreateForwardPrimitiveDescriptor(first_arg, std::forward<Args>(args)...);
+      fwd_pd_ = AcquireShared<typename TForward::primitive_desc>(
+          "@fwd_pd",
+          [&] {
+            CreateForwardPrimitiveDescriptor(first_arg,
+                                             std::forward<Args>(args)...);
+            return fwd_pd_;
+          },
+          0);
       dev_ctx_.SetBlob(key_pd, fwd_pd_);
     }
   }
 
+  // Clones of a predictor create the same forward primitives, those of the
+  // threads sharing them are looked up in OneDNNPrimitiveCache before being
+  // created.
+  template <typename T, typename Creator>
+  std::shared_ptr<T> AcquireShared(const std::string& suffix,
+                                   Creator&& create,
+                                   int64_t memory_bytes) {
+    const std::string shared_key = OneDNNPrimitiveCache::Key(key_common_,
+                                                             suffix);
+    if (shared_key.empty()) {
+      return create();
+    }
+    auto& cache = OneDNNPrimitiveCache::Instance();
+    auto shared = std::static_pointer_cast<T>(cache.Get(shared_key));
+    if (shared == nullptr) {
+      shared = std::static_pointer_cast<T>(
+          cache.Insert(shared_key, create(), memory_bytes));
+    }
+    return shared;
+  }
+
   // Using sfinae to specialise variadic function. Workaround for not having
   // if constexpr in C++ 11.
   template <class First, class... Args>
@@ -77,5 +77,30 @@ class Stream {
   bool own_data_ = true;
 };
 
+using graph_t = void*;
+
+// An entry of a command list submitted to a stream with a single call to the
+// device, see DeviceInterface::SubmitCommands.
+struct Command {
+  enum class Type : uint8_t {
+    kMemoryCopyH2D,
+    kMemoryCopyD2H,
+    kMemoryCopyD2D,
+    kMemorySet,
+    kRecordEvent,
+    kWaitEvent,
+    kHostCallback,
+  };
+
+  Type type;
+  void* dst = nullptr;
+  const void* src = nullptr;
+  size_t size = 0;
+  uint8_t value = 0;
+  const event::Event* event = nullptr;
+  // released by the device after it runs, same as Device::AddCallback
+  Stream::Callback* callback = nullptr;
+};
+
 }  // namespace stream
 }  // namespace phi
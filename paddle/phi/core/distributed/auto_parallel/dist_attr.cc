@@ -297,6 +297,51 @@ std::string TensorDistAttr::to_string() const {
   return dist_str;
 }
 
+namespace {
+
+void AppendInt(int64_t value, std::string* key) {
+  key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+void AppendInts(const std::vector<T>& values, std::string* key) {
+  AppendInt(static_cast<int64_t>(values.size()), key);
+  for (const auto& value : values) {
+    AppendInt(static_cast<int64_t>(value), key);
+  }
+}
+
+}  // namespace
+
+void TensorDistAttr::append_to_key(std::string* key) const {
+  AppendInts(process_mesh_.shape(), key);
+  AppendInts(process_mesh_.process_ids(), key);
+  AppendInt(static_cast<int64_t>(process_mesh_.dim_names().size()), key);
+  for (const auto& name : process_mesh_.dim_names()) {
+    key->append(name);
+    key->push_back('\0');
+  }
+  AppendInts(dims_mapping_, key);
+  AppendInt(batch_dim_, key);
+  AppendInt(chunk_id_, key);
+  AppendInt(skip_check_mesh_, key);
+  AppendInts(dynamic_dims_, key);
+  AppendInt(static_cast<int64_t>(annotated_.size()), key);
+  for (const auto& item : annotated_) {
+    key->append(item.first);
+    key->push_back(item.second ? '\1' : '\0');
+  }
+  // flat_hash_map has no order, partial_status_ is small
+  std::vector<std::pair<int64_t, ReduceType>> partial(partial_status_.begin(),
+                                                      partial_status_.end());
+  std::sort(partial.begin(), partial.end());
+  AppendInt(static_cast<int64_t>(partial.size()), key);
+  for (const auto& item : partial) {
+    AppendInt(item.first, key);
+    AppendInt(static_cast<int64_t>(item.second), key);
+  }
+}
+
 void TensorDistAttr::from_proto(const TensorDistAttrProto& proto) {
   process_mesh_ = ProcessMesh::from_proto(proto.process_mesh());
   dims_mapping_.resize(proto.dims_mapping_size());
@@ -168,6 +168,10 @@ class TEST_API TensorDistAttr {
   std::string to_string() const;
   std::string partial_status_string() const;
 
+  // Appends all the fields to key in a compact binary form, a cheaper
+  // to_string for the keys of the InferSpmd and reshard function caches.
+  void append_to_key(std::string* key) const;
+
   // in partial-support-stage-I partial will always be a runtime attribute,
   // there is not need to serialize it. support the partial serialization in
   // future partial-support-stage-II.
@@ -15,6 +15,7 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/int_array.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
@@ -22,11 +23,15 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/p_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_p_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/r_to_s_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_utils.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_r_reshard_function.h"
+#include "paddle/phi/core/distributed/auto_parallel/reshard/s_to_s_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/store/store_utils.h"
 
+COMMON_DECLARE_bool(reshard_planner);
+
 namespace phi::distributed {
 
 namespace {
@@ -92,6 +97,10 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
                                      const TensorDistAttr& out_dist_attr,
                                      DistTensor* out) {
   VLOG(3) << "Call " << Name();
+  if (FLAGS_reshard_planner) {
+    EvalPlan(dev_ctx, in, out_dist_attr, out);
+    return;
+  }
   const auto& in_dist_attr = in.dist_attr();
   const auto& process_mesh = out_dist_attr.process_mesh();
 
@@ -272,6 +281,96 @@ void SameNdMeshReshardFunction::Eval(phi::DeviceContext* dev_ctx,
   }
 }
 
+void SameNdMeshReshardFunction::EvalPlan(DeviceContext* dev_ctx,
+                                         const DistTensor& in,
+                                         const TensorDistAttr& out_dist_attr,
+                                         DistTensor* out) {
+  const auto& process_mesh = out_dist_attr.process_mesh();
+  const auto plan = ReshardPlanner::Instance().Plan(
+      in.dims(), in.dtype(), in.dist_attr(), out_dist_attr);
+
+  // Backup out_dist_attr to to avoid overwriting the out's dist attr
+  auto out_dist_attr_orig = out_dist_attr;
+
+  SetValue(out, in.value());
+  SetDistProps(out, in.dims(), in.dist_attr());
+
+  for (const auto& step : plan->steps) {
+    VLOG(3) << "Reshard step " << step.to_string();
+    const int64_t mesh_axis = step.mesh_axis;
+    // the dist_attr after this step
+    TensorDistAttr real_out_dist_attr(out->dist_attr());
+    std::vector<int64_t> real_dims_mapping = real_out_dist_attr.dims_mapping();
+
+    // the one dim dist attrs on the sub mesh of the axis
+    ProcessMesh sub_mesh = GetSubProcessMesh(process_mesh, mesh_axis);
+    TensorDistAttr in_one_dim_dist_attr(common::vectorize(in.dims()));
+    in_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    TensorDistAttr out_one_dim_dist_attr(common::vectorize(in.dims()));
+    out_one_dim_dist_attr.set_process_mesh(sub_mesh);
+    std::vector<int64_t> in_one_dims_mapping =
+        in_one_dim_dist_attr.dims_mapping();
+    std::vector<int64_t> out_one_dims_mapping =
+        out_one_dim_dist_attr.dims_mapping();
+    if (step.in_tensor_axis != -1) {
+      in_one_dims_mapping[step.in_tensor_axis] = 0;
+      real_dims_mapping[step.in_tensor_axis] = -1;
+    }
+    if (step.out_tensor_axis != -1) {
+      out_one_dims_mapping[step.out_tensor_axis] = 0;
+      real_dims_mapping[step.out_tensor_axis] = mesh_axis;
+    }
+    in_one_dim_dist_attr.set_dims_mapping(in_one_dims_mapping);
+    out_one_dim_dist_attr.set_dims_mapping(out_one_dims_mapping);
+    real_out_dist_attr.set_dims_mapping(real_dims_mapping);
+
+    std::unique_ptr<ReshardFunction> func;
+    switch (step.type) {
+      case ReshardStep::Type::kPToR:
+      case ReshardStep::Type::kPToS: {
+        const auto reduce_type =
+            out->dist_attr().partial_status().at(mesh_axis);
+        in_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0},
+                                                reduce_type);
+        real_out_dist_attr.clean_partial_dims({mesh_axis});
+        if (step.type == ReshardStep::Type::kPToR) {
+          func = std::make_unique<PToRReshardFunction>();
+        } else {
+          func = std::make_unique<PToSReshardFunction>();
+        }
+        break;
+      }
+      case ReshardStep::Type::kRToP: {
+        const auto reduce_type =
+            out_dist_attr_orig.partial_status().at(mesh_axis);
+        out_one_dim_dist_attr.set_partial_status(std::vector<int64_t>{0},
+                                                 reduce_type);
+        real_out_dist_attr.set_partial_status(std::vector<int64_t>{mesh_axis},
+                                              reduce_type);
+        func = std::make_unique<RToPReshardFunction>();
+        break;
+      }
+      case ReshardStep::Type::kSToR:
+        func = std::make_unique<SToRReshardFunction>();
+        break;
+      case ReshardStep::Type::kSToS:
+        func = std::make_unique<SToSReshardFunction>();
+        break;
+      case ReshardStep::Type::kRToS:
+        func = std::make_unique<RToSReshardFunction>();
+        break;
+    }
+
+    DistTensor tmp_result;
+    SetDistProps(out, in_one_dim_dist_attr);
+    func->Eval(dev_ctx, *out, out_one_dim_dist_attr, &tmp_result);
+
+    SetValue(out, tmp_result.value());
+    SetDistProps(out, real_out_dist_attr);
+  }
+  SetDistProps(out, out_dist_attr_orig);
+}
+
 bool CrossNdMeshReshardFunction::IsSuitable(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
   const ProcessMesh& in_process_mesh = in.dist_attr().process_mesh();
@@ -30,6 +30,13 @@ class SameNdMeshReshardFunction final : public ReshardFunction {
             DistTensor* out) override;
 
   std::string Name() override { return "SameNdMeshReshard"; }
+
+ private:
+  // Runs the 1-d reshards of the plan of ReshardPlanner
+  void EvalPlan(DeviceContext* dev_ctx,
+                const DistTensor& in,
+                const TensorDistAttr& out_dist_attr,
+                DistTensor* out);
 };
 
 class CrossNdMeshReshardFunction final : public ReshardFunction {
@@ -14,8 +14,12 @@
 
 #include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_function_registry.h"
 
+#include <string>
+#include <unordered_map>
+
 #include "glog/logging.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/auto_parallel/dist_tensor.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/global_and_sub_mesh_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/nd_mesh_reshard_function.h"
@@ -30,10 +34,53 @@
 #include "paddle/phi/core/distributed/auto_parallel/reshard/same_status_reshard_function.h"
 #include "paddle/phi/core/distributed/auto_parallel/reshard/x_to_r_reshard_function.h"
 
+COMMON_DECLARE_bool(enable_spmd_rule_cache);
+
 namespace phi::distributed {
 
+static ReshardFunction* CachedReshardFunction(
+    const DistTensor& in, const TensorDistAttr& out_dist_attr) {
+  // IsSuitable only looks at the dims and dist attrs, which make the key
+  constexpr size_t kMaxCacheSize = 4096;
+  thread_local std::unordered_map<std::string, ReshardFunction*> cache;
+  thread_local std::string key;
+  key.clear();
+  for (auto dim : common::vectorize(in.dims())) {
+    key.append(reinterpret_cast<const char*>(&dim), sizeof(dim));
+  }
+  key.push_back('|');
+  in.dist_attr().append_to_key(&key);
+  key.push_back('|');
+  out_dist_attr.append_to_key(&key);
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  ReshardFunction* func = nullptr;
+  for (const auto& candidate : GetReshardFunctionList()) {
+    if (candidate->IsSuitable(in, out_dist_attr)) {
+      func = candidate.get();
+      break;
+    }
+  }
+  if (func != nullptr) {
+    if (cache.size() >= kMaxCacheSize) {
+      cache.clear();
+    }
+    cache.emplace(key, func);
+  }
+  return func;
+}
+
 ReshardFunction* ChooseProperReshardFunction(
     const DistTensor& in, const TensorDistAttr& out_dist_attr) {
+  if (FLAGS_enable_spmd_rule_cache) {
+    auto* func = CachedReshardFunction(in, out_dist_attr);
+    if (func != nullptr) {
+      VLOG(4) << "Choose ReshardFunction: " << func->Name();
+      return func;
+    }
+  }
   for (const auto& func : GetReshardFunctionList()) {
     if (func->IsSuitable(in, out_dist_attr)) {
       VLOG(4) << "Choose ReshardFunction: " << func->Name();
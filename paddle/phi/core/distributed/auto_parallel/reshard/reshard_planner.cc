@@ -0,0 +1,410 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <queue>
+#include <sstream>
+#include <tuple>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/enforce.h"
+
+COMMON_DECLARE_string(reshard_mesh_axis_bandwidths);
+
+namespace phi::distributed {
+
+namespace {
+
+// The placements of a tensor on the mesh, the partial mesh axes are kept as
+// a bit mask
+struct PlanState {
+  std::vector<int64_t> dims_mapping;
+  uint64_t partial_mask = 0;
+
+  bool operator<(const PlanState& other) const {
+    return std::tie(dims_mapping, partial_mask) <
+           std::tie(other.dims_mapping, other.partial_mask);
+  }
+  bool operator==(const PlanState& other) const {
+    return dims_mapping == other.dims_mapping &&
+           partial_mask == other.partial_mask;
+  }
+
+  bool is_partial(int64_t mesh_axis) const {
+    return (partial_mask >> mesh_axis) & 1;
+  }
+  // the tensor axis sharded by `mesh_axis`, -1 if none
+  int64_t shard_axis(int64_t mesh_axis) const {
+    for (size_t i = 0; i < dims_mapping.size(); ++i) {
+      if (dims_mapping[i] == mesh_axis) return static_cast<int64_t>(i);
+    }
+    return -1;
+  }
+};
+
+PlanState ToPlanState(const TensorDistAttr& dist_attr) {
+  PlanState state;
+  state.dims_mapping = dist_attr.dims_mapping();
+  for (const auto& kv : dist_attr.partial_status()) {
+    state.partial_mask |= (uint64_t(1) << kv.first);
+  }
+  return state;
+}
+
+PlanState ApplyStep(const PlanState& state, const ReshardStep& step) {
+  PlanState next = state;
+  const uint64_t bit = uint64_t(1) << step.mesh_axis;
+  switch (step.type) {
+    case ReshardStep::Type::kPToR:
+      next.partial_mask &= ~bit;
+      break;
+    case ReshardStep::Type::kPToS:
+      next.partial_mask &= ~bit;
+      next.dims_mapping[step.out_tensor_axis] = step.mesh_axis;
+      break;
+    case ReshardStep::Type::kSToR:
+      next.dims_mapping[step.in_tensor_axis] = -1;
+      break;
+    case ReshardStep::Type::kSToS:
+      next.dims_mapping[step.in_tensor_axis] = -1;
+      next.dims_mapping[step.out_tensor_axis] = step.mesh_axis;
+      break;
+    case ReshardStep::Type::kRToP:
+      next.partial_mask |= bit;
+      break;
+    case ReshardStep::Type::kRToS:
+      next.dims_mapping[step.out_tensor_axis] = step.mesh_axis;
+      break;
+  }
+  return next;
+}
+
+int64_t LocalBytes(const PlanState& state,
+                   const DDim& dims,
+                   DataType dtype,
+                   const std::vector<int64_t>& mesh_shape) {
+  int64_t bytes = static_cast<int64_t>(SizeOf(dtype));
+  for (int i = 0; i < dims.size(); ++i) {
+    int64_t size = dims[i];
+    const int64_t mesh_axis = state.dims_mapping[i];
+    if (mesh_axis != -1) {
+      size = (size + mesh_shape[mesh_axis] - 1) / mesh_shape[mesh_axis];
+    }
+    bytes *= size;
+  }
+  return bytes;
+}
+
+// The 1-d reshards from `state` on each mesh axis
+std::vector<ReshardStep> NextSteps(const PlanState& state,
+                                   const PlanState& target,
+                                   const DDim& dims,
+                                   const std::vector<int64_t>& mesh_shape) {
+  std::vector<ReshardStep> steps;
+  const int64_t tensor_ndim = static_cast<int64_t>(state.dims_mapping.size());
+  for (int64_t mesh_axis = 0;
+       mesh_axis < static_cast<int64_t>(mesh_shape.size());
+       ++mesh_axis) {
+    const int64_t shard_axis = state.shard_axis(mesh_axis);
+    if (state.is_partial(mesh_axis)) {
+      steps.push_back({ReshardStep::Type::kPToR, mesh_axis});
+    } else if (shard_axis != -1) {
+      steps.push_back({ReshardStep::Type::kSToR, mesh_axis, shard_axis});
+    } else if (target.is_partial(mesh_axis)) {
+      steps.push_back({ReshardStep::Type::kRToP, mesh_axis});
+    }
+
+    // the all-to-all reshapes with the global dims, so the other tensor axes
+    // must not be sharded
+    bool can_all_to_all =
+        shard_axis != -1 && dims[shard_axis] % mesh_shape[mesh_axis] == 0;
+    for (int64_t i = 0; i < tensor_ndim && can_all_to_all; ++i) {
+      can_all_to_all = i == shard_axis || state.dims_mapping[i] == -1;
+    }
+
+    for (int64_t i = 0; i < tensor_ndim; ++i) {
+      if (state.dims_mapping[i] != -1) continue;
+      if (state.is_partial(mesh_axis)) {
+        steps.push_back({ReshardStep::Type::kPToS, mesh_axis, -1, i});
+      } else if (shard_axis == -1) {
+        steps.push_back({ReshardStep::Type::kRToS, mesh_axis, -1, i});
+      } else if (can_all_to_all && dims[i] % mesh_shape[mesh_axis] == 0) {
+        steps.push_back({ReshardStep::Type::kSToS, mesh_axis, shard_axis, i});
+      }
+    }
+  }
+  return steps;
+}
+
+void AddStep(const ReshardCostModel& cost_model,
+             const DDim& dims,
+             DataType dtype,
+             const std::vector<int64_t>& mesh_shape,
+             const ReshardStep& step,
+             PlanState* state,
+             ReshardPlan* plan) {
+  const int64_t local_bytes = LocalBytes(*state, dims, dtype, mesh_shape);
+  const int64_t axis_size = mesh_shape[step.mesh_axis];
+  plan->cost += cost_model.Cost(step, local_bytes, axis_size);
+  plan->comm_bytes +=
+      ReshardCostModel::CommBytes(step.type, local_bytes, axis_size);
+  plan->steps.push_back(step);
+  *state = ApplyStep(*state, step);
+}
+
+std::vector<double> ParseBandwidths(const std::string& bandwidths) {
+  std::vector<double> result;
+  std::stringstream ss(bandwidths);
+  std::string item;
+  while (std::getline(ss, item, ',')) {
+    if (!item.empty()) result.push_back(std::stod(item));
+  }
+  return result;
+}
+
+}  // namespace
+
+std::string ReshardStep::to_string() const {
+  static const char* names[] = {"p_to_r", "p_to_s", "s_to_r", "s_to_s",
+                                "r_to_p", "r_to_s"};
+  std::stringstream ss;
+  ss << names[static_cast<int>(type)] << "(mesh_axis=" << mesh_axis;
+  if (in_tensor_axis != -1) ss << ", in_tensor_axis=" << in_tensor_axis;
+  if (out_tensor_axis != -1) ss << ", out_tensor_axis=" << out_tensor_axis;
+  ss << ")";
+  return ss.str();
+}
+
+ReshardCostModel::ReshardCostModel(std::vector<double> mesh_axis_bandwidths,
+                                   double latency)
+    : mesh_axis_bandwidths_(std::move(mesh_axis_bandwidths)),
+      latency_(latency) {
+  for (auto bandwidth : mesh_axis_bandwidths_) {
+    PADDLE_ENFORCE_GT(bandwidth,
+                      0.0,
+                      common::errors::InvalidArgument(
+                          "The bandwidth of a mesh axis should be greater "
+                          "than 0, but got %f.",
+                          bandwidth));
+  }
+}
+
+int64_t ReshardCostModel::CommBytes(ReshardStep::Type type,
+                                    int64_t local_bytes,
+                                    int64_t axis_size) {
+  switch (type) {
+    case ReshardStep::Type::kPToR:
+      // all-reduce
+      return 2 * (axis_size - 1) * local_bytes / axis_size;
+    case ReshardStep::Type::kPToS:
+      // reduce-scatter
+    case ReshardStep::Type::kSToS:
+      // all-to-all
+      return (axis_size - 1) * local_bytes / axis_size;
+    case ReshardStep::Type::kSToR:
+      // all-gather
+      return (axis_size - 1) * local_bytes;
+    case ReshardStep::Type::kRToP:
+    case ReshardStep::Type::kRToS:
+      // local
+      return 0;
+  }
+  return 0;
+}
+
+double ReshardCostModel::Cost(const ReshardStep& step,
+                              int64_t local_bytes,
+                              int64_t axis_size) const {
+  const int64_t bytes = CommBytes(step.type, local_bytes, axis_size);
+  if (bytes == 0) return 0.0;
+  double bandwidth = 1.0;
+  if (!mesh_axis_bandwidths_.empty()) {
+    bandwidth = mesh_axis_bandwidths_[std::min<size_t>(
+        step.mesh_axis, mesh_axis_bandwidths_.size() - 1)];
+  }
+  return latency_ + static_cast<double>(bytes) / (bandwidth * 1e9);
+}
+
+ReshardPlanner& ReshardPlanner::Instance() {
+  static ReshardPlanner planner(
+      ReshardCostModel(ParseBandwidths(FLAGS_reshard_mesh_axis_bandwidths)));
+  return planner;
+}
+
+std::shared_ptr<const ReshardPlan> ReshardPlanner::Plan(
+    const DDim& dims,
+    DataType dtype,
+    const TensorDistAttr& in_dist_attr,
+    const TensorDistAttr& out_dist_attr) {
+  std::string key = dims.to_str() + ";" + DataTypeToString(dtype) + ";" +
+                    in_dist_attr.to_string() + "->" +
+                    out_dist_attr.to_string();
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto iter = cache_.find(key);
+    if (iter != cache_.end()) return iter->second;
+  }
+
+  auto plan = std::make_shared<const ReshardPlan>(
+      Search(dims, dtype, in_dist_attr, out_dist_attr));
+  if (VLOG_IS_ON(3)) {
+    const auto naive = NaivePlan(dims, dtype, in_dist_attr, out_dist_attr);
+    std::stringstream ss;
+    for (const auto& step : plan->steps) ss << step.to_string() << " ";
+    VLOG(3) << "Reshard plan from " << in_dist_attr << " to " << out_dist_attr
+            << ": " << ss.str() << "sends " << plan->comm_bytes
+            << " bytes in " << plan->cost << "s, the fixed order sends "
+            << naive.comm_bytes << " bytes in " << naive.cost << "s";
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  return cache_.emplace(std::move(key), plan).first->second;
+}
+
+size_t ReshardPlanner::CacheSize() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return cache_.size();
+}
+
+ReshardPlan ReshardPlanner::Search(const DDim& dims,
+                                   DataType dtype,
+                                   const TensorDistAttr& in_dist_attr,
+                                   const TensorDistAttr& out_dist_attr) const {
+  const auto& mesh_shape = in_dist_attr.process_mesh().shape();
+  const PlanState source = ToPlanState(in_dist_attr);
+  const PlanState target = ToPlanState(out_dist_attr);
+
+  // Dijkstra over the placements, there are at most (ndim + 2) ^ mesh_ndim
+  struct Node {
+    PlanState state;
+    ReshardPlan plan;
+  };
+  std::vector<Node> nodes = {{source, ReshardPlan()}};
+  std::map<PlanState, size_t> visited = {{source, 0}};
+  using Entry = std::pair<double, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+  queue.emplace(0.0, 0);
+
+  while (!queue.empty()) {
+    auto [cost, index] = queue.top();
+    queue.pop();
+    if (cost > nodes[index].plan.cost) continue;
+    if (nodes[index].state == target) return nodes[index].plan;
+
+    for (const auto& step :
+         NextSteps(nodes[index].state, target, dims, mesh_shape)) {
+      PlanState state = nodes[index].state;
+      ReshardPlan plan = nodes[index].plan;
+      AddStep(cost_model_, dims, dtype, mesh_shape, step, &state, &plan);
+      auto iter = visited.find(state);
+      if (iter == visited.end()) {
+        visited.emplace(state, nodes.size());
+        queue.emplace(plan.cost, nodes.size());
+        nodes.push_back({std::move(state), std::move(plan)});
+      } else if (plan.cost < nodes[iter->second].plan.cost ||
+                 (plan.cost == nodes[iter->second].plan.cost &&
+                  plan.steps.size() < nodes[iter->second].plan.steps.size())) {
+        nodes[iter->second].plan = std::move(plan);
+        queue.emplace(nodes[iter->second].plan.cost, iter->second);
+      }
+    }
+  }
+
+  PADDLE_THROW(common::errors::Unimplemented(
+      "Can not plan the reshard from %s to %s.", in_dist_attr, out_dist_attr));
+}
+
+ReshardPlan ReshardPlanner::NaivePlan(
+    const DDim& dims,
+    DataType dtype,
+    const TensorDistAttr& in_dist_attr,
+    const TensorDistAttr& out_dist_attr) const {
+  const auto& mesh_shape = in_dist_attr.process_mesh().shape();
+  const auto& out_dims_mapping = out_dist_attr.dims_mapping();
+  PlanState state = ToPlanState(in_dist_attr);
+  const PlanState target = ToPlanState(out_dist_attr);
+  ReshardPlan plan;
+
+  int64_t first_diff_axis = -1;
+  for (int64_t i = static_cast<int64_t>(out_dims_mapping.size()) - 1; i >= 0;
+       --i) {
+    if (state.dims_mapping[i] != out_dims_mapping[i]) {
+      first_diff_axis = i;
+      break;
+    }
+  }
+
+  for (int64_t mesh_axis = 0;
+       mesh_axis < static_cast<int64_t>(mesh_shape.size());
+       ++mesh_axis) {
+    if (state.is_partial(mesh_axis) && !target.is_partial(mesh_axis) &&
+        target.shard_axis(mesh_axis) == -1) {
+      AddStep(cost_model_,
+              dims,
+              dtype,
+              mesh_shape,
+              {ReshardStep::Type::kPToR, mesh_axis},
+              &state,
+              &plan);
+    }
+  }
+  for (int64_t i = first_diff_axis; i >= 0; --i) {
+    if (state.dims_mapping[i] != -1) {
+      AddStep(cost_model_,
+              dims,
+              dtype,
+              mesh_shape,
+              {ReshardStep::Type::kSToR, state.dims_mapping[i], i},
+              &state,
+              &plan);
+    }
+  }
+  for (int64_t mesh_axis = 0;
+       mesh_axis < static_cast<int64_t>(mesh_shape.size());
+       ++mesh_axis) {
+    if (target.is_partial(mesh_axis) && !state.is_partial(mesh_axis)) {
+      AddStep(cost_model_,
+              dims,
+              dtype,
+              mesh_shape,
+              {ReshardStep::Type::kRToP, mesh_axis},
+              &state,
+              &plan);
+    }
+  }
+  for (int64_t i = first_diff_axis; i >= 0; --i) {
+    const int64_t mesh_axis = out_dims_mapping[i];
+    if (mesh_axis != -1) {
+      const auto type = state.is_partial(mesh_axis)
+                            ? ReshardStep::Type::kPToS
+                            : ReshardStep::Type::kRToS;
+      AddStep(cost_model_,
+              dims,
+              dtype,
+              mesh_shape,
+              {type, mesh_axis, -1, i},
+              &state,
+              &plan);
+    }
+  }
+  return plan;
+}
+
+}  // namespace phi::distributed
@@ -0,0 +1,115 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/ddim.h"
+
+namespace phi {
+namespace distributed {
+
+class TensorDistAttr;
+
+// A reshard on a single axis of the process mesh, run by the 1-d reshard
+// function of the same name on the sub mesh of that axis.
+struct ReshardStep {
+  enum class Type { kPToR, kPToS, kSToR, kSToS, kRToP, kRToS };
+
+  Type type;
+  int64_t mesh_axis;
+  // the tensor axis sharded by mesh_axis before the step, -1 if none
+  int64_t in_tensor_axis = -1;
+  // the tensor axis sharded by mesh_axis after the step, -1 if none
+  int64_t out_tensor_axis = -1;
+
+  std::string to_string() const;
+};
+
+struct ReshardPlan {
+  std::vector<ReshardStep> steps;
+  // estimated seconds of the communication
+  double cost = 0.0;
+  // bytes sent by each rank
+  int64_t comm_bytes = 0;
+};
+
+// Estimates a step with the bandwidth of its mesh axis and the bytes each
+// rank sends with the ring algorithms, plus a fixed latency per collective.
+class ReshardCostModel {
+ public:
+  // in GB/s per mesh axis, the axes not given use the last one
+  explicit ReshardCostModel(std::vector<double> mesh_axis_bandwidths = {},
+                            double latency = 1e-5);
+
+  // Bytes sent by each rank of a mesh axis of `axis_size` ranks, each with
+  // `local_bytes` before the step.
+  static int64_t CommBytes(ReshardStep::Type type,
+                           int64_t local_bytes,
+                           int64_t axis_size);
+
+  double Cost(const ReshardStep& step,
+              int64_t local_bytes,
+              int64_t axis_size) const;
+
+ private:
+  std::vector<double> mesh_axis_bandwidths_;
+  double latency_;
+};
+
+// Searches the sequence of 1-d reshards with the least cost between two dist
+// attrs on the same N-d mesh, e.g. an all-to-all instead of shard ->
+// replicated -> shard. The plans are cached by the shape, the dtype and the
+// pair of dist attrs.
+class ReshardPlanner {
+ public:
+  // Uses FLAGS_reshard_mesh_axis_bandwidths
+  static ReshardPlanner& Instance();
+
+  explicit ReshardPlanner(ReshardCostModel cost_model)
+      : cost_model_(std::move(cost_model)) {}
+
+  std::shared_ptr<const ReshardPlan> Plan(const DDim& dims,
+                                          DataType dtype,
+                                          const TensorDistAttr& in_dist_attr,
+                                          const TensorDistAttr& out_dist_attr);
+
+  // The plan of the fixed order of SameNdMeshReshardFunction: partial to
+  // replicated, shard to replicated, replicated to partial, then to shard.
+  ReshardPlan NaivePlan(const DDim& dims,
+                        DataType dtype,
+                        const TensorDistAttr& in_dist_attr,
+                        const TensorDistAttr& out_dist_attr) const;
+
+  size_t CacheSize();
+
+ private:
+  ReshardPlan Search(const DDim& dims,
+                     DataType dtype,
+                     const TensorDistAttr& in_dist_attr,
+                     const TensorDistAttr& out_dist_attr) const;
+
+  ReshardCostModel cost_model_;
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<const ReshardPlan>> cache_;
+};
+
+}  // namespace distributed
+}  // namespace phi
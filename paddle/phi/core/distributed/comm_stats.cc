@@ -0,0 +1,182 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/distributed/comm_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/api/profiler/common_event.h"
+#include "paddle/phi/api/profiler/event_tracing.h"
+#include "paddle/phi/api/profiler/host_event_recorder.h"
+#include "paddle/phi/api/profiler/host_tracer.h"
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/os_info.h"
+
+COMMON_DECLARE_int32(comm_stats_sample_interval);
+PHI_DECLARE_bool(enable_host_event_recorder_hook);
+
+namespace phi::distributed {
+
+// the samples of the collectives that never complete are bounded
+constexpr size_t kMaxPendingSamples = 1024;
+
+void CommOpStats::Add(double latency_us, int64_t sample_bytes) {
+  int bucket = latency_us < 2.0 ? 0 : static_cast<int>(std::log2(latency_us));
+  ++buckets[std::min(bucket, kNumBuckets - 1)];
+  min_us = count == 0 ? latency_us : std::min(min_us, latency_us);
+  max_us = std::max(max_us, latency_us);
+  total_us += latency_us;
+  bytes += sample_bytes;
+  ++count;
+}
+
+bool CommStatsManager::ShouldSample() {
+  const int interval = FLAGS_comm_stats_sample_interval;
+  if (interval <= 0) {
+    return false;
+  }
+  return num_comms_.fetch_add(1, std::memory_order_relaxed) % interval == 0;
+}
+
+gpuEvent_t CommStatsManager::GetEvent(int device) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& events = free_events_[device];
+    if (!events.empty()) {
+      gpuEvent_t event = events.back();
+      events.pop_back();
+      return event;
+    }
+  }
+  backends::gpu::GPUDeviceGuard guard(device);
+  gpuEvent_t event;
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventCreate(&event));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreate(&event));
+#endif
+  return event;
+}
+
+CommStatsManager::Sample CommStatsManager::StartSample(int device,
+                                                       gpuStream_t stream) {
+  Sample sample;
+  sample.device = device;
+  sample.start = GetEvent(device);
+  sample.host_start_ns = PosixInNsec();
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(sample.start, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(sample.start, stream));
+#endif
+  return sample;
+}
+
+void CommStatsManager::EndSample(const Sample& sample,
+                                 const std::string& group_key,
+                                 CommType comm_type,
+                                 int64_t bytes,
+                                 gpuStream_t stream) {
+  gpuEvent_t end = GetEvent(sample.device);
+#ifdef PADDLE_WITH_HIP
+  PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(end, stream));
+#else
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(end, stream));
+#endif
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  CollectCompleted();
+  if (pending_.size() >= kMaxPendingSamples) {
+    free_events_[sample.device].push_back(sample.start);
+    free_events_[sample.device].push_back(end);
+    return;
+  }
+  pending_.push_back({sample, end, group_key, comm_type, bytes});
+}
+
+void CommStatsManager::CollectCompleted() {
+  for (auto iter = pending_.begin(); iter != pending_.end();) {
+#ifdef PADDLE_WITH_HIP
+    hipError_t ret = hipEventQuery(iter->end);
+    if (ret == hipErrorNotReady) {
+      // ignore and clear the error if not ready
+      (void)hipGetLastError();
+      ++iter;
+      continue;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(ret);
+    float elapsed_ms = 0.0f;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipEventElapsedTime(&elapsed_ms, iter->sample.start, iter->end));
+#else
+    cudaError_t ret = cudaEventQuery(iter->end);
+    if (ret == cudaErrorNotReady) {
+      // ignore and clear the error if not ready
+      (void)cudaGetLastError();
+      ++iter;
+      continue;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(ret);
+    float elapsed_ms = 0.0f;
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaEventElapsedTime(&elapsed_ms, iter->sample.start, iter->end));
+#endif
+    const double latency_us = static_cast<double>(elapsed_ms) * 1000.0;
+    auto& stats = stats_[{iter->group_key, iter->comm_type}];
+    if (stats.count == 0) {
+      stats.group_key = iter->group_key;
+      stats.comm_type = iter->comm_type;
+    }
+    stats.Add(latency_us, iter->bytes);
+
+    // the device time of the collective, from the host time it was issued
+    if (HostTraceLevel::GetInstance().NeedTrace(kDefaultTraceLevel) &&
+        FLAGS_enable_host_event_recorder_hook) {
+      const uint64_t start_ns = iter->sample.host_start_ns;
+      HostEventRecorder<CommonEvent>::GetInstance().RecordEvent(
+          CommTypeToString(iter->comm_type) + ":" + iter->group_key,
+          start_ns,
+          start_ns + static_cast<uint64_t>(latency_us * 1000.0),
+          EventRole::kOrdinary,
+          TracerEventType::Communication);
+    }
+
+    auto& events = free_events_[iter->sample.device];
+    events.push_back(iter->sample.start);
+    events.push_back(iter->end);
+    iter = pending_.erase(iter);
+  }
+}
+
+std::vector<CommOpStats> CommStatsManager::GetStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CollectCompleted();
+  std::vector<CommOpStats> stats;
+  stats.reserve(stats_.size());
+  for (const auto& item : stats_) {
+    stats.push_back(item.second);
+  }
+  return stats;
+}
+
+void CommStatsManager::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CollectCompleted();
+  stats_.clear();
+}
+
+}  // namespace phi::distributed
@@ -0,0 +1,107 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/backends/gpu/gpu_decls.h"
+#include "paddle/phi/core/distributed/utils.h"
+
+namespace phi {
+namespace distributed {
+
+// The latency histogram and the bytes of one type of collective of a group.
+struct CommOpStats {
+  // bucket i counts the latencies in [2^i, 2^(i+1)) microseconds, the first
+  // bucket also counts the shorter ones and the last one the longer ones
+  static constexpr int kNumBuckets = 24;
+
+  std::string group_key;
+  CommType comm_type = CommType::UNKNOWN;
+  int64_t count = 0;
+  int64_t bytes = 0;
+  double total_us = 0.0;
+  double min_us = 0.0;
+  double max_us = 0.0;
+  std::vector<int64_t> buckets = std::vector<int64_t>(kNumBuckets, 0);
+
+  void Add(double latency_us, int64_t sample_bytes);
+};
+
+// Samples one in FLAGS_comm_stats_sample_interval collectives with timing
+// events on their stream. A sample is collected once its end event has
+// completed, when the next sample is taken or the stats are read, so the
+// host never waits for a collective. The samples are also recorded as
+// communication events of the profiler while it is enabled.
+class CommStatsManager {
+ public:
+  struct Sample {
+    int device = -1;
+    gpuEvent_t start = nullptr;
+    uint64_t host_start_ns = 0;
+  };
+
+  static CommStatsManager& GetInstance() {
+    static CommStatsManager instance;
+    return instance;
+  }
+
+  // counts the collectives, true for the ones to sample
+  bool ShouldSample();
+  Sample StartSample(int device, gpuStream_t stream);
+  void EndSample(const Sample& sample,
+                 const std::string& group_key,
+                 CommType comm_type,
+                 int64_t bytes,
+                 gpuStream_t stream);
+
+  std::vector<CommOpStats> GetStats();
+  void Reset();
+
+ private:
+  CommStatsManager() = default;
+
+  struct PendingSample {
+    Sample sample;
+    gpuEvent_t end;
+    std::string group_key;
+    CommType comm_type;
+    int64_t bytes;
+  };
+
+  gpuEvent_t GetEvent(int device);
+  // requires mutex_
+  void CollectCompleted();
+
+  std::atomic<uint64_t> num_comms_{0};
+  std::mutex mutex_;
+  std::list<PendingSample> pending_;
+  std::map<std::pair<std::string, CommType>, CommOpStats> stats_;
+  // device -> the events of the collected samples
+  std::unordered_map<int, std::vector<gpuEvent_t>> free_events_;
+
+  DISABLE_COPY_AND_ASSIGN(CommStatsManager);
+};
+
+}  // namespace distributed
+}  // namespace phi
@@ -17,6 +17,7 @@
 
 #include <gloo/allgather.h>
 #include <gloo/allreduce.h>
+#include <gloo/allreduce_halving_doubling.h>
 #include <gloo/barrier.h>
 #include <gloo/broadcast.h>
 #include <gloo/gather.h>
@@ -24,13 +25,56 @@
 #include <gloo/scatter.h>
 #include <gloo/types.h>
 
+#include <cstring>
+
+#include "paddle/common/flags.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/distributed/check/static_check.h"
 #include "paddle/phi/core/enforce.h"
 
+COMMON_DECLARE_int64(gloo_allreduce_halving_doubling_bytes);
+
 namespace phi::distributed {
 
+namespace {
+
+// in may equal out, the allreduce is then done in place
+template <typename T>
+void AllReduceData(const std::shared_ptr<gloo::rendezvous::Context>& context,
+                   const void* in,
+                   void* out,
+                   size_t count,
+                   int reduce_type,
+                   uint32_t tag) {
+  if (count == 0) {
+    return;
+  }
+  T* out_data = static_cast<T*>(out);
+  if (static_cast<ReduceType>(reduce_type) == ReduceType::kRedSum &&
+      static_cast<int64_t>(count * sizeof(T)) <=
+          FLAGS_gloo_allreduce_halving_doubling_bytes) {
+    static const gloo::ReductionFunction<T> sum(gloo::SUM, &SumInPlace<T>);
+    if (in != out) {
+      std::memcpy(out, in, count * sizeof(T));
+    }
+    gloo::AllreduceHalvingDoubling<T> algorithm(
+        context, std::vector<T*>{out_data}, static_cast<int>(count), &sum);
+    algorithm.run();
+    return;
+  }
+  gloo::AllreduceOptions opts(context);
+  opts.setTag(tag);
+  if (in != out) {
+    opts.setInput(static_cast<T*>(const_cast<void*>(in)), count);
+  }
+  opts.setOutput(out_data, count);
+  SetReduceFunc<T>(&opts, reduce_type);
+  gloo::allreduce(opts);
+}
+
+}  // namespace
+
 GlooCommContext::GlooCommContext(
     int rank,
     int size,
@@ -80,13 +124,78 @@ void GlooCommContext::AllReduce(phi::DenseTensor* out_tensor,
                                 const phi::DenseTensor& in_tensor,
                                 int reduce_type,
                                 uint32_t tag) {
-  gloo::AllreduceOptions opts(gloo_context_);
-  opts.setTag(tag);
   const auto& dtype = in_tensor.dtype();
-  GENERATE_FUNC(dtype, SetInput, &opts, in_tensor);
-  GENERATE_FUNC(dtype, SetOutput, &opts, out_tensor);
-  GENERATE_FUNC(dtype, SetReduceFunc, &opts, reduce_type);
-  gloo::allreduce(opts);
+  GENERATE_FUNC(dtype,
+                AllReduceData,
+                gloo_context_,
+                in_tensor.data(),
+                out_tensor->data(),
+                static_cast<size_t>(out_tensor->numel()),
+                reduce_type,
+                tag);
+}
+
+void GlooCommContext::AllReduce(
+    const std::vector<phi::DenseTensor*>& out_tensors,
+    const std::vector<phi::DenseTensor>& in_tensors,
+    int reduce_type,
+    uint32_t tag) {
+  PADDLE_ENFORCE_EQ(
+      out_tensors.size(),
+      in_tensors.size(),
+      common::errors::InvalidArgument(
+          "The number of output tensors (%d) of the coalesced allreduce must "
+          "equal the number of input tensors (%d).",
+          out_tensors.size(),
+          in_tensors.size()));
+  if (in_tensors.empty()) {
+    return;
+  }
+  const auto& dtype = in_tensors[0].dtype();
+  size_t total_bytes = 0;
+  for (size_t i = 0; i < in_tensors.size(); ++i) {
+    PADDLE_ENFORCE_EQ(
+        in_tensors[i].dtype(),
+        dtype,
+        common::errors::InvalidArgument(
+            "The tensors of the coalesced allreduce must have the same dtype, "
+            "but tensor %d is %s and tensor 0 is %s.",
+            i,
+            in_tensors[i].dtype(),
+            dtype));
+    PADDLE_ENFORCE_EQ(
+        out_tensors[i]->numel(),
+        in_tensors[i].numel(),
+        common::errors::InvalidArgument(
+            "The output and input of the coalesced allreduce must have the "
+            "same numel, but tensor %d has %d and %d.",
+            i,
+            out_tensors[i]->numel(),
+            in_tensors[i].numel()));
+    total_bytes += in_tensors[i].numel() * phi::SizeOf(dtype);
+  }
+
+  std::vector<uint8_t> buffer(total_bytes);
+  size_t offset = 0;
+  for (const auto& in_tensor : in_tensors) {
+    size_t bytes = in_tensor.numel() * phi::SizeOf(dtype);
+    std::memcpy(buffer.data() + offset, in_tensor.data(), bytes);
+    offset += bytes;
+  }
+  GENERATE_FUNC(dtype,
+                AllReduceData,
+                gloo_context_,
+                buffer.data(),
+                buffer.data(),
+                total_bytes / phi::SizeOf(dtype),
+                reduce_type,
+                tag);
+  offset = 0;
+  for (auto* out_tensor : out_tensors) {
+    size_t bytes = out_tensor->numel() * phi::SizeOf(dtype);
+    std::memcpy(out_tensor->data(), buffer.data() + offset, bytes);
+    offset += bytes;
+  }
 }
 
 void GlooCommContext::Reduce(phi::DenseTensor* out_tensor,
@@ -18,6 +18,7 @@
 #include <gloo/transport/tcp/device.h>
 
 #include <memory>
+#include <vector>
 
 #include "paddle/common/macros.h"
 #include "paddle/phi/core/distributed/comm_context.h"
@@ -43,6 +44,13 @@ class GlooCommContext final : public CommContext {
                  int reduce_type,
                  uint32_t tag = 0);
 
+  // Allreduces the tensors, which must share the dtype, as one buffer so
+  // that small tensors pay the latency of a single collective.
+  void AllReduce(const std::vector<phi::DenseTensor*>& out_tensors,
+                 const std::vector<phi::DenseTensor>& in_tensors,
+                 int reduce_type,
+                 uint32_t tag = 0);
+
   void Reduce(phi::DenseTensor* out_tensor,
               const phi::DenseTensor& in_tensor,
               int reduce_type,
@@ -26,7 +26,12 @@
 #include <cstdlib>
 #include <cstring>
 
+#if defined(__AVX__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
 #include "paddle/common/errors.h"
+#include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/core/distributed/gloo_utils.h"
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
 #include "paddle/phi/core/enforce.h"
@@ -90,6 +95,86 @@ std::shared_ptr<gloo::transport::Device> CreateGlooDevice() {
   }
 }
 
+void VecSumFloat(void* c, const void* a, const void* b, size_t n) {
+  float* out = static_cast<float*>(c);
+  const float* x = static_cast<const float*>(a);
+  const float* y = static_cast<const float*>(b);
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(
+        out + i, _mm512_add_ps(_mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+  }
+#elif defined(__AVX__)
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(
+        out + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = x[i] + y[i];
+  }
+}
+
+void VecSumBFloat16(void* c, const void* a, const void* b, size_t n) {
+  using phi::dtype::bfloat16;
+  bfloat16* out = static_cast<bfloat16*>(c);
+  const bfloat16* x = static_cast<const bfloat16*>(a);
+  const bfloat16* y = static_cast<const bfloat16*>(b);
+  size_t i = 0;
+  // a bfloat16 is the high half of a float, the sum is rounded to nearest
+  // even and NaN becomes 0x7FFF as in cpu_float_to_bfloat16
+#if defined(__AVX512F__)
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i bias = _mm512_set1_epi32(0x7FFF);
+  const __m512i nan = _mm512_set1_epi32(0x7FFF);
+  for (; i + 16 <= n; i += 16) {
+    __m512 fx = _mm512_castsi512_ps(_mm512_slli_epi32(
+        _mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i))),
+        16));
+    __m512 fy = _mm512_castsi512_ps(_mm512_slli_epi32(
+        _mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i))),
+        16));
+    __m512 sum = _mm512_add_ps(fx, fy);
+    __m512i bits = _mm512_castps_si512(sum);
+    __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16), one);
+    bits = _mm512_srli_epi32(
+        _mm512_add_epi32(bits, _mm512_add_epi32(bias, lsb)), 16);
+    bits = _mm512_mask_mov_epi32(
+        bits, _mm512_cmp_ps_mask(sum, sum, _CMP_UNORD_Q), nan);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                        _mm512_cvtepi32_epi16(bits));
+  }
+#elif defined(__SSE4_1__)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi32(1);
+  const __m128i bias = _mm_set1_epi32(0x7FFF);
+  const __m128i nan = _mm_set1_epi32(0x7FFF);
+  auto round = [&](__m128 sum) {
+    __m128i bits = _mm_castps_si128(sum);
+    __m128i lsb = _mm_and_si128(_mm_srli_epi32(bits, 16), one);
+    bits = _mm_srli_epi32(_mm_add_epi32(bits, _mm_add_epi32(bias, lsb)), 16);
+    __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(sum, sum));
+    return _mm_blendv_epi8(bits, nan, is_nan);
+  };
+  for (; i + 8 <= n; i += 8) {
+    __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + i));
+    __m128 lo = _mm_add_ps(_mm_castsi128_ps(_mm_unpacklo_epi16(zero, vx)),
+                           _mm_castsi128_ps(_mm_unpacklo_epi16(zero, vy)));
+    __m128 hi = _mm_add_ps(_mm_castsi128_ps(_mm_unpackhi_epi16(zero, vx)),
+                           _mm_castsi128_ps(_mm_unpackhi_epi16(zero, vy)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                     _mm_packus_epi32(round(lo), round(hi)));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = x[i] + y[i];
+  }
+}
+
 void send_recv(SendRecvOptions* opts) {
   const auto& context = opts->context;
   gloo::transport::UnboundBuffer* in = opts->in.get();
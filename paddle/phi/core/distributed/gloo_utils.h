@@ -22,6 +22,7 @@
 #include <climits>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 #include "glog/logging.h"
 
@@ -117,15 +118,35 @@ void SetInputForScatter(P* opts, const phi::DenseTensor& tensor, int nranks) {
   opts->setInputs(ret, tensor.numel() / nranks);
 }
 
+// c = a + b of n elements, vectorized with AVX-512 or AVX when the library
+// is compiled for them. gloo::sum is a scalar loop, and converts bfloat16
+// through float one element at a time.
+void VecSumFloat(void* c, const void* a, const void* b, size_t n);
+void VecSumBFloat16(void* c, const void* a, const void* b, size_t n);
+
+template <typename T>
+void (*GetSumFunc())(void*, const void*, const void*, size_t) {
+  if (std::is_same<T, float>::value) {
+    return &VecSumFloat;
+  } else if (std::is_same<T, phi::dtype::bfloat16>::value) {
+    return &VecSumBFloat16;
+  }
+  return static_cast<void (*)(void*, const void*, const void*, size_t)>(
+      &gloo::sum<T>);
+}
+
+template <typename T>
+void SumInPlace(T* x, const T* y, size_t n) {
+  GetSumFunc<T>()(x, x, y, n);
+}
+
 template <typename T, typename P>
 void SetReduceFunc(P* opts, int reduce_type) {
   // gloo only support mutable data input
   ReduceType reduce_type_enum = static_cast<ReduceType>(reduce_type);
   switch (reduce_type_enum) {
     case ReduceType::kRedSum:
-      opts->setReduceFunction(
-          static_cast<void (*)(void*, const void*, const void*, size_t)>(
-              &gloo::sum<T>));
+      opts->setReduceFunction(GetSumFunc<T>());
       break;
     case ReduceType::kRedMax:
       opts->setReduceFunction(
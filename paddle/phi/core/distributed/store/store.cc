@@ -42,4 +42,26 @@ void Store::set(const std::string& key, const std::vector<uint8_t>& value) {
       errors::InvalidArgument("Implement the set method in the subclass."));
 }
 
+std::vector<std::vector<uint8_t>> Store::multi_get(
+    const std::vector<std::string>& keys) {
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (const auto& key : keys) {
+    values.push_back(get(key));
+  }
+  return values;
+}
+
+void Store::multi_wait(const std::vector<std::string>& keys) {
+  for (const auto& key : keys) {
+    wait(key);
+  }
+}
+
+std::map<std::string, std::vector<uint8_t>> Store::wait_prefix(
+    const std::string& prefix, size_t count) {
+  PADDLE_THROW(errors::InvalidArgument(
+      "Implement the wait_prefix method in the subclass."));
+}
+
 }  // namespace phi::distributed
@@ -15,6 +15,7 @@
 #pragma once
 #include <chrono>
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,14 @@ class Store {
   virtual bool check(const std::string& key);
   virtual void wait(const std::string& key);
   virtual void set(const std::string& key, const std::vector<uint8_t>& value);
+  // batched get and wait, one round trip for all the keys
+  virtual std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys);
+  virtual void multi_wait(const std::vector<std::string>& keys);
+  // waits for at least `count` keys starting with `prefix`, returns all of
+  // them with their values
+  virtual std::map<std::string, std::vector<uint8_t>> wait_prefix(
+      const std::string& prefix, size_t count);
 
   virtual int timeout() { return _timeout; }
 
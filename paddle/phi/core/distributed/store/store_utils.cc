@@ -20,8 +20,11 @@
 // there will be symbol redefinition error on windows
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/distributed/auto_parallel/utils.h"
 
+COMMON_DECLARE_int32(tcp_store_relay_fanout);
+
 namespace phi::distributed {
 using auto_parallel::str_split;
 
@@ -43,6 +46,53 @@ std::string GetMasterEndpoint() {
           "The environment variable 'PADDLE_MASTER' cannot be found."));
   return master_endpoint;
 }
+
+std::vector<std::string> GetTrainerEndpoints() {
+  const char* trainer_endpoints = std::getenv("PADDLE_TRAINER_ENDPOINTS");
+  PADDLE_ENFORCE_NOT_NULL(
+      trainer_endpoints,
+      common::errors::NotFound("The environment variable "
+                               "'PADDLE_TRAINER_ENDPOINTS' cannot be found."));
+  return str_split(trainer_endpoints, ",");
+}
+
+// The rank r connects to the relay of the rank (r - 1) / fanout, the ranks
+// 1 to fanout connect to the master.
+std::shared_ptr<TCPStore> CreateRelayTCPStore(const std::string& master_host,
+                                              uint16_t master_port,
+                                              int64_t cur_rank,
+                                              int64_t world_size,
+                                              int64_t fanout) {
+  if (cur_rank == 0) {
+    return std::make_shared<TCPStore>(
+        master_host, master_port, true, world_size);
+  }
+  auto endpoints = GetTrainerEndpoints();
+  PADDLE_ENFORCE_EQ(static_cast<int64_t>(endpoints.size()),
+                    world_size,
+                    common::errors::InvalidArgument(
+                        "The number of PADDLE_TRAINER_ENDPOINTS (%d) should "
+                        "be the world size (%d).",
+                        endpoints.size(),
+                        world_size));
+
+  std::string host = master_host;
+  uint16_t port = master_port;
+  int64_t parent = (cur_rank - 1) / fanout;
+  if (parent > 0) {
+    auto parent_endpoint = str_split(endpoints[parent], ":");
+    host = parent_endpoint[0];
+    port = std::stoi(parent_endpoint[1]);
+  }
+  uint16_t relay_port = 0;
+  if (cur_rank * fanout + 1 < world_size) {
+    relay_port = std::stoi(str_split(endpoints[cur_rank], ":")[1]);
+  }
+  VLOG(3) << "TCPStore of rank " << cur_rank << " connects to " << host << ":"
+          << port << ", relay port " << relay_port;
+  return std::make_shared<TCPStore>(
+      host, port, false, world_size, 900, relay_port);
+}
 }  // namespace
 
 int64_t GetCurGlobalRank() {
@@ -78,8 +128,12 @@ std::shared_ptr<Store> CreateOrGetGlobalTCPStore() {
   int64_t world_size = GetGlobalWorldSize();
   bool is_master = (cur_rank == 0);
 
+  int64_t fanout = FLAGS_tcp_store_relay_fanout;
+
   static std::shared_ptr<TCPStore> store =
-      std::make_shared<TCPStore>(host, port, is_master, world_size);
+      fanout > 0 && world_size > fanout + 1
+          ? CreateRelayTCPStore(host, port, cur_rank, world_size, fanout)
+          : std::make_shared<TCPStore>(host, port, is_master, world_size);
   return store;
 }
 
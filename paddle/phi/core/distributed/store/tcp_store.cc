@@ -14,6 +14,7 @@
 
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -27,15 +28,28 @@ namespace phi::distributed::detail {
 
 constexpr int INFTIME = 10000;  // 10 seconds
 
-std::unique_ptr<MasterDaemon> MasterDaemon::start(SocketType socket,
-                                                  int nranks,
-                                                  int timeout) {
+std::unique_ptr<MasterDaemon> MasterDaemon::start(
+    SocketType socket,
+    int nranks,
+    int timeout,
+    const std::string& upstream_host,
+    uint16_t upstream_port) {
   VLOG(8) << ("begin to run start");
-  return std::make_unique<MasterDaemon>(socket, nranks, timeout);
+  return std::make_unique<MasterDaemon>(
+      socket, nranks, timeout, upstream_host, upstream_port);
 }
 
-MasterDaemon::MasterDaemon(SocketType socket, int nranks, int timeout)
+MasterDaemon::MasterDaemon(SocketType socket,
+                           int nranks,
+                           int timeout,
+                           const std::string& upstream_host,
+                           uint16_t upstream_port)
     : _listen_socket(socket), _nranks(nranks), _timeout(timeout) {
+  if (!upstream_host.empty()) {
+    VLOG(3) << "TCPStore: relay to " << upstream_host << ":" << upstream_port;
+    _upstream = TCPClient::connect(upstream_host, upstream_port);
+    _upstream_waits = TCPClient::connect(upstream_host, upstream_port);
+  }
   InitControlFd();
   _background_thread = std::thread{&MasterDaemon::run, this};
 }
@@ -55,18 +69,25 @@ void MasterDaemon::_do_add(SocketType socket) {
   int64_t new_value{};
   std::string key = tcputils::receive_string(socket);
   new_value = tcputils::receive_value<int64_t>(socket);
-  std::vector<uint8_t> old_value;
-  auto it = _store.find(key);
-  if (it != _store.end()) {
-    old_value = it->second;
-    char* buffer = reinterpret_cast<char*>(it->second.data());
-    size_t len = old_value.size();
-    new_value += std::stoll(std::string(buffer, len));
+  if (_is_relay()) {
+    _upstream->send_command_for_key(Command::ADD, key);
+    _upstream->send_value<int64_t>(new_value);
+    new_value = _upstream->receive_value<int64_t>();
+  } else {
+    std::vector<uint8_t> old_value;
+    auto it = _store.find(key);
+    if (it != _store.end()) {
+      old_value = it->second;
+      char* buffer = reinterpret_cast<char*>(it->second.data());
+      size_t len = old_value.size();
+      new_value += std::stoll(std::string(buffer, len));
+    }
   }
 
   std::string new_value_str = std::to_string(new_value);
   _store[key] =
       std::vector<uint8_t>(new_value_str.begin(), new_value_str.end());
+  _counter_keys.insert(key);
   VLOG(8) << "TCPStore: new value (" << new_value << ") for key (" << key
           << ") " << GetSockName(socket);
   tcputils::send_value<int64_t>(socket, new_value);
@@ -78,13 +99,24 @@ void MasterDaemon::_do_set(SocketType socket) {
   VLOG(8) << "MasterDaemon::_do_set key(" << key << ") " << GetSockName(socket);
 
   auto value = tcputils::receive_vector<uint8_t>(socket);
+  if (_is_relay()) {
+    _upstream->send_command_for_key(Command::SET, key);
+    _upstream->send_vector<uint8_t>(value);
+  }
   _store[key] = value;
+  _counter_keys.erase(key);
   _notify_waiting_sockets(key);
 }
 
 void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
   if (_waiting_sockets.find(key) != _waiting_sockets.end()) {
     for (auto waiting_socket : _waiting_sockets.at(key)) {
+      // a socket of MULTI_WAIT is notified once all its keys are ready
+      auto count_iter = _waiting_counts.find(waiting_socket);
+      if (count_iter == _waiting_counts.end() || --count_iter->second > 0) {
+        continue;
+      }
+      _waiting_counts.erase(count_iter);
       auto reply = ReplyType::STOP_WAIT;
       VLOG(7) << "TCPStore: notify the socket: " << GetSockName(waiting_socket)
               << " that key: " << key << " is ready.";
@@ -92,21 +124,132 @@ void MasterDaemon::_notify_waiting_sockets(const std::string& key) {
     }
     _waiting_sockets.erase(key);
   }
+
+  auto get_iter = _waiting_get_sockets.find(key);
+  if (get_iter != _waiting_get_sockets.end()) {
+    auto waiting_sockets = std::move(get_iter->second);
+    _waiting_get_sockets.erase(get_iter);
+    for (auto waiting_socket : waiting_sockets) {
+      _send_entries(waiting_socket, {key});
+    }
+  }
+
+  for (size_t i = 0; i < _prefix_waiters.size();) {
+    const auto& waiter = _prefix_waiters[i];
+    if (key.compare(0, waiter.prefix.size(), waiter.prefix) == 0 &&
+        _count_prefix(waiter.prefix) >= waiter.count) {
+      auto ready = waiter;
+      _prefix_waiters.erase(_prefix_waiters.begin() + i);
+      _send_prefix_entries(ready.socket, ready.prefix);
+    } else {
+      ++i;
+    }
+  }
+  _upstream_waiting_keys.erase(key);
 }
 
-void MasterDaemon::_do_get(SocketType socket) {
-  std::string key = tcputils::receive_string(socket);
-  VLOG(8) << "MasterDaemon::_do_get key(" << key << ") " << GetSockName(socket);
+void MasterDaemon::_remove_waiting_socket(SocketType socket) {
+  for (auto* waiting : {&_waiting_sockets, &_waiting_get_sockets}) {
+    auto map_iter = waiting->begin();
+    while (map_iter != waiting->end()) {
+      auto& sockets = map_iter->second;
+      sockets.erase(std::remove(sockets.begin(), sockets.end(), socket),
+                    sockets.end());
+      if (sockets.empty()) {
+        map_iter = waiting->erase(map_iter);
+      } else {
+        ++map_iter;
+      }
+    }
+  }
+  _waiting_counts.erase(socket);
+  _prefix_waiters.erase(
+      std::remove_if(_prefix_waiters.begin(),
+                     _prefix_waiters.end(),
+                     [socket](const PrefixWaiter& waiter) {
+                       return waiter.socket == socket;
+                     }),
+      _prefix_waiters.end());
+}
 
+std::vector<uint8_t> MasterDaemon::_get_value(const std::string& key) {
   auto iter = _store.find(key);
   PADDLE_ENFORCE_NE(
       iter,
       _store.end(),
       common::errors::InvalidArgument("Key %s not found in TCPStore.", key));
-  std::vector<uint8_t> value = iter->second;
+  if (_is_relay() && _counter_keys.count(key) > 0) {
+    // the counters are only up to date on the master
+    _upstream->send_command_for_key(Command::GET, key);
+    iter->second = _upstream->receive_vector<uint8_t>();
+  }
+  return iter->second;
+}
+
+size_t MasterDaemon::_count_prefix(const std::string& prefix) const {
+  size_t count = 0;
+  for (auto iter = _store.lower_bound(prefix);
+       iter != _store.end() &&
+       iter->first.compare(0, prefix.size(), prefix) == 0;
+       ++iter) {
+    ++count;
+  }
+  return count;
+}
+
+// Replies the keys with their values and whether a relay may cache them.
+void MasterDaemon::_send_entries(SocketType socket,
+                                 const std::vector<std::string>& keys) {
+  tcputils::send_value<size_t>(socket, keys.size());
+  for (const auto& key : keys) {
+    tcputils::send_string(socket, key);
+    tcputils::send_value<bool>(socket, _counter_keys.count(key) == 0);
+    tcputils::send_vector<uint8_t>(socket, _store.at(key));
+  }
+}
+
+void MasterDaemon::_send_prefix_entries(SocketType socket,
+                                        const std::string& prefix) {
+  std::vector<std::string> keys;
+  for (auto iter = _store.lower_bound(prefix);
+       iter != _store.end() &&
+       iter->first.compare(0, prefix.size(), prefix) == 0;
+       ++iter) {
+    keys.push_back(iter->first);
+  }
+  for (const auto& key : keys) {
+    _get_value(key);
+  }
+  _send_entries(socket, keys);
+}
+
+void MasterDaemon::_do_get(SocketType socket) {
+  std::string key = tcputils::receive_string(socket);
+  VLOG(8) << "MasterDaemon::_do_get key(" << key << ") " << GetSockName(socket);
+
+  std::vector<uint8_t> value = _get_value(key);
   tcputils::send_vector<uint8_t>(socket, value);
 }
 
+void MasterDaemon::_do_multi_get(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys(num_keys);
+  for (auto& key : keys) {
+    key = tcputils::receive_string(socket);
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_get " << num_keys << " keys "
+          << GetSockName(socket);
+
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(num_keys);
+  for (const auto& key : keys) {
+    values.push_back(_get_value(key));
+  }
+  for (const auto& value : values) {
+    tcputils::send_vector<uint8_t>(socket, value);
+  }
+}
+
 void MasterDaemon::_do_check(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(4) << "MasterDaemon::_do_check key(" << key << ") "
@@ -115,6 +258,10 @@ void MasterDaemon::_do_check(SocketType socket) {
   auto iter = _store.find(key);
   if (iter != _store.end()) {
     tcputils::send_value<ReplyType>(socket, ReplyType::READY);
+  } else if (_is_relay()) {
+    _upstream->send_command_for_key(Command::CHECK, key);
+    tcputils::send_value<ReplyType>(socket,
+                                    _upstream->receive_value<ReplyType>());
   } else {
     tcputils::send_value<ReplyType>(socket, ReplyType::NOT_READY);
   }
@@ -157,33 +304,109 @@ void MasterDaemon::CloseControlFd() { CloseHandle(ghStopEvent_); }
 void MasterDaemon::StopByControlFd() { SetEvent(ghStopEvent_); }
 #endif
 
+void MasterDaemon::_wait_keys(SocketType socket,
+                              const std::vector<std::string>& keys) {
+  size_t num_waiting = 0;
+  std::vector<std::string> upstream_keys;
+  for (const auto& key : keys) {
+    if (_store.find(key) != _store.end()) {
+      continue;
+    }
+    // The key can not be found in store currently. Record and check later.
+    _waiting_sockets[key].emplace_back(socket);
+    ++num_waiting;
+    if (_is_relay() && _upstream_waiting_keys.insert(key).second) {
+      upstream_keys.push_back(key);
+    }
+  }
+
+  if (num_waiting == 0) {
+    auto reply = ReplyType::STOP_WAIT;
+    VLOG(7) << "TCPStore: wait reply (" << static_cast<int>(reply) << ") for "
+            << keys.size() << " keys.";
+    tcputils::send_value<ReplyType>(socket, reply);
+  } else {
+    _waiting_counts[socket] = num_waiting;
+  }
+  // the waits of the whole subtree on a key share one WAIT_GET upstream
+  for (const auto& key : upstream_keys) {
+    _upstream_waits->send_command_for_key(Command::WAIT_GET, key);
+  }
+}
+
 void MasterDaemon::_do_wait(SocketType socket) {
   std::string key = tcputils::receive_string(socket);
   VLOG(8) << "MasterDaemon::_do_wait key(" << key << ") "
           << GetSockName(socket);
+  _wait_keys(socket, {key});
+}
 
-  auto iter = _store.find(key);
-  if (iter == _store.end()) {
-    // The key can not be found in store currently. Record and check later.
-    _waiting_sockets[key].emplace_back(socket);
-  } else {
-    auto reply = ReplyType::STOP_WAIT;
-    VLOG(7) << "TCPStore: wait reply (" << static_cast<int>(reply)
-            << ") for key (" << key << ").";
-    tcputils::send_value<ReplyType>(socket, reply);
+void MasterDaemon::_do_multi_wait(SocketType socket) {
+  auto num_keys = tcputils::receive_value<size_t>(socket);
+  std::vector<std::string> keys(num_keys);
+  for (auto& key : keys) {
+    key = tcputils::receive_string(socket);
+  }
+  VLOG(8) << "MasterDaemon::_do_multi_wait " << num_keys << " keys "
+          << GetSockName(socket);
+  _wait_keys(socket, keys);
+}
+
+void MasterDaemon::_do_wait_prefix(SocketType socket) {
+  std::string prefix = tcputils::receive_string(socket);
+  auto count = tcputils::receive_value<size_t>(socket);
+  VLOG(8) << "MasterDaemon::_do_wait_prefix prefix(" << prefix << ") count("
+          << count << ") " << GetSockName(socket);
+
+  if (_count_prefix(prefix) >= count) {
+    _send_prefix_entries(socket, prefix);
+    return;
+  }
+  _prefix_waiters.push_back({socket, prefix, count});
+  if (_is_relay() && _upstream_waiting_prefixes.emplace(prefix, count).second) {
+    _upstream_waits->send_command_for_key(Command::WAIT_PREFIX, prefix);
+    _upstream_waits->send_value<size_t>(count);
+  }
+}
+
+void MasterDaemon::_do_wait_get(SocketType socket) {
+  std::string key = tcputils::receive_string(socket);
+  VLOG(8) << "MasterDaemon::_do_wait_get key(" << key << ") "
+          << GetSockName(socket);
+
+  if (_store.find(key) != _store.end()) {
+    _send_entries(socket, {key});
+    return;
+  }
+  _waiting_get_sockets[key].emplace_back(socket);
+  if (_is_relay() && _upstream_waiting_keys.insert(key).second) {
+    _upstream_waits->send_command_for_key(Command::WAIT_GET, key);
+  }
+}
+
+// The replies of WAIT_GET and WAIT_PREFIX of a relay, in any order.
+void MasterDaemon::_receive_upstream_entries() {
+  auto num_entries = _upstream_waits->receive_value<size_t>();
+  std::vector<std::string> keys(num_entries);
+  for (auto& key : keys) {
+    key = _upstream_waits->receive_string();
+    bool cacheable = _upstream_waits->receive_value<bool>();
+    _store[key] = _upstream_waits->receive_vector<uint8_t>();
+    if (cacheable) {
+      _counter_keys.erase(key);
+    } else {
+      _counter_keys.insert(key);
+    }
+  }
+  for (const auto& key : keys) {
+    _notify_waiting_sockets(key);
   }
 }
 
 void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
   std::vector<struct pollfd>& fds = *p_fds;
   // FIXME(gongwb): Don't loop all fds of set just the fds who have event.
-#ifdef _WIN32
-  // 0: listen socket, so loop from 1.
-  for (size_t i = 1; i < fds.size(); i++) {
-#else
-  // 0: listen socket, 1:controller pipe, so loop from 2.
-  for (uint i = 2; i < fds.size(); i++) {
-#endif
+  for (size_t i = _num_fixed_fds; i < fds.size(); i++) {
     try {
       if (fds[i].revents == 0) {
         continue;
@@ -209,35 +432,28 @@ void MasterDaemon::ProcessCommands(std::vector<struct pollfd>* p_fds) {
         case Command::WAIT:
           _do_wait(fds[i].fd);
           break;
+        case Command::MULTI_GET:
+          _do_multi_get(fds[i].fd);
+          break;
+        case Command::MULTI_WAIT:
+          _do_multi_wait(fds[i].fd);
+          break;
+        case Command::WAIT_PREFIX:
+          _do_wait_prefix(fds[i].fd);
+          break;
+        case Command::WAIT_GET:
+          _do_wait_get(fds[i].fd);
+          break;
         default:
           VLOG(8) << "Unknown command: " << static_cast<int>(command)
                   << " from addr info:" << GetSockName(fds[i].fd);
       }
     } catch (const std::exception& ex) {
-      auto map_iter = _waiting_sockets.begin();
-      while (map_iter != _waiting_sockets.end()) {
-        auto vec_iter = map_iter->second.begin();
-        while (vec_iter != map_iter->second.end()) {
-          if (*vec_iter == fds[i].fd) {
-            vec_iter = map_iter->second.erase(vec_iter);
-          } else {
-            ++vec_iter;
-          }
-        }
-        if (map_iter->second.empty()) {
-          map_iter = _waiting_sockets.erase(map_iter);
-        } else {
-          ++map_iter;
-        }
-      }
+      _remove_waiting_socket(fds[i].fd);
 
       tcputils::close_socket(fds[i].fd);
       fds.erase(fds.begin() + i);
-#ifdef _WIN32
-      _sockets.erase(_sockets.begin() + i - 1);
-#else
-      _sockets.erase(_sockets.begin() + i - 2);
-#endif
+      _sockets.erase(_sockets.begin() + i - _num_fixed_fds);
       std::string s(ex.what());
       if (s.find("TCP connection reset by peer") != std::string::npos) {
         VLOG(5) << "TCP connection reset by peer";
@@ -257,6 +473,15 @@ void MasterDaemon::run() {
   fds.push_back(
       {.fd = _control_fd[0], .events = POLLIN | POLLHUP, .revents = 0});
 #endif
+  if (_is_relay()) {
+#ifdef _WIN32
+    fds.push_back({_upstream_waits->socket(), POLLIN});
+#else
+    fds.push_back(
+        {.fd = _upstream_waits->socket(), .events = POLLIN, .revents = 0});
+#endif
+  }
+  _num_fixed_fds = fds.size();
 
   bool finished = false;
   while (!finished) {
@@ -294,6 +519,15 @@ void MasterDaemon::run() {
     }
 #endif
 
+    if (_is_relay() && fds[_num_fixed_fds - 1].revents != 0) {
+      try {
+        _receive_upstream_entries();
+      } catch (const std::exception& ex) {
+        PADDLE_THROW(common::errors::Unavailable(
+            "The relay of TCPStore lost its upstream store: %s", ex.what()));
+      }
+    }
+
     // accept connect request.
     if (fds[0].revents != 0) {
       auto socket = tcputils::tcp_accept(_listen_socket);
@@ -311,11 +545,13 @@ void MasterDaemon::run() {
 
 std::unique_ptr<TCPServer> TCPServer::create(uint16_t port,
                                              int nranks,
-                                             int stop_check_timeout) {
+                                             int stop_check_timeout,
+                                             const std::string& upstream_host,
+                                             uint16_t upstream_port) {
   int socket = tcputils::tcp_listen("", std::to_string(port), AF_INET);
   auto server = std::make_unique<TCPServer>();
-  server->_master_daemon =
-      MasterDaemon::start(socket, nranks, stop_check_timeout);
+  server->_master_daemon = MasterDaemon::start(
+      socket, nranks, stop_check_timeout, upstream_host, upstream_port);
   return server;
 }
 
@@ -345,6 +581,14 @@ T TCPClient::receive_value() {
   return res;
 }
 
+void TCPClient::send_string(const std::string& s) {
+  tcputils::send_string(_socket, s);
+}
+
+std::string TCPClient::receive_string() {
+  return tcputils::receive_string(_socket);
+}
+
 template <typename T>
 void TCPClient::send_vector(const std::vector<T>& value) {
   tcputils::send_vector<T>(_socket, value);
@@ -362,7 +606,8 @@ TCPStore::TCPStore(std::string host,
                    uint16_t port,
                    bool is_master,
                    size_t num_workers,
-                   int timeout)
+                   int timeout,
+                   uint16_t relay_port)
     : Store(timeout),
       _is_master(is_master),
       _num_workers(static_cast<int>(num_workers)) {
@@ -376,6 +621,15 @@ TCPStore::TCPStore(std::string host,
   if (_is_master) {
     _server = detail::TCPServer::create(port, this->_num_workers, timeout);
   }
+  if (relay_port != 0) {
+    PADDLE_ENFORCE_EQ(
+        _is_master,
+        false,
+        common::errors::InvalidArgument("The master of TCPStore can't serve "
+                                        "as a relay."));
+    _relay = detail::TCPServer::create(
+        relay_port, this->_num_workers, timeout, host, port);
+  }
 
   _client = detail::TCPClient::connect(host, port);
   waitWorkers();
@@ -462,6 +716,52 @@ void TCPStore::wait(const std::string& key) {
       common::errors::InvalidArgument("Stop_waiting response is expected"));
 }
 
+void TCPStore::multi_wait(const std::vector<std::string>& keys) {
+  VLOG(7) << "TCPStore multi_wait " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_WAIT, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  auto reply = _client->receive_value<ReplyType>();
+  PADDLE_ENFORCE_EQ(
+      reply == ReplyType::STOP_WAIT,
+      true,
+      common::errors::InvalidArgument("Stop_waiting response is expected"));
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multi_get(
+    const std::vector<std::string>& keys) {
+  multi_wait(keys);
+  VLOG(7) << "TCPStore multi_get " << keys.size() << " keys.";
+  _client->send_command_for_key(Command::MULTI_GET, "");
+  _client->send_value<size_t>(keys.size());
+  for (const auto& key : keys) {
+    _client->send_string(_key_prefix + key);
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    values.push_back(_client->receive_vector<uint8_t>());
+  }
+  return values;
+}
+
+std::map<std::string, std::vector<uint8_t>> TCPStore::wait_prefix(
+    const std::string& prefix, size_t count) {
+  VLOG(7) << "TCPStore wait_prefix " << prefix << ", count " << count;
+  _client->send_command_for_key(Command::WAIT_PREFIX, _key_prefix + prefix);
+  _client->send_value<size_t>(count);
+  std::map<std::string, std::vector<uint8_t>> entries;
+  auto num_entries = _client->receive_value<size_t>();
+  for (size_t i = 0; i < num_entries; ++i) {
+    auto key = _client->receive_string();
+    _client->receive_value<bool>();
+    entries[key.substr(_key_prefix.size())] = _client->receive_vector<uint8_t>();
+  }
+  return entries;
+}
+
 TCPStore::~TCPStore() { VLOG(7) << "TCPStore destructure"; }
 
 }  // namespace phi::distributed
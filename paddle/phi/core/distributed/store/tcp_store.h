@@ -25,10 +25,14 @@
 
 #include <array>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 
 #include "paddle/phi/core/distributed/store/socket.h"
 #include "paddle/phi/core/distributed/store/store.h"
@@ -38,19 +42,48 @@ namespace phi {
 namespace distributed {
 
 enum class ReplyType { WAITING, STOP_WAIT, READY, NOT_READY };
-enum class Command { ADD, GET, CHECK, SET, WAIT, STOP };
+// MULTI_GET and MULTI_WAIT carry a batch of keys, WAIT_PREFIX waits for a
+// number of keys under a prefix and replies with all of them. WAIT_GET is
+// sent by the relays, it replies with the key and its value once the key is
+// set, so that many of them can be pending on one connection.
+enum class Command {
+  ADD,
+  GET,
+  CHECK,
+  SET,
+  WAIT,
+  STOP,
+  MULTI_GET,
+  MULTI_WAIT,
+  WAIT_PREFIX,
+  WAIT_GET
+};
 
 namespace detail {
 
+class TCPClient;
+
+// Serves the store on the master. With an upstream store it serves as a
+// relay for a subtree of the ranks instead: SET and ADD are written through
+// to the upstream, the waits of the subtree on the same key are merged into
+// a single WAIT_GET on the upstream, and the values written with SET are
+// cached, so the master only serves the relays of the first level of the
+// tree. Relays assume a key written with SET is not set again; the keys
+// written with ADD are counters and are always read from the master.
 class MasterDaemon {
  public:
-  static std::unique_ptr<MasterDaemon> start(SocketType listen_socket,
-                                             int nranks,
-                                             int timeout);
+  static std::unique_ptr<MasterDaemon> start(
+      SocketType listen_socket,
+      int nranks,
+      int timeout,
+      const std::string& upstream_host = "",
+      uint16_t upstream_port = 0);
   MasterDaemon() = delete;
   explicit MasterDaemon(SocketType listen_socket,
                         int nranks,
-                        int stop_check_timeout);
+                        int stop_check_timeout,
+                        const std::string& upstream_host = "",
+                        uint16_t upstream_port = 0);
   ~MasterDaemon();
 
  private:
@@ -61,15 +94,50 @@ class MasterDaemon {
   void _do_get(SocketType socket);
   void _do_check(SocketType socket);
   void _do_set(SocketType socket);
+  void _do_multi_get(SocketType socket);
+  void _do_multi_wait(SocketType socket);
+  void _do_wait_prefix(SocketType socket);
+  void _do_wait_get(SocketType socket);
   void _notify_waiting_sockets(const std::string&);
+  void _remove_waiting_socket(SocketType socket);
+  void _wait_keys(SocketType socket, const std::vector<std::string>& keys);
+  std::vector<uint8_t> _get_value(const std::string& key);
+  size_t _count_prefix(const std::string& prefix) const;
+  void _send_entries(SocketType socket, const std::vector<std::string>& keys);
+  void _send_prefix_entries(SocketType socket, const std::string& prefix);
+  bool _is_relay() const { return _upstream != nullptr; }
+  void _receive_upstream_entries();
   SocketType _listen_socket;
   std::vector<SocketType> _sockets;
-  std::unordered_map<std::string, std::vector<uint8_t>> _store;
+  // ordered for the prefix lookups
+  std::map<std::string, std::vector<uint8_t>> _store;
+  // keys written with ADD, the relays don't cache their values
+  std::unordered_set<std::string> _counter_keys;
   std::thread _background_thread{};
   int _nranks = -1;
   int _timeout = 0;
+  // the listen socket, the control pipe and the upstream of a relay come
+  // before the sockets of the clients in the polled fds
+  size_t _num_fixed_fds = 0;
   std::unordered_map<std::string, std::vector<SocketType>>
       _waiting_sockets;  // key -> list of waiting sockets
+  // socket -> number of keys it still waits for
+  std::unordered_map<SocketType, size_t> _waiting_counts;
+  // key -> list of relays waiting for the value
+  std::unordered_map<std::string, std::vector<SocketType>> _waiting_get_sockets;
+  struct PrefixWaiter {
+    SocketType socket;
+    std::string prefix;
+    size_t count;
+  };
+  std::vector<PrefixWaiter> _prefix_waiters;
+
+  // relay only, the upstream for the synchronous requests and the one of the
+  // pending WAIT_GET and WAIT_PREFIX
+  std::unique_ptr<TCPClient> _upstream;
+  std::unique_ptr<TCPClient> _upstream_waits;
+  std::unordered_set<std::string> _upstream_waiting_keys;
+  std::set<std::pair<std::string, size_t>> _upstream_waiting_prefixes;
 
   void InitControlFd();
   void CloseControlFd();
@@ -84,9 +152,12 @@ class MasterDaemon {
 class TCPServer {
  public:
   TCPServer() = default;
-  static std::unique_ptr<TCPServer> create(std::uint16_t port,
-                                           int nranks,
-                                           int stop_check_timeout);
+  static std::unique_ptr<TCPServer> create(
+      std::uint16_t port,
+      int nranks,
+      int stop_check_timeout,
+      const std::string& upstream_host = "",
+      uint16_t upstream_port = 0);
 
  private:
   std::unique_ptr<MasterDaemon> _master_daemon;
@@ -111,6 +182,11 @@ class TCPClient {
   template <typename T>
   T receive_value();
 
+  void send_string(const std::string& s);
+  std::string receive_string();
+
+  SocketType socket() const { return _socket; }
+
  private:
   SocketType _socket;
 };
@@ -118,6 +194,9 @@ class TCPClient {
 }  // namespace detail
 
 // TODO(gongwb) :Add IP6 support.
+// A rank with a nonzero relay_port serves a relay on that port for the ranks
+// under it, which connect to it instead of the master. The relay forwards to
+// the store at host:port, which is the master or another relay.
 class TCPStore : public Store {
  public:
   static constexpr std::uint16_t kDefaultPort = 6170;
@@ -125,7 +204,8 @@ class TCPStore : public Store {
                     uint16_t port = kDefaultPort,
                     bool is_master = false,
                     size_t num_workers = 1,
-                    int timeout = 900);
+                    int timeout = 900,
+                    uint16_t relay_port = 0);
 
   ~TCPStore();
 
@@ -134,10 +214,16 @@ class TCPStore : public Store {
   bool check(const std::string& key) override;
   void wait(const std::string& key) override;
   void set(const std::string& key, const std::vector<uint8_t>& value) override;
+  std::vector<std::vector<uint8_t>> multi_get(
+      const std::vector<std::string>& keys) override;
+  void multi_wait(const std::vector<std::string>& keys) override;
+  std::map<std::string, std::vector<uint8_t>> wait_prefix(
+      const std::string& prefix, size_t count) override;
 
  private:
   void waitWorkers();
   std::unique_ptr<detail::TCPServer> _server;
+  std::unique_ptr<detail::TCPServer> _relay;
   std::unique_ptr<detail::TCPClient> _client;
 
   const std::string _init_key = "init/";
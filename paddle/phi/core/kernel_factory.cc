@@ -14,6 +14,8 @@
 
 #include "paddle/phi/core/kernel_factory.h"
 
+#include <mutex>  // NOLINT
+
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/enforce.h"
@@ -31,6 +33,10 @@
 PHI_DEFINE_EXPORTED_bool(use_stride_kernel,
                          true,
                          "Whether to use stride kernel if op support stride.");
+PHI_DEFINE_EXPORTED_bool(
+    enable_kernel_select_cache,
+    true,
+    "Whether the generated apis cache the kernels selected at each call site.");
 
 COMMON_DECLARE_int32(low_precision_op_list);
 COMMON_DECLARE_bool(enable_api_kernel_fallback);
@@ -55,6 +61,56 @@ uint32_t KernelKey::Hash::operator()(const KernelKey& key) const {
   return hash_value;
 }
 
+void Kernel::MaterializeArgsDef() const {
+  static std::mutex materialize_mutex;
+  std::lock_guard<std::mutex> guard(materialize_mutex);
+  if (args_ready_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  // The registration body gets an eager kernel to fill, since it goes
+  // through the accessors that would otherwise materialize this one again.
+  Kernel kernel(fn_, variadic_fn_);
+  if (kernel.GetKernelRegisteredType() == KernelRegisteredType::FUNCTION) {
+    lazy_args_parse_fn_(lazy_key_, kernel.mutable_args_def());
+  }
+  lazy_args_def_fn_(lazy_key_, &kernel);
+  auto* self = const_cast<Kernel*>(this);
+  self->args_def_ = std::move(kernel.args_def_);
+  self->get_kerneltype_forvar_fn_ = kernel.get_kerneltype_forvar_fn_;
+  self->check_if_onednn_kernel_support_ =
+      std::move(kernel.check_if_onednn_kernel_support_);
+  args_ready_.store(true, std::memory_order_release);
+}
+
+void Kernel::CopyFrom(const Kernel& other) {
+  other.Materialize();
+  get_kerneltype_forvar_fn_ = other.get_kerneltype_forvar_fn_;
+  check_if_onednn_kernel_support_ = other.check_if_onednn_kernel_support_;
+  fn_ = other.fn_;
+  variadic_fn_ = other.variadic_fn_;
+  args_def_ = other.args_def_;
+  kernel_registered_type_ = other.kernel_registered_type_;
+  lazy_key_ = other.lazy_key_;
+  lazy_args_parse_fn_ = other.lazy_args_parse_fn_;
+  lazy_args_def_fn_ = other.lazy_args_def_fn_;
+  args_ready_.store(true, std::memory_order_relaxed);
+}
+
+void Kernel::MoveFrom(Kernel&& other) {
+  get_kerneltype_forvar_fn_ = other.get_kerneltype_forvar_fn_;
+  check_if_onednn_kernel_support_ =
+      std::move(other.check_if_onednn_kernel_support_);
+  fn_ = other.fn_;
+  variadic_fn_ = other.variadic_fn_;
+  args_def_ = std::move(other.args_def_);
+  kernel_registered_type_ = other.kernel_registered_type_;
+  lazy_key_ = other.lazy_key_;
+  lazy_args_parse_fn_ = other.lazy_args_parse_fn_;
+  lazy_args_def_fn_ = other.lazy_args_def_fn_;
+  args_ready_.store(other.args_ready_.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+}
+
 KernelFactory& KernelFactory::Instance() {
   static KernelFactory g_op_kernel_factory;
   return g_op_kernel_factory;
@@ -109,6 +165,7 @@ const Kernel& KernelFactory::SelectKernel(const std::string& kernel_name,
     return empty_kernel;
   }
 
+  kernel_iter->second.Materialize();
   return kernel_iter->second;
 }
 
@@ -124,6 +181,7 @@ const Kernel& KernelFactory::SelectKernelWithGPUDNN(
     auto kernel_iter = iter->second.find(
         {Backend::GPUDNN, phi::DataLayout::ALL_LAYOUT, kernel_key.dtype()});
     if (kernel_iter != iter->second.end()) {
+      kernel_iter->second.Materialize();
       return kernel_iter->second;
     }
     kernel_key =
@@ -152,6 +210,7 @@ const Kernel& KernelFactory::SelectKernelWithGPUDNN(
     return empty_kernel;
   }
 
+  kernel_iter->second.Materialize();
   return kernel_iter->second;
 }
 
@@ -408,6 +467,36 @@ KernelResult KernelFactory::SelectKernelOrThrowError(
   return {kernel_iter->second, false, false};
 }
 
+KernelResult KernelSelectCache::Select(const KernelKey& kernel_key,
+                                       bool use_strided_kernel) {
+  if (!FLAGS_enable_kernel_select_cache) {
+    return KernelFactory::Instance().SelectKernelOrThrowError(
+        kernel_name_, kernel_key, use_strided_kernel);
+  }
+  uint32_t flags = (use_strided_kernel ? 1U : 0U) |
+                   (FLAGS_use_stride_kernel ? 2U : 0U) |
+                   (FLAGS_enable_api_kernel_fallback ? 4U : 0U) |
+                   (FLAGS_run_kp_kernel ? 8U : 0U);
+  for (size_t i = 0; i < size_; ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.kernel_key == kernel_key && entry.flags == flags) {
+      return {entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+    }
+  }
+  auto result = KernelFactory::Instance().SelectKernelOrThrowError(
+      kernel_name_, kernel_key, use_strided_kernel);
+  if (size_ == kMaxEntries) {
+    return result;
+  }
+  Entry& entry = entries_[size_++];
+  entry.kernel_key = kernel_key;
+  entry.flags = flags;
+  entry.kernel = result.kernel;
+  entry.has_fallback_cpu = result.has_fallback_cpu;
+  entry.is_stride_kernel = result.is_stride_kernel;
+  return {entry.kernel, entry.has_fallback_cpu, entry.is_stride_kernel};
+}
+
 const KernelArgsDef& KernelFactory::GetFirstKernelArgsDef(
     const std::string& kernel_name) const {
   auto iter = kernels_.find(kernel_name);
@@ -14,10 +14,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <ostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include "paddle/common/layout.h"
 #include "paddle/phi/common/backend.h"
 #include "paddle/phi/common/data_type.h"
@@ -251,6 +253,41 @@ class Kernel {
     }
   }
 
+  // Lazily registered kernel: parsing the kernel signature and running the
+  // registration body are deferred until the args def is first needed, so
+  // the thousands of static registrations only record four pointers.
+  Kernel(KernelFn fn,
+         void* variadic_fn,
+         const KernelKey& kernel_key,
+         KernelArgsParseFn args_parse_fn,
+         KernelArgsDefFn args_def_fn)
+      : Kernel(fn, variadic_fn) {
+    lazy_key_ = kernel_key;
+    lazy_args_parse_fn_ = args_parse_fn;
+    lazy_args_def_fn_ = args_def_fn;
+    args_ready_.store(false, std::memory_order_relaxed);
+  }
+
+  // Copies are always materialized, so only the kernels stored in the
+  // factory map ever run the deferred registration.
+  Kernel(const Kernel& other) { CopyFrom(other); }
+
+  Kernel& operator=(const Kernel& other) {
+    if (this != &other) {
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  Kernel(Kernel&& other) noexcept { MoveFrom(std::move(other)); }
+
+  Kernel& operator=(Kernel&& other) noexcept {
+    if (this != &other) {
+      MoveFrom(std::move(other));
+    }
+    return *this;
+  }
+
   void operator()(KernelContext* ctx) const { fn_(ctx); }
 
   template <typename Fn>
@@ -259,21 +296,35 @@ class Kernel {
     return func;
   }
 
-  KernelArgsDef* mutable_args_def() { return &args_def_; }
+  KernelArgsDef* mutable_args_def() {
+    Materialize();
+    return &args_def_;
+  }
 
-  const KernelArgsDef& args_def() const { return args_def_; }
+  const KernelArgsDef& args_def() const {
+    Materialize();
+    return args_def_;
+  }
 
   const TensorArgDef& InputAt(size_t idx) const {
+    Materialize();
     return args_def_.input_defs().at(idx);
   }
 
-  TensorArgDef& InputAt(size_t idx) { return args_def_.input_defs().at(idx); }
+  TensorArgDef& InputAt(size_t idx) {
+    Materialize();
+    return args_def_.input_defs().at(idx);
+  }
 
   const TensorArgDef& OutputAt(size_t idx) const {
+    Materialize();
     return args_def_.output_defs().at(idx);
   }
 
-  TensorArgDef& OutputAt(size_t idx) { return args_def_.output_defs().at(idx); }
+  TensorArgDef& OutputAt(size_t idx) {
+    Materialize();
+    return args_def_.output_defs().at(idx);
+  }
 
   bool IsValid() const { return fn_ != nullptr; }
 
@@ -281,15 +332,32 @@ class Kernel {
     return kernel_registered_type_;
   }
 
+  // Runs the deferred registration of a lazily registered kernel, it is
+  // thread safe and a no-op once done.
+  void Materialize() const {
+    if (!args_ready_.load(std::memory_order_acquire)) {
+      MaterializeArgsDef();
+    }
+  }
+
   GetKernelTypeForVarFn get_kerneltype_forvar_fn_{nullptr};
   std::function<bool(const KernelContext* ctx)> check_if_onednn_kernel_support_{
       nullptr};
 
  private:
+  void MaterializeArgsDef() const;
+  void CopyFrom(const Kernel& other);
+  void MoveFrom(Kernel&& other);
+
   KernelFn fn_{nullptr};
   void* variadic_fn_ = nullptr;
   KernelArgsDef args_def_;
   KernelRegisteredType kernel_registered_type_ = KernelRegisteredType::FUNCTION;
+
+  KernelKey lazy_key_;
+  KernelArgsParseFn lazy_args_parse_fn_{nullptr};
+  KernelArgsDefFn lazy_args_def_fn_{nullptr};
+  mutable std::atomic<bool> args_ready_{true};
 };
 
 using KernelKeyMap = paddle::flat_hash_map<KernelKey, Kernel, KernelKey::Hash>;
@@ -300,7 +368,9 @@ struct KernelResult {
   KernelResult(const Kernel& kernel, bool fallback_cpu, bool is_stride_kernel)
       : kernel(kernel),
         has_fallback_cpu(fallback_cpu),
-        is_stride_kernel(is_stride_kernel) {}
+        is_stride_kernel(is_stride_kernel) {
+    kernel.Materialize();
+  }
 
   const Kernel& kernel;
   bool has_fallback_cpu = false;
@@ -357,6 +427,40 @@ class KernelFactory {
   std::map<const std::string, OpCount> low_precision_kernels_;
 };
 
+/**
+ * Note: KernelSelectCache memoizes SelectKernelOrThrowError for one kernel
+ *       name, so that a call site which keeps dispatching the same kernel
+ *       key skips the name hashing and the fallback search. It is meant to
+ *       be a thread_local static at the call site, and keeps a copy of the
+ *       selected kernels, so the results stay valid while it is alive. The
+ *       flags that change the selection are a part of the cached key.
+ */
+class KernelSelectCache {
+ public:
+  explicit KernelSelectCache(const char* kernel_name)
+      : kernel_name_(kernel_name) {}
+
+  KernelResult Select(const KernelKey& kernel_key,
+                      bool use_strided_kernel = false);
+
+ private:
+  struct Entry {
+    KernelKey kernel_key;
+    uint32_t flags = 0;
+    Kernel kernel;
+    bool has_fallback_cpu = false;
+    bool is_stride_kernel = false;
+  };
+
+  // small ops see only a few kernel keys, the keys after the first
+  // kMaxEntries ones are not cached
+  static constexpr size_t kMaxEntries = 4;
+
+  std::string kernel_name_;
+  size_t size_ = 0;
+  Entry entries_[kMaxEntries];
+};
+
 inline std::ostream& operator<<(std::ostream& os, const KernelKey& kernel_key) {
   os << "(" << kernel_key.backend() << ", " << kernel_key.layout() << ", "
      << kernel_key.dtype() << ")";
@@ -139,13 +139,13 @@ struct KernelRegistrar {
     std::string kernel_name(kernel_name_cstr);
     KernelKey kernel_key(
         paddle::experimental::StringToBackend(backend_cstr), layout, dtype);
-    Kernel kernel(kernel_fn, variadic_kernel_fn);
-    if (kernel.GetKernelRegisteredType() == KernelRegisteredType::FUNCTION) {
-      args_parse_fn(kernel_key, kernel.mutable_args_def());
-    }
-    args_def_fn(kernel_key, &kernel);
+    // The signature parse and the registration body run on first use, see
+    // Kernel::Materialize.
+    Kernel kernel(
+        kernel_fn, variadic_kernel_fn, kernel_key, args_parse_fn, args_def_fn);
     if (reg_type == RegType::INNER) {
-      KernelFactory::Instance().kernels()[kernel_name][kernel_key] = kernel;
+      KernelFactory::Instance().kernels()[kernel_name][kernel_key] =
+          std::move(kernel);
     } else {
       CustomKernelMap::Instance().RegisterCustomKernel(
           kernel_name, kernel_key, kernel);
@@ -14,6 +14,8 @@
 
 #include "paddle/phi/core/lod_utils.h"
 
+#include <utility>
+
 #include "paddle/phi/core/enforce.h"
 
 namespace phi {
@@ -42,13 +44,11 @@ void AppendLegacyLoD(LegacyLoD *lod, const LegacyLoD &lod_length) {
           lod_length.size(),
           lod->size()));
   if (lod->empty()) {
-    for (size_t i = 0; i < lod_length.size(); ++i) {
-      lod->emplace_back(1, 0);  // size = 1, value = 0;
-    }
-    *lod = LegacyLoD(lod_length.size(), std::vector<size_t>({0}));
+    lod->resize(lod_length.size(), std::vector<size_t>({0}));
   }
   for (size_t i = 0; i < lod->size(); ++i) {
     auto &level = (*lod)[i];
+    level.reserve(level.size() + lod_length[i].size());
     for (size_t len : lod_length[i]) {
       level.push_back(level.back() + len);
     }
@@ -63,10 +63,10 @@ LegacyLoD ConvertToLengthBasedLegacyLoD(const LegacyLoD &offset_lod) {
     if (!item.empty()) {
       level.reserve(item.size() - 1);
     }
-    for (size_t idx = 0; idx < item.size() - 1; ++idx) {
+    for (size_t idx = 0; idx + 1 < item.size(); ++idx) {
       level.push_back(item[idx + 1] - item[idx]);
     }
-    length_lod.push_back(level);
+    length_lod.push_back(std::move(level));
   }
   return length_lod;
 }
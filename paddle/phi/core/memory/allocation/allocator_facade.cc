@@ -26,6 +26,7 @@
 #include "paddle/phi/core/memory/allocation/cpu_allocator.h"
 #include "paddle/phi/core/memory/allocation/naive_best_fit_allocator.h"
 #include "paddle/phi/core/memory/allocation/retry_allocator.h"
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
 #include "paddle/phi/core/memory/allocation/stat_allocator.h"
 #include "paddle/phi/core/platform/device_context.h"
 
@@ -92,6 +93,14 @@ PHI_DEFINE_EXPORTED_bool(use_virtual_memory_auto_growth,
                          false,
                          "Use VirtualMemoryAutoGrowthBestFitAllocator.");
 
+PHI_DEFINE_EXPORTED_bool(
+    virtual_memory_compaction,
+    false,
+    "Back the chunks of VirtualMemoryAutoGrowthBestFitAllocator with "
+    "individually mapped physical pages, so that releasing the allocator "
+    "(empty_cache, or a retry on OOM) gives back the pages behind free "
+    "blocks. Only used with FLAGS_use_virtual_memory_auto_growth.");
+
 // NOTE(Ruibiao): This FLAGS is just to be compatible with
 // the old single-stream CUDA allocator. It will be removed
 // after StreamSafeCudaAllocator has been fully tested.
@@ -113,6 +122,8 @@ PHI_DEFINE_EXPORTED_bool(
 
 COMMON_DECLARE_string(allocator_strategy);
 COMMON_DECLARE_uint64(auto_growth_chunk_size_in_mb);
+COMMON_DECLARE_uint64(size_class_allocator_max_size);
+COMMON_DECLARE_uint64(size_class_allocator_thread_cache_blocks);
 COMMON_DECLARE_bool(use_auto_growth_pinned_allocator);
 COMMON_DECLARE_bool(use_cuda_malloc_async_allocator);
 COMMON_DECLARE_bool(auto_free_cudagraph_allocations_on_launch);
@@ -242,7 +253,8 @@ class AllocatorFacadePrivate {
         break;
       }
 
-      case AllocatorStrategy::kAutoGrowth: {
+      case AllocatorStrategy::kAutoGrowth:
+      case AllocatorStrategy::kSizeClass: {
         InitNaiveBestFitCPUAllocator();
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
         allow_free_idle_chunk_ = allow_free_idle_chunk;
@@ -847,6 +859,14 @@ class AllocatorFacadePrivate {
               phi::backends::cpu::CUDAPinnedMinChunkSize(),
               chunk_size,
               allow_free_idle_chunk_);
+      if (strategy_ == AllocatorStrategy::kSizeClass) {
+        // short-lived staging buffers of data loaders and offloading are
+        // mostly served from the free lists without taking the pool lock
+        allocators_[phi::GPUPinnedPlace()] = WrapSizeClassAllocator(
+            allocators_[phi::GPUPinnedPlace()],
+            phi::GPUPinnedPlace(),
+            phi::backends::cpu::CUDAPinnedMinChunkSize());
+      }
     } else {
       allocators_[phi::GPUPinnedPlace()] =
           std::make_shared<NaiveBestFitAllocator>(phi::GPUPinnedPlace());
@@ -861,8 +881,8 @@ class AllocatorFacadePrivate {
   std::shared_ptr<Allocator> CreateCUDAAllocator(phi::GPUPlace p) {
     if (FLAGS_use_cuda_managed_memory) {
       PADDLE_ENFORCE_EQ(
-          strategy_,
-          AllocatorStrategy::kAutoGrowth,
+          IsAutoGrowthStrategy(strategy_),
+          true,
           common::errors::InvalidArgument(
               "CUDA managed memory is only implemented for auto_growth "
               "strategy, not support %s strategy.\n"
@@ -888,8 +908,8 @@ class AllocatorFacadePrivate {
 
   void InitCUDAAllocator(phi::GPUPlace p, gpuStream_t stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         common::errors::Unimplemented(
             "Only support auto-growth strategy for StreamSafeCUDAAllocator, "
             "the allocator strategy %d is unsupported for multi-stream",
@@ -969,7 +989,8 @@ class AllocatorFacadePrivate {
     }
 
     if (val > 0 && FLAGS_use_virtual_memory_auto_growth) {
-      auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(p);
+      auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(
+          p, FLAGS_virtual_memory_compaction);
       cuda_allocators_[p][stream] =
           std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
               cuda_allocator, platform::GpuMinChunkSize(), p);
@@ -1042,6 +1063,10 @@ class AllocatorFacadePrivate {
     }
 #endif
 #endif
+    if (strategy_ == AllocatorStrategy::kSizeClass) {
+      cuda_allocators_[p][stream] =
+          WrapSizeClassAllocator(cuda_allocators_[p][stream], p);
+    }
   }
 
   // NOTE(Ruibiao): Old single-stream version, will be removed later
@@ -1085,7 +1110,8 @@ class AllocatorFacadePrivate {
     }
 
     if (val > 0 && FLAGS_use_virtual_memory_auto_growth) {
-      auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(p);
+      auto cuda_allocator = std::make_shared<CUDAVirtualMemAllocator>(
+          p, FLAGS_virtual_memory_compaction);
       allocators_[p] =
           std::make_shared<VirtualMemoryAutoGrowthBestFitAllocator>(
               cuda_allocator, platform::GpuMinChunkSize(), p);
@@ -1153,6 +1179,26 @@ class AllocatorFacadePrivate {
     }
 #endif
 #endif
+    if (strategy_ == AllocatorStrategy::kSizeClass) {
+      allocators_[p] = WrapSizeClassAllocator(allocators_[p], p);
+    }
+  }
+
+  // Serve small requests of the auto-growth allocator from size-class
+  // segregated free lists, see SizeClassAllocator.
+  std::shared_ptr<Allocator> WrapSizeClassAllocator(
+      const std::shared_ptr<Allocator>& allocator,
+      const phi::Place& p,
+      size_t alignment = platform::GpuMinChunkSize()) {
+    VLOG(4) << "Use SizeClassAllocator for " << p
+            << ", FLAGS_size_class_allocator_max_size is "
+            << FLAGS_size_class_allocator_max_size;
+    return std::make_shared<SizeClassAllocator>(
+        allocator,
+        p,
+        alignment,
+        FLAGS_size_class_allocator_max_size,
+        FLAGS_size_class_allocator_thread_cache_blocks);
   }
 
   void InitThreadLocalCUDAAllocator(phi::GPUPlace p) {
@@ -1269,8 +1315,8 @@ class AllocatorFacadePrivate {
 
   void InitStreamSafeXPUAllocator(phi::XPUPlace p, XPUStream stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         common::errors::Unimplemented(
             "Only support auto-growth strategy for StreamSafeXPUAllocator, "
             "the allocator strategy %d is unsupported for multi-stream",
@@ -1378,8 +1424,8 @@ class AllocatorFacadePrivate {
   void InitStreamSafeCustomDeviceAllocator(phi::CustomPlace p,
                                            phi::stream::stream_t stream) {
     PADDLE_ENFORCE_EQ(
-        strategy_,
-        AllocatorStrategy::kAutoGrowth,
+        IsAutoGrowthStrategy(strategy_),
+        true,
         common::errors::Unimplemented(
             "Only support auto-growth strategy for "
             "StreamSafeCustomDeviceAllocator, "
@@ -1390,6 +1436,7 @@ class AllocatorFacadePrivate {
               << " in place " << p;
       InitAutoGrowthCustomDeviceAllocator(p, stream);
       WrapStreamSafeCustomDeviceAllocator(p, stream);
+      WrapCustomDeviceRetryAllocator(p, stream, FLAGS_gpu_allocator_retry_time);
     }
   }
 
@@ -1451,6 +1498,19 @@ class AllocatorFacadePrivate {
     allocator =
         std::make_shared<StreamSafeCustomDeviceAllocator>(allocator, p, stream);
   }
+
+  void WrapCustomDeviceRetryAllocator(phi::CustomPlace p,
+                                      phi::stream::stream_t stream,
+                                      size_t retry_time) {
+    PADDLE_ENFORCE_GT(
+        retry_time,
+        0,
+        common::errors::InvalidArgument(
+            "Retry time should be larger than 0, but got %d", retry_time));
+    std::shared_ptr<Allocator>& allocator =
+        custom_device_allocators_[p][stream];
+    allocator = std::make_shared<RetryAllocator>(allocator, retry_time);
+  }
 #endif
 
   void InitSystemAllocators() {
@@ -1659,8 +1719,8 @@ const std::shared_ptr<Allocator>& AllocatorFacade::GetAutoGrowthAllocator(
 
 void* AllocatorFacade::GetBasePtr(
     const std::shared_ptr<phi::Allocation>& allocation) {
-  PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
-                    AllocatorStrategy::kAutoGrowth,
+  PADDLE_ENFORCE_EQ(IsAutoGrowthStrategy(GetAllocatorStrategy()),
+                    true,
                     common::errors::Unimplemented(
                         "GetBasePtr() is only implemented for auto_growth "
                         "strategy, not support allocator strategy: %d",
@@ -1838,8 +1898,8 @@ void AllocatorFacade::SetDefaultStream(const phi::GPUPlace& place,
 
 #if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
 void AllocatorFacade::PrepareMemoryPoolForCUDAGraph(int64_t id) {
-  PADDLE_ENFORCE_EQ(GetAllocatorStrategy(),
-                    AllocatorStrategy::kAutoGrowth,
+  PADDLE_ENFORCE_EQ(IsAutoGrowthStrategy(GetAllocatorStrategy()),
+                    true,
                     common::errors::InvalidArgument(
                         "CUDA Graph is only supported when the "
                         "FLAGS_allocator_strategy=\"auto_growth\", but got "
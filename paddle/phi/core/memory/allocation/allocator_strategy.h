@@ -19,10 +19,23 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
-enum class AllocatorStrategy { kNaiveBestFit, kAutoGrowth, kThreadLocal };
+enum class AllocatorStrategy {
+  kNaiveBestFit,
+  kAutoGrowth,
+  kThreadLocal,
+  kSizeClass
+};
 
 extern AllocatorStrategy GetAllocatorStrategy();
 
+// kSizeClass is built on top of the auto-growth allocator, so anything that
+// relies on auto-growth (stream safe allocators, CUDA graph memory pools)
+// works with both strategies.
+inline bool IsAutoGrowthStrategy(AllocatorStrategy strategy) {
+  return strategy == AllocatorStrategy::kAutoGrowth ||
+         strategy == AllocatorStrategy::kSizeClass;
+}
+
 // Do nothing, just make sure linker do not prune this file.
 TEST_API void UseAllocatorStrategyGFlag();
 
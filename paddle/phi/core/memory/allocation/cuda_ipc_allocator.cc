@@ -18,15 +18,26 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 
+#include <list>
+#include <map>
 #include <random>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "glog/logging.h"
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/mmap_allocator.h"
 #include "paddle/phi/core/platform/cuda_device_guard.h"
 
+COMMON_DECLARE_uint64(cuda_ipc_pool_segment_size_mb);
+
 namespace paddle::memory::allocation {
 
 namespace {
@@ -71,6 +82,327 @@ CudaIpcAllocation::~CudaIpcAllocation() {
           << "\t" << this->ptr();
 }
 
+namespace {
+
+// blocks of a segment, bounded by the size of the shared reference counts
+constexpr int kIpcSlotsPerSegment = 4096;
+constexpr size_t kIpcBlockAlignment = 256;
+constexpr size_t kIpcRefcountBytes =
+    kIpcSlotsPerSegment * sizeof(std::atomic<int>);
+
+static_assert(std::atomic<int>::is_always_lock_free,
+              "The shared reference counts need lock free atomics.");
+
+std::atomic<int> *MapRefcounts(const std::string &name, int flags) {
+  int fd = shm_open(name.c_str(), flags, 0600);
+  PADDLE_ENFORCE_NE(fd,
+                    -1,
+                    common::errors::Unavailable(
+                        "Failed to open the shared memory file %s of CUDA IPC "
+                        "reference counts, errno %d.",
+                        name,
+                        errno));
+  if ((flags & O_CREAT) && ftruncate(fd, kIpcRefcountBytes) == -1) {
+    close(fd);
+    PADDLE_THROW(common::errors::Unavailable(
+        "Failed to resize the shared memory file %s, errno %d.", name, errno));
+  }
+  void *ptr = mmap(
+      nullptr, kIpcRefcountBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  PADDLE_ENFORCE_NE(ptr,
+                    MAP_FAILED,
+                    common::errors::Unavailable(
+                        "Failed to map the shared memory file %s, errno %d.",
+                        name,
+                        errno));
+  return reinterpret_cast<std::atomic<int> *>(ptr);
+}
+
+// A cudaMalloc'ed range of the producer, exported once and split into blocks.
+// Segments live until the process exits, receivers may hold them open.
+struct CudaIpcSegment {
+  char *ptr = nullptr;
+  size_t size = 0;
+  std::string mem_handle;
+  std::string refcount_name;
+  // zero-initialized by ftruncate, the count of a block is 1 while shared
+  std::atomic<int> *refcounts = nullptr;
+  std::vector<cudaEvent_t> events;
+  std::vector<std::string> event_handles;
+  // offset -> size
+  std::map<size_t, size_t> free_ranges;
+  // slot -> offset and size of the blocks handed to receivers
+  std::unordered_map<int, std::pair<size_t, size_t>> shared_blocks;
+  std::vector<int> free_slots;
+
+  // Gives back the blocks whose receivers dropped their counts.
+  void Reclaim() {
+    for (auto it = shared_blocks.begin(); it != shared_blocks.end();) {
+      if (refcounts[it->first].load(std::memory_order_acquire) != 0) {
+        ++it;
+        continue;
+      }
+      auto [offset, block_size] = it->second;
+      auto next = free_ranges.emplace(offset, block_size).first;
+      if (next != free_ranges.begin()) {
+        auto prev = std::prev(next);
+        if (prev->first + prev->second == offset) {
+          prev->second += next->second;
+          free_ranges.erase(next);
+          next = prev;
+        }
+      }
+      auto after = std::next(next);
+      if (after != free_ranges.end() &&
+          next->first + next->second == after->first) {
+        next->second += after->second;
+        free_ranges.erase(after);
+      }
+      free_slots.push_back(it->first);
+      it = shared_blocks.erase(it);
+    }
+  }
+
+  // First fit, returns false if no free range or slot is left.
+  bool TakeBlock(size_t block_size, size_t *offset, int *slot) {
+    if (free_slots.empty()) {
+      return false;
+    }
+    for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it) {
+      if (it->second < block_size) {
+        continue;
+      }
+      *offset = it->first;
+      if (it->second > block_size) {
+        free_ranges.emplace(it->first + block_size, it->second - block_size);
+      }
+      free_ranges.erase(it);
+      *slot = free_slots.back();
+      free_slots.pop_back();
+      shared_blocks.emplace(*slot, std::make_pair(*offset, block_size));
+      return true;
+    }
+    return false;
+  }
+
+  cudaEvent_t GetEvent(int slot, std::string *handle) {
+    if (events[slot] == nullptr) {
+      PADDLE_ENFORCE_GPU_SUCCESS(cudaEventCreateWithFlags(
+          &events[slot], cudaEventDisableTiming | cudaEventInterprocess));
+      cudaIpcEventHandle_t event_handle;
+      PADDLE_ENFORCE_GPU_SUCCESS(
+          cudaIpcGetEventHandle(&event_handle, events[slot]));
+      event_handles[slot].assign(reinterpret_cast<char *>(&event_handle),
+                                 CUDA_IPC_HANDLE_SIZE);
+    }
+    *handle = event_handles[slot];
+    return events[slot];
+  }
+};
+
+std::unique_ptr<CudaIpcSegment> CreateCudaIpcSegment(size_t size) {
+  auto segment = std::make_unique<CudaIpcSegment>();
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaMalloc(reinterpret_cast<void **>(&segment->ptr), size));
+  segment->size = size;
+  cudaIpcMemHandle_t mem_handle;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaIpcGetMemHandle(&mem_handle, segment->ptr));
+  segment->mem_handle.assign(reinterpret_cast<char *>(&mem_handle),
+                             CUDA_IPC_HANDLE_SIZE);
+  segment->refcount_name = GetIPCName();
+  segment->refcounts =
+      MapRefcounts(segment->refcount_name, O_RDWR | O_CREAT | O_EXCL);
+  // unlinked at exit
+  MemoryMapFdSet::Instance().Insert(segment->refcount_name);
+  segment->events.resize(kIpcSlotsPerSegment, nullptr);
+  segment->event_handles.resize(kIpcSlotsPerSegment);
+  segment->free_ranges.emplace(0, size);
+  segment->free_slots.reserve(kIpcSlotsPerSegment);
+  for (int slot = kIpcSlotsPerSegment - 1; slot >= 0; --slot) {
+    segment->free_slots.push_back(slot);
+  }
+  VLOG(4) << "Create CUDA IPC segment of " << size << " bytes, refcounts "
+          << segment->refcount_name;
+  return segment;
+}
+
+std::mutex ipc_pool_mutex_;
+std::unordered_map<int, std::vector<std::unique_ptr<CudaIpcSegment>>>
+    ipc_pools_;
+
+struct PendingIpcRelease {
+  cudaEvent_t event;
+  std::shared_ptr<std::atomic<int>> refcounts;
+  int slot;
+  // keeps the segment opened until the release is done
+  std::shared_ptr<void> segment;
+};
+
+std::mutex ipc_release_mutex_;
+std::list<PendingIpcRelease> pending_ipc_releases_;
+
+// Drops the counts of the received blocks whose last use is done.
+void ProcessPendingIpcReleases() {
+  std::lock_guard<std::mutex> lock(ipc_release_mutex_);
+  for (auto it = pending_ipc_releases_.begin();
+       it != pending_ipc_releases_.end();) {
+    auto err = cudaEventQuery(it->event);
+    if (err == cudaErrorNotReady) {
+      // clear the sticky error of the query
+      cudaGetLastError();
+      ++it;
+      continue;
+    }
+    PADDLE_ENFORCE_GPU_SUCCESS(err);
+    it->refcounts.get()[it->slot].fetch_sub(1, std::memory_order_release);
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventDestroy(it->event));
+    it = pending_ipc_releases_.erase(it);
+  }
+}
+
+std::mutex ipc_refcount_mutex_;
+std::unordered_map<std::string, std::weak_ptr<std::atomic<int>>>
+    ipc_name_to_refcounts_;
+
+std::shared_ptr<std::atomic<int>> GetIpcRefcounts(const std::string &name) {
+  std::lock_guard<std::mutex> lock(ipc_refcount_mutex_);
+  auto iter = ipc_name_to_refcounts_.find(name);
+  if (iter != ipc_name_to_refcounts_.end()) {
+    auto refcounts = iter->second.lock();
+    if (refcounts) return refcounts;
+  }
+  // not registered to MemoryMapFdSet, the file is owned by the producer
+  auto sp = std::shared_ptr<std::atomic<int>>(
+      MapRefcounts(name, O_RDWR), [name](std::atomic<int> *ptr) {
+        munmap(ptr, kIpcRefcountBytes);
+        std::lock_guard<std::mutex> lock(ipc_refcount_mutex_);
+        ipc_name_to_refcounts_.erase(name);
+      });
+  ipc_name_to_refcounts_[name] = sp;
+  return sp;
+}
+
+std::mutex ipc_event_mutex_;
+// opened events are kept, the producer reuses them for its blocks
+std::unordered_map<std::string, cudaEvent_t> ipc_handle_to_event_;
+
+cudaEvent_t GetIpcEvent(const std::string &handle) {
+  std::lock_guard<std::mutex> lock(ipc_event_mutex_);
+  auto iter = ipc_handle_to_event_.find(handle);
+  if (iter != ipc_handle_to_event_.end()) {
+    return iter->second;
+  }
+  cudaEvent_t event;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaIpcOpenEventHandle(
+      &event, *reinterpret_cast<const cudaIpcEventHandle_t *>(handle.data())));
+  ipc_handle_to_event_.emplace(handle, event);
+  return event;
+}
+
+class CudaIpcBlockAllocation : public CudaIpcAllocation {
+ public:
+  CudaIpcBlockAllocation(void *ptr,
+                         size_t size,
+                         int device_id,
+                         std::shared_ptr<void> segment,
+                         std::shared_ptr<std::atomic<int>> refcounts,
+                         int slot,
+                         gpuStream_t stream)
+      : CudaIpcAllocation(ptr, size, device_id, segment),
+        segment_(std::move(segment)),
+        refcounts_(std::move(refcounts)),
+        slot_(slot),
+        stream_(stream) {}
+
+  ~CudaIpcBlockAllocation() override {
+    // the count is dropped once the work queued on the block is done
+    platform::CUDADeviceGuard guard(device_id());
+    cudaEvent_t event;
+    if (cudaEventCreateWithFlags(&event, cudaEventDisableTiming) !=
+            cudaSuccess ||
+        cudaEventRecord(event, stream_) != cudaSuccess) {
+      // the runtime is shutting down
+      refcounts_.get()[slot_].fetch_sub(1, std::memory_order_release);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(ipc_release_mutex_);
+      pending_ipc_releases_.push_back(
+          {event, std::move(refcounts_), slot_, std::move(segment_)});
+    }
+    ProcessPendingIpcReleases();
+  }
+
+ private:
+  std::shared_ptr<void> segment_;
+  std::shared_ptr<std::atomic<int>> refcounts_;
+  int slot_;
+  gpuStream_t stream_;
+};
+
+}  // namespace
+
+CudaIpcBlockMeta ShareToCudaIpcPool(const void *src,
+                                    size_t size,
+                                    int device_id,
+                                    gpuStream_t stream) {
+  size_t block_size =
+      AlignedSize(std::max<size_t>(size, 1), kIpcBlockAlignment);
+  platform::CUDADeviceGuard guard(device_id);
+  std::lock_guard<std::mutex> lock(ipc_pool_mutex_);
+  auto &segments = ipc_pools_[device_id];
+  CudaIpcSegment *segment = nullptr;
+  CudaIpcBlockMeta meta;
+  for (auto &candidate : segments) {
+    candidate->Reclaim();
+    if (candidate->TakeBlock(block_size, &meta.offset, &meta.slot)) {
+      segment = candidate.get();
+      break;
+    }
+  }
+  if (segment == nullptr) {
+    size_t segment_size = std::max<size_t>(
+        FLAGS_cuda_ipc_pool_segment_size_mb << 20, block_size);
+    segments.emplace_back(CreateCudaIpcSegment(segment_size));
+    segment = segments.back().get();
+    segment->TakeBlock(block_size, &meta.offset, &meta.slot);
+  }
+  meta.mem_handle = segment->mem_handle;
+  meta.refcount_name = segment->refcount_name;
+  cudaEvent_t event = segment->GetEvent(meta.slot, &meta.event_handle);
+  segment->refcounts[meta.slot].store(1, std::memory_order_relaxed);
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemcpyAsync(segment->ptr + meta.offset,
+                                             src,
+                                             size,
+                                             cudaMemcpyDeviceToDevice,
+                                             stream));
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event, stream));
+  VLOG(6) << "Share " << size << " bytes to CUDA IPC block " << meta.slot
+          << " at offset " << meta.offset;
+  return meta;
+}
+
+std::shared_ptr<Allocation> OpenCudaIpcBlock(const CudaIpcBlockMeta &meta,
+                                             size_t size,
+                                             int device_id,
+                                             gpuStream_t stream) {
+  platform::CUDADeviceGuard guard(device_id);
+  ProcessPendingIpcReleases();
+  auto segment = GetIpcBasePtr(meta.mem_handle);
+  auto refcounts = GetIpcRefcounts(meta.refcount_name);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cudaStreamWaitEvent(stream, GetIpcEvent(meta.event_handle), 0));
+  void *ptr = reinterpret_cast<char *>(segment.get()) + meta.offset;
+  return std::make_shared<CudaIpcBlockAllocation>(ptr,
+                                                  size,
+                                                  device_id,
+                                                  std::move(segment),
+                                                  std::move(refcounts),
+                                                  meta.slot,
+                                                  stream);
+}
+
 }  // namespace paddle::memory::allocation
 
 #endif
@@ -32,6 +32,38 @@ namespace allocation {
 
 std::shared_ptr<void> GetIpcBasePtr(std::string handle);
 
+// Pooled sharing of GPU tensors between processes. The producer copies each
+// shared tensor into a block of a large segment whose cudaIpcMemHandle is
+// exported once, so a receiver opens every segment only once. Each block has
+// a reference count in shared memory and an interprocess event recorded
+// after the copy: the receiver waits for the event on its stream instead of
+// the producer synchronizing, and drops the count once the received tensor
+// is freed and the work queued on it is done. The producer then reuses the
+// block.
+struct CudaIpcBlockMeta {
+  std::string mem_handle;
+  std::string event_handle;
+  // name of the shared memory file of the reference counts of the segment
+  std::string refcount_name;
+  size_t offset;
+  // index of the reference count and the event of the block
+  int slot;
+};
+
+// Copies size bytes at src on stream into a pooled block and returns the
+// meta to send to the single receiver of the block.
+CudaIpcBlockMeta ShareToCudaIpcPool(const void *src,
+                                    size_t size,
+                                    int device_id,
+                                    gpuStream_t stream);
+
+// Opens a block shared by ShareToCudaIpcPool, work on stream waits for the
+// copy of the producer.
+std::shared_ptr<Allocation> OpenCudaIpcBlock(const CudaIpcBlockMeta &meta,
+                                             size_t size,
+                                             int device_id,
+                                             gpuStream_t stream);
+
 class CudaIpcAllocation : public Allocation {
  public:
   explicit CudaIpcAllocation(void *ptr,
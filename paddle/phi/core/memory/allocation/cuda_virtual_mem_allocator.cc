@@ -31,8 +31,37 @@
 
 namespace paddle::memory::allocation {
 
-CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(const phi::GPUPlace& place)
-    : place_(place), virtual_mem_base_(0), prop_{} {
+namespace {
+
+void ThrowGpuOutOfMemory(int device, size_t size) {
+  size_t actual_avail, actual_total;
+  PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&actual_avail, &actual_total));
+  size_t actual_allocated = actual_total - actual_avail;
+
+  PADDLE_THROW_BAD_ALLOC(common::errors::ResourceExhausted(
+      "\n\nOut of memory error on GPU %d. "
+      "Cannot allocate %s memory on GPU %d, %s memory has been allocated "
+      "and "
+      "available memory is only %s.\n\n"
+      "Please check whether there is any other process using GPU %d.\n"
+      "1. If yes, please stop them, or start PaddlePaddle on another GPU.\n"
+      "2. If no, please decrease the batch size of your model.\n\n",
+      device,
+      string::HumanReadableSize(size),
+      device,
+      string::HumanReadableSize(actual_allocated),
+      string::HumanReadableSize(actual_avail),
+      device));
+}
+
+}  // namespace
+
+CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(const phi::GPUPlace& place,
+                                                 bool map_by_page)
+    : place_(place),
+      map_by_page_(map_by_page),
+      virtual_mem_base_(0),
+      prop_{} {
   CUmemAllocationProp prop = {};
 
   // Setup the properties common for all the chunks
@@ -84,6 +113,10 @@ CUDAVirtualMemAllocator::CUDAVirtualMemAllocator(const phi::GPUPlace& place)
   PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&actual_avail, &actual_total));
 
   virtual_mem_size_ = AlignedSize(actual_total, granularity_);
+  if (map_by_page_) {
+    // room for the holes left by released pages
+    virtual_mem_size_ *= 2;
+  }
 
   // Reserve the required contiguous virtual address space for the allocations
   // The maximum video memory size we can apply for is the video memory size of
@@ -105,6 +138,24 @@ void CUDAVirtualMemAllocator::FreeImpl(phi::Allocation* allocation) {
       common::errors::PermissionDenied(
           "GPU memory is freed in incorrect device. This may be a bug"));
 
+  if (map_by_page_) {
+    auto ptr = reinterpret_cast<CUdeviceptr>(allocation->ptr());
+    paddle::platform::CUDADeviceGuard guard(place_.device);
+    auto iter = page_map_.lower_bound(ptr);
+    while (iter != page_map_.end() && iter->first < ptr + allocation->size()) {
+      auto page = iter->first;
+      // pages released by compaction may belong to other chunks by now
+      bool owned = iter->second.second == ptr;
+      ++iter;
+      if (owned) {
+        ReleasePage(page);
+        AddFreeRange(page, granularity_);
+      }
+    }
+    delete allocation;
+    return;
+  }
+
   auto iter = virtual_2_physical_map_.find(
       reinterpret_cast<CUdeviceptr>(allocation->ptr()));
   if (iter == virtual_2_physical_map_.end()) {
@@ -140,6 +191,40 @@ void CUDAVirtualMemAllocator::FreeImpl(phi::Allocation* allocation) {
 phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
   size = AlignedSize(size, granularity_);
 
+  if (map_by_page_) {
+    CUdeviceptr ptr = TakeFreeRange(size);
+    bool from_tail = ptr == 0;
+    if (from_tail) {
+      ptr = virtual_mem_base_ + virtual_mem_alloced_offset_;
+    }
+    if (ptr + size > virtual_mem_base_ + virtual_mem_size_) {
+      PADDLE_THROW_BAD_ALLOC(common::errors::ResourceExhausted(
+          "\n\nOut of memory error on GPU Virtual Memory %d. "
+          "Cannot allocate %s memory, the reserved address space of %s is "
+          "used up by allocations and holes left by released pages.\n\n",
+          place_.device,
+          string::HumanReadableSize(size),
+          string::HumanReadableSize(virtual_mem_size_)));
+    }
+
+    paddle::platform::CUDADeviceGuard guard(place_.device);
+    auto result = MapPages(ptr, size);
+    if (result != CUDA_SUCCESS) {
+      if (!from_tail) {
+        AddFreeRange(ptr, size);
+      }
+      if (result == CUDA_ERROR_OUT_OF_MEMORY) {
+        ThrowGpuOutOfMemory(place_.device, size);
+      }
+      PADDLE_ENFORCE_GPU_SUCCESS(result);
+    }
+    if (from_tail) {
+      virtual_mem_alloced_offset_ += size;
+    }
+    return new Allocation(
+        reinterpret_cast<void*>(ptr), size, phi::Place(place_));  // NOLINT
+  }
+
   CUdeviceptr ptr = virtual_mem_base_ + virtual_mem_alloced_offset_;
 
   if (ptr + size > virtual_mem_base_ + virtual_mem_size_) {
@@ -169,24 +254,7 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
 
   if (result != CUDA_SUCCESS) {
     if (result == CUDA_ERROR_OUT_OF_MEMORY) {
-      size_t actual_avail, actual_total;
-      PADDLE_ENFORCE_GPU_SUCCESS(cudaMemGetInfo(&actual_avail, &actual_total));
-      size_t actual_allocated = actual_total - actual_avail;
-
-      PADDLE_THROW_BAD_ALLOC(common::errors::ResourceExhausted(
-          "\n\nOut of memory error on GPU %d. "
-          "Cannot allocate %s memory on GPU %d, %s memory has been allocated "
-          "and "
-          "available memory is only %s.\n\n"
-          "Please check whether there is any other process using GPU %d.\n"
-          "1. If yes, please stop them, or start PaddlePaddle on another GPU.\n"
-          "2. If no, please decrease the batch size of your model.\n\n",
-          place_.device,
-          string::HumanReadableSize(size),
-          place_.device,
-          string::HumanReadableSize(actual_allocated),
-          string::HumanReadableSize(actual_avail),
-          place_.device));
+      ThrowGpuOutOfMemory(place_.device, size);
     } else {
       PADDLE_ENFORCE_GPU_SUCCESS(result);
     }
@@ -223,6 +291,127 @@ phi::Allocation* CUDAVirtualMemAllocator::AllocateImpl(size_t size) {
       reinterpret_cast<void*>(ptr), size, phi::Place(place_));  // NOLINT
 }
 
+std::vector<std::pair<void*, size_t>>
+CUDAVirtualMemAllocator::ReleasePhysicalPages(
+    const std::vector<std::pair<void*, size_t>>& ranges) {
+  std::vector<std::pair<void*, size_t>> released;
+  if (!map_by_page_) {
+    return released;
+  }
+  paddle::platform::CUDADeviceGuard guard(place_.device);
+  bool synchronized = false;
+  for (auto& range : ranges) {
+    auto begin = reinterpret_cast<CUdeviceptr>(range.first);
+    auto end = begin + range.second;
+    begin = AlignedSize(begin, granularity_);
+    end = end / granularity_ * granularity_;
+    size_t range_start = released.size();
+    for (auto page = begin; page < end; page += granularity_) {
+      if (page_map_.count(page) == 0) {
+        continue;
+      }
+      if (!synchronized) {
+        // the free blocks may still be read by kernels in flight
+        PADDLE_ENFORCE_GPU_SUCCESS(cudaDeviceSynchronize());
+        synchronized = true;
+      }
+      ReleasePage(page);
+      AddFreeRange(page, granularity_);
+      if (released.size() > range_start &&
+          reinterpret_cast<CUdeviceptr>(released.back().first) +
+                  released.back().second ==
+              page) {
+        released.back().second += granularity_;
+      } else {
+        released.emplace_back(reinterpret_cast<void*>(page), granularity_);
+      }
+    }
+  }
+  return released;
+}
+
+// Best fit among the holes, 0 if none is large enough.
+CUdeviceptr CUDAVirtualMemAllocator::TakeFreeRange(size_t size) {
+  auto best = free_ranges_.end();
+  for (auto iter = free_ranges_.begin(); iter != free_ranges_.end(); ++iter) {
+    if (iter->second >= size &&
+        (best == free_ranges_.end() || iter->second < best->second)) {
+      best = iter;
+    }
+  }
+  if (best == free_ranges_.end()) {
+    return 0;
+  }
+  CUdeviceptr ptr = best->first;
+  size_t remaining = best->second - size;
+  free_ranges_.erase(best);
+  if (remaining > 0) {
+    free_ranges_.emplace(ptr + size, remaining);
+  }
+  return ptr;
+}
+
+void CUDAVirtualMemAllocator::AddFreeRange(CUdeviceptr ptr, size_t size) {
+  auto next = free_ranges_.lower_bound(ptr);
+  if (next != free_ranges_.end() && ptr + size == next->first) {
+    size += next->second;
+    next = free_ranges_.erase(next);
+  }
+  if (next != free_ranges_.begin()) {
+    auto prev = std::prev(next);
+    if (prev->first + prev->second == ptr) {
+      prev->second += size;
+      return;
+    }
+  }
+  free_ranges_.emplace_hint(next, ptr, size);
+}
+
+// Maps one physical allocation per page, the mapped pages are released again
+// on failure.
+CUresult CUDAVirtualMemAllocator::MapPages(CUdeviceptr ptr, size_t size) {
+  CUresult result = CUDA_SUCCESS;
+  size_t offset = 0;
+  for (; offset < size; offset += granularity_) {
+    CUmemGenericAllocationHandle handle;
+    result = platform::RecordedGpuMemCreate(
+        &handle, granularity_, &prop_, 0, place_.device);
+    if (result != CUDA_SUCCESS) {
+      break;
+    }
+    result = phi::dynload::cuMemMap(ptr + offset, granularity_, 0, handle, 0);
+    if (result != CUDA_SUCCESS) {
+      platform::RecordedGpuMemRelease(handle, granularity_, place_.device);
+      break;
+    }
+    result = phi::dynload::cuMemSetAccess(
+        ptr + offset, granularity_, access_desc_.data(), access_desc_.size());
+    if (result != CUDA_SUCCESS) {
+      phi::dynload::cuMemUnmap(ptr + offset, granularity_);
+      platform::RecordedGpuMemRelease(handle, granularity_, place_.device);
+      break;
+    }
+    page_map_.emplace(ptr + offset, std::make_pair(handle, ptr));
+  }
+  if (result != CUDA_SUCCESS) {
+    for (size_t mapped = 0; mapped < offset; mapped += granularity_) {
+      ReleasePage(ptr + mapped);
+    }
+  }
+  return result;
+}
+
+void CUDAVirtualMemAllocator::ReleasePage(CUdeviceptr page) {
+  auto iter = page_map_.find(page);
+  auto result = phi::dynload::cuMemUnmap(page, granularity_);
+  if (result != CUDA_ERROR_DEINITIALIZED) {
+    PADDLE_ENFORCE_GPU_SUCCESS(result);
+    PADDLE_ENFORCE_GPU_SUCCESS(platform::RecordedGpuMemRelease(
+        iter->second.first, granularity_, place_.device));
+  }
+  page_map_.erase(iter);
+}
+
 }  // namespace paddle::memory::allocation
 
 #endif
@@ -20,10 +20,14 @@
 #include "paddle/phi/core/platform/cuda_device_guard.h"
 #endif
 
+#include <map>
 #include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
 
 #if CUDA_VERSION >= 10020
 
@@ -31,19 +35,35 @@ namespace paddle {
 namespace memory {
 namespace allocation {
 
-// Allocate memory using NVIDIA's virtual memory management technology
-class CUDAVirtualMemAllocator : public Allocator {
+// Allocate memory using NVIDIA's virtual memory management technology.
+//
+// With map_by_page, every chunk is backed by granularity sized physical
+// allocations instead of a single one, so that the pages behind the free
+// blocks of VirtualMemoryAutoGrowthBestFitAllocator can be released without
+// moving live data. The address ranges of released pages are reused by later
+// chunks, and twice the device memory is reserved to leave room for holes.
+class CUDAVirtualMemAllocator : public Allocator, public PhysicalPageReleaser {
  public:
-  explicit CUDAVirtualMemAllocator(const phi::GPUPlace& place);
+  explicit CUDAVirtualMemAllocator(const phi::GPUPlace& place,
+                                   bool map_by_page = false);
 
   bool IsAllocThreadSafe() const override;
 
+  std::vector<std::pair<void*, size_t>> ReleasePhysicalPages(
+      const std::vector<std::pair<void*, size_t>>& ranges) override;
+
  protected:
   void FreeImpl(phi::Allocation* allocation) override;
   phi::Allocation* AllocateImpl(size_t size) override;
 
  private:
+  CUdeviceptr TakeFreeRange(size_t size);
+  void AddFreeRange(CUdeviceptr ptr, size_t size);
+  CUresult MapPages(CUdeviceptr ptr, size_t size);
+  void ReleasePage(CUdeviceptr page);
+
   phi::GPUPlace place_;
+  bool map_by_page_;
 
   CUdeviceptr virtual_mem_base_;
   size_t virtual_mem_size_;
@@ -55,6 +75,12 @@ class CUDAVirtualMemAllocator : public Allocator {
 
   std::map<CUdeviceptr, std::pair<CUmemGenericAllocationHandle, size_t>>
       virtual_2_physical_map_;
+
+  // only used with map_by_page, page -> (handle, base of the owning chunk)
+  std::map<CUdeviceptr, std::pair<CUmemGenericAllocationHandle, CUdeviceptr>>
+      page_map_;
+  // unmapped ranges below virtual_mem_alloced_offset_, base -> size
+  std::map<CUdeviceptr, size_t> free_ranges_;
 };
 
 }  // namespace allocation
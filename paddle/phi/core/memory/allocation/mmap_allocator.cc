@@ -27,8 +27,15 @@
 #include "glog/logging.h"
 #include "paddle/common/flags.h"
 #include "paddle/phi/core/enforce.h"
+#ifdef PADDLE_WITH_CUDA
+#include <cuda_runtime.h>
+#endif
+#ifdef PADDLE_WITH_HIP
+#include <hip/hip_runtime.h>
+#endif
 
 COMMON_DECLARE_bool(use_shm_cache);
+COMMON_DECLARE_int32(dataloader_shm_ring_size);
 
 namespace paddle::memory::allocation {
 
@@ -419,6 +426,146 @@ void MemoryMapAllocationPool::Clear() {
 
 MemoryMapAllocationPool::~MemoryMapAllocationPool() { Clear(); }  // NOLINT
 
+MemoryMapRingSegment::MemoryMapRingSegment(std::string ipc_name,
+                                           size_t size,
+                                           bool owner)
+    : ipc_name_(std::move(ipc_name)),
+      map_size_(size + mmap_alignment),
+      owner_(owner) {
+  int fd = -1;
+  int flags = MAPPED_SHAREDMEM;
+  flags |= owner ? MAPPED_EXCLUSIVE : MAPPED_NOCREATE;
+  AllocateMemoryMap(ipc_name_, &fd, flags, map_size_, &map_ptr_);
+  if (owner) {
+    new (map_ptr_) std::atomic<int>(0);
+  }
+}
+
+MemoryMapRingSegment::~MemoryMapRingSegment() {
+#ifdef PADDLE_WITH_CUDA
+  if (pinned_) {
+    cudaHostUnregister(map_ptr_);
+  }
+#elif defined(PADDLE_WITH_HIP)
+  if (pinned_) {
+    hipHostUnregister(map_ptr_);
+  }
+#endif
+  if (owner_) {
+    shm_unlink(ipc_name_.c_str());
+    MemoryMapFdSet::Instance().Remove(ipc_name_);
+    VLOG(6) << "shm_unlink ring segment: " << ipc_name_;
+  }
+  if (munmap(map_ptr_, map_size_) == -1) {
+    LOG(WARNING) << "could not unmap the shared memory file " << ipc_name_
+                 << ": " << strerror(errno);
+  }
+}
+
+std::atomic<int> *MemoryMapRingSegment::readers() const {
+  return static_cast<std::atomic<int> *>(map_ptr_);
+}
+
+bool MemoryMapRingSegment::Pin() {
+  if (pinned_) {
+    return true;
+  }
+#ifdef PADDLE_WITH_CUDA
+  pinned_ = cudaHostRegister(map_ptr_, map_size_, cudaHostRegisterDefault) ==
+            cudaSuccess;
+  if (!pinned_) {
+    cudaGetLastError();
+  }
+#elif defined(PADDLE_WITH_HIP)
+  pinned_ = hipHostRegister(map_ptr_, map_size_, hipHostRegisterDefault) ==
+            hipSuccess;
+  if (!pinned_) {
+    hipGetLastError();
+  }
+#endif
+  VLOG(4) << "Pin ring segment " << ipc_name_ << ": " << pinned_;
+  return pinned_;
+}
+
+MemoryMapRingAllocation::~MemoryMapRingAllocation() {
+  segment_->readers()->fetch_sub(1);
+}
+
+MemoryMapRing &MemoryMapRing::Instance() {  // NOLINT
+  // the segments left at exit are unlinked by MemoryMapFdSet
+  static MemoryMapRing *ring = new MemoryMapRing();
+  return *ring;
+}
+
+bool MemoryMapRing::IsEnabled() const {
+  return FLAGS_dataloader_shm_ring_size > 0;
+}
+
+std::shared_ptr<MemoryMapRingSegment> MemoryMapRing::Acquire(size_t size) {
+  std::lock_guard<std::mutex> guard(mtx_);
+  int free_idx = -1;
+  for (int idx = 0; idx < static_cast<int>(segments_.size()); ++idx) {
+    auto &segment = segments_[idx];
+    if (segment->readers()->load() != 0) {
+      continue;
+    }
+    if (segment->size() >= size) {
+      segment->readers()->store(1);
+      return segment;
+    }
+    free_idx = idx;
+  }
+
+  bool append =
+      static_cast<int>(segments_.size()) < FLAGS_dataloader_shm_ring_size;
+  if (!append && free_idx == -1) {
+    return nullptr;
+  }
+  // leave some room for the batches a bit larger than this one
+  size_t segment_size = size + size / 4;
+  auto segment =
+      std::make_shared<MemoryMapRingSegment>(GetIPCName(), segment_size, true);
+  if (append) {
+    segments_.emplace_back(segment);
+  } else {
+    // the batch outgrows a free segment
+    segments_[free_idx] = segment;
+  }
+  VLOG(4) << "Create ring segment " << segment->ipc_name() << " of "
+          << segment_size << " bytes";
+  segment->readers()->store(1);
+  return segment;
+}
+
+std::shared_ptr<MemoryMapRingAllocation> MemoryMapRing::Open(
+    const std::string &ipc_name,
+    size_t segment_size,
+    size_t data_size,
+    bool pin_memory) {
+  std::shared_ptr<MemoryMapRingSegment> segment;
+  {
+    std::lock_guard<std::mutex> guard(mtx_);
+    auto &opened = opened_[ipc_name];
+    if (!opened) {
+      opened = std::make_shared<MemoryMapRingSegment>(
+          ipc_name, segment_size, false);
+      VLOG(4) << "Map ring segment " << ipc_name;
+    }
+    segment = opened;
+  }
+  phi::Place place = phi::CPUPlace();
+  if (pin_memory && segment->Pin()) {
+    place = phi::GPUPinnedPlace();
+  }
+  return std::make_shared<MemoryMapRingAllocation>(segment, data_size, place);
+}
+
+void MemoryMapRing::Clear() {
+  std::lock_guard<std::mutex> guard(mtx_);
+  segments_.clear();
+  opened_.clear();
+}
+
 }  // namespace paddle::memory::allocation
 
 #endif
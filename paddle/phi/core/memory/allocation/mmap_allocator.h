@@ -20,8 +20,10 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "paddle/phi/core/memory/allocation/allocator.h"
 
@@ -235,6 +237,91 @@ class MemoryMapAllocationPool {
   std::mutex mtx_;
 };
 
+/* MemoryMapRing keeps a few shm segments in a DataLoader worker and reuses
+them for the following batches, see FLAGS_dataloader_shm_ring_size. All the
+tensors of a batch are packed into one segment, so a batch costs no shm_open,
+ftruncate or mmap once the ring is warm. The header of a segment counts the
+batches in the main process that still read it, the worker only writes a
+segment again when no reader is left.
+
+The main process maps each segment once and builds the tensors of a batch in
+place, the mapping may also be registered as pinned memory so that the copy to
+the device does not go through another staging buffer.
+*/
+class MemoryMapRingSegment {
+ public:
+  // Creates the segment when owner is true, otherwise opens the segment
+  // created by a worker.
+  MemoryMapRingSegment(std::string ipc_name, size_t size, bool owner);
+
+  ~MemoryMapRingSegment();
+
+  inline const std::string &ipc_name() const { return ipc_name_; }
+  inline void *data() const {
+    return static_cast<char *>(map_ptr_) + mmap_alignment;
+  }
+  inline size_t size() const { return map_size_ - mmap_alignment; }
+  inline bool pinned() const { return pinned_; }
+
+  std::atomic<int> *readers() const;
+
+  // Registers the mapping as page-locked memory, returns false if the
+  // device runtime is not available.
+  bool Pin();
+
+ private:
+  std::string ipc_name_;
+  void *map_ptr_ = nullptr;
+  size_t map_size_ = 0;
+  bool owner_ = false;
+  bool pinned_ = false;
+};
+
+// The tensors of a batch in the main process, which release the segment to
+// the worker when destructed.
+class MemoryMapRingAllocation : public Allocation {
+ public:
+  MemoryMapRingAllocation(std::shared_ptr<MemoryMapRingSegment> segment,
+                          size_t size,
+                          const phi::Place &place)
+      : Allocation(segment->data(), size, place),
+        segment_(std::move(segment)) {}
+
+  ~MemoryMapRingAllocation() override;
+
+ private:
+  std::shared_ptr<MemoryMapRingSegment> segment_;
+};
+
+class MemoryMapRing {
+ public:
+  static MemoryMapRing &Instance();  // NOLINT
+
+  bool IsEnabled() const;
+
+  // Returns a segment of at least size bytes with one reader, or nullptr
+  // when all the segments of the ring are still read.
+  std::shared_ptr<MemoryMapRingSegment> Acquire(size_t size);
+
+  // Returns the allocation of a batch written to the segment ipc_name.
+  std::shared_ptr<MemoryMapRingAllocation> Open(const std::string &ipc_name,
+                                                size_t segment_size,
+                                                size_t data_size,
+                                                bool pin_memory);
+
+  void Clear();
+
+ private:
+  MemoryMapRing() = default;
+
+  // written by the worker
+  std::vector<std::shared_ptr<MemoryMapRingSegment>> segments_;
+  // mapped by the main process
+  std::unordered_map<std::string, std::shared_ptr<MemoryMapRingSegment>>
+      opened_;
+  std::mutex mtx_;
+};
+
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
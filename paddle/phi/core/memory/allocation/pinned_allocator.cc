@@ -14,17 +14,79 @@
 
 #include "paddle/phi/core/memory/allocation/pinned_allocator.h"
 
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <fstream>
+#include <string>
+#endif
+
+#include "paddle/common/flags.h"
 #include "paddle/phi/core/memory/stats.h"
+#include "paddle/phi/core/platform/device/gpu/gpu_info.h"
 #include "paddle/phi/core/platform/profiler/mem_tracing.h"
+
+COMMON_DECLARE_bool(pinned_memory_numa_local);
+
 namespace paddle::memory::allocation {
+
+namespace {
+
+// Pinned with cudaHostRegister on mmap-ed pages instead of cudaHostAlloc.
+class NumaLocalPinnedAllocation : public Allocation {
+ public:
+  using Allocation::Allocation;
+};
+
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__)
+// MPOL_PREFERRED of <numaif.h>, which comes with libnuma
+constexpr int kMpolPreferred = 1;
+
+int ReadGpuNumaNode(int device) {
+  char bus_id[32];
+  if (cudaDeviceGetPCIBusId(bus_id, sizeof(bus_id), device) != cudaSuccess) {
+    cudaGetLastError();
+    return -1;
+  }
+  std::string path(bus_id);
+  std::transform(path.begin(), path.end(), path.begin(), [](char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  std::ifstream numa_node_file("/sys/bus/pci/devices/" + path + "/numa_node");
+  int node = -1;
+  if (!(numa_node_file >> node)) {
+    return -1;
+  }
+  return node;
+}
+#endif
+
+}  // namespace
+
+CPUPinnedAllocator::CPUPinnedAllocator()
+    : numa_local_(FLAGS_pinned_memory_numa_local) {}
+
 bool CPUPinnedAllocator::IsAllocThreadSafe() const { return true; }
 void CPUPinnedAllocator::FreeImpl(phi::Allocation *allocation) {
+  if (dynamic_cast<NumaLocalPinnedAllocation *>(allocation) != nullptr) {
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__)
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaHostUnregister(allocation->ptr()));
+    munmap(allocation->ptr(), allocation->size());
+#endif
+    VLOG(10) << "cudaHostUnregister " << allocation->ptr();
+  } else {
 #ifdef PADDLE_WITH_HIP
-  PADDLE_ENFORCE_GPU_SUCCESS(hipHostFree(allocation->ptr()));
+    PADDLE_ENFORCE_GPU_SUCCESS(hipHostFree(allocation->ptr()));
 #else
-  PADDLE_ENFORCE_GPU_SUCCESS(cudaFreeHost(allocation->ptr()));
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaFreeHost(allocation->ptr()));
 #endif
-  VLOG(10) << "cudaFreeHost " << allocation->ptr();
+    VLOG(10) << "cudaFreeHost " << allocation->ptr();
+  }
   HOST_MEMORY_STAT_UPDATE(Reserved, 0, -allocation->size());
   platform::RecordMemEvent(allocation->ptr(),
                            allocation->place(),
@@ -33,18 +95,84 @@ void CPUPinnedAllocator::FreeImpl(phi::Allocation *allocation) {
   delete allocation;
 }
 phi::Allocation *CPUPinnedAllocator::AllocateImpl(size_t size) {
-  void *ptr;
+  void *ptr = numa_local_ && size > 0 ? AllocateNumaLocal(size) : nullptr;
+  bool numa_local = ptr != nullptr;
+  if (!numa_local) {
 #ifdef PADDLE_WITH_HIP
-  PADDLE_ENFORCE_GPU_SUCCESS(hipHostMalloc(&ptr, size, hipHostMallocPortable));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        hipHostMalloc(&ptr, size, hipHostMallocPortable));
 #else
-  PADDLE_ENFORCE_GPU_SUCCESS(cudaHostAlloc(&ptr, size, cudaHostAllocPortable));
+    PADDLE_ENFORCE_GPU_SUCCESS(
+        cudaHostAlloc(&ptr, size, cudaHostAllocPortable));
 #endif
-  VLOG(10) << "cudaHostAlloc " << size << " " << ptr;
+    VLOG(10) << "cudaHostAlloc " << size << " " << ptr;
+  }
   HOST_MEMORY_STAT_UPDATE(Reserved, 0, size);
   platform::RecordMemEvent(ptr,
                            phi::GPUPinnedPlace(),
                            size,
                            phi::TracerMemEventType::ReservedAllocate);
+  if (numa_local) {
+    return new NumaLocalPinnedAllocation(ptr, size, phi::GPUPinnedPlace());
+  }
   return new Allocation(ptr, size, phi::GPUPinnedPlace());
 }
+
+void *CPUPinnedAllocator::AllocateNumaLocal(size_t size) {
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__)
+  int node = GpuNumaNode(platform::GetCurrentDeviceId());
+  unsigned long node_mask = 0;  // NOLINT
+  if (node < 0 || node >= static_cast<int>(sizeof(node_mask) * 8)) {
+    return nullptr;
+  }
+  void *ptr = mmap(nullptr,
+                   size,
+                   PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS,
+                   -1,
+                   0);
+  if (ptr == MAP_FAILED) {
+    return nullptr;
+  }
+  // the pages are faulted in by cudaHostRegister, under this policy
+  node_mask = 1UL << node;
+  if (syscall(SYS_mbind,
+              ptr,
+              size,
+              kMpolPreferred,
+              &node_mask,
+              sizeof(node_mask) * 8 + 1,
+              0) != 0) {
+    VLOG(4) << "mbind to NUMA node " << node << " failed, errno " << errno;
+  }
+  if (cudaHostRegister(ptr, size, cudaHostRegisterPortable) != cudaSuccess) {
+    cudaGetLastError();
+    munmap(ptr, size);
+    return nullptr;
+  }
+  VLOG(10) << "cudaHostRegister " << size << " " << ptr << " on NUMA node "
+           << node;
+  return ptr;
+#else
+  return nullptr;
+#endif
+}
+
+int CPUPinnedAllocator::GpuNumaNode(int device) {
+#if defined(PADDLE_WITH_CUDA) && defined(__linux__)
+  std::lock_guard<std::mutex> guard(numa_nodes_mtx_);
+  if (numa_nodes_.empty()) {
+    numa_nodes_.resize(platform::GetGPUDeviceCount(), -2);
+  }
+  int &node = numa_nodes_[device];
+  if (node == -2) {
+    node = ReadGpuNumaNode(device);
+    VLOG(4) << "GPU " << device << " is on NUMA node " << node;
+  }
+  return node;
+#else
+  return -1;
+#endif
+}
+
 }  // namespace paddle::memory::allocation
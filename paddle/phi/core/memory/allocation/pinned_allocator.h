@@ -13,20 +13,39 @@
 // limitations under the License.
 
 #pragma once
+#include <mutex>  // NOLINT
+#include <vector>
+
 #include "paddle/phi/core/memory/allocation/allocator.h"
 
 namespace paddle {
 namespace memory {
 namespace allocation {
 
-// Allocator uses `cudaHostAlloc`
+// Allocator uses `cudaHostAlloc`. With FLAGS_pinned_memory_numa_local, the
+// pages are instead mapped on the NUMA node of the current GPU and pinned with
+// `cudaHostRegister`, so that copies to and from the GPU do not cross the
+// interconnect between sockets. It falls back to `cudaHostAlloc` when the node
+// is unknown.
 class CPUPinnedAllocator : public Allocator {
  public:
+  CPUPinnedAllocator();
+
   bool IsAllocThreadSafe() const override;
 
  protected:
   void FreeImpl(phi::Allocation *allocation) override;
   phi::Allocation *AllocateImpl(size_t size) override;
+
+ private:
+  // Returns nullptr if the memory can not be placed on the node of the GPU.
+  void *AllocateNumaLocal(size_t size);
+  int GpuNumaNode(int device);
+
+  bool numa_local_;
+  std::mutex numa_nodes_mtx_;
+  // NUMA node of each GPU, -1 if unknown, -2 if not read yet
+  std::vector<int> numa_nodes_;
 };
 
 }  // namespace allocation
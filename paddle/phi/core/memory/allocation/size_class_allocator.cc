@@ -0,0 +1,229 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/stats.h"
+
+PHI_DEFINE_EXPORTED_uint64(
+    size_class_allocator_max_size,
+    1 << 20,
+    "The largest request size (in bytes) served from the size-class free "
+    "lists. Larger requests go to the auto-growth allocator directly. This "
+    "flag only works when FLAGS_allocator_strategy=size_class.");
+
+PHI_DEFINE_EXPORTED_uint64(
+    size_class_allocator_thread_cache_blocks,
+    64,
+    "The max number of free blocks of each size class kept in the cache of "
+    "each thread before they are returned to the central free list. This "
+    "flag only works when FLAGS_allocator_strategy=size_class.");
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+static uint64_t NextAllocatorId() {
+  static std::atomic<uint64_t> id{0};
+  return id.fetch_add(1, std::memory_order_relaxed);
+}
+
+static size_t PrevPowerOfTwo(size_t size) {
+  size_t power = 1;
+  while (power <= size / 2) {
+    power <<= 1;
+  }
+  return power;
+}
+
+SizeClassAllocator::SizeClassAllocator(
+    std::shared_ptr<Allocator> underlying_allocator,
+    const phi::Place &place,
+    size_t alignment,
+    size_t max_class_size,
+    size_t thread_cache_blocks)
+    : underlying_allocator_(std::move(underlying_allocator)),
+      place_(place),
+      alignment_(alignment),
+      thread_cache_blocks_(thread_cache_blocks),
+      id_(NextAllocatorId()) {
+  PADDLE_ENFORCE_GT(
+      alignment_,
+      0,
+      common::errors::InvalidArgument(
+          "The alignment of SizeClassAllocator must be greater than 0."));
+  // Four classes per power of two, each a multiple of the alignment.
+  for (size_t size = alignment_; size <= max_class_size;) {
+    class_sizes_.push_back(size);
+    size += std::max(alignment_, PrevPowerOfTwo(size) / 4 / alignment_ *
+                                     alignment_);
+  }
+  central_lists_ = std::vector<CentralList>(class_sizes_.size());
+  VLOG(4) << "Create SizeClassAllocator with " << class_sizes_.size()
+          << " size classes up to " << max_class_size << " bytes";
+}
+
+SizeClassAllocator::~SizeClassAllocator() { FlushAll(); }
+
+int SizeClassAllocator::SizeClassIndex(size_t size) const {
+  auto iter = std::lower_bound(class_sizes_.begin(), class_sizes_.end(), size);
+  if (iter == class_sizes_.end()) {
+    return -1;
+  }
+  return static_cast<int>(iter - class_sizes_.begin());
+}
+
+SizeClassAllocator::ThreadCache *SizeClassAllocator::GetThreadCache() {
+  thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCache>>
+      caches;
+  auto iter = caches.find(id_);
+  if (iter != caches.end()) {
+    return iter->second.get();
+  }
+  auto cache = std::make_shared<ThreadCache>(class_sizes_.size());
+  {
+    std::lock_guard<std::mutex> guard(thread_caches_mtx_);
+    thread_caches_.push_back(cache);
+  }
+  caches.emplace(id_, cache);
+  return cache.get();
+}
+
+void SizeClassAllocator::LockAndCount(SpinLock *lock) {
+  if (!lock->try_lock()) {
+    UpdateStat(/*cached_stat=*/false, 1);
+    lock->lock();
+  }
+}
+
+void SizeClassAllocator::UpdateStat(bool cached_stat, int64_t increment) {
+  if (phi::is_cpu_place(place_) || phi::is_cuda_pinned_place(place_)) {
+    if (cached_stat) {
+      HOST_MEMORY_STAT_UPDATE(SizeClassCached, 0, increment);
+    } else {
+      HOST_MEMORY_STAT_UPDATE(AllocatorLockContention, 0, increment);
+    }
+  } else {
+    if (cached_stat) {
+      DEVICE_MEMORY_STAT_UPDATE(
+          SizeClassCached, place_.GetDeviceId(), increment);
+    } else {
+      DEVICE_MEMORY_STAT_UPDATE(
+          AllocatorLockContention, place_.GetDeviceId(), increment);
+    }
+  }
+}
+
+phi::Allocation *SizeClassAllocator::AllocateImpl(size_t size) {
+  int index = size == 0 ? -1 : SizeClassIndex(size);
+  if (index < 0) {
+    return underlying_allocator_->Allocate(size).release();
+  }
+
+  phi::Allocation *allocation = nullptr;
+  ThreadCache *cache = GetThreadCache();
+  {
+    std::lock_guard<SpinLock> guard(cache->lock);
+    FreeList &list = cache->free_lists[index];
+    if (!list.empty()) {
+      allocation = list.back();
+      list.pop_back();
+    }
+  }
+  if (allocation == nullptr) {
+    CentralList &central = central_lists_[index];
+    LockAndCount(&central.lock);
+    if (!central.blocks.empty()) {
+      allocation = central.blocks.back();
+      central.blocks.pop_back();
+    }
+    central.lock.unlock();
+  }
+
+  if (allocation != nullptr) {
+    UpdateStat(/*cached_stat=*/true,
+               -static_cast<int64_t>(class_sizes_[index]));
+    return allocation;
+  }
+  return underlying_allocator_->Allocate(class_sizes_[index]).release();
+}
+
+void SizeClassAllocator::FreeImpl(phi::Allocation *allocation) {
+  size_t size = allocation->size();
+  int index = size == 0 ? -1 : SizeClassIndex(size);
+  if (index < 0 || class_sizes_[index] != size) {
+    underlying_allocator_->Free(allocation);
+    return;
+  }
+
+  UpdateStat(/*cached_stat=*/true, static_cast<int64_t>(size));
+  ThreadCache *cache = GetThreadCache();
+  {
+    std::lock_guard<SpinLock> guard(cache->lock);
+    FreeList &list = cache->free_lists[index];
+    if (list.size() < thread_cache_blocks_) {
+      list.push_back(allocation);
+      return;
+    }
+  }
+  CentralList &central = central_lists_[index];
+  LockAndCount(&central.lock);
+  central.blocks.push_back(allocation);
+  central.lock.unlock();
+}
+
+uint64_t SizeClassAllocator::FlushAll() {
+  std::vector<phi::Allocation *> blocks;
+  {
+    std::lock_guard<std::mutex> guard(thread_caches_mtx_);
+    for (auto &cache : thread_caches_) {
+      std::lock_guard<SpinLock> cache_guard(cache->lock);
+      for (auto &list : cache->free_lists) {
+        blocks.insert(blocks.end(), list.begin(), list.end());
+        list.clear();
+      }
+    }
+  }
+  for (auto &central : central_lists_) {
+    LockAndCount(&central.lock);
+    blocks.insert(blocks.end(), central.blocks.begin(), central.blocks.end());
+    central.blocks.clear();
+    central.lock.unlock();
+  }
+
+  uint64_t flushed_bytes = 0;
+  for (auto *allocation : blocks) {
+    flushed_bytes += allocation->size();
+    underlying_allocator_->Free(allocation);
+  }
+  UpdateStat(/*cached_stat=*/true, -static_cast<int64_t>(flushed_bytes));
+  VLOG(10) << "SizeClassAllocator flushed " << blocks.size() << " blocks ("
+           << flushed_bytes << " bytes)";
+  return flushed_bytes;
+}
+
+uint64_t SizeClassAllocator::ReleaseImpl(const phi::Place &place) {
+  FlushAll();
+  return underlying_allocator_->Release(place);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
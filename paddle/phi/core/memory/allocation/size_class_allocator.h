@@ -0,0 +1,108 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/spin_lock.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// SizeClassAllocator decorates an auto-growth best-fit allocator with
+// segregated free lists. Small requests are rounded up to one of a fixed set
+// of size classes (four classes per power of two, as multiples of the
+// alignment). Freed blocks are kept in a per-thread cache first and in a
+// per-class central list when the thread cache is full, so most allocations
+// never take the lock of the underlying best-fit allocator. Requests larger
+// than the largest size class go to the underlying allocator directly.
+//
+// The bytes kept in the free lists and the number of contended lock
+// acquisitions are reported as the SizeClassCached and AllocatorLockContention
+// memory stats.
+class SizeClassAllocator : public Allocator {
+ public:
+  SizeClassAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                     const phi::Place &place,
+                     size_t alignment,
+                     size_t max_class_size,
+                     size_t thread_cache_blocks);
+
+  ~SizeClassAllocator() override;
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t NumSizeClasses() const { return class_sizes_.size(); }
+
+  // Return the index of the smallest size class that fits size, or -1 if the
+  // size is larger than the largest size class.
+  int SizeClassIndex(size_t size) const;
+
+  size_t SizeClassSize(size_t index) const { return class_sizes_[index]; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override;
+
+  void FreeImpl(phi::Allocation *allocation) override;
+
+  uint64_t ReleaseImpl(const phi::Place &place) override;
+
+ private:
+  using FreeList = std::vector<phi::Allocation *>;
+
+  struct ThreadCache {
+    explicit ThreadCache(size_t num_classes) : free_lists(num_classes) {}
+    // Only contended when ReleaseImpl flushes the caches of all threads.
+    SpinLock lock;
+    std::vector<FreeList> free_lists;
+  };
+
+  struct CentralList {
+    SpinLock lock;
+    FreeList blocks;
+  };
+
+  ThreadCache *GetThreadCache();
+
+  // Acquire lock and count the acquisition as contended if it is held.
+  void LockAndCount(SpinLock *lock);
+
+  void UpdateStat(bool cached_stat, int64_t increment);
+
+  // Return all the cached blocks to the underlying allocator.
+  uint64_t FlushAll();
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  phi::Place place_;
+  size_t alignment_;
+  size_t thread_cache_blocks_;
+  std::vector<size_t> class_sizes_;
+  std::vector<CentralList> central_lists_;
+
+  // Unique id to look up the thread caches of this allocator, so that a new
+  // allocator at the address of a destroyed one never sees stale caches.
+  const uint64_t id_;
+  std::mutex thread_caches_mtx_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,208 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "paddle/phi/common/place.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/memory/allocation/allocator.h"
+#include "paddle/phi/core/memory/allocation/spin_lock.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+struct StreamSafeAllocatorStats {
+  // Number of frees deferred because other streams were still using the
+  // allocations.
+  uint64_t deferred_free_count{0};
+  // Bytes held by the deferred allocations, they can not be reused by any
+  // stream until the events recorded on them complete.
+  uint64_t deferred_bytes{0};
+  uint64_t peak_deferred_bytes{0};
+  // Number of allocations that only succeeded after releasing the memory of
+  // all the streams of the place.
+  uint64_t alloc_retry_count{0};
+};
+
+// StreamSafeAllocatorBase is the backend agnostic core of the stream safe
+// allocators of CUDA, XPU and custom devices. An allocation that is still
+// used by other streams when it is freed is deferred, and released once the
+// events recorded on those streams complete. Every stream of a place owns a
+// stream safe allocator on top of its own underlying allocator, which serves
+// as the per-stream free cache. When the underlying allocator runs out of
+// memory, the deferred allocations and the cached memory of all the streams
+// of the place are released and the allocation is retried.
+//
+// AllocationT should provide `bool CanBeFreed()`, which returns true when no
+// other stream is using the allocation.
+template <typename AllocationT>
+class StreamSafeAllocatorBase : public Allocator {
+ public:
+  // An allocator which is not registered, e.g. the one used in CUDA Graph
+  // capturing, never releases the memory of the other streams.
+  StreamSafeAllocatorBase(std::shared_ptr<Allocator> underlying_allocator,
+                          const phi::Place& place,
+                          bool registered = true)
+      : underlying_allocator_(std::move(underlying_allocator)),
+        place_(place),
+        registered_(registered) {
+    if (registered_) {
+      std::lock_guard<SpinLock> lock_guard(AllocatorMapLock());
+      AllocatorMap()[place_].emplace_back(this);
+    }
+  }
+
+  ~StreamSafeAllocatorBase() override {
+    if (registered_) {
+      std::lock_guard<SpinLock> lock_guard(AllocatorMapLock());
+      std::vector<StreamSafeAllocatorBase*>& allocators =
+          AllocatorMap()[place_];
+      allocators.erase(std::remove(allocators.begin(), allocators.end(), this),
+                       allocators.end());
+    }
+  }
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  StreamSafeAllocatorStats GetStats() const {
+    StreamSafeAllocatorStats stats;
+    stats.deferred_free_count =
+        deferred_free_count_.load(std::memory_order_relaxed);
+    stats.deferred_bytes = deferred_bytes_.load(std::memory_order_relaxed);
+    stats.peak_deferred_bytes =
+        peak_deferred_bytes_.load(std::memory_order_relaxed);
+    stats.alloc_retry_count =
+        alloc_retry_count_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ protected:
+  AllocationPtr AllocateUnderlying(size_t size) {
+    ProcessUnfreedAllocations();
+    VLOG(8) << "Try allocate " << size << " bytes";
+    try {
+      return underlying_allocator_->Allocate(size);
+    } catch (BadAlloc&) {
+      VLOG(4) << "Allocation failed when allocating " << size << " bytes";
+    }
+    ReleaseImpl(place_);
+    alloc_retry_count_.fetch_add(1, std::memory_order_relaxed);
+    try {
+      return underlying_allocator_->Allocate(size);
+    } catch (...) {
+      VLOG(3)
+          << "Still allocation failed after release memory from all streams";
+      throw;
+    }
+  }
+
+  void FreeOrDefer(AllocationT* allocation) {
+    VLOG(8) << "Try free allocation " << allocation->ptr();
+    if (allocation->CanBeFreed()) {
+      VLOG(9) << "Directly delete allocation";
+      delete allocation;
+      return;
+    }
+    VLOG(9) << "Put into unfreed_allocation list";
+    size_t size = allocation->size();
+    {
+      std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
+      unfreed_allocations_.emplace_back(allocation);
+    }
+    deferred_free_count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t deferred_bytes =
+        deferred_bytes_.fetch_add(size, std::memory_order_relaxed) + size;
+    uint64_t peak = peak_deferred_bytes_.load(std::memory_order_relaxed);
+    while (deferred_bytes > peak &&
+           !peak_deferred_bytes_.compare_exchange_weak(
+               peak, deferred_bytes, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t ReleaseImpl(const phi::Place& place) override {
+    std::lock_guard<SpinLock> lock_guard(AllocatorMapLock());
+    std::vector<StreamSafeAllocatorBase*>& allocators = AllocatorMap()[place];
+    uint64_t released_size = 0;
+    for (StreamSafeAllocatorBase* allocator : allocators) {
+      released_size += allocator->ProcessUnfreedAllocationsAndRelease();
+    }
+    VLOG(8) << "Release " << released_size << " bytes memory from all streams";
+    return released_size;
+  }
+
+  void ProcessUnfreedAllocations() {
+    // NOTE(Ruibiao): This condition is to reduce lock completion. It does not
+    // need to be thread-safe since here occasional misjudgments are
+    // permissible.
+    if (unfreed_allocations_.empty()) {
+      return;
+    }
+
+    std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
+    for (auto it = unfreed_allocations_.begin();
+         it != unfreed_allocations_.end();) {
+      if ((*it)->CanBeFreed()) {
+        deferred_bytes_.fetch_sub((*it)->size(), std::memory_order_relaxed);
+        delete *it;
+        it = unfreed_allocations_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  std::shared_ptr<Allocator> underlying_allocator_;
+  phi::Place place_;
+
+ private:
+  uint64_t ProcessUnfreedAllocationsAndRelease() {
+    ProcessUnfreedAllocations();
+    return underlying_allocator_->Release(place_);
+  }
+
+  static std::map<phi::Place, std::vector<StreamSafeAllocatorBase*>>&
+  AllocatorMap() {
+    static std::map<phi::Place, std::vector<StreamSafeAllocatorBase*>>
+        allocator_map;
+    return allocator_map;
+  }
+
+  static SpinLock& AllocatorMapLock() {
+    static SpinLock allocator_map_lock;
+    return allocator_map_lock;
+  }
+
+  bool registered_;
+  std::list<AllocationT*> unfreed_allocations_;
+  SpinLock unfreed_allocation_lock_;
+
+  std::atomic<uint64_t> deferred_free_count_{0};
+  std::atomic<uint64_t> deferred_bytes_{0};
+  std::atomic<uint64_t> peak_deferred_bytes_{0};
+  std::atomic<uint64_t> alloc_retry_count_{0};
+};
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
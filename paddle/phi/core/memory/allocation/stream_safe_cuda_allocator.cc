@@ -164,26 +164,12 @@ StreamSafeCUDAAllocator::StreamSafeCUDAAllocator(
     phi::GPUPlace place,
     gpuStream_t default_stream,
     bool in_cuda_graph_capturing)
-    : underlying_allocator_(std::move(underlying_allocator)),
-      place_(place),
+    : StreamSafeAllocatorBase<StreamSafeCUDAAllocation>(
+          std::move(underlying_allocator),
+          place,
+          /*registered=*/!in_cuda_graph_capturing),
       default_stream_(default_stream),
-      in_cuda_graph_capturing_(in_cuda_graph_capturing) {
-  if (LIKELY(!in_cuda_graph_capturing)) {
-    std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-    allocator_map_[place].emplace_back(this);
-  }
-}
-
-StreamSafeCUDAAllocator::~StreamSafeCUDAAllocator() {
-  if (LIKELY(!in_cuda_graph_capturing_)) {
-    std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-    std::vector<StreamSafeCUDAAllocator*>& allocators = allocator_map_[place_];
-    allocators.erase(std::remove(allocators.begin(), allocators.end(), this),
-                     allocators.end());
-  }
-}
-
-bool StreamSafeCUDAAllocator::IsAllocThreadSafe() const { return true; }
+      in_cuda_graph_capturing_(in_cuda_graph_capturing) {}
 
 gpuStream_t StreamSafeCUDAAllocator::GetDefaultStream() const {
   return default_stream_;
@@ -197,24 +183,7 @@ phi::Allocation* StreamSafeCUDAAllocator::AllocateImpl(size_t size) {
   phi::RecordEvent record("StreamSafeCUDAAllocator::Allocate",
                           phi::TracerEventType::UserDefined,
                           9 /*level*/);
-  ProcessUnfreedAllocations();
-  VLOG(8) << "Try allocate " << size << " bytes";
-  AllocationPtr underlying_allocation;
-  try {
-    underlying_allocation = underlying_allocator_->Allocate(size);
-  } catch (BadAlloc&) {
-    VLOG(4) << "Allocation failed when allocating " << size << " bytes";
-    ReleaseImpl(place_);
-    try {
-      underlying_allocation = underlying_allocator_->Allocate(size);
-    } catch (...) {
-      VLOG(3)
-          << "Still allocation failed after release memory from all streams";
-      throw;
-    }
-  } catch (...) {
-    throw;
-  }
+  AllocationPtr underlying_allocation = AllocateUnderlying(size);
   StreamSafeCUDAAllocation* allocation = new StreamSafeCUDAAllocation(
       static_unique_ptr_cast<Allocation>(std::move(underlying_allocation)),
       default_stream_,
@@ -229,18 +198,7 @@ void StreamSafeCUDAAllocator::FreeImpl(phi::Allocation* allocation) {
   phi::RecordEvent record("StreamSafeCUDAAllocator::Free",
                           phi::TracerEventType::UserDefined,
                           9 /*level*/);
-  StreamSafeCUDAAllocation* stream_safe_cuda_allocation =
-      static_cast<StreamSafeCUDAAllocation*>(allocation);
-
-  VLOG(8) << "Try free allocation " << stream_safe_cuda_allocation->ptr();
-  if (stream_safe_cuda_allocation->CanBeFreed()) {
-    VLOG(9) << "Directly delete allocation";
-    delete stream_safe_cuda_allocation;
-  } else {
-    VLOG(9) << "Put into unfreed_allocation list";
-    std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-    unfreed_allocations_.emplace_back(stream_safe_cuda_allocation);
-  }
+  FreeOrDefer(static_cast<StreamSafeCUDAAllocation*>(allocation));
 }
 
 uint64_t StreamSafeCUDAAllocator::ReleaseImpl(const phi::Place& place) {
@@ -248,45 +206,9 @@ uint64_t StreamSafeCUDAAllocator::ReleaseImpl(const phi::Place& place) {
     VLOG(7) << "Memory release forbidden in CUDA Graph Capturing";
     return 0;
   }
-
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  std::vector<StreamSafeCUDAAllocator*>& allocators = allocator_map_[place];
-  uint64_t released_size = 0;
-  for (StreamSafeCUDAAllocator* allocator : allocators) {
-    released_size += allocator->ProcessUnfreedAllocationsAndRelease();
-  }
-  VLOG(8) << "Release " << released_size << " bytes memory from all streams";
-  return released_size;
-}
-
-void StreamSafeCUDAAllocator::ProcessUnfreedAllocations() {
-  // NOTE(Ruibiao): This condition is to reduce lock completion. It does not
-  // need to be thread-safe since here occasional misjudgments are permissible.
-  if (unfreed_allocations_.empty()) {
-    return;
-  }
-
-  std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-  for (auto it = unfreed_allocations_.begin();
-       it != unfreed_allocations_.end();) {
-    if ((*it)->CanBeFreed()) {
-      delete *it;
-      it = unfreed_allocations_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
-uint64_t StreamSafeCUDAAllocator::ProcessUnfreedAllocationsAndRelease() {
-  ProcessUnfreedAllocations();
-  return underlying_allocator_->Release(place_);
+  return StreamSafeAllocatorBase<StreamSafeCUDAAllocation>::ReleaseImpl(place);
 }
 
 thread_local std::once_flag StreamSafeCUDAAllocation::once_flag_;
 
-std::map<phi::Place, std::vector<StreamSafeCUDAAllocator*>>
-    StreamSafeCUDAAllocator::allocator_map_;
-SpinLock StreamSafeCUDAAllocator::allocator_map_lock_;
-
 }  // namespace paddle::memory::allocation
@@ -21,6 +21,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
+#include "paddle/phi/core/memory/allocation/stream_safe_allocator_base.h"
 
 #ifdef PADDLE_WITH_CUDA
 #include <cuda_runtime.h>
@@ -60,16 +61,14 @@ class StreamSafeCUDAAllocation : public Allocation {
 };
 
 class StreamSafeCUDAAllocator
-    : public Allocator,
+    : public StreamSafeAllocatorBase<StreamSafeCUDAAllocation>,
       public std::enable_shared_from_this<StreamSafeCUDAAllocator> {
  public:
   StreamSafeCUDAAllocator(std::shared_ptr<Allocator> underlying_allocator,
                           phi::GPUPlace place,
                           gpuStream_t default_stream,
                           bool in_cuda_graph_capturing = false);
-  ~StreamSafeCUDAAllocator();
 
-  bool IsAllocThreadSafe() const override;
   gpuStream_t GetDefaultStream() const;
   void SetDefaultStream(gpuStream_t stream);
 
@@ -79,19 +78,7 @@ class StreamSafeCUDAAllocator
   uint64_t ReleaseImpl(const phi::Place &place) override;
 
  private:
-  void ProcessUnfreedAllocations();
-  uint64_t ProcessUnfreedAllocationsAndRelease();
-
-  static std::map<phi::Place, std::vector<StreamSafeCUDAAllocator *>>
-      allocator_map_;
-  static SpinLock allocator_map_lock_;
-
-  std::shared_ptr<Allocator> underlying_allocator_;
-  phi::GPUPlace place_;
   gpuStream_t default_stream_;
-  std::list<StreamSafeCUDAAllocation *> unfreed_allocations_;
-  SpinLock unfreed_allocation_lock_;
-
   bool in_cuda_graph_capturing_;
 };
 
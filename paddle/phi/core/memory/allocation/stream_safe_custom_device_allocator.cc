@@ -94,20 +94,9 @@ StreamSafeCustomDeviceAllocator::StreamSafeCustomDeviceAllocator(
     std::shared_ptr<Allocator> underlying_allocator,
     phi::CustomPlace place,
     phi::stream::stream_t default_stream)
-    : underlying_allocator_(std::move(underlying_allocator)),
-      place_(std::move(place)),
-      default_stream_(std::move(default_stream)) {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  allocator_map_[place_].emplace_back(this);
-}
-
-StreamSafeCustomDeviceAllocator::~StreamSafeCustomDeviceAllocator() {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  std::vector<StreamSafeCustomDeviceAllocator*>& allocators =
-      allocator_map_[place_];
-  allocators.erase(std::remove(allocators.begin(), allocators.end(), this),
-                   allocators.end());
-}
+    : StreamSafeAllocatorBase<StreamSafeCustomDeviceAllocation>(
+          std::move(underlying_allocator), place),
+      default_stream_(std::move(default_stream)) {}
 
 phi::stream::stream_t StreamSafeCustomDeviceAllocator::GetDefaultStream()
     const {
@@ -123,24 +112,7 @@ phi::Allocation* StreamSafeCustomDeviceAllocator::AllocateImpl(size_t size) {
   phi::RecordEvent record("StreamSafeCustomDeviceAllocator::Allocate",
                           phi::TracerEventType::UserDefined,
                           9 /*level*/);
-  ProcessUnfreedAllocations();
-  VLOG(8) << "Try allocate " << size << " bytes";
-  AllocationPtr underlying_allocation;
-  try {
-    underlying_allocation = underlying_allocator_->Allocate(size);
-  } catch (BadAlloc&) {
-    VLOG(4) << "Allocation failed when allocating " << size << " bytes";
-    ReleaseImpl(place_);
-    try {
-      underlying_allocation = underlying_allocator_->Allocate(size);
-    } catch (...) {
-      VLOG(3)
-          << "Still allocation failed after release memory from all streams";
-      throw;
-    }
-  } catch (...) {
-    throw;
-  }
+  AllocationPtr underlying_allocation = AllocateUnderlying(size);
   StreamSafeCustomDeviceAllocation* allocation =
       new StreamSafeCustomDeviceAllocation(
           static_unique_ptr_cast<Allocation>(std::move(underlying_allocation)),
@@ -159,7 +131,6 @@ void StreamSafeCustomDeviceAllocator::FreeImpl(phi::Allocation* allocation) {
   StreamSafeCustomDeviceAllocation* stream_safe_cuda_allocation =
       static_cast<StreamSafeCustomDeviceAllocation*>(allocation);
 
-  VLOG(8) << "Try free allocation " << stream_safe_cuda_allocation->ptr();
   if (!stream_safe_cuda_allocation->GetOwningStream()) {
     stream_safe_cuda_allocation->SetOwningStream(
         default_stream_ ? default_stream_
@@ -167,59 +138,11 @@ void StreamSafeCustomDeviceAllocator::FreeImpl(phi::Allocation* allocation) {
                               phi::DeviceContextPool::Instance().Get(place_))
                               ->stream());
   }
-  if (stream_safe_cuda_allocation->CanBeFreed()) {
-    VLOG(9) << "Directly delete allocation";
-    delete stream_safe_cuda_allocation;
-  } else {
-    VLOG(9) << "Put into unfreed_allocation list";
-    std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-    unfreed_allocations_.emplace_back(stream_safe_cuda_allocation);
-  }
-}
-
-uint64_t StreamSafeCustomDeviceAllocator::ReleaseImpl(const phi::Place& place) {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  std::vector<StreamSafeCustomDeviceAllocator*>& allocators =
-      allocator_map_[place];
-  uint64_t released_size = 0;
-  for (StreamSafeCustomDeviceAllocator* allocator : allocators) {
-    released_size += allocator->ProcessUnfreedAllocationsAndRelease();
-  }
-  VLOG(8) << "Release " << released_size << " bytes memory from all streams";
-  return released_size;
-}
-
-void StreamSafeCustomDeviceAllocator::ProcessUnfreedAllocations() {
-  // NOTE(Ruibiao): This condition is to reduce lock completion. It does not
-  // need to be thread-safe since here occasional misjudgments are permissible.
-  if (unfreed_allocations_.empty()) {
-    return;
-  }
-
-  std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-  for (auto it = unfreed_allocations_.begin();
-       it != unfreed_allocations_.end();) {
-    if ((*it)->CanBeFreed()) {
-      delete *it;
-      it = unfreed_allocations_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
-uint64_t
-StreamSafeCustomDeviceAllocator::ProcessUnfreedAllocationsAndRelease() {
-  ProcessUnfreedAllocations();
-  return underlying_allocator_->Release(place_);
+  FreeOrDefer(stream_safe_cuda_allocation);
 }
 
 thread_local std::once_flag StreamSafeCustomDeviceAllocation::once_flag_;
 
-std::map<phi::Place, std::vector<StreamSafeCustomDeviceAllocator*>>
-    StreamSafeCustomDeviceAllocator::allocator_map_;
-SpinLock StreamSafeCustomDeviceAllocator::allocator_map_lock_;
-
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
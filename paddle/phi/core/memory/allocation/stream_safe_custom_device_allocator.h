@@ -22,6 +22,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
+#include "paddle/phi/core/memory/allocation/stream_safe_allocator_base.h"
 
 namespace paddle {
 namespace memory {
@@ -52,37 +53,22 @@ class StreamSafeCustomDeviceAllocation : public Allocation {
 };
 
 class StreamSafeCustomDeviceAllocator
-    : public Allocator,
+    : public StreamSafeAllocatorBase<StreamSafeCustomDeviceAllocation>,
       public std::enable_shared_from_this<StreamSafeCustomDeviceAllocator> {
  public:
   StreamSafeCustomDeviceAllocator(
       std::shared_ptr<Allocator> underlying_allocator,
       phi::CustomPlace place,
       phi::stream::stream_t default_stream);
-  ~StreamSafeCustomDeviceAllocator();
-
-  bool IsAllocThreadSafe() const override { return true; }
   phi::stream::stream_t GetDefaultStream() const;
   void SetDefaultStream(phi::stream::stream_t stream);
 
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
   void FreeImpl(phi::Allocation *allocation) override;
-  uint64_t ReleaseImpl(const phi::Place &place) override;
 
  private:
-  void ProcessUnfreedAllocations();
-  uint64_t ProcessUnfreedAllocationsAndRelease();
-
-  static std::map<phi::Place, std::vector<StreamSafeCustomDeviceAllocator *>>
-      allocator_map_;
-  static SpinLock allocator_map_lock_;
-
-  std::shared_ptr<Allocator> underlying_allocator_;
-  phi::CustomPlace place_;
   phi::stream::stream_t default_stream_;
-  std::list<StreamSafeCustomDeviceAllocation *> unfreed_allocations_;
-  SpinLock unfreed_allocation_lock_;
 };
 
 }  // namespace allocation
@@ -90,21 +90,9 @@ StreamSafeXPUAllocator::StreamSafeXPUAllocator(
     std::shared_ptr<Allocator> underlying_allocator,
     phi::XPUPlace place,
     XPUStream default_stream)
-    : underlying_allocator_(std::move(underlying_allocator)),
-      place_(std::move(place)),
-      default_stream_(std::move(default_stream)) {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  allocator_map_[place].emplace_back(this);
-}
-
-StreamSafeXPUAllocator::~StreamSafeXPUAllocator() {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  std::vector<StreamSafeXPUAllocator*>& allocators = allocator_map_[place_];
-  allocators.erase(std::remove(allocators.begin(), allocators.end(), this),
-                   allocators.end());
-}
-
-bool StreamSafeXPUAllocator::IsAllocThreadSafe() const { return true; }
+    : StreamSafeAllocatorBase<StreamSafeXPUAllocation>(
+          std::move(underlying_allocator), place),
+      default_stream_(std::move(default_stream)) {}
 
 XPUStream StreamSafeXPUAllocator::GetDefaultStream() const {
   return default_stream_;
@@ -118,24 +106,7 @@ phi::Allocation* StreamSafeXPUAllocator::AllocateImpl(size_t size) {
   phi::RecordEvent record("StreamSafeXPUAllocator::Allocate",
                           phi::TracerEventType::UserDefined,
                           9 /*level*/);
-  ProcessUnfreedAllocations();
-  VLOG(8) << "Try allocate " << size << " bytes";
-  AllocationPtr underlying_allocation;
-  try {
-    underlying_allocation = underlying_allocator_->Allocate(size);
-  } catch (BadAlloc&) {
-    VLOG(4) << "Allocation failed when allocating " << size << " bytes";
-    ReleaseImpl(place_);
-    try {
-      underlying_allocation = underlying_allocator_->Allocate(size);
-    } catch (...) {
-      VLOG(3)
-          << "Still allocation failed after release memory from all streams";
-      throw;
-    }
-  } catch (...) {
-    throw;
-  }
+  AllocationPtr underlying_allocation = AllocateUnderlying(size);
   StreamSafeXPUAllocation* allocation = new StreamSafeXPUAllocation(
       static_unique_ptr_cast<Allocation>(std::move(underlying_allocation)),
       default_stream_,
@@ -152,59 +123,11 @@ void StreamSafeXPUAllocator::FreeImpl(phi::Allocation* allocation) {
                           9 /*level*/);
   StreamSafeXPUAllocation* stream_safe_xpu_allocation =
       static_cast<StreamSafeXPUAllocation*>(allocation);
-
-  VLOG(8) << "Try free allocation " << stream_safe_xpu_allocation->ptr();
-  if (stream_safe_xpu_allocation->CanBeFreed()) {
-    VLOG(9) << "Directly delete allocation";
-    delete stream_safe_xpu_allocation;
-  } else {
-    VLOG(9) << "Put into unfreed_allocation list";
-    std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-    unfreed_allocations_.emplace_back(stream_safe_xpu_allocation);
-  }
-}
-
-uint64_t StreamSafeXPUAllocator::ReleaseImpl(const phi::Place& place) {
-  std::lock_guard<SpinLock> lock_guard(allocator_map_lock_);
-  std::vector<StreamSafeXPUAllocator*>& allocators = allocator_map_[place];
-  uint64_t released_size = 0;
-  for (StreamSafeXPUAllocator* allocator : allocators) {
-    released_size += allocator->ProcessUnfreedAllocationsAndRelease();
-  }
-  VLOG(8) << "Release " << released_size << " bytes memory from all streams";
-  return released_size;
-}
-
-void StreamSafeXPUAllocator::ProcessUnfreedAllocations() {
-  // NOTE(Ruibiao): This condition is to reduce lock completion. It does not
-  // need to be thread-safe since here occasional misjudgments are permissible.
-  if (unfreed_allocations_.empty()) {
-    return;
-  }
-
-  std::lock_guard<SpinLock> lock_guard(unfreed_allocation_lock_);
-  for (auto it = unfreed_allocations_.begin();
-       it != unfreed_allocations_.end();) {
-    if ((*it)->CanBeFreed()) {
-      delete *it;
-      it = unfreed_allocations_.erase(it);
-    } else {
-      ++it;
-    }
-  }
-}
-
-uint64_t StreamSafeXPUAllocator::ProcessUnfreedAllocationsAndRelease() {
-  ProcessUnfreedAllocations();
-  return underlying_allocator_->Release(place_);
+  FreeOrDefer(stream_safe_xpu_allocation);
 }
 
 thread_local std::once_flag StreamSafeXPUAllocation::once_flag_;
 
-std::map<phi::Place, std::vector<StreamSafeXPUAllocator*>>
-    StreamSafeXPUAllocator::allocator_map_;
-SpinLock StreamSafeXPUAllocator::allocator_map_lock_;
-
 }  // namespace allocation
 }  // namespace memory
 }  // namespace paddle
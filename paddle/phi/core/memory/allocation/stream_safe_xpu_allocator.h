@@ -21,6 +21,7 @@
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
+#include "paddle/phi/core/memory/allocation/stream_safe_allocator_base.h"
 
 #include "paddle/phi/backends/xpu/xpu_context.h"
 #include "paddle/phi/core/platform/device/xpu/xpu_info.h"
@@ -53,36 +54,21 @@ class StreamSafeXPUAllocation : public Allocation {
 };
 
 class StreamSafeXPUAllocator
-    : public Allocator,
+    : public StreamSafeAllocatorBase<StreamSafeXPUAllocation>,
       public std::enable_shared_from_this<StreamSafeXPUAllocator> {
  public:
   StreamSafeXPUAllocator(std::shared_ptr<Allocator> underlying_allocator,
                          phi::XPUPlace place,
                          XPUStream default_stream);
-  ~StreamSafeXPUAllocator();
-
-  bool IsAllocThreadSafe() const override;
   XPUStream GetDefaultStream() const;
   void SetDefaultStream(XPUStream stream);
 
  protected:
   phi::Allocation *AllocateImpl(size_t size) override;
   void FreeImpl(phi::Allocation *allocation) override;
-  uint64_t ReleaseImpl(const phi::Place &place) override;
 
  private:
-  void ProcessUnfreedAllocations();
-  uint64_t ProcessUnfreedAllocationsAndRelease();
-
-  static std::map<phi::Place, std::vector<StreamSafeXPUAllocator *>>
-      allocator_map_;
-  static SpinLock allocator_map_lock_;
-
-  std::shared_ptr<Allocator> underlying_allocator_;
-  phi::XPUPlace place_;
   XPUStream default_stream_;
-  std::list<StreamSafeXPUAllocation *> unfreed_allocations_;
-  SpinLock unfreed_allocation_lock_;
 };
 
 }  // namespace allocation
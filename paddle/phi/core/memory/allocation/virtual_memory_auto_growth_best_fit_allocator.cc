@@ -17,6 +17,7 @@
 #include <mutex>
 
 #include "paddle/phi/core/memory/allocation/aligned_allocator.h"
+#include "paddle/phi/core/memory/stats.h"
 
 namespace paddle {
 namespace memory {
@@ -33,6 +34,8 @@ VirtualMemoryAutoGrowthBestFitAllocator::
         const phi::GPUPlace &place)
     : underlying_allocator_(
           std::make_shared<AlignedAllocator>(underlying_allocator, alignment)),
+      page_releaser_(std::dynamic_pointer_cast<PhysicalPageReleaser>(
+          underlying_allocator)),
       alignment_(alignment),
       place_(place) {}
 
@@ -45,6 +48,7 @@ phi::Allocation *VirtualMemoryAutoGrowthBestFitAllocator::AllocateImpl(
   if (!result) {
     ExtendAndMerge(size);
     result = AllocFromFreeBlocks(size);
+    UpdateFragmentationStats();
   }
 
   return result;
@@ -58,6 +62,81 @@ void VirtualMemoryAutoGrowthBestFitAllocator::FreeImpl(
   delete allocation;
 }
 
+uint64_t VirtualMemoryAutoGrowthBestFitAllocator::ReleaseImpl(
+    const phi::Place &place) {
+  std::lock_guard<SpinLock> guard(spinlock_);
+  uint64_t released_size = 0;
+  if (page_releaser_) {
+    std::vector<std::pair<void *, size_t>> free_ranges;
+    for (auto &block : all_blocks_) {
+      if (block.is_free_) {
+        free_ranges.emplace_back(block.ptr_, block.size_);
+      }
+    }
+    auto released_ranges = page_releaser_->ReleasePhysicalPages(free_ranges);
+    for (auto &range : released_ranges) {
+      CutFreeRange(range.first, range.second);
+      released_size += range.second;
+    }
+    VLOG(1) << "Compacted the virtual memory pool on " << place_ << ", "
+            << released_size << " bytes of physical memory released";
+  }
+  UpdateFragmentationStats();
+  return released_size;
+}
+
+// The range lies inside a single free block, which is split around it.
+void VirtualMemoryAutoGrowthBestFitAllocator::CutFreeRange(void *ptr,
+                                                           size_t size) {
+  auto *begin = reinterpret_cast<uint8_t *>(ptr);
+  auto block = all_blocks_.begin();
+  while (block != all_blocks_.end() &&
+         !(block->is_free_ && block->ptr_ <= ptr &&
+           begin + size <=
+               reinterpret_cast<uint8_t *>(block->ptr_) + block->size_)) {
+    ++block;
+  }
+  PADDLE_ENFORCE_EQ(
+      block != all_blocks_.end(),
+      true,
+      common::errors::PreconditionNotMet(
+          "The released range at %p is not inside a free block.", ptr));
+
+  free_blocks_.erase(std::make_pair(block->size_, block->ptr_));
+  size_t head_size = begin - reinterpret_cast<uint8_t *>(block->ptr_);
+  size_t tail_size = block->size_ - head_size - size;
+  if (tail_size > 0) {
+    auto tail = all_blocks_.insert(std::next(block),
+                                   Block(begin + size, tail_size, true));
+    free_blocks_.emplace(std::make_pair(tail_size, tail->ptr_), tail);
+  }
+  if (head_size > 0) {
+    block->size_ = head_size;
+    free_blocks_.emplace(std::make_pair(head_size, block->ptr_), block);
+  } else {
+    all_blocks_.erase(block);
+  }
+}
+
+void VirtualMemoryAutoGrowthBestFitAllocator::UpdateFragmentationStats() {
+  int64_t free_size = 0;
+  for (auto &item : free_blocks_) {
+    free_size += static_cast<int64_t>(item.first.first);
+  }
+  int64_t largest_free_size =
+      free_blocks_.empty()
+          ? 0
+          : static_cast<int64_t>(free_blocks_.rbegin()->first.first);
+  int dev_id = place_.GetDeviceId();
+  DEVICE_MEMORY_STAT_UPDATE(
+      VirtualMemoryFree, dev_id, free_size - reported_free_size_);
+  DEVICE_MEMORY_STAT_UPDATE(VirtualMemoryLargestFree,
+                            dev_id,
+                            largest_free_size - reported_largest_free_size_);
+  reported_free_size_ = free_size;
+  reported_largest_free_size_ = largest_free_size;
+}
+
 void VirtualMemoryAutoGrowthBestFitAllocator::TryMergeBlock2Blocks(
     std::list<Block>::iterator block) {
   if (block->ptr_ == all_blocks_.front().ptr_ &&
@@ -164,7 +243,7 @@ void VirtualMemoryAutoGrowthBestFitAllocator::ExtendAndMerge(size_t size) {
                                block_it);
         } else {
           // do not merge
-          all_blocks_.emplace_back(ptr, size, true);
+          all_blocks_.emplace_front(ptr, size, true);
           free_blocks_.emplace(std::make_pair(size, ptr), all_blocks_.begin());
         }
       } else {
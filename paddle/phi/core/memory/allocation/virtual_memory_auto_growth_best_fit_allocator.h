@@ -17,6 +17,8 @@
 #include <list>
 #include <map>
 #include <set>
+#include <utility>
+#include <vector>
 
 #include "paddle/phi/core/memory/allocation/allocator.h"
 #include "paddle/phi/core/memory/allocation/spin_lock.h"
@@ -42,6 +44,19 @@ struct BlockAllocation : public Allocation {
   std::list<Block>::iterator block_it_;
 };
 
+// Implemented by underlying allocators that back their chunks with physical
+// pages which can be unmapped one by one, see CUDAVirtualMemAllocator.
+class PhysicalPageReleaser {
+ public:
+  virtual ~PhysicalPageReleaser() = default;
+
+  // Unmaps and frees the physical pages lying fully inside the given ranges,
+  // which must not be accessed by any pending work. Returns the released
+  // address ranges sorted by address.
+  virtual std::vector<std::pair<void *, size_t>> ReleasePhysicalPages(
+      const std::vector<std::pair<void *, size_t>> &ranges) = 0;
+};
+
 /**
  * Like AutoGrowthBestFitAllocator, VirtualMemoryAutoGrowthBestFitAllocator will
  * gradually apply to GPU for video memory as the model uses more video memory.
@@ -50,6 +65,14 @@ struct BlockAllocation : public Allocation {
  * address. If the video memory applied for twice is continuous, we can combine
  * the two video memories later. This combination can greatly reduce
  * fragmentation.
+ *
+ * If the underlying allocator is a PhysicalPageReleaser, Release compacts the
+ * pool: the physical pages behind free blocks are given back and the holes
+ * left in the address space are cut out of the blocks. The next growth maps
+ * new pages, possibly into those holes, so long running jobs whose free
+ * memory is scattered in small blocks can still get large contiguous ranges.
+ * Release is called by paddle.device.cuda.empty_cache and on OOM by the
+ * stream safe allocator, both after the pending frees are synchronized.
  */
 class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
  public:
@@ -65,12 +88,18 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
 
   void FreeImpl(phi::Allocation *allocation) override;
 
+  uint64_t ReleaseImpl(const phi::Place &place) override;
+
  private:
   phi::Allocation *AllocFromFreeBlocks(size_t size);
   void ExtendAndMerge(size_t size);
   void TryMergeBlock2Blocks(std::list<Block>::iterator iter);
+  void CutFreeRange(void *ptr, size_t size);
+  void UpdateFragmentationStats();
 
   std::shared_ptr<Allocator> underlying_allocator_;
+  // null if the underlying allocator can not release pages
+  std::shared_ptr<PhysicalPageReleaser> page_releaser_;
   size_t alignment_;
 
   std::map<std::pair<size_t, void *>, std::list<Block>::iterator> free_blocks_;
@@ -78,6 +107,10 @@ class VirtualMemoryAutoGrowthBestFitAllocator : public Allocator {
   std::list<AllocationPtr> allocations_;
   phi::Place place_;
   SpinLock spinlock_;
+
+  // values last added to the device memory stats by this allocator
+  int64_t reported_free_size_{0};
+  int64_t reported_largest_free_size_{0};
 };
 
 }  // namespace allocation
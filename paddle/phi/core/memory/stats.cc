@@ -163,9 +163,15 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name) {
 int RegisterAllStats() {
   DEVICE_MEMORY_STAT_REGISTER(Allocated);
   DEVICE_MEMORY_STAT_REGISTER(Reserved);
+  DEVICE_MEMORY_STAT_REGISTER(SizeClassCached);
+  DEVICE_MEMORY_STAT_REGISTER(AllocatorLockContention);
+  DEVICE_MEMORY_STAT_REGISTER(VirtualMemoryFree);
+  DEVICE_MEMORY_STAT_REGISTER(VirtualMemoryLargestFree);
 
   HOST_MEMORY_STAT_REGISTER(Allocated);
   HOST_MEMORY_STAT_REGISTER(Reserved);
+  HOST_MEMORY_STAT_REGISTER(SizeClassCached);
+  HOST_MEMORY_STAT_REGISTER(AllocatorLockContention);
   return 0;
 }
 
@@ -228,9 +228,15 @@ void LogDeviceMemoryStats(const phi::Place& place, const std::string& op_name);
 // To add a new STAT type, declare here and register in stats.cc
 DEVICE_MEMORY_STAT_DECLARE(Allocated);
 DEVICE_MEMORY_STAT_DECLARE(Reserved);
+DEVICE_MEMORY_STAT_DECLARE(SizeClassCached);
+DEVICE_MEMORY_STAT_DECLARE(AllocatorLockContention);
+DEVICE_MEMORY_STAT_DECLARE(VirtualMemoryFree);
+DEVICE_MEMORY_STAT_DECLARE(VirtualMemoryLargestFree);
 
 HOST_MEMORY_STAT_DECLARE(Allocated);
 HOST_MEMORY_STAT_DECLARE(Reserved);
+HOST_MEMORY_STAT_DECLARE(SizeClassCached);
+HOST_MEMORY_STAT_DECLARE(AllocatorLockContention);
 
 }  // namespace memory
 }  // namespace paddle
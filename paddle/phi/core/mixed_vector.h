@@ -261,9 +261,8 @@ class MixVector {
  public:
   // implicit cast from std::vector.
   template <typename U>
-  MixVector(const std::vector<U> *dat) {  // NOLINT
-    m_.reset(new VectorData(const_cast<std::vector<U> *>(dat)));
-  }
+  MixVector(const std::vector<U> *dat)  // NOLINT
+      : cpu_(const_cast<std::vector<U> *>(dat)) {}
 
   // Copy ctor
   MixVector(const MixVector<T> &other) = delete;
@@ -275,66 +274,92 @@ class MixVector {
   MixVector(MixVector<T> &&other) = delete;
 
   // CPU data access method. Mutable.
-  T &operator[](size_t i) { return (*m_)[i]; }
+  T &operator[](size_t i) { return m_ ? (*m_)[i] : (*cpu_)[i]; }
 
   // CPU data access method. Immutable.
-  const T &operator[](size_t i) const { return (*m_)[i]; }
+  const T &operator[](size_t i) const { return m_ ? (*m_)[i] : (*cpu_)[i]; }
 
   // std::vector iterator methods. Based on CPU data access method
-  size_t size() const { return m_->size(); }
+  size_t size() const { return cpu_->size(); }
 
-  iterator begin() { return m_->begin(); }
+  iterator begin() { return m_ ? m_->begin() : cpu_->begin(); }
 
-  iterator end() { return m_->end(); }
+  iterator end() { return m_ ? m_->end() : cpu_->end(); }
 
-  T &front() { return m_->front(); }
+  T &front() { return m_ ? m_->front() : cpu_->front(); }
 
-  T &back() { return m_->back(); }
+  T &back() { return m_ ? m_->back() : cpu_->back(); }
 
-  const_iterator begin() const { return m_->begin(); }
+  const_iterator begin() const {
+    return m_ ? m_->begin() : const_iterator(cpu_->begin());
+  }
 
-  const_iterator end() const { return m_->end(); }
+  const_iterator end() const {
+    return m_ ? m_->end() : const_iterator(cpu_->end());
+  }
 
   const_iterator cbegin() const { return begin(); }
 
   const_iterator cend() const { return end(); }
 
-  const T &back() const { return m_->back(); }
+  const T &back() const { return m_ ? m_->back() : cpu_->back(); }
 
-  T *data() { return m_->data(); }
+  T *data() { return cpu_->data(); }
 
-  const T *data() const { return m_->data(); }
+  const T *data() const { return cpu_->data(); }
 
-  const T &front() const { return m_->front(); }
+  const T &front() const { return m_ ? m_->front() : cpu_->front(); }
   // end of std::vector iterator methods
 
   // assign this from iterator.
   // NOTE: the iterator must support `end-begin`
   template <typename Iter>
   void assign(Iter begin, Iter end) {
-    m_->assign(begin, end);
+    if (m_) {
+      m_->assign(begin, end);
+    } else {
+      cpu_->assign(begin, end);
+    }
   }
 
   // push_back. If the previous capacity is not enough, the memory will
   // double.
-  void push_back(T elem) { m_->push_back(elem); }
+  void push_back(T elem) {
+    if (m_) {
+      m_->push_back(elem);
+    } else {
+      cpu_->push_back(elem);
+    }
+  }
 
   // extend a vector by iterator.
   // NOTE: the iterator must support end-begin
   template <typename It>
   void Extend(It begin, It end) {
-    m_->Extend(begin, end);
+    if (m_) {
+      m_->Extend(begin, end);
+    } else {
+      cpu_->insert(cpu_->end(), begin, end);
+    }
   }
 
   // resize the vector
   void resize(size_t size) {
-    if (m_->size() != size) {
+    if (cpu_->size() == size) {
+      return;
+    }
+    if (m_) {
       m_->resize(size);
+    } else {
+      cpu_->resize(size);
     }
   }
 
   // get cuda ptr. immutable
   const T *CUDAData(phi::Place place) const {
+    if (!m_) {
+      m_.reset(new VectorData(cpu_));
+    }
     {
       phi::GPUPlace p(place.GetDeviceId());
       auto &mtx = m_->Mutex();
@@ -351,6 +376,9 @@ class MixVector {
 
   // get cuda ptr. mutable
   T *CUDAMutableData(phi::Place place) {
+    if (!m_) {
+      m_.reset(new VectorData(cpu_));
+    }
     {
       phi::GPUPlace p(place.GetDeviceId());
       auto &mtx = m_->Mutex();
@@ -366,12 +394,18 @@ class MixVector {
   }
 
   // clear
-  void clear() { m_->clear(); }
+  void clear() {
+    if (m_) {
+      m_->clear();
+    } else {
+      cpu_->clear();
+    }
+  }
 
-  size_t capacity() const { return m_->capacity(); }
+  size_t capacity() const { return cpu_->capacity(); }
 
   // reserve data
-  void reserve(size_t size) { m_->reserve(size); }
+  void reserve(size_t size) { cpu_->reserve(size); }
 
   // the unify method to access CPU or CUDA data. immutable.
   const T *Data(phi::Place place) const {
@@ -391,11 +425,20 @@ class MixVector {
     }
   }
 
-  void CopyToCPU() { m_->MutableCPU(); }
+  void CopyToCPU() {
+    if (m_) {
+      m_->MutableCPU();
+    }
+  }
 
+  // nullptr until the data has been visited from a device
   const void *Handle() const { return m_.get(); }
 
  private:
+  std::vector<T> *cpu_;
+  // The device sync state is only built on the first CUDA access, so a
+  // MixVector that stays on the host wraps the std::vector without any
+  // allocation, lock or flag checks.
   mutable std::unique_ptr<VectorData> m_;
 };
 
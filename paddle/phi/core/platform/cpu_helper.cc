@@ -14,6 +14,15 @@ limitations under the License. */
 
 #include "paddle/phi/core/platform/cpu_helper.h"
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#endif
+
 #ifdef PADDLE_WITH_MKLML
 #include <omp.h>
 
@@ -56,4 +65,92 @@ void SetNumThreads(int num_threads) {
 #endif
 }
 
+#ifdef __linux__
+namespace {
+
+constexpr char kNumaNodeDir[] = "/sys/devices/system/node/node";
+
+// Parses a cpu list of the kernel, e.g. 0-15,32-47.
+std::vector<int> ParseCpuList(const std::string& list) {
+  std::vector<int> cpus;
+  std::stringstream ss(list);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty()) continue;
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first
+                                         : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+bool BindCurrentThread(const cpu_set_t& mask) {
+  return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+}
+
+}  // namespace
+#endif
+
+int GetNumaNodeCount() {
+#ifdef __linux__
+  int count = 0;
+  while (std::ifstream(kNumaNodeDir + std::to_string(count) + "/cpulist")
+             .good()) {
+    ++count;
+  }
+  return count > 0 ? count : 1;
+#else
+  return 1;
+#endif
+}
+
+std::vector<int> GetNumaNodeCpus(int node) {
+#ifdef __linux__
+  std::ifstream file(kNumaNodeDir + std::to_string(node) + "/cpulist");
+  std::string list;
+  if (!file.is_open() || !std::getline(file, list)) {
+    return {};
+  }
+  return ParseCpuList(list);
+#else
+  return {};
+#endif
+}
+
+void BindToNumaNode(int node, int num_threads) {
+#ifdef __linux__
+  // the binding of a thread outlives the run, skip the syscalls per run
+  thread_local int bound_node = -1;
+  thread_local int bound_num_threads = 0;
+  if (node < 0 || (node == bound_node && num_threads == bound_num_threads)) {
+    return;
+  }
+  std::vector<int> cpus = GetNumaNodeCpus(node);
+  if (cpus.empty()) {
+    return;
+  }
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &mask);
+  }
+  if (!BindCurrentThread(mask)) {
+    return;
+  }
+#ifdef PADDLE_WITH_MKLML
+  // bind the team of the calling thread, threads of the OpenMP pool keep the
+  // affinity set here for the next parallel regions of the same size
+  int real_num_threads = num_threads > 1 ? num_threads : 1;
+#pragma omp parallel num_threads(real_num_threads)
+  { BindCurrentThread(mask); }
+#endif
+  bound_node = node;
+  bound_num_threads = num_threads;
+#endif
+}
+
 }  // namespace paddle::platform
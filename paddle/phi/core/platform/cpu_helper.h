@@ -16,11 +16,24 @@ limitations under the License. */
 
 #include <stddef.h>
 
+#include <vector>
+
 namespace paddle {
 namespace platform {
 
 //! Set the number of threads in use.
 void SetNumThreads(int num_threads);
 
+//! Get the number of NUMA nodes of the host, 1 if it is unknown.
+int GetNumaNodeCount();
+
+//! Get the cpus of a NUMA node, empty if it is unknown.
+std::vector<int> GetNumaNodeCpus(int node);
+
+//! Bind the calling thread, and the team of num_threads OpenMP threads it
+//! runs the math library and oneDNN kernels on, to the cpus of a NUMA node.
+//! Memory they touch first is then allocated on the node.
+void BindToNumaNode(int node, int num_threads);
+
 }  // namespace platform
 }  // namespace paddle
@@ -14,12 +14,16 @@
 
 #include "paddle/phi/core/vocab/string_array.h"
 #include <utf8proc.h>
+#include <algorithm>
 #include <exception>
+#include <map>
 #include "glog/logging.h"
 
 namespace phi {
 
-std::wstring_convert<std::codecvt_utf8<wchar_t>> kConverter;
+// wstring_convert keeps conversion state, so every thread gets its own, as
+// faster_tokenizer converts the strings of a batch in parallel.
+thread_local std::wstring_convert<std::codecvt_utf8<wchar_t>> kConverter;
 
 // Convert the std::string type to the std::wstring type.
 bool ConvertStrToWstr(const std::string& src, std::wstring* res) {
@@ -37,6 +41,83 @@ void ConvertWstrToStr(const std::wstring& src, std::string* res) {
   *res = kConverter.to_bytes(src);
 }
 
+VocabTrie::VocabTrie(
+    const std::unordered_map<std::wstring, std::int32_t>& tokens) {
+  std::vector<std::map<wchar_t, int>> children(1);
+  std::vector<std::int32_t> token_ids(1, -1);
+  for (const auto& token : tokens) {
+    int node = kRoot;
+    for (wchar_t ch : token.first) {
+      auto it = children[node].find(ch);
+      if (it != children[node].end()) {
+        node = it->second;
+        continue;
+      }
+      int child = static_cast<int>(children.size());
+      children[node].emplace(ch, child);
+      children.emplace_back();
+      token_ids.push_back(-1);
+      node = child;
+    }
+    token_ids[node] = token.second;
+  }
+  nodes_.resize(children.size());
+  for (size_t node = 0; node < children.size(); ++node) {
+    nodes_[node].edge_begin = static_cast<uint32_t>(edge_chars_.size());
+    for (const auto& edge : children[node]) {
+      edge_chars_.push_back(edge.first);
+      edge_children_.push_back(edge.second);
+    }
+    nodes_[node].edge_end = static_cast<uint32_t>(edge_chars_.size());
+    nodes_[node].token_id = token_ids[node];
+  }
+}
+
+int VocabTrie::Child(int node, wchar_t ch) const {
+  auto begin = edge_chars_.begin() + nodes_[node].edge_begin;
+  auto end = edge_chars_.begin() + nodes_[node].edge_end;
+  auto it = std::lower_bound(begin, end, ch);
+  if (it == end || *it != ch) {
+    return -1;
+  }
+  return edge_children_[it - edge_chars_.begin()];
+}
+
+int VocabTrie::Walk(int node, const wchar_t* str, size_t len) const {
+  for (size_t i = 0; i < len && node >= 0; ++i) {
+    node = Child(node, str[i]);
+  }
+  return node;
+}
+
+size_t VocabTrie::LongestPrefix(int node,
+                                const wchar_t* str,
+                                size_t len,
+                                std::int32_t* token_id) const {
+  size_t matched = 0;
+  for (size_t i = 0; i < len; ++i) {
+    node = Child(node, str[i]);
+    if (node < 0) {
+      break;
+    }
+    if (nodes_[node].token_id >= 0) {
+      matched = i + 1;
+      *token_id = nodes_[node].token_id;
+    }
+  }
+  return matched;
+}
+
+std::shared_ptr<const VocabTrie> Vocab::trie() const {
+  auto trie = std::atomic_load(&trie_);
+  if (trie == nullptr) {
+    // concurrent first calls may each build one, the last store wins
+    trie = std::make_shared<const VocabTrie>(data_);
+    std::atomic_store(&trie_, trie);
+  }
+  return trie;
+}
+
 // Normalization Form Canonical Decomposition.
 void NFD(const std::string& s, std::string* ret) {
   *ret = "";
@@ -17,6 +17,7 @@
 #include <codecvt>
 #include <iostream>
 #include <locale>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -30,6 +31,40 @@ struct PhiVectorType<std::string> {
   const char* type_name = "PhiVectorString";
 };
 
+// Prefix tree of the vocab tokens, for WordPiece to find the longest token at
+// a position in one walk instead of hashing every candidate substring. The
+// children of a node are a run of edges sorted by character.
+class VocabTrie {
+ public:
+  static constexpr int kRoot = 0;
+
+  explicit VocabTrie(
+      const std::unordered_map<std::wstring, std::int32_t>& tokens);
+
+  // node reached from node by the chars of [str, str + len), -1 if none
+  int Walk(int node, const wchar_t* str, size_t len) const;
+
+  // Length of the longest token that continues the path of node and prefixes
+  // [str, str + len), with its id in *token_id. 0 when there is none.
+  size_t LongestPrefix(int node,
+                       const wchar_t* str,
+                       size_t len,
+                       std::int32_t* token_id) const;
+
+ private:
+  struct Node {
+    uint32_t edge_begin;
+    uint32_t edge_end;
+    std::int32_t token_id;  // -1 when no token ends here
+  };
+
+  int Child(int node, wchar_t ch) const;
+
+  std::vector<Node> nodes_;
+  std::vector<wchar_t> edge_chars_;
+  std::vector<std::int32_t> edge_children_;
+};
+
 // Note(YuanRisheng): Vocab is mainly used for faster_tokenizer_op and we don't
 // recommend widely use it. Because faster_tokenizer_op may be deleted in the
 // future and this class will be deleted.
@@ -50,6 +85,7 @@ class Vocab : public phi::ExtendedTensor,
   Vocab& operator=(
       const std::unordered_map<std::wstring, std::int32_t>& other) {
     this->data_ = other;
+    this->trie_.reset();
     return *this;
   }
 
@@ -63,12 +99,19 @@ class Vocab : public phi::ExtendedTensor,
 
   size_t size() const { return data_.size(); }
 
-  void clear() { data_.clear(); }
+  void clear() {
+    data_.clear();
+    trie_.reset();
+  }
 
   void emplace(const std::wstring& key, std::int32_t value) {
     data_.emplace(key, value);
+    trie_.reset();
   }
 
+  /// \brief Returns the prefix tree of the tokens, built on first use.
+  std::shared_ptr<const VocabTrie> trie() const;
+
   std::int32_t at(const std::wstring& key) { return data_.at(key); }
 
   std::int32_t at(const std::wstring& key) const { return data_.at(key); }
@@ -101,6 +144,7 @@ class Vocab : public phi::ExtendedTensor,
 
  private:
   std::unordered_map<std::wstring, std::int32_t> data_;
+  mutable std::shared_ptr<const VocabTrie> trie_;
 };
 
 // Note(YuanRisheng): PhiVector is essentially a vector that only used for PHI
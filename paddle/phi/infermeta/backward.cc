@@ -1185,6 +1185,31 @@ void MeshgridGradInferMeta(const std::vector<const MetaTensor*>& inputs,
   }
 }
 
+void MoeGateDispatchGradInferMeta(const MetaTensor& combine_weights,
+                                  const MetaTensor& scatter_index,
+                                  const MetaTensor& expert_id,
+                                  const MetaTensor& y_grad,
+                                  const MetaTensor& combine_weights_grad,
+                                  int64_t k,
+                                  int64_t capacity,
+                                  bool use_pad,
+                                  MetaTensor* x_grad,
+                                  MetaTensor* gate_logits_grad) {
+  auto y_grad_dims = y_grad.dims();
+  PADDLE_ENFORCE_EQ(y_grad_dims.size(),
+                    3,
+                    common::errors::InvalidArgument(
+                        "The y_grad of moe_gate_dispatch_grad should be a 3-D "
+                        "tensor [num_experts, capacity, hidden_size], but got "
+                        "%d-D.",
+                        y_grad_dims.size()));
+  int64_t num_tokens = combine_weights.dims()[0];
+  x_grad->set_dims({num_tokens, y_grad_dims[2]});
+  x_grad->set_dtype(y_grad.dtype());
+  gate_logits_grad->set_dims({num_tokens, y_grad_dims[0]});
+  gate_logits_grad->set_dtype(DataType::FLOAT32);
+}
+
 void MultiDotGradInferMeta(const std::vector<const MetaTensor*>& x,
                            const MetaTensor& out_grad,
                            std::vector<MetaTensor*> x_grad) {
@@ -100,6 +100,52 @@ void AllValueCompareInferMeta(const MetaTensor& x,
   out->set_dtype(DataType::BOOL);
 }
 
+void AllGatherMatmulInferMeta(const MetaTensor& x,
+                              const MetaTensor& y,
+                              bool transpose_y,
+                              int nranks,
+                              MetaTensor* out,
+                              MetaTensor* x_gathered) {
+  auto x_dims = x.dims();
+  auto y_dims = y.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input(X) of AllGatherMatmul should be at least "
+                        "2-D, but received X's dimension is [%s].",
+                        x_dims));
+  PADDLE_ENFORCE_EQ(y_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input(Y) of AllGatherMatmul should be 2-D, but "
+                        "received Y's dimension is [%s].",
+                        y_dims));
+  const int64_t k = transpose_y ? y_dims[1] : y_dims[0];
+  const int64_t n = transpose_y ? y_dims[0] : y_dims[1];
+  if (x_dims[x_dims.size() - 1] > 0 && k > 0) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[x_dims.size() - 1],
+        k,
+        common::errors::InvalidArgument(
+            "The last dimension of X (%d) should be equal to the reduced "
+            "dimension of Y (%d).",
+            x_dims[x_dims.size() - 1],
+            k));
+  }
+
+  auto gathered_dims = x_dims;
+  gathered_dims[0] = x_dims[0] < 0 ? -1 : x_dims[0] * nranks;
+  x_gathered->set_dims(gathered_dims);
+  x_gathered->set_dtype(x.dtype());
+  x_gathered->set_layout(x.layout());
+
+  auto out_dims = gathered_dims;
+  out_dims[out_dims.size() - 1] = n;
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
 void KLDivInferMeta(const MetaTensor& x,
                     const MetaTensor& label,
                     const std::string& reduction,
@@ -489,9 +535,9 @@ void CompareRawInferMeta(const MetaTensor& x,
   } else {
     int max_dim = std::max(dim_x.size(), dim_y.size());
     int axis = std::abs(dim_x.size() - dim_y.size());
-    std::vector<int> x_dims_array(max_dim);
-    std::vector<int> y_dims_array(max_dim);
-    std::vector<int> out_dims_array(max_dim);
+    common::SmallShape<int> x_dims_array(max_dim);
+    common::SmallShape<int> y_dims_array(max_dim);
+    common::SmallShape<int> out_dims_array(max_dim);
     funcs::GetBroadcastDimsArrays(dim_x,
                                   dim_y,
                                   x_dims_array.data(),
@@ -544,9 +590,9 @@ void ComplexInferMeta(const MetaTensor& x,
 
     // start align axis
     int axis = std::abs(x_dims.size() - y_dims.size());
-    std::vector<int> x_dims_array(max_dim);
-    std::vector<int> y_dims_array(max_dim);
-    std::vector<int> out_dims_array(max_dim);
+    common::SmallShape<int> x_dims_array(max_dim);
+    common::SmallShape<int> y_dims_array(max_dim);
+    common::SmallShape<int> out_dims_array(max_dim);
     phi::funcs::GetBroadcastDimsArrays(x_dims,
                                        y_dims,
                                        x_dims_array.data(),
@@ -1692,9 +1738,9 @@ void ElementwiseRawInferMeta(const MetaTensor& x,
                           axis));
     axis = (axis < 0 ? (std::abs(x_dims.size() - y_dims.size()) + axis + 1)
                      : axis);
-    std::vector<int> x_dims_array(max_dim);
-    std::vector<int> y_dims_array(max_dim);
-    std::vector<int> out_dims_array(max_dim);
+    common::SmallShape<int> x_dims_array(max_dim);
+    common::SmallShape<int> y_dims_array(max_dim);
+    common::SmallShape<int> out_dims_array(max_dim);
 
 #ifdef PADDLE_WITH_DNNL
     bool should_rotate =
@@ -1705,8 +1751,8 @@ void ElementwiseRawInferMeta(const MetaTensor& x,
     if (should_rotate) {
       // Pick bigger shape and rotate this one
       bool x_over_y = (common::product(x_dims) > common::product(y_dims));
-      auto vdims = x_over_y ? common::vectorize<int>(x_dims)
-                            : common::vectorize<int>(y_dims);
+      auto vdims = x_over_y ? common::small_vectorize<int>(x_dims)
+                            : common::small_vectorize<int>(y_dims);
       std::rotate(vdims.begin() + 1, vdims.begin() + 2, vdims.end());
       if (x_over_y) {
         x_dims = common::make_ddim(vdims);
@@ -2971,6 +3017,53 @@ void MatmulInferMeta(const MetaTensor& x,
   out->share_lod(x);
 }
 
+void MatmulReduceScatterInferMeta(const MetaTensor& x,
+                                  const MetaTensor& y,
+                                  bool transpose_y,
+                                  int nranks,
+                                  MetaTensor* out) {
+  auto x_dims = x.dims();
+  auto y_dims = y.dims();
+  PADDLE_ENFORCE_GE(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input(X) of MatmulReduceScatter should be at "
+                        "least 2-D, but received X's dimension is [%s].",
+                        x_dims));
+  PADDLE_ENFORCE_EQ(y_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input(Y) of MatmulReduceScatter should be 2-D, "
+                        "but received Y's dimension is [%s].",
+                        y_dims));
+  const int64_t k = transpose_y ? y_dims[1] : y_dims[0];
+  const int64_t n = transpose_y ? y_dims[0] : y_dims[1];
+  if (x_dims[x_dims.size() - 1] > 0 && k > 0) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[x_dims.size() - 1],
+        k,
+        common::errors::InvalidArgument(
+            "The last dimension of X (%d) should be equal to the reduced "
+            "dimension of Y (%d).",
+            x_dims[x_dims.size() - 1],
+            k));
+  }
+
+  auto out_dims = x_dims;
+  if (out_dims[0] > 0) {
+    PADDLE_ENFORCE_EQ(
+        out_dims[0] % nranks,
+        0,
+        common::errors::InvalidArgument(
+            "dim[0] (%d) is not divisible by nranks(%d)", out_dims[0], nranks));
+    out_dims[0] /= nranks;
+  }
+  out_dims[out_dims.size() - 1] = n;
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->set_layout(x.layout());
+}
+
 void MatmulWithFlattenInferMeta(const MetaTensor& x,
                                 const MetaTensor& y,
                                 int x_num_col_dims,
@@ -3161,6 +3254,78 @@ void MatrixRankTolInferMeta(const MetaTensor& x,
   out->share_lod(x);
 }
 
+void MoeGateDispatchInferMeta(const MetaTensor& x,
+                              const MetaTensor& gate_logits,
+                              int64_t k,
+                              int64_t capacity,
+                              bool use_pad,
+                              MetaTensor* y,
+                              MetaTensor* combine_weights,
+                              MetaTensor* scatter_index,
+                              MetaTensor* expert_offset,
+                              MetaTensor* expert_id) {
+  auto x_dims = x.dims();
+  auto gate_dims = gate_logits.dims();
+  PADDLE_ENFORCE_EQ(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input x of moe_gate_dispatch should be a 2-D "
+                        "tensor [tokens, hidden_size], but got %d-D.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(gate_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input gate_logits of moe_gate_dispatch should be "
+                        "a 2-D tensor [tokens, num_experts], but got %d-D.",
+                        gate_dims.size()));
+  if (x_dims[0] > 0 && gate_dims[0] > 0) {
+    PADDLE_ENFORCE_EQ(
+        x_dims[0],
+        gate_dims[0],
+        common::errors::InvalidArgument(
+            "The number of tokens of x (%d) and gate_logits (%d) of "
+            "moe_gate_dispatch should be equal.",
+            x_dims[0],
+            gate_dims[0]));
+  }
+  PADDLE_ENFORCE_EQ(
+      gate_logits.dtype(),
+      DataType::FLOAT32,
+      common::errors::InvalidArgument(
+          "The gate_logits of moe_gate_dispatch should be float32."));
+  PADDLE_ENFORCE_EQ(
+      k > 0 && (gate_dims[1] < 0 || k <= gate_dims[1]),
+      true,
+      common::errors::InvalidArgument(
+          "The k of moe_gate_dispatch should be in [1, num_experts], but "
+          "got k = %d and num_experts = %d.",
+          k,
+          gate_dims[1]));
+  PADDLE_ENFORCE_GT(capacity,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The capacity of moe_gate_dispatch should be greater "
+                        "than 0, but got %d.",
+                        capacity));
+  PADDLE_ENFORCE_EQ(use_pad,
+                    true,
+                    common::errors::Unimplemented(
+                        "moe_gate_dispatch only supports use_pad = true."));
+
+  int64_t num_tokens = x_dims[0];
+  int64_t num_experts = gate_dims[1];
+  y->set_dims({num_experts, capacity, x_dims[1]});
+  y->set_dtype(x.dtype());
+  combine_weights->set_dims({num_tokens, k});
+  combine_weights->set_dtype(DataType::FLOAT32);
+  scatter_index->set_dims({k, num_tokens});
+  scatter_index->set_dtype(DataType::INT32);
+  expert_offset->set_dims({num_experts});
+  expert_offset->set_dtype(DataType::INT64);
+  expert_id->set_dims({num_tokens, k});
+  expert_id->set_dtype(DataType::INT32);
+}
+
 void MulticlassNmsv1InferMeta(const MetaTensor& bboxes,
                               const MetaTensor& scores,
                               float score_threshold,
@@ -39,6 +39,13 @@ void AllValueCompareInferMeta(const MetaTensor& x,
                               MetaTensor* out,
                               MetaConfig config = MetaConfig());
 
+void AllGatherMatmulInferMeta(const MetaTensor& x,
+                              const MetaTensor& y,
+                              bool transpose_y,
+                              int nranks,
+                              MetaTensor* out,
+                              MetaTensor* x_gathered);
+
 void KLDivInferMeta(const MetaTensor& x,
                     const MetaTensor& label,
                     const std::string& reduction,
@@ -536,6 +543,12 @@ void MatmulInferMeta(const MetaTensor& x,
                      bool trans_y,
                      MetaTensor* out);
 
+void MatmulReduceScatterInferMeta(const MetaTensor& x,
+                                  const MetaTensor& y,
+                                  bool transpose_y,
+                                  int nranks,
+                                  MetaTensor* out);
+
 void MatmulWithFlattenInferMeta(const MetaTensor& x,
                                 const MetaTensor& y,
                                 int x_num_col_dims,
@@ -569,6 +582,17 @@ void MatrixRankTolInferMeta(const MetaTensor& x,
                             bool hermitian,
                             MetaTensor* out);
 
+void MoeGateDispatchInferMeta(const MetaTensor& x,
+                              const MetaTensor& gate_logits,
+                              int64_t k,
+                              int64_t capacity,
+                              bool use_pad,
+                              MetaTensor* y,
+                              MetaTensor* combine_weights,
+                              MetaTensor* scatter_index,
+                              MetaTensor* expert_offset,
+                              MetaTensor* expert_id);
+
 void MulticlassNmsv1InferMeta(const MetaTensor& b_boxes,
                               const MetaTensor& scores,
                               float score_threshold,
@@ -15,6 +15,7 @@ limitations under the License. */
 #include "paddle/phi/infermeta/fusion.h"
 #include <unordered_set>
 #include <vector>
+#include "paddle/common/flags.h"
 #include "paddle/common/layout.h"
 #include "paddle/phi/common/scalar.h"
 #include "paddle/phi/core/infermeta_utils.h"
@@ -26,6 +27,8 @@ limitations under the License. */
 #include "paddle/phi/kernels/funcs/fused_elemwise_activation_functor.h"
 #include "paddle/phi/kernels/funcs/strided_slice.h"
 
+COMMON_DECLARE_bool(fused_dropout_bitpack_mask);
+
 namespace phi {
 
 static phi::DDim BroadCastInferShape(const DDim x_dims,
@@ -1298,7 +1301,15 @@ void FusedBiasDropoutResidualLnInferMeta(
   }
   bias_dropout_residual_out->set_dims(x.dims());
   if (is_test == false) {
-    dropout_mask_out->set_dims(x.dims());
+    if (FLAGS_fused_dropout_bitpack_mask) {
+      // 8 mask elements per byte, see PackDropoutMask
+      dropout_mask_out->set_dims(
+          {common::contain_unknown_dim(x_dim)
+               ? -1
+               : (common::product(x_dim) + 7) / 8});
+    } else {
+      dropout_mask_out->set_dims(x.dims());
+    }
   }
   ln_mean->set_dims({left});
   ln_variance->set_dims({left});
@@ -3213,6 +3224,172 @@ void FusionTransposeFlattenConcatInferMeta(
   out->set_dtype((*x[0]).dtype());
 }
 
+void FusedEmbeddingSeqpoolCvmInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const MetaTensor& w,
+    const MetaTensor& cvm,
+    const std::string& pooltype,
+    bool use_cvm,
+    int64_t padding_idx,
+    std::vector<MetaTensor*> out,
+    MetaConfig config) {
+  PADDLE_ENFORCE_GE(
+      ids.size(),
+      1UL,
+      common::errors::InvalidArgument(
+          "Inputs(Ids) of FusedEmbeddingSeqpoolCvmOp should not be empty."));
+  PADDLE_ENFORCE_EQ(
+      out.size(),
+      ids.size(),
+      common::errors::InvalidArgument(
+          "The number of Outputs(Out) of FusedEmbeddingSeqpoolCvmOp should be "
+          "equal to the number of Inputs(Ids), but received %d and %d.",
+          out.size(),
+          ids.size()));
+  PADDLE_ENFORCE_EQ(
+      pooltype == "SUM" || pooltype == "AVERAGE" || pooltype == "SQRT",
+      true,
+      common::errors::InvalidArgument(
+          "FusedEmbeddingSeqpoolCvmOp only supports SUM, AVERAGE and SQRT "
+          "pooltype, but received %s.",
+          pooltype));
+
+  const auto& w_dims = w.dims();
+  PADDLE_ENFORCE_EQ(
+      w_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The rank of Input(W) should be 2, but received %d.", w_dims.size()));
+  PADDLE_ENFORCE_GT(w_dims[1],
+                    2,
+                    common::errors::InvalidArgument(
+                        "The width of Input(W) should be larger than 2 to hold "
+                        "the show and click, but received %d.",
+                        w_dims[1]));
+  const auto& cvm_dims = cvm.dims();
+  PADDLE_ENFORCE_EQ(
+      cvm_dims.size(),
+      2,
+      common::errors::InvalidArgument("Input(CVM)'s rank should be 2."));
+
+  for (size_t i = 0; i < ids.size(); ++i) {
+    const auto& ids_dims = ids[i]->dims();
+    PADDLE_ENFORCE_EQ(
+        ids_dims.size() == 1 ||
+            (ids_dims.size() == 2 && ids_dims[ids_dims.size() - 1] == 1),
+        true,
+        common::errors::InvalidArgument(
+            "The %d-th Input(Ids) should be of shape [N] or [N, 1], but "
+            "received [%s].",
+            i,
+            ids_dims));
+    // the batch size is the number of sequences in the lod of ids
+    out[i]->set_dims(
+        common::make_ddim({-1, use_cvm ? w_dims[1] : w_dims[1] - 2}));
+    out[i]->set_dtype(w.dtype());
+  }
+}
+
+void FusedInt8MatmulInferMeta(const MetaTensor& x,
+                              const MetaTensor& weight,
+                              const std::vector<float>& weight_scale,
+                              float input_scale,
+                              float quant_max_bound,
+                              MetaTensor* out) {
+  const auto& x_dims = x.dims();
+  const auto& w_dims = weight.dims();
+  PADDLE_ENFORCE_EQ(
+      w_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The rank of Input(Weight) of FusedInt8Matmul should be 2, but "
+          "received %d.",
+          w_dims.size()));
+  PADDLE_ENFORCE_GE(
+      x_dims.size(),
+      1,
+      common::errors::InvalidArgument(
+          "The rank of Input(X) of FusedInt8Matmul should be at least 1."));
+  if (x_dims[x_dims.size() - 1] > 0 && w_dims[0] > 0) {
+    PADDLE_ENFORCE_EQ(x_dims[x_dims.size() - 1],
+                      w_dims[0],
+                      common::errors::InvalidArgument(
+                          "The last dimension of Input(X) (%d) should be "
+                          "equal to the first dimension of Input(Weight) "
+                          "(%d).",
+                          x_dims[x_dims.size() - 1],
+                          w_dims[0]));
+  }
+  PADDLE_ENFORCE_EQ(
+      weight_scale.size() == 1 ||
+          static_cast<int64_t>(weight_scale.size()) == w_dims[1],
+      true,
+      common::errors::InvalidArgument(
+          "The size of weight_scale should be 1 or the number of output "
+          "channels %d, but received %d.",
+          w_dims[1],
+          weight_scale.size()));
+  PADDLE_ENFORCE_GT(input_scale,
+                    0.0f,
+                    common::errors::InvalidArgument(
+                        "The input_scale should be positive, but received %f.",
+                        input_scale));
+  PADDLE_ENFORCE_GT(
+      quant_max_bound,
+      0.0f,
+      common::errors::InvalidArgument(
+          "The quant_max_bound should be positive, but received %f.",
+          quant_max_bound));
+
+  auto out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = w_dims[1];
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->share_lod(x);
+}
+
+void Sparse24GemmInferMeta(const MetaTensor& x,
+                           const MetaTensor& compressed_weight,
+                           int n,
+                           int k,
+                           MetaTensor* out) {
+  const auto& x_dims = x.dims();
+  PADDLE_ENFORCE_GE(
+      x_dims.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The rank of Input(X) of Sparse24Gemm should be at least 2, but "
+          "received %d.",
+          x_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      n > 0 && k > 0,
+      true,
+      common::errors::InvalidArgument(
+          "The n (%d) and k (%d) of Sparse24Gemm should be positive.", n, k));
+  if (x_dims[x_dims.size() - 1] > 0) {
+    PADDLE_ENFORCE_EQ(x_dims[x_dims.size() - 1],
+                      k,
+                      common::errors::InvalidArgument(
+                          "The last dimension of Input(X) (%d) should be "
+                          "equal to the k of the weight (%d).",
+                          x_dims[x_dims.size() - 1],
+                          k));
+  }
+  PADDLE_ENFORCE_EQ(
+      compressed_weight.dtype(),
+      phi::DataType::UINT8,
+      common::errors::InvalidArgument(
+          "The compressed weight of Sparse24Gemm should be of uint8, but "
+          "received %s.",
+          compressed_weight.dtype()));
+
+  auto out_dims = x_dims;
+  out_dims[out_dims.size() - 1] = n;
+  out->set_dims(out_dims);
+  out->set_dtype(x.dtype());
+  out->share_lod(x);
+}
+
 void FusedFCElementwiseLayerNormInferMeta(const MetaTensor& x,
                                           const MetaTensor& w,
                                           const MetaTensor& y,
@@ -6024,4 +6201,73 @@ void ResnetBasicBlockGradInferMeta(const MetaTensor& x,
   }
 }
 
+
+void FusedQkNormRopeInferMeta(const MetaTensor& q,
+                              const MetaTensor& k,
+                              const MetaTensor& q_norm_weight,
+                              const MetaTensor& k_norm_weight,
+                              const MetaTensor& sin,
+                              const MetaTensor& cos,
+                              const MetaTensor& position_ids,
+                              float epsilon,
+                              bool use_neox_rotary_style,
+                              MetaTensor* out_q,
+                              MetaTensor* out_k) {
+  const auto& q_dims = q.dims();
+  const auto& k_dims = k.dims();
+  PADDLE_ENFORCE_EQ(
+      q_dims.size() == 4 && k_dims.size() == 4,
+      true,
+      common::errors::InvalidArgument(
+          "The q and k of fused_qk_norm_rope should be 4-D tensors of format "
+          "[batch_size, seq_len, num_heads, head_dim], but got q {%s} and k "
+          "{%s}.",
+          q_dims,
+          k_dims));
+  PADDLE_ENFORCE_EQ(
+      q_dims[0] == k_dims[0] && q_dims[1] == k_dims[1] &&
+          q_dims[3] == k_dims[3],
+      true,
+      common::errors::InvalidArgument(
+          "The batch_size, seq_len and head_dim of q and k should be the "
+          "same, but got q {%s} and k {%s}.",
+          q_dims,
+          k_dims));
+  const int64_t head_dim = q_dims[3];
+  PADDLE_ENFORCE_EQ(head_dim % 2,
+                    0,
+                    common::errors::InvalidArgument(
+                        "The head_dim of fused_qk_norm_rope should be a "
+                        "multiple of 2, but got %d.",
+                        head_dim));
+  PADDLE_ENFORCE_EQ(
+      q_norm_weight.numel() == head_dim && k_norm_weight.numel() == head_dim,
+      true,
+      common::errors::InvalidArgument(
+          "The norm weights of fused_qk_norm_rope should have head_dim (%d) "
+          "elements, but got %d and %d.",
+          head_dim,
+          q_norm_weight.numel(),
+          k_norm_weight.numel()));
+  PADDLE_ENFORCE_EQ(
+      sin.dims(),
+      cos.dims(),
+      common::errors::InvalidArgument(
+          "The dims of sin and cos should be the same, but got {%s} and {%s}.",
+          sin.dims(),
+          cos.dims()));
+  PADDLE_ENFORCE_EQ(
+      sin.dims()[sin.dims().size() - 1],
+      head_dim,
+      common::errors::InvalidArgument(
+          "The last dim of sin and cos should be head_dim (%d), but got %d.",
+          head_dim,
+          sin.dims()[sin.dims().size() - 1]));
+
+  out_q->set_dims(q_dims);
+  out_q->set_dtype(q.dtype());
+  out_k->set_dims(k_dims);
+  out_k->set_dtype(k.dtype());
+}
+
 }  // namespace phi
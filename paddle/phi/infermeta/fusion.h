@@ -820,6 +820,29 @@ void FusedEmbeddingEltWiseLayerNormInferMeta(
     const float epsilon,
     MetaTensor* out);
 
+void FusedEmbeddingSeqpoolCvmInferMeta(
+    const std::vector<const MetaTensor*>& ids,
+    const MetaTensor& w,
+    const MetaTensor& cvm,
+    const std::string& pooltype,
+    bool use_cvm,
+    int64_t padding_idx,
+    std::vector<MetaTensor*> out,
+    MetaConfig config = MetaConfig());
+
+void FusedInt8MatmulInferMeta(const MetaTensor& x,
+                              const MetaTensor& weight,
+                              const std::vector<float>& weight_scale,
+                              float input_scale,
+                              float quant_max_bound,
+                              MetaTensor* out);
+
+void Sparse24GemmInferMeta(const MetaTensor& x,
+                           const MetaTensor& compressed_weight,
+                           int n,
+                           int k,
+                           MetaTensor* out);
+
 void FusionTransposeFlattenConcatInferMeta(
     const std::vector<const MetaTensor*>& x,
     const std::vector<int>& trans_axis,
@@ -1459,4 +1482,17 @@ void ResnetBasicBlockGradInferMeta(const MetaTensor& x,
                                    MetaTensor* bias3_grad,
                                    MetaConfig config = MetaConfig());
 
+
+void FusedQkNormRopeInferMeta(const MetaTensor& q,
+                              const MetaTensor& k,
+                              const MetaTensor& q_norm_weight,
+                              const MetaTensor& k_norm_weight,
+                              const MetaTensor& sin,
+                              const MetaTensor& cos,
+                              const MetaTensor& position_ids,
+                              float epsilon,
+                              bool use_neox_rotary_style,
+                              MetaTensor* out_q,
+                              MetaTensor* out_k);
+
 }  // namespace phi
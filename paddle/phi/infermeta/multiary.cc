@@ -1479,6 +1479,100 @@ void CrfDecodingInferMeta(const MetaTensor& emission,
   viterbi_path->set_dtype(emission.dtype());
 }
 
+void CropResizeNormalizeInferMeta(const std::vector<const MetaTensor*>& x,
+                                  const MetaTensor& boxes,
+                                  const MetaTensor& flip,
+                                  const std::vector<int>& size,
+                                  const std::vector<float>& mean,
+                                  const std::vector<float>& std,
+                                  MetaTensor* out) {
+  PADDLE_ENFORCE_GT(
+      x.size(),
+      0,
+      common::errors::InvalidArgument(
+          "The Input(X) of crop_resize_normalize should not be empty."));
+  const int64_t batch_size = static_cast<int64_t>(x.size());
+  const auto& first_dims = x[0]->dims();
+  for (size_t i = 0; i < x.size(); ++i) {
+    const auto& dims = x[i]->dims();
+    PADDLE_ENFORCE_EQ(dims.size(),
+                      3,
+                      common::errors::InvalidArgument(
+                          "The image %d of crop_resize_normalize should be a "
+                          "3-D tensor of shape [C, H, W], but got [%s].",
+                          i,
+                          dims));
+    PADDLE_ENFORCE_EQ(
+        dims[0],
+        first_dims[0],
+        common::errors::InvalidArgument(
+            "The images of crop_resize_normalize should have the same number "
+            "of channels, but the image %d has %d channels while the image "
+            "0 has %d.",
+            i,
+            dims[0],
+            first_dims[0]));
+  }
+  const int64_t channels = first_dims[0];
+  PADDLE_ENFORCE_LE(
+      channels,
+      4,
+      common::errors::InvalidArgument(
+          "The images of crop_resize_normalize should have at most 4 "
+          "channels, but got %d.",
+          channels));
+
+  const auto& boxes_dims = boxes.dims();
+  PADDLE_ENFORCE_EQ(
+      boxes_dims.size() == 2 && boxes_dims[0] == batch_size &&
+          boxes_dims[1] == 4,
+      true,
+      common::errors::InvalidArgument(
+          "The Input(Boxes) of crop_resize_normalize should be of shape "
+          "[%d, 4], but got [%s].",
+          batch_size,
+          boxes_dims));
+  if (flip.initialized()) {
+    PADDLE_ENFORCE_EQ(
+        flip.numel(),
+        batch_size,
+        common::errors::InvalidArgument(
+            "The Input(Flip) of crop_resize_normalize should have %d "
+            "elements, but got %d.",
+            batch_size,
+            flip.numel()));
+  }
+
+  PADDLE_ENFORCE_EQ(
+      size.size(),
+      2,
+      common::errors::InvalidArgument(
+          "The size of crop_resize_normalize should be [height, width], but "
+          "got %d values.",
+          size.size()));
+  PADDLE_ENFORCE_EQ(
+      size[0] > 0 && size[1] > 0,
+      true,
+      common::errors::InvalidArgument(
+          "The size of crop_resize_normalize should be positive, but got "
+          "[%d, %d].",
+          size[0],
+          size[1]));
+  for (const auto* values : {&mean, &std}) {
+    PADDLE_ENFORCE_EQ(
+        values->size() <= 1 || static_cast<int64_t>(values->size()) == channels,
+        true,
+        common::errors::InvalidArgument(
+            "The mean and std of crop_resize_normalize should have 1 or %d "
+            "values, but got %d.",
+            channels,
+            values->size()));
+  }
+
+  out->set_dims({batch_size, channels, size[0], size[1]});
+  out->set_dtype(phi::DataType::FLOAT32);
+}
+
 void CudnnLSTMInferMeta(
     const MetaTensor& x,
     const MetaTensor& init_h,
@@ -311,6 +311,14 @@ void CrfDecodingInferMeta(const MetaTensor& emission,
                           MetaTensor* viterbi_path,
                           MetaConfig config = MetaConfig());
 
+void CropResizeNormalizeInferMeta(const std::vector<const MetaTensor*>& x,
+                                  const MetaTensor& boxes,
+                                  const MetaTensor& flip,
+                                  const std::vector<int>& size,
+                                  const std::vector<float>& mean,
+                                  const std::vector<float>& std,
+                                  MetaTensor* out);
+
 void CudnnLSTMInferMeta(
     const MetaTensor& x,
     const MetaTensor& init_h,
@@ -807,4 +807,179 @@ SpmdInfo FlashAttGradInferSpmd(const DistMetaTensor& q,
           {q_grad, k_grad, v_grad}};
 }
 
+// The varlen (unpadded) flash attention packs the tokens of all the
+// sequences into the first dim of q, k and v, [total_tokens, num_heads,
+// head_dim], and cu_seqlens hold the offsets of the sequences. A sequence
+// may cross any split of the tokens, so only the num_heads can be sharded.
+namespace {
+
+void CheckUnpaddedInput(const DistMetaTensor& tensor, const char* name) {
+  PADDLE_ENFORCE_EQ(tensor.dims().size(),
+                    3,
+                    common::errors::InvalidArgument(
+                        "The Tensor %s's shape must be [total_tokens, "
+                        "num_heads, head_dim], but its rank is [%d].",
+                        name,
+                        tensor.dims().size()));
+  const auto& dims_mapping = tensor.dist_attr().dims_mapping();
+  PADDLE_ENFORCE_EQ(
+      tensor.dims().size(),
+      static_cast<int>(dims_mapping.size()),
+      common::errors::InvalidArgument("The Tensor %s's rank [%d] and Its "
+                                      "dims_mapping size [%d] are not matched.",
+                                      name,
+                                      tensor.dims().size(),
+                                      dims_mapping.size()));
+}
+
+// The mesh dim the num_heads of q, k and v are split on, -1 if they are
+// replicated. The heads stay replicated when k has fewer heads than q and
+// they do not divide evenly.
+int64_t UnpaddedNumHeadsMeshDim(const DistMetaTensor& q,
+                                const DistMetaTensor& k,
+                                const DistMetaTensor& v) {
+  const int64_t num_heads_axis = 1;
+  std::vector<std::pair<std::string, std::vector<int64_t>>> axes_sharding_info;
+  for (const auto* tensor : {&q, &k, &v}) {
+    axes_sharding_info.emplace_back(
+        "h",
+        std::vector<int64_t>{
+            tensor->dist_attr().dims_mapping()[num_heads_axis]});
+  }
+  auto axis_to_dim_map = ShardingMergeForTensors(axes_sharding_info);
+  int64_t mesh_dim = axis_to_dim_map["h"];
+  if (mesh_dim != -1) {
+    const int64_t split_size = q.dist_attr().process_mesh().dim_size(mesh_dim);
+    for (const auto* tensor : {&q, &k, &v}) {
+      if (tensor->dims()[num_heads_axis] % split_size != 0) {
+        return -1;
+      }
+    }
+  }
+  return mesh_dim;
+}
+
+TensorDistAttr ShardDims(const TensorDistAttr& src,
+                         const std::vector<int64_t>& dims_mapping) {
+  auto dst = CopyTensorDistAttrForOutput(src);
+  dst.set_dims_mapping(dims_mapping);
+  return dst;
+}
+
+}  // namespace
+
+SpmdInfo FlashAttUnpaddedInferSpmd(const DistMetaTensor& q,
+                                   const DistMetaTensor& k,
+                                   const DistMetaTensor& v,
+                                   const DistMetaTensor& cu_seqlens_q,
+                                   const DistMetaTensor& cu_seqlens_k,
+                                   const DistMetaTensor& fixed_seed_offset,
+                                   const DistMetaTensor& attn_mask,
+                                   int64_t max_seqlen_q,
+                                   int64_t max_seqlen_k,
+                                   float scale,
+                                   float dropout,
+                                   bool causal,
+                                   bool return_softmax,
+                                   bool is_test,
+                                   const std::string& rng_name) {
+  CheckUnpaddedInput(q, "q");
+  CheckUnpaddedInput(k, "k");
+  CheckUnpaddedInput(v, "v");
+  const int64_t h = UnpaddedNumHeadsMeshDim(q, k, v);
+
+  // [total_tokens, num_heads, head_dim]
+  auto q_dist_attr_dst = ShardDims(q.dist_attr(), {-1, h, -1});
+  auto k_dist_attr_dst = ShardDims(k.dist_attr(), {-1, h, -1});
+  auto v_dist_attr_dst = ShardDims(v.dist_attr(), {-1, h, -1});
+  // [batch_size + 1]
+  auto cu_seqlens_q_dist_attr_dst = ShardDims(cu_seqlens_q.dist_attr(), {-1});
+  auto cu_seqlens_k_dist_attr_dst = ShardDims(cu_seqlens_k.dist_attr(), {-1});
+  // TODO(liuzhenhai): process fixed_seed and  attn_mask
+  auto fixed_seed_offset_dist_attr_dst = fixed_seed_offset.dist_attr();
+  auto attn_mask_dist_attr_dst = attn_mask.dist_attr();
+
+  // [total_tokens_q, num_heads, head_dim_v]
+  auto out = ShardDims(q.dist_attr(), {-1, h, -1});
+  // [batch_size, num_heads, max_seqlen_q, max_seqlen_k]
+  auto softmax = ShardDims(q.dist_attr(), {-1, h, -1, -1});
+  // [batch_size, num_heads, max_seqlen_q]
+  auto softmax_lse = ShardDims(q.dist_attr(), {-1, h, -1});
+  TensorDistAttr seed_offset = fixed_seed_offset.dist_attr();
+  seed_offset.set_dims_mapping({-1});
+  seed_offset.set_process_mesh(out.process_mesh());
+
+  VLOG(4) << "FlashAttUnpaddedInferSpmd: num_heads mesh dim " << h;
+  VLOG(4) << "Outputs:";
+  LOG_SPMD_OUTPUT(out);
+  LOG_SPMD_OUTPUT(softmax);
+  LOG_SPMD_OUTPUT(softmax_lse);
+  LOG_SPMD_OUTPUT(seed_offset);
+
+  return {{q_dist_attr_dst,
+           k_dist_attr_dst,
+           v_dist_attr_dst,
+           cu_seqlens_q_dist_attr_dst,
+           cu_seqlens_k_dist_attr_dst,
+           fixed_seed_offset_dist_attr_dst,
+           attn_mask_dist_attr_dst},
+          {out, softmax, softmax_lse, seed_offset}};
+}
+
+SpmdInfo FlashAttUnpaddedGradInferSpmd(const DistMetaTensor& q,
+                                       const DistMetaTensor& k,
+                                       const DistMetaTensor& v,
+                                       const DistMetaTensor& cu_seqlens_q,
+                                       const DistMetaTensor& cu_seqlens_k,
+                                       const DistMetaTensor& out,
+                                       const DistMetaTensor& softmax_lse,
+                                       const DistMetaTensor& seed_offset,
+                                       const DistMetaTensor& attn_mask,
+                                       const DistMetaTensor& out_grad,
+                                       int64_t max_seqlen_q,
+                                       int64_t max_seqlen_k,
+                                       float scale,
+                                       float dropout,
+                                       bool causal) {
+  CheckUnpaddedInput(q, "q");
+  CheckUnpaddedInput(k, "k");
+  CheckUnpaddedInput(v, "v");
+  const int64_t h = UnpaddedNumHeadsMeshDim(q, k, v);
+
+  auto q_dist_attr_dst = ShardDims(q.dist_attr(), {-1, h, -1});
+  auto k_dist_attr_dst = ShardDims(k.dist_attr(), {-1, h, -1});
+  auto v_dist_attr_dst = ShardDims(v.dist_attr(), {-1, h, -1});
+  auto cu_seqlens_q_dist_attr_dst = ShardDims(cu_seqlens_q.dist_attr(), {-1});
+  auto cu_seqlens_k_dist_attr_dst = ShardDims(cu_seqlens_k.dist_attr(), {-1});
+  auto out_dist_attr_dst = ShardDims(out.dist_attr(), {-1, h, -1});
+  auto softmax_lse_dist_attr_dst =
+      ShardDims(softmax_lse.dist_attr(), {-1, h, -1});
+  // TODO(liuzhenhai): process seed and  attn_mask
+  auto seed_offset_dist_attr_dst = seed_offset.dist_attr();
+  auto attn_mask_dist_attr_dst = attn_mask.dist_attr();
+  auto out_grad_dist_attr_dst = ShardDims(out_grad.dist_attr(), {-1, h, -1});
+
+  auto q_grad = ShardDims(q.dist_attr(), {-1, h, -1});
+  auto k_grad = ShardDims(k.dist_attr(), {-1, h, -1});
+  auto v_grad = ShardDims(v.dist_attr(), {-1, h, -1});
+
+  VLOG(4) << "FlashAttUnpaddedGradInferSpmd: num_heads mesh dim " << h;
+  VLOG(4) << "Outputs:";
+  LOG_SPMD_OUTPUT(q_grad);
+  LOG_SPMD_OUTPUT(k_grad);
+  LOG_SPMD_OUTPUT(v_grad);
+
+  return {{q_dist_attr_dst,
+           k_dist_attr_dst,
+           v_dist_attr_dst,
+           cu_seqlens_q_dist_attr_dst,
+           cu_seqlens_k_dist_attr_dst,
+           out_dist_attr_dst,
+           softmax_lse_dist_attr_dst,
+           seed_offset_dist_attr_dst,
+           attn_mask_dist_attr_dst,
+           out_grad_dist_attr_dst},
+          {q_grad, k_grad, v_grad}};
+}
+
 }  // namespace phi::distributed
@@ -68,5 +68,37 @@ SpmdInfo FlashAttGradInferSpmd(const DistMetaTensor& q,
                                float dropout = 0.0,
                                bool causal = false);
 
+SpmdInfo FlashAttUnpaddedInferSpmd(const DistMetaTensor& q,
+                                   const DistMetaTensor& k,
+                                   const DistMetaTensor& v,
+                                   const DistMetaTensor& cu_seqlens_q,
+                                   const DistMetaTensor& cu_seqlens_k,
+                                   const DistMetaTensor& fixed_seed_offset,
+                                   const DistMetaTensor& attn_mask,
+                                   int64_t max_seqlen_q,
+                                   int64_t max_seqlen_k,
+                                   float scale,
+                                   float dropout = 0.0,
+                                   bool causal = false,
+                                   bool return_softmax = false,
+                                   bool is_test = false,
+                                   const std::string& rng_name = "");
+
+SpmdInfo FlashAttUnpaddedGradInferSpmd(const DistMetaTensor& q,
+                                       const DistMetaTensor& k,
+                                       const DistMetaTensor& v,
+                                       const DistMetaTensor& cu_seqlens_q,
+                                       const DistMetaTensor& cu_seqlens_k,
+                                       const DistMetaTensor& out,
+                                       const DistMetaTensor& softmax_lse,
+                                       const DistMetaTensor& seed_offset,
+                                       const DistMetaTensor& attn_mask,
+                                       const DistMetaTensor& out_grad,
+                                       int64_t max_seqlen_q,
+                                       int64_t max_seqlen_k,
+                                       float scale,
+                                       float dropout = 0.0,
+                                       bool causal = false);
+
 }  // namespace distributed
 }  // namespace phi
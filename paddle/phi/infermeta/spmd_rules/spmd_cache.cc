@@ -0,0 +1,91 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/infermeta/spmd_rules/spmd_cache.h"
+
+#include <unordered_map>
+
+namespace phi::distributed {
+
+void SpmdCacheKey::Append(const DistMetaTensor& tensor) {
+  if (!tensor.initialized()) {
+    key_.push_back('\0');
+    return;
+  }
+  key_.push_back('\1');
+  AppendInts(common::vectorize(tensor.dims()));
+  // metas built from dims and dist attr only have no dtype
+  bool has_dtype = tensor.MetaTensor::initialized();
+  AppendPod(static_cast<int64_t>(has_dtype ? tensor.dtype()
+                                           : DataType::UNDEFINED));
+  tensor.dist_attr().append_to_key(&key_);
+}
+
+void SpmdCacheKey::Append(const std::vector<DistMetaTensor>& tensors) {
+  AppendPod(static_cast<int64_t>(tensors.size()));
+  for (const auto& tensor : tensors) {
+    Append(tensor);
+  }
+}
+
+void SpmdCacheKey::Append(const paddle::optional<DistMetaTensor>& tensor) {
+  if (tensor) {
+    Append(*tensor);
+  } else {
+    key_.push_back('\0');
+  }
+}
+
+void SpmdCacheKey::Append(const std::string& value) {
+  AppendPod(static_cast<int64_t>(value.size()));
+  key_.append(value);
+}
+
+void SpmdCacheKey::Append(const Scalar& value) {
+  AppendPod(static_cast<int64_t>(value.dtype()));
+  Append(value.ToRawString());
+}
+
+namespace {
+
+constexpr size_t kMaxSpmdCacheSize = 8192;
+
+std::unordered_map<std::string, SpmdInfo>& ThreadSpmdCache() {
+  // one per thread, so that the dispatch of an api takes no lock
+  thread_local std::unordered_map<std::string, SpmdInfo> cache;
+  return cache;
+}
+
+}  // namespace
+
+bool GetCachedSpmdInfo(const std::string& key, SpmdInfo* info) {
+  auto& cache = ThreadSpmdCache();
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    return false;
+  }
+  *info = it->second;
+  return true;
+}
+
+void CacheSpmdInfo(const std::string& key, const SpmdInfo& info) {
+  auto& cache = ThreadSpmdCache();
+  if (cache.size() >= kMaxSpmdCacheSize) {
+    // shapes that keep changing, start over rather than track recency
+    cache.clear();
+  }
+  cache.emplace(key, info);
+}
+
+}  // namespace phi::distributed
@@ -0,0 +1,117 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "paddle/common/flags.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/common/scalar.h"
+#include "paddle/phi/core/distributed/auto_parallel/dist_meta_tensor.h"
+#include "paddle/phi/core/distributed/type_defs.h"
+#include "paddle/utils/optional.h"
+#include "paddle/utils/test_macros.h"
+
+COMMON_DECLARE_bool(enable_spmd_rule_cache);
+
+namespace phi {
+namespace distributed {
+
+// Key of an InferSpmd call: the rule name, then the dims, dtype and dist
+// attr of every input and the value of every attribute, in call order. A call
+// with an argument of an unsupported type is not cacheable.
+class SpmdCacheKey {
+ public:
+  explicit SpmdCacheKey(const char* rule_name) : key_(rule_name) {
+    key_.push_back('\0');
+  }
+
+  void Append(const DistMetaTensor& tensor);
+  void Append(const std::vector<DistMetaTensor>& tensors);
+  void Append(const paddle::optional<DistMetaTensor>& tensor);
+  void Append(const std::string& value);
+  void Append(const char* value) { Append(std::string(value)); }
+  void Append(const Scalar& value);
+  void Append(const IntArray& value) { AppendInts(value.GetData()); }
+  void Append(DataType value) { AppendPod(static_cast<int64_t>(value)); }
+  void Append(const std::vector<int>& values) { AppendInts(values); }
+  void Append(const std::vector<int64_t>& values) { AppendInts(values); }
+  void Append(const std::vector<bool>& values) { AppendInts(values); }
+
+  template <typename T>
+  void Append(const T& value) {
+    if constexpr (std::is_arithmetic<T>::value) {
+      AppendPod(value);
+    } else {
+      cacheable_ = false;
+    }
+  }
+
+  bool cacheable() const { return cacheable_; }
+
+  const std::string& str() const { return key_; }
+
+ private:
+  template <typename T>
+  void AppendPod(const T& value) {
+    key_.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  template <typename T>
+  void AppendInts(const std::vector<T>& values) {
+    AppendPod(static_cast<int64_t>(values.size()));
+    for (const auto& value : values) {
+      AppendPod(static_cast<int64_t>(value));
+    }
+  }
+
+  std::string key_;
+  bool cacheable_{true};
+};
+
+// The InferSpmd results of the calling thread, bounded in size.
+TEST_API bool GetCachedSpmdInfo(const std::string& key, SpmdInfo* info);
+TEST_API void CacheSpmdInfo(const std::string& key, const SpmdInfo& info);
+
+// Runs infer, an InferSpmd rule applied to args, unless the same rule was
+// already run on the same args. The result only depends on the meta of the
+// inputs and the attributes, which is what the key records.
+template <typename InferFn, typename... Args>
+SpmdInfo CachedInferSpmd(const char* rule_name,
+                         InferFn&& infer,
+                         const Args&... args) {
+  if (!FLAGS_enable_spmd_rule_cache) {
+    return infer();
+  }
+  SpmdCacheKey key(rule_name);
+  (key.Append(args), ...);
+  if (!key.cacheable()) {
+    return infer();
+  }
+  SpmdInfo info;
+  if (GetCachedSpmdInfo(key.str(), &info)) {
+    return info;
+  }
+  info = infer();
+  CacheSpmdInfo(key.str(), info);
+  return info;
+}
+
+}  // namespace distributed
+}  // namespace phi
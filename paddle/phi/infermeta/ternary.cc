@@ -1332,6 +1332,47 @@ void MatrixRankAtolRtolInferMeta(const MetaTensor& x,
   MatrixRankTolInferMeta(x, atol, true, hermitian, out);
 }
 
+void MoeCombineInferMeta(const MetaTensor& x,
+                         const MetaTensor& combine_weights,
+                         const MetaTensor& scatter_index,
+                         MetaTensor* y) {
+  auto x_dims = x.dims();
+  auto weights_dims = combine_weights.dims();
+  auto index_dims = scatter_index.dims();
+  PADDLE_ENFORCE_EQ(x_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The input x of moe_combine should be a 2-D tensor "
+                        "[rows, hidden_size], but got %d-D.",
+                        x_dims.size()));
+  PADDLE_ENFORCE_EQ(weights_dims.size(),
+                    2,
+                    common::errors::InvalidArgument(
+                        "The combine_weights of moe_combine should be a 2-D "
+                        "tensor [tokens, k], but got %d-D.",
+                        weights_dims.size()));
+  PADDLE_ENFORCE_EQ(
+      weights_dims,
+      index_dims,
+      common::errors::InvalidArgument(
+          "The shape of combine_weights [%s] and scatter_index [%s] of "
+          "moe_combine should be equal.",
+          weights_dims,
+          index_dims));
+  PADDLE_ENFORCE_EQ(
+      combine_weights.dtype(),
+      DataType::FLOAT32,
+      common::errors::InvalidArgument(
+          "The combine_weights of moe_combine should be float32."));
+  PADDLE_ENFORCE_EQ(
+      scatter_index.dtype(),
+      DataType::INT32,
+      common::errors::InvalidArgument(
+          "The scatter_index of moe_combine should be int32."));
+  y->set_dims({weights_dims[0], x_dims[1]});
+  y->set_dtype(x.dtype());
+}
+
 void MultiClassNMSInferMeta(const MetaTensor& bboxes,
                             const MetaTensor& scores,
                             const MetaTensor& rois_num,
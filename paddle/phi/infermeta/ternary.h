@@ -244,6 +244,11 @@ void MatrixRankAtolRtolInferMeta(const MetaTensor& x,
                                  bool hermitian,
                                  MetaTensor* out);
 
+void MoeCombineInferMeta(const MetaTensor& x,
+                         const MetaTensor& combine_weights,
+                         const MetaTensor& scatter_index,
+                         MetaTensor* y);
+
 void MovingAverageAbsMaxScaleInferMeta(const MetaTensor& x,
                                        const MetaTensor& in_accum,
                                        const MetaTensor& in_state,
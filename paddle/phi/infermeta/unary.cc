@@ -1565,7 +1565,7 @@ void FlattenWithXShapeInferMeta(const MetaTensor& x,
   FlattenInferMeta(x, start_axis, stop_axis, out);
   if (xshape == nullptr) return;
   const auto& x_dims = x.dims();
-  std::vector<int64_t> xshape_dims(x_dims.size() + 1);
+  common::SmallShape<int64_t> xshape_dims(x_dims.size() + 1);
   xshape_dims[0] = 0;
   for (int i = 0; i < x_dims.size(); ++i) {
     xshape_dims[i + 1] = x_dims[i];
@@ -1612,8 +1612,7 @@ void FlattenInferMeta(const MetaTensor& x,
   }
 
   int64_t outer = 1;
-  std::vector<int32_t> out_shape;
-  out_shape.reserve(in_dims_size - stop_axis + start_axis + 1);
+  common::SmallShape<int64_t> out_shape;
 
   for (int i = 0; i < start_axis; ++i) {
     out_shape.push_back(x_dims[i]);  // NOLINT
@@ -5295,8 +5294,8 @@ void TransposeInferMeta(const MetaTensor& x,
                         x_rank,
                         axis_size));
 
-  std::vector<int> formatted_axis = axis;
-  std::vector<int> count(axis_size, 0);
+  common::SmallShape<int> formatted_axis(axis.begin(), axis.end());
+  common::SmallShape<int> count(axis_size, 0);
   for (int i = 0; i < axis_size; i++) {
     PADDLE_ENFORCE_LT(axis[i],
                       x_rank,
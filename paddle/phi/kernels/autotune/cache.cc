@@ -14,12 +14,67 @@
 
 #include "paddle/phi/kernels/autotune/cache.h"
 
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
+#include <random>
+#include <sstream>
 
 #include "glog/logging.h"
 
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+#include "paddle/phi/backends/gpu/gpu_info.h"
+#endif
+
 namespace phi::autotune {
 
+namespace {
+
+constexpr char kAutoTuneCacheMagic[] = "paddle_autotune_cache v1";
+
+// The tuned algorithms are only valid on the same device model with the same
+// driver and library versions.
+std::string AutoTuneCacheFingerprint() {
+  std::ostringstream os;
+#if defined(PADDLE_WITH_CUDA) || defined(PADDLE_WITH_HIP)
+  int dev_id = phi::backends::gpu::GetCurrentDeviceId();
+  const auto& prop = phi::backends::gpu::GetDeviceProperties(dev_id);
+  os << prop.name << ";sm=" << prop.multiProcessorCount
+     << ";cc=" << phi::backends::gpu::GetGPUComputeCapability(dev_id)
+     << ";driver=" << phi::backends::gpu::GetGPUDriverVersion(dev_id)
+     << ";runtime=" << phi::backends::gpu::GetGPURuntimeVersion(dev_id)
+     << ";dnn=" << phi::backends::gpu::DnnVersion();
+#else
+  os << "cpu";
+#endif
+  return os.str();
+}
+
+template <typename T>
+void WriteVector(std::ostream& os, const std::vector<T>& vec) {
+  os << " " << vec.size();
+  for (auto& v : vec) {
+    os << " " << v;
+  }
+}
+
+template <typename T>
+bool ReadVector(std::istream& is, std::vector<T>* vec) {
+  size_t size = 0;
+  if (!(is >> size)) {
+    return false;
+  }
+  vec->resize(size);
+  for (auto& v : *vec) {
+    if (!(is >> v)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
 size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype) {
@@ -27,6 +82,16 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
   return GenKey(x_dims, perm, rank, static_cast<int>(dtype));
 }
 
+size_t ReduceSplitKey(int64_t left_num,
+                      int64_t reduce_num,
+                      phi::DataType x_dtype,
+                      phi::DataType y_dtype) {
+  return GenKey(left_num,
+                reduce_num,
+                static_cast<int>(x_dtype),
+                static_cast<int>(y_dtype));
+}
+
 std::string AlgorithmTypeString(int64_t algo_type) {
   if (algo_type == static_cast<int64_t>(AlgorithmType::kConvForward)) {
     return "conv_forward";
@@ -115,4 +180,118 @@ void AutoTuneCache::UpdateStatus() {
   total_cache_misses_ = cache_misses;
 }
 
+std::string AutoTuneCache::Serialize() {
+  std::ostringstream os;
+  os << kAutoTuneCacheMagic << "\n";
+  os << "fingerprint " << AutoTuneCacheFingerprint() << "\n";
+  for (auto& v : auto_tune_map_) {
+    int64_t algo_type = v.first;
+    v.second.Visit([&](size_t key, int64_t algo) {
+      os << "algo " << algo_type << " " << key << " " << algo << "\n";
+    });
+  }
+  for (auto& v : conv_auto_tune_map_) {
+    int64_t algo_type = v.first;
+    v.second.Visit([&](const ConvCacheKey& key,
+                       const ConvAutoTuneResult& result) {
+      os << "conv " << algo_type << " " << result.algo << " "
+         << result.workspace_size << " " << result.exhaustive_search << " "
+         << static_cast<int>(key.dtype) << " " << key.groups << " "
+         << key.data_layout;
+      WriteVector(os, key.x_dims);
+      WriteVector(os, key.w_dims);
+      WriteVector(os, key.strides);
+      WriteVector(os, key.paddings);
+      WriteVector(os, key.dilations);
+      os << "\n";
+    });
+  }
+  return os.str();
+}
+
+int64_t AutoTuneCache::Deserialize(const std::string& data) {
+  std::istringstream is(data);
+  std::string line;
+  if (!std::getline(is, line) || line != kAutoTuneCacheMagic) {
+    VLOG(3) << "Skip the autotune cache with an unknown format.";
+    return -1;
+  }
+  std::string fingerprint = "fingerprint " + AutoTuneCacheFingerprint();
+  if (!std::getline(is, line) || line != fingerprint) {
+    VLOG(3) << "Skip the autotune cache tuned on a different environment: "
+            << line;
+    return -1;
+  }
+
+  int64_t num_merged = 0;
+  while (std::getline(is, line)) {
+    std::istringstream ls(line);
+    std::string tag;
+    int64_t algo_type = 0;
+    if (!(ls >> tag >> algo_type)) {
+      continue;
+    }
+    if (tag == "algo") {
+      size_t key = 0;
+      int64_t algo = 0;
+      auto it = auto_tune_map_.find(algo_type);
+      if ((ls >> key >> algo) && it != auto_tune_map_.end()) {
+        num_merged += it->second.Merge(key, algo);
+      }
+    } else if (tag == "conv") {
+      ConvAutoTuneResult result;
+      ConvCacheKey key;
+      int dtype = 0;
+      bool valid = static_cast<bool>(
+          ls >> result.algo >> result.workspace_size >>
+          result.exhaustive_search >> dtype >> key.groups >> key.data_layout);
+      valid = valid && ReadVector(ls, &key.x_dims) &&
+              ReadVector(ls, &key.w_dims) && ReadVector(ls, &key.strides) &&
+              ReadVector(ls, &key.paddings) && ReadVector(ls, &key.dilations);
+      key.dtype = static_cast<phi::DataType>(dtype);
+      auto it = conv_auto_tune_map_.find(algo_type);
+      if (valid && it != conv_auto_tune_map_.end()) {
+        num_merged += it->second.Merge(key, result);
+      }
+    }
+  }
+  VLOG(3) << "Merged " << num_merged << " autotune cache entries.";
+  return num_merged;
+}
+
+int64_t AutoTuneCache::LoadFromFile(const std::string& path) {
+  std::ifstream fin(path);
+  if (!fin.is_open()) {
+    return -1;
+  }
+  std::stringstream buffer;
+  buffer << fin.rdbuf();
+  return Deserialize(buffer.str());
+}
+
+bool AutoTuneCache::SaveToFile(const std::string& path) {
+  // Keep the entries saved by the other ranks meanwhile.
+  LoadFromFile(path);
+  std::string tmp_path =
+      path + ".tmp" + std::to_string(std::random_device()());
+  {
+    std::ofstream fout(tmp_path);
+    if (!fout.is_open()) {
+      LOG(WARNING) << "Failed to save the autotune cache to " << tmp_path;
+      return false;
+    }
+    fout << Serialize();
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(path.c_str());
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      LOG(WARNING) << "Failed to save the autotune cache to " << path;
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  VLOG(3) << "Saved the autotune cache to " << path;
+  return true;
+}
+
 }  // namespace phi::autotune
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <numeric>
+#include <string>
 
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/kernels/autotune/cache_base.h"
@@ -39,6 +40,11 @@ size_t TransposeKey(const std::vector<int64_t>& x_dims,
                     const std::vector<int32_t>& perm,
                     phi::DataType dtype);
 
+size_t ReduceSplitKey(int64_t left_num,
+                      int64_t reduce_num,
+                      phi::DataType x_dtype,
+                      phi::DataType y_dtype);
+
 enum class AlgorithmType {
   kConvForward = 1,
   kConvBackwardData = 2,
@@ -49,21 +55,22 @@ enum class AlgorithmType {
   kGatherGemmScatterFP32NN = 7,
   kGatherGemmScatterFP32TN = 8,
   kGatherGemmScatterFP32NT = 9,
+  kReduceSplit = 10,
 #if !defined(PADDLE_WITH_CUDNN_FRONTEND)
-  kAlgorithmCount = 10
+  kAlgorithmCount = 11
 #else
-  kConvForwardV8 = 10,
-  kConvBackwardDataV8 = 11,
-  kConvBackwardFilterV8 = 12,
-  kScaleBiasReluConvBNstats = 13,
-  kBNFinalize = 14,
-  kScaleBiasAddRelu = 15,
-  kDgradDreluBnBwdWeight = 16,
-  kDbnApply = 17,
-  kBnActWgrad = 18,
-  kPoolingForwardV8 = 19,
-  kPoolingBackwardV8 = 20,
-  kAlgorithmCount = 21
+  kConvForwardV8 = 11,
+  kConvBackwardDataV8 = 12,
+  kConvBackwardFilterV8 = 13,
+  kScaleBiasReluConvBNstats = 14,
+  kBNFinalize = 15,
+  kScaleBiasAddRelu = 16,
+  kDgradDreluBnBwdWeight = 17,
+  kDbnApply = 18,
+  kBnActWgrad = 19,
+  kPoolingForwardV8 = 20,
+  kPoolingBackwardV8 = 21,
+  kAlgorithmCount = 22
 #endif
 };
 
@@ -151,6 +158,26 @@ class AutoTuneCache {
 
   void UpdateStatus();
 
+  // Serializes the caches whose entries are plain algorithm ids, i.e. the
+  // cuDNN conv, transpose and gather-gemm-scatter caches, together with the
+  // fingerprint of the device, driver and libraries they are tuned on. The
+  // cuBLASLt matmul and cuDNN frontend caches hold runtime descriptors and
+  // are not serialized.
+  std::string Serialize();
+
+  // Merges the entries of `data` into the caches, the entries already tuned
+  // in this process are kept. Returns the number of merged entries, or -1 if
+  // `data` was tuned on a different device or library versions.
+  int64_t Deserialize(const std::string& data);
+
+  // Returns the number of merged entries, or -1 if the file does not exist
+  // or does not match.
+  int64_t LoadFromFile(const std::string& path);
+
+  // Merges the entries in the file, which may be written by other ranks,
+  // then atomically replaces the file with all the entries.
+  bool SaveToFile(const std::string& path);
+
   // The number of total config cached
   int64_t Size() const { return total_size_; }
 
@@ -137,6 +137,21 @@ class AlgorithmsCache {
     hash_[key] = algo;
   }
 
+  // Sets the algorithm only if the key is not cached yet, returns whether it
+  // is set. Used to merge the results tuned by other processes.
+  bool Merge(const KeyT& key, AlgorithmT algo) {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    return hash_.emplace(key, algo).second;
+  }
+
+  template <typename Visitor>
+  void Visit(Visitor&& visitor) {
+    std::lock_guard<std::mutex> lock(*cache_mutex_);
+    for (auto& item : hash_) {
+      visitor(item.first, item.second);
+    }
+  }
+
   int64_t CacheMisses() const { return cache_misses_; }
 
   int64_t CacheHits() const { return cache_hits_; }
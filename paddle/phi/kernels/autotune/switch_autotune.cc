@@ -18,6 +18,7 @@
 #include "paddle/common/flags.h"
 
 COMMON_DECLARE_bool(use_autotune);
+COMMON_DECLARE_string(autotune_cache_file);
 
 namespace phi::autotune {
 
@@ -38,6 +39,14 @@ void AutoTuneStatus::Update() {
     return;
   }
 
+  if (!FLAGS_autotune_cache_file.empty() && !cache_file_loaded_) {
+    cache_file_loaded_ = true;
+    int64_t num_loaded =
+        AutoTuneCache::Instance().LoadFromFile(FLAGS_autotune_cache_file);
+    VLOG(3) << "Loaded " << num_loaded << " autotune cache entries from "
+            << FLAGS_autotune_cache_file;
+  }
+
   // This function is called when each iter finished.
   if (current_steps_id_ + 1 < start_step_id_) {
     use_autotune_ = false;
@@ -54,6 +63,10 @@ void AutoTuneStatus::Update() {
             << static_cast<int>(StepHitRate() * 100) << "%";
   } else {
     use_autotune_ = false;
+    if (!FLAGS_autotune_cache_file.empty() &&
+        current_steps_id_ + 1 == stop_step_id_) {
+      AutoTuneCache::Instance().SaveToFile(FLAGS_autotune_cache_file);
+    }
     // Set a small tolerance to avoid performance degradation
     // due to large cache size under dynamic shape.
     // TODO(limingshu): Currently works for conv op only, this
@@ -29,4 +29,13 @@ void CheckNumericsKernel(const Context& ctx,
                          DenseTensor* stats,
                          DenseTensor* values);
 
+// Sets *flag to 1 if tensor holds NAN or INF, without synchronizing the
+// device. The flag must be accessible from the device, e.g. pinned host
+// memory, and is never reset here, so that the results of many tensors can be
+// accumulated into one word and read once.
+template <typename T, typename Context>
+void AccumulateNanInfFlag(const Context& ctx,
+                          const DenseTensor& tensor,
+                          int* flag);
+
 }  // namespace phi
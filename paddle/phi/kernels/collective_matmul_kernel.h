@@ -0,0 +1,42 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// out = matmul(all_gather(x), y), the rows of x gathered from the ranks are
+// multiplied as soon as they arrive, x_gathered is kept for the backward.
+template <typename T, typename Context>
+void AllGatherMatmulKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& y,
+                           bool transpose_y,
+                           int nranks,
+                           DenseTensor* out,
+                           DenseTensor* x_gathered);
+
+// out = reduce_scatter(matmul(x, y)), the partial result of each rank's rows
+// is sent while the rows of the next rank are multiplied.
+template <typename T, typename Context>
+void MatmulReduceScatterKernel(const Context& dev_ctx,
+                               const DenseTensor& x,
+                               const DenseTensor& y,
+                               bool transpose_y,
+                               int nranks,
+                               DenseTensor* out);
+
+}  // namespace phi
@@ -14,7 +14,10 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/check_numerics_kernel.h"
 
+#include <cmath>
+
 #include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/check_numerics_utils.h"
 
@@ -60,6 +63,37 @@ void CheckNumericsKernel(const Context& ctx,
                                    values_ptr);
 }
 
+template <typename T, typename Context>
+void AccumulateNanInfFlag(const Context& ctx,
+                          const DenseTensor& tensor,
+                          int* flag) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  using std::isinf;
+  using std::isnan;
+  const T* value_ptr = tensor.data<T>();
+  for (int64_t i = 0; i < tensor.numel(); ++i) {
+    MT value = static_cast<MT>(value_ptr[i]);
+    if (isnan(value) || isinf(value)) {
+      *reinterpret_cast<volatile int*>(flag) = 1;
+      return;
+    }
+  }
+}
+
+#define INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(T)       \
+  template void AccumulateNanInfFlag<T, CPUContext>( \
+      const CPUContext& ctx, const DenseTensor& tensor, int* flag);
+
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(float)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(double)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float16)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::bfloat16)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::complex<float>)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::complex<double>)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float8_e4m3fn)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float8_e5m2)
+#undef INSTANTIATE_ACCUMULATE_NAN_INF_FLAG
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(check_numerics,
@@ -14,6 +14,8 @@
 
 #include <utf8proc.h>
 
+#include <array>
+#include <cstring>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -33,6 +35,7 @@ using std::size_t;
 using std::string;
 using std::unordered_map;
 using std::unordered_set;
+using std::pair;
 using std::vector;
 using std::wcout;
 using std::wstring;
@@ -46,7 +49,12 @@ using InvVocab = unordered_map<int, wstring>;
 class BasicTokenizer {
  public:
   explicit BasicTokenizer(bool do_lower_case = true);
-  void Tokenize(const string& text, vector<wstring>* res) const;
+  // Decodes text into *unicode_text, drops its control chars, lower-cases it
+  // if asked, and splits it into words, which are [begin, end) ranges of
+  // *unicode_text, so that no word is copied into a string of its own.
+  void Tokenize(const string& text,
+                wstring* unicode_text,
+                vector<pair<size_t, size_t>>* words) const;
 
  private:
   wchar_t do_lower_case(wchar_t ch) const;
@@ -59,10 +67,15 @@ class WordPieceTokenizer {
   explicit WordPieceTokenizer(const phi::Vocab* vocab,
                               const wstring& unk_token = L"[UNK]",
                               const size_t max_input_chars_per_word = 100);
-  void Tokenize(const wstring& text, vector<int64_t>* output) const;
+  void Tokenize(const wchar_t* word,
+                size_t len,
+                vector<int64_t>* token_ids) const;
 
  private:
   const phi::Vocab* vocab_;
+  std::shared_ptr<const phi::VocabTrie> trie_;
+  // trie node of "##", the prefix of the pieces that continue a word
+  int suffix_node_;
   wstring unk_token_{L"[UNK]"};
   int64_t unk_token_id_;
   size_t max_input_chars_per_word_;
@@ -125,7 +138,59 @@ class BertTokenizer {
 
 const wstring kStripChars = L" \t\n\r\v\f";
 
+// Classes of the ASCII chars, so that the common case skips utf8proc. They
+// match the utf8proc categories checked below.
+enum AsciiClass : uint8_t {
+  kAsciiControl = 1,
+  kAsciiWhiteSpace = 2,
+  kAsciiPunctuation = 4,
+};
+
+const std::array<uint8_t, 128> kAsciiClasses = [] {
+  std::array<uint8_t, 128> classes{};
+  for (int ch = 0; ch < 128; ++ch) {
+    if ((ch < 32 || ch == 127) && ch != '\t' && ch != '\n' && ch != '\r') {
+      classes[ch] |= kAsciiControl;
+    }
+    if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+      classes[ch] |= kAsciiWhiteSpace;
+    }
+    if ((ch >= 33 && ch <= 47) || (ch >= 58 && ch <= 64) ||
+        (ch >= 91 && ch <= 96) || (ch >= 123 && ch <= 126)) {
+      classes[ch] |= kAsciiPunctuation;
+    }
+  }
+  return classes;
+}();
+
+// Decodes the UTF-8 text into *res. Text that is all ASCII, checked eight
+// bytes at a time, is widened directly instead of going through the codecvt.
+inline bool DecodeUtf8(const string& text, wstring* res) {
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  const char* data = text.data();
+  size_t size = text.size();
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, sizeof(uint64_t));
+    if (word & kHighBits) {
+      return phi::ConvertStrToWstr(text, res);
+    }
+  }
+  for (; i < size; ++i) {
+    if (data[i] & 0x80) {
+      return phi::ConvertStrToWstr(text, res);
+    }
+  }
+  res->resize(size);
+  for (i = 0; i < size; ++i) {
+    (*res)[i] = static_cast<unsigned char>(data[i]);
+  }
+  return true;
+}
+
 inline bool IsControl(const wchar_t& ch) {
+  if (ch >= 0 && ch < 128) return kAsciiClasses[ch] & kAsciiControl;
   if (ch == L'\t' || ch == L'\n' || ch == L'\r') return false;
   auto cat = utf8proc_category(ch);
   if (cat == UTF8PROC_CATEGORY_CC || cat == UTF8PROC_CATEGORY_CF) return true;
@@ -142,6 +207,7 @@ inline bool IsChineseChar(const wchar_t& ch) {
 }
 
 inline bool IsWhiteSpace(const wchar_t& ch) {
+  if (ch >= 0 && ch < 128) return kAsciiClasses[ch] & kAsciiWhiteSpace;
   if (ch == L' ' || ch == L'\t' || ch == L'\n' || ch == L'\r') return true;
   auto cat = utf8proc_category(ch);
   if (cat == UTF8PROC_CATEGORY_ZS) return true;
@@ -149,6 +215,7 @@ inline bool IsWhiteSpace(const wchar_t& ch) {
 }
 
 inline bool IsPunctuation(const wchar_t& ch) {
+  if (ch >= 0 && ch < 128) return kAsciiClasses[ch] & kAsciiPunctuation;
   if ((ch >= 33 && ch <= 47) || (ch >= 58 && ch <= 64) ||
       (ch >= 91 && ch <= 96) || (ch >= 123 && ch <= 126))
     return true;
@@ -165,25 +232,33 @@ BasicTokenizer::BasicTokenizer(bool do_lower_case /* = true */)
     : do_lower_case_(do_lower_case) {}
 
 wchar_t BasicTokenizer::do_lower_case(wchar_t ch) const {
+  if (ch >= 0 && ch < 128) {
+    return (ch >= L'A' && ch <= L'Z') ? ch + (L'a' - L'A') : ch;
+  }
   wchar_t new_ch = utf8proc_tolower(ch);
   return new_ch;
 }
 
-void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
-  std::wstring unicode_text;
-  bool status = phi::ConvertStrToWstr(text, &unicode_text);
+void BasicTokenizer::Tokenize(const string& text,
+                              wstring* unicode_text,
+                              vector<pair<size_t, size_t>>* words) const {
+  bool status = DecodeUtf8(text, unicode_text);
   if (!status) {
     // String is converted into wstring failedly.
+    unicode_text->clear();
     return;
   }
-  std::wstring cache_text = L"";
-  auto PushCacheText = [&]() {
-    if (!cache_text.empty()) {
-      res->emplace_back(cache_text);
-      cache_text = L"";
+  // the kept chars are compacted in place, a word ends where it is pushed
+  size_t kept = 0;
+  size_t word_begin = 0;
+  auto PushWord = [&]() {
+    if (kept > word_begin) {
+      words->emplace_back(word_begin, kept);
     }
+    word_begin = kept;
   };
-  for (auto& ch : unicode_text) {
+  for (size_t i = 0; i < unicode_text->size(); ++i) {
+    wchar_t ch = (*unicode_text)[i];
     if (ch == 0 || ch == 0xfffd || IsControl(ch)) {
       continue;
     }
@@ -191,15 +266,17 @@ void BasicTokenizer::Tokenize(const string& text, vector<wstring>* res) const {
       ch = do_lower_case(ch);
     }
     if (IsChineseChar(ch) || IsPunctuation(ch)) {
-      PushCacheText();
-      res->emplace_back(std::wstring{ch});
+      PushWord();
+      (*unicode_text)[kept++] = ch;
+      PushWord();
     } else if (IsWhiteSpace(ch)) {
-      PushCacheText();
+      PushWord();
     } else {
-      cache_text += ch;
+      (*unicode_text)[kept++] = ch;
     }
   }
-  PushCacheText();
+  PushWord();
+  unicode_text->resize(kept);
 }
 
 WordPieceTokenizer::WordPieceTokenizer(
@@ -207,55 +284,41 @@ WordPieceTokenizer::WordPieceTokenizer(
     const wstring& unk_token /* = L"[UNK]"*/,
     const size_t max_input_chars_per_word /* = 100 */)
     : vocab_(vocab),
+      trie_(vocab->trie()),
       unk_token_(unk_token),
       max_input_chars_per_word_(max_input_chars_per_word) {
   unk_token_id_ = vocab_->at(unk_token_);
+  suffix_node_ = trie_->Walk(phi::VocabTrie::kRoot, L"##", 2);
 }
 
-void WordPieceTokenizer::Tokenize(const wstring& text,
+// Greedy longest-match-first: the whole word when it is a token, else its
+// longest prefix token followed by the longest "##" tokens of the rest, each
+// found by one walk down the trie.
+void WordPieceTokenizer::Tokenize(const wchar_t* word,
+                                  size_t len,
                                   vector<int64_t>* token_ids) const {
-  size_t len = text.size();
   if (len > max_input_chars_per_word_) {
     token_ids->emplace_back(unk_token_id_);
     return;
   }
 
-  auto it = vocab_->find(text);
-  if (it != vocab_->end()) {
-    token_ids->emplace_back(it->second);
-    return;
-  }
-
+  size_t word_begin = token_ids->size();
   size_t start = 0;
-  vector<int64_t> wordpiece_ids;
   while (start < len) {
-    size_t end = len;
-    std::wstring cur_substr;
-    int64_t cur_substr_id = 0;
-    while (start < end) {
-      std::wstring sub = text.substr(start, end - start);
-      if (start > 0) {
-        sub.insert(0, L"##");
-      }
-      auto it = vocab_->find(sub);
-      if (it != vocab_->end()) {
-        cur_substr = sub;
-        cur_substr_id = it->second;
-        break;
-      }
-      end -= 1;
+    int node = start == 0 ? phi::VocabTrie::kRoot : suffix_node_;
+    int32_t token_id = 0;
+    size_t matched = 0;
+    if (node >= 0) {
+      matched =
+          trie_->LongestPrefix(node, word + start, len - start, &token_id);
     }
-
-    if (cur_substr.empty()) {
+    if (matched == 0) {
+      token_ids->resize(word_begin);
       token_ids->emplace_back(unk_token_id_);
       return;
-    } else {
-      start = end;
-      wordpiece_ids.emplace_back(cur_substr_id);
     }
-  }
-  for (auto& token_id : wordpiece_ids) {
     token_ids->emplace_back(token_id);
+    start += matched;
   }
 }
 
@@ -294,28 +357,17 @@ BertTokenizer::BertTokenizer(const phi::Vocab* vocab,
 
 void BertTokenizer::Tokenize(const string& text,
                              vector<int64_t>* split_token_ids) const {
-  std::vector<std::wstring> tmp_tokens;
-  basic_tokenizer_.Tokenize(text, &tmp_tokens);
-  if (tmp_tokens.empty()) return;
-  split_token_ids->reserve(tmp_tokens.size());
-  for (auto& w_token : tmp_tokens) {
-    const auto& vec_size = w_token.size();
-    if (vec_size == 1) {
-      if (IsChineseChar(w_token[0])) {
-        auto vocab_it = vocab_->find(w_token);
-        if (vocab_it != vocab_->end()) {
-          split_token_ids->emplace_back(vocab_it->second);
-        } else {
-          split_token_ids->emplace_back(unk_token_id_);
-        }
-      } else {
-        word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-      }
-    } else if (vec_size > 1) {
-      word_piece_tokenizer_.Tokenize(w_token, split_token_ids);
-    } else {
-      continue;
-    }
+  std::wstring unicode_text;
+  std::vector<pair<size_t, size_t>> words;
+  basic_tokenizer_.Tokenize(text, &unicode_text, &words);
+  if (words.empty()) return;
+  split_token_ids->reserve(words.size());
+  // a single Chinese char is looked up as is, which is what WordPiece does
+  // for any one char word
+  for (auto& word : words) {
+    word_piece_tokenizer_.Tokenize(unicode_text.data() + word.first,
+                                   word.second - word.first,
+                                   split_token_ids);
   }
 }
 
@@ -410,15 +462,16 @@ int BertTokenizer::Encode(
     }
   } else {
     std::wstring unicode_text;
-    bool status_a = phi::ConvertStrToWstr(text, &unicode_text);
+    bool status_a = DecodeUtf8(text, &unicode_text);
     if (!status_a) {
       return 0;
     }
+    const auto& trie = *vocab_->trie();
     for (size_t i = 0; i < unicode_text.size(); i++) {
-      wstring token = unicode_text.substr(i, 1);
-      auto it = vocab_->find(token);
-      if (it != vocab_->end()) {
-        ids.emplace_back(it->second);
+      int32_t token_id = 0;
+      if (trie.LongestPrefix(
+              phi::VocabTrie::kRoot, &unicode_text[i], 1, &token_id) > 0) {
+        ids.emplace_back(token_id);
       } else {
         ids.emplace_back(unk_token_id_);
       }
@@ -496,8 +549,10 @@ void BertTokenizer::BatchEncode(
   }
 
   size_t batch_size = batch_text.size();
+  // sentence lengths vary a lot within a batch, so threads take them in
+  // small chunks rather than in one static block each
 #ifdef PADDLE_WITH_MKLML
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic, 4)
 #endif
   for (size_t i = 0; i < batch_size; i++) {
     unordered_map<string, vector<int64_t>> res;
@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/layer_norm_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/kernels/cpu/elementwise.h"
 #include "paddle/phi/kernels/funcs/layer_norm_util.h"
 #if !defined(PADDLE_WITH_CUDA) && !defined(_WIN32) && !defined(__APPLE__) && \
@@ -134,15 +136,32 @@ void LayerNormKernel(const Context& dev_ctx,
   auto ker =
       phi::jit::KernelFuncs<phi::jit::LayerNormTuple<T>, phi::CPUPlace>::Cache()
           .At(right);
-  ker(x_tmp.data<T>(),
-      out.data<T>(),
-      mean_tmp.data<T>(),
-      var_tmp.data<T>(),
-      scale ? scale->data<T>() : nullptr,
-      bias ? bias->data<T>() : nullptr,
-      static_cast<int>(left),
-      static_cast<float>(epsilon),
-      right);
+  // the rows are normalized independently, in blocks of rows in parallel
+  constexpr int kRowsPerBlock = 16;
+  const int num_blocks = (left + kRowsPerBlock - 1) / kRowsPerBlock;
+  T* x_data = x_tmp.data<T>();
+  T* out_data = out.data<T>();
+  T* mean_data = mean_tmp.data<T>();
+  T* var_data = var_tmp.data<T>();
+  const T* scale_data = scale ? scale->data<T>() : nullptr;
+  const T* bias_data = bias ? bias->data<T>() : nullptr;
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int block = 0; block < num_blocks; ++block) {
+    const int begin = block * kRowsPerBlock;
+    const int rows = std::min(kRowsPerBlock, left - begin);
+    const int64_t offset = static_cast<int64_t>(begin) * right;
+    ker(x_data + offset,
+        out_data + offset,
+        mean_data + begin,
+        var_data + begin,
+        scale_data,
+        bias_data,
+        rows,
+        static_cast<float>(epsilon),
+        right);
+  }
 #endif
 }
 
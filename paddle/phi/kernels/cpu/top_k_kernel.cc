@@ -18,13 +18,13 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/funcs/eigen/common.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
+#include "paddle/phi/kernels/funcs/top_k_function_cpu.h"
 
 namespace phi {
 
 template <typename T, typename Type>
 static void FullTopK(Type input_height,
                      Type input_width,
-                     int input_dim,
                      const DenseTensor* input,
                      T* t_out,
                      Type* t_indices,
@@ -41,84 +41,66 @@ static void FullTopK(Type input_height,
 
   // when the k is small, will the partial sort
   bool partial_sort_flag = (k * 64) < input_width;
+  const T* input_data = input->data<T>();
 
 #ifdef PADDLE_WITH_MKLML
 #pragma omp parallel for
 #endif
   for (Type i = 0; i < input_height; ++i) {
+    const T* row = input_data + i * input_width;
+    if (partial_sort_flag) {
+      // only the rare elements that beat the k-th candidate are sorted
+      funcs::HeapTopK<T, Type>(
+          row, input_width, k, largest, t_out + i * k, t_indices + i * k);
+      continue;
+    }
     std::vector<std::pair<T, Type>> col_vec;
     col_vec.reserve(input_width);
-    if (input_dim == 1) {
-      auto e_input = EigenVector<T>::Flatten(*input);
-      for (Type j = 0; j < input_width; ++j) {
-        col_vec.emplace_back(std::pair<T, Type>(e_input(j), j));
-      }
-    } else {
-      auto e_input = EigenMatrix<T>::Reshape(*input, input_dim - 1);
-      for (Type j = 0; j < input_width; ++j) {
-        col_vec.emplace_back(std::pair<T, Type>(e_input(i, j), j));
-      }
+    for (Type j = 0; j < input_width; ++j) {
+      col_vec.emplace_back(std::pair<T, Type>(row[j], j));
     }
-    if (partial_sort_flag) {
-      std::partial_sort(
+    // use the nth-element to get the K-larger or K-small element
+    if (largest) {
+      std::nth_element(
           col_vec.begin(),
-          col_vec.begin() + k,
+          col_vec.begin() + k - 1,
           col_vec.end(),
-          [&largest](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
-            if (largest) {
-              return (std::isnan(static_cast<double>(l.first)) &&
-                      !std::isnan(static_cast<double>(r.first))) ||
-                     (l.first > r.first);
-            } else {
-              return (!std::isnan(static_cast<double>(l.first)) &&
-                      std::isnan(static_cast<double>(r.first))) ||
-                     (l.first < r.first);
-            }
+          [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
+            return (std::isnan(static_cast<double>(l.first)) &&
+                    !std::isnan(static_cast<double>(r.first))) ||
+                   (l.first > r.first);
           });
-    } else {
-      // use the nth-element to get the K-larger or K-small element
-      if (largest) {
-        std::nth_element(
+      // the nth-element will get the unorder elements, sort the element
+      if (sorted) {
+        std::sort(
             col_vec.begin(),
             col_vec.begin() + k - 1,
-            col_vec.end(),
             [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
               return (std::isnan(static_cast<double>(l.first)) &&
                       !std::isnan(static_cast<double>(r.first))) ||
                      (l.first > r.first);
             });
-        // the nth-element will get the unorder elements, sort the element
-        if (sorted) {
-          std::sort(
-              col_vec.begin(),
-              col_vec.begin() + k - 1,
-              [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
-                return (std::isnan(static_cast<double>(l.first)) &&
-                        !std::isnan(static_cast<double>(r.first))) ||
-                       (l.first > r.first);
-              });
-        }
-      } else {
-        std::nth_element(
+      }
+    } else {
+      std::nth_element(
+          col_vec.begin(),
+          col_vec.begin() + k - 1,
+          col_vec.end(),
+          [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
+            return (!std::isnan(static_cast<double>(l.first)) &&
+                    std::isnan(static_cast<double>(r.first))) ||
+                   (l.first < r.first);
+          });
+      // the nth-element will get the unorder elements, sort the element
+      if (sorted) {
+        std::sort(
             col_vec.begin(),
             col_vec.begin() + k - 1,
-            col_vec.end(),
             [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
               return (!std::isnan(static_cast<double>(l.first)) &&
                       std::isnan(static_cast<double>(r.first))) ||
                      (l.first < r.first);
             });
-        // the nth-element will get the unorder elements, sort the element
-        if (sorted) {
-          std::sort(
-              col_vec.begin(),
-              col_vec.begin() + k - 1,
-              [](const std::pair<T, Type>& l, const std::pair<T, Type>& r) {
-                return (!std::isnan(static_cast<double>(l.first)) &&
-                        std::isnan(static_cast<double>(r.first))) ||
-                       (l.first < r.first);
-              });
-        }
       }
     }
     for (Type j = 0; j < k; ++j) {
@@ -176,7 +158,6 @@ void TopkKernel(const Context& dev_ctx,
     const int64_t& input_width = in_dims[in_dims.size() - 1];
     FullTopK<T, int64_t>(input_height,
                          input_width,
-                         in_dims.size(),
                          input,
                          out_data,
                          indices_data,
@@ -229,7 +210,6 @@ void TopkKernel(const Context& dev_ctx,
     // get the TopK value
     FullTopK<T, int64_t>(input_height,
                          input_width,
-                         in_dims.size(),
                          &trans_inp,
                          t_out,
                          t_ind,
@@ -0,0 +1,39 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// Crops boxes[i] = (top, left, height, width) out of the CHW image x[i],
+// resizes the crop to size bilinearly, optionally flips it horizontally and
+// normalizes it as (value - mean[c]) / std[c], all in one pass:
+//   out[i] = normalize(flip(resize(crop(x[i], boxes[i]), size)))
+// The images may be of different sizes, the output is a float32 batch of
+// shape [N, C, size[0], size[1]].
+template <typename T, typename Context>
+void CropResizeNormalizeKernel(const Context& dev_ctx,
+                               const std::vector<const DenseTensor*>& x,
+                               const DenseTensor& boxes,
+                               const paddle::optional<DenseTensor>& flip,
+                               const std::vector<int>& size,
+                               const std::vector<float>& mean,
+                               const std::vector<float>& std,
+                               DenseTensor* out);
+
+}  // namespace phi
@@ -24,6 +24,7 @@
 
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/complex.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -1000,6 +1001,59 @@ struct CBlas<phi::dtype::float16> {
 #endif
 };
 
+namespace detail {
+// C = A * B + beta * C with the B packed by PackedWeightCache, false if B is
+// not packed
+template <typename T>
+inline bool GEMMWithPackedWeight(
+    int M, int N, int K, const T *A, const T *B, T beta, T *C) {
+  return false;
+}
+
+#ifdef PADDLE_WITH_MKLML
+template <typename T>
+inline bool GEMMWithMKLPackedWeight(
+    int M, int N, int K, const T *A, const T *B, T beta, T *C) {
+  const T *packed = static_cast<const T *>(PackedWeightCache::Instance().Find(
+      B, K, N, phi::CppTypeToDataType<T>::Type()));
+  if (packed == nullptr) {
+    return false;
+  }
+  CBlas<T>::GEMM_COMPUTE(CblasRowMajor,
+                         CblasNoTrans,
+                         CblasPacked,
+                         M,
+                         N,
+                         K,
+                         A,
+                         K,
+                         packed,
+                         N,
+                         beta,
+                         C,
+                         N);
+  return true;
+}
+
+template <>
+inline bool GEMMWithPackedWeight<float>(
+    int M, int N, int K, const float *A, const float *B, float beta, float *C) {
+  return GEMMWithMKLPackedWeight<float>(M, N, K, A, B, beta, C);
+}
+
+template <>
+inline bool GEMMWithPackedWeight<double>(int M,
+                                         int N,
+                                         int K,
+                                         const double *A,
+                                         const double *B,
+                                         double beta,
+                                         double *C) {
+  return GEMMWithMKLPackedWeight<double>(M, N, K, A, B, beta, C);
+}
+#endif
+}  // namespace detail
+
 #ifdef PADDLE_WITH_MKLML
 template <>
 template <typename T>
@@ -1061,6 +1115,11 @@ void Blas<phi::CPUContext>::GEMM(CBLAS_TRANSPOSE transA,
                                  const T *B,
                                  T beta,
                                  T *C) const {
+  if (transA == CblasNoTrans && transB == CblasNoTrans &&
+      alpha == static_cast<T>(1) &&
+      detail::GEMMWithPackedWeight<T>(M, N, K, A, B, beta, C)) {
+    return;
+  }
   int lda = (transA == CblasNoTrans) ? K : M;
   int ldb = (transB == CblasNoTrans) ? N : K;
   int ldc = N;
@@ -1585,6 +1644,9 @@ template <>
 template <typename T>
 void Blas<phi::CPUContext>::MatMul(
     const int M, const int N, const int K, const T *A, const T *B, T *C) const {
+  if (detail::GEMMWithPackedWeight<T>(M, N, K, A, B, static_cast<T>(0), C)) {
+    return;
+  }
 #ifdef PADDLE_WITH_LIBXSMM
   // Refer to https://github.com/hfp/libxsmm/blob/master/README.md
   // But the threshold is custom constexpr int LIBXSMM_THRESHOLD = 20 * 20 * 20;
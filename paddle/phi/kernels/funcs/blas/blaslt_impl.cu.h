@@ -16,6 +16,8 @@ limitations under the License. */
 
 #if defined(PADDLE_WITH_CUDA) && CUDA_VERSION >= 11060
 
+#include <algorithm>
+
 #include "glog/logging.h"
 
 #include <cuda_runtime_api.h>  // NOLINT
@@ -440,6 +442,87 @@ struct MatmulGradDescriptor : MatmulDescriptor {
   }
 };
 
+// GEMMs with only a few rows of x, e.g. the GEMMs of decoding, launch too
+// few output tiles to keep all the SMs busy, while the heuristic of cuBLASLt
+// seldom splits the long K. Appends the split-K variants of the leading
+// heuristic algorithms as candidates of the exhaustive search, and the
+// fastest one is cached for the shape like any other algorithm.
+static constexpr int64_t kSplitKMaxRows = 16;
+static constexpr int64_t kSplitKMinK = 256;
+static constexpr int kSplitKCandidateAlgos = 3;
+
+template <class MatmulDescT>
+static void AppendSplitKAlgos(
+    const cublasLtHandle_t& lt_handle,
+    MatmulDescT* desc,
+    size_t workspace_size,
+    std::vector<cublasLtMatmulHeuristicResult_t>* heuristic_results,
+    int* returned_results) {
+  if (desc->M_ <= 0 || desc->M_ > kSplitKMaxRows ||
+      desc->K_ < 2 * kSplitKMinK) {
+    return;
+  }
+  const int num_candidates = std::min(*returned_results, kSplitKCandidateAlgos);
+  for (int i = 0; i < num_candidates; ++i) {
+    const cublasLtMatmulAlgo_t& algo = (*heuristic_results)[i].algo;
+    int splitk_support = 0;
+    size_t size_written = 0;
+    if (dynload::cublasLtMatmulAlgoCapGetAttribute(
+            &algo,
+            CUBLASLT_ALGO_CAP_SPLITK_SUPPORT,
+            &splitk_support,
+            sizeof(splitk_support),
+            &size_written) != CUBLAS_STATUS_SUCCESS ||
+        !splitk_support) {
+      continue;
+    }
+    int algo_splits = 1;
+    dynload::cublasLtMatmulAlgoConfigGetAttribute(
+        &algo,
+        CUBLASLT_ALGO_CONFIG_SPLITK_NUM,
+        &algo_splits,
+        sizeof(algo_splits),
+        &size_written);
+    for (int splits : {2, 4, 8, 16}) {
+      if (splits == algo_splits || desc->K_ / splits < kSplitKMinK) {
+        continue;
+      }
+      cublasLtMatmulHeuristicResult_t result = (*heuristic_results)[i];
+      // The partial sums are reduced in the compute type in the workspace,
+      // so the result is as precise as the one without split.
+      uint32_t reduction_scheme = CUBLASLT_REDUCTION_SCHEME_COMPUTE_TYPE;
+      if (dynload::cublasLtMatmulAlgoConfigSetAttribute(
+              &result.algo,
+              CUBLASLT_ALGO_CONFIG_SPLITK_NUM,
+              &splits,
+              sizeof(splits)) != CUBLAS_STATUS_SUCCESS ||
+          dynload::cublasLtMatmulAlgoConfigSetAttribute(
+              &result.algo,
+              CUBLASLT_ALGO_CONFIG_REDUCTION_SCHEME,
+              &reduction_scheme,
+              sizeof(reduction_scheme)) != CUBLAS_STATUS_SUCCESS) {
+        continue;
+      }
+      if (dynload::cublasLtMatmulAlgoCheck(lt_handle,
+                                           desc->op_desc,
+                                           desc->y_desc,
+                                           desc->x_desc,
+                                           desc->out_desc,
+                                           desc->out_desc,
+                                           &result.algo,
+                                           &result) != CUBLAS_STATUS_SUCCESS ||
+          result.workspaceSize > workspace_size) {
+        continue;
+      }
+      heuristic_results->push_back(result);
+      ++(*returned_results);
+    }
+  }
+  VLOG(6) << "[AppendSplitKAlgos] " << *returned_results
+          << " candidate algorithms for M = " << desc->M_
+          << ", K = " << desc->K_;
+}
+
 template <typename T, typename OutT = T, class MatmulDescT = MatmulDescriptor>
 struct CublasLtBase {
  public:
@@ -548,6 +631,14 @@ struct CublasLtBase {
         returned_results,
         0,
         common::errors::Unavailable("No GEMM algorithm available."));
+    heuristic_results.resize(returned_results);
+    if (FLAGS_cublaslt_exhaustive_search_times > 0) {
+      AppendSplitKAlgos(lt_handle,
+                        desc,
+                        workspace_size,
+                        &heuristic_results,
+                        &returned_results);
+    }
     int best_algo_idx = -1;
     if (returned_results == 1 || FLAGS_cublaslt_exhaustive_search_times <= 0) {
       best_algo_idx = 0;
@@ -830,6 +921,14 @@ struct CublasLtBase<int8_t, int32_t, MatmulDescriptor> {
         returned_results,
         0,
         common::errors::Unavailable("No GEMM algorithm available."));
+    heuristic_results.resize(returned_results);
+    if (FLAGS_cublaslt_exhaustive_search_times > 0) {
+      AppendSplitKAlgos(lt_handle,
+                        desc,
+                        workspace_size,
+                        &heuristic_results,
+                        &returned_results);
+    }
     int best_algo_idx = -1;
     if (returned_results == 1 || FLAGS_cublaslt_exhaustive_search_times <= 0) {
       best_algo_idx = 0;
@@ -0,0 +1,113 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/blas/packed_weight.h"
+
+#include "glog/logging.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/kernels/funcs/blas/blas.h"
+
+namespace phi {
+namespace funcs {
+
+#ifdef PADDLE_WITH_MKLML
+template <typename T>
+static std::shared_ptr<void> PackWeight(const DenseTensor& weight) {
+  const int K = static_cast<int>(weight.dims()[0]);
+  const int N = static_cast<int>(weight.dims()[1]);
+  auto* dev_ctx = static_cast<phi::CPUContext*>(
+      phi::DeviceContextPool::Instance().Get(phi::CPUPlace()));
+  auto blas = GetBlas<phi::CPUContext, T>(*dev_ctx);
+  // a packed B serves any M, as in the packed GEMMs of gru
+  T* packed = blas.GEMM_ALLOC(CblasBMatrix, 1, N, K);
+  PADDLE_ENFORCE_NOT_NULL(
+      packed,
+      common::errors::ResourceExhausted(
+          "Failed to allocate the packed weight of [%d, %d].", K, N));
+  blas.GEMM_PACK(CblasBMatrix,
+                 CblasNoTrans,
+                 1,
+                 N,
+                 K,
+                 static_cast<T>(1),
+                 weight.data<T>(),
+                 N,
+                 packed);
+  return std::shared_ptr<void>(
+      packed, [blas](void* data) { blas.GEMM_FREE(static_cast<T*>(data)); });
+}
+#endif
+
+bool PackedWeightCache::Pack(const DenseTensor& weight) {
+#ifdef PADDLE_WITH_MKLML
+  if (!weight.initialized() || weight.dims().size() != 2 ||
+      weight.place().GetType() != phi::AllocationType::CPU) {
+    return false;
+  }
+  std::shared_ptr<void> packed;
+  if (weight.dtype() == DataType::FLOAT32) {
+    packed = PackWeight<float>(weight);
+  } else if (weight.dtype() == DataType::FLOAT64) {
+    packed = PackWeight<double>(weight);
+  } else {
+    return false;
+  }
+  VLOG(4) << "Pack the weight of [" << weight.dims() << "]";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[weight.data()] = {weight.Holder(),
+                             static_cast<int>(weight.dims()[0]),
+                             static_cast<int>(weight.dims()[1]),
+                             weight.dtype(),
+                             std::move(packed)};
+  size_.store(entries_.size(), std::memory_order_relaxed);
+  return true;
+#else
+  return false;
+#endif
+}
+
+const void* PackedWeightCache::Find(const void* weight,
+                                    int K,
+                                    int N,
+                                    DataType dtype) {
+  if (Size() == 0) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = entries_.find(weight);
+  if (iter == entries_.end()) {
+    return nullptr;
+  }
+  const Entry& entry = iter->second;
+  if (entry.holder.expired()) {
+    // the data now belongs to another allocation
+    entries_.erase(iter);
+    size_.store(entries_.size(), std::memory_order_relaxed);
+    return nullptr;
+  }
+  if (entry.K != K || entry.N != N || entry.dtype != dtype) {
+    return nullptr;
+  }
+  return entry.packed.get();
+}
+
+void PackedWeightCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  size_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace funcs
+}  // namespace phi
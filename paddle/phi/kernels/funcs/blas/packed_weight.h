@@ -0,0 +1,73 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "paddle/common/macros.h"
+#include "paddle/phi/common/data_type.h"
+#include "paddle/phi/core/allocator.h"
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+namespace funcs {
+
+// The constant [K, N] weights of inference packed ahead of time for the
+// packed GEMM of MKL (cblas_?gemm_pack), so the CPU GEMMs with them as B
+// do not pack them again on every call. A packed weight is found by the
+// data of the weight, and dropped once the allocation of the weight is
+// released. The weight must not be modified after it is packed.
+class PackedWeightCache {
+ public:
+  static PackedWeightCache& Instance() {
+    static PackedWeightCache instance;
+    return instance;
+  }
+
+  // Packs the 2-D float or double weight, returns false if it can not be
+  // packed, e.g. without MKL.
+  bool Pack(const DenseTensor& weight);
+
+  // The packed weight of `weight` with K rows and N cols of `dtype`, nullptr
+  // if it is not packed.
+  const void* Find(const void* weight, int K, int N, DataType dtype);
+
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+  void Clear();
+
+ private:
+  PackedWeightCache() = default;
+
+  struct Entry {
+    std::weak_ptr<Allocation> holder;
+    int K;
+    int N;
+    DataType dtype;
+    std::shared_ptr<void> packed;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<const void*, Entry> entries_;
+  // checked without the lock, most GEMMs run with nothing packed
+  std::atomic<size_t> size_{0};
+
+  DISABLE_COPY_AND_ASSIGN(PackedWeightCache);
+};
+
+}  // namespace funcs
+}  // namespace phi
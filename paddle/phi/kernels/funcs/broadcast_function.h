@@ -511,6 +511,232 @@ void LaunchBroadcastKernel(
 #endif
 }
 
+#ifndef PADDLE_WITH_XPU_KP
+// How an input of the block broadcast kernel is loaded by the VecSize
+// consecutive outputs of a thread.
+enum BlockBroadcastLoadType {
+  // The input has the same shape as the output.
+  kBlockSame = 0,
+  // The VecSize outputs share one input element, e.g. [N, C, H, W] with
+  // [C, 1, 1] when H * W is divisible by VecSize.
+  kBlockScalar = 1,
+  // The VecSize outputs read VecSize contiguous input elements, e.g. [M, N]
+  // with [N] when N is divisible by VecSize.
+  kBlockVector = 2,
+  // Every output computes its own input index.
+  kBlockGeneric = 3,
+};
+
+// The inputs whose non-broadcast dimensions are contiguous in the output are
+// indexed by (out_index / inner) % mid, which covers the scalar, row, column
+// and channel broadcast. Computing it takes two divmods at most instead of one
+// per dimension, and none at all for the whole vector of a thread when the
+// pattern allows a vectorized or a single load.
+template <typename OutT, typename Functor, int Arity, int NumOuts>
+struct BlockBroadcastConfig {
+  uint32_t numel{0};
+  Array<const _ptr_ char *__restrict__, Arity> ins_data;
+  Array<_ptr_ OutT *, NumOuts> outs_data;
+  Array<kps::details::FastDivMod, Arity> inners;
+  Array<kps::details::FastDivMod, Arity> mids;
+  Array<int, Arity> load_types;
+
+  // Returns false if any input can not be indexed as a block.
+  bool Init(const std::vector<const DenseTensor *> &ins,
+            std::vector<DenseTensor *> *outs,
+            int axis,
+            int vec_size) {
+    const auto &out_dims = (*outs)[0]->dims();
+    const int64_t out_numel = (*outs)[0]->numel();
+    if (out_numel <= 0 || out_numel >= std::numeric_limits<int32_t>::max()) {
+      return false;
+    }
+    numel = static_cast<uint32_t>(out_numel);
+    const int rank = out_dims.size();
+    for (int i = 0; i < Arity; ++i) {
+      const auto &in_dims = ins[i]->dims();
+      const int offset = in_dims.size() == rank ? 0 : axis;
+      if (offset < 0 || offset + in_dims.size() > rank) {
+        return false;
+      }
+      // 0: before the kept dimensions, 1: inside, 2: after.
+      int state = 0;
+      int64_t mid = 1;
+      int64_t inner = 1;
+      for (int d = 0; d < rank; ++d) {
+        int in_d = d - offset;
+        int64_t in_dim =
+            (in_d >= 0 && in_d < in_dims.size()) ? in_dims[in_d] : 1;
+        if (out_dims[d] == 1) {
+          if (in_dim != 1) {
+            return false;
+          }
+          continue;
+        }
+        if (in_dim == out_dims[d]) {
+          if (state == 2) {
+            return false;
+          }
+          state = 1;
+          mid *= out_dims[d];
+        } else if (in_dim == 1) {
+          if (state == 1) {
+            state = 2;
+          }
+          if (state == 2) {
+            inner *= out_dims[d];
+          }
+        } else {
+          return false;
+        }
+      }
+      inners[i] = kps::details::FastDivMod(static_cast<uint32_t>(inner));
+      mids[i] = kps::details::FastDivMod(static_cast<uint32_t>(mid));
+      if (mid == out_numel) {
+        load_types[i] = kBlockSame;
+      } else if (inner % vec_size == 0) {
+        load_types[i] = kBlockScalar;
+      } else if (inner == 1 && mid % vec_size == 0) {
+        load_types[i] = kBlockVector;
+      } else {
+        load_types[i] = kBlockGeneric;
+      }
+    }
+
+    using Traits = phi::funcs::FunctionTraits<Functor>;
+    using ArgsT = typename Traits::ArgsTuple;
+    ArgsT arg;
+    UnrollerWithoutVecSize<InputSetter, Arity>::step(ins, arg, &ins_data);
+    for (int i = 0; i < NumOuts; ++i) {
+      outs_data[i] = (*outs)[i]->data<OutT>();
+    }
+    return true;
+  }
+};
+
+template <int Index, int VecSize>
+struct BlockBroadcastLoader {
+  template <typename Array1, typename Array2, typename Array3, typename ArgsT>
+  static __device__ __forceinline__ void Apply(const Array1 &ins,
+                                               ArgsT *args,
+                                               const Array2 &inners,
+                                               const Array2 &mids,
+                                               const Array3 &load_types,
+                                               uint32_t offset,
+                                               int num) {
+    using Type = std::tuple_element_t<Index, ArgsT>;
+    const _ptr_ Type *in = reinterpret_cast<const _ptr_ Type *>(ins[Index]);
+    const int load_type = load_types[Index];
+    if (num == VecSize && load_type != kBlockGeneric) {
+      if (load_type == kBlockScalar) {
+        uint32_t index =
+            mids[Index].Divmod(inners[Index].Div(offset)).val[1];
+        Type value = in[index];
+#pragma unroll
+        for (int k = 0; k < VecSize; ++k) {
+          std::get<Index>(args[k]) = value;
+        }
+      } else {
+        uint32_t index = load_type == kBlockSame
+                             ? offset
+                             : mids[Index].Divmod(offset).val[1];
+        phi::AlignedVector<Type, VecSize> vec;
+        phi::Load<Type, VecSize>(in + index, &vec);
+#pragma unroll
+        for (int k = 0; k < VecSize; ++k) {
+          std::get<Index>(args[k]) = vec[k];
+        }
+      }
+      return;
+    }
+#pragma unroll
+    for (int k = 0; k < VecSize; ++k) {
+      std::get<Index>(args[k]) = static_cast<Type>(1);
+      if (k < num) {
+        uint32_t index =
+            mids[Index].Divmod(inners[Index].Div(offset + k)).val[1];
+        std::get<Index>(args[k]) = in[index];
+      }
+    }
+  }
+};
+
+template <typename OutT, typename Functor, int Arity, int NumOuts, int VecSize>
+__global__ void BlockBroadcastKernel(
+    Array<const _ptr_ char *__restrict__, Arity> ins,
+    Array<_ptr_ OutT *, NumOuts> outs,
+    Array<kps::details::FastDivMod, Arity> inners,
+    Array<kps::details::FastDivMod, Arity> mids,
+    Array<int, Arity> load_types,
+    uint32_t numel,
+    Functor func) {
+  using Traits = phi::funcs::FunctionTraits<Functor>;
+  using ArgsT = typename Traits::ArgsTuple;
+  const uint32_t stride = blockDim.x * gridDim.x * VecSize;
+  for (uint32_t offset = (blockIdx.x * blockDim.x + threadIdx.x) * VecSize;
+       offset < numel;
+       offset += stride) {
+    const int num = min(static_cast<uint32_t>(VecSize), numel - offset);
+    ArgsT args[VecSize];
+    ConditionalT<OutT, NumOuts> result[VecSize];
+    Unroller<BlockBroadcastLoader, VecSize, Arity>::step(
+        ins, args, inners, mids, load_types, offset, num);
+    SameDimsElementwisePrimitiveCaller<ConditionalT<OutT, NumOuts>,
+                                       VecSize,
+                                       Functor,
+                                       ArgsT,
+                                       Arity>()(func, args, result, VecSize);
+#pragma unroll
+    for (int i = 0; i < NumOuts; ++i) {
+      phi::AlignedVector<OutT, VecSize> vec;
+#pragma unroll
+      for (int k = 0; k < VecSize; ++k) {
+        if constexpr (NumOuts == 1) {
+          vec[k] = result[k];
+        } else {
+          vec[k] = result[k][i];
+        }
+      }
+      if (num == VecSize) {
+        phi::Store<OutT, VecSize>(vec, outs[i] + offset);
+      } else {
+        for (int k = 0; k < num; ++k) {
+          outs[i][offset + k] = vec[k];
+        }
+      }
+    }
+  }
+}
+
+// Launches BlockBroadcastKernel if every input can be indexed as a block,
+// returns false otherwise.
+template <typename OutT, typename Functor, int Arity, int NumOuts, int VecSize>
+bool LaunchBlockBroadcastKernel(const KPDevice &ctx,
+                                const std::vector<const DenseTensor *> &ins,
+                                std::vector<DenseTensor *> *outs,
+                                int axis,
+                                Functor func) {
+  BlockBroadcastConfig<OutT, Functor, Arity, NumOuts> config;
+  if (!config.Init(ins, outs, axis, VecSize)) {
+    return false;
+  }
+  auto gpu_config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(ctx, config.numel, VecSize);
+  BlockBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSize>
+      <<<gpu_config.block_per_grid,
+         gpu_config.GetBlockSize(),
+         0,
+         ctx.stream()>>>(config.ins_data,
+                         config.outs_data,
+                         config.inners,
+                         config.mids,
+                         config.load_types,
+                         config.numel,
+                         func);
+  return true;
+}
+#endif
+
 template <typename OutT, typename Functor, int Arity, int NumOuts = 1>
 typename std::enable_if<!NeedVectorized<OutT>::value, void>::type
 BroadcastKernelForDifferentVecSize(const KPDevice &ctx,
@@ -540,6 +766,38 @@ BroadcastKernelForDifferentVecSize(const KPDevice &ctx,
   int vec_size = GetVectorizedSizeForTensors(ins, *outs);
 #endif
 
+#ifndef PADDLE_WITH_XPU_KP
+  bool all_elementwise = true;
+  for (auto *in : ins) {
+    all_elementwise &= in->numel() == (*outs)[0]->numel();
+  }
+  if (!all_elementwise) {
+    bool launched = false;
+    switch (vec_size) {
+      case VecSizeL:
+        launched =
+            LaunchBlockBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeL>(
+                ctx, ins, outs, axis, func);
+        break;
+      case VecSizeM:
+        launched =
+            LaunchBlockBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeM>(
+                ctx, ins, outs, axis, func);
+        break;
+      case VecSizeS:
+        launched =
+            LaunchBlockBroadcastKernel<OutT, Functor, Arity, NumOuts, VecSizeS>(
+                ctx, ins, outs, axis, func);
+        break;
+      default:
+        break;
+    }
+    if (launched) {
+      return;
+    }
+  }
+#endif
+
   auto classifier =
       BroadcastTypeClassifier<OutT, Functor, Arity, NumOuts>(ins, outs, axis);
   switch (vec_size) {
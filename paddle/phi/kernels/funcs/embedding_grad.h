@@ -14,8 +14,19 @@
 
 #pragma once
 
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
 
 namespace phi {
 namespace funcs {
@@ -163,5 +174,139 @@ void LaunchEmbeddingGradDeterministicKernel(const GPUContext& ctx,
   }
 }
 
+// Returns whether the gradient of an embedding table with N rows looked up
+// by K ids is better reduced by sorting the ids. When there are at least as
+// many ids as rows, the ids repeat heavily and the atomics of the same row
+// contend, especially for float16 and bfloat16.
+inline bool UseEmbeddingGradSortedKernel(int64_t N, int64_t K) {
+  return K >= N;
+}
+
+// Converts the ids to the rows of the table. The ids out of
+// [start_idx, start_idx + N) are mapped to N so that they are sorted to the
+// end and skipped.
+template <typename IdT>
+__global__ void EmbeddingGradSortKeysKernel(const IdT* ids,
+                                            const int64_t K,
+                                            const int64_t N,
+                                            const int64_t start_idx,
+                                            int64_t* rows,
+                                            int64_t* positions) {
+  CUDA_KERNEL_LOOP_TYPE(i, K, int64_t) {
+    int64_t row = static_cast<int64_t>(ids[i]);
+    if (start_idx >= 0) {
+      row = (row >= start_idx && row < start_idx + N) ? row - start_idx : N;
+    }
+    rows[i] = row;
+    positions[i] = i;
+  }
+}
+
+// Every block reduces the gradients of the ids of one row, which are
+// contiguous after sorting. The row is written once without atomics and the
+// gradients are summed in the order of the ids, so the result is
+// deterministic.
+template <typename T>
+__global__ void EmbeddingGradSortedSegmentKernel(T* table,
+                                                 const T* output,
+                                                 const int64_t* sorted_rows,
+                                                 const int64_t* positions,
+                                                 const int64_t K,
+                                                 const int64_t N,
+                                                 const int64_t D) {
+  using MT = typename dtype::MPTypeTrait<T>::Type;
+  __shared__ int64_t segment_end;
+  for (int64_t i = blockIdx.x; i < K; i += gridDim.x) {
+    int64_t row = sorted_rows[i];
+    if (row >= N || (i > 0 && sorted_rows[i - 1] == row)) {
+      continue;
+    }
+    if (threadIdx.x == 0) {
+      int64_t end = i + 1;
+      while (end < K && sorted_rows[end] == row) {
+        ++end;
+      }
+      segment_end = end;
+    }
+    __syncthreads();
+    for (int64_t col = threadIdx.x; col < D; col += blockDim.x) {
+      MT sum = static_cast<MT>(0);
+      for (int64_t j = i; j < segment_end; ++j) {
+        sum += static_cast<MT>(output[positions[j] * D + col]);
+      }
+      table[row * D + col] = static_cast<T>(sum);
+    }
+    __syncthreads();
+  }
+}
+
+// Sorts the ids with radix sort, reduces the gradients of every row and
+// scatters them to the zero-initialized d_table once. If start_idx is not
+// negative, only the ids in [start_idx, start_idx + N) are accumulated, which
+// is the vocabulary shard of the tensor parallel embedding.
+template <typename T, typename IdT>
+void LaunchEmbeddingGradSortedKernel(const GPUContext& ctx,
+                                     const IdT* ids,
+                                     const T* d_out,
+                                     T* d_table,
+                                     int64_t N,
+                                     int64_t D,
+                                     int64_t K,
+                                     int64_t start_idx = -1) {
+  if (K == 0) {
+    return;
+  }
+  auto stream = ctx.stream();
+  auto alloc_stream = phi::Stream(reinterpret_cast<phi::StreamId>(stream));
+  auto buffer = phi::memory_utils::Alloc(
+      ctx.GetPlace(), 4 * K * sizeof(int64_t), alloc_stream);
+  int64_t* rows = reinterpret_cast<int64_t*>(buffer->ptr());
+  int64_t* positions = rows + K;
+  int64_t* sorted_rows = positions + K;
+  int64_t* sorted_positions = sorted_rows + K;
+
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, K);
+  EmbeddingGradSortKeysKernel<IdT>
+      <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+          ids, K, N, start_idx, rows, positions);
+
+  // The rows are in [0, N], only the low bits need to be sorted.
+  int end_bit = 1;
+  while (end_bit < 64 && (int64_t{1} << end_bit) <= N) {
+    ++end_bit;
+  }
+  size_t temp_storage_bytes = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRadixSort::SortPairs<int64_t, int64_t>(nullptr,
+                                                        temp_storage_bytes,
+                                                        rows,
+                                                        sorted_rows,
+                                                        positions,
+                                                        sorted_positions,
+                                                        K,
+                                                        0,
+                                                        end_bit,
+                                                        stream));
+  auto temp_storage = phi::memory_utils::Alloc(
+      ctx.GetPlace(), temp_storage_bytes, alloc_stream);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRadixSort::SortPairs<int64_t, int64_t>(temp_storage->ptr(),
+                                                        temp_storage_bytes,
+                                                        rows,
+                                                        sorted_rows,
+                                                        positions,
+                                                        sorted_positions,
+                                                        K,
+                                                        0,
+                                                        end_bit,
+                                                        stream));
+
+  int64_t max_grid = ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(K, max_grid));
+  int threads = D >= 256 ? 256 : 128;
+  EmbeddingGradSortedSegmentKernel<T><<<grid, threads, 0, stream>>>(
+      d_table, d_out, sorted_rows, sorted_positions, K, N, D);
+}
+
 }  // namespace funcs
 }  // namespace phi
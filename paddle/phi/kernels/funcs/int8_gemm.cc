@@ -0,0 +1,85 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/funcs/int8_gemm.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_info.h"
+#ifdef PADDLE_WITH_MKLML
+#include "paddle/phi/backends/dynload/mklml.h"
+#endif
+
+namespace phi {
+namespace funcs {
+
+void Int8Gemm(int64_t M,
+              int64_t N,
+              int64_t K,
+              const int8_t* A,
+              const int8_t* B,
+              int32_t* C) {
+#ifdef PADDLE_WITH_MKLML
+  if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512_core_vnni)) {
+    // The first matrix of cblas_gemm_s8u8s32 is signed and the second one
+    // unsigned. C^T = B^T * A^T in column major is C in row major, so B is
+    // the signed matrix and A is shifted to unsigned with an offset of -128.
+    std::vector<uint8_t> a_u8(M * K);
+    for (int64_t i = 0; i < M * K; ++i) {
+      a_u8[i] = static_cast<uint8_t>(static_cast<int32_t>(A[i]) + 128);
+    }
+    const MKL_INT32 c_offset = 0;
+    phi::dynload::cblas_gemm_s8u8s32(CblasColMajor,
+                                     CblasNoTrans,
+                                     CblasNoTrans,
+                                     CblasFixOffset,
+                                     N,
+                                     M,
+                                     K,
+                                     1.0f,
+                                     B,
+                                     N,
+                                     0,
+                                     a_u8.data(),
+                                     K,
+                                     -128,
+                                     0.0f,
+                                     C,
+                                     N,
+                                     &c_offset);
+    return;
+  }
+#endif
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < M; ++i) {
+    int32_t* c_row = C + i * N;
+    std::fill(c_row, c_row + N, 0);
+    for (int64_t k = 0; k < K; ++k) {
+      const int32_t a = A[i * K + k];
+      if (a == 0) {
+        continue;
+      }
+      const int8_t* b_row = B + k * N;
+      for (int64_t j = 0; j < N; ++j) {
+        c_row[j] += a * static_cast<int32_t>(b_row[j]);
+      }
+    }
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,34 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace phi {
+namespace funcs {
+
+// C = A * B with int32 accumulation, A is [M, K], B is [K, N] and C is
+// [M, N], all row major. It runs on the int8 GEMM of MKL when the CPU has
+// AVX512-VNNI, whose dot products do not saturate, otherwise on a loop over
+// the rows of A.
+void Int8Gemm(int64_t M,
+              int64_t N,
+              int64_t K,
+              const int8_t* A,
+              const int8_t* B,
+              int32_t* C);
+
+}  // namespace funcs
+}  // namespace phi
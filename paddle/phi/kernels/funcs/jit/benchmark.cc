@@ -360,7 +360,7 @@ void BenchKernelSgd() {
 template <typename KernelTuple, typename PlaceType>
 void BenchKernelMatMul() {
   using T = typename KernelTuple::data_type;
-  for (int m : {1, 2, 3, 4}) {
+  for (int m : {1, 2, 3, 4, 8, 16}) {
     for (int n : TestSizes()) {
       for (int k : TestSizes()) {
         phi::DenseTensor a, b, c;
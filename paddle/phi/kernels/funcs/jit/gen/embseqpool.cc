@@ -24,7 +24,14 @@ namespace phi::jit::gen {
 
 void EmbSeqPoolJitCode::genCode() {
   preCode();
-  constexpr int block = YMM_FLOAT_BLOCK;
+  const bool use_zmm =
+      phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
+      tbl_w_ % ZMM_FLOAT_BLOCK == 0;
+  const int block = use_zmm ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
+  // the register of the width of the block, keeps the kind of zmm or ymm
+  auto jmm = [use_zmm](int idx) {
+    return use_zmm ? Xbyak::Xmm(zmm_t(idx)) : Xbyak::Xmm(ymm_t(idx));
+  };
   constexpr int max_num_regs = 8;
   const int num_block = tbl_w_ / block;
   const int num_groups = num_block / max_num_regs;
@@ -64,7 +71,7 @@ void EmbSeqPoolJitCode::genCode() {
       add(reg_ptr_tbl_i, param_tbl);  // reg is ptr_i now
       size_t w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ymm_t(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
+        vmovups(jmm(reg_i + num_regs), ptr[reg_ptr_tbl_i + w_offset]);
         w_offset += block_size;
       }
       add(reg_ptr_idx_i, reg_idx_width_in_byte);
@@ -89,9 +96,8 @@ void EmbSeqPoolJitCode::genCode() {
         add(reg_ptr_tbl_i, param_tbl);
         size_t w_offset = 0;
         for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-          vmovups(ymm_t(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
-          vaddps(
-              ymm_t(reg_i + num_regs), ymm_t(reg_i + num_regs), ymm_t(reg_i));
+          vmovups(jmm(reg_i), ptr[reg_ptr_tbl_i + w_offset]);
+          vaddps(jmm(reg_i + num_regs), jmm(reg_i + num_regs), jmm(reg_i));
           w_offset += block_size;
         }
         add(reg_ptr_idx_i, reg_idx_width_in_byte);
@@ -102,7 +108,7 @@ void EmbSeqPoolJitCode::genCode() {
       // avg or sqrt here, if needed
       w_offset = 0;
       for (int reg_i = 0; reg_i < num_regs; ++reg_i) {
-        vmovups(ptr[reg_ptr_dst_i + w_offset], ymm_t(reg_i + num_regs));
+        vmovups(ptr[reg_ptr_dst_i + w_offset], jmm(reg_i + num_regs));
         w_offset += block_size;
       }
       add(reg_ptr_dst_i, tbl_width_in_byte);
@@ -38,6 +38,12 @@ void MatMulJitCode::genCode() {
   // from packed mov(reg_ptr_wgt, ptr[param_attr + offsetof(matmul_attr_t,
   // packed_weight)]);
   mov(reg_ptr_wgt, param_y);
+  // the rows of x and z are looped at runtime, the code of one row is reused
+  Label l_next_row;
+  if (m_ > 1) {
+    mov(reg_row_i, 0);
+    L(l_next_row);
+  }
   size_t z_offset = 0;
   size_t wgt_offset = 0;
   for (size_t g = 0; g < groups.size(); ++g) {
@@ -101,13 +107,24 @@ void MatMulJitCode::genCode() {
     }
   }
 
+  if (m_ > 1) {
+    add(param_x, k_ * sizeof(float));
+    add(param_z, n_ * sizeof(float));
+    inc(reg_row_i);
+    cmp(reg_row_i, m_);
+    jl(l_next_row, T_NEAR);
+  }
+
   postCode();
 }
 
 class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
  public:
+  static constexpr int kMaxRows = 8;
+
   bool CanBeUsed(const matmul_attr_t& attr) const override {
-    return attr.m == 1 &&
+    // the weights are reloaded for every row, mkl is better for more rows
+    return attr.m <= kMaxRows &&
            phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f) &&
            attr.n % ZMM_FLOAT_BLOCK == 0 && attr.k < 512;
   }
@@ -116,7 +133,7 @@ class MatMulCreator : public JitCodeCreator<matmul_attr_t> {
     if (phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f)) {
       block = ZMM_FLOAT_BLOCK;
     }
-    return 96 + 4 * attr.k * (attr.n / block + 1) * 8;
+    return 128 + 4 * attr.k * (attr.n / block + 1) * 8;
   }
   std::unique_ptr<GenBase> CreateJitCode(
       const matmul_attr_t& attr) const override {
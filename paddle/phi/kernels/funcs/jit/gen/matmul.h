@@ -33,12 +33,6 @@ class MatMulJitCode : public JitCode {
                          size_t code_size = 256 * 1024,
                          void* code_ptr = nullptr)
       : JitCode(code_size, code_ptr), m_(attr.m), n_(attr.n), k_(attr.k) {
-    PADDLE_ENFORCE_EQ(m_,
-                      1,
-                      common::errors::Unimplemented(
-                          "Jitcode of matmul only support m==1 (first "
-                          "matrix's row) now. But m is %d.",
-                          m_));
     this->genCode();
   }
 
@@ -60,6 +54,7 @@ class MatMulJitCode : public JitCode {
   reg64_t reg_tmp{rax};
 
   reg64_t reg_ptr_wgt{r10};
+  reg64_t reg_row_i{r11};
 };
 
 }  // namespace gen
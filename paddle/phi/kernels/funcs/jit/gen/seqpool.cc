@@ -21,7 +21,8 @@
 namespace phi::jit::gen {
 
 void SeqPoolJitCode::genCode() {
-  constexpr int block = YMM_FLOAT_BLOCK;
+  const bool use_zmm = phi::backends::cpu::MayIUse(phi::backends::cpu::avx512f);
+  const int block = use_zmm ? ZMM_FLOAT_BLOCK : YMM_FLOAT_BLOCK;
   constexpr int max_num_regs = 8;
   const int num_block = w_ / block;
   const int num_groups = num_block / max_num_regs;
@@ -42,13 +43,27 @@ void SeqPoolJitCode::genCode() {
   }
   const int group_len = max_num_regs * block * sizeof(float);
   for (int g = 0; g < num_groups; ++g) {
-    pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    if (use_zmm) {
+      pool_height<zmm_t>(g * group_len, block, max_num_regs);
+    } else {
+      pool_height<ymm_t>(g * group_len, block, max_num_regs);
+    }
   }
   if (rest_num_regs > 0) {
-    pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    if (use_zmm) {
+      pool_height<zmm_t>(num_groups * group_len, block, rest_num_regs);
+    } else {
+      pool_height<ymm_t>(num_groups * group_len, block, rest_num_regs);
+    }
+  }
+  int rest = w_ % block;
+  if (rest >= YMM_FLOAT_BLOCK) {
+    // the half zmm block left by avx512
+    pool_height<ymm_t>(
+        static_cast<int>((w_ - rest) * sizeof(float)), YMM_FLOAT_BLOCK, 1);
+    rest -= YMM_FLOAT_BLOCK;
   }
   // part of rest_w * height
-  const int rest = w_ % block;
   pool_height_of_rest_width(
       rest, static_cast<int>((w_ - rest) * sizeof(float)), max_num_regs);
   ret();
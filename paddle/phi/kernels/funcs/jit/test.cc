@@ -656,8 +656,9 @@ void TestKernelMatMul() {
   // export MKL_CBWR=AVX would make MKL force to use AVX
   // export KMP_DETERMINISTIC_REDUCTION=yes would make the result deterministic
   FLAGS_acc = 1e-3;
-  for (int m : {1, 2, 3, 4}) {
-    for (int n : {1, 2, 3, 4}) {
+  // n of 16 and 32 and m up to 8 cover the avx512 jitcode
+  for (int m : {1, 2, 3, 4, 8}) {
+    for (int n : {1, 2, 3, 4, 16, 32}) {
       for (int k : TestSizes()) {
         auto ref = jit::GetReferFunc<KernelTuple>();
         EXPECT_TRUE(ref != nullptr);
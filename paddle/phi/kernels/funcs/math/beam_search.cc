@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include "paddle/phi/kernels/funcs/math/beam_search.h"
+
+#include <cmath>
+#include <limits>
+
 #include "glog/logging.h"
 #include "paddle/phi/backends/cpu/cpu_context.h"
 
@@ -227,6 +231,28 @@ class BeamSearchFunctor<phi::CPUContext, T> {
     top_beam[0] = item;
   }
 
+  /*
+   * The lowest input score that may enter the beam. A candidate enters a full
+   * beam when its score is not below the last one, the bound of the
+   * probabilities has a margin over the rounding of pre_score + log(p) so
+   * the skipped candidates are the ones the insertion would reject.
+   */
+  double ScoreBound(const std::vector<Item> &top_beam,
+                    size_t beam_size,
+                    float pre_score,
+                    bool is_accumulated) {
+    if (top_beam.size() < beam_size) {
+      return -std::numeric_limits<double>::infinity();
+    }
+    const double last = top_beam[beam_size - 1].score;
+    if (is_accumulated) {
+      return last;
+    }
+    const double margin =
+        1e-5 * (std::abs(last) + std::abs(static_cast<double>(pre_score)) + 1);
+    return std::exp(last - pre_score - margin);
+  }
+
   /*
    * For each source, select top beam_size records.
    */
@@ -239,8 +265,6 @@ class BeamSearchFunctor<phi::CPUContext, T> {
       size_t beam_size,
       int end_id,
       bool is_accumulated) {
-    std::vector<std::vector<Item>> result;
-
     // find the current candidates
     auto abs_lod = phi::ToAbsOffset(scores->lod());
 
@@ -256,7 +280,12 @@ class BeamSearchFunctor<phi::CPUContext, T> {
       seq_width *= scores->dims()[i];
     }
 
-    for (size_t seq_id = 0; seq_id < num_seqs; ++seq_id) {
+    std::vector<std::vector<Item>> result(num_seqs);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+    for (int64_t seq_id = 0; seq_id < static_cast<int64_t>(num_seqs);
+         ++seq_id) {
       size_t seq_offset_start = abs_lod[lod_level][seq_id];
       size_t seq_offset_end = abs_lod[lod_level][seq_id + 1];
 
@@ -274,18 +303,26 @@ class BeamSearchFunctor<phi::CPUContext, T> {
           Insert(&top_beam, item, beam_size);
         } else {
           size_t index = offset * seq_width;
+          // the scores below the bound can not enter the full beam, they are
+          // skipped before taking their log
+          double bound =
+              ScoreBound(top_beam, beam_size, pre_score, is_accumulated);
           for (size_t d = 0; d < seq_width; d++, index++) {
+            if (scores_data[index] < bound) {
+              continue;
+            }
             int64_t id = ids_data ? ids_data[index] : static_cast<int64_t>(d);
             float score = is_accumulated
                               ? scores_data[index]
                               : pre_score + std::log(scores_data[index]);
             Item item(offset, id, score);
             Insert(&top_beam, item, beam_size);
+            bound = ScoreBound(top_beam, beam_size, pre_score, is_accumulated);
           }
         }
       }
 
-      result.emplace_back(top_beam);
+      result[seq_id] = std::move(top_beam);
     }
 
     if (FLAGS_v == 3) {
@@ -14,7 +14,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <vector>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/tensor_utils.h"
 
@@ -178,5 +182,166 @@ void LaunchMultiTensorApplyKernel(
   }
 }
 
+// The tensors of a multi tensor apply packed into a table in device memory,
+// so any number of tensors is updated by one launch. Each block of the
+// persistent kernel walks the chunks of all the tensors with a grid stride
+// and sets chunk_id and tensor_id before calling the functor, which reads
+// the table like TensorAndBlockInfo.
+template <int N>
+struct TensorTableInfo {
+  void *const *tensor_addrs[N - 1];
+  const void *const *grads;
+  const int64_t *sizes;
+  // chunk_offsets[i] is the first chunk of the i-th tensor in all chunks
+  const int64_t *chunk_offsets;
+  int tensor_num;
+  int chunk_id;
+  int tensor_id;
+
+  DEVICE void GetChunkIdAndTensorId(int *chunk_id, int *tensor_id) const {
+    *chunk_id = this->chunk_id;
+    *tensor_id = this->tensor_id;
+  }
+};
+
+template <int N, typename Functor, typename... ArgTypes>
+__global__ void PersistentMultiTensorApplyCudaKernel(
+    int chunk_size,
+    int64_t chunk_num,
+    TensorTableInfo<N> t_info,
+    Functor functor,
+    ArgTypes... args) {
+  int tensor_id = 0;
+  for (int64_t chunk = blockIdx.x; chunk < chunk_num; chunk += gridDim.x) {
+    // the chunks of a block only move forward, so does the tensor
+    int lo = tensor_id;
+    int hi = t_info.tensor_num - 1;
+    while (lo < hi) {
+      int mid = (lo + hi + 1) / 2;
+      if (t_info.chunk_offsets[mid] <= chunk) {
+        lo = mid;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    tensor_id = lo;
+    t_info.tensor_id = tensor_id;
+    t_info.chunk_id = static_cast<int>(chunk - t_info.chunk_offsets[tensor_id]);
+    functor(chunk_size, t_info, args...);
+  }
+}
+
+// Launches functor over all the chunks of the tensors of input_vector with a
+// single persistent kernel, the grid is sized to fill the device once and
+// the tensor addresses go to the device with one copy. It replaces the
+// launch per group of MaxTensorSize tensors of LaunchMultiTensorApplyKernel,
+// which dominates the update of many small parameters.
+template <int InputNum,
+          typename Functor,
+          typename Context,
+          typename... ArgTypes>
+void LaunchPersistentMultiTensorApplyKernel(
+    const Context &dev_ctx,
+    int block_size,
+    int chunk_size,
+    const std::vector<std::vector<DenseTensor *>> &input_vector,
+    const std::vector<const DenseTensor *> &grads,
+    Functor functor,
+    ArgTypes... args) {
+  PADDLE_ENFORCE_EQ(
+      input_vector.size(),
+      InputNum - 1,
+      errors::InvalidArgument(
+          "input_vector.size() != InputNum - 1, the input vector's size is "
+          "unequal to InputNum - 1, please cheack grads, params, momemts1, "
+          "moments2, moments2_max(if use amsgrad), and, master_params."));
+  const size_t tensor_num = input_vector[0].size();
+  PADDLE_ENFORCE_GT(
+      tensor_num,
+      0,
+      errors::InvalidArgument(
+          "input_vector[0].size() is not > 0, please cheack params."));
+  auto place = input_vector[0][0]->place();
+  for (size_t i = 0; i < input_vector.size(); i++) {
+    PADDLE_ENFORCE_EQ(
+        input_vector[i].size(),
+        tensor_num,
+        errors::InvalidArgument(
+            "some input vectors' size mismatch other input vector."));
+    for (size_t j = 0; j < tensor_num; j++) {
+      PADDLE_ENFORCE_EQ(
+          input_vector[i][j]->place(),
+          place,
+          errors::InvalidArgument(
+              "A tensor was not on the same device as the first tensor"));
+      PADDLE_ENFORCE_EQ(input_vector[i][j]->numel(),
+                        input_vector[0][j]->numel(),
+                        errors::InvalidArgument(
+                            "The number of elements of Inputs must be equal."));
+    }
+  }
+
+  // the table holds the addresses of the N - 1 inputs and of the grads, the
+  // sizes and the chunk offsets, one word per tensor each
+  const size_t table_words = (InputNum + 2) * tensor_num + 1;
+  const auto &cpu_place = phi::CPUPlace();
+  auto h_table_mem =
+      phi::memory_utils::Alloc(cpu_place, table_words * sizeof(int64_t));
+  int64_t *h_table = reinterpret_cast<int64_t *>(h_table_mem->ptr());
+  void **h_addrs = reinterpret_cast<void **>(h_table);
+  const void **h_grads =
+      reinterpret_cast<const void **>(h_table + (InputNum - 1) * tensor_num);
+  int64_t *h_sizes = h_table + InputNum * tensor_num;
+  int64_t *h_chunk_offsets = h_table + (InputNum + 1) * tensor_num;
+
+  h_chunk_offsets[0] = 0;
+  for (size_t t = 0; t < tensor_num; t++) {
+    for (int d = 0; d < InputNum - 1; d++) {
+      h_addrs[d * tensor_num + t] = input_vector[d][t]->data();
+    }
+    h_grads[t] = grads[t]->data();
+    h_sizes[t] = input_vector[0][t]->numel();
+    h_chunk_offsets[t + 1] =
+        h_chunk_offsets[t] + (h_sizes[t] + chunk_size - 1) / chunk_size;
+  }
+  const int64_t chunk_num = h_chunk_offsets[tensor_num];
+  if (chunk_num == 0) {
+    return;
+  }
+
+  auto d_table_mem = phi::memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      table_words * sizeof(int64_t),
+      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+  int64_t *d_table = reinterpret_cast<int64_t *>(d_table_mem->ptr());
+  memory_utils::Copy(dev_ctx.GetPlace(),
+                     d_table,
+                     cpu_place,
+                     h_table,
+                     table_words * sizeof(int64_t),
+                     dev_ctx.stream());
+
+  TensorTableInfo<InputNum> t_info;
+  for (int d = 0; d < InputNum - 1; d++) {
+    t_info.tensor_addrs[d] =
+        reinterpret_cast<void *const *>(d_table + d * tensor_num);
+  }
+  t_info.grads = reinterpret_cast<const void *const *>(
+      d_table + (InputNum - 1) * tensor_num);
+  t_info.sizes = d_table + InputNum * tensor_num;
+  t_info.chunk_offsets = d_table + (InputNum + 1) * tensor_num;
+  t_info.tensor_num = static_cast<int>(tensor_num);
+  t_info.chunk_id = 0;
+  t_info.tensor_id = 0;
+
+  const int max_blocks =
+      std::max(dev_ctx.GetMaxPhysicalThreadCount() / block_size, 1);
+  const int grid_size =
+      static_cast<int>(std::min<int64_t>(chunk_num, max_blocks));
+  PersistentMultiTensorApplyCudaKernel<InputNum, Functor, ArgTypes...>
+      <<<grid_size, block_size, 0, dev_ctx.stream()>>>(
+          chunk_size, chunk_num, t_info, functor, args...);
+}
+
 }  // namespace funcs
 }  // namespace phi
@@ -19,6 +19,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <set>
 #include <vector>
@@ -37,6 +38,9 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_device_function.h"
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/kernels/autotune/cache.h"
+#include "paddle/phi/kernels/autotune/gpu_timer.h"
+#include "paddle/phi/kernels/autotune/switch_autotune.h"
 #endif
 
 #include "paddle/phi/kernels/cast_kernel.h"
@@ -49,6 +53,9 @@ namespace cub = hipcub;
 // Reduce split or not, Whether to use ReduceHigherDim
 #define REDUCE_SPLIT_BOUNDARY 512
 #define REDUCE_VEC_SIZE 4
+// Whether the split of a long row for kReduceLastDim is tuned
+#define REDUCE_LONG_ROW_BOUNDARY 8192
+#define REDUCE_MIN_NUM_PER_THREAD 16
 
 namespace kps = phi::kps;
 #ifdef PADDLE_WITH_XPU_KP
@@ -281,6 +288,29 @@ struct ReduceConfig {
                ? kps::details::kReduceMaxThread
                : details::GetLastPow2(block_dim);
   }
+
+  // Only a few rows are reduced but every row is long, the blocks of a row
+  // along grid.y decide how well the device is used.
+  bool IsLongRowReduce(const KPDevice& dev_ctx) const {
+    return reduce_type == static_cast<int>(ReduceType::kReduceLastDim) &&
+           left_num < dev_ctx.GetSMCount() &&
+           reduce_num >= REDUCE_LONG_ROW_BOUNDARY;
+  }
+
+  // Every thread reduces at least REDUCE_MIN_NUM_PER_THREAD elements.
+  int GetMaxInputSplit(const KPDevice& dev_ctx) const {
+    int max_split = details::CeilingDiv(
+        reduce_num, static_cast<int>(block.x) * REDUCE_MIN_NUM_PER_THREAD);
+    int max_grid_y = static_cast<int>(dev_ctx.GetCUDAMaxGridDimSize()[1]);
+    return std::max(std::min(max_split, max_grid_y), 1);
+  }
+
+  // Splits every row into input_split parts reduced by different blocks, the
+  // partial results are reduced again.
+  void SetInputSplit(int input_split) {
+    grid.y = input_split;
+    should_reduce_again = input_split > 1;
+  }
 #endif  // PADDLE_WITH_XPU_KP
 
   // If should_reduce_again, we need malloc temp space for temp data
@@ -432,7 +462,7 @@ struct ReduceConfig {
 
 #ifndef PADDLE_WITH_XPU_KP
   void SetBlockDimForReduceAny(dim3* block_dim, dim3* grid_dim) {
-    constexpr int min_reduce_num_per_thread = 16;
+    constexpr int min_reduce_num_per_thread = REDUCE_MIN_NUM_PER_THREAD;
     constexpr int max_reduce_num_per_thread = 256;
     constexpr int max_num_threads = kps::details::kReduceMaxThread;
 
@@ -926,6 +956,83 @@ static void LaunchReduceKernel(const Tx* x_data,
 
 #if !defined(PADDLE_WITH_XPU_KP)
 
+// The split of the long rows is chosen by the heuristic of
+// SetBlockDimForReduceAny, which ignores the cost of the second pass. When
+// autotune is on, the power-of-two splits are measured and the fastest one
+// is cached by the shape and dtypes of the reduction.
+template <typename Tx,
+          typename Ty,
+          typename MPType,
+          typename ReduceOp,
+          typename TransformOp>
+static void TuneReduceInputSplit(const KPDevice& dev_ctx,
+                                 const Tx* x_data,
+                                 Ty* y_data,
+                                 const ReduceOp& reducer,
+                                 const TransformOp& transform,
+                                 MPType init,
+                                 ReduceConfig<Ty, MPType>* config,
+                                 bool is_mean) {
+  size_t key =
+      phi::autotune::ReduceSplitKey(config->left_num,
+                                    config->reduce_num,
+                                    phi::CppTypeToDataType<Tx>::Type(),
+                                    phi::CppTypeToDataType<Ty>::Type());
+  auto& cache = phi::autotune::AutoTuneCache::Instance().Get(
+      phi::autotune::AlgorithmType::kReduceSplit);
+  if (cache.Find(key)) {
+    config->SetInputSplit(static_cast<int>(cache.Get(key)));
+    return;
+  }
+  if (!phi::autotune::AutoTuneStatus::Instance().UseAutoTune()) {
+    return;
+  }
+
+  int max_split = config->GetMaxInputSplit(dev_ctx);
+  std::vector<int> candidates = {static_cast<int>(config->grid.y)};
+  for (int split = 1; split <= max_split; split *= 2) {
+    if (split != candidates[0]) {
+      candidates.push_back(split);
+    }
+  }
+  int max_candidate = *std::max_element(candidates.begin(), candidates.end());
+  phi::DenseTensor tmp = phi::Empty<MPType, phi::GPUContext>(
+      dev_ctx,
+      {static_cast<int64_t>(config->left_num) * config->grid.z *
+       max_candidate});
+  config->tmp_data = tmp.data<MPType>();
+
+  // The first run of every candidate is regarded as warmup.
+  constexpr int repeats = 5;
+  auto stream = dev_ctx.stream();
+  phi::GpuTimer timer;
+  int best_split = candidates[0];
+  float min_time = std::numeric_limits<float>::max();
+  dev_ctx.Wait();
+  for (int split : candidates) {
+    config->SetInputSplit(split);
+    LaunchReduceKernel<Tx, Ty, MPType, ReduceOp, TransformOp>(
+        x_data, y_data, reducer, transform, init, stream, *config, is_mean);
+    timer.Start(stream);
+    for (int i = 0; i < repeats; ++i) {
+      LaunchReduceKernel<Tx, Ty, MPType, ReduceOp, TransformOp>(
+          x_data, y_data, reducer, transform, init, stream, *config, is_mean);
+    }
+    timer.Stop(stream);
+    float time = timer.ElapsedTime();
+    VLOG(3) << "reduce [" << config->left_num << ", " << config->reduce_num
+            << "] with input split " << split << " costs " << time << " ms";
+    if (time < min_time) {
+      min_time = time;
+      best_split = split;
+    }
+  }
+  VLOG(3) << "best input split of reduce [" << config->left_num << ", "
+          << config->reduce_num << "] is " << best_split;
+  cache.Set(key, best_split);
+  config->SetInputSplit(best_split);
+}
+
 template <typename Tx,
           typename Ty,
           template <typename>
@@ -1091,7 +1198,6 @@ void ReduceKernel(const KPDevice& dev_ctx,
     return;
   }
 
-  config.SetOutputData(y_data, dev_ctx, &tmp);
   constexpr bool kIsTxFP16 = std::is_same<Tx, phi::dtype::float16>::value;
   constexpr bool kIsTxBF16 = std::is_same<Tx, phi::dtype::bfloat16>::value;
   bool use_cub_reduce = config.reduce_num == numel && !kIsTxFP16 && !kIsTxBF16;
@@ -1105,6 +1211,20 @@ void ReduceKernel(const KPDevice& dev_ctx,
 #endif
 
   auto reducer = ReduceOp<MPType>();
+#ifndef PADDLE_WITH_XPU_KP
+  if (config.IsLongRowReduce(dev_ctx)) {
+    TuneReduceInputSplit<Tx, Ty, MPType, ReduceOp<MPType>, TransformOp>(
+        dev_ctx,
+        x_data,
+        y_data,
+        reducer,
+        transform,
+        reducer.initial(),
+        &config,
+        IsMean);
+  }
+#endif
+  config.SetOutputData(y_data, dev_ctx, &tmp);
   // launch ReduceHigherDimKernel
   // when reduce_dim.size() == 1 and reduce_dim[0] != x_dim.size() - 1, this
   // function will be used
@@ -16,12 +16,25 @@ limitations under the License. */
 #include <unordered_set>
 #include <vector>
 
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include "paddle/common/flags.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/common/memory_utils.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
+COMMON_DECLARE_bool(cudnn_deterministic);
+
 namespace phi {
 namespace funcs {
 
@@ -125,6 +138,143 @@ __global__ void ScatterNdCUDAKernel(const T* update,
   }
 }
 
+template <typename IndexT>
+__global__ void ScatterSortKeysCUDAKernel(const IndexT* indices,
+                                          int64_t output_count,
+                                          int64_t index_size,
+                                          int64_t* rows) {
+  CUDA_KERNEL_LOOP_TYPE(i, index_size, int64_t) {
+    IndexT scatter_i = indices[i];
+
+    PADDLE_ENFORCE(
+        scatter_i >= -output_count && scatter_i < output_count,
+        "The index is out of bounds, "
+        "please check whether the dimensions of index and "
+        "input meet the requirements. It should "
+        "be less than [%ld] and greater or equal to [%ld], but received [%d]",
+        output_count,
+        -output_count,
+        scatter_i);
+    if (scatter_i < 0) {
+      scatter_i += output_count;
+    }
+    rows[i] = static_cast<int64_t>(scatter_i);
+  }
+}
+
+template <typename IndexT>
+__global__ void ScatterPositionsCUDAKernel(int64_t num_keys,
+                                           IndexT* positions) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_keys, int64_t) {
+    positions[i] = static_cast<IndexT>(i);
+  }
+}
+
+// Every thread adds the slices scattered to one row at one offset of the
+// slice. The keys of a row are contiguous after the stable sort and are
+// summed in their original order, so the result is deterministic.
+template <typename T>
+__global__ void ScatterAddSortedSegmentCUDAKernel(const T* src,
+                                                  const int64_t* sorted_rows,
+                                                  const int64_t* positions,
+                                                  int64_t num_keys,
+                                                  int64_t slice_size,
+                                                  bool single_src,
+                                                  T* output) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  CUDA_KERNEL_LOOP_TYPE(index, num_keys * slice_size, int64_t) {
+    int64_t i = index / slice_size;
+    int64_t slice_i = index - i * slice_size;
+    int64_t row = sorted_rows[i];
+    if (i > 0 && sorted_rows[i - 1] == row) {
+      continue;
+    }
+    int64_t out_i = row * slice_size + slice_i;
+    MT sum = static_cast<MT>(output[out_i]);
+    for (int64_t j = i; j < num_keys && sorted_rows[j] == row; ++j) {
+      sum += static_cast<MT>(
+          src[single_src ? 0 : positions[j] * slice_size + slice_i]);
+    }
+    output[out_i] = static_cast<T>(sum);
+  }
+}
+
+/**
+ * Adds the slices of src to the rows of output without atomics:
+ *   output[rows[i]] += src[i]
+ * The rows in [0, row_bound) are radix sorted with their positions, then the
+ * slices of every row are reduced in order, so the result is deterministic
+ * and still runs in parallel over the distinct rows. If single_src is true,
+ * src holds a single value added for every key.
+ */
+template <typename T>
+void GPUScatterAddSorted(const phi::GPUContext& ctx,
+                         const int64_t* rows,
+                         int64_t num_keys,
+                         int64_t row_bound,
+                         const T* src,
+                         bool single_src,
+                         int64_t slice_size,
+                         T* output) {
+  if (num_keys == 0 || slice_size == 0) {
+    return;
+  }
+  auto stream = ctx.stream();
+  auto alloc_stream = phi::Stream(reinterpret_cast<phi::StreamId>(stream));
+  auto buffer = phi::memory_utils::Alloc(
+      ctx.GetPlace(), 3 * num_keys * sizeof(int64_t), alloc_stream);
+  int64_t* positions = reinterpret_cast<int64_t*>(buffer->ptr());
+  int64_t* sorted_rows = positions + num_keys;
+  int64_t* sorted_positions = sorted_rows + num_keys;
+
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, num_keys);
+  ScatterPositionsCUDAKernel<int64_t>
+      <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+          num_keys, positions);
+
+  // The rows are in [0, row_bound), only the low bits need to be sorted.
+  int end_bit = 1;
+  while (end_bit < 64 && (int64_t{1} << end_bit) < row_bound) {
+    ++end_bit;
+  }
+  size_t temp_storage_bytes = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRadixSort::SortPairs<int64_t, int64_t>(nullptr,
+                                                        temp_storage_bytes,
+                                                        rows,
+                                                        sorted_rows,
+                                                        positions,
+                                                        sorted_positions,
+                                                        num_keys,
+                                                        0,
+                                                        end_bit,
+                                                        stream));
+  auto temp_storage = phi::memory_utils::Alloc(
+      ctx.GetPlace(), temp_storage_bytes, alloc_stream);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      cub::DeviceRadixSort::SortPairs<int64_t, int64_t>(temp_storage->ptr(),
+                                                        temp_storage_bytes,
+                                                        rows,
+                                                        sorted_rows,
+                                                        positions,
+                                                        sorted_positions,
+                                                        num_keys,
+                                                        0,
+                                                        end_bit,
+                                                        stream));
+
+  config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, num_keys * slice_size);
+  ScatterAddSortedSegmentCUDAKernel<T>
+      <<<config.block_per_grid, config.thread_per_block, 0, stream>>>(
+          src,
+          sorted_rows,
+          sorted_positions,
+          num_keys,
+          slice_size,
+          single_src,
+          output);
+}
+
 /**
  * A thin wrapper on gpu tensor
  * Return a new updated tensor from source tensor, scatter-assigned according to
@@ -187,6 +337,29 @@ void GPUScatterAssign(const phi::GPUContext& ctx,
         p_index, p_output, output_dims[0], index_size, slice_size);
   }
 
+  // The atomics of the accumulation are not deterministic when the indices
+  // repeat, add the sorted slices instead.
+  if (!overwrite && FLAGS_cudnn_deterministic) {
+    auto rows = phi::memory_utils::Alloc(
+        ctx.GetPlace(),
+        index_size * sizeof(int64_t),
+        phi::Stream(reinterpret_cast<phi::StreamId>(ctx.stream())));
+    int64_t* p_rows = reinterpret_cast<int64_t*>(rows->ptr());
+    auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, index_size);
+    ScatterSortKeysCUDAKernel<IndexT>
+        <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+            p_index, output_dims[0], index_size, p_rows);
+    GPUScatterAddSorted<T>(ctx,
+                           p_rows,
+                           index_size,
+                           output_dims[0],
+                           p_src,
+                           false,
+                           static_cast<int64_t>(slice_size),
+                           p_output);
+    return;
+  }
+
   ScatterCUDAKernel<T, IndexT><<<grid, block, 0, ctx.stream()>>>(p_src,
                                                                  p_index,
                                                                  p_output,
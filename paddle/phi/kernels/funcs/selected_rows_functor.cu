@@ -12,12 +12,14 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
-#include <set>
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/bfloat16.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
@@ -344,29 +346,77 @@ namespace scatter {
 
 template <typename T, int block_size>
 __global__ void MergeAddKernel(const T* input,
-                               const int64_t* input_rows,
+                               const int64_t* out_index,
                                T* out,
-                               const int64_t* out_rows,
-                               size_t out_rows_size,
                                int64_t row_numel) {
-  const int ty = blockIdx.x;
+  const int64_t ty = blockIdx.x;
   int tid = threadIdx.x;
-  __shared__ size_t out_idx;
 
-  if (tid == 0) {
-    for (size_t i = 0; i < out_rows_size; i++) {
-      if (input_rows[ty] == out_rows[i]) {
-        out_idx = i;
-      }
-    }
+  input += ty * row_numel;
+  out += out_index[ty] * row_numel;
+  for (int64_t index = tid; index < row_numel; index += block_size) {
+    phi::CudaAtomicAdd(out + index, input[index]);
   }
+}
 
-  __syncthreads();
+// Sums the input rows of every merged row without atomics, the input rows
+// of the ty-th merged row are segment_rows[segment_offsets[ty]] to
+// segment_rows[segment_offsets[ty + 1] - 1].
+template <typename T, int block_size>
+__global__ void SegmentMergeAddKernel(const T* input,
+                                      const int64_t* segment_rows,
+                                      const int64_t* segment_offsets,
+                                      T* out,
+                                      int64_t row_numel) {
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int64_t ty = blockIdx.x;
+  const int64_t begin = segment_offsets[ty];
+  const int64_t end = segment_offsets[ty + 1];
+
+  out += ty * row_numel;
+  for (int64_t index = threadIdx.x; index < row_numel; index += block_size) {
+    MT sum = static_cast<MT>(0);
+    for (int64_t i = begin; i < end; ++i) {
+      sum += static_cast<MT>(input[segment_rows[i] * row_numel + index]);
+    }
+    out[index] = static_cast<T>(sum);
+  }
+}
 
-  input += ty * row_numel;
-  out += out_idx * row_numel;
-  for (int index = tid; index < row_numel; index += block_size) {
-    phi::CudaAtomicAdd(out + index, input[index]);
+// The merged rows are summed by segments rather than with atomics once an
+// output row gets at least this many input rows on average, the atomics on
+// the same row serialize.
+constexpr int64_t kSegmentMergeMinDuplication = 2;
+
+// Finds the merged rows of the rows of all inputs with a hash map, sorted,
+// and the position in them of every input row, which saves looking up each
+// input row in the merged rows on the device.
+inline void HashMergeRows(
+    const std::vector<const phi::Vector<int64_t>*>& rows_list,
+    std::vector<int64_t>* merge_rows,
+    std::vector<int64_t>* out_index) {
+  std::unordered_map<int64_t, int64_t> row_to_index;
+  size_t rows_num = 0;
+  for (auto* rows : rows_list) {
+    rows_num += rows->size();
+  }
+  row_to_index.reserve(rows_num);
+  for (auto* rows : rows_list) {
+    for (int64_t row : *rows) {
+      if (row_to_index.emplace(row, 0).second) {
+        merge_rows->push_back(row);
+      }
+    }
+  }
+  std::sort(merge_rows->begin(), merge_rows->end());
+  for (size_t i = 0; i < merge_rows->size(); ++i) {
+    row_to_index[(*merge_rows)[i]] = static_cast<int64_t>(i);
+  }
+  out_index->reserve(rows_num);
+  for (auto* rows : rows_list) {
+    for (int64_t row : *rows) {
+      out_index->push_back(row_to_index[row]);
+    }
   }
 }
 
@@ -384,45 +434,71 @@ struct MergeAddImpl {
                   const phi::SelectedRows& input,
                   phi::SelectedRows* output,
                   const bool sorted_result = false) {
-    phi::Vector<int64_t> input_rows(input.rows());
+    const phi::Vector<int64_t>& input_rows = input.rows();
     if (input_rows.size() == 0) {
       return;
     }
 
     phi::SelectedRows& out = *output;
-    std::set<int64_t> row_set(input_rows.begin(), input_rows.end());
-    std::vector<int64_t> merge_rows_cpu(row_set.begin(), row_set.end());
+    std::vector<int64_t> merge_rows_cpu;
+    std::vector<int64_t> out_index;
+    HashMergeRows({&input_rows}, &merge_rows_cpu, &out_index);
     phi::Vector<int64_t> merge_rows(merge_rows_cpu);
 
     auto input_width = input.value().dims()[1];
+    const int64_t input_rows_num = static_cast<int64_t>(input_rows.size());
+    const int64_t merge_rows_num = static_cast<int64_t>(merge_rows.size());
 
     out.set_rows(merge_rows);
     out.set_height(input.height());
     DenseTensor* out_tensor = out.mutable_value();
-    out_tensor->Resize(common::make_ddim(
-        {static_cast<int64_t>(merge_rows.size()), input_width}));
+    out_tensor->Resize(common::make_ddim({merge_rows_num, input_width}));
     context.template Alloc<T>(out_tensor);
 
-    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
-    constant_functor(context, out.mutable_value(), static_cast<T>(0));
-
     auto* out_data = out.mutable_value()->data<T>();
     auto* input_data = input.value().data<T>();
 
     const int block_size = 256;
     dim3 threads(block_size, 1);
-    dim3 grid1(input_rows.size(), 1);
 
-    phi::MixVector<int64_t> mix_vector_input(&input_rows);
-    phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
+    if (input_rows_num >= kSegmentMergeMinDuplication * merge_rows_num) {
+      // counting sort of the input rows by merged row, the offsets of the
+      // segments go after the rows
+      std::vector<int64_t> segment_cpu(input_rows_num + merge_rows_num + 1, 0);
+      int64_t* segment_offsets = segment_cpu.data() + input_rows_num;
+      for (int64_t index : out_index) {
+        ++segment_offsets[index + 1];
+      }
+      for (int64_t i = 0; i < merge_rows_num; ++i) {
+        segment_offsets[i + 1] += segment_offsets[i];
+      }
+      std::vector<int64_t> fill(segment_offsets,
+                                segment_offsets + merge_rows_num);
+      for (int64_t i = 0; i < input_rows_num; ++i) {
+        segment_cpu[fill[out_index[i]]++] = i;
+      }
+      phi::Vector<int64_t> segment(segment_cpu);
+      phi::MixVector<int64_t> mix_vector_segment(&segment);
+      const int64_t* segment_data =
+          mix_vector_segment.CUDAData(context.GetPlace());
+      const int64_t* offsets_data = segment_data + input_rows_num;
+      dim3 grid(merge_rows_num, 1);
+      SegmentMergeAddKernel<T, 256><<<grid, threads, 0, context.stream()>>>(
+          input_data, segment_data, offsets_data, out_data, input_width);
+      return;
+    }
+
+    phi::funcs::SetConstant<DeviceContext, T> constant_functor;
+    constant_functor(context, out.mutable_value(), static_cast<T>(0));
+
+    phi::Vector<int64_t> index(out_index);
+    phi::MixVector<int64_t> mix_vector_index(&index);
+    dim3 grid1(input_rows_num, 1);
     MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
         input_data,
-        mix_vector_input.CUDAData(context.GetPlace()),
+        mix_vector_index.CUDAData(context.GetPlace()),
         out_data,
-        mix_vector_out.CUDAMutableData(context.GetPlace()),
-        out.rows().size(),
         input_width);
-    mix_vector_out.CopyToCPU();
   }
 
   void operator()(const DeviceContext& context,
@@ -447,7 +523,7 @@ struct MergeAddImpl {
     auto input_width = has_value_input->value().dims()[1];
     auto input_height = has_value_input->height();
     phi::SelectedRows& out = *output;
-    std::set<int64_t> merged_row_set;
+    std::vector<const phi::Vector<int64_t>*> rows_list;
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
         continue;
@@ -461,10 +537,11 @@ struct MergeAddImpl {
                         input->height(),
                         common::errors::InvalidArgument(
                             "All input should have same height."));
-      merged_row_set.insert(input->rows().begin(), input->rows().end());
+      rows_list.push_back(&input->rows());
     }
-    std::vector<int64_t> merge_rows_cpu(merged_row_set.begin(),
-                                        merged_row_set.end());
+    std::vector<int64_t> merge_rows_cpu;
+    std::vector<int64_t> out_index;
+    HashMergeRows(rows_list, &merge_rows_cpu, &out_index);
     phi::Vector<int64_t> merge_rows(merge_rows_cpu);
 
     out.set_rows(merge_rows);
@@ -483,24 +560,18 @@ struct MergeAddImpl {
     const int block_size = 256;
     dim3 threads(block_size, 1);
 
+    phi::Vector<int64_t> index(out_index);
+    phi::MixVector<int64_t> mix_vector_index(&index);
+    const int64_t* index_data = mix_vector_index.CUDAData(context.GetPlace());
     for (auto* input : inputs) {
       if (input->rows().size() == 0) {
         continue;
       }
       auto* input_data = input->value().data<T>();
-      auto& input_rows = input->rows();
-      dim3 grid1(input_rows.size(), 1);
-
-      phi::MixVector<int64_t> mix_vector_input(&input_rows);
-      phi::MixVector<int64_t> mix_vector_out(out.mutable_rows());
+      dim3 grid1(input->rows().size(), 1);
       MergeAddKernel<T, 256><<<grid1, threads, 0, context.stream()>>>(
-          input_data,
-          mix_vector_input.CUDAData(context.GetPlace()),
-          out_data,
-          mix_vector_out.CUDAMutableData(context.GetPlace()),
-          out.rows().size(),
-          input_width);
-      mix_vector_out.CopyToCPU();
+          input_data, index_data, out_data, input_width);
+      index_data += input->rows().size();
     }
   }
 };
@@ -230,6 +230,24 @@ template <class DeviceContext>
 using enable_if_CPU = typename std::enable_if<
     std::is_same<DeviceContext, phi::CPUContext>::value>::type;
 
+// The softmax of a row of num_classes with the avx vector functions, in and
+// out may be the same row. The rows are independent, so the callers run
+// them in parallel.
+template <typename T>
+inline void VecSoftmaxRow(const int num_classes, const T* in, T* out) {
+  T max_val = *std::max_element(in, in + num_classes);
+  max_val *= static_cast<T>(-1);
+  vec_add_bias<T, phi::backends::cpu::avx>(num_classes, max_val, in, out);
+  vec_clip<T, phi::backends::cpu::avx>(
+      num_classes, static_cast<T>(-64), out, out);
+  vec_exp<T>(num_classes, out, out);
+
+  T sum = 0;
+  vec_sum<T, phi::backends::cpu::avx>(num_classes, out, &sum);
+  sum = static_cast<T>(1) / sum;
+  vec_scal<T, phi::backends::cpu::avx>(num_classes, sum, out, out);
+}
+
 template <typename DeviceContext, typename T>
 class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
  public:
@@ -249,23 +267,12 @@ class SoftmaxFunctor<DeviceContext, T, enable_if_CPU<DeviceContext>> {
         phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
       const T* in_data = X->data<T>();
       T* out_data = Y->data<T>();
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
       for (int bs = 0; bs < batch_size; ++bs) {
-        T max_val = *std::max_element(in_data, in_data + num_classes);
-        max_val *= static_cast<T>(-1);
-        vec_add_bias<T, phi::backends::cpu::avx>(
-            num_classes, max_val, in_data, out_data);
-        vec_clip<T, phi::backends::cpu::avx>(
-            num_classes, static_cast<T>(-64), out_data, out_data);
-        vec_exp<T>(num_classes, out_data, out_data);
-
-        T sum = 0;
-        vec_sum<T, phi::backends::cpu::avx>(num_classes, out_data, &sum);
-        sum = static_cast<T>(1) / sum;
-        vec_scal<T, phi::backends::cpu::avx>(
-            num_classes, sum, out_data, out_data);
-
-        in_data += num_classes;
-        out_data += num_classes;
+        const int64_t offset = static_cast<int64_t>(bs) * num_classes;
+        VecSoftmaxRow<T>(num_classes, in_data + offset, out_data + offset);
       }
     } else {
       SoftmaxEigen<DeviceContext, T>()(context, axis_dim, X, Y);
@@ -0,0 +1,387 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "paddle/common/ddim.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/backends/gpu/gpu_primitives.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/sparse_csr_tensor.h"
+#include "paddle/phi/core/visit_type.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+COMMON_DECLARE_double(sparse_csr_balanced_matmul_threshold);
+
+namespace phi {
+namespace funcs {
+namespace sparse {
+
+/* SpMM and SDDMM for batched SparseCsrTensor that split the work evenly over
+ * nonzeros instead of rows, so that a few long rows do not serialize a whole
+ * block as in the row-per-thread schedule of cuSPARSE. The batch layout is the
+ * same as the strided batch of cuSPARSE: crows holds batch * (rows + 1)
+ * offsets relative to each batch, and every batch holds nnz / batch nonzeros.
+ * Rows are numbered globally over the batch.
+ */
+
+template <typename IntT>
+__device__ __forceinline__ int64_t CsrRowEnd(const IntT* crows,
+                                             int64_t row,
+                                             int64_t rows,
+                                             int64_t batch_nnz) {
+  int64_t b = row / rows;
+  return b * batch_nnz + static_cast<int64_t>(crows[row + b + 1]);
+}
+
+// Splits the first diagonal items of the merge of row ends and nonzero
+// indices, returns the number of rows taken and sets *nz to the number of
+// nonzeros taken.
+template <typename IntT>
+__device__ __forceinline__ int64_t MergePathSearch(int64_t diagonal,
+                                                   const IntT* crows,
+                                                   int64_t total_rows,
+                                                   int64_t rows,
+                                                   int64_t batch_nnz,
+                                                   int64_t nnz,
+                                                   int64_t* nz) {
+  int64_t lo = diagonal > nnz ? diagonal - nnz : 0;
+  int64_t hi = diagonal < total_rows ? diagonal : total_rows;
+  while (lo < hi) {
+    int64_t pivot = (lo + hi) >> 1;
+    if (CsrRowEnd(crows, pivot, rows, batch_nnz) <= diagonal - pivot - 1) {
+      lo = pivot + 1;
+    } else {
+      hi = pivot;
+    }
+  }
+  *nz = diagonal - lo;
+  return lo;
+}
+
+template <typename IntT>
+__global__ void CsrRowLengthStatsKernel(const IntT* crows,
+                                        int64_t total_rows,
+                                        int64_t rows,
+                                        double* stats) {
+  double sum = 0;
+  double square_sum = 0;
+  CUDA_KERNEL_LOOP_TYPE(i, total_rows, int64_t) {
+    int64_t crow_idx = i + i / rows;
+    double len = static_cast<double>(crows[crow_idx + 1] - crows[crow_idx]);
+    sum += len;
+    square_sum += len * len;
+  }
+  sum = BlockReduceSum<double>(sum, FINAL_MASK);
+  square_sum = BlockReduceSum<double>(square_sum, FINAL_MASK);
+  if (threadIdx.x == 0) {
+    CudaAtomicAdd(stats, sum);
+    CudaAtomicAdd(stats + 1, square_sum);
+  }
+}
+
+// Whether BalancedCsrSpmm and BalancedCsrSddmm should be used for x. They are
+// chosen when the coefficient of variation of the row lengths of x exceeds
+// FLAGS_sparse_csr_balanced_matmul_threshold, which costs one small copy from
+// device to host. float16 always uses them, they accumulate in float while
+// cuSPARSE would compute in float16.
+template <typename T>
+bool UseBalancedCsrMatmul(const phi::GPUContext& dev_ctx,
+                          const SparseCsrTensor& x) {
+  if (std::is_same<T, phi::dtype::float16>::value) {
+    return true;
+  }
+  double threshold = FLAGS_sparse_csr_balanced_matmul_threshold;
+  if (threshold < 0) {
+    return false;
+  }
+  if (threshold == 0) {
+    return true;
+  }
+  int64_t rows = x.dims()[x.dims().size() - 2];
+  int64_t total_rows = x.non_zero_crows().numel() / (rows + 1) * rows;
+  if (total_rows == 0 || x.nnz() == 0) {
+    return false;
+  }
+
+  DenseTensor stats = phi::Empty<double>(dev_ctx, {2});
+  phi::backends::gpu::GpuMemsetAsync(
+      stats.data<double>(), 0, 2 * sizeof(double), dev_ctx.stream());
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, total_rows);
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.non_zero_crows().dtype(), "CsrRowLengthStatsKernel", ([&] {
+        CsrRowLengthStatsKernel<data_t>
+            <<<config.block_per_grid, config.thread_per_block, 0,
+               dev_ctx.stream()>>>(x.non_zero_crows().data<data_t>(),
+                                   total_rows,
+                                   rows,
+                                   stats.data<double>());
+      }));
+  double h_stats[2];
+  phi::backends::gpu::GpuMemcpyAsync(h_stats,
+                                     stats.data<double>(),
+                                     2 * sizeof(double),
+                                     gpuMemcpyDeviceToHost,
+                                     dev_ctx.stream());
+  dev_ctx.Wait();
+
+  double mean = h_stats[0] / total_rows;
+  double var = std::max(h_stats[1] / total_rows - mean * mean, 0.0);
+  double cv = std::sqrt(var) / mean;
+  VLOG(6) << "Row length coefficient of variation of SparseCsrTensor: " << cv;
+  return cv > threshold;
+}
+
+// One warp per segment of items_per_warp merge items (row ends plus
+// nonzeros), the lanes of a warp cover the columns of y. Rows that start and
+// end inside a segment are stored directly, the partial rows at both ends of
+// a segment are accumulated atomically into the zeroed out.
+template <typename T, typename IntT>
+__global__ void MergePathCsrSpmmKernel(const IntT* crows,
+                                       const IntT* cols,
+                                       const T* values,
+                                       const T* y,
+                                       T* out,
+                                       int64_t total_rows,
+                                       int64_t rows,
+                                       int64_t k,
+                                       int64_t n,
+                                       int64_t nnz,
+                                       int64_t batch_nnz,
+                                       int64_t items_per_warp,
+                                       T alpha) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  int64_t warp_id =
+      (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) /
+      WARP_SIZE;
+  int lane = threadIdx.x & (WARP_SIZE - 1);
+  int64_t total_items = total_rows + nnz;
+  int64_t diagonal = warp_id * items_per_warp;
+  if (diagonal >= total_items) return;
+  int64_t diagonal_end = min(diagonal + items_per_warp, total_items);
+
+  int64_t first_nz, last_nz;
+  int64_t first_row = MergePathSearch(
+      diagonal, crows, total_rows, rows, batch_nnz, nnz, &first_nz);
+  int64_t last_row = MergePathSearch(
+      diagonal_end, crows, total_rows, rows, batch_nnz, nnz, &last_nz);
+  // whether the nonzeros of first_row before first_nz belong to earlier
+  // segments, the row end of row - 1 is the row begin of row
+  bool first_row_partial =
+      first_row > 0 && first_row < total_rows &&
+      CsrRowEnd(crows, first_row - 1, rows, batch_nnz) < first_nz;
+  MPType mp_alpha = static_cast<MPType>(alpha);
+
+  for (int64_t col = lane; col < n; col += WARP_SIZE) {
+    int64_t nz = first_nz;
+    for (int64_t row = first_row; row <= last_row && row < total_rows; ++row) {
+      int64_t row_end =
+          row < last_row ? CsrRowEnd(crows, row, rows, batch_nnz) : last_nz;
+      int64_t row_first_nz = nz;
+      const T* y_batch = y + (row / rows) * k * n;
+      MPType sum = static_cast<MPType>(0);
+      for (; nz < row_end; ++nz) {
+        sum += static_cast<MPType>(values[nz]) *
+               static_cast<MPType>(y_batch[cols[nz] * n + col]);
+      }
+      T result = static_cast<T>(mp_alpha * sum);
+      if (row == last_row) {
+        // the rest of the row belongs to the next segments
+        if (nz > row_first_nz) {
+          phi::CudaAtomicAdd(out + row * n + col, result);
+        }
+      } else if (row == first_row && first_row_partial) {
+        phi::CudaAtomicAdd(out + row * n + col, result);
+      } else {
+        out[row * n + col] = result;
+      }
+    }
+  }
+}
+
+// Each warp computes a contiguous chunk of nonzeros, the lanes of a warp
+// split the reduction over k.
+template <typename T, typename IntT>
+__global__ void NnzBalancedCsrSddmmKernel(const T* x,
+                                          const T* y,
+                                          const IntT* crows,
+                                          const IntT* cols,
+                                          T* out,
+                                          int64_t total_rows,
+                                          int64_t rows,
+                                          int64_t k,
+                                          int64_t y_cols,
+                                          bool trans_y,
+                                          int64_t nnz,
+                                          int64_t batch_nnz,
+                                          int64_t nnz_per_warp,
+                                          T alpha) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  int64_t warp_id =
+      (static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x) /
+      WARP_SIZE;
+  int lane = threadIdx.x & (WARP_SIZE - 1);
+  int64_t nz = warp_id * nnz_per_warp;
+  if (nz >= nnz) return;
+  int64_t nz_end = min(nz + nnz_per_warp, nnz);
+
+  // the first row whose end is after nz
+  int64_t lo = 0;
+  int64_t hi = total_rows - 1;
+  while (lo < hi) {
+    int64_t mid = (lo + hi) >> 1;
+    if (CsrRowEnd(crows, mid, rows, batch_nnz) <= nz) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  int64_t row = lo;
+  int64_t row_end = CsrRowEnd(crows, row, rows, batch_nnz);
+  MPType mp_alpha = static_cast<MPType>(alpha);
+
+  for (; nz < nz_end; ++nz) {
+    while (nz >= row_end) {
+      row_end = CsrRowEnd(crows, ++row, rows, batch_nnz);
+    }
+    int64_t col = static_cast<int64_t>(cols[nz]);
+    const T* x_row = x + row * k;
+    const T* y_batch = y + (row / rows) * k * y_cols;
+    MPType sum = static_cast<MPType>(0);
+    for (int64_t i = lane; i < k; i += WARP_SIZE) {
+      T y_val = trans_y ? y_batch[col * k + i] : y_batch[i * y_cols + col];
+      sum += static_cast<MPType>(x_row[i]) * static_cast<MPType>(y_val);
+    }
+    sum = WarpReduceSum<MPType>(sum, FINAL_MASK);
+    if (lane == 0) {
+      out[nz] = static_cast<T>(mp_alpha * sum);
+    }
+  }
+}
+
+inline int64_t BalancedItemsPerWarp(const phi::GPUContext& dev_ctx,
+                                    int64_t total_items) {
+  // enough warps to fill every SM a few times over, but not so many that
+  // the merge path searches dominate
+  int64_t num_warps = static_cast<int64_t>(dev_ctx.GetSMCount()) * 64;
+  return std::max<int64_t>((total_items + num_warps - 1) / num_warps, 16);
+}
+
+// out = alpha * x * y, x is a SparseCsrTensor of shape [*, M, K], y and out
+// are DenseTensor of shape [*, K, N] and [*, M, N]. out must be allocated.
+template <typename T>
+void BalancedCsrSpmm(const phi::GPUContext& dev_ctx,
+                     const SparseCsrTensor& x,
+                     const DenseTensor& y,
+                     T alpha,
+                     DenseTensor* out) {
+  auto x_dims = x.dims();
+  auto y_dims = y.dims();
+  int64_t rows = x_dims[x_dims.size() - 2];
+  int64_t k = y_dims[y_dims.size() - 2];
+  int64_t n = y_dims[y_dims.size() - 1];
+  int64_t batch_size = x.non_zero_crows().numel() / (rows + 1);
+  int64_t total_rows = batch_size * rows;
+  int64_t nnz = x.nnz();
+
+  phi::backends::gpu::GpuMemsetAsync(
+      out->data<T>(), 0, out->numel() * sizeof(T), dev_ctx.stream());
+  if (total_rows == 0 || nnz == 0 || n == 0) {
+    return;
+  }
+
+  int64_t items_per_warp = BalancedItemsPerWarp(dev_ctx, total_rows + nnz);
+  int64_t num_warps = (total_rows + nnz + items_per_warp - 1) / items_per_warp;
+  int threads = 256;
+  int64_t blocks = (num_warps * WARP_SIZE + threads - 1) / threads;
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      x.non_zero_crows().dtype(), "MergePathCsrSpmmKernel", ([&] {
+        MergePathCsrSpmmKernel<T, data_t>
+            <<<blocks, threads, 0, dev_ctx.stream()>>>(
+                x.non_zero_crows().data<data_t>(),
+                x.non_zero_cols().data<data_t>(),
+                x.non_zero_elements().data<T>(),
+                y.data<T>(),
+                out->data<T>(),
+                total_rows,
+                rows,
+                k,
+                n,
+                nnz,
+                nnz / batch_size,
+                items_per_warp,
+                alpha);
+      }));
+}
+
+// out = alpha * (x * y) ∘ spy(out), x and y are DenseTensor of shape
+// [*, M, K] and [*, K, N] ([*, N, K] if trans_y), out is a SparseCsrTensor of
+// shape [*, M, N] whose crows and cols are already set.
+template <typename T>
+void BalancedCsrSddmm(const phi::GPUContext& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& y,
+                      bool trans_y,
+                      T alpha,
+                      SparseCsrTensor* out) {
+  auto x_dims = x.dims();
+  auto y_dims = y.dims();
+  int64_t rows = x_dims[x_dims.size() - 2];
+  int64_t k = x_dims[x_dims.size() - 1];
+  int64_t y_cols = trans_y ? y_dims[y_dims.size() - 2]
+                           : y_dims[y_dims.size() - 1];
+  int64_t batch_size = out->non_zero_crows().numel() / (rows + 1);
+  int64_t total_rows = batch_size * rows;
+  int64_t nnz = out->nnz();
+  if (total_rows == 0 || nnz == 0) {
+    return;
+  }
+
+  int64_t nnz_per_warp = BalancedItemsPerWarp(dev_ctx, nnz);
+  int64_t num_warps = (nnz + nnz_per_warp - 1) / nnz_per_warp;
+  int threads = 256;
+  int64_t blocks = (num_warps * WARP_SIZE + threads - 1) / threads;
+  PD_VISIT_BASE_INTEGRAL_TYPES(
+      out->non_zero_crows().dtype(), "NnzBalancedCsrSddmmKernel", ([&] {
+        NnzBalancedCsrSddmmKernel<T, data_t>
+            <<<blocks, threads, 0, dev_ctx.stream()>>>(
+                x.data<T>(),
+                y.data<T>(),
+                out->non_zero_crows().data<data_t>(),
+                out->non_zero_cols().data<data_t>(),
+                out->mutable_non_zero_elements()->data<T>(),
+                total_rows,
+                rows,
+                k,
+                y_cols,
+                trans_y,
+                nnz,
+                nnz / batch_size,
+                nnz_per_warp,
+                alpha);
+      }));
+}
+
+}  // namespace sparse
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,112 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace phi {
+namespace funcs {
+
+template <typename T>
+inline bool TopKIsNan(T value) {
+  return std::isnan(static_cast<double>(value));
+}
+
+// True if l ranks before r in the output of topk, the NaNs rank first for the
+// largest and last for the smallest.
+template <typename T>
+inline bool TopKBefore(T l, T r, bool largest) {
+  if (largest) {
+    return (TopKIsNan(l) && !TopKIsNan(r)) || (l > r);
+  }
+  return (!TopKIsNan(l) && TopKIsNan(r)) || (l < r);
+}
+
+// Selects the k first elements of a row of width elements, sorted, into out
+// and indices. A heap keeps the k candidates with the last one on top. The
+// row is screened in blocks against the last candidate with a branch free
+// loop the compiler vectorizes, only the blocks that hold a better element
+// are inserted one by one, which is rare once the heap has warmed up. Equal
+// elements rank by their index.
+template <typename T, typename Type>
+void HeapTopK(const T* row,
+              Type width,
+              int k,
+              bool largest,
+              T* out,
+              Type* indices) {
+  constexpr Type kBlock = 16;
+  using Candidate = std::pair<T, Type>;
+  auto before = [largest](const Candidate& l, const Candidate& r) {
+    if (TopKBefore(l.first, r.first, largest)) {
+      return true;
+    }
+    return !TopKBefore(r.first, l.first, largest) && l.second < r.second;
+  };
+
+  std::vector<Candidate> heap;
+  heap.reserve(k);
+  for (Type j = 0; j < k; ++j) {
+    heap.emplace_back(row[j], j);
+  }
+  std::make_heap(heap.begin(), heap.end(), before);
+
+  auto insert = [&](Type j) {
+    if (TopKBefore(row[j], heap.front().first, largest)) {
+      std::pop_heap(heap.begin(), heap.end(), before);
+      heap.back() = Candidate(row[j], j);
+      std::push_heap(heap.begin(), heap.end(), before);
+    }
+  };
+
+  Type j = k;
+  for (; j + kBlock <= width; j += kBlock) {
+    const T last = heap.front().first;
+    const T* block = row + j;
+    bool hit = false;
+    if (largest) {
+      for (Type b = 0; b < kBlock; ++b) {
+        // block[b] != block[b] for the NaNs
+        hit |= (block[b] > last) | (block[b] != block[b]);
+      }
+    } else if (TopKIsNan(last)) {
+      hit = true;
+    } else {
+      for (Type b = 0; b < kBlock; ++b) {
+        hit |= block[b] < last;
+      }
+    }
+    if (hit) {
+      for (Type b = 0; b < kBlock; ++b) {
+        insert(j + b);
+      }
+    }
+  }
+  for (; j < width; ++j) {
+    insert(j);
+  }
+
+  std::sort_heap(heap.begin(), heap.end(), before);
+  for (int i = 0; i < k; ++i) {
+    out[i] = heap[i].first;
+    indices[i] = heap[i].second;
+  }
+}
+
+}  // namespace funcs
+}  // namespace phi
@@ -0,0 +1,137 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+namespace fusion {
+
+// y = layer_norm(residual + dropout(x + bias)) over the last dimension, for
+// inference. Each row is summed into bias_dropout_residual_out, then
+// normalized with its mean and the variance around it, the rows run in
+// parallel.
+template <typename T, typename Context>
+void FusedBiasDropoutResidualLnKernel(
+    const Context& dev_ctx,
+    const DenseTensor& x,
+    const DenseTensor& residual,
+    const paddle::optional<DenseTensor>& bias,
+    const paddle::optional<DenseTensor>& ln_scale,
+    const paddle::optional<DenseTensor>& ln_bias,
+    const float dropout_rate,
+    const bool is_test,
+    const bool dropout_fix_seed UNUSED,
+    const int dropout_seed UNUSED,
+    const std::string& dropout_implementation,
+    const float ln_epsilon,
+    DenseTensor* y,
+    DenseTensor* bias_dropout_residual_out,
+    DenseTensor* dropout_mask_out,
+    DenseTensor* ln_mean,
+    DenseTensor* ln_variance) {
+  PADDLE_ENFORCE_EQ(is_test || dropout_rate == 0.0f,
+                    true,
+                    common::errors::Unimplemented(
+                        "The CPU kernel of fused_bias_dropout_residual_"
+                        "layer_norm only supports is_test or a dropout_rate "
+                        "of 0, but received dropout_rate %f.",
+                        dropout_rate));
+  PADDLE_ENFORCE_EQ(residual.numel(),
+                    x.numel(),
+                    common::errors::InvalidArgument(
+                        "The numel of Input(Residual) (%d) should be equal "
+                        "with the numel of Input(X) (%d).",
+                        residual.numel(),
+                        x.numel()));
+
+  const auto& x_dims = x.dims();
+  const int64_t cols = x_dims[x_dims.size() - 1];
+  const int64_t rows = cols == 0 ? 0 : x.numel() / cols;
+  const T* x_data = x.data<T>();
+  const T* residual_data = residual.data<T>();
+  const T* bias_data = bias ? bias->data<T>() : nullptr;
+  const T* scale_data = ln_scale ? ln_scale->data<T>() : nullptr;
+  const T* shift_data = ln_bias ? ln_bias->data<T>() : nullptr;
+  T* sum_data = dev_ctx.template Alloc<T>(bias_dropout_residual_out);
+  T* y_data = dev_ctx.template Alloc<T>(y);
+  T* mean_data = dev_ctx.template Alloc<T>(ln_mean);
+  T* var_data = dev_ctx.template Alloc<T>(ln_variance);
+  if (dropout_mask_out && !is_test) {
+    // nothing is dropped with a dropout_rate of 0
+    uint8_t* mask_data = dev_ctx.template Alloc<uint8_t>(dropout_mask_out);
+    // all bits set for a mask packed by FLAGS_fused_dropout_bitpack_mask
+    const uint8_t keep_all = dropout_mask_out->numel() == x.numel() ? 1 : 0xFF;
+    std::fill(mask_data, mask_data + dropout_mask_out->numel(), keep_all);
+  }
+
+  // dropout scales by 1 - dropout_rate in inference for downgrade_in_infer
+  const T keep = is_test && dropout_implementation == "downgrade_in_infer"
+                     ? static_cast<T>(1.0f - dropout_rate)
+                     : static_cast<T>(1);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t row = 0; row < rows; ++row) {
+    const T* x_row = x_data + row * cols;
+    const T* residual_row = residual_data + row * cols;
+    T* sum_row = sum_data + row * cols;
+    T* y_row = y_data + row * cols;
+
+    T sum = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      T value = bias_data ? x_row[j] + bias_data[j] : x_row[j];
+      value = value * keep + residual_row[j];
+      sum_row[j] = value;
+      sum += value;
+    }
+    const T mean = sum / static_cast<T>(cols);
+    T square_sum = 0;
+    for (int64_t j = 0; j < cols; ++j) {
+      const T diff = sum_row[j] - mean;
+      square_sum += diff * diff;
+    }
+    const T var = square_sum / static_cast<T>(cols);
+    const T inv_std =
+        static_cast<T>(1) / std::sqrt(var + static_cast<T>(ln_epsilon));
+    for (int64_t j = 0; j < cols; ++j) {
+      T value = (sum_row[j] - mean) * inv_std;
+      if (scale_data) {
+        value *= scale_data[j];
+      }
+      if (shift_data) {
+        value += shift_data[j];
+      }
+      y_row[j] = value;
+    }
+    mean_data[row] = mean;
+    var_data[row] = var;
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_bias_dropout_residual_layer_norm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedBiasDropoutResidualLnKernel,
+                   float,
+                   double) {
+  kernel->OutputAt(2).SetDataType(phi::DataType::UINT8);
+}
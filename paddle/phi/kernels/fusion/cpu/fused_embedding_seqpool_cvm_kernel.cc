@@ -0,0 +1,123 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/jit/kernels.h"
+
+namespace phi {
+namespace fusion {
+
+// Gathers the rows of W of the ids of every sequence of every slot, pools
+// them and applies CVM on the pooled row in place, so neither the looked up
+// embeddings nor the pooled rows before CVM are materialized.
+template <typename T, typename Context>
+void FusedEmbeddingSeqpoolCvmKernel(const Context& dev_ctx,
+                                    const std::vector<const DenseTensor*>& ids,
+                                    const DenseTensor& w,
+                                    const DenseTensor& cvm,
+                                    const std::string& pooltype,
+                                    bool use_cvm,
+                                    int64_t padding_idx,
+                                    std::vector<DenseTensor*> out) {
+  const int64_t table_height = w.dims()[0];
+  const int64_t width = w.dims()[1];
+  const int64_t out_width = use_cvm ? width : width - 2;
+  const T* table = w.data<T>();
+  const int jit_width = static_cast<int>(width);
+
+  jit::emb_seq_pool_attr_t emb_attr(
+      table_height, width, 0, 1, width, jit::SeqPoolType::kSum);
+  auto emb_seqpool =
+      jit::KernelFuncs<jit::EmbSeqPoolTuple<T>, phi::CPUPlace>::Cache().At(
+          emb_attr);
+  auto vadd = jit::KernelFuncs<jit::VAddTuple<T>, phi::CPUPlace>::Cache().At(
+      jit_width);
+  auto vscal = jit::KernelFuncs<jit::VScalTuple<T>, phi::CPUPlace>::Cache().At(
+      jit_width);
+
+  std::vector<T> pooled(width);
+  for (size_t slot = 0; slot < ids.size(); ++slot) {
+    const auto& lod = ids[slot]->lod();
+    PADDLE_ENFORCE_EQ(lod.empty(),
+                      false,
+                      common::errors::InvalidArgument(
+                          "The %d-th Input(Ids) of FusedEmbeddingSeqpoolCvm "
+                          "should have lod.",
+                          slot));
+    const auto& offsets = lod[0];
+    const int64_t batch_size = static_cast<int64_t>(offsets.size()) - 1;
+    const int64_t* ids_data = ids[slot]->data<int64_t>();
+    out[slot]->Resize({batch_size, out_width});
+    T* out_data = dev_ctx.template Alloc<T>(out[slot]);
+
+    for (int64_t i = 0; i < batch_size; ++i) {
+      const int64_t* seq = ids_data + offsets[i];
+      const int64_t seq_len =
+          static_cast<int64_t>(offsets[i + 1] - offsets[i]);
+      if (seq_len > 0 && padding_idx < 0) {
+        emb_attr.index_height = seq_len;
+        emb_seqpool(table, seq, pooled.data(), &emb_attr);
+      } else {
+        std::fill(pooled.begin(), pooled.end(), static_cast<T>(0));
+        for (int64_t j = 0; j < seq_len; ++j) {
+          // the padding rows are zeros, as looked up by embedding
+          if (seq[j] == padding_idx) {
+            continue;
+          }
+          PADDLE_ENFORCE_EQ(
+              seq[j] >= 0 && seq[j] < table_height,
+              true,
+              common::errors::InvalidArgument(
+                  "The id should be in [0, %d), but received %d.",
+                  table_height,
+                  seq[j]));
+          vadd(
+              pooled.data(), table + seq[j] * width, pooled.data(), jit_width);
+        }
+      }
+      if (seq_len > 0 && pooltype != "SUM") {
+        const T scale =
+            pooltype == "AVERAGE"
+                ? static_cast<T>(1) / static_cast<T>(seq_len)
+                : static_cast<T>(1) / std::sqrt(static_cast<T>(seq_len));
+        vscal(&scale, pooled.data(), pooled.data(), jit_width);
+      }
+
+      T* dst = out_data + i * out_width;
+      if (use_cvm) {
+        dst[0] = std::log(pooled[0] + 1);
+        dst[1] = std::log(pooled[1] + 1) - dst[0];
+        std::copy(pooled.begin() + 2, pooled.end(), dst + 2);
+      } else {
+        std::copy(pooled.begin() + 2, pooled.end(), dst);
+      }
+    }
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_embedding_seqpool_cvm,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedEmbeddingSeqpoolCvmKernel,
+                   float,
+                   double) {}
@@ -0,0 +1,93 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "paddle/phi/backends/cpu/cpu_context.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/int8_gemm.h"
+
+namespace phi {
+namespace fusion {
+
+// out = x * weight for a weight quantized to int8 with per tensor or per
+// output channel scales. x is quantized with input_scale, the product is
+// accumulated in int32 and dequantized with both scales.
+template <typename T, typename Context>
+void FusedInt8MatmulKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& weight,
+                           const std::vector<float>& weight_scale,
+                           const float input_scale,
+                           const float quant_max_bound,
+                           DenseTensor* out) {
+  PADDLE_ENFORCE_EQ(weight.dtype(),
+                    phi::DataType::INT8,
+                    common::errors::InvalidArgument(
+                        "The data type of Input(Weight) of fused_int8_matmul "
+                        "should be int8, but received %s.",
+                        weight.dtype()));
+  const auto& x_dims = x.dims();
+  const int64_t K = x_dims[x_dims.size() - 1];
+  const int64_t N = weight.dims()[1];
+  const int64_t M = K == 0 ? 0 : x.numel() / K;
+  T* out_data = dev_ctx.template Alloc<T>(out);
+  if (M == 0 || N == 0) {
+    return;
+  }
+
+  const T* x_data = x.data<T>();
+  std::vector<int8_t> x_int8(M * K);
+  const float quant_scale = quant_max_bound / input_scale;
+  for (int64_t i = 0; i < M * K; ++i) {
+    float value = std::nearbyint(static_cast<float>(x_data[i]) * quant_scale);
+    value = std::min(std::max(value, -quant_max_bound), quant_max_bound);
+    x_int8[i] = static_cast<int8_t>(value);
+  }
+
+  std::vector<int32_t> acc(M * N);
+  phi::funcs::Int8Gemm(
+      M, N, K, x_int8.data(), weight.data<int8_t>(), acc.data());
+
+  std::vector<float> dequant_scale(N);
+  for (int64_t j = 0; j < N; ++j) {
+    const float scale = weight_scale.size() == 1 ? weight_scale[0]
+                                                 : weight_scale[j];
+    dequant_scale[j] =
+        input_scale / quant_max_bound * scale / quant_max_bound;
+  }
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t i = 0; i < M; ++i) {
+    const int32_t* acc_row = acc.data() + i * N;
+    T* out_row = out_data + i * N;
+    for (int64_t j = 0; j < N; ++j) {
+      out_row[j] = static_cast<T>(acc_row[j] * dequant_scale[j]);
+    }
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_int8_matmul,
+                   CPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedInt8MatmulKernel,
+                   float) {
+  kernel->InputAt(1).SetDataType(phi::DataType::INT8);
+}
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "paddle/phi/backends/cpu/cpu_info.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/funcs/softmax_impl.h"
 #include "paddle/phi/kernels/softmax_kernel.h"
 
 namespace phi::fusion {
@@ -52,8 +54,39 @@ void FusedSoftmaxMaskKernel(const Context& dev_ctx,
             idx,
             mask_dim[idx]));
   }
-  DenseTensor t = phi::Add<T, Context>(dev_ctx, x, mask);
-  SoftmaxKernel<T, Context>(dev_ctx, t, 3, out);  // axis for softmax
+  if (x.numel() == 0) {
+    dev_ctx.template Alloc<T>(out);
+    return;
+  }
+  if (!phi::backends::cpu::MayIUse(phi::backends::cpu::avx)) {
+    DenseTensor t = phi::Add<T, Context>(dev_ctx, x, mask);
+    SoftmaxKernel<T, Context>(dev_ctx, t, 3, out);  // axis for softmax
+    return;
+  }
+
+  // the mask is added to each row in the output before its softmax, the
+  // rows of all the heads share the rows of the mask of their batch
+  const int64_t heads = x_dim[1];
+  const int64_t query_len = x_dim[2];
+  const int key_len = static_cast<int>(x_dim[3]);
+  const int64_t rows = x.numel() / key_len;
+  const T* x_data = x.data<T>();
+  const T* mask_data = mask.data<T>();
+  T* out_data = dev_ctx.template Alloc<T>(out);
+#ifdef PADDLE_WITH_MKLML
+#pragma omp parallel for
+#endif
+  for (int64_t row = 0; row < rows; ++row) {
+    const int64_t batch = row / (heads * query_len);
+    const int64_t query = row % query_len;
+    const T* x_row = x_data + row * key_len;
+    const T* mask_row = mask_data + (batch * query_len + query) * key_len;
+    T* out_row = out_data + row * key_len;
+    for (int j = 0; j < key_len; ++j) {
+      out_row[j] = x_row[j] + mask_row[j];
+    }
+    funcs::VecSoftmaxRow<T>(key_len, out_row, out_row);
+  }
 }
 
 }  // namespace phi::fusion
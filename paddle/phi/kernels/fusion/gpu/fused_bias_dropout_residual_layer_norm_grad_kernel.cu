@@ -25,6 +25,7 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_dnn.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/funcs/layer_norm_impl.cu.h"
 #include "paddle/phi/kernels/fusion/gpu/fused_dropout_helper.h"
 
@@ -58,7 +59,17 @@ void FusedBiasDropoutResidualLnGradKernel(
   auto* d_y_data = y_grad.data<T>();
   auto* ln_scale_data =
       (ln_scale.get_ptr() == nullptr ? nullptr : ln_scale->data<U>());
-  auto* dropout_mask_out_data = dropout_mask_out.data<uint8_t>();
+  const uint8_t* dropout_mask_out_data = dropout_mask_out.data<uint8_t>();
+  // a bit-packed mask, see FLAGS_fused_dropout_bitpack_mask
+  DenseTensor byte_mask;
+  if (!is_test && dropout_mask_out.numel() != y_grad.numel()) {
+    byte_mask = phi::Empty<uint8_t>(dev_ctx, {y_grad.numel()});
+    phi::fusion::UnpackDropoutMask<uint8_t>(dev_ctx,
+                                            dropout_mask_out_data,
+                                            y_grad.numel(),
+                                            byte_mask.data<uint8_t>());
+    dropout_mask_out_data = byte_mask.data<uint8_t>();
+  }
   auto* bias_dropout_residual_out_data = bias_dropout_residual_out.data<T>();
   auto* ln_mean_data = ln_mean.data<U>();
   auto* ln_var_data = ln_variance.data<U>();
@@ -16,6 +16,7 @@
 #include "paddle/phi/backends/gpu/gpu_dnn.h"
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/kernels/empty_kernel.h"
 #include "paddle/phi/kernels/funcs/layer_norm_impl.cu.h"
 #include "paddle/phi/kernels/fusion/gpu/fused_dropout_helper.h"
 
@@ -60,6 +61,14 @@ void FusedBiasDropoutResidualLnKernel(
           ? nullptr
           : dev_ctx.template Alloc<uint8_t>(
                 dropout_mask_out, dropout_mask_out->numel() * sizeof(uint8_t));
+  // With FLAGS_fused_dropout_bitpack_mask the InferMeta gives the mask
+  // output the packed shape, the byte mask then only lives in this kernel.
+  const bool pack_mask = !is_test && dropout_mask_out != nullptr &&
+                         dropout_mask_out->numel() != x.numel();
+  DenseTensor byte_mask;
+  if (pack_mask) {
+    byte_mask = phi::Empty<uint8_t>(dev_ctx, {x.numel()});
+  }
   auto* y_data = dev_ctx.template Alloc<T>(y, y->numel() * sizeof(T));
 
   const auto input_x_dims = x.dims();
@@ -88,10 +97,14 @@ void FusedBiasDropoutResidualLnKernel(
       ln_scale_data,
       ln_bias_data,
       bias_dropout_residual_out_data,
-      dropout_mask_out_data,
+      pack_mask ? byte_mask.data<uint8_t>() : dropout_mask_out_data,
       y_data,
       ln_mean_data,
       ln_var_data);
+  if (pack_mask) {
+    phi::fusion::PackDropoutMask<uint8_t>(
+        dev_ctx, byte_mask.data<uint8_t>(), x.numel(), dropout_mask_out_data);
+  }
 }
 }  // namespace fusion
 }  // namespace phi
@@ -167,6 +167,61 @@ inline __device__ void CalculateDBias(const T *tmp_sum,
   }
 }
 
+/**
+ * Packs a 0/1 dropout mask of n elements into PackedDropoutMaskNumel(n)
+ * bytes, bit (i % 8) of byte (i / 8) holds element i.
+ */
+template <typename MaskType>
+__global__ void PackDropoutMaskKernel(const MaskType *mask,
+                                      const int64_t n,
+                                      uint8_t *bits) {
+  CUDA_KERNEL_LOOP_TYPE(i, (n + 7) / 8, int64_t) {
+    uint8_t byte = 0;
+#pragma unroll
+    for (int j = 0; j < 8; ++j) {
+      int64_t idx = i * 8 + j;
+      if (idx < n && mask[idx]) {
+        byte |= (1 << j);
+      }
+    }
+    bits[i] = byte;
+  }
+}
+
+template <typename MaskType>
+__global__ void UnpackDropoutMaskKernel(const uint8_t *bits,
+                                        const int64_t n,
+                                        MaskType *mask) {
+  CUDA_KERNEL_LOOP_TYPE(i, n, int64_t) {
+    mask[i] = static_cast<MaskType>((bits[i >> 3] >> (i & 7)) & 1);
+  }
+}
+
+inline int64_t PackedDropoutMaskNumel(const int64_t n) { return (n + 7) / 8; }
+
+template <typename MaskType>
+void PackDropoutMask(const phi::GPUContext &ctx,
+                     const MaskType *mask,
+                     const int64_t n,
+                     uint8_t *bits) {
+  auto config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(ctx, PackedDropoutMaskNumel(n));
+  PackDropoutMaskKernel<MaskType>
+      <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+          mask, n, bits);
+}
+
+template <typename MaskType>
+void UnpackDropoutMask(const phi::GPUContext &ctx,
+                       const uint8_t *bits,
+                       const int64_t n,
+                       MaskType *mask) {
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(ctx, n);
+  UnpackDropoutMaskKernel<MaskType>
+      <<<config.block_per_grid, config.thread_per_block, 0, ctx.stream()>>>(
+          bits, n, mask);
+}
+
 template <typename T>
 inline __device__ T GetFactor(const float dropout_prob,
                               const bool is_upscale_in_train,
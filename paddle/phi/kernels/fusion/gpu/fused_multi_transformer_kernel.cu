@@ -270,12 +270,30 @@ void FusedMultiTransformerOpKernel(
         0,
         common::errors::InvalidArgument(
             "The value of time_step must > 0, but now is %d", time_step_value));
-    PADDLE_ENFORCE_EQ(
-        seq_len,
-        1,
-        common::errors::PreconditionNotMet(
-            "In decode stage, the seq_len of input must be 1, but now is %d",
-            seq_len));
+    // seq_len > 1 verifies the draft tokens of speculative decoding
+    if (seq_len > 1) {
+      PADDLE_ENFORCE_EQ(
+          beam_cache_offset,
+          nullptr,
+          common::errors::PreconditionNotMet(
+              "In decode stage, the seq_len of input must be 1 with beam "
+              "search, but now is %d",
+              seq_len));
+      PADDLE_ENFORCE_EQ(
+          cache_kvs.empty(),
+          false,
+          common::errors::PreconditionNotMet(
+              "In decode stage, the draft tokens need the CacheKV."));
+      PADDLE_ENFORCE_LE(
+          time_step_value + seq_len,
+          cache_kvs[0]->dims()[3],
+          common::errors::InvalidArgument(
+              "The %d draft tokens after time_step %d exceed the max_seq_len "
+              "%d of CacheKV.",
+              seq_len,
+              time_step_value,
+              cache_kvs[0]->dims()[3]));
+    }
     out_seq_len += time_step_value;
   } else {
     out_seq_len += cache_offset;
@@ -557,7 +575,34 @@ void FusedMultiTransformerOpKernel(
       cache_bsz = cache_kv->dims()[1];
     }
 
-    if (time_step) {  // generation decoder stage
+    if (time_step && seq_len > 1) {  // verify draft tokens
+      int max_seq_len = cache_kv->dims()[3];
+      phi::fusion::draft_fmha<T>(dev_ctx,
+                                 qkv_out,
+                                 *qkv_bias,
+                                 src_mask,
+                                 sequence_lengths,
+                                 rotary_tensor,
+                                 cache_kv_out,
+                                 &fmha_out,
+                                 &partial_max_logits_tensor,
+                                 &partial_expsum_tensor,
+                                 &partial_out_tensor,
+                                 bsz,
+                                 cache_bsz,
+                                 seq_len,
+                                 max_seq_len,
+                                 num_head,
+                                 dim_head,
+                                 time_step_value - seq_len + 1,
+                                 rotary_emb_dims,
+                                 1. / sqrt(dim_head),
+                                 FLAGS_fused_multi_transformer_op_use_mbfmha,
+                                 mask_broadcast_num_heads,
+                                 compute_bias,
+                                 use_neox_rotary_style,
+                                 gqa_group_size);
+    } else if (time_step) {  // generation decoder stage
       if (FLAGS_fused_multi_transformer_op_use_mbfmha) {
         int max_seq_len = cache_kv->dims()[3];
         phi::fusion::mbfmha<T>(dev_ctx,
@@ -1687,6 +1687,232 @@ void fmha(const phi::GPUContext &dev_ctx,
       dev_ctx, params, dim_head, load_func, store_func);
 }
 
+// Copies token token_id of src [rows, num_tokens, dim] to dst [rows, dim].
+template <typename T>
+__global__ void GatherDraftToken(T *dst,
+                                 const T *src,
+                                 const int num_tokens,
+                                 const int token_id,
+                                 const int dim) {
+  const int64_t bid = blockIdx.x;
+  const T *src_row = src + (bid * num_tokens + token_id) * dim;
+  for (int i = threadIdx.x; i < dim; i += blockDim.x) {
+    dst[bid * dim + i] = src_row[i];
+  }
+}
+
+// Copies src [rows, dim] to token token_id of dst [rows, num_tokens, dim].
+template <typename T>
+__global__ void ScatterDraftToken(T *dst,
+                                  const T *src,
+                                  const int num_tokens,
+                                  const int token_id,
+                                  const int dim) {
+  const int64_t bid = blockIdx.x;
+  T *dst_row = dst + (bid * num_tokens + token_id) * dim;
+  for (int i = threadIdx.x; i < dim; i += blockDim.x) {
+    dst_row[i] = src[bid * dim + i];
+  }
+}
+
+__global__ void DraftSequenceLengths(int *dst,
+                                     const int *src,
+                                     const int token_id,
+                                     const int batch_size) {
+  const int bi = blockIdx.x * blockDim.x + threadIdx.x;
+  if (bi < batch_size) {
+    // a sequence of length 0 is skipped by the attention
+    dst[bi] = src[bi] > 0 ? src[bi] + token_id : 0;
+  }
+}
+
+/*
+Decode stage attention over num_tokens draft tokens per sequence, which is
+the verification step of speculative decoding. Draft j sits at position
+timestep + j: its key and value are written to the cache there and it attends
+to the cache up to itself, so the drafts are causally masked among each other.
+Every draft runs one masked multihead attention, in order, on the kernels of
+the single token decode.
+
+qkv_tensor: [bsz, num_tokens, num_head + 2 * gqa_group_size, dim_head]
+out_tensor: [bsz, num_tokens, num_head, dim_head]
+src_mask_tensor: [bsz, 1 or num_head, num_tokens, mask_length]
+rotary_tensor: [2, bsz, 1, num_tokens, dim_head]
+
+Rejected drafts need no rollback of the cache: the next step gets the accepted
+length as timestep (or sequence_lengths) and overwrites the stale entries.
+*/
+template <typename T>
+void draft_fmha(const phi::GPUContext &dev_ctx,
+                const phi::DenseTensor &qkv_tensor,
+                const phi::DenseTensor &qkv_bias_tensor,
+                const phi::DenseTensor *src_mask_tensor,
+                const phi::DenseTensor *sequence_lengths_tensor,
+                const phi::DenseTensor *rotary_tensor,
+                phi::DenseTensor *cache_kv_tensor,
+                phi::DenseTensor *out_tensor,
+                phi::DenseTensor *partial_max_logits_tensor,
+                phi::DenseTensor *partial_expsum_tensor,
+                phi::DenseTensor *partial_out_tensor,
+                int batch_size,
+                int cache_batch_size,
+                int num_tokens,
+                int max_seq_length,
+                int num_head,
+                int dim_head,
+                int timestep,
+                int rotary_emb_dims,
+                float inv_sqrt_dh,
+                const bool use_mbfmha,
+                const bool mask_broadcast_num_heads = true,
+                const bool add_qkv_bias = true,
+                const bool neox_rotary_style = false,
+                const int gqa_group_size = -1) {
+  VLOG(1) << "FMHA verifies " << num_tokens << " draft tokens in FusedMT.";
+  auto stream = dev_ctx.stream();
+  const int qkv_size = qkv_tensor.numel() / (batch_size * num_tokens);
+  const int out_size = num_head * dim_head;
+
+  phi::DenseTensor qkv_token, out_token;
+  qkv_token.Resize({{batch_size, 1, qkv_size}});
+  auto *qkv_token_data =
+      dev_ctx.template Alloc<T>(&qkv_token, qkv_token.numel() * sizeof(T));
+  out_token.Resize({{batch_size, 1, num_head, dim_head}});
+  auto *out_token_data =
+      dev_ctx.template Alloc<T>(&out_token, out_token.numel() * sizeof(T));
+
+  phi::DenseTensor mask_token;
+  int mask_rows = 0;
+  if (src_mask_tensor) {
+    const auto &mask_dims = src_mask_tensor->dims();
+    PADDLE_ENFORCE_EQ(
+        mask_dims[2],
+        num_tokens,
+        common::errors::InvalidArgument(
+            "The src_mask must have a row for each of the %d draft tokens, "
+            "but got %d rows.",
+            num_tokens,
+            mask_dims[2]));
+    mask_rows = mask_dims[0] * mask_dims[1];
+    mask_token.Resize({{mask_dims[0], mask_dims[1], 1, mask_dims[3]}});
+    dev_ctx.template Alloc<T>(&mask_token, mask_token.numel() * sizeof(T));
+  }
+
+  phi::DenseTensor rotary_token;
+  int rotary_rows = 0;
+  if (rotary_emb_dims > 0) {
+    const auto &rotary_dims = rotary_tensor->dims();
+    PADDLE_ENFORCE_EQ(
+        rotary_dims.size() == 5 && rotary_dims[3] == num_tokens,
+        true,
+        common::errors::InvalidArgument(
+            "The rotary embedding must be [2, bsz, 1, %d, head_dim] for %d "
+            "draft tokens, but got [%s].",
+            num_tokens,
+            num_tokens,
+            rotary_dims));
+    rotary_rows = rotary_dims[0] * rotary_dims[1] * rotary_dims[2];
+    rotary_token.Resize(
+        {{rotary_dims[0], rotary_dims[1], rotary_dims[2], 1, rotary_dims[4]}});
+    dev_ctx.template Alloc<float>(&rotary_token,
+                                  rotary_token.numel() * sizeof(float));
+  }
+
+  phi::DenseTensor sequence_lengths_token;
+  if (sequence_lengths_tensor) {
+    sequence_lengths_token.Resize({{batch_size}});
+    dev_ctx.template Alloc<int>(&sequence_lengths_token,
+                                sequence_lengths_token.numel() * sizeof(int));
+  }
+
+  for (int j = 0; j < num_tokens; ++j) {
+    GatherDraftToken<<<batch_size, 256, 0, stream>>>(
+        qkv_token_data, qkv_tensor.data<T>(), num_tokens, j, qkv_size);
+    if (src_mask_tensor) {
+      GatherDraftToken<<<mask_rows, 256, 0, stream>>>(
+          mask_token.data<T>(),
+          src_mask_tensor->data<T>(),
+          num_tokens,
+          j,
+          static_cast<int>(mask_token.dims()[3]));
+    }
+    if (rotary_emb_dims > 0) {
+      GatherDraftToken<<<rotary_rows, 256, 0, stream>>>(
+          rotary_token.data<float>(),
+          rotary_tensor->data<float>(),
+          num_tokens,
+          j,
+          static_cast<int>(rotary_token.dims()[4]));
+    }
+    if (sequence_lengths_tensor) {
+      DraftSequenceLengths<<<(batch_size + 255) / 256, 256, 0, stream>>>(
+          sequence_lengths_token.data<int>(),
+          sequence_lengths_tensor->data<int>(),
+          j,
+          batch_size);
+    }
+
+    const phi::DenseTensor *mask = src_mask_tensor ? &mask_token : nullptr;
+    const phi::DenseTensor *sequence_lengths =
+        sequence_lengths_tensor ? &sequence_lengths_token : nullptr;
+    const phi::DenseTensor *rotary =
+        rotary_emb_dims > 0 ? &rotary_token : nullptr;
+    if (use_mbfmha) {
+      mbfmha<T>(dev_ctx,
+                qkv_token,
+                qkv_bias_tensor,
+                mask,
+                nullptr,
+                sequence_lengths,
+                rotary,
+                cache_kv_tensor,
+                &out_token,
+                partial_max_logits_tensor,
+                partial_expsum_tensor,
+                partial_out_tensor,
+                batch_size,
+                cache_batch_size,
+                1,
+                max_seq_length,
+                num_head,
+                dim_head,
+                timestep + j,
+                rotary_emb_dims,
+                inv_sqrt_dh,
+                mask_broadcast_num_heads,
+                add_qkv_bias,
+                neox_rotary_style,
+                gqa_group_size);
+    } else {
+      fmha<T>(dev_ctx,
+              qkv_token,
+              qkv_bias_tensor,
+              mask,
+              nullptr,
+              sequence_lengths,
+              rotary,
+              nullptr,
+              cache_kv_tensor,
+              &out_token,
+              batch_size,
+              cache_batch_size,
+              1,
+              max_seq_length,
+              num_head,
+              dim_head,
+              timestep + j,
+              rotary_emb_dims,
+              inv_sqrt_dh,
+              mask_broadcast_num_heads,
+              add_qkv_bias,
+              neox_rotary_style,
+              gqa_group_size);
+    }
+    ScatterDraftToken<<<batch_size, 256, 0, stream>>>(
+        out_tensor->data<T>(), out_token_data, num_tokens, j, out_size);
+  }
+}
+
 // NOTE: simd with 16Bytes(128bit), float is 4, float16 is 8
 constexpr int VEC_16B = 16;
 
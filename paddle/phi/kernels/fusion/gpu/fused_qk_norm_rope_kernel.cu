@@ -0,0 +1,185 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/enforce.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+
+namespace phi {
+namespace fusion {
+
+// Every block handles one head of a token of q or k: the head is normalized
+// by RMSNorm over head_dim, then rotated by the sin and cos of the position
+// of the token, so the normalized head never goes back to global memory.
+//
+// The rotated pair of element i is (i, i + 1) for every two, and
+// (i, i + head_dim / 2) for rotate half, both rotate as
+//   out[a] = cos[a] * x[a] - sin[a] * x[b]
+//   out[b] = sin[b] * x[a] + cos[b] * x[b].
+template <typename T>
+__global__ void FusedQkNormRopeCUDAKernel(const T* q,
+                                          const T* k,
+                                          const T* q_norm_weight,
+                                          const T* k_norm_weight,
+                                          const T* sin,
+                                          const T* cos,
+                                          const int64_t* position_ids,
+                                          int64_t seq_len,
+                                          int64_t q_num_heads,
+                                          int64_t k_num_heads,
+                                          int64_t head_dim,
+                                          int64_t q_rows,
+                                          int64_t num_rows,
+                                          float epsilon,
+                                          bool rotate_every_two,
+                                          T* out_q,
+                                          T* out_k) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  const int64_t half_dim = head_dim / 2;
+  for (int64_t row = blockIdx.x; row < num_rows; row += gridDim.x) {
+    bool is_q = row < q_rows;
+    int64_t head_row = is_q ? row : row - q_rows;
+    int64_t token = head_row / (is_q ? q_num_heads : k_num_heads);
+    const T* x = (is_q ? q : k) + head_row * head_dim;
+    const T* weight = is_q ? q_norm_weight : k_norm_weight;
+    T* out = (is_q ? out_q : out_k) + head_row * head_dim;
+
+    MPType square_sum = static_cast<MPType>(0);
+    for (int64_t i = threadIdx.x; i < head_dim; i += blockDim.x) {
+      MPType value = static_cast<MPType>(x[i]);
+      square_sum += value * value;
+    }
+    square_sum = phi::funcs::BlockReduceSum<MPType>(square_sum, FINAL_MASK);
+    MPType scale = rsqrt(square_sum / static_cast<MPType>(head_dim) +
+                         static_cast<MPType>(epsilon));
+
+    int64_t pos = position_ids ? position_ids[token] : token % seq_len;
+    const T* sin_row = sin + pos * head_dim;
+    const T* cos_row = cos + pos * head_dim;
+    for (int64_t p = threadIdx.x; p < half_dim; p += blockDim.x) {
+      int64_t a = rotate_every_two ? 2 * p : p;
+      int64_t b = rotate_every_two ? 2 * p + 1 : p + half_dim;
+      MPType xa = static_cast<MPType>(x[a]) * scale *
+                  static_cast<MPType>(weight[a]);
+      MPType xb = static_cast<MPType>(x[b]) * scale *
+                  static_cast<MPType>(weight[b]);
+      out[a] = static_cast<T>(static_cast<MPType>(cos_row[a]) * xa -
+                              static_cast<MPType>(sin_row[a]) * xb);
+      out[b] = static_cast<T>(static_cast<MPType>(sin_row[b]) * xa +
+                              static_cast<MPType>(cos_row[b]) * xb);
+    }
+  }
+}
+
+template <typename T, typename Context>
+void FusedQkNormRopeKernel(const Context& dev_ctx,
+                           const DenseTensor& q,
+                           const DenseTensor& k,
+                           const DenseTensor& q_norm_weight,
+                           const DenseTensor& k_norm_weight,
+                           const DenseTensor& sin,
+                           const DenseTensor& cos,
+                           const paddle::optional<DenseTensor>& position_ids,
+                           float epsilon,
+                           bool use_neox_rotary_style,
+                           DenseTensor* out_q,
+                           DenseTensor* out_k) {
+  dev_ctx.template Alloc<T>(out_q);
+  dev_ctx.template Alloc<T>(out_k);
+  if (q.numel() == 0) {
+    return;
+  }
+
+  // q.shape: [batch_size, seq_len, num_heads, head_dim]
+  const int64_t batch_size = q.dims()[0];
+  const int64_t seq_len = q.dims()[1];
+  const int64_t q_num_heads = q.dims()[2];
+  const int64_t k_num_heads = k.dims()[2];
+  const int64_t head_dim = q.dims()[3];
+
+  // sin.shape: [seq_len, head_dim] or [1, seq_len, 1, head_dim]
+  const auto& sin_dims = sin.dims();
+  PADDLE_ENFORCE_EQ(
+      sin_dims.size() == 2 ||
+          (sin_dims.size() == 4 && sin_dims[0] == 1 && sin_dims[2] == 1),
+      true,
+      common::errors::InvalidArgument(
+          "The sin and cos of fused_qk_norm_rope should be of shape "
+          "[seq_len, head_dim] or [1, seq_len, 1, head_dim], but got {%s}.",
+          sin_dims));
+  const int64_t sin_seq_len = sin_dims[sin_dims.size() == 4 ? 1 : 0];
+  const int64_t* position_ids_data = nullptr;
+  if (position_ids) {
+    PADDLE_ENFORCE_EQ(
+        position_ids->numel(),
+        batch_size * seq_len,
+        common::errors::InvalidArgument(
+            "The position_ids of fused_qk_norm_rope should be of shape "
+            "[batch_size, seq_len], but got {%s}.",
+            position_ids->dims()));
+    position_ids_data = position_ids->data<int64_t>();
+  } else {
+    PADDLE_ENFORCE_GE(
+        sin_seq_len,
+        seq_len,
+        common::errors::InvalidArgument(
+            "The seq_len of sin and cos (%d) should not be less than the "
+            "seq_len of q (%d).",
+            sin_seq_len,
+            seq_len));
+  }
+
+  const int64_t q_rows = batch_size * seq_len * q_num_heads;
+  const int64_t num_rows = q_rows + batch_size * seq_len * k_num_heads;
+  int threads = static_cast<int>((head_dim / 2 + 31) / 32 * 32);
+  threads = std::min(std::max(threads, 32), 256);
+  int64_t max_grid = dev_ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(num_rows, max_grid));
+  // NOTE: use_neox_rotary_style rotates every two elements, the same as
+  // fused_rotary_position_embedding.
+  FusedQkNormRopeCUDAKernel<T>
+      <<<grid, threads, 0, dev_ctx.stream()>>>(q.data<T>(),
+                                               k.data<T>(),
+                                               q_norm_weight.data<T>(),
+                                               k_norm_weight.data<T>(),
+                                               sin.data<T>(),
+                                               cos.data<T>(),
+                                               position_ids_data,
+                                               seq_len,
+                                               q_num_heads,
+                                               k_num_heads,
+                                               head_dim,
+                                               q_rows,
+                                               num_rows,
+                                               epsilon,
+                                               use_neox_rotary_style,
+                                               out_q->data<T>(),
+                                               out_k->data<T>());
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(fused_qk_norm_rope,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::FusedQkNormRopeKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
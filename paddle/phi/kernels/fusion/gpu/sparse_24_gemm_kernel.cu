@@ -0,0 +1,175 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef PADDLE_WITH_CUSPARSELT
+#include "paddle/phi/kernels/fusion/gpu/sparse_24_gemm_utils.h"
+
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+namespace fusion {
+
+namespace {
+
+// The descriptors and the plan of a shape, which live as long as the
+// process, like the algorithm caches of cuBLASLt.
+struct Sparse24GemmPlan {
+  cusparseLtMatDescriptor_t mat_a;
+  cusparseLtMatDescriptor_t mat_b;
+  cusparseLtMatDescriptor_t mat_c;
+  cusparseLtMatmulDescriptor_t matmul;
+  cusparseLtMatmulAlgSelection_t alg_sel;
+  cusparseLtMatmulPlan_t plan;
+  size_t workspace_size{0};
+};
+
+// out[m, n] = x[m, k] * weight[n, k]^T
+const Sparse24GemmPlan& GetSparse24GemmPlan(cusparseLtHandle_t* handle,
+                                            int device,
+                                            int64_t m,
+                                            int64_t n,
+                                            int64_t k,
+                                            cudaDataType_t type) {
+  using Key = std::tuple<int, int64_t, int64_t, int64_t, int>;
+  static std::mutex mutex;
+  static std::map<Key, std::unique_ptr<Sparse24GemmPlan>> plans;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& plan = plans[Key(device, m, n, k, static_cast<int>(type))];
+  if (plan != nullptr) {
+    return *plan;
+  }
+  plan = std::make_unique<Sparse24GemmPlan>();
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtDenseDescriptorInit(handle,
+                                                  &plan->mat_a,
+                                                  m,
+                                                  k,
+                                                  k,
+                                                  kSparse24Alignment,
+                                                  type,
+                                                  CUSPARSE_ORDER_ROW));
+  InitSparse24WeightDescriptor(handle, &plan->mat_b, n, k, type);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtDenseDescriptorInit(handle,
+                                                  &plan->mat_c,
+                                                  m,
+                                                  n,
+                                                  n,
+                                                  kSparse24Alignment,
+                                                  type,
+                                                  CUSPARSE_ORDER_ROW));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtMatmulDescriptorInit(
+      handle,
+      &plan->matmul,
+      CUSPARSE_OPERATION_NON_TRANSPOSE,
+      CUSPARSE_OPERATION_TRANSPOSE,
+      &plan->mat_a,
+      &plan->mat_b,
+      &plan->mat_c,
+      &plan->mat_c,
+      CUSPARSE_COMPUTE_16F));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtMatmulAlgSelectionInit(
+      handle, &plan->alg_sel, &plan->matmul, CUSPARSELT_MATMUL_ALG_DEFAULT));
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtMatmulGetWorkspace(
+      handle, &plan->alg_sel, &plan->workspace_size));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtMatmulPlanInit(handle,
+                                             &plan->plan,
+                                             &plan->matmul,
+                                             &plan->alg_sel,
+                                             plan->workspace_size));
+  return *plan;
+}
+
+}  // namespace
+
+template <typename T, typename Context>
+void Sparse24GemmKernel(const Context& dev_ctx,
+                        const DenseTensor& x,
+                        const DenseTensor& compressed_weight,
+                        int n,
+                        int k,
+                        DenseTensor* out) {
+  dev_ctx.template Alloc<T>(out);
+  const int64_t m = x.numel() / k;
+  if (m == 0) {
+    return;
+  }
+  // the rows of the dense matrices are padded to the alignment of cuSPARSELt
+  const int64_t padded_m =
+      (m + kSparse24Alignment - 1) / kSparse24Alignment * kSparse24Alignment;
+  const int device = dev_ctx.GetPlace().GetDeviceId();
+  auto* handle = GetCusparseLtHandle(device);
+  const auto& plan = GetSparse24GemmPlan(
+      handle, device, padded_m, n, k, ToSparse24DataType(x.dtype()));
+
+  const T* x_data = x.data<T>();
+  T* out_data = out->data<T>();
+  DenseTensor padded_x, padded_out;
+  if (padded_m != m) {
+    padded_x.Resize({padded_m, k});
+    dev_ctx.template Alloc<T>(&padded_x);
+    phi::funcs::SetConstant<Context, T>()(&dev_ctx, &padded_x, T(0));
+    phi::memory_utils::Copy(dev_ctx.GetPlace(),
+                            padded_x.data<T>(),
+                            dev_ctx.GetPlace(),
+                            x_data,
+                            m * k * sizeof(T),
+                            dev_ctx.stream());
+    x_data = padded_x.data<T>();
+    padded_out.Resize({padded_m, n});
+    out_data = dev_ctx.template Alloc<T>(&padded_out);
+  }
+
+  DenseTensor workspace;
+  workspace.Resize({static_cast<int64_t>(plan.workspace_size)});
+  auto* workspace_data = dev_ctx.template Alloc<uint8_t>(&workspace);
+  float alpha = 1.0f;
+  float beta = 0.0f;
+  cudaStream_t stream = dev_ctx.stream();
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtMatmul(handle,
+                                     &plan.plan,
+                                     &alpha,
+                                     x_data,
+                                     compressed_weight.data<uint8_t>(),
+                                     &beta,
+                                     out_data,
+                                     out_data,
+                                     workspace_data,
+                                     &stream,
+                                     1));
+
+  if (padded_m != m) {
+    phi::memory_utils::Copy(dev_ctx.GetPlace(),
+                            out->data<T>(),
+                            dev_ctx.GetPlace(),
+                            out_data,
+                            m * n * sizeof(T),
+                            dev_ctx.stream());
+  }
+}
+
+}  // namespace fusion
+}  // namespace phi
+
+PD_REGISTER_KERNEL(sparse_24_gemm,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::fusion::Sparse24GemmKernel,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
+#endif
@@ -0,0 +1,109 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#ifdef PADDLE_WITH_CUSPARSELT
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#include "paddle/phi/backends/dynload/cusparseLt.h"
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/core/dense_tensor.h"
+#include "paddle/phi/core/enforce.h"
+
+namespace phi {
+namespace fusion {
+
+// The weight of sparse_24_gemm is the [n, k] transpose of the [k, n] weight
+// of matmul, with 2 nonzeros in every 4 consecutive elements along k, and is
+// compressed by cuSPARSELt into an opaque buffer of uint8. The same layout
+// as the sparse_fc plugin of TensorRT.
+constexpr int kSparse24Alignment = 16;
+
+inline cudaDataType_t ToSparse24DataType(phi::DataType dtype) {
+  switch (dtype) {
+    case phi::DataType::FLOAT16:
+      return CUDA_R_16F;
+    case phi::DataType::BFLOAT16:
+      return CUDA_R_16BF;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "sparse_24_gemm supports float16 and bfloat16, but got %s.",
+          dtype));
+  }
+}
+
+// One handle per device, cuSPARSELt handles are thread safe.
+inline cusparseLtHandle_t* GetCusparseLtHandle(int device) {
+  static std::mutex mutex;
+  static std::map<int, std::unique_ptr<cusparseLtHandle_t>> handles;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& handle = handles[device];
+  if (handle == nullptr) {
+    handle = std::make_unique<cusparseLtHandle_t>();
+    PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtInit(handle.get()));
+  }
+  return handle.get();
+}
+
+inline void InitSparse24WeightDescriptor(cusparseLtHandle_t* handle,
+                                         cusparseLtMatDescriptor_t* desc,
+                                         int64_t n,
+                                         int64_t k,
+                                         cudaDataType_t type) {
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtStructuredDescriptorInit(
+      handle,
+      desc,
+      n,
+      k,
+      k,
+      kSparse24Alignment,
+      type,
+      CUSPARSE_ORDER_ROW,
+      CUSPARSELT_SPARSITY_50_PERCENT));
+}
+
+// Compresses the [n, k] weight on the device into compressed.
+inline void CompressSparse24Weight(const phi::GPUContext& dev_ctx,
+                                   const DenseTensor& weight,
+                                   DenseTensor* compressed) {
+  const int64_t n = weight.dims()[0];
+  const int64_t k = weight.dims()[1];
+  auto* handle = GetCusparseLtHandle(dev_ctx.GetPlace().GetDeviceId());
+  cusparseLtMatDescriptor_t desc;
+  InitSparse24WeightDescriptor(
+      handle, &desc, n, k, ToSparse24DataType(weight.dtype()));
+  size_t compressed_size = 0;
+  PADDLE_ENFORCE_GPU_SUCCESS(phi::dynload::cusparseLtSpMMACompressedSize2(
+      handle, &desc, &compressed_size));
+  compressed->Resize({static_cast<int64_t>(compressed_size)});
+  auto* compressed_data = dev_ctx.template Alloc<uint8_t>(compressed);
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtSpMMACompress2(handle,
+                                             &desc,
+                                             0,
+                                             CUSPARSE_OPERATION_TRANSPOSE,
+                                             weight.data(),
+                                             compressed_data,
+                                             dev_ctx.stream()));
+  PADDLE_ENFORCE_GPU_SUCCESS(
+      phi::dynload::cusparseLtMatDescriptorDestroy(&desc));
+}
+
+}  // namespace fusion
+}  // namespace phi
+#endif
@@ -137,3 +137,11 @@ PD_REGISTER_KERNEL(weight_only_linear_xpu,
                    phi::WeightOnlyLinearKernel,
                    phi::dtype::float16,
                    phi::dtype::bfloat16) {}
+
+// The same kernel for the device independent op, so that models calling
+// paddle.nn.quant.weight_only_linear run on XPU unchanged.
+PD_REGISTER_KERNEL(weight_only_linear,
+                   XPU,
+                   ALL_LAYOUT,
+                   phi::WeightOnlyLinearKernel,
+                   phi::dtype::float16) {}
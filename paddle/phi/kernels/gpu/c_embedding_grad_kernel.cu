@@ -78,7 +78,33 @@ void CEmbeddingGradKernel(const Context& dev_ctx,
   t.device(*dev_ctx.eigen_device()) = t.constant(static_cast<T>(0));
 
   const auto& index_type = ids.dtype();
-  if (FLAGS_embedding_deterministic == 1) {
+  if (FLAGS_embedding_deterministic == 3 ||
+      (FLAGS_embedding_deterministic == 0 &&
+       phi::funcs::UseEmbeddingGradSortedKernel(N, K))) {
+    if (index_type == phi::DataType::INT32) {
+      phi::funcs::LaunchEmbeddingGradSortedKernel<T, int32_t>(
+          dev_ctx,
+          ids.data<int32_t>(),
+          d_output,
+          d_table,
+          N,
+          D,
+          K,
+          start_index);
+      return;
+    } else if (index_type == phi::DataType::INT64) {
+      phi::funcs::LaunchEmbeddingGradSortedKernel<T, int64_t>(
+          dev_ctx,
+          ids.data<int64_t>(),
+          d_output,
+          d_table,
+          N,
+          D,
+          K,
+          start_index);
+      return;
+    }
+  } else if (FLAGS_embedding_deterministic == 1) {
     if (index_type == phi::DataType::INT32) {
       phi::funcs::LaunchEmbeddingGradDeterministicKernel<T, int32_t>(
           dev_ctx,
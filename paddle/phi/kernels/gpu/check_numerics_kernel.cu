@@ -408,6 +408,21 @@ static void WriteToOutputDir(const phi::GPUContext& ctx,
                                                   output_dir);
 }
 
+template <typename T, typename MT>
+__global__ void FindNanInfAndSetFlag(const T* value_ptr,
+                                     const int64_t numel,
+                                     int* flag) {
+  int64_t i = threadIdx.x + blockIdx.x * blockDim.x;
+  for (; i < numel; i += blockDim.x * gridDim.x) {
+    MT value = static_cast<MT>(value_ptr[i]);
+    if (isnan(value) || isinf(value)) {
+      // All the writers write 1, so no atomic operation is needed.
+      *reinterpret_cast<volatile int*>(flag) = 1;
+      return;
+    }
+  }
+}
+
 template <typename T, typename Context>
 void CheckNumericsKernel(const Context& ctx,
                          const DenseTensor& tensor,
@@ -500,6 +515,36 @@ void CheckNumericsKernel(const Context& ctx,
   }
 }
 
+template <typename T, typename Context>
+void AccumulateNanInfFlag(const Context& ctx,
+                          const DenseTensor& tensor,
+                          int* flag) {
+  if (tensor.numel() <= 0) return;
+
+  const size_t threads = 1024;
+  size_t blocks =
+      std::min(static_cast<size_t>(128),
+               static_cast<size_t>((tensor.numel() + threads - 1) / threads));
+
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
+  FindNanInfAndSetFlag<T, MT><<<blocks, threads, 0, ctx.stream()>>>(
+      tensor.data<T>(), tensor.numel(), flag);
+}
+
+#define INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(T)       \
+  template void AccumulateNanInfFlag<T, GPUContext>( \
+      const GPUContext& ctx, const DenseTensor& tensor, int* flag);
+
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(float)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(double)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float16)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::bfloat16)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::complex<float>)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::complex<double>)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float8_e4m3fn)
+INSTANTIATE_ACCUMULATE_NAN_INF_FLAG(phi::dtype::float8_e5m2)
+#undef INSTANTIATE_ACCUMULATE_NAN_INF_FLAG
+
 }  // namespace phi
 
 PD_REGISTER_KERNEL(check_numerics,
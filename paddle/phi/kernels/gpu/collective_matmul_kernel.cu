@@ -0,0 +1,283 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/collective_matmul_kernel.h"
+
+#include <memory>
+#include <vector>
+
+#include "paddle/phi/backends/all_context.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/elementwise_add_kernel.h"
+#include "paddle/phi/kernels/matmul_kernel.h"
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+#include "paddle/phi/core/distributed/nccl_comm_context.h"
+#include "paddle/phi/core/platform/device/gpu/gpu_resource_pool.h"
+#endif
+
+namespace phi {
+
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+namespace {
+
+// The blocks of rows of the ring are exchanged on a side stream, so the
+// GEMM of the block of one rank on the calc stream overlaps the transfer of
+// the block of the next one.
+class RingPipeline {
+ public:
+  RingPipeline(const phi::GPUContext& dev_ctx,
+               distributed::NCCLCommContext* comm_ctx)
+      : comm_ctx_(comm_ctx),
+        dev_id_(dev_ctx.GetPlace().GetDeviceId()),
+        calc_stream_(dev_ctx.stream()) {
+    comm_stream_ =
+        paddle::platform::CudaStreamResourcePool::Instance().New(dev_id_);
+    const int nranks = comm_ctx_->GetSize();
+    next_ = (comm_ctx_->GetRank() + 1) % nranks;
+    prev_ = (comm_ctx_->GetRank() + nranks - 1) % nranks;
+  }
+
+  // Sends `send` to the next rank and receives `recv` from the previous one
+  // after the work issued on the calc stream so far, returns the event of the
+  // transfer.
+  std::shared_ptr<paddle::platform::CudaEventObject> SendRecv(
+      const DenseTensor& send, DenseTensor* recv) {
+    Wait(comm_stream_.get(), Record(calc_stream_).get());
+    comm_ctx_->GroupStart();
+    comm_ctx_->Send(send, send.numel(), next_, comm_stream_.get());
+    comm_ctx_->Recv(recv, recv->numel(), prev_, comm_stream_.get());
+    comm_ctx_->GroupEnd();
+    return Record(comm_stream_.get());
+  }
+
+  // The tensors of the ring are released on the calc stream, it must wait
+  // for the event of the last transfer.
+  void CalcWait(
+      const std::shared_ptr<paddle::platform::CudaEventObject>& event) {
+    Wait(calc_stream_, event.get());
+  }
+
+ private:
+  std::shared_ptr<paddle::platform::CudaEventObject> Record(
+      gpuStream_t stream) {
+    auto event =
+        paddle::platform::CudaEventResourcePool::Instance().New(dev_id_);
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipEventRecord(event.get(), stream));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaEventRecord(event.get(), stream));
+#endif
+    return event;
+  }
+
+  void Wait(gpuStream_t stream, gpuEvent_t event) {
+#ifdef PADDLE_WITH_HIP
+    PADDLE_ENFORCE_GPU_SUCCESS(hipStreamWaitEvent(stream, event, 0));
+#else
+    PADDLE_ENFORCE_GPU_SUCCESS(cudaStreamWaitEvent(stream, event, 0));
+#endif
+  }
+
+  distributed::NCCLCommContext* comm_ctx_;
+  int dev_id_;
+  gpuStream_t calc_stream_;
+  std::shared_ptr<paddle::platform::CudaStreamObject> comm_stream_;
+  int next_;
+  int prev_;
+};
+
+distributed::NCCLCommContext* GetNCCLCommContext(const phi::GPUContext& dev_ctx,
+                                                 int nranks) {
+  auto comm_ctx =
+      static_cast<distributed::NCCLCommContext*>(dev_ctx.GetCommContext());
+  PADDLE_ENFORCE_NE(comm_ctx,
+                    nullptr,
+                    errors::Unavailable("NCCLCommContext is nullptr, collective "
+                                        "op should has ring_id attr."));
+  PADDLE_ENFORCE_EQ(
+      nranks,
+      comm_ctx->GetSize(),
+      errors::InvalidArgument(
+          "nranks: %s should equal to %s", nranks, comm_ctx->GetSize()));
+  return comm_ctx;
+}
+
+// views the tensor as a matrix of its last dimension
+DenseTensor FlattenTo2D(const DenseTensor& x) {
+  DenseTensor matrix;
+  matrix.ShareDataWith(x);
+  const int64_t cols = x.dims()[x.dims().size() - 1];
+  matrix.Resize({x.numel() / cols, cols});
+  return matrix;
+}
+
+}  // namespace
+#endif
+
+template <typename T, typename Context>
+void AllGatherMatmulKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& y,
+                           bool transpose_y,
+                           int nranks,
+                           DenseTensor* out,
+                           DenseTensor* x_gathered) {
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+  auto comm_ctx = GetNCCLCommContext(dev_ctx, nranks);
+  const int rank = comm_ctx->GetRank();
+
+  dev_ctx.template Alloc<T>(x_gathered);
+  dev_ctx.template Alloc<T>(out);
+  DenseTensor gathered = FlattenTo2D(*x_gathered);
+  DenseTensor result = FlattenTo2D(*out);
+  const int64_t rows = gathered.dims()[0] / nranks;
+
+  DenseTensor local = gathered.Slice(rank * rows, (rank + 1) * rows);
+  memory_utils::Copy(dev_ctx.GetPlace(),
+                     local.data(),
+                     x.place(),
+                     x.data(),
+                     x.numel() * sizeof(T),
+                     dev_ctx.stream());
+
+  // The block of rank r - s arrives at step s, it is forwarded to the next
+  // rank at step s + 1. All the steps are queued on the side stream first.
+  RingPipeline ring(dev_ctx, comm_ctx);
+  std::vector<DenseTensor> blocks;
+  std::vector<std::shared_ptr<paddle::platform::CudaEventObject>> arrived;
+  for (int step = 1; step < nranks; ++step) {
+    const int send_rank = (rank - step + 1 + nranks) % nranks;
+    const int recv_rank = (rank - step + nranks) % nranks;
+    DenseTensor send = gathered.Slice(send_rank * rows, (send_rank + 1) * rows);
+    DenseTensor recv = gathered.Slice(recv_rank * rows, (recv_rank + 1) * rows);
+    arrived.push_back(ring.SendRecv(send, &recv));
+    blocks.push_back(recv);
+  }
+
+  // local rows first, they need no transfer
+  DenseTensor local_out = result.Slice(rank * rows, (rank + 1) * rows);
+  MatmulKernel<T, Context>(dev_ctx, local, y, false, transpose_y, &local_out);
+  for (int step = 1; step < nranks; ++step) {
+    const int recv_rank = (rank - step + nranks) % nranks;
+    DenseTensor block_out =
+        result.Slice(recv_rank * rows, (recv_rank + 1) * rows);
+    ring.CalcWait(arrived[step - 1]);
+    MatmulKernel<T, Context>(
+        dev_ctx, blocks[step - 1], y, false, transpose_y, &block_out);
+  }
+#else
+  PADDLE_THROW(
+      errors::PreconditionNotMet("PaddlePaddle should compile with GPU."));
+#endif
+}
+
+template <typename T, typename Context>
+void MatmulReduceScatterKernel(const Context& dev_ctx,
+                               const DenseTensor& x,
+                               const DenseTensor& y,
+                               bool transpose_y,
+                               int nranks,
+                               DenseTensor* out) {
+#if defined(PADDLE_WITH_NCCL) || defined(PADDLE_WITH_RCCL)
+  auto comm_ctx = GetNCCLCommContext(dev_ctx, nranks);
+  const int rank = comm_ctx->GetRank();
+
+  dev_ctx.template Alloc<T>(out);
+  DenseTensor input = FlattenTo2D(x);
+  DenseTensor result = FlattenTo2D(*out);
+  PADDLE_ENFORCE_EQ(input.dims()[0] % nranks,
+                    0,
+                    errors::InvalidArgument(
+                        "The rows of X (%d) should be divisible by nranks(%d)",
+                        input.dims()[0],
+                        nranks));
+  const int64_t rows = input.dims()[0] / nranks;
+  const int64_t cols = result.dims()[1];
+
+  // The partial sum of the block of rank r - s - 1 is computed at step s,
+  // added to the one received from the previous rank and sent to the next
+  // one, at the last step every rank holds the sum of its own block. Two
+  // buffers let the GEMM of a step overlap the send of the previous one.
+  RingPipeline ring(dev_ctx, comm_ctx);
+  DenseTensor partials[2];
+  DenseTensor received;
+  std::shared_ptr<paddle::platform::CudaEventObject> arrived;
+  if (nranks > 1) {
+    for (auto& partial : partials) {
+      partial.Resize({rows, cols});
+      dev_ctx.template Alloc<T>(&partial);
+    }
+    received.Resize({rows, cols});
+    dev_ctx.template Alloc<T>(&received);
+  }
+
+  for (int step = 0; step < nranks; ++step) {
+    const int block_rank = (rank - step - 1 + 2 * nranks) % nranks;
+    DenseTensor* partial = step + 1 == nranks ? &result : &partials[step % 2];
+    DenseTensor block =
+        input.Slice(block_rank * rows, (block_rank + 1) * rows);
+    MatmulKernel<T, Context>(dev_ctx, block, y, false, transpose_y, partial);
+    if (step > 0) {
+      ring.CalcWait(arrived);
+      AddKernel<T, Context>(dev_ctx, *partial, received, partial);
+    }
+    if (step + 1 < nranks) {
+      arrived = ring.SendRecv(*partial, &received);
+    }
+  }
+#else
+  PADDLE_THROW(
+      errors::PreconditionNotMet("PaddlePaddle should compile with GPU."));
+#endif
+}
+
+}  // namespace phi
+
+#if NCCL_VERSION_CODE >= 21000
+PD_REGISTER_KERNEL(all_gather_matmul,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::AllGatherMatmulKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16,
+                   phi::dtype::float16) {}
+
+PD_REGISTER_KERNEL(matmul_reduce_scatter,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MatmulReduceScatterKernel,
+                   float,
+                   double,
+                   phi::dtype::bfloat16,
+                   phi::dtype::float16) {}
+#else
+PD_REGISTER_KERNEL(all_gather_matmul,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::AllGatherMatmulKernel,
+                   float,
+                   double,
+                   phi::dtype::float16) {}
+
+PD_REGISTER_KERNEL(matmul_reduce_scatter,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MatmulReduceScatterKernel,
+                   float,
+                   double,
+                   phi::dtype::float16) {}
+#endif
@@ -0,0 +1,168 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/crop_resize_normalize_kernel.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/core/utils/array.h"
+
+namespace phi {
+
+template <typename T>
+struct ImageDesc {
+  const T* data;
+  int height;
+  int width;
+};
+
+// Every thread computes one output pixel of one channel. The crop box is
+// clamped into the image, then the pixel is sampled bilinearly with the
+// half pixel centers of interpolate(align_corners=False), so the cropped and
+// resized image never goes back to global memory before being normalized.
+template <typename T>
+__global__ void CropResizeNormalizeCUDAKernel(const ImageDesc<T>* images,
+                                              const int* boxes,
+                                              const bool* flip,
+                                              int64_t numel,
+                                              int channels,
+                                              int out_h,
+                                              int out_w,
+                                              phi::Array<float, 4> mean,
+                                              phi::Array<float, 4> inv_std,
+                                              float* out) {
+  CUDA_KERNEL_LOOP_TYPE(index, numel, int64_t) {
+    int ox = static_cast<int>(index % out_w);
+    int oy = static_cast<int>(index / out_w % out_h);
+    int c = static_cast<int>(index / out_w / out_h % channels);
+    int64_t n = index / out_w / out_h / channels;
+
+    const ImageDesc<T> image = images[n];
+    const int* box = boxes + n * 4;
+    int top = min(max(box[0], 0), image.height - 1);
+    int left = min(max(box[1], 0), image.width - 1);
+    int crop_h = min(max(box[2], 1), image.height - top);
+    int crop_w = min(max(box[3], 1), image.width - left);
+    if (flip != nullptr && flip[n]) {
+      ox = out_w - 1 - ox;
+    }
+
+    float ratio_h = static_cast<float>(crop_h) / out_h;
+    float ratio_w = static_cast<float>(crop_w) / out_w;
+    float src_y = max((oy + 0.5f) * ratio_h - 0.5f, 0.0f);
+    float src_x = max((ox + 0.5f) * ratio_w - 0.5f, 0.0f);
+    int y0 = min(static_cast<int>(src_y), crop_h - 1);
+    int x0 = min(static_cast<int>(src_x), crop_w - 1);
+    int y1 = min(y0 + 1, crop_h - 1);
+    int x1 = min(x0 + 1, crop_w - 1);
+    float ly = src_y - y0;
+    float lx = src_x - x0;
+
+    const T* plane = image.data +
+                     static_cast<int64_t>(c) * image.height * image.width +
+                     static_cast<int64_t>(top) * image.width + left;
+    float v00 = static_cast<float>(plane[y0 * image.width + x0]);
+    float v01 = static_cast<float>(plane[y0 * image.width + x1]);
+    float v10 = static_cast<float>(plane[y1 * image.width + x0]);
+    float v11 = static_cast<float>(plane[y1 * image.width + x1]);
+    float value = (1.0f - ly) * ((1.0f - lx) * v00 + lx * v01) +
+                  ly * ((1.0f - lx) * v10 + lx * v11);
+    out[index] = (value - mean[c]) * inv_std[c];
+  }
+}
+
+template <typename T, typename Context>
+void CropResizeNormalizeKernel(const Context& dev_ctx,
+                               const std::vector<const DenseTensor*>& x,
+                               const DenseTensor& boxes,
+                               const paddle::optional<DenseTensor>& flip,
+                               const std::vector<int>& size,
+                               const std::vector<float>& mean,
+                               const std::vector<float>& std,
+                               DenseTensor* out) {
+  float* out_data = dev_ctx.template Alloc<float>(out);
+  if (out->numel() == 0) {
+    return;
+  }
+
+  const int channels = static_cast<int>(x[0]->dims()[0]);
+  std::vector<ImageDesc<T>> images(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    images[i].data = x[i]->data<T>();
+    images[i].height = static_cast<int>(x[i]->dims()[1]);
+    images[i].width = static_cast<int>(x[i]->dims()[2]);
+    PADDLE_ENFORCE_GT(
+        images[i].height * images[i].width,
+        0,
+        common::errors::InvalidArgument(
+            "The image %d of crop_resize_normalize should not be empty.", i));
+  }
+  const size_t num_bytes = images.size() * sizeof(ImageDesc<T>);
+  auto images_allocation = phi::memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      num_bytes,
+      phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+  phi::backends::gpu::GpuMemcpyAsync(images_allocation->ptr(),
+                                     images.data(),
+                                     num_bytes,
+                                     phi::gpuMemcpyHostToDevice,
+                                     dev_ctx.stream());
+
+  phi::Array<float, 4> mean_array;
+  phi::Array<float, 4> inv_std_array;
+  for (int c = 0; c < channels; ++c) {
+    mean_array[c] = mean.empty() ? 0.0f : mean[mean.size() == 1 ? 0 : c];
+    float s = std.empty() ? 1.0f : std[std.size() == 1 ? 0 : c];
+    PADDLE_ENFORCE_NE(
+        s,
+        0.0f,
+        common::errors::InvalidArgument(
+            "The std of crop_resize_normalize should not be zero."));
+    inv_std_array[c] = 1.0f / s;
+  }
+
+  const int64_t numel = out->numel();
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+  CropResizeNormalizeCUDAKernel<T>
+      <<<config.block_per_grid,
+         config.thread_per_block,
+         0,
+         dev_ctx.stream()>>>(
+          reinterpret_cast<const ImageDesc<T>*>(images_allocation->ptr()),
+          boxes.data<int>(),
+          flip ? flip->data<bool>() : nullptr,
+          numel,
+          channels,
+          size[0],
+          size[1],
+          mean_array,
+          inv_std_array,
+          out_data);
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(crop_resize_normalize,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::CropResizeNormalizeKernel,
+                   uint8_t,
+                   float) {
+  kernel->OutputAt(0).SetDataType(phi::DataType::FLOAT32);
+}
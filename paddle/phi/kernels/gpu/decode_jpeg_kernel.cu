@@ -23,8 +23,10 @@
 
 namespace phi {
 
-static cudaStream_t nvjpeg_stream = nullptr;
 static nvjpegHandle_t nvjpeg_handle = nullptr;
+// The decoding state owns the pinned and device buffers of nvJPEG, it is
+// reused by every decoding instead of being created for every image.
+static nvjpegJpegState_t nvjpeg_state = nullptr;
 
 void InitNvjpegImage(nvjpegImage_t* img) {
   for (int c = 0; c < NVJPEG_MAX_COMPONENT; c++) {
@@ -49,14 +51,15 @@ void DecodeJpegKernel(const Context& dev_ctx,
         errors::Fatal("nvjpegCreateSimple failed: ", create_status));
   }
 
-  nvjpegJpegState_t nvjpeg_state;
-  nvjpegStatus_t state_status =
-      phi::dynload::nvjpegJpegStateCreate(nvjpeg_handle, &nvjpeg_state);
+  if (nvjpeg_state == nullptr) {
+    nvjpegStatus_t state_status =
+        phi::dynload::nvjpegJpegStateCreate(nvjpeg_handle, &nvjpeg_state);
 
-  PADDLE_ENFORCE_EQ(
-      state_status,
-      NVJPEG_STATUS_SUCCESS,
-      errors::Fatal("nvjpegJpegStateCreate failed: ", state_status));
+    PADDLE_ENFORCE_EQ(
+        state_status,
+        NVJPEG_STATUS_SUCCESS,
+        errors::Fatal("nvjpegJpegStateCreate failed: ", state_status));
+  }
 
   int components;
   nvjpegChromaSubsampling_t subsampling;
@@ -91,7 +94,6 @@ void DecodeJpegKernel(const Context& dev_ctx,
       output_format = NVJPEG_OUTPUT_RGB;
       output_components = 3;
     } else {
-      phi::dynload::nvjpegJpegStateDestroy(nvjpeg_state);
       PADDLE_THROW(errors::Fatal(
           "The provided mode is not supported for JPEG files on GPU"));
     }
@@ -102,7 +104,6 @@ void DecodeJpegKernel(const Context& dev_ctx,
     output_format = NVJPEG_OUTPUT_RGB;
     output_components = 3;
   } else {
-    phi::dynload::nvjpegJpegStateDestroy(nvjpeg_state);
     PADDLE_THROW(errors::Fatal(
         "The provided mode is not supported for JPEG files on GPU"));
   }
@@ -110,11 +111,6 @@ void DecodeJpegKernel(const Context& dev_ctx,
   nvjpegImage_t out_image;
   InitNvjpegImage(&out_image);
 
-  // create nvjpeg stream
-  if (nvjpeg_stream == nullptr) {
-    cudaStreamCreateWithFlags(&nvjpeg_stream, cudaStreamNonBlocking);
-  }
-
   int sz = widths[0] * heights[0];
 
   std::vector<int64_t> out_shape = {output_components, height, width};
@@ -127,13 +123,19 @@ void DecodeJpegKernel(const Context& dev_ctx,
     out_image.pitch[c] = width;
   }
 
+  // Decode on the stream of dev_ctx, so the kernels consuming the image,
+  // e.g. crop_resize_normalize, are ordered after the decoding without any
+  // extra synchronization.
   nvjpegStatus_t decode_status = phi::dynload::nvjpegDecode(nvjpeg_handle,
                                                             nvjpeg_state,
                                                             x_data,
                                                             x.numel(),
                                                             output_format,
                                                             &out_image,
-                                                            nvjpeg_stream);
+                                                            dev_ctx.stream());
+  PADDLE_ENFORCE_EQ(decode_status,
+                    NVJPEG_STATUS_SUCCESS,
+                    errors::Fatal("nvjpegDecode failed: ", decode_status));
 }
 }  // namespace phi
 
@@ -104,7 +104,12 @@ struct EmbeddingGradCUDAFunctor {
           cudaMemsetAsync(d_table, 0, N * D * sizeof(T), dev_ctx_.stream()));
 #endif
 
-      if (FLAGS_embedding_deterministic == 1) {
+      if (FLAGS_embedding_deterministic == 3 ||
+          (FLAGS_embedding_deterministic == 0 &&
+           phi::funcs::UseEmbeddingGradSortedKernel(N, K))) {
+        phi::funcs::LaunchEmbeddingGradSortedKernel<T, IdT>(
+            dev_ctx_, ids, d_output, d_table, N, D, K);
+      } else if (FLAGS_embedding_deterministic == 1) {
         phi::funcs::LaunchEmbeddingGradDeterministicKernel<T, IdT>(
             dev_ctx_, ids, d_output, d_table, N, D, K);
       } else {
@@ -70,14 +70,12 @@ template <typename T,
           bool IsMultiPrecision,
           bool IsCPUBetaPow,
           bool UseAdamW,
-          bool AMSGrad,
-          int N,
-          int MaxTensorSize,
-          int MaxBlockSize>
+          bool AMSGrad>
 struct FusedAdamFunctor {
+  template <typename TensorInfo>
   __device__ __forceinline__ void operator()(
       int chunk_size,
-      const funcs::TensorAndBlockInfo<N, MaxTensorSize, MaxBlockSize>& t_info,
+      const TensorInfo& t_info,
       MT beta1,
       MT beta2,
       FusedAdamBetaPowInfo<T, IsCPUBetaPow> beta_pow,
@@ -414,8 +412,6 @@ void FusedAdamKernel(
   do {                                                                       \
     constexpr int kInputNum =                                                \
         (__multi_precision ? 5 : 4) + (__amsgrad ? 1 : 0);                   \
-    constexpr int kMaxTensorSize = __multi_precision ? 48 : 60;              \
-    constexpr int kMaxBlockSize = __multi_precision ? 320 : 320;             \
     constexpr int kBlockSize = 512;                                          \
     FusedAdamBetaPowInfo<T, __is_cpu_betapow> beta_pow_info(                 \
         beta1_pow_first->data<MPDType>(), beta2_pow_first->data<MPDType>()); \
@@ -425,14 +421,9 @@ void FusedAdamKernel(
                      __multi_precision,                                      \
                      __is_cpu_betapow,                                       \
                      __use_adamw,                                            \
-                     __amsgrad,                                              \
-                     kInputNum,                                              \
-                     kMaxTensorSize,                                         \
-                     kMaxBlockSize>                                          \
+                     __amsgrad>                                              \
         functor;                                                             \
-    funcs::LaunchMultiTensorApplyKernel<kInputNum,                           \
-                                        kMaxTensorSize,                      \
-                                        kMaxBlockSize>(                      \
+    funcs::LaunchPersistentMultiTensorApplyKernel<kInputNum>(                \
         dev_ctx,                                                             \
         kBlockSize,                                                          \
         ((chunk_size + __vec_size - 1) / __vec_size) * __vec_size,           \
@@ -25,6 +25,7 @@ namespace cub = hipcub;
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/data_type.h"
 #include "paddle/phi/core/dense_tensor.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -38,7 +39,7 @@ using SegmentOffsetIter = phi::funcs::SegmentOffsetIter;
 template <typename T>
 struct AttnMaskFunctor {
   inline HOSTDEVICE T operator()(const T a, const T b) const {
-    return b >= 0 ? a : 0;
+    return b >= static_cast<T>(0) ? a : static_cast<T>(0);
   }
 };
 
@@ -96,6 +97,9 @@ void FusedTokenPruneOpCUDAKernel(const Context& dev_ctx,
                                  bool keep_order,
                                  DenseTensor* slimmed_x,
                                  DenseTensor* cls_inds) {
+  // The scores of the tokens are accumulated and sorted in MT, so that the
+  // half precision models prune the same tokens as the float ones.
+  using MT = typename phi::dtype::MPTypeTrait<T>::Type;
   // Input dims
   auto attn_dims = attn.dims();
   auto x_dims = x.dims();
@@ -119,14 +123,14 @@ void FusedTokenPruneOpCUDAKernel(const Context& dev_ctx,
   auto* attn_tmp_data = dev_ctx.template Alloc<T>(&attn_tmp);
   phi::DenseTensor attn_accu;
   attn_accu.Resize({bsz, max_seq_len});
-  auto* attn_accu_data = dev_ctx.template Alloc<T>(&attn_accu);
+  auto* attn_accu_data = dev_ctx.template Alloc<MT>(&attn_accu);
   phi::DenseTensor attn_accu_indices;
   attn_accu_indices.Resize({bsz, max_seq_len});
   auto* attn_accu_indices_data =
       dev_ctx.template Alloc<int64_t>(&attn_accu_indices);
   phi::DenseTensor sort_attn_accu;
   sort_attn_accu.Resize({bsz, max_seq_len});
-  auto* sort_attn_accu_data = dev_ctx.template Alloc<T>(&sort_attn_accu);
+  auto* sort_attn_accu_data = dev_ctx.template Alloc<MT>(&sort_attn_accu);
   phi::DenseTensor sort_attn_accu_indices;
   sort_attn_accu_indices.Resize({bsz, max_seq_len});
   auto* sort_attn_accu_indices_data =
@@ -162,9 +166,9 @@ void FusedTokenPruneOpCUDAKernel(const Context& dev_ctx,
 
   // 4. Sort token indices by attn
   if (keep_first_token) {
-    T max = std::numeric_limits<T>::max();
+    MT max = std::numeric_limits<MT>::max();
     config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, bsz);
-    MaximumFirst<T>
+    MaximumFirst<MT>
         <<<config.block_per_grid,
            config.thread_per_block,
            0,
@@ -192,7 +196,7 @@ void FusedTokenPruneOpCUDAKernel(const Context& dev_ctx,
       segment_offsets_t,
       segment_offsets_t + 1,
       0,
-      sizeof(T) * 8,
+      sizeof(MT) * 8,
       dev_ctx.stream()));
   // Allocate temporary storage
   int64_t temp_size = temp_storage_bytes;
@@ -212,7 +216,7 @@ void FusedTokenPruneOpCUDAKernel(const Context& dev_ctx,
       segment_offsets_t,
       segment_offsets_t + 1,
       0,
-      sizeof(T) * 8,
+      sizeof(MT) * 8,
       dev_ctx.stream()));
   // 5. Slice
   auto slimmed_indices_tmp =
@@ -284,6 +288,7 @@ PD_REGISTER_KERNEL(fused_token_prune,
                    ALL_LAYOUT,
                    phi::FusedTokenPruneOpCUDAKernel,
                    float,
-                   double) {
+                   double,
+                   phi::dtype::float16) {
   kernel->OutputAt(1).SetDataType(phi::DataType::INT64);
 }
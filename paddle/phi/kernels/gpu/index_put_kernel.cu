@@ -19,6 +19,9 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "paddle/phi/kernels/cast_kernel.h"
 #include "paddle/phi/kernels/funcs/index_put_utils.h"
+#include "paddle/phi/kernels/funcs/scatter.cu.h"
+
+COMMON_DECLARE_bool(cudnn_deterministic);
 
 namespace phi {
 
@@ -61,6 +64,28 @@ __global__ void IndexPutCudaKernel(const T* x,
   }
 }
 
+// Computes the offsets in out of the elements put, which are the keys of the
+// deterministic accumulation.
+__global__ void IndexPutOffsetsCudaKernel(
+    int64_t** indices,
+    Array<int64_t, DDim::kMaxRank> stride,
+    Array<int64_t, DDim::kMaxRank> shape,
+    const int rank,
+    const int64_t numel,
+    int64_t* offsets) {
+  CUDA_KERNEL_LOOP_TYPE(idx, numel, int64_t) {
+    int64_t offset = 0;
+    for (int i = 0; i < rank; ++i) {
+      int64_t cur_ix = indices[i][idx];
+      if (cur_ix < 0) {
+        cur_ix += shape[i];
+      }
+      offset += stride[i] * cur_ix;
+    }
+    offsets[idx] = offset;
+  }
+}
+
 template <typename T, typename Context>
 void LaunchIndexPutCudaKernel(const Context& dev_ctx,
                               const DenseTensor& x,
@@ -95,6 +120,29 @@ void LaunchIndexPutCudaKernel(const Context& dev_ctx,
       funcs::GetDevicePointerArray<int64_t, Context>(dev_ctx, indices, &holder);
 
   auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, numel);
+  // The atomics of the accumulation are not deterministic when the indices
+  // repeat, add the elements sorted by their offsets instead.
+  if (accumulate && FLAGS_cudnn_deterministic) {
+    auto offsets = phi::memory_utils::Alloc(
+        dev_ctx.GetPlace(),
+        numel * sizeof(int64_t),
+        phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+    int64_t* offsets_data = reinterpret_cast<int64_t*>(offsets->ptr());
+    IndexPutOffsetsCudaKernel<<<config.block_per_grid,
+                                config.thread_per_block,
+                                0,
+                                dev_ctx.stream()>>>(
+        pd_indices, stride_array, shape_array, rank, numel, offsets_data);
+    funcs::GPUScatterAddSorted<T>(dev_ctx,
+                                  offsets_data,
+                                  numel,
+                                  out->numel(),
+                                  val_data,
+                                  value.numel() == 1,
+                                  1,
+                                  out_data);
+    return;
+  }
   IndexPutCudaKernel<T>
       <<<config.block_per_grid, config.thread_per_block, 0, dev_ctx.stream()>>>(
           x_data,
@@ -0,0 +1,110 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/moe_combine_grad_kernel.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_cuda_utils.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+
+// Every block handles one choice of a token. The rows of x_grad scattered to
+// are distinct, so no atomic is needed, and the gradient of the combine
+// weight is reduced over the hidden size in the same pass.
+template <typename T>
+__global__ void MoeCombineGradRowsKernel(const T* x,
+                                         const float* combine_weights,
+                                         const int* scatter_index,
+                                         const T* y_grad,
+                                         int64_t num_choices,
+                                         int k,
+                                         int64_t hidden_size,
+                                         T* x_grad,
+                                         float* combine_weights_grad) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  for (int64_t i = blockIdx.x; i < num_choices; i += gridDim.x) {
+    int index = scatter_index[i];
+    if (index < 0) {
+      if (threadIdx.x == 0) {
+        combine_weights_grad[i] = 0.0f;
+      }
+      continue;
+    }
+    const T* dy = y_grad + (i / k) * hidden_size;
+    const T* src = x + index * hidden_size;
+    T* dx = x_grad + index * hidden_size;
+    MPType weight = static_cast<MPType>(combine_weights[i]);
+    float dot = 0.0f;
+    for (int64_t h = threadIdx.x; h < hidden_size; h += blockDim.x) {
+      MPType grad = static_cast<MPType>(dy[h]);
+      dx[h] = static_cast<T>(weight * grad);
+      dot += static_cast<float>(grad * static_cast<MPType>(src[h]));
+    }
+    dot = phi::funcs::BlockReduceSum<float>(dot, FINAL_MASK);
+    if (threadIdx.x == 0) {
+      combine_weights_grad[i] = dot;
+    }
+  }
+}
+
+template <typename T, typename Context>
+void MoeCombineGradKernel(const Context& dev_ctx,
+                          const DenseTensor& x,
+                          const DenseTensor& combine_weights,
+                          const DenseTensor& scatter_index,
+                          const DenseTensor& y_grad,
+                          DenseTensor* x_grad,
+                          DenseTensor* combine_weights_grad) {
+  const int64_t num_choices = combine_weights.numel();
+  const int64_t k = combine_weights.dims()[1];
+  const int64_t hidden_size = x.dims()[1];
+  dev_ctx.template Alloc<T>(x_grad);
+  dev_ctx.template Alloc<float>(combine_weights_grad);
+  // The rows of x which are not combined, e.g. the padding of the experts,
+  // get zero gradients.
+  phi::funcs::SetConstant<Context, T>()(dev_ctx, x_grad, static_cast<T>(0));
+  if (num_choices == 0) {
+    return;
+  }
+  int64_t max_grid = dev_ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(num_choices, max_grid));
+  MoeCombineGradRowsKernel<T>
+      <<<grid, 256, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                           combine_weights.data<float>(),
+                                           scatter_index.data<int>(),
+                                           y_grad.data<T>(),
+                                           num_choices,
+                                           static_cast<int>(k),
+                                           hidden_size,
+                                           x_grad->data<T>(),
+                                           combine_weights_grad->data<float>());
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_combine_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MoeCombineGradKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
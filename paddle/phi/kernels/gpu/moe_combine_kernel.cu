@@ -0,0 +1,86 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/moe_combine_kernel.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+
+namespace phi {
+
+// Every block combines the expert outputs of a token, the un-permutation and
+// the weighted sum are fused so the permuted outputs are read only once.
+template <typename T>
+__global__ void MoeCombineRowsKernel(const T* x,
+                                     const float* combine_weights,
+                                     const int* scatter_index,
+                                     int64_t num_tokens,
+                                     int k,
+                                     int64_t hidden_size,
+                                     T* y) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  for (int64_t token = blockIdx.x; token < num_tokens; token += gridDim.x) {
+    const float* weights = combine_weights + token * k;
+    const int* indices = scatter_index + token * k;
+    for (int64_t h = threadIdx.x; h < hidden_size; h += blockDim.x) {
+      MPType sum = static_cast<MPType>(0);
+      for (int i = 0; i < k; ++i) {
+        if (indices[i] >= 0) {
+          sum += static_cast<MPType>(weights[i]) *
+                 static_cast<MPType>(x[indices[i] * hidden_size + h]);
+        }
+      }
+      y[token * hidden_size + h] = static_cast<T>(sum);
+    }
+  }
+}
+
+template <typename T, typename Context>
+void MoeCombineKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& combine_weights,
+                      const DenseTensor& scatter_index,
+                      DenseTensor* y) {
+  const int64_t num_tokens = combine_weights.dims()[0];
+  const int64_t k = combine_weights.dims()[1];
+  const int64_t hidden_size = x.dims()[1];
+  dev_ctx.template Alloc<T>(y);
+  if (num_tokens == 0) {
+    return;
+  }
+  int64_t max_grid = dev_ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(num_tokens, max_grid));
+  MoeCombineRowsKernel<T>
+      <<<grid, 256, 0, dev_ctx.stream()>>>(x.data<T>(),
+                                           combine_weights.data<float>(),
+                                           scatter_index.data<int>(),
+                                           num_tokens,
+                                           static_cast<int>(k),
+                                           hidden_size,
+                                           y->data<T>());
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_combine,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MoeCombineKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {}
@@ -0,0 +1,130 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/moe_gate_dispatch_grad_kernel.h"
+
+#include <algorithm>
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/amp_type_traits.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+
+// Every block sums the gradients of the dispatched copies of a token.
+template <typename T>
+__global__ void MoeDispatchGradRowsKernel(const T* y_grad,
+                                          const int* scatter_index,
+                                          int64_t num_tokens,
+                                          int k,
+                                          int64_t hidden_size,
+                                          T* x_grad) {
+  using MPType = typename phi::dtype::MPTypeTrait<T>::Type;
+  for (int64_t token = blockIdx.x; token < num_tokens; token += gridDim.x) {
+    for (int64_t h = threadIdx.x; h < hidden_size; h += blockDim.x) {
+      MPType sum = static_cast<MPType>(0);
+      for (int i = 0; i < k; ++i) {
+        int index = scatter_index[i * num_tokens + token];
+        if (index >= 0) {
+          sum += static_cast<MPType>(y_grad[index * hidden_size + h]);
+        }
+      }
+      x_grad[token * hidden_size + h] = static_cast<T>(sum);
+    }
+  }
+}
+
+// The selected experts of a token are distinct, so every choice writes its
+// own element of gate_logits_grad. The dropped choices have a constant
+// combine weight of 0 and get no gradient.
+__global__ void MoeGateGradKernel(const float* combine_weights_grad,
+                                  const int* scatter_index,
+                                  const int* expert_id,
+                                  int64_t num_tokens,
+                                  int64_t num_experts,
+                                  int k,
+                                  float* gate_logits_grad) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_tokens * k, int64_t) {
+    int64_t token = i / k;
+    int64_t choice = i % k;
+    if (scatter_index[choice * num_tokens + token] < 0) {
+      continue;
+    }
+    gate_logits_grad[token * num_experts + expert_id[i]] =
+        combine_weights_grad[i];
+  }
+}
+
+template <typename T, typename Context>
+void MoeGateDispatchGradKernel(const Context& dev_ctx,
+                               const DenseTensor& combine_weights,
+                               const DenseTensor& scatter_index,
+                               const DenseTensor& expert_id,
+                               const DenseTensor& y_grad,
+                               const DenseTensor& combine_weights_grad,
+                               int64_t k,
+                               int64_t capacity,
+                               bool use_pad,
+                               DenseTensor* x_grad,
+                               DenseTensor* gate_logits_grad) {
+  const int64_t num_tokens = combine_weights.dims()[0];
+  const int64_t num_experts = y_grad.dims()[0];
+  const int64_t hidden_size = y_grad.dims()[2];
+  dev_ctx.template Alloc<T>(x_grad);
+  dev_ctx.template Alloc<float>(gate_logits_grad);
+  phi::funcs::SetConstant<Context, float>()(dev_ctx, gate_logits_grad, 0.0f);
+  if (num_tokens == 0) {
+    return;
+  }
+
+  auto stream = dev_ctx.stream();
+  int64_t max_grid = dev_ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(num_tokens, max_grid));
+  MoeDispatchGradRowsKernel<T><<<grid, 256, 0, stream>>>(
+      y_grad.data<T>(),
+      scatter_index.data<int>(),
+      num_tokens,
+      static_cast<int>(k),
+      hidden_size,
+      x_grad->data<T>());
+
+  auto config =
+      phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num_tokens * k);
+  MoeGateGradKernel<<<config.block_per_grid,
+                      config.thread_per_block,
+                      0,
+                      stream>>>(combine_weights_grad.data<float>(),
+                                scatter_index.data<int>(),
+                                expert_id.data<int>(),
+                                num_tokens,
+                                num_experts,
+                                static_cast<int>(k),
+                                gate_logits_grad->data<float>());
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_gate_dispatch_grad,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MoeGateDispatchGradKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+}
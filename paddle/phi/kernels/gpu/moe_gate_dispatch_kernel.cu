@@ -0,0 +1,304 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/kernels/moe_gate_dispatch_kernel.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
+#include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
+#include "paddle/phi/common/memory_utils.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/phi/kernels/empty_kernel.h"
+#include "paddle/phi/kernels/funcs/math_function.h"
+
+namespace phi {
+
+// The top k choices of a token are kept in registers.
+constexpr int kMoeMaxTopK = 16;
+
+// Every thread selects the top k experts of one token. The choices are also
+// written in the k-major order as the keys and values to be sorted, so that
+// the first choices of all the tokens take the capacity of the experts
+// before the second ones.
+__global__ void MoeTopKGateKernel(const float* gate_logits,
+                                  int64_t num_tokens,
+                                  int64_t num_experts,
+                                  int k,
+                                  float* combine_weights,
+                                  int* expert_id,
+                                  int* sort_keys,
+                                  int* sort_values) {
+  int64_t token = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+  if (token >= num_tokens) {
+    return;
+  }
+  float values[kMoeMaxTopK];
+  int ids[kMoeMaxTopK];
+  for (int i = 0; i < k; ++i) {
+    values[i] = -INFINITY;
+    ids[i] = -1;
+  }
+  const float* row = gate_logits + token * num_experts;
+  for (int e = 0; e < num_experts; ++e) {
+    float value = row[e];
+    // On ties the expert with the smaller id wins.
+    if (ids[k - 1] >= 0 && !(value > values[k - 1])) {
+      continue;
+    }
+    int j = k - 1;
+    while (j > 0 && (ids[j - 1] < 0 || value > values[j - 1])) {
+      values[j] = values[j - 1];
+      ids[j] = ids[j - 1];
+      --j;
+    }
+    values[j] = value;
+    ids[j] = e;
+  }
+  for (int i = 0; i < k; ++i) {
+    combine_weights[token * k + i] = values[i];
+    expert_id[token * k + i] = ids[i];
+    int64_t flat = i * num_tokens + token;
+    sort_keys[flat] = ids[i];
+    sort_values[flat] = static_cast<int>(flat);
+  }
+}
+
+__global__ void MoeExpertCountKernel(const int* expert_id,
+                                     int64_t num_choices,
+                                     int* expert_count) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_choices, int64_t) {
+    atomicAdd(expert_count + expert_id[i], 1);
+  }
+}
+
+// The number of experts is small, a single thread computes the start of
+// every expert in the sorted choices and the offsets of the experts in y.
+__global__ void MoeExpertOffsetKernel(const int* expert_count,
+                                      int64_t num_experts,
+                                      int64_t capacity,
+                                      int* expert_start,
+                                      int64_t* expert_offset) {
+  int start = 0;
+  int64_t offset = 0;
+  for (int64_t e = 0; e < num_experts; ++e) {
+    expert_start[e] = start;
+    start += expert_count[e];
+    offset += min(static_cast<int64_t>(expert_count[e]), capacity);
+    expert_offset[e] = offset;
+  }
+}
+
+__global__ void MoeScatterIndexKernel(const int* sorted_keys,
+                                      const int* sorted_values,
+                                      const int* expert_start,
+                                      int64_t num_choices,
+                                      int64_t num_tokens,
+                                      int k,
+                                      int64_t capacity,
+                                      int* scatter_index,
+                                      float* combine_weights) {
+  CUDA_KERNEL_LOOP_TYPE(i, num_choices, int64_t) {
+    int expert = sorted_keys[i];
+    int64_t position = i - expert_start[expert];
+    int flat = sorted_values[i];
+    if (position < capacity) {
+      scatter_index[flat] = static_cast<int>(expert * capacity + position);
+    } else {
+      int64_t token = flat % num_tokens;
+      int64_t choice = flat / num_tokens;
+      scatter_index[flat] = -1;
+      combine_weights[token * k + choice] = 0.0f;
+    }
+  }
+}
+
+template <typename T>
+__global__ void MoeDispatchRowsKernel(const T* x,
+                                      const int* scatter_index,
+                                      int64_t num_choices,
+                                      int64_t num_tokens,
+                                      int64_t hidden_size,
+                                      T* y) {
+  for (int64_t i = blockIdx.x; i < num_choices; i += gridDim.x) {
+    int index = scatter_index[i];
+    if (index < 0) {
+      continue;
+    }
+    const T* src = x + (i % num_tokens) * hidden_size;
+    T* dst = y + index * hidden_size;
+    for (int64_t h = threadIdx.x; h < hidden_size; h += blockDim.x) {
+      dst[h] = src[h];
+    }
+  }
+}
+
+template <typename T, typename Context>
+void MoeGateDispatchKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& gate_logits,
+                           int64_t k,
+                           int64_t capacity,
+                           bool use_pad,
+                           DenseTensor* y,
+                           DenseTensor* combine_weights,
+                           DenseTensor* scatter_index,
+                           DenseTensor* expert_offset,
+                           DenseTensor* expert_id) {
+  PADDLE_ENFORCE_LE(
+      k,
+      kMoeMaxTopK,
+      common::errors::InvalidArgument(
+          "The k of moe_gate_dispatch should not be greater than %d, but "
+          "got %d.",
+          kMoeMaxTopK,
+          k));
+  const int64_t num_tokens = x.dims()[0];
+  const int64_t hidden_size = x.dims()[1];
+  const int64_t num_experts = gate_logits.dims()[1];
+  const int64_t num_choices = num_tokens * k;
+  PADDLE_ENFORCE_LE(
+      std::max(num_experts * capacity, num_choices),
+      static_cast<int64_t>(std::numeric_limits<int>::max()),
+      common::errors::InvalidArgument(
+          "The rows of moe_gate_dispatch are indexed by int32, but got "
+          "%d experts with capacity %d and %d choices.",
+          num_experts,
+          capacity,
+          num_choices));
+
+  dev_ctx.template Alloc<T>(y);
+  float* weights_data = dev_ctx.template Alloc<float>(combine_weights);
+  int* index_data = dev_ctx.template Alloc<int>(scatter_index);
+  int64_t* offset_data = dev_ctx.template Alloc<int64_t>(expert_offset);
+  int* expert_id_data = dev_ctx.template Alloc<int>(expert_id);
+  phi::funcs::SetConstant<Context, T>()(dev_ctx, y, static_cast<T>(0));
+  if (num_tokens == 0) {
+    phi::funcs::SetConstant<Context, int64_t>()(dev_ctx, expert_offset, 0);
+    return;
+  }
+
+  auto stream = dev_ctx.stream();
+  DenseTensor keys = phi::Empty<int, Context>(dev_ctx, {num_choices});
+  DenseTensor values = phi::Empty<int, Context>(dev_ctx, {num_choices});
+  DenseTensor sorted_keys = phi::Empty<int, Context>(dev_ctx, {num_choices});
+  DenseTensor sorted_values =
+      phi::Empty<int, Context>(dev_ctx, {num_choices});
+
+  constexpr int kThreads = 256;
+  int blocks = static_cast<int>((num_tokens + kThreads - 1) / kThreads);
+  MoeTopKGateKernel<<<blocks, kThreads, 0, stream>>>(
+      gate_logits.data<float>(),
+      num_tokens,
+      num_experts,
+      static_cast<int>(k),
+      weights_data,
+      expert_id_data,
+      keys.data<int>(),
+      values.data<int>());
+
+  // The radix sort is stable, the choices of an expert keep the k-major
+  // order after sorting.
+  int end_bit = 1;
+  while ((int64_t{1} << end_bit) < num_experts) {
+    ++end_bit;
+  }
+  size_t temp_storage_bytes = 0;
+  cub::DeviceRadixSort::SortPairs<int, int>(nullptr,
+                                            temp_storage_bytes,
+                                            keys.data<int>(),
+                                            sorted_keys.data<int>(),
+                                            values.data<int>(),
+                                            sorted_values.data<int>(),
+                                            num_choices,
+                                            0,
+                                            end_bit,
+                                            stream);
+  auto temp_storage = phi::memory_utils::Alloc(
+      dev_ctx.GetPlace(),
+      temp_storage_bytes,
+      phi::Stream(reinterpret_cast<phi::StreamId>(stream)));
+  cub::DeviceRadixSort::SortPairs<int, int>(temp_storage->ptr(),
+                                            temp_storage_bytes,
+                                            keys.data<int>(),
+                                            sorted_keys.data<int>(),
+                                            values.data<int>(),
+                                            sorted_values.data<int>(),
+                                            num_choices,
+                                            0,
+                                            end_bit,
+                                            stream);
+
+  DenseTensor expert_count = phi::Empty<int, Context>(dev_ctx, {num_experts});
+  DenseTensor expert_start = phi::Empty<int, Context>(dev_ctx, {num_experts});
+  phi::funcs::SetConstant<Context, int>()(dev_ctx, &expert_count, 0);
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, num_choices);
+  MoeExpertCountKernel<<<config.block_per_grid,
+                         config.thread_per_block,
+                         0,
+                         stream>>>(
+      expert_id_data, num_choices, expert_count.data<int>());
+  MoeExpertOffsetKernel<<<1, 1, 0, stream>>>(expert_count.data<int>(),
+                                             num_experts,
+                                             capacity,
+                                             expert_start.data<int>(),
+                                             offset_data);
+  MoeScatterIndexKernel<<<config.block_per_grid,
+                          config.thread_per_block,
+                          0,
+                          stream>>>(sorted_keys.data<int>(),
+                                    sorted_values.data<int>(),
+                                    expert_start.data<int>(),
+                                    num_choices,
+                                    num_tokens,
+                                    static_cast<int>(k),
+                                    capacity,
+                                    index_data,
+                                    weights_data);
+
+  int64_t max_grid = dev_ctx.GetCUDAMaxGridDimSize()[0];
+  int grid = static_cast<int>(std::min(num_choices, max_grid));
+  MoeDispatchRowsKernel<T><<<grid, kThreads, 0, stream>>>(x.data<T>(),
+                                                           index_data,
+                                                           num_choices,
+                                                           num_tokens,
+                                                           hidden_size,
+                                                           y->data<T>());
+}
+
+}  // namespace phi
+
+PD_REGISTER_KERNEL(moe_gate_dispatch,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::MoeGateDispatchKernel,
+                   float,
+                   double,
+                   phi::dtype::float16,
+                   phi::dtype::bfloat16) {
+  kernel->OutputAt(1).SetDataType(phi::DataType::FLOAT32);
+  kernel->OutputAt(2).SetDataType(phi::DataType::INT32);
+  kernel->OutputAt(3).SetDataType(phi::DataType::INT64);
+  kernel->OutputAt(4).SetDataType(phi::DataType::INT32);
+}
@@ -14,6 +14,8 @@
 
 #include "paddle/phi/kernels/nms_kernel.h"
 
+#include <algorithm>
+
 #include "paddle/phi/backends/gpu/gpu_context.h"
 #include "paddle/phi/backends/gpu/gpu_primitives.h"
 #include "paddle/phi/common/memory_utils.h"
@@ -21,6 +23,9 @@
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 static const int64_t threadsPerBlock = sizeof(int64_t) * 8;
+// The removed bits of all the boxes are kept in the shared memory while the
+// masks are reduced on the device, up to 393216 boxes.
+static const size_t kMaxRemovedBytes = 48 * 1024;
 
 namespace phi {
 
@@ -53,6 +58,48 @@ static __global__ void NMS(const T* boxes_data,
   }
 }
 
+// Reduces the IoU masks into the kept boxes in a single block, so neither
+// the masks nor the kept indices make a round trip to the host. The boxes
+// are visited in order, and every thread owns the same words of the
+// removed bits for the whole scan, so no atomic is needed. The word of the
+// current boxes is only updated in registers, the shared words are read
+// again at the next word after a barrier.
+static __global__ void GatherKeepFromMask(const uint64_t* masks,
+                                          int64_t num_boxes,
+                                          int64_t blocks_per_line,
+                                          int64_t* keep,
+                                          int64_t* num_keep) {
+  extern __shared__ uint64_t removed[];
+  for (int64_t j = threadIdx.x; j < blocks_per_line; j += blockDim.x) {
+    removed[j] = 0;
+  }
+  int64_t count = 0;
+  for (int64_t block = 0; block < blocks_per_line; ++block) {
+    __syncthreads();
+    uint64_t block_removed = removed[block];
+    const int64_t start = block * threadsPerBlock;
+    const int64_t end = min(start + threadsPerBlock, num_boxes);
+    for (int64_t i = start; i < end; ++i) {
+      if (block_removed & 1ULL << (i - start)) {
+        continue;
+      }
+      if (threadIdx.x == 0) {
+        keep[count] = i;
+      }
+      ++count;
+      const uint64_t* current_mask = masks + i * blocks_per_line;
+      block_removed |= current_mask[block];
+      for (int64_t j = block + 1 + threadIdx.x; j < blocks_per_line;
+           j += blockDim.x) {
+        removed[j] |= current_mask[j];
+      }
+    }
+  }
+  if (threadIdx.x == 0) {
+    *num_keep = count;
+  }
+}
+
 template <typename T, typename Context>
 void NMSKernel(const Context& dev_ctx,
                const DenseTensor& boxes,
@@ -71,6 +118,11 @@ void NMSKernel(const Context& dev_ctx,
                                       boxes.dims()));
 
   const int64_t num_boxes = boxes.dims()[0];
+  if (num_boxes == 0) {
+    output->Resize(common::make_ddim({0}));
+    dev_ctx.template Alloc<int64_t>(output);
+    return;
+  }
   const auto blocks_per_line = CeilDivide(num_boxes, threadsPerBlock);
   dim3 block(threadsPerBlock);
   dim3 grid(blocks_per_line, blocks_per_line);
@@ -81,6 +133,41 @@ void NMSKernel(const Context& dev_ctx,
   uint64_t* mask_dev = reinterpret_cast<uint64_t*>(mask_data->ptr());
   NMS<T><<<grid, block, 0, dev_ctx.stream()>>>(
       boxes.data<T>(), threshold, num_boxes, mask_dev);
+  const size_t removed_bytes = blocks_per_line * sizeof(uint64_t);
+  if (removed_bytes <= kMaxRemovedBytes) {
+    auto keep_data = phi::memory_utils::Alloc(
+        dev_ctx.GetPlace(),
+        (num_boxes + 1) * sizeof(int64_t),
+        phi::Stream(reinterpret_cast<phi::StreamId>(dev_ctx.stream())));
+    int64_t* keep_dev = reinterpret_cast<int64_t*>(keep_data->ptr());
+    int64_t* num_keep_dev = keep_dev + num_boxes;
+    int threads = static_cast<int>(
+        std::min<int64_t>(CeilDivide(blocks_per_line, 32) * 32, 256));
+    GatherKeepFromMask<<<1, threads, removed_bytes, dev_ctx.stream()>>>(
+        mask_dev, num_boxes, blocks_per_line, keep_dev, num_keep_dev);
+    // Only the number of the kept boxes goes to the host, to shape the
+    // output.
+    int64_t last_box_num = 0;
+    memory_utils::Copy(phi::CPUPlace(),
+                       &last_box_num,
+                       dev_ctx.GetPlace(),
+                       num_keep_dev,
+                       sizeof(int64_t),
+                       dev_ctx.stream());
+    dev_ctx.Wait();
+    output->Resize(common::make_ddim({last_box_num}));
+    auto* output_data = dev_ctx.template Alloc<int64_t>(output);
+    memory_utils::Copy(dev_ctx.GetPlace(),
+                       output_data,
+                       dev_ctx.GetPlace(),
+                       keep_dev,
+                       sizeof(int64_t) * last_box_num,
+                       dev_ctx.stream());
+    return;
+  }
+
+  // The removed bits do not fit in the shared memory, reduce the masks on
+  // the host.
   std::vector<uint64_t> mask_host(num_boxes * blocks_per_line);
   memory_utils::Copy(phi::CPUPlace(),
                      mask_host.data(),
@@ -0,0 +1,31 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// Gathers the expert outputs of every token back and sums them weighted:
+//   y[s] = sum_k(combine_weights[s][k] * x[scatter_index[s][k]])
+// The choices with a negative scatter index are skipped.
+template <typename T, typename Context>
+void MoeCombineKernel(const Context& dev_ctx,
+                      const DenseTensor& x,
+                      const DenseTensor& combine_weights,
+                      const DenseTensor& scatter_index,
+                      DenseTensor* y);
+
+}  // namespace phi
@@ -0,0 +1,40 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "paddle/phi/core/dense_tensor.h"
+
+namespace phi {
+
+// Selects the top k experts of every token from gate_logits [S, E] and
+// scatters the tokens of x [S, H] into the expert contiguous buffer
+// y [E, capacity, H]. The k-th choices of all the tokens are placed before the
+// (k+1)-th ones, so the tokens beyond the capacity of an expert are dropped
+// from the lowest priority first. A dropped choice gets a combine weight of 0
+// and a scatter index of -1.
+template <typename T, typename Context>
+void MoeGateDispatchKernel(const Context& dev_ctx,
+                           const DenseTensor& x,
+                           const DenseTensor& gate_logits,
+                           int64_t k,
+                           int64_t capacity,
+                           bool use_pad,
+                           DenseTensor* y,
+                           DenseTensor* combine_weights,
+                           DenseTensor* scatter_index,
+                           DenseTensor* expert_offset,
+                           DenseTensor* expert_id);
+
+}  // namespace phi
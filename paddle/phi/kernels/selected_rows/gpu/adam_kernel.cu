@@ -17,6 +17,8 @@
 #include "glog/logging.h"
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
+#include "paddle/phi/backends/gpu/gpu_helper.h"
+#include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/common/amp_type_traits.h"
 #include "paddle/phi/common/float16.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -107,6 +109,68 @@ __global__ void SparseAdamCUDAKernelREG(MT beta1,
   }
 }
 
+// Lazy mode only touches the rows in the gradient, so one thread per element
+// of the merged gradient updates the moments and the parameter in place of a
+// search over every element of the parameter.
+template <typename T, typename MT>
+__global__ void LazySparseAdamCUDAKernel(MT beta1,
+                                         MT beta2,
+                                         MT epsilon,
+                                         MT beta1_pow,
+                                         MT beta2_pow,
+                                         const MT* beta1_pow_ptr,
+                                         const MT* beta2_pow_ptr,
+                                         const MT* mom1_,
+                                         MT* mom1_out_,
+                                         const MT* mom2_,
+                                         MT* mom2_out_,
+                                         const MT* mom2_max_,
+                                         MT* mom2_max_out_,
+                                         const MT* lr_,
+                                         const T* grad_,
+                                         const T* param_,
+                                         T* param_out_,
+                                         const MT* master_param,
+                                         MT* master_param_out,
+                                         const int64_t* rows_,
+                                         int64_t row_numel,
+                                         int64_t grad_numel,
+                                         bool amsgrad) {
+  MT lr = *lr_;
+  // beta pows live on the device when they are not passed by value
+  if (beta1_pow_ptr) {
+    beta1_pow = *beta1_pow_ptr;
+    beta2_pow = *beta2_pow_ptr;
+  }
+  MT lr_t = lr / (static_cast<MT>(1.0) - beta1_pow);
+  MT bias_correction2 = sqrt(static_cast<MT>(1.0) - beta2_pow);
+
+  CUDA_KERNEL_LOOP_TYPE(i, grad_numel, int64_t) {
+    int64_t id = rows_[i / row_numel] * row_numel + i % row_numel;
+    MT g = static_cast<MT>(grad_[i]);
+    MT p = master_param ? master_param[id] : static_cast<MT>(param_[id]);
+    MT mom1 = beta1 * mom1_[id] + (static_cast<MT>(1.0) - beta1) * g;
+    MT mom2 = beta2 * mom2_[id] + (static_cast<MT>(1.0) - beta2) * g * g;
+
+    MT denom;
+    if (amsgrad) {
+      MT moment2_max_ = std::max(mom2, mom2_max_[id]);
+      mom2_max_out_[id] = moment2_max_;
+      denom = sqrt(moment2_max_) / bias_correction2 + epsilon;
+    } else {
+      denom = sqrt(mom2) / bias_correction2 + epsilon;
+    }
+    p -= (mom1 / denom) * lr_t;
+
+    mom1_out_[id] = mom1;
+    mom2_out_[id] = mom2;
+    param_out_[id] = static_cast<T>(p);
+    if (master_param_out) {
+      master_param_out[id] = p;
+    }
+  }
+}
+
 template <typename T, typename Context>
 void AdamDenseParamSparseGradKernel(
     const Context& dev_ctx,
@@ -234,8 +298,41 @@ void AdamDenseParamSparseGradKernel(
   phi::MixVector<int64_t> mixv_grad_merge_rows(grad_merge_rows);
   const int64_t* rows = mixv_grad_merge_rows.Data(dev_ctx.GetPlace());
   auto row_numel = grad_tensor.numel() / grad_merge.rows().size();
+  bool cpu_beta_pow =
+      beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace();
 
-  if (beta1_pow.place() == CPUPlace() && beta2_pow.place() == CPUPlace()) {
+  if (lazy_mode) {
+    auto config =
+        phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, grad_tensor.numel());
+    LazySparseAdamCUDAKernel<T, MPDType>
+        <<<config.block_per_grid,
+           config.thread_per_block,
+           0,
+           dev_ctx.stream()>>>(
+            beta1_,
+            beta2_,
+            epsilon_,
+            cpu_beta_pow ? *beta1_pow.data<MPDType>() : MPDType(0),
+            cpu_beta_pow ? *beta2_pow.data<MPDType>() : MPDType(0),
+            cpu_beta_pow ? nullptr : beta1_pow.data<MPDType>(),
+            cpu_beta_pow ? nullptr : beta2_pow.data<MPDType>(),
+            moment1.data<MPDType>(),
+            dev_ctx.template Alloc<MPDType>(moment1_out),
+            moment2.data<MPDType>(),
+            dev_ctx.template Alloc<MPDType>(moment2_out),
+            moment2_max_in_data,
+            moment2_max_out_data,
+            learning_rate.data<MPDType>(),
+            grad_data,
+            param.data<T>(),
+            dev_ctx.template Alloc<T>(param_out),
+            master_in_data,
+            master_out_data,
+            rows,
+            row_numel,
+            grad_tensor.numel(),
+            amsgrad);
+  } else if (cpu_beta_pow) {
     int threads = 512;
     int ndim = param.numel();
     int blocks = (ndim + threads - 1) / threads;
@@ -265,13 +362,6 @@ void AdamDenseParamSparseGradKernel(
             lazy_mode,
             ndim,
             amsgrad);
-    if (!use_global_beta_pow) {
-      // Update with cpu
-      dev_ctx.template HostAlloc<MPDType>(beta1_pow_out)[0] =
-          beta1_ * beta1_pow.data<MPDType>()[0];
-      dev_ctx.template HostAlloc<MPDType>(beta2_pow_out)[0] =
-          beta2_ * beta2_pow.data<MPDType>()[0];
-    }
   } else {
     funcs::SparseAdamFunctor<T, funcs::GPUAdam, MPDType> functor(
         beta1_,
@@ -300,7 +390,16 @@ void AdamDenseParamSparseGradKernel(
     // FIXME(minqiyang): remove BinarySearch in GPU later
     funcs::ForRange<Context> for_range(dev_ctx, param.numel());
     for_range(functor);
-    if (!use_global_beta_pow) {
+  }
+
+  if (!use_global_beta_pow) {
+    if (cpu_beta_pow) {
+      // Update with cpu
+      dev_ctx.template HostAlloc<MPDType>(beta1_pow_out)[0] =
+          beta1_ * beta1_pow.data<MPDType>()[0];
+      dev_ctx.template HostAlloc<MPDType>(beta2_pow_out)[0] =
+          beta2_ * beta2_pow.data<MPDType>()[0];
+    } else {
       // update beta1 and beta2
       UpdateBetaPow<MPDType><<<1, 32, 0, dev_ctx.stream()>>>(
           beta1_,
@@ -14,9 +14,19 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/sparse/coalesce_kernel.h"
 
-#include <thrust/sort.h>
 #include <thrust/unique.h>
 
+#include <cstdint>
+#include <string>
+
+#ifdef __NVCC__
+#include "cub/cub.cuh"
+#endif
+#ifdef __HIPCC__
+#include <hipcub/hipcub.hpp>
+namespace cub = hipcub;
+#endif
+
 #include "paddle/phi/backends/gpu/gpu_info.h"
 #include "paddle/phi/backends/gpu/gpu_launch_config.h"
 #include "paddle/phi/core/kernel_registry.h"
@@ -29,6 +39,70 @@ limitations under the License. */
 namespace phi {
 namespace sparse {
 
+// The sort permutation and the coalesced indices only depend on the indices,
+// so they are kept in the indices dict of the output and reused when the
+// same indices are coalesced again, e.g. after a unary op sharing them.
+inline std::string CoalesceKey(const SparseCooTensor& x) {
+  return "coalesce_" +
+         std::to_string(reinterpret_cast<uintptr_t>(x.indices().data())) +
+         "_" + x.dims().to_str();
+}
+
+template <typename T, int VecSize>
+void ScatterCoalescedValuesImpl(const GPUContext& dev_ctx,
+                                const T* x_values_ptr,
+                                const int* public_indexs_ptr,
+                                const int* values_indexs_ptr,
+                                const int64_t out_nnz,
+                                const int64_t nnz,
+                                const int64_t stride,
+                                T* out_values_ptr) {
+  auto config = phi::backends::gpu::GetGpuLaunchConfig1D(
+      dev_ctx, out_nnz * stride / VecSize, 1);
+  phi::funcs::sparse::ScatterKernel<T, VecSize>
+      <<<config.block_per_grid,
+         config.thread_per_block,
+         0,
+         dev_ctx.stream()>>>(x_values_ptr,
+                             public_indexs_ptr,
+                             values_indexs_ptr,
+                             out_nnz,
+                             nnz,
+                             stride,
+                             out_values_ptr);
+}
+
+template <typename T>
+void ScatterCoalescedValues(const GPUContext& dev_ctx,
+                            const DenseTensor& x_values,
+                            const int* public_indexs_ptr,
+                            const int* values_indexs_ptr,
+                            const int64_t out_nnz,
+                            const int64_t nnz,
+                            const int64_t stride,
+                            DenseTensor* out_values) {
+  const int VecSize = VecBytes / sizeof(T);
+  if (stride % VecSize == 0) {
+    ScatterCoalescedValuesImpl<T, VecSize>(dev_ctx,
+                                           x_values.data<T>(),
+                                           public_indexs_ptr,
+                                           values_indexs_ptr,
+                                           out_nnz,
+                                           nnz,
+                                           stride,
+                                           out_values->data<T>());
+  } else {
+    ScatterCoalescedValuesImpl<T, 1>(dev_ctx,
+                                     x_values.data<T>(),
+                                     public_indexs_ptr,
+                                     values_indexs_ptr,
+                                     out_nnz,
+                                     nnz,
+                                     stride,
+                                     out_values->data<T>());
+  }
+}
+
 template <typename T, typename IntT>
 void CoalesceCooGPUKernel(const GPUContext& dev_ctx,
                           const SparseCooTensor& x,
@@ -40,6 +114,38 @@ void CoalesceCooGPUKernel(const GPUContext& dev_ctx,
 
   const int64_t nnz = x.nnz();
   const int64_t sparse_dim = x.indices().dims()[0];
+  const int64_t stride =
+      x.dims().size() == sparse_dim ? 1 : x.values().dims()[1];
+
+  const std::string cache_key = CoalesceKey(x);
+  const auto* cached_indices = x.IndicesPairs(cache_key + "_indices");
+  const auto* cached_perm = x.IndicesPairs(cache_key + "_perm");
+  // the cached x indices keep their allocation alive, so equal data means
+  // the same indices
+  if (cached_indices != nullptr && cached_perm != nullptr &&
+      cached_indices->first.data() == x_indices.data() &&
+      cached_indices->first.dims() == x_indices.dims()) {
+    out_indices = cached_indices->second;
+    const int64_t out_nnz = out_indices.dims()[1];
+    if (out_values.dims().size() == 1) {
+      out_values.Resize(common::make_ddim({out_nnz}));
+    } else {
+      out_values.Resize(common::make_ddim({out_nnz, x_values.dims()[1]}));
+    }
+    ScatterCoalescedValues<T>(dev_ctx,
+                              x_values,
+                              cached_perm->second.data<int>(),
+                              cached_perm->first.data<int>(),
+                              out_nnz,
+                              nnz,
+                              stride,
+                              &out_values);
+    out->SetMember(out_indices, out_values, x.dims(), true);
+    out->SetIndicesDict(x.GetIndicesDict());
+    out->SetKmaps(x.GetKmaps());
+    return;
+  }
+
   std::vector<IntT> sparse_offsets(sparse_dim);
 
   phi::funcs::sparse::CalcOffsetsPerDim<IntT>(
@@ -72,29 +178,55 @@ void CoalesceCooGPUKernel(const GPUContext& dev_ctx,
       indexs_ptr);
 
   // 2. get the address of each non-zero values
-  const T* x_values_ptr = x_values.data<T>();
-  const int64_t stride =
-      x.dims().size() == sparse_dim ? 1 : x.values().dims()[1];
   DenseTensor values_indexs = phi::Empty(
       dev_ctx, DenseTensorMeta(DataType::INT32, {nnz}, DataLayout::NCHW));
   int* values_indexs_ptr = values_indexs.data<int>();
   DenseTensor public_indexs = phi::EmptyLike<int>(dev_ctx, values_indexs);
 
-  // values_indexs = [0,1,2,,,nnz-1]
-  phi::IndexKernel<int, kps::IdentityFunctor<int>>(
-      dev_ctx, &values_indexs, kps::IdentityFunctor<int>());
+  // public_indexs = [0,1,2,,,nnz-1], the input of the sort, then the
+  // positions of the unique indices
   phi::IndexKernel<int, kps::IdentityFunctor<int>>(
       dev_ctx, &public_indexs, kps::IdentityFunctor<int>());
 
-// 3. sort (indices, values index)
-#ifdef PADDLE_WITH_HIP
-  thrust::sort_by_key(thrust::hip::par.on(dev_ctx.stream()),
-#else
-  thrust::sort_by_key(thrust::cuda::par.on(dev_ctx.stream()),
-#endif
-                      indexs_ptr,
-                      indexs_ptr + nnz,
-                      values_indexs_ptr);
+  // 3. sort (indices, values index), radix sort on only the bits a flattened
+  // index can use
+  int64_t table_size = 1;
+  for (int64_t i = 0; i < sparse_dim; ++i) {
+    table_size *= x.dims()[i];
+  }
+  int end_bit = 1;
+  while (end_bit < static_cast<int>(sizeof(IntT) * 8) &&
+         (static_cast<uint64_t>(table_size - 1) >> end_bit) != 0) {
+    ++end_bit;
+  }
+  DenseTensor sorted_indexs = phi::EmptyLike<IntT>(dev_ctx, indexs);
+  size_t temp_storage_bytes = 0;
+  cub::DeviceRadixSort::SortPairs<IntT, int>(nullptr,
+                                             temp_storage_bytes,
+                                             indexs_ptr,
+                                             sorted_indexs.data<IntT>(),
+                                             public_indexs.data<int>(),
+                                             values_indexs_ptr,
+                                             nnz,
+                                             0,
+                                             end_bit,
+                                             dev_ctx.stream());
+  DenseTensor temp_storage = phi::Empty<uint8_t>(
+      dev_ctx, {static_cast<int64_t>(temp_storage_bytes)});
+  cub::DeviceRadixSort::SortPairs<IntT, int>(temp_storage.data<uint8_t>(),
+                                             temp_storage_bytes,
+                                             indexs_ptr,
+                                             sorted_indexs.data<IntT>(),
+                                             public_indexs.data<int>(),
+                                             values_indexs_ptr,
+                                             nnz,
+                                             0,
+                                             end_bit,
+                                             dev_ctx.stream());
+  indexs = sorted_indexs;
+  indexs_ptr = indexs.data<IntT>();
+  phi::IndexKernel<int, kps::IdentityFunctor<int>>(
+      dev_ctx, &public_indexs, kps::IdentityFunctor<int>());
 
   // 4. unique index
   thrust::pair<IntT*, int*> new_end =
@@ -126,35 +258,14 @@ void CoalesceCooGPUKernel(const GPUContext& dev_ctx,
   }
 
   // 5. scatter the values
-  const int VecSize = VecBytes / sizeof(T);
-  if (stride % VecSize == 0) {
-    config = phi::backends::gpu::GetGpuLaunchConfig1D(
-        dev_ctx, nnz * stride / VecSize, 1);
-    phi::funcs::sparse::ScatterKernel<T, VecSize>
-        <<<config.block_per_grid,
-           config.thread_per_block,
-           0,
-           dev_ctx.stream()>>>(x_values_ptr,
-                               public_indexs.data<int>(),
-                               values_indexs_ptr,
-                               out_nnz,
-                               nnz,
-                               stride,
-                               out_values.data<T>());
-  } else {
-    config = phi::backends::gpu::GetGpuLaunchConfig1D(dev_ctx, nnz * stride, 1);
-    phi::funcs::sparse::ScatterKernel<T, 1>
-        <<<config.block_per_grid,
-           config.thread_per_block,
-           0,
-           dev_ctx.stream()>>>(x_values_ptr,
-                               public_indexs.data<int>(),
-                               values_indexs_ptr,
-                               out_nnz,
-                               nnz,
-                               stride,
-                               out_values.data<T>());
-  }
+  ScatterCoalescedValues<T>(dev_ctx,
+                            x_values,
+                            public_indexs.data<int>(),
+                            values_indexs_ptr,
+                            out_nnz,
+                            nnz,
+                            stride,
+                            &out_values);
 
   // 6. convert index to coordinate
   Dim<DDim::kMaxRank> const_dims;
@@ -172,6 +283,10 @@ void CoalesceCooGPUKernel(const GPUContext& dev_ctx,
   out->SetMember(out_indices, out_values, x.dims(), true);
   out->SetIndicesDict(x.GetIndicesDict());
   out->SetKmaps(x.GetKmaps());
+  out->SaveIndicesPairs(cache_key + "_indices",
+                        std::make_pair(x_indices, out_indices));
+  out->SaveIndicesPairs(cache_key + "_perm",
+                        std::make_pair(values_indexs, public_indexs));
 }
 
 template <typename T, typename Context>
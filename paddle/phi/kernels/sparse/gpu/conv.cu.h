@@ -14,7 +14,9 @@ limitations under the License. */
 
 #pragma once
 
+#include <thrust/iterator/counting_iterator.h>
 #include <thrust/remove.h>
+#include <thrust/transform_reduce.h>
 #include <thrust/unique.h>
 #ifdef __NVCC__
 #include <cub/block/block_scan.cuh>
@@ -23,6 +25,9 @@ limitations under the License. */
 #include <hipcub/hipcub.hpp>
 namespace cub = hipcub;
 #endif
+#include <string>
+#include <vector>
+
 #include "paddle/phi/kernels/sparse/conv_kernel.h"
 
 #include "paddle/phi/backends/gpu/gpu_context.h"
@@ -935,5 +940,53 @@ int ProductRuleBook(const Context& dev_ctx,
   }
 }
 
+template <typename IntT>
+struct IndicesHashFunctor {
+  const IntT* indices;
+
+  __device__ uint64_t operator()(int64_t i) const {
+    // splitmix64 of the position mixed with the coordinate
+    uint64_t h = static_cast<uint64_t>(i) * 0x9e3779b97f4a7c15ULL ^
+                 static_cast<uint64_t>(indices[i]);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+  }
+};
+
+// The key of the rulebook of a subm conv without a user key. The rulebook
+// only depends on the coordinates of x, the shape and the kernel, so it is
+// keyed by a hash of the coordinates and saved in the indices dict of out,
+// the next subm convs over the same coordinates with the same kernel reuse
+// it. The coordinates change with strided convs, which changes the hash.
+template <typename IntT>
+std::string SubmRulebookKey(const GPUContext& dev_ctx,
+                            const SparseCooTensor& x,
+                            const std::vector<int>& kernel_sizes,
+                            const std::vector<int>& dilations) {
+  const DenseTensor& indices = x.indices();
+  IndicesHashFunctor<IntT> hash_functor{indices.data<IntT>()};
+  const uint64_t hash = thrust::transform_reduce(
+#ifdef PADDLE_WITH_HIP
+      thrust::hip::par.on(dev_ctx.stream()),
+#else
+      thrust::cuda::par.on(dev_ctx.stream()),
+#endif
+      thrust::counting_iterator<int64_t>(0),
+      thrust::counting_iterator<int64_t>(indices.numel()),
+      hash_functor,
+      static_cast<uint64_t>(0),
+      thrust::plus<uint64_t>());
+  std::string key = "__subm_rulebook_" + std::to_string(hash) + "_" +
+                    std::to_string(x.nnz()) + "_" + x.dims().to_str();
+  for (int kernel_size : kernel_sizes) {
+    key += "_" + std::to_string(kernel_size);
+  }
+  for (int dilation : dilations) {
+    key += "_" + std::to_string(dilation);
+  }
+  return key;
+}
+
 }  // namespace sparse
 }  // namespace phi
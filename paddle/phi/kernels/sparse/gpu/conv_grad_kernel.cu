@@ -211,7 +211,7 @@ void Conv3dCooGradGPUKernel(const GPUContext& dev_ctx,
       const IntT* gather_x_indices = rulebook_ptr + offsets[i];
       const IntT* scatter_x_indices = rulebook_ptr + offsets[i];
       const IntT* gather_out_indices = rulebook_ptr + rulebook_len + offsets[i];
-      const size_t key = autotune::GenKey(M / features_num_range, N, K);
+      const size_t key = GatherGemmScatterKey(M, N, K);
       if (!is_params_freezing) {
         // call gemm: d_kernel = transpose(x) * out_grad
         // (in_channels, n) * (n, out_channels)
@@ -47,7 +47,7 @@ namespace sparse {
       const IntT* gather_indices = rulebook_ptr + h_offsets_ptr[i];      \
       const IntT* scatter_indices =                                      \
           rulebook_ptr + rulebook_len + h_offsets_ptr[i];                \
-      const size_t key = autotune::GenKey(M / features_num_range, N, K); \
+      const size_t key = GatherGemmScatterKey(M, N, K);                  \
       GatherGemmScatterDriver<arch, false, false>(                       \
           dev_ctx,                                                       \
           key,                                                           \
@@ -135,17 +135,28 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
   int rulebook_len = 0;
   const IntT* rulebook_ptr = nullptr;
   bool need_product_rulebook = true;
-  if (subm && !key.empty()) {
+  std::string rulebook_key = key;
+  if (subm && key.empty()) {
+    rulebook_key = SubmRulebookKey<IntT>(dev_ctx, x, kernel_sizes, dilations);
+  }
+  if (subm) {
     rulebook_ptr = phi::funcs::sparse::PrepareSubm<T, IntT, GPUContext>(
         dev_ctx,
         x,
-        key,
+        rulebook_key,
         out_dims,
         out,
         h_counter.data<int>(),
         h_offsets.data<int>(),
         &rulebook_len,
         &need_product_rulebook);
+    if (!need_product_rulebook && key.empty()) {
+      // the grad kernel reads the rulebook from the outputs without a key
+      *rulebook = x.IndicesPairs(rulebook_key)->first;
+      counter->Resize({kernel_size});
+      int* counter_ptr = dev_ctx.template HostAlloc<int>(counter);
+      memcpy(counter_ptr, h_counter_ptr, kernel_size * sizeof(int));
+    }
   }
 
   if (need_product_rulebook) {
@@ -170,6 +181,10 @@ void Conv3dCooGPUKernel(const GPUContext& dev_ctx,
 
     phi::funcs::sparse::SaveToTable(
         dev_ctx, x, key, tmp_rulebook, h_counter, out, rulebook, counter);
+    if (rulebook_key != key) {
+      out->SaveIndicesPairs(rulebook_key,
+                            std::make_pair(tmp_rulebook, h_counter));
+    }
   }
 
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
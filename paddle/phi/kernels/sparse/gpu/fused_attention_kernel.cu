@@ -22,6 +22,9 @@ limitations under the License. */
 #include "paddle/phi/kernels/sparse/empty_kernel.h"
 #include "paddle/phi/kernels/sparse/matmul_kernel.h"
 #include "paddle/phi/kernels/sparse/sparse_utils_kernel.h"
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/kernels/funcs/sparse/balanced_matmul.cu.h"
+#endif
 
 namespace phi {
 namespace sparse {
@@ -187,14 +190,24 @@ void FusedAttentionCsrKernel(
   /* Step1: SDD Matmul, reuse matmul */
   SparseCsrTensor sdd_result;
   EmptyLikeCsrKernel<T, Context>(dev_ctx, sparse_mask, &sdd_result);
-  auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
-  sparse_blas.SDDMM(false,
-                    true,
-                    static_cast<T>(1 / std::sqrt(N)),
-                    query,
-                    key,
-                    static_cast<T>(0),
-                    &sdd_result);
+  if (phi::funcs::sparse::UseBalancedCsrMatmul<T>(dev_ctx, sparse_mask)) {
+    // the final SpMM makes the same choice through MatmulCsrDenseKernel
+    phi::funcs::sparse::BalancedCsrSddmm<T>(dev_ctx,
+                                            query,
+                                            key,
+                                            true,
+                                            static_cast<T>(1 / std::sqrt(N)),
+                                            &sdd_result);
+  } else {
+    auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
+    sparse_blas.SDDMM(false,
+                      true,
+                      static_cast<T>(1 / std::sqrt(N)),
+                      query,
+                      key,
+                      static_cast<T>(0),
+                      &sdd_result);
+  }
 
   EmptyLikeCsrKernel<T, Context>(dev_ctx, sdd_result, softmax);
 
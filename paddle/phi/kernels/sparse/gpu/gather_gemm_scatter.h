@@ -13,6 +13,7 @@
 // limitations under the License.
 #pragma once
 
+#include <mutex>  // NOLINT
 #include <type_traits>
 #if defined(PADDLE_WITH_CUTLASS) && SPCONV_WITH_CUTLASS
 #include "paddle/phi/backends/gpu/gpu_context.h"
@@ -23,9 +24,16 @@
 namespace phi {
 namespace sparse {
 
-// To reduce tuning time, map shape (m,n,k) to (m/features_num_range,n,k) so
-// that shapes within this range share the same key.
-constexpr int features_num_range = 10000;
+// To reduce tuning time, the shapes (m,n,k) whose m have the same number of
+// bits share the same key, so a layer is tuned once per (k, n) and power of
+// two of its number of nonzeros however the point cloud changes.
+inline size_t GatherGemmScatterKey(int m, int n, int k) {
+  int m_bits = 0;
+  for (; m > 0; m >>= 1) {
+    ++m_bits;
+  }
+  return autotune::GenKey(m_bits, n, k);
+}
 
 template <int ComputeCapability,
           bool TransposeA,
@@ -78,10 +86,15 @@ void GatherGemmScatterDriver(
       out_type alpha,                                                         \
       out_type beta,                                                          \
       cutlass::device_memory::allocation<uint8_t>* const workspace_ptr) {     \
+    static std::once_flag add_kernels_flag;                                   \
     auto* tuner =                                                             \
         autotune::MakeGatherGemmScatterTuner<transpose_a, transpose_b>(       \
             kernels[0]);                                                      \
-    for (auto i = 1; i < kernels.size(); i++) tuner->AddCallBack(kernels[i]); \
+    std::call_once(add_kernels_flag, [&] {                                    \
+      for (size_t i = 1; i < kernels.size(); i++) {                           \
+        tuner->AddCallBack(kernels[i]);                                       \
+      }                                                                       \
+    });                                                                       \
     tuner->Run(ctx,                                                           \
                key,                                                           \
                alpha,                                                         \
@@ -30,10 +30,36 @@ limitations under the License. */
 #include "paddle/phi/kernels/sparse/empty_kernel.h"
 #include "paddle/phi/kernels/sparse/impl/unary_kernel_impl.h"
 #include "paddle/phi/kernels/sparse/sparse_utils_kernel.h"
+#ifdef PADDLE_WITH_CUDA
+#include "paddle/phi/kernels/funcs/sparse/balanced_matmul.cu.h"
+#endif
 
 namespace phi {
 namespace sparse {
 
+#ifdef PADDLE_WITH_CUDA
+template <typename T, typename Context>
+bool BalancedSpmm(const Context& dev_ctx,
+                  const SparseCooTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* out) {
+  return false;
+}
+
+template <typename T, typename Context>
+bool BalancedSpmm(const Context& dev_ctx,
+                  const SparseCsrTensor& x,
+                  const DenseTensor& y,
+                  DenseTensor* out) {
+  if (!phi::funcs::sparse::UseBalancedCsrMatmul<T>(dev_ctx, x)) {
+    return false;
+  }
+  phi::funcs::sparse::BalancedCsrSpmm<T>(
+      dev_ctx, x, y, static_cast<T>(1), out);
+  return true;
+}
+#endif
+
 template <typename T, typename Context, typename TensorType>
 void MatmulKernelImpl(const Context& dev_ctx,
                       const TensorType& x,
@@ -83,6 +109,12 @@ void MatmulKernelImpl(const Context& dev_ctx,
 
   dev_ctx.template Alloc<T>(out);
 
+#ifdef PADDLE_WITH_CUDA
+  if (BalancedSpmm<T>(dev_ctx, x, y, out)) {
+    return;
+  }
+#endif
+
 #ifdef PADDLE_WITH_HIP
   phi::funcs::SetConstant<Context, T> set_zero;
   set_zero(dev_ctx, out, static_cast<T>(0.0f));
@@ -259,6 +291,12 @@ void MaskedMatmulCsrKernel(const Context& dev_ctx,
   // InferMeta of SparseCsrTensor 'out', CreateLikeInferMeta
   EmptyLikeCsrKernel<T, Context>(dev_ctx, mask, out);
 
+  if (phi::funcs::sparse::UseBalancedCsrMatmul<T>(dev_ctx, mask)) {
+    phi::funcs::sparse::BalancedCsrSddmm<T>(
+        dev_ctx, x, y, false, static_cast<T>(1), out);
+    return;
+  }
+
   auto sparse_blas = phi::funcs::sparse::GetSparseBlas<Context, T>(dev_ctx);
   sparse_blas.SDDMM(
       false, false, static_cast<T>(1), x, y, static_cast<T>(0), out);
@@ -272,6 +310,17 @@ void MaskedMatmulCsrKernel(const Context& dev_ctx,
 }  // namespace sparse
 }  // namespace phi
 
+#ifdef PADDLE_WITH_CUDA
+PD_REGISTER_KERNEL(matmul_csr_dense,
+                   GPU,
+                   ALL_LAYOUT,
+                   phi::sparse::MatmulCsrDenseKernel,
+                   float,
+                   double,
+                   phi::dtype::float16) {
+  kernel->InputAt(0).SetDataLayout(phi::DataLayout::SPARSE_CSR);
+}
+#else
 PD_REGISTER_KERNEL(matmul_csr_dense,
                    GPU,
                    ALL_LAYOUT,
@@ -280,6 +329,7 @@ PD_REGISTER_KERNEL(matmul_csr_dense,
                    double) {
   kernel->InputAt(0).SetDataLayout(phi::DataLayout::SPARSE_CSR);
 }
+#endif
 
 PD_REGISTER_KERNEL(matmul_coo_dense,
                    GPU,
@@ -315,4 +365,5 @@ PD_REGISTER_KERNEL(masked_matmul_csr,
                    ALL_LAYOUT,
                    phi::sparse::MaskedMatmulCsrKernel,
                    float,
-                   double) {}
+                   double,
+                   phi::dtype::float16) {}
@@ -16,6 +16,7 @@
 
 #include <any>
 #include <cstdint>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -164,16 +165,20 @@ class IR_API Pass {
 
   virtual bool Initialize(IrContext* context) { return true; }
 
+  // The statistics may be added by the threads of a parallel pass manager.
   void AddStatistics(int64_t match_count) {
+    std::lock_guard<std::mutex> guard(statistics_mutex_);
     Set<int64_t>("__match_count__", new int64_t{match_count});
   }
 
   void AddStatistics(int64_t match_count_1, int64_t match_count_2) {
+    std::lock_guard<std::mutex> guard(statistics_mutex_);
     Set<int64_t>("__match_count_1__", new int64_t{match_count_1});
     Set<int64_t>("__match_count_2__", new int64_t{match_count_2});
   }
 
   void AddStatistics(const std::string& custom_log) {
+    std::lock_guard<std::mutex> guard(statistics_mutex_);
     Set<std::string>("__custom_log__", new std::string{custom_log});
   }
 
@@ -193,6 +198,8 @@ class IR_API Pass {
 
   std::unordered_map<std::string, std::any> attrs_;
   std::unordered_map<std::string, std::function<void(void)>> attr_dels_;
+
+  std::mutex statistics_mutex_;
 };
 
 class IR_API PatternRewritePass : public Pass {
@@ -22,6 +22,7 @@ namespace pir {
 
 class Operation;
 class Pass;
+class Pattern;
 
 namespace detail {
 struct PassInstrumentorImpl;
@@ -53,6 +54,13 @@ class PassInstrumentation {
   virtual void RunAfterAnalysis(const std::string& name,
                                 TypeId id,
                                 Operation* op) {}
+
+  // A callback to run after a pattern of a pattern rewrite pass is tried on
+  // op, applied tells whether the pattern matched and rewrote op.
+  virtual void RunAfterPatternMatch(Pass* pass,
+                                    const Pattern& pattern,
+                                    Operation* op,
+                                    bool applied) {}
 };
 
 /// This class holds a collection of PassInstrumentation objects, and invokes
@@ -78,6 +86,11 @@ class IR_API PassInstrumentor {
 
   void RunAfterAnalysis(const std::string& name, TypeId id, Operation* op);
 
+  void RunAfterPatternMatch(Pass* pass,
+                            const Pattern& pattern,
+                            Operation* op,
+                            bool applied);
+
   // TODO(liuyuanle): Add other hooks.
 
  private:
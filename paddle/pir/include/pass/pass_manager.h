@@ -119,6 +119,15 @@ class IR_API PassManager {
     value_replaced_hook_ = hook;
   }
 
+  // Run the pipeline over the nested operations of a block with up to
+  // num_threads threads. Only the operations isolated from above, whose
+  // regions use no value defined outside of them, run in parallel, and the
+  // passes must not share state between the operations they run on. The
+  // pipeline runs sequentially when any instrumentation is added.
+  void EnableParallelRun(size_t num_threads) { num_threads_ = num_threads; }
+
+  size_t num_threads() const { return num_threads_; }
+
  private:
   bool Initialize(IrContext *context);
 
@@ -133,6 +142,8 @@ class IR_API PassManager {
 
   bool disable_log_{false};
 
+  size_t num_threads_{1};
+
   std::vector<std::unique_ptr<Pass>> passes_;
 
   std::unique_ptr<Pass> pass_adaptor_;
@@ -22,6 +22,10 @@ namespace pir {
 using VALUE_REPLACED_HOOK_FUNC = std::function<void(pir::Value, pir::Value)>;
 
 class FrozenRewritePatternSet;
+class Pattern;
+
+using PATTERN_MATCHED_HOOK_FUNC =
+    std::function<void(const Pattern&, Operation*, bool)>;
 
 /// This enum will control which ops will be added to the worklist during the
 /// match rewrite process
@@ -48,6 +52,15 @@ class IR_API GreedyRewriteConfig {
   /// kNoLimit to represent unlimited.
   int64_t max_num_rewrites = kNoLimit;
 
+  /// If true, only the first iteration scans the whole region. The following
+  /// iterations revisit the ops touched by the rewrites of the previous one
+  /// and their users up to `incremental_user_depth` levels, which is enough
+  /// for the patterns matching from a root towards its producers at most that
+  /// deep. Also enabled by FLAGS_pir_incremental_pattern_rewrite.
+  bool incremental = false;
+
+  int64_t incremental_user_depth = 4;
+
   /// Only the op inside this region will be added to the worklist.
   Region* region{nullptr};
 
@@ -62,6 +75,10 @@ class IR_API GreedyRewriteConfig {
   // Hook function for replacing the value.
   VALUE_REPLACED_HOOK_FUNC value_replaced_hook = nullptr;
 
+  // Hook function called after every pattern tried on an op, with whether the
+  // pattern was applied.
+  PATTERN_MATCHED_HOOK_FUNC pattern_matched_hook = nullptr;
+
   static constexpr int64_t kNoLimit = -1;
 };
 
@@ -0,0 +1,80 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/pir/src/core/op_memory_pool.h"
+
+#include <glog/logging.h>
+#include <mutex>
+
+#include "paddle/common/enforce.h"
+#include "paddle/common/flags.h"
+#include "paddle/pir/include/core/utils.h"
+
+COMMON_DECLARE_bool(pir_operation_memory_pool);
+
+namespace pir {
+namespace detail {
+
+OpMemoryPool &OpMemoryPool::Instance() {
+  // Leaked on purpose, operations may be destroyed during static destruction.
+  static OpMemoryPool *pool = new OpMemoryPool();
+  return *pool;
+}
+
+OpMemoryPool::OpMemoryPool() : enabled_(FLAGS_pir_operation_memory_pool) {}
+
+void *OpMemoryPool::Allocate(size_t size) {
+  if (!enabled_ || size > kMaxPooledSize) {
+    return aligned_malloc(size, 8);
+  }
+  size_t cls = (size + kAlignment - 1) / kAlignment - 1;
+  size = (cls + 1) * kAlignment;
+  std::lock_guard<pir::SpinLock> guard(lock_);
+  if (FreeBlock *block = free_lists_[cls]) {
+    free_lists_[cls] = block->next;
+    return block;
+  }
+  if (chunk_left_ < size) {
+    // The tail of the last chunk is too small for any block of this size and
+    // is given up.
+    chunk_ptr_ = static_cast<char *>(aligned_malloc(kChunkSize, kAlignment));
+    PADDLE_ENFORCE_NOT_NULL(
+        chunk_ptr_,
+        common::errors::ResourceExhausted(
+            "Failed to allocate %d bytes for operations.", kChunkSize));
+    chunk_left_ = kChunkSize;
+    chunk_bytes_ += kChunkSize;
+    VLOG(10) << "Allocate a chunk of " << kChunkSize
+             << " bytes for operations, total " << chunk_bytes_ << " bytes.";
+  }
+  void *ptr = chunk_ptr_;
+  chunk_ptr_ += size;
+  chunk_left_ -= size;
+  return ptr;
+}
+
+void OpMemoryPool::Deallocate(void *ptr, size_t size) {
+  if (!enabled_ || size > kMaxPooledSize) {
+    aligned_free(ptr);
+    return;
+  }
+  size_t cls = (size + kAlignment - 1) / kAlignment - 1;
+  std::lock_guard<pir::SpinLock> guard(lock_);
+  auto *block = static_cast<FreeBlock *>(ptr);
+  block->next = free_lists_[cls];
+  free_lists_[cls] = block;
+}
+
+}  // namespace detail
+}  // namespace pir
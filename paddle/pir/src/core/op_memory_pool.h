@@ -0,0 +1,68 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "paddle/pir/include/core/spin_lock.h"
+
+namespace pir {
+namespace detail {
+///
+/// \brief The pool of the memory of operations. The memory of an operation
+/// holds its results, the operation itself, its operands, successors and
+/// regions. The small ones are carved from large chunks and recycled by size
+/// class, so the operations built one after another stay close in memory and
+/// creating and destroying them does not go through malloc and free.
+///
+/// The pool is shared by all programs because operations can be moved
+/// between blocks of different programs. The chunks are kept for reuse once
+/// allocated. FLAGS_pir_operation_memory_pool disables the pool, it is read
+/// once when the pool is first used.
+///
+class OpMemoryPool {
+ public:
+  static OpMemoryPool &Instance();
+
+  void *Allocate(size_t size);
+
+  void Deallocate(void *ptr, size_t size);
+
+  // The bytes of the chunks allocated by the pool.
+  size_t chunk_bytes() const { return chunk_bytes_; }
+
+ private:
+  OpMemoryPool();
+
+  static constexpr size_t kAlignment = 16;
+  static constexpr size_t kMaxPooledSize = 2048;
+  static constexpr size_t kChunkSize = 256 * 1024;
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  bool enabled_;
+  pir::SpinLock lock_;
+  FreeBlock *free_lists_[kMaxPooledSize / kAlignment] = {};
+  char *chunk_ptr_{nullptr};
+  size_t chunk_left_{0};
+  size_t chunk_bytes_{0};
+};
+
+}  // namespace detail
+}  // namespace pir
@@ -25,6 +25,7 @@
 #include "paddle/pir/include/core/region.h"
 #include "paddle/pir/include/core/utils.h"
 #include "paddle/pir/src/core/block_operand_impl.h"
+#include "paddle/pir/src/core/op_memory_pool.h"
 #include "paddle/pir/src/core/op_result_impl.h"
 
 namespace pir {
@@ -77,8 +78,8 @@ Operation *Operation::Create(const std::vector<Value> &inputs,
   size_t base_size = result_mem_size + op_mem_size + operand_mem_size +
                      region_mem_size + block_operand_size;
   // 2. Malloc memory.
-  char *base_ptr =
-      reinterpret_cast<char *>(detail::aligned_malloc(base_size, 8));
+  char *base_ptr = reinterpret_cast<char *>(
+      detail::OpMemoryPool::Instance().Allocate(base_size));
 
   auto name = op_info ? op_info.name() : "";
   VLOG(10) << "Create Operation [" << name
@@ -241,10 +242,14 @@ void Operation::Destroy() {
                 sizeof(detail::OpInlineResultImpl) * OUTLINE_RESULT_IDX
           : sizeof(detail::OpInlineResultImpl) * num_results_;
   void *aligned_ptr = reinterpret_cast<char *>(this) - result_mem_size;
+  size_t base_size = result_mem_size + sizeof(Operation) +
+                     sizeof(detail::OpOperandImpl) * num_operands_ +
+                     num_regions_ * sizeof(Region) +
+                     num_successors_ * sizeof(detail::BlockOperandImpl);
 
   VLOG(10) << "Destroy Operation [" << name() << "]: {ptr = " << aligned_ptr
-           << ", size = " << result_mem_size << "} done.";
-  detail::aligned_free(aligned_ptr);
+           << ", size = " << base_size << "} done.";
+  detail::OpMemoryPool::Instance().Deallocate(aligned_ptr, base_size);
 }
 
 IrContext *Operation::ir_context() const { return info_.ir_context(); }
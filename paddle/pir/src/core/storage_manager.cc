@@ -37,10 +37,12 @@ struct ParametricStorageManager {
   }
 
   // Get the storage of parametric type, if not in the cache, create and
-  // insert the cache.
+  // insert the cache. Every parametric type has its own lock, so that the
+  // threads uniquing different types do not wait for each other.
   StorageBase *GetOrCreate(std::size_t hash_value,
                            std::function<bool(StorageBase *)> equal_func,
                            std::function<StorageBase *()> constructor) {
+    std::lock_guard<pir::SpinLock> guard(lock_);
     if (parametric_instances_.count(hash_value) != 0) {
       auto pr = parametric_instances_.equal_range(hash_value);
       while (pr.first != pr.second) {
@@ -66,6 +68,7 @@ struct ParametricStorageManager {
   // is used for storage.
   std::unordered_multimap<size_t, StorageBase *> parametric_instances_;
   std::function<void(StorageBase *)> destroy_;
+  pir::SpinLock lock_;
 };
 
 StorageManager::StorageManager() = default;
@@ -77,15 +80,19 @@ StorageManager::StorageBase *StorageManager::GetParametricStorageImpl(
     std::size_t hash_value,
     std::function<bool(const StorageBase *)> equal_func,
     std::function<StorageBase *()> constructor) {
-  std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
   VLOG(10) << "Try to get a parametric storage of: [TypeId_hash="
            << std::hash<pir::TypeId>()(type_id) << ", param_hash=" << hash_value
            << "].";
-  if (parametric_instance_.find(type_id) == parametric_instance_.end()) {
-    IR_THROW("The input data pointer is null.");
+  ParametricStorageManager *parametric_storage = nullptr;
+  {
+    std::lock_guard<pir::SpinLock> guard(parametric_instance_lock_);
+    auto iter = parametric_instance_.find(type_id);
+    if (iter == parametric_instance_.end()) {
+      IR_THROW("The input data pointer is null.");
+    }
+    parametric_storage = iter->second.get();
   }
-  ParametricStorageManager &parametric_storage = *parametric_instance_[type_id];
-  return parametric_storage.GetOrCreate(hash_value, equal_func, constructor);
+  return parametric_storage->GetOrCreate(hash_value, equal_func, constructor);
 }
 
 StorageManager::StorageBase *StorageManager::GetParameterlessStorageImpl(
@@ -27,6 +27,31 @@ bool CanSubstituteInConstraint(const DimExpr& lhs, const DimExpr& rhs) {
   return true;
 }
 
+// Whether target appears in dim_expr, without building new expressions.
+bool ContainsDimExpr(const DimExpr& dim_expr, const DimExpr& target) {
+  if (dim_expr == target) {
+    return true;
+  }
+  auto ContainsInOperands = [&](const List<DimExpr>& operands) {
+    for (const auto& operand : *operands) {
+      if (ContainsDimExpr(operand, target)) return true;
+    }
+    return false;
+  };
+  return std::visit(
+      common::Overloaded{
+          [&](std::int64_t) { return false; },
+          [&](const std::string&) { return false; },
+          [&](const Negative<DimExpr>& expr) {
+            return ContainsDimExpr(expr->data, target);
+          },
+          [&](const Reciprocal<DimExpr>& expr) {
+            return ContainsDimExpr(expr->data, target);
+          },
+          [&](const auto& expr) { return ContainsInOperands(expr.operands); }},
+      dim_expr.variant());
+}
+
 bool CanEqualCStrInsert(const DimExpr& lhs, const DimExpr& rhs) {
   int lhs_priority = GetDimExprPriority(lhs);
   int rhs_priority = GetDimExprPriority(rhs);
@@ -266,33 +291,56 @@ void ConstraintsManager::SubstituteInConstraint(const DimExpr& origin,
                                                 const DimExpr& substituted) {
   std::unordered_map<DimExpr, DimExpr> substitution_pattern;
   substitution_pattern[origin] = substituted;
+  // Only the constraints containing origin change, the others are kept and
+  // a constraint set is rebuilt only if some of its constraints change.
+  auto Substitute = [&](const DimExpr& dim_expr) {
+    return ContainsDimExpr(dim_expr, origin)
+               ? SubstituteDimExpr(dim_expr, substitution_pattern)
+               : dim_expr;
+  };
 
-  EqualConstraints substituted_equals;
+  bool equals_changed = false;
   EqualConstraintsVisitor([&](auto it) {
-    DimExpr key = SubstituteDimExpr(it->first, substitution_pattern);
-    DimExpr value = SubstituteDimExpr(it->second, substitution_pattern);
-    substituted_equals.Union(key, value);
+    equals_changed = equals_changed || ContainsDimExpr(it->first, origin) ||
+                     ContainsDimExpr(it->second, origin);
   });
-  equals_ = substituted_equals;
+  if (equals_changed) {
+    EqualConstraints substituted_equals;
+    EqualConstraintsVisitor([&](auto it) {
+      substituted_equals.Union(Substitute(it->first), Substitute(it->second));
+    });
+    equals_ = substituted_equals;
+  }
 
-  GTOneConstraints substituted_gtones;
+  bool gtones_changed = false;
   GTOneConstraintsVisitor([&](auto it) {
-    substituted_gtones.insert(SubstituteDimExpr(*it, substitution_pattern));
+    gtones_changed = gtones_changed || ContainsDimExpr(*it, origin);
   });
-  gtones_ = substituted_gtones;
+  if (gtones_changed) {
+    GTOneConstraints substituted_gtones;
+    GTOneConstraintsVisitor(
+        [&](auto it) { substituted_gtones.insert(Substitute(*it)); });
+    gtones_ = substituted_gtones;
+  }
 
-  BroadcastableConstraints substituted_broadcastables;
+  bool broadcastables_changed = false;
   BroadcastableConstraintsVisitor([&](auto it) {
-    const DimExpr& substituted_lhs =
-        SubstituteDimExpr(it->data->lhs, substitution_pattern);
-    const DimExpr& substituted_rhs =
-        SubstituteDimExpr(it->data->rhs, substitution_pattern);
-    if (substituted_lhs != substituted_rhs) {
-      substituted_broadcastables.insert(
-          Broadcastable<DimExpr>(substituted_lhs, substituted_rhs));
-    }
+    broadcastables_changed = broadcastables_changed ||
+                             ContainsDimExpr(it->data->lhs, origin) ||
+                             ContainsDimExpr(it->data->rhs, origin);
   });
-  broadcastables_ = substituted_broadcastables;
+  if (broadcastables_changed) {
+    BroadcastableConstraints substituted_broadcastables;
+    BroadcastableConstraintsVisitor([&](auto it) {
+      const DimExpr& substituted_lhs = Substitute(it->data->lhs);
+      const DimExpr& substituted_rhs = Substitute(it->data->rhs);
+      if (substituted_lhs != substituted_rhs) {
+        substituted_broadcastables.insert(
+            Broadcastable<DimExpr>(substituted_lhs, substituted_rhs));
+      }
+    });
+    broadcastables_ = substituted_broadcastables;
+  }
 
   InputRangeConstraints substituted_input_ranges;
   InputRangeConstraintsVisitor([&](auto it) {
@@ -980,7 +980,11 @@ struct SimplifyBroadcast {
   using dim_expr_type = Broadcast<DimExpr>;
 
   DimExpr Rewrite(const DimExpr& expr) {
-    auto [operands] = expr.Get<Broadcast<DimExpr>>();
+    // Copy the operands, the input may be shared, e.g. by the simplify cache.
+    const auto& [expr_operands] = expr.Get<Broadcast<DimExpr>>();
+    List<DimExpr> operands{};
+    operands->insert(
+        operands->end(), expr_operands->begin(), expr_operands->end());
     while (operands->size() > 1) {
       int pos_erasable = SearchErasable(operands);
       if (pos_erasable < 0) break;
@@ -1040,7 +1044,7 @@ void DoPass(bool* rewrited, DimExpr* expr) {
   *rewrited = *rewrited || (old_expr != *expr);
 }
 
-DimExpr Simplify(const DimExpr& expr) {
+DimExpr SimplifyUncached(const DimExpr& expr) {
   DimExpr ret = expr;
   for (bool keep_rewrite = true; keep_rewrite;) {
     keep_rewrite = false;
@@ -1075,6 +1079,28 @@ DimExpr Simplify(const DimExpr& expr) {
   return ret;
 }
 
+// Shape inference simplifies the same expressions again and again, e.g. the
+// operands of every binary operator, so the results are cached per thread.
+// A simplified expression is cached as its own result as well.
+DimExpr Simplify(const DimExpr& expr) {
+  if (expr.isa<std::int64_t>() || expr.isa<std::string>()) {
+    return SimplifyUncached(expr);
+  }
+  constexpr size_t kMaxCachedExprs = 1 << 16;
+  thread_local std::unordered_map<DimExpr, DimExpr> cache;
+  auto iter = cache.find(expr);
+  if (iter != cache.end()) {
+    return iter->second;
+  }
+  DimExpr ret = SimplifyUncached(expr);
+  if (cache.size() >= kMaxCachedExprs) {
+    cache.clear();
+  }
+  cache.emplace(expr, ret);
+  cache.emplace(ret, ret);
+  return ret;
+}
+
 }  // namespace
 
 DimExpr SimplifyDimExpr(const DimExpr& expr) { return Simplify(expr); }
@@ -1179,8 +1205,8 @@ class SubstituteDimExprHelper final {
 
   template <template <typename> class OpT>
   std::optional<DimExpr> SubstituteSubOperands(const OpT<DimExpr>& dim_expr) {
-    const std::unordered_set<DimExpr> operands_set{dim_expr.operands->begin(),
-                                                   dim_expr.operands->end()};
+    // Most patterns are symbols, build the operand set only when needed.
+    std::unordered_set<DimExpr> operands_set;
 
     auto CanReplaceSubOperands = [&operands_set](const OpT<DimExpr>& dim_expr) {
       for (const auto& operand : *dim_expr.operands) {
@@ -1191,6 +1217,10 @@ class SubstituteDimExprHelper final {
 
     for (const auto& kv : pattern_to_replacement_) {
       if (!kv.first.isa<OpT<DimExpr>>()) continue;
+      if (operands_set.empty()) {
+        operands_set.insert(dim_expr.operands->begin(),
+                            dim_expr.operands->end());
+      }
       const auto& dim_expr_pattern = kv.first.dyn_cast<OpT<DimExpr>>();
       if (!CanReplaceSubOperands(dim_expr_pattern)) continue;
 
@@ -13,7 +13,13 @@
 // limitations under the License.
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
 
+#include "paddle/pir/include/core/block_argument.h"
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/core/program.h"
@@ -26,9 +32,47 @@
 #include "paddle/pir/src/pass/pass_adaptor.h"
 
 #include "paddle/common/enforce.h"
+#include "paddle/common/flags.h"
+
+COMMON_DECLARE_int32(pir_pass_num_threads);
 
 namespace pir {
 
+namespace {
+// The states of the passes run by a thread of a parallel pass manager, where
+// the same pass runs on several operations at once.
+thread_local std::unordered_map<const Pass*,
+                                std::optional<detail::PassExecutionState>>*
+    worker_pass_states = nullptr;
+
+// Whether the regions of op only use the values defined inside of op, so the
+// passes running on op do not touch the use lists of any outer value.
+bool IsIsolatedFromAbove(Operation* op) {
+  bool isolated = true;
+  op->Walk([&](Operation* inner) {
+    if (!isolated || inner == op) return;
+    for (auto value : inner->operands_source()) {
+      if (!value) continue;
+      Block* block = nullptr;
+      if (auto* defining_op = value.defining_op()) {
+        block = defining_op->GetParent();
+      } else if (auto arg = value.dyn_cast<BlockArgument>()) {
+        block = arg.owner();
+      }
+      Operation* parent = block ? block->GetParentOp() : nullptr;
+      while (parent && parent != op) {
+        parent = parent->GetParentOp();
+      }
+      if (parent != op) {
+        isolated = false;
+        return;
+      }
+    }
+  });
+  return isolated;
+}
+}  // namespace
+
 //===----------------------------------------------------------------------===//
 // Pass
 //===----------------------------------------------------------------------===//
@@ -45,21 +89,26 @@ Pass::~Pass() {
 bool Pass::CanApplyOn(Operation* op) const { return op->num_regions() > 0; }
 
 std::optional<detail::PassExecutionState>& Pass::pass_state() {
+  if (worker_pass_states) {
+    return (*worker_pass_states)[this];
+  }
   return pass_state_;
 }
 
 void Pass::SignalPassFailure() {
-  PADDLE_ENFORCE_EQ(pass_state_.has_value(),
+  auto& state = pass_state();
+  PADDLE_ENFORCE_EQ(state.has_value(),
                     true,
                     common::errors::InvalidArgument("pass state has no value"));
-  pass_state_->pass_failed = true;
+  state->pass_failed = true;
 }
 
 AnalysisManager Pass::analysis_manager() {
-  PADDLE_ENFORCE_EQ(pass_state_.has_value(),
+  auto& state = pass_state();
+  PADDLE_ENFORCE_EQ(state.has_value(),
                     true,
                     common::errors::InvalidArgument("pass state has no value"));
-  return pass_state_->am;
+  return state->am;
 }
 //===----------------------------------------------------------------------===//
 // PatternRewritePass
@@ -94,6 +143,13 @@ void PatternRewritePass::Run(Operation* op) {
     config.value_replaced_hook =
         Get<VALUE_REPLACED_HOOK_FUNC>(kValueReplaceHookAttr);
   }
+  if (auto* instrumentor = analysis_manager().GetPassInstrumentor()) {
+    config.pattern_matched_hook = [this, instrumentor](const Pattern& pattern,
+                                                       Operation* op,
+                                                       bool applied) {
+      instrumentor->RunAfterPatternMatch(this, pattern, op, applied);
+    };
+  }
   auto [_, num_rewrites] = ApplyPatternsGreedily(op, patterns_, config);
   AddStatistics(num_rewrites);
 }
@@ -109,10 +165,18 @@ void detail::PassAdaptor::RunImpl(Operation* op,
                                   uint8_t opt_level,
                                   bool verify) {
   auto last_am = analysis_manager();
+  // The nested pipelines of a worker thread run sequentially.
+  bool parallel = pm_->num_threads() > 1 && !last_am.GetPassInstrumentor() &&
+                  !worker_pass_states;
 
   for (size_t i = 0; i < op->num_regions(); ++i) {
     auto& region = op->region(i);
     for (auto& block : region) {
+      if (parallel) {
+        if (!RunParallel(&block, opt_level, verify))
+          return SignalPassFailure();
+        continue;
+      }
       for (auto& op : block) {
         AnalysisManagerHolder am(&op, last_am.GetPassInstrumentor());
         if (!RunPipeline(*pm_, &op, am, opt_level, verify))
@@ -123,6 +187,56 @@ void detail::PassAdaptor::RunImpl(Operation* op,
   return;
 }
 
+bool detail::PassAdaptor::RunParallel(Block* block,
+                                      uint8_t opt_level,
+                                      bool verify) {
+  std::vector<Operation*> parallel_ops;
+  for (auto& op : *block) {
+    if (op.num_regions() > 0 && IsIsolatedFromAbove(&op)) {
+      parallel_ops.push_back(&op);
+      continue;
+    }
+    AnalysisManagerHolder am(&op, nullptr);
+    if (!RunPipeline(*pm_, &op, am, opt_level, verify)) return false;
+  }
+
+  std::atomic<size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  auto worker = [&]() {
+    std::unordered_map<const Pass*, std::optional<PassExecutionState>> states;
+    worker_pass_states = &states;
+    for (size_t i = next++; i < parallel_ops.size() && !failed; i = next++) {
+      try {
+        AnalysisManagerHolder am(parallel_ops[i], nullptr);
+        if (!RunPipeline(*pm_, parallel_ops[i], am, opt_level, verify)) {
+          failed = true;
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(error_mutex);
+        if (!error) error = std::current_exception();
+        failed = true;
+      }
+    }
+    worker_pass_states = nullptr;
+  };
+
+  size_t num_threads = std::min(pm_->num_threads(), parallel_ops.size());
+  VLOG(4) << "Run the pipeline on " << parallel_ops.size()
+          << " isolated operations with " << num_threads << " threads.";
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) std::rethrow_exception(error);
+  return !failed;
+}
+
 bool detail::PassAdaptor::RunPipeline(const PassManager& pm,
                                       Operation* op,
                                       AnalysisManager am,
@@ -160,7 +274,7 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
                                   bool verify) {
   if (opt_level < pass->pass_info().opt_level) return true;
 
-  pass->pass_state_ = PassExecutionState(op, am);
+  pass->pass_state() = PassExecutionState(op, am);
 
   PassInstrumentor* instrumentor = am.GetPassInstrumentor();
 
@@ -185,7 +299,9 @@ bool detail::PassAdaptor::RunPass(Pass* pass,
 // PassManager
 //----------------------------------------------------------------------------------------------//
 PassManager::PassManager(IrContext* context, uint8_t opt_level)
-    : context_(context), opt_level_(opt_level) {
+    : context_(context),
+      opt_level_(opt_level),
+      num_threads_(std::max(FLAGS_pir_pass_num_threads, 1)) {
   pass_adaptor_ = std::make_unique<detail::PassAdaptor>(this);
 }
 
@@ -288,6 +404,15 @@ void PassInstrumentor::RunAfterAnalysis(const std::string& name,
   }
 }
 
+void PassInstrumentor::RunAfterPatternMatch(Pass* pass,
+                                            const Pattern& pattern,
+                                            Operation* op,
+                                            bool applied) {
+  for (auto& instr : impl_->instrumentations) {
+    instr->RunAfterPatternMatch(pass, pattern, op, applied);
+  }
+}
+
 void PassInstrumentor::AddInstrumentation(
     std::unique_ptr<PassInstrumentation> pi) {
   impl_->instrumentations.emplace_back(std::move(pi));
@@ -18,6 +18,7 @@
 
 namespace pir {
 
+class Block;
 class Operation;
 class PassManager;
 
@@ -34,6 +35,10 @@ class PassAdaptor final : public Pass {
  private:
   void RunImpl(Operation* op, uint8_t opt_level, bool verify);
 
+  // Runs the pipeline over the operations of block, the operations isolated
+  // from above are distributed among the threads of the pass manager.
+  bool RunParallel(Block* block, uint8_t opt_level, bool verify);
+
   static bool RunPass(Pass* pass,
                       Operation* op,
                       AnalysisManager am,
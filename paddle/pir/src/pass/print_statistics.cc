@@ -13,12 +13,15 @@
 // limitations under the License.
 
 #include <glog/logging.h>
+#include <algorithm>
+#include <map>
 
 #include "paddle/common/macros.h"
 #include "paddle/pir/include/core/operation.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_instrumentation.h"
 #include "paddle/pir/include/pass/pass_manager.h"
+#include "paddle/pir/include/pattern_rewrite/pattern_match.h"
 #include "paddle/utils/string/pretty_log.h"
 
 REGISTER_FILE_SYMBOLS(print_statistics);
@@ -36,7 +39,17 @@ class PrintStatistics : public PassInstrumentation {
                                 pass->pass_info().name);
   }
 
+  void RunAfterPatternMatch(Pass *pass,
+                            const Pattern &pattern,
+                            Operation *op,
+                            bool applied) override {
+    auto &counter = pattern_counters_[pattern.debug_name()];
+    ++counter.first;
+    if (applied) ++counter.second;
+  }
+
   void RunAfterPass(Pass *pass, Operation *op) override {
+    PrintPatternCounters();
     if (pass->Has("__match_count_1__") && pass->Has("__match_count_2__")) {
       auto match_count_1 = pass->Get<int64_t>("__match_count_1__");
       auto match_count_2 = pass->Get<int64_t>("__match_count_2__");
@@ -56,6 +69,28 @@ class PrintStatistics : public PassInstrumentation {
       }
     }
   }
+
+ private:
+  void PrintPatternCounters() {
+    if (pattern_counters_.empty()) return;
+    std::vector<std::pair<std::string, std::pair<int64_t, int64_t>>> counters(
+        pattern_counters_.begin(), pattern_counters_.end());
+    // The patterns failing the most matches come first.
+    std::stable_sort(
+        counters.begin(), counters.end(), [](const auto &lhs, const auto &rhs) {
+          return lhs.second.first - lhs.second.second >
+                 rhs.second.first - rhs.second.second;
+        });
+    for (auto &[name, counter] : counters) {
+      LOG(INFO) << "--- pattern [" << (name.empty() ? "unnamed" : name)
+                << "] tried " << counter.first << " times, applied "
+                << counter.second << " times";
+    }
+    pattern_counters_.clear();
+  }
+
+  // The number of times each pattern was tried and applied during a pass.
+  std::map<std::string, std::pair<int64_t, int64_t>> pattern_counters_;
 };
 
 void PassManager::EnablePrintStatistics() {
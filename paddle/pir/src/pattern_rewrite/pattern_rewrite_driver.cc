@@ -23,6 +23,7 @@
 #include <unordered_map>
 #include <unordered_set>
 
+#include "paddle/common/flags.h"
 #include "paddle/pir/include/core/block.h"
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/operation.h"
@@ -32,6 +33,8 @@
 #include "paddle/pir/include/pattern_rewrite/pattern_applicator.h"
 #include "paddle/pir/include/pattern_rewrite/pattern_match.h"
 
+COMMON_DECLARE_bool(pir_incremental_pattern_rewrite);
+
 namespace {
 
 class GreedyPatternRewriteDriver : public pir::PatternRewriter {
@@ -56,6 +59,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     if (config.value_replaced_hook) {
       value_replaced_hook_fn_ = config.value_replaced_hook;
     }
+    incremental_ = config.incremental || FLAGS_pir_incremental_pattern_rewrite;
   }
 
   std::pair<bool, int64_t> Simplify() {
@@ -71,11 +75,16 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       worklist_.clear();
       worklist_map_.clear();
 
-      for (auto& block_item : region_) {
-        for (auto& op_item : block_item) {
-          worklist_.push_back(&op_item);
+      if (incremental_ && iteration > 1) {
+        CollectTouchedOps();
+      } else {
+        for (auto& block_item : region_) {
+          for (auto& op_item : block_item) {
+            worklist_.push_back(&op_item);
+          }
         }
       }
+      touched_ops_.clear();
       if (config_.use_top_down_traversal) {
         // Reverse the list so out pop-back loop process them in-order.
         std::reverse(worklist_.begin(), worklist_.end());
@@ -110,7 +119,22 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       // TODO(wilber): fold logical.
       // ...
 
-      bool match_result = matcher_.MatchAndRewrite(op, *this);
+      bool match_result = false;
+      if (config_.pattern_matched_hook) {
+        match_result = matcher_.MatchAndRewrite(
+            op,
+            *this,
+            nullptr,
+            [&](const pir::Pattern& pattern) {
+              config_.pattern_matched_hook(pattern, op, false);
+            },
+            [&](const pir::Pattern& pattern) {
+              config_.pattern_matched_hook(pattern, op, true);
+              return true;
+            });
+      } else {
+        match_result = matcher_.MatchAndRewrite(op, *this);
+      }
       if (match_result) {
         ++num_rewrites;
       }
@@ -151,6 +175,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     if (config_.strict_mode != pir::GreedyRewriteStrictness::AnyOp) {
       strict_mode_filtered_ops_.erase(op);
     }
+    touched_ops_.erase(op);
   }
 
   void NotifyOperationInserted(pir::Operation* op) override {
@@ -169,6 +194,12 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   void AddToWorklist(pir::Operation* op) {
     if (config_.strict_mode == pir::GreedyRewriteStrictness::AnyOp ||
         strict_mode_filtered_ops_.count(op)) {
+      // Only the ops of the region are revisited, the nested ones may be
+      // erased along with their parent without notification.
+      if (incremental_ && op->GetParent() &&
+          op->GetParent()->GetParent() == &region_) {
+        touched_ops_.insert(op);
+      }
       if (worklist_map_.count(op)) return;
 
       worklist_map_[op] = worklist_.size();
@@ -176,6 +207,34 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
     }
   }
 
+  /// Seed the worklist with the ops touched in the last iteration and their
+  /// users, in the order of the region.
+  void CollectTouchedOps() {
+    std::unordered_set<pir::Operation*> seeds;
+    std::vector<pir::Operation*> frontier(touched_ops_.begin(),
+                                          touched_ops_.end());
+    for (int64_t depth = 0;
+         depth <= config_.incremental_user_depth && !frontier.empty();
+         ++depth) {
+      std::vector<pir::Operation*> next;
+      for (auto* op : frontier) {
+        if (!seeds.insert(op).second) continue;
+        for (uint32_t i = 0; i < op->num_results(); ++i) {
+          auto result = op->result(i);
+          for (auto it = result.use_begin(); it != result.use_end(); ++it) {
+            next.push_back(it->owner());
+          }
+        }
+      }
+      frontier = std::move(next);
+    }
+    for (auto& block_item : region_) {
+      for (auto& op_item : block_item) {
+        if (seeds.count(&op_item)) worklist_.push_back(&op_item);
+      }
+    }
+  }
+
   void AddOperandToWorklist(pir::Value operand) {
     // If the use count of this operand is now < 2, we re-add the defining
     // operation to the worklist.
@@ -207,6 +266,7 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
       worklist_[it->second] = nullptr;
       worklist_map_.erase(it);
     }
+    touched_ops_.erase(op);
   }
 
  private:
@@ -217,6 +277,9 @@ class GreedyPatternRewriteDriver : public pir::PatternRewriter {
   pir::Region& region_;
   pir::PatternApplicator matcher_;
   pir::VALUE_REPLACED_HOOK_FUNC value_replaced_hook_fn_ = nullptr;
+  bool incremental_{false};
+  // The ops added to the worklist by the rewrites of this iteration.
+  std::unordered_set<pir::Operation*> touched_ops_;
 };
 
 }  // namespace
@@ -360,13 +360,16 @@ try:
         from .libpaddle import (  # noqa: F401
             _array_to_share_memory_tensor,
             _cleanup_mmap_fds,
+            _clear_shm_ring,
             _convert_to_tensor_list,
             _erase_process_pids,
+            _pack_tensors_to_shm_ring,
             _remove_tensor_list_mmap_fds,
             _set_max_memory_map_allocation_pool_size,
             _set_process_pids,
             _set_process_signal_handler,
             _throw_error_if_process_failed,
+            _unpack_tensors_from_shm_ring,
         )
 
 except Exception as e:
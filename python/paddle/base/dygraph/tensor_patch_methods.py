@@ -1260,6 +1260,48 @@ def monkey_patch_tensor():
         """
         return _C_ops.sparse_coalesce(self)
 
+    @framework.dygraph_only
+    def __dlpack__(
+        self, *, stream=None, max_version=None, dl_device=None, copy=None
+    ):
+        """
+        Export the tensor as a DLPack capsule that shares the memory with it.
+
+        Args:
+            stream (int|None, optional): The stream of the consumer, which waits
+                for the work queued to the tensor so far without blocking the
+                host. None stands for the legacy default stream, -1 means the
+                consumer synchronizes by itself. Only used for CUDA tensors.
+            max_version (tuple|None, optional): The highest DLPack version the
+                consumer supports, an unversioned capsule is always returned.
+            dl_device (tuple|None, optional): The device to export to, only
+                the device of the tensor is supported.
+            copy (bool|None, optional): Whether to export a copy of the tensor.
+
+        Returns:
+            dltensor, and the data type is PyCapsule.
+        """
+        if self.is_sparse():
+            raise BufferError(
+                "Can't export a sparse tensor by DLPack. "
+                "Use Tensor.to_dense() to convert to a dense tensor first."
+            )
+        if dl_device is not None and tuple(dl_device) != tuple(
+            self.__dlpack_device__()
+        ):
+            raise BufferError(
+                f"Can't export the tensor on {self.place} to device {dl_device}."
+            )
+        tensor = self
+        if copy:
+            with paddle.no_grad():
+                tensor = self.clone()
+        if self.place.is_gpu_place():
+            stream = 1 if stream is None else stream
+        else:
+            stream = -1
+        return tensor.value().get_tensor()._to_dlpack(stream)
+
     @framework.dygraph_only
     def __dlpack_device__(self):
         """
@@ -1298,8 +1340,11 @@ def monkey_patch_tensor():
         """Array view description for cuda tensors.
 
         See:
-        CUDA Array Interface (Version 2)
+        CUDA Array Interface (Version 3)
         https://numba.pydata.org/numba-doc/dev/cuda/cuda_array_interface.html
+
+        The stream is the one the tensor is computed on, the consumer waits
+        for it instead of the host synchronizing here.
         """
 
         # raise AttributeError for unsupported tensors, so that
@@ -1355,15 +1400,25 @@ def monkey_patch_tensor():
             # the number of bytes to skip to access the next element at each dimension.
             strides = tuple(s * itemsize for s in self.strides)
 
-        data_ptr = self.data_ptr() if self.numel().item() > 0 else 0
+        # the shape is on the host, numel() would sync the device
+        data_ptr = self.data_ptr() if 0 not in shape else 0
         data = (data_ptr, False)  # read-only is false
 
+        with warnings.catch_warnings():
+            warnings.filterwarnings("ignore", category=UserWarning)
+            stream = paddle.device.cuda.current_stream(
+                self.place.gpu_device_id()
+            ).cuda_stream
+        # 0 is disallowed, the legacy default stream is 1
+        stream = 1 if stream == 0 else stream
+
         return {
             "typestr": typestr,
             "shape": shape,
             "strides": strides,
             "data": data,
-            "version": 2,
+            "version": 3,
+            "stream": stream,
         }
 
     if not hasattr(core, "eager"):
@@ -1410,6 +1465,7 @@ def monkey_patch_tensor():
         ("_use_gpudnn", _use_gpudnn),
         ("_md5sum", _md5sum),
         ("__cuda_array_interface__", __cuda_array_interface__),
+        ("__dlpack__", __dlpack__),
         ("__dlpack_device__", __dlpack_device__),
     ):
         setattr(core.eager.Tensor, method_name, method)
@@ -35,6 +35,7 @@ PIR_PASS = [
     'fused_gemm_epilogue_pass',
     'fused_linear_param_grad_add_pass',
     'fuse_allreduce_split_to_reducescatter_pass',
+    'fuse_collective_matmul_pass',
     'fused_dropout_add_pass',
 ]
 
@@ -20,6 +20,7 @@ from dataclasses import dataclass
 from typing import TYPE_CHECKING
 
 import paddle
+from paddle.base import core
 from paddle.base.framework import (
     _current_expected_place,
 )
@@ -27,6 +28,7 @@ from paddle.distributed.communication.group import is_initialized
 from paddle.distributed.fleet.utils.log_util import logger
 
 from .metadata import LocalTensorIndex, LocalTensorMetadata
+from .save_state_dict import clear_async_save_task_queue
 from .utils import (
     compute_local_shape_and_global_offset,
     flatten_state_dict,
@@ -72,6 +74,26 @@ def get_checkpoint_files(path, use_cache=True):
     return (metadata_files, local_data_files)
 
 
+def load_checkpoint_file(file_path, offload):
+    """
+    Load the tensors of a checkpoint file, written by paddle.save or by the
+    async save.
+    """
+    if core.is_tensors_file(file_path):
+        place = paddle.CPUPlace() if offload else _current_expected_place()
+        return {
+            key: paddle.Tensor(value=value, place=place)
+            for key, value in core.load_tensors(file_path).items()
+        }
+    if offload:
+        state_dict_numpy = paddle.load(file_path, return_numpy=True)
+        return {
+            key: paddle.to_tensor(value, place=paddle.CPUPlace())
+            for key, value in state_dict_numpy.items()
+        }
+    return paddle.load(file_path)
+
+
 def get_rank_to_files(
     metadata_list, local_data_files, state_dict, process_group, use_dist
 ):
@@ -521,6 +543,9 @@ def load_state_dict(
             # Init the default global process group
             paddle.distributed.init_parallel_env()
 
+        # the files of the async save of this rank are complete
+        clear_async_save_task_queue()
+
         if use_dist:
             # sync to avoid some ranks not write path yet
             paddle.distributed.barrier(process_group)
@@ -567,16 +592,9 @@ def load_state_dict(
 
         source_state_dict = {}
         for file in local_load_files:
-            if offload:
-                state_dict_numpy = paddle.load(
-                    os.path.join(path, file), return_numpy=True
-                )
-                source_state_dict[file] = {
-                    key: paddle.to_tensor(value, place=paddle.CPUPlace())
-                    for key, value in state_dict_numpy.items()
-                }
-            else:
-                source_state_dict[file] = paddle.load(os.path.join(path, file))
+            source_state_dict[file] = load_checkpoint_file(
+                os.path.join(path, file), offload
+            )
 
         _load_state_dict(
             flat_state_dict,
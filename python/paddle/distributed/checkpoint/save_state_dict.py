@@ -13,12 +13,11 @@
 # limitations under the License.
 from __future__ import annotations
 
-import multiprocessing
 import os
-import time
 from typing import TYPE_CHECKING
 
 import paddle
+from paddle.base import core
 from paddle.distributed.communication.group import is_initialized
 from paddle.distributed.fleet.utils.log_util import logger
 
@@ -32,48 +31,61 @@ if TYPE_CHECKING:
     from paddle import Tensor
     from paddle.distributed.collective import Group
 
-async_save_queue = []
+# The files of each rank in an async save, they are written in parallel.
+ASYNC_SAVE_NUM_FILES = 4
+_async_checkpoint_writer = None
 
 
-def check_exitcode(task):
-    exitcode = task.exitcode
-    if exitcode != 0:
-        logger.error(
-            f"Error: save ckpt process failed with exitcode {exitcode}!!!"
+def get_async_checkpoint_writer():
+    global _async_checkpoint_writer
+    if _async_checkpoint_writer is None:
+        _async_checkpoint_writer = core.AsyncCheckpointWriter(
+            ASYNC_SAVE_NUM_FILES
         )
+    return _async_checkpoint_writer
 
 
 def clear_async_save_task_queue():
     """
     wait until all async save task to be done.
     """
-    while len(async_save_queue) > 0:
-        task = async_save_queue.pop()
-        if task and task.is_alive():
-            task.join(timeout=60)
-            if task.is_alive():
-                logger.error("Error: save ckpt process timeout!!!")
-                async_save_queue.append(task)
-            else:
-                check_exitcode(task)
-        else:
-            check_exitcode(task)
+    if _async_checkpoint_writer is not None:
+        _async_checkpoint_writer.wait()
 
 
-def copy_dict_to_cpu(nested_dict):
+def assign_files(local_state_dict, file_name, num_files):
     """
-    Copy the paddle.Tensor objects in the nested dictionary to the CPU and return a new dict.
+    Assign the tensors to at most num_files files of similar sizes, the file of
+    the k-th is named {rank}_{unique_id}_{k}.distcp after file_name.
     """
-    new_dict = {}
-    for key, value in nested_dict.items():
-        if isinstance(value, paddle.Tensor):
-            new_dict[key] = value.cpu()
-            paddle.device.synchronize()
-        elif isinstance(value, dict):
-            new_dict[key] = copy_dict_to_cpu(value)
-        else:
-            new_dict[key] = value
-    return new_dict
+    sizes = {}
+    for key, val in local_state_dict.items():
+        sizes[key] = int(val._numel()) * val.element_size()
+    num_files = max(1, min(num_files, len(local_state_dict)))
+    file_sizes = [0] * num_files
+    key_to_file = {}
+    prefix = file_name.split(".")[0]
+    for key in sorted(sizes, key=lambda k: sizes[k], reverse=True):
+        k = file_sizes.index(min(file_sizes))
+        file_sizes[k] += sizes[key]
+        key_to_file[key] = f"{prefix}_{k}.distcp"
+    return key_to_file
+
+
+def save_by_files(local_state_dict, path, local_file_names):
+    """
+    Snapshot the tensors and write the files in background threads.
+    """
+    files = {}
+    for key, val in local_state_dict.items():
+        files.setdefault(local_file_names[key], []).append((key, val))
+    writer = get_async_checkpoint_writer()
+    for file_name, items in files.items():
+        writer.save(
+            [key for key, _ in items],
+            [val for _, val in items],
+            os.path.join(path, file_name),
+        )
 
 
 def check_file_name(file_name, process_group):
@@ -157,7 +169,7 @@ def save_state_dict(
         path(str): The directory to save state_dict.
         process_group(paddle.distributed.collective.Group): ProcessGroup to be used for cross-rank synchronization. Use the default process group which contains all cards.
         coordinator_rank(int): The rank used to save non distributed values. Rank0 is used by default.
-        async_save(bool): Async save the state_dict, default is False.
+        async_save(bool): Async save the state_dict, default is False. The tensors are copied into the host memory, then the files are written in background threads while the training goes on. Call clear_async_save_task_queue to wait for them.
 
     Examples:
         .. code-block:: python
@@ -197,7 +209,11 @@ def save_state_dict(
         file_name = ""
         while True:
             file_name = f"{paddle.distributed.get_rank()}_{unique_id}.distcp"
-            if not os.path.exists(os.path.join(path, file_name)):
+            if not os.path.exists(
+                os.path.join(path, file_name)
+            ) and not os.path.exists(
+                os.path.join(path, file_name.replace(".", "_0.", 1))
+            ):
                 break
             unique_id += 1
         logger.debug(f"file_name:{file_name}")
@@ -244,9 +260,16 @@ def save_state_dict(
                 local_state_dict_metadata[key] = LocalTensorMetadata(
                     global_offset, local_shape, local_tenosr_dtype
                 )
-                local_storage_metadata[
-                    LocalTensorIndex(key, tuple(global_offset))
-                ] = file_name
+
+        local_file_names = {key: file_name for key in local_state_dict}
+        if async_save:
+            local_file_names = assign_files(
+                local_state_dict, file_name, ASYNC_SAVE_NUM_FILES
+            )
+        for key, local_tensor_metadata in local_state_dict_metadata.items():
+            local_storage_metadata[
+                LocalTensorIndex(key, tuple(local_tensor_metadata.global_offset))
+            ] = local_file_names[key]
 
         global_state_dict_metadata = []
         global_storage_metadata = []
@@ -282,30 +305,7 @@ def save_state_dict(
         )
 
         if async_save:
-            cpu_state_dict = copy_dict_to_cpu(local_state_dict)
             clear_async_save_task_queue()
-
-            attempt = 0
-            ctx = multiprocessing.get_context("spawn")
-
-            def start_process():
-                nonlocal attempt
-                try:
-                    p = ctx.Process(
-                        target=paddle.save,
-                        args=(cpu_state_dict, os.path.join(path, file_name)),
-                    )
-                    p.start()
-                    return p
-                except Exception as e:
-                    logger.error(
-                        f"Attempt {attempt + 1} failed with error: {e}"
-                    )
-                    attempt += 1
-                    time.sleep(1)
-                    return start_process()
-
-            p = start_process()
-            async_save_queue.append(p)
+            save_by_files(local_state_dict, path, local_file_names)
         else:
             paddle.save(local_state_dict, os.path.join(path, file_name))
@@ -0,0 +1,79 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+from __future__ import annotations
+
+from typing import Any
+
+from paddle.framework import core
+
+
+def _percentile_us(buckets: list[int], count: int, q: float) -> float:
+    # the upper bound of the bucket holding the q-th latency, the bucket i
+    # holds the latencies in [2^i, 2^(i+1)) microseconds
+    rank = q * count
+    seen = 0
+    for i, bucket in enumerate(buckets):
+        seen += bucket
+        if seen >= rank:
+            return float(2 ** (i + 1))
+    return float(2 ** len(buckets))
+
+
+def get_comm_stats() -> list[dict[str, Any]]:
+    """
+    Get the latency histograms of the sampled collectives of this rank, one
+    for each group and type of collective. One in
+    ``FLAGS_comm_stats_sample_interval`` collectives is timed with events on
+    its stream, the samples are also recorded as communication events of
+    ``paddle.profiler`` while it runs.
+
+    Returns:
+        list[dict]: ``group_key``, ``op``, ``count``, ``bytes``,
+        ``total_us``, ``min_us``, ``max_us``, ``buckets`` (the counts of the
+        latencies in [2^i, 2^(i+1)) microseconds), and the estimated
+        ``p50_us`` and ``p99_us``.
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env: DISTRIBUTED)
+            >>> import paddle
+            >>> import paddle.distributed as dist
+            >>> from paddle.distributed.communication.comm_stats import get_comm_stats
+
+            >>> dist.init_parallel_env()
+            >>> data = paddle.ones([1024])
+            >>> for _ in range(100):
+            ...     dist.all_reduce(data)
+            >>> for stats in get_comm_stats():
+            ...     print(stats['op'], stats['count'], stats['p99_us'])
+    """
+    if not hasattr(core, "get_comm_stats"):
+        return []
+    all_stats = core.get_comm_stats()
+    for stats in all_stats:
+        stats["p50_us"] = _percentile_us(stats["buckets"], stats["count"], 0.5)
+        stats["p99_us"] = _percentile_us(
+            stats["buckets"], stats["count"], 0.99
+        )
+    return all_stats
+
+
+def reset_comm_stats() -> None:
+    """
+    Clear the latency histograms of the collectives of this rank.
+    """
+    if hasattr(core, "reset_comm_stats"):
+        core.reset_comm_stats()
@@ -213,6 +213,19 @@ class Communicator:
             table_id = self.send_ctx_[var_name].table_id()
         self.communicator_.push_sparse_param(var_name, table_id, scope)
 
+    def get_send_stats(self):
+        """
+        Get the send metrics of every send context: sends, merged grads,
+        rpc latency, queue depth and the adaptive merge window and send
+        concurrency (see FLAGS_communicator_adaptive_send).
+
+        Returns:
+            dict, send context name to a dict of metric name to value.
+        """
+        if self.communicator_ is None:
+            return {}
+        return self.communicator_.get_send_stats()
+
 
 class FLCommunicator(Communicator):  # only for coordinator
     def __init__(self, ps_hosts, kwargs=None):
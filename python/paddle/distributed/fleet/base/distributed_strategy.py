@@ -760,6 +760,7 @@ class DistributedStrategy:
             'sparse_load_filter_slots',
             'sparse_save_filter_slots',
             'sparse_zero_init',
+            'sparse_embedx_storage',
             'use_gpu_graph',
         ]
         support_sparse_table_class = [
@@ -987,6 +988,9 @@ class DistributedStrategy:
             table_data.accessor.ctr_accessor_param.zero_init = config.get(
                 'sparse_zero_init', True
             )
+            table_data.accessor.ctr_accessor_param.embedx_storage = (
+                config.get('sparse_embedx_storage', 'fp32')
+            )
             # gpu graph mode set zero_init False for sparse adam init
             if table_data.use_gpu_graph is True:
                 table_data.accessor.ctr_accessor_param.zero_init = False
@@ -14,10 +14,15 @@
 
 from __future__ import annotations
 
-from typing import Any
+from typing import TYPE_CHECKING, Any
+
+import numpy as np
 
 from paddle.base import core
 
+if TYPE_CHECKING:
+    import numpy.typing as npt
+
 __all__ = []
 
 
@@ -102,3 +107,27 @@ class TreeIndex(Index):
         return self._layerwise_sampler.sample(
             user_input, index_input, with_hierarchy
         )
+
+    def layerwise_sample_batch(
+        self,
+        user_input: npt.ArrayLike,
+        index_input: npt.ArrayLike,
+        with_hierarchy: bool = False,
+        share_negatives: bool = False,
+        num_threads: int = 1,
+    ) -> npt.NDArray[np.uint64]:
+        """
+        Same rows as layerwise_sample, sampled on num_threads threads into
+        one uint64 array of shape [len(index_input) * rows, user features + 2].
+        With share_negatives, the inputs sampled by one thread share the
+        negatives drawn for each layer, except those equal to their positive.
+        """
+        if self._layerwise_sampler is None:
+            raise ValueError("please init layerwise_sampler first.")
+        return self._layerwise_sampler.sample_batch(
+            np.asarray(user_input, dtype=np.uint64),
+            np.asarray(index_input, dtype=np.uint64),
+            with_hierarchy,
+            share_negatives,
+            num_threads,
+        )
@@ -27,6 +27,7 @@ if TYPE_CHECKING:
     class _Kernel(TypedDict):
         enable: bool
         tuning_range: list[int] | tuple[int, int]
+        cache_file: NotRequired[str]
 
     class _Layout(TypedDict):
         enable: bool
@@ -54,6 +55,9 @@ def set_config(config: _ConfigKernel | str | None = None) -> None:
 
     - enable(bool): Whether to enable kernel tuning.
     - tuning_range(list): Start and end iteration for auto-tuning. Default: [1, 10].
+    - cache_file(str): The file to load the tuned algorithms from when tuning
+      starts, and to merge them into when tuning ends. It can be shared by the
+      ranks of a job. Default: "", the results are not persisted.
 
     2. layout: When it is enabled, the best data layout such as NCHW or NHWC will be
     determined based on the device and data type. When the origin layout setting is
@@ -144,6 +148,16 @@ def set_config(config: _ConfigKernel | str | None = None) -> None:
                     "The auto-tuning configuration of the kernel is incorrect."
                     "The `tuning_range` should be list. Use default parameter instead."
                 )
+        if "cache_file" in kernel_config:
+            if isinstance(kernel_config['cache_file'], str):
+                paddle.set_flags(
+                    {'FLAGS_autotune_cache_file': kernel_config['cache_file']}
+                )
+            else:
+                warnings.warn(
+                    "The auto-tuning configuration of the kernel is incorrect."
+                    "The `cache_file` should be str. Use default parameter instead."
+                )
     if "layout" in config_dict:
         layout_config = config_dict["layout"]
         if "enable" in layout_config:
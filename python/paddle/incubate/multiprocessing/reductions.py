@@ -191,6 +191,12 @@ def _rebuild_cuda_tensor(
     return lodtensor
 
 
+def _rebuild_cuda_pooled_tensor(cls, *metadata):
+    # The block is a copy owned by this receiver, it goes back to the pool
+    # of the sender once the tensor is freed, so no cache is needed.
+    return cls._new_shared_cuda_pooled(metadata)
+
+
 def _rebuild_lodtensor_empty(cls):
     # TODO: check if tensor initialized
     # TODO: handle the dtype of empty tensor
@@ -224,8 +230,14 @@ def _reduce_lodtensor(lodtensor):
         lodtensor._shared_incref()
         # TODO, maintain reference for lodtensor
     elif lodtensor._place().is_gpu_place():
-        metadata = lodtensor._share_cuda()
-        rebuild = _rebuild_cuda_tensor
+        if paddle.base.core.globals()["FLAGS_cuda_ipc_pool_segment_size_mb"]:
+            # The receiver gets a copy in a pooled segment instead of the
+            # memory of the sender, each segment is opened only once.
+            metadata = lodtensor._share_cuda_pooled()
+            rebuild = _rebuild_cuda_pooled_tensor
+        else:
+            metadata = lodtensor._share_cuda()
+            rebuild = _rebuild_cuda_tensor
     else:
         raise RuntimeError("We only support pass cpu/gpu lodtensor for now!")
 
@@ -40,6 +40,7 @@ from .fused_transformer import (
     fused_multi_transformer,
 )
 from .masked_multihead_attention import masked_multihead_attention
+from .moe_dispatch import moe_combine, moe_gate_dispatch
 from .swiglu import swiglu
 from .variable_length_memory_efficient_attention import (
     variable_length_memory_efficient_attention,
@@ -64,4 +65,6 @@ __all__ = [
     "blha_get_max_len",
     "block_multihead_attention",
     "swiglu",
+    "moe_gate_dispatch",
+    "moe_combine",
 ]
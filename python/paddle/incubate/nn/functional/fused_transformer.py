@@ -1166,7 +1166,10 @@ def fused_multi_transformer(
             The shape is `[2, bsz, 1, seq\_len, head\_dim]`. Default None.
         time_step (Tensor, optional): The time step tensor for the generation model.
             Which used in decode stage, to represent the time step, that is, the real seq_len of CacheKV.
-            The shape is `[1]`, must be in CPUPlace. Default None.
+            The shape is `[1]`, must be in CPUPlace. With a seq_len greater than 1 in decode stage, the
+            tokens are the drafts of speculative decoding: they are written to CacheKV after time_step
+            and each attends to the tokens before it. To reject drafts, pass the accepted length as the
+            time_step of the next step. Default None.
         attn_mask (Tensor, optional):  A tensor used in multi-head attention to prevents attention to
             some unwanted positions, usually the paddings or the subsequent positions. It is a tensor
             with shape `[batch_size, 1, sequence_length, sequence_length]`. Default None.
@@ -0,0 +1,133 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+from __future__ import annotations
+
+from typing import TYPE_CHECKING
+
+from paddle import _C_ops
+
+from ....framework import in_dynamic_or_pir_mode
+
+if TYPE_CHECKING:
+    from paddle import Tensor
+
+
+def moe_gate_dispatch(
+    x: Tensor,
+    gate_logits: Tensor,
+    k: int,
+    capacity: int,
+    use_pad: bool = True,
+    name: str | None = None,
+) -> tuple[Tensor, Tensor, Tensor, Tensor, Tensor]:
+    """
+    Selects the top ``k`` experts of every token and permutes the tokens into
+    expert contiguous buffers in one fused pass.
+
+    The k-th choices of all the tokens are placed before the (k+1)-th ones, so
+    when more than ``capacity`` tokens choose an expert, the choices with the
+    lowest priority are dropped. A dropped choice gets a combine weight of 0
+    and a scatter index of -1.
+
+    Args:
+        x (Tensor): The tokens with shape [tokens, hidden_size], the data type
+            is float32, float64, float16 or bfloat16.
+        gate_logits (Tensor): The float32 gate scores with shape
+            [tokens, num_experts], usually the output of softmax.
+        k (int): The number of experts selected by every token, at most 16.
+        capacity (int): The maximum number of tokens of every expert.
+        use_pad (bool, optional): Whether to pad the buffer of every expert to
+            ``capacity``, only True is supported now. Default: True.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        - y (Tensor), the permuted tokens with shape [num_experts, capacity, hidden_size].
+        - combine_weights (Tensor), the float32 gate scores of the selected experts with shape [tokens, k].
+        - scatter_index (Tensor), the int32 rows of the flattened ``y`` the choices are placed to, with shape [k, tokens].
+        - expert_offset (Tensor), the int64 inclusive prefix sum of the number of tokens of the experts, with shape [num_experts].
+        - expert_id (Tensor), the int32 selected experts with shape [tokens, k].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> paddle.set_device('gpu')
+            >>> x = paddle.randn([8, 16])
+            >>> gate_logits = paddle.nn.functional.softmax(paddle.randn([8, 4]))
+            >>> y, weights, index, offset, expert_id = F.moe_gate_dispatch(
+            ...     x, gate_logits, k=2, capacity=8
+            ... )
+            >>> print(y.shape)
+            [4, 8, 16]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.moe_gate_dispatch(x, gate_logits, k, capacity, use_pad)
+    raise NotImplementedError(
+        "moe_gate_dispatch is only supported in dynamic graph mode and PIR."
+    )
+
+
+def moe_combine(
+    x: Tensor,
+    combine_weights: Tensor,
+    scatter_index: Tensor,
+    name: str | None = None,
+) -> Tensor:
+    """
+    Gathers the expert outputs of every token back and sums them weighted by
+    the gate scores in one fused pass, it is the inverse of
+    :ref:`moe_gate_dispatch`.
+
+    .. math::
+
+        y[s] = \\sum_{i} combine\\_weights[s][i] * x[scatter\\_index[s][i]]
+
+    The choices with a negative scatter index are skipped.
+
+    Args:
+        x (Tensor): The expert outputs with shape [rows, hidden_size], e.g. the
+            output of the experts reshaped to [num_experts * capacity, hidden_size].
+        combine_weights (Tensor): The float32 weights with shape [tokens, k].
+        scatter_index (Tensor): The int32 rows of ``x`` with shape [tokens, k],
+            i.e. the transposed ``scatter_index`` of :ref:`moe_gate_dispatch`.
+        name (str, optional): For details, please refer to :ref:`api_guide_Name`. Generally, no setting is required. Default: None.
+
+    Returns:
+        Tensor, the combined tokens with shape [tokens, hidden_size].
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> import paddle.incubate.nn.functional as F
+            >>> paddle.set_device('gpu')
+            >>> x = paddle.randn([8, 16])
+            >>> gate_logits = paddle.nn.functional.softmax(paddle.randn([8, 4]))
+            >>> y, weights, index, _, _ = F.moe_gate_dispatch(
+            ...     x, gate_logits, k=2, capacity=8
+            ... )
+            >>> out = F.moe_combine(
+            ...     y.reshape([-1, 16]), weights, index.transpose([1, 0])
+            ... )
+            >>> print(out.shape)
+            [8, 16]
+    """
+    if in_dynamic_or_pir_mode():
+        return _C_ops.moe_combine(x, combine_weights, scatter_index)
+    raise NotImplementedError(
+        "moe_combine is only supported in dynamic graph mode and PIR."
+    )
@@ -14,8 +14,11 @@
 
 from __future__ import annotations
 
+import hashlib
+import json
 import logging
 import os
+import tempfile
 from typing import TYPE_CHECKING, Any, TypedDict
 
 import numpy as np
@@ -38,8 +41,11 @@ if TYPE_CHECKING:
 
     from paddle import Tensor
 
-    class _WhiteList(TypedDict):
+    class _ConvertToMixedPrecisionKwargs(TypedDict, total=False):
         white_list: set[str]
+        calibration_data: list[dict[str, npt.NDArray[Any]]]
+        tolerance: float
+        cache_file: str
 
 
 _logger = get_logger(
@@ -97,7 +103,7 @@ def convert_to_mixed_precision(
     backend: PlaceType,
     keep_io_types: bool = True,
     black_list: set[str] = set(),
-    **kwargs: Unpack[_WhiteList],
+    **kwargs: Unpack[_ConvertToMixedPrecisionKwargs],
 ) -> None:
     '''
     Convert a fp32 model to mixed precision model.
@@ -112,8 +118,18 @@ def convert_to_mixed_precision(
         keep_io_types: Whether the model input and output dtype remains unchanged.
             Default is True.
         black_list: Operators that do not convert precision.
-        kwargs: Supported keys including 'white_list'.
+        kwargs: Supported keys including 'white_list', 'calibration_data',
+            'tolerance' and 'cache_file'.
             - white_list: Operators that do convert precision.
+            - calibration_data: A list of feed dicts. If given, the model is
+              converted with the black and white lists first, then the fp32
+              and mixed models are run on these batches, and the types of the
+              operators whose outputs deviate most are kept in fp32.
+            - tolerance: The relative error an operator may add to its
+              outputs before its type is kept in fp32. Default is 1e-2.
+            - cache_file: The json file the selected operator types are
+              cached in, keyed by the model and the conversion options.
+              Default is a file next to mixed_model_file.
     '''
     if backend is PlaceType.GPU and not core.is_compiled_with_cuda():
         _logger.error(
@@ -132,6 +148,20 @@ def convert_to_mixed_precision(
     if not os.path.exists(mixed_params_dirname):
         os.makedirs(mixed_params_dirname)
     white_list = kwargs.get('white_list', set())
+    calibration_data = kwargs.get('calibration_data', None)
+    if calibration_data:
+        black_list = black_list | _select_fp32_ops(
+            model_file,
+            params_file,
+            mixed_model_file,
+            mixed_precision,
+            backend,
+            black_list,
+            white_list,
+            calibration_data,
+            kwargs.get('tolerance', 1e-2),
+            kwargs.get('cache_file', None),
+        )
     convert_to_mixed_precision_bind(
         model_file,
         params_file,
@@ -145,5 +175,174 @@ def convert_to_mixed_precision(
     )
 
 
+def _model_digest(
+    model_file: str,
+    params_file: str,
+    mixed_precision: PrecisionType,
+    backend: PlaceType,
+    black_list: set[str],
+    white_list: set[str],
+    tolerance: float,
+) -> str:
+    digest = hashlib.sha256()
+    for path in (model_file, params_file):
+        if path and os.path.exists(path):
+            with open(path, 'rb') as f:
+                for chunk in iter(lambda: f.read(1 << 20), b''):
+                    digest.update(chunk)
+    options = [
+        str(mixed_precision),
+        str(backend),
+        sorted(black_list),
+        sorted(white_list),
+        tolerance,
+    ]
+    digest.update(json.dumps(options).encode())
+    return digest.hexdigest()
+
+
+def _run_calibration(
+    model_file: str,
+    params_file: str,
+    place: paddle.CUDAPlace | paddle.XPUPlace,
+    calibration_data: list[dict[str, npt.NDArray[Any]]],
+    var_names: list[str] | None,
+) -> tuple[paddle.static.Program, list[str], list[list[npt.NDArray[Any]]]]:
+    exe = paddle.static.Executor(place)
+    with paddle.static.scope_guard(paddle.static.Scope()):
+        program, _, _ = paddle.static.load_inference_model(
+            os.path.dirname(model_file),
+            exe,
+            model_filename=os.path.basename(model_file),
+            params_filename=os.path.basename(params_file)
+            if params_file
+            else None,
+        )
+        block = program.global_block()
+        if var_names is None:
+            var_names = [
+                var.name
+                for var in block.vars.values()
+                if not var.persistable
+                and var.desc.type() == core.VarDesc.VarType.DENSE_TENSOR
+                and var.dtype == core.VarDesc.VarType.FP32
+            ]
+        else:
+            var_names = [name for name in var_names if block.has_var(name)]
+        outputs = [
+            exe.run(program, feed=feed, fetch_list=var_names)
+            for feed in calibration_data
+        ]
+    return program, var_names, outputs
+
+
+def _select_fp32_ops(
+    model_file: str,
+    params_file: str,
+    mixed_model_file: str,
+    mixed_precision: PrecisionType,
+    backend: PlaceType,
+    black_list: set[str],
+    white_list: set[str],
+    calibration_data: list[dict[str, npt.NDArray[Any]]],
+    tolerance: float,
+    cache_file: str | None,
+) -> set[str]:
+    '''
+    Select the operator types to keep in fp32 by the error every operator
+    adds to its outputs on the calibration data, the selection is cached per
+    model and conversion options.
+    '''
+    if cache_file is None:
+        cache_file = os.path.join(
+            os.path.dirname(mixed_model_file), 'mixed_precision_cache.json'
+        )
+    key = _model_digest(
+        model_file,
+        params_file,
+        mixed_precision,
+        backend,
+        black_list,
+        white_list,
+        tolerance,
+    )
+    cache = {}
+    if os.path.exists(cache_file):
+        with open(cache_file) as f:
+            cache = json.load(f)
+    if key in cache:
+        _logger.info(f"Use the fp32 operators cached in {cache_file}.")
+        return set(cache[key])
+
+    if backend is PlaceType.GPU:
+        place = paddle.CUDAPlace(0)
+    elif backend is PlaceType.XPU:
+        place = paddle.XPUPlace(0)
+    else:
+        raise ValueError(
+            "calibration_data of convert_to_mixed_precision only supports "
+            f"PlaceType.GPU and PlaceType.XPU, but got {backend}."
+        )
+
+    def relative_error(
+        expected: npt.NDArray[Any], actual: npt.NDArray[Any]
+    ) -> float:
+        expected = np.asarray(expected, dtype=np.float32)
+        actual = np.asarray(actual, dtype=np.float32)
+        if expected.shape != actual.shape or expected.size == 0:
+            return 0.0
+        scale = np.abs(expected).mean() + 1e-6
+        return float(np.abs(expected - actual).mean() / scale)
+
+    selected = set()
+    with paddle.pir_utils.OldIrGuard(), tempfile.TemporaryDirectory() as tmp:
+        program, var_names, expected = _run_calibration(
+            model_file, params_file, place, calibration_data, None
+        )
+        mixed_file = os.path.join(tmp, 'mixed.pdmodel')
+        mixed_params = os.path.join(tmp, 'mixed.pdiparams')
+        convert_to_mixed_precision_bind(
+            model_file,
+            params_file,
+            mixed_file,
+            mixed_params,
+            mixed_precision,
+            backend,
+            True,
+            black_list,
+            white_list,
+        )
+        _, mixed_names, actual = _run_calibration(
+            mixed_file, mixed_params, place, calibration_data, var_names
+        )
+
+        # The error of a variable is the worst over the calibration batches,
+        # an operator is charged only the error it adds to its inputs.
+        errors = {}
+        for batch, mixed_batch in zip(expected, actual):
+            values = dict(zip(var_names, batch))
+            for name, value in zip(mixed_names, mixed_batch):
+                error = relative_error(values[name], value)
+                errors[name] = max(errors.get(name, 0.0), error)
+        for op in program.global_block().ops:
+            if op.type in white_list or op.type in ('feed', 'fetch'):
+                continue
+            input_error = max(
+                [errors.get(name, 0.0) for name in op.input_arg_names],
+                default=0.0,
+            )
+            for name in op.output_arg_names:
+                if name in errors and errors[name] - input_error > tolerance:
+                    selected.add(op.type)
+                    break
+
+    _logger.info(f"Keep the operators {sorted(selected)} in fp32.")
+    cache[key] = sorted(selected)
+    os.makedirs(os.path.dirname(os.path.abspath(cache_file)), exist_ok=True)
+    with open(cache_file, 'w') as f:
+        json.dump(cache, f, indent=2)
+    return selected
+
+
 Tensor.copy_from_cpu = tensor_copy_from_cpu
 Tensor.share_external_data = tensor_share_external_data
@@ -43,6 +43,7 @@ from .worker import (
     _DatasetKind,
     _IterableDatasetStopIteration,
     _ResumeIteration,
+    _ShmRingBatch,
     _worker_loop,
     _WorkerException,
 )
@@ -604,6 +605,8 @@ class _DataLoaderIterMultiProcess(_DataLoaderIterBase):
                         q.close()
             finally:
                 core._erase_process_pids(id(self))
+                if self._use_shared_memory:
+                    core._clear_shm_ring()
                 self._shutdown = True
 
     def _thread_loop(self, legacy_expected_place):
@@ -629,6 +632,10 @@ class _DataLoaderIterMultiProcess(_DataLoaderIterBase):
                         # pack as DenseTensorArray
                         array = core.DenseTensorArray()
                         if self._use_shared_memory:
+                            if isinstance(batch, _ShmRingBatch):
+                                batch = core._unpack_tensors_from_shm_ring(
+                                    batch.meta, self._pin_memory
+                                )
                             for tensor in batch:
                                 array.append(tensor)
                         else:
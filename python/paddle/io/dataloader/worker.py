@@ -45,6 +45,13 @@ class _ResumeIteration:
     pass
 
 
+class _ShmRingBatch:
+    # the tensors of a batch packed into a shm segment reused by the worker,
+    # see FLAGS_dataloader_shm_ring_size
+    def __init__(self, meta):
+        self.meta = meta
+
+
 class _DatasetKind:
     MAP = 0
     ITER = 1
@@ -406,7 +413,13 @@ def _worker_loop(
                         )
                         for b in batch
                     ]
-                    out_queue.put((idx, tensor_list, structure))
+                    ring_meta = core._pack_tensors_to_shm_ring(tensor_list)
+                    if ring_meta is not None:
+                        out_queue.put(
+                            (idx, _ShmRingBatch(ring_meta), structure)
+                        )
+                    else:
+                        out_queue.put((idx, tensor_list, structure))
                 else:
                     out_queue.put((idx, batch, structure))
     except KeyboardInterrupt:
@@ -73,6 +73,8 @@ class SummaryView(Enum):
     - **SummaryView.MemoryManipulationView** : The memory manipulation summary view.
 
     - **SummaryView.UDFView** : The user defined summary view.
+
+    - **SummaryView.RooflineView** : The operator roofline summary view, needs `with_flops` enabled.
     """
 
     DeviceView = 0
@@ -84,6 +86,7 @@ class SummaryView(Enum):
     MemoryView = 6
     MemoryManipulationView = 7
     UDFView = 8
+    RooflineView = 9
 
 
 class ProfilerState(Enum):
@@ -887,6 +890,8 @@ class Profiler:
         thread_sep: bool = False,
         time_unit: Literal['s', 'ms', 'us', 'ns'] = 'ms',
         views: SummaryView | list[SummaryView] | None = None,
+        peak_flops: float | None = None,
+        peak_bandwidth: float | None = None,
     ) -> None:
         r"""
         Print the Summary table. Currently support overview, model, distributed, operator, memory manipulation and user-defined summary.
@@ -897,6 +902,8 @@ class Profiler:
             thread_sep(bool, optional): print op table each thread, default value is False.
             time_unit(str, optional): time unit for display, can be chosen from ['s', 'ms', 'us', 'ns'], default value is 'ms'.
             views(SummaryView|list[SummaryView], optional): summary tables to print, default to None means all views to be printed.
+            peak_flops(float, optional): peak FLOPS of the device, used with `peak_bandwidth` to classify each operator of the roofline view as compute or memory bound, default value is None.
+            peak_bandwidth(float, optional): peak memory bandwidth of the device in bytes per second, default value is None.
 
         Examples:
             .. code-block:: python
@@ -932,6 +939,8 @@ class Profiler:
                     thread_sep=thread_sep,
                     time_unit=time_unit,
                     views=views,
+                    peak_flops=peak_flops,
+                    peak_bandwidth=peak_bandwidth,
                 )
             )
 
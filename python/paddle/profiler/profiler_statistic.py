@@ -16,7 +16,7 @@ import re
 from enum import Enum
 
 from paddle.base.core import TracerEventType, TracerMemEventType
-from paddle.utils.flops import flops
+from paddle.utils.flops import flops, memory_bytes
 
 from .statistic_helper import (
     intersection_ranges,
@@ -105,6 +105,7 @@ class HostStatisticNode:
         self.general_gpu_time = 0  # besides kernel, include time of gpu events like memcpy and memset
         self.self_general_gpu_time = 0
         self.flops = 0
+        self.memory_bytes = 0
 
     def cal_flops(self):
         if self.hostnode.type == TracerEventType.Operator:
@@ -115,6 +116,13 @@ class HostStatisticNode:
                     self.hostnode.input_shapes,
                     self.hostnode.attributes,
                 )
+                if self.flops > 0:
+                    self.memory_bytes = memory_bytes(
+                        op_name,
+                        self.hostnode.input_shapes,
+                        self.hostnode.attributes,
+                        getattr(self.hostnode, 'dtypes', None),
+                    )
 
     def cal_statistic(self):
         self.cpu_time = self.hostnode.end_ns - self.hostnode.start_ns
@@ -127,6 +135,7 @@ class HostStatisticNode:
             self.general_gpu_time += child.general_gpu_time
             self.self_cpu_time -= child.end_ns - child.start_ns
             self.flops += child.flops
+            self.memory_bytes += child.memory_bytes
 
         for rt in self.runtime_node:
             rt.cal_statistic()
@@ -521,11 +530,16 @@ class EventSummary:
             self.min_general_gpu_time = float('inf')
             self.max_general_gpu_time = 0
             self._flops = 0
+            self._memory_bytes = 0
 
         @property
         def flops(self):
             return self._flops
 
+        @property
+        def memory_bytes(self):
+            return self._memory_bytes
+
         @property
         def avg_cpu_time(self):
             return self.cpu_time / self.call
@@ -565,6 +579,9 @@ class EventSummary:
         def add_flops(self, flops):
             self._flops += flops
 
+        def add_memory_bytes(self, memory_bytes):
+            self._memory_bytes += memory_bytes
+
         def add_item(self, node):
             raise NotImplementedError
 
@@ -580,6 +597,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_memory_bytes(node.memory_bytes)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -602,6 +620,7 @@ class EventSummary:
             self.add_gpu_time(node.gpu_time)
             self.add_general_gpu_time(node.general_gpu_time)
             self.add_flops(node.flops)
+            self.add_memory_bytes(node.memory_bytes)
             for child in node.children_node:
                 if child.type != TracerEventType.Operator:
                     if child.name not in self.operator_inners:
@@ -880,6 +899,8 @@ def _build_table(
     row_limit=100,
     max_src_column_width=75,
     views=None,
+    peak_flops=None,
+    peak_bandwidth=None,
 ):
     from .profiler import SummaryView
 
@@ -1598,6 +1619,89 @@ def _build_table(
             append('')
             append('')
 
+    if views is None or SummaryView.RooflineView in views:
+        # ----- Print Operator Roofline Report ----- #
+        roofline_items = [
+            item
+            for item in statistic_data.event_summary.items.values()
+            if item.flops > 0 and item.memory_bytes > 0 and item.gpu_time > 0
+        ]
+        if roofline_items:
+            all_row_values = []
+            has_peak = bool(peak_flops) and bool(peak_bandwidth)
+            for item in sorted(
+                roofline_items, key=lambda x: x.gpu_time, reverse=True
+            ):
+                intensity = item.flops / item.memory_bytes
+                achieved_flops = item.flops * 1e9 / item.gpu_time
+                achieved_bandwidth = item.memory_bytes * 1e9 / item.gpu_time
+                if has_peak:
+                    ridge = peak_flops / peak_bandwidth
+                    bound = 'Compute' if intensity >= ridge else 'Memory'
+                    roof = min(peak_flops, intensity * peak_bandwidth)
+                    efficiency = format_ratio(achieved_flops / roof)
+                else:
+                    bound = '-'
+                    efficiency = '-'
+                row_values = [
+                    item.name,
+                    item.call,
+                    format_time(item.gpu_time, unit=time_unit),
+                    _format_large_number(item.flops),
+                    _format_large_number(item.memory_bytes),
+                    f'{intensity:.2f}',
+                    _format_large_number(achieved_flops),
+                    _format_large_number(achieved_bandwidth),
+                    bound,
+                    efficiency,
+                ]
+                all_row_values.append(row_values)
+
+            headers = [
+                'Name',
+                'Calls',
+                'GPU Total',
+                'FLOPs',
+                'Bytes',
+                'FLOP/Byte',
+                'FLOPS',
+                'Bytes/s',
+                'Bound',
+                'Efficiency(%)',
+            ]
+            name_column_width = 52
+            row_format_list = [""]
+            header_sep_list = [""]
+            line_length_list = [-SPACING_SIZE]
+            add_column(name_column_width)
+            for header in headers[1:]:
+                add_column(max(len(header), 10))
+
+            row_format = row_format_list[0]
+            header_sep = header_sep_list[0]
+            line_length = line_length_list[0]
+
+            # construct table string
+            append(add_title(line_length, "Operator Roofline Summary"))
+            append(f'Time unit: {time_unit}')
+            if has_peak:
+                append(
+                    f'Peak FLOPS: {_format_large_number(peak_flops)}, '
+                    f'Peak Bytes/s: {_format_large_number(peak_bandwidth)}'
+                )
+            append(header_sep)
+            append(row_format.format(*headers))
+            append(header_sep)
+            for row_values in all_row_values:
+                if len(row_values[0]) > name_column_width:
+                    row_values[0] = (
+                        row_values[0][: name_column_width - 3] + '...'
+                    )
+                append(row_format.format(*row_values))
+            append(header_sep)
+            append('')
+            append('')
+
     if views is None or SummaryView.KernelView in views:
         # ----- Print Kernel Summary Report ----- #
         if statistic_data.event_summary.kernel_items:
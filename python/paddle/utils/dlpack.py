@@ -132,7 +132,8 @@ def from_dlpack(
 
     Args:
         dlpack (SupportDLPack | CapsuleType): A PyCapsule object with the dltensor,
-            or that implements '__dlpack__' and '__dlpack_device__' methods.
+            or that implements '__dlpack__' and '__dlpack_device__' methods,
+            or a CUDA array that implements '__cuda_array_interface__'.
 
             If `dlpack` is a tensor (or ndarray) object, it must support
             the `__dlpack__` protocol (i.e., have a `dlpack.__dlpack__`
@@ -209,6 +210,12 @@ def from_dlpack(
             dlpack_ = dlpack.__dlpack__(stream=stream_ptr)
         else:
             dlpack_ = dlpack.__dlpack__()
+    elif hasattr(dlpack, "__cuda_array_interface__"):
+        # the current stream waits for the stream of the producer
+        out = paddle.base.core._from_cuda_array_interface(dlpack)
+        if in_dygraph_mode():
+            out = paddle.Tensor(out, place=out._place())
+        return out
     else:
         # Old versions just call the converter
         dlpack_ = dlpack
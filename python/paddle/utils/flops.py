@@ -12,9 +12,30 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+from __future__ import annotations
+
 import copy
 
 _FLOPS_COMPUTE_FUNC_MAP = {}
+_MEMORY_BYTES_FUNC_MAP = {}
+
+# element size of the dtype names recorded by the profiler
+_DTYPE_BYTES = {
+    'BOOL': 1,
+    'INT8': 1,
+    'UINT8': 1,
+    'FP8_E4M3FN': 1,
+    'FP8_E5M2': 1,
+    'INT16': 2,
+    'FP16': 2,
+    'BF16': 2,
+    'INT32': 4,
+    'FP32': 4,
+    'INT64': 8,
+    'FP64': 8,
+    'COMPLEX64': 8,
+    'COMPLEX128': 16,
+}
 
 
 def prod(s):
@@ -48,6 +69,62 @@ def flops(op_type: str, input_shapes: dict, attrs: dict) -> int:
         return flops
 
 
+def memory_bytes(
+    op_type: str, input_shapes: dict, attrs: dict, dtypes: dict | None = None
+) -> int:
+    """
+    count the bytes of device memory an operation reads and writes, which is
+    joined with FLOPs to place the operation on the roofline.
+
+    Args:
+        op_type (str): the type of operation.
+        input_shapes (dict): the shapes of inputs.
+        attrs (dict): the attributes of the operation.
+        dtypes (dict, optional): the dtype names of inputs, float32 if missing.
+
+    Returns:
+        the total bytes accessed by the operation. Without a registered
+        function, every input is read once and one output as large as the
+        largest input is written.
+    """
+    dtypes = dtypes or {}
+    try:
+        if op_type in _MEMORY_BYTES_FUNC_MAP:
+            return _MEMORY_BYTES_FUNC_MAP[op_type](input_shapes, attrs, dtypes)
+        input_bytes = [
+            _tensor_bytes(shape, _input_dtype(dtypes, name, idx))
+            for name, shapes in input_shapes.items()
+            for idx, shape in enumerate(shapes)
+        ]
+        if not input_bytes:
+            return 0
+        return sum(input_bytes) + max(input_bytes)
+    except Exception as e:
+        return 0
+
+
+def _input_dtype(dtypes, name, idx=0):
+    names = dtypes.get(name, [])
+    return names[idx] if idx < len(names) else 'FP32'
+
+
+def _tensor_bytes(shape, dtype):
+    return prod(shape) * _DTYPE_BYTES.get(dtype, 4)
+
+
+def register_memory_bytes(op_type):
+    """
+    register memory bytes computation function for operation.
+    """
+
+    def register(func):
+        global _MEMORY_BYTES_FUNC_MAP
+        _MEMORY_BYTES_FUNC_MAP[op_type] = func
+        return func
+
+    return register
+
+
 def register_flops(op_type):
     """
     register flops computation function for operation.
@@ -270,6 +347,43 @@ def _matmul_flops(input_shapes, attrs):
     return 2 * macs
 
 
+@register_memory_bytes("matmul")
+@register_memory_bytes("matmul_v2")
+def _matmul_memory_bytes(input_shapes, attrs, dtypes):
+    """Memory bytes computation for matmul and matmul_v2 op.
+    For matmul(input,other):
+        equation: bytes = bytes(input) + bytes(other) + bytes(output)
+    """
+    x_key = 'X' if 'X' in input_shapes else 'x'
+    y_key = 'Y' if 'Y' in input_shapes else 'y'
+    x_shape = list(input_shapes.get(x_key)[0])
+    y_shape = list(input_shapes.get(y_key)[0])
+    dtype = _input_dtype(dtypes, x_key)
+    if attrs.get('transpose_X') or attrs.get('transpose_x'):
+        x_shape[-1], x_shape[-2] = x_shape[-2], x_shape[-1]
+    if (
+        attrs.get('transpose_Y')
+        or attrs.get('transpose_y')
+        or attrs.get('trans_y')
+    ):
+        y_shape[-1], y_shape[-2] = y_shape[-2], y_shape[-1]
+    if attrs.get('trans_x'):
+        x_shape[-1], x_shape[-2] = x_shape[-2], x_shape[-1]
+    dim_x = len(x_shape)
+    dim_y = len(y_shape)
+    output_shape = []
+    for idx in range(max(dim_x, dim_y), 2, -1):
+        x_idx = x_shape[dim_x - idx] if idx <= dim_x else 1
+        y_idx = y_shape[dim_y - idx] if idx <= dim_y else 1
+        output_shape.append(max(x_idx, y_idx))
+    output_shape += [x_shape[-2], y_shape[-1]]
+    return (
+        _tensor_bytes(x_shape, dtype)
+        + _tensor_bytes(y_shape, _input_dtype(dtypes, y_key))
+        + _tensor_bytes(output_shape, dtype)
+    )
+
+
 @register_flops("matmul_v2")
 def _matmul_v2_flops(input_shapes, attrs):
     """FLOPs computation for matmul_v2 op.
@@ -55,6 +55,7 @@ __all__ = [
     'generate_proposals',
     'read_file',
     'decode_jpeg',
+    'crop_resize_normalize',
     'roi_pool',
     'RoIPool',
     'psroi_pool',
@@ -1438,6 +1439,87 @@ def decode_jpeg(
         return out
 
 
+def crop_resize_normalize(
+    x: Sequence[Tensor],
+    boxes: Tensor,
+    size: Size2,
+    flip: Tensor | None = None,
+    mean: Sequence[float] | float | None = None,
+    std: Sequence[float] | float | None = None,
+    name: str | None = None,
+) -> Tensor:
+    """
+    Crops the boxes out of the images, resizes the crops bilinearly to the same size,
+    optionally flips them horizontally and normalizes them, in a single GPU kernel.
+    It fuses the usual random resized crop, random horizontal flip and normalize
+    augmentations on the images decoded by :ref:`api_paddle_vision_ops_decode_jpeg`,
+    and batches the images of different sizes into one tensor.
+
+    The resizing follows ``paddle.nn.functional.interpolate`` with ``mode='bilinear'``
+    and ``align_corners=False``, and every output value is ``(value - mean[c]) / std[c]``.
+
+    Args:
+        x (list[Tensor]): The images, every one is a 3-D uint8 or float32 tensor of
+            shape (C, H, W). The images may be of different sizes but should have the
+            same number of channels, at most 4.
+        boxes (Tensor): A int32 tensor of shape (N, 4), the crop box of every image
+            as (top, left, height, width). The boxes are clamped into the images.
+        size (int|list[int]|tuple[int]): The size (height, width) of the output images.
+        flip (Tensor, optional): A bool tensor of shape (N,), whether to flip every
+            image horizontally. Default: None, no image is flipped.
+        mean (float|list[float], optional): The mean of every channel, or of all the
+            channels. Default: None, means 0.
+        std (float|list[float], optional): The standard deviation of every channel,
+            or of all the channels. Default: None, means 1.
+        name (str, optional): The default value is None. Normally there is no
+            need for user to set this property. For more information, please
+            refer to :ref:`api_guide_Name`.
+
+    Returns:
+        Tensor: A float32 tensor of shape (N, C, size[0], size[1]).
+
+    Examples:
+        .. code-block:: python
+
+            >>> # doctest: +REQUIRES(env:GPU)
+            >>> import paddle
+            >>> paddle.device.set_device('gpu')
+
+            >>> images = [
+            ...     paddle.randint(0, 256, [3, 120, 160]).astype('uint8'),
+            ...     paddle.randint(0, 256, [3, 200, 100]).astype('uint8'),
+            ... ]
+            >>> boxes = paddle.to_tensor([[10, 20, 100, 120], [0, 0, 200, 100]], 'int32')
+            >>> flip = paddle.to_tensor([True, False])
+            >>> out = paddle.vision.ops.crop_resize_normalize(
+            ...     images, boxes, 64, flip=flip,
+            ...     mean=[123.675, 116.28, 103.53], std=[58.395, 57.12, 57.375])
+            >>> print(out.shape)
+            [2, 3, 64, 64]
+    """
+    if isinstance(size, int):
+        size = [size, size]
+    size = list(size)
+    if mean is None:
+        mean = []
+    elif isinstance(mean, (int, float)):
+        mean = [float(mean)]
+    if std is None:
+        std = []
+    elif isinstance(std, (int, float)):
+        std = [float(std)]
+    mean = [float(v) for v in mean]
+    std = [float(v) for v in std]
+
+    if in_dynamic_or_pir_mode():
+        return _C_ops.crop_resize_normalize(x, boxes, flip, size, mean, std)
+    else:
+        raise NotImplementedError(
+            "crop_resize_normalize is only supported in dynamic graph mode "
+            "and PIR mode."
+        )
+
+
 def psroi_pool(
     x: Tensor,
     boxes: Tensor,
@@ -2046,60 +2128,32 @@ def nms(
         categories is not None
     ), "if category_idxs is given, categories which is a list of unique id of all categories is necessary"
 
-    mask = paddle.zeros_like(scores, dtype='int32')
-
-    for category_id in categories:
-        cur_category_boxes_idxs = paddle.where(
-            paddle.equal(category_idxs, paddle.to_tensor(category_id))
-        )[0]
-        shape = cur_category_boxes_idxs.shape[0]
-        cur_category_boxes_idxs = paddle.reshape(
-            cur_category_boxes_idxs, [shape]
-        )
-        if shape == 0:
-            continue
-        elif shape == 1:
-            mask[cur_category_boxes_idxs] = 1
-            continue
-        cur_category_boxes = boxes[cur_category_boxes_idxs]
-        cur_category_scores = scores[cur_category_boxes_idxs]
-        cur_category_sorted_indices = paddle.argsort(
-            cur_category_scores, descending=True
-        )
-        cur_category_sorted_boxes = cur_category_boxes[
-            cur_category_sorted_indices
-        ]
-
-        cur_category_keep_boxes_sub_idxs = cur_category_sorted_indices[
-            _nms(cur_category_sorted_boxes, iou_threshold)
-        ]
-
-        updates = paddle.ones_like(
-            cur_category_boxes_idxs[cur_category_keep_boxes_sub_idxs],
-            dtype='int32',
+    # Only the boxes of the given categories are considered.
+    valid_idxs = paddle.where(
+        paddle.isin(
+            category_idxs,
+            paddle.to_tensor(categories, dtype=category_idxs.dtype),
         )
-        mask = paddle.scatter(
-            mask,
-            cur_category_boxes_idxs[cur_category_keep_boxes_sub_idxs],
-            updates,
-            overwrite=True,
-        )
-    keep_boxes_idxs = paddle.where(mask)[0]
-    shape = keep_boxes_idxs.shape[0]
-    keep_boxes_idxs = paddle.reshape(keep_boxes_idxs, [shape])
-    sorted_sub_indices = paddle.argsort(
-        scores[keep_boxes_idxs], descending=True
+    )[0]
+    valid_idxs = paddle.reshape(valid_idxs, [-1])
+    if in_dygraph_mode() and valid_idxs.shape[0] == 0:
+        return valid_idxs
+    valid_boxes = boxes[valid_idxs]
+    # Shifts the boxes of every category into a disjoint region, so the boxes
+    # of different categories never overlap and a single NMS over all the
+    # boxes equals the NMS of every category, without a loop over categories.
+    offsets = paddle.cast(category_idxs[valid_idxs], boxes.dtype) * (
+        paddle.max(valid_boxes) + 1
     )
+    valid_boxes = valid_boxes + paddle.unsqueeze(offsets, 1)
+    sorted_indices = paddle.argsort(scores[valid_idxs], descending=True)
+    keep_boxes_idxs = valid_idxs[
+        sorted_indices[_nms(valid_boxes[sorted_indices], iou_threshold)]
+    ]
 
     if top_k is None:
-        return keep_boxes_idxs[sorted_sub_indices]
-
-    if in_dygraph_mode():
-        top_k = min(top_k, shape)
-        _, topk_sub_indices = paddle.topk(scores[keep_boxes_idxs], top_k)
-        return keep_boxes_idxs[topk_sub_indices]
-
-    return keep_boxes_idxs[sorted_sub_indices][:top_k]
+        return keep_boxes_idxs
+    return keep_boxes_idxs[:top_k]
 
 
 @overload
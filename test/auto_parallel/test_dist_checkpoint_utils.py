@@ -182,6 +182,42 @@ class TestDistCheckpointUtils(test_base.CommunicationTestDistBase):
 
         ckpt_dir_tmp.cleanup()
 
+    def test_async_save(self):
+        ckpt_dir_tmp = tempfile.TemporaryDirectory()
+        ckpt_dir = ckpt_dir_tmp.name
+        state_dict = {
+            "w1": paddle.arange(32, dtype="float32").reshape([4, 8]),
+            "w2": paddle.to_tensor([3, 4]),
+            "w3": paddle.ones([16], dtype="float16"),
+        }
+        dist.save_state_dict(state_dict, ckpt_dir, async_save=True)
+        # the snapshot is taken before save_state_dict returns
+        state_dict["w1"].add_(paddle.ones([4, 8]))
+        dist.checkpoint.save_state_dict.clear_async_save_task_queue()
+
+        _, local_load_files = get_checkpoint_files(ckpt_dir, use_cache=False)
+        self.assertEqual(
+            sorted(local_load_files),
+            ["0_0_0.distcp", "0_0_1.distcp", "0_0_2.distcp"],
+        )
+
+        new_state_dict = {
+            "w1": paddle.zeros([4, 8], dtype="float32"),
+            "w2": paddle.zeros([2], dtype="int64"),
+            "w3": paddle.zeros([16], dtype="float16"),
+        }
+        dist.load_state_dict(new_state_dict, ckpt_dir)
+        np.testing.assert_equal(
+            new_state_dict["w1"].numpy(),
+            np.arange(32, dtype="float32").reshape([4, 8]),
+        )
+        np.testing.assert_equal(new_state_dict["w2"].numpy(), [3, 4])
+        np.testing.assert_equal(
+            new_state_dict["w3"].numpy(), np.ones([16], dtype="float16")
+        )
+
+        ckpt_dir_tmp.cleanup()
+
 
 if __name__ == "__main__":
     unittest.main()
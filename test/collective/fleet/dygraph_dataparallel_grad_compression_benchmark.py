@@ -0,0 +1,101 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# Compares the step time and the gradient bytes sent per step of DataParallel
+# with each gradient compression codec of the EagerReducer, run with
+#   python -m paddle.distributed.launch --gpus 0,1 \
+#       dygraph_dataparallel_grad_compression_benchmark.py
+
+import argparse
+import time
+
+import paddle
+import paddle.distributed as dist
+from paddle import nn
+
+
+class MLP(nn.Layer):
+    def __init__(self, hidden, layers):
+        super().__init__()
+        self.layers = nn.LayerList(
+            [nn.Linear(hidden, hidden) for _ in range(layers)]
+        )
+
+    def forward(self, x):
+        for layer in self.layers:
+            x = paddle.nn.functional.relu(layer(x))
+        return x
+
+
+def run(codec, args):
+    paddle.seed(2024)
+    model = paddle.DataParallel(MLP(args.hidden, args.layers))
+    if codec != "none":
+        model._reducer.set_grad_compression(
+            codec,
+            topk_ratio=args.topk_ratio,
+            powersgd_rank=args.powersgd_rank,
+        )
+    opt = paddle.optimizer.SGD(
+        learning_rate=1e-3, parameters=model.parameters()
+    )
+    x = paddle.randn([args.batch_size, args.hidden])
+
+    def step():
+        loss = model(x).mean()
+        loss.backward()
+        opt.step()
+        opt.clear_grad()
+        return loss
+
+    for _ in range(args.warmup):
+        step()
+    paddle.device.synchronize()
+    start_bytes = model._reducer.comm_bytes
+    start = time.perf_counter()
+    for _ in range(args.steps):
+        loss = step()
+    paddle.device.synchronize()
+    elapsed = time.perf_counter() - start
+    sent = model._reducer.comm_bytes - start_bytes
+    return elapsed / args.steps * 1000, sent / args.steps, float(loss)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--hidden", type=int, default=4096)
+    parser.add_argument("--layers", type=int, default=8)
+    parser.add_argument("--batch_size", type=int, default=32)
+    parser.add_argument("--warmup", type=int, default=5)
+    parser.add_argument("--steps", type=int, default=20)
+    parser.add_argument("--topk_ratio", type=float, default=0.01)
+    parser.add_argument("--powersgd_rank", type=int, default=4)
+    parser.add_argument(
+        "--codecs", type=str, default="none,bf16,fp8,topk,powersgd"
+    )
+    args = parser.parse_args()
+
+    dist.init_parallel_env()
+    for codec in args.codecs.split(","):
+        step_ms, sent, loss = run(codec, args)
+        if dist.get_rank() == 0:
+            print(
+                f"codec={codec} step_time={step_ms:.3f}ms "
+                f"bytes_sent_per_step={sent / 1024 / 1024:.3f}MB "
+                f"loss={loss:.6f}"
+            )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,110 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "paddle/phi/core/distributed/auto_parallel/reshard/reshard_planner.h"
+
+#include "gtest/gtest.h"
+
+#include "paddle/phi/core/distributed/auto_parallel/dist_attr.h"
+#include "paddle/phi/core/distributed/auto_parallel/process_mesh.h"
+
+namespace phi {
+namespace distributed {
+namespace auto_parallel {
+
+static TensorDistAttr MakeDistAttr(const ProcessMesh& mesh,
+                                   const std::vector<int64_t>& dims_mapping,
+                                   const std::vector<int64_t>& partial_dims) {
+  TensorDistAttr dist_attr(std::vector<int64_t>(dims_mapping.size(), 1));
+  dist_attr.set_process_mesh(mesh);
+  dist_attr.set_dims_mapping(dims_mapping);
+  if (!partial_dims.empty()) {
+    dist_attr.set_partial_status(partial_dims);
+  }
+  return dist_attr;
+}
+
+static ProcessMesh Mesh2x4() {
+  return ProcessMesh({2, 4}, {0, 1, 2, 3, 4, 5, 6, 7}, {"x", "y"});
+}
+
+TEST(ReshardPlanner, all_to_all) {
+  ReshardPlanner planner((ReshardCostModel()));
+  auto mesh = Mesh2x4();
+  auto dims = common::make_ddim({1024, 1024});
+  auto in = MakeDistAttr(mesh, {1, -1}, {});
+  auto out = MakeDistAttr(mesh, {-1, 1}, {});
+
+  auto plan = planner.Plan(dims, DataType::FLOAT32, in, out);
+  ASSERT_EQ(plan->steps.size(), 1UL);
+  EXPECT_EQ(plan->steps[0].type, ReshardStep::Type::kSToS);
+  EXPECT_EQ(plan->steps[0].mesh_axis, 1);
+
+  // all-gather then slice moves 4x the bytes on an axis of 4 ranks
+  auto naive = planner.NaivePlan(dims, DataType::FLOAT32, in, out);
+  EXPECT_EQ(naive.comm_bytes, 4 * plan->comm_bytes);
+  EXPECT_LT(plan->cost, naive.cost);
+}
+
+TEST(ReshardPlanner, partial_to_shard) {
+  ReshardPlanner planner((ReshardCostModel()));
+  auto mesh = Mesh2x4();
+  auto dims = common::make_ddim({1024, 1024});
+  auto in = MakeDistAttr(mesh, {0, -1}, {1});
+  auto out = MakeDistAttr(mesh, {0, 1}, {});
+
+  auto plan = planner.Plan(dims, DataType::FLOAT32, in, out);
+  ASSERT_EQ(plan->steps.size(), 1UL);
+  EXPECT_EQ(plan->steps[0].type, ReshardStep::Type::kPToS);
+  EXPECT_EQ(plan->steps[0].out_tensor_axis, 1);
+}
+
+TEST(ReshardPlanner, never_worse_than_fixed_order) {
+  ReshardPlanner planner((ReshardCostModel({25, 200})));
+  auto mesh = Mesh2x4();
+  auto dims = common::make_ddim({512, 256, 64});
+  const std::vector<std::vector<int64_t>> dims_mappings = {
+      {-1, -1, -1}, {0, -1, -1}, {1, -1, -1}, {0, 1, -1}, {1, 0, -1},
+      {-1, 0, 1},   {-1, 1, -1}, {1, -1, 0},  {-1, -1, 1}};
+  for (const auto& in_dims_mapping : dims_mappings) {
+    for (const auto& out_dims_mapping : dims_mappings) {
+      auto in = MakeDistAttr(mesh, in_dims_mapping, {});
+      auto out = MakeDistAttr(mesh, out_dims_mapping, {});
+      auto plan = planner.Plan(dims, DataType::FLOAT16, in, out);
+      auto naive = planner.NaivePlan(dims, DataType::FLOAT16, in, out);
+      EXPECT_LE(plan->cost, naive.cost + 1e-12);
+    }
+  }
+}
+
+TEST(ReshardPlanner, cache) {
+  ReshardPlanner planner((ReshardCostModel()));
+  auto mesh = Mesh2x4();
+  auto in = MakeDistAttr(mesh, {0, 1}, {});
+  auto out = MakeDistAttr(mesh, {1, 0}, {});
+
+  auto plan = planner.Plan(
+      common::make_ddim({64, 64}), DataType::FLOAT32, in, out);
+  EXPECT_EQ(planner.CacheSize(), 1UL);
+  EXPECT_EQ(
+      planner.Plan(common::make_ddim({64, 64}), DataType::FLOAT32, in, out),
+      plan);
+  EXPECT_EQ(planner.CacheSize(), 1UL);
+  planner.Plan(common::make_ddim({128, 64}), DataType::FLOAT32, in, out);
+  EXPECT_EQ(planner.CacheSize(), 2UL);
+}
+
+}  // namespace auto_parallel
+}  // namespace distributed
+}  // namespace phi
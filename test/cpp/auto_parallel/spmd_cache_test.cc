@@ -0,0 +1,73 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "test/cpp/auto_parallel/spmd_rule_test_util.h"
+
+namespace paddle {
+namespace distributed {
+namespace auto_parallel {
+
+TEST(SpmdCache, HitAndMiss) {
+  ProcessMesh process_mesh({2, 2}, {0, 1, 2, 3}, {"x", "y"});
+  TensorDistAttr t_dist_attr = TensorDistAttr();
+  t_dist_attr.set_process_mesh(process_mesh);
+  t_dist_attr.set_dims_mapping({0, -1, 1});
+  t_dist_attr.set_dynamic_dims({false, false, false});
+  phi::distributed::DistMetaTensor x(common::make_ddim({6, 8, 10}),
+                                     t_dist_attr);
+  std::vector<int64_t> repeat_times = {2, 2, 1, 1};
+
+  int calls = 0;
+  auto infer = [&](const phi::distributed::DistMetaTensor& x,
+                   const std::vector<int64_t>& repeat_times) {
+    return phi::distributed::CachedInferSpmd(
+        "TileInferSpmd",
+        [&]() {
+          ++calls;
+          return phi::distributed::TileInferSpmd(x, repeat_times);
+        },
+        x,
+        repeat_times);
+  };
+
+  auto first = infer(x, repeat_times);
+  auto second = infer(x, repeat_times);
+  EXPECT_EQ(calls, 1);
+  check_dim_mapping(second.first[0], {-1, -1, 1});
+  check_dim_mapping(second.second[0], {-1, -1, -1, 1});
+  EXPECT_EQ(first.second.size(), second.second.size());
+
+  // a different attribute, shape or placement is a different call
+  infer(x, {1, 1, 1, 1});
+  EXPECT_EQ(calls, 2);
+  phi::distributed::DistMetaTensor y(common::make_ddim({6, 8, 12}),
+                                     t_dist_attr);
+  infer(y, repeat_times);
+  EXPECT_EQ(calls, 3);
+  TensorDistAttr other_dist_attr = t_dist_attr;
+  other_dist_attr.set_dims_mapping({1, -1, 0});
+  phi::distributed::DistMetaTensor z(common::make_ddim({6, 8, 10}),
+                                     other_dist_attr);
+  infer(z, repeat_times);
+  EXPECT_EQ(calls, 4);
+
+  FLAGS_enable_spmd_rule_cache = false;
+  infer(x, repeat_times);
+  EXPECT_EQ(calls, 5);
+  FLAGS_enable_spmd_rule_cache = true;
+}
+
+}  // namespace auto_parallel
+}  // namespace distributed
+}  // namespace paddle
@@ -1127,6 +1127,120 @@ TEST(FlashAtt, Ctor) {
   check_dim_mapping(spmd2.second[2], {0, -1, 1, -1});
 }
 
+TEST(FlashAttUnpadded, Ctor) {
+  std::vector<int64_t> mesh_shape = {2, 2};
+  std::vector<int64_t> process_ids = {0, 1, 2, 3};
+  std::vector<std::string> dim_names = {"x", "y"};
+  ProcessMesh process_mesh(mesh_shape, process_ids, dim_names);
+
+  auto build_input = [&](const std::vector<int64_t>& shape,
+                         const std::vector<int64_t>& dim_mapping) {
+    auto t_dist_attr = TensorDistAttr();
+    t_dist_attr.set_process_mesh(process_mesh);
+    t_dist_attr.set_dims_mapping(dim_mapping);
+    t_dist_attr.set_dynamic_dims(std::vector<bool>(shape.size(), false));
+    auto input =
+        phi::distributed::DistMetaTensor(common::make_ddim(shape), t_dist_attr);
+    return input;
+  };
+
+  // total_tokens, num_heads, head_dim
+  std::vector<int64_t> qkv_shape = {512, 4, 128};
+  auto q = build_input(qkv_shape, {0, 1, -1});
+  auto kv = build_input(qkv_shape, {-1, -1, 0});
+  auto cu_seqlens = build_input({3}, {0});
+  auto mask = build_input({}, {});
+  auto seed_offset = build_input({}, {});
+
+  // the tokens and head_dim are replicated, the heads keep the split of q
+  auto spmd1 = FlashAttUnpaddedInferSpmd(q,
+                                         kv,
+                                         kv,
+                                         cu_seqlens,
+                                         cu_seqlens,
+                                         seed_offset,
+                                         mask,
+                                         256,
+                                         256,
+                                         0.5,
+                                         0.0,
+                                         true,
+                                         false,
+                                         false,
+                                         "");
+
+  EXPECT_EQ(spmd1.first.size(), static_cast<size_t>(7));
+  EXPECT_EQ(spmd1.second.size(), static_cast<size_t>(4));
+  check_dim_mapping(spmd1.first[0], {-1, 1, -1});
+  check_dim_mapping(spmd1.first[1], {-1, 1, -1});
+  check_dim_mapping(spmd1.first[2], {-1, 1, -1});
+  check_dim_mapping(spmd1.first[3], {-1});
+  check_dim_mapping(spmd1.first[4], {-1});
+  check_dim_mapping(spmd1.first[5], {});
+  check_dim_mapping(spmd1.first[6], {});
+  check_dim_mapping(spmd1.second[0], {-1, 1, -1});
+  check_dim_mapping(spmd1.second[1], {-1, 1, -1, -1});
+  check_dim_mapping(spmd1.second[2], {-1, 1, -1});
+  check_dim_mapping(spmd1.second[3], {-1});
+
+  // one kv head can not be split, the heads are replicated
+  auto gqa_kv = build_input({512, 1, 128}, {-1, 1, -1});
+  auto spmd2 = FlashAttUnpaddedInferSpmd(q,
+                                         gqa_kv,
+                                         gqa_kv,
+                                         cu_seqlens,
+                                         cu_seqlens,
+                                         seed_offset,
+                                         mask,
+                                         256,
+                                         256,
+                                         0.5,
+                                         0.0,
+                                         true,
+                                         false,
+                                         false,
+                                         "");
+  check_dim_mapping(spmd2.first[0], {-1, -1, -1});
+  check_dim_mapping(spmd2.first[1], {-1, -1, -1});
+  check_dim_mapping(spmd2.second[0], {-1, -1, -1});
+
+  auto out = build_input(qkv_shape, {0, -1, -1});
+  auto softmax_lse = build_input({2, 4, 256}, {-1, 1, -1});
+  auto out_grad = build_input(qkv_shape, {-1, 1, -1});
+
+  auto spmd3 = FlashAttUnpaddedGradInferSpmd(q,
+                                             kv,
+                                             kv,
+                                             cu_seqlens,
+                                             cu_seqlens,
+                                             out,
+                                             softmax_lse,
+                                             seed_offset,
+                                             mask,
+                                             out_grad,
+                                             256,
+                                             256,
+                                             0.5,
+                                             0.0,
+                                             true);
+
+  EXPECT_EQ(spmd3.first.size(), static_cast<size_t>(10));
+  EXPECT_EQ(spmd3.second.size(), static_cast<size_t>(3));
+  check_dim_mapping(spmd3.first[0], {-1, 1, -1});
+  check_dim_mapping(spmd3.first[1], {-1, 1, -1});
+  check_dim_mapping(spmd3.first[2], {-1, 1, -1});
+  check_dim_mapping(spmd3.first[3], {-1});
+  check_dim_mapping(spmd3.first[4], {-1});
+  check_dim_mapping(spmd3.first[5], {-1, 1, -1});
+  check_dim_mapping(spmd3.first[6], {-1, 1, -1});
+  check_dim_mapping(spmd3.first[7], {});
+  check_dim_mapping(spmd3.first[8], {});
+  check_dim_mapping(spmd3.first[9], {-1, 1, -1});
+  check_dim_mapping(spmd3.second[0], {-1, 1, -1});
+  check_dim_mapping(spmd3.second[1], {-1, 1, -1});
+  check_dim_mapping(spmd3.second[2], {-1, 1, -1});
+}
+
 TEST(Util, Ctor) {
   // test equal test not equal
   using phi::distributed::PartialStatus;
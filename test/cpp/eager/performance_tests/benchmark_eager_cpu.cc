@@ -33,9 +33,47 @@
 
 #include "paddle/phi/core/kernel_registry.h"
 
+COMMON_DECLARE_bool(enable_kernel_select_cache);
+
 using namespace egr;            // NOLINT
 using namespace egr_utils_api;  // NOLINT
 
+TEST(Benchmark, EagerSmallOpDispatchCPU) {
+  // Prepare Device Contexts
+  eager_test::InitEnv(phi::CPUPlace());
+
+  phi::DDim ddim = common::make_ddim({1});
+  paddle::Tensor X = eager_test::CreateTensorWithValue(ddim,
+                                                       phi::CPUPlace(),
+                                                       phi::DataType::FLOAT32,
+                                                       phi::DataLayout::NCHW,
+                                                       1.0,
+                                                       false);
+  paddle::Tensor Y = eager_test::CreateTensorWithValue(ddim,
+                                                       phi::CPUPlace(),
+                                                       phi::DataType::FLOAT32,
+                                                       phi::DataLayout::NCHW,
+                                                       2.0,
+                                                       false);
+  benchmark_eager_small_op(X, Y, true /* accuracy_check */);
+
+  bool enable_kernel_select_cache = FLAGS_enable_kernel_select_cache;
+  for (bool use_cache : {false, true}) {
+    FLAGS_enable_kernel_select_cache = use_cache;
+    // warm up the cache and the allocator
+    benchmark_eager_small_op(X, Y, true /* accuracy_check */);
+
+    auto t_start = std::chrono::high_resolution_clock::now();
+    size_t num_ops = benchmark_eager_small_op(X, Y);
+    auto t_end = std::chrono::high_resolution_clock::now();
+    double elapsed_time_us =
+        std::chrono::duration<double, std::micro>(t_end - t_start).count();
+    std::cout << "Kernel select cache " << (use_cache ? "on" : "off") << ": "
+              << elapsed_time_us / num_ops << " us/op" << std::endl;
+  }
+  FLAGS_enable_kernel_select_cache = enable_kernel_select_cache;
+}
+
 TEST(Benchmark, EagerScaleCPU) {
   // Prepare Device Contexts
   eager_test::InitEnv(phi::CPUPlace());
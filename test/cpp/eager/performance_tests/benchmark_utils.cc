@@ -35,6 +35,7 @@
 #include "paddle/fluid/framework/op_registry.h"
 #include "paddle/fluid/imperative/basic_engine.h"
 #include "paddle/fluid/imperative/tracer.h"
+#include "paddle/phi/api/include/api.h"
 #include "paddle/phi/core/memory/memcpy.h"
 
 static size_t max_num_benchmark_runs = 4000;
@@ -152,6 +153,26 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
   }
 }
 
+/* ------------------------ */
+/* ---- Eager Small Op ---- */
+/* ------------------------ */
+size_t benchmark_eager_small_op(const paddle::Tensor& X,
+                                const paddle::Tensor& Y,
+                                bool accuracy_check) {
+  paddle::Tensor input_tensor0 = X;
+
+  size_t max_num_runs = accuracy_check ? 10 : max_num_benchmark_runs * 25;
+  for (size_t i = 0; i < max_num_runs; i++) {
+    input_tensor0 = paddle::experimental::add(input_tensor0, Y);
+  }
+
+  if (accuracy_check) {
+    // Examine Forward Output (w.r.t max_num_runs = 10)
+    eager_test::CompareTensorWithValue<float>(input_tensor0, 21.0);
+  }
+  return max_num_runs;
+}
+
 }  // namespace egr
 
 namespace paddle {
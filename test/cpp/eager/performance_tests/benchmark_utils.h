@@ -65,6 +65,13 @@ void benchmark_eager_intermediate_mlp(const paddle::Tensor& X,
                                       const std::vector<paddle::Tensor>& Bs,
                                       bool accuracy_check = false);
 
+/* ---- Eager Small Op ---- */
+// Runs a small add through the phi api, no autograd, and returns the number
+// of ops it ran, to measure the dispatch overhead per op.
+size_t benchmark_eager_small_op(const paddle::Tensor& X,
+                                const paddle::Tensor& Y,
+                                bool accuracy_check = false);
+
 }  // namespace egr
 
 namespace paddle {
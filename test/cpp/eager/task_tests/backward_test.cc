@@ -18,6 +18,7 @@
 
 #include "glog/logging.h"
 #include "gtest/gtest.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/eager/accumulation/accumulation_node.h"
 #include "paddle/fluid/eager/api/all.h"
 #include "paddle/fluid/eager/api/generated/eager_generated/backwards/scale_node.h"
@@ -31,6 +32,8 @@
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 
+COMMON_DECLARE_int32(eager_backward_num_threads);
+
 namespace egr {
 
 TEST(Backward, SingleNodeEmptyGrad) {
@@ -232,7 +235,9 @@ Node0   Node1
   |      |
  inp0   inp1
 */
-TEST(Backward, WithAccumulation) {
+// Two grad nodes, which run in parallel when the backward is parallel,
+// accumulate into the same next node.
+static void RunBackwardWithAccumulation() {
   // Prepare Device Contexts
   eager_test::InitEnv(phi::CPUPlace());
 
@@ -342,4 +347,13 @@ TEST(Backward, WithAccumulation) {
   eager_test::CompareGradTensorWithValue<float>(leaf_tensor, 2500.0);
 }
 
+TEST(Backward, WithAccumulation) { RunBackwardWithAccumulation(); }
+
+TEST(Backward, ParallelWithAccumulation) {
+  int num_threads = FLAGS_eager_backward_num_threads;
+  FLAGS_eager_backward_num_threads = 2;
+  RunBackwardWithAccumulation();
+  FLAGS_eager_backward_num_threads = num_threads;
+}
+
 }  // namespace egr
@@ -0,0 +1,126 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_feed_columnar.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace framework {
+
+namespace {
+
+const int kUint64SlotNum = 3;
+const int kFloatSlotNum = 2;
+
+std::vector<SlotRecord> MakeRecords(int num) {
+  std::vector<SlotRecord> records(num);
+  for (int i = 0; i < num; ++i) {
+    SlotRecord rec = make_slotrecord();
+    rec->search_id = 1000 + i;
+    rec->rank = i % 7;
+    rec->cmatch = i % 3;
+    rec->ins_id_ = "ins_" + std::to_string(i);
+    for (int slot = 0; slot < kUint64SlotNum; ++slot) {
+      // every few records leave a slot empty
+      std::vector<uint64_t> values((i + slot) % 4);
+      for (size_t j = 0; j < values.size(); ++j) {
+        values[j] = (static_cast<uint64_t>(i) << 32) + slot * 100 + j;
+      }
+      rec->slot_uint64_feasigns_.add_values(values.data(), values.size());
+    }
+    for (int slot = 0; slot < kFloatSlotNum; ++slot) {
+      std::vector<float> values(1 + (i + slot) % 2, i * 0.5f + slot);
+      rec->slot_float_feasigns_.add_values(values.data(), values.size());
+    }
+    records[i] = rec;
+  }
+  return records;
+}
+
+void FreeRecords(std::vector<SlotRecord>* records) {
+  for (auto rec : *records) {
+    free_slotrecord(rec);
+  }
+  records->clear();
+}
+
+}  // namespace
+
+TEST(DataFeedColumnar, RoundTrip) {
+  std::string path = "./data_feed_columnar_test.slotcol";
+  auto first = MakeRecords(100);
+  auto second = MakeRecords(37);
+
+  SlotRecordColumnarWriter writer(kUint64SlotNum, kFloatSlotNum);
+  ASSERT_TRUE(writer.Open(path));
+  ASSERT_TRUE(writer.Append(first.data(), first.size()));
+  ASSERT_TRUE(writer.Append(second.data(), second.size()));
+  ASSERT_TRUE(writer.Commit());
+
+  SlotRecordColumnarReader reader;
+  ASSERT_TRUE(reader.Open(path, kUint64SlotNum, kFloatSlotNum));
+  for (auto* expected : {&first, &second}) {
+    ASSERT_EQ(reader.NextBlock(), static_cast<int>(expected->size()));
+    auto loaded = MakeRecords(expected->size());
+    reader.FillBlock(loaded.data());
+    for (size_t i = 0; i < expected->size(); ++i) {
+      SlotRecord a = (*expected)[i];
+      SlotRecord b = loaded[i];
+      EXPECT_EQ(a->search_id, b->search_id);
+      EXPECT_EQ(a->rank, b->rank);
+      EXPECT_EQ(a->cmatch, b->cmatch);
+      EXPECT_EQ(a->ins_id_, b->ins_id_);
+      EXPECT_EQ(a->slot_uint64_feasigns_.slot_values,
+                b->slot_uint64_feasigns_.slot_values);
+      EXPECT_EQ(a->slot_uint64_feasigns_.slot_offsets,
+                b->slot_uint64_feasigns_.slot_offsets);
+      EXPECT_EQ(a->slot_float_feasigns_.slot_values,
+                b->slot_float_feasigns_.slot_values);
+      EXPECT_EQ(a->slot_float_feasigns_.slot_offsets,
+                b->slot_float_feasigns_.slot_offsets);
+    }
+    FreeRecords(&loaded);
+  }
+  EXPECT_EQ(reader.NextBlock(), 0);
+  reader.Close();
+
+  // a cache written for another slot config is never used
+  EXPECT_FALSE(reader.Open(path, kUint64SlotNum + 1, kFloatSlotNum));
+  remove(path.c_str());
+  FreeRecords(&first);
+  FreeRecords(&second);
+}
+
+TEST(DataFeedColumnar, AbortLeavesNoFile) {
+  std::string path = "./data_feed_columnar_abort.slotcol";
+  auto records = MakeRecords(10);
+  {
+    SlotRecordColumnarWriter writer(kUint64SlotNum, kFloatSlotNum);
+    ASSERT_TRUE(writer.Open(path));
+    ASSERT_TRUE(writer.Append(records.data(), records.size()));
+    // destroyed without Commit
+  }
+  SlotRecordColumnarReader reader;
+  EXPECT_FALSE(reader.Open(path, kUint64SlotNum, kFloatSlotNum));
+  EXPECT_NE(access((path + ".tmp").c_str(), F_OK), 0);
+  FreeRecords(&records);
+}
+
+}  // namespace framework
+}  // namespace paddle
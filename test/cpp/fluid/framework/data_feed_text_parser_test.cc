@@ -0,0 +1,202 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/data_feed_text_parser.h"
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(DataFeedTextParser, Uint64MatchesStrtoull) {
+  std::vector<std::string> tokens = {"0",
+                                     "7",
+                                     "12345678",
+                                     "123456789",
+                                     "18446744073709551615",
+                                     "99999999999999999999",
+                                     "0000000000000000000042",
+                                     "  42 next",
+                                     "+5",
+                                     "abc"};
+  for (auto& token : tokens) {
+    const char* str = token.c_str();
+    char* fast_end = nullptr;
+    char* libc_end = nullptr;
+    uint64_t fast = FastStrtoull(str, str + token.size(), &fast_end);
+    uint64_t libc = strtoull(str, &libc_end, 10);
+    EXPECT_EQ(fast, libc) << token;
+    EXPECT_EQ(fast_end, libc_end) << token;
+  }
+}
+
+TEST(DataFeedTextParser, FloatMatchesStrtof) {
+  std::vector<std::string> tokens = {"0",
+                                     "-0",
+                                     "1",
+                                     "0.5",
+                                     "-3.25",
+                                     ".125",
+                                     "5.",
+                                     "0.000001",
+                                     "123456.789012",
+                                     "1e-05",
+                                     "2.5E3",
+                                     "0x1p3",
+                                     "inf",
+                                     "nan",
+                                     " 1.5 2",
+                                     "-"};
+  for (auto& token : tokens) {
+    const char* str = token.c_str();
+    char* fast_end = nullptr;
+    char* libc_end = nullptr;
+    float fast = FastStrtof(str, str + token.size(), &fast_end);
+    float libc = strtof(str, &libc_end);
+    if (std::isnan(libc)) {
+      EXPECT_TRUE(std::isnan(fast)) << token;
+    } else {
+      EXPECT_EQ(fast, libc) << token;
+    }
+    EXPECT_EQ(fast_end, libc_end) << token;
+  }
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+  int mismatch = 0;
+  for (int i = 0; i < 100000; ++i) {
+    std::string token = std::to_string(dist(rng));
+    char* end = nullptr;
+    float fast = FastStrtof(token.c_str(), token.c_str() + token.size(), &end);
+    mismatch += (fast != strtof(token.c_str(), nullptr));
+  }
+  EXPECT_EQ(mismatch, 0);
+}
+
+TEST(DataFeedTextParser, FindNextSpace) {
+  std::string line = "3 11 22 33";
+  const char* end = line.c_str() + line.size();
+  EXPECT_EQ(FindNextSpace(line.c_str(), end) - line.c_str(), 1);
+  EXPECT_EQ(FindNextSpace(line.c_str() + 8, end), end);
+  EXPECT_EQ(FindNextSpace(end, end), end);
+}
+
+namespace {
+
+const int kSlotNum = 40;
+const int kFeasignPerSlot = 4;
+const int kLineNum = 20000;
+
+std::vector<std::string> MakeSlotLines() {
+  std::mt19937_64 rng(0);
+  std::vector<std::string> lines;
+  lines.reserve(kLineNum);
+  for (int i = 0; i < kLineNum; ++i) {
+    std::string line = "1 " + std::to_string((rng() % 1000) / 1000.0f);
+    for (int slot = 0; slot < kSlotNum; ++slot) {
+      line += " " + std::to_string(kFeasignPerSlot);
+      for (int j = 0; j < kFeasignPerSlot; ++j) {
+        line += " " + std::to_string(rng() >> (rng() % 40));
+      }
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// a label slot followed by uint64 slots, as SlotRecord lines are laid out
+template <bool kFast>
+uint64_t ParseSlotLine(const std::string& line) {
+  const char* str = line.c_str();
+  const char* line_end = str + line.size();
+  char* endptr = const_cast<char*>(str);
+  uint64_t checksum = 0;
+  auto to_uint64 = [&](char* p) {
+    return kFast ? FastStrtoull(p, line_end, &endptr)
+                 : strtoull(p, &endptr, 10);
+  };
+  uint64_t num = to_uint64(endptr);
+  for (uint64_t j = 0; j < num; ++j) {
+    float label = kFast ? FastStrtof(endptr, line_end, &endptr)
+                        : strtof(endptr, &endptr);
+    checksum += static_cast<uint64_t>(label * 1000);
+  }
+  for (int slot = 0; slot < kSlotNum; ++slot) {
+    num = to_uint64(endptr);
+    for (uint64_t j = 0; j < num; ++j) {
+      checksum += to_uint64(endptr);
+    }
+  }
+  return checksum;
+}
+
+template <bool kFast>
+double RecordsPerSecondPerCore(const std::vector<std::string>& lines,
+                               int thread_num,
+                               uint64_t* checksum) {
+  std::vector<std::thread> threads;
+  std::vector<double> seconds(thread_num, 0.0);
+  std::vector<uint64_t> sums(thread_num, 0);
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      auto begin = std::chrono::steady_clock::now();
+      for (auto& line : lines) {
+        sums[t] += ParseSlotLine<kFast>(line);
+      }
+      auto end = std::chrono::steady_clock::now();
+      seconds[t] = std::chrono::duration<double>(end - begin).count();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  *checksum = sums[0];
+  double total = 0.0;
+  for (auto s : seconds) {
+    total += lines.size() / s;
+  }
+  return total / thread_num;
+}
+
+}  // namespace
+
+TEST(DataFeedTextParser, SlotLineThroughput) {
+  auto lines = MakeSlotLines();
+  int thread_num = std::max(
+      1, std::min(4, static_cast<int>(std::thread::hardware_concurrency())));
+  uint64_t libc_sum = 0;
+  uint64_t fast_sum = 0;
+  double libc = RecordsPerSecondPerCore<false>(lines, thread_num, &libc_sum);
+  double fast = RecordsPerSecondPerCore<true>(lines, thread_num, &fast_sum);
+  EXPECT_EQ(libc_sum, fast_sum);
+  std::cout << "slot lines with " << kSlotNum << " slots x "
+            << kFeasignPerSlot << " feasigns, threads " << thread_num
+            << std::endl
+            << "  strtoull/strtof : " << libc << " records/s per core"
+            << std::endl
+            << "  fast parser     : " << fast << " records/s per core"
+            << std::endl;
+}
+
+}  // namespace framework
+}  // namespace paddle
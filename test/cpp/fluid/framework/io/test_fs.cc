@@ -14,10 +14,17 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <fstream>
+#include <string>
 
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/io/fs.h"
 
+COMMON_DECLARE_int64(hdfs_native_read_chunk_size);
+
 #if defined _WIN32 || defined __APPLE__
 #else
 #define _LINUX
@@ -60,3 +67,72 @@ TEST(FS, mv) {
 
 #endif
 }
+
+#ifdef _LINUX
+class MemoryReader : public paddle::framework::FsRandomReader {
+ public:
+  explicit MemoryReader(const std::string& data) : data_(data) {}
+  int64_t size() override { return data_.size(); }
+  int64_t pread(int64_t offset, char* data, size_t size) override {
+    ++reads_;
+    // short reads, the stream has to loop until the chunk is full
+    size = std::min<size_t>(size, 1000);
+    size = std::min<size_t>(size, data_.size() - offset);
+    memcpy(data, data_.data() + offset, size);
+    return size;
+  }
+  std::atomic<int> reads_{0};
+
+ private:
+  std::string data_;
+};
+
+class MemoryBackend : public paddle::framework::FsBackend {
+ public:
+  explicit MemoryBackend(const std::string& data)
+      : reader_(std::make_shared<MemoryReader>(data)) {}
+  std::shared_ptr<paddle::framework::FsRandomReader> open_random_read(
+      const std::string& path) override {
+    if (path.find("none") != std::string::npos) {
+      return nullptr;
+    }
+    return reader_;
+  }
+  std::shared_ptr<MemoryReader> reader_;
+};
+#endif
+
+TEST(FS, native_backend) {
+#ifdef _LINUX
+  std::string data;
+  for (int i = 0; i < 20000; ++i) {
+    data += "line " + std::to_string(i) + "\n";
+  }
+  auto backend = std::make_shared<MemoryBackend>(data);
+  paddle::framework::fs_register_backend("afs:", backend);
+  FLAGS_hdfs_native_read_chunk_size = 4096;
+
+  int err_no = -1;
+  auto fp = paddle::framework::fs_open_read("afs:/data", &err_no, "", true);
+  ASSERT_NE(fp, nullptr);
+  EXPECT_EQ(err_no, 0);
+  std::string read_back;
+  char buffer[777];
+  size_t n = 0;
+  while ((n = fread(buffer, 1, sizeof(buffer), fp.get())) > 0) {
+    read_back.append(buffer, n);
+  }
+  EXPECT_EQ(read_back, data);
+  EXPECT_GT(backend->reader_->reads_.load(), 1);
+
+  // empty file ends right away
+  paddle::framework::fs_register_backend(
+      "afs:", std::make_shared<MemoryBackend>(""));
+  fp = paddle::framework::fs_open_read("afs:/empty", &err_no, "", true);
+  ASSERT_NE(fp, nullptr);
+  EXPECT_EQ(fread(buffer, 1, sizeof(buffer), fp.get()), 0UL);
+
+  paddle::framework::fs_register_backend("afs:", nullptr);
+  EXPECT_EQ(paddle::framework::fs_get_backend("afs:/data"), nullptr);
+#endif
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/fluid/framework/mpmc_ring.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace paddle {
+namespace framework {
+
+TEST(MPMCRing, SingleThread) {
+  MPMCRing<int> ring(3);
+  EXPECT_EQ(ring.Capacity(), 3UL);
+  EXPECT_TRUE(ring.Empty());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(ring.TryPush(i));
+  }
+  EXPECT_FALSE(ring.TryPush(3));
+  EXPECT_EQ(ring.Size(), 3UL);
+  // wrap around several rounds in order
+  for (int i = 0; i < 10; ++i) {
+    int val = -1;
+    EXPECT_TRUE(ring.TryPop(&val));
+    EXPECT_EQ(val, i);
+    EXPECT_TRUE(ring.TryPush(i + 3));
+  }
+}
+
+TEST(MPMCRing, MoveOnly) {
+  MPMCRing<std::unique_ptr<int>> ring(2);
+  EXPECT_TRUE(ring.Push(std::make_unique<int>(7)));
+  std::unique_ptr<int> val;
+  EXPECT_TRUE(ring.Pop(&val));
+  EXPECT_EQ(*val, 7);
+}
+
+TEST(MPMCRing, MultiProducerMultiConsumer) {
+  constexpr int kThreads = 4;
+  constexpr int64_t kPerThread = 20000;
+  MPMCRing<int64_t> ring(16);
+  std::vector<std::thread> producers;
+  std::vector<std::thread> consumers;
+  std::vector<int64_t> sums(kThreads, 0);
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&ring, t]() {
+      for (int64_t i = 0; i < kPerThread; ++i) {
+        ring.Push(t * kPerThread + i);
+      }
+    });
+    consumers.emplace_back([&ring, &sums, t]() {
+      int64_t val = 0;
+      while (ring.Pop(&val)) {
+        sums[t] += val;
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ring.Close();
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  int64_t total = 0;
+  for (auto sum : sums) {
+    total += sum;
+  }
+  int64_t n = kThreads * kPerThread;
+  EXPECT_EQ(total, n * (n - 1) / 2);
+}
+
+TEST(MPMCRing, Batch) {
+  MPMCRing<int> ring(4);
+  std::vector<int> in = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  std::thread producer([&]() {
+    EXPECT_EQ(ring.PushBatch(in.data(), in.size()), in.size());
+  });
+  std::vector<int> out;
+  std::vector<int> buf(3);
+  while (out.size() < in.size()) {
+    size_t n = ring.PopBatch(buf.data(), buf.size());
+    EXPECT_GT(n, 0UL);
+    out.insert(out.end(), buf.begin(), buf.begin() + n);
+  }
+  producer.join();
+  EXPECT_EQ(out, in);
+}
+
+TEST(MPMCRing, CloseAndTimeout) {
+  MPMCRing<int> ring(2);
+  int val = 0;
+  EXPECT_FALSE(ring.PopFor(&val, 10));
+  EXPECT_TRUE(ring.Push(1));
+  ring.Close();
+  EXPECT_FALSE(ring.Push(2));
+  // values pushed before Close are still delivered
+  EXPECT_TRUE(ring.Pop(&val));
+  EXPECT_EQ(val, 1);
+  EXPECT_FALSE(ring.Pop(&val));
+  ring.Open();
+  EXPECT_TRUE(ring.Push(3));
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -42,7 +42,10 @@ TEST(NaiveExecutor, Basic) {
 
   auto place = phi::CPUPlace();
   NaiveExecutor exe(place);
-  exe.Prepare(nullptr, program, 0, false);
+  Scope root;
+  Scope* scope = &root.NewScope();
+  exe.CreateVariables(program, 0, false, scope);
+  exe.Prepare(scope, program, 0);
   auto* a_tensor = exe.FindTensor("a");
   auto* b_tensor = exe.FindTensor("b");
   auto* c_tensor = exe.FindTensor("c");
@@ -67,6 +70,54 @@ TEST(NaiveExecutor, Basic) {
   }
 }
 
+TEST(NaiveExecutor, InterOpParallel) {
+  // c = (a + b) + b and d = (a + a) + b run in parallel, e = c + d
+  ProgramDesc program;
+  auto* main_block = program.MutableBlock(0);
+  for (auto name : {"a", "b", "c0", "c", "d0", "d", "e"}) {
+    main_block->Var(name)->SetType(proto::VarType::DENSE_TENSOR);
+  }
+  auto add = [&](const std::string& x,
+                 const std::string& y,
+                 const std::string& out) {
+    auto* op = main_block->AppendOp();
+    op->SetType("elementwise_add");
+    op->SetInput("X", {x});
+    op->SetInput("Y", {y});
+    op->SetOutput("Out", {out});
+  };
+  add("a", "b", "c0");
+  add("a", "a", "d0");
+  add("c0", "b", "c");
+  add("d0", "b", "d");
+  add("c", "d", "e");
+
+  auto place = phi::CPUPlace();
+  NaiveExecutor exe(place);
+  Scope root;
+  Scope* scope = &root.NewScope();
+  exe.CreateVariables(program, 0, false, scope);
+  exe.Prepare(scope, program, 0);
+  exe.EnableInterOpParallel(2, 2);
+
+  auto* a_tensor = exe.FindTensor("a");
+  auto* b_tensor = exe.FindTensor("b");
+  a_tensor->Resize({1, 4});
+  b_tensor->Resize({1, 4});
+  float a_arr[] = {0, 1, 2, 3};
+  float b_arr[] = {0.0, .1, .2, .3};
+  std::copy_n(a_arr, 4, a_tensor->mutable_data<float>(place));
+  std::copy_n(b_arr, 4, b_tensor->mutable_data<float>(place));
+
+  for (int run = 0; run < 3; ++run) {
+    exe.Run();
+    auto* e_data = exe.FindTensor("e")->data<float>();
+    for (int i = 0; i < 4; i++) {
+      EXPECT_NEAR(e_data[i], 3 * a_arr[i] + 3 * b_arr[i], 1e-3);
+    }
+  }
+}
+
 }  // namespace framework
 }  // namespace paddle
 
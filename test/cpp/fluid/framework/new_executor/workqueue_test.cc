@@ -142,6 +142,33 @@ TEST(WorkQueue, TestMultiThreadedWorkQueue) {
   EXPECT_EQ(handle.get(), 5678);
 }
 
+TEST(WorkQueue, TestLocalityAwareStealing) {
+  using paddle::framework::CreateMultiThreadedWorkQueue;
+  using paddle::framework::EventsWaiter;
+  using paddle::framework::WorkQueueOptions;
+  std::atomic<unsigned> counter{0};
+  constexpr unsigned kTaskNum = 1000;
+  EventsWaiter events_waiter;
+  WorkQueueOptions options(/*name*/ "LocalityWorkQueueForTesting",
+                           /*num_threads*/ 8,
+                           /*allow_spinning*/ true,
+                           /*always_spinning*/ false,
+                           /*track_task*/ true,
+                           /*detached*/ true,
+                           &events_waiter);
+  options.steal_group_size = 3;
+  auto work_queue = CreateMultiThreadedWorkQueue(options);
+  EXPECT_EQ(work_queue->Stats().local_tasks, 0u);
+  EXPECT_EQ(work_queue->Stats().stolen_tasks, 0u);
+  for (unsigned i = 0; i < kTaskNum; ++i) {
+    work_queue->AddTask([&counter]() { ++counter; });
+  }
+  EXPECT_EQ(events_waiter.WaitEvent(), paddle::framework::kQueueEmptyEvent);
+  EXPECT_EQ(counter.load(), kTaskNum);
+  auto stats = work_queue->Stats();
+  EXPECT_EQ(stats.local_tasks + stats.stolen_tasks, kTaskNum);
+}
+
 TEST(WorkQueue, TestWorkQueueGroup) {
   using paddle::framework::CreateWorkQueueGroup;
   using paddle::framework::EventsWaiter;
@@ -77,3 +77,38 @@ TEST(Scope, GetAllNames) {
 
   EXPECT_STREQ("a", str.c_str());
 }
+
+TEST(Scope, Arena) {
+  Scope s;
+  s.EnableArena(/*block_size=*/2);
+  EXPECT_TRUE(s.IsArenaEnabled());
+  Variable* a = s.Var("a");
+  Variable* b = s.Var("b");
+  Variable* c = s.Var("c");
+  EXPECT_EQ(a, s.FindVar("a"));
+  EXPECT_EQ(c, s.FindVar("c"));
+  b->GetMutable<phi::DenseTensor>();
+  s.EraseVars({"b"});
+  EXPECT_EQ(nullptr, s.FindVar("b"));
+  s.Rename("c", "d");
+  EXPECT_EQ(c, s.FindVar("d"));
+
+  s.ResetArena();
+  EXPECT_EQ(0u, s.Size());
+  EXPECT_EQ(nullptr, s.FindVar("a"));
+  // The arena memory is reused after reset.
+  EXPECT_EQ(a, s.Var("e"));
+}
+
+TEST(Scope, VarIndex) {
+  Scope s;
+  size_t a_idx = s.VarIndex("a");
+  size_t b_idx = s.VarIndex("b");
+  EXPECT_NE(a_idx, b_idx);
+  EXPECT_EQ(a_idx, s.VarIndex("a"));
+  EXPECT_EQ(s.FindVar("a"), s.VarAt(a_idx));
+  EXPECT_EQ(s.FindVar("b"), s.VarAt(b_idx));
+  s.EraseVars({"a"});
+  EXPECT_EQ(nullptr, s.VarAt(a_idx));
+  EXPECT_EQ(s.FindVar("b"), s.VarAt(b_idx));
+}
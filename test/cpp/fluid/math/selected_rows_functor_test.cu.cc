@@ -14,6 +14,11 @@ limitations under the License. */
 
 #include "paddle/phi/kernels/funcs/selected_rows_functor.h"
 
+#include <chrono>  // NOLINT
+#include <random>
+#include <vector>
+
+#include "glog/logging.h"
 #include "gtest/gtest.h"
 #include "paddle/common/errors.h"
 #include "paddle/phi/backends/context_pool.h"
@@ -283,3 +288,94 @@ TEST(selected_rows_functor, gpu_merge_add) {
     }
   }
 }
+
+TEST(selected_rows_functor, gpu_merge_add_duplicated_rows) {
+  phi::GPUPlace gpu_place(0);
+  phi::CPUPlace cpu_place;
+  phi::GPUContext& ctx = *reinterpret_cast<phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(gpu_place));
+
+  int64_t height = 10;
+  int64_t row_numel = 300;
+
+  // 4 merged rows for 10 input rows, merged by segments
+  std::vector<int64_t> rows{7, 1, 7, 4, 1, 7, 9, 1, 7, 4};
+  phi::SelectedRows input(rows, height);
+  phi::DenseTensor input_cpu;
+  float* input_cpu_data = input_cpu.mutable_data<float>(
+      common::make_ddim({static_cast<int64_t>(rows.size()), row_numel}),
+      cpu_place);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    for (int64_t j = 0; j < row_numel; ++j) {
+      input_cpu_data[i * row_numel + j] = static_cast<float>(i + j);
+    }
+  }
+  phi::Copy(ctx, input_cpu, gpu_place, true, input.mutable_value());
+
+  phi::SelectedRows output;
+  phi::funcs::scatter::MergeAdd<phi::GPUContext, float> merge_add_functor;
+  merge_add_functor(ctx, input, &output);
+
+  phi::DenseTensor output_cpu;
+  phi::Copy(ctx, output.value(), cpu_place, true, &output_cpu);
+
+  std::vector<int64_t> ret_rows{1, 4, 7, 9};
+  EXPECT_EQ(output.rows(), ret_rows);
+  EXPECT_EQ(output.value().dims(), common::make_ddim({4, row_numel}));
+  auto* out_data = output_cpu.data<float>();
+  for (size_t k = 0; k < ret_rows.size(); ++k) {
+    for (int64_t j = 0; j < row_numel; ++j) {
+      float expected = 0;
+      for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i] == ret_rows[k]) {
+          expected += input_cpu_data[i * row_numel + j];
+        }
+      }
+      EXPECT_EQ(out_data[k * row_numel + j], expected);
+    }
+  }
+}
+
+TEST(selected_rows_functor, gpu_merge_add_benchmark) {
+  phi::GPUPlace gpu_place(0);
+  phi::GPUContext& ctx = *reinterpret_cast<phi::GPUContext*>(
+      phi::DeviceContextPool::Instance().Get(gpu_place));
+  phi::funcs::SetConstant<phi::GPUContext, float> set_const;
+
+  constexpr int repeat = 10;
+  int64_t rows_num = 1 << 17;
+  int64_t row_numel = 64;
+  std::mt19937 rng(2024);
+  // the number of input rows for every merged row
+  for (int64_t duplication : {1, 2, 8, 64}) {
+    const int64_t height = rows_num / duplication;
+    std::uniform_int_distribution<int64_t> dist(0, height - 1);
+    std::vector<int64_t> rows(rows_num);
+    for (auto& row : rows) {
+      row = dist(rng);
+    }
+    phi::SelectedRows input(rows, height);
+    auto* in_value = input.mutable_value();
+    in_value->mutable_data<float>(common::make_ddim({rows_num, row_numel}),
+                                  gpu_place);
+    set_const(ctx, in_value, 1.0);
+
+    phi::funcs::scatter::MergeAdd<phi::GPUContext, float> merge_add_functor;
+    phi::SelectedRows output;
+    merge_add_functor(ctx, input, &output);
+    ctx.Wait();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i) {
+      phi::SelectedRows out;
+      merge_add_functor(ctx, input, &out);
+    }
+    ctx.Wait();
+    auto end = std::chrono::steady_clock::now();
+    VLOG(3) << "Duplication ratio " << duplication << ", " << rows_num
+            << " rows to " << output.rows().size() << " rows: merge add takes "
+            << std::chrono::duration<double, std::micro>(end - start).count() /
+                   repeat
+            << " us";
+  }
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/size_class_allocator.h"
+
+#include <cstdlib>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/allocation/aligned_allocator.h"
+#include "paddle/phi/core/memory/allocation/auto_growth_best_fit_allocator.h"
+#include "paddle/phi/core/memory/stats.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+class CountedAllocator : public Allocator {
+ public:
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t AllocateCount() const { return allocate_count_; }
+
+  size_t FreeCount() const { return free_count_; }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    ++allocate_count_;
+    return new Allocation(malloc(size), size, phi::CPUPlace());  // NOLINT
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    ++free_count_;
+    free(allocation->ptr());  // NOLINT
+    delete allocation;
+  }
+
+ private:
+  std::atomic<size_t> allocate_count_{0};
+  std::atomic<size_t> free_count_{0};
+};
+
+TEST(SizeClassAllocator, SizeClasses) {
+  auto counted_allocator = std::make_shared<CountedAllocator>();
+  SizeClassAllocator allocator(
+      counted_allocator, phi::CPUPlace(), 256, 1 << 20, 4);
+
+  ASSERT_GT(allocator.NumSizeClasses(), 0UL);
+  ASSERT_EQ(allocator.SizeClassSize(0), 256UL);
+  for (size_t i = 1; i < allocator.NumSizeClasses(); ++i) {
+    size_t prev = allocator.SizeClassSize(i - 1);
+    size_t cur = allocator.SizeClassSize(i);
+    ASSERT_GT(cur, prev);
+    ASSERT_EQ(cur % 256, 0UL);
+    // At most 25% internal fragmentation beyond the alignment.
+    ASSERT_LE(cur - prev, std::max<size_t>(256, prev / 4));
+  }
+
+  ASSERT_EQ(allocator.SizeClassIndex(1), 0);
+  ASSERT_EQ(allocator.SizeClassIndex(256), 0);
+  ASSERT_EQ(allocator.SizeClassIndex(257), 1);
+  ASSERT_EQ(allocator.SizeClassIndex((1 << 20) + 1), -1);
+}
+
+TEST(SizeClassAllocator, ReuseCachedBlocks) {
+  auto counted_allocator = std::make_shared<CountedAllocator>();
+  auto allocator = std::make_shared<SizeClassAllocator>(
+      counted_allocator, phi::CPUPlace(), 256, 1 << 20, 4);
+
+  {
+    auto allocation = allocator->Allocate(1000);
+    ASSERT_EQ(allocation->size(), 1024UL);
+  }
+  ASSERT_EQ(counted_allocator->AllocateCount(), 1UL);
+  ASSERT_EQ(counted_allocator->FreeCount(), 0UL);
+  ASSERT_EQ(HOST_MEMORY_STAT_CURRENT_VALUE(SizeClassCached, 0), 1024);
+
+  for (size_t i = 0; i < 10; ++i) {
+    auto allocation = allocator->Allocate(1024);
+    ASSERT_EQ(allocation->size(), 1024UL);
+  }
+  ASSERT_EQ(counted_allocator->AllocateCount(), 1UL);
+
+  // Larger than the largest size class, not cached.
+  { auto allocation = allocator->Allocate((1 << 20) + 1); }
+  ASSERT_EQ(counted_allocator->AllocateCount(), 2UL);
+  ASSERT_EQ(counted_allocator->FreeCount(), 1UL);
+
+  allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(counted_allocator->FreeCount(), 2UL);
+  ASSERT_EQ(HOST_MEMORY_STAT_CURRENT_VALUE(SizeClassCached, 0), 0);
+}
+
+TEST(SizeClassAllocator, MultiThread) {
+  auto counted_allocator = std::make_shared<CountedAllocator>();
+  auto underlying_allocator =
+      std::make_shared<AlignedAllocator>(counted_allocator, 256);
+  auto ag_allocator =
+      std::make_shared<AutoGrowthBestFitAllocator>(underlying_allocator, 256);
+  auto allocator = std::make_shared<SizeClassAllocator>(
+      ag_allocator, phi::CPUPlace(), 256, 1 << 16, 2);
+
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 8; ++i) {
+    threads.emplace_back([allocator, i]() {
+      std::vector<AllocationPtr> allocations;
+      for (size_t j = 0; j < 1000; ++j) {
+        allocations.emplace_back(allocator->Allocate((i + 1) * (j % 64 + 1)));
+        if (allocations.size() > 16) {
+          allocations.erase(allocations.begin());
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  allocator->Release(phi::CPUPlace());
+  ASSERT_EQ(counted_allocator->AllocateCount(),
+            counted_allocator->FreeCount());
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,95 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/stream_safe_allocator_base.h"
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/allocation/cpu_allocator.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+// An allocation used by a fake stream until the stream is marked as done.
+class FakeStreamAllocation : public Allocation {
+ public:
+  FakeStreamAllocation(DecoratedAllocationPtr underlying_allocation,
+                       const bool *stream_done)
+      : Allocation(underlying_allocation->ptr(),
+                   underlying_allocation->base_ptr(),
+                   underlying_allocation->size(),
+                   underlying_allocation->place()),
+        underlying_allocation_(std::move(underlying_allocation)),
+        stream_done_(stream_done) {}
+
+  bool CanBeFreed() { return *stream_done_; }
+
+ private:
+  DecoratedAllocationPtr underlying_allocation_;
+  const bool *stream_done_;
+};
+
+class FakeStreamSafeAllocator
+    : public StreamSafeAllocatorBase<FakeStreamAllocation> {
+ public:
+  FakeStreamSafeAllocator(std::shared_ptr<Allocator> underlying_allocator,
+                          const bool *stream_done)
+      : StreamSafeAllocatorBase<FakeStreamAllocation>(
+            std::move(underlying_allocator), phi::CPUPlace()),
+        stream_done_(stream_done) {}
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    return new FakeStreamAllocation(
+        static_unique_ptr_cast<Allocation>(AllocateUnderlying(size)),
+        stream_done_);
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    FreeOrDefer(static_cast<FakeStreamAllocation *>(allocation));
+  }
+
+ private:
+  const bool *stream_done_;
+};
+
+TEST(StreamSafeAllocatorBase, DeferredFree) {
+  bool stream_done = false;
+  FakeStreamSafeAllocator allocator(std::make_shared<CPUAllocator>(),
+                                    &stream_done);
+
+  constexpr size_t kSize = 1024;
+  allocator.Allocate(kSize).reset();
+  allocator.Allocate(kSize).reset();
+  StreamSafeAllocatorStats stats = allocator.GetStats();
+  EXPECT_EQ(stats.deferred_free_count, 2UL);
+  EXPECT_EQ(stats.deferred_bytes, 2 * kSize);
+  EXPECT_EQ(stats.peak_deferred_bytes, 2 * kSize);
+
+  // The deferred allocations are released once the stream is done.
+  stream_done = true;
+  allocator.Release(phi::CPUPlace());
+  stats = allocator.GetStats();
+  EXPECT_EQ(stats.deferred_free_count, 2UL);
+  EXPECT_EQ(stats.deferred_bytes, 0UL);
+  EXPECT_EQ(stats.peak_deferred_bytes, 2 * kSize);
+
+  allocator.Allocate(kSize).reset();
+  EXPECT_EQ(allocator.GetStats().deferred_free_count, 2UL);
+  EXPECT_EQ(allocator.GetStats().alloc_retry_count, 0UL);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,146 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "paddle/phi/core/memory/allocation/virtual_memory_auto_growth_best_fit_allocator.h"
+
+#include <cstring>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "paddle/phi/core/memory/stats.h"
+
+namespace paddle {
+namespace memory {
+namespace allocation {
+
+static constexpr size_t kPageSize = 4096;
+
+// Hands out page aligned chunks of a host arena one after another, like the
+// reserved address range of CUDAVirtualMemAllocator, and tracks which pages
+// are backed.
+class PagedArenaAllocator : public Allocator, public PhysicalPageReleaser {
+ public:
+  explicit PagedArenaAllocator(size_t page_num)
+      : arena_((page_num + 1) * kPageSize) {
+    base_ = reinterpret_cast<uint8_t *>(
+        AlignedSize(reinterpret_cast<uintptr_t>(arena_.data()), kPageSize));
+  }
+
+  bool IsAllocThreadSafe() const override { return true; }
+
+  size_t MappedPageNum() const { return mapped_pages_.size(); }
+
+  std::vector<std::pair<void *, size_t>> ReleasePhysicalPages(
+      const std::vector<std::pair<void *, size_t>> &ranges) override {
+    std::vector<std::pair<void *, size_t>> released;
+    for (auto &range : ranges) {
+      size_t begin = AlignedSize(PageOffset(range.first), kPageSize);
+      size_t end = (PageOffset(range.first) + range.second) / kPageSize *
+                   kPageSize;
+      size_t range_start = released.size();
+      for (size_t page = begin; page < end; page += kPageSize) {
+        if (mapped_pages_.erase(page) == 0) {
+          continue;
+        }
+        if (released.size() > range_start &&
+            PageOffset(released.back().first) + released.back().second ==
+                page) {
+          released.back().second += kPageSize;
+        } else {
+          released.emplace_back(base_ + page, kPageSize);
+        }
+      }
+    }
+    return released;
+  }
+
+ protected:
+  phi::Allocation *AllocateImpl(size_t size) override {
+    size = AlignedSize(size, kPageSize);
+    PADDLE_ENFORCE_LE(offset_ + size + kPageSize,
+                      arena_.size(),
+                      common::errors::ResourceExhausted("Arena used up."));
+    for (size_t page = offset_; page < offset_ + size; page += kPageSize) {
+      mapped_pages_.insert(page);
+    }
+    auto *allocation =
+        new Allocation(base_ + offset_, size, phi::GPUPlace(0));  // NOLINT
+    offset_ += size;
+    return allocation;
+  }
+
+  void FreeImpl(phi::Allocation *allocation) override {
+    size_t begin = PageOffset(allocation->ptr());
+    for (size_t page = begin; page < begin + allocation->size();
+         page += kPageSize) {
+      mapped_pages_.erase(page);
+    }
+    delete allocation;
+  }
+
+ private:
+  size_t PageOffset(const void *ptr) const {
+    return reinterpret_cast<const uint8_t *>(ptr) - base_;
+  }
+
+  std::vector<uint8_t> arena_;
+  uint8_t *base_;
+  size_t offset_{0};
+  std::set<size_t> mapped_pages_;
+};
+
+TEST(VirtualMemoryAutoGrowthBestFitAllocator, ReleaseFreePages) {
+  int64_t free_before = DEVICE_MEMORY_STAT_CURRENT_VALUE(VirtualMemoryFree, 0);
+  auto arena_allocator = std::make_shared<PagedArenaAllocator>(128);
+  {
+    VirtualMemoryAutoGrowthBestFitAllocator allocator(
+        arena_allocator, 256, phi::GPUPlace(0));
+    // each allocation grows the pool by a 17 pages chunk, 16 for the
+    // allocation and 1 for the alignment, left free in front of it
+    auto a = allocator.Allocate(16 * kPageSize);
+    auto b = allocator.Allocate(16 * kPageSize);
+    auto c = allocator.Allocate(16 * kPageSize);
+    ASSERT_EQ(arena_allocator->MappedPageNum(), 51UL);
+
+    // b merges with the free pages in front of it and in front of c, the
+    // free page in front of a is released too
+    b.reset();
+    ASSERT_EQ(allocator.Release(phi::GPUPlace(0)), 19 * kPageSize);
+    ASSERT_EQ(arena_allocator->MappedPageNum(), 32UL);
+    ASSERT_EQ(allocator.Release(phi::GPUPlace(0)), 0UL);
+    ASSERT_EQ(DEVICE_MEMORY_STAT_CURRENT_VALUE(VirtualMemoryFree, 0),
+              free_before);
+
+    // the released range is never handed out again
+    b = allocator.Allocate(16 * kPageSize);
+    ASSERT_EQ(arena_allocator->MappedPageNum(), 49UL);
+    memset(b->ptr(), 0, b->size());
+    ASSERT_EQ(DEVICE_MEMORY_STAT_CURRENT_VALUE(VirtualMemoryFree, 0),
+              free_before + static_cast<int64_t>(kPageSize));
+
+    a.reset();
+    b.reset();
+    c.reset();
+    ASSERT_EQ(allocator.Release(phi::GPUPlace(0)), 49 * kPageSize);
+    ASSERT_EQ(arena_allocator->MappedPageNum(), 0UL);
+  }
+  ASSERT_EQ(DEVICE_MEMORY_STAT_CURRENT_VALUE(VirtualMemoryFree, 0),
+            free_before);
+}
+
+}  // namespace allocation
+}  // namespace memory
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/onednn/onednn_context.h"
+#include "paddle/phi/backends/onednn/onednn_primitive_cache.h"
+
+COMMON_DECLARE_int64(onednn_shared_primitive_cache_capacity);
+
+namespace phi {
+
+TEST(OneDNNPrimitiveCache, key_without_executor_suffix) {
+  auto& tls = OneDNNContext::tls();
+  tls.set_primitive_cache_scope("");
+  EXPECT_EQ(OneDNNPrimitiveCache::Key("conv-1x3", "@fwd_p"), "");
+
+  // two executors of the same scope get the same key
+  tls.set_primitive_cache_scope("model");
+  tls.set_cur_input_shape_str("1-3-");
+  tls.set_key_suffix("");
+  std::string first = OneDNNPrimitiveCache::Key("conv-1x3", "@fwd_p");
+  tls.set_key_suffix("E1234");
+  EXPECT_EQ(OneDNNPrimitiveCache::Key("conv-1x3E1234", "@fwd_p"), first);
+
+  // but not another scope or another shape
+  tls.set_primitive_cache_scope("other");
+  EXPECT_NE(OneDNNPrimitiveCache::Key("conv-1x3E1234", "@fwd_p"), first);
+  tls.set_primitive_cache_scope("model");
+  tls.set_cur_input_shape_str("2-3-");
+  EXPECT_NE(OneDNNPrimitiveCache::Key("conv-1x3E1234", "@fwd_p"), first);
+
+  tls.set_primitive_cache_scope("");
+  tls.set_cur_input_shape_str("");
+  tls.set_key_suffix("");
+}
+
+TEST(OneDNNPrimitiveCache, share_and_evict) {
+  auto& cache = OneDNNPrimitiveCache::Instance();
+  auto before = cache.GetStats();
+  int64_t capacity = FLAGS_onednn_shared_primitive_cache_capacity;
+  FLAGS_onednn_shared_primitive_cache_capacity =
+      static_cast<int64_t>(before.num_entries) + 2;
+
+  EXPECT_EQ(cache.Get("test|a"), nullptr);
+  auto a = std::make_shared<int>(1);
+  EXPECT_EQ(cache.Insert("test|a", a, 100), a);
+  // the first primitive published wins
+  EXPECT_EQ(cache.Insert("test|a", std::make_shared<int>(2), 100), a);
+  EXPECT_EQ(cache.Get("test|a"), a);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, before.hits + 1);
+  EXPECT_EQ(stats.misses, before.misses + 1);
+  EXPECT_EQ(stats.num_entries, before.num_entries + 1);
+  EXPECT_EQ(stats.memory_bytes, before.memory_bytes + 100);
+
+  // above the capacity the oldest one is dropped
+  cache.Insert("test|b", std::make_shared<int>(3), 10);
+  cache.Insert("test|c", std::make_shared<int>(4), 10);
+  EXPECT_EQ(cache.Get("test|a"), nullptr);
+  EXPECT_NE(cache.Get("test|b"), nullptr);
+  EXPECT_EQ(cache.GetStats().memory_bytes, before.memory_bytes + 20);
+
+  cache.Erase("test");
+  EXPECT_EQ(cache.Get("test|b"), nullptr);
+  EXPECT_EQ(cache.GetStats().num_entries, before.num_entries);
+  FLAGS_onednn_shared_primitive_cache_capacity = capacity;
+}
+
+}  // namespace phi
@@ -74,6 +74,41 @@ void TestDeviceInterface(const phi::Place& place) {
   }
 }
 
+void TestSubmitCommands(const phi::Place& place) {
+  std::cout << "TestSubmitCommands on " << place << std::endl;
+  auto device = phi::DeviceManager::GetDeviceWithPlace(place);
+  phi::stream::Stream stream(place, nullptr);
+  std::array<uint8_t, 16> host_src, host_dst;
+  host_src.fill(3);
+  host_dst.fill(0);
+  auto dev_ptr = static_cast<uint8_t*>(device->MemoryAllocate(32));
+  bool called = false;
+
+  std::vector<phi::stream::Command> commands(4);
+  commands[0].type = phi::stream::Command::Type::kMemorySet;
+  commands[0].dst = dev_ptr;
+  commands[0].value = 7;
+  commands[0].size = 32;
+  commands[1].type = phi::stream::Command::Type::kMemoryCopyH2D;
+  commands[1].dst = dev_ptr;
+  commands[1].src = host_src.data();
+  commands[1].size = 8;
+  commands[2].type = phi::stream::Command::Type::kMemoryCopyD2H;
+  commands[2].dst = host_dst.data();
+  commands[2].src = dev_ptr;
+  commands[2].size = host_dst.size();
+  commands[3].type = phi::stream::Command::Type::kHostCallback;
+  commands[3].callback =
+      new phi::stream::Stream::Callback([&called]() { called = true; });
+  device->SubmitCommands(&stream, commands);
+
+  EXPECT_TRUE(called);
+  for (size_t i = 0; i < host_dst.size(); ++i) {
+    EXPECT_EQ(host_dst[i], i < 8 ? 3 : 7);
+  }
+  device->MemoryDeallocate(dev_ptr, 32);
+}
+
 void TestTensorMutableData(const phi::Place& place) {
   std::cout << "TestTensorInitialization on " << place << std::endl;
   phi::DenseTensor src_tensor;
@@ -230,6 +265,7 @@ TEST(CustomDevice, Tensor) {
     auto place = phi::PlaceHelper::CreatePlace(dev_type);
 
     TestDeviceInterface(place);
+    TestSubmitCommands(place);
     TestTensorMutableData(place);
     TestTensorShareDataWith(place);
     TestTensorUtils(place);
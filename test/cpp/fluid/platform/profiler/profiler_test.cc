@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <deque>
 #include <set>
 #include <string>
 
@@ -25,6 +26,7 @@
 #endif
 #include "paddle/fluid/platform/profiler/event_python.h"
 #include "paddle/fluid/platform/profiler/profiler.h"
+#include "paddle/phi/api/profiler/host_event_ring.h"
 #include "paddle/phi/common/place.h"
 #include "paddle/phi/core/platform/profiler.h"
 #include "paddle/phi/core/platform/profiler/event_tracing.h"
@@ -60,6 +62,40 @@ TEST(ProfilerTest, TestHostTracer) {
   EXPECT_EQ(host_events.count("TestTraceLevel_record2"), 0u);
 }
 
+TEST(ProfilerTest, TestHostEventRing) {
+  using phi::HostEventRing;
+  using phi::RecordEvent;
+  using phi::TracerEventType;
+  auto& ring = HostEventRing::GetInstance();
+  ring.Enable(/*events_per_thread=*/8, /*trace_level=*/1);
+  for (int i = 0; i < 20; ++i) {
+    RecordEvent event("TestHostEventRing_" + std::to_string(i),
+                      TracerEventType::UserDefined,
+                      1);
+  }
+  {
+    RecordEvent event(
+        "TestHostEventRing_level2", TracerEventType::UserDefined, 2);
+  }
+  ring.Disable();
+  {
+    RecordEvent event("TestHostEventRing_off", TracerEventType::UserDefined, 1);
+  }
+
+  std::deque<std::string> strs;
+  auto host_sec = ring.Snapshot(/*window_ns=*/60ULL * 1000000000ULL, &strs);
+  std::vector<std::string> names;
+  for (const auto& thr_sec : host_sec.thr_sections) {
+    for (const auto& event : thr_sec.events) {
+      names.emplace_back(event.name);
+    }
+  }
+  // only the latest 8 events are kept
+  ASSERT_EQ(names.size(), 8u);
+  EXPECT_EQ(names.front(), "TestHostEventRing_12");
+  EXPECT_EQ(names.back(), "TestHostEventRing_19");
+}
+
 TEST(ProfilerTest, TestCudaTracer) {
   using paddle::platform::Profiler;
   using paddle::platform::ProfilerOptions;
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <fstream>
+#include <iterator>
+
 #include "gtest/gtest.h"
 #include "paddle/fluid/framework/type_defs.h"
 #include "paddle/fluid/platform/profiler/chrometracing_logger.h"
@@ -388,3 +391,70 @@ TEST(NodeTreesTest, HandleTrees_case0) {
                    op_supplement_event_node_handle);
   logger.LogExtraInfo(std::unordered_map<std::string, std::string>());
 }
+
+TEST(NodeTreesTest, LogMemoryLifetime) {
+  std::list<HostTraceEvent> host_events;
+  std::list<RuntimeTraceEvent> runtime_events;
+  std::list<DeviceTraceEvent> device_events;
+  std::list<MemTraceEvent> mem_events;
+  std::list<OperatorSupplementEvent> op_supplement_events;
+  host_events.emplace_back(
+      std::string("op1"), TracerEventType::Operator, 11000, 20000, 10, 10);
+  host_events.emplace_back(
+      std::string("op2"), TracerEventType::Operator, 21000, 30000, 10, 10);
+  mem_events.emplace_back(11500,
+                          0x1000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          50,
+                          "GPU:0",
+                          50,
+                          50,
+                          50,
+                          50);
+  mem_events.emplace_back(21500,
+                          0x2000,
+                          TracerMemEventType::Allocate,
+                          10,
+                          10,
+                          30,
+                          "GPU:0",
+                          80,
+                          80,
+                          80,
+                          80);
+  mem_events.emplace_back(25000,
+                          0x1000,
+                          TracerMemEventType::Free,
+                          10,
+                          10,
+                          -50,
+                          "GPU:0",
+                          30,
+                          80,
+                          80,
+                          80);
+  std::string filename("test_nodetrees_log_memory_lifetime.json");
+  {
+    ChromeTracingLogger logger(filename);
+    logger.LogMetaInfo(std::string("1.0.2"), 0);
+    NodeTrees tree(host_events,
+                   runtime_events,
+                   device_events,
+                   mem_events,
+                   op_supplement_events);
+    tree.LogMe(&logger);
+    logger.LogExtraInfo(std::unordered_map<std::string, std::string>());
+  }
+  std::ifstream ifs(filename);
+  std::string content((std::istreambuf_iterator<char>(ifs)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find("\"name\": \"[memory] op1\""), std::string::npos);
+  EXPECT_NE(content.find("\"lifetime\": \"13.500 us\""), std::string::npos);
+  EXPECT_NE(content.find("\"name\": \"[memory peak] GPU:0\""),
+            std::string::npos);
+  EXPECT_NE(content.find("\"peak_allocated\": 80"), std::string::npos);
+  EXPECT_NE(content.find("\"op1\": 50"), std::string::npos);
+  EXPECT_NE(content.find("\"op2\": 30"), std::string::npos);
+}
@@ -206,6 +206,61 @@ TEST(PD_Tensor, from_buffer) {
   PD_ConfigDestroy(config);
 }
 
+void CountRun(void* user_data, PD_Bool success) {
+  EXPECT_TRUE(success);
+  ++*static_cast<int*>(user_data);
+}
+
+TEST(PD_Tensor, share_external_data_run_async) {
+  auto model_dir = FLAGS_infer_model;
+  PD_Config* config = PD_ConfigCreate();
+  PD_ConfigSetModel(config,
+                    (model_dir + "/__model__").c_str(),
+                    (model_dir + "/__params__").c_str());
+  PD_Predictor* predictor = PD_PredictorCreate(config);
+  PD_OneDimArrayCstr* input_names = PD_PredictorGetInputNames(predictor);
+  PD_Tensor* tensor =
+      PD_PredictorGetInputHandle(predictor, input_names->data[0]);
+  std::array<int32_t, 4> shapes = {1, 3, 224, 224};
+  std::vector<float> input(1 * 3 * 224 * 224, 1.0f);
+  PD_TensorShareExternalDataFloat(
+      tensor, input.data(), shapes.size(), shapes.data(), PD_PLACE_CPU);
+  PD_PredictorRun(predictor);
+
+  PD_OneDimArrayCstr* output_names = PD_PredictorGetOutputNames(predictor);
+  PD_Tensor* output_tensor =
+      PD_PredictorGetOutputHandle(predictor, output_names->data[0]);
+  PD_OneDimArrayInt32* output_shape = PD_TensorGetShape(output_tensor);
+  int32_t out_num = std::accumulate(output_shape->data,
+                                    output_shape->data + output_shape->size,
+                                    1,
+                                    std::multiplies<>());
+  std::vector<float> expected(out_num);
+  PD_TensorCopyToCpuFloat(output_tensor, expected.data());
+
+  std::vector<float> output(out_num, 0.0f);
+  PD_TensorShareExternalDataFloat(output_tensor,
+                                  output.data(),
+                                  output_shape->size,
+                                  output_shape->data,
+                                  PD_PLACE_CPU);
+  int finished = 0;
+  PD_PredictorRunAsync(predictor, CountRun, &finished);
+  PD_PredictorRunAsync(predictor, CountRun, &finished);
+  PD_PredictorWaitAsync(predictor);
+  EXPECT_EQ(finished, 2);
+  for (int32_t i = 0; i < out_num; ++i) {
+    EXPECT_NEAR(output[i], expected[i], 1e-5);
+  }
+
+  PD_OneDimArrayInt32Destroy(output_shape);
+  PD_TensorDestroy(output_tensor);
+  PD_OneDimArrayCstrDestroy(output_names);
+  PD_TensorDestroy(tensor);
+  PD_OneDimArrayCstrDestroy(input_names);
+  PD_PredictorDestroy(predictor);
+}
+
 }  // namespace analysis
 }  // namespace inference
 }  // namespace paddle
@@ -0,0 +1,136 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "paddle/fluid/inference/api/serving/batch_policy.h"
+
+namespace paddle {
+namespace inference {
+namespace serving {
+
+namespace {
+
+PaddleTensor MakeFloatTensor(const std::string& name,
+                             const std::vector<int>& shape,
+                             const std::vector<float>& data,
+                             const std::vector<std::vector<size_t>>& lod = {}) {
+  PaddleTensor tensor;
+  tensor.name = name;
+  tensor.shape = shape;
+  tensor.dtype = PaddleDType::FLOAT32;
+  tensor.lod = lod;
+  tensor.data.Resize(data.size() * sizeof(float));
+  std::memcpy(tensor.data.data(), data.data(), data.size() * sizeof(float));
+  return tensor;
+}
+
+std::vector<float> Data(const PaddleTensor& tensor) {
+  const auto* data = static_cast<const float*>(tensor.data.data());
+  return std::vector<float>(data, data + tensor.data.length() / sizeof(float));
+}
+
+}  // namespace
+
+TEST(BatchPolicy, full_and_preferred_batches) {
+  BatchPolicy policy(8, {4, 2, 16, 4}, false);
+  EXPECT_EQ(policy.preferred_batch_sizes(), (std::vector<int>{2, 4}));
+
+  // waits for more until the oldest request times out
+  EXPECT_EQ(policy.NumRequestsToRun({1}, false), 0UL);
+  EXPECT_EQ(policy.NumRequestsToRun({1}, true), 1UL);
+  // the largest prefix on a preferred size runs at once
+  EXPECT_EQ(policy.NumRequestsToRun({1, 1, 2, 1}, false), 3UL);
+  // a full batch runs at once, the next request does not fit
+  EXPECT_EQ(policy.NumRequestsToRun({3, 5, 1}, false), 2UL);
+  EXPECT_EQ(policy.NumRequestsToRun({3, 3, 3}, false), 2UL);
+  EXPECT_EQ(policy.NumRequestsToRun({3, 3, 3}, true), 2UL);
+}
+
+TEST(BatchPolicy, padded_rows) {
+  BatchPolicy policy(8, {2, 4}, true);
+  EXPECT_EQ(policy.PaddedRows(1), 2);
+  EXPECT_EQ(policy.PaddedRows(3), 4);
+  EXPECT_EQ(policy.PaddedRows(4), 4);
+  EXPECT_EQ(policy.PaddedRows(5), 5);
+  EXPECT_EQ(BatchPolicy(8, {2, 4}, false).PaddedRows(3), 3);
+}
+
+TEST(PackBatch, pad_and_split) {
+  // [1, 2] and [2, 3], padded to [4, 3] with a padding row
+  std::vector<PaddleTensor> a{MakeFloatTensor("x", {1, 2}, {1, 2})};
+  std::vector<PaddleTensor> b{
+      MakeFloatTensor("x", {2, 3}, {3, 4, 5, 6, 7, 8})};
+  EXPECT_EQ(NumBatchRows(a), 1);
+  EXPECT_EQ(NumBatchRows(b), 2);
+
+  auto batch = PackBatch({&a, &b}, 4);
+  ASSERT_EQ(batch.size(), 1UL);
+  EXPECT_EQ(batch[0].shape, (std::vector<int>{4, 3}));
+  EXPECT_EQ(Data(batch[0]),
+            (std::vector<float>{1, 2, 0, 3, 4, 5, 6, 7, 8, 0, 0, 0}));
+
+  auto outputs = SplitBatch({MakeFloatTensor("y", {4, 1}, {10, 20, 30, 40})},
+                            {1, 2});
+  ASSERT_EQ(outputs.size(), 2UL);
+  EXPECT_EQ(outputs[0][0].shape, (std::vector<int>{1, 1}));
+  EXPECT_EQ(Data(outputs[0][0]), (std::vector<float>{10}));
+  EXPECT_EQ(outputs[1][0].shape, (std::vector<int>{2, 1}));
+  EXPECT_EQ(Data(outputs[1][0]), (std::vector<float>{20, 30}));
+}
+
+TEST(PackBatch, ragged_lod) {
+  // two sequences of 1 and 2 rows, and one of 3 rows
+  std::vector<PaddleTensor> a{
+      MakeFloatTensor("words", {3, 1}, {1, 2, 3}, {{0, 1, 3}})};
+  std::vector<PaddleTensor> b{
+      MakeFloatTensor("words", {3, 1}, {4, 5, 6}, {{0, 3}})};
+  EXPECT_EQ(NumBatchRows(a), 2);
+  EXPECT_EQ(NumBatchRows(b), 1);
+
+  // no padding rows for LoD inputs
+  auto batch = PackBatch({&a, &b}, 4);
+  ASSERT_EQ(batch.size(), 1UL);
+  EXPECT_EQ(batch[0].shape, (std::vector<int>{6, 1}));
+  EXPECT_EQ(batch[0].lod,
+            (std::vector<std::vector<size_t>>{{0, 1, 3, 6}}));
+  EXPECT_EQ(Data(batch[0]), (std::vector<float>{1, 2, 3, 4, 5, 6}));
+
+  // an output per token splits by sequences, one per sequence by rows
+  auto outputs = SplitBatch(
+      {MakeFloatTensor("tags", {6, 1}, {1, 2, 3, 4, 5, 6}, {{0, 1, 3, 6}}),
+       MakeFloatTensor("pooled", {3, 1}, {7, 8, 9})},
+      {2, 1});
+  ASSERT_EQ(outputs.size(), 2UL);
+  EXPECT_EQ(outputs[0][0].lod, (std::vector<std::vector<size_t>>{{0, 1, 3}}));
+  EXPECT_EQ(Data(outputs[0][0]), (std::vector<float>{1, 2, 3}));
+  EXPECT_EQ(outputs[1][0].lod, (std::vector<std::vector<size_t>>{{0, 3}}));
+  EXPECT_EQ(Data(outputs[1][0]), (std::vector<float>{4, 5, 6}));
+  EXPECT_EQ(Data(outputs[0][1]), (std::vector<float>{7, 8}));
+  EXPECT_EQ(Data(outputs[1][1]), (std::vector<float>{9}));
+}
+
+TEST(PackBatch, mismatched_inputs) {
+  std::vector<PaddleTensor> a{MakeFloatTensor("x", {1, 2}, {1, 2})};
+  std::vector<PaddleTensor> b{MakeFloatTensor("z", {1, 2}, {1, 2})};
+  EXPECT_ANY_THROW(PackBatch({&a, &b}, 0));
+}
+
+}  // namespace serving
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,94 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <cstdio>
+#include <string>
+
+#include "paddle/fluid/inference/utils/engine_cache.h"
+
+namespace paddle {
+namespace inference {
+
+namespace {
+
+std::string MakeCacheDir(const std::string& name) {
+  std::string dir = "/tmp/" + name;
+  mkdir(dir.c_str(), 0755);
+  return dir;
+}
+
+bool Exists(const std::string& path) {
+  struct stat st;
+  return stat(path.c_str(), &st) == 0;
+}
+
+void SetAccessTime(const std::string& path, time_t time) {
+  struct utimbuf times {
+    time, time
+  };
+  utime(path.c_str(), &times);
+}
+
+}  // namespace
+
+TEST(EngineFileCache, store_and_load) {
+  EngineFileCache cache(MakeCacheDir("engine_cache_store"), "trt_", 0);
+  std::string data;
+  std::remove(cache.Path("a").c_str());
+  EXPECT_FALSE(cache.Load("a", &data));
+
+  {
+    auto lock = cache.LockForBuild("a");
+    cache.Store("a", "engine a");
+  }
+  ASSERT_TRUE(cache.Load("a", &data));
+  EXPECT_EQ(data, "engine a");
+  // a rebuilt engine replaces the old one
+  cache.Store("a", "engine a2");
+  ASSERT_TRUE(cache.Load("a", &data));
+  EXPECT_EQ(data, "engine a2");
+}
+
+TEST(EngineFileCache, evict_least_recently_used) {
+  // room for two engines of 8 bytes
+  EngineFileCache cache(MakeCacheDir("engine_cache_evict"), "trt_", 16);
+  for (const auto* key : {"a", "b", "c"}) {
+    std::remove(cache.Path(key).c_str());
+  }
+  cache.Store("a", "engine a");
+  cache.Store("b", "engine b");
+  SetAccessTime(cache.Path("a"), 100);
+  SetAccessTime(cache.Path("b"), 200);
+  // a load makes a the most recently used
+  std::string data;
+  ASSERT_TRUE(cache.Load("a", &data));
+
+  cache.Store("c", "engine c");
+  EXPECT_TRUE(Exists(cache.Path("a")));
+  EXPECT_FALSE(Exists(cache.Path("b")));
+  EXPECT_TRUE(Exists(cache.Path("c")));
+}
+
+TEST(StableHash, deterministic) {
+  EXPECT_EQ(StableHash(""), 14695981039346656037ULL);
+  EXPECT_EQ(StableHash("a"), 0xaf63dc4c8601ec8cULL);
+  EXPECT_NE(StableHash("a", 1), StableHash("a"));
+}
+
+}  // namespace inference
+}  // namespace paddle
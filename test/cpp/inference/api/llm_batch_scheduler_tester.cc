@@ -0,0 +1,365 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "paddle/fluid/inference/api/llm/batch_scheduler.h"
+#include "paddle/fluid/inference/api/llm/block_manager.h"
+
+namespace paddle {
+namespace inference {
+namespace llm {
+
+namespace {
+
+std::shared_ptr<Request> MakeRequest(int64_t id,
+                                     int prompt_len,
+                                     int max_new_tokens) {
+  auto request = std::make_shared<Request>();
+  request->id = id;
+  for (int i = 0; i < prompt_len; ++i) {
+    request->prompt_ids.push_back(100 * id + i);
+  }
+  request->max_new_tokens = max_new_tokens;
+  return request;
+}
+
+// every row samples token 7
+std::vector<std::shared_ptr<Request>> RunStep(
+    ContinuousBatchScheduler* scheduler, StepPlan* plan) {
+  *plan = scheduler->Schedule();
+  return scheduler->Update(*plan, std::vector<int64_t>(plan->rows(), 7));
+}
+
+}  // namespace
+
+TEST(KVCacheBlockManager, AllocateAndSwap) {
+  KVCacheBlockManager manager(/* num_gpu_blocks = */ 4,
+                              /* num_cpu_blocks = */ 2,
+                              /* block_size = */ 4);
+  EXPECT_TRUE(manager.Allocate(0, 5));
+  EXPECT_EQ(manager.BlockTable(0), (std::vector<int>{0, 1}));
+  EXPECT_TRUE(manager.Allocate(0, 8));
+  EXPECT_EQ(manager.BlockTable(0).size(), 2UL);
+  // all or nothing
+  EXPECT_FALSE(manager.Allocate(1, 13));
+  EXPECT_FALSE(manager.HasRequest(1));
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 2);
+
+  auto swap_out = manager.SwapOut(0);
+  ASSERT_EQ(swap_out.size(), 2UL);
+  EXPECT_EQ(swap_out[0].first, 0);
+  EXPECT_TRUE(manager.IsSwapped(0));
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 4);
+  EXPECT_EQ(manager.NumFreeCpuBlocks(), 0);
+
+  EXPECT_TRUE(manager.Allocate(1, 12));
+  EXPECT_FALSE(manager.CanSwapIn(0));
+  manager.Free(1);
+  auto swap_in = manager.SwapIn(0);
+  ASSERT_EQ(swap_in.size(), 2UL);
+  EXPECT_EQ(swap_in[0].first, swap_out[0].second);
+  EXPECT_FALSE(manager.IsSwapped(0));
+  EXPECT_EQ(manager.NumFreeCpuBlocks(), 2);
+  manager.Free(0);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 4);
+}
+
+TEST(KVCacheBlockManager, SharePrefix) {
+  KVCacheBlockManager manager(8, 0, 4, /* enable_prefix_caching = */ true);
+  std::vector<int64_t> system_prompt{1, 2, 3, 4, 5, 6, 7, 8};
+  std::vector<int64_t> prompt_a(system_prompt);
+  prompt_a.insert(prompt_a.end(), {10, 11});
+  std::vector<int64_t> prompt_b(system_prompt);
+  prompt_b.insert(prompt_b.end(), {20, 21, 22});
+
+  EXPECT_EQ(manager.NumCachedTokens(prompt_a), 0);
+  EXPECT_TRUE(manager.Allocate(0, prompt_a));
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 5);
+  // the full blocks of the system prompt are shared
+  EXPECT_EQ(manager.NumCachedTokens(prompt_b), 8);
+  EXPECT_EQ(manager.NumBlocksToAllocate(prompt_b), 1);
+  EXPECT_TRUE(manager.Allocate(1, prompt_b));
+  const auto& table_a = manager.BlockTable(0);
+  const auto& table_b = manager.BlockTable(1);
+  EXPECT_EQ(table_a[0], table_b[0]);
+  EXPECT_EQ(table_a[1], table_b[1]);
+  EXPECT_NE(table_a[2], table_b[2]);
+  EXPECT_EQ(manager.RefCount(table_a[0]), 2);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 4);
+  EXPECT_EQ(manager.num_prefix_hit_tokens(), 8);
+
+  // a different first block shares nothing, even with the same second one
+  std::vector<int64_t> prompt_c{9, 9, 9, 9, 5, 6, 7, 8};
+  EXPECT_EQ(manager.NumCachedTokens(prompt_c), 0);
+
+  // the cached blocks outlive the requests until their memory is needed
+  const int shared_block = table_a[0];
+  manager.Free(0);
+  manager.Free(1);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 8);
+  EXPECT_EQ(manager.NumCachedTokens(prompt_b), 8);
+  EXPECT_TRUE(manager.Allocate(2, prompt_b));
+  EXPECT_EQ(manager.BlockTable(2)[0], shared_block);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 5);
+  manager.Free(2);
+
+  // taking all blocks evicts the cached ones
+  std::vector<int64_t> long_prompt(32, 3);
+  EXPECT_TRUE(manager.Allocate(3, long_prompt));
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 0);
+  EXPECT_EQ(manager.NumCachedTokens(prompt_b), 0);
+}
+
+TEST(KVCacheBlockManager, CopyOnWrite) {
+  KVCacheBlockManager manager(4, 0, 4);
+  EXPECT_TRUE(manager.Allocate(0, 6));
+  manager.Fork(0, 1);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 2);
+  EXPECT_EQ(manager.RefCount(manager.BlockTable(0)[1]), 2);
+
+  // the seventh token goes to the shared second block
+  KVCacheBlockManager::BlockMapping copies;
+  EXPECT_EQ(manager.NumBlocksToGrow(1, 7), 1);
+  EXPECT_TRUE(manager.Allocate(1, 7, &copies));
+  ASSERT_EQ(copies.size(), 1UL);
+  EXPECT_EQ(copies[0].first, manager.BlockTable(0)[1]);
+  EXPECT_EQ(copies[0].second, manager.BlockTable(1)[1]);
+  EXPECT_EQ(manager.BlockTable(0)[0], manager.BlockTable(1)[0]);
+  EXPECT_EQ(manager.RefCount(manager.BlockTable(0)[1]), 1);
+
+  // the parent writes to its own block now
+  copies.clear();
+  EXPECT_TRUE(manager.Allocate(0, 7, &copies));
+  EXPECT_TRUE(copies.empty());
+  manager.Free(0);
+  manager.Free(1);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 4);
+}
+
+TEST(ContinuousBatchScheduler, MixPrefillWithDecode) {
+  KVCacheBlockManager manager(16, 0, 4);
+  SchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_num_batched_tokens = 8;
+  config.max_blocks_per_seq = 4;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  scheduler.AddRequest(MakeRequest(0, 6, 2));
+  scheduler.AddRequest(MakeRequest(1, 4, 3));
+
+  StepPlan plan;
+  // the second prompt is over the token budget of the first step
+  auto finished = RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 1);
+  EXPECT_EQ(plan.seq_lens_encoder, (std::vector<int>{6}));
+  EXPECT_EQ(plan.seq_lens_this_time, (std::vector<int>{6}));
+  EXPECT_EQ(plan.max_input_len, 6);
+  EXPECT_EQ(plan.input_ids[5], 5);
+  EXPECT_EQ(plan.block_tables, (std::vector<int>{0, 1, -1, -1}));
+  EXPECT_TRUE(finished.empty());
+
+  // the decode of the first request runs with the prompt of the second
+  finished = RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 2);
+  EXPECT_EQ(plan.seq_lens_encoder, (std::vector<int>{0, 4}));
+  EXPECT_EQ(plan.seq_lens_decoder, (std::vector<int>{6, 0}));
+  EXPECT_EQ(plan.seq_lens_this_time, (std::vector<int>{1, 4}));
+  EXPECT_EQ(plan.num_batched_tokens, 5);
+  EXPECT_EQ(plan.input_ids[0], 7);
+  EXPECT_EQ(plan.input_ids[4], 100);
+  ASSERT_EQ(finished.size(), 1UL);
+  EXPECT_EQ(finished[0]->id, 0);
+  EXPECT_EQ(finished[0]->output_ids, (std::vector<int64_t>{7, 7}));
+  EXPECT_EQ(finished[0]->state, RequestState::kFinished);
+
+  while (scheduler.HasUnfinished()) {
+    RunStep(&scheduler, &plan);
+  }
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 16);
+}
+
+TEST(ContinuousBatchScheduler, PreemptBySwap) {
+  // two requests of a full block each, the cache can't grow both
+  KVCacheBlockManager manager(3, 4, 4);
+  SchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_num_batched_tokens = 16;
+  config.max_blocks_per_seq = 3;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  scheduler.AddRequest(MakeRequest(0, 4, 4));
+  scheduler.AddRequest(MakeRequest(1, 4, 4));
+
+  StepPlan plan;
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 2);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 1);
+
+  // the later request is swapped out to let the earlier one grow
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 1);
+  EXPECT_EQ(plan.seqs[0]->id, 0);
+  EXPECT_EQ(plan.swap_out.size(), 1UL);
+  EXPECT_TRUE(plan.swap_in.empty());
+  EXPECT_EQ(scheduler.NumSwapped(), 1UL);
+  EXPECT_TRUE(manager.IsSwapped(1));
+
+  std::vector<std::shared_ptr<Request>> finished;
+  bool swapped_in = false;
+  while (scheduler.HasUnfinished()) {
+    auto step_finished = RunStep(&scheduler, &plan);
+    finished.insert(finished.end(), step_finished.begin(), step_finished.end());
+    if (!plan.swap_in.empty()) {
+      swapped_in = true;
+      // it goes on decoding from the swapped blocks
+      EXPECT_EQ(plan.seq_lens_encoder.back(), 0);
+      EXPECT_EQ(plan.seq_lens_decoder.back(), 4);
+    }
+  }
+  EXPECT_TRUE(swapped_in);
+  ASSERT_EQ(finished.size(), 2UL);
+  EXPECT_EQ(finished[0]->id, 0);
+  EXPECT_EQ(finished[1]->output_ids.size(), 4UL);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 3);
+  EXPECT_EQ(manager.NumFreeCpuBlocks(), 4);
+}
+
+TEST(ContinuousBatchScheduler, PreemptByRecompute) {
+  KVCacheBlockManager manager(3, 0, 4);
+  SchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_num_batched_tokens = 16;
+  config.max_blocks_per_seq = 3;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  scheduler.AddRequest(MakeRequest(0, 4, 4));
+  scheduler.AddRequest(MakeRequest(1, 4, 4));
+
+  StepPlan plan;
+  RunStep(&scheduler, &plan);
+  RunStep(&scheduler, &plan);
+  EXPECT_EQ(plan.recompute, (std::vector<int64_t>{1}));
+  EXPECT_EQ(scheduler.NumWaiting(), 1UL);
+  EXPECT_FALSE(manager.HasRequest(1));
+
+  bool recomputed = false;
+  while (scheduler.HasUnfinished()) {
+    RunStep(&scheduler, &plan);
+    for (int row = 0; row < plan.rows(); ++row) {
+      if (plan.seqs[row]->id == 1 && plan.seq_lens_encoder[row] > 0) {
+        // the prompt and the generated token are computed again
+        EXPECT_EQ(plan.seq_lens_encoder[row], 5);
+        recomputed = true;
+      }
+    }
+  }
+  EXPECT_TRUE(recomputed);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 3);
+}
+
+TEST(ContinuousBatchScheduler, ShareSystemPrompt) {
+  KVCacheBlockManager manager(6, 0, 4, /* enable_prefix_caching = */ true);
+  SchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_num_batched_tokens = 32;
+  config.max_blocks_per_seq = 4;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  // without sharing the two prompts take all blocks and can't grow
+  for (int64_t id = 0; id < 2; ++id) {
+    auto request = MakeRequest(id, 0, 4);
+    request->prompt_ids = {1, 2, 3, 4, 5, 6, 7, 8, 10 + id};
+    scheduler.AddRequest(request);
+  }
+
+  StepPlan plan;
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 2);
+  EXPECT_EQ(plan.seq_lens_encoder, (std::vector<int>{9, 9}));
+  EXPECT_EQ(plan.block_tables[0], plan.block_tables[4]);
+  EXPECT_EQ(plan.block_tables[1], plan.block_tables[5]);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 2);
+
+  while (scheduler.HasUnfinished()) {
+    RunStep(&scheduler, &plan);
+    EXPECT_TRUE(plan.swap_out.empty() && plan.recompute.empty());
+  }
+}
+
+TEST(ContinuousBatchScheduler, ForkCopiesOnWrite) {
+  KVCacheBlockManager manager(8, 0, 4);
+  SchedulerConfig config;
+  config.max_batch_size = 4;
+  config.max_num_batched_tokens = 16;
+  config.max_blocks_per_seq = 4;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  scheduler.AddRequest(MakeRequest(0, 5, 3));
+
+  StepPlan plan;
+  RunStep(&scheduler, &plan);
+  auto child = std::make_shared<Request>();
+  child->id = 1;
+  child->max_new_tokens = 3;
+  scheduler.ForkRequest(0, child);
+  EXPECT_EQ(child->NumTokens(), 6);
+
+  // both write the seventh token to the shared second block
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 2);
+  EXPECT_EQ(plan.seq_lens_decoder, (std::vector<int>{5, 5}));
+  ASSERT_EQ(plan.copy_blocks.size(), 1UL);
+  EXPECT_EQ(plan.block_tables[0], plan.block_tables[4]);
+  EXPECT_NE(plan.block_tables[1], plan.block_tables[5]);
+
+  while (scheduler.HasUnfinished()) {
+    RunStep(&scheduler, &plan);
+  }
+  EXPECT_EQ(child->output_ids.size(), 3UL);
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 8);
+}
+
+TEST(ContinuousBatchScheduler, Admission) {
+  KVCacheBlockManager manager(4, 0, 4);
+  SchedulerConfig config;
+  config.max_batch_size = 2;
+  config.max_num_batched_tokens = 8;
+  config.max_seq_len = 32;
+  config.max_blocks_per_seq = 8;
+  ContinuousBatchScheduler scheduler(config, &manager);
+  // more blocks than the whole cache
+  EXPECT_ANY_THROW(scheduler.AddRequest(MakeRequest(0, 12, 8)));
+  EXPECT_ANY_THROW(scheduler.AddRequest(MakeRequest(1, 0, 8)));
+
+  // a prompt over the token budget runs alone
+  scheduler.AddRequest(MakeRequest(2, 12, 1));
+  scheduler.AddRequest(MakeRequest(3, 2, 1));
+  StepPlan plan;
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 1);
+  EXPECT_EQ(plan.num_batched_tokens, 12);
+  RunStep(&scheduler, &plan);
+  ASSERT_EQ(plan.rows(), 1);
+  EXPECT_EQ(plan.seqs[0]->id, 3);
+  EXPECT_FALSE(scheduler.HasUnfinished());
+
+  scheduler.AddRequest(MakeRequest(4, 2, 8));
+  RunStep(&scheduler, &plan);
+  scheduler.AbortRequest(4);
+  EXPECT_FALSE(scheduler.HasUnfinished());
+  EXPECT_EQ(manager.NumFreeGpuBlocks(), 4);
+}
+
+}  // namespace llm
+}  // namespace inference
+}  // namespace paddle
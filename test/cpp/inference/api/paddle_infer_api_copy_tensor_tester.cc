@@ -179,6 +179,68 @@ TEST(Tensor, copy_to_cpu_async_callback) {
   contrib::TensorUtils::CudaFreePinnedMemory(static_cast<void *>(out_data));
 }
 
+TEST(Tensor, copy_from_cpu_async) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableUseGpu(100, 0);
+  auto predictor = CreatePredictor(config);
+  auto ref_predictor = predictor->Clone();
+
+  std::vector<int> in_shape = {1, 3, 318, 318};
+  int in_num = std::accumulate(
+      in_shape.begin(), in_shape.end(), 1, std::multiplies<int>());
+  const int num_requests = 3;
+  std::vector<std::vector<float>> inputs;
+  for (int i = 0; i < num_requests; i++) {
+    inputs.emplace_back(in_num, 0.5f * (i + 1));
+    contrib::TensorUtils::CudaRegisterPinnedMemory(inputs[i].data(),
+                                                   sizeof(float) * in_num);
+  }
+
+  auto run = [&](Predictor *p, int i) {
+    auto input_tensor = p->GetInputHandle(p->GetInputNames()[0]);
+    input_tensor->Reshape(in_shape);
+    input_tensor->CopyFromCpu(inputs[i].data());
+    p->Run();
+  };
+  auto output = [](Predictor *p) {
+    auto output_tensor = p->GetOutputHandle(p->GetOutputNames()[0]);
+    std::vector<int> output_shape = output_tensor->shape();
+    std::vector<float> out(std::accumulate(output_shape.begin(),
+                                           output_shape.end(),
+                                           1,
+                                           std::multiplies<int>()));
+    output_tensor->CopyToCpu(out.data());
+    return out;
+  };
+
+  auto input_tensor =
+      predictor->GetInputHandle(predictor->GetInputNames()[0]);
+  input_tensor->Reshape(in_shape);
+  auto copied = input_tensor->CopyFromCpuAsync(inputs[0].data());
+  for (int i = 0; i < num_requests; i++) {
+    predictor->Run();
+    // the input of the request is copied, its host buffer may be reused
+    copied.wait();
+    // copy the next request while this one computes
+    if (i + 1 < num_requests) {
+      copied = input_tensor->CopyFromCpuAsync(inputs[i + 1].data());
+    }
+    auto out = output(predictor.get());
+    run(ref_predictor.get(), i);
+    auto ref_out = output(ref_predictor.get());
+    ASSERT_EQ(out.size(), ref_out.size());
+    for (size_t j = 0; j < out.size(); j++) {
+      EXPECT_NEAR(out[j], ref_out[j], 1e-3);
+    }
+  }
+
+  for (auto &input : inputs) {
+    contrib::TensorUtils::CudaUnregisterPinnedMemory(input.data());
+  }
+}
+
 template <class DTYPE>
 static void test_copy_tensor(PlaceType src_place, PlaceType dst_place) {
   paddle::framework::Scope scope;
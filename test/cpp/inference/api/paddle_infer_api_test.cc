@@ -12,10 +12,14 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License. */
 
+#include <cuda_runtime.h>
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
+#include <thread>
+
 #include "paddle/common/flags.h"
+#include "paddle/phi/core/dense_tensor.h"
 #include "test/cpp/inference/api/tester_helper.h"
 
 namespace paddle_infer {
@@ -95,4 +99,129 @@ TEST(PredictorPool, basic) {
   }
 }
 
+TEST(Predictor, share_activation_memory) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  auto create = [&](bool share) {
+    Config config;
+    config.EnableNewIR(false);
+    config.SetModel(model_dir + "/model", model_dir + "/params");
+    config.EnableUseGpu(100, 0);
+    config.EnableActivationMemorySharing(share);
+    return CreatePredictor(config);
+  };
+  auto run = [](Predictor *predictor) {
+    std::vector<int> in_shape = {1, 3, 318, 318};
+    std::vector<float> input(1 * 3 * 318 * 318, 1.f);
+    auto input_t = predictor->GetInputHandle(predictor->GetInputNames()[0]);
+    input_t->Reshape(in_shape);
+    input_t->CopyFromCpu(input.data());
+    predictor->Run();
+    auto output_t =
+        predictor->GetOutputHandle(predictor->GetOutputNames()[0]);
+    std::vector<int> output_shape = output_t->shape();
+    std::vector<float> out_data(std::accumulate(output_shape.begin(),
+                                                output_shape.end(),
+                                                1,
+                                                std::multiplies<int>()));
+    output_t->CopyToCpu(out_data.data());
+    return out_data;
+  };
+
+  auto ref = run(create(false).get());
+  // two predictors taking turns on the memory the other one released
+  auto first = create(true);
+  auto second = create(true);
+  for (int i = 0; i < 2; ++i) {
+    for (auto *predictor : {first.get(), second.get()}) {
+      auto out = run(predictor);
+      ASSERT_EQ(out.size(), ref.size());
+      for (size_t j = 0; j < out.size(); ++j) {
+        EXPECT_NEAR(out[j], ref[j], 1e-5);
+      }
+    }
+  }
+}
+
+TEST(Predictor, run_telemetry) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.EnableNewIR(false);
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableUseGpu(100, 0);
+  config.EnableRunTelemetry();
+  auto predictor = CreatePredictor(config);
+
+  std::vector<float> input(1 * 3 * 318 * 318, 1.f);
+  for (int i = 0; i < 3; ++i) {
+    auto input_t = predictor->GetInputHandle(predictor->GetInputNames()[0]);
+    input_t->Reshape({1, 3, 318, 318});
+    input_t->CopyFromCpu(input.data());
+    ASSERT_TRUE(predictor->Run());
+    auto output_t =
+        predictor->GetOutputHandle(predictor->GetOutputNames()[0]);
+    std::vector<int> output_shape = output_t->shape();
+    std::vector<float> out_data(std::accumulate(output_shape.begin(),
+                                                output_shape.end(),
+                                                1,
+                                                std::multiplies<int>()));
+    output_t->CopyToCpu(out_data.data());
+  }
+
+  std::string telemetry = predictor->GetRunTelemetry();
+  for (const std::string stage :
+       {"input_copy", "dispatch", "sync_wait", "output_copy", "run"}) {
+    EXPECT_NE(telemetry.find("stage=\"" + stage + "\",le=\"+Inf\"} 3"),
+              std::string::npos)
+        << telemetry;
+  }
+}
+
+TEST(ConcurrentPredictor, use_gpu) {
+  std::string model_dir = FLAGS_infer_model + "/model";
+  Config config;
+  config.EnableNewIR(false);
+  config.SetModel(model_dir + "/model", model_dir + "/params");
+  config.EnableUseGpu(100, 0);
+  services::ConcurrentPredictor predictor(config, 2);
+
+  std::vector<int64_t> in_shape = {1, 3, 318, 318};
+  std::vector<float> input(1 * 3 * 318 * 318, 1.f);
+  auto run = [&] {
+    auto in = std::make_shared<phi::DenseTensor>();
+    in->Resize(common::make_ddim(in_shape));
+    float *in_data = in->mutable_data<float>(phi::GPUPlace(0));
+    cudaMemcpy(in_data,
+               input.data(),
+               input.size() * sizeof(float),
+               cudaMemcpyHostToDevice);
+    std::vector<paddle::Tensor> outputs;
+    EXPECT_TRUE(predictor.Run(
+        {paddle::Tensor(in, predictor.GetInputNames()[0])}, &outputs));
+    auto out = std::dynamic_pointer_cast<phi::DenseTensor>(outputs[0].impl());
+    std::vector<float> out_data(out->numel());
+    cudaMemcpy(out_data.data(),
+               out->data<float>(),
+               out_data.size() * sizeof(float),
+               cudaMemcpyDeviceToHost);
+    return out_data;
+  };
+
+  auto ref = run();
+  std::vector<std::vector<float>> outs(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < outs.size(); ++i) {
+    threads.emplace_back([&, i] { outs[i] = run(); });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_LE(predictor.GetNumExecutors(), 2UL);
+  for (const auto &out : outs) {
+    ASSERT_EQ(out.size(), ref.size());
+    for (size_t j = 0; j < out.size(); ++j) {
+      EXPECT_NEAR(out[j], ref[j], 1e-5);
+    }
+  }
+}
+
 }  // namespace paddle_infer
@@ -0,0 +1,59 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "paddle/fluid/inference/utils/shape_profiles.h"
+
+namespace paddle {
+namespace inference {
+
+TEST(ClusterShapeSizes, bimodal) {
+  // short and long sequences, interleaved
+  std::vector<int64_t> sizes{16, 512, 20, 480, 24, 18, 500, 16};
+  EXPECT_EQ(ClusterShapeSizes(sizes, 2),
+            (std::vector<int>{0, 1, 0, 1, 0, 0, 1, 0}));
+  EXPECT_EQ(ClusterShapeSizes(sizes, 1), std::vector<int>(sizes.size(), 0));
+  // no more clusters than distinct sizes
+  EXPECT_EQ(ClusterShapeSizes({8, 64, 8}, 5), (std::vector<int>{0, 1, 0}));
+  EXPECT_TRUE(ClusterShapeSizes({}, 2).empty());
+}
+
+TEST(ChooseShapeProfile, closest_holding_profile) {
+  std::vector<ShapeProfile> min_shapes{{{"x", {1, 1}}}, {{"x", {1, 64}}}};
+  std::vector<ShapeProfile> max_shapes{{{"x", {8, 64}}}, {{"x", {8, 512}}}};
+  std::vector<ShapeProfile> opt_shapes{{{"x", {4, 32}}}, {{"x", {4, 256}}}};
+
+  EXPECT_EQ(ChooseShapeProfile(
+                {{"x", {4, 20}}}, min_shapes, max_shapes, opt_shapes),
+            0);
+  EXPECT_EQ(ChooseShapeProfile(
+                {{"x", {4, 300}}}, min_shapes, max_shapes, opt_shapes),
+            1);
+  // both hold it, the second has its opt shapes closer
+  EXPECT_EQ(ChooseShapeProfile(
+                {{"x", {4, 64}}}, min_shapes, max_shapes, opt_shapes),
+            1);
+  // none holds it, names the profiles do not have are ignored
+  EXPECT_EQ(ChooseShapeProfile({{"x", {16, 64}}, {"y", {1}}},
+                               min_shapes,
+                               max_shapes,
+                               opt_shapes),
+            -1);
+}
+
+}  // namespace inference
+}  // namespace paddle
@@ -0,0 +1,359 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the host overhead of the executors on synthetic programs of ops on
+// one-element tensors, whose kernels take next to no time: a long chain, a
+// wide fan-out joined by add_n, and a while loop. Each program runs through
+// PirInterpreter, and the chain and fan-out also through ProgramInterpreter
+// and NaiveExecutor, with the host thread counts of --executor_bench_threads
+// and with the garbage collector on and off. Reported as ns per instruction.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "paddle/common/flags.h"
+#include "paddle/common/macros.h"
+#include "paddle/fluid/framework/naive_executor.h"
+#include "paddle/fluid/framework/new_executor/interpretercore.h"
+#include "paddle/fluid/framework/op_registry.h"
+#include "paddle/fluid/framework/program_desc.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
+#include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
+#include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
+#include "paddle/fluid/pir/transforms/pd_op_to_kernel_pass.h"
+#include "paddle/phi/core/kernel_registry.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/include/core/builtin_op.h"
+#include "paddle/pir/include/core/ir_context.h"
+#include "paddle/pir/include/core/program.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
+#include "paddle/utils/string/split.h"
+
+COMMON_DECLARE_double(eager_delete_tensor_gb);
+
+PD_DEFINE_int32(executor_bench_ops, 500, "Ops of the synthetic programs.");
+PD_DEFINE_int32(executor_bench_branches,
+                16,
+                "Independent branches of the fan-out program.");
+PD_DEFINE_int32(executor_bench_repeat, 10, "Timed runs of each program.");
+PD_DEFINE_string(executor_bench_threads,
+                 "1,2,4",
+                 "Comma separated host thread counts to run with.");
+
+PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(add_n, CPU, ALL_LAYOUT);
+PD_DECLARE_KERNEL(less_than, CPU, ALL_LAYOUT);
+
+DECLARE_FILE_SYMBOLS(kernel_dialect);
+
+USE_OP_ITSELF(elementwise_add);
+USE_OP_ITSELF(sum);
+
+namespace paddle {
+namespace framework {
+
+using paddle::dialect::AddNOp;
+using paddle::dialect::AddOp;
+using paddle::dialect::FullOp;
+using paddle::dialect::LessThanOp;
+using paddle::dialect::WhileOp;
+
+struct SyntheticProgram {
+  std::string name;
+  std::unique_ptr<pir::Program> kernel_program;
+  // executed instructions per run, the iterations of loops included
+  int64_t num_instrs;
+};
+
+static pir::Value BuildOne(pir::Builder* builder, float value) {
+  return builder
+      ->Build<FullOp>(std::vector<int64_t>{1},
+                      value,
+                      phi::DataType::FLOAT32,
+                      phi::CPUPlace())
+      .out();
+}
+
+static SyntheticProgram LowerToKernel(std::string name,
+                                      pir::Program* program,
+                                      int64_t num_instrs) {
+  return {std::move(name),
+          paddle::dialect::PdOpLowerToKernelPass(program),
+          num_instrs};
+}
+
+// out = x + one + one + ..., a serial chain of num_ops adds
+static SyntheticProgram BuildChain(int num_ops) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  auto x = BuildOne(&builder, 1.0);
+  auto one = BuildOne(&builder, 1.0);
+  for (int i = 0; i < num_ops; ++i) {
+    x = builder.Build<AddOp>(x, one).out();
+  }
+  builder.Build<pir::ShadowOutputOp>(x, "out");
+  return LowerToKernel("chain", &program, num_ops + 3);
+}
+
+// num_branches independent chains on the same input, joined by add_n
+static SyntheticProgram BuildFanOut(int num_ops, int num_branches) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program(ctx);
+  pir::Builder builder(ctx, program.block());
+  auto x = BuildOne(&builder, 1.0);
+  auto one = BuildOne(&builder, 1.0);
+  int ops_per_branch = std::max(num_ops / num_branches, 1);
+  std::vector<pir::Value> branches;
+  for (int b = 0; b < num_branches; ++b) {
+    auto y = x;
+    for (int i = 0; i < ops_per_branch; ++i) {
+      y = builder.Build<AddOp>(y, one).out();
+    }
+    branches.push_back(y);
+  }
+  auto combine = builder.Build<pir::CombineOp>(branches).out();
+  builder.Build<pir::ShadowOutputOp>(builder.Build<AddNOp>(combine).out(),
+                                     "out");
+  return LowerToKernel(
+      "fan_out", &program, num_branches * ops_per_branch + 5);
+}
+
+// while (i < n) { i = i + 1; x = x + one + ... }, num_ops adds in total
+static SyntheticProgram BuildWhile(int num_ops, int body_ops) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program(ctx);
+  pir::Block* block = program.block();
+  pir::Builder builder(ctx, block);
+  int num_iters = std::max(num_ops / body_ops, 1);
+  auto i = BuildOne(&builder, 0.0);
+  auto n = BuildOne(&builder, static_cast<float>(num_iters));
+  auto x = BuildOne(&builder, 1.0);
+  auto cond = builder.Build<LessThanOp>(i, n).out();
+  auto while_op =
+      builder.Build<WhileOp>(cond, std::vector<pir::Value>{i, n, x});
+
+  pir::Block& body = while_op.body();
+  builder.SetInsertionPointToStart(&body);
+  auto one = BuildOne(&builder, 1.0);
+  auto next_i = builder.Build<AddOp>(body.arg(0), one).out();
+  auto next_x = body.arg(2);
+  for (int k = 0; k < body_ops; ++k) {
+    next_x = builder.Build<AddOp>(next_x, one).out();
+  }
+  auto next_cond = builder.Build<LessThanOp>(next_i, body.arg(1)).out();
+  builder.Build<pir::YieldOp>(
+      std::vector<pir::Value>{next_cond, next_i, body.arg(1), next_x});
+
+  builder.SetInsertionPointAfter(while_op);
+  builder.Build<pir::ShadowOutputOp>(while_op->result(2), "out");
+  return LowerToKernel(
+      "while", &program, 6 + static_cast<int64_t>(num_iters) * (body_ops + 4));
+}
+
+// The chain or the fan-out program as a ProgramDesc of elementwise_add and
+// sum, for ProgramInterpreter and NaiveExecutor.
+static ProgramDesc BuildProgramDesc(int num_ops, int num_branches) {
+  ProgramDesc program;
+  auto* block = program.MutableBlock(0);
+  auto new_var = [&](const std::string& name, bool persistable) {
+    auto* var = block->Var(name);
+    var->SetType(proto::VarType::DENSE_TENSOR);
+    var->SetDataType(proto::VarType::FP32);
+    var->SetShape({1});
+    var->SetPersistable(persistable);
+  };
+  // inputs are persistable so that they stay in the root scope
+  new_var("x", true);
+  new_var("one", true);
+  int ops_per_branch = std::max(num_ops / num_branches, 1);
+  std::vector<std::string> branches;
+  for (int b = 0; b < num_branches; ++b) {
+    std::string y = "x";
+    for (int i = 0; i < ops_per_branch; ++i) {
+      auto out = "y_" + std::to_string(b) + "_" + std::to_string(i);
+      new_var(out, false);
+      auto* op = block->AppendOp();
+      op->SetType("elementwise_add");
+      op->SetInput("X", {y});
+      op->SetInput("Y", {"one"});
+      op->SetOutput("Out", {out});
+      op->SetAttr("axis", -1);
+      y = out;
+    }
+    branches.push_back(y);
+  }
+  auto out = num_branches == 1 ? branches[0] : "out";
+  if (num_branches > 1) {
+    new_var(out, false);
+    auto* op = block->AppendOp();
+    op->SetType("sum");
+    op->SetInput("X", branches);
+    op->SetOutput("Out", {out});
+  }
+  return program;
+}
+
+static void InitInputs(Scope* scope) {
+  for (auto name : {"x", "one"}) {
+    auto* tensor = scope->Var(name)->GetMutable<phi::DenseTensor>();
+    tensor->Resize({1});
+    *tensor->mutable_data<float>(phi::CPUPlace()) = 1.0f;
+  }
+}
+
+// ns per run of run, after a first run which builds the executor
+static double TimeRuns(const std::function<void()>& run) {
+  run();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_executor_bench_repeat; ++i) {
+    run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(
+             std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+                 .count()) /
+         FLAGS_executor_bench_repeat;
+}
+
+static void Report(const std::string& executor,
+                   const std::string& program,
+                   int threads,
+                   bool gc,
+                   double ns_per_run,
+                   int64_t num_instrs) {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(1) << executor << " " << program
+     << " threads=" << threads << " gc=" << (gc ? "on" : "off") << ": "
+     << ns_per_run / num_instrs << " ns/instr, " << ns_per_run / 1e3
+     << " us/run";
+  LOG(INFO) << os.str();
+}
+
+static std::vector<int> BenchThreads() {
+  std::vector<int> threads;
+  for (auto& s : paddle::string::Split(FLAGS_executor_bench_threads, ',')) {
+    threads.push_back(std::stoi(s));
+  }
+  return threads;
+}
+
+class ExecutorOverheadBenchmark : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    pir::IrContext* ctx = pir::IrContext::Instance();
+    ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+    ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+    gc_threshold_ = FLAGS_eager_delete_tensor_gb;
+  }
+
+  void TearDown() override { FLAGS_eager_delete_tensor_gb = gc_threshold_; }
+
+  // a negative threshold disables the garbage collector
+  void SetGC(bool gc) { FLAGS_eager_delete_tensor_gb = gc ? 0.0 : -1.0; }
+
+  double gc_threshold_;
+};
+
+TEST_F(ExecutorOverheadBenchmark, PirInterpreter) {
+  std::vector<SyntheticProgram> programs;
+  programs.push_back(BuildChain(FLAGS_executor_bench_ops));
+  programs.push_back(
+      BuildFanOut(FLAGS_executor_bench_ops, FLAGS_executor_bench_branches));
+  programs.push_back(BuildWhile(FLAGS_executor_bench_ops, 4));
+  for (const auto& program : programs) {
+    for (int threads : BenchThreads()) {
+      for (bool gc : {true, false}) {
+        SetGC(gc);
+        interpreter::ExecutionConfig config;
+        config.host_num_threads = threads;
+        config.device_num_threads = 1;
+        Scope scope;
+        InterpreterCore core(phi::CPUPlace(),
+                             {},
+                             program.kernel_program->block(),
+                             &scope,
+                             config);
+        core.SetSkipGcVars({"out"});
+        double ns = TimeRuns([&] { core.Run({}, false); });
+        Report("PirInterpreter",
+               program.name,
+               threads,
+               gc,
+               ns,
+               program.num_instrs);
+        EXPECT_GT(ns, 0);
+      }
+    }
+  }
+}
+
+TEST_F(ExecutorOverheadBenchmark, ProgramInterpreter) {
+  for (int branches : {1, FLAGS_executor_bench_branches}) {
+    auto program = BuildProgramDesc(FLAGS_executor_bench_ops, branches);
+    int64_t num_instrs = program.Block(0).OpSize();
+    for (int threads : BenchThreads()) {
+      for (bool gc : {true, false}) {
+        SetGC(gc);
+        interpreter::ExecutionConfig config;
+        config.host_num_threads = threads;
+        config.device_num_threads = 1;
+        Scope scope;
+        InitInputs(&scope);
+        InterpreterCore core(
+            phi::CPUPlace(), program.Block(0), &scope, config);
+        double ns = TimeRuns([&] { core.Run({}, false); });
+        Report("ProgramInterpreter",
+               branches == 1 ? "chain" : "fan_out",
+               threads,
+               gc,
+               ns,
+               num_instrs);
+        EXPECT_GT(ns, 0);
+      }
+    }
+  }
+}
+
+TEST_F(ExecutorOverheadBenchmark, NaiveExecutor) {
+  for (int branches : {1, FLAGS_executor_bench_branches}) {
+    auto program = BuildProgramDesc(FLAGS_executor_bench_ops, branches);
+    int64_t num_instrs = program.Block(0).OpSize();
+    Scope scope;
+    InitInputs(&scope);
+    NaiveExecutor exe(phi::CPUPlace());
+    exe.Prepare(&scope, program, 0);
+    double ns = TimeRuns([&] { exe.Run(); });
+    // single threaded and without garbage collection by design
+    Report("NaiveExecutor",
+           branches == 1 ? "chain" : "fan_out",
+           1,
+           false,
+           ns,
+           num_instrs);
+    EXPECT_GT(ns, 0);
+  }
+}
+
+}  // namespace framework
+}  // namespace paddle
@@ -22,6 +22,7 @@
 
 #include "paddle/phi/core/kernel_registry.h"
 
+#include "paddle/fluid/framework/new_executor/interpreter/memory_plan.h"
 #include "paddle/fluid/framework/new_executor/pir_interpreter.h"
 #include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -39,6 +40,9 @@
 
 DECLARE_FILE_SYMBOLS(kernel_dialect);
 
+COMMON_DECLARE_bool(pir_interpreter_static_trace_replay);
+COMMON_DECLARE_bool(pir_interpreter_static_memory_plan);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(full_int_array, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(uniform, CPU, ALL_LAYOUT);
@@ -385,5 +389,65 @@ TEST(StandaloneExecutor, while_op) {
   EXPECT_EQ(res0, true);
 }
 
+TEST(StandaloneExecutor, plan_tensor_offsets) {
+  // [0, 1] and [1, 2] overlap at 1, [3, 4] reuses the memory of both
+  std::vector<interpreter::TensorLifetime> tensors = {
+      {0, 1, 100}, {1, 2, 300}, {3, 4, 200}};
+  std::vector<size_t> offsets;
+  size_t buffer_size = interpreter::PlanTensorOffsets(tensors, 64, &offsets);
+  EXPECT_EQ(offsets[1], 0u);
+  EXPECT_EQ(offsets[0], 320u);
+  EXPECT_EQ(offsets[2], 0u);
+  EXPECT_EQ(buffer_size, 448u);
+}
+
+TEST(StandaloneExecutor, static_memory_plan) {
+  FLAGS_pir_interpreter_static_trace_replay = true;
+  FLAGS_pir_interpreter_static_memory_plan = true;
+
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  pir::Program program((ctx));
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  paddle::dialect::FullOp op1 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 1.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  paddle::dialect::FullOp op2 = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{2, 2}, 2.0, phi::DataType::FLOAT32, phi::CPUPlace());
+  auto add1 =
+      builder.Build<paddle::dialect::AddOp>(op1->result(0), op2->result(0));
+  auto add2 =
+      builder.Build<paddle::dialect::AddOp>(add1->result(0), add1->result(0));
+  auto add3 =
+      builder.Build<paddle::dialect::AddOp>(add2->result(0), op2->result(0));
+
+  std::string out_name = "add_out";
+  builder.Build<pir::ShadowOutputOp>(add3->result(0), out_name);
+
+  auto kernel_program = paddle::dialect::PdOpLowerToKernelPass(&program);
+
+  auto place = phi::CPUPlace();
+  Scope scope;
+  InterpreterCore test_core(place, {}, kernel_program->block(), &scope);
+  test_core.SetSkipGcVars({out_name});
+
+  // build, collect the plan, then run from the planned buffer
+  for (int i = 0; i < 4; ++i) {
+    test_core.Run({});
+    auto out_tensor =
+        test_core.local_scope() == nullptr
+            ? scope.FindVar(out_name)->Get<phi::DenseTensor>()
+            : test_core.local_scope()
+                  ->FindVar(out_name)
+                  ->Get<phi::DenseTensor>();
+    for (int j = 0; j < 4; ++j) {
+      EXPECT_EQ(simple_cmp(out_tensor.data<float>()[j], 8.0), true);
+    }
+  }
+
+  FLAGS_pir_interpreter_static_trace_replay = false;
+  FLAGS_pir_interpreter_static_memory_plan = false;
+}
+
 }  // namespace framework
 }  // namespace paddle
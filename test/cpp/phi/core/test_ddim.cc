@@ -110,6 +110,21 @@ TEST(DDim, Equality) {
   EXPECT_EQ(common::product(slice_dim3), 1);
 }
 
+TEST(DDim, SmallShape) {
+  phi::DDim ddim = common::make_ddim({2, 3, 4});
+  common::SmallShape<int> shape = common::small_vectorize<int>(ddim);
+  EXPECT_EQ(shape.size(), size_t(3));
+  EXPECT_EQ(shape[2], 4);
+  shape.push_back(5);
+  phi::DDim ddim2 = common::make_ddim(shape);
+  EXPECT_EQ(ddim2.size(), 4);
+  EXPECT_EQ(common::product(ddim2), 120);
+
+  phi::DDim zero_ddim = common::make_ddim({});
+  EXPECT_EQ(common::small_vectorize(zero_ddim).size(), size_t(0));
+  EXPECT_EQ(common::make_ddim(common::SmallShape<int64_t>()).size(), 0);
+}
+
 TEST(DDim, Print) {
   // print a DDim
   std::stringstream ss1;
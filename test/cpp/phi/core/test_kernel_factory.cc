@@ -72,6 +72,35 @@ TEST(KernelRegistry, SetFP32Input) {
   EXPECT_EQ(output_defs.at(0).dtype, phi::DataType::FLOAT16);
 }
 
+static int lazy_args_def_calls = 0;
+
+void LazyTestArgsDef(const phi::KernelKey& kernel_key, phi::Kernel* kernel) {
+  ++lazy_args_def_calls;
+  kernel->OutputAt(0).SetDataType(phi::DataType::FLOAT64);
+}
+
+TEST(KernelRegistry, LazyArgsDef) {
+  using TestKernelFn = decltype(&TestKernel<float, phi::CPUContext>);
+  phi::KernelKey kernel_key(
+      phi::Backend::CPU, phi::DataLayout::ALL_LAYOUT, phi::DataType::FLOAT32);
+  phi::Kernel kernel(
+      PHI_KERNEL(TestKernel<float, phi::CPUContext>),
+      PHI_VARIADIC_KERNEL(TestKernel<float, phi::CPUContext>),
+      kernel_key,
+      &phi::KernelArgsParseFunctor<TestKernelFn>::Parse,
+      &LazyTestArgsDef);
+  EXPECT_EQ(lazy_args_def_calls, 0);
+  phi::Kernel moved(std::move(kernel));
+  EXPECT_EQ(lazy_args_def_calls, 0);
+
+  phi::Kernel copied(moved);
+  EXPECT_EQ(lazy_args_def_calls, 1);
+  EXPECT_EQ(copied.args_def().input_defs().size(), 2UL);
+  EXPECT_EQ(moved.OutputAt(0).dtype, phi::DataType::FLOAT64);
+  EXPECT_EQ(copied.OutputAt(0).dtype, phi::DataType::FLOAT64);
+  EXPECT_EQ(lazy_args_def_calls, 1);
+}
+
 TEST(AttributeType, OStream) {
   std::ostringstream oss;
   oss << phi::AttributeType::UNDEFINED;
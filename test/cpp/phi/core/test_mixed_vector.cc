@@ -72,3 +72,16 @@ TEST(mixed_vector, Resize) {
   vec.push_back(0);
   vec.push_back(0);
 }
+
+TEST(mixed_vector, HostOnlyMixVector) {
+  std::vector<size_t> level = {0, 2};
+  phi::MixVector<size_t> mix_vec(&level);
+  mix_vec.push_back(5);
+  mix_vec.Extend(level.begin(), level.begin() + 1);
+  ASSERT_EQ(mix_vec.size(), 4UL);
+  ASSERT_EQ(mix_vec[2], 5UL);
+  ASSERT_EQ(mix_vec.back(), 0UL);
+  ASSERT_EQ(mix_vec.Data(phi::CPUPlace()), level.data());
+  // no device state is built while the data stays on the host
+  ASSERT_EQ(mix_vec.Handle(), nullptr);
+}
@@ -12,6 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <string>
+#include <thread>
+
 #include "gtest/gtest.h"
 #include "paddle/phi/core/distributed/store/tcp_store.h"
 #include "paddle/phi/core/distributed/store/tcp_utils.h"
@@ -37,6 +40,44 @@ TEST(MasterDaemon, init) {
   d.reset();
 }
 
+static std::vector<uint8_t> ToBytes(const std::string& s) {
+  return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+TEST(TCPStore, relay) {
+  TCPStore master("127.0.0.1", 36170, true, 1);
+  TCPStore relay("127.0.0.1", 36170, false, 1, 900, 36171);
+  TCPStore leaf("127.0.0.1", 36171, false, 1);
+
+  // written through to the master
+  leaf.set("id", ToBytes("nccl"));
+  EXPECT_EQ(master.get("id"), ToBytes("nccl"));
+
+  // the counters are not cached by the relay
+  master.add("counter", 2);
+  EXPECT_EQ(leaf.get("counter"), ToBytes("2"));
+  leaf.add("counter", 1);
+  EXPECT_EQ(leaf.get("counter"), ToBytes("3"));
+
+  std::thread waiter([&leaf]() { leaf.multi_wait({"a", "b"}); });
+  master.set("a", ToBytes("1"));
+  master.set("b", ToBytes("2"));
+  waiter.join();
+  auto values = leaf.multi_get({"b", "id"});
+  ASSERT_EQ(values.size(), 2UL);
+  EXPECT_EQ(values[0], ToBytes("2"));
+  EXPECT_EQ(values[1], ToBytes("nccl"));
+
+  std::map<std::string, std::vector<uint8_t>> entries;
+  std::thread watcher(
+      [&leaf, &entries]() { entries = leaf.wait_prefix("rank/", 2); });
+  master.set("rank/0", ToBytes("0"));
+  master.set("rank/1", ToBytes("1"));
+  watcher.join();
+  ASSERT_EQ(entries.size(), 2UL);
+  EXPECT_EQ(entries["rank/1"], ToBytes("1"));
+}
+
 /* now for only c compile test
 TEST(TCPStore, init) {
   TCPStore store("127.0.0.1", 6170, true, 1);
@@ -0,0 +1,454 @@
+/* Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+// Benchmarks registered phi kernels described by a YAML spec, e.g.
+//
+//   - kernel: matmul
+//     backends: [CPU, GPU]
+//     dtypes: [float32, float16]
+//     cases:
+//       - inputs: [[512, 512], [512, 512]]
+//         outputs: [[512, 512]]
+//         attrs: [false, false]
+//         flops: 268435456
+//
+// inputs and outputs follow the order of the kernel arguments. A tensor is a
+// shape, or a map with shape and optionally dtype, low and high. A list of
+// tensors is a vector argument and null an absent optional input. outputs
+// default to one tensor shaped as the first input. attrs follow the order of
+// the kernel attributes. flops is the work of one run, used to report the
+// achieved FLOPs, the bandwidth is computed from the bytes of all tensors.
+//
+// The times are compared against --kernel_bench_baseline when it exists, and
+// written to it with --kernel_bench_update_baseline.
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <random>
+#include <sstream>
+
+#include "glog/logging.h"
+#include "paddle/common/flags.h"
+#include "paddle/phi/backends/context_pool.h"
+#include "paddle/phi/common/int_array.h"
+#include "paddle/phi/common/scalar.h"
+#include "paddle/phi/core/compat/convert_utils.h"
+#include "paddle/phi/core/kernel_context.h"
+#include "paddle/phi/core/kernel_factory.h"
+#include "paddle/phi/core/os_info.h"
+#include "paddle/phi/core/tensor_utils.h"
+#include "paddle/phi/core/visit_type.h"
+#include "yaml-cpp/yaml.h"
+
+PD_DEFINE_string(kernel_bench_spec,
+                 KERNEL_BENCHMARK_SPEC,
+                 "YAML spec of the kernels to benchmark.");
+PD_DEFINE_string(kernel_bench_baseline,
+                 "",
+                 "YAML file of the baseline times in us, compared against "
+                 "if it exists.");
+PD_DEFINE_bool(kernel_bench_update_baseline,
+               false,
+               "Write the measured times to kernel_bench_baseline.");
+PD_DEFINE_double(kernel_bench_tolerance,
+                 0.1,
+                 "Slowdown over the baseline reported as a regression.");
+PD_DEFINE_int32(kernel_bench_warmup, 10, "Runs before timing.");
+PD_DEFINE_int32(kernel_bench_repeat, 100, "Timed runs.");
+
+namespace phi {
+namespace tests {
+
+struct TensorSpec {
+  std::vector<int64_t> shape;
+  DataType dtype;
+  double low = -1.0;
+  double high = 1.0;
+};
+
+// The tensors of one kernel argument, none for an absent optional input.
+struct ArgSpec {
+  std::vector<TensorSpec> tensors;
+  bool is_vector = false;
+};
+
+struct BenchCase {
+  std::string kernel;
+  Backend backend;
+  DataType dtype;
+  std::vector<ArgSpec> inputs;
+  std::vector<ArgSpec> outputs;
+  YAML::Node attrs;
+  double flops = 0;
+
+  std::string Key() const {
+    std::ostringstream os;
+    os << kernel << "/" << backend << "/" << DataTypeToString(dtype) << "/";
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      os << (i == 0 ? "" : ",");
+      for (size_t j = 0; j < inputs[i].tensors.size(); ++j) {
+        os << (j == 0 ? "" : ";");
+        const auto& shape = inputs[i].tensors[j].shape;
+        for (size_t k = 0; k < shape.size(); ++k) {
+          os << (k == 0 ? "" : "x") << shape[k];
+        }
+      }
+    }
+    return os.str();
+  }
+};
+
+static TensorSpec ParseTensor(const YAML::Node& node, DataType dtype) {
+  TensorSpec spec;
+  spec.dtype = dtype;
+  if (!node.IsMap()) {
+    spec.shape = node.as<std::vector<int64_t>>();
+    return spec;
+  }
+  spec.shape = node["shape"].as<std::vector<int64_t>>();
+  if (node["dtype"]) {
+    spec.dtype = StringToDataType(node["dtype"].as<std::string>());
+  }
+  if (node["low"]) spec.low = node["low"].as<double>();
+  if (node["high"]) spec.high = node["high"].as<double>();
+  return spec;
+}
+
+static ArgSpec ParseArg(const YAML::Node& node, DataType dtype) {
+  ArgSpec arg;
+  if (node.IsNull()) {
+    return arg;
+  }
+  if (node.IsSequence() && node.size() > 0 &&
+      (node[0].IsSequence() || node[0].IsMap())) {
+    arg.is_vector = true;
+    for (const auto& tensor : node) {
+      arg.tensors.push_back(ParseTensor(tensor, dtype));
+    }
+  } else {
+    arg.tensors.push_back(ParseTensor(node, dtype));
+  }
+  return arg;
+}
+
+static std::vector<BenchCase> ParseSpec(const std::string& path) {
+  std::vector<BenchCase> cases;
+  for (const auto& entry : YAML::LoadFile(path)) {
+    auto kernel = entry["kernel"].as<std::string>();
+    auto backends = entry["backends"]
+                        ? entry["backends"].as<std::vector<std::string>>()
+                        : std::vector<std::string>{"CPU", "GPU"};
+    auto dtypes = entry["dtypes"]
+                      ? entry["dtypes"].as<std::vector<std::string>>()
+                      : std::vector<std::string>{"float32"};
+    for (const auto& backend : backends) {
+      for (const auto& dtype_str : dtypes) {
+        for (const auto& node : entry["cases"]) {
+          BenchCase c;
+          c.kernel = kernel;
+          c.backend = StringToBackend(backend.c_str());
+          c.dtype = StringToDataType(dtype_str);
+          for (const auto& input : node["inputs"]) {
+            c.inputs.push_back(ParseArg(input, c.dtype));
+          }
+          if (node["outputs"]) {
+            for (const auto& output : node["outputs"]) {
+              c.outputs.push_back(ParseArg(output, c.dtype));
+            }
+          } else {
+            c.outputs.push_back(c.inputs.at(0));
+          }
+          c.attrs = node["attrs"];
+          if (node["flops"]) c.flops = node["flops"].as<double>();
+          cases.push_back(std::move(c));
+        }
+      }
+    }
+  }
+  return cases;
+}
+
+static Attribute ParseAttr(const YAML::Node& node,
+                           AttributeType type,
+                           const Place& place) {
+  switch (type) {
+    case AttributeType::BOOL:
+      return node.as<bool>();
+    case AttributeType::INT32:
+      return node.as<int>();
+    case AttributeType::INT64:
+      return node.as<int64_t>();
+    case AttributeType::FLOAT32:
+      return node.as<float>();
+    case AttributeType::FLOAT64:
+      return node.as<double>();
+    case AttributeType::STRING:
+      return node.as<std::string>();
+    case AttributeType::BOOLS:
+      return node.as<std::vector<bool>>();
+    case AttributeType::INT32S:
+      return node.as<std::vector<int>>();
+    case AttributeType::INT64S:
+      return node.as<std::vector<int64_t>>();
+    case AttributeType::FLOAT32S:
+      return node.as<std::vector<float>>();
+    case AttributeType::FLOAT64S:
+      return node.as<std::vector<double>>();
+    case AttributeType::STRINGS:
+      return node.as<std::vector<std::string>>();
+    case AttributeType::SCALAR:
+      return Scalar(node.as<double>());
+    case AttributeType::SCALARS: {
+      std::vector<Scalar> scalars;
+      for (auto value : node.as<std::vector<double>>()) {
+        scalars.emplace_back(value);
+      }
+      return scalars;
+    }
+    case AttributeType::INT_ARRAY:
+      return IntArray(node.as<std::vector<int64_t>>());
+    case AttributeType::DATA_TYPE:
+      return StringToDataType(node.as<std::string>());
+    case AttributeType::DATA_LAYOUT:
+      return common::StringToDataLayout(node.as<std::string>());
+    case AttributeType::PLACE:
+      return place;
+    default:
+      PADDLE_THROW(common::errors::Unimplemented(
+          "Unsupported attribute type %d in the kernel benchmark.",
+          static_cast<int>(type)));
+  }
+}
+
+template <typename T>
+static void FillUniform(DenseTensor* tensor,
+                        double low,
+                        double high,
+                        std::mt19937* rng) {
+  std::uniform_real_distribution<double> dist(low, high);
+  T* data = tensor->data<T>();
+  for (int64_t i = 0; i < tensor->numel(); ++i) {
+    data[i] = static_cast<T>(static_cast<float>(dist(*rng)));
+  }
+}
+
+static DenseTensor MakeInput(const TensorSpec& spec,
+                             const DeviceContext& dev_ctx,
+                             std::mt19937* rng) {
+  DenseTensor cpu_tensor;
+  cpu_tensor.Resize(common::make_ddim(spec.shape));
+  DeviceContextPool::Instance().Get(CPUPlace())->Alloc(&cpu_tensor,
+                                                       spec.dtype);
+  PD_VISIT_ALL_TYPES(spec.dtype, "FillUniform", ([&] {
+                       FillUniform<data_t>(
+                           &cpu_tensor, spec.low, spec.high, rng);
+                     }));
+  if (dev_ctx.GetPlace().GetType() == AllocationType::CPU) {
+    return cpu_tensor;
+  }
+  DenseTensor tensor;
+  Copy(dev_ctx, cpu_tensor, dev_ctx.GetPlace(), true, &tensor);
+  return tensor;
+}
+
+static size_t Bytes(const TensorSpec& spec) {
+  int64_t numel = 1;
+  for (auto dim : spec.shape) {
+    numel *= dim;
+  }
+  return numel * SizeOf(spec.dtype);
+}
+
+struct BenchResult {
+  double time_us;
+  double gbps;
+  double tflops;
+};
+
+static bool RunCase(const BenchCase& c, BenchResult* result) {
+  KernelKey key(c.backend, DataLayout::ALL_LAYOUT, c.dtype);
+  const auto& factory = KernelFactory::Instance();
+  if (!factory.HasKernel(c.kernel, key)) {
+    LOG(WARNING) << "Skip " << c.Key() << ", the kernel is not registered.";
+    return false;
+  }
+  Place place = TransToPhiPlace(c.backend);
+  auto* dev_ctx = DeviceContextPool::Instance().Get(place);
+  const auto& kernel = factory.SelectKernel(c.kernel, key);
+  const auto& args_def = kernel.args_def();
+  PADDLE_ENFORCE_EQ(
+      c.inputs.size(),
+      args_def.input_defs().size(),
+      common::errors::InvalidArgument(
+          "%s expects %d inputs but the spec gives %d.",
+          c.kernel,
+          args_def.input_defs().size(),
+          c.inputs.size()));
+  PADDLE_ENFORCE_EQ(
+      c.outputs.size(),
+      args_def.output_defs().size(),
+      common::errors::InvalidArgument(
+          "%s expects %d outputs but the spec gives %d.",
+          c.kernel,
+          args_def.output_defs().size(),
+          c.outputs.size()));
+  size_t num_attrs = c.attrs ? c.attrs.size() : 0;
+  PADDLE_ENFORCE_EQ(
+      num_attrs,
+      args_def.attribute_defs().size(),
+      common::errors::InvalidArgument(
+          "%s expects %d attributes but the spec gives %d.",
+          c.kernel,
+          args_def.attribute_defs().size(),
+          num_attrs));
+
+  std::mt19937 rng(2024);
+  size_t bytes = 0;
+  // deques keep the tensors in place while the context points to them
+  std::deque<DenseTensor> tensors;
+  KernelContext ctx(dev_ctx);
+  for (const auto& arg : c.inputs) {
+    if (arg.tensors.empty()) {
+      ctx.EmplaceBackInput(nullptr);
+      continue;
+    }
+    paddle::small_vector<const TensorBase*> ins;
+    for (const auto& spec : arg.tensors) {
+      tensors.push_back(MakeInput(spec, *dev_ctx, &rng));
+      ins.push_back(&tensors.back());
+      bytes += Bytes(spec);
+    }
+    if (arg.is_vector) {
+      ctx.EmplaceBackInputs(std::move(ins));
+    } else {
+      ctx.EmplaceBackInput(ins[0]);
+    }
+  }
+  for (const auto& arg : c.outputs) {
+    if (arg.tensors.empty()) {
+      ctx.EmplaceBackOutput(nullptr);
+      continue;
+    }
+    paddle::small_vector<TensorBase*> outs;
+    for (const auto& spec : arg.tensors) {
+      tensors.emplace_back();
+      tensors.back().set_meta(
+          DenseTensorMeta(spec.dtype, common::make_ddim(spec.shape)));
+      outs.push_back(&tensors.back());
+      bytes += Bytes(spec);
+    }
+    if (arg.is_vector) {
+      ctx.EmplaceBackOutputs(std::move(outs));
+    } else {
+      ctx.EmplaceBackOutput(outs[0]);
+    }
+  }
+  for (size_t i = 0; i < num_attrs; ++i) {
+    ctx.EmplaceBackAttr(
+        ParseAttr(c.attrs[i], args_def.attribute_defs()[i].type_index, place));
+  }
+
+  for (int i = 0; i < FLAGS_kernel_bench_warmup; ++i) {
+    kernel(&ctx);
+  }
+  dev_ctx->Wait();
+  uint64_t start = PosixInNsec();
+  for (int i = 0; i < FLAGS_kernel_bench_repeat; ++i) {
+    kernel(&ctx);
+  }
+  dev_ctx->Wait();
+  double time_ns =
+      static_cast<double>(PosixInNsec() - start) / FLAGS_kernel_bench_repeat;
+  result->time_us = time_ns / 1e3;
+  result->gbps = bytes / time_ns;
+  result->tflops = c.flops / time_ns / 1e3;
+  return true;
+}
+
+static std::map<std::string, double> LoadBaseline(const std::string& path) {
+  std::map<std::string, double> baseline;
+  std::ifstream ifs(path);
+  if (path.empty() || !ifs.good()) {
+    return baseline;
+  }
+  for (const auto& item : YAML::Load(ifs)) {
+    baseline[item.first.as<std::string>()] = item.second.as<double>();
+  }
+  return baseline;
+}
+
+static void SaveBaseline(const std::string& path,
+                         const std::map<std::string, double>& times) {
+  YAML::Emitter out;
+  out << YAML::BeginMap;
+  for (const auto& [key, time_us] : times) {
+    out << YAML::Key << key << YAML::Value << time_us;
+  }
+  out << YAML::EndMap;
+  std::ofstream ofs(path);
+  PADDLE_ENFORCE_EQ(
+      ofs.is_open(),
+      true,
+      common::errors::Unavailable("Failed to open %s for writing.", path));
+  ofs << out.c_str() << "\n";
+}
+
+TEST(KernelBenchmark, RunSpec) {
+  auto cases = ParseSpec(FLAGS_kernel_bench_spec);
+  auto baseline = LoadBaseline(FLAGS_kernel_bench_baseline);
+  std::map<std::string, double> times;
+  for (const auto& c : cases) {
+#if !defined(PADDLE_WITH_CUDA) && !defined(PADDLE_WITH_HIP)
+    if (c.backend == Backend::GPU) {
+      continue;
+    }
+#endif
+    BenchResult result;
+    if (!RunCase(c, &result)) {
+      continue;
+    }
+    times[c.Key()] = result.time_us;
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(3) << c.Key() << ": "
+       << result.time_us << " us, " << result.gbps << " GB/s";
+    if (c.flops > 0) {
+      os << ", " << result.tflops << " TFLOPs";
+    }
+    auto iter = baseline.find(c.Key());
+    if (iter != baseline.end()) {
+      os << ", baseline " << iter->second << " us";
+      if (!FLAGS_kernel_bench_update_baseline) {
+        EXPECT_LE(result.time_us,
+                  iter->second * (1.0 + FLAGS_kernel_bench_tolerance))
+            << c.Key() << " regressed over the baseline.";
+      }
+    }
+    LOG(INFO) << os.str();
+  }
+  if (FLAGS_kernel_bench_update_baseline) {
+    PADDLE_ENFORCE_EQ(FLAGS_kernel_bench_baseline.empty(),
+                      false,
+                      common::errors::InvalidArgument(
+                          "kernel_bench_baseline must be given to update "
+                          "the baseline."));
+    SaveBaseline(FLAGS_kernel_bench_baseline, times);
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
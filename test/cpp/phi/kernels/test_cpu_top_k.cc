@@ -0,0 +1,146 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+#include "gtest/gtest.h"
+#include "paddle/phi/common/port.h"
+#include "paddle/phi/kernels/funcs/top_k_function_cpu.h"
+
+namespace phi {
+namespace tests {
+
+inline double GetCurrentUS() {
+  struct timeval time = {};
+  gettimeofday(&time, nullptr);
+  return 1e+6 * time.tv_sec + time.tv_usec;  // NOLINT
+}
+
+// the partial sort over pairs the topk kernel used before
+void RefTopK(const std::vector<float>& row,
+             int k,
+             bool largest,
+             float* out,
+             int64_t* indices) {
+  std::vector<std::pair<float, int64_t>> col_vec;
+  col_vec.reserve(row.size());
+  for (size_t j = 0; j < row.size(); ++j) {
+    col_vec.emplace_back(row[j], static_cast<int64_t>(j));
+  }
+  std::partial_sort(
+      col_vec.begin(),
+      col_vec.begin() + k,
+      col_vec.end(),
+      [largest](const std::pair<float, int64_t>& l,
+                const std::pair<float, int64_t>& r) {
+        if (phi::funcs::TopKBefore(l.first, r.first, largest)) {
+          return true;
+        }
+        return !phi::funcs::TopKBefore(r.first, l.first, largest) &&
+               l.second < r.second;
+      });
+  for (int i = 0; i < k; ++i) {
+    out[i] = col_vec[i].first;
+    indices[i] = col_vec[i].second;
+  }
+}
+
+void CheckTopK(const std::vector<float>& row, int k, bool largest) {
+  std::vector<float> out(k);
+  std::vector<float> ref_out(k);
+  std::vector<int64_t> indices(k);
+  std::vector<int64_t> ref_indices(k);
+  phi::funcs::HeapTopK<float, int64_t>(row.data(),
+                                       static_cast<int64_t>(row.size()),
+                                       k,
+                                       largest,
+                                       out.data(),
+                                       indices.data());
+  RefTopK(row, k, largest, ref_out.data(), ref_indices.data());
+  for (int i = 0; i < k; ++i) {
+    EXPECT_EQ(indices[i], ref_indices[i]);
+    if (std::isnan(ref_out[i])) {
+      EXPECT_TRUE(std::isnan(out[i]));
+    } else {
+      EXPECT_EQ(out[i], ref_out[i]);
+    }
+  }
+}
+
+std::vector<float> RandomRow(int width, unsigned int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> uniform_dist(-20.f, 20.f);
+  std::vector<float> row(width);
+  for (auto& value : row) {
+    value = uniform_dist(rng);
+  }
+  return row;
+}
+
+TEST(top_k, heap_top_k) {
+  for (int width : {17, 100, 1000, 4099}) {
+    for (int k : {1, 5, 16}) {
+      auto row = RandomRow(width, width + k);
+      CheckTopK(row, k, true);
+      CheckTopK(row, k, false);
+    }
+  }
+}
+
+TEST(top_k, heap_top_k_ties_and_nan) {
+  std::vector<float> row(1000);
+  for (size_t j = 0; j < row.size(); ++j) {
+    row[j] = static_cast<float>(j % 7);
+  }
+  CheckTopK(row, 10, true);
+  CheckTopK(row, 10, false);
+
+  row[3] = std::numeric_limits<float>::quiet_NaN();
+  row[500] = std::numeric_limits<float>::quiet_NaN();
+  CheckTopK(row, 4, true);
+  CheckTopK(row, 4, false);
+}
+
+TEST(top_k, benchmark) {
+  constexpr int repeat = 20;
+  constexpr int k = 8;
+  for (int width : {1 << 10, 1 << 12, 1 << 14, 50000, 1 << 16, 1 << 18}) {
+    auto row = RandomRow(width, width);
+    std::vector<float> out(k);
+    std::vector<int64_t> indices(k);
+
+    auto st = GetCurrentUS();
+    for (int i = 0; i < repeat; ++i) {
+      phi::funcs::HeapTopK<float, int64_t>(
+          row.data(), width, k, true, out.data(), indices.data());
+    }
+    auto mt = GetCurrentUS();
+    for (int i = 0; i < repeat; ++i) {
+      RefTopK(row, k, true, out.data(), indices.data());
+    }
+    auto et = GetCurrentUS();
+    VLOG(3) << "Vocab size " << width << ", k " << k
+            << ": partial sort takes: " << (et - mt) / repeat
+            << " us, heap top k takes: " << (mt - st) / repeat << " us";
+  }
+}
+
+}  // namespace tests
+}  // namespace phi
@@ -18,6 +18,7 @@
 #include "gtest/gtest.h"
 #include "paddle/phi/backends/context_pool.h"
 #include "paddle/phi/kernels/funcs/blas/blas.h"
+#include "paddle/phi/kernels/funcs/blas/packed_weight.h"
 #include "paddle/phi/kernels/funcs/math_function.h"
 
 namespace phi {
@@ -376,5 +377,50 @@ TEST(math_function, gemm_warp) {
   GemmWarpTest<double>(8, 5, 6, 2.0, 1.0);
 }
 
+#ifdef PADDLE_WITH_MKLML
+TEST(math_function, gemm_packed_weight) {
+  auto* dev_ctx =
+      phi::DeviceContextPool::Instance().GetByPlace(phi::CPUPlace());
+  const int m = 5;
+  const int n = 24;
+  const int k = 16;
+  phi::DenseTensor mat_a;
+  phi::DenseTensor mat_b;
+  phi::DenseTensor mat_c_ref;
+  phi::DenseTensor mat_c_packed;
+  mat_a.Resize({m, k});
+  float* A = dev_ctx->template Alloc<float>(&mat_a);
+  mat_b.Resize({k, n});
+  float* B = dev_ctx->template Alloc<float>(&mat_b);
+  mat_c_ref.Resize({m, n});
+  float* CREF = dev_ctx->template Alloc<float>(&mat_c_ref);
+  mat_c_packed.Resize({m, n});
+  float* CPACKED = dev_ctx->template Alloc<float>(&mat_c_packed);
+  for (int i = 0; i < mat_a.numel(); ++i) {
+    A[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  for (int i = 0; i < mat_b.numel(); ++i) {
+    B[i] = static_cast<float>(i % 5) * 0.5f;
+  }
+
+  auto blas = GetBlas<float>(*dev_ctx);
+  blas.MatMul(m, n, k, A, B, CREF);
+
+  auto& cache = phi::funcs::PackedWeightCache::Instance();
+  ASSERT_TRUE(cache.Pack(mat_b));
+  EXPECT_NE(cache.Find(B, k, n, phi::DataType::FLOAT32), nullptr);
+  EXPECT_EQ(cache.Find(B, n, k, phi::DataType::FLOAT32), nullptr);
+  blas.MatMul(m, n, k, A, B, CPACKED);
+  for (int i = 0; i < mat_c_ref.numel(); ++i) {
+    EXPECT_FLOAT_EQ(CREF[i], CPACKED[i]);
+  }
+
+  // the packed weight is dropped with the allocation of the weight
+  mat_b.clear();
+  EXPECT_EQ(cache.Find(B, k, n, phi::DataType::FLOAT32), nullptr);
+  cache.Clear();
+}
+#endif
+
 }  // namespace tests
 }  // namespace phi
@@ -0,0 +1,78 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/ir/group_schedule/config/group_tile_config.h"
+
+namespace cinn {
+namespace ir {
+
+TEST(DeclaredShapeBuckets, Parse) {
+  DeclaredShapeBuckets buckets =
+      ParseDeclaredShapeBuckets("S: 128,512, 2048;R:1024");
+  ASSERT_EQ(buckets.size(), 2UL);
+  EXPECT_EQ(buckets["S"], (std::vector<int64_t>{128, 512, 2048}));
+  EXPECT_EQ(buckets["R"], (std::vector<int64_t>{1024}));
+  EXPECT_TRUE(ParseDeclaredShapeBuckets("").empty());
+
+  EXPECT_ANY_THROW(ParseDeclaredShapeBuckets("X:128"));
+  EXPECT_ANY_THROW(ParseDeclaredShapeBuckets("S:512,128"));
+  EXPECT_ANY_THROW(ParseDeclaredShapeBuckets("S:abc"));
+  EXPECT_ANY_THROW(ParseDeclaredShapeBuckets("S128"));
+}
+
+TEST(DeclaredShapeBuckets, SpecializeDynamicSpatial) {
+  // e.g. layer_norm over [batch * seq_len, 768] with a dynamic seq_len
+  auto base_info = std::make_shared<ScheduleConfig::BaseInfo>();
+  base_info->data_rank = 2;
+  base_info->reduce_axis = {1};
+  base_info->spatial_numel = -1;
+  base_info->reduce_numel = 768;
+  base_info->has_dynamic_spatial = true;
+  base_info->iter_space_type = {{"S", "dynamic"}, {"R", "static"}};
+
+  auto config_map = BuildDeclaredShapeBucketConfig(
+      base_info,
+      common::DefaultNVGPUTarget(),
+      ParseDeclaredShapeBuckets("S:128,4096;R:1024"));
+  // the reduce extent is static, its declared buckets don't apply
+  ASSERT_EQ(config_map.size(), 2UL);
+  for (const auto& [bucket_info, tile_config] : config_map) {
+    ASSERT_EQ(bucket_info.space.size(), 2UL);
+    EXPECT_TRUE(bucket_info.space[0].is_dynamic);
+    EXPECT_FALSE(bucket_info.space[1].is_dynamic);
+    EXPECT_EQ(bucket_info.space[1].upper_bound, INT32_MAX);
+    EXPECT_LT(bucket_info.bucket_priority, 100);
+    if (bucket_info.space[0].lower_bound == 1) {
+      EXPECT_EQ(bucket_info.space[0].upper_bound, 128);
+    } else {
+      EXPECT_EQ(bucket_info.space[0].lower_bound, 129);
+      EXPECT_EQ(bucket_info.space[0].upper_bound, 4096);
+    }
+    EXPECT_EQ(tile_config.grid_reduce_num, 1);
+    EXPECT_GE(tile_config.warp_num, 1);
+  }
+
+  // nothing is declared for the dynamic extent
+  EXPECT_TRUE(BuildDeclaredShapeBucketConfig(base_info,
+                                             common::DefaultNVGPUTarget(),
+                                             ParseDeclaredShapeBuckets("R:64"))
+                  .empty());
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -0,0 +1,112 @@
+// Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "paddle/cinn/common/target.h"
+#include "paddle/cinn/ir/group_schedule/config/tuning_database.h"
+
+namespace cinn {
+namespace ir {
+
+namespace {
+
+TuningRecord MakeRecord(const std::string& signature,
+                        int spatial_numel,
+                        int reduce_numel,
+                        int64_t warp_num) {
+  TuningRecord record;
+  record.group_signature = signature;
+  record.bucket_info = BucketInfo(spatial_numel,
+                                  spatial_numel,
+                                  reduce_numel,
+                                  reduce_numel,
+                                  /* sp_is_dynamic = */ false,
+                                  /* rb_is_dynamic = */ false);
+  record.tile_config.warp_num = warp_num;
+  record.tile_config.tree_reduce_num = 256;
+  record.tile_config.spatial_inner_num = 1;
+  record.tile_config.reduce_method = BlockReduceMethod();
+  record.score = 10.0 * warp_num;
+  return record;
+}
+
+}  // namespace
+
+TEST(TuningRecordDatabase, CommitAndReload) {
+  const std::string path = "./tuning_database_test.json";
+  std::remove(path.c_str());
+  const common::Target target = common::DefaultTarget();
+  const std::string layer_norm =
+      "cinn_op.reduce_sum(float32);pd_op.divide(float32)";
+  const std::string rms_norm = "pd_op.multiply(float32);cinn_op.reduce_sum";
+
+  {
+    TuningRecordDatabase database(path);
+    EXPECT_TRUE(database.GetRecords(target, layer_norm).empty());
+    database.Commit(target, MakeRecord(layer_norm, 128, 4096, 8));
+    database.Commit(target, MakeRecord(layer_norm, 256, 4096, 4));
+    database.Commit(target, MakeRecord(rms_norm, 128, 4096, 16));
+    // a later record of the same bucket replaces the earlier one
+    database.Commit(target, MakeRecord(layer_norm, 128, 4096, 2));
+  }
+  // a crashed writer may leave a broken line behind
+  {
+    std::ofstream os(path, std::ofstream::app);
+    os << "{\"groupSignature\": \"cinn_op\n";
+  }
+
+  TuningRecordDatabase database(path);
+  auto records = database.GetRecords(target, layer_norm);
+  ASSERT_EQ(records.size(), 2UL);
+  for (const auto& record : records) {
+    int64_t expected_warp_num =
+        record.bucket_info.space[0].lower_bound == 128 ? 2 : 4;
+    EXPECT_EQ(record.tile_config.warp_num, expected_warp_num);
+    EXPECT_EQ(record.tile_config.tree_reduce_num, 256);
+    EXPECT_EQ(record.tile_config.reduce_method.index(),
+              ReduceMethod(BlockReduceMethod()).index());
+  }
+  EXPECT_TRUE(database.HasRecord(
+      target, rms_norm, MakeRecord(rms_norm, 128, 4096, 1).bucket_info));
+  EXPECT_FALSE(database.HasRecord(
+      target, rms_norm, MakeRecord(rms_norm, 128, 2048, 1).bucket_info));
+  std::remove(path.c_str());
+}
+
+TEST(TuningRecordDatabase, TuningBucketOf) {
+  ScheduleConfig::BaseInfo base_info;
+  base_info.spatial_numel = 128;
+  base_info.reduce_numel = 4096;
+  BucketInfo config_bucket(1, INT32_MAX, 1, INT32_MAX, false, false);
+
+  // static shapes are keyed by their exact extents
+  BucketInfo static_bucket = TuningBucketOf(base_info, config_bucket);
+  ASSERT_EQ(static_bucket.space.size(), 2UL);
+  EXPECT_EQ(static_bucket.space[0].lower_bound, 128);
+  EXPECT_EQ(static_bucket.space[0].upper_bound, 128);
+  EXPECT_EQ(static_bucket.space[1].lower_bound, 4096);
+  EXPECT_EQ(static_bucket.space[1].upper_bound, 4096);
+
+  // dynamic shapes keep the bucket of the config
+  base_info.has_dynamic_reduce = true;
+  EXPECT_TRUE(IsSameBucketSpace(TuningBucketOf(base_info, config_bucket),
+                                config_bucket));
+}
+
+}  // namespace ir
+}  // namespace cinn
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <sstream>
 
 #include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
@@ -36,6 +37,8 @@
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
 #include "paddle/fluid/pir/dialect/operator/transforms/param_to_variable.h"
 #include "paddle/phi/core/enforce.h"
+#include "paddle/pir/include/core/builder.h"
+#include "paddle/pir/src/core/op_memory_pool.h"
 #include "test/cpp/pir/tools/macros_utils.h"
 class AddOp : public pir::Op<AddOp> {
  public:
@@ -128,3 +131,45 @@ TEST(program_test, slice_combine_test) {
   // (8) Traverse Program
   EXPECT_EQ(program.block()->size() == 4, true);
 }
+
+TEST(program_test, op_memory_reuse) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  pir::Type fp32_dtype = pir::Float32Type::get(ctx);
+  constexpr int kNumOps = 100000;
+  auto &pool = pir::detail::OpMemoryPool::Instance();
+
+  size_t chunk_bytes = 0;
+  for (int round = 0; round < 2; ++round) {
+    auto start = std::chrono::steady_clock::now();
+    {
+      pir::Program program(ctx);
+      pir::Builder builder = pir::Builder(ctx, program.block());
+      pir::Value a = builder
+                         .Build<pir::ConstantOp>(
+                             pir::FloatAttribute::get(ctx, 1.0), fp32_dtype)
+                         .out();
+      for (int i = 1; i < kNumOps; ++i) {
+        pir::Value b = builder
+                           .Build<pir::ConstantOp>(
+                               pir::FloatAttribute::get(ctx, 2.0), fp32_dtype)
+                           .out();
+        a = builder
+                .Build<pir::CombineOp>(std::vector<pir::Value>{a, b})
+                .result(0);
+        a = builder.Build<pir::SliceOp>(a, 0).result(0);
+      }
+      EXPECT_EQ(program.block()->size(), 3u * kNumOps - 2);
+    }
+    VLOG(0) << "Build and destroy " << 3 * kNumOps << " operations in "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                             start)
+                   .count()
+            << " s, pooled chunks " << pool.chunk_bytes() << " bytes.";
+    // The operations of the second round reuse the memory of the first.
+    if (round == 0) {
+      chunk_bytes = pool.chunk_bytes();
+    } else {
+      EXPECT_EQ(pool.chunk_bytes(), chunk_bytes);
+    }
+  }
+}
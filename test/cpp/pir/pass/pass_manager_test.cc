@@ -13,12 +13,14 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include "glog/logging.h"
 
 // NOTE(zhangbo9674): File pd_op.h is generated by op_gen.py, see details in
 // paddle/fluid/pir/dialect/CMakeLists.txt.
 #include "paddle/common/errors.h"
 #include "paddle/fluid/pir/dialect/operator/interface/op_yaml_info.h"
+#include "paddle/fluid/pir/dialect/operator/ir/control_flow_op.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_type.h"
 #include "paddle/fluid/pir/dialect/operator/ir/pd_op.h"
@@ -32,6 +34,8 @@
 #include "paddle/pir/include/core/ir_context.h"
 #include "paddle/pir/include/core/op_base.h"
 #include "paddle/pir/include/core/operation.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_dialect.h"
+#include "paddle/pir/include/dialect/control_flow/ir/cf_op.h"
 #include "paddle/pir/include/pass/pass.h"
 #include "paddle/pir/include/pass/pass_manager.h"
 #include "test/cpp/pir/tools/macros_utils.h"
@@ -312,3 +316,63 @@ TEST(pass_manager, PassManager) {
       true,
       common::errors::InvalidArgument("Program not run. Expected run."));
 }
+
+class CountIfOpPass : public pir::Pass {
+ public:
+  explicit CountIfOpPass(std::atomic<int> *count)
+      : pir::Pass("CountIfOpPass", 1), count_(count) {}
+
+  void Run(pir::Operation *op) override {
+    PADDLE_ENFORCE_EQ(
+        pass_state()->ir,
+        op,
+        common::errors::InvalidArgument("pass state of another operation."));
+    ++*count_;
+    AddStatistics(1);
+  }
+
+  bool CanApplyOn(pir::Operation *op) const override {
+    return op->isa<paddle::dialect::IfOp>();
+  }
+
+ private:
+  std::atomic<int> *count_;
+};
+
+TEST(pass_manager, ParallelRun) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::ControlFlowDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+
+  auto cond = builder.Build<paddle::dialect::FullOp>(
+      std::vector<int64_t>{1}, true, phi::DataType::BOOL);
+  constexpr int kNumIfOps = 16;
+  for (int i = 0; i < kNumIfOps; ++i) {
+    builder.SetInsertionPointToBlockEnd(program.block());
+    auto if_op = builder.Build<paddle::dialect::IfOp>(
+        cond.out(), std::vector<pir::Type>{cond.out().type()});
+    for (auto *block : {&if_op.true_block(), &if_op.false_block()}) {
+      builder.SetInsertionPointToStart(block);
+      // The last if op uses an outer value and runs sequentially.
+      pir::Value out = i + 1 == kNumIfOps
+                           ? cond.out()
+                           : builder
+                                 .Build<paddle::dialect::FullOp>(
+                                     std::vector<int64_t>{1},
+                                     i % 2 == 0,
+                                     phi::DataType::BOOL)
+                                 .out();
+      builder.Build<pir::YieldOp>(std::vector<pir::Value>{out});
+    }
+  }
+
+  std::atomic<int> count{0};
+  pir::PassManager pm(ctx);
+  pm.AddPass(std::make_unique<CountIfOpPass>(&count));
+  pm.EnableParallelRun(4);
+
+  EXPECT_TRUE(pm.Run(&program));
+  EXPECT_EQ(count.load(), kNumIfOps);
+}
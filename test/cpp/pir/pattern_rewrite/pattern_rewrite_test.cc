@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 #include <memory>
 #include <numeric>
@@ -22,6 +24,7 @@
 
 #include "paddle/common/enforce.h"
 #include "paddle/common/errors.h"
+#include "paddle/common/flags.h"
 #include "paddle/fluid/framework/scope.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_attribute.h"
 #include "paddle/fluid/pir/dialect/operator/ir/op_dialect.h"
@@ -56,6 +59,8 @@
 #include "paddle/phi/core/kernel_registry.h"
 #include "test/cpp/pir/tools/macros_utils.h"
 
+COMMON_DECLARE_string(pir_constant_folding_cache_dir);
+
 PD_DECLARE_KERNEL(full, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(add, CPU, ALL_LAYOUT);
 PD_DECLARE_KERNEL(sqrt, CPU, ALL_LAYOUT);
@@ -431,6 +436,50 @@ TEST(pattern_rewrite, Patterns) {
   EXPECT_EQ(program.block()->size(), 17u);
 }
 
+TEST(pattern_rewrite, IncrementalDriver) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+
+  for (bool incremental : {false, true}) {
+    pir::Program program(ctx);
+    pir::Builder builder = pir::Builder(ctx, program.block());
+    pir::Value out = builder
+                         .Build<paddle::dialect::FullOp>(
+                             std::vector<int64_t>{2, 3, 4, 5}, 1.5)
+                         .out();
+    for (int i = 0; i < 6; ++i) {
+      out = builder
+                .Build<paddle::dialect::TransposeOp>(
+                    out, std::vector<int>{0, 2, 3, 1})
+                .out();
+    }
+    builder.Build<paddle::dialect::FetchOp>(out, "out", 0);
+
+    pir::RewritePatternSet ps(ctx);
+    ps.Add<RedundantTransposeFusePattern>(ctx);
+    pir::FrozenRewritePatternSet patterns(std::move(ps));
+    pir::GreedyRewriteConfig config;
+    config.incremental = incremental;
+    int64_t num_tried = 0;
+    int64_t num_applied = 0;
+    config.pattern_matched_hook =
+        [&](const pir::Pattern &, pir::Operation *, bool applied) {
+          ++num_tried;
+          if (applied) ++num_applied;
+        };
+    auto [converged, num_rewrites] =
+        pir::ApplyPatternsGreedily(program.module_op(), patterns, config);
+
+    EXPECT_TRUE(converged);
+    EXPECT_EQ(num_applied, num_rewrites);
+    EXPECT_GE(num_tried, num_applied);
+    auto *fetch_input = program.block()->back().operand_source(0).defining_op();
+    EXPECT_TRUE(fetch_input->isa<paddle::dialect::TransposeOp>());
+    EXPECT_TRUE(pir::GetDefiningOpForInput(fetch_input, 0)
+                    ->isa<paddle::dialect::FullOp>());
+  }
+}
+
 void BuildConstantFoldingProgram(pir::Program *program,
                                  pir::IrContext *ctx,
                                  paddle::framework::Scope *scope) {
@@ -528,6 +577,65 @@ TEST(constant_folding, ConstantFolding_Train) {
   EXPECT_EQ(program.block()->size(), 4u);
 }
 
+TEST(constant_folding, ConstantFolding_Cache) {
+  pir::IrContext *ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+
+  std::string cache_dir = "constant_folding_cache_test";
+  std::filesystem::remove_all(cache_dir);
+  std::filesystem::create_directories(cache_dir);
+  FLAGS_pir_constant_folding_cache_dir = cache_dir;
+
+  // The second run loads the folded results saved by the first one.
+  for (int run = 0; run < 2; ++run) {
+    pir::Program program(ctx);
+    paddle::framework::Scope scope;
+    BuildConstantFoldingProgram(&program, ctx, &scope);
+    for (auto *name : {"a", "b", "c"}) {
+      auto *tensor = scope.FindVar(name)->GetMutable<phi::DenseTensor>();
+      std::fill(tensor->data<float>(),
+                tensor->data<float>() + tensor->numel(),
+                1.0f);
+    }
+
+    pir::PassManager pm(ctx);
+    std::unique_ptr<pir::Pass> constant_folding_pass =
+        pir::CreateConstantFoldingPass();
+    phi::Place place = phi::CPUPlace();
+    constant_folding_pass->SetNotOwned(pir::Pass::kPlaceAttr, &place);
+    constant_folding_pass->SetNotOwned(pir::Pass::kParamScopeAttr, &scope);
+    pm.AddPass(std::move(constant_folding_pass));
+    pm.AddPass(pir::CreateDeadCodeEliminationPass());
+
+    PADDLE_ENFORCE_EQ(pm.Run(&program),
+                      true,
+                      common::errors::ExecutionTimeout(
+                          "Sorry, the test for program is timeout."));
+    EXPECT_EQ(program.block()->size(), 2u);
+
+    auto *folded_op = program.block()->back().operand_source(0).defining_op();
+    std::string folded_name =
+        folded_op->isa<pir::ParameterOp>()
+            ? folded_op->dyn_cast<pir::ParameterOp>().param_name()
+            : folded_op->dyn_cast<pir::ConstantTensorOp>().tensor_name();
+    auto &folded = scope.FindVar(folded_name)->Get<phi::DenseTensor>();
+    for (int64_t i = 0; i < folded.numel(); ++i) {
+      EXPECT_EQ(folded.data<float>()[i], 3.0f);
+    }
+  }
+
+  size_t num_cache_files = 0;
+  for (auto &entry : std::filesystem::directory_iterator(cache_dir)) {
+    EXPECT_EQ(entry.path().extension(), ".pdfold");
+    ++num_cache_files;
+  }
+  EXPECT_EQ(num_cache_files, 2u);
+
+  FLAGS_pir_constant_folding_cache_dir = "";
+  std::filesystem::remove_all(cache_dir);
+}
+
 void BuildConcatProgram(pir::Program *program, pir::IrContext *ctx) {
   pir::Builder builder = pir::Builder(ctx, program->block());
   auto x = builder
@@ -60,3 +60,42 @@ TEST(SaveTest, uncompelteted_parameter) {
   EXPECT_EQ(new_op.attribute("stop_gradient").isa<pir::ArrayAttribute>(), true);
   EXPECT_EQ(new_op.attribute("trainable").isa<pir::ArrayAttribute>(), true);
 }
+
+TEST(SaveTest, binary_program) {
+  pir::IrContext* ctx = pir::IrContext::Instance();
+  ctx->GetOrRegisterDialect<paddle::dialect::OperatorDialect>();
+  ctx->GetOrRegisterDialect<pir::BuiltinDialect>();
+  pir::Program program(ctx);
+  pir::Builder builder = pir::Builder(ctx, program.block());
+  for (int i = 0; i < 100; ++i) {
+    paddle::dialect::FullOp full_op = builder.Build<paddle::dialect::FullOp>(
+        std::vector<int64_t>{64, i + 1}, -1.5 * i);
+    builder.Build<paddle::dialect::ReluOp>(full_op.out());
+  }
+
+  pir::WriteModule(
+      program, "./test_program.json", /*pir_version*/ 0, true, false, true);
+  pir::WriteModule(program,
+                   "./test_program.bin",
+                   /*pir_version*/ 0,
+                   true,
+                   false,
+                   true,
+                   /*binary*/ true);
+
+  pir::Program json_program(ctx);
+  pir::Program binary_program(ctx);
+  EXPECT_TRUE(
+      pir::ReadModule("./test_program.json", &json_program, /*pir_version*/ 0));
+  EXPECT_TRUE(pir::ReadModule(
+      "./test_program.bin", &binary_program, /*pir_version*/ 0));
+
+  ASSERT_EQ(json_program.block()->num_ops(), binary_program.block()->num_ops());
+  auto json_iter = json_program.block()->begin();
+  auto binary_iter = binary_program.block()->begin();
+  for (; json_iter != json_program.block()->end(); ++json_iter, ++binary_iter) {
+    EXPECT_EQ(json_iter->name(), binary_iter->name());
+    EXPECT_EQ(json_iter->attributes(), binary_iter->attributes());
+    EXPECT_EQ(json_iter->result(0).type(), binary_iter->result(0).type());
+  }
+}
@@ -61,4 +61,22 @@ TEST(ConstraintsManager, BroadcastableCstr) {
   ASSERT_TRUE(cstr_mgr.IsBroadcastable(sym_expr_0, int_expr));
 }
 
+TEST(ConstraintsManager, SubstituteKeepsUnrelatedCstr) {
+  ConstraintsManager cstr_mgr;
+  DimExprBuilder builder;
+
+  // Eq(Mul(S0,S1),Mul(S2,S3)) does not contain S4 and is kept as is.
+  DimExpr mul_expr_0 = builder.Mul(DimExpr("S0"), DimExpr("S1"));
+  DimExpr mul_expr_1 = builder.Mul(DimExpr("S2"), DimExpr("S3"));
+  cstr_mgr.AddEqCstr(mul_expr_0, mul_expr_1);
+  cstr_mgr.AddGTOneCstr(DimExpr("S5"));
+  for (int i = 5; i < 100; ++i) {
+    cstr_mgr.AddEqCstr(DimExpr("S" + std::to_string(i)),
+                       DimExpr("S" + std::to_string(i - 1)));
+  }
+  ASSERT_TRUE(cstr_mgr.IsEqual(mul_expr_0, mul_expr_1));
+  ASSERT_TRUE(cstr_mgr.IsGTOne(DimExpr("S4")));
+  ASSERT_FALSE(cstr_mgr.IsGTOne(DimExpr("S5")));
+}
+
 }  // namespace symbol::test
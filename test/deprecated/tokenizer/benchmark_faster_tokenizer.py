@@ -0,0 +1,91 @@
+#   Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Measures the sentences per second of the faster_tokenizer op on CPU.
+Usage: python benchmark_faster_tokenizer.py [--batch_sizes 1,32,256]
+"""
+
+import argparse
+import random
+import time
+
+from test_faster_tokenizer_op_deprecated import (
+    BertTokenizer,
+    FasterTokenizer,
+    to_string_tensor,
+)
+
+import paddle
+
+SENTENCES = [
+    '很好的地理位置，一蹋糊涂的服务，萧条的酒店。',
+    '选择珠江花园的原因就是方便，有电动扶梯直接到达海边，周围餐馆、食廊、商场、超市、摊位一应俱全。',
+    '非常不错，服务很好，位于市中心区，交通方便，不过价格也高！',
+    'Test bert tokenizer. The first text.',
+    'The quick brown fox jumps over the lazy dog, again and again.',
+    'Tokenization should not take longer than the model step itself.',
+]
+
+
+def make_batch(batch_size, words_per_sentence):
+    batch = []
+    for _ in range(batch_size):
+        words = []
+        while len(words) < words_per_sentence:
+            words.extend(random.choice(SENTENCES).split())
+        batch.append(' '.join(words[:words_per_sentence]))
+    return batch
+
+
+def benchmark(tokenizer, batch_size, words_per_sentence, iters, max_seq_len):
+    text = to_string_tensor(make_batch(batch_size, words_per_sentence), "text")
+    for _ in range(3):
+        tokenizer(text, max_seq_len=max_seq_len, pad_to_max_seq_len=True)
+    start = time.perf_counter()
+    for _ in range(iters):
+        tokenizer(text, max_seq_len=max_seq_len, pad_to_max_seq_len=True)
+    elapsed = time.perf_counter() - start
+    return batch_size * iters / elapsed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--batch_sizes', type=str, default='1,32,256')
+    parser.add_argument('--words_per_sentence', type=int, default=64)
+    parser.add_argument('--max_seq_len', type=int, default=128)
+    parser.add_argument('--iters', type=int, default=100)
+    args = parser.parse_args()
+
+    paddle.set_device('cpu')
+    paddle.disable_static()
+    random.seed(2024)
+    vocab = BertTokenizer.from_pretrained("bert-base-chinese").vocab
+    tokenizer = FasterTokenizer(vocab)
+    for batch_size in [int(bs) for bs in args.batch_sizes.split(',')]:
+        sentences_per_second = benchmark(
+            tokenizer,
+            batch_size,
+            args.words_per_sentence,
+            args.iters,
+            args.max_seq_len,
+        )
+        print(
+            f"faster_tokenizer batch_size {batch_size}: "
+            f"{sentences_per_second:.1f} sentences/s"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -174,5 +174,35 @@ class TestToOutputWithCache(Dy2StTestBase):
         self.assertEqual(ret.numpy(), 5050)
 
 
+def decode_step(x, w):
+    return paddle.tanh(paddle.matmul(x, w)) + x
+
+
+class TestRunProgramBoundVars(Dy2StTestBase):
+    def test_repeated_run(self):
+        # the runs after the first share tensors through the bound variables
+        w = paddle.rand([8, 8])
+        static_fn = paddle.jit.to_static(decode_step)
+        x = paddle.rand([2, 8])
+        with paddle.no_grad():
+            for _ in range(10):
+                out = static_fn(x, w)
+                np.testing.assert_allclose(
+                    out.numpy(), decode_step(x, w).numpy(), rtol=1e-5
+                )
+                x = out
+
+        x = paddle.rand([2, 8])
+        x.stop_gradient = False
+        for _ in range(3):
+            out = static_fn(x, w)
+            out.sum().backward()
+            np.testing.assert_allclose(
+                out.numpy(), decode_step(x, w).numpy(), rtol=1e-5
+            )
+            x = paddle.rand([2, 8])
+            x.stop_gradient = False
+
+
 if __name__ == '__main__':
     unittest.main()
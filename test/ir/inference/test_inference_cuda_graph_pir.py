@@ -0,0 +1,104 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+
+
+class TestNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.fc1 = paddle.nn.Linear(16, 32)
+        self.fc2 = paddle.nn.Linear(32, 16)
+
+    def forward(self, x):
+        y = paddle.nn.functional.gelu(self.fc1(x))
+        return paddle.nn.functional.softmax(self.fc2(y) + x)
+
+
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), 'should compile with cuda.'
+)
+class TestPredictorCUDAGraph(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.prefix = os.path.join(self.temp_dir.name, 'cuda_graph/inference')
+        paddle.seed(2024)
+        net = TestNet()
+        with paddle.pir_utils.DygraphPirGuard():
+            model = paddle.jit.to_static(
+                net,
+                input_spec=[
+                    paddle.static.InputSpec(
+                        shape=[None, 16], dtype='float32', name='x'
+                    )
+                ],
+                full_graph=True,
+            )
+            paddle.jit.save(model, self.prefix)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def create_predictor(self, max_num_graphs=None):
+        config = Config(self.prefix + '.json', self.prefix + '.pdiparams')
+        config.enable_use_gpu(256, 0)
+        config.enable_new_executor()
+        config.enable_new_ir()
+        if max_num_graphs is not None:
+            config.enable_cuda_graph(max_num_graphs)
+            self.assertTrue(config.cuda_graph_enabled())
+            self.assertEqual(config.cuda_graph_max_num_graphs(), max_num_graphs)
+        return create_predictor(config)
+
+    def infer(self, predictor, x):
+        input_tensor = predictor.get_input_handle(
+            predictor.get_input_names()[0]
+        )
+        input_tensor.reshape(x.shape)
+        input_tensor.copy_from_cpu(x)
+        predictor.run()
+        output_tensor = predictor.get_output_handle(
+            predictor.get_output_names()[0]
+        )
+        return output_tensor.copy_to_cpu()
+
+    def check(self, max_num_graphs):
+        ref_predictor = self.create_predictor()
+        predictor = self.create_predictor(max_num_graphs)
+        # replays of a captured shape, another shape and back
+        for batch in [2, 2, 5, 2, 5, 7, 2]:
+            x = np.random.random([batch, 16]).astype(np.float32)
+            np.testing.assert_allclose(
+                self.infer(predictor, x),
+                self.infer(ref_predictor, x),
+                rtol=1e-5,
+                atol=1e-6,
+            )
+
+    def test_cuda_graph(self):
+        self.check(8)
+
+    def test_more_shapes_than_graphs(self):
+        self.check(1)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,91 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import sys
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+
+
+class TestNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.fc1 = paddle.nn.Linear(4, 8)
+        self.fc2 = paddle.nn.Linear(8, 4)
+
+    def forward(self, x):
+        return self.fc2(paddle.nn.functional.relu(self.fc1(x)))
+
+
+@unittest.skipIf(sys.platform == 'win32', 'mmap is not supported on Windows.')
+class TestPredictorMmapParams(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.prefix = os.path.join(self.temp_dir.name, 'mmap_params/inference')
+        paddle.seed(2024)
+        net = TestNet()
+        with paddle.pir_utils.DygraphPirGuard():
+            model = paddle.jit.to_static(
+                net,
+                input_spec=[
+                    paddle.static.InputSpec(
+                        shape=[None, 4], dtype='float32', name='x'
+                    )
+                ],
+                full_graph=True,
+            )
+            paddle.jit.save(model, self.prefix)
+        self.x = np.random.random([3, 4]).astype(np.float32)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def run_predictor(self, use_gpu, ir_optim, mmap_params):
+        config = Config(self.prefix + '.json', self.prefix + '.pdiparams')
+        if use_gpu:
+            config.enable_use_gpu(256, 0)
+        else:
+            config.disable_gpu()
+        config.switch_ir_optim(ir_optim)
+        config.enable_new_executor()
+        config.enable_new_ir()
+        config.enable_mmap_params(mmap_params)
+        self.assertEqual(config.mmap_params_enabled(), mmap_params)
+        predictor = create_predictor(config)
+        outputs = predictor.run([paddle.to_tensor(self.x)])
+        return outputs[0].numpy()
+
+    def check(self, use_gpu):
+        for ir_optim in [False, True]:
+            ref = self.run_predictor(use_gpu, ir_optim, False)
+            out = self.run_predictor(use_gpu, ir_optim, True)
+            np.testing.assert_allclose(out, ref, rtol=1e-6, atol=1e-6)
+
+    def test_cpu(self):
+        self.check(False)
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda(), 'should compile with cuda.'
+    )
+    def test_gpu(self):
+        self.check(True)
+
+
+if __name__ == '__main__':
+    unittest.main()
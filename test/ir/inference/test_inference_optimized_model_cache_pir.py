@@ -0,0 +1,93 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.inference import Config, create_predictor
+
+
+class TestNet(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+        self.fc1 = paddle.nn.Linear(4, 8)
+        self.fc2 = paddle.nn.Linear(8, 4)
+
+    def forward(self, x):
+        return self.fc2(paddle.nn.functional.relu(self.fc1(x)))
+
+
+class TestOptimizedModelCache(unittest.TestCase):
+    def setUp(self):
+        self.temp_dir = tempfile.TemporaryDirectory()
+        self.prefix = os.path.join(self.temp_dir.name, 'model/inference')
+        self.cache_dir = os.path.join(self.temp_dir.name, 'cache')
+        self.x = np.random.random([3, 4]).astype(np.float32)
+
+    def tearDown(self):
+        self.temp_dir.cleanup()
+
+    def save_model(self, seed):
+        paddle.seed(seed)
+        net = TestNet()
+        with paddle.pir_utils.DygraphPirGuard():
+            model = paddle.jit.to_static(
+                net,
+                input_spec=[
+                    paddle.static.InputSpec(
+                        shape=[None, 4], dtype='float32', name='x'
+                    )
+                ],
+                full_graph=True,
+            )
+            paddle.jit.save(model, self.prefix)
+
+    def run_predictor(self, use_optimized_model):
+        config = Config(self.prefix + '.json', self.prefix + '.pdiparams')
+        config.disable_gpu()
+        config.enable_new_executor()
+        config.enable_new_ir()
+        if use_optimized_model:
+            config.set_optim_cache_dir(self.cache_dir)
+            config.use_optimized_model(True)
+        predictor = create_predictor(config)
+        outputs = predictor.run([paddle.to_tensor(self.x)])
+        return outputs[0].numpy()
+
+    def saved_key(self):
+        with open(os.path.join(self.cache_dir, '_optimized.key')) as f:
+            return f.read()
+
+    def test_cache(self):
+        self.save_model(2024)
+        ref = self.run_predictor(False)
+        np.testing.assert_allclose(self.run_predictor(True), ref, rtol=1e-6)
+        key = self.saved_key()
+        # the saved optimized model is used
+        np.testing.assert_allclose(self.run_predictor(True), ref, rtol=1e-6)
+        self.assertEqual(self.saved_key(), key)
+
+        # new weights of the same network invalidate the optimized model
+        self.save_model(2025)
+        ref = self.run_predictor(False)
+        np.testing.assert_allclose(self.run_predictor(True), ref, rtol=1e-6)
+        self.assertNotEqual(self.saved_key(), key)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,88 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import time
+import unittest
+
+import numpy as np
+
+import paddle
+
+
+class ElementwiseLayer(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x, y):
+        return paddle.exp(x) * y + x
+
+
+class ReduceLayer(paddle.nn.Layer):
+    def __init__(self):
+        super().__init__()
+
+    def forward(self, x, y):
+        return (x * y).sum(axis=-1)
+
+
+class TestCinnCpuKernel(unittest.TestCase):
+    """
+    Compare the host kernels of CINN, whose outer loops run on multiple
+    threads and whose inner loops are vectorized, with the phi CPU kernels.
+    """
+
+    def setUp(self):
+        paddle.set_device('cpu')
+        self.inputs = (
+            paddle.rand(shape=[2048, 1024], dtype=paddle.float32),
+            paddle.rand(shape=[2048, 1024], dtype=paddle.float32),
+        )
+        self.repeat = 20
+
+    def build(self, net, with_cinn):
+        paddle.set_flags({'FLAGS_prim_all': with_cinn})
+        build_strategy = paddle.static.BuildStrategy()
+        build_strategy.build_cinn_pass = with_cinn
+        return paddle.jit.to_static(
+            net, build_strategy=build_strategy, full_graph=True
+        )
+
+    def benchmark(self, net):
+        out = net(*self.inputs)
+        start = time.perf_counter()
+        for _ in range(self.repeat):
+            out = net(*self.inputs)
+        return out, (time.perf_counter() - start) / self.repeat
+
+    def check(self, layer_cls):
+        phi_out, phi_time = self.benchmark(self.build(layer_cls(), False))
+        cinn_out, cinn_time = self.benchmark(self.build(layer_cls(), True))
+        print(
+            f"{layer_cls.__name__}: phi {phi_time * 1e3:.3f} ms, "
+            f"cinn {cinn_time * 1e3:.3f} ms, "
+            f"speedup {phi_time / cinn_time:.2f}x"
+        )
+        np.testing.assert_allclose(
+            phi_out.numpy(), cinn_out.numpy(), atol=1e-5, rtol=1e-5
+        )
+
+    def test_elementwise(self):
+        self.check(ElementwiseLayer)
+
+    def test_reduce(self):
+        self.check(ReduceLayer)
+
+
+if __name__ == '__main__':
+    unittest.main()
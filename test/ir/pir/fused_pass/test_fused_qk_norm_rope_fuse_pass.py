@@ -0,0 +1,135 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+from paddle.incubate.nn.functional import (
+    fused_rms_norm,
+    fused_rotary_position_embedding,
+)
+from paddle.pir.core import create_parameter
+
+paddle.enable_static()
+
+
+class TestFusedQkNormRopeFusePass(PassTest):
+    r"""
+    q       w_q    k       w_k
+     \      /       \      /
+     rms_norm       rms_norm
+          \           /
+    fused_rotary_position_embedding
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def init_config(self):
+        self.use_position_ids = True
+        self.use_neox_rotary_style = False
+
+    def sample_program(self):
+        self.init_config()
+        batch_size, seq_len, head_dim = 2, 8, 64
+        q_shape = [batch_size, seq_len, 4, head_dim]
+        k_shape = [batch_size, seq_len, 2, head_dim]
+        sin_shape = [1, seq_len, 1, head_dim]
+        with paddle.pir_utils.IrGuard():
+            start_prog = paddle.static.Program()
+            main_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                q = paddle.static.data(name="q", shape=q_shape, dtype='float32')
+                k = paddle.static.data(name="k", shape=k_shape, dtype='float32')
+                sin = paddle.static.data(
+                    name="sin", shape=sin_shape, dtype='float32'
+                )
+                cos = paddle.static.data(
+                    name="cos", shape=sin_shape, dtype='float32'
+                )
+                position_ids = None
+                if self.use_position_ids:
+                    position_ids = paddle.static.data(
+                        name="position_ids",
+                        shape=[batch_size, seq_len],
+                        dtype='int64',
+                    )
+                weights = [
+                    create_parameter(
+                        name=name,
+                        shape=[head_dim],
+                        dtype='float32',
+                        initializer=paddle.nn.initializer.Assign(
+                            np.random.random([head_dim]).astype('float32')
+                        ),
+                    )
+                    for name in ["q_norm_weight", "k_norm_weight"]
+                ]
+                q_norm = fused_rms_norm(q, weights[0], None, 1e-6, 3)
+                k_norm = fused_rms_norm(k, weights[1], None, 1e-6, 3)
+                out_q, out_k, _ = fused_rotary_position_embedding(
+                    q_norm,
+                    k_norm,
+                    None,
+                    sin=sin,
+                    cos=cos,
+                    position_ids=position_ids,
+                    use_neox_rotary_style=self.use_neox_rotary_style,
+                )
+                out_q = paddle.assign(out_q)
+                out_k = paddle.assign(out_k)
+
+                self.pass_attr_list = [{'fused_qk_norm_rope_fuse_pass': {}}]
+                self.feeds = {
+                    "q": np.random.random(q_shape).astype("float32"),
+                    "k": np.random.random(k_shape).astype("float32"),
+                    "sin": np.random.random(sin_shape).astype("float32"),
+                    "cos": np.random.random(sin_shape).astype("float32"),
+                }
+                if self.use_position_ids:
+                    self.feeds["position_ids"] = np.array(
+                        [
+                            [7, 5, 4, 6, 3, 1, 2, 0],
+                            [3, 1, 4, 0, 7, 6, 5, 2],
+                        ],
+                        dtype='int64',
+                    )
+                self.fetch_list = [out_q, out_k]
+                self.valid_op_map = {
+                    "pd_op.rms_norm": 0,
+                    "pd_op.fused_rotary_position_embedding": 0,
+                    "pd_op.fused_qk_norm_rope": 1,
+                }
+                yield [main_prog, start_prog], False
+
+    def setUp(self):
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+class TestFusedQkNormRopeFusePassNeox(TestFusedQkNormRopeFusePass):
+    def init_config(self):
+        self.use_position_ids = False
+        self.use_neox_rotary_style = True
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -270,5 +270,29 @@ class TestFusedWeightOnlyLinearPass_Weight_Only_Int8_WithBias(
         ]
 
 
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or get_cuda_version() < 11020,
+    "weight_only_linear requires CUDA >= 11.2",
+)
+class TestFusedWeightOnlyLinearPass_Weight_Only_Int4_GroupWise(
+    TestFusedWeightOnlyLinearPass_WithBias
+):
+    def setUp(self):
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+        self.pass_attr_list = [
+            {
+                'fused_weight_only_linear_pass': {
+                    "weight_only_algo": "weight_only_int4",
+                    "weight_only_group_size": 128,
+                }
+            }
+        ]
+
+    def test_check_output(self):
+        # a scale per 128 input channels keeps int4 close to the reference
+        self.check_pass_correct(1e-2, 1e-2)
+
 if __name__ == "__main__":
     unittest.main()
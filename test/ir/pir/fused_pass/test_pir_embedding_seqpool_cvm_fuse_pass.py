@@ -0,0 +1,106 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestEmbeddingSeqpoolCvmFusePattern(PassTest):
+    r'''
+      ids_0    w       ids_1    w       ids_2    w
+        |      |         |      |         |      |
+        embedding        embedding        embedding
+            |                |                |
+      sequence_pool    sequence_pool    sequence_pool
+            |                |                |
+           cvm              cvm              cvm
+              \              |              /
+                          concat
+    '''
+
+    def is_program_valid(self, program):
+        return True
+
+    def build_feeds(self):
+        place = core.CPUPlace()
+        lods = [[0, 2, 5, 6], [0, 1, 1, 4], [0, 3, 4, 7]]
+        feeds = {}
+        for i, lod in enumerate(lods):
+            ids = np.random.randint(0, 100, [lod[-1]]).astype("int64")
+            tensor = core.DenseTensor()
+            tensor.set(ids, place)
+            tensor.set_lod([lod])
+            feeds[f"ids_{i}"] = tensor
+        feeds["cvm"] = np.ones([3, 2]).astype("float32")
+        return feeds
+
+    def sample_program(self):
+        for pooltype in ["SUM", "AVERAGE", "SQRT"]:
+            for use_cvm in [True, False]:
+                with paddle.pir_utils.IrGuard():
+                    main_prog = paddle.static.Program()
+                    start_prog = paddle.static.Program()
+                    with paddle.pir.core.program_guard(main_prog, start_prog):
+                        cvm = paddle.static.data(
+                            name='cvm', shape=[-1, 2], dtype='float32'
+                        )
+                        w = paddle.create_parameter(
+                            shape=[100, 11], dtype='float32'
+                        )
+                        outs = []
+                        for i in range(3):
+                            ids = paddle.static.data(
+                                name=f'ids_{i}',
+                                shape=[-1],
+                                dtype='int64',
+                                lod_level=1,
+                            )
+                            emb = paddle.nn.functional.embedding(ids, w)
+                            pooled = paddle._pir_ops.sequence_pool(
+                                emb, True, pooltype, 0.0
+                            )
+                            outs.append(
+                                paddle._pir_ops.cvm(pooled, cvm, use_cvm)
+                            )
+                        out = paddle.concat(outs, axis=1)
+                        out = paddle.assign(out)
+                        self.pass_attr_list = [
+                            {'embedding_seqpool_cvm_fuse_pass': {}}
+                        ]
+                        self.feeds = self.build_feeds()
+                        self.fetch_list = [out]
+                        self.valid_op_map = {
+                            "pd_op.embedding": 0,
+                            "pd_op.sequence_pool": 0,
+                            "pd_op.cvm": 0,
+                            "pd_op.fused_embedding_seqpool_cvm": 1,
+                        }
+                        yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,134 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+from pass_test import PassTest
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestMultiTowerHorizontalBatchFusePattern(PassTest):
+    """
+      x0  w0    x1  w1          x7  w7
+       \  /      \  /            \  /
+      matmul    matmul   ...    matmul
+        |         |               |
+       relu      relu            relu
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def sample_program(self):
+        num_towers = 8
+        x_shape = [4, 16]
+        w_shape = [16, 32]
+
+        with paddle.pir_utils.IrGuard():
+            start_prog = paddle.static.Program()
+            main_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                res_vec = []
+                self.feeds = {}
+                for i in range(num_towers):
+                    x = paddle.static.data(
+                        name=f"x{i}", shape=x_shape, dtype="float32"
+                    )
+                    w = paddle.static.data(
+                        name=f"w{i}", shape=w_shape, dtype="float32"
+                    )
+                    res_vec.append(
+                        paddle.nn.functional.relu(paddle.matmul(x, w))
+                    )
+                    self.feeds[f"x{i}"] = np.random.random(x_shape).astype(
+                        "float32"
+                    )
+                    self.feeds[f"w{i}"] = np.random.random(w_shape).astype(
+                        "float32"
+                    )
+
+                for i in range(num_towers):
+                    res_vec[i] = paddle.assign(res_vec[i])
+
+                self.pass_attr_list = [{"horizontal_batch_fuse_pass": {}}]
+                self.fetch_list = res_vec
+                self.valid_op_map = {
+                    "pd_op.stack": 3,
+                    "pd_op.matmul": 1,
+                    "pd_op.relu": 1,
+                    "pd_op.unstack": 2,
+                }
+                yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+        if core.is_compiled_with_cuda():
+            self.places.append(paddle.CUDAPlace(0))
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+class TestDependentOpsHorizontalBatchFusePattern(PassTest):
+    """
+    The ops of a chain depend on each other and can not be batched.
+
+      x -> add -> add -> ... -> add
+    """
+
+    def is_program_valid(self, program=None):
+        return True
+
+    def sample_program(self):
+        num_ops = 8
+        shape = [4, 16]
+
+        with paddle.pir_utils.IrGuard():
+            start_prog = paddle.static.Program()
+            main_prog = paddle.static.Program()
+            with paddle.pir.core.program_guard(main_prog, start_prog):
+                x = paddle.static.data(name="x", shape=shape, dtype="float32")
+                y = paddle.static.data(name="y", shape=shape, dtype="float32")
+                out = x
+                for _ in range(num_ops):
+                    out = paddle.add(out, y)
+                out = paddle.assign(out)
+
+                self.pass_attr_list = [{"horizontal_batch_fuse_pass": {}}]
+                self.feeds = {
+                    "x": np.random.random(shape).astype("float32"),
+                    "y": np.random.random(shape).astype("float32"),
+                }
+                self.fetch_list = [out]
+                self.valid_op_map = {
+                    "pd_op.stack": 0,
+                    "pd_op.add": num_ops,
+                    "pd_op.unstack": 0,
+                }
+                yield [main_prog, start_prog], False
+
+    def setUp(self):
+        self.places.append(paddle.CPUPlace())
+
+    def test_check_output(self):
+        self.check_pass_correct()
+
+
+if __name__ == "__main__":
+    unittest.main()
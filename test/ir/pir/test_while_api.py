@@ -233,5 +233,36 @@ class TestBuildModuleWithWhile2Op(unittest.TestCase):
             )
 
 
+class TestWhileLoopCarriedArray(unittest.TestCase):
+    def test_array_grows_in_loop(self):
+        main_program = paddle.static.Program()
+        with paddle.pir.core.program_guard(main_program):
+            i = paddle.full(shape=[1], fill_value=0, dtype='int64')
+            n = paddle.full(shape=[1], fill_value=5, dtype='int64')
+            x = paddle.full(shape=[2], fill_value=1.0, dtype='float32')
+            array = paddle.tensor.create_array(dtype='float32')
+
+            def body(i, x, array):
+                paddle.tensor.array_write(x, i, array)
+                return [i + 1, x * 2, array]
+
+            i, x, array = paddle.static.nn.while_loop(
+                lambda i, x, array: i < n, body, [i, x, array]
+            )
+            length = paddle.tensor.array_length(array)
+            first = paddle.tensor.array_read(array, i - n)
+            last = paddle.tensor.array_read(array, i - 1)
+
+        exe = paddle.static.Executor()
+        # the array moved into the body is handed back by the yield
+        for _ in range(2):
+            res_len, res_first, res_last = exe.run(
+                main_program, fetch_list=[length, first, last]
+            )
+            self.assertEqual(int(res_len), 5)
+            self.assertEqual(res_first.tolist(), [1.0, 1.0])
+            self.assertEqual(res_last.tolist(), [16.0, 16.0])
+
+
 if __name__ == "__main__":
     unittest.main()
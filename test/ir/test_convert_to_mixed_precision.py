@@ -12,10 +12,13 @@
 # See the License for the specific language governing permissions and
 # limitations under the License.
 
+import json
 import os
 import tempfile
 import unittest
 
+import numpy as np
+
 import paddle
 from paddle.inference import (
     PlaceType,
@@ -87,6 +90,29 @@ class TestConvertToMixedPrecision(unittest.TestCase):
                     black_list=black_list,
                 )
 
+    def test_convert_with_calibration_data(self):
+        model_dir = os.path.join(self.temp_dir.name, 'resnet50')
+        mixed_dir = os.path.join(self.temp_dir.name, 'calibrated')
+        cache_file = os.path.join(mixed_dir, 'cache.json')
+        calibration_data = [
+            {'x': np.random.random([1, 3, 224, 224]).astype('float32')}
+            for _ in range(2)
+        ]
+        for _ in range(2):
+            convert_to_mixed_precision(
+                os.path.join(model_dir, 'inference.pdmodel'),
+                os.path.join(model_dir, 'inference.pdiparams'),
+                os.path.join(mixed_dir, 'inference.pdmodel'),
+                os.path.join(mixed_dir, 'inference.pdiparams'),
+                backend=PlaceType.GPU,
+                mixed_precision=PrecisionType.Half,
+                calibration_data=calibration_data,
+                cache_file=cache_file,
+            )
+            self.assertTrue(os.path.exists(cache_file))
+            with open(cache_file) as f:
+                self.assertEqual(len(json.load(f)), 1)
+
 
 if __name__ == '__main__':
     unittest.main()
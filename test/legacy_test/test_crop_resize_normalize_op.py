@@ -0,0 +1,125 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+def crop_resize_normalize_ref(images, boxes, size, flip, mean, std):
+    out_h, out_w = size
+    outs = []
+    for n, image in enumerate(images):
+        c, h, w = image.shape
+        top = min(max(boxes[n][0], 0), h - 1)
+        left = min(max(boxes[n][1], 0), w - 1)
+        crop_h = min(max(boxes[n][2], 1), h - top)
+        crop_w = min(max(boxes[n][3], 1), w - left)
+        crop = image[:, top : top + crop_h, left : left + crop_w]
+        crop = crop.astype('float32')
+
+        src_y = np.maximum(
+            (np.arange(out_h) + 0.5) * crop_h / out_h - 0.5, 0
+        ).astype('float32')
+        src_x = np.maximum(
+            (np.arange(out_w) + 0.5) * crop_w / out_w - 0.5, 0
+        ).astype('float32')
+        y0 = np.minimum(src_y.astype('int64'), crop_h - 1)
+        x0 = np.minimum(src_x.astype('int64'), crop_w - 1)
+        y1 = np.minimum(y0 + 1, crop_h - 1)
+        x1 = np.minimum(x0 + 1, crop_w - 1)
+        ly = (src_y - y0)[:, None]
+        lx = (src_x - x0)[None, :]
+        out = (1 - ly) * (
+            (1 - lx) * crop[:, y0][:, :, x0] + lx * crop[:, y0][:, :, x1]
+        ) + ly * ((1 - lx) * crop[:, y1][:, :, x0] + lx * crop[:, y1][:, :, x1])
+        if flip is not None and flip[n]:
+            out = out[:, :, ::-1]
+        out = (out - np.array(mean).reshape([-1, 1, 1])) / np.array(
+            std
+        ).reshape([-1, 1, 1])
+        outs.append(out.astype('float32'))
+    return np.stack(outs)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda() or core.is_compiled_with_rocm(),
+    "crop_resize_normalize is only supported on CUDA.",
+)
+class TestCropResizeNormalize(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.shapes = [[3, 48, 64], [3, 100, 30], [3, 17, 23]]
+        self.boxes = [[4, 8, 32, 40], [0, 0, 100, 30], [10, 20, 100, 100]]
+        self.flip = [True, False, True]
+        self.size = [24, 20]
+        self.mean = [123.675, 116.28, 103.53]
+        self.std = [58.395, 57.12, 57.375]
+        self.images = [
+            np.random.randint(0, 256, shape).astype('uint8')
+            for shape in self.shapes
+        ]
+
+    def test_output(self):
+        paddle.disable_static(paddle.CUDAPlace(0))
+        out = paddle.vision.ops.crop_resize_normalize(
+            [paddle.to_tensor(image) for image in self.images],
+            paddle.to_tensor(self.boxes, dtype='int32'),
+            self.size,
+            flip=paddle.to_tensor(self.flip),
+            mean=self.mean,
+            std=self.std,
+        )
+        ref = crop_resize_normalize_ref(
+            self.images, self.boxes, self.size, self.flip, self.mean, self.std
+        )
+        self.assertEqual(out.dtype, paddle.float32)
+        np.testing.assert_allclose(out.numpy(), ref, rtol=1e-4, atol=1e-4)
+
+    def test_output_without_flip(self):
+        paddle.disable_static(paddle.CUDAPlace(0))
+        out = paddle.vision.ops.crop_resize_normalize(
+            [paddle.to_tensor(image) for image in self.images],
+            paddle.to_tensor(self.boxes, dtype='int32'),
+            self.size,
+            mean=127.5,
+            std=127.5,
+        )
+        ref = crop_resize_normalize_ref(
+            self.images, self.boxes, self.size, None, [127.5], [127.5]
+        )
+        np.testing.assert_allclose(out.numpy(), ref, rtol=1e-4, atol=1e-4)
+
+    def test_same_as_interpolate(self):
+        paddle.disable_static(paddle.CUDAPlace(0))
+        image = paddle.to_tensor(self.images[0])
+        out = paddle.vision.ops.crop_resize_normalize(
+            [image], paddle.to_tensor([[0, 0, 48, 64]], dtype='int32'), 32
+        )
+        ref = paddle.nn.functional.interpolate(
+            image.astype('float32').unsqueeze(0),
+            size=[32, 32],
+            mode='bilinear',
+            align_corners=False,
+        )
+        np.testing.assert_allclose(
+            out.numpy(), ref.numpy(), rtol=1e-4, atol=1e-3
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -114,6 +114,22 @@ class TestDygraphDataLoader(unittest.TestCase):
             )
             self.iter_loader_data(loader)
 
+    def test_multi_process_dataloader_shm_ring(self):
+        paddle.base.core.globals()["FLAGS_dataloader_shm_ring_size"] = 2
+        try:
+            with base.dygraph.guard():
+                loader = DataLoader(
+                    dataset,
+                    batch_size=self.batch_size,
+                    shuffle=True,
+                    drop_last=True,
+                    use_shared_memory=True,
+                    num_workers=2,
+                )
+                self.iter_loader_data(loader)
+        finally:
+            paddle.base.core.globals()["FLAGS_dataloader_shm_ring_size"] = 0
+
 
 if __name__ == '__main__':
     unittest.main()
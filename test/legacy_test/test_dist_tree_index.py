@@ -172,6 +172,44 @@ class TestIndexSampler(unittest.TestCase):
         )
         self.assertTrue(dataset.get_shuffle_data_size() == 8)
 
+    def test_layerwise_sample_batch(self):
+        path = download(
+            "https://paddlerec.bj.bcebos.com/tree-based/data/mini_tree.pb",
+            "tree_index_unittest",
+            "e2ba4561c2e9432b532df40546390efa",
+        )
+        tree = TreeIndex("batch_demo", path)
+        layer_counts = [1, 2, 1]
+        tree.init_layerwise_sampler(layer_counts, start_sample_layer=1, seed=1)
+        leaf_ids = [node.id() for node in tree.get_all_leafs()][:8]
+        user_input = [[leaf_id, leaf_id] for leaf_id in leaf_ids]
+
+        for with_hierarchy in [False, True]:
+            expected = tree.layerwise_sample(
+                user_input, leaf_ids, with_hierarchy
+            )
+            for share_negatives in [False, True]:
+                for num_threads in [1, 3]:
+                    out = tree.layerwise_sample_batch(
+                        user_input,
+                        leaf_ids,
+                        with_hierarchy=with_hierarchy,
+                        share_negatives=share_negatives,
+                        num_threads=num_threads,
+                    )
+                    self.assertEqual(list(out.shape), [len(expected), 4])
+                    positive = None
+                    for row, expected_row in zip(out.tolist(), expected):
+                        # users and labels are deterministic, negatives are
+                        # not but never equal to the positive of the layer
+                        self.assertEqual(row[:2], expected_row[:2])
+                        self.assertEqual(row[3], expected_row[3])
+                        if row[3] == 1:
+                            self.assertEqual(row[2], expected_row[2])
+                            positive = row[2]
+                        else:
+                            self.assertNotEqual(row[2], positive)
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -325,6 +325,47 @@ class TestDLPack(unittest.TestCase):
                     np.testing.assert_array_equal(x.numpy(), y1.numpy())
                     np.testing.assert_array_equal(x.numpy(), y2.numpy())
 
+    def test_dlpack_protocol(self):
+        with dygraph_guard():
+            places = [base.CPUPlace()]
+            if paddle.is_compiled_with_cuda():
+                places.append(base.CUDAPlace(0))
+            for place in places:
+                x = paddle.rand([3, 5]).to(device=place)
+                y = paddle.from_dlpack(x)
+                self.assertEqual(x.data_ptr(), y.data_ptr())
+                np.testing.assert_array_equal(x.numpy(), y.numpy())
+
+                z = paddle.from_dlpack(x.__dlpack__(copy=True))
+                self.assertNotEqual(x.data_ptr(), z.data_ptr())
+                np.testing.assert_array_equal(x.numpy(), z.numpy())
+
+    def test_cuda_array_interface(self):
+        if not paddle.is_compiled_with_cuda():
+            return
+        with dygraph_guard():
+            x = paddle.rand([3, 5]).to(device=base.CUDAPlace(0))
+            interface = x.__cuda_array_interface__
+            self.assertEqual(interface["version"], 3)
+            self.assertNotEqual(interface["stream"], 0)
+
+            x_strided = x[::2, ::2]
+            for src in [x, x_strided]:
+                y = paddle.utils.dlpack.from_dlpack(
+                    type(
+                        "CudaArray",
+                        (),
+                        {
+                            "__cuda_array_interface__": (
+                                src.__cuda_array_interface__
+                            )
+                        },
+                    )()
+                )
+                self.assertEqual(src.data_ptr(), y.data_ptr())
+                self.assertEqual(src.shape, y.shape)
+                np.testing.assert_array_equal(src.numpy(), y.numpy())
+
 
 from paddle.utils.dlpack import DLDeviceType
 
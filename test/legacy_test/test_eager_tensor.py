@@ -350,6 +350,43 @@ class TestEagerTensor(unittest.TestCase):
                 a = paddle.to_tensor(a, place=paddle.CUDAPinnedPlace())
                 self.assertEqual(a.place.__repr__(), "Place(gpu_pinned)")
 
+    def test_tensors_from_numpy(self):
+        arrays = [
+            np.random.rand(3, 5).astype('float32'),
+            np.arange(7, dtype='int64'),
+            np.random.rand(4, 2)[:, 0],
+            np.zeros([0, 3], dtype='float32'),
+            np.array(True),
+        ]
+        places = [core.CPUPlace()]
+        if core.is_compiled_with_cuda():
+            places.append(core.CUDAPlace(0))
+        for place in places:
+            with paddle.base.dygraph.guard(place):
+                tensors = core.eager.tensors_from_numpy(arrays, place)
+                self.assertEqual(len(tensors), len(arrays))
+                for array, tensor in zip(arrays, tensors):
+                    self.assertEqual(list(array.shape), tensor.shape)
+                    self.assertTrue(tensor.stop_gradient)
+                    self.assertEqual(
+                        tensor.place.is_gpu_place(),
+                        isinstance(place, core.CUDAPlace),
+                    )
+                    np.testing.assert_array_equal(array, tensor.numpy())
+
+    def test_grad_object_pool_stats(self):
+        with paddle.base.dygraph.guard(core.CPUPlace()):
+            x = paddle.rand([4, 4])
+            x.stop_gradient = False
+            for _ in range(2):
+                y = paddle.tanh(paddle.exp(x)).sum()
+                y.backward()
+                stats = core.eager._grad_object_pool_stats()
+                self.assertGreater(stats["allocated"], 0)
+                self.assertGreater(stats["bytes"], 0)
+            # the grad nodes freed by the first backward are reused
+            self.assertGreater(stats["reused"], 0)
+
     def test_to_tensor_with_densetensor(self):
         if core.is_compiled_with_cuda():
             a_np = np.random.rand(1024, 1024)
@@ -0,0 +1,82 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "block broadcast only runs on GPU"
+)
+class TestElementwiseBlockBroadcast(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        np.random.seed(2024)
+        self.dtypes = ["float32", "float16"]
+        # (x_shape, y_shape) pairs of the block broadcast patterns, including
+        # the ones whose inner size is not divisible by the vector size.
+        self.shapes = [
+            ([8, 16, 7, 9], [16, 1, 1]),
+            ([8, 16, 8, 8], [16, 1, 1]),
+            ([64, 128], [128]),
+            ([64, 126], [126]),
+            ([64, 128], [64, 1]),
+            ([63, 5], [63, 1]),
+            ([4, 5, 6], [1]),
+            ([4, 5, 6], []),
+            ([1, 16, 1, 8], [16, 1]),
+            ([16, 1, 8], [2, 16, 4, 8]),
+            # Not a block broadcast, falls back to the generic kernel.
+            ([4, 6, 8], [4, 1, 8]),
+        ]
+
+    def check(self, op, np_op, x_shape, y_shape, dtype):
+        x = np.random.random(x_shape).astype(dtype)
+        y = np.random.random(y_shape).astype(dtype) + 0.5
+        out = op(paddle.to_tensor(x), paddle.to_tensor(y))
+        atol = 1e-3 if dtype == "float16" else 1e-6
+        np.testing.assert_allclose(
+            out.numpy(), np_op(x, y), rtol=atol, atol=atol
+        )
+
+    def test_patterns(self):
+        ops = [
+            (paddle.add, np.add),
+            (paddle.multiply, np.multiply),
+            (paddle.divide, np.divide),
+            (paddle.subtract, np.subtract),
+        ]
+        for dtype in self.dtypes:
+            for x_shape, y_shape in self.shapes:
+                for op, np_op in ops:
+                    self.check(op, np_op, x_shape, y_shape, dtype)
+                    self.check(op, np_op, y_shape, x_shape, dtype)
+
+    def test_where(self):
+        # Three inputs of different block patterns.
+        cond = np.random.random([8, 16, 1, 1]) > 0.5
+        x = np.random.random([8, 16, 4, 4]).astype("float32")
+        y = np.random.random([4]).astype("float32")
+        out = paddle.where(
+            paddle.to_tensor(cond), paddle.to_tensor(x), paddle.to_tensor(y)
+        )
+        np.testing.assert_allclose(out.numpy(), np.where(cond, x, y))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -180,7 +180,7 @@ class TestEmbeddingBase(unittest.TestCase):
     def test_main(self):
         weight_dtypes = get_all_dtypes()
         ids_dtypes = [paddle.int64, paddle.int32]
-        deterministic_levels = [0, 1]
+        deterministic_levels = [0, 1, 3]
         ranks = [None, 0, 2, 4, 8]
         allow_duplicate_ids = [False, True]
         allow_pure_randoms = [False, True]
@@ -217,6 +217,16 @@ class TestEmbedding2(TestEmbeddingBase):
         self.nranks = 8
 
 
+class TestEmbeddingHeavyRepetition(TestEmbeddingBase):
+    def setUp(self):
+        # Many more ids than rows, the gradient is reduced by sorting the ids
+        # by default.
+        self.ids_shape = [64, 64]
+        self.vocab_size = 16
+        self.hidden_size = 256
+        self.nranks = 8
+
+
 class TestEmbeddingDeterministic(unittest.TestCase):
     def setUp(self):
         self.ids_shape = [32, 16]
@@ -43,6 +43,32 @@ class TestFleetExecutorUtils(unittest.TestCase):
             program_map
         )
 
+    def test_simulate_pipeline_schedule(self):
+        num_stages, num_micro_batches = 8, 16
+        _, bubble_1f1b = paddle.base.core.simulate_pipeline_schedule(
+            "1F1B", num_stages, num_micro_batches
+        )
+        # (S - 1) / (M + S - 1) with the same forward and backward stages
+        self.assertAlmostEqual(
+            bubble_1f1b, (num_stages - 1) / (num_micro_batches + num_stages - 1)
+        )
+        _, bubble_vpp = paddle.base.core.simulate_pipeline_schedule(
+            "VPP", num_stages, num_micro_batches, num_chunks=2
+        )
+        _, bubble_zb = paddle.base.core.simulate_pipeline_schedule(
+            "ZBH1", num_stages, num_micro_batches
+        )
+        self.assertLess(bubble_vpp, bubble_1f1b)
+        self.assertLess(bubble_zb, bubble_1f1b)
+
+        schedule = paddle.base.core.generate_pipeline_schedule(
+            "ZBH1", num_stages, num_micro_batches
+        )
+        self.assertEqual(len(schedule), num_stages)
+        for jobs in schedule:
+            forwards = [job for job in jobs if job[0] == "forward"]
+            self.assertEqual(len(forwards), num_micro_batches)
+
 
 if __name__ == "__main__":
     unittest.main()
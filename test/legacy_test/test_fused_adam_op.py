@@ -106,13 +106,17 @@ class TestFusedAdamOp(OpTest):
         # no check `Moment2MaxOut` with amsgrad is False
         self.no_check_set = ['Moments2MaxOut']
 
+    def set_tensor_num(self):
+        self.tensor_num = 10
+
     def setUp(self):
         paddle.enable_static()
 
         '''Test FusedAdam Op with supplied attributes'''
         self.__class__.op_type = "fused_adam"
 
-        num = 10
+        self.set_tensor_num()
+        num = self.tensor_num
         inputs_list = [[0] * num] * 6
         learning_rate = 0.004
         beta1 = 0.78
@@ -217,6 +221,12 @@ class TestFusedAdamOpAMSGrad(TestFusedAdamOp):
         self.no_check_set = None
 
 
+class TestFusedAdamOpManyTensors(TestFusedAdamOp):
+    def set_tensor_num(self):
+        # more tensors than a launch of the chunked engine took
+        self.tensor_num = 150
+
+
 if __name__ == "__main__":
     paddle.enable_static()
     unittest.main()
@@ -178,5 +178,67 @@ class TestFusedBiasDropoutResidualLayerNormOpFp16(
         self.atol = 1e-1
 
 
+class TestFusedBiasDropoutResidualLayerNormOpBitpackMask(
+    TestFusedBiasDropoutResidualLayerNormOp
+):
+    def config(self):
+        super().config()
+        self.dropout_prob = 0.0
+
+    def setUp(self):
+        super().setUp()
+        paddle.set_flags({'FLAGS_fused_dropout_bitpack_mask': True})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_fused_dropout_bitpack_mask': False})
+
+
+class TestFusedBiasDropoutResidualLayerNormOpCPU(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static(place=paddle.CPUPlace())
+        self.dropout_prob = 0.1
+        self.epsilon = 1e-5
+        self.x = np.random.rand(4, 16, 96).astype(np.float32)
+        self.residual = np.random.rand(4, 16, 96).astype(np.float32)
+        self.bias = np.random.rand(96).astype(np.float32)
+        self.ln_scale = np.random.rand(96).astype(np.float32)
+        self.ln_bias = np.random.rand(96).astype(np.float32)
+
+    def reference(self, keep):
+        out = (self.x + self.bias) * keep + self.residual
+        mean = out.mean(axis=-1, keepdims=True)
+        var = out.var(axis=-1, keepdims=True)
+        out = (out - mean) / np.sqrt(var + self.epsilon)
+        return out * self.ln_scale + self.ln_bias
+
+    def run_fused_op(self, mode):
+        return incubate_f.fused_bias_dropout_residual_layer_norm(
+            paddle.to_tensor(self.x),
+            paddle.to_tensor(self.residual),
+            paddle.to_tensor(self.bias),
+            paddle.to_tensor(self.ln_scale),
+            paddle.to_tensor(self.ln_bias),
+            self.dropout_prob,
+            self.epsilon,
+            training=False,
+            mode=mode,
+        )
+
+    def test_upscale_in_train(self):
+        out = self.run_fused_op('upscale_in_train')
+        np.testing.assert_allclose(
+            self.reference(1.0), out.numpy(), rtol=1e-5, atol=1e-4
+        )
+
+    def test_downgrade_in_infer(self):
+        out = self.run_fused_op('downscale_in_infer')
+        np.testing.assert_allclose(
+            self.reference(1.0 - self.dropout_prob),
+            out.numpy(),
+            rtol=1e-5,
+            atol=1e-4,
+        )
+
+
 if __name__ == "__main__":
     unittest.main()
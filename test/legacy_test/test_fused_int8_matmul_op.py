@@ -0,0 +1,77 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle import base
+
+
+def int8_matmul_ref(x, weight, weight_scale, input_scale, bound=127.0):
+    x_int8 = np.clip(np.round(x * bound / input_scale), -bound, bound)
+    acc = np.matmul(x_int8.astype(np.int64), weight.astype(np.int64))
+    return (acc * (input_scale / bound) * (weight_scale / bound)).astype(
+        np.float32
+    )
+
+
+class TestFusedInt8MatmulOp(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.x_shape = [2, 5, 48]
+        self.n = 32
+        self.input_scale = 2.0
+        self.x = np.random.uniform(-2.5, 2.5, self.x_shape).astype(np.float32)
+        self.weight = np.random.randint(
+            -127, 128, [self.x_shape[-1], self.n]
+        ).astype(np.int8)
+        self.set_weight_scale()
+
+    def set_weight_scale(self):
+        self.weight_scale = np.random.uniform(0.1, 1.0, [self.n]).astype(
+            np.float32
+        )
+
+    def test_fused_int8_matmul(self):
+        with paddle.pir_utils.IrGuard():
+            with base.program_guard(base.Program(), base.Program()):
+                x = paddle.static.data('x', self.x_shape, 'float32')
+                weight = paddle.static.data('weight', self.weight.shape, 'int8')
+                out = paddle._pir_ops.fused_int8_matmul(
+                    x,
+                    weight,
+                    self.weight_scale.tolist(),
+                    self.input_scale,
+                    127.0,
+                )
+                exe = base.Executor(base.CPUPlace())
+                (result,) = exe.run(
+                    feed={'x': self.x, 'weight': self.weight},
+                    fetch_list=[out],
+                )
+        expected = int8_matmul_ref(
+            self.x, self.weight, self.weight_scale, self.input_scale
+        )
+        np.testing.assert_allclose(result, expected, rtol=1e-5, atol=1e-5)
+
+
+class TestFusedInt8MatmulOpPerTensor(TestFusedInt8MatmulOp):
+    def set_weight_scale(self):
+        self.weight_scale = np.array([0.5], dtype=np.float32)
+
+
+if __name__ == "__main__":
+    unittest.main()
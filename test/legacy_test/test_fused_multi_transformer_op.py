@@ -1988,5 +1988,127 @@ class TestFusedMultiTransformerOpUseMBMMHAGQA(TestFusedMultiTransformerOp):
         self.x_type = np.float16
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda()
+    or get_cuda_version() < 11030
+    or paddle.device.cuda.get_device_capability()[0] < 8,
+    "FusedMultiTransformer requires CUDA >= 11.2 and CUDA_ARCH >= 8",
+)
+class TestFusedMultiTransformerDraftTokens(unittest.TestCase):
+    def setUp(self):
+        self.batch_size = 2
+        self.num_heads = 4
+        self.head_dim = 64
+        self.embed_dim = self.num_heads * self.head_dim
+        self.layers = 2
+        self.time_step = 9
+        self.num_drafts = 3
+        self.max_seq_len = 128
+        self.dtype = 'float16'
+
+        def rand(*shape, scale=0.1, dtype=self.dtype):
+            return paddle.to_tensor(
+                (np.random.rand(*shape) * 2 - 1) * scale, dtype=dtype
+            )
+
+        # the layer norm parameters are float32
+        self.ln_scales = [
+            rand(self.embed_dim, dtype='float32') + 1
+            for _ in range(self.layers)
+        ]
+        self.ln_biases = [
+            rand(self.embed_dim, dtype='float32') for _ in range(self.layers)
+        ]
+        self.qkv_weights = [
+            rand(3, self.num_heads, self.head_dim, self.embed_dim)
+            for _ in range(self.layers)
+        ]
+        self.qkv_biases = [
+            rand(3, self.num_heads, self.head_dim) for _ in range(self.layers)
+        ]
+        self.linear_weights = [
+            rand(self.embed_dim, self.embed_dim) for _ in range(self.layers)
+        ]
+        self.linear_biases = [rand(self.embed_dim) for _ in range(self.layers)]
+        self.ffn_ln_scales = [
+            rand(self.embed_dim, dtype='float32') + 1
+            for _ in range(self.layers)
+        ]
+        self.ffn_ln_biases = [
+            rand(self.embed_dim, dtype='float32') for _ in range(self.layers)
+        ]
+        self.ffn1_weights = [
+            rand(self.embed_dim, 4 * self.embed_dim) for _ in range(self.layers)
+        ]
+        self.ffn1_biases = [
+            rand(4 * self.embed_dim) for _ in range(self.layers)
+        ]
+        self.ffn2_weights = [
+            rand(4 * self.embed_dim, self.embed_dim) for _ in range(self.layers)
+        ]
+        self.ffn2_biases = [rand(self.embed_dim) for _ in range(self.layers)]
+        self.x = rand(self.batch_size, self.num_drafts, self.embed_dim, scale=1)
+        # any content works as the prefix, both runs start from the same cache
+        self.cache_kv = rand(
+            2,
+            self.batch_size,
+            self.num_heads,
+            self.max_seq_len,
+            self.head_dim,
+            scale=1,
+        )
+
+    def run_decode(self, x, cache_kvs, time_step):
+        return fused_multi_transformer(
+            x,
+            self.ln_scales,
+            self.ln_biases,
+            self.qkv_weights,
+            self.qkv_biases,
+            self.linear_weights,
+            self.linear_biases,
+            self.ffn_ln_scales,
+            self.ffn_ln_biases,
+            self.ffn1_weights,
+            self.ffn1_biases,
+            self.ffn2_weights,
+            self.ffn2_biases,
+            cache_kvs=cache_kvs,
+            time_step=paddle.to_tensor(
+                [time_step], dtype='int32', place=paddle.CPUPlace()
+            ),
+        )[0]
+
+    def test_drafts_match_sequential_decode(self):
+        paddle.disable_static()
+        ref_caches = [self.cache_kv.clone() for _ in range(self.layers)]
+        ref_out = paddle.concat(
+            [
+                self.run_decode(
+                    self.x[:, j : j + 1], ref_caches, self.time_step + j
+                )
+                for j in range(self.num_drafts)
+            ],
+            axis=1,
+        )
+
+        caches = [self.cache_kv.clone() for _ in range(self.layers)]
+        out = self.run_decode(self.x, caches, self.time_step)
+
+        np.testing.assert_allclose(
+            out.astype('float32').numpy(),
+            ref_out.astype('float32').numpy(),
+            rtol=1e-3,
+            atol=1e-3,
+        )
+        for cache, ref_cache in zip(caches, ref_caches):
+            np.testing.assert_allclose(
+                cache.astype('float32').numpy(),
+                ref_cache.astype('float32').numpy(),
+                rtol=1e-3,
+                atol=1e-3,
+            )
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -141,5 +141,15 @@ class TestFusedTokenPruneOp2(TestFusedTokenPruneOp):
         self.out_cls_inds_py = np.array(out_cls_inds_py, dtype='int64')
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda()
+    or not core.is_float16_supported(core.CUDAPlace(0)),
+    "core is not compiled with CUDA or not support float16",
+)
+class TestFusedTokenPruneOp2Float16(TestFusedTokenPruneOp2):
+    def setDtype(self):
+        self.dtype = np.float16
+
+
 if __name__ == "__main__":
     unittest.main()
@@ -1028,5 +1028,42 @@ class TestIndexPutAPIMixedIndices1(TestIndexPutAPIBase):
         self.index_type_pd1 = "bool"
 
 
+@unittest.skipIf(
+    not paddle.is_compiled_with_cuda(), "only the GPU kernel uses atomics"
+)
+class TestIndexPutAccumulateDeterministic(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.x_np = np.random.random((16, 8)).astype(np.float32)
+        # Every element is accumulated many times.
+        self.indices_np = (
+            np.random.randint(0, 16, (4096,)),
+            np.random.randint(0, 8, (4096,)),
+        )
+        self.value_np = np.random.random((4096,)).astype(np.float32)
+
+    def run_index_put(self):
+        x = paddle.to_tensor(self.x_np, place=paddle.CUDAPlace(0))
+        indices = tuple(
+            paddle.to_tensor(index, place=paddle.CUDAPlace(0))
+            for index in self.indices_np
+        )
+        value = paddle.to_tensor(self.value_np, place=paddle.CUDAPlace(0))
+        return paddle.index_put(x, indices, value, True).numpy()
+
+    def test_deterministic(self):
+        paddle.disable_static()
+        paddle.set_flags({'FLAGS_cudnn_deterministic': True})
+        try:
+            out = self.run_index_put()
+            for _ in range(3):
+                np.testing.assert_array_equal(out, self.run_index_put())
+        finally:
+            paddle.set_flags({'FLAGS_cudnn_deterministic': False})
+        ref = self.x_np.copy()
+        np.add.at(ref, self.indices_np, self.value_np)
+        np.testing.assert_allclose(out, ref, rtol=1e-5, atol=1e-4)
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -182,6 +182,25 @@ class LayoutAutoTune(unittest.TestCase):
         self.assertEqual(conv_out.shape, [1, 8, 14, 12])
         self.assertEqual(out.shape, [1, 8, 17, 13])
 
+    def test_transpose_back_report(self):
+        paddle.base.core.clear_layout_autotune_transpose_report()
+        conv = paddle.nn.Conv2D(3, 8, (3, 3))
+        flatten = paddle.nn.Flatten(start_axis=1, stop_axis=2)
+        data = paddle.rand([1, 3, 16, 14])
+        with paddle.amp.auto_cast(level="O2"):
+            conv_out = conv(data)
+            # flatten of the C and H dimensions has to run in NCHW
+            out = flatten(conv_out)
+
+        self.assertEqual(out.shape, [1, 112, 12])
+        report = paddle.base.core.layout_autotune_transpose_report()
+        if paddle.base.core.use_layout_autotune():
+            self.assertGreater(report.get("flatten", 0), 0)
+        paddle.base.core.clear_layout_autotune_transpose_report()
+        self.assertEqual(
+            paddle.base.core.layout_autotune_transpose_report(), {}
+        )
+
 
 class TestAutoTuneAPI(unittest.TestCase):
     def test_set_config_warnings(self):
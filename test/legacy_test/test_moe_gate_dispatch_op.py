@@ -0,0 +1,121 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+import paddle.incubate.nn.functional as F
+from paddle.base import core
+
+
+def ref_moe_gate_dispatch(x, gate_logits, k, capacity):
+    num_tokens, hidden_size = x.shape
+    num_experts = gate_logits.shape[1]
+    expert_id = np.argsort(-gate_logits, axis=1, kind="stable")[:, :k]
+    weights = np.take_along_axis(gate_logits, expert_id, axis=1)
+    y = np.zeros([num_experts, capacity, hidden_size], dtype=x.dtype)
+    scatter_index = np.full([k, num_tokens], -1, dtype=np.int32)
+    count = np.zeros([num_experts], dtype=np.int64)
+    for i in range(k):
+        for s in range(num_tokens):
+            e = expert_id[s, i]
+            if count[e] < capacity:
+                y[e, count[e]] = x[s]
+                scatter_index[i, s] = e * capacity + count[e]
+            else:
+                weights[s, i] = 0.0
+            count[e] += 1
+    expert_offset = np.cumsum(np.minimum(count, capacity))
+    return y, weights, scatter_index, expert_offset, expert_id
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "moe dispatch only supports GPU"
+)
+class TestMoeGateDispatch(unittest.TestCase):
+    def setUp(self):
+        paddle.disable_static()
+        np.random.seed(2024)
+        self.num_tokens = 64
+        self.hidden_size = 32
+        self.num_experts = 8
+        self.k = 2
+        # Small enough that some choices are dropped.
+        self.capacity = 12
+        self.x = np.random.random([self.num_tokens, self.hidden_size]).astype(
+            "float32"
+        )
+        logits = np.random.random([self.num_tokens, self.num_experts])
+        self.gate_logits = (
+            np.exp(logits) / np.exp(logits).sum(axis=1, keepdims=True)
+        ).astype("float32")
+
+    def test_dispatch(self):
+        y, weights, index, offset, expert_id = F.moe_gate_dispatch(
+            paddle.to_tensor(self.x),
+            paddle.to_tensor(self.gate_logits),
+            self.k,
+            self.capacity,
+        )
+        ref = ref_moe_gate_dispatch(
+            self.x, self.gate_logits, self.k, self.capacity
+        )
+        np.testing.assert_allclose(y.numpy(), ref[0])
+        np.testing.assert_allclose(weights.numpy(), ref[1])
+        np.testing.assert_array_equal(index.numpy(), ref[2])
+        np.testing.assert_array_equal(offset.numpy(), ref[3])
+        np.testing.assert_array_equal(expert_id.numpy(), ref[4])
+
+    def test_dispatch_combine_grad(self):
+        x = paddle.to_tensor(self.x, stop_gradient=False)
+        gate_logits = paddle.to_tensor(self.gate_logits, stop_gradient=False)
+        y, weights, index, _, _ = F.moe_gate_dispatch(
+            x, gate_logits, self.k, self.capacity
+        )
+        out = F.moe_combine(
+            y.reshape([-1, self.hidden_size]),
+            weights,
+            index.transpose([1, 0]),
+        )
+
+        x_ref = paddle.to_tensor(self.x, stop_gradient=False)
+        gate_ref = paddle.to_tensor(self.gate_logits, stop_gradient=False)
+        mask = paddle.to_tensor((index.numpy() >= 0).T.astype("float32"))
+        expert_id = paddle.to_tensor(
+            np.argsort(-self.gate_logits, axis=1, kind="stable")[:, : self.k]
+        )
+        ref_weights = paddle.take_along_axis(gate_ref, expert_id, axis=1)
+        out_ref = (ref_weights * mask).sum(axis=1, keepdim=True) * x_ref
+        np.testing.assert_allclose(
+            out.numpy(), out_ref.numpy(), rtol=1e-5, atol=1e-6
+        )
+
+        dout = np.random.random(out.shape).astype("float32")
+        out.backward(paddle.to_tensor(dout))
+        out_ref.backward(paddle.to_tensor(dout))
+        np.testing.assert_allclose(
+            x.grad.numpy(), x_ref.grad.numpy(), rtol=1e-5, atol=1e-6
+        )
+        np.testing.assert_allclose(
+            gate_logits.grad.numpy(),
+            gate_ref.grad.numpy(),
+            rtol=1e-5,
+            atol=1e-6,
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
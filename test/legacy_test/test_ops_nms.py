@@ -254,5 +254,14 @@ class TestOpsNMS(unittest.TestCase):
                 )
 
 
+class TestOpsNMSManyBoxes(TestOpsNMS):
+    # The kept boxes span many words of the IoU masks on GPU.
+    def setUp(self):
+        super().setUp()
+        self.num_boxes = 500
+        self.threshold = 0.3
+        self.topk = 100
+
+
 if __name__ == '__main__':
     unittest.main()
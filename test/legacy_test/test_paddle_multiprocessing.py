@@ -51,6 +51,14 @@ def send_parambase(queue, event, device, dtype):
     event.wait()
 
 
+def send_pooled_tensors(queue, event, repeat):
+    paddle.set_flags({'FLAGS_cuda_ipc_pool_segment_size_mb': 1})
+    for i in range(repeat):
+        # the blocks of the received tensors are reused by the later ones
+        queue.put(paddle.full([64, 64], i, dtype="float32"))
+    event.wait()
+
+
 class leak_checker:
     def __init__(self, test_case):
         self.checked_pids = [os.getpid()]
@@ -208,6 +216,28 @@ class TestMultiprocessingGpu(TestMultiprocessingBase):
     def test_pass_tensor(self):
         self.func_test_pass_tensor()
 
+    @unittest.skipIf(
+        not paddle.base.core.is_compiled_with_cuda(),
+        "core is not compiled with CUDA",
+    )
+    def test_pass_pooled_tensor(self):
+        paddle.set_device("gpu")
+        ctx = mp.get_context("spawn")
+        queue = ctx.Queue()
+        event = ctx.Event()
+        process = ctx.Process(
+            target=send_pooled_tensors, args=(queue, event, REPEAT)
+        )
+        process.daemon = True
+        process.start()
+        for i in range(REPEAT):
+            t = queue.get(timeout=30)
+            self.assertTrue(t.equal(i).all())
+            del t
+        event.set()
+        process.join(10)
+        self.assertFalse(process.is_alive())
+
 
 if __name__ == "__main__":
     unittest.main()
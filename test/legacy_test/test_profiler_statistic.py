@@ -1044,6 +1044,67 @@ class TestProfilerStatistic(unittest.TestCase):
                 )
             )
 
+    def test_statistic_roofline(self):
+        root_node = HostPythonNode(
+            'Root Node',
+            profiler.TracerEventType.UserDefined,
+            0,
+            float('inf'),
+            1000,
+            1001,
+        )
+        profilerstep_node = HostPythonNode(
+            'ProfileStep#1',
+            profiler.TracerEventType.ProfileStep,
+            0,
+            400,
+            1000,
+            1001,
+        )
+        matmul_node = HostPythonNode(
+            'matmul_v2 dygraph',
+            profiler.TracerEventType.Operator,
+            10,
+            100,
+            1000,
+            1001,
+        )
+        matmul_node.input_shapes = {'X': [[64, 128]], 'Y': [[128, 256]]}
+        matmul_node.dtypes = {'X': ['FP16'], 'Y': ['FP16']}
+        matmul_node.attributes = {'trans_x': False, 'trans_y': False}
+        matmul_launchkernel = HostPythonNode(
+            'cudalaunchkernel',
+            profiler.TracerEventType.CudaRuntime,
+            20,
+            30,
+            1000,
+            1001,
+        )
+        matmul_kernel = DevicePythonNode(
+            'gemm_kernel', profiler.TracerEventType.Kernel, 40, 240, 0, 0, 0
+        )
+        root_node.children_node.append(profilerstep_node)
+        profilerstep_node.children_node.append(matmul_node)
+        matmul_node.runtime_node.append(matmul_launchkernel)
+        matmul_launchkernel.device_node.append(matmul_kernel)
+        thread_tree = {'thread1001': root_node}
+        statistic_data = profiler.profiler_statistic.StatisticData(
+            thread_tree, {}
+        )
+        item = statistic_data.event_summary.items['matmul_v2 dygraph']
+        self.assertEqual(item.flops, 2 * 64 * 128 * 256)
+        self.assertEqual(
+            item.memory_bytes, (64 * 128 + 128 * 256 + 64 * 256) * 2
+        )
+        table = profiler.profiler_statistic._build_table(
+            statistic_data,
+            views=[profiler.SummaryView.RooflineView],
+            peak_flops=1e12,
+            peak_bandwidth=1e11,
+        )
+        self.assertIn('Operator Roofline Summary', table)
+        self.assertIn('Compute', table)
+
 
 if __name__ == '__main__':
     unittest.main()
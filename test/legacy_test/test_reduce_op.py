@@ -1983,6 +1983,33 @@ class TestAllZeroError(unittest.TestCase):
             self.assertRaises(ValueError, test_0_size)
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "core is not compiled with CUDA"
+)
+class TestReduceLongRowAutoTune(unittest.TestCase):
+    # Few rows with long reduced last dims split the rows across blocks, the
+    # split is tuned in the tuning range and read from the cache after it.
+    def test_long_row_reduce(self):
+        paddle.disable_static()
+        paddle.incubate.autotune.set_config(
+            config={"kernel": {"enable": True, "tuning_range": [1, 2]}}
+        )
+        x_np = np.random.uniform(-1, 1, [3, 1 << 18]).astype('float32')
+        x = paddle.to_tensor(x_np)
+        for _ in range(4):
+            out = paddle.sum(x, axis=-1)
+            max_out = paddle.max(x, axis=-1)
+            paddle.base.core.update_autotune_status()
+            np.testing.assert_allclose(
+                out.numpy(), x_np.sum(axis=-1), rtol=1e-5, atol=1e-3
+            )
+            np.testing.assert_array_equal(max_out.numpy(), x_np.max(axis=-1))
+        paddle.incubate.autotune.set_config(
+            config={"kernel": {"enable": False}}
+        )
+        paddle.enable_static()
+
+
 if __name__ == '__main__':
     paddle.enable_static()
     unittest.main()
@@ -903,6 +903,41 @@ class TestScatterInplaceAPI(TestScatterAPI):
         self.scatter = paddle.scatter_
 
 
+@unittest.skipIf(
+    not core.is_compiled_with_cuda(), "only the GPU kernel uses atomics"
+)
+class TestScatterAccumulateDeterministic(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.x_np = np.random.random((16, 32)).astype(np.float32)
+        self.index_np = np.random.randint(0, 16, (2048,)).astype(np.int64)
+        self.updates_np = np.random.random((2048, 32)).astype(np.float32)
+
+    def run_scatter(self):
+        place = base.CUDAPlace(0)
+        return paddle.scatter(
+            paddle.to_tensor(self.x_np, place=place),
+            paddle.to_tensor(self.index_np, place=place),
+            paddle.to_tensor(self.updates_np, place=place),
+            overwrite=False,
+        ).numpy()
+
+    def test_deterministic(self):
+        with dygraph_guard():
+            paddle.set_flags({'FLAGS_cudnn_deterministic': True})
+            try:
+                out = self.run_scatter()
+                for _ in range(3):
+                    np.testing.assert_array_equal(out, self.run_scatter())
+            finally:
+                paddle.set_flags({'FLAGS_cudnn_deterministic': False})
+        # The rows scattered to are reset before being accumulated.
+        ref = self.x_np.copy()
+        ref[np.unique(self.index_np)] = 0
+        np.add.at(ref, self.index_np, self.updates_np)
+        np.testing.assert_allclose(out, ref, rtol=1e-5, atol=1e-4)
+
+
 @unittest.skipIf(core.is_compiled_with_cuda(), "CUDA will not throw exception")
 class TestScatterError(unittest.TestCase):
     def test_scatter_index(self):
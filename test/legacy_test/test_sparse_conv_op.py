@@ -237,6 +237,36 @@ class TestSparseConv(unittest.TestCase):
                 1, 1, (1, 3, 3), data_format='NCDHW', key='subm_conv'
             )
 
+    def test_SubmConv3D_stack_without_key(self):
+        # the subm convs without a key reuse the rulebook of the same
+        # coordinates, they should match the convs with a key
+        paddle.seed(0)
+        x = paddle.randn([1, 4, 4, 4, 3])
+        x = paddle.nn.functional.relu(x)
+
+        def run(key):
+            sp_x = x.to_sparse_coo(4)
+            sp_x.stop_gradient = False
+            convs = [
+                paddle.sparse.nn.SubmConv3D(3, 3, 3, key=key)
+                for _ in range(3)
+            ]
+            for conv in convs:
+                conv.weight.set_value(paddle.ones_like(conv.weight) * 0.1)
+                conv.bias.set_value(paddle.zeros_like(conv.bias))
+            out = sp_x
+            for conv in convs:
+                out = conv(out)
+            out.values().sum().backward()
+            return out.to_dense().numpy(), convs[0].weight.grad.numpy()
+
+        out, weight_grad = run(None)
+        out_with_key, weight_grad_with_key = run('subm_conv')
+        np.testing.assert_allclose(out, out_with_key, atol=1e-5, rtol=1e-5)
+        np.testing.assert_allclose(
+            weight_grad, weight_grad_with_key, atol=1e-5, rtol=1e-5
+        )
+
     def test_Conv2D_bias(self):
         paddle.seed(0)
         shape = [1, 4, 4, 3]
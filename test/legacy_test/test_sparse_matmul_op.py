@@ -308,6 +308,58 @@ class TestMaskedMatmul(unittest.TestCase):
         )
 
 
+class TestBalancedCsrMatmul(unittest.TestCase):
+    # rows of very different lengths, run by the nnz-balanced kernels
+    def setUp(self):
+        paddle.set_default_dtype('float32')
+        np_mask = np.random.rand(64, 48) < 0.05
+        np_mask[:4] = True
+        self.mask = paddle.to_tensor(np_mask.astype('float32'))
+        paddle.set_flags({'FLAGS_sparse_csr_balanced_matmul_threshold': 0.0})
+
+    def tearDown(self):
+        paddle.set_flags({'FLAGS_sparse_csr_balanced_matmul_threshold': 1.0})
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11080,
+        "only support on cuda>=11.8",
+    )
+    def test_matmul(self):
+        for dtype, rtol in [('float32', 1e-05), ('float16', 1e-02)]:
+            x = (paddle.rand([3, 64, 48]) * self.mask).astype(dtype)
+            y = paddle.rand([3, 48, 40]).astype(dtype)
+            out = paddle.sparse.matmul(x.to_sparse_csr(), y)
+            dense_out = paddle.matmul(
+                x.astype('float32'), y.astype('float32')
+            )
+            np.testing.assert_allclose(
+                out.astype('float32').numpy(),
+                dense_out.numpy(),
+                rtol=rtol,
+                atol=rtol,
+            )
+
+    @unittest.skipIf(
+        not paddle.is_compiled_with_cuda() or get_cuda_version() < 11080,
+        "only support on cuda>=11.8",
+    )
+    def test_masked_matmul(self):
+        for dtype, rtol in [('float32', 1e-05), ('float16', 1e-02)]:
+            x = paddle.rand([3, 64, 36]).astype(dtype)
+            y = paddle.rand([3, 36, 48]).astype(dtype)
+            mask = paddle.tile(self.mask, [3, 1, 1]).astype(dtype)
+            out = paddle.sparse.masked_matmul(x, y, mask.to_sparse_csr())
+            dense_out = paddle.matmul(
+                x.astype('float32'), y.astype('float32')
+            ) * mask.astype('float32')
+            np.testing.assert_allclose(
+                out.to_dense().astype('float32').numpy(),
+                dense_out.numpy(),
+                rtol=rtol,
+                atol=rtol,
+            )
+
+
 class TestMatmulSparseDenseStatic(unittest.TestCase):
     # x: sparse, y: dense, out: dense
     def check_result(self, x_shape, y_shape):
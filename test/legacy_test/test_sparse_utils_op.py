@@ -358,6 +358,20 @@ class TestSparseConvert(unittest.TestCase):
                     values_sorted, sparse_x.values().numpy()
                 )
 
+                # unary ops share the indices, the second coalesce reuses
+                # the sort of the first one
+                for op, expected in [
+                    (paddle.sparse.nn.functional.relu, values_sorted),
+                    (paddle.sparse.square, np.square(values_sorted)),
+                ]:
+                    sparse_y = paddle.sparse.coalesce(op(sparse_x))
+                    np.testing.assert_array_equal(
+                        indices_sorted, sparse_y.indices().numpy()
+                    )
+                    np.testing.assert_array_equal(
+                        expected, sparse_y.values().numpy()
+                    )
+
     def test_batch_csr(self):
         def verify(dense_x):
             sparse_x = dense_x.to_sparse_csr()
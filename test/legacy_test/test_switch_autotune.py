@@ -179,6 +179,42 @@ class TestStaticAutoTuneStatus(TestAutoTune):
         self.func_disable_autotune()
 
 
+class TestAutoTuneCacheFile(TestAutoTune):
+    def test_save_and_load(self):
+        temp_dir = tempfile.TemporaryDirectory()
+        cache_file = os.path.join(temp_dir.name, "autotune_cache")
+        self.set_flags(True)
+        paddle.incubate.autotune.set_config(
+            config={
+                "kernel": {
+                    "enable": True,
+                    "tuning_range": [1, 2],
+                    "cache_file": cache_file,
+                }
+            }
+        )
+        x_var = paddle.uniform((1, 1, 8, 8), dtype='float32', min=-1.0, max=1.0)
+        net = SimpleNet()
+        for _ in range(3):
+            train_dygraph(net, x_var)
+        self.assertTrue(os.path.exists(cache_file))
+
+        # All the entries in the file are tuned in this process already.
+        self.assertEqual(paddle.base.core.load_autotune_cache(cache_file), 0)
+        paddle.base.core.enable_autotune()
+        num_entries = paddle.base.core.load_autotune_cache(cache_file)
+        if paddle.is_compiled_with_cuda():
+            self.assertEqual(num_entries, 3)
+        else:
+            self.assertEqual(num_entries, 0)
+
+        paddle.set_flags({'FLAGS_autotune_cache_file': ""})
+        paddle.incubate.autotune.set_config(
+            config={"kernel": {"enable": False}}
+        )
+        temp_dir.cleanup()
+
+
 class TestAutoTuneAPI(unittest.TestCase):
     def test_set_config_warnings(self):
         with warnings.catch_warnings(record=True) as w:
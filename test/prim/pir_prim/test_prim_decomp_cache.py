@@ -0,0 +1,83 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.decomposition import decomp
+
+paddle.enable_static()
+
+
+class TestPrimDecompCache(unittest.TestCase):
+    def setUp(self):
+        np.random.seed(2024)
+        self.shape = [8, 16]
+        self.x = np.random.random(self.shape).astype("float32")
+
+    def net(self, flags):
+        paddle.set_flags(flags)
+        main_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program):
+            x = paddle.static.data('x', self.shape, dtype='float32')
+            out = x
+            # identical signatures, the later ones replay the first decomp
+            for _ in range(3):
+                out = paddle.nn.functional.layer_norm(out, self.shape[1:])
+                out = paddle.nn.functional.softmax(out, axis=-1)
+            with decomp.prim_guard():
+                [out] = decomp.decompose(main_program, [out])
+            exe = paddle.static.Executor()
+            [res] = exe.run(feed={'x': self.x}, fetch_list=[out])
+        ops = [op.name() for op in main_program.global_block().ops]
+        paddle.set_flags(
+            {
+                'FLAGS_prim_decomp_cache': False,
+                'FLAGS_prim_fused_kernel_reduce_numel': 0,
+            }
+        )
+        return res, ops
+
+    def test_decomp_cache(self):
+        ref, ref_ops = self.net({'FLAGS_prim_decomp_cache': False})
+        res, ops = self.net({'FLAGS_prim_decomp_cache': True})
+        self.assertNotIn('pd_op.layer_norm', ops)
+        self.assertNotIn('pd_op.softmax', ops)
+        self.assertEqual(ref_ops, ops)
+        np.testing.assert_allclose(ref, res, rtol=1e-6, atol=1e-6)
+
+        # hits of the cache filled by the run above
+        res, ops = self.net({'FLAGS_prim_decomp_cache': True})
+        self.assertEqual(ref_ops, ops)
+        np.testing.assert_allclose(ref, res, rtol=1e-6, atol=1e-6)
+
+    def test_prefer_fused_kernel(self):
+        ref, _ = self.net({'FLAGS_prim_fused_kernel_reduce_numel': 0})
+        res, ops = self.net(
+            {
+                'FLAGS_prim_fused_kernel_reduce_numel': 1,
+                'FLAGS_use_cinn': False,
+            }
+            if paddle.is_compiled_with_cinn()
+            else {'FLAGS_prim_fused_kernel_reduce_numel': 1}
+        )
+        self.assertIn('pd_op.layer_norm', ops)
+        self.assertIn('pd_op.softmax', ops)
+        np.testing.assert_allclose(ref, res, rtol=1e-5, atol=1e-5)
+
+
+if __name__ == "__main__":
+    unittest.main()
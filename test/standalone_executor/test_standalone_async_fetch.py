@@ -0,0 +1,77 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestAsyncFetch(unittest.TestCase):
+    def setUp(self):
+        self.steps = 4
+        self.place = (
+            paddle.CUDAPlace(0)
+            if core.is_compiled_with_cuda()
+            else paddle.CPUPlace()
+        )
+        self.batches = [
+            np.random.random([8, 16]).astype("float32")
+            for _ in range(self.steps)
+        ]
+
+    def create_fetcher(self):
+        place = core.Place()
+        place.set_place(self.place)
+        return core.AsyncFetcher(place)
+
+    def test_fetch_every_step(self):
+        with paddle.pir_utils.IrGuard():
+            main_program = paddle.static.Program()
+            startup_program = paddle.static.Program()
+            with paddle.static.program_guard(main_program, startup_program):
+                x = paddle.static.data(
+                    name="x", shape=[8, 16], dtype="float32"
+                )
+                loss = paddle.mean(paddle.nn.functional.relu(x * 2.0))
+                # keep the loss on the device instead of fetching it
+                paddle._pir_ops.set_persistable_value(loss, "loss")
+
+            scope = paddle.static.Scope()
+            with paddle.static.scope_guard(scope):
+                exe = paddle.static.Executor(self.place)
+                exe.run(startup_program)
+                fetcher = self.create_fetcher()
+                handles = []
+                for step in range(self.steps):
+                    exe.run(main_program, feed={"x": self.batches[step]})
+                    loss_tensor = scope.find_var("loss").get_tensor()
+                    handles.append(fetcher.fetch([loss_tensor]))
+
+                for step, handle in enumerate(handles):
+                    (res,) = handle.wait()
+                    self.assertTrue(handle.is_ready())
+                    np.testing.assert_allclose(
+                        np.array(res),
+                        np.mean(np.maximum(self.batches[step] * 2.0, 0)),
+                        rtol=1e-5,
+                    )
+
+
+if __name__ == "__main__":
+    unittest.main()
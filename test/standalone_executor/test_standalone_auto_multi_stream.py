@@ -0,0 +1,119 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import os
+import tempfile
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestAutoMultiStream(unittest.TestCase):
+    """
+                       x
+          -------------------------
+         |        |        |       |
+      matmul   matmul   matmul   matmul
+         |        |        |       |
+       tanh     relu    sigmoid   exp
+         |        |        |       |
+          ------ add_n ------------
+                   |
+                 mean
+    """
+
+    def setUp(self):
+        self.steps = 3
+        self.num_branches = 4
+        self.x = np.random.random([256, 256]).astype("float32")
+
+    def build_program(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name="x", shape=[256, 256], dtype="float32")
+            acts = [
+                paddle.tanh,
+                paddle.nn.functional.relu,
+                paddle.nn.functional.sigmoid,
+                paddle.exp,
+            ]
+            branches = []
+            for i in range(self.num_branches):
+                w = paddle.full([256, 256], 0.001 * (i + 1), dtype="float32")
+                branches.append(acts[i](paddle.matmul(x, w)))
+            out = paddle.mean(paddle.add_n(branches))
+        return main_program, startup_program, [out, *branches]
+
+    def run_program(self, num_compute_streams, cost_table=""):
+        paddle.set_flags(
+            {
+                "FLAGS_new_executor_num_compute_streams": num_compute_streams,
+                "FLAGS_new_executor_kernel_cost_table": cost_table,
+            }
+        )
+        main_program, startup_program, fetch_list = self.build_program()
+        exe = paddle.static.Executor(paddle.CUDAPlace(0))
+        scope = core.Scope()
+        outs = []
+        with paddle.static.scope_guard(scope):
+            exe.run(startup_program)
+            for _ in range(self.steps):
+                outs.append(
+                    exe.run(
+                        main_program,
+                        feed={"x": self.x},
+                        fetch_list=fetch_list,
+                    )
+                )
+        paddle.set_flags(
+            {
+                "FLAGS_new_executor_num_compute_streams": 1,
+                "FLAGS_new_executor_kernel_cost_table": "",
+            }
+        )
+        return outs
+
+    def check(self, baselines, outs):
+        for baseline, out in zip(baselines, outs):
+            for bl, o in zip(baseline, out):
+                np.testing.assert_array_equal(bl, o)
+
+    def test_result(self):
+        if not core.is_compiled_with_cuda():
+            return
+        with paddle.pir_utils.IrGuard():
+            baselines = self.run_program(1)
+            self.check(baselines, self.run_program(3))
+
+    def test_result_with_cost_table(self):
+        if not core.is_compiled_with_cuda():
+            return
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            cost_table = os.path.join(tmp_dir, "kernel_cost.txt")
+            with open(cost_table, "w") as f:
+                f.write("matmul 200\n")
+                f.write("tanh 20\n")
+            with paddle.pir_utils.IrGuard():
+                baselines = self.run_program(1)
+                self.check(baselines, self.run_program(4, cost_table))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -318,6 +318,34 @@ class TestException(unittest.TestCase):
         feed[1]['data'][0] = np.nan
         self.assertRaises(RuntimeError, self.run_new_executor, feed)
 
+    def test_nan_sampling(self):
+        flags = {
+            'FLAGS_check_nan_inf': True,
+            'FLAGS_check_nan_inf_sampling_interval': 1,
+        }
+        paddle.base.set_flags(flags)
+        feed = [
+            {
+                'id': np.array([1, 2, 3, 4, 5]).astype(np.int64),
+                'data': np.array([1, 2, 3]).astype(np.float32),
+            }
+            for _ in range(3)
+        ]
+        # the NAN of step 1 is found when step 2 begins, which then checks
+        # each operator and raises
+        feed[1]['data'][0] = np.nan
+        feed[2]['data'][0] = np.nan
+        try:
+            if paddle.framework.in_pir_mode():
+                self.assertRaises(RuntimeError, self.run_new_executor, feed)
+        finally:
+            paddle.base.set_flags(
+                {
+                    'FLAGS_check_nan_inf': False,
+                    'FLAGS_check_nan_inf_sampling_interval': 0,
+                }
+            )
+
     def test_scope_find_temp_var(self):
         feed = [
             {
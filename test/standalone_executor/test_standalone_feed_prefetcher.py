@@ -0,0 +1,96 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestFeedPrefetcher(unittest.TestCase):
+    def setUp(self):
+        self.steps = 4
+        self.place = (
+            paddle.CUDAPlace(0)
+            if core.is_compiled_with_cuda()
+            else paddle.CPUPlace()
+        )
+        self.batches = [
+            np.random.random([8, 16]).astype("float32")
+            for _ in range(self.steps)
+        ]
+
+    def create_prefetcher(self, capacity=2):
+        place = core.Place()
+        place.set_place(self.place)
+        return core.FeedPrefetcher(place, capacity)
+
+    def to_host_tensor(self, array):
+        tensor = core.DenseTensor()
+        tensor.set(array, paddle.CPUPlace())
+        return tensor
+
+    def build_program(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name="x", shape=[8, 16], dtype="float32")
+            out = paddle.nn.functional.relu(x * 2.0)
+        return main_program, startup_program, out
+
+    def test_run_with_prefetched_feed(self):
+        main_program, startup_program, out = self.build_program()
+        exe = paddle.static.Executor(self.place)
+        exe.run(startup_program)
+
+        prefetcher = self.create_prefetcher()
+        prefetcher.push(["x"], [self.to_host_tensor(self.batches[0])])
+        prefetcher.push(["x"], [self.to_host_tensor(self.batches[1])])
+        next_batch = 2
+        for step in range(self.steps):
+            feed = prefetcher.pop()
+            self.assertEqual(
+                feed["x"]._place().is_gpu_place(),
+                core.is_compiled_with_cuda(),
+            )
+            # Stage the following batch while the current one runs.
+            if next_batch < self.steps:
+                prefetcher.push(
+                    ["x"], [self.to_host_tensor(self.batches[next_batch])]
+                )
+                next_batch += 1
+            (res,) = exe.run(main_program, feed=feed, fetch_list=[out])
+            np.testing.assert_allclose(
+                res, np.maximum(self.batches[step] * 2.0, 0), rtol=1e-6
+            )
+        self.assertEqual(prefetcher.size(), 0)
+
+    def test_capacity(self):
+        prefetcher = self.create_prefetcher(capacity=1)
+        prefetcher.push(["x"], [self.to_host_tensor(self.batches[0])])
+        with self.assertRaises(Exception):
+            prefetcher.push(["x"], [self.to_host_tensor(self.batches[1])])
+        np.testing.assert_array_equal(
+            np.array(prefetcher.pop()["x"]), self.batches[0]
+        )
+        with self.assertRaises(Exception):
+            prefetcher.pop()
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,87 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+
+paddle.enable_static()
+
+
+class TestInstructionStatistics(unittest.TestCase):
+    def setUp(self):
+        self.steps = 5
+        self.place = (
+            paddle.CUDAPlace(0)
+            if core.is_compiled_with_cuda()
+            else paddle.CPUPlace()
+        )
+
+    def build_program(self):
+        main_program = paddle.static.Program()
+        startup_program = paddle.static.Program()
+        with paddle.static.program_guard(main_program, startup_program):
+            x = paddle.static.data(name="x", shape=[64, 64], dtype="float32")
+            out = paddle.nn.functional.relu(paddle.matmul(x, x))
+            out = paddle.mean(out)
+        return main_program, startup_program, out
+
+    def run_program(self):
+        main_program, startup_program, out = self.build_program()
+        exe = paddle.static.Executor(self.place)
+        exe.run(startup_program)
+        feed = {"x": np.random.random([64, 64]).astype("float32")}
+        for _ in range(self.steps):
+            exe.run(main_program, feed=feed, fetch_list=[out])
+
+    def test_statistics(self):
+        paddle.set_flags(
+            {
+                'FLAGS_new_executor_instruction_stats': True,
+                'FLAGS_new_executor_instruction_stats_device_sampling': 1,
+            }
+        )
+        core.reset_instruction_statistics()
+        try:
+            self.run_program()
+        finally:
+            paddle.set_flags({'FLAGS_new_executor_instruction_stats': False})
+
+        stats = core.get_instruction_statistics()
+        if not paddle.framework.in_pir_mode():
+            self.assertEqual(len(stats), 0)
+            return
+
+        self.assertIn("pd_op.matmul", stats)
+        matmul = stats["pd_op.matmul"]
+        self.assertEqual(matmul["count"], self.steps)
+        self.assertGreater(matmul["dispatch_time_ns"], 0)
+        self.assertGreaterEqual(
+            matmul["dispatch_time_ns"],
+            matmul["infer_meta_time_ns"] + matmul["launch_time_ns"],
+        )
+        if core.is_compiled_with_cuda():
+            self.assertGreater(matmul["device_samples"], 0)
+        else:
+            self.assertEqual(matmul["device_samples"], 0)
+
+        core.reset_instruction_statistics()
+        self.assertEqual(len(core.get_instruction_statistics()), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
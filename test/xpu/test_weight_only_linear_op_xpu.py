@@ -0,0 +1,59 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+import unittest
+
+import numpy as np
+
+import paddle
+from paddle.base import core
+from paddle.nn.quant import weight_only_linear
+
+np.random.seed(2024)
+
+
+@unittest.skipIf(
+    not core.is_compiled_with_xpu()
+    or core.get_xpu_device_version(0) != core.XPUVersion.XPU2,
+    "weight_only_linear is only registered for XPU2.",
+)
+class TestWeightOnlyLinearXPU(unittest.TestCase):
+    def setUp(self):
+        self.place = paddle.XPUPlace(0)
+        self.m, self.k, self.n = 4, 64, 32
+
+    def test_int8_per_channel(self):
+        paddle.disable_static(self.place)
+        x = np.random.uniform(-1, 1, [2, self.m, self.k]).astype('float16')
+        weight = np.random.randint(-127, 128, [self.n, self.k]).astype('int8')
+        scale = np.random.uniform(0.001, 0.01, [self.n]).astype('float32')
+        bias = np.random.uniform(-1, 1, [self.n]).astype('float16')
+
+        out = weight_only_linear(
+            paddle.to_tensor(x),
+            paddle.to_tensor(weight),
+            bias=paddle.to_tensor(bias),
+            weight_scale=paddle.to_tensor(scale),
+            weight_dtype='int8',
+        )
+
+        dequant = weight.astype('float32') * scale[:, None]
+        expected = x.astype('float32') @ dequant.T + bias.astype('float32')
+        np.testing.assert_allclose(
+            out.numpy().astype('float32'), expected, rtol=1e-2, atol=1e-2
+        )
+
+
+if __name__ == '__main__':
+    unittest.main()
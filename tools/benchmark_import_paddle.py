@@ -0,0 +1,70 @@
+# Copyright (c) 2024 PaddlePaddle Authors. All Rights Reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""
+Measures the wall time and peak RSS of `import paddle` in fresh processes,
+and of running a first op after the import.
+Usage: python benchmark_import_paddle.py [--repeat 10]
+"""
+
+import argparse
+import statistics
+import subprocess
+import sys
+
+IMPORT_SCRIPT = """
+import resource, time
+start = time.perf_counter()
+import paddle
+imported = time.perf_counter()
+{first_op}
+done = time.perf_counter()
+rss_kb = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+print(imported - start, done - imported, rss_kb)
+"""
+
+FIRST_OP = "paddle.ones([2, 2]).sum()"
+
+
+def run_once(first_op):
+    script = IMPORT_SCRIPT.format(first_op=first_op if first_op else "pass")
+    out = subprocess.check_output([sys.executable, "-c", script], text=True)
+    import_time, first_op_time, rss_kb = out.strip().splitlines()[-1].split()
+    return float(import_time), float(first_op_time), int(rss_kb)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--repeat', type=int, default=10)
+    parser.add_argument('--no_first_op', action='store_true')
+    args = parser.parse_args()
+
+    first_op = None if args.no_first_op else FIRST_OP
+    results = [run_once(first_op) for _ in range(args.repeat)]
+    import_times = [r[0] for r in results]
+    first_op_times = [r[1] for r in results]
+    rss_mb = [r[2] / 1024.0 for r in results]
+    print(
+        f"import paddle: median {statistics.median(import_times):.3f}s, "
+        f"min {min(import_times):.3f}s"
+    )
+    if first_op:
+        print(
+            f"first op: median {statistics.median(first_op_times) * 1000:.1f}ms"
+        )
+    print(f"peak rss: median {statistics.median(rss_mb):.1f}MB")
+
+
+if __name__ == "__main__":
+    main()